@@ -1,45 +1,470 @@
 #include "ApiServer.h"
+#include "AuthCache.h"
+#include "HttpRouter.h"
+#include "RateLimiter.h"
+#include "ResponseEncoding.h"
+#include "WebhookDispatcher.h"
+#include "../core/Tracer.h"
 #include <iostream>
 #include <thread>
 #include <chrono>
+#include <memory>
 #include <vector>
+#include <deque>
 #include <unordered_set>
 #include <algorithm>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include <sstream>
+#include <string_view>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <csignal>
 #include <iomanip>
 
+#if defined(__linux__)
+#include <sys/epoll.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+#include <sys/event.h>
+#else
+#include <sys/select.h>
+#endif
+
+namespace {
+
+constexpr size_t READ_CHUNK_SIZE = 16 * 1024;
+constexpr size_t MAX_HEADER_BYTES = 64 * 1024;
+constexpr size_t MAX_BODY_BYTES = 16 * 1024 * 1024;  // 16 MB
+constexpr size_t MAX_PENDING_REQUESTS = 1024;
+constexpr size_t MAX_WORKER_THREADS = 8;
+constexpr size_t MAX_SUBSCRIBER_BACKLOG = 1024 * 1024;  // Unsent event bytes before a subscriber is dropped
+constexpr auto KEEP_ALIVE_TIMEOUT = std::chrono::seconds(15);
+constexpr int POLL_INTERVAL_MS = 1000;
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;  // SO_NOSIGPIPE is set on each socket instead
+#endif
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+std::string toLower(std::string value) {
+    std::transform(value.begin(), value.end(), value.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return value;
+}
+
+bool equalsLower(std::string_view text, std::string_view lower) {
+    return text.size() == lower.size() &&
+           std::equal(text.begin(), text.end(), lower.begin(), [](unsigned char a, unsigned char b) {
+               return std::tolower(a) == b;
+           });
+}
+
+// Header names are stored as sent; HTTP says they are case-insensitive
+const std::string* findHeader(const ApiRequest& request, std::string_view lower_name) {
+    for (const auto& header : request.headers) {
+        if (equalsLower(header.first, lower_name)) {
+            return &header.second;
+        }
+    }
+    return nullptr;
+}
+
+const char* methodName(HttpMethod method) {
+    switch (method) {
+        case HttpMethod::GET: return "GET";
+        case HttpMethod::POST: return "POST";
+        case HttpMethod::PUT: return "PUT";
+        case HttpMethod::DELETE: return "DELETE";
+        case HttpMethod::PATCH: return "PATCH";
+    }
+    return "";
+}
+
+// Status lines are formatted once; codes outside the table get "Unknown"
+std::string_view statusLine(int status) {
+    switch (status) {
+        case 200: return "HTTP/1.1 200 OK\r\n";
+        case 304: return "HTTP/1.1 304 Not Modified\r\n";
+        case 400: return "HTTP/1.1 400 Bad Request\r\n";
+        case 401: return "HTTP/1.1 401 Unauthorized\r\n";
+        case 404: return "HTTP/1.1 404 Not Found\r\n";
+        case 410: return "HTTP/1.1 410 Gone\r\n";
+        case 411: return "HTTP/1.1 411 Length Required\r\n";
+        case 413: return "HTTP/1.1 413 Payload Too Large\r\n";
+        case 429: return "HTTP/1.1 429 Too Many Requests\r\n";
+        case 431: return "HTTP/1.1 431 Request Header Fields Too Large\r\n";
+        case 500: return "HTTP/1.1 500 Internal Server Error\r\n";
+        case 503: return "HTTP/1.1 503 Service Unavailable\r\n";
+        default: return {};
+    }
+}
+
+// Binary encoding, conditional GET and compression of a complete response,
+// as the request's Accept, If-None-Match and Accept-Encoding ask
+void negotiateEncoding(const ApiRequest& request, ApiResponse& response) {
+    if (response.body_stream || !response.event_stream.empty()) return;
+    
+    auto content_type = response.headers.find("Content-Type");
+    const std::string* accept = findHeader(request, "accept");
+    if (accept && content_type != response.headers.end() && content_type->second.rfind("application/json", 0) == 0) {
+        std::string format = ResponseEncoding::binaryFormat(*accept);
+        if (!format.empty() && ResponseEncoding::encodeJson(format, response.body)) {
+            content_type->second = format;
+        }
+    }
+    response.headers["Vary"] = "Accept, Accept-Encoding";
+    
+    const std::string* accept_encoding = findHeader(request, "accept-encoding");
+    std::string coding;
+    if (accept_encoding && response.body.size() >= ResponseEncoding::MIN_COMPRESSED_SIZE) {
+        coding = ResponseEncoding::contentCoding(*accept_encoding);
+    }
+    
+    // Tagged before compressing, so an unchanged answer costs a hash and no deflate
+    if (request.method == HttpMethod::GET && response.status_code == 200) {
+        std::string tag = ResponseEncoding::entityTag(response.body, coding);
+        response.headers["ETag"] = tag;
+        const std::string* if_none_match = findHeader(request, "if-none-match");
+        if (if_none_match && ResponseEncoding::matchesTag(*if_none_match, tag)) {
+            response.status_code = 304;
+            response.body.clear();
+            return;
+        }
+    }
+    
+    std::string compressed;
+    if (!coding.empty() && ResponseEncoding::compress(coding, response.body, compressed)
+        && compressed.size() < response.body.size()) {
+        response.body = std::move(compressed);
+        response.headers["Content-Encoding"] = coding;
+    } else if (response.headers.count("ETag") && !coding.empty()) {
+        response.headers["ETag"] = ResponseEncoding::entityTag(response.body, "");
+    }
+}
+
+struct PollEvent {
+    int fd;
+    bool readable;
+    bool writable;
+    bool error;
+};
+
+// Readiness notification over the platform's native mechanism:
+// epoll on Linux, kqueue on macOS/BSD and select() everywhere else
+class Poller {
+private:
+#if defined(__linux__)
+    int epoll_fd = -1;
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+    int kqueue_fd = -1;
+#else
+    struct Interest {
+        bool read;
+        bool write;
+    };
+    std::unordered_map<int, Interest> watched;
+#endif
+
+public:
+    Poller() = default;
+    ~Poller() { close(); }
+
+    Poller(const Poller&) = delete;
+    Poller& operator=(const Poller&) = delete;
+
+    bool open();
+    void close();
+    bool add(int fd);  // Starts watching for readability
+    void update(int fd, bool want_read, bool want_write);
+    void remove(int fd);
+    int wait(std::vector<PollEvent>& events, int timeout_ms);
+};
+
+#if defined(__linux__)
+
+bool Poller::open() {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    return epoll_fd >= 0;
+}
+
+void Poller::close() {
+    if (epoll_fd >= 0) {
+        ::close(epoll_fd);
+        epoll_fd = -1;
+    }
+}
+
+bool Poller::add(int fd) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+void Poller::update(int fd, bool want_read, bool want_write) {
+    epoll_event event{};
+    event.events = (want_read ? EPOLLIN : 0u) | (want_write ? EPOLLOUT : 0u);
+    event.data.fd = fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event);
+}
+
+void Poller::remove(int fd) {
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+int Poller::wait(std::vector<PollEvent>& events, int timeout_ms) {
+    epoll_event ready[64];
+    int count = epoll_wait(epoll_fd, ready, 64, timeout_ms);
+    events.clear();
+    for (int i = 0; i < count; ++i) {
+        events.push_back({ready[i].data.fd,
+                          (ready[i].events & EPOLLIN) != 0,
+                          (ready[i].events & EPOLLOUT) != 0,
+                          (ready[i].events & (EPOLLERR | EPOLLHUP)) != 0});
+    }
+    return count;
+}
+
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+
+bool Poller::open() {
+    kqueue_fd = kqueue();
+    return kqueue_fd >= 0;
+}
+
+void Poller::close() {
+    if (kqueue_fd >= 0) {
+        ::close(kqueue_fd);
+        kqueue_fd = -1;
+    }
+}
+
+bool Poller::add(int fd) {
+    struct kevent change;
+    EV_SET(&change, fd, EVFILT_READ, EV_ADD, 0, 0, nullptr);
+    return kevent(kqueue_fd, &change, 1, nullptr, 0, nullptr) == 0;
+}
+
+void Poller::update(int fd, bool want_read, bool want_write) {
+    // Deleting a filter that is not registered fails harmlessly
+    struct kevent changes[2];
+    EV_SET(&changes[0], fd, EVFILT_READ, want_read ? EV_ADD : EV_DELETE, 0, 0, nullptr);
+    EV_SET(&changes[1], fd, EVFILT_WRITE, want_write ? EV_ADD : EV_DELETE, 0, 0, nullptr);
+    kevent(kqueue_fd, &changes[0], 1, nullptr, 0, nullptr);
+    kevent(kqueue_fd, &changes[1], 1, nullptr, 0, nullptr);
+}
+
+void Poller::remove(int fd) {
+    update(fd, false, false);
+}
+
+int Poller::wait(std::vector<PollEvent>& events, int timeout_ms) {
+    struct kevent ready[64];
+    struct timespec timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_nsec = (timeout_ms % 1000) * 1000000L;
+    int count = kevent(kqueue_fd, nullptr, 0, ready, 64, &timeout);
+    events.clear();
+    for (int i = 0; i < count; ++i) {
+        events.push_back({static_cast<int>(ready[i].ident),
+                          ready[i].filter == EVFILT_READ,
+                          ready[i].filter == EVFILT_WRITE,
+                          (ready[i].flags & EV_ERROR) != 0});
+    }
+    return count;
+}
+
+#else
+
+bool Poller::open() {
+    return true;
+}
+
+void Poller::close() {
+    watched.clear();
+}
+
+bool Poller::add(int fd) {
+    if (fd >= FD_SETSIZE) {
+        return false;
+    }
+    watched[fd] = {true, false};
+    return true;
+}
+
+void Poller::update(int fd, bool want_read, bool want_write) {
+    auto it = watched.find(fd);
+    if (it != watched.end()) {
+        it->second = {want_read, want_write};
+    }
+}
+
+void Poller::remove(int fd) {
+    watched.erase(fd);
+}
+
+int Poller::wait(std::vector<PollEvent>& events, int timeout_ms) {
+    fd_set read_set, write_set;
+    FD_ZERO(&read_set);
+    FD_ZERO(&write_set);
+    int max_fd = -1;
+    for (const auto& entry : watched) {
+        if (entry.second.read) FD_SET(entry.first, &read_set);
+        if (entry.second.write) FD_SET(entry.first, &write_set);
+        max_fd = std::max(max_fd, entry.first);
+    }
+
+    struct timeval timeout;
+    timeout.tv_sec = timeout_ms / 1000;
+    timeout.tv_usec = (timeout_ms % 1000) * 1000;
+    int count = select(max_fd + 1, &read_set, &write_set, nullptr, &timeout);
+    events.clear();
+    if (count <= 0) {
+        return count;
+    }
+    for (const auto& entry : watched) {
+        bool readable = FD_ISSET(entry.first, &read_set);
+        bool writable = FD_ISSET(entry.first, &write_set);
+        if (readable || writable) {
+            events.push_back({entry.first, readable, writable, false});
+        }
+    }
+    return count;
+}
+
+#endif
+
+} // namespace
+
 // Private implementation details
 struct ApiServer::Impl {
     std::atomic<bool> running{false};
     int port = 8080;
     int server_socket = -1;
     std::thread server_thread;
-    std::unordered_map<std::string, ApiHandler> routes;
+    HttpRouter router;
+    std::vector<ApiHandler> handlers;  // By route index
     std::vector<std::function<bool(ApiRequest&, ApiResponse&)>> middlewares;
     std::function<bool(const std::string&, std::string&)> auth_handler;
+    AuthCache auth_cache;
     std::unordered_set<std::string> protected_paths;
     std::unordered_map<std::string, RateLimit> rate_limits;
     RateLimit global_rate_limit;
-    std::unordered_map<std::string, std::unordered_map<std::string, std::vector<std::chrono::steady_clock::time_point>>> rate_limit_tracker;
+    RateLimiter rate_limiter;
+    std::unordered_set<std::string> route_paths;  // Paths with a route, each its own rate limit key
     bool cors_enabled = false;
     std::string cors_origins = "*";
     std::unordered_map<std::string, std::string> cors_headers;
+    std::string cors_block;  // The CORS header lines, formatted once for every response
+    std::unordered_set<std::string> cors_names;  // ... and their names, which replace a handler's
     std::unordered_map<std::string, std::vector<std::string>> webhooks;
+    std::unique_ptr<WebhookDispatcher> webhook_dispatcher;  // Started with the first webhook
     std::function<ApiResponse(int, const std::string&)> error_handler;
     std::function<void(const std::string&)> log_handler;
     std::string log_level = "INFO";
+    size_t worker_count = 0;  // 0 = derive from hardware concurrency
+
+    // Per-connection state, owned by the event loop thread
+    struct Connection {
+        uint64_t id = 0;
+        std::string client_ip;
+        std::string in_buffer;
+        std::string out_buffer;
+        size_t out_offset = 0;
+        std::chrono::steady_clock::time_point last_activity;
+
+        size_t header_scan = 0;  // in_buffer before this holds no header terminator
+        
+        // Request whose headers are parsed while its body is still arriving
+        bool headers_parsed = false;
+        ApiRequest request;
+        size_t body_start = 0;
+        size_t body_length = 0;
+        bool keep_alive = true;
+        bool http11 = true;
+
+        std::string event_stream;  // Non-empty once subscribed to a stream
+        bool busy = false;  // A request is with the worker pool
+        bool read_closed = false;
+        bool want_write = false;
+        bool close_after_write = false;
+    };
+
+    struct PendingRequest {
+        int fd;
+        uint64_t connection_id;
+        ApiRequest request;
+        bool keep_alive;
+        bool chunked_ok;  // HTTP/1.1 client
+    };
+
+    struct CompletedResponse {
+        int fd;
+        uint64_t connection_id;
+        std::string data;
+        bool keep_alive;
+        std::string event_stream;
+        bool final = true;  // False for leading pieces of a streamed response
+    };
+
+    struct StreamEvent {
+        std::string stream;
+        std::shared_ptr<const std::string> payload;
+    };
+
+    // Event loop
+    Poller poller;
+    int wake_pipe[2] = {-1, -1};
+    std::unordered_map<int, Connection> connections;
+    uint64_t next_connection_id = 1;
+
+    // Worker pool
+    std::vector<std::thread> workers;
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<PendingRequest> pending_requests;
+    bool workers_running = false;
+
+    // Handoff to the event loop; also guards last_events
+    std::mutex completed_mutex;
+    std::vector<CompletedResponse> completed_responses;
+    std::vector<StreamEvent> stream_events;
+    std::unordered_map<std::string, std::shared_ptr<const std::string>> last_events;
+    std::atomic<size_t> subscriber_count{0};
     
-    void serverLoop(ApiServer* server);
-    std::string parseHttpRequest(const std::string& raw_request, ApiRequest& request);
-    std::string formatHttpResponse(const ApiResponse& response);
-    std::string urlDecode(const std::string& encoded);
+    void serverLoop();
+    void workerLoop(ApiServer* server);
+    void streamResponse(const PendingRequest& job, ApiResponse& response);
+    void complete(const PendingRequest& job, std::string data, bool keep_alive, bool final,
+                  std::string event_stream = {});
+    void acceptConnections();
+    void readConnection(int fd, Connection& connection);
+    void dispatchRequests(int fd, Connection& connection);
+    void rejectRequest(int fd, Connection& connection, int status, const std::string& message);
+    bool flushConnection(int fd, Connection& connection);
+    void closeConnection(int fd);
+    void deliverQueued();
+    void closeIdleConnections();
+    void wake();
+    void releaseSockets();
+    void compileCorsHeaders();
+    std::string parseHttpRequest(std::string_view head, ApiRequest& request, std::string_view& version);
+    std::string formatHttpResponse(const ApiResponse& response, bool keep_alive);
+    std::string urlDecode(std::string_view encoded);
 };
 
 ApiServer::ApiServer() : impl_(std::make_unique<Impl>()) {
@@ -98,7 +523,7 @@ bool ApiServer::start(int port) {
     }
     
     // Start listening
-    if (listen(impl_->server_socket, 10) < 0) {
+    if (listen(impl_->server_socket, SOMAXCONN) < 0) {
         if (impl_->log_handler) {
             impl_->log_handler("Failed to listen on socket");
         }
@@ -107,13 +532,36 @@ bool ApiServer::start(int port) {
         return false;
     }
     
+    // Event loop: non-blocking listener plus a pipe the workers use to wake it
+    if (!setNonBlocking(impl_->server_socket) || pipe(impl_->wake_pipe) < 0 ||
+        !setNonBlocking(impl_->wake_pipe[0]) || !setNonBlocking(impl_->wake_pipe[1]) ||
+        !impl_->poller.open() || !impl_->poller.add(impl_->server_socket) ||
+        !impl_->poller.add(impl_->wake_pipe[0])) {
+        if (impl_->log_handler) {
+            impl_->log_handler("Failed to initialize event loop");
+        }
+        impl_->releaseSockets();
+        return false;
+    }
+    
+    // Start worker pool
+    size_t worker_count = impl_->worker_count;
+    if (worker_count == 0) {
+        worker_count = std::clamp<size_t>(std::thread::hardware_concurrency(), 2, MAX_WORKER_THREADS);
+    }
+    impl_->workers_running = true;
+    for (size_t i = 0; i < worker_count; ++i) {
+        impl_->workers.emplace_back(&ApiServer::Impl::workerLoop, impl_.get(), this);
+    }
+    
     impl_->running.store(true);
     
     // Start server thread
-    impl_->server_thread = std::thread(&ApiServer::Impl::serverLoop, impl_.get(), this);
+    impl_->server_thread = std::thread(&ApiServer::Impl::serverLoop, impl_.get());
     
     if (impl_->log_handler) {
-        impl_->log_handler("API Server started on port " + std::to_string(port));
+        impl_->log_handler("API Server started on port " + std::to_string(port) +
+                           " (" + std::to_string(worker_count) + " workers)");
     }
     
     return true;
@@ -123,17 +571,31 @@ void ApiServer::stop() {
     if (impl_->running.load()) {
         impl_->running.store(false);
         
-        // Close server socket to break accept() loop
-        if (impl_->server_socket >= 0) {
-            close(impl_->server_socket);
-            impl_->server_socket = -1;
-        }
-        
-        // Wait for server thread to finish
+        // Wake the event loop so it notices the flag; it closes its connections on exit
+        impl_->wake();
         if (impl_->server_thread.joinable()) {
             impl_->server_thread.join();
         }
         
+        // Drop queued requests and let in-flight ones finish
+        {
+            std::lock_guard<std::mutex> lock(impl_->queue_mutex);
+            impl_->workers_running = false;
+            impl_->pending_requests.clear();
+        }
+        impl_->queue_cv.notify_all();
+        for (auto& worker : impl_->workers) {
+            worker.join();
+        }
+        impl_->workers.clear();
+        
+        {
+            std::lock_guard<std::mutex> lock(impl_->completed_mutex);
+            impl_->completed_responses.clear();
+            impl_->stream_events.clear();
+        }
+        impl_->releaseSockets();
+        
         if (impl_->log_handler) {
             impl_->log_handler("API Server stopped");
         }
@@ -144,18 +606,25 @@ bool ApiServer::isRunning() const {
     return impl_->running.load();
 }
 
+void ApiServer::setWorkerThreads(size_t count) {
+    impl_->worker_count = count;
+}
+
 void ApiServer::addRoute(HttpMethod method, const std::string& path, ApiHandler handler) {
-    std::string method_str;
-    switch (method) {
-        case HttpMethod::GET: method_str = "GET"; break;
-        case HttpMethod::POST: method_str = "POST"; break;
-        case HttpMethod::PUT: method_str = "PUT"; break;
-        case HttpMethod::DELETE: method_str = "DELETE"; break;
-        case HttpMethod::PATCH: method_str = "PATCH"; break;
+    std::string route_key = std::string(methodName(method)) + " " + path;
+    size_t route = impl_->router.add(method, path);
+    if (route == HttpRouter::NO_ROUTE) {
+        if (impl_->log_handler) {
+            impl_->log_handler("Route rejected, {name} must be a whole path segment: " + route_key);
+        }
+        return;
     }
-    
-    std::string route_key = method_str + " " + path;
-    impl_->routes[route_key] = handler;
+    if (route == impl_->handlers.size()) {
+        impl_->handlers.push_back(std::move(handler));
+    } else {
+        impl_->handlers[route] = std::move(handler);
+    }
+    impl_->route_paths.insert(path);
     
     if (impl_->log_handler) {
         impl_->log_handler("Route added: " + route_key);
@@ -168,12 +637,21 @@ void ApiServer::addMiddleware(std::function<bool(ApiRequest&, ApiResponse&)> mid
 
 void ApiServer::setAuthHandler(std::function<bool(const std::string& token, std::string& user_id)> auth_handler) {
     impl_->auth_handler = auth_handler;
+    impl_->auth_cache.clear();  // Answers of the previous handler
 }
 
 void ApiServer::requireAuth(const std::string& path) {
     impl_->protected_paths.insert(path);
 }
 
+void ApiServer::setAuthCacheTtl(std::chrono::seconds accepted, std::chrono::seconds refused) {
+    impl_->auth_cache.setTtl(accepted, refused);
+}
+
+void ApiServer::revokeToken(const std::string& token) {
+    impl_->auth_cache.revoke(token);
+}
+
 void ApiServer::setRateLimit(const std::string& path, const RateLimit& limit) {
     impl_->rate_limits[path] = limit;
 }
@@ -185,14 +663,55 @@ void ApiServer::setGlobalRateLimit(const RateLimit& limit) {
 void ApiServer::enableCors(const std::string& allowed_origins) {
     impl_->cors_enabled = true;
     impl_->cors_origins = allowed_origins;
+    impl_->compileCorsHeaders();
 }
 
 void ApiServer::setCorsHeaders(const std::unordered_map<std::string, std::string>& headers) {
     impl_->cors_headers = headers;
+    impl_->compileCorsHeaders();
+}
+
+void ApiServer::addEventStream(const std::string& path) {
+    addRoute(HttpMethod::GET, path, [path](const ApiRequest&) {
+        ApiResponse response;
+        response.headers["Content-Type"] = "text/event-stream";
+        response.event_stream = path;
+        return response;
+    });
+}
+
+void ApiServer::broadcastEvent(const std::string& path, const std::string& event, const std::string& data) {
+    // Serialize once; every subscriber is sent the same bytes
+    std::string payload = "event: " + event + "\n";
+    size_t start = 0;
+    while (true) {
+        size_t end = data.find('\n', start);
+        payload += "data: " + data.substr(start, end - start) + "\n";
+        if (end == std::string::npos) break;
+        start = end + 1;
+    }
+    payload += "\n";
+    auto shared = std::make_shared<const std::string>(std::move(payload));
+    
+    {
+        std::lock_guard<std::mutex> lock(impl_->completed_mutex);
+        impl_->last_events[path] = shared;
+        if (impl_->running.load()) {
+            impl_->stream_events.push_back({path, std::move(shared)});
+            impl_->wake();  // Under the lock so stop() cannot close the pipe meanwhile
+        }
+    }
+}
+
+size_t ApiServer::getEventSubscriberCount() const {
+    return impl_->subscriber_count.load();
 }
 
 void ApiServer::addWebhook(const std::string& event, const std::string& url) {
     impl_->webhooks[event].push_back(url);
+    if (!impl_->webhook_dispatcher) {
+        impl_->webhook_dispatcher = std::make_unique<WebhookDispatcher>();
+    }
 }
 
 void ApiServer::removeWebhook(const std::string& event, const std::string& url) {
@@ -201,16 +720,14 @@ void ApiServer::removeWebhook(const std::string& event, const std::string& url)
 }
 
 void ApiServer::triggerWebhook(const std::string& event, const std::string& payload) {
-    // Suppress unused parameter warning for mock implementation
-    (void)payload;
-    
+    // An enqueue per URL; delivery, coalescing and retries happen on the dispatcher's thread
     auto it = impl_->webhooks.find(event);
-    if (it != impl_->webhooks.end()) {
-        for (const auto& url : it->second) {
-            // In a real implementation, this would make HTTP POST requests to the webhook URLs
-            if (impl_->log_handler) {
-                impl_->log_handler("Triggering webhook: " + event + " -> " + url);
-            }
+    if (it == impl_->webhooks.end()) {
+        return;
+    }
+    for (const auto& url : it->second) {
+        if (!impl_->webhook_dispatcher->enqueue(url, event, payload) && impl_->log_handler) {
+            impl_->log_handler("Webhook queue full, dropped: " + event + " -> " + url);
         }
     }
 }
@@ -228,41 +745,18 @@ void ApiServer::setLogHandler(std::function<void(const std::string& message)> ha
 }
 
 bool ApiServer::checkRateLimit(const std::string& client_ip, const std::string& path) {
-    auto now = std::chrono::steady_clock::now();
-    auto& client_requests = impl_->rate_limit_tracker[client_ip][path];
-    
-    // Clean old requests (older than 1 day)
-    auto day_ago = now - std::chrono::hours(24);
-    client_requests.erase(
-        std::remove_if(client_requests.begin(), client_requests.end(),
-            [day_ago](const auto& time) { return time < day_ago; }),
-        client_requests.end()
-    );
-    
-    // Check rate limits
+    // Called from every worker thread
     RateLimit limit = impl_->global_rate_limit;
     auto it = impl_->rate_limits.find(path);
     if (it != impl_->rate_limits.end()) {
         limit = it->second;
     }
     
-    auto minute_ago = now - std::chrono::minutes(1);
-    auto hour_ago = now - std::chrono::hours(1);
-    
-    int requests_last_minute = std::count_if(client_requests.begin(), client_requests.end(),
-        [minute_ago](const auto& time) { return time > minute_ago; });
-    int requests_last_hour = std::count_if(client_requests.begin(), client_requests.end(),
-        [hour_ago](const auto& time) { return time > hour_ago; });
-    int requests_last_day = client_requests.size();
-    
-    if (requests_last_minute >= limit.requests_per_minute ||
-        requests_last_hour >= limit.requests_per_hour ||
-        requests_last_day >= limit.requests_per_day) {
-        return false;
-    }
-    
-    client_requests.push_back(now);
-    return true;
+    // Paths without a route share one key per client, so probing for them
+    // cannot mint new keys
+    static const std::string unrouted;
+    const std::string& route = impl_->route_paths.count(path) ? path : unrouted;
+    return impl_->rate_limiter.allow(client_ip, route, limit);
 }
 
 bool ApiServer::authenticate(ApiRequest& request) {
@@ -283,56 +777,64 @@ bool ApiServer::authenticate(ApiRequest& request) {
         return false;
     }
     
-    auto auth_header = request.headers.find("Authorization");
-    if (auth_header == request.headers.end()) {
+    const std::string* auth_header = findHeader(request, "authorization");
+    if (!auth_header) {
         return false;
     }
     
-    std::string token = auth_header->second;
+    std::string token = *auth_header;
     if (token.substr(0, 7) == "Bearer ") {
         token = token.substr(7);
     }
     
-    return impl_->auth_handler(token, request.user_id);
+    uint64_t generation = 0;
+    switch (impl_->auth_cache.find(token, request.user_id, generation)) {
+        case AuthCache::Lookup::ACCEPTED: return true;
+        case AuthCache::Lookup::REFUSED: return false;
+        case AuthCache::Lookup::MISS: break;
+    }
+    
+    bool accepted = impl_->auth_handler(token, request.user_id);
+    impl_->auth_cache.store(token, accepted, request.user_id, generation);
+    return accepted;
 }
 
-ApiResponse ApiServer::handleRequest(const ApiRequest& request) {
+ApiResponse ApiServer::handleRequest(ApiRequest& request) {
+    TRACE_SCOPE("api_request");
     // Apply middlewares
-    ApiRequest mutable_request = request;
     ApiResponse response;
     
     for (auto& middleware : impl_->middlewares) {
-        if (!middleware(mutable_request, response)) {
+        if (!middleware(request, response)) {
             return response;  // Middleware rejected the request
         }
     }
     
+    // Route once; a parameterized route is one rate limit key, like a fixed path
+    thread_local std::vector<std::string_view> values;
+    size_t route = impl_->router.match(request.method, request.path, values);
+    if (route != HttpRouter::NO_ROUTE) {
+        const std::vector<std::string>& names = impl_->router.params(route);
+        for (size_t i = 0; i < values.size(); ++i) {
+            request.path_params[names[i]] = impl_->urlDecode(values[i]);
+        }
+    }
+    
     // Check rate limiting
-    if (!checkRateLimit(request.client_ip, request.path)) {
+    const std::string& rate_key = route != HttpRouter::NO_ROUTE ? impl_->router.pattern(route) : request.path;
+    if (!checkRateLimit(request.client_ip, rate_key)) {
         return impl_->error_handler(429, "Rate limit exceeded");
     }
     
     // Authenticate
-    if (!authenticate(mutable_request)) {
+    if (!authenticate(request)) {
         return impl_->error_handler(401, "Unauthorized");
     }
     
-    // Find and execute handler
-    std::string method_str;
-    switch (request.method) {
-        case HttpMethod::GET: method_str = "GET"; break;
-        case HttpMethod::POST: method_str = "POST"; break;
-        case HttpMethod::PUT: method_str = "PUT"; break;
-        case HttpMethod::DELETE: method_str = "DELETE"; break;
-        case HttpMethod::PATCH: method_str = "PATCH"; break;
-    }
-    
-    std::string route_key = method_str + " " + request.path;
-    auto it = impl_->routes.find(route_key);
-    
-    if (it != impl_->routes.end()) {
+    // Execute handler
+    if (route != HttpRouter::NO_ROUTE) {
         try {
-            response = it->second(mutable_request);
+            response = impl_->handlers[route](request);
         } catch (const std::exception& e) {
             response = impl_->error_handler(500, "Internal server error: " + std::string(e.what()));
         }
@@ -340,32 +842,13 @@ ApiResponse ApiServer::handleRequest(const ApiRequest& request) {
         response = impl_->error_handler(404, "Not found");
     }
     
-    // Add CORS headers if enabled
-    if (impl_->cors_enabled) {
-        response.headers["Access-Control-Allow-Origin"] = impl_->cors_origins;
-        response.headers["Access-Control-Allow-Methods"] = "GET, POST, PUT, DELETE, PATCH, OPTIONS";
-        response.headers["Access-Control-Allow-Headers"] = "Content-Type, Authorization";
-        
-        for (const auto& header : impl_->cors_headers) {
-            response.headers[header.first] = header.second;
-        }
-    }
-    
-    return response;
+    negotiateEncoding(request, response);
+    return response;  // CORS headers are added as it is formatted
 }
 
 void ApiServer::logRequest(const ApiRequest& request, const ApiResponse& response) {
     if (impl_->log_handler) {
-        std::string method_str;
-        switch (request.method) {
-            case HttpMethod::GET: method_str = "GET"; break;
-            case HttpMethod::POST: method_str = "POST"; break;
-            case HttpMethod::PUT: method_str = "PUT"; break;
-            case HttpMethod::DELETE: method_str = "DELETE"; break;
-            case HttpMethod::PATCH: method_str = "PATCH"; break;
-        }
-        
-        std::string log_message = request.client_ip + " " + method_str + " " + 
+        std::string log_message = request.client_ip + " " + methodName(request.method) + " " + 
                                  request.path + " " + std::to_string(response.status_code);
         impl_->log_handler(log_message);
     }
@@ -390,68 +873,544 @@ ApiResponse successResponse(const std::string& message) {
     return jsonResponse(json, 200);
 }
 
-// Implementation of server loop and HTTP parsing
-void ApiServer::Impl::serverLoop(ApiServer* server) {
+// Implementation of the event loop and worker pool.
+// A single thread multiplexes every socket: it accepts, reads requests
+// incrementally until headers and Content-Length body are complete, and
+// writes responses back. Handlers run on a fixed pool of workers, which hand
+// the formatted response back through a queue and wake the loop via a pipe.
+void ApiServer::Impl::serverLoop() {
+    std::vector<PollEvent> events;
+    
     while (running.load()) {
+        // Time out at least once a second to retire idle keep-alive connections
+        if (poller.wait(events, POLL_INTERVAL_MS) < 0) {
+            if (errno != EINTR && log_handler) {
+                log_handler("Event loop wait failed");
+            }
+            continue;
+        }
+        
+        for (const auto& event : events) {
+            if (event.fd == server_socket) {
+                acceptConnections();
+                continue;
+            }
+            if (event.fd == wake_pipe[0]) {
+                char drain[64];
+                while (read(wake_pipe[0], drain, sizeof(drain)) > 0) {}
+                continue;
+            }
+            
+            auto it = connections.find(event.fd);
+            if (it == connections.end()) {
+                continue;
+            }
+            if (event.readable) {
+                readConnection(event.fd, it->second);
+                it = connections.find(event.fd);
+                if (it == connections.end()) {
+                    continue;
+                }
+            }
+            if (event.writable && !flushConnection(event.fd, it->second)) {
+                continue;
+            }
+            if (event.error && !event.readable) {
+                closeConnection(event.fd);
+            }
+        }
+        
+        deliverQueued();
+        closeIdleConnections();
+    }
+    
+    for (const auto& entry : connections) {
+        poller.remove(entry.first);
+        close(entry.first);
+    }
+    connections.clear();
+    subscriber_count.store(0);
+}
+
+void ApiServer::Impl::workerLoop(ApiServer* server) {
+    Tracer::shared().setThreadName("api-worker");
+    while (true) {
+        PendingRequest job;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_cv.wait(lock, [this] { return !pending_requests.empty() || !workers_running; });
+            if (!workers_running) {
+                return;
+            }
+            job = std::move(pending_requests.front());
+            pending_requests.pop_front();
+        }
+        
+        ApiResponse response = server->handleRequest(job.request);
+        server->logRequest(job.request, response);
+        
+        if (response.body_stream) {
+            streamResponse(job, response);
+        } else {
+            complete(job, formatHttpResponse(response, job.keep_alive), job.keep_alive, true,
+                     response.event_stream);
+        }
+    }
+}
+
+void ApiServer::Impl::streamResponse(const PendingRequest& job, ApiResponse& response) {
+    if (!job.chunked_ok) {
+        // HTTP/1.0 has no chunked encoding; collect the body and send it with a length
+        std::string body;
+        try {
+            response.body_stream([&body](const std::string& chunk) { body += chunk; });
+        } catch (const std::exception& e) {
+            response = error_handler(500, "Internal server error: " + std::string(e.what()));
+            body = response.body;
+        }
+        response.body = std::move(body);
+        response.body_stream = nullptr;
+        complete(job, formatHttpResponse(response, job.keep_alive), job.keep_alive, true);
+        return;
+    }
+    
+    // Headers go out first; each chunk is handed to the event loop as it is produced
+    complete(job, formatHttpResponse(response, job.keep_alive), job.keep_alive, false);
+    bool finished = true;
+    try {
+        response.body_stream([this, &job](const std::string& chunk) {
+            if (chunk.empty()) return;  // A zero-length chunk would end the body
+            std::ostringstream framed;
+            framed << std::hex << chunk.size() << "\r\n" << chunk << "\r\n";
+            complete(job, framed.str(), job.keep_alive, false);
+        });
+    } catch (const std::exception& e) {
+        finished = false;
+        if (log_handler) {
+            log_handler("Streamed response aborted: " + std::string(e.what()));
+        }
+    }
+    
+    // Without the terminating chunk the client sees a truncated body, so close
+    complete(job, finished ? "0\r\n\r\n" : "", job.keep_alive && finished, true);
+}
+
+void ApiServer::Impl::complete(const PendingRequest& job, std::string data, bool keep_alive, bool final,
+                               std::string event_stream) {
+    {
+        std::lock_guard<std::mutex> lock(completed_mutex);
+        completed_responses.push_back({job.fd, job.connection_id, std::move(data), keep_alive,
+                                       std::move(event_stream), final});
+    }
+    wake();
+}
+
+void ApiServer::Impl::acceptConnections() {
+    while (true) {
         struct sockaddr_in client_addr;
         socklen_t client_len = sizeof(client_addr);
         
         int client_socket = accept(server_socket, (struct sockaddr*)&client_addr, &client_len);
-        
         if (client_socket < 0) {
-            if (running.load()) {
-                // Only log if we're still supposed to be running
-                if (log_handler) {
-                    log_handler("Accept failed");
-                }
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK && log_handler) {
+                log_handler("Accept failed");
             }
+            return;
+        }
+        
+        // Responses are small and latency matters more than packet count
+        int opt = 1;
+        setsockopt(client_socket, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+#ifdef SO_NOSIGPIPE
+        setsockopt(client_socket, SOL_SOCKET, SO_NOSIGPIPE, &opt, sizeof(opt));
+#endif
+        if (!setNonBlocking(client_socket) || !poller.add(client_socket)) {
+            close(client_socket);
             continue;
         }
         
-        // Handle request in a separate thread for better concurrency
-        std::thread([this, client_socket, server, client_addr]() {
-            char buffer[4096];
-            ssize_t bytes_read = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
-            
-            if (bytes_read > 0) {
-                buffer[bytes_read] = '\0';
-                std::string raw_request(buffer);
-                
-                ApiRequest request;
-                request.client_ip = inet_ntoa(client_addr.sin_addr);
-                
-                std::string parse_error = parseHttpRequest(raw_request, request);
-                ApiResponse response;
-                
-                if (!parse_error.empty()) {
-                    response = server->impl_->error_handler(400, "Bad Request: " + parse_error);
-                } else {
-                    response = server->handleRequest(request);
-                }
-                
-                std::string http_response = formatHttpResponse(response);
-                send(client_socket, http_response.c_str(), http_response.length(), 0);
-                
-                server->logRequest(request, response);
+        char ip[INET_ADDRSTRLEN] = {0};
+        inet_ntop(AF_INET, &client_addr.sin_addr, ip, sizeof(ip));
+        
+        Connection& connection = connections[client_socket];
+        connection.id = next_connection_id++;
+        connection.client_ip = ip;
+        connection.last_activity = std::chrono::steady_clock::now();
+    }
+}
+
+void ApiServer::Impl::readConnection(int fd, Connection& connection) {
+    char buffer[READ_CHUNK_SIZE];
+    
+    while (true) {
+        ssize_t bytes_read = recv(fd, buffer, sizeof(buffer), 0);
+        if (bytes_read > 0) {
+            if (!connection.event_stream.empty()) {
+                continue;  // Subscribers have nothing more to say
             }
-            
-            close(client_socket);
-        }).detach();
+            connection.in_buffer.append(buffer, static_cast<size_t>(bytes_read));
+            connection.last_activity = std::chrono::steady_clock::now();
+            if (connection.in_buffer.size() > MAX_HEADER_BYTES + MAX_BODY_BYTES) {
+                closeConnection(fd);  // Client is pipelining far more than we will buffer
+                return;
+            }
+            continue;
+        }
+        if (bytes_read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes_read < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (bytes_read < 0) {
+            closeConnection(fd);
+            return;
+        }
+        
+        // Peer shut down its side; answer the request in flight before closing
+        connection.read_closed = true;
+        connection.close_after_write = true;
+        poller.update(fd, false, connection.want_write);
+        break;
+    }
+    
+    dispatchRequests(fd, connection);
+    
+    auto it = connections.find(fd);
+    if (it != connections.end() && it->second.read_closed && !it->second.busy &&
+        it->second.out_offset >= it->second.out_buffer.size()) {
+        closeConnection(fd);
     }
 }
 
-std::string ApiServer::Impl::parseHttpRequest(const std::string& raw_request, ApiRequest& request) {
-    std::istringstream stream(raw_request);
-    std::string line;
+void ApiServer::Impl::dispatchRequests(int fd, Connection& connection) {
+    // One request in flight per connection keeps pipelined responses in order
+    if (connection.busy || !connection.event_stream.empty()) {
+        return;
+    }
+    
+    if (!connection.headers_parsed) {
+        // Resumes where the last read left off, less the terminator's first three bytes
+        size_t header_end = connection.in_buffer.find("\r\n\r\n", connection.header_scan);
+        if (header_end == std::string::npos) {
+            connection.header_scan = connection.in_buffer.size() < 3 ? 0 : connection.in_buffer.size() - 3;
+            if (connection.in_buffer.size() > MAX_HEADER_BYTES) {
+                rejectRequest(fd, connection, 431, "Request header too large");
+            }
+            return;
+        }
+        if (header_end > MAX_HEADER_BYTES) {
+            rejectRequest(fd, connection, 431, "Request header too large");
+            return;
+        }
+        
+        connection.header_scan = 0;
+        
+        ApiRequest request;
+        request.client_ip = connection.client_ip;
+        std::string_view version;
+        std::string parse_error = parseHttpRequest(std::string_view(connection.in_buffer).substr(0, header_end + 2),
+                                                   request, version);
+        if (!parse_error.empty()) {
+            rejectRequest(fd, connection, 400, "Bad Request: " + parse_error);
+            return;
+        }
+        
+        if (findHeader(request, "transfer-encoding")) {
+            rejectRequest(fd, connection, 411, "Chunked request bodies are not supported");
+            return;
+        }
+        
+        size_t body_length = 0;
+        if (const std::string* length = findHeader(request, "content-length")) {
+            char* end = nullptr;
+            errno = 0;
+            unsigned long long value = std::strtoull(length->c_str(), &end, 10);
+            if (length->empty() || *end != '\0' || errno == ERANGE) {
+                rejectRequest(fd, connection, 400, "Bad Request: Invalid Content-Length");
+                return;
+            }
+            if (value > MAX_BODY_BYTES) {
+                rejectRequest(fd, connection, 413, "Request body too large");
+                return;
+            }
+            body_length = static_cast<size_t>(value);
+        }
+        
+        std::string connection_header;
+        if (const std::string* value = findHeader(request, "connection")) {
+            connection_header = toLower(*value);
+        }
+        connection.http11 = version == "HTTP/1.1";
+        connection.keep_alive = connection.http11 ? connection_header != "close"
+                                                  : connection_header == "keep-alive";
+        
+        connection.request = std::move(request);
+        connection.body_start = header_end + 4;
+        connection.body_length = body_length;
+        connection.headers_parsed = true;
+        connection.in_buffer.reserve(connection.body_start + body_length);
+        
+        // curl and others hold large bodies back until told to go ahead
+        const std::string* expect = findHeader(connection.request, "expect");
+        if (expect && toLower(*expect) == "100-continue" &&
+            connection.in_buffer.size() < connection.body_start + body_length) {
+            connection.out_buffer += "HTTP/1.1 100 Continue\r\n\r\n";
+            if (!flushConnection(fd, connection)) {
+                return;
+            }
+        }
+    }
+    
+    if (connection.in_buffer.size() < connection.body_start + connection.body_length) {
+        return;  // Body still arriving
+    }
+    
+    PendingRequest job;
+    job.fd = fd;
+    job.connection_id = connection.id;
+    job.request = std::move(connection.request);
+    job.request.body.assign(connection.in_buffer, connection.body_start, connection.body_length);
+    job.keep_alive = connection.keep_alive && !connection.read_closed;
+    job.chunked_ok = connection.http11;
+    connection.in_buffer.erase(0, connection.body_start + connection.body_length);
+    connection.headers_parsed = false;
+    connection.request = ApiRequest();
+    
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (pending_requests.size() < MAX_PENDING_REQUESTS) {
+            pending_requests.push_back(std::move(job));
+            connection.busy = true;
+        }
+    }
+    if (!connection.busy) {
+        rejectRequest(fd, connection, 503, "Server busy");
+        return;
+    }
+    queue_cv.notify_one();
+}
+
+void ApiServer::Impl::rejectRequest(int fd, Connection& connection, int status, const std::string& message) {
+    // Framing is unreliable after a protocol error, so the connection ends here
+    connection.in_buffer.clear();
+    connection.header_scan = 0;
+    connection.headers_parsed = false;
+    connection.close_after_write = true;
+    connection.out_buffer += formatHttpResponse(error_handler(status, message), false);
+    flushConnection(fd, connection);
+}
+
+bool ApiServer::Impl::flushConnection(int fd, Connection& connection) {
+    while (connection.out_offset < connection.out_buffer.size()) {
+        ssize_t sent = send(fd, connection.out_buffer.data() + connection.out_offset,
+                            connection.out_buffer.size() - connection.out_offset, SEND_FLAGS);
+        if (sent > 0) {
+            connection.out_offset += static_cast<size_t>(sent);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!connection.want_write) {
+                connection.want_write = true;
+                poller.update(fd, !connection.read_closed, true);
+            }
+            return true;
+        }
+        closeConnection(fd);
+        return false;
+    }
+    
+    connection.out_buffer.clear();
+    connection.out_offset = 0;
+    connection.last_activity = std::chrono::steady_clock::now();
+    if (connection.want_write) {
+        connection.want_write = false;
+        poller.update(fd, !connection.read_closed, false);
+    }
+    if (connection.close_after_write && !connection.busy) {
+        closeConnection(fd);
+        return false;
+    }
+    return true;
+}
+
+void ApiServer::Impl::closeConnection(int fd) {
+    auto it = connections.find(fd);
+    if (it != connections.end() && !it->second.event_stream.empty()) {
+        subscriber_count.fetch_sub(1);
+    }
+    poller.remove(fd);
+    close(fd);
+    connections.erase(fd);
+}
+
+void ApiServer::Impl::deliverQueued() {
+    std::vector<CompletedResponse> ready;
+    std::vector<StreamEvent> events;
+    std::unordered_map<std::string, std::shared_ptr<const std::string>> replay;
+    {
+        std::lock_guard<std::mutex> lock(completed_mutex);
+        ready.swap(completed_responses);
+        events.swap(stream_events);
+        // Latest events as of this batch; anything newer reaches new subscribers live
+        for (const auto& done : ready) {
+            if (!done.event_stream.empty()) {
+                replay = last_events;
+                break;
+            }
+        }
+    }
+    
+    // Events first, so subscribers added below are not sent their replay twice
+    for (const auto& event : events) {
+        std::vector<int> targets;
+        for (const auto& entry : connections) {
+            if (entry.second.event_stream == event.stream) {
+                targets.push_back(entry.first);
+            }
+        }
+        for (int fd : targets) {
+            Connection& connection = connections[fd];
+            if (connection.out_buffer.size() - connection.out_offset > MAX_SUBSCRIBER_BACKLOG) {
+                closeConnection(fd);  // Too slow to keep up
+                continue;
+            }
+            connection.out_buffer += *event.payload;
+            flushConnection(fd, connection);
+        }
+    }
+    
+    for (auto& done : ready) {
+        auto it = connections.find(done.fd);
+        if (it == connections.end() || it->second.id != done.connection_id) {
+            continue;  // Client went away while the handler ran
+        }
+        
+        Connection& connection = it->second;
+        if (!done.final) {
+            connection.out_buffer += done.data;
+            flushConnection(done.fd, connection);
+            continue;
+        }
+        connection.busy = false;
+        connection.out_buffer += done.data;
+        if (!done.event_stream.empty() && !connection.read_closed) {
+            connection.event_stream = done.event_stream;
+            connection.close_after_write = false;
+            connection.in_buffer.clear();
+            subscriber_count.fetch_add(1);
+            auto last = replay.find(done.event_stream);
+            if (last != replay.end()) {
+                connection.out_buffer += *last->second;
+            }
+            flushConnection(done.fd, connection);
+            continue;
+        }
+        if (!done.keep_alive) {
+            connection.close_after_write = true;
+        }
+        if (flushConnection(done.fd, connection) && !connection.close_after_write) {
+            dispatchRequests(done.fd, connection);  // Next pipelined request, if any
+        }
+    }
+}
+
+void ApiServer::Impl::closeIdleConnections() {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<int> idle;
+    for (const auto& entry : connections) {
+        const Connection& connection = entry.second;
+        if (!connection.busy && connection.out_buffer.empty() &&
+            now - connection.last_activity > KEEP_ALIVE_TIMEOUT) {
+            idle.push_back(entry.first);
+        }
+    }
+    for (int fd : idle) {
+        Connection& connection = connections[fd];
+        if (connection.event_stream.empty()) {
+            closeConnection(fd);
+        } else {
+            // SSE comment line keeps proxies from timing the stream out
+            connection.out_buffer += ": keep-alive\n\n";
+            flushConnection(fd, connection);
+        }
+    }
+}
+
+void ApiServer::Impl::wake() {
+    if (wake_pipe[1] >= 0) {
+        char byte = 1;
+        // A full pipe already guarantees a wakeup
+        [[maybe_unused]] ssize_t written = write(wake_pipe[1], &byte, 1);
+    }
+}
+
+void ApiServer::Impl::releaseSockets() {
+    poller.close();
+    if (server_socket >= 0) {
+        close(server_socket);
+        server_socket = -1;
+    }
+    std::lock_guard<std::mutex> lock(completed_mutex);
+    for (int& fd : wake_pipe) {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+}
+
+void ApiServer::Impl::compileCorsHeaders() {
+    std::unordered_map<std::string, std::string> headers = {
+        {"Access-Control-Allow-Origin", cors_origins},
+        {"Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, PATCH, OPTIONS"},
+        {"Access-Control-Allow-Headers", "Content-Type, Authorization"}
+    };
+    for (const auto& header : cors_headers) {
+        headers[header.first] = header.second;
+    }
+    
+    cors_block.clear();
+    cors_names.clear();
+    for (const auto& header : headers) {
+        cors_block += header.first + ": " + header.second + "\r\n";
+        cors_names.insert(header.first);
+    }
+}
+
+// Parses the request line and headers in place; only the parts kept in
+// request are copied. The body is framed by Content-Length in dispatchRequests.
+std::string ApiServer::Impl::parseHttpRequest(std::string_view head, ApiRequest& request,
+                                              std::string_view& version) {
+    auto nextLine = [&head]() {
+        size_t end = head.find('\n');
+        std::string_view line = head.substr(0, end);
+        head.remove_prefix(end == std::string_view::npos ? head.size() : end + 1);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        return line;
+    };
+    auto nextWord = [](std::string_view& text) {
+        size_t start = std::min(text.find_first_not_of(' '), text.size());
+        size_t end = std::min(text.find(' ', start), text.size());
+        std::string_view word = text.substr(start, end - start);
+        text.remove_prefix(end);
+        return word;
+    };
     
     // Parse request line
-    if (!std::getline(stream, line)) {
+    std::string_view line = nextLine();
+    if (line.empty()) {
         return "Missing request line";
     }
-    
-    std::istringstream request_line(line);
-    std::string method_str, path, version;
-    request_line >> method_str >> path >> version;
+    std::string_view method_str = nextWord(line);
+    std::string_view target = nextWord(line);
+    version = nextWord(line);
     
     // Parse method
     if (method_str == "GET") request.method = HttpMethod::GET;
@@ -459,123 +1418,112 @@ std::string ApiServer::Impl::parseHttpRequest(const std::string& raw_request, Ap
     else if (method_str == "PUT") request.method = HttpMethod::PUT;
     else if (method_str == "DELETE") request.method = HttpMethod::DELETE;
     else if (method_str == "PATCH") request.method = HttpMethod::PATCH;
-    else return "Unsupported method: " + method_str;
+    else return "Unsupported method: " + std::string(method_str);
     
-    // Parse path and query parameters
-    size_t query_pos = path.find('?');
-    if (query_pos != std::string::npos) {
-        std::string query_string = path.substr(query_pos + 1);
-        path = path.substr(0, query_pos);
-        
-        // Parse query parameters with URL decoding
-        std::istringstream query_stream(query_string);
-        std::string param;
-        while (std::getline(query_stream, param, '&')) {
+    // Parse path and query parameters, URL decoding both keys and values
+    size_t query_pos = target.find('?');
+    if (query_pos != std::string_view::npos) {
+        std::string_view query_string = target.substr(query_pos + 1);
+        while (!query_string.empty()) {
+            size_t amp = std::min(query_string.find('&'), query_string.size());
+            std::string_view param = query_string.substr(0, amp);
+            query_string.remove_prefix(std::min(amp + 1, query_string.size()));
             size_t eq_pos = param.find('=');
-            if (eq_pos != std::string::npos) {
-                std::string key = param.substr(0, eq_pos);
-                std::string value = param.substr(eq_pos + 1);
-                
-                // URL decode both key and value
-                key = this->urlDecode(key);
-                value = this->urlDecode(value);
-                
-                request.query_params[key] = value;
+            if (eq_pos != std::string_view::npos) {
+                request.query_params[urlDecode(param.substr(0, eq_pos))] = urlDecode(param.substr(eq_pos + 1));
             }
         }
     }
-    
-    request.path = path;
+    request.path.assign(target.substr(0, query_pos));
     
     // Parse headers
-    while (std::getline(stream, line) && line != "\r" && !line.empty()) {
+    while (!(line = nextLine()).empty()) {
         size_t colon_pos = line.find(':');
-        if (colon_pos != std::string::npos) {
-            std::string header_name = line.substr(0, colon_pos);
-            std::string header_value = line.substr(colon_pos + 1);
+        if (colon_pos != std::string_view::npos) {
+            std::string_view header_value = line.substr(colon_pos + 1);
             
             // Trim whitespace
-            header_value.erase(0, header_value.find_first_not_of(" \t"));
-            header_value.erase(header_value.find_last_not_of(" \t\r") + 1);
+            size_t first = header_value.find_first_not_of(" \t");
+            header_value = first == std::string_view::npos ? std::string_view()
+                                                           : header_value.substr(first, header_value.find_last_not_of(" \t") + 1 - first);
             
-            request.headers[header_name] = header_value;
+            request.headers[std::string(line.substr(0, colon_pos))] = header_value;
         }
     }
     
-    // Parse body (if present)
-    std::string body_line;
-    while (std::getline(stream, body_line)) {
-        request.body += body_line + "\n";
-    }
-    
-    if (!request.body.empty()) {
-        request.body.pop_back(); // Remove last newline
-    }
-    
     return ""; // Success
 }
 
-std::string ApiServer::Impl::formatHttpResponse(const ApiResponse& response) {
-    std::ostringstream http_response;
-    
-    http_response << "HTTP/1.1 " << response.status_code << " ";
+std::string ApiServer::Impl::formatHttpResponse(const ApiResponse& response, bool keep_alive) {
+    std::string http_response;
+    http_response.reserve(256 + cors_block.size() + response.body.size());
     
-    // Status text
-    switch (response.status_code) {
-        case 200: http_response << "OK"; break;
-        case 400: http_response << "Bad Request"; break;
-        case 401: http_response << "Unauthorized"; break;
-        case 404: http_response << "Not Found"; break;
-        case 429: http_response << "Too Many Requests"; break;
-        case 500: http_response << "Internal Server Error"; break;
-        default: http_response << "Unknown"; break;
+    std::string_view status_line = statusLine(response.status_code);
+    if (!status_line.empty()) {
+        http_response += status_line;
+    } else {
+        http_response += "HTTP/1.1 " + std::to_string(response.status_code) + " Unknown\r\n";
     }
     
-    http_response << "\r\n";
-    
-    // Headers
+    // Headers; the CORS lines replace any the handler set itself
     for (const auto& header : response.headers) {
-        http_response << header.first << ": " << header.second << "\r\n";
+        if (cors_enabled && cors_names.count(header.first)) continue;
+        http_response += header.first;
+        http_response += ": ";
+        http_response += header.second;
+        http_response += "\r\n";
+    }
+    if (cors_enabled) {
+        http_response += cors_block;
     }
     
-    http_response << "Content-Length: " << response.body.length() << "\r\n";
-    http_response << "\r\n";
-    http_response << response.body;
+    std::string_view connection_line = keep_alive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    if (response.body_stream) {
+        http_response += "Transfer-Encoding: chunked\r\n";
+        http_response += connection_line;
+    } else if (response.event_stream.empty()) {
+        http_response += "Content-Length: ";
+        http_response += std::to_string(response.body.length());
+        http_response += "\r\n";
+        http_response += connection_line;
+    } else {
+        // Event streams are unbounded and end when either side closes
+        http_response += "Cache-Control: no-cache\r\n";
+        http_response += "Connection: keep-alive\r\n";
+    }
+    http_response += "\r\n";
+    http_response += response.body;
     
-    return http_response.str();
+    return http_response;
 }
 
 // URL decoding utility function
 // Handles percent-encoded characters like %20 (space), %3A (:), etc.
 // Also converts '+' to space as per HTML form encoding standard
-std::string ApiServer::Impl::urlDecode(const std::string& encoded) {
+std::string ApiServer::Impl::urlDecode(std::string_view encoded) {
+    auto hexValue = [](char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+    
     std::string decoded;
     decoded.reserve(encoded.length());
     
     for (size_t i = 0; i < encoded.length(); ++i) {
-        if (encoded[i] == '%' && i + 2 < encoded.length()) {
-            // Get the two hex digits after %
-            std::string hex = encoded.substr(i + 1, 2);
-            
-            // Convert hex to integer
-            char* end;
-            unsigned long value = std::strtoul(hex.c_str(), &end, 16);
-            
-            // If conversion was successful and within valid range
-            if (*end == '\0' && value <= 255) {
-                decoded += static_cast<char>(value);
-                i += 2; // Skip the two hex digits
-            } else {
-                // Invalid hex sequence, keep the % as is
-                decoded += encoded[i];
-            }
+        if (encoded[i] == '%' && i + 2 < encoded.length() && hexValue(encoded[i + 1]) >= 0 &&
+            hexValue(encoded[i + 2]) >= 0) {
+            decoded += static_cast<char>(hexValue(encoded[i + 1]) * 16 + hexValue(encoded[i + 2]));
+            i += 2; // Skip the two hex digits
         } else if (encoded[i] == '+') {
             // '+' is encoded space in query parameters
             decoded += ' ';
         } else {
+            // Invalid hex sequences keep the % as is
             decoded += encoded[i];
         }
     }
     
     return decoded;
-}
\ No newline at end of file
+}
@@ -2,6 +2,7 @@
 #define API_SERVER_H
 
 #include <string>
+#include <chrono>
 #include <functional>
 #include <unordered_map>
 #include <memory>
@@ -19,15 +20,23 @@ struct ApiRequest {
     std::string path;
     std::unordered_map<std::string, std::string> headers;
     std::unordered_map<std::string, std::string> query_params;
+    std::unordered_map<std::string, std::string> path_params;  // {name} segments of the matched route
     std::string body;
     std::string client_ip;
     std::string user_id;  // Populated after authentication
 };
 
+using ChunkWriter = std::function<void(const std::string& chunk)>;
+
 struct ApiResponse {
     int status_code;
     std::unordered_map<std::string, std::string> headers;
     std::string body;
+    std::string event_stream;  // Set by event stream routes; the connection stays open as a subscriber
+    
+    // Optional streamed body, produced on the worker one chunk at a time
+    // (Transfer-Encoding: chunked). body is ignored when this is set.
+    std::function<void(const ChunkWriter& write)> body_stream;
     
     ApiResponse() : status_code(200) {
         headers["Content-Type"] = "application/json";
@@ -53,14 +62,19 @@ public:
     bool start(int port = 8080);
     void stop();
     bool isRunning() const;
+    void setWorkerThreads(size_t count);  // 0 = pick from hardware; applies on next start()
     
-    // Route registration
+    // Route registration; path may hold {name} segments, e.g. /api/verse/{ref}
     void addRoute(HttpMethod method, const std::string& path, ApiHandler handler);
     void addMiddleware(std::function<bool(ApiRequest&, ApiResponse&)> middleware);
     
     // Authentication
     void setAuthHandler(std::function<bool(const std::string& token, std::string& user_id)> auth_handler);
     void requireAuth(const std::string& path);
+    // The handler's answer for a token is reused for the accepted or refused
+    // TTL (see AuthCache); zero turns caching of that outcome off
+    void setAuthCacheTtl(std::chrono::seconds accepted, std::chrono::seconds refused);
+    void revokeToken(const std::string& token);  // Until the handler is asked again
     
     // Rate limiting
     void setRateLimit(const std::string& path, const RateLimit& limit);
@@ -70,6 +84,13 @@ public:
     void enableCors(const std::string& allowed_origins = "*");
     void setCorsHeaders(const std::unordered_map<std::string, std::string>& headers);
     
+    // Server-Sent Events: GET on the path subscribes; each broadcast is
+    // serialized once and fanned out to every subscriber of that stream.
+    // New subscribers are sent the stream's most recent event first.
+    void addEventStream(const std::string& path);
+    void broadcastEvent(const std::string& path, const std::string& event, const std::string& data);
+    size_t getEventSubscriberCount() const;
+    
     // Webhook support
     void addWebhook(const std::string& event, const std::string& url);
     void removeWebhook(const std::string& event, const std::string& url);
@@ -88,7 +109,7 @@ private:
     
     bool checkRateLimit(const std::string& client_ip, const std::string& path);
     bool authenticate(ApiRequest& request);
-    ApiResponse handleRequest(const ApiRequest& request);
+    ApiResponse handleRequest(ApiRequest& request);  // Middlewares and auth may amend request
     void logRequest(const ApiRequest& request, const ApiResponse& response);
 };
 
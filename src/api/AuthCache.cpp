@@ -0,0 +1,79 @@
+#include "AuthCache.h"
+#include "../core/MetricsRegistry.h"
+#include <algorithm>
+#include <functional>
+
+AuthCache::AuthCache()
+    : hits(MetricsRegistry::shared().counter("versefinder_auth_cache_total", "Bearer token checks by cache outcome",
+                                             MetricsRegistry::label("result", "hit"))),
+      misses(MetricsRegistry::shared().counter("versefinder_auth_cache_total", "Bearer token checks by cache outcome",
+                                               MetricsRegistry::label("result", "miss"))) {}
+
+void AuthCache::setTtl(std::chrono::seconds accepted, std::chrono::seconds refused) {
+    accepted_ttl_s.store(std::max<int64_t>(accepted.count(), 0));
+    refused_ttl_s.store(std::max<int64_t>(refused.count(), 0));
+    clear();
+}
+
+AuthCache::Shard& AuthCache::shardFor(const std::string& token) {
+    return shards[std::hash<std::string>{}(token) % SHARD_COUNT];
+}
+
+AuthCache::Lookup AuthCache::find(const std::string& token, std::string& user_id, uint64_t& generation) {
+    Shard& shard = shardFor(token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    generation = shard.generation;
+    auto it = shard.entries.find(token);
+    if (it == shard.entries.end() || it->second.expires <= Clock::now()) {
+        misses.add();
+        return Lookup::MISS;
+    }
+    hits.add();
+    if (!it->second.accepted) return Lookup::REFUSED;
+    user_id = it->second.user_id;
+    return Lookup::ACCEPTED;
+}
+
+void AuthCache::store(const std::string& token, bool accepted, const std::string& user_id, uint64_t generation) {
+    int64_t ttl = (accepted ? accepted_ttl_s : refused_ttl_s).load();
+    if (ttl == 0) return;
+    Clock::time_point now = Clock::now();
+
+    Shard& shard = shardFor(token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.generation != generation) return;  // Revoked while the handler ran
+    if (shard.entries.size() >= MAX_ENTRIES_PER_SHARD && !shard.entries.count(token)) {
+        std::erase_if(shard.entries, [now](const auto& entry) { return entry.second.expires <= now; });
+        if (shard.entries.size() >= MAX_ENTRIES_PER_SHARD) {
+            shard.entries.erase(std::min_element(shard.entries.begin(), shard.entries.end(),
+                                                 [](const auto& a, const auto& b) {
+                                                     return a.second.expires < b.second.expires;
+                                                 }));
+        }
+    }
+    shard.entries[token] = {accepted, accepted ? user_id : std::string(), now + std::chrono::seconds(ttl)};
+}
+
+void AuthCache::revoke(const std::string& token) {
+    Shard& shard = shardFor(token);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.entries.erase(token);
+    ++shard.generation;
+}
+
+void AuthCache::clear() {
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.clear();
+        ++shard.generation;
+    }
+}
+
+size_t AuthCache::getEntryCount() const {
+    size_t count = 0;
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.entries.size();
+    }
+    return count;
+}
@@ -0,0 +1,71 @@
+#ifndef AUTH_CACHE_H
+#define AUTH_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class Counter;
+
+// What the auth handler said about each bearer token, so a display that
+// sends the same token every second costs a hash lookup rather than a round
+// trip to the identity service. Accepted tokens are remembered with their
+// user id for the accepted TTL, refused ones for the (shorter) refused TTL,
+// so a token issued a moment ago is not turned away for long; a zero TTL
+// stops caching that outcome. revoke() forgets a token at once.
+//
+// Split into SHARD_COUNT shards with a lock each, like RateLimiter. A full
+// shard drops its expired entries, then the one closest to expiring.
+// A handler call that was already running when its token was revoked does
+// not put it back: store() is ignored if the token's shard saw a revocation
+// after the find() that missed.
+class AuthCache {
+public:
+    static constexpr size_t SHARD_COUNT = 16;
+    static constexpr size_t MAX_ENTRIES_PER_SHARD = 1024;
+    static constexpr auto DEFAULT_ACCEPTED_TTL = std::chrono::seconds(60);
+    static constexpr auto DEFAULT_REFUSED_TTL = std::chrono::seconds(5);
+
+    enum class Lookup { MISS, ACCEPTED, REFUSED };
+
+    AuthCache();
+
+    void setTtl(std::chrono::seconds accepted, std::chrono::seconds refused);
+
+    // user_id is set for ACCEPTED; generation is handed back to store()
+    Lookup find(const std::string& token, std::string& user_id, uint64_t& generation);
+    void store(const std::string& token, bool accepted, const std::string& user_id, uint64_t generation);
+
+    void revoke(const std::string& token);
+    void clear();
+    size_t getEntryCount() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Entry {
+        bool accepted;
+        std::string user_id;
+        Clock::time_point expires;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, Entry> entries;
+        uint64_t generation = 0;  // bumped by every revocation
+    };
+
+    std::array<Shard, SHARD_COUNT> shards;
+    std::atomic<int64_t> accepted_ttl_s{DEFAULT_ACCEPTED_TTL.count()};
+    std::atomic<int64_t> refused_ttl_s{DEFAULT_REFUSED_TTL.count()};
+    Counter& hits;
+    Counter& misses;
+
+    Shard& shardFor(const std::string& token);
+};
+
+#endif // AUTH_CACHE_H
@@ -0,0 +1,112 @@
+#include "HttpRouter.h"
+#include <algorithm>
+
+uint32_t HttpRouter::newNode(std::string prefix) {
+    nodes.push_back({std::move(prefix), {}, -1, NO_ROUTE});
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+uint32_t HttpRouter::insertLiteral(uint32_t node, std::string_view text) {
+    while (!text.empty()) {
+        uint32_t child = 0;
+        bool found = false;
+        for (uint32_t candidate : nodes[node].children) {
+            if (nodes[candidate].prefix[0] == text[0]) {
+                child = candidate;
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            uint32_t added = newNode(std::string(text));
+            nodes[node].children.push_back(added);
+            return added;
+        }
+
+        const std::string& prefix = nodes[child].prefix;
+        size_t common = std::mismatch(prefix.begin(), prefix.end(), text.begin(), text.end()).first - prefix.begin();
+        if (common < prefix.size()) {
+            // Split the edge: the child keeps its index, so its parent needs no update
+            uint32_t tail = newNode(prefix.substr(common));
+            nodes[tail].children = std::move(nodes[child].children);
+            nodes[tail].param_child = nodes[child].param_child;
+            nodes[tail].route = nodes[child].route;
+            nodes[child].prefix.resize(common);
+            nodes[child].children = {tail};
+            nodes[child].param_child = -1;
+            nodes[child].route = NO_ROUTE;
+        }
+        node = child;
+        text.remove_prefix(common);
+    }
+    return node;
+}
+
+size_t HttpRouter::add(HttpMethod method, const std::string& pattern) {
+    int32_t& root = roots[static_cast<size_t>(method)];
+    if (root < 0) root = static_cast<int32_t>(newNode(""));
+
+    uint32_t node = static_cast<uint32_t>(root);
+    std::vector<std::string> params;
+    std::string_view rest = pattern;
+    while (!rest.empty()) {
+        size_t open = rest.find('{');
+        node = insertLiteral(node, rest.substr(0, open));
+        if (open == std::string_view::npos) break;
+
+        size_t close = rest.find('}', open);
+        if (close == std::string_view::npos || close == open + 1 || (open > 0 && rest[open - 1] != '/') ||
+            (close + 1 < rest.size() && rest[close + 1] != '/')) {
+            return NO_ROUTE;
+        }
+        params.emplace_back(rest.substr(open + 1, close - open - 1));
+        if (nodes[node].param_child < 0) {
+            int32_t param = static_cast<int32_t>(newNode(""));
+            nodes[node].param_child = param;
+        }
+        node = static_cast<uint32_t>(nodes[node].param_child);
+        rest.remove_prefix(close + 1);
+    }
+
+    if (nodes[node].route == NO_ROUTE) {
+        nodes[node].route = routes.size();
+        routes.push_back({pattern, std::move(params)});
+    } else {
+        // Same shape, perhaps other parameter names: the later registration names them
+        routes[nodes[node].route] = {pattern, std::move(params)};
+    }
+    return nodes[node].route;
+}
+
+size_t HttpRouter::match(HttpMethod method, std::string_view path, std::vector<std::string_view>& values) const {
+    values.clear();
+    int32_t root = roots[static_cast<size_t>(method)];
+    if (root < 0) return NO_ROUTE;
+    return matchFrom(static_cast<uint32_t>(root), path, values);
+}
+
+size_t HttpRouter::matchFrom(uint32_t node, std::string_view path, std::vector<std::string_view>& values) const {
+    const Node& current = nodes[node];
+    if (path.empty()) return current.route;
+
+    for (uint32_t child : current.children) {
+        const std::string& prefix = nodes[child].prefix;
+        if (prefix[0] != path[0]) continue;
+        if (path.substr(0, prefix.size()) == prefix) {
+            size_t route = matchFrom(child, path.substr(prefix.size()), values);
+            if (route != NO_ROUTE) return route;
+        }
+        break;
+    }
+
+    if (current.param_child >= 0) {
+        size_t end = std::min(path.find('/'), path.size());
+        if (end > 0) {
+            values.push_back(path.substr(0, end));
+            size_t route = matchFrom(static_cast<uint32_t>(current.param_child), path.substr(end), values);
+            if (route != NO_ROUTE) return route;
+            values.pop_back();
+        }
+    }
+    return NO_ROUTE;
+}
@@ -0,0 +1,59 @@
+#ifndef HTTP_ROUTER_H
+#define HTTP_ROUTER_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ApiServer.h"
+
+// Route patterns compiled into one radix tree per method, so a request is
+// routed by walking its path once instead of building a "METHOD path" key
+// and hashing it. A pattern is literal text and {name} segments, e.g.
+// /api/verse/{ref}; a {name} matches one non-empty path segment (up to the
+// next '/'). Literal edges are tried before a parameter at the same point,
+// so /api/verse/random wins over /api/verse/{ref} for that path.
+//
+// Routes are added before the server starts; match() is then read-only and
+// safe from every worker at once.
+class HttpRouter {
+public:
+    static constexpr size_t NO_ROUTE = static_cast<size_t>(-1);
+
+    // Index of pattern's route, the same one if it was added before; NO_ROUTE
+    // if a {name} is unterminated or shares its segment with other text
+    size_t add(HttpMethod method, const std::string& pattern);
+
+    // Route that path matches, with the text of each {name} in values in the
+    // order of route_params(); the views point into path
+    size_t match(HttpMethod method, std::string_view path, std::vector<std::string_view>& values) const;
+
+    const std::string& pattern(size_t route) const { return routes[route].pattern; }
+    const std::vector<std::string>& params(size_t route) const { return routes[route].params; }
+    size_t routeCount() const { return routes.size(); }
+
+private:
+    static constexpr size_t METHOD_COUNT = 5;
+
+    struct Node {
+        std::string prefix;             // literal text on the edge into the node
+        std::vector<uint32_t> children; // literal edges, no two starting with the same byte
+        int32_t param_child = -1;       // edge taken by a {name} segment
+        size_t route = NO_ROUTE;        // route ending here
+    };
+    struct Route {
+        std::string pattern;
+        std::vector<std::string> params;
+    };
+
+    std::vector<Node> nodes;
+    std::array<int32_t, METHOD_COUNT> roots{-1, -1, -1, -1, -1};
+    std::vector<Route> routes;
+
+    uint32_t newNode(std::string prefix);
+    uint32_t insertLiteral(uint32_t node, std::string_view text);
+    size_t matchFrom(uint32_t node, std::string_view path, std::vector<std::string_view>& values) const;
+};
+
+#endif // HTTP_ROUTER_H
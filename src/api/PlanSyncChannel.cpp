@@ -0,0 +1,163 @@
+#include "PlanSyncChannel.h"
+#include "ApiServer.h"
+#include <nlohmann/json.hpp>
+#include <iostream>
+
+PlanSyncChannel::PlanSyncChannel(ApiServer& server, std::function<void()> wake)
+    : server(server), wake(std::move(wake)) {
+    registerRoutes();
+}
+
+PlanSyncChannel::~PlanSyncChannel() {
+    if (plan) {
+        plan->setOperationListener(nullptr);
+    }
+}
+
+void PlanSyncChannel::registerRoutes() {
+    server.addEventStream(EVENT_STREAM);
+
+    server.addRoute(HttpMethod::GET, "/api/service/plan", [this](const ApiRequest&) -> ApiResponse {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (snapshot.empty()) {
+            return errorResponse(404, "No service plan is open");
+        }
+        return jsonResponse(snapshot);
+    });
+
+    server.addRoute(HttpMethod::GET, "/api/service/plan/ops", [this](const ApiRequest& req) -> ApiResponse {
+        uint64_t since = 0;
+        auto since_it = req.query_params.find("since");
+        if (since_it != req.query_params.end()) {
+            try {
+                since = std::stoull(since_it->second);
+            } catch (const std::exception&) {
+                return errorResponse(400, "Invalid 'since' parameter");
+            }
+        }
+
+        std::vector<PlanOperation> operations;
+        uint64_t current = 0;
+        std::string id;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            current = revision;
+            id = plan_id;
+            if (since < revision) {
+                if (published.empty() || published.front().revision > since + 1) {
+                    return errorResponse(410, "Revision is too old; reload /api/service/plan");
+                }
+                for (const auto& operation : published) {
+                    if (operation.revision > since) {
+                        operations.push_back(operation);
+                    }
+                }
+            }
+        }
+
+        return jsonResponse("{\"plan\":" + nlohmann::json(id).dump() + ",\"from\":" + std::to_string(since) +
+                            ",\"to\":" + std::to_string(current) +
+                            ",\"ops\":" + ServicePlan::operationsToJson(operations) + "}");
+    });
+
+    server.addRoute(HttpMethod::POST, "/api/service/plan/ops", [this](const ApiRequest& req) -> ApiResponse {
+        std::vector<PlanOperation> operations;
+        try {
+            auto body = nlohmann::json::parse(req.body);
+            if (!body.contains("ops") || !ServicePlan::operationsFromJson(body["ops"].dump(), operations)) {
+                return errorResponse(400, "Expected {\"ops\": [...]}");
+            }
+        } catch (const std::exception&) {
+            return errorResponse(400, "Invalid JSON body");
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto& operation : operations) {
+                operation.author = req.user_id.empty() ? req.client_ip : req.user_id;
+                incoming.push_back(std::move(operation));
+            }
+        }
+        if (wake) {
+            wake();
+        }
+
+        ApiResponse response = jsonResponse("{\"queued\":" + std::to_string(operations.size()) + "}", 202);
+        return response;
+    });
+}
+
+void PlanSyncChannel::attach(ServicePlan* new_plan) {
+    if (plan) {
+        plan->setOperationListener(nullptr);
+    }
+    plan = new_plan;
+    outgoing.clear();
+
+    std::string reset;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        incoming.clear(); // they were made against the previous plan
+        published.clear();
+        plan_id = plan ? plan->getId() : "";
+        revision = plan ? plan->getRevision() : 0;
+        snapshot = plan ? plan->exportToJson() : "";
+        reset = "{\"plan\":" + nlohmann::json(plan_id).dump() + ",\"revision\":" + std::to_string(revision) + "}";
+    }
+
+    if (plan) {
+        plan->setOperationListener([this](const PlanOperation& operation) { outgoing.push_back(operation); });
+    }
+    server.broadcastEvent(EVENT_STREAM, "plan-reset", reset);
+}
+
+void PlanSyncChannel::pump() {
+    std::vector<PlanOperation> received;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.swap(incoming);
+    }
+
+    if (plan) {
+        size_t dropped = 0;
+        for (auto& operation : received) {
+            if (!plan->applyOperation(std::move(operation))) {
+                dropped++;
+            }
+        }
+        if (dropped > 0) {
+            std::cerr << "Dropped " << dropped << " service plan edits that no longer apply" << std::endl;
+        }
+    }
+
+    if (!outgoing.empty()) {
+        publish();
+    }
+}
+
+void PlanSyncChannel::publish() {
+    std::vector<PlanOperation> batch;
+    batch.swap(outgoing);
+
+    uint64_t from = batch.front().revision - 1;
+    uint64_t to = batch.back().revision;
+    std::string snapshot_json = plan->exportToJson();
+    std::string id;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        id = plan_id;
+        revision = to;
+        snapshot = std::move(snapshot_json);
+        for (const auto& operation : batch) {
+            published.push_back(operation);
+        }
+        while (published.size() > MAX_PUBLISHED_OPERATIONS) {
+            published.pop_front();
+        }
+    }
+
+    // One event per batch, however many edits the frame made
+    server.broadcastEvent(EVENT_STREAM, "plan-ops",
+                          "{\"plan\":" + nlohmann::json(id).dump() + ",\"from\":" + std::to_string(from) +
+                          ",\"to\":" + std::to_string(to) + ",\"ops\":" + ServicePlan::operationsToJson(batch) + "}");
+}
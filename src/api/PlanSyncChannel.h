@@ -0,0 +1,67 @@
+#ifndef PLAN_SYNC_CHANNEL_H
+#define PLAN_SYNC_CHANNEL_H
+
+#include "../service/ServicePlan.h"
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ApiServer;
+
+// Shares the open ServicePlan with remote editors through the API server.
+//
+//   GET  /api/service/plan              the plan, with its revision
+//   GET  /api/service/plan/ops?since=N  operations after revision N, or 410 if too old
+//   POST /api/service/plan/ops          {"ops": [...]} edits to apply
+//   GET  /api/service/events            Server-Sent Events:
+//        "plan-ops"   {"plan", "from", "to", "ops"}: apply if from is your revision,
+//                     otherwise catch up through /ops?since= first
+//        "plan-reset" {"plan", "revision"}: another plan was opened; reload it
+//
+// Local edits are collected as the plan records them and broadcast as one
+// batch per pump(), which the UI calls once a frame. Posted edits are
+// queued and applied on the UI thread at the next pump(); wake is called
+// so that happens within a frame, and they reach every editor, the poster
+// included, in the broadcast that follows. Operations that no longer fit
+// (their item was removed meanwhile) are dropped.
+class PlanSyncChannel {
+public:
+    static constexpr const char* EVENT_STREAM = "/api/service/events";
+
+    PlanSyncChannel(ApiServer& server, std::function<void()> wake);
+    ~PlanSyncChannel();
+
+    PlanSyncChannel(const PlanSyncChannel&) = delete;
+    PlanSyncChannel& operator=(const PlanSyncChannel&) = delete;
+
+    // UI thread. plan may be null; it must outlive the channel or the next
+    // attach(). Routes are registered on construction and capture the
+    // channel, so stop the server before destroying it.
+    void attach(ServicePlan* plan);
+    void pump();
+
+private:
+    ApiServer& server;
+    std::function<void()> wake;
+
+    // UI thread
+    ServicePlan* plan = nullptr;
+    std::vector<PlanOperation> outgoing;
+
+    // Shared with API workers
+    mutable std::mutex mutex;
+    std::string plan_id;
+    uint64_t revision = 0;
+    std::string snapshot; // the plan as of revision
+    std::deque<PlanOperation> published;
+    std::vector<PlanOperation> incoming;
+
+    static constexpr size_t MAX_PUBLISHED_OPERATIONS = 1024;
+
+    void registerRoutes();
+    void publish();
+};
+
+#endif // PLAN_SYNC_CHANNEL_H
@@ -0,0 +1,74 @@
+#include "RateLimiter.h"
+#include "ApiServer.h"
+#include <algorithm>
+#include <functional>
+
+namespace {
+constexpr int64_t NS_PER_SECOND = 1000000000LL;
+constexpr int64_t WINDOW_NS[] = {60 * NS_PER_SECOND, 3600 * NS_PER_SECOND, 86400 * NS_PER_SECOND};
+constexpr int64_t FULL_SWEEP_INTERVAL_NS = NS_PER_SECOND;
+}
+
+bool RateLimiter::allow(const std::string& client, const std::string& route, const RateLimit& limit) {
+    const int limits[WINDOW_COUNT] = {limit.requests_per_minute, limit.requests_per_hour, limit.requests_per_day};
+    for (int count : limits) {
+        if (count <= 0) return false;
+    }
+
+    std::string key;
+    key.reserve(client.size() + 1 + route.size());
+    key.append(client).push_back('\0');
+    key.append(route);
+    size_t hash = std::hash<std::string>{}(key);
+    Shard& shard = shards[hash % SHARD_COUNT];
+
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (now >= shard.next_sweep) {
+        sweep(shard, now);
+    }
+    auto it = shard.keys.find(key);
+    if (it == shard.keys.end()) {
+        if (shard.keys.size() >= MAX_KEYS_PER_SHARD) {
+            if (now < shard.next_full_sweep) return false;
+            shard.next_full_sweep = now + FULL_SWEEP_INTERVAL_NS;
+            sweep(shard, now);
+            if (shard.keys.size() >= MAX_KEYS_PER_SHARD) return false;
+        }
+        it = shard.keys.emplace(std::move(key), Key{}).first;
+    }
+
+    // GCRA: a request conforms if it arrives no earlier than the theoretical
+    // arrival time less the burst tolerance (window - interval)
+    std::array<int64_t, WINDOW_COUNT> next;
+    for (size_t w = 0; w < WINDOW_COUNT; ++w) {
+        int64_t interval = WINDOW_NS[w] / limits[w];
+        int64_t arrival = std::max(it->second.arrival[w], now);
+        if (arrival - (WINDOW_NS[w] - interval) > now) return false;
+        next[w] = arrival + interval;
+    }
+    it->second.arrival = next;
+    return true;
+}
+
+size_t RateLimiter::getKeyCount() const {
+    size_t count = 0;
+    for (const auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.keys.size();
+    }
+    return count;
+}
+
+void RateLimiter::sweep(Shard& shard, int64_t now) {
+    shard.next_sweep = now + std::chrono::duration_cast<std::chrono::nanoseconds>(SWEEP_INTERVAL).count();
+    for (auto it = shard.keys.begin(); it != shard.keys.end();) {
+        const auto& arrival = it->second.arrival;
+        if (*std::max_element(arrival.begin(), arrival.end()) <= now) {
+            it = shard.keys.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
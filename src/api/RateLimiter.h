@@ -0,0 +1,55 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+struct RateLimit;
+
+// Per-minute, per-hour and per-day request limits for (client, route) keys,
+// enforced with GCRA: each key keeps one theoretical arrival time per window
+// instead of a history of requests, so a check is a hash lookup and a few
+// integer operations under the lock of one of SHARD_COUNT shards. A window
+// of N requests still allows a burst of N, then one per window / N.
+//
+// A key whose arrival times have all passed is indistinguishable from one
+// never seen, so it is swept without losing anything; each shard sweeps at
+// most every SWEEP_INTERVAL. A shard holds at most MAX_KEYS_PER_SHARD keys:
+// when full even after a sweep, requests from new keys are refused rather
+// than letting a scan of addresses or paths grow the table.
+class RateLimiter {
+public:
+    static constexpr size_t SHARD_COUNT = 64;
+    static constexpr size_t MAX_KEYS_PER_SHARD = 2048;
+    static constexpr auto SWEEP_INTERVAL = std::chrono::seconds(10);
+
+    // Counts the request against limit if it is within it
+    bool allow(const std::string& client, const std::string& route, const RateLimit& limit);
+    size_t getKeyCount() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t WINDOW_COUNT = 3; // minute, hour, day
+
+    struct Key {
+        std::array<int64_t, WINDOW_COUNT> arrival{}; // theoretical arrival times, ns since the clock's epoch
+    };
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, Key> keys;
+        int64_t next_sweep = 0;
+        int64_t next_full_sweep = 0; // sweeps forced by a full shard are spaced out too
+    };
+
+    std::array<Shard, SHARD_COUNT> shards;
+
+    // Caller holds shard.mutex
+    static void sweep(Shard& shard, int64_t now);
+};
+
+#endif // RATE_LIMITER_H
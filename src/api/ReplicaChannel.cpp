@@ -0,0 +1,543 @@
+#include "ReplicaChannel.h"
+#include "ApiServer.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+using json = nlohmann::json;
+
+namespace {
+constexpr auto RETRY_INTERVAL = std::chrono::seconds(2);
+constexpr int REQUEST_TIMEOUT_SECONDS = 5;
+// Idle event streams get a keep-alive comment every 15 s; three missed and the leader is gone
+constexpr int STREAM_TIMEOUT_SECONDS = 45;
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;  // SO_NOSIGPIPE is set on the socket instead
+#endif
+
+std::string newEpoch() {
+    std::random_device device;
+    std::mt19937_64 generator(device() ^ static_cast<uint64_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count()));
+    std::ostringstream text;
+    text << std::hex << generator();
+    return text.str();
+}
+
+// Connected socket to "http://host:port" with send and receive timeouts, or -1
+int connectPeer(const std::string& peer, int timeout_seconds, std::string& host_header) {
+    std::string address = peer.rfind("http://", 0) == 0 ? peer.substr(7) : peer;
+    while (!address.empty() && address.back() == '/') address.pop_back();
+    size_t colon = address.rfind(':');
+    std::string host = colon == std::string::npos ? address : address.substr(0, colon);
+    std::string port = colon == std::string::npos ? "80" : address.substr(colon + 1);
+    host_header = address;
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0 || !result) return -1;
+
+    int fd = -1;
+    for (addrinfo* candidate = result; candidate && fd < 0; candidate = candidate->ai_next) {
+        fd = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+        if (fd < 0) continue;
+        timeval timeout{timeout_seconds, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)); // bounds connect() too on Linux
+#ifdef SO_NOSIGPIPE
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+        if (connect(fd, candidate->ai_addr, candidate->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(result);
+    return fd;
+}
+
+bool sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t written = send(fd, data.data() + sent, data.size() - sent, SEND_FLAGS);
+        if (written <= 0) return false;
+        sent += static_cast<size_t>(written);
+    }
+    return true;
+}
+
+std::string requestHead(const std::string& method, const std::string& path, const std::string& host) {
+    return method + " " + path + " HTTP/1.1\r\nHost: " + host + "\r\n";
+}
+
+struct HttpReply {
+    int status = 0;
+    std::string body;
+};
+
+// Status line of a response head, 0 if it is not one
+int statusOf(const std::string& head) {
+    if (head.compare(0, 5, "HTTP/") != 0) return 0;
+    size_t space = head.find(' ');
+    return space == std::string::npos ? 0 : std::atoi(head.c_str() + space + 1);
+}
+
+// One request on its own connection; false if the peer could not be reached
+bool exchange(const std::string& peer, const std::string& method, const std::string& path,
+              const std::string& body, HttpReply& reply) {
+    std::string host;
+    int fd = connectPeer(peer, REQUEST_TIMEOUT_SECONDS, host);
+    if (fd < 0) return false;
+
+    std::string request = requestHead(method, path, host) + "Connection: close\r\n";
+    if (method == "POST") {
+        request += "Content-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) + "\r\n";
+    }
+    request += "\r\n" + body;
+
+    std::string response;
+    bool ok = sendAll(fd, request);
+    char buffer[16384];
+    ssize_t received = 0;
+    while (ok && (received = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(received));
+    }
+    close(fd);
+
+    size_t head_end = response.find("\r\n\r\n");
+    reply.status = statusOf(response);
+    if (!ok || received < 0 || head_end == std::string::npos || reply.status == 0) return false;
+    reply.body = response.substr(head_end + 4);
+    return true;
+}
+}
+
+ReplicaChannel::ReplicaChannel(ApiServer& server) : server(server), epoch(newEpoch()) {
+    registerRoutes();
+}
+
+ReplicaChannel::~ReplicaChannel() {
+    stopFollowing();
+}
+
+void ReplicaChannel::registerRoutes() {
+    server.addEventStream(EVENT_STREAM);
+
+    server.addRoute(HttpMethod::GET, "/api/replica/state", [this](const ApiRequest&) -> ApiResponse {
+        std::lock_guard<std::mutex> lock(mutex);
+        json body = {
+            {"epoch", epoch},
+            {"revision", revision},
+            {"role", leading ? "leader" : "follower"},
+            {"leader", leading ? json(nullptr) : json(leader)},
+            {"state", stateLocked()}
+        };
+        return jsonResponse(body.dump());
+    });
+
+    server.addRoute(HttpMethod::GET, "/api/replica/ops", [this](const ApiRequest& req) -> ApiResponse {
+        uint64_t since = 0;
+        auto since_it = req.query_params.find("since");
+        if (since_it != req.query_params.end()) {
+            try {
+                since = std::stoull(since_it->second);
+            } catch (const std::exception&) {
+                return errorResponse(400, "Invalid 'since' parameter");
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto epoch_it = req.query_params.find("epoch");
+        uint64_t first = revision - published.size() + 1; // revision of published.front()
+        if ((epoch_it != req.query_params.end() && epoch_it->second != epoch) || since > revision ||
+            (since < revision && first > since + 1)) {
+            return errorResponse(410, "Revision is not in the log; reload /api/replica/state");
+        }
+        json ops = json::array();
+        for (uint64_t at = since + 1; at <= revision; ++at) {
+            ops.push_back(published[at - first]);
+        }
+        json body = {{"epoch", epoch}, {"from", since}, {"to", revision}, {"ops", std::move(ops)}};
+        return jsonResponse(body.dump());
+    });
+
+    server.addRoute(HttpMethod::POST, "/api/replica/ops", [this](const ApiRequest& req) -> ApiResponse {
+        json body = json::parse(req.body, nullptr, false);
+        if (body.is_discarded() || !body.is_object() || !body.contains("ops") || !body["ops"].is_array()) {
+            return errorResponse(400, "Expected {\"ops\": [...]}");
+        }
+
+        bool lead_here = false;
+        std::string target;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            lead_here = leading;
+            target = leader;
+        }
+        if (lead_here) {
+            std::string error;
+            if (!apply(body["ops"], error)) {
+                return errorResponse(400, error);
+            }
+            return jsonResponse("{\"revision\":" + std::to_string(getRevision()) + "}");
+        }
+
+        // Followers pass changes on, so clients can write to whichever node they reach
+        HttpReply reply;
+        if (target.empty() || !exchange(target, "POST", "/api/replica/ops", req.body, reply)) {
+            return errorResponse(503, "No leader reachable");
+        }
+        return jsonResponse(reply.body, reply.status);
+    });
+
+    server.addRoute(HttpMethod::POST, "/api/replica/promote", [this](const ApiRequest&) -> ApiResponse {
+        lead();
+        std::lock_guard<std::mutex> lock(mutex);
+        json body = {{"epoch", epoch}, {"revision", revision}};
+        return jsonResponse(body.dump());
+    });
+}
+
+void ReplicaChannel::lead() {
+    stopFollowing();
+    std::lock_guard<std::mutex> lock(mutex);
+    leading = true;
+    leader.clear();
+    epoch = newEpoch();
+    published.clear(); // followers of the old epoch take the whole state
+    std::cout << "Replica leading at revision " << revision << " (epoch " << epoch << ")" << std::endl;
+}
+
+void ReplicaChannel::follow(std::vector<std::string> new_peers) {
+    stopFollowing();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        leading = false;
+        peers = std::move(new_peers);
+    }
+    following = true;
+    follower = std::thread(&ReplicaChannel::followLoop, this);
+}
+
+bool ReplicaChannel::isLeader() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return leading;
+}
+
+uint64_t ReplicaChannel::getRevision() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return revision;
+}
+
+json ReplicaChannel::state() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stateLocked();
+}
+
+void ReplicaChannel::setDocumentListener(DocumentListener listener) {
+    document_listener = std::move(listener);
+}
+
+bool ReplicaChannel::validate(const json& op, std::string& error) {
+    auto isString = [&op](const char* field) { return op.contains(field) && op[field].is_string(); };
+    std::string kind = op.is_object() && op.contains("op") && op["op"].is_string() ? op["op"].get<std::string>() : "";
+    bool valid = false;
+    if (kind == "favorite") {
+        valid = isString("verse") && op.contains("on") && op["on"].is_boolean();
+    } else if (kind == "collection") {
+        valid = isString("name");
+        if (valid && op.contains("verses")) {
+            valid = op["verses"].is_array();
+            for (const auto& verse : op["verses"]) valid = valid && verse.is_string();
+        }
+    } else if (kind == "verse-of-the-day") {
+        valid = isString("verse");
+    } else if (kind == "document") {
+        valid = isString("key") && op.contains("value");
+    }
+    if (!valid) error = "Invalid operation: " + op.dump();
+    return valid;
+}
+
+void ReplicaChannel::applyLocked(const json& op, std::vector<std::string>& changed) {
+    const std::string kind = op["op"].get<std::string>();
+    if (kind == "favorite") {
+        const std::string verse = op["verse"].get<std::string>();
+        if (op["on"].get<bool>()) {
+            current.favorites.insert(verse);
+        } else {
+            current.favorites.erase(verse);
+        }
+    } else if (kind == "collection") {
+        const std::string name = op["name"].get<std::string>();
+        if (op.contains("verses")) {
+            current.collections[name] = op["verses"].get<std::vector<std::string>>();
+        } else {
+            current.collections.erase(name);
+        }
+    } else if (kind == "verse-of-the-day") {
+        current.verse_of_the_day = op["verse"].get<std::string>();
+    } else if (kind == "document") {
+        const std::string key = op["key"].get<std::string>();
+        if (op["value"].is_null()) {
+            current.documents.erase(key);
+        } else {
+            current.documents[key] = op["value"];
+        }
+        changed.push_back(key);
+    }
+
+    ++revision;
+    published.push_back(op);
+    while (published.size() > MAX_PUBLISHED_OPERATIONS) {
+        published.pop_front();
+    }
+}
+
+json ReplicaChannel::stateLocked() const {
+    json documents = json::object();
+    for (const auto& [key, value] : current.documents) documents[key] = value;
+    return {
+        {"favorites", current.favorites},
+        {"collections", current.collections},
+        {"verse_of_the_day", current.verse_of_the_day},
+        {"documents", std::move(documents)}
+    };
+}
+
+void ReplicaChannel::notifyDocuments(const std::vector<std::string>& keys) {
+    if (!document_listener) return;
+    for (const auto& key : keys) {
+        json value;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = current.documents.find(key);
+            if (it != current.documents.end()) value = it->second;
+        }
+        document_listener(key, value);
+    }
+}
+
+bool ReplicaChannel::apply(const json& ops, std::string& error) {
+    if (!ops.is_array()) {
+        error = "Expected an array of operations";
+        return false;
+    }
+    for (const auto& op : ops) {
+        if (!validate(op, error)) return false;
+    }
+
+    std::vector<std::string> changed;
+    std::string event;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!leading) {
+            error = "Not the leader";
+            return false;
+        }
+        uint64_t from = revision;
+        for (const auto& op : ops) {
+            applyLocked(op, changed);
+        }
+        event = json{{"epoch", epoch}, {"from", from}, {"to", revision}, {"ops", ops}}.dump();
+    }
+
+    // One event per batch, however many operations it holds
+    server.broadcastEvent(EVENT_STREAM, "state-ops", event);
+    notifyDocuments(changed);
+    return true;
+}
+
+void ReplicaChannel::stopFollowing() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        following = false;
+        if (stream_fd >= 0) shutdown(stream_fd, SHUT_RDWR);
+    }
+    follower_wake.notify_all();
+    if (follower.joinable()) {
+        follower.join();
+    }
+}
+
+void ReplicaChannel::followLoop() {
+    size_t next = 0;
+    while (following) {
+        std::string peer;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (peers.empty()) return;
+            peer = peers[next % peers.size()];
+        }
+        // A leader that drops is retried first; one that cannot be reached gives way to the next peer
+        if (!followPeer(peer)) next++;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        follower_wake.wait_for(lock, RETRY_INTERVAL, [this] { return !following; });
+    }
+}
+
+bool ReplicaChannel::followPeer(const std::string& peer) {
+    HttpReply reply;
+    if (!exchange(peer, "GET", "/api/replica/state", "", reply) || reply.status != 200) return false;
+    json body = json::parse(reply.body, nullptr, false);
+    if (body.is_discarded() || !body.is_object() || body.value("role", "") != "leader" || !adoptState(body)) {
+        return false;
+    }
+
+    std::string host;
+    int fd = connectPeer(peer, STREAM_TIMEOUT_SECONDS, host);
+    if (fd < 0) return true;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!following) {
+            close(fd);
+            return true;
+        }
+        stream_fd = fd;
+        leader = peer;
+        std::cout << "Replica following " << peer << " at revision " << revision << std::endl;
+    }
+
+    // New subscribers are sent the stream's last event first, which closes any
+    // gap between the state read above and the subscription
+    std::string buffer;
+    bool in_body = false;
+    bool in_sync = sendAll(fd, requestHead("GET", EVENT_STREAM, host) + "Accept: text/event-stream\r\n\r\n");
+    char chunk[16384];
+    while (in_sync && following) {
+        ssize_t received = recv(fd, chunk, sizeof(chunk), 0);
+        if (received <= 0) break;
+        buffer.append(chunk, static_cast<size_t>(received));
+
+        if (!in_body) {
+            size_t head_end = buffer.find("\r\n\r\n");
+            if (head_end == std::string::npos) continue;
+            if (statusOf(buffer) != 200) break;
+            buffer.erase(0, head_end + 4);
+            in_body = true;
+        }
+
+        size_t block_end;
+        while (in_sync && (block_end = buffer.find("\n\n")) != std::string::npos) {
+            std::string block = buffer.substr(0, block_end);
+            buffer.erase(0, block_end + 2);
+            std::string event_name;
+            std::string data;
+            std::istringstream lines(block);
+            std::string line;
+            while (std::getline(lines, line)) {
+                if (line.rfind("event: ", 0) == 0) event_name = line.substr(7);
+                if (line.rfind("data: ", 0) == 0) data += (data.empty() ? "" : "\n") + line.substr(6);
+            }
+            if (event_name == "state-ops") {
+                in_sync = applyEvent(peer, json::parse(data, nullptr, false));
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stream_fd = -1;
+        leader.clear();
+        close(fd);
+    }
+    return true;
+}
+
+bool ReplicaChannel::adoptState(const json& body) {
+    const json& incoming = body.contains("state") ? body["state"] : json();
+    if (!incoming.is_object() || !body.contains("epoch") || !body["epoch"].is_string() ||
+        !body.contains("revision") || !body["revision"].is_number_unsigned()) {
+        return false;
+    }
+
+    State next;
+    std::vector<std::string> changed;
+    try {
+        next.favorites = incoming.value("favorites", std::set<std::string>());
+        next.collections = incoming.value("collections", std::map<std::string, std::vector<std::string>>());
+        next.verse_of_the_day = incoming.value("verse_of_the_day", "");
+        if (incoming.contains("documents") && incoming["documents"].is_object()) {
+            for (const auto& [key, value] : incoming["documents"].items()) next.documents[key] = value;
+        }
+    } catch (const json::exception&) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& [key, value] : next.documents) {
+            auto it = current.documents.find(key);
+            if (it == current.documents.end() || it->second != value) changed.push_back(key);
+        }
+        for (const auto& [key, value] : current.documents) {
+            if (!next.documents.count(key)) changed.push_back(key);
+        }
+        current = std::move(next);
+        epoch = body["epoch"].get<std::string>();
+        revision = body["revision"].get<uint64_t>();
+        published.clear();
+    }
+    notifyDocuments(changed);
+    return true;
+}
+
+bool ReplicaChannel::applyEvent(const std::string& peer, const json& event) {
+    if (!event.is_object() || !event.contains("ops") || !event["ops"].is_array()) return true;
+    uint64_t from = event.value("from", uint64_t{0});
+    std::string event_epoch = event.value("epoch", "");
+
+    uint64_t have = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (event_epoch != epoch) return false;
+        have = revision;
+    }
+
+    // Missed events are fetched from the log; too old for it, the state is taken again
+    json batch = event;
+    if (from > have) {
+        HttpReply reply;
+        if (!exchange(peer, "GET", "/api/replica/ops?since=" + std::to_string(have) + "&epoch=" + event_epoch, "",
+                      reply) || reply.status != 200) {
+            return false;
+        }
+        batch = json::parse(reply.body, nullptr, false);
+        if (batch.is_discarded() || !batch.contains("ops") || !batch["ops"].is_array()) return false;
+        from = batch.value("from", uint64_t{0});
+    }
+
+    std::string error;
+    for (const auto& op : batch["ops"]) {
+        if (!validate(op, error)) {
+            std::cerr << "Replica: " << error << std::endl;
+            return false;
+        }
+    }
+
+    std::vector<std::string> changed;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (from > revision) return false;
+        const json& ops = batch["ops"];
+        // Operations already applied, such as the replayed last event, are skipped
+        for (size_t i = revision - from; i < ops.size(); ++i) {
+            applyLocked(ops[i], changed);
+        }
+    }
+    notifyDocuments(changed);
+    return true;
+}
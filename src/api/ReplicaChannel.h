@@ -0,0 +1,117 @@
+#ifndef REPLICA_CHANNEL_H
+#define REPLICA_CHANNEL_H
+
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ApiServer;
+
+// Shares the small mutable state of a group of search servers: favorites,
+// collections, the verse of the day, and named documents such as the
+// presentation state or a service plan. One node leads and takes every
+// change; the others follow it and answer corpus queries from their own
+// translations, so any of them can sit behind a load balancer.
+//
+//   GET  /api/replica/state        the whole state, with epoch, revision and role
+//   GET  /api/replica/ops?since=N  operations after revision N, or 410 if too old
+//   POST /api/replica/ops          {"ops": [...]}; a follower forwards them to its leader
+//   POST /api/replica/promote      make this node the leader
+//   GET  /api/replica/events       Server-Sent Events: "state-ops" {"epoch", "from", "to", "ops"}
+//
+// Operations:
+//   {"op": "favorite", "verse": K, "on": true | false}
+//   {"op": "collection", "name": N, "verses": [...]}   without verses it is deleted
+//   {"op": "verse-of-the-day", "verse": K}
+//   {"op": "document", "key": K, "value": ...}         a null value removes it
+//
+// A follower takes the leader's whole state when it connects, then applies
+// the operations pushed to it; a gap is filled from /ops, and a new epoch
+// (a promoted leader) or a gap older than the log means taking the state
+// again. While its leader is unreachable a follower keeps serving what it
+// has and tries its peers in order for one that reports itself leader.
+// Promotion is explicit, by an operator or whatever watches the nodes, so
+// two nodes never both decide to lead.
+class ReplicaChannel {
+public:
+    static constexpr const char* EVENT_STREAM = "/api/replica/events";
+
+    using DocumentListener = std::function<void(const std::string& key, const nlohmann::json& value)>;
+
+    // Registers the routes; the channel leads until follow() is called. Routes
+    // capture the channel, so stop the server before destroying it.
+    explicit ReplicaChannel(ApiServer& server);
+    ~ReplicaChannel();
+
+    ReplicaChannel(const ReplicaChannel&) = delete;
+    ReplicaChannel& operator=(const ReplicaChannel&) = delete;
+
+    // Lead from the current state, under a new epoch
+    void lead();
+    // Follow the first of peers ("http://host:port") that leads
+    void follow(std::vector<std::string> peers);
+    bool isLeader() const;
+
+    // Leader only: apply and publish a batch; on a malformed operation
+    // nothing is applied and error says why
+    bool apply(const nlohmann::json& ops, std::string& error);
+    nlohmann::json state() const;
+    uint64_t getRevision() const;
+
+    // Called after a document changes, whether here or on the leader, outside the lock
+    void setDocumentListener(DocumentListener listener);
+
+private:
+    struct State {
+        std::set<std::string> favorites;
+        std::map<std::string, std::vector<std::string>> collections;
+        std::string verse_of_the_day;
+        std::map<std::string, nlohmann::json> documents;
+    };
+
+    ApiServer& server;
+    DocumentListener document_listener;
+
+    mutable std::mutex mutex;
+    State current;
+    std::string epoch;
+    uint64_t revision = 0;
+    std::deque<nlohmann::json> published; // the last operations, published[i] at revision - size + 1 + i
+    bool leading = true;
+    std::vector<std::string> peers;
+    std::string leader; // the peer followed, empty while searching
+
+    std::thread follower;
+    std::atomic<bool> following{false};
+    std::condition_variable follower_wake;
+    int stream_fd = -1; // the open event stream, shut down to stop following
+
+    static constexpr size_t MAX_PUBLISHED_OPERATIONS = 1024;
+
+    void registerRoutes();
+    static bool validate(const nlohmann::json& op, std::string& error);
+    // Caller holds mutex; documents changed are added to changed
+    void applyLocked(const nlohmann::json& op, std::vector<std::string>& changed);
+    nlohmann::json stateLocked() const;
+    void notifyDocuments(const std::vector<std::string>& keys);
+    void stopFollowing();
+
+    void followLoop();
+    // Follows peer until it fails or stops leading; false if it never answered as leader
+    bool followPeer(const std::string& peer);
+    // Replace the state with the leader's; false if body is not a state
+    bool adoptState(const nlohmann::json& body);
+    // Apply a pushed batch, or fetch what was missed; false to resynchronise
+    bool applyEvent(const std::string& peer, const nlohmann::json& event);
+};
+
+#endif // REPLICA_CHANNEL_H
@@ -0,0 +1,137 @@
+#include "ResponseEncoding.h"
+#include <nlohmann/json.hpp>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+#ifdef VERSEFINDER_USE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef VERSEFINDER_USE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+// Low levels: a stage display polling several times a second gains more
+// from a fast answer than from the last few percent of size
+constexpr int GZIP_LEVEL = 4;
+constexpr int ZSTD_LEVEL = 3;
+
+std::string lowercase(std::string text) {
+    for (char& c : text) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return text;
+}
+
+// Whether a comma-separated header list (Accept, Accept-Encoding) accepts
+// token: listed with a non-zero q, or covered by wildcard and not refused
+bool accepts(const std::string& header, const std::string& token, const std::string& wildcard) {
+    bool by_wildcard = false;
+    std::stringstream list(lowercase(header));
+    std::string entry;
+    while (std::getline(list, entry, ',')) {
+        size_t semicolon = entry.find(';');
+        std::string name = entry.substr(0, semicolon);
+        name.erase(0, name.find_first_not_of(" \t"));
+        name.erase(name.find_last_not_of(" \t") + 1);
+        double quality = 1.0;
+        if (semicolon != std::string::npos) {
+            size_t q = entry.find("q=", semicolon);
+            if (q != std::string::npos) quality = std::strtod(entry.c_str() + q + 2, nullptr);
+        }
+        if (name == token) return quality > 0.0;
+        if (name == wildcard) by_wildcard = quality > 0.0;
+    }
+    return by_wildcard;
+}
+}
+
+std::string ResponseEncoding::binaryFormat(const std::string& accept) {
+    // Only when asked for by name; browsers send */* and get JSON
+    std::string wanted = lowercase(accept);
+    if (wanted.find("application/cbor") != std::string::npos && accepts(accept, "application/cbor", "")) {
+        return "application/cbor";
+    }
+    for (const char* format : {"application/msgpack", "application/x-msgpack", "application/vnd.msgpack"}) {
+        if (wanted.find(format) != std::string::npos && accepts(accept, format, "")) return format;
+    }
+    return "";
+}
+
+bool ResponseEncoding::encodeJson(const std::string& format, std::string& body) {
+    nlohmann::json value = nlohmann::json::parse(body, nullptr, false);
+    if (value.is_discarded()) return false;
+    std::vector<std::uint8_t> encoded = format == "application/cbor" ? nlohmann::json::to_cbor(value)
+                                                                      : nlohmann::json::to_msgpack(value);
+    body.assign(encoded.begin(), encoded.end());
+    return true;
+}
+
+std::string ResponseEncoding::contentCoding(const std::string& accept_encoding) {
+    if (accept_encoding.empty()) return "";
+#ifdef VERSEFINDER_USE_ZSTD
+    if (accepts(accept_encoding, "zstd", "*")) return "zstd";
+#endif
+#ifdef VERSEFINDER_USE_ZLIB
+    if (accepts(accept_encoding, "gzip", "*") || accepts(accept_encoding, "x-gzip", "")) return "gzip";
+#endif
+    return "";
+}
+
+bool ResponseEncoding::compress(const std::string& coding, const std::string& body, std::string& out) {
+#ifdef VERSEFINDER_USE_ZSTD
+    if (coding == "zstd") {
+        out.resize(ZSTD_compressBound(body.size()));
+        size_t size = ZSTD_compress(out.data(), out.size(), body.data(), body.size(), ZSTD_LEVEL);
+        if (ZSTD_isError(size)) return false;
+        out.resize(size);
+        return true;
+    }
+#endif
+#ifdef VERSEFINDER_USE_ZLIB
+    if (coding == "gzip") {
+        z_stream stream{};
+        // 15 window bits + 16 asks for a gzip header and trailer instead of zlib's
+        if (deflateInit2(&stream, GZIP_LEVEL, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) return false;
+        out.resize(deflateBound(&stream, static_cast<uLong>(body.size())));
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(body.data()));
+        stream.avail_in = static_cast<uInt>(body.size());
+        stream.next_out = reinterpret_cast<Bytef*>(out.data());
+        stream.avail_out = static_cast<uInt>(out.size());
+        int result = deflate(&stream, Z_FINISH);
+        out.resize(stream.total_out);
+        deflateEnd(&stream);
+        return result == Z_STREAM_END;
+    }
+#endif
+    (void)coding;
+    (void)body;
+    (void)out;
+    return false;
+}
+
+std::string ResponseEncoding::entityTag(const std::string& body, const std::string& coding) {
+    // FNV-1a over the bytes; distinct codings of one body get distinct tags
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : body) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    std::ostringstream tag;
+    tag << '"' << std::hex << hash << std::dec << '-' << body.size();
+    if (!coding.empty()) tag << '-' << coding;
+    tag << '"';
+    return tag.str();
+}
+
+bool ResponseEncoding::matchesTag(const std::string& if_none_match, const std::string& tag) {
+    std::stringstream list(if_none_match);
+    std::string entry;
+    while (std::getline(list, entry, ',')) {
+        entry.erase(0, entry.find_first_not_of(" \t"));
+        entry.erase(entry.find_last_not_of(" \t") + 1);
+        if (entry.rfind("W/", 0) == 0) entry.erase(0, 2); // If-None-Match compares weakly
+        if (entry == "*" || entry == tag) return true;
+    }
+    return false;
+}
@@ -0,0 +1,35 @@
+#ifndef RESPONSE_ENCODING_H
+#define RESPONSE_ENCODING_H
+
+#include <string>
+
+// Content negotiation for API responses, applied by ApiServer to every
+// complete (not streamed) response:
+//   - Accept: application/cbor or application/msgpack turns a JSON body into
+//     that binary encoding (nlohmann's), which is smaller and cheaper to decode
+//   - GET responses carry a strong ETag of their bytes; If-None-Match with it
+//     is answered 304 without a body
+//   - Accept-Encoding: zstd or gzip compresses bodies of MIN_COMPRESSED_SIZE
+//     and more, when the build found libzstd / zlib
+// Codings are tried in the order zstd, gzip; brotli is not built in.
+class ResponseEncoding {
+public:
+    static constexpr size_t MIN_COMPRESSED_SIZE = 512;
+
+    // "application/cbor", "application/msgpack" or "" for JSON, from an Accept header
+    static std::string binaryFormat(const std::string& accept);
+    // Re-encode a JSON body as format; false (body unchanged) if it is not JSON
+    static bool encodeJson(const std::string& format, std::string& body);
+
+    // "zstd", "gzip" or "" from an Accept-Encoding header and what the build supports
+    static std::string contentCoding(const std::string& accept_encoding);
+    // false if coding is unsupported or compression failed; out is then unspecified
+    static bool compress(const std::string& coding, const std::string& body, std::string& out);
+
+    // Quoted strong entity tag of a representation's bytes and coding
+    static std::string entityTag(const std::string& body, const std::string& coding);
+    // Whether an If-None-Match header names tag (or is "*")
+    static bool matchesTag(const std::string& if_none_match, const std::string& tag);
+};
+
+#endif // RESPONSE_ENCODING_H
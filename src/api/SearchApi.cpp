@@ -0,0 +1,715 @@
+#include "SearchApi.h"
+#include "ApiServer.h"
+#include "../core/VerseFinder.h"
+#include "../core/TaskScheduler.h"
+#include "../core/MemoryAccounting.h"
+#include "../core/MetricsRegistry.h"
+#include "../core/PerformanceBenchmark.h"
+#include "../core/QueryProfile.h"
+#include "../core/Tracer.h"
+#include <algorithm>
+#include <cctype>
+#include <future>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+// How a search ran, for explain=1
+json explainJson(const QueryProfile& profile, double total_ms, const QueryIntent& intent) {
+    json counts = json::object();
+    for (const auto& [name, value] : profile.counts()) {
+        counts[name] = value; // a count taken twice keeps the later one
+    }
+    json stages = json::array();
+    for (const QueryProfile::Stage& stage : profile.timings()) {
+        stages.push_back({{"name", stage.name},
+                          {"depth", stage.depth},
+                          {"start_ms", stage.start_ms},
+                          {"duration_ms", stage.duration_ms}});
+    }
+    json explanation = {
+        {"intent", {{"type", QueryIntent::typeName(intent.type)},
+                    {"keywords", intent.keywords},
+                    {"topics", intent.topics},
+                    {"subject", intent.subject},
+                    {"confidence", intent.confidence}}},
+        {"plan", profile.plan()},
+        {"counts", std::move(counts)},
+        {"cache", {{"hits", profile.cacheHits()}, {"misses", profile.cacheMisses()}}},
+        {"stages", std::move(stages)},
+        {"total_ms", total_ms}
+    };
+    if (profile.droppedStages() > 0) explanation["stages_dropped"] = profile.droppedStages();
+    return explanation;
+}
+
+} // namespace
+
+SearchApi::SearchApi(ApiServer& server, VerseFinder& bible) : server(server), bible(bible) {
+    registerRoutes();
+}
+
+void SearchApi::registerRoutes() {
+    // Search endpoint
+    // Examples: 
+    // /api/search?q=John%203:16 (John 3:16)
+    // /api/search?q=love&translation=ESV 
+    // /api/search?q=psalm+23 (psalm 23)
+    // /api/search?q=romans+8:28-39%3B+john+10:11 (a passage, verse by verse)
+    // /api/search?q=god&limit=20&offset=40 (third page of 20 keyword matches)
+    // /api/search?q=shepherd&explain=1 (the same, saying how it was found)
+    // /api/search?q=still+waters&translation=all (every resident translation, one merged list)
+    auto search = [this](const ApiRequest& req) -> ApiResponse {
+        auto query_it = req.query_params.find("q");
+        if (query_it == req.query_params.end()) {
+            return errorResponse(400, "Missing query parameter 'q'");
+        }
+        
+        std::string query = query_it->second;
+        
+        // Keyword matches are paged; only offset + limit of them are ever looked at
+        constexpr size_t DEFAULT_LIMIT = 100;
+        constexpr size_t MAX_LIMIT = 1000;
+        auto parseCount = [&req](const char* name, size_t& value) {
+            auto param_it = req.query_params.find(name);
+            if (param_it == req.query_params.end()) return true;
+            const std::string& text = param_it->second;
+            if (text.empty() || text.size() > 9 ||
+                !std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c); })) {
+                return false;
+            }
+            value = std::stoul(text);
+            return true;
+        };
+        size_t limit = DEFAULT_LIMIT;
+        size_t offset = 0;
+        if (!parseCount("limit", limit)) return errorResponse(400, "Invalid 'limit' parameter");
+        if (!parseCount("offset", offset)) return errorResponse(400, "Invalid 'offset' parameter");
+        limit = std::clamp<size_t>(limit, 1, MAX_LIMIT);
+
+        // language=English searches every translation of the language as one index
+        auto language_it = req.query_params.find("language");
+        if (language_it != req.query_params.end()) {
+            if (!bible.isReady()) {
+                return errorResponse(503, "Bible data not ready");
+            }
+            std::vector<std::string> members;
+            for (const auto& trans : bible.getTranslations()) {
+                if (trans.language == language_it->second) members.push_back(trans.name);
+            }
+            if (members.empty()) {
+                return errorResponse(400, "No translations in language '" + language_it->second + "'");
+            }
+            VerseFinder::TranslationLease lease = bible.acquireTranslations(members);
+            if (!lease) {
+                return errorResponse(503, "Translations in '" + language_it->second + "' could not be loaded");
+            }
+            SearchContext context;
+            context.setOffset(offset).setMaxResults(limit + 1);
+            std::vector<std::string> results = bible.searchLanguage(query, language_it->second, context);
+            bool has_more = results.size() > limit;
+            if (has_more) results.pop_back();
+            json body = {
+                {"type", "language"},
+                {"query", query},
+                {"language", language_it->second},
+                {"offset", offset},
+                {"limit", limit},
+                {"has_more", has_more},
+                {"results", std::move(results)}
+            };
+            return jsonResponse(body.dump());
+        }
+
+        // translation=all searches every resident translation and merges their matches by verse
+        auto all_it = req.query_params.find("translation");
+        if (all_it != req.query_params.end() && all_it->second == "all") {
+            if (!bible.isReady()) {
+                return errorResponse(503, "Bible data not ready");
+            }
+            std::vector<std::string> resident;
+            for (const auto& trans : bible.getTranslations()) {
+                if (trans.is_loaded) resident.push_back(trans.name);
+            }
+            // Held so none of them is evicted while its matches are rendered
+            VerseFinder::TranslationLease lease = bible.acquireTranslations(resident);
+            if (resident.empty() || !lease) {
+                return errorResponse(503, "No translations loaded");
+            }
+            SearchContext context;
+            context.setOffset(offset).setMaxResults(limit + 1);
+            std::vector<std::string> results = bible.searchAllTranslations(query, context);
+            bool has_more = results.size() > limit;
+            if (has_more) results.pop_back();
+            json body = {
+                {"type", "all"},
+                {"query", query},
+                {"translations", std::move(resident)},
+                {"offset", offset},
+                {"limit", limit},
+                {"has_more", has_more},
+                {"results", std::move(results)}
+            };
+            return jsonResponse(body.dump());
+        }
+
+        // Get the first available translation as default
+        std::string translation;
+        if (!bible.getTranslations().empty()) {
+            translation = bible.getTranslations()[0].name;
+        } else {
+            return errorResponse(503, "No translations loaded");
+        }
+        
+        // Check if user specified a translation parameter
+        auto trans_it = req.query_params.find("translation");
+        if (trans_it != req.query_params.end()) {
+            std::string requested_translation = trans_it->second;
+            
+            // Look for exact match by name or abbreviation
+            bool found = false;
+            for (const auto& trans : bible.getTranslations()) {
+                if (trans.name == requested_translation || trans.abbreviation == requested_translation) {
+                    translation = trans.name; // Always use the full name internally
+                    found = true;
+                    break;
+                }
+            }
+            
+            if (!found) {
+                // Build list of available translations for error message
+                std::string available_list = "";
+                const auto& translations = bible.getTranslations();
+                for (size_t i = 0; i < translations.size(); ++i) {
+                    if (i > 0) available_list += ", ";
+                    available_list += translations[i].name + " (" + translations[i].abbreviation + ")";
+                }
+                return errorResponse(400, "Translation '" + requested_translation + "' not found. Available: " + available_list);
+            }
+        }
+        
+        // Log the query to show URL decoding worked
+        std::cout << "[API] Search query: '" << query << "' with translation: '" << translation << "'" << std::endl;
+        
+        if (!bible.isReady()) {
+            return errorResponse(503, "Bible data not ready");
+        }
+        
+        // Reads the translation in on first use and keeps it resident for this request
+        VerseFinder::TranslationLease lease = bible.acquireTranslation(translation);
+        if (!lease) {
+            return errorResponse(503, "Translation '" + translation + "' could not be loaded");
+        }
+        
+        // Try reference search first: a passage ("Romans 8:28-39", "Ps 23; John 10:11-18")
+        // is read as runs of the canonical order, with no lookup per verse
+        const VerseStore* store = bible.getVerseStore(translation);
+        std::vector<VerseRange> passage = bible.findPassageRanges(query, translation);
+        if (store && !passage.empty()) {
+            std::string result;
+            json verses_json = json::array();
+            for (VerseRange range : passage) {
+                for (uint32_t pos = range.first; pos < range.last; ++pos) {
+                    VerseId id = store->atPosition(pos);
+                    std::string_view text = store->text(id);
+                    if (!result.empty()) result += ' ';
+                    result += text;
+                    verses_json.push_back({{"reference", store->reference(id)}, {"text", text}});
+                }
+            }
+            json body = {
+                {"type", "reference"},
+                {"query", query},
+                {"translation", translation},
+                {"result", result},
+                {"verses", std::move(verses_json)}
+            };
+            return jsonResponse(body.dump());
+        }
+        
+        // Try keyword search, best BM25 matches first; one match past the page
+        // tells whether another page exists
+        std::vector<VerseId> page_ids;
+        std::vector<float> page_scores;
+        std::vector<std::vector<MatchSpan>> page_spans;
+        SearchContext context;
+        context.setOffset(offset).setMaxResults(limit + 1);
+        bible.streamKeywordMatches(query, translation, [&](VerseId id, float score, std::span<const MatchSpan> spans) {
+            page_ids.push_back(id);
+            page_scores.push_back(score);
+            page_spans.emplace_back(spans.begin(), spans.end());
+            return true;
+        }, context);
+        bool has_more = page_ids.size() > limit;
+        if (has_more) {
+            page_ids.pop_back();
+            page_scores.pop_back();
+            page_spans.pop_back();
+        }
+        
+        if (store && (!page_ids.empty() || offset > 0)) {
+            std::string json = std::string("{\"type\": \"keyword\", \"query\": \"") + query + 
+                              std::string("\", \"translation\": \"") + translation + 
+                              std::string("\", \"offset\": ") + std::to_string(offset) +
+                              std::string(", \"limit\": ") + std::to_string(limit) +
+                              std::string(", \"has_more\": ") + (has_more ? "true" : "false") +
+                              std::string(", \"results\": [");
+            // Matched words as [begin, end) byte ranges of each result string
+            std::string highlights;
+            for (size_t i = 0; i < page_ids.size(); ++i) {
+                std::string result = store->formatResult(page_ids[i]);
+                size_t text_start = result.size() - store->text(page_ids[i]).size();
+                if (i > 0) {
+                    json += ", ";
+                    highlights += ", ";
+                }
+                json += "\"" + result + "\"";
+                highlights += "[";
+                for (size_t j = 0; j < page_spans[i].size(); ++j) {
+                    if (j > 0) highlights += ", ";
+                    highlights += "[" + std::to_string(text_start + page_spans[i][j].begin) + ", " +
+                                  std::to_string(text_start + page_spans[i][j].end) + "]";
+                }
+                highlights += "]";
+            }
+            json += "], \"scores\": [";
+            for (size_t i = 0; i < page_scores.size(); ++i) {
+                if (i > 0) json += ", ";
+                json += std::to_string(page_scores[i]);
+            }
+            json += "], \"highlights\": [" + highlights + "]}";
+            return jsonResponse(json);
+        }
+        
+        // If no results found, provide available translations info
+        std::string available_translations = "";
+        const auto& translations = bible.getTranslations();
+        for (size_t i = 0; i < translations.size(); ++i) {
+            if (i > 0) available_translations += ", ";
+            available_translations += translations[i].name;
+        }
+        
+        std::string error_msg = "No results found";
+        if (!available_translations.empty()) {
+            error_msg += ". Available translations: " + available_translations;
+        }
+        
+        return errorResponse(404, error_msg);
+    };
+    
+    // explain=1 adds how the search ran: the query's parsed intent, the plan it
+    // took (index, fallback scan, fuzzy, semantic), candidates at each step,
+    // cache lookups and the time of every stage
+    server.addRoute(HttpMethod::GET, "/api/search", [this, search](const ApiRequest& req) -> ApiResponse {
+        auto explain_it = req.query_params.find("explain");
+        if (explain_it == req.query_params.end() || explain_it->second == "0" || explain_it->second == "false") {
+            return search(req);
+        }
+        
+        QueryProfile profile;
+        ApiResponse response;
+        {
+            QueryProfile::Scope scope(profile);
+            response = search(req);
+        }
+        double total_ms = profile.elapsedMs();
+        auto query_it = req.query_params.find("q");
+        QueryIntent intent = bible.parseNaturalLanguage(query_it != req.query_params.end() ? query_it->second : "");
+        json explanation = explainJson(profile, total_ms, intent);
+        
+        json body = json::parse(response.body, nullptr, false);
+        if (body.is_object()) {
+            body["explain"] = std::move(explanation);
+        } else {
+            body = {{"response", response.body}, {"explain", std::move(explanation)}};
+        }
+        response.body = body.dump();
+        return response;
+    });
+    
+    // Verse endpoint: a reference or passage by path, verse by verse
+    // /api/verse/John%203:16, /api/verse/Psalm+23:1-3?translation=KJV
+    server.addRoute(HttpMethod::GET, "/api/verse/{ref}", [this](const ApiRequest& req) -> ApiResponse {
+        if (!bible.isReady() || bible.getTranslations().empty()) {
+            return errorResponse(503, "Bible data not ready");
+        }
+
+        std::string translation = bible.getTranslations()[0].name;
+        auto trans_it = req.query_params.find("translation");
+        if (trans_it != req.query_params.end()) {
+            const auto& loaded = bible.getTranslations();
+            auto match = std::find_if(loaded.begin(), loaded.end(), [&trans_it](const TranslationInfo& trans) {
+                return trans.name == trans_it->second || trans.abbreviation == trans_it->second;
+            });
+            if (match == loaded.end()) {
+                return errorResponse(400, "Translation '" + trans_it->second + "' not found");
+            }
+            translation = match->name;
+        }
+
+        VerseFinder::TranslationLease lease = bible.acquireTranslation(translation);
+        const VerseStore* store = lease ? bible.getVerseStore(translation) : nullptr;
+        if (!store) {
+            return errorResponse(503, "Translation '" + translation + "' could not be loaded");
+        }
+
+        const std::string& reference = req.path_params.at("ref");
+        json verses_json = json::array();
+        for (VerseRange range : bible.findPassageRanges(reference, translation)) {
+            for (uint32_t pos = range.first; pos < range.last; ++pos) {
+                VerseId id = store->atPosition(pos);
+                verses_json.push_back({{"reference", store->reference(id)}, {"text", store->text(id)}});
+            }
+        }
+        if (verses_json.empty()) {
+            return errorResponse(404, "Verse not found");
+        }
+        json body = {{"reference", reference}, {"translation", translation}, {"verses", std::move(verses_json)}};
+        return jsonResponse(body.dump());
+    });
+
+    // Parallel endpoint: one verse in several translations, lined up however each numbers it
+    // /api/parallel?ref=Malachi+4:5&translations=KJV,ESV
+    server.addRoute(HttpMethod::GET, "/api/parallel", [this](const ApiRequest& req) -> ApiResponse {
+        auto ref_it = req.query_params.find("ref");
+        auto trans_it = req.query_params.find("translations");
+        if (ref_it == req.query_params.end() || trans_it == req.query_params.end()) {
+            return errorResponse(400, "Expected 'ref' and 'translations' parameters");
+        }
+        if (!bible.isReady()) {
+            return errorResponse(503, "Bible data not ready");
+        }
+        
+        std::vector<std::string> translations;
+        const auto& loaded = bible.getTranslations();
+        std::stringstream requested_list(trans_it->second);
+        std::string name;
+        while (std::getline(requested_list, name, ',')) {
+            auto match = std::find_if(loaded.begin(), loaded.end(), [&name](const TranslationInfo& trans) {
+                return trans.name == name || trans.abbreviation == name;
+            });
+            if (match == loaded.end()) {
+                return errorResponse(400, "Translation '" + name + "' not found");
+            }
+            translations.push_back(match->name);
+        }
+        
+        VerseFinder::TranslationLease lease = bible.acquireTranslations(translations);
+        if (translations.empty() || !lease) {
+            return errorResponse(503, "Translations could not be loaded");
+        }
+        
+        std::vector<VerseView> aligned = bible.findAlignedVerses(ref_it->second, translations);
+        json verses_json = json::array();
+        bool found = false;
+        for (size_t i = 0; i < translations.size(); ++i) {
+            const VerseView& verse = aligned[i];
+            json entry = {{"translation", translations[i]}, {"reference", nullptr}, {"text", nullptr}};
+            if (verse) {
+                entry["reference"] = std::string(verse.book) + " " + std::to_string(verse.chapter) + ":" +
+                                     std::to_string(verse.verse);
+                entry["text"] = verse.text;
+                found = true;
+            }
+            verses_json.push_back(std::move(entry));
+        }
+        if (!found) {
+            return errorResponse(404, "Verse not found");
+        }
+        json body = {{"query", ref_it->second}, {"verses", std::move(verses_json)}};
+        return jsonResponse(body.dump());
+    });
+    
+    // Regex endpoint: verses matching a pattern in one or more translations, ignoring case
+    // /api/search/regex?pattern=%5Cbsh%5Bae%5Dpherd%5Cw*&translations=KJV,ASV&limit=50
+    server.addRoute(HttpMethod::GET, "/api/search/regex", [this](const ApiRequest& req) -> ApiResponse {
+        auto pattern_it = req.query_params.find("pattern");
+        if (pattern_it == req.query_params.end() || pattern_it->second.empty()) {
+            return errorResponse(400, "Missing query parameter 'pattern'");
+        }
+        if (!bible.isReady()) {
+            return errorResponse(503, "Bible data not ready");
+        }
+
+        constexpr size_t DEFAULT_LIMIT = 100;
+        constexpr size_t MAX_LIMIT = 1000;
+        size_t limit = DEFAULT_LIMIT;
+        auto limit_it = req.query_params.find("limit");
+        if (limit_it != req.query_params.end()) {
+            const std::string& text = limit_it->second;
+            if (text.empty() || text.size() > 9 ||
+                !std::all_of(text.begin(), text.end(), [](unsigned char c) { return std::isdigit(c); })) {
+                return errorResponse(400, "Invalid 'limit' parameter");
+            }
+            limit = std::clamp<size_t>(std::stoul(text), 1, MAX_LIMIT);
+        }
+
+        // The first translation unless some are named
+        const auto& loaded = bible.getTranslations();
+        if (loaded.empty()) {
+            return errorResponse(503, "No translations loaded");
+        }
+        std::vector<std::string> translations;
+        auto trans_it = req.query_params.find("translations");
+        if (trans_it == req.query_params.end()) {
+            translations.push_back(loaded[0].name);
+        } else {
+            std::stringstream requested_list(trans_it->second);
+            std::string name;
+            while (std::getline(requested_list, name, ',')) {
+                auto match = std::find_if(loaded.begin(), loaded.end(), [&name](const TranslationInfo& trans) {
+                    return trans.name == name || trans.abbreviation == name;
+                });
+                if (match == loaded.end()) {
+                    return errorResponse(400, "Translation '" + name + "' not found");
+                }
+                translations.push_back(match->name);
+            }
+        }
+
+        VerseFinder::TranslationLease lease = bible.acquireTranslations(translations);
+        if (translations.empty() || !lease) {
+            return errorResponse(503, "Translations could not be loaded");
+        }
+
+        // Translations are searched side by side, each with its own page
+        std::vector<CachedSearchResult> found(translations.size());
+        SearchContext context;
+        context.setMaxResults(limit + 1);
+        TaskScheduler::shared().parallelFor(translations.size(), [&](size_t i) {
+            found[i] = bible.searchRegexIds(pattern_it->second, translations[i], context);
+        });
+
+        json results_json = json::array();
+        for (size_t i = 0; i < translations.size(); ++i) {
+            const CachedSearchResult& result = found[i];
+            if (result.ids.empty() && result.message.rfind("Invalid regular expression", 0) == 0) {
+                return errorResponse(400, result.message);
+            }
+            const VerseStore* store = bible.getVerseStore(translations[i]);
+            bool has_more = result.ids.size() > limit;
+            size_t shown = std::min(limit, result.ids.size());
+            json verses_json = json::array();
+            for (size_t j = 0; store && j < shown; ++j) {
+                json highlights = json::array();
+                for (const MatchSpan& span : result.spansOf(j)) {
+                    highlights.push_back({span.begin, span.end});
+                }
+                verses_json.push_back({{"reference", store->reference(result.ids[j])},
+                                       {"text", store->text(result.ids[j])},
+                                       {"highlights", std::move(highlights)}});
+            }
+            results_json.push_back({{"translation", translations[i]},
+                                    {"has_more", has_more},
+                                    {"verses", std::move(verses_json)}});
+        }
+        json body = {{"pattern", pattern_it->second}, {"limit", limit}, {"results", std::move(results_json)}};
+        return jsonResponse(body.dump());
+    });
+
+    // Translations endpoint
+    server.addRoute(HttpMethod::GET, "/api/translations", [this](const ApiRequest&) -> ApiResponse {
+        if (!bible.isReady()) {
+            return errorResponse(503, "Bible data not ready");
+        }
+        
+        const auto& translations = bible.getTranslations();
+        std::string json = "{\"translations\": [";
+        bool first = true;
+        for (const auto& trans : translations) {
+            if (!first) json += ", ";
+            json += "{\"name\": \"" + trans.name + "\", \"abbreviation\": \"" + trans.abbreviation +
+                    "\", \"resident\": " + (bible.isTranslationResident(trans.name) ? "true" : "false") + "}";
+            first = false;
+        }
+        json += "]}";
+        return jsonResponse(json);
+    });
+    
+    // Health check endpoint
+    server.addRoute(HttpMethod::GET, "/api/health", [this](const ApiRequest& req) -> ApiResponse {
+        std::string json = std::string("{\"status\": \"ok\", \"bible_ready\": ") + 
+                          (bible.isReady() ? "true" : "false") + 
+                          std::string(", \"api_server_running\": true");
+        
+        // Add test parameter to verify URL decoding works
+        auto test_it = req.query_params.find("test");
+        if (test_it != req.query_params.end()) {
+            json = std::string("{\"status\": \"ok\", \"bible_ready\": ") + 
+                   (bible.isReady() ? "true" : "false") + 
+                   std::string(", \"api_server_running\": true, \"test_decoded\": \"") + 
+                   test_it->second + std::string("\"}");
+        }
+        
+        return jsonResponse(json);
+    });
+    
+    // Batch endpoint: several references/queries across several translations in one round trip
+    // Example: POST /api/batch {"queries": ["John 3:16", "Psalm 23"], "translations": ["KJV", "WEB"]}
+    // Results come back in query-major order as one JSON document, streamed in chunks
+    server.addRoute(HttpMethod::POST, "/api/batch", [this](const ApiRequest& req) -> ApiResponse {
+        if (!bible.isReady()) {
+            return errorResponse(503, "Bible data not ready");
+        }
+        
+        json request = json::parse(req.body, nullptr, false);
+        if (request.is_discarded() || !request.is_object()) {
+            return errorResponse(400, "Request body must be a JSON object");
+        }
+        
+        std::vector<std::string> queries;
+        if (request.contains("queries") && request["queries"].is_array()) {
+            for (const auto& query : request["queries"]) {
+                if (query.is_string()) queries.push_back(query.get<std::string>());
+            }
+        }
+        if (queries.empty()) {
+            return errorResponse(400, "Missing 'queries' array");
+        }
+        
+        // Resolve names or abbreviations; default to the first loaded translation
+        std::vector<std::string> translations;
+        const auto& loaded = bible.getTranslations();
+        if (request.contains("translations") && request["translations"].is_array()) {
+            for (const auto& requested : request["translations"]) {
+                if (!requested.is_string()) continue;
+                std::string name = requested.get<std::string>();
+                auto match = std::find_if(loaded.begin(), loaded.end(), [&name](const TranslationInfo& trans) {
+                    return trans.name == name || trans.abbreviation == name;
+                });
+                if (match == loaded.end()) {
+                    return errorResponse(400, "Translation '" + name + "' not found");
+                }
+                translations.push_back(match->name);
+            }
+        } else if (!loaded.empty()) {
+            translations.push_back(loaded[0].name);
+        }
+        if (translations.empty()) {
+            return errorResponse(503, "No translations loaded");
+        }
+        
+        constexpr size_t MAX_BATCH_CELLS = 2000;
+        if (queries.size() * translations.size() > MAX_BATCH_CELLS) {
+            return errorResponse(400, "Batch too large (max " + std::to_string(MAX_BATCH_CELLS) + " query/translation pairs)");
+        }
+        size_t limit = 100; // Per keyword query
+        if (request.contains("limit") && request["limit"].is_number_unsigned()) {
+            limit = std::max<size_t>(1, request["limit"].get<size_t>());
+        }
+        
+        // One lease for every translation asked for, held until the last chunk is written
+        auto lease = std::make_shared<VerseFinder::TranslationLease>(bible.acquireTranslations(translations));
+        if (!*lease) {
+            return errorResponse(503, "Translations could not be loaded");
+        }
+        
+        ApiResponse response;
+        response.body_stream = [this, queries = std::move(queries), translations = std::move(translations),
+                                limit, lease](const ChunkWriter& write) {
+            struct BatchCell {
+                const char* type = "reference";
+                std::vector<VerseId> ids;
+                std::vector<std::vector<MatchSpan>> spans; // keyword matches only, parallel to ids
+                std::string message;
+            };
+            
+            // Look up in parallel blocks; each block is written as soon as it and those before it are done
+            const size_t cell_count = queries.size() * translations.size();
+            const size_t block_size = 16;
+            std::vector<std::future<std::vector<BatchCell>>> blocks;
+            // Lookups read queries and translations, so never return with one still queued
+            struct WaitForBlocks {
+                std::vector<std::future<std::vector<BatchCell>>>& pending;
+                ~WaitForBlocks() {
+                    for (auto& block : pending) {
+                        if (block.valid()) block.wait();
+                    }
+                }
+            } wait_for_blocks{blocks};
+            for (size_t begin = 0; begin < cell_count; begin += block_size) {
+                size_t end = std::min(cell_count, begin + block_size);
+                blocks.push_back(TaskScheduler::shared().submit([this, &queries, &translations, limit, begin, end]() {
+                    std::vector<BatchCell> cells(end - begin);
+                    for (size_t i = begin; i < end; ++i) {
+                        const std::string& query = queries[i / translations.size()];
+                        const std::string& translation = translations[i % translations.size()];
+                        BatchCell& cell = cells[i - begin];
+                        cell.ids = bible.findPassage(query, translation);
+                        if (cell.ids.empty()) {
+                            CachedSearchResult matches = bible.searchKeywordIds(query, translation,
+                                                                                SearchContext().setMaxResults(limit));
+                            cell.type = "keyword";
+                            for (size_t m = 0; m < matches.ids.size(); ++m) {
+                                std::span<const MatchSpan> spans = matches.spansOf(m);
+                                cell.spans.emplace_back(spans.begin(), spans.end());
+                            }
+                            cell.ids = std::move(matches.ids);
+                            cell.message = std::move(matches.message);
+                        }
+                    }
+                    return cells;
+                }));
+            }
+            
+            write("{\"translations\": " + json(translations).dump() + ", \"results\": [");
+            
+            size_t index = 0;
+            for (auto& block : blocks) {
+                std::string chunk;
+                for (const BatchCell& cell : block.get()) {
+                    const std::string& translation = translations[index % translations.size()];
+                    const VerseStore* store = bible.getVerseStore(translation);
+                    json entry = {
+                        {"query", queries[index / translations.size()]},
+                        {"translation", translation},
+                        {"type", cell.type}
+                    };
+                    json verses_json = json::array();
+                    for (size_t v = 0; v < cell.ids.size(); ++v) {
+                        VerseId id = cell.ids[v];
+                        if (!store || id >= store->size()) continue;
+                        json verse = {{"reference", store->reference(id)}, {"text", store->text(id)}};
+                        if (v < cell.spans.size()) {
+                            // Matched words as [begin, end) byte ranges of text
+                            json highlights = json::array();
+                            for (const MatchSpan& span : cell.spans[v]) highlights.push_back({span.begin, span.end});
+                            verse["highlights"] = std::move(highlights);
+                        }
+                        verses_json.push_back(std::move(verse));
+                    }
+                    entry["verses"] = std::move(verses_json);
+                    if (cell.ids.empty()) {
+                        entry["error"] = cell.message.empty() ? "No matching verses found." : cell.message;
+                    }
+                    
+                    if (index > 0) chunk += ", ";
+                    chunk += entry.dump();
+                    ++index;
+                }
+                write(chunk);
+            }
+            write("]}");
+        };
+        return response;
+    });
+    
+    // Prometheus scrape target: search, cache, plugin and frame metrics
+    server.addRoute(HttpMethod::GET, "/metrics", [](const ApiRequest&) -> ApiResponse {
+        static Gauge& resident_memory = MetricsRegistry::shared().gauge(
+            "versefinder_resident_memory_bytes", "Resident memory of the process");
+        resident_memory.set(static_cast<double>(PerformanceBenchmark::getCurrentMemoryUsage()) * 1024.0);
+        MemoryAccounting::publishMetrics();
+        
+        ApiResponse response;
+        response.headers["Content-Type"] = "text/plain; version=0.0.4";
+        response.body = MetricsRegistry::shared().renderPrometheus();
+        return response;
+    });
+    
+    // Recorded spans as Chrome trace JSON (empty unless tracing is on)
+    server.addRoute(HttpMethod::GET, "/api/debug/trace", [](const ApiRequest&) -> ApiResponse {
+        return jsonResponse(Tracer::shared().chromeTraceJson());
+    });
+}
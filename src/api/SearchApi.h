@@ -0,0 +1,36 @@
+#ifndef SEARCH_API_H
+#define SEARCH_API_H
+
+class ApiServer;
+class VerseFinder;
+
+// The read-only search endpoints, shared by the desktop app's API server
+// and the headless versefinder-server:
+//
+//   GET  /api/search        references, passages and paged keyword matches;
+//                           explain=1 adds the plan, counts and stage timings
+//   GET  /api/search/regex  verses matching a regex, in one or more translations
+//   GET  /api/parallel      one verse in several translations
+//   GET  /api/translations  translations found, and whether each is resident
+//   GET  /api/health        liveness and whether translations are listed yet
+//   POST /api/batch         many queries across many translations, streamed
+//   GET  /metrics           Prometheus scrape target
+//   GET  /api/debug/trace   recorded spans as Chrome trace JSON
+//
+// Routes are registered on construction and capture the channel, so it must
+// outlive the server's last request; they hold no state of their own.
+class SearchApi {
+public:
+    SearchApi(ApiServer& server, VerseFinder& bible);
+
+    SearchApi(const SearchApi&) = delete;
+    SearchApi& operator=(const SearchApi&) = delete;
+
+private:
+    ApiServer& server;
+    VerseFinder& bible;
+
+    void registerRoutes();
+};
+
+#endif // SEARCH_API_H
@@ -0,0 +1,214 @@
+#include "WebhookDispatcher.h"
+#include "../core/MetricsRegistry.h"
+#include "../core/Tracer.h"
+#include <algorithm>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+bool retryable(const HttpClient::Response& response) {
+    return !response.error.empty() || response.status >= 500 || response.status == 408 || response.status == 429;
+}
+
+} // namespace
+
+struct WebhookDispatcher::State {
+    struct Delivery {
+        std::string url;
+        std::string event;
+        std::string payload;
+        int attempts = 0;  // failed so far
+        Clock::time_point due;
+        bool in_flight = false;
+        bool has_next = false;
+        std::string next_payload;  // queued while payload was in flight
+    };
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    bool changed = false;
+    std::unordered_map<std::string, Delivery> pending;  // by url + '\0' + event
+    size_t in_flight = 0;
+
+    Counter& delivered = MetricsRegistry::shared().counter(
+        "versefinder_webhook_deliveries_total", "Webhook payloads an endpoint accepted");
+    Counter& retries = MetricsRegistry::shared().counter(
+        "versefinder_webhook_retries_total", "Webhook requests that failed and were scheduled again");
+    Counter& coalesced = MetricsRegistry::shared().counter(
+        "versefinder_webhook_coalesced_total", "Webhook payloads replaced by a later one before delivery");
+    Counter& dead_rejected = MetricsRegistry::shared().counter(
+        "versefinder_webhook_dead_letters_total", "Webhook payloads given up on",
+        MetricsRegistry::label("reason", "rejected"));
+    Counter& dead_exhausted = MetricsRegistry::shared().counter(
+        "versefinder_webhook_dead_letters_total", "Webhook payloads given up on",
+        MetricsRegistry::label("reason", "retries"));
+    Counter& dead_overflow = MetricsRegistry::shared().counter(
+        "versefinder_webhook_dead_letters_total", "Webhook payloads given up on",
+        MetricsRegistry::label("reason", "queue_full"));
+    Gauge& queued = MetricsRegistry::shared().gauge(
+        "versefinder_webhook_pending", "Webhook deliveries waiting or in flight");
+
+    void finish(const std::string& key, const HttpClient::Response& response);
+};
+
+void WebhookDispatcher::State::finish(const std::string& key, const HttpClient::Response& response) {
+    std::lock_guard<std::mutex> lock(mutex);
+    --in_flight;
+    auto it = pending.find(key);
+    if (it == pending.end()) return;
+    Delivery& delivery = it->second;
+    delivery.in_flight = false;
+
+    if (response.ok()) {
+        delivered.add();
+        delivery.attempts = 0;
+        delivery.due = Clock::now();
+    } else if (retryable(response) && delivery.attempts + 1 < MAX_ATTEMPTS) {
+        retries.add();
+        ++delivery.attempts;
+        auto delay = std::min<Clock::duration>(FIRST_RETRY * (1 << (delivery.attempts - 1)), MAX_RETRY);
+        delivery.due = Clock::now() + delay;
+        // A newer payload rides on the same backoff; the failed one is superseded
+        if (delivery.has_next) {
+            delivery.payload = std::move(delivery.next_payload);
+            delivery.has_next = false;
+            coalesced.add();
+        }
+        changed = true;
+        wake.notify_one();
+        return;
+    } else {
+        (retryable(response) ? dead_exhausted : dead_rejected).add();
+        std::cerr << "Webhook " << delivery.event << " -> " << delivery.url << " dropped: "
+                  << (response.error.empty() ? "HTTP " + std::to_string(response.status) : response.error)
+                  << std::endl;
+        delivery.attempts = 0;
+        delivery.due = Clock::now();
+    }
+
+    if (delivery.has_next) {
+        delivery.payload = std::move(delivery.next_payload);
+        delivery.has_next = false;
+        changed = true;
+        wake.notify_one();
+    } else {
+        pending.erase(it);
+        queued.set(static_cast<double>(pending.size()));
+    }
+}
+
+WebhookDispatcher::WebhookDispatcher()
+    : state(std::make_shared<State>()), client("webhooks", MAX_CONCURRENT) {
+    client.setTimeout(TIMEOUT_SECONDS);
+    worker = std::thread(&WebhookDispatcher::run, this);
+}
+
+WebhookDispatcher::~WebhookDispatcher() {
+    size_t dropped = 0;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->stopping = true;
+        dropped = state->pending.size();
+    }
+    state->wake.notify_one();
+    worker.join();
+    if (dropped > 0) {
+        std::cerr << "Webhook dispatcher stopped with " << dropped << " deliveries queued" << std::endl;
+    }
+}
+
+bool WebhookDispatcher::enqueue(const std::string& url, const std::string& event, const std::string& payload) {
+    std::string key;
+    key.reserve(url.size() + 1 + event.size());
+    key.append(url).push_back('\0');
+    key.append(event);
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    auto it = state->pending.find(key);
+    if (it != state->pending.end()) {
+        State::Delivery& delivery = it->second;
+        if (delivery.in_flight) {
+            if (delivery.has_next) state->coalesced.add();
+            delivery.next_payload = payload;
+            delivery.has_next = true;
+        } else {
+            // Still waiting (perhaps backing off): only the latest state is worth sending
+            state->coalesced.add();
+            delivery.payload = payload;
+        }
+        return true;
+    }
+
+    if (state->pending.size() >= MAX_PENDING) {
+        state->dead_overflow.add();
+        return false;
+    }
+    State::Delivery& delivery = state->pending[key];
+    delivery.url = url;
+    delivery.event = event;
+    delivery.payload = payload;
+    delivery.due = Clock::now();
+    state->queued.set(static_cast<double>(state->pending.size()));
+    state->changed = true;
+    state->wake.notify_one();
+    return true;
+}
+
+size_t WebhookDispatcher::getPendingCount() const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->pending.size();
+}
+
+void WebhookDispatcher::run() {
+    Tracer::shared().setThreadName("webhooks");
+    std::vector<std::pair<std::string, HttpClient::Request>> due;
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (!state->stopping) {
+        auto now = Clock::now();
+        auto next_due = Clock::time_point::max();
+        for (auto& entry : state->pending) {
+            State::Delivery& delivery = entry.second;
+            if (delivery.in_flight) continue;
+            if (delivery.due > now) {
+                next_due = std::min(next_due, delivery.due);
+                continue;
+            }
+            HttpClient::Request request;
+            request.method = "POST";
+            request.url = delivery.url;
+            request.headers = {"Content-Type: application/json", "X-VerseFinder-Event: " + delivery.event};
+            request.body = delivery.payload;
+            delivery.in_flight = true;
+            ++state->in_flight;
+            due.emplace_back(entry.first, std::move(request));
+        }
+
+        if (!due.empty()) {
+            lock.unlock();
+            for (auto& [key, request] : due) {
+                client.send(std::move(request), [state = state, key = key](HttpClient::Response response) {
+                    state->finish(key, response);
+                });
+            }
+            due.clear();
+            lock.lock();
+            continue;
+        }
+
+        state->changed = false;
+        auto woken = [this] { return state->stopping || state->changed; };
+        if (next_due == Clock::time_point::max()) {
+            state->wake.wait(lock, woken);
+        } else {
+            state->wake.wait_until(lock, next_due, woken);
+        }
+    }
+}
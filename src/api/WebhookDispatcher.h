@@ -0,0 +1,51 @@
+#ifndef WEBHOOK_DISPATCHER_H
+#define WEBHOOK_DISPATCHER_H
+
+#include "../core/HttpClient.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Delivers webhook events to their URLs off the caller's thread. enqueue()
+// is one map update under a lock; a worker POSTs what is due through a
+// pooled HttpClient lane, at most one request in flight per (URL, event).
+//
+// Deliveries coalesce: a payload queued for a (URL, event) that has not
+// gone out yet replaces the waiting one, and one queued while a request is
+// in flight is sent after it, so a burst of verse changes reaches a slow
+// endpoint as its latest state rather than as a backlog. Transport errors,
+// 5xx, 408 and 429 are retried with exponential backoff up to MAX_ATTEMPTS;
+// other statuses, exhausted retries and deliveries refused because
+// MAX_PENDING are queued are counted as dead letters in the metrics.
+class WebhookDispatcher {
+public:
+    static constexpr size_t MAX_PENDING = 1024;  // (URL, event) pairs waiting or in flight
+    static constexpr int MAX_ATTEMPTS = 6;
+    static constexpr auto FIRST_RETRY = std::chrono::seconds(1);  // doubled after each failure
+    static constexpr auto MAX_RETRY = std::chrono::seconds(60);
+    static constexpr size_t MAX_CONCURRENT = 4;
+    static constexpr long TIMEOUT_SECONDS = 10;
+
+    WebhookDispatcher();
+    // Cancels requests in flight; deliveries still queued are dropped
+    ~WebhookDispatcher();
+
+    WebhookDispatcher(const WebhookDispatcher&) = delete;
+    WebhookDispatcher& operator=(const WebhookDispatcher&) = delete;
+
+    // POSTs payload (JSON) to url with an X-VerseFinder-Event header; false
+    // if the queue is full
+    bool enqueue(const std::string& url, const std::string& event, const std::string& payload);
+    size_t getPendingCount() const;
+
+private:
+    struct State;  // Shared with response callbacks, which can run after the dispatcher is gone
+    std::shared_ptr<State> state;
+    HttpClient client;
+    std::thread worker;
+
+    void run();
+};
+
+#endif // WEBHOOK_DISPATCHER_H
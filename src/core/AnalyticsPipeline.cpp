@@ -0,0 +1,66 @@
+#include "AnalyticsPipeline.h"
+
+AnalyticsPipeline::AnalyticsPipeline() : worker(&AnalyticsPipeline::workerLoop, this) {}
+
+AnalyticsPipeline::~AnalyticsPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(worker_mutex);
+        stopping = true;
+    }
+    worker_wake.notify_one();
+    worker.join();
+}
+
+bool AnalyticsPipeline::enqueue(Event event) {
+    if (events.push(std::move(event))) return true;
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool AnalyticsPipeline::recordSearch(const std::string& query, const std::string& queryType,
+                                     const std::string& translation, int resultCount,
+                                     double executionTime, bool wasSuccessful) {
+    Event event;
+    event.kind = Event::SEARCH;
+    event.query = query;
+    event.detail = queryType;
+    event.translation = translation;
+    event.resultCount = resultCount;
+    event.executionTime = executionTime;
+    event.wasSuccessful = wasSuccessful;
+    return enqueue(std::move(event));
+}
+
+bool AnalyticsPipeline::recordVerseSelection(const std::string& query, const std::string& verseKey) {
+    Event event;
+    event.kind = Event::SELECTION;
+    event.query = query;
+    event.detail = verseKey;
+    return enqueue(std::move(event));
+}
+
+void AnalyticsPipeline::drainLocked() const {
+    Event event;
+    while (events.pop(event)) {
+        if (event.kind == Event::SEARCH) {
+            analytics.recordSearch(event.query, event.detail, event.translation,
+                                   event.resultCount, event.executionTime, event.wasSuccessful);
+        } else {
+            analytics.recordVerseSelection(event.query, event.detail);
+            analytics.recordVerseAccess(event.detail);
+        }
+    }
+}
+
+void AnalyticsPipeline::workerLoop() {
+    std::unique_lock<std::mutex> lock(worker_mutex);
+    while (!stopping) {
+        worker_wake.wait_for(lock, BATCH_INTERVAL, [this] { return stopping; });
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> analytics_lock(analytics_mutex);
+            drainLocked();
+        }
+        lock.lock();
+    }
+}
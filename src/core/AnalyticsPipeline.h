@@ -0,0 +1,81 @@
+#ifndef ANALYTICSPIPELINE_H
+#define ANALYTICSPIPELINE_H
+
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include "SearchAnalytics.h"
+#include "MpscQueue.h"
+
+// Feeds SearchAnalytics from any number of search threads. Recording a
+// search or a selection is one push onto a lock-free queue; a background
+// thread applies the queued events in batches. Readers lock the analytics
+// and apply whatever is still queued first, so they always see their own
+// thread's events. Events arriving while the queue is full are dropped and
+// counted rather than slowing the search down.
+class AnalyticsPipeline {
+public:
+    static constexpr size_t QUEUE_CAPACITY = 4096;
+    static constexpr std::chrono::milliseconds BATCH_INTERVAL{100};
+
+private:
+    struct Event {
+        enum Kind { SEARCH, SELECTION } kind = SEARCH;
+        std::string query;
+        std::string detail; // query type for a search, verse key for a selection
+        std::string translation;
+        int resultCount = 0;
+        double executionTime = 0.0;
+        bool wasSuccessful = false;
+    };
+
+    // Readers drain the queue too, so both are mutable; analytics_mutex guards
+    // analytics and the queue's consumer side
+    mutable SearchAnalytics analytics;
+    mutable std::mutex analytics_mutex;
+    mutable MpscQueue<Event> events{QUEUE_CAPACITY};
+    std::atomic<size_t> dropped{0};
+
+    std::mutex worker_mutex;
+    std::condition_variable worker_wake;
+    bool stopping = false;
+    std::thread worker;
+
+    bool enqueue(Event event);
+    // Caller holds analytics_mutex
+    void drainLocked() const;
+    void workerLoop();
+
+public:
+    AnalyticsPipeline();
+    ~AnalyticsPipeline();
+
+    AnalyticsPipeline(const AnalyticsPipeline&) = delete;
+    AnalyticsPipeline& operator=(const AnalyticsPipeline&) = delete;
+
+    // Safe from any thread; false if the event was dropped
+    bool recordSearch(const std::string& query, const std::string& queryType, const std::string& translation,
+                      int resultCount, double executionTime, bool wasSuccessful);
+    bool recordVerseSelection(const std::string& query, const std::string& verseKey);
+
+    // Run fn on the up-to-date analytics, locked
+    template <typename Fn>
+    auto read(Fn&& fn) const {
+        std::lock_guard<std::mutex> lock(analytics_mutex);
+        drainLocked();
+        return fn(static_cast<const SearchAnalytics&>(analytics));
+    }
+    template <typename Fn>
+    auto update(Fn&& fn) {
+        std::lock_guard<std::mutex> lock(analytics_mutex);
+        drainLocked();
+        return fn(analytics);
+    }
+
+    size_t droppedEvents() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+#endif // ANALYTICSPIPELINE_H
@@ -1,292 +1,511 @@
 #include "AutoComplete.h"
 #include "VerseFinder.h"
-#include <regex>
-#include <sstream>
-#include <cmath>
+#include "BookResolver.h"
+#include <algorithm>
+#include <array>
+#include <deque>
 
-AutoComplete::AutoComplete() : root(std::make_unique<TrieNode>()) {
-}
+namespace {
 
-void AutoComplete::insertWord(const std::string& word) {
-    if (word.empty()) return;
+// Open-addressing word counter: the build hashes every word of every verse,
+// which node-based maps make the slowest step by far. Words are copied when
+// first seen, since a compressed store's text views do not last.
+class WordCounter {
+private:
+    struct Slot {
+        std::string_view word;
+        uint32_t count = 0;
+    };
+    
+    std::vector<Slot> slots = std::vector<Slot>(1 << 14);
+    std::deque<std::string> words; // never moved once added, so slots can view them
+    size_t used = 0;
+    
+    static size_t hashWord(std::string_view word) {
+        uint64_t hash = 1469598103934665603ULL; // FNV-1a
+        for (char c : word) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+        }
+        return static_cast<size_t>(hash ^ (hash >> 32));
+    }
     
-    TrieNode* current = root.get();
-    std::string lower_word = word;
-    std::transform(lower_word.begin(), lower_word.end(), lower_word.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
+    void grow() {
+        std::vector<Slot> old(slots.size() * 2);
+        old.swap(slots);
+        for (const Slot& slot : old) {
+            if (slot.count == 0) continue;
+            size_t mask = slots.size() - 1;
+            size_t i = hashWord(slot.word) & mask;
+            while (slots[i].count != 0) i = (i + 1) & mask;
+            slots[i] = slot;
+        }
+    }
     
-    for (char ch : lower_word) {
-        if (current->children.find(ch) == current->children.end()) {
-            current->children[ch] = std::make_unique<TrieNode>();
+public:
+    void add(std::string_view word) {
+        size_t mask = slots.size() - 1;
+        size_t i = hashWord(word) & mask;
+        while (slots[i].count != 0) {
+            if (slots[i].word == word) {
+                ++slots[i].count;
+                return;
+            }
+            i = (i + 1) & mask;
         }
-        current = current->children[ch].get();
-        current->addCompletion(word);
+        words.emplace_back(word);
+        slots[i] = {words.back(), 1};
+        if (++used * 2 > slots.size()) grow();
     }
-    current->is_end_of_word = true;
-}
-
-void AutoComplete::buildIndex(const std::unordered_map<std::string, std::unordered_map<std::string, Verse>>& verses) {
-    clear();
     
-    for (const auto& translation_pair : verses) {
-        for (const auto& verse_pair : translation_pair.second) {
-            const Verse& verse = verse_pair.second;
-            
-            // Add book name to reference patterns
-            addBookName(verse.book);
-            
-            // Add reference pattern
-            addReferencePattern(verse.book, verse.chapter, verse.verse);
-            
-            // Add verse text for keyword completions
-            addVerseText(verse.text);
+    size_t size() const { return used; }
+    
+    template <typename Visit>
+    void forEach(Visit visit) const {
+        for (const Slot& slot : slots) {
+            if (slot.count != 0) visit(slot.word, slot.count);
         }
     }
-}
+};
 
-void AutoComplete::addBookName(const std::string& book_name) {
-    insertWord(book_name);
-    
-    // Add to reference patterns for chapter/verse completion
-    reference_patterns[book_name] = std::set<std::string>();
-}
+// Word characters as in \w: ASCII letters, digits and underscore
+constexpr std::array<bool, 256> WORD_CHARS = [] {
+    std::array<bool, 256> table{};
+    for (int c = '0'; c <= '9'; ++c) table[c] = true;
+    for (int c = 'a'; c <= 'z'; ++c) table[c] = table[c - 'a' + 'A'] = true;
+    table['_'] = true;
+    return table;
+}();
 
-void AutoComplete::addVerseText(const std::string& text) {
-    // Simple tokenization - split on whitespace and punctuation
-    std::regex word_regex(R"(\b\w+\b)");
-    std::sregex_iterator words_begin(text.begin(), text.end(), word_regex);
-    std::sregex_iterator words_end;
-    
-    for (std::sregex_iterator i = words_begin; i != words_end; ++i) {
-        std::string word = (*i).str();
-        if (word.length() >= 3) { // Only index words of 3+ characters
-            insertWord(word);
-            updateWordFrequency(word);
+void addVerseWords(std::string_view text, WordCounter& counts) {
+    auto is_word = [](char c) { return WORD_CHARS[static_cast<unsigned char>(c)]; };
+    
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !is_word(text[i])) ++i;
+        size_t start = i;
+        while (i < text.size() && is_word(text[i])) ++i;
+        if (i - start >= 3) { // Only index words of 3+ characters
+            counts.add(text.substr(start, i - start));
         }
     }
 }
 
-void AutoComplete::addReferencePattern(const std::string& book, int chapter, int verse) {
-    // Add patterns like "John 3", "John 3:16"
-    std::string chapter_ref = book + " " + std::to_string(chapter);
-    std::string verse_ref = chapter_ref + ":" + std::to_string(verse);
-    
-    reference_patterns[book].insert(chapter_ref);
-    reference_patterns[book].insert(verse_ref);
-    
-    insertWord(chapter_ref);
-    insertWord(verse_ref);
+std::string lowerAscii(std::string_view text) {
+    std::string lower(text);
+    for (char& c : lower) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return lower;
 }
 
-bool AutoComplete::isReferencePattern(const std::string& input) const {
-    // Check if input looks like a Bible reference
-    std::regex reference_regex(R"(\b\w+\s*\d+(?::\d+)?\s*$)");
-    return std::regex_search(input, reference_regex);
+bool allDigits(std::string_view text) {
+    return std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; });
 }
 
-std::vector<std::string> AutoComplete::generateReferenceCompletions(const std::string& input) const {
-    std::vector<std::string> completions;
+// 0 for anything that is not a plausible chapter or verse number
+size_t parseNumber(std::string_view digits) {
+    if (digits.empty() || digits.size() > 4 || !allDigits(digits)) return 0;
+    size_t value = 0;
+    for (char c : digits) value = value * 10 + static_cast<size_t>(c - '0');
+    return value;
+}
+
+// "Book", "Book C" or "Book C:V", any part after the book possibly cut
+// short: "John 3:" has an empty verse, "1 John " an empty chapter
+struct ReferencePrefix {
+    std::string_view book;
+    std::string_view chapter;
+    bool colon = false;
+    std::string_view verse;
+};
+
+bool splitReferencePrefix(std::string_view input, ReferencePrefix& prefix) {
+    prefix = ReferencePrefix{};
+    std::string_view rest = input;
+    size_t colon = rest.find(':');
+    if (colon != std::string_view::npos) {
+        prefix.colon = true;
+        prefix.verse = rest.substr(colon + 1);
+        if (!allDigits(prefix.verse)) return false;
+        rest = rest.substr(0, colon);
+    }
     
-    // Extract book name from input
-    std::regex book_regex(R"(^(\w+(?:\s+\w+)*))");
-    std::smatch book_match;
-    
-    if (std::regex_search(input, book_match, book_regex)) {
-        std::string book_part = book_match[1].str();
-        
-        // Find matching books
-        for (const auto& pattern_pair : reference_patterns) {
-            const std::string& book = pattern_pair.first;
-            if (book.find(book_part) == 0 || 
-                (book.length() >= book_part.length() && 
-                 std::equal(book_part.begin(), book_part.end(), book.begin(),
-                           [](char a, char b) { return std::tolower(a) == std::tolower(b); }))) {
-                
-                // Add matching patterns for this book
-                for (const std::string& pattern : pattern_pair.second) {
-                    if (pattern.find(input) == 0) {
-                        completions.push_back(pattern);
-                        if (completions.size() >= 10) break;
-                    }
-                }
-            }
-        }
+    // The chapter is the digits after the last space; a book name may hold digits too ("1 John")
+    size_t space = rest.find_last_of(' ');
+    if (space != std::string_view::npos && allDigits(rest.substr(space + 1))) {
+        prefix.chapter = rest.substr(space + 1);
+        rest = rest.substr(0, space);
+    } else if (prefix.colon) {
+        return false;
     }
+    if (prefix.colon && prefix.chapter.empty()) return false;
     
-    return completions;
+    while (!rest.empty() && rest.back() == ' ') rest.remove_suffix(1);
+    while (!rest.empty() && rest.front() == ' ') rest.remove_prefix(1);
+    prefix.book = rest;
+    return !rest.empty();
 }
 
-std::vector<std::string> AutoComplete::generateKeywordCompletions(const std::string& input) const {
-    std::vector<std::string> completions;
-    
-    if (input.empty()) return completions;
-    
-    std::string lower_input = input;
-    std::transform(lower_input.begin(), lower_input.end(), lower_input.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
+} // namespace
+
+AutoComplete::AutoComplete() {
+    auto empty = std::make_shared<RankingData>();
+    empty->trie = std::make_shared<CompletionTrie>();
+    ranking = std::move(empty);
+}
+
+std::shared_ptr<const AutoComplete::RankingData> AutoComplete::snapshot() const {
+    return std::atomic_load_explicit(&ranking, std::memory_order_acquire);
+}
+
+void AutoComplete::publish(std::shared_ptr<const RankingData> data) {
+    // Readers still holding the old snapshot keep it alive until they finish
+    std::atomic_store_explicit(&ranking, std::move(data), std::memory_order_release);
+}
+
+void AutoComplete::buildIndex(const VerseStoreMap& verses,
+                              const std::vector<std::pair<std::string, uint32_t>>& query_log) {
+    // Built off to the side; lookups keep using the previous trie until it is swapped in
+    auto data = std::make_shared<RankingData>();
+
+    WordCounter word_counts;
+    std::vector<CompletionTrie::Source> sources;
     
-    TrieNode* current = root.get();
+    for (const auto& translation_pair : verses) {
+        const VerseStore& store = *translation_pair.second;
+        addBooks(store, *data, sources);
     
-    // Navigate to the prefix node
-    for (char ch : lower_input) {
-        if (current->children.find(ch) == current->children.end()) {
-            return completions; // No completions found
+        // Add verse text for keyword completions
+        for (VerseId id = 0; id < store.size(); ++id) {
+            addVerseWords(store.text(id), word_counts);
         }
-        current = current->children[ch].get();
     }
     
-    // Collect completions from this node
-    collectCompletions(current, input, completions, 10);
-    
-    return completions;
+    sources.reserve(sources.size() + word_counts.size());
+    word_counts.forEach([&sources](std::string_view word, uint32_t count) {
+        sources.push_back({std::string(word), count});
+    });
+    
+    // Logged searches weigh into the precomputed rankings; "john 3:16" counts for "John 3:16"
+    std::string reference;
+    for (const auto& [query, count] : query_log) {
+        if (query.empty() || query.size() > MAX_LOGGED_QUERY_LENGTH) continue;
+        if (canonicalReference(*data, query, reference)) {
+            data->reference_counts[reference] += count;
+            continue;
+        }
+        uint64_t weight = static_cast<uint64_t>(count) * QUERY_LOG_WEIGHT;
+        sources.push_back({query, static_cast<uint32_t>(std::min<uint64_t>(weight, UINT32_MAX / 2)), true});
+    }
+    auto trie = std::make_shared<CompletionTrie>();
+    trie->build(std::move(sources));
+    
+    data->trie = std::move(trie);
+    data->learned.assign(data->trie->size(), 0);
+    
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    for (const auto& learned_pair : learned_totals) {
+        CompletionTrie::EntryId id = data->trie->find(learned_pair.first);
+        if (id != CompletionTrie::NO_ENTRY) {
+            data->learned[id] = learned_pair.second;
+        } else if (canonicalReference(*data, learned_pair.first, reference)) {
+            data->reference_counts[reference] += learned_pair.second;
+        }
+    }
+    indexLearned(*data);
+    publish(std::move(data));
+    mergePendingLocked();
 }
 
-void AutoComplete::collectCompletions(TrieNode* node, const std::string& /* prefix */, 
-                                    std::vector<std::string>& results, int max_results) const {
-    if (!node || results.size() >= static_cast<size_t>(max_results)) return;
+void AutoComplete::addBooks(const VerseStore& store, RankingData& data, std::vector<CompletionTrie::Source>& sources) {
+    // Book names are entries, weighted by the verses they cover; their chapters and verses are bounds
+    for (size_t book_id = 0; book_id < store.books().size(); ++book_id) {
+        const std::string& book = store.books()[book_id];
+        int book_id_value = static_cast<int>(book_id);
+        sources.push_back({book, store.bookRange(book_id_value).size()});
+    
+        auto inserted = data.book_ids.emplace(lowerAscii(book), static_cast<uint32_t>(data.books.size()));
+        if (inserted.second) {
+            data.books.push_back({book, {}, {}, 0});
+            data.canonical_book_ids.emplace(BookResolver::canonicalBook(book), inserted.first->second);
+        }
+        ReferenceBook& bounds = data.books[inserted.first->second];
+        ++bounds.translations;
     
-    // Add all completions stored at this node
-    for (const std::string& completion : node->completions) {
-        if (results.size() >= static_cast<size_t>(max_results)) break;
-        results.push_back(completion);
+        size_t chapters = static_cast<size_t>(std::max(store.lastChapter(book_id_value), 0));
+        if (bounds.verse_counts.size() < chapters) {
+            bounds.verse_counts.resize(chapters, 0);
+            bounds.chapter_frequency.resize(chapters, 0);
+        }
+        for (size_t chapter = 1; chapter <= chapters; ++chapter) {
+            VerseRange range = store.chapterRange(book_id_value, static_cast<int>(chapter));
+            int last_verse = 0;
+            for (uint32_t position = range.first; position < range.last; ++position) {
+                last_verse = std::max(last_verse, store.verseNumber(store.atPosition(position)));
+            }
+            bounds.verse_counts[chapter - 1] = static_cast<uint16_t>(
+                std::max<int>(bounds.verse_counts[chapter - 1], std::min(last_verse, UINT16_MAX)));
+            bounds.chapter_frequency[chapter - 1] += range.size();
+        }
     }
 }
 
-std::vector<std::string> AutoComplete::getCompletions(const std::string& input, int max_results) const {
-    if (input.empty()) return {};
-    
-    // Check cache first
-    auto cache_it = suggestion_cache.find(input);
-    if (cache_it != suggestion_cache.end()) {
-        auto result = cache_it->second;
-        if (result.size() > static_cast<size_t>(max_results)) {
-            result.resize(max_results);
-        }
-        return result;
+const AutoComplete::ReferenceBook* AutoComplete::findBook(const RankingData& data, std::string_view name) {
+    // A translation's own name first, then the usual names and abbreviations of the 66
+    auto it = data.book_ids.find(lowerAscii(name));
+    if (it != data.book_ids.end()) return &data.books[it->second];
+    int canonical = BookResolver::canonicalBook(name);
+    if (canonical == 0) return nullptr;
+    auto canonical_it = data.canonical_book_ids.find(canonical);
+    return canonical_it != data.canonical_book_ids.end() ? &data.books[canonical_it->second] : nullptr;
+}
+
+bool AutoComplete::canonicalReference(const RankingData& data, const std::string& query, std::string& reference) {
+    ReferencePrefix prefix;
+    if (!splitReferencePrefix(query, prefix) || prefix.chapter.empty() || (prefix.colon && prefix.verse.empty())) {
+        return false;
     }
-    
-    std::vector<std::string> completions;
-    
-    if (isReferencePattern(input)) {
-        completions = generateReferenceCompletions(input);
-    } else {
-        completions = generateKeywordCompletions(input);
+    const ReferenceBook* book = findBook(data, prefix.book);
+    if (!book) return false;
+    
+    size_t chapter = parseNumber(prefix.chapter);
+    if (chapter == 0 || chapter > book->verse_counts.size()) return false;
+    reference = book->name + " " + std::to_string(chapter);
+    if (prefix.colon) {
+        size_t verse = parseNumber(prefix.verse);
+        if (verse == 0 || verse > book->verse_counts[chapter - 1]) return false;
+        reference += ":" + std::to_string(verse);
     }
+    return true;
+}
+
+void AutoComplete::referenceCompletions(const RankingData& data, const std::string& input,
+                                        std::vector<Candidate>& candidates) {
+    ReferencePrefix prefix;
+    if (!splitReferencePrefix(input, prefix)) return;
+    const ReferenceBook* book = findBook(data, prefix.book);
+    if (!book) return;
+    
+    auto add = [&](std::string text, uint64_t frequency) {
+        auto it = data.reference_counts.find(text);
+        if (it != data.reference_counts.end()) frequency += static_cast<uint64_t>(it->second) * QUERY_LOG_WEIGHT;
+        candidates.push_back({std::move(text), frequency});
+    };
+    auto add_verses = [&](size_t chapter, std::string_view verse_prefix) {
+        std::string chapter_ref = book->name + " " + std::to_string(chapter) + ":";
+        for (size_t verse = 1; verse <= book->verse_counts[chapter - 1]; ++verse) {
+            std::string number = std::to_string(verse);
+            if (number.compare(0, verse_prefix.size(), verse_prefix) == 0) {
+                add(chapter_ref + number, book->translations);
+            }
+        }
+    };
     
-    // Rank and limit results
-    rankSuggestions(completions, input);
-    if (completions.size() > static_cast<size_t>(max_results)) {
-        completions.resize(max_results);
+    if (prefix.colon) {
+        size_t chapter = parseNumber(prefix.chapter);
+        if (chapter == 0 || chapter > book->verse_counts.size()) return;
+        add_verses(chapter, prefix.verse);
+        return;
     }
     
-    // Cache the result
-    if (suggestion_cache.size() >= MAX_CACHE_SIZE) {
-        manageCacheSize();
+    // Chapters are weighted by the verses they hold, as books are, so they
+    // outrank the verses of a chapter typed in full
+    for (size_t chapter = 1; chapter <= book->verse_counts.size(); ++chapter) {
+        std::string number = std::to_string(chapter);
+        if (number.compare(0, prefix.chapter.size(), prefix.chapter) == 0) {
+            add(book->name + " " + number, book->chapter_frequency[chapter - 1]);
+        }
+    }
+    size_t typed_chapter = parseNumber(prefix.chapter);
+    if (typed_chapter != 0 && typed_chapter <= book->verse_counts.size()) {
+        add_verses(typed_chapter, "");
+    }
+}
+
+uint64_t AutoComplete::blendedFrequency(const RankingData& data, CompletionTrie::EntryId id) {
+    return data.trie->frequency(id) + static_cast<uint64_t>(data.learned[id]) * QUERY_LOG_WEIGHT;
+}
+
+void AutoComplete::rankByFrequency(const RankingData& data, std::vector<CompletionTrie::EntryId>& ids) {
+    std::sort(ids.begin(), ids.end(), [&data](CompletionTrie::EntryId a, CompletionTrie::EntryId b) {
+        uint64_t frequency_a = blendedFrequency(data, a);
+        uint64_t frequency_b = blendedFrequency(data, b);
+        if (frequency_a != frequency_b) return frequency_a > frequency_b;
+        return a < b;
+    });
+}
+
+void AutoComplete::addLearned(const RankingData& data, CompletionTrie::EntryId first, CompletionTrie::EntryId last,
+                              std::vector<CompletionTrie::EntryId>& ids) {
+    // Entries the trie ranked below its top ones may have been searched since
+    auto learned_it = std::lower_bound(data.learned_ids.begin(), data.learned_ids.end(), first);
+    for (size_t added = 0; learned_it != data.learned_ids.end() && *learned_it < last &&
+                           added < MAX_LEARNED_CANDIDATES; ++learned_it, ++added) {
+        if (std::find(ids.begin(), ids.end(), *learned_it) == ids.end()) {
+            ids.push_back(*learned_it);
+        }
+    }
+}
+
+std::vector<AutoComplete::Candidate> AutoComplete::exactCompletions(const RankingData& data,
+                                                                    const std::string& input) {
+    // The trie's best entries under this prefix, plus any learned ones it ranked lower
+    std::vector<CompletionTrie::EntryId> ids;
+    data.trie->complete(input, CompletionTrie::TOP_K, ids);
+    auto [first, last] = data.trie->prefixRange(input);
+    addLearned(data, first, last, ids);
+    
+    std::vector<Candidate> candidates;
+    candidates.reserve(ids.size());
+    for (CompletionTrie::EntryId id : ids) {
+        candidates.push_back({std::string(data.trie->text(id)), blendedFrequency(data, id)});
+    }
+    referenceCompletions(data, input, candidates);
+    // Entries first among equals, then references in numeric order
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const Candidate& a, const Candidate& b) { return a.frequency > b.frequency; });
+    return candidates;
+}
+
+std::vector<CompletionTrie::EntryId> AutoComplete::typoCompletions(const RankingData& data, const std::string& input) {
+    std::vector<CompletionTrie::EntryId> ids;
+    std::vector<std::pair<CompletionTrie::EntryId, CompletionTrie::EntryId>> ranges;
+    data.trie->completeTypo(input, ids, ranges);
+    for (const auto& [first, last] : ranges) {
+        addLearned(data, first, last, ids);
     }
-    suggestion_cache[input] = completions;
     
-    return completions;
+    // The exact completions are listed already
+    auto [exact_first, exact_last] = data.trie->prefixRange(input);
+    ids.erase(std::remove_if(ids.begin(), ids.end(),
+                             [&](CompletionTrie::EntryId id) { return id >= exact_first && id < exact_last; }),
+              ids.end());
+    rankByFrequency(data, ids);
+    return ids;
 }
 
-std::vector<std::string> AutoComplete::getSmartSuggestions(const std::string& input, int max_results) const {
-    std::vector<std::string> suggestions = getCompletions(input, max_results * 2);
+std::vector<std::string> AutoComplete::getCompletions(const std::string& input, int max_results) const {
+    if (input.empty() || max_results <= 0) return {};
     
-    // Apply additional smart filtering and ranking
-    rankSuggestions(suggestions, input);
+    // One snapshot for the whole lookup, so a concurrent swap cannot mix generations
+    std::shared_ptr<const RankingData> data = snapshot();
+    std::vector<Candidate> candidates = exactCompletions(*data, input);
+    if (candidates.size() > static_cast<size_t>(max_results)) {
+        candidates.resize(max_results);
+    }
     
-    if (suggestions.size() > static_cast<size_t>(max_results)) {
-        suggestions.resize(max_results);
+    std::vector<std::string> completions;
+    completions.reserve(candidates.size());
+    for (Candidate& candidate : candidates) {
+        completions.push_back(std::move(candidate.text));
     }
     
-    return suggestions;
+    return completions;
 }
 
-double AutoComplete::calculateWordScore(const std::string& word, const std::string& input) const {
-    double score = 0.0;
+std::vector<std::string> AutoComplete::getSmartSuggestions(const std::string& input, int max_results) const {
+    if (input.empty() || max_results <= 0) return {};
     
-    // Exact prefix match gets highest score
-    if (word.find(input) == 0) {
-        score += 100.0;
+    std::shared_ptr<const RankingData> data = snapshot();
+    std::vector<Candidate> candidates = exactCompletions(*data, input);
+    if (candidates.size() > static_cast<size_t>(max_results)) {
+        candidates.resize(max_results);
     }
     
-    // Case-insensitive prefix match
-    std::string lower_word = word;
-    std::string lower_input = input;
-    std::transform(lower_word.begin(), lower_word.end(), lower_word.begin(), ::tolower);
-    std::transform(lower_input.begin(), lower_input.end(), lower_input.begin(), ::tolower);
-    
-    if (lower_word.find(lower_input) == 0) {
-        score += 50.0;
+    std::vector<std::string> suggestions;
+    suggestions.reserve(max_results);
+    for (Candidate& candidate : candidates) {
+        suggestions.push_back(std::move(candidate.text));
     }
     
-    // Frequency boost
-    auto freq_it = word_frequency.find(word);
-    if (freq_it != word_frequency.end()) {
-        score += std::log(freq_it->second + 1) * 10.0;
+    // A mistyped prefix has few or no exact completions; fill up from one edit away
+    if (suggestions.size() < static_cast<size_t>(max_results) && input.size() >= MIN_TYPO_INPUT) {
+        for (CompletionTrie::EntryId id : typoCompletions(*data, input)) {
+            if (suggestions.size() >= static_cast<size_t>(max_results)) break;
+            suggestions.emplace_back(data->trie->text(id));
+        }
     }
     
-    // Length penalty (prefer shorter completions)
-    score -= word.length() * 0.1;
-    
-    return score;
+    return suggestions;
 }
 
-void AutoComplete::rankSuggestions(std::vector<std::string>& suggestions, const std::string& input) const {
-    std::sort(suggestions.begin(), suggestions.end(),
-              [this, &input](const std::string& a, const std::string& b) {
-                  return calculateWordScore(a, input) > calculateWordScore(b, input);
-              });
+void AutoComplete::updateWordFrequency(const std::string& word) {
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    ++pending_frequency[word];
+    
+    // Batch bursts of updates into one snapshot copy
+    if (std::chrono::steady_clock::now() - last_merge >= MERGE_INTERVAL) {
+        mergePendingLocked();
+    }
 }
 
-void AutoComplete::updateWordFrequency(const std::string& word) {
-    word_frequency[word]++;
+void AutoComplete::mergePendingLocked() {
+    last_merge = std::chrono::steady_clock::now();
+    if (pending_frequency.empty()) return;
+    
+    std::shared_ptr<const RankingData> current = snapshot();
+    auto next = std::make_shared<RankingData>(*current);
+    std::string reference;
+    for (const auto& pending_pair : pending_frequency) {
+        CompletionTrie::EntryId id = next->trie->find(pending_pair.first);
+        if (id != CompletionTrie::NO_ENTRY) {
+            next->learned[id] += pending_pair.second;
+            learned_totals[pending_pair.first] = next->learned[id];
+        } else if (canonicalReference(*next, pending_pair.first, reference)) {
+            next->reference_counts[reference] += pending_pair.second;
+            learned_totals[pending_pair.first] += pending_pair.second;
+        }
+        // Other queries are not completions and cannot change any ranking
+    }
+    pending_frequency.clear();
+    indexLearned(*next);
+    publish(std::move(next));
 }
 
-void AutoComplete::clearCache() {
-    suggestion_cache.clear();
+void AutoComplete::indexLearned(RankingData& data) {
+    data.learned_ids.clear();
+    for (CompletionTrie::EntryId id = 0; id < data.learned.size(); ++id) {
+        if (data.learned[id] != 0) data.learned_ids.push_back(id);
+    }
 }
 
-void AutoComplete::manageCacheSize() const {
-    // Remove oldest half of cache entries when limit is reached
-    auto it = suggestion_cache.begin();
-    std::advance(it, suggestion_cache.size() / 2);
-    suggestion_cache.erase(suggestion_cache.begin(), it);
+void AutoComplete::clearCache() {
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    mergePendingLocked();
 }
 
 size_t AutoComplete::getMemoryUsage() const {
-    // Rough estimation of memory usage
-    size_t size = 0;
-    
-    // Trie structure (approximation)
-    size += sizeof(TrieNode) * 1000; // Rough estimate
-    
-    // Reference patterns
-    for (const auto& pattern_pair : reference_patterns) {
-        size += pattern_pair.first.size();
-        for (const auto& pattern : pattern_pair.second) {
-            size += pattern.size();
-        }
+    std::shared_ptr<const RankingData> data = snapshot();
+    size_t size = data->trie->getMemoryUsage() + data->learned.capacity() * sizeof(uint32_t) +
+                  data->learned_ids.capacity() * sizeof(CompletionTrie::EntryId);
+    
+    // Reference bounds
+    for (const ReferenceBook& book : data->books) {
+        size += sizeof(ReferenceBook) + book.name.size() + book.verse_counts.capacity() * sizeof(uint16_t) +
+                book.chapter_frequency.capacity() * sizeof(uint32_t);
     }
-    
-    // Word frequency map
-    for (const auto& freq_pair : word_frequency) {
-        size += freq_pair.first.size() + sizeof(int);
+    for (const auto& reference_pair : data->reference_counts) {
+        size += reference_pair.first.size() + sizeof(uint32_t);
     }
     
-    // Cache
-    for (const auto& cache_pair : suggestion_cache) {
-        size += cache_pair.first.size();
-        for (const auto& suggestion : cache_pair.second) {
-            size += suggestion.size();
-        }
+    // Learned frequencies
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    for (const auto& learned_pair : learned_totals) {
+        size += learned_pair.first.size() + sizeof(uint32_t);
+    }
+    for (const auto& pending_pair : pending_frequency) {
+        size += pending_pair.first.size() + sizeof(uint32_t);
     }
     
     return size;
 }
 
 void AutoComplete::clear() {
-    root = std::make_unique<TrieNode>();
-    reference_patterns.clear();
-    word_frequency.clear();
-    clearCache();
+    auto empty = std::make_shared<RankingData>();
+    empty->trie = std::make_shared<CompletionTrie>();
+    
+    std::lock_guard<std::mutex> lock(writer_mutex);
+    pending_frequency.clear();
+    learned_totals.clear();
+    publish(std::move(empty));
 }
\ No newline at end of file
@@ -4,49 +4,91 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
-#include <set>
-#include <algorithm>
+#include <string_view>
 #include <memory>
+#include <mutex>
+#include <chrono>
+#include "CompletionTrie.h"
+#include "VerseStore.h"
 
-struct TrieNode {
-    std::unordered_map<char, std::unique_ptr<TrieNode>> children;
-    std::vector<std::string> completions;
-    bool is_end_of_word = false;
-    
-    // Limit completions per node for memory efficiency
-    static constexpr size_t MAX_COMPLETIONS = 10;
-    
-    void addCompletion(const std::string& word) {
-        if (completions.size() < MAX_COMPLETIONS) {
-            // Insert in sorted order for faster retrieval
-            auto it = std::lower_bound(completions.begin(), completions.end(), word);
-            if (it == completions.end() || *it != word) {
-                completions.insert(it, word);
-            }
-        }
-    }
-};
-
+// Lookups run on the UI thread at every keystroke while frequency learning
+// and index rebuilds happen elsewhere. Everything a lookup reads is one
+// immutable snapshot: readers only copy the pointer and never wait for a
+// rebuild or merge; writers build a replacement and swap it in
+// (read-copy-update).
+//
+// Entries rank by corpus frequency plus QUERY_LOG_WEIGHT per logged search
+// that named them. The query log given to buildIndex() is folded into the
+// trie's precomputed top entries; searches submitted afterwards are learned
+// counts blended in at lookup. getSmartSuggestions() also completes prefixes
+// one typo away once exact completions run out.
+//
+// References are not entries: "Book C" and "Book C:V" completions are
+// generated at lookup from each book's chapter and verse counts, once the
+// input names a book.
 class AutoComplete {
+public:
+    static constexpr uint32_t QUERY_LOG_WEIGHT = 50;
+    static constexpr size_t MIN_TYPO_INPUT = 3; // shorter prefixes are one edit from too much
+    static constexpr size_t MAX_LOGGED_QUERY_LENGTH = 64;
+
 private:
-    std::unique_ptr<TrieNode> root;
-    std::unordered_map<std::string, std::set<std::string>> reference_patterns;
-    std::unordered_map<std::string, int> word_frequency;
-    
-    // Cache for recent searches to improve performance
-    mutable std::unordered_map<std::string, std::vector<std::string>> suggestion_cache;
-    static constexpr size_t MAX_CACHE_SIZE = 1000;
-    
-    void insertWord(const std::string& word);
-    void collectCompletions(TrieNode* node, const std::string& prefix, 
-                           std::vector<std::string>& results, int max_results) const;
+    // One book's bounds across every translation that has it
+    struct ReferenceBook {
+        std::string name;
+        std::vector<uint16_t> verse_counts;       // per chapter, the most any translation has
+        std::vector<uint32_t> chapter_frequency;  // per chapter, verses summed over translations
+        uint32_t translations = 0;
+    };
+    
+    struct RankingData {
+        // Book names and verse words of every translation
+        std::shared_ptr<const CompletionTrie> trie;
+        TaggedVector<uint32_t, MemoryTag::AUTOCOMPLETE> learned; // submitted-query counts, per trie entry
+        TaggedVector<CompletionTrie::EntryId, MemoryTag::AUTOCOMPLETE> learned_ids; // sorted ids whose count is non-zero
+        std::vector<ReferenceBook> books;
+        std::unordered_map<std::string, uint32_t> book_ids;      // lower-cased name -> index in books
+        std::unordered_map<int, uint32_t> canonical_book_ids;    // BookResolver number -> index in books
+        std::unordered_map<std::string, uint32_t> reference_counts; // "Book C[:V]" -> logged and submitted searches
+    };
+    
+    struct Candidate {
+        std::string text;
+        uint64_t frequency;
+    };
+    
+    // Only accessed through std::atomic_load / std::atomic_store
+    std::shared_ptr<const RankingData> ranking;
+    
+    // Frequency updates wait here until the next merge. The mutex also
+    // serializes writers, so a merge never races a rebuild.
+    mutable std::mutex writer_mutex;
+    std::unordered_map<std::string, uint32_t> pending_frequency;
+    std::unordered_map<std::string, uint32_t> learned_totals; // survives rebuilds
+    std::chrono::steady_clock::time_point last_merge;
+    static constexpr std::chrono::milliseconds MERGE_INTERVAL{500};
+    static constexpr size_t MAX_LEARNED_CANDIDATES = 64; // per lookup, on top of the trie's top entries
+    
+    std::shared_ptr<const RankingData> snapshot() const;
+    void publish(std::shared_ptr<const RankingData> data);
+    void mergePendingLocked();
+    static void indexLearned(RankingData& data);
     
-    // Reference pattern matching (e.g., "John 3:16", "Genesis 1")
-    bool isReferencePattern(const std::string& input) const;
-    std::vector<std::string> generateReferenceCompletions(const std::string& input) const;
-    
-    // Keyword-based completions
-    std::vector<std::string> generateKeywordCompletions(const std::string& input) const;
+    // Helper methods for building the index
+    static void addBooks(const VerseStore& store, RankingData& data, std::vector<CompletionTrie::Source>& sources);
+    static const ReferenceBook* findBook(const RankingData& data, std::string_view name);
+    // "Book C" or "Book C:V" as generated, if query is a reference within the bounds
+    static bool canonicalReference(const RankingData& data, const std::string& query, std::string& reference);
+    static void referenceCompletions(const RankingData& data, const std::string& input,
+                                     std::vector<Candidate>& candidates);
+    
+    // Ranking
+    static uint64_t blendedFrequency(const RankingData& data, CompletionTrie::EntryId id);
+    static void rankByFrequency(const RankingData& data, std::vector<CompletionTrie::EntryId>& ids);
+    static void addLearned(const RankingData& data, CompletionTrie::EntryId first, CompletionTrie::EntryId last,
+                           std::vector<CompletionTrie::EntryId>& ids);
+    static std::vector<Candidate> exactCompletions(const RankingData& data, const std::string& input);
+    static std::vector<CompletionTrie::EntryId> typoCompletions(const RankingData& data, const std::string& input);
 
 public:
     AutoComplete();
@@ -56,22 +98,21 @@ public:
     AutoComplete(const AutoComplete&) = delete;
     AutoComplete& operator=(const AutoComplete&) = delete;
     
-    // Build the autocomplete index from verse data
-    void buildIndex(const std::unordered_map<std::string, std::unordered_map<std::string, struct Verse>>& verses);
+    // Build the autocomplete index from verse data and the searches that found
+    // something (query, count); logged queries that are not words or
+    // references become completions of their own
+    void buildIndex(const VerseStoreMap& verses, const std::vector<std::pair<std::string, uint32_t>>& query_log = {});
     
-    // Add a book name to the reference patterns
-    void addBookName(const std::string& book_name);
-    
-    // Get completions for a given input string
+    // Completions of exactly this prefix (case-insensitive), best first
     std::vector<std::string> getCompletions(const std::string& input, int max_results = 10) const;
     
-    // Get smart suggestions that consider context and frequency
+    // Exact completions, then those of prefixes one typo away
     std::vector<std::string> getSmartSuggestions(const std::string& input, int max_results = 10) const;
     
-    // Clear the suggestion cache
+    // Fold pending frequency updates into the published ranking now
     void clearCache();
     
-    // Update word frequency for better ranking
+    // Update word frequency for better ranking; takes effect at the next merge
     void updateWordFrequency(const std::string& word);
     
     // Get memory usage statistics
@@ -79,18 +120,6 @@ public:
     
     // Clear all data
     void clear();
-    
-private:
-    // Helper methods for building the index
-    void addVerseText(const std::string& text);
-    void addReferencePattern(const std::string& book, int chapter, int verse);
-    
-    // Scoring and ranking functions
-    double calculateWordScore(const std::string& word, const std::string& input) const;
-    void rankSuggestions(std::vector<std::string>& suggestions, const std::string& input) const;
-    
-    // Cache management
-    void manageCacheSize() const;
 };
 
 #endif // AUTOCOMPLETE_H
\ No newline at end of file
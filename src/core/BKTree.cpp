@@ -0,0 +1,92 @@
+#include "BKTree.h"
+#include "EditDistance.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+uint32_t BKTree::appendNode(std::string_view word, int distance) {
+    Node node;
+    node.word_offset = static_cast<uint32_t>(words.size());
+    node.word_length = static_cast<uint16_t>(std::min<size_t>(word.size(), std::numeric_limits<uint16_t>::max()));
+    node.distance = static_cast<uint16_t>(distance);
+    words.append(word.data(), node.word_length);
+    nodes.push_back(node);
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+void BKTree::build(std::vector<std::string_view> vocabulary) {
+    clear();
+    std::sort(vocabulary.begin(), vocabulary.end());
+
+    size_t total = 0;
+    for (std::string_view word : vocabulary) total += word.size();
+    words.reserve(total);
+    nodes.reserve(vocabulary.size());
+
+    for (std::string_view word : vocabulary) {
+        insert(word);
+    }
+}
+
+void BKTree::insert(std::string_view word) {
+    if (nodes.empty()) {
+        appendNode(word, 0);
+        return;
+    }
+
+    const EditDistance::Pattern pattern(word);
+    uint32_t current = 0;
+    while (true) {
+        int distance = pattern.distance(wordAt(nodes[current]));
+        if (distance == 0) return; // Already present
+
+        // Descend into the child at the same distance, or hang a new one here
+        uint32_t child = nodes[current].first_child;
+        while (child != NO_NODE && nodes[child].distance != distance) {
+            child = nodes[child].next_sibling;
+        }
+        if (child != NO_NODE) {
+            current = child;
+            continue;
+        }
+
+        uint32_t added = appendNode(word, distance);
+        nodes[added].next_sibling = nodes[current].first_child;
+        nodes[current].first_child = added;
+        return;
+    }
+}
+
+void BKTree::clear() {
+    words.clear();
+    nodes.clear();
+}
+
+std::vector<BKTree::Match> BKTree::search(std::string_view query, int max_distance) const {
+    std::vector<Match> matches;
+    if (nodes.empty() || max_distance < 0) return matches;
+
+    const EditDistance::Pattern pattern(query);
+    std::vector<uint32_t> pending{0};
+    while (!pending.empty()) {
+        const Node& node = nodes[pending.back()];
+        pending.pop_back();
+
+        int distance = pattern.distance(wordAt(node));
+        if (distance <= max_distance) {
+            matches.push_back({wordAt(node), distance});
+        }
+
+        // Only children whose edge lies within max_distance of this distance can match
+        for (uint32_t child = node.first_child; child != NO_NODE; child = nodes[child].next_sibling) {
+            if (std::abs(nodes[child].distance - distance) <= max_distance) {
+                pending.push_back(child);
+            }
+        }
+    }
+    return matches;
+}
+
+size_t BKTree::getMemoryUsage() const {
+    return words.capacity() + nodes.capacity() * sizeof(Node);
+}
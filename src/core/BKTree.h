@@ -0,0 +1,55 @@
+#ifndef BKTREE_H
+#define BKTREE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+// Burkhard-Keller tree over a vocabulary for "every word within k edits"
+// queries. The triangle inequality lets a search skip whole subtrees, so only
+// a small fraction of the vocabulary is ever compared. Nodes live in one array
+// and words are packed into a single buffer, which keeps the tree copyable.
+class BKTree {
+public:
+    struct Match {
+        std::string_view word;
+        int distance;
+    };
+
+private:
+    static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+    struct Node {
+        uint32_t word_offset;
+        uint16_t word_length;
+        uint16_t distance;               // edit distance to the parent word
+        uint32_t first_child = NO_NODE;
+        uint32_t next_sibling = NO_NODE; // children are chained through their siblings
+    };
+
+    std::string words;
+    std::vector<Node> nodes;
+
+    std::string_view wordAt(const Node& node) const {
+        return std::string_view(words).substr(node.word_offset, node.word_length);
+    }
+    uint32_t appendNode(std::string_view word, int distance);
+
+public:
+    BKTree() = default;
+
+    // Replace the contents; sorting first makes the tree shape deterministic
+    void build(std::vector<std::string_view> vocabulary);
+    void insert(std::string_view word);
+    void clear();
+
+    // Every word within max_distance edits of query, in no particular order
+    std::vector<Match> search(std::string_view query, int max_distance) const;
+
+    size_t size() const { return nodes.size(); }
+    bool empty() const { return nodes.empty(); }
+    size_t getMemoryUsage() const;
+};
+
+#endif // BKTREE_H
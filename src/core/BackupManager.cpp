@@ -0,0 +1,739 @@
+#include "BackupManager.h"
+#include "nlohmann/json.hpp"
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <sys/resource.h>
+#elif defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace {
+
+// XXH64: fast, and well enough distributed to name chunks by
+constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+uint64_t rotl(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t read64(const unsigned char* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t read32(const unsigned char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint64_t xxRound(uint64_t accumulator, uint64_t input) {
+    accumulator += input * PRIME2;
+    return rotl(accumulator, 31) * PRIME1;
+}
+
+uint64_t xxMerge(uint64_t hash, uint64_t lane) {
+    hash ^= xxRound(0, lane);
+    return hash * PRIME1 + PRIME4;
+}
+
+uint64_t hash64(const char* data, size_t size) {
+    const auto* p = reinterpret_cast<const unsigned char*>(data);
+    const unsigned char* end = p + size;
+    uint64_t hash;
+    if (size >= 32) {
+        uint64_t v1 = PRIME1 + PRIME2;
+        uint64_t v2 = PRIME2;
+        uint64_t v3 = 0;
+        uint64_t v4 = 0 - PRIME1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = xxRound(v1, read64(p));
+            v2 = xxRound(v2, read64(p + 8));
+            v3 = xxRound(v3, read64(p + 16));
+            v4 = xxRound(v4, read64(p + 24));
+        }
+        hash = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        hash = xxMerge(xxMerge(xxMerge(xxMerge(hash, v1), v2), v3), v4);
+    } else {
+        hash = PRIME5;
+    }
+    hash += size;
+    for (; p + 8 <= end; p += 8) {
+        hash ^= xxRound(0, read64(p));
+        hash = rotl(hash, 27) * PRIME1 + PRIME4;
+    }
+    if (p + 4 <= end) {
+        hash ^= static_cast<uint64_t>(read32(p)) * PRIME1;
+        hash = rotl(hash, 23) * PRIME2 + PRIME3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        hash ^= *p * PRIME5;
+        hash = rotl(hash, 11) * PRIME1;
+    }
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+// Random values for the rolling gear hash, fixed so boundaries are the same from run to run
+constexpr std::array<uint64_t, 256> makeGear() {
+    std::array<uint64_t, 256> gear{};
+    uint64_t state = 0x5646424B55505331ULL; // splitmix64
+    for (uint64_t& value : gear) {
+        state += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = state;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        value = z ^ (z >> 31);
+    }
+    return gear;
+}
+
+constexpr std::array<uint64_t, 256> GEAR = makeGear();
+
+constexpr int bitsOf(size_t value) {
+    int bits = 0;
+    while (value > 1) {
+        value >>= 1;
+        ++bits;
+    }
+    return bits;
+}
+
+// Where the chunk starting at data ends. A boundary falls where the hash of
+// the last bytes has its top bits clear, once every AVERAGE_CHUNK bytes on
+// average; it depends only on nearby content, so an insertion upstream
+// leaves later boundaries where they were.
+size_t chunkLength(const char* data, size_t size) {
+    if (size <= BackupManager::MIN_CHUNK) return size;
+    constexpr int BOUNDARY_BITS = bitsOf(BackupManager::AVERAGE_CHUNK);
+    size_t limit = std::min(size, BackupManager::MAX_CHUNK);
+    uint64_t hash = 0;
+    for (size_t i = BackupManager::MIN_CHUNK; i < limit; ++i) {
+        hash = (hash << 1) + GEAR[static_cast<unsigned char>(data[i])];
+        if ((hash >> (64 - BOUNDARY_BITS)) == 0) return i + 1;
+    }
+    return limit;
+}
+
+std::string hexHash(uint64_t hash) {
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016" PRIx64, hash);
+    return text;
+}
+
+bool parseHash(const std::string& text, uint64_t& hash) {
+    if (text.size() != 16) return false;
+    char* end = nullptr;
+    hash = std::strtoull(text.c_str(), &end, 16);
+    return end == text.c_str() + text.size();
+}
+
+bool readFile(const fs::path& path, std::string& data) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::ostringstream content;
+    content << in.rdbuf();
+    data = content.str();
+    return !in.bad();
+}
+
+// Written beside the target and renamed over it, so no reader sees half a file
+bool writeFileAtomically(const fs::path& path, const char* data, size_t size) {
+    fs::path temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(data, static_cast<std::streamsize>(size));
+        if (!out.flush()) return false;
+    }
+    std::error_code error;
+    fs::rename(temporary, path, error);
+    if (error) {
+        fs::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+int64_t modificationTime(const fs::path& path) {
+    std::error_code error;
+    auto time = fs::last_write_time(path, error);
+    return error ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+bool validName(const std::string& name) {
+    return !name.empty() && name.find_first_of("/\\:") == std::string::npos && name[0] != '.';
+}
+
+std::string timestampName() {
+    std::time_t now = std::time(nullptr);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    char text[32];
+    std::strftime(text, sizeof(text), "backup-%Y%m%d-%H%M%S", &local);
+    return text;
+}
+
+// Backups read and write at the disk's idle priority, behind anything interactive
+void lowerIoPriority() {
+#ifdef _WIN32
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#elif defined(__APPLE__)
+    setiopolicy_np(IOPOL_TYPE_DISK, IOPOL_SCOPE_THREAD, IOPOL_THROTTLE);
+#elif defined(__linux__) && defined(SYS_ioprio_set)
+    constexpr int IOPRIO_WHO_PROCESS = 1; // with id 0, the calling thread
+    constexpr int IOPRIO_CLASS_IDLE = 3;
+    constexpr int IOPRIO_CLASS_SHIFT = 13;
+    syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, IOPRIO_CLASS_IDLE << IOPRIO_CLASS_SHIFT);
+#endif
+}
+
+} // namespace
+
+BackupManager::~BackupManager() {
+    shutdown();
+}
+
+bool BackupManager::initialize(const std::string& backup_dir) {
+    if (is_initialized.load()) return true;
+
+    std::error_code error;
+    fs::create_directories(fs::path(backup_dir) / "objects", error);
+    fs::create_directories(fs::path(backup_dir) / "snapshots", error);
+    if (error) {
+        std::cerr << "Cannot create backup store in " << backup_dir << ": " << error.message() << std::endl;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(backup_mutex);
+        backup_directory = fs::absolute(backup_dir).lexically_normal().string();
+        loadStore();
+    }
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = false;
+    }
+    worker = std::thread(&BackupManager::workerLoop, this);
+    is_initialized.store(true);
+    return true;
+}
+
+void BackupManager::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+        queued.clear();
+    }
+    work_ready.notify_all();
+    if (worker.joinable()) worker.join();
+    is_initialized.store(false);
+}
+
+void BackupManager::addSource(const std::string& directory) {
+    std::string normalized = fs::absolute(directory).lexically_normal().string();
+    std::lock_guard<std::mutex> lock(backup_mutex);
+    if (std::find(sources.begin(), sources.end(), normalized) == sources.end()) {
+        sources.push_back(normalized);
+    }
+}
+
+void BackupManager::setAutomaticInterval(std::chrono::minutes interval) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        automatic_interval = interval;
+        next_automatic = std::chrono::steady_clock::now() + interval;
+    }
+    work_ready.notify_all();
+}
+
+bool BackupManager::createBackup(const std::string& backup_name) {
+    if (!is_initialized.load()) return false;
+    if (!backup_name.empty() && !validName(backup_name)) return false;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        queued.push_back(backup_name);
+    }
+    work_ready.notify_all();
+    return true;
+}
+
+bool BackupManager::createBackupNow(const std::string& backup_name) {
+    if (!is_initialized.load()) return false;
+    std::string name = backup_name.empty() ? timestampName() : backup_name;
+    if (!validName(name)) return false;
+    std::lock_guard<std::mutex> lock(backup_mutex);
+    return writeSnapshot(name);
+}
+
+void BackupManager::workerLoop() {
+    lowerIoPriority();
+    while (true) {
+        std::string name;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            auto ready = [this] {
+                return stopping || !queued.empty() ||
+                       (automatic_interval.count() > 0 && std::chrono::steady_clock::now() >= next_automatic);
+            };
+            if (automatic_interval.count() > 0) {
+                work_ready.wait_until(lock, next_automatic, ready);
+            } else {
+                work_ready.wait(lock, ready);
+            }
+            if (stopping) break;
+            if (!queued.empty()) {
+                name = queued.front();
+                queued.pop_front();
+            } else if (automatic_interval.count() > 0 && std::chrono::steady_clock::now() >= next_automatic) {
+                next_automatic = std::chrono::steady_clock::now() + automatic_interval;
+            } else {
+                continue;
+            }
+        }
+        createBackupNow(name);
+    }
+}
+
+bool BackupManager::writeSnapshot(const std::string& name) {
+    auto began = std::chrono::steady_clock::now();
+    Snapshot snapshot;
+    snapshot.name = name;
+    snapshot.sequence = has_last_snapshot ? last_snapshot.sequence + 1 : 1;
+    snapshot.created = static_cast<int64_t>(std::time(nullptr));
+    snapshot.sources = sources;
+
+    // Files of the last snapshot by source and path, to reuse when unchanged
+    std::map<std::pair<std::string, std::string>, const FileEntry*> previous;
+    if (has_last_snapshot) {
+        for (const FileEntry& file : last_snapshot.files) {
+            if (file.source < last_snapshot.sources.size()) {
+                previous[{last_snapshot.sources[file.source], file.path}] = &file;
+            }
+        }
+    }
+
+    Stats run;
+    bool complete = true;
+    std::string data;
+    for (size_t source = 0; source < sources.size(); ++source) {
+        std::error_code error;
+        if (!fs::is_directory(sources[source], error)) continue;
+        fs::recursive_directory_iterator it(sources[source], fs::directory_options::skip_permission_denied, error);
+        for (; !error && it != fs::recursive_directory_iterator(); it.increment(error)) {
+            const fs::path& path = it->path();
+            if (isInsideStore(path.string())) {
+                if (it->is_directory(error)) it.disable_recursion_pending();
+                continue;
+            }
+            if (!it->is_regular_file(error) || path.extension() == ".tmp") continue;
+
+            FileEntry file;
+            file.source = source;
+            file.path = path.lexically_relative(sources[source]).generic_string();
+            file.size = static_cast<uint64_t>(it->file_size(error));
+            file.mtime = modificationTime(path);
+
+            auto same = previous.find({sources[source], file.path});
+            if (same != previous.end() && same->second->size == file.size && same->second->mtime == file.mtime &&
+                std::all_of(same->second->chunks.begin(), same->second->chunks.end(),
+                            [this](uint64_t chunk) { return chunk_sizes.count(chunk) != 0; })) {
+                file.chunks = same->second->chunks;
+                snapshot.files.push_back(std::move(file));
+                continue;
+            }
+
+            if (!readFile(path, data)) {
+                std::cerr << "Backup " << name << " skipped unreadable " << path.string() << std::endl;
+                complete = false;
+                continue;
+            }
+            ++run.files_read;
+            run.bytes_read += data.size();
+            file.size = data.size();
+            for (size_t offset = 0; offset < data.size();) {
+                size_t length = chunkLength(data.data() + offset, data.size() - offset);
+                uint64_t hash = hash64(data.data() + offset, length);
+                if (!chunk_sizes.count(hash)) {
+                    if (!storeChunk(hash, data.data() + offset, length)) {
+                        std::cerr << "Backup " << name << " failed writing a chunk of " << path.string() << std::endl;
+                        return false;
+                    }
+                    ++run.chunks_written;
+                    run.bytes_written += length;
+                } else if (chunk_sizes[hash] != length) {
+                    std::cerr << "Backup " << name << ": chunk hash collision in " << path.string() << std::endl;
+                    return false;
+                }
+                file.chunks.push_back(hash);
+                offset += length;
+            }
+            snapshot.files.push_back(std::move(file));
+        }
+        if (error) {
+            std::cerr << "Backup " << name << " could not list " << sources[source] << ": " << error.message()
+                      << std::endl;
+            complete = false;
+        }
+    }
+
+    if (!saveManifest(snapshot)) {
+        std::cerr << "Backup " << name << " failed writing its manifest" << std::endl;
+        return false;
+    }
+    last_snapshot = std::move(snapshot);
+    has_last_snapshot = true;
+
+    run.backup_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - began).count();
+    stats.files_read = run.files_read;
+    stats.bytes_read = run.bytes_read;
+    stats.chunks_written = run.chunks_written;
+    stats.bytes_written = run.bytes_written;
+    stats.backup_ms = run.backup_ms;
+    ++stats.snapshots;
+    std::cout << "Backup " << name << ": " << last_snapshot.files.size() << " files, " << run.files_read
+              << " read (" << run.bytes_read << " bytes), " << run.chunks_written << " new chunks ("
+              << run.bytes_written << " bytes) in " << run.backup_ms << "ms" << std::endl;
+    return complete;
+}
+
+bool BackupManager::storeChunk(uint64_t hash, const char* data, size_t size) {
+    fs::path path = objectPath(hash);
+    std::error_code error;
+    fs::create_directories(path.parent_path(), error);
+    if (!writeFileAtomically(path, data, size)) return false;
+    chunk_sizes[hash] = static_cast<uint32_t>(size);
+    stored_bytes += size;
+    return true;
+}
+
+bool BackupManager::readChunk(uint64_t hash, std::string& data) const {
+    auto known = chunk_sizes.find(hash);
+    if (known == chunk_sizes.end()) return false;
+    return readFile(objectPath(hash), data) && data.size() == known->second && hash64(data.data(), data.size()) == hash;
+}
+
+bool BackupManager::restoreBackup(const std::string& backup_name) {
+    if (!is_initialized.load()) return false;
+    std::lock_guard<std::mutex> lock(backup_mutex);
+
+    Snapshot snapshot;
+    if (backup_name.empty()) {
+        std::vector<Snapshot> snapshots = loadSnapshots();
+        if (snapshots.empty()) return false;
+        snapshot = std::move(snapshots.back());
+    } else if (!validName(backup_name) || !loadManifest(backup_name, snapshot)) {
+        std::cerr << "No backup named " << backup_name << std::endl;
+        return false;
+    }
+
+    // Every chunk is checked against its hash before the file it belongs to is replaced
+    size_t restored = 0;
+    size_t failed = 0;
+    std::string content;
+    std::string chunk;
+    for (const FileEntry& file : snapshot.files) {
+        if (file.source >= snapshot.sources.size()) {
+            ++failed;
+            continue;
+        }
+        content.clear();
+        bool intact = true;
+        for (uint64_t hash : file.chunks) {
+            if (!readChunk(hash, chunk)) {
+                intact = false;
+                break;
+            }
+            content += chunk;
+        }
+        fs::path target = fs::path(snapshot.sources[file.source]) / fs::path(file.path);
+        std::error_code error;
+        fs::create_directories(target.parent_path(), error);
+        if (!intact || content.size() != file.size || !writeFileAtomically(target, content.data(), content.size())) {
+            std::cerr << "Backup " << snapshot.name << " could not restore " << target.string() << std::endl;
+            ++failed;
+            continue;
+        }
+        ++restored;
+    }
+    std::cout << "Restored " << restored << " files from backup " << snapshot.name
+              << (failed ? ", " + std::to_string(failed) + " failed" : "") << std::endl;
+    return failed == 0;
+}
+
+std::vector<std::string> BackupManager::getAvailableBackups() {
+    std::lock_guard<std::mutex> lock(backup_mutex);
+    std::vector<std::string> names;
+    for (const Snapshot& snapshot : loadSnapshots()) {
+        names.push_back(snapshot.name);
+    }
+    return names;
+}
+
+bool BackupManager::verifyIntegrity() {
+    if (!is_initialized.load()) return false;
+    std::lock_guard<std::mutex> lock(backup_mutex);
+
+    // Chunks in hash order, so the cursor survives chunks coming and going
+    std::vector<uint64_t> hashes;
+    hashes.reserve(chunk_sizes.size());
+    for (const auto& [hash, size] : chunk_sizes) {
+        if (hash >= verify_cursor) hashes.push_back(hash);
+    }
+    std::sort(hashes.begin(), hashes.end());
+
+    bool intact = true;
+    uint64_t checked = 0;
+    std::string data;
+    size_t next = 0;
+    for (; next < hashes.size() && checked < VERIFY_BYTES; ++next) {
+        uint64_t hash = hashes[next];
+        checked += chunk_sizes[hash];
+        if (readChunk(hash, data)) continue;
+
+        // Set aside rather than deleted, and forgotten, so the next backup writes it again
+        std::cerr << "Backup chunk " << hexHash(hash) << " is damaged or missing" << std::endl;
+        std::error_code error;
+        fs::path quarantine = fs::path(backup_directory) / "damaged";
+        fs::create_directories(quarantine, error);
+        fs::rename(objectPath(hash), quarantine / hexHash(hash), error);
+        stored_bytes -= chunk_sizes[hash];
+        chunk_sizes.erase(hash);
+        ++stats.corrupt_chunks;
+        intact = false;
+    }
+    // A round ends when the cursor passes the last chunk; the next starts over
+    verify_cursor = next < hashes.size() ? hashes[next] : 0;
+
+    if (has_last_snapshot) {
+        for (const FileEntry& file : last_snapshot.files) {
+            for (uint64_t hash : file.chunks) {
+                if (!chunk_sizes.count(hash)) {
+                    std::cerr << "Backup " << last_snapshot.name << " is missing part of " << file.path << std::endl;
+                    intact = false;
+                    break;
+                }
+            }
+        }
+    }
+    return intact;
+}
+
+std::string BackupManager::generateReport() {
+    if (!is_initialized.load()) return "BackupManager: Not initialized\n";
+    Stats current = getStats();
+    std::ostringstream report;
+    report << "BackupManager: " << current.snapshots << " snapshots, " << current.chunks << " chunks ("
+           << current.stored_bytes << " bytes) in " << backup_directory << "\n";
+    report << "Last backup: " << current.files_read << " files read (" << current.bytes_read << " bytes), "
+           << current.chunks_written << " chunks written (" << current.bytes_written << " bytes) in "
+           << current.backup_ms << "ms\n";
+    if (current.corrupt_chunks) {
+        report << "Damaged chunks found: " << current.corrupt_chunks << "\n";
+    }
+    return report.str();
+}
+
+bool BackupManager::selfTest() {
+    if (!is_initialized.load()) return false;
+    // Known XXH64 values, and a round trip through the store's own directory
+    if (hash64("", 0) != 0xEF46DB3751D8E999ULL || hash64("abc", 3) != 0x44BC2CF5AD770999ULL) return false;
+    std::lock_guard<std::mutex> lock(backup_mutex);
+    fs::path probe = fs::path(backup_directory) / "objects" / "selftest";
+    std::string data;
+    bool ok = writeFileAtomically(probe, "VerseFinder", 11) && readFile(probe, data) && data == "VerseFinder";
+    std::error_code error;
+    fs::remove(probe, error);
+    return ok;
+}
+
+bool BackupManager::cleanupOldBackups() {
+    if (!is_initialized.load()) return true;
+    std::lock_guard<std::mutex> lock(backup_mutex);
+    std::vector<Snapshot> snapshots = loadSnapshots();
+    if (snapshots.size() <= KEEP_SNAPSHOTS) return true;
+
+    bool ok = true;
+    size_t excess = snapshots.size() - KEEP_SNAPSHOTS;
+    for (size_t i = 0; i < excess; ++i) {
+        std::error_code error;
+        fs::remove(fs::path(backup_directory) / "snapshots" / (snapshots[i].name + ".json"), error);
+        if (error) ok = false;
+    }
+    stats.snapshots = snapshots.size() - excess;
+    return ok;
+}
+
+void BackupManager::optimizeStorage() {
+    if (!is_initialized.load()) return;
+    std::lock_guard<std::mutex> lock(backup_mutex);
+
+    std::vector<Snapshot> snapshots = loadSnapshots();
+    std::set<uint64_t> referenced;
+    for (const Snapshot& snapshot : snapshots) {
+        for (const FileEntry& file : snapshot.files) {
+            referenced.insert(file.chunks.begin(), file.chunks.end());
+        }
+    }
+
+    size_t removed = 0;
+    uint64_t freed = 0;
+    for (auto it = chunk_sizes.begin(); it != chunk_sizes.end();) {
+        if (referenced.count(it->first)) {
+            ++it;
+            continue;
+        }
+        std::error_code error;
+        fs::remove(objectPath(it->first), error);
+        if (error) {
+            ++it;
+            continue;
+        }
+        freed += it->second;
+        stored_bytes -= it->second;
+        ++removed;
+        it = chunk_sizes.erase(it);
+    }
+    if (removed) {
+        std::cout << "Backup store: removed " << removed << " unused chunks (" << freed << " bytes)" << std::endl;
+    }
+}
+
+BackupManager::Stats BackupManager::getStats() const {
+    std::lock_guard<std::mutex> lock(backup_mutex);
+    Stats current = stats;
+    current.chunks = chunk_sizes.size();
+    current.stored_bytes = stored_bytes;
+    return current;
+}
+
+bool BackupManager::saveManifest(const Snapshot& snapshot) const {
+    json files = json::array();
+    for (const FileEntry& file : snapshot.files) {
+        json chunks = json::array();
+        for (uint64_t hash : file.chunks) {
+            chunks.push_back(hexHash(hash));
+        }
+        files.push_back({{"source", file.source}, {"path", file.path}, {"size", file.size},
+                         {"mtime", file.mtime}, {"chunks", std::move(chunks)}});
+    }
+    json manifest = {{"version", 1}, {"name", snapshot.name}, {"sequence", snapshot.sequence},
+                     {"created", snapshot.created},
+                     {"sources", snapshot.sources}, {"files", std::move(files)}};
+    std::string text = manifest.dump();
+    fs::path path = fs::path(backup_directory) / "snapshots" / (snapshot.name + ".json");
+    return writeFileAtomically(path, text.data(), text.size());
+}
+
+bool BackupManager::loadManifest(const std::string& name, Snapshot& snapshot) const {
+    std::string text;
+    if (!readFile(fs::path(backup_directory) / "snapshots" / (name + ".json"), text)) return false;
+    try {
+        json manifest = json::parse(text);
+        if (manifest.value("version", 0) != 1) return false;
+        snapshot = Snapshot();
+        snapshot.name = manifest.value("name", name);
+        snapshot.sequence = manifest.value("sequence", uint64_t{0});
+        snapshot.created = manifest.value("created", int64_t{0});
+        snapshot.sources = manifest.value("sources", std::vector<std::string>());
+        for (const json& entry : manifest.at("files")) {
+            FileEntry file;
+            file.source = entry.at("source").get<size_t>();
+            file.path = entry.at("path").get<std::string>();
+            file.size = entry.at("size").get<uint64_t>();
+            file.mtime = entry.at("mtime").get<int64_t>();
+            for (const json& chunk : entry.at("chunks")) {
+                uint64_t hash;
+                if (!parseHash(chunk.get<std::string>(), hash)) return false;
+                file.chunks.push_back(hash);
+            }
+            snapshot.files.push_back(std::move(file));
+        }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Backup manifest " << name << " unreadable: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+std::vector<BackupManager::Snapshot> BackupManager::loadSnapshots() const {
+    std::vector<Snapshot> snapshots;
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(fs::path(backup_directory) / "snapshots", error)) {
+        if (entry.path().extension() != ".json") continue;
+        Snapshot snapshot;
+        if (loadManifest(entry.path().stem().string(), snapshot)) {
+            snapshots.push_back(std::move(snapshot));
+        }
+    }
+    std::sort(snapshots.begin(), snapshots.end(), [](const Snapshot& a, const Snapshot& b) {
+        return a.sequence != b.sequence ? a.sequence < b.sequence : a.name < b.name;
+    });
+    return snapshots;
+}
+
+void BackupManager::loadStore() {
+    chunk_sizes.clear();
+    stored_bytes = 0;
+    std::error_code error;
+    for (fs::recursive_directory_iterator it(fs::path(backup_directory) / "objects", error);
+         !error && it != fs::recursive_directory_iterator(); it.increment(error)) {
+        if (!it->is_regular_file(error)) continue;
+        uint64_t hash;
+        if (!parseHash(it->path().filename().string(), hash)) continue; // a .tmp left by a crash, say
+        uint64_t size = it->file_size(error);
+        chunk_sizes[hash] = static_cast<uint32_t>(size);
+        stored_bytes += size;
+    }
+
+    std::vector<Snapshot> snapshots = loadSnapshots();
+    stats.snapshots = snapshots.size();
+    has_last_snapshot = !snapshots.empty();
+    if (has_last_snapshot) {
+        last_snapshot = std::move(snapshots.back());
+    }
+}
+
+std::string BackupManager::objectPath(uint64_t hash) const {
+    std::string hex = hexHash(hash);
+    return (fs::path(backup_directory) / "objects" / hex.substr(0, 2) / hex).string();
+}
+
+bool BackupManager::isInsideStore(const std::string& path) const {
+    std::string normalized = fs::absolute(path).lexically_normal().string();
+    return normalized.compare(0, backup_directory.size(), backup_directory) == 0 &&
+           (normalized.size() == backup_directory.size() ||
+            normalized[backup_directory.size()] == fs::path::preferred_separator);
+}
@@ -5,58 +5,135 @@
 #include <vector>
 #include <mutex>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <thread>
+#include <unordered_map>
 
+// Snapshots of the application's data directories in a content-addressed
+// store. Files are cut into chunks at boundaries chosen by their content,
+// so an edit moves only the chunks it touches, and each chunk is stored
+// once under its hash in objects/; a snapshot is a manifest in snapshots/
+// listing each file's chunks. A chunk shared by any number of files or
+// snapshots is written once, and a file whose size and modification time
+// match the last snapshot is not even read, so backing up data that has
+// barely changed writes a manifest and a few chunks.
+//
+// Backups run on a thread of the manager's own at idle I/O priority, so
+// they never compete with loading a translation. verifyIntegrity() rehashes
+// a slice of the store per call, resuming where the last call stopped;
+// a chunk found damaged is set aside and written afresh by the next backup.
 class BackupManager {
+public:
+    static constexpr size_t MIN_CHUNK = 2 * 1024;
+    static constexpr size_t AVERAGE_CHUNK = 8 * 1024; // a power of two
+    static constexpr size_t MAX_CHUNK = 64 * 1024;
+    static constexpr size_t KEEP_SNAPSHOTS = 48;      // two days of hourly backups
+    static constexpr uint64_t VERIFY_BYTES = 4 * 1024 * 1024; // rehashed per verifyIntegrity()
+
+    struct Stats {
+        size_t snapshots = 0;
+        size_t chunks = 0;
+        uint64_t stored_bytes = 0;
+        // The last backup's I/O
+        size_t files_read = 0;
+        uint64_t bytes_read = 0;
+        size_t chunks_written = 0;
+        uint64_t bytes_written = 0;
+        double backup_ms = 0.0;
+        size_t corrupt_chunks = 0; // found by verifyIntegrity() since startup
+    };
+
 private:
+    struct FileEntry {
+        size_t source = 0;
+        std::string path; // relative to its source, with '/' separators
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        std::vector<uint64_t> chunks;
+    };
+
+    struct Snapshot {
+        std::string name;
+        uint64_t sequence = 0; // orders snapshots, one more than the last
+        int64_t created = 0;   // seconds since the epoch
+        std::vector<std::string> sources;
+        std::vector<FileEntry> files;
+    };
+
     std::string backup_directory;
     std::atomic<bool> is_initialized{false};
-    std::mutex backup_mutex;
+    mutable std::mutex backup_mutex; // the store: objects, snapshots and what follows
+    std::vector<std::string> sources;
+    std::unordered_map<uint64_t, uint32_t> chunk_sizes; // every stored chunk
+    uint64_t stored_bytes = 0;
+    Snapshot last_snapshot;      // its files are reused when unchanged
+    bool has_last_snapshot = false;
+    uint64_t verify_cursor = 0;  // chunks up to this hash were verified this round
+    Stats stats;
 
-public:
-    BackupManager() = default;
-    ~BackupManager() = default;
-
-    bool initialize(const std::string& backup_dir) {
-        backup_directory = backup_dir;
-        is_initialized.store(true);
-        return true;
-    }
+    // Backups queued for the worker
+    std::mutex queue_mutex;
+    std::condition_variable work_ready;
+    std::deque<std::string> queued;
+    std::chrono::minutes automatic_interval{0};
+    std::chrono::steady_clock::time_point next_automatic;
+    bool stopping = false;
+    std::thread worker;
 
-    void shutdown() {
-        is_initialized.store(false);
-    }
+    void workerLoop();
+    // Under backup_mutex
+    bool writeSnapshot(const std::string& name);
+    bool storeChunk(uint64_t hash, const char* data, size_t size);
+    bool readChunk(uint64_t hash, std::string& data) const;
+    bool saveManifest(const Snapshot& snapshot) const;
+    bool loadManifest(const std::string& name, Snapshot& snapshot) const;
+    std::vector<Snapshot> loadSnapshots() const;
+    void loadStore();
+    std::string objectPath(uint64_t hash) const;
+    bool isInsideStore(const std::string& path) const;
 
-    bool createBackup([[maybe_unused]] const std::string& backup_name = "") {
-        return is_initialized.load();
-    }
+public:
+    BackupManager() = default;
+    ~BackupManager();
 
-    bool restoreBackup([[maybe_unused]] const std::string& backup_name) {
-        return is_initialized.load();
-    }
+    BackupManager(const BackupManager&) = delete;
+    BackupManager& operator=(const BackupManager&) = delete;
 
-    std::vector<std::string> getAvailableBackups() {
-        return {};
-    }
+    bool initialize(const std::string& backup_dir);
+    void shutdown();
 
-    bool verifyIntegrity() {
-        return is_initialized.load();
-    }
+    // A directory to include in every backup, with everything under it
+    void addSource(const std::string& directory);
+    // Queues a backup every interval from now on; zero stops them
+    void setAutomaticInterval(std::chrono::minutes interval);
 
-    std::string generateReport() {
-        return "BackupManager: " + std::string(is_initialized.load() ? "Initialized" : "Not initialized");
-    }
+    // Queued for the backup thread; name defaults to the time
+    bool createBackup(const std::string& backup_name = "");
+    // The same, on the calling thread, returning once it is written
+    bool createBackupNow(const std::string& backup_name = "");
+    // Writes each file of the snapshot back where it came from, each
+    // replaced whole or not at all; files added since are left alone.
+    // An empty name restores the newest snapshot.
+    bool restoreBackup(const std::string& backup_name);
+    // Oldest first
+    std::vector<std::string> getAvailableBackups();
 
-    bool selfTest() {
-        return is_initialized.load();
-    }
+    // Rehashes the next VERIFY_BYTES of chunks and checks the newest
+    // snapshot names only stored chunks; false if either found damage
+    bool verifyIntegrity();
 
-    bool cleanupOldBackups() {
-        return true;
-    }
+    std::string generateReport();
+    bool selfTest();
+    // Drops snapshots past KEEP_SNAPSHOTS, oldest first
+    bool cleanupOldBackups();
+    // Deletes chunks no snapshot refers to
+    void optimizeStorage();
 
-    void optimizeStorage() {
-        // Placeholder
-    }
+    Stats getStats() const;
 };
 
-#endif // BACKUP_MANAGER_H
\ No newline at end of file
+#endif // BACKUP_MANAGER_H
@@ -0,0 +1,170 @@
+#include "Bm25Ranker.h"
+#include "TopK.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// One query term's position in its postings during topK()
+struct Cursor {
+    const Bm25Ranker::QueryTerm* term;
+    float idf;
+    float max_score; // bound over all of its blocks
+
+    size_t position = 0;
+
+    const PostingList& ids() const { return term->postings->ids; }
+    bool done() const { return position >= ids().size(); }
+    VerseId id() const { return ids()[position]; }
+    size_t block() const { return position / TermPostings::BLOCK_SIZE; }
+    // Last id the current block covers
+    VerseId blockLast() const {
+        return ids()[std::min(ids().size(), (block() + 1) * TermPostings::BLOCK_SIZE) - 1];
+    }
+    void seek(VerseId target) {
+        position = std::lower_bound(ids().begin() + position, ids().end(), target) - ids().begin();
+    }
+};
+
+} // namespace
+
+Bm25Ranker::Bm25Ranker(const InvertedIndex& index)
+    : index(index),
+      inverse_average_length(index.averageVerseLength() > 0.0 ? static_cast<float>(1.0 / index.averageVerseLength())
+                                                              : 1.0f) {}
+
+float Bm25Ranker::idf(size_t document_frequency) const {
+    // The +1 keeps very common words slightly positive instead of negative
+    float verses = static_cast<float>(index.verseCount());
+    float frequency = static_cast<float>(document_frequency);
+    return std::log(1.0f + (verses - frequency + 0.5f) / (frequency + 0.5f));
+}
+
+float Bm25Ranker::termScore(float term_idf, uint32_t frequency, uint32_t verse_length) const {
+    float tf = static_cast<float>(frequency);
+    float norm = K1 * (1.0f - B + B * static_cast<float>(verse_length) * inverse_average_length);
+    return term_idf * tf * (K1 + 1.0f) / (tf + norm);
+}
+
+float Bm25Ranker::postingScore(const QueryTerm& term, float term_idf, size_t i) const {
+    const TermPostings& postings = *term.postings;
+    return term.weight * termScore(term_idf, postings.frequency(i), index.verseLength(postings.ids[i]));
+}
+
+float Bm25Ranker::blockBound(const QueryTerm& term, float term_idf, size_t block) const {
+    // Scores rise with frequency and fall with length, so the block's extremes bound them all
+    const PostingBlock& bounds = term.postings->blocks[block];
+    return term.weight * termScore(term_idf, bounds.max_frequency, bounds.min_length);
+}
+
+std::vector<float> Bm25Ranker::score(const std::vector<QueryTerm>& terms, const PostingList& candidates) const {
+    TRACE_SCOPE("bm25_score");
+    // Sums are kept in double so that topK(), adding the same terms in another
+    // order, arrives at the same float score
+    std::vector<double> sums(candidates.size(), 0.0);
+    for (const QueryTerm& term : terms) {
+        if (!term.postings) continue;
+        const PostingList& ids = term.postings->ids;
+        float term_idf = idf(ids.size());
+        auto cursor = ids.begin();
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            cursor = std::lower_bound(cursor, ids.end(), candidates[i]);
+            if (cursor == ids.end()) break;
+            if (*cursor == candidates[i]) {
+                sums[i] += postingScore(term, term_idf, cursor - ids.begin());
+            }
+        }
+    }
+    return std::vector<float>(sums.begin(), sums.end());
+}
+
+std::vector<Bm25Ranker::ScoredVerse> Bm25Ranker::topK(const std::vector<QueryTerm>& terms, size_t k,
+                                                      const SearchContext& context) const {
+    if (k == 0) return {};
+
+    std::vector<Cursor> cursors;
+    cursors.reserve(terms.size());
+    for (const QueryTerm& term : terms) {
+        if (!term.postings || term.postings->ids.empty() || term.weight <= 0.0f) continue;
+        Cursor cursor{&term, idf(term.postings->ids.size()), 0.0f};
+        for (size_t block = 0; block < term.postings->blocks.size(); ++block) {
+            cursor.max_score = std::max(cursor.max_score, blockBound(term, cursor.idf, block));
+        }
+        cursors.push_back(cursor);
+    }
+
+    // Weakest terms first. Once the k-th best score reaches the bounds of a
+    // prefix of them, a verse holding only those terms cannot qualify: the
+    // prefix stops driving the walk and is only probed for verses found by
+    // the others (MaxScore).
+    std::sort(cursors.begin(), cursors.end(), [](const Cursor& a, const Cursor& b) { return a.max_score < b.max_score; });
+    std::vector<double> bound_sums(cursors.size()); // bounds of cursors[0 .. i]
+    double running_sum = 0.0;
+    for (size_t i = 0; i < cursors.size(); ++i) {
+        running_sum += cursors[i].max_score;
+        bound_sums[i] = running_sum;
+    }
+
+    auto ranksHigher = [](const ScoredVerse& a, const ScoredVerse& b) {
+        if (a.second != b.second) return a.second > b.second;
+        return a.first < b.first;
+    };
+    TopK<ScoredVerse, decltype(ranksHigher)> best(k, ranksHigher);
+    size_t essential = 0; // cursors[essential ..] drive the walk
+    size_t visited = 0;
+
+    while (essential < cursors.size()) {
+        constexpr VerseId NONE = std::numeric_limits<VerseId>::max();
+        VerseId id = NONE;
+        for (size_t i = essential; i < cursors.size(); ++i) {
+            if (!cursors[i].done()) id = std::min(id, cursors[i].id());
+        }
+        if (id == NONE || context.shouldStopAt(visited++)) break;
+
+        double non_essential = essential > 0 ? bound_sums[essential - 1] : 0.0;
+        if (best.full()) {
+            // Bound every verse up to the nearest block end by the blocks' maxima;
+            // ties lose to the earlier ids already kept, so equal is not enough
+            double bound = non_essential;
+            VerseId block_last = NONE;
+            for (size_t i = essential; i < cursors.size(); ++i) {
+                if (cursors[i].done()) continue;
+                bound += blockBound(*cursors[i].term, cursors[i].idf, cursors[i].block());
+                block_last = std::min(block_last, cursors[i].blockLast());
+            }
+            if (bound <= best.worst().second) {
+                if (block_last == NONE) break;
+                for (size_t i = essential; i < cursors.size(); ++i) {
+                    if (!cursors[i].done()) cursors[i].seek(block_last + 1);
+                }
+                continue;
+            }
+        }
+
+        double score = 0.0;
+        for (size_t i = essential; i < cursors.size(); ++i) {
+            Cursor& cursor = cursors[i];
+            if (cursor.done() || cursor.id() != id) continue;
+            score += postingScore(*cursor.term, cursor.idf, cursor.position);
+            ++cursor.position;
+        }
+        // Strongest non-essential terms first, stopping once even all of them could not help
+        for (size_t i = essential; i-- > 0;) {
+            if (best.full() && score + bound_sums[i] <= best.worst().second) break;
+            Cursor& cursor = cursors[i];
+            cursor.seek(id);
+            if (!cursor.done() && cursor.id() == id) {
+                score += postingScore(*cursor.term, cursor.idf, cursor.position);
+            }
+        }
+
+        best.push({id, static_cast<float>(score)});
+        if (best.full()) {
+            while (essential < cursors.size() && bound_sums[essential] <= best.worst().second) ++essential;
+        }
+    }
+
+    return best.take();
+}
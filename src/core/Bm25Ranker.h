@@ -0,0 +1,47 @@
+#ifndef BM25RANKER_H
+#define BM25RANKER_H
+
+#include <utility>
+#include <vector>
+#include "InvertedIndex.h"
+#include "SearchContext.h"
+
+// BM25 relevance over one translation's index. Document frequencies and verse
+// lengths are the index's own statistics, gathered once by finalize(), so a
+// ranker is cheap to construct per search. topK() walks the query terms'
+// postings in id order and uses each posting block's score bound to skip
+// verses that cannot reach the current k-th best score.
+class Bm25Ranker {
+public:
+    static constexpr float K1 = 1.2f; // term frequency saturation
+    static constexpr float B = 0.75f; // verse length normalization
+
+    struct QueryTerm {
+        const TermPostings* postings;
+        float weight = 1.0f; // query-side boost, e.g. for words the user typed
+    };
+    using ScoredVerse = std::pair<VerseId, float>;
+
+private:
+    const InvertedIndex& index;
+    float inverse_average_length;
+
+public:
+    explicit Bm25Ranker(const InvertedIndex& index);
+
+    float idf(size_t document_frequency) const;
+    // One term's contribution to a verse of verse_length tokens holding it frequency times
+    float termScore(float term_idf, uint32_t frequency, uint32_t verse_length) const;
+    // Score of the i-th posting of term
+    float postingScore(const QueryTerm& term, float term_idf, size_t i) const;
+    // Highest score any posting in block of term can have
+    float blockBound(const QueryTerm& term, float term_idf, size_t block) const;
+
+    // Summed scores of sorted candidates, parallel to them
+    std::vector<float> score(const std::vector<QueryTerm>& terms, const PostingList& candidates) const;
+    // The k best verses holding any term, best first, ties by id
+    std::vector<ScoredVerse> topK(const std::vector<QueryTerm>& terms, size_t k,
+                                  const SearchContext& context = SearchContext()) const;
+};
+
+#endif // BM25RANKER_H
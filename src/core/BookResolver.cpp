@@ -0,0 +1,335 @@
+#include "BookResolver.h"
+#include <array>
+#include <cstdint>
+#include <mutex>
+
+namespace {
+constexpr std::array<std::string_view, BookResolver::BOOK_COUNT> CANONICAL_NAMES = {
+    "Genesis", "Exodus", "Leviticus", "Numbers", "Deuteronomy", "Joshua", "Judges", "Ruth",
+    "1 Samuel", "2 Samuel", "1 Kings", "2 Kings", "1 Chronicles", "2 Chronicles", "Ezra", "Nehemiah",
+    "Esther", "Job", "Psalms", "Proverbs", "Ecclesiastes", "Song of Songs", "Isaiah", "Jeremiah",
+    "Lamentations", "Ezekiel", "Daniel", "Hosea", "Joel", "Amos", "Obadiah", "Jonah",
+    "Micah", "Nahum", "Habakkuk", "Zephaniah", "Haggai", "Zechariah", "Malachi", "Matthew",
+    "Mark", "Luke", "John", "Acts", "Romans", "1 Corinthians", "2 Corinthians", "Galatians",
+    "Ephesians", "Philippians", "Colossians", "1 Thessalonians", "2 Thessalonians", "1 Timothy", "2 Timothy", "Titus",
+    "Philemon", "Hebrews", "James", "1 Peter", "2 Peter", "1 John", "2 John", "3 John",
+    "Jude", "Revelation",
+};
+
+// Every name the table answers to, canonical one first, in book order.
+// Ambiguous short forms ("Ph", "Jud", "Co") are left out on purpose.
+constexpr std::array<std::string_view, BookResolver::BOOK_COUNT> BOOK_ALIASES = {
+    "Genesis|Gen|Ge|Gn",
+    "Exodus|Exod|Exo|Ex",
+    "Leviticus|Lev|Le|Lv",
+    "Numbers|Num|Nu|Nm|Nb",
+    "Deuteronomy|Deut|Deu|Dt",
+    "Joshua|Josh|Jos|Jsh",
+    "Judges|Judg|Jdg|Jg|Jdgs",
+    "Ruth|Rth|Ru",
+    "1 Samuel|1 Sam|1 Sa|1 Sm",
+    "2 Samuel|2 Sam|2 Sa|2 Sm",
+    "1 Kings|1 Kgs|1 Ki|1 Kin",
+    "2 Kings|2 Kgs|2 Ki|2 Kin",
+    "1 Chronicles|1 Chron|1 Chr|1 Ch",
+    "2 Chronicles|2 Chron|2 Chr|2 Ch",
+    "Ezra|Ezr",
+    "Nehemiah|Neh|Ne",
+    "Esther|Esth|Est|Es",
+    "Job|Jb",
+    "Psalms|Psalm|Ps|Psa|Pss|Psm",
+    "Proverbs|Prov|Pro|Prv|Pr",
+    "Ecclesiastes|Eccles|Eccl|Ecc|Ec|Qoh|Qoheleth",
+    "Song of Songs|Song of Solomon|Song|SoS|Sg|Canticles|Canticle of Canticles|Cant",
+    "Isaiah|Isa|Is",
+    "Jeremiah|Jer|Je|Jr",
+    "Lamentations|Lam|La",
+    "Ezekiel|Ezek|Eze|Ezk",
+    "Daniel|Dan|Da|Dn",
+    "Hosea|Hos|Ho",
+    "Joel|Jl",
+    "Amos|Am",
+    "Obadiah|Obad|Oba|Ob",
+    "Jonah|Jon|Jnh",
+    "Micah|Mic|Mc",
+    "Nahum|Nah|Na",
+    "Habakkuk|Hab|Hb",
+    "Zephaniah|Zeph|Zep|Zp",
+    "Haggai|Hag|Hg",
+    "Zechariah|Zech|Zec|Zc",
+    "Malachi|Mal|Ml",
+    "Matthew|Matt|Mat|Mt",
+    "Mark|Mrk|Mar|Mk|Mr",
+    "Luke|Luk|Lk",
+    "John|Joh|Jhn|Jn|St John|Saint John",
+    "Acts|Act|Ac|Acts of the Apostles",
+    "Romans|Rom|Ro|Rm",
+    "1 Corinthians|1 Cor|1 Co",
+    "2 Corinthians|2 Cor|2 Co",
+    "Galatians|Gal|Ga",
+    "Ephesians|Eph|Ephes",
+    "Philippians|Phil|Php|Pp",
+    "Colossians|Col",
+    "1 Thessalonians|1 Thess|1 Thes|1 Th",
+    "2 Thessalonians|2 Thess|2 Thes|2 Th",
+    "1 Timothy|1 Tim|1 Ti",
+    "2 Timothy|2 Tim|2 Ti",
+    "Titus|Tit",
+    "Philemon|Philem|Phlm|Phm",
+    "Hebrews|Heb",
+    "James|Jas|Jm",
+    "1 Peter|1 Pet|1 Pe|1 Pt",
+    "2 Peter|2 Pet|2 Pe|2 Pt",
+    "1 John|1 Jn|1 Jhn|1 Jo|1 Joh",
+    "2 John|2 Jn|2 Jhn|2 Jo|2 Joh",
+    "3 John|3 Jn|3 Jhn|3 Jo|3 Joh",
+    "Jude|Jud|Jd",
+    "Revelation|Revelations|Rev|Re|Apocalypse|Revelation of John",
+};
+
+constexpr char toLower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+constexpr bool isSeparator(char c) {
+    return c == ' ' || c == '.';
+}
+
+// Lowercase ASCII with separators dropped; a leading ordinal word becomes
+// its digit ("II Kings", "Second Kings", "2nd Kings" -> "2kings")
+template <typename Out>
+constexpr void foldName(std::string_view name, Out&& out) {
+    size_t start = 0;
+    while (start < name.size() && isSeparator(name[start])) start++;
+    size_t token_end = start;
+    while (token_end < name.size() && !isSeparator(name[token_end])) token_end++;
+    size_t rest = token_end;
+    while (rest < name.size() && isSeparator(name[rest])) rest++;
+
+    if (token_end > start && rest < name.size()) {
+        constexpr std::array<std::string_view, 9> ORDINALS = {
+            "i", "1st", "first", "ii", "2nd", "second", "iii", "3rd", "third",
+        };
+        for (size_t i = 0; i < ORDINALS.size(); i++) {
+            std::string_view ordinal = ORDINALS[i];
+            if (ordinal.size() != token_end - start) continue;
+            bool same = true;
+            for (size_t j = 0; j < ordinal.size() && same; j++) {
+                same = toLower(name[start + j]) == ordinal[j];
+            }
+            if (same) {
+                out(static_cast<char>('1' + i / 3));
+                start = rest;
+                break;
+            }
+        }
+    }
+
+    for (size_t i = start; i < name.size(); i++) {
+        if (!isSeparator(name[i])) out(toLower(name[i]));
+    }
+}
+
+constexpr size_t MAX_KEY = 23;
+constexpr size_t BUCKETS = 128;
+constexpr size_t SLOTS = 1024; // a power of two, about 2.5x the keys
+
+struct Key {
+    std::array<char, MAX_KEY> text{};
+    uint8_t size = 0;
+    uint8_t book = 0;
+
+    constexpr std::string_view view() const { return {text.data(), size}; }
+};
+
+// Fold into a Key; false if it is too long to be any of the table's names
+constexpr bool foldKey(std::string_view name, Key& key) {
+    bool fits = true;
+    foldName(name, [&](char c) {
+        if (key.size < MAX_KEY) {
+            key.text[key.size++] = c;
+        } else {
+            fits = false;
+        }
+    });
+    return fits;
+}
+
+constexpr uint32_t hashKey(std::string_view key, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+    for (char c : key) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+    }
+    // FNV's low bits are weak; finish with murmur3's mixer
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+constexpr size_t KEY_COUNT = [] {
+    size_t count = 0;
+    for (std::string_view names : BOOK_ALIASES) {
+        count++;
+        for (char c : names) count += c == '|';
+    }
+    return count;
+}();
+
+// Hash and displace: keys are split into buckets by one hash, then each
+// bucket, largest first, gets the first seed that sends all its keys to
+// free slots. A lookup is one bucket read and one slot read, no probing.
+struct PerfectTable {
+    std::array<Key, KEY_COUNT> keys{};
+    std::array<uint16_t, BUCKETS> seeds{};
+    std::array<uint16_t, SLOTS> slots{}; // key index + 1, 0 if empty
+};
+
+constexpr PerfectTable TABLE = [] {
+    PerfectTable table;
+    size_t count = 0;
+    for (size_t book = 0; book < BOOK_ALIASES.size(); book++) {
+        std::string_view names = BOOK_ALIASES[book];
+        while (true) {
+            size_t bar = names.find('|');
+            Key key;
+            key.book = static_cast<uint8_t>(book + 1);
+            if (!foldKey(names.substr(0, bar), key)) throw "book alias longer than MAX_KEY";
+            for (size_t i = 0; i < count; i++) {
+                if (table.keys[i].view() == key.view()) throw "two books share an alias";
+            }
+            table.keys[count++] = key;
+            if (bar == std::string_view::npos) break;
+            names.remove_prefix(bar + 1);
+        }
+    }
+
+    std::array<size_t, BUCKETS> sizes{};
+    for (const Key& key : table.keys) sizes[hashKey(key.view(), 0) % BUCKETS]++;
+    std::array<size_t, BUCKETS> order{};
+    for (size_t i = 0; i < BUCKETS; i++) order[i] = i;
+    for (size_t i = 1; i < BUCKETS; i++) {
+        for (size_t j = i; j > 0 && sizes[order[j]] > sizes[order[j - 1]]; j--) {
+            std::swap(order[j], order[j - 1]);
+        }
+    }
+
+    for (size_t bucket : order) {
+        if (sizes[bucket] == 0) break;
+        std::array<size_t, 16> members{};
+        size_t member_count = 0;
+        for (size_t i = 0; i < KEY_COUNT; i++) {
+            if (hashKey(table.keys[i].view(), 0) % BUCKETS != bucket) continue;
+            if (member_count == members.size()) throw "bucket too large; raise BUCKETS";
+            members[member_count++] = i;
+        }
+
+        bool placed = false;
+        for (uint32_t seed = 1; seed < 65536 && !placed; seed++) {
+            std::array<size_t, 16> targets{};
+            placed = true;
+            for (size_t m = 0; m < member_count && placed; m++) {
+                targets[m] = hashKey(table.keys[members[m]].view(), seed) % SLOTS;
+                placed = table.slots[targets[m]] == 0;
+                for (size_t n = 0; n < m && placed; n++) placed = targets[n] != targets[m];
+            }
+            if (placed) {
+                table.seeds[bucket] = static_cast<uint16_t>(seed);
+                for (size_t m = 0; m < member_count; m++) {
+                    table.slots[targets[m]] = static_cast<uint16_t>(members[m] + 1);
+                }
+            }
+        }
+        if (!placed) throw "no seed places this bucket; raise SLOTS";
+    }
+    return table;
+}();
+
+std::string foldString(std::string_view name) {
+    std::string folded;
+    folded.reserve(name.size());
+    foldName(name, [&folded](char c) { folded.push_back(c); });
+    return folded;
+}
+}
+
+BookResolver::BookResolver() {
+    indexSoundsLocked();
+}
+
+int BookResolver::canonicalBook(std::string_view name) {
+    Key key;
+    if (!foldKey(name, key) || key.size == 0) return 0;
+    uint16_t seed = TABLE.seeds[hashKey(key.view(), 0) % BUCKETS];
+    uint16_t slot = TABLE.slots[hashKey(key.view(), seed) % SLOTS];
+    if (slot == 0) return 0;
+    const Key& candidate = TABLE.keys[slot - 1];
+    return candidate.view() == key.view() ? candidate.book : 0;
+}
+
+std::string_view BookResolver::canonicalName(int book) {
+    return book >= 1 && book <= BOOK_COUNT ? CANONICAL_NAMES[book - 1] : std::string_view();
+}
+
+std::string BookResolver::resolve(std::string_view name) const {
+    if (int book = canonicalBook(name)) {
+        return std::string(canonicalName(book));
+    }
+
+    std::string key = foldString(name);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto alias = aliases.find(key);
+    if (alias != aliases.end()) {
+        if (int book = canonicalBook(alias->second)) {
+            return std::string(canonicalName(book));
+        }
+        key = foldString(alias->second);
+        auto target = book_names.find(key);
+        return target != book_names.end() ? target->second : alias->second;
+    }
+    auto stored = book_names.find(key);
+    return stored != book_names.end() ? stored->second : std::string(name);
+}
+
+void BookResolver::addBookNames(const std::vector<std::string>& books) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    for (const auto& book : books) {
+        if (canonicalBook(book) == 0) {
+            book_names.emplace(foldString(book), book); // the first translation's casing wins
+            book_sounds.add(book);
+        }
+    }
+}
+
+void BookResolver::setAliases(const std::unordered_map<std::string, std::string>& new_aliases) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    aliases.clear();
+    alias_names.clear();
+    for (const auto& [alias, target] : new_aliases) {
+        if (alias.empty() || target.empty() || canonicalBook(alias) != 0) continue;
+        aliases[foldString(alias)] = target;
+        alias_names.push_back(alias);
+    }
+    indexSoundsLocked();
+}
+
+std::vector<std::string> BookResolver::aliasNames() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return alias_names;
+}
+
+std::vector<std::string> BookResolver::soundsLike(std::string_view name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::vector<std::string_view> matches = book_sounds.find(name);
+    return std::vector<std::string>(matches.begin(), matches.end());
+}
+
+void BookResolver::indexSoundsLocked() {
+    // Names cannot be taken out of a PhoneticIndex, so replaced aliases mean a rebuild
+    book_sounds.clear();
+    for (std::string_view name : CANONICAL_NAMES) book_sounds.add(name);
+    for (const auto& entry : book_names) book_sounds.add(entry.second);
+    for (const auto& alias : alias_names) book_sounds.add(alias);
+}
@@ -0,0 +1,57 @@
+#ifndef BOOK_RESOLVER_H
+#define BOOK_RESOLVER_H
+
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "PhoneticIndex.h"
+
+// Maps what people type for a book ("jn", "1 Cor.", "Song of Solomon",
+// "II Kings") to the name translations are keyed by. The 66 canonical books
+// and their usual abbreviations live in a perfect hash table built at
+// compile time, so resolving one costs a fold and a single probe. Names it
+// does not know, such as a translation's own book names in another
+// language or user-defined aliases, go in a small runtime table consulted
+// only on a miss.
+//
+// Matching ignores ASCII case, spaces and periods, and a leading "I", "II",
+// "III", "First", "2nd" and so on stands for the number.
+class BookResolver {
+public:
+    static constexpr int BOOK_COUNT = 66;
+
+    BookResolver();
+
+    // Canonical book number, 1 (Genesis) to 66 (Revelation), or 0 if unknown
+    static int canonicalBook(std::string_view name);
+    // "" if book is out of range
+    static std::string_view canonicalName(int book);
+
+    // Thread-safe. The name to look book up by: the canonical name for the
+    // 66, else a runtime entry, else name itself
+    std::string resolve(std::string_view name) const;
+
+    // A translation's book names, so they match case-insensitively too
+    void addBookNames(const std::vector<std::string>& books);
+    // Replaces the user's aliases; they cannot redefine a built-in name
+    void setAliases(const std::unordered_map<std::string, std::string>& aliases);
+
+    // Every runtime alias, for suggestions
+    std::vector<std::string> aliasNames() const;
+    // Thread-safe. Book names (canonical, a translation's, aliases) that
+    // sound like name, e.g. "Habbakuk" for "Habakkuk"
+    std::vector<std::string> soundsLike(std::string_view name) const;
+
+private:
+    mutable std::shared_mutex mutex;
+    std::unordered_map<std::string, std::string> book_names; // folded -> as stored
+    std::unordered_map<std::string, std::string> aliases;    // folded -> target
+    std::vector<std::string> alias_names;                    // as the user wrote them
+    PhoneticIndex book_sounds;                               // every name above, by sound
+
+    void indexSoundsLocked();
+};
+
+#endif // BOOK_RESOLVER_H
@@ -0,0 +1,117 @@
+#include "BooleanPlanner.h"
+#include "SearchOptimizer.h"
+#include <algorithm>
+
+namespace {
+
+// Size ratio above which binary-searching the larger list beats a linear merge
+constexpr size_t SKIP_RATIO = 8;
+
+} // namespace
+
+BooleanPlanner::IdSet BooleanPlanner::unite(std::vector<PostingList>& lists, size_t verse_count) {
+    IdSet set;
+    size_t total = 0;
+    for (const PostingList& list : lists) total += list.size();
+
+    if (lists.size() == 1) {
+        set.ids = std::move(lists.front());
+    } else if (total * DENSE_DIVISOR > verse_count) {
+        // Setting bits needs no sort and no deduplication
+        auto bits = std::make_shared<VerseSet>(verse_count);
+        for (const PostingList& list : lists) {
+            for (VerseId id : list) bits->insert(id);
+        }
+        set.count = bits->size();
+        set.bits = std::move(bits);
+        return set;
+    } else {
+        set.ids.reserve(total);
+        for (const PostingList& list : lists) set.ids.insert(set.ids.end(), list.begin(), list.end());
+        std::sort(set.ids.begin(), set.ids.end());
+        set.ids.erase(std::unique(set.ids.begin(), set.ids.end()), set.ids.end());
+    }
+    set.count = set.ids.size();
+    return set;
+}
+
+PostingList BooleanPlanner::filter(const PostingList& candidates, const IdSet& set, bool keep_members) {
+    PostingList result;
+    if (set.bits) {
+        if (keep_members) return set.bits->filter(candidates);
+        result.reserve(candidates.size());
+        for (VerseId id : candidates) {
+            if (!set.bits->contains(id)) result.push_back(id);
+        }
+        return result;
+    }
+    if (keep_members) return SearchOptimizer::intersectTwoPostings(candidates, set.ids);
+
+    // Difference: skip through the excluded list when it dwarfs the candidates
+    result.reserve(candidates.size());
+    const bool skip = candidates.size() * SKIP_RATIO < set.ids.size();
+    auto excluded = set.ids.begin();
+    for (VerseId id : candidates) {
+        if (skip) {
+            excluded = std::lower_bound(excluded, set.ids.end(), id);
+        } else {
+            while (excluded != set.ids.end() && *excluded < id) ++excluded;
+        }
+        if (excluded == set.ids.end() || *excluded != id) result.push_back(id);
+    }
+    return result;
+}
+
+PostingList BooleanPlanner::execute(Query query, size_t verse_count) {
+    std::vector<IdSet> required;
+    required.reserve(query.required.size() + query.within.size() + 1);
+    for (PostingList& list : query.required) {
+        if (list.empty()) return {};
+        IdSet set;
+        set.count = list.size();
+        set.ids = std::move(list);
+        required.push_back(std::move(set));
+    }
+    for (std::shared_ptr<const VerseSet>& scope : query.within) {
+        if (!scope) continue;
+        if (scope->empty()) return {};
+        IdSet set;
+        set.count = scope->size();
+        set.bits = std::move(scope);
+        required.push_back(std::move(set));
+    }
+    if (!query.alternatives.empty()) {
+        IdSet any = unite(query.alternatives, verse_count);
+        if (any.count == 0) return {};
+        required.push_back(std::move(any));
+    }
+
+    // Lists rarest first, since the driver bounds every later step; bitsets last,
+    // as they cost one bit test per remaining candidate
+    std::sort(required.begin(), required.end(), [](const IdSet& a, const IdSet& b) {
+        if (!a.bits != !b.bits) return !a.bits;
+        return a.count < b.count;
+    });
+
+    PostingList candidates;
+    size_t next = 0;
+    if (required.empty()) {
+        candidates.resize(verse_count);
+        for (size_t id = 0; id < verse_count; ++id) candidates[id] = static_cast<VerseId>(id);
+    } else if (!required.front().bits) {
+        candidates = std::move(required.front().ids);
+        next = 1;
+    } else {
+        // Only bitsets: enumerate the first one
+        candidates = required.front().bits->ids();
+        next = 1;
+    }
+    for (size_t i = next; i < required.size() && !candidates.empty(); ++i) {
+        candidates = filter(candidates, required[i], true);
+    }
+
+    if (!query.excluded.empty() && !candidates.empty()) {
+        candidates = filter(candidates, unite(query.excluded, verse_count), false);
+    }
+    return candidates;
+}
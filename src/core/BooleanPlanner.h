@@ -0,0 +1,47 @@
+#ifndef BOOLEANPLANNER_H
+#define BOOLEANPLANNER_H
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include "InvertedIndex.h"
+#include "VerseSet.h"
+
+// Evaluates a boolean query as set operations over sorted verse-id lists
+// instead of scanning verse text. The alternatives are merged into one more
+// required set, the required sets are intersected rarest first (so every
+// intermediate result is as small as possible), and the excluded verses are
+// subtracted last. A union covering a large share of the verses is gathered
+// in a bitset rather than sorted, and candidates are then checked against it
+// with one bit test each. Scopes such as favorites or a collection arrive as
+// such bitsets already and join the required sets.
+class BooleanPlanner {
+public:
+    // Unions holding more than one verse in DENSE_DIVISOR are kept as bitsets
+    static constexpr size_t DENSE_DIVISOR = 32;
+
+    struct Query {
+        std::vector<PostingList> required;     // every one must contain the verse
+        std::vector<PostingList> alternatives; // if any are given, at least one must
+        std::vector<PostingList> excluded;     // none may
+        std::vector<std::shared_ptr<const VerseSet>> within; // every one must contain it too
+    };
+
+    // Sorted ids in [0, verse_count) satisfying the query. With neither required
+    // nor alternative lists every verse not excluded matches.
+    static PostingList execute(Query query, size_t verse_count);
+
+private:
+    // A set of verse ids, as a sorted list or, when dense, a bitset
+    struct IdSet {
+        PostingList ids;
+        std::shared_ptr<const VerseSet> bits; // used instead of ids when set
+        size_t count = 0;
+    };
+
+    static IdSet unite(std::vector<PostingList>& lists, size_t verse_count);
+    // Keep the candidates that are (or, with keep_members false, are not) in set
+    static PostingList filter(const PostingList& candidates, const IdSet& set, bool keep_members);
+};
+
+#endif // BOOLEANPLANNER_H
@@ -0,0 +1,183 @@
+#include "CacheManager.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+size_t scaled(size_t bytes, double factor) {
+    double result = static_cast<double>(bytes) * factor;
+    return result >= static_cast<double>(SIZE_MAX) ? SIZE_MAX : static_cast<size_t>(result);
+}
+
+} // namespace
+
+CacheManager::Registration::Registration(Registration&& other) noexcept
+    : manager(std::exchange(other.manager, nullptr)), id(other.id) {}
+
+CacheManager::Registration& CacheManager::Registration::operator=(Registration&& other) noexcept {
+    if (this != &other) {
+        if (manager) manager->remove(id);
+        manager = std::exchange(other.manager, nullptr);
+        id = other.id;
+    }
+    return *this;
+}
+
+CacheManager::Registration::~Registration() {
+    if (manager) manager->remove(id);
+}
+
+CacheManager::CacheManager(size_t budget_bytes) : budget(budget_bytes) {}
+
+CacheManager& CacheManager::shared() {
+    static CacheManager manager;
+    return manager;
+}
+
+CacheManager::Registration CacheManager::add(Cache cache) {
+    std::lock_guard<std::mutex> lock(mutex);
+    cache.weight = std::max(cache.weight, 0.001);
+    uint64_t id = next_id++;
+    entries.push_back(Entry{id, std::move(cache), 0});
+    rebalanceLocked();
+    return Registration(this, id);
+}
+
+void CacheManager::remove(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = std::find_if(entries.begin(), entries.end(), [id](const Entry& entry) { return entry.id == id; });
+    if (it == entries.end()) return;
+    entries.erase(it);
+    rebalanceLocked();
+}
+
+void CacheManager::setBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    budget = bytes;
+    rebalanceLocked();
+}
+
+size_t CacheManager::getBudget() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return budget;
+}
+
+size_t CacheManager::getEffectiveBudget() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return effectiveBudgetLocked();
+}
+
+size_t CacheManager::effectiveBudgetLocked() const {
+    return std::min(scaled(budget, fraction), pressure_cap);
+}
+
+void CacheManager::setBudgetFraction(double budget_fraction) {
+    std::lock_guard<std::mutex> lock(mutex);
+    fraction = std::clamp(budget_fraction, 0.0, 1.0);
+    rebalanceLocked();
+}
+
+void CacheManager::reportMemoryPressure(size_t over_bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t full = scaled(budget, fraction);
+    if (over_bytes > 0) {
+        // Give back the excess from what the caches hold, if they hold that much
+        size_t held = 0;
+        for (const Entry& entry : entries) held += entry.cache.usage ? entry.cache.usage() : 0;
+        size_t target = held > over_bytes ? held - over_bytes : 0;
+        pressure_cap = std::max(scaled(full, MIN_PRESSURE_FRACTION), std::min(target, effectiveBudgetLocked()));
+    } else if (pressure_cap != SIZE_MAX) {
+        pressure_cap = pressure_cap > SIZE_MAX - full / 8 ? SIZE_MAX : pressure_cap + full / 8;
+        if (pressure_cap >= full) pressure_cap = SIZE_MAX;
+    } else {
+        return;
+    }
+    rebalanceLocked();
+}
+
+void CacheManager::poll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (std::chrono::steady_clock::now() - last_rebalance >= REBALANCE_INTERVAL) {
+        rebalanceLocked();
+    }
+}
+
+void CacheManager::rebalance() {
+    std::lock_guard<std::mutex> lock(mutex);
+    rebalanceLocked();
+}
+
+void CacheManager::rebalanceLocked() {
+    last_rebalance = std::chrono::steady_clock::now();
+    const size_t count = entries.size();
+    if (count == 0) return;
+
+    // What each cache asks for: a new one its whole weighted part, one near
+    // its share twice that, any other a quarter more than it holds; never
+    // less than its reserve
+    size_t remaining = effectiveBudgetLocked();
+    double total_weight = 0.0;
+    for (const Entry& entry : entries) total_weight += entry.cache.weight;
+    std::vector<size_t> demand(count);
+    for (size_t i = 0; i < count; ++i) {
+        const Entry& entry = entries[i];
+        size_t used = entry.cache.usage ? entry.cache.usage() : 0;
+        if (entry.budget == 0) {
+            demand[i] = SIZE_MAX;
+        } else if (used >= entry.budget - entry.budget / 8) {
+            demand[i] = scaled(entry.budget, 2.0);
+        } else {
+            demand[i] = used + used / 4;
+        }
+        size_t reserve = scaled(remaining, entry.cache.weight / total_weight * RESERVE_FRACTION);
+        demand[i] = std::max({demand[i], reserve, MIN_SHARE});
+    }
+
+    // Water-fill by weight: settle every demand below its weighted part of
+    // what is left, then split the rest among the caches still asking
+    std::vector<size_t> shares(count, 0);
+    std::vector<char> settled(count, 0);
+    for (bool changed = true; changed;) {
+        changed = false;
+        double weights = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            if (!settled[i]) weights += entries[i].cache.weight;
+        }
+        if (weights == 0.0) break;
+        const size_t pool = remaining;
+        for (size_t i = 0; i < count; ++i) {
+            if (settled[i] || demand[i] > scaled(pool, entries[i].cache.weight / weights)) continue;
+            shares[i] = demand[i];
+            remaining -= std::min(remaining, demand[i]);
+            settled[i] = 1;
+            changed = true;
+        }
+    }
+    const bool all_settled = std::all_of(settled.begin(), settled.end(), [](char done) { return done != 0; });
+    double weights = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        if (all_settled || !settled[i]) weights += entries[i].cache.weight;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (all_settled || !settled[i]) shares[i] += scaled(remaining, entries[i].cache.weight / weights);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        Entry& entry = entries[i];
+        size_t share = std::max<size_t>(shares[i], 1);
+        if (share == entry.budget) continue;
+        entry.budget = share;
+        if (entry.cache.resize) entry.cache.resize(share);
+    }
+}
+
+std::vector<CacheManager::CacheStats> CacheManager::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<CacheStats> stats;
+    stats.reserve(entries.size());
+    for (const Entry& entry : entries) {
+        stats.push_back({entry.cache.name, entry.cache.weight, entry.cache.usage ? entry.cache.usage() : 0,
+                         entry.budget});
+    }
+    return stats;
+}
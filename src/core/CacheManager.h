@@ -0,0 +1,119 @@
+#ifndef CACHEMANAGER_H
+#define CACHEMANAGER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// One memory budget shared by the process's caches (search results, media
+// textures, ...). Each cache keeps its own eviction order and is told only
+// how many bytes it may hold; the manager decides the split.
+//
+// A cache's weight is what a byte of it is worth relative to the others,
+// roughly what a miss costs to redo per byte cached: a search result is a few
+// kilobytes that took milliseconds to find, a texture megabytes that took as
+// long to decode. Every cache keeps RESERVE_FRACTION of its weighted part of
+// the budget, so one that has not filled yet can still take large entries.
+// Beyond that budgets follow demand: a cache using well under its share is
+// given a quarter more than it holds, and one at its share may double, both
+// within its weighted part of what is left; whatever nobody asked for is
+// spread by weight, so the shares always add up to the budget. Caches apply
+// a new share at once or at their next chance to evict.
+//
+// The budget shrinks with the degradation profile's cache fraction and, while
+// the MemoryMonitor reports resident memory past its threshold, by the
+// excess, down to MIN_PRESSURE_FRACTION of it; it recovers an eighth of the
+// budget per report once under again.
+class CacheManager {
+public:
+    static constexpr size_t DEFAULT_BUDGET = 320 * 1024 * 1024;
+    static constexpr size_t MIN_SHARE = 1024 * 1024;
+    static constexpr double RESERVE_FRACTION = 0.25;
+    static constexpr double MIN_PRESSURE_FRACTION = 0.125;
+    static constexpr auto REBALANCE_INTERVAL = std::chrono::seconds(2);
+
+    struct Cache {
+        std::string name;
+        double weight = 1.0;
+        std::function<size_t()> usage;          // bytes held now
+        std::function<void(size_t bytes)> resize; // the cache's new budget
+    };
+
+    struct CacheStats {
+        std::string name;
+        double weight = 0.0;
+        size_t usage = 0;
+        size_t budget = 0;
+    };
+
+    // Keeps a cache registered while it lives; destroy it before the cache.
+    // Its callbacks are called from whichever thread rebalances, never after
+    // it is destroyed.
+    class Registration {
+    private:
+        CacheManager* manager = nullptr;
+        uint64_t id = 0;
+
+    public:
+        Registration() = default;
+        Registration(CacheManager* manager, uint64_t id) : manager(manager), id(id) {}
+        Registration(Registration&& other) noexcept;
+        Registration& operator=(Registration&& other) noexcept;
+        ~Registration();
+
+        Registration(const Registration&) = delete;
+        Registration& operator=(const Registration&) = delete;
+
+        explicit operator bool() const { return manager != nullptr; }
+    };
+
+    explicit CacheManager(size_t budget_bytes = DEFAULT_BUDGET);
+
+    CacheManager(const CacheManager&) = delete;
+    CacheManager& operator=(const CacheManager&) = delete;
+
+    static CacheManager& shared();
+
+    // Rebalances at once, so the cache starts with its share
+    Registration add(Cache cache);
+
+    void setBudget(size_t bytes);
+    size_t getBudget() const;
+    // What the caches may hold now, after load shedding and memory pressure
+    size_t getEffectiveBudget() const;
+    // DegradationProfile::cache_budget_fraction
+    void setBudgetFraction(double fraction);
+    // Resident memory is over_bytes past the monitor's threshold; 0 once under it
+    void reportMemoryPressure(size_t over_bytes);
+
+    // Rebalances if REBALANCE_INTERVAL has passed since the last time; call each frame (or tick)
+    void poll();
+    void rebalance();
+
+    std::vector<CacheStats> getStats() const;
+
+private:
+    struct Entry {
+        uint64_t id = 0;
+        Cache cache;
+        size_t budget = 0; // 0 until first rebalanced
+    };
+
+    mutable std::mutex mutex;
+    std::vector<Entry> entries;
+    uint64_t next_id = 1;
+    size_t budget;
+    double fraction = 1.0;
+    size_t pressure_cap = SIZE_MAX; // while recovering from memory pressure
+    std::chrono::steady_clock::time_point last_rebalance;
+
+    void remove(uint64_t id);
+    size_t effectiveBudgetLocked() const;
+    void rebalanceLocked();
+};
+
+#endif // CACHEMANAGER_H
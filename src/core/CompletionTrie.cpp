@@ -0,0 +1,291 @@
+#include "CompletionTrie.h"
+#include <algorithm>
+#include <cctype>
+#include <numeric>
+
+namespace {
+
+std::string toLowerAscii(std::string_view text) {
+    std::string lower(text);
+    for (char& c : lower) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return lower;
+}
+
+size_t commonPrefix(std::string_view a, std::string_view b, size_t from) {
+    size_t limit = std::min(a.size(), b.size());
+    while (from < limit && a[from] == b[from]) ++from;
+    return from;
+}
+
+} // namespace
+
+void CompletionTrie::build(std::vector<Source> sources) {
+    clear();
+    if (sources.empty()) return;
+
+    std::vector<std::string> lowered;
+    lowered.reserve(sources.size());
+    for (const auto& source : sources) {
+        lowered.push_back(toLowerAscii(source.text));
+    }
+
+    std::vector<uint32_t> order(sources.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        if (lowered[a] != lowered[b]) return lowered[a] < lowered[b];
+        return sources[a].text < sources[b].text;
+    });
+
+    size_t total = 0;
+    for (const auto& source : sources) total += source.text.size();
+    texts.reserve(total);
+    keys.reserve(total);
+    entries.reserve(sources.size());
+
+    // Entries of one key are few (case variants), so they are searched linearly
+    auto same_text = [this](EntryId group_begin, std::string_view wanted) {
+        for (EntryId id = group_begin; id < entries.size(); ++id) {
+            if (text(id) == wanted) return id;
+        }
+        return NO_ENTRY;
+    };
+    for (size_t group = 0; group < order.size();) {
+        size_t group_end = group + 1;
+        while (group_end < order.size() && lowered[order[group_end]] == lowered[order[group]]) ++group_end;
+        const EntryId group_begin = static_cast<EntryId>(entries.size());
+
+        // Aliases last, so they find the entries they fold into
+        for (int pass = 0; pass < 2; ++pass) {
+            for (size_t i = group; i < group_end; ++i) {
+                const Source& source = sources[order[i]];
+                if (source.alias != (pass == 1)) continue;
+                EntryId target = same_text(group_begin, source.text);
+                if (target == NO_ENTRY && source.alias && entries.size() > group_begin) target = group_begin;
+                if (target != NO_ENTRY) {
+                    entries[target].frequency += source.frequency; // Same text from another translation
+                    continue;
+                }
+                entries.push_back({static_cast<uint32_t>(texts.size()), static_cast<uint32_t>(source.text.size()),
+                                   source.frequency});
+                texts += source.text;
+                keys += lowered[order[i]];
+            }
+        }
+        group = group_end;
+    }
+    entries.shrink_to_fit();
+
+    Node root{};
+    root.first_entry = 0;
+    root.entry_end = static_cast<uint32_t>(entries.size());
+    nodes.push_back(root);
+    buildNode(0, 0);
+    nodes.shrink_to_fit();
+    top.shrink_to_fit();
+}
+
+void CompletionTrie::buildNode(uint32_t index, size_t depth) {
+    const uint32_t begin = nodes[index].first_entry;
+    const uint32_t end = nodes[index].entry_end;
+
+    // Keys that end at this node sort ahead of the ones that continue past it
+    uint32_t terminal_end = begin;
+    while (terminal_end < end && keyOf(terminal_end).size() == depth) ++terminal_end;
+
+    std::vector<std::pair<uint32_t, uint32_t>> groups;
+    for (uint32_t i = terminal_end; i < end;) {
+        char next = keyOf(i)[depth];
+        uint32_t j = i + 1;
+        while (j < end && keyOf(j)[depth] == next) ++j;
+        groups.push_back({i, j});
+        i = j;
+    }
+
+    const uint32_t first_child = static_cast<uint32_t>(nodes.size());
+    nodes[index].first_child = first_child;
+    nodes[index].child_count = static_cast<uint16_t>(groups.size());
+    nodes.resize(nodes.size() + groups.size());
+
+    for (size_t g = 0; g < groups.size(); ++g) {
+        auto [group_begin, group_end] = groups[g];
+        // Sorted run: the first and last keys bound the prefix all of them share
+        size_t shared = commonPrefix(keyOf(group_begin), keyOf(group_end - 1), depth + 1);
+        shared = std::min(shared, depth + UINT16_MAX);
+
+        Node& child = nodes[first_child + g];
+        child.first_entry = group_begin;
+        child.entry_end = group_end;
+        child.label_offset = entries[group_begin].offset + static_cast<uint32_t>(depth);
+        child.label_length = static_cast<uint16_t>(shared - depth);
+        buildNode(first_child + static_cast<uint32_t>(g), shared);
+    }
+
+    if (end - begin <= TOP_K) return; // Ranked from the entry run itself on lookup
+
+    // This node's best entries are among its own and its children's best
+    std::vector<EntryId> candidates;
+    for (EntryId id = begin; id < terminal_end; ++id) {
+        candidates.push_back(id);
+    }
+    for (size_t g = 0; g < groups.size(); ++g) {
+        const Node& child = nodes[first_child + g];
+        if (child.top_offset != NO_TOP) {
+            candidates.insert(candidates.end(), top.begin() + child.top_offset,
+                              top.begin() + child.top_offset + TOP_K);
+        } else {
+            for (EntryId id = child.first_entry; id < child.entry_end; ++id) {
+                candidates.push_back(id);
+            }
+        }
+    }
+    std::partial_sort(candidates.begin(), candidates.begin() + TOP_K, candidates.end(),
+                      [this](EntryId a, EntryId b) { return ranksBefore(a, b); });
+
+    nodes[index].top_offset = static_cast<uint32_t>(top.size());
+    top.insert(top.end(), candidates.begin(), candidates.begin() + TOP_K);
+}
+
+const CompletionTrie::Node* CompletionTrie::findNode(std::string_view lower_prefix) const {
+    if (nodes.empty()) return nullptr;
+
+    const Node* node = &nodes[0];
+    size_t pos = 0;
+    while (pos < lower_prefix.size()) {
+        auto children_begin = nodes.begin() + node->first_child;
+        auto children_end = children_begin + node->child_count;
+        unsigned char wanted = static_cast<unsigned char>(lower_prefix[pos]);
+        auto child = std::lower_bound(children_begin, children_end, wanted,
+                                      [this](const Node& candidate, unsigned char c) {
+                                          return static_cast<unsigned char>(keys[candidate.label_offset]) < c;
+                                      });
+        if (child == children_end || static_cast<unsigned char>(keys[child->label_offset]) != wanted) {
+            return nullptr;
+        }
+
+        std::string_view label(keys.data() + child->label_offset, child->label_length);
+        size_t compared = std::min(label.size(), lower_prefix.size() - pos);
+        if (label.substr(0, compared) != lower_prefix.substr(pos, compared)) return nullptr;
+
+        pos += compared;
+        node = &*child;
+    }
+    return node;
+}
+
+void CompletionTrie::appendBest(const Node& node, std::vector<EntryId>& results) const {
+    if (node.top_offset != NO_TOP) {
+        results.insert(results.end(), top.begin() + node.top_offset, top.begin() + node.top_offset + TOP_K);
+        return;
+    }
+    for (EntryId id = node.first_entry; id < node.entry_end; ++id) {
+        results.push_back(id);
+    }
+}
+
+void CompletionTrie::completeTypo(std::string_view prefix, std::vector<EntryId>& results,
+                                  std::vector<std::pair<EntryId, EntryId>>& ranges) const {
+    if (nodes.empty() || prefix.empty() || prefix.size() > MAX_TYPO_INPUT) return;
+    const std::string lower = toLowerAscii(prefix);
+
+    // Row i is the edit distance between the first i input characters and the key so far
+    TypoRow row{};
+    for (size_t i = 0; i <= lower.size(); ++i) row[i] = static_cast<uint8_t>(i);
+    walkTypo(nodes[0], lower, row, row, '\0', results, ranges);
+}
+
+void CompletionTrie::walkTypo(const Node& node, std::string_view lower_input, const TypoRow& before,
+                              const TypoRow& row, char last, std::vector<EntryId>& results,
+                              std::vector<std::pair<EntryId, EntryId>>& ranges) const {
+    constexpr uint8_t MAX_EDITS = 1;
+    const size_t n = lower_input.size();
+
+    for (uint32_t c = 0; c < node.child_count; ++c) {
+        const Node& child = nodes[node.first_child + c];
+        TypoRow previous = before;
+        TypoRow current = row;
+        char previous_char = last;
+        bool matched = false;
+        bool hopeless = false;
+
+        for (uint16_t j = 0; j < child.label_length && !matched && !hopeless; ++j) {
+            const char key_char = keys[child.label_offset + j];
+            TypoRow next;
+            next[0] = static_cast<uint8_t>(current[0] + 1);
+            uint8_t lowest = next[0];
+            for (size_t i = 1; i <= n; ++i) {
+                int distance = std::min({current[i] + 1, next[i - 1] + 1,
+                                         current[i - 1] + (lower_input[i - 1] != key_char ? 1 : 0)});
+                // Swapped neighbours count as one edit (optimal string alignment)
+                if (i > 1 && lower_input[i - 1] == previous_char && lower_input[i - 2] == key_char) {
+                    distance = std::min(distance, previous[i - 2] + 1);
+                }
+                next[i] = static_cast<uint8_t>(distance);
+                lowest = std::min(lowest, next[i]);
+            }
+            // The whole input is matched: every key below here completes it
+            matched = next[n] <= MAX_EDITS;
+            // No longer key can come back within the bound
+            hopeless = lowest > MAX_EDITS;
+            previous = current;
+            current = next;
+            previous_char = key_char;
+        }
+
+        if (matched) {
+            appendBest(child, results);
+            ranges.push_back({child.first_entry, child.entry_end});
+        } else if (!hopeless) {
+            walkTypo(child, lower_input, previous, current, previous_char, results, ranges);
+        }
+    }
+}
+
+void CompletionTrie::complete(std::string_view prefix, size_t max_results, std::vector<EntryId>& results) const {
+    results.clear();
+    const Node* node = findNode(toLowerAscii(prefix));
+    if (!node || max_results == 0) return;
+
+    if (node->top_offset != NO_TOP) {
+        size_t count = std::min(max_results, TOP_K);
+        results.assign(top.begin() + node->top_offset, top.begin() + node->top_offset + count);
+        return;
+    }
+
+    for (EntryId id = node->first_entry; id < node->entry_end; ++id) {
+        results.push_back(id);
+    }
+    std::sort(results.begin(), results.end(), [this](EntryId a, EntryId b) { return ranksBefore(a, b); });
+    if (results.size() > max_results) results.resize(max_results);
+}
+
+std::pair<CompletionTrie::EntryId, CompletionTrie::EntryId> CompletionTrie::prefixRange(std::string_view prefix) const {
+    const Node* node = findNode(toLowerAscii(prefix));
+    if (!node) return {0, 0};
+    return {node->first_entry, node->entry_end};
+}
+
+CompletionTrie::EntryId CompletionTrie::find(std::string_view word) const {
+    const Node* node = findNode(toLowerAscii(word));
+    if (!node) return NO_ENTRY;
+
+    // Entries whose key is exactly the lowered text lead the node's run
+    for (EntryId id = node->first_entry; id < node->entry_end && entries[id].length == word.size(); ++id) {
+        if (text(id) == word) return id;
+    }
+    return NO_ENTRY;
+}
+
+void CompletionTrie::clear() {
+    texts.clear();
+    keys.clear();
+    entries.clear();
+    nodes.clear();
+    top.clear();
+}
+
+size_t CompletionTrie::getMemoryUsage() const {
+    return texts.capacity() + keys.capacity() + entries.capacity() * sizeof(Entry) +
+           nodes.capacity() * sizeof(Node) + top.capacity() * sizeof(EntryId);
+}
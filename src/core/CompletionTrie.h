@@ -0,0 +1,108 @@
+#ifndef COMPLETIONTRIE_H
+#define COMPLETIONTRIE_H
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include "MemoryAccounting.h"
+
+// Immutable radix trie for prefix completion. Entries are sorted by their
+// lower-cased key, so every node covers one contiguous run of entry ids and
+// its label is a slice of the shared key pool. Nodes whose run is longer than
+// TOP_K keep their TOP_K most frequent ids; smaller runs are ranked on lookup.
+// completeTypo() walks the same nodes with a Levenshtein automaton bounded
+// at one edit, so a mistyped prefix costs a few hundred node visits rather
+// than a scan of the entries.
+class CompletionTrie {
+public:
+    static constexpr size_t TOP_K = 10;
+    static constexpr size_t MAX_TYPO_INPUT = 32; // longer prefixes are only completed exactly
+    using EntryId = uint32_t;
+    static constexpr EntryId NO_ENTRY = UINT32_MAX;
+
+    struct Source {
+        std::string text;
+        uint32_t frequency;
+        // Adds its frequency to an entry whose text differs only in case, if
+        // there is one, instead of becoming an entry of its own
+        bool alias = false;
+    };
+
+private:
+    static constexpr uint32_t NO_TOP = UINT32_MAX;
+
+    struct Entry {
+        uint32_t offset;    // into texts and keys alike; lower-casing keeps lengths
+        uint32_t length;
+        uint32_t frequency;
+    };
+
+    struct Node {
+        uint32_t first_entry;
+        uint32_t entry_end;
+        uint32_t label_offset; // into keys
+        uint16_t label_length;
+        uint16_t child_count;
+        uint32_t first_child;  // children are contiguous and sorted by first label byte
+        uint32_t top_offset = NO_TOP;
+    };
+
+    // Counted under MemoryTag::AUTOCOMPLETE, its only user
+    TaggedString<MemoryTag::AUTOCOMPLETE> texts; // display forms
+    TaggedString<MemoryTag::AUTOCOMPLETE> keys;  // lower-cased forms
+    TaggedVector<Entry, MemoryTag::AUTOCOMPLETE> entries;
+    TaggedVector<Node, MemoryTag::AUTOCOMPLETE> nodes;
+    TaggedVector<EntryId, MemoryTag::AUTOCOMPLETE> top;
+
+    using TypoRow = std::array<uint8_t, MAX_TYPO_INPUT + 1>;
+
+    std::string_view keyOf(EntryId id) const {
+        return std::string_view(keys).substr(entries[id].offset, entries[id].length);
+    }
+    bool ranksBefore(EntryId a, EntryId b) const {
+        if (entries[a].frequency != entries[b].frequency) return entries[a].frequency > entries[b].frequency;
+        return a < b;
+    }
+    void buildNode(uint32_t index, size_t depth);
+    const Node* findNode(std::string_view lower_prefix) const;
+    // The node's best entries: its TOP_K, or its whole (smaller) run unranked
+    void appendBest(const Node& node, std::vector<EntryId>& results) const;
+    void walkTypo(const Node& node, std::string_view lower_input, const TypoRow& before, const TypoRow& row,
+                  char last, std::vector<EntryId>& results, std::vector<std::pair<EntryId, EntryId>>& ranges) const;
+
+public:
+    CompletionTrie() = default;
+
+    // Replace the contents; identical texts are merged and their frequencies summed
+    void build(std::vector<Source> sources);
+    void clear();
+
+    // Entries whose text starts with prefix (ASCII case-insensitive), most frequent first
+    void complete(std::string_view prefix, size_t max_results, std::vector<EntryId>& results) const;
+    // Entries whose text starts with something one edit away from prefix: a
+    // letter inserted, dropped or replaced, or two neighbours swapped (ASCII
+    // case-insensitive). Appends each matching run's best entries, unranked,
+    // to results and the run to ranges. Runs are disjoint but include the
+    // exact matches. Does nothing for prefixes longer than MAX_TYPO_INPUT.
+    void completeTypo(std::string_view prefix, std::vector<EntryId>& results,
+                      std::vector<std::pair<EntryId, EntryId>>& ranges) const;
+    // Ids [first, last) of every entry under prefix; sorted ids keep each prefix contiguous
+    std::pair<EntryId, EntryId> prefixRange(std::string_view prefix) const;
+    // Entry with exactly this text, or NO_ENTRY
+    EntryId find(std::string_view word) const;
+
+    std::string_view text(EntryId id) const {
+        return std::string_view(texts).substr(entries[id].offset, entries[id].length);
+    }
+    uint32_t frequency(EntryId id) const { return entries[id].frequency; }
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+    size_t nodeCount() const { return nodes.size(); }
+    size_t getMemoryUsage() const;
+};
+
+#endif // COMPLETIONTRIE_H
@@ -0,0 +1,51 @@
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "VerseStore.h"
+#include "InvertedIndex.h"
+#include "MinHashIndex.h"
+#include "VerseAlignment.h"
+#include "LanguageIndex.h"
+#include "SubstringIndex.h"
+#include "TrigramIndex.h"
+
+struct TranslationInfo {
+    std::string name;
+    std::string abbreviation;
+    std::string description;
+    int year = 0;
+    std::string language;
+    std::string filename;
+    bool is_loaded = false;
+
+    TranslationInfo() = default;
+    TranslationInfo(const std::string& n, const std::string& abbr,
+                   const std::string& desc = "", int y = 0,
+                   const std::string& lang = "", const std::string& file = "")
+        : name(n), abbreviation(abbr), description(desc), year(y),
+          language(lang), filename(file), is_loaded(false) {}
+};
+
+// The translations as searches see them at one moment: what is listed, and
+// the stores and indexes of those resident. A published Corpus never changes.
+// Loads copy the current one, which copies pointers rather than verses since
+// versions share each translation's data, change the copy and publish it;
+// a reader keeps the version it took, whole, until it lets it go.
+struct Corpus {
+    std::vector<TranslationInfo> translations; // every translation found, resident or only listed
+    VerseStoreMap verses;
+    InvertedIndexMap keyword_index;
+    std::unordered_map<std::string, std::shared_ptr<const MinHashIndex>> similarity_indexes; // near-duplicate verses
+    std::unordered_map<std::string, std::shared_ptr<const TrigramIndex>> trigram_indexes; // fuzzy search candidates
+    // Translations read while substring search was on (see VerseFinder::setSubstringSearch)
+    std::unordered_map<std::string, std::shared_ptr<const SubstringIndex>> substring_indexes;
+    VerseAlignment alignment; // every resident translation's verses by English versification row
+    // By language, for languages with more than one resident translation; rebuilt on publish
+    std::unordered_map<std::string, std::shared_ptr<const LanguageIndex>> language_indexes;
+};
+
+#endif // CORPUS_H
@@ -28,8 +28,10 @@ bool CrashRecoverySystem::initialize(const std::string& recovery_dir) {
         std::filesystem::create_directories(recovery_directory);
         
         // Set up file paths
+        session_journal_file = recovery_directory + "/current_session.jsonl";
         current_session_file = recovery_directory + "/current_session.json";
         backup_session_file = recovery_directory + "/backup_session.json";
+        session_journal = std::make_unique<JournalFile>(session_journal_file);
         
         // Clean up old sessions
         cleanupOldSessions();
@@ -37,6 +39,10 @@ bool CrashRecoverySystem::initialize(const std::string& recovery_dir) {
         // Initialize current session
         current_session.timestamp = std::chrono::system_clock::now();
         
+        writer_stopping = false;
+        journal_stale = false;
+        writer = std::thread(&CrashRecoverySystem::writerLoop, this);
+        
         is_initialized.store(true);
         
         std::cout << "CrashRecoverySystem initialized with session ID: " << session_id << std::endl;
@@ -53,8 +59,16 @@ void CrashRecoverySystem::shutdown() {
         return;
     }
     
-    // Save final state
+    // Save final state, let the writer finish, and archive it under the session id
     saveSessionState();
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        writer_stopping = true;
+    }
+    writer_wake.notify_one();
+    writer.join();
+    saveSessionToFile(written_session, getSessionFilePath(session_id));
+    session_journal->close();
     
     is_initialized.store(false);
     std::cout << "CrashRecoverySystem shutdown complete" << std::endl;
@@ -79,34 +93,63 @@ std::string CrashRecoverySystem::getSessionFilePath(const std::string& session_i
     return recovery_directory + "/session_" + session_id + ".json";
 }
 
-bool CrashRecoverySystem::saveSessionToFile(const SessionState& state, const std::string& filepath) {
-    try {
-        json session_json;
-        
-        // Convert SessionState to JSON
-        session_json["session_id"] = state.session_id;
-        session_json["timestamp"] = std::chrono::duration_cast<std::chrono::seconds>(
-            state.timestamp.time_since_epoch()).count();
-        session_json["current_translation"] = state.current_translation;
-        session_json["current_search_query"] = state.current_search_query;
-        session_json["search_history"] = state.search_history;
-        session_json["selected_verses"] = state.selected_verses;
-        session_json["favorite_verses"] = state.favorite_verses;
-        session_json["custom_collections"] = state.custom_collections;
-        session_json["presentation_settings"] = state.presentation_settings;
-        session_json["ui_settings"] = state.ui_settings;
+json CrashRecoverySystem::sessionFields(const SessionState& state, uint32_t fields) {
+    json session_json;
+    session_json["session_id"] = state.session_id;
+    session_json["timestamp"] = std::chrono::duration_cast<std::chrono::seconds>(
+        state.timestamp.time_since_epoch()).count();
+    
+    if (fields & FIELD_TRANSLATION) session_json["current_translation"] = state.current_translation;
+    if (fields & FIELD_SEARCH_QUERY) session_json["current_search_query"] = state.current_search_query;
+    if (fields & FIELD_SEARCH_HISTORY) session_json["search_history"] = state.search_history;
+    if (fields & FIELD_SELECTED_VERSES) session_json["selected_verses"] = state.selected_verses;
+    if (fields & FIELD_FAVORITE_VERSES) session_json["favorite_verses"] = state.favorite_verses;
+    if (fields & FIELD_COLLECTIONS) session_json["custom_collections"] = state.custom_collections;
+    if (fields & FIELD_PRESENTATION_SETTINGS) session_json["presentation_settings"] = state.presentation_settings;
+    if (fields & FIELD_UI_SETTINGS) session_json["ui_settings"] = state.ui_settings;
+    if (fields & FIELD_PRESENTATION_MODE) {
         session_json["presentation_mode_active"] = state.presentation_mode_active;
         session_json["current_displayed_verse"] = state.current_displayed_verse;
-        session_json["version"] = "1.0";
+    }
+    if (fields == ALL_FIELDS) session_json["version"] = "1.0";
+    
+    return session_json;
+}
+
+void CrashRecoverySystem::applySessionFields(const json& fields, SessionState& state) {
+    // Only the fields present are changed, so a journal replays record by record
+    if (fields.contains("session_id")) state.session_id = fields["session_id"].get<std::string>();
+    if (fields.contains("timestamp")) {
+        state.timestamp = std::chrono::system_clock::from_time_t(fields["timestamp"].get<long>());
+    }
+    if (fields.contains("current_translation")) state.current_translation = fields["current_translation"];
+    if (fields.contains("current_search_query")) state.current_search_query = fields["current_search_query"];
+    if (fields.contains("search_history")) state.search_history = fields["search_history"];
+    if (fields.contains("selected_verses")) state.selected_verses = fields["selected_verses"];
+    if (fields.contains("favorite_verses")) state.favorite_verses = fields["favorite_verses"];
+    if (fields.contains("custom_collections")) state.custom_collections = fields["custom_collections"];
+    if (fields.contains("presentation_settings")) state.presentation_settings = fields["presentation_settings"];
+    if (fields.contains("ui_settings")) state.ui_settings = fields["ui_settings"];
+    if (fields.contains("presentation_mode_active")) state.presentation_mode_active = fields["presentation_mode_active"];
+    if (fields.contains("current_displayed_verse")) state.current_displayed_verse = fields["current_displayed_verse"];
+}
+
+bool CrashRecoverySystem::saveSessionToFile(const SessionState& state, const std::string& filepath) {
+    try {
+        json session_json = sessionFields(state, ALL_FIELDS);
         
-        // Write to file
-        std::ofstream file(filepath);
-        if (!file.is_open()) {
-            return false;
+        std::string temp_path = filepath + ".tmp";
+        {
+            std::ofstream file(temp_path, std::ios::trunc);
+            if (!file.is_open()) {
+                return false;
+            }
+            file << session_json.dump(4);
+            if (!file.good()) {
+                return false;
+            }
         }
-        
-        file << session_json.dump(4);
-        file.close();
+        std::filesystem::rename(temp_path, filepath);
         
         return true;
         
@@ -127,35 +170,41 @@ bool CrashRecoverySystem::loadSessionFromFile(const std::string& filepath, Sessi
         file >> session_json;
         file.close();
         
-        // Convert JSON to SessionState
-        state.session_id = session_json.value("session_id", "");
+        state = SessionState();
+        applySessionFields(session_json, state);
         
-        auto timestamp_seconds = session_json.value("timestamp", 0L);
-        state.timestamp = std::chrono::system_clock::from_time_t(timestamp_seconds);
-        
-        state.current_translation = session_json.value("current_translation", "");
-        state.current_search_query = session_json.value("current_search_query", "");
-        state.search_history = session_json.value("search_history", std::vector<std::string>());
-        state.selected_verses = session_json.value("selected_verses", std::vector<std::string>());
-        state.favorite_verses = session_json.value("favorite_verses", std::vector<std::string>());
+        return validateSessionData(state);
         
-        if (session_json.contains("custom_collections")) {
-            state.custom_collections = session_json["custom_collections"];
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to load session from file: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool CrashRecoverySystem::loadSessionJournal(const std::string& filepath, SessionState& state) {
+    try {
+        state = SessionState();
+        if (!JournalFile::replay(filepath, [&state](const json& record) { applySessionFields(record, state); })) {
+            return false;
         }
-        
-        state.presentation_settings = session_json.value("presentation_settings", json::object());
-        state.ui_settings = session_json.value("ui_settings", json::object());
-        state.presentation_mode_active = session_json.value("presentation_mode_active", false);
-        state.current_displayed_verse = session_json.value("current_displayed_verse", "");
-        
         return validateSessionData(state);
         
     } catch (const std::exception& e) {
-        std::cerr << "Failed to load session from file: " << e.what() << std::endl;
+        std::cerr << "Failed to load session journal: " << e.what() << std::endl;
         return false;
     }
 }
 
+bool CrashRecoverySystem::loadCurrentSession(SessionState& state) {
+    if (std::filesystem::exists(session_journal_file) && loadSessionJournal(session_journal_file, state)) {
+        return true;
+    }
+    if (std::filesystem::exists(current_session_file) && loadSessionFromFile(current_session_file, state)) {
+        return true;
+    }
+    return std::filesystem::exists(backup_session_file) && loadSessionFromFile(backup_session_file, state);
+}
+
 bool CrashRecoverySystem::validateSessionData(const SessionState& state) {
     // Basic validation
     if (state.session_id.empty()) {
@@ -216,33 +265,76 @@ bool CrashRecoverySystem::saveSessionState() {
         return false;
     }
     
-    std::lock_guard<std::mutex> lock(state_mutex);
-    
-    try {
-        // Update timestamp
+    json fields;
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
         current_session.timestamp = std::chrono::system_clock::now();
-        
-        // Save to current session file
-        if (!saveSessionToFile(current_session, current_session_file)) {
-            return false;
+        fields = sessionFields(current_session, dirty_fields);
+        dirty_fields = 0;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(writer_mutex);
+        if (pending_fields.is_null()) {
+            pending_fields = std::move(fields);
+        } else {
+            // Fields are replaced whole, so later values simply win
+            pending_fields.update(fields);
+        }
+    }
+    writer_wake.notify_one();
+    return true;
+}
+
+void CrashRecoverySystem::flush() {
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    writer_idle.wait(lock, [this] { return pending_fields.is_null() && !writer_busy; });
+}
+
+void CrashRecoverySystem::writerLoop() {
+    std::unique_lock<std::mutex> lock(writer_mutex);
+    for (;;) {
+        writer_wake.wait(lock, [this] { return writer_stopping || !pending_fields.is_null(); });
+        if (pending_fields.is_null()) {
+            break; // stopping with nothing left to write
         }
         
-        // Also save a backup copy
-        saveSessionToFile(current_session, backup_session_file);
-        
-        // Save a timestamped copy
-        std::string timestamped_file = getSessionFilePath(session_id);
-        saveSessionToFile(current_session, timestamped_file);
+        json fields = std::move(pending_fields);
+        pending_fields = nullptr;
+        writer_busy = true;
+        lock.unlock();
         
-        {
+        bool saved = writeSessionFields(fields);
+        if (saved) {
             std::lock_guard<std::mutex> stats_lock(stats_mutex);
             stats.sessions_created++;
         }
         
-        return true;
+        lock.lock();
+        writer_busy = false;
+        writer_idle.notify_all();
+    }
+}
+
+bool CrashRecoverySystem::writeSessionFields(const json& fields) {
+    try {
+        applySessionFields(fields, written_session);
+        
+        // Append what changed; once the changes outgrow the snapshot, rewrite it
+        // (the session's first save always does, replacing the previous session)
+        bool saved;
+        if (journal_stale || session_journal->needsCompaction()) {
+            saved = session_journal->compact(sessionFields(written_session, ALL_FIELDS));
+            if (saved) saveSessionToFile(written_session, getSessionFilePath(session_id));
+        } else {
+            saved = session_journal->append(fields);
+        }
+        journal_stale = !saved;
+        return saved;
         
     } catch (const std::exception& e) {
         std::cerr << "Failed to save session state: " << e.what() << std::endl;
+        journal_stale = true;
         return false;
     }
 }
@@ -253,21 +345,12 @@ bool CrashRecoverySystem::loadLastSession(std::string& session_data) {
     }
     
     SessionState loaded_state;
-    bool success = false;
-    
-    // Try to load from current session file first
-    if (std::filesystem::exists(current_session_file)) {
-        success = loadSessionFromFile(current_session_file, loaded_state);
-    }
-    
-    // If that fails, try the backup
-    if (!success && std::filesystem::exists(backup_session_file)) {
-        success = loadSessionFromFile(backup_session_file, loaded_state);
-    }
+    bool success = loadCurrentSession(loaded_state);
     
     if (success) {
         std::lock_guard<std::mutex> lock(state_mutex);
         current_session = loaded_state;
+        dirty_fields = ALL_FIELDS;
         
         // Convert to JSON string for application
         json session_json;
@@ -306,30 +389,21 @@ bool CrashRecoverySystem::hasRecoverableSession() {
         return false;
     }
     
-    // Check if current session file exists and is valid
-    if (std::filesystem::exists(current_session_file)) {
-        SessionState test_state;
-        return loadSessionFromFile(current_session_file, test_state);
-    }
-    
-    // Check backup file
-    if (std::filesystem::exists(backup_session_file)) {
-        SessionState test_state;
-        return loadSessionFromFile(backup_session_file, test_state);
-    }
-    
-    return false;
+    SessionState test_state;
+    return loadCurrentSession(test_state);
 }
 
 // State update methods
 void CrashRecoverySystem::updateCurrentTranslation(const std::string& translation) {
     std::lock_guard<std::mutex> lock(state_mutex);
     current_session.current_translation = translation;
+    dirty_fields |= FIELD_TRANSLATION;
 }
 
 void CrashRecoverySystem::updateSearchQuery(const std::string& query) {
     std::lock_guard<std::mutex> lock(state_mutex);
     current_session.current_search_query = query;
+    dirty_fields |= FIELD_SEARCH_QUERY;
 }
 
 void CrashRecoverySystem::addToSearchHistory(const std::string& query) {
@@ -349,37 +423,44 @@ void CrashRecoverySystem::addToSearchHistory(const std::string& query) {
     if (current_session.search_history.size() > 50) {
         current_session.search_history.resize(50);
     }
+    dirty_fields |= FIELD_SEARCH_HISTORY;
 }
 
 void CrashRecoverySystem::updateSelectedVerses(const std::vector<std::string>& verses) {
     std::lock_guard<std::mutex> lock(state_mutex);
     current_session.selected_verses = verses;
+    dirty_fields |= FIELD_SELECTED_VERSES;
 }
 
 void CrashRecoverySystem::updateFavoriteVerses(const std::vector<std::string>& verses) {
     std::lock_guard<std::mutex> lock(state_mutex);
     current_session.favorite_verses = verses;
+    dirty_fields |= FIELD_FAVORITE_VERSES;
 }
 
 void CrashRecoverySystem::updateCustomCollections(const std::map<std::string, std::vector<std::string>>& collections) {
     std::lock_guard<std::mutex> lock(state_mutex);
     current_session.custom_collections = collections;
+    dirty_fields |= FIELD_COLLECTIONS;
 }
 
 void CrashRecoverySystem::updatePresentationSettings(const json& settings) {
     std::lock_guard<std::mutex> lock(state_mutex);
     current_session.presentation_settings = settings;
+    dirty_fields |= FIELD_PRESENTATION_SETTINGS;
 }
 
 void CrashRecoverySystem::updateUISettings(const json& settings) {
     std::lock_guard<std::mutex> lock(state_mutex);
     current_session.ui_settings = settings;
+    dirty_fields |= FIELD_UI_SETTINGS;
 }
 
 void CrashRecoverySystem::setPresentationMode(bool active, const std::string& displayed_verse) {
     std::lock_guard<std::mutex> lock(state_mutex);
     current_session.presentation_mode_active = active;
     current_session.current_displayed_verse = displayed_verse;
+    dirty_fields |= FIELD_PRESENTATION_MODE;
 }
 
 bool CrashRecoverySystem::recoverSession(const std::string& session_id) {
@@ -387,18 +468,13 @@ bool CrashRecoverySystem::recoverSession(const std::string& session_id) {
         return false;
     }
     
-    std::string filepath;
-    if (session_id.empty()) {
-        // Use current session file
-        filepath = current_session_file;
-    } else {
-        filepath = getSessionFilePath(session_id);
-    }
-    
     SessionState recovered_state;
-    if (loadSessionFromFile(filepath, recovered_state)) {
+    bool loaded = session_id.empty() ? loadCurrentSession(recovered_state)
+                                     : loadSessionFromFile(getSessionFilePath(session_id), recovered_state);
+    if (loaded) {
         std::lock_guard<std::mutex> lock(state_mutex);
         current_session = recovered_state;
+        dirty_fields = ALL_FIELDS;
         return true;
     }
     
@@ -543,8 +619,7 @@ bool CrashRecoverySystem::cleanupOldFiles() {
 bool CrashRecoverySystem::createEmergencySnapshot() {
     try {
         std::string emergency_file = recovery_directory + "/emergency_snapshot.json";
-        std::lock_guard<std::mutex> lock(state_mutex);
-        return saveSessionToFile(current_session, emergency_file);
+        return saveSessionToFile(getCurrentSessionState(), emergency_file);
     } catch (const std::exception& e) {
         std::cerr << "Failed to create emergency snapshot: " << e.what() << std::endl;
         return false;
@@ -559,6 +634,7 @@ bool CrashRecoverySystem::restoreFromEmergencySnapshot() {
         if (loadSessionFromFile(emergency_file, emergency_state)) {
             std::lock_guard<std::mutex> lock(state_mutex);
             current_session = emergency_state;
+            dirty_fields = ALL_FIELDS;
             return true;
         }
         
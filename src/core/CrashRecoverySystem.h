@@ -5,9 +5,13 @@
 #include <vector>
 #include <chrono>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
 #include <atomic>
 #include <memory>
+#include <cstdint>
 #include "nlohmann/json.hpp"
+#include "JournalFile.h"
 
 using json = nlohmann::json;
 
@@ -18,8 +22,8 @@ struct SessionState {
     std::vector<std::string> selected_verses;
     std::vector<std::string> favorite_verses;
     std::map<std::string, std::vector<std::string>> custom_collections;
-    json presentation_settings;
-    json ui_settings;
+    json presentation_settings = json::object();
+    json ui_settings = json::object();
     bool presentation_mode_active = false;
     std::string current_displayed_verse;
     std::chrono::system_clock::time_point timestamp;
@@ -37,8 +41,9 @@ struct RecoveryStats {
 class CrashRecoverySystem {
 private:
     std::string recovery_directory;
-    std::string current_session_file;
-    std::string backup_session_file;
+    std::string session_journal_file;
+    std::string current_session_file; // written by older versions, still read
+    std::string backup_session_file;  // likewise
     std::atomic<bool> is_initialized{false};
     std::mutex state_mutex;
     
@@ -46,6 +51,36 @@ private:
     SessionState current_session;
     std::string session_id;
     
+    // Saves append the fields changed since the last save to the journal
+    enum SessionField : uint32_t {
+        FIELD_TRANSLATION = 1 << 0,
+        FIELD_SEARCH_QUERY = 1 << 1,
+        FIELD_SEARCH_HISTORY = 1 << 2,
+        FIELD_SELECTED_VERSES = 1 << 3,
+        FIELD_FAVORITE_VERSES = 1 << 4,
+        FIELD_COLLECTIONS = 1 << 5,
+        FIELD_PRESENTATION_SETTINGS = 1 << 6,
+        FIELD_UI_SETTINGS = 1 << 7,
+        FIELD_PRESENTATION_MODE = 1 << 8,
+        ALL_FIELDS = (1 << 9) - 1
+    };
+    uint32_t dirty_fields = ALL_FIELDS;
+    
+    // Saves are written by a background thread so callers never wait on disk.
+    // A save hands over the changed fields; saves made while a write is in
+    // progress merge into one pending change. The writer owns the journal and
+    // a copy of the state as last written, from which it builds snapshots.
+    std::mutex writer_mutex;
+    std::condition_variable writer_wake;
+    std::condition_variable writer_idle;
+    json pending_fields;        // null when nothing is waiting
+    bool writer_busy = false;
+    bool writer_stopping = false;
+    std::thread writer;
+    std::unique_ptr<JournalFile> session_journal;
+    SessionState written_session;
+    bool journal_stale = false; // a failed write left the journal behind; rewrite it whole
+    
     // Recovery statistics
     RecoveryStats stats;
     std::mutex stats_mutex;
@@ -57,8 +92,17 @@ private:
     // Internal methods
     std::string generateSessionId();
     std::string getSessionFilePath(const std::string& session_id);
+    // Writes to a temporary file and renames it over filepath, so a crash
+    // mid-write leaves the previous file intact
     bool saveSessionToFile(const SessionState& state, const std::string& filepath);
     bool loadSessionFromFile(const std::string& filepath, SessionState& state);
+    bool loadSessionJournal(const std::string& filepath, SessionState& state);
+    // The running session's last saved state: the journal, else the older JSON files
+    bool loadCurrentSession(SessionState& state);
+    static json sessionFields(const SessionState& state, uint32_t fields);
+    static void applySessionFields(const json& fields, SessionState& state);
+    void writerLoop();
+    bool writeSessionFields(const json& fields);
     void cleanupOldSessions();
     bool validateSessionData(const SessionState& state);
     
@@ -71,7 +115,11 @@ public:
     void shutdown();
     
     // Session state management
+    // Queues the changes since the last save for the writer thread and
+    // returns without touching the disk; false if not initialized
     bool saveSessionState();
+    // Blocks until every queued save has been written
+    void flush();
     bool loadLastSession(std::string& session_data);
     bool hasRecoverableSession();
     
@@ -0,0 +1,141 @@
+#include "CrossReferenceGraph.h"
+#include <algorithm>
+#include <cmath>
+
+CrossReferenceGraph::NodeId CrossReferenceGraph::intern(const std::string& reference) {
+    auto it = node_ids.find(reference);
+    if (it != node_ids.end()) return it->second;
+    NodeId node = static_cast<NodeId>(node_names.size());
+    node_names.push_back(reference);
+    node_ids.emplace(reference, node);
+    return node;
+}
+
+CrossReferenceGraph::NodeId CrossReferenceGraph::find(const std::string& reference) const {
+    auto it = node_ids.find(reference);
+    return it == node_ids.end() ? INVALID_NODE : it->second;
+}
+
+uint8_t CrossReferenceGraph::internRelationship(const std::string& name) {
+    auto it = std::find(relationship_names.begin(), relationship_names.end(), name);
+    if (it != relationship_names.end()) return static_cast<uint8_t>(it - relationship_names.begin());
+    if (relationship_names.size() > UINT8_MAX) return RELATED;
+    relationship_names.push_back(name);
+    return static_cast<uint8_t>(relationship_names.size() - 1);
+}
+
+const std::string& CrossReferenceGraph::relationshipName(uint8_t relationship) const {
+    return relationship < relationship_names.size() ? relationship_names[relationship] : relationship_names[RELATED];
+}
+
+void CrossReferenceGraph::addEdge(const std::string& source, const std::string& target,
+                                  const std::string& relationship, double confidence) {
+    NodeId from = intern(source);
+    Edge edge;
+    edge.target = intern(target);
+    edge.relationship = internRelationship(relationship);
+    edge.confidence = static_cast<uint8_t>(std::lround(std::clamp(confidence, 0.0, 1.0) * 255.0));
+    std::erase(pending_removals, std::make_pair(from, edge.target));
+    pending_adds.push_back({from, edge});
+}
+
+void CrossReferenceGraph::removeEdge(const std::string& source, const std::string& target) {
+    NodeId from = find(source);
+    NodeId to = find(target);
+    if (from == INVALID_NODE || to == INVALID_NODE) return;
+    std::erase_if(pending_adds, [from, to](const PendingEdge& e) { return e.source == from && e.edge.target == to; });
+    pending_removals.emplace_back(from, to);
+}
+
+void CrossReferenceGraph::build() {
+    if (!hasPendingChanges() && offsets.size() == node_names.size() + 1) return;
+
+    // Existing rows first, so a queued edge for the same pair wins the dedup below
+    std::vector<PendingEdge> all;
+    all.reserve(edges.size() + pending_adds.size());
+    for (NodeId node = 0; node + 1 < offsets.size(); ++node) {
+        for (uint32_t e = offsets[node]; e < offsets[node + 1]; ++e) all.push_back({node, edges[e]});
+    }
+    all.insert(all.end(), pending_adds.begin(), pending_adds.end());
+    std::stable_sort(all.begin(), all.end(), [](const PendingEdge& a, const PendingEdge& b) {
+        return a.source != b.source ? a.source < b.source : a.edge.target < b.edge.target;
+    });
+
+    std::sort(pending_removals.begin(), pending_removals.end());
+    auto removed = [this](const PendingEdge& e) {
+        return std::binary_search(pending_removals.begin(), pending_removals.end(),
+                                  std::make_pair(e.source, e.edge.target));
+    };
+
+    edges.clear();
+    offsets.assign(node_names.size() + 1, 0);
+    for (size_t i = 0; i < all.size(); ++i) {
+        bool superseded = i + 1 < all.size() && all[i + 1].source == all[i].source &&
+                          all[i + 1].edge.target == all[i].edge.target;
+        if (superseded || removed(all[i])) continue;
+        edges.push_back(all[i].edge);
+        ++offsets[all[i].source + 1];
+    }
+    for (size_t node = 0; node < node_names.size(); ++node) offsets[node + 1] += offsets[node];
+    edges.shrink_to_fit();
+
+    pending_adds.clear();
+    pending_removals.clear();
+}
+
+void CrossReferenceGraph::clear() {
+    node_names.clear();
+    node_ids.clear();
+    relationship_names.assign(1, "related");
+    offsets.assign(1, 0);
+    edges.clear();
+    pending_adds.clear();
+    pending_removals.clear();
+}
+
+std::span<const CrossReferenceGraph::Edge> CrossReferenceGraph::neighbors(NodeId node) const {
+    if (node + 1 >= offsets.size()) return {};
+    return std::span<const Edge>(edges).subspan(offsets[node], offsets[node + 1] - offsets[node]);
+}
+
+std::vector<CrossReferenceGraph::Hop> CrossReferenceGraph::twoHop(NodeId node, size_t max_results) const {
+    std::span<const Edge> direct = neighbors(node);
+    auto isDirect = [&direct](NodeId target) {
+        auto it = std::lower_bound(direct.begin(), direct.end(), target,
+                                   [](const Edge& e, NodeId id) { return e.target < id; });
+        return it != direct.end() && it->target == target;
+    };
+
+    std::vector<Hop> hops;
+    for (const Edge& first : direct) {
+        for (const Edge& second : neighbors(first.target)) {
+            if (second.target == node || isDirect(second.target)) continue;
+            hops.push_back({second.target, first.target, first.weight() * second.weight()});
+        }
+    }
+
+    // Keep the best path to each verse
+    std::sort(hops.begin(), hops.end(), [](const Hop& a, const Hop& b) {
+        return a.target != b.target ? a.target < b.target : a.score > b.score;
+    });
+    hops.erase(std::unique(hops.begin(), hops.end(),
+                           [](const Hop& a, const Hop& b) { return a.target == b.target; }),
+               hops.end());
+
+    auto byScore = [](const Hop& a, const Hop& b) {
+        return a.score != b.score ? a.score > b.score : a.target < b.target;
+    };
+    if (hops.size() > max_results) {
+        std::partial_sort(hops.begin(), hops.begin() + max_results, hops.end(), byScore);
+        hops.resize(max_results);
+    } else {
+        std::sort(hops.begin(), hops.end(), byScore);
+    }
+    return hops;
+}
+
+std::vector<uint32_t> CrossReferenceGraph::inDegrees() const {
+    std::vector<uint32_t> degrees(node_names.size(), 0);
+    for (const Edge& edge : edges) ++degrees[edge.target];
+    return degrees;
+}
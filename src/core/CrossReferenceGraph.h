@@ -0,0 +1,81 @@
+#ifndef CROSSREFERENCEGRAPH_H
+#define CROSSREFERENCEGRAPH_H
+
+#include <string>
+#include <vector>
+#include <span>
+#include <unordered_map>
+#include <cstdint>
+
+// Directed verse-to-verse links in compressed sparse row form. References
+// are interned into dense node ids, and the edges of node n are the slice
+// edges[offsets[n] .. offsets[n + 1]), sorted by target, so a neighbour
+// lookup touches only that node's edges. Relationship and confidence are
+// packed into a byte each.
+//
+// The rows are immutable: additions and removals are queued and merged by
+// build(), so bulk imports should queue everything and build once.
+class CrossReferenceGraph {
+public:
+    using NodeId = uint32_t;
+    static constexpr NodeId INVALID_NODE = UINT32_MAX;
+    static constexpr uint8_t RELATED = 0; // relationship used once the name table is full
+
+    struct Edge {
+        NodeId target;
+        uint8_t relationship; // index into relationshipName()
+        uint8_t confidence;   // confidence * 255, rounded
+
+        double weight() const { return confidence / 255.0; }
+    };
+
+    // A verse reached through one intermediate verse
+    struct Hop {
+        NodeId target;
+        NodeId via;
+        double score; // product of both edges' confidences
+    };
+
+private:
+    struct PendingEdge {
+        NodeId source;
+        Edge edge;
+    };
+
+    std::vector<std::string> node_names;
+    std::unordered_map<std::string, NodeId> node_ids;
+    std::vector<std::string> relationship_names{"related"};
+
+    std::vector<uint32_t> offsets{0}; // one per node plus one; nodes interned since build() have no row yet
+    std::vector<Edge> edges;
+    std::vector<PendingEdge> pending_adds;
+    std::vector<std::pair<NodeId, NodeId>> pending_removals;
+
+public:
+    NodeId intern(const std::string& reference);
+    NodeId find(const std::string& reference) const; // INVALID_NODE if never linked
+    const std::string& reference(NodeId node) const { return node_names[node]; }
+    uint8_t internRelationship(const std::string& name);
+    const std::string& relationshipName(uint8_t relationship) const;
+
+    // Queue a link; a later one between the same verses replaces it
+    void addEdge(const std::string& source, const std::string& target,
+                 const std::string& relationship, double confidence);
+    void removeEdge(const std::string& source, const std::string& target);
+    // Merge queued changes into the rows
+    void build();
+    void clear();
+
+    std::span<const Edge> neighbors(NodeId node) const;
+    // Verses two links away, excluding node and its direct neighbours, best score
+    // first; a verse reachable several ways keeps its best path
+    std::vector<Hop> twoHop(NodeId node, size_t max_results) const;
+    // Incoming links per node
+    std::vector<uint32_t> inDegrees() const;
+
+    size_t nodeCount() const { return node_names.size(); }
+    size_t edgeCount() const { return edges.size(); }
+    bool hasPendingChanges() const { return !pending_adds.empty() || !pending_removals.empty(); }
+};
+
+#endif // CROSSREFERENCEGRAPH_H
@@ -1,5 +1,7 @@
 #include "CrossReferenceSystem.h"
 #include <iostream>
+#include <algorithm>
+#include <numeric>
 
 CrossReferenceSystem::CrossReferenceSystem() {
     initializeCommonCrossReferences();
@@ -29,13 +31,21 @@ void CrossReferenceSystem::initializeParallelPassages() {
 
 std::vector<CrossReference> CrossReferenceSystem::findCrossReferences(
     const std::string& verseKey, 
-    [[maybe_unused]] const std::unordered_map<std::string, std::string>& allVerses) const {
+    [[maybe_unused]] const VerseTextView& allVerses) const {
     
     std::vector<CrossReference> results;
+    CrossReferenceGraph::NodeId node = graph.find(verseKey);
+    if (node == CrossReferenceGraph::INVALID_NODE) return results;
     
-    auto it = crossReferences.find(verseKey);
-    if (it != crossReferences.end()) {
-        results = it->second;
+    std::span<const CrossReferenceGraph::Edge> edges = graph.neighbors(node);
+    results.reserve(edges.size());
+    for (const auto& edge : edges) {
+        CrossReference ref;
+        ref.sourceVerse = verseKey;
+        ref.targetVerse = graph.reference(edge.target);
+        ref.relationship = graph.relationshipName(edge.relationship);
+        ref.confidence = edge.weight();
+        results.push_back(std::move(ref));
     }
     
     return results;
@@ -43,27 +53,99 @@ std::vector<CrossReference> CrossReferenceSystem::findCrossReferences(
 
 std::vector<std::string> CrossReferenceSystem::findParallelPassages(
     const std::string& verseKey,
-    [[maybe_unused]] const std::unordered_map<std::string, std::string>& allVerses) const {
+    [[maybe_unused]] const VerseTextView& allVerses) const {
     
     std::vector<std::string> results;
+    CrossReferenceGraph::NodeId node = graph.find(verseKey);
+    if (node == CrossReferenceGraph::INVALID_NODE) return results;
     
-    auto it = parallelPassages.find(verseKey);
-    if (it != parallelPassages.end()) {
-        results = it->second;
+    for (const auto& edge : graph.neighbors(node)) {
+        if (graph.relationshipName(edge.relationship) == "parallel") {
+            results.push_back(graph.reference(edge.target));
+        }
     }
     
     return results;
 }
 
+std::vector<CrossReferenceGraph::Hop> CrossReferenceSystem::findIndirectReferences(
+    const std::string& verseKey, size_t maxResults) const {
+    
+    CrossReferenceGraph::NodeId node = graph.find(verseKey);
+    if (node == CrossReferenceGraph::INVALID_NODE) return {};
+    return graph.twoHop(node, maxResults);
+}
+
 std::vector<std::string> CrossReferenceSystem::findThematicMatches(
-    [[maybe_unused]] const std::string& verseKey,
-    [[maybe_unused]] const std::unordered_map<std::string, std::string>& allVerses) const {
+    const std::string& verseKey, const VerseStore& store, const MinHashIndex& similarity,
+    double threshold, size_t maxResults) const {
     
     std::vector<std::string> results;
-    // Basic implementation - would be enhanced with actual thematic analysis
+    VerseId id = store.findByReference(verseKey);
+    if (id == INVALID_VERSE_ID) return results;
+    
+    for (const auto& match : similarity.findSimilar(store, id, threshold, maxResults)) {
+        results.push_back(store.reference(match.first));
+    }
     return results;
 }
 
+std::vector<ParallelPassage> CrossReferenceSystem::findParallelPassageGroups(
+    const std::vector<std::string>& verseKeys, const VerseStore& store, const MinHashIndex& similarity,
+    double threshold) const {
+    
+    std::vector<VerseId> members;
+    members.reserve(verseKeys.size());
+    for (const auto& key : verseKeys) {
+        VerseId id = store.findByReference(key);
+        if (id != INVALID_VERSE_ID) members.push_back(id);
+    }
+    std::sort(members.begin(), members.end());
+    members.erase(std::unique(members.begin(), members.end()), members.end());
+    
+    // Union-find over the similar pairs, indexed by position in members
+    std::vector<size_t> parent(members.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto root = [&parent](size_t i) {
+        while (parent[i] != i) i = parent[i] = parent[parent[i]];
+        return i;
+    };
+    auto position = [&members](VerseId id) {
+        return static_cast<size_t>(std::lower_bound(members.begin(), members.end(), id) - members.begin());
+    };
+    
+    auto pairs = similarity.findSimilarPairs(store, members, threshold);
+    for (const auto& pair : pairs) {
+        parent[root(position(pair.first))] = root(position(pair.second));
+    }
+    
+    std::unordered_map<size_t, size_t> groupOf; // root -> index in groups
+    std::vector<ParallelPassage> groups;
+    std::vector<size_t> pairCounts;
+    for (const auto& pair : pairs) {
+        size_t r = root(position(pair.first));
+        auto [it, inserted] = groupOf.emplace(r, groups.size());
+        if (inserted) {
+            groups.push_back({{}, "parallel", 0.0});
+            pairCounts.push_back(0);
+        }
+        groups[it->second].coherenceScore += pair.similarity;
+        ++pairCounts[it->second];
+    }
+    for (size_t i = 0; i < members.size(); ++i) {
+        auto it = groupOf.find(root(i));
+        if (it != groupOf.end()) groups[it->second].verses.push_back(store.reference(members[i]));
+    }
+    for (size_t g = 0; g < groups.size(); ++g) {
+        groups[g].coherenceScore /= static_cast<double>(pairCounts[g]);
+    }
+    
+    std::sort(groups.begin(), groups.end(), [](const ParallelPassage& a, const ParallelPassage& b) {
+        return a.coherenceScore > b.coherenceScore;
+    });
+    return groups;
+}
+
 std::vector<std::string> CrossReferenceSystem::expandContext(
     [[maybe_unused]] const std::string& verseKey, [[maybe_unused]] int beforeCount, [[maybe_unused]] int afterCount) const {
     
@@ -104,19 +186,58 @@ void CrossReferenceSystem::addCrossReference(
     const std::string& source, const std::string& target, 
     const std::string& relationship, double confidence) {
     
-    CrossReference ref;
-    ref.sourceVerse = source;
-    ref.targetVerse = target;
-    ref.relationship = relationship;
-    ref.confidence = confidence;
-    
-    crossReferences[source].push_back(ref);
+    graph.addEdge(source, target, relationship, confidence);
+    graph.build();
+}
+
+void CrossReferenceSystem::removeCrossReference(const std::string& source, const std::string& target) {
+    graph.removeEdge(source, target);
+    graph.build();
+}
+
+void CrossReferenceSystem::loadCrossReferenceData(const std::string& jsonData) {
+    try {
+        json references = json::parse(jsonData);
+        if (!references.is_array()) return;
+        
+        for (const auto& ref : references) {
+            if (!ref.contains("source") || !ref.contains("target")) continue;
+            graph.addEdge(ref["source"].get<std::string>(), ref["target"].get<std::string>(),
+                          ref.value("relationship", std::string("related")), ref.value("confidence", 0.8));
+        }
+    } catch (const json::exception& e) {
+        // Keep whatever parsed before the error
+    }
+    graph.build();
+}
+
+std::string CrossReferenceSystem::exportCrossReferenceData() const {
+    json references = json::array();
+    for (CrossReferenceGraph::NodeId node = 0; node < graph.nodeCount(); ++node) {
+        for (const auto& edge : graph.neighbors(node)) {
+            references.push_back({
+                {"source", graph.reference(node)},
+                {"target", graph.reference(edge.target)},
+                {"relationship", graph.relationshipName(edge.relationship)},
+                {"confidence", edge.weight()}
+            });
+        }
+    }
+    return references.dump(2);
 }
 
 int CrossReferenceSystem::getCrossReferenceCount() const {
-    int count = 0;
-    for (const auto& pair : crossReferences) {
-        count += pair.second.size();
+    return static_cast<int>(graph.edgeCount());
+}
+
+std::vector<std::pair<std::string, int>> CrossReferenceSystem::getMostReferencedVerses() const {
+    std::vector<uint32_t> degrees = graph.inDegrees();
+    std::vector<std::pair<std::string, int>> verses;
+    for (CrossReferenceGraph::NodeId node = 0; node < degrees.size(); ++node) {
+        if (degrees[node] > 0) verses.emplace_back(graph.reference(node), static_cast<int>(degrees[node]));
     }
-    return count;
+    std::sort(verses.begin(), verses.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    return verses;
 }
\ No newline at end of file
@@ -6,6 +6,9 @@
 #include <unordered_map>
 #include <unordered_set>
 #include "nlohmann/json.hpp"
+#include "VerseTextView.h"
+#include "CrossReferenceGraph.h"
+#include "MinHashIndex.h"
 
 using json = nlohmann::json;
 
@@ -25,10 +28,9 @@ struct ParallelPassage {
 
 class CrossReferenceSystem {
 private:
-    // Cross-reference mappings
-    std::unordered_map<std::string, std::vector<CrossReference>> crossReferences;
+    // Cross-references and parallel passages ("parallel" links) as one graph
+    CrossReferenceGraph graph;
     std::unordered_map<std::string, std::vector<std::string>> thematicGroups;
-    std::unordered_map<std::string, std::vector<std::string>> parallelPassages;
     
     // Common biblical themes and their keywords
     std::unordered_map<std::string, std::vector<std::string>> biblicalThemes;
@@ -44,20 +46,30 @@ private:
     std::vector<std::string> findCommonKeywords(const std::string& text1, const std::string& text2) const;
     
 public:
+    // Word-pair overlap (Jaccard) from which two verses count as parallel
+    static constexpr double PARALLEL_SIMILARITY = 0.4;
+
     CrossReferenceSystem();
     
     // Cross-reference discovery
     std::vector<CrossReference> findCrossReferences(const std::string& verseKey, 
-                                                   const std::unordered_map<std::string, std::string>& allVerses) const;
+                                                   const VerseTextView& allVerses) const;
     std::vector<std::string> findParallelPassages(const std::string& verseKey,
-                                                 const std::unordered_map<std::string, std::string>& allVerses) const;
-    std::vector<std::string> findThematicMatches(const std::string& verseKey,
-                                               const std::unordered_map<std::string, std::string>& allVerses) const;
+                                                 const VerseTextView& allVerses) const;
+    // Verses linked to the verse's own links but not to it, best chain first
+    std::vector<CrossReferenceGraph::Hop> findIndirectReferences(const std::string& verseKey, size_t maxResults = 20) const;
+    const CrossReferenceGraph& referenceGraph() const { return graph; }
+    // Near-duplicate verses of one translation, looked up in its MinHash index
+    std::vector<std::string> findThematicMatches(const std::string& verseKey, const VerseStore& store,
+                                               const MinHashIndex& similarity,
+                                               double threshold = PARALLEL_SIMILARITY, size_t maxResults = 20) const;
     
     // Relationship analysis
     std::string determineRelationshipType(const std::string& verse1, const std::string& verse2) const;
+    // Clusters of mutually similar verses among verseKeys, most coherent first
     std::vector<ParallelPassage> findParallelPassageGroups(const std::vector<std::string>& verseKeys,
-                                                          const std::unordered_map<std::string, std::string>& allVerses) const;
+                                                          const VerseStore& store, const MinHashIndex& similarity,
+                                                          double threshold = PARALLEL_SIMILARITY) const;
     
     // Context expansion
     std::vector<std::string> expandContext(const std::string& verseKey, int beforeCount = 2, int afterCount = 2) const;
@@ -65,7 +77,7 @@ public:
     
     // Theme-based discovery
     std::vector<std::string> findVersesByTheme(const std::string& theme,
-                                             const std::unordered_map<std::string, std::string>& allVerses) const;
+                                             const VerseTextView& allVerses) const;
     std::vector<std::string> getRelatedThemes(const std::string& theme) const;
     
     // Custom cross-reference management
@@ -74,7 +86,8 @@ public:
     void removeCrossReference(const std::string& source, const std::string& target);
     void addThematicGroup(const std::string& theme, const std::vector<std::string>& verses);
     
-    // Import/Export functionality
+    // Import/Export functionality: a JSON array of {source, target, relationship, confidence};
+    // loading adds to the links already present and rebuilds the graph once
     void loadCrossReferenceData(const std::string& jsonData);
     std::string exportCrossReferenceData() const;
     
@@ -0,0 +1,128 @@
+#include "DegradationPolicy.h"
+#include "HealthMonitor.h"
+#include <algorithm>
+
+namespace {
+std::string percentReason(const char* what, double percent) {
+    return std::string(what) + " at " + std::to_string(static_cast<int>(percent)) + "%";
+}
+}
+
+DegradationLevel DegradationPolicy::pressureLevel(const PerformanceMetrics& metrics, std::string& reason) const {
+    struct Signal {
+        const char* what;
+        double value;
+        double reduced;
+        double minimal;
+    };
+    const Signal signals[] = {
+        {"CPU", metrics.cpu_usage, thresholds.cpu_reduced, thresholds.cpu_minimal},
+        {"memory", metrics.memory_usage_percent, thresholds.memory_reduced, thresholds.memory_minimal},
+        {"slow frames", metrics.frame_time_violation_percent,
+         thresholds.frame_violations_reduced, thresholds.frame_violations_minimal},
+    };
+
+    // The worst signal decides; it also names the reason
+    DegradationLevel worst = DegradationLevel::NORMAL;
+    for (const Signal& signal : signals) {
+        DegradationLevel level = signal.value >= signal.minimal ? DegradationLevel::MINIMAL
+                               : signal.value >= signal.reduced ? DegradationLevel::REDUCED
+                               : DegradationLevel::NORMAL;
+        if (level > worst) {
+            worst = level;
+            reason = percentReason(signal.what, signal.value);
+        }
+    }
+    return worst;
+}
+
+DegradationLevel DegradationPolicy::evaluate(const PerformanceMetrics& metrics) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::string why;
+    DegradationLevel target = pressureLevel(metrics, why);
+    if (target > measured) {
+        // Shed straight to what the load calls for once it has lasted
+        under_count = 0;
+        if (++over_count >= thresholds.escalate_after) {
+            measured = target;
+            over_count = 0;
+            last_reason = why;
+        }
+    } else if (target < measured) {
+        // Restore one step at a time, so recovery does not bring the load back at once
+        over_count = 0;
+        if (++under_count >= thresholds.recover_after) {
+            measured = static_cast<DegradationLevel>(static_cast<int>(measured) - 1);
+            under_count = 0;
+            if (measured == DegradationLevel::NORMAL) last_reason.clear();
+        }
+    } else {
+        over_count = 0;
+        under_count = 0;
+    }
+
+    publish();
+    return current.load(std::memory_order_relaxed);
+}
+
+void DegradationPolicy::setFloor(DegradationLevel level, const std::string& reason) {
+    std::lock_guard<std::mutex> lock(mutex);
+    floor = level;
+    if (level > measured && !reason.empty()) last_reason = reason;
+    publish();
+}
+
+void DegradationPolicy::setThresholds(const Thresholds& limits) {
+    std::lock_guard<std::mutex> lock(mutex);
+    thresholds = limits;
+    over_count = 0;
+    under_count = 0;
+}
+
+std::string DegradationPolicy::reason() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return last_reason;
+}
+
+void DegradationPolicy::publish() {
+    DegradationLevel effective = std::max(measured, floor);
+    if (current.load(std::memory_order_relaxed) != effective) {
+        current.store(effective, std::memory_order_release);
+        changes.fetch_add(1, std::memory_order_acq_rel);
+    }
+}
+
+DegradationProfile DegradationPolicy::profile(DegradationLevel level) {
+    DegradationProfile profile;
+    switch (level) {
+        case DegradationLevel::NORMAL:
+            break;
+        case DegradationLevel::REDUCED:
+            profile.fuzzy_search = false;
+            profile.semantic_search = false;
+            profile.topic_analysis = false;
+            profile.animated_effects = false;
+            profile.cache_budget_fraction = 0.5;
+            profile.max_results = 50;
+            break;
+        case DegradationLevel::MINIMAL:
+            profile.fuzzy_search = false;
+            profile.semantic_search = false;
+            profile.topic_analysis = false;
+            profile.animated_effects = false;
+            profile.cache_budget_fraction = 0.25;
+            profile.max_results = 20;
+            break;
+    }
+    return profile;
+}
+
+const char* DegradationPolicy::name(DegradationLevel level) {
+    switch (level) {
+        case DegradationLevel::NORMAL: return "normal";
+        case DegradationLevel::REDUCED: return "reduced";
+        case DegradationLevel::MINIMAL: return "minimal";
+    }
+    return "unknown";
+}
@@ -0,0 +1,84 @@
+#ifndef DEGRADATIONPOLICY_H
+#define DEGRADATIONPOLICY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+
+struct PerformanceMetrics;
+
+// How much optional work the application does. Reference lookup and verse
+// display run at every level; each step up sheds more of the rest.
+enum class DegradationLevel {
+    NORMAL = 0,
+    REDUCED = 1,
+    MINIMAL = 2
+};
+
+// What is allowed to run at one level
+struct DegradationProfile {
+    bool fuzzy_search = true;
+    bool semantic_search = true;
+    bool topic_analysis = true;
+    bool animated_effects = true;
+    double cache_budget_fraction = 1.0; // of the CacheManager's budget
+    size_t max_results = std::numeric_limits<size_t>::max(); // per search
+};
+
+// Load-shedding policy fed by HealthMonitor samples. CPU, memory pressure
+// or frame-time violations over a threshold for escalate_after consecutive
+// samples raise the level one step; recover_after consecutive healthy
+// samples lower it one step, so a single spike neither sheds nor restores.
+// A floor, set from the reliability level, holds the level at or above it.
+// Samples arrive on the monitor's thread; consumers poll generation() and
+// apply profile(level()) on their own.
+class DegradationPolicy {
+public:
+    struct Thresholds {
+        double cpu_reduced = 85.0;    // percent of all cores, as HealthMonitor measures it
+        double cpu_minimal = 95.0;
+        double memory_reduced = 85.0; // percent of system memory in use
+        double memory_minimal = 95.0;
+        double frame_violations_reduced = 10.0; // percent of frames over budget
+        double frame_violations_minimal = 30.0;
+        int escalate_after = 2;
+        int recover_after = 6;
+    };
+
+private:
+    mutable std::mutex mutex;
+    Thresholds thresholds;
+    DegradationLevel measured = DegradationLevel::NORMAL; // from samples alone
+    DegradationLevel floor = DegradationLevel::NORMAL;
+    int over_count = 0;  // consecutive samples asking for more than measured
+    int under_count = 0; // consecutive samples asking for less
+    std::string last_reason;
+
+    std::atomic<DegradationLevel> current{DegradationLevel::NORMAL};
+    std::atomic<uint64_t> changes{0};
+
+    DegradationLevel pressureLevel(const PerformanceMetrics& metrics, std::string& reason) const;
+    void publish(); // callers hold mutex
+
+public:
+    DegradationPolicy() = default;
+    explicit DegradationPolicy(const Thresholds& limits) : thresholds(limits) {}
+
+    // Feed one health sample; returns the level in effect afterwards
+    DegradationLevel evaluate(const PerformanceMetrics& metrics);
+    void setFloor(DegradationLevel level, const std::string& reason = "");
+    void setThresholds(const Thresholds& limits);
+
+    DegradationLevel level() const { return current.load(std::memory_order_acquire); }
+    // Bumped on every level change, so a poller applies each change once
+    uint64_t generation() const { return changes.load(std::memory_order_acquire); }
+    std::string reason() const;
+
+    static DegradationProfile profile(DegradationLevel level);
+    static const char* name(DegradationLevel level);
+};
+
+#endif // DEGRADATIONPOLICY_H
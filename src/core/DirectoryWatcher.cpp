@@ -0,0 +1,306 @@
+#include "DirectoryWatcher.h"
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <set>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+#if defined(_WIN32) || defined(__linux__)
+// Names seen since the last report, and when the first and latest arrived
+class PendingNames {
+public:
+    explicit PendingNames(std::chrono::milliseconds settle) : settle(settle) {}
+
+    bool empty() const { return names.empty(); }
+    void add(std::string name) {
+        Clock::time_point now = Clock::now();
+        if (names.empty()) first = now;
+        last = now;
+        names.insert(std::move(name));
+    }
+    Clock::time_point due() const {
+        return std::min(last + settle, first + settle * DirectoryWatcher::MAX_SETTLE_FACTOR);
+    }
+    // Until due, for a wait that should end then; never negative
+    long long millisecondsLeft() const {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(due() - Clock::now()).count();
+        return std::max<long long>(left + 1, 0);
+    }
+    std::vector<std::string> take() {
+        std::vector<std::string> taken(names.begin(), names.end());
+        names.clear();
+        return taken;
+    }
+
+private:
+    std::chrono::milliseconds settle;
+    std::set<std::string> names;
+    Clock::time_point first;
+    Clock::time_point last;
+};
+#endif
+
+} // namespace
+
+DirectoryWatcher::DirectoryWatcher() = default;
+
+DirectoryWatcher::~DirectoryWatcher() {
+    stop();
+}
+
+bool DirectoryWatcher::start(const std::string& watched, Callback callback, std::chrono::milliseconds settle_time) {
+    if (worker.joinable()) {
+        if (running && watched == directory) {
+            return true;
+        }
+        stop();
+    }
+    directory = watched;
+    on_change = std::move(callback);
+    settle = settle_time;
+    if (!open()) {
+        return false;
+    }
+    stopping = false;
+    running = true;
+    worker = std::thread([this] { run(); });
+    return true;
+}
+
+void DirectoryWatcher::stop() {
+    if (!worker.joinable()) {
+        return;
+    }
+    stopping = true;
+#ifdef _WIN32
+    SetEvent(static_cast<HANDLE>(stop_event));
+#elif defined(__linux__)
+    char byte = 1;
+    if (write(wake_fds[1], &byte, 1) < 0) {
+        std::cerr << "Cannot wake the directory watcher" << std::endl;
+    }
+#else
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex);
+    }
+    stop_signal.notify_all();
+#endif
+    worker.join();
+    close();
+    running = false;
+}
+
+std::vector<std::string> DirectoryWatcher::listNames() const {
+    std::vector<std::string> names;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (entry.is_regular_file(ec)) names.push_back(entry.path().filename().string());
+    }
+    return names;
+}
+
+#ifdef _WIN32
+
+bool DirectoryWatcher::open() {
+    HANDLE handle = CreateFileW(std::filesystem::path(directory).wstring().c_str(), FILE_LIST_DIRECTORY,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                                FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        std::cerr << "Cannot watch " << directory << ": error " << GetLastError() << std::endl;
+        return false;
+    }
+    directory_handle = handle;
+    stop_event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    return true;
+}
+
+void DirectoryWatcher::close() {
+    if (directory_handle) CloseHandle(static_cast<HANDLE>(directory_handle));
+    if (stop_event) CloseHandle(static_cast<HANDLE>(stop_event));
+    directory_handle = stop_event = nullptr;
+}
+
+void DirectoryWatcher::run() {
+    HANDLE handle = static_cast<HANDLE>(directory_handle);
+    const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+    alignas(DWORD) char buffer[16 * 1024];
+    OVERLAPPED overlapped{};
+    overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    PendingNames pending(settle);
+    bool reading = false;
+    for (;;) {
+        if (!reading) {
+            ResetEvent(overlapped.hEvent);
+            if (!ReadDirectoryChangesW(handle, buffer, sizeof(buffer), FALSE, filter, nullptr, &overlapped, nullptr)) {
+                std::cerr << "Stopped watching " << directory << ": error " << GetLastError() << std::endl;
+                break;
+            }
+            reading = true;
+        }
+        HANDLE handles[2] = {overlapped.hEvent, static_cast<HANDLE>(stop_event)};
+        DWORD timeout = pending.empty() ? INFINITE : static_cast<DWORD>(pending.millisecondsLeft());
+        DWORD woken = WaitForMultipleObjects(2, handles, FALSE, timeout);
+        if (woken != WAIT_OBJECT_0 && woken != WAIT_TIMEOUT) {
+            break;
+        }
+        if (woken == WAIT_OBJECT_0) {
+            reading = false;
+            DWORD bytes = 0;
+            if (!GetOverlappedResult(handle, &overlapped, &bytes, FALSE)) {
+                std::cerr << "Stopped watching " << directory << ": error " << GetLastError() << std::endl;
+                break;
+            }
+            if (bytes == 0) {
+                // The buffer overflowed and the changes were dropped
+                for (auto& name : listNames()) pending.add(std::move(name));
+            }
+            for (DWORD offset = 0; bytes > 0;) {
+                auto* info = reinterpret_cast<FILE_NOTIFY_INFORMATION*>(buffer + offset);
+                int wide_length = static_cast<int>(info->FileNameLength / sizeof(WCHAR));
+                int length = WideCharToMultiByte(CP_UTF8, 0, info->FileName, wide_length, nullptr, 0, nullptr, nullptr);
+                std::string name(static_cast<size_t>(length), '\0');
+                WideCharToMultiByte(CP_UTF8, 0, info->FileName, wide_length, name.data(), length, nullptr, nullptr);
+                pending.add(std::move(name));
+                if (info->NextEntryOffset == 0) break;
+                offset += info->NextEntryOffset;
+            }
+        }
+        if (!pending.empty() && Clock::now() >= pending.due()) {
+            on_change(pending.take());
+        }
+    }
+    if (reading) {
+        DWORD bytes = 0;
+        CancelIoEx(handle, &overlapped);
+        GetOverlappedResult(handle, &overlapped, &bytes, TRUE);
+    }
+    CloseHandle(overlapped.hEvent);
+    running = false;
+}
+
+#elif defined(__linux__)
+
+bool DirectoryWatcher::open() {
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    const uint32_t mask = IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                          IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+    if (inotify_fd < 0 || inotify_add_watch(inotify_fd, directory.c_str(), mask) < 0 ||
+        pipe2(wake_fds, O_CLOEXEC) != 0) {
+        std::cerr << "Cannot watch " << directory << ": " << std::strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    return true;
+}
+
+void DirectoryWatcher::close() {
+    for (int* fd : {&inotify_fd, &wake_fds[0], &wake_fds[1]}) {
+        if (*fd >= 0) ::close(*fd);
+        *fd = -1;
+    }
+}
+
+void DirectoryWatcher::run() {
+    alignas(inotify_event) char buffer[16 * 1024];
+    PendingNames pending(settle);
+    bool gone = false;
+    while (!gone) {
+        pollfd fds[2] = {{inotify_fd, POLLIN, 0}, {wake_fds[0], POLLIN, 0}};
+        int timeout = pending.empty() ? -1 : static_cast<int>(pending.millisecondsLeft());
+        int ready = ::poll(fds, 2, timeout);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready < 0 || fds[1].revents) break;
+        if (fds[0].revents & POLLIN) {
+            ssize_t count = read(inotify_fd, buffer, sizeof(buffer));
+            if (count < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+            if (count <= 0) break;
+            for (char* at = buffer; at < buffer + count;) {
+                auto* event = reinterpret_cast<inotify_event*>(at);
+                if (event->mask & IN_Q_OVERFLOW) {
+                    for (auto& name : listNames()) pending.add(std::move(name));
+                } else if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+                    gone = true;
+                } else if (event->len > 0 && !(event->mask & IN_ISDIR)) {
+                    pending.add(event->name);
+                }
+                at += sizeof(inotify_event) + event->len;
+            }
+        }
+        if (!pending.empty() && (gone || Clock::now() >= pending.due())) {
+            on_change(pending.take());
+        }
+    }
+    if (gone) {
+        std::cerr << "Stopped watching " << directory << ": it was removed or moved" << std::endl;
+    }
+    running = false;
+}
+
+#else
+
+bool DirectoryWatcher::open() {
+    std::error_code ec;
+    if (!std::filesystem::is_directory(directory, ec)) {
+        std::cerr << "Cannot watch " << directory << ": not a directory" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void DirectoryWatcher::close() {}
+
+void DirectoryWatcher::run() {
+    using Stamp = std::pair<uintmax_t, std::filesystem::file_time_type>;
+    auto scan = [this]() {
+        std::map<std::string, Stamp> stamps;
+        std::error_code ec;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+            if (!entry.is_regular_file(ec)) continue;
+            stamps[entry.path().filename().string()] = {entry.file_size(ec), entry.last_write_time(ec)};
+        }
+        return stamps;
+    };
+    std::map<std::string, Stamp> seen = scan();
+    std::set<std::string> pending;
+    std::unique_lock<std::mutex> lock(stop_mutex);
+    while (!stop_signal.wait_for(lock, POLL_INTERVAL, [this] { return stopping.load(); })) {
+        std::map<std::string, Stamp> current = scan();
+        std::set<std::string> changed;
+        for (const auto& [name, stamp] : current) {
+            auto previous = seen.find(name);
+            if (previous == seen.end() || previous->second != stamp) changed.insert(name);
+        }
+        for (const auto& entry : seen) {
+            if (!current.count(entry.first)) changed.insert(entry.first);
+        }
+        seen = std::move(current);
+        // Reported once a scan finds nothing new: the files have settled
+        if (!changed.empty()) {
+            pending.insert(changed.begin(), changed.end());
+        } else if (!pending.empty()) {
+            std::vector<std::string> names(pending.begin(), pending.end());
+            pending.clear();
+            lock.unlock();
+            on_change(names);
+            lock.lock();
+        }
+    }
+    running = false;
+}
+
+#endif
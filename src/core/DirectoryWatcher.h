@@ -0,0 +1,73 @@
+#ifndef DIRECTORYWATCHER_H
+#define DIRECTORYWATCHER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Reports the files of one directory (not its subdirectories) that were
+// written, added, removed or renamed, by name. Events come from inotify on
+// Linux and ReadDirectoryChangesW on Windows; elsewhere the directory is
+// listed every POLL_INTERVAL and compared by size and mtime.
+//
+// Editors and copies write a file in several steps, so names are gathered
+// until the directory has been quiet for the settle time and then reported
+// together, once each; a directory that never goes quiet is still reported
+// every MAX_SETTLE_FACTOR settle times. on_change runs on the watcher's own
+// thread and may take as long as it likes: changes made meanwhile are
+// reported when it returns. If the kernel drops events, every file present
+// is reported instead, and removals in that window are missed.
+class DirectoryWatcher {
+public:
+    using Callback = std::function<void(const std::vector<std::string>& names)>;
+
+    static constexpr auto DEFAULT_SETTLE = std::chrono::milliseconds(500);
+    static constexpr int MAX_SETTLE_FACTOR = 10;
+    static constexpr auto POLL_INTERVAL = std::chrono::seconds(2);
+
+    DirectoryWatcher();
+    ~DirectoryWatcher();
+
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+    // False if the directory cannot be watched. Restarts on directory if
+    // already watching another one; not from on_change.
+    bool start(const std::string& directory, Callback on_change,
+               std::chrono::milliseconds settle = DEFAULT_SETTLE);
+    // Waits for an on_change under way to return
+    void stop();
+    bool isRunning() const { return running.load(); }
+    const std::string& getDirectory() const { return directory; }
+
+private:
+    std::string directory;
+    Callback on_change;
+    std::chrono::milliseconds settle = DEFAULT_SETTLE;
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<bool> stopping{false};
+#ifdef _WIN32
+    void* directory_handle = nullptr; // HANDLE
+    void* stop_event = nullptr;       // HANDLE
+#elif defined(__linux__)
+    int inotify_fd = -1;
+    int wake_fds[2] = {-1, -1}; // written to stop the worker
+#else
+    std::mutex stop_mutex;
+    std::condition_variable stop_signal;
+#endif
+
+    bool open();
+    void close();
+    void run();
+    // Every regular file's name, for when events were dropped
+    std::vector<std::string> listNames() const;
+};
+
+#endif // DIRECTORYWATCHER_H
@@ -0,0 +1,146 @@
+#include "EditDistance.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+
+namespace {
+
+constexpr int UNBOUNDED = std::numeric_limits<int>::max() / 2;
+
+// Myers/Hyyro over a compiled pattern of 1..64 characters
+int myersDistance(const uint64_t* peq, size_t pattern_length, std::string_view text, int max_distance) {
+    const uint64_t last_row = uint64_t(1) << (pattern_length - 1);
+    uint64_t pv = ~uint64_t(0); // vertical +1 deltas
+    uint64_t mv = 0;            // vertical -1 deltas
+    int score = static_cast<int>(pattern_length);
+    const size_t n = text.size();
+
+    for (size_t j = 0; j < n; ++j) {
+        uint64_t eq = peq[static_cast<unsigned char>(text[j])];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        if (ph & last_row) ++score;
+        else if (mh & last_row) --score;
+
+        // Top row of the matrix is 0, 1, 2, ... so a +1 shifts in at the bottom bit
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        // The last row can fall by at most one per remaining column
+        if (score - static_cast<int>(n - j - 1) > max_distance) return max_distance + 1;
+    }
+    return score > max_distance ? max_distance + 1 : score;
+}
+
+// Row DP restricted to the 2k+1 diagonals around the main one
+int bandedDistance(std::string_view a, std::string_view b, int max_distance) {
+    const int m = static_cast<int>(a.size());
+    const int n = static_cast<int>(b.size());
+    const int k = std::min(max_distance, std::max(m, n));
+    const int cap = k + 1;
+    if (std::abs(m - n) > k) return max_distance + 1;
+
+    std::vector<int> prev(n + 1);
+    std::vector<int> curr(n + 1, cap);
+    for (int j = 0; j <= n; ++j) {
+        prev[j] = std::min(j, cap);
+    }
+
+    for (int i = 1; i <= m; ++i) {
+        const int lo = std::max(1, i - k);
+        const int hi = std::min(n, i + k);
+        curr[lo - 1] = lo == 1 ? std::min(i, cap) : cap;
+        int row_min = curr[lo - 1];
+
+        for (int j = lo; j <= hi; ++j) {
+            int substitution = prev[j - 1] + (a[i - 1] != b[j - 1] ? 1 : 0);
+            int value = std::min({substitution, prev[j] + 1, curr[j - 1] + 1, cap});
+            curr[j] = value;
+            row_min = std::min(row_min, value);
+        }
+        if (hi < n) curr[hi + 1] = cap; // Next row reads one cell past this band
+
+        // Every alignment crosses this row, and costs never decrease along it
+        if (row_min > k) return max_distance + 1;
+        prev.swap(curr);
+    }
+    return prev[n] > k ? max_distance + 1 : prev[n];
+}
+
+int shortPatternDistance(std::string_view pattern, std::string_view text, int max_distance) {
+    // Stays all-zero between calls; only the pattern's bytes are set and cleared
+    thread_local std::array<uint64_t, 256> peq{};
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        peq[static_cast<unsigned char>(pattern[i])] |= uint64_t(1) << i;
+    }
+    int result = myersDistance(peq.data(), pattern.size(), text, max_distance);
+    for (char c : pattern) {
+        peq[static_cast<unsigned char>(c)] = 0;
+    }
+    return result;
+}
+
+} // namespace
+
+EditDistance::Pattern::Pattern(std::string_view text) : pattern(text) {
+    if (pattern.size() > MAX_PATTERN_LENGTH) return; // Scored with the banded DP instead
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        peq[static_cast<unsigned char>(pattern[i])] |= uint64_t(1) << i;
+    }
+}
+
+int EditDistance::Pattern::distance(std::string_view text) const {
+    return distance(text, UNBOUNDED);
+}
+
+int EditDistance::Pattern::distance(std::string_view text, int max_distance) const {
+    if (max_distance < 0) return 0;
+    if (pattern.empty() || text.empty()) {
+        int length = static_cast<int>(std::max(pattern.size(), text.size()));
+        return length > max_distance ? max_distance + 1 : length;
+    }
+    int length_gap = static_cast<int>(pattern.size()) - static_cast<int>(text.size());
+    if (std::abs(length_gap) > max_distance) return max_distance + 1;
+
+    if (pattern.size() <= MAX_PATTERN_LENGTH) {
+        return myersDistance(peq.data(), pattern.size(), text, max_distance);
+    }
+    if (text.size() <= MAX_PATTERN_LENGTH) {
+        return shortPatternDistance(text, pattern, max_distance);
+    }
+    return bandedDistance(pattern, text, max_distance);
+}
+
+int EditDistance::distance(std::string_view a, std::string_view b) {
+    return bounded(a, b, UNBOUNDED);
+}
+
+int EditDistance::bounded(std::string_view a, std::string_view b, int max_distance) {
+    if (max_distance < 0) return 0;
+    if (a.size() > b.size()) std::swap(a, b);
+    if (a.empty()) {
+        int length = static_cast<int>(b.size());
+        return length > max_distance ? max_distance + 1 : length;
+    }
+    if (b.size() - a.size() > static_cast<size_t>(max_distance)) return max_distance + 1;
+
+    if (a.size() <= MAX_PATTERN_LENGTH) {
+        return shortPatternDistance(a, b, max_distance);
+    }
+    return bandedDistance(a, b, max_distance);
+}
+
+std::vector<int> EditDistance::batch(std::string_view query, const std::vector<std::string>& candidates,
+                                     int max_distance) {
+    Pattern pattern(query);
+    std::vector<int> distances;
+    distances.reserve(candidates.size());
+    for (const auto& candidate : candidates) {
+        distances.push_back(pattern.distance(candidate, max_distance));
+    }
+    return distances;
+}
@@ -0,0 +1,44 @@
+#ifndef EDITDISTANCE_H
+#define EDITDISTANCE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <array>
+#include <cstdint>
+
+// Levenshtein distance kernels. When the shorter string has at most 64
+// characters it becomes the pattern of Myers' bit-parallel algorithm (in
+// Hyyro's formulation): a whole DP column lives in two 64-bit words, so each
+// character of the other string costs a few word operations instead of a row
+// of comparisons. Longer pairs fall back to a banded row DP.
+class EditDistance {
+public:
+    static constexpr size_t MAX_PATTERN_LENGTH = 64;
+
+    // A query compiled once and scored against many candidates
+    class Pattern {
+    private:
+        std::string pattern;
+        std::array<uint64_t, 256> peq{}; // bit i set where pattern[i] is that byte
+
+    public:
+        explicit Pattern(std::string_view text);
+
+        const std::string& str() const { return pattern; }
+        size_t size() const { return pattern.size(); }
+
+        int distance(std::string_view text) const;
+        // Exact distance, or max_distance + 1 as soon as it must exceed max_distance
+        int distance(std::string_view text, int max_distance) const;
+    };
+
+    static int distance(std::string_view a, std::string_view b);
+    static int bounded(std::string_view a, std::string_view b, int max_distance);
+
+    // One query against every candidate, compiling the query only once
+    static std::vector<int> batch(std::string_view query, const std::vector<std::string>& candidates,
+                                  int max_distance);
+};
+
+#endif // EDITDISTANCE_H
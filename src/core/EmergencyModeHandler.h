@@ -3,6 +3,7 @@
 
 #include <string>
 #include <atomic>
+#include <mutex>
 
 class EmergencyModeHandler {
 private:
@@ -10,6 +11,8 @@ private:
     std::atomic<bool> is_active{false};
     std::atomic<int> activation_count{0};
     std::string last_activation_reason;
+    mutable std::mutex bundle_mutex;
+    std::string fallback_bundle;
 
 public:
     EmergencyModeHandler() = default;
@@ -53,6 +56,18 @@ public:
         return last_activation_reason;
     }
 
+    // A service bundle (see ServiceBundle) to present from while active,
+    // when translations or the planning integration cannot be relied on
+    void setFallbackBundle(const std::string& path) {
+        std::lock_guard<std::mutex> lock(bundle_mutex);
+        fallback_bundle = path;
+    }
+
+    std::string getFallbackBundle() const {
+        std::lock_guard<std::mutex> lock(bundle_mutex);
+        return fallback_bundle;
+    }
+
     bool selfTest() {
         return is_initialized.load();
     }
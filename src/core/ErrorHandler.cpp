@@ -5,7 +5,6 @@
 #include <filesystem>
 #include <random>
 #include <algorithm>
-#include <regex>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -136,8 +135,9 @@ void ErrorHandler::reportError(ErrorSeverity severity, ErrorCategory category,
     }
     
     try {
+        // Only what must come from the caller is gathered here; the id,
+        // symbolized stack and log line are produced by the processing thread
         ErrorEvent error;
-        error.id = generateErrorId();
         error.severity = severity;
         error.category = category;
         error.message = message;
@@ -147,19 +147,29 @@ void ErrorHandler::reportError(ErrorSeverity severity, ErrorCategory category,
         
         // Get stack trace for errors and above
         if (stack_trace_enabled && severity >= ErrorSeverity::ERROR) {
-            error.stack_trace = getStackTrace();
+            error.stack_frames = captureStackFrames();
         }
         
-        // Add to queue for processing
-        {
-            std::lock_guard<std::mutex> lock(queue_mutex);
-            error_queue.push(error);
+        bool on_processing_thread = std::this_thread::get_id() == processing_thread.get_id();
+        if (!error_queue.push(error)) {
+            // Critical events wait for room rather than being lost, unless the
+            // processing thread itself is reporting and nobody else would drain
+            if (severity < ErrorSeverity::CRITICAL || on_processing_thread) {
+                dropped_events.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            delayed_events.fetch_add(1, std::memory_order_relaxed);
+            queue_cv.notify_one();
+            while (!error_queue.push(error)) {
+                std::this_thread::yield();
+            }
         }
-        queue_cv.notify_one();
         
-        // For critical and fatal errors, process immediately
-        if (severity >= ErrorSeverity::CRITICAL) {
+        if (severity == ErrorSeverity::FATAL) {
+            // The process may be about to die; get it on disk now
             flushPendingErrors();
+        } else if (severity == ErrorSeverity::CRITICAL) {
+            queue_cv.notify_one();
         }
         
     } catch (const std::exception& e) {
@@ -170,24 +180,43 @@ void ErrorHandler::reportError(ErrorSeverity severity, ErrorCategory category,
 }
 
 void ErrorHandler::processErrorQueue() {
+    std::unique_lock<std::mutex> lock(queue_mutex);
     while (is_running.load()) {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        queue_cv.wait(lock, [this] { return !error_queue.empty() || !is_running.load(); });
-        
-        while (!error_queue.empty()) {
-            ErrorEvent error = error_queue.front();
-            error_queue.pop();
-            lock.unlock();
-            
-            // Process the error
-            processError(error);
-            
-            lock.lock();
-        }
+        queue_cv.wait_for(lock, FLUSH_INTERVAL);
+        drainQueueLocked();
+    }
+}
+
+void ErrorHandler::drainQueueLocked() {
+    ErrorEvent error;
+    while (error_queue.pop(error)) {
+        processError(error);
+    }
+    writeLogBuffer();
+}
+
+void ErrorHandler::writeLogBuffer() {
+    if (log_buffer.empty()) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(log_mutex);
+    if (log_file.is_open()) {
+        log_file.write(log_buffer.data(), static_cast<std::streamsize>(log_buffer.size()));
+        log_file.flush();
     }
+    log_buffer.clear();
 }
 
-void ErrorHandler::processError(const ErrorEvent& error) {
+void ErrorHandler::processError(ErrorEvent& error) {
+    if (error.id.empty()) {
+        error.id = generateErrorId();
+    }
+    if (!error.stack_frames.empty()) {
+        error.stack_trace = formatStackTrace(error.stack_frames);
+        error.stack_frames.clear();
+    }
+    
     // Add to history
     {
         std::lock_guard<std::mutex> lock(error_mutex);
@@ -199,14 +228,9 @@ void ErrorHandler::processError(const ErrorEvent& error) {
         }
     }
     
-    // Write to log file
-    {
-        std::lock_guard<std::mutex> lock(log_mutex);
-        if (log_file.is_open()) {
-            log_file << formatLogEntry(error) << std::endl;
-            log_file.flush();
-        }
-    }
+    // Queue the log line; the batch is written once the queue is drained
+    log_buffer += formatLogEntry(error);
+    log_buffer += '\n';
     
     // Update statistics
     updateErrorStats(error);
@@ -235,8 +259,21 @@ void ErrorHandler::processError(const ErrorEvent& error) {
 void ErrorHandler::attemptAutoRecovery(const ErrorEvent& error) {
     std::lock_guard<std::mutex> lock(pattern_mutex);
     
-    for (const auto& pattern : error_patterns) {
-        if (matchesPattern(error, pattern) && pattern.auto_recoverable) {
+    for (size_t index : matchingPatterns(error)) {
+        const ErrorPattern& pattern = error_patterns[index];
+        if (pattern.auto_recoverable) {
+            // At most max_occurrences attempts per cooldown period, so a storm
+            // of one error does not rerun its recovery for every occurrence
+            RecoveryWindow& window = recovery_windows[index];
+            auto now = std::chrono::steady_clock::now();
+            if (window.attempts == 0 || now - window.start >= pattern.cooldown_period) {
+                window.start = now;
+                window.attempts = 0;
+            }
+            if (window.attempts >= pattern.max_occurrences) {
+                break;
+            }
+            ++window.attempts;
             try {
                 if (pattern.recovery_action && pattern.recovery_action()) {
                     logInfo("Auto-recovery successful for error: " + error.id, 
@@ -261,15 +298,12 @@ void ErrorHandler::attemptAutoRecovery(const ErrorEvent& error) {
     }
 }
 
-bool ErrorHandler::matchesPattern(const ErrorEvent& error, const ErrorPattern& pattern) {
-    try {
-        // Simple regex matching for now
-        std::regex pattern_regex(pattern.message_pattern);
-        return std::regex_search(error.message, pattern_regex) && 
-               error.category == pattern.category;
-    } catch (const std::exception&) {
-        return false; // Invalid regex pattern
-    }
+std::vector<size_t> ErrorHandler::matchingPatterns(const ErrorEvent& error) const {
+    std::vector<size_t> matches = pattern_matcher.match(error.message);
+    matches.erase(std::remove_if(matches.begin(), matches.end(), [&](size_t index) {
+        return error_patterns[index].category != error.category;
+    }), matches.end());
+    return matches;
 }
 
 void ErrorHandler::updateErrorStats(const ErrorEvent& error) {
@@ -338,30 +372,33 @@ std::string ErrorHandler::formatLogEntry(const ErrorEvent& error) {
     return ss.str();
 }
 
-std::string ErrorHandler::getStackTrace() {
-    if (!stack_trace_enabled) {
-        return "";
-    }
+std::vector<void*> ErrorHandler::captureStackFrames() {
+    std::vector<void*> frames(100);
     
+#ifdef _WIN32
+    frames.resize(CaptureStackBackTrace(0, 100, frames.data(), NULL));
+#elif defined(__linux__) || defined(__APPLE__)
+    frames.resize(static_cast<size_t>(backtrace(frames.data(), 100)));
+#else
+    frames.clear();
+#endif
+    
+    return frames;
+}
+
+std::string ErrorHandler::formatStackTrace(const std::vector<void*>& frames) {
     std::string trace;
     
 #ifdef _WIN32
-    // Windows stack trace implementation
-    void* stack[100];
-    unsigned short frames = CaptureStackBackTrace(0, 100, stack, NULL);
-    
-    for (unsigned short i = 0; i < frames; ++i) {
-        trace += std::to_string(reinterpret_cast<uintptr_t>(stack[i])) + " ";
+    for (void* frame : frames) {
+        trace += std::to_string(reinterpret_cast<uintptr_t>(frame)) + " ";
     }
     
 #elif defined(__linux__) || defined(__APPLE__)
-    // Linux/macOS stack trace implementation
-    void* array[100];
-    size_t size = backtrace(array, 100);
-    char** strings = backtrace_symbols(array, size);
+    char** strings = backtrace_symbols(frames.data(), static_cast<int>(frames.size()));
     
     if (strings) {
-        for (size_t i = 0; i < size; ++i) {
+        for (size_t i = 0; i < frames.size(); ++i) {
             trace += std::string(strings[i]) + "\n";
         }
         free(strings);
@@ -373,15 +410,28 @@ std::string ErrorHandler::getStackTrace() {
 
 void ErrorHandler::registerErrorPattern(const ErrorPattern& pattern) {
     std::lock_guard<std::mutex> lock(pattern_mutex);
+    if (!pattern_matcher.add(pattern.message_pattern)) {
+        std::cerr << "Invalid error pattern '" << pattern.pattern_id << "' never matches: "
+                  << pattern.message_pattern << std::endl;
+    }
     error_patterns.push_back(pattern);
+    recovery_windows.emplace_back();
 }
 
 void ErrorHandler::removeErrorPattern(const std::string& pattern_id) {
     std::lock_guard<std::mutex> lock(pattern_mutex);
-    error_patterns.erase(
-        std::remove_if(error_patterns.begin(), error_patterns.end(),
-                      [&pattern_id](const ErrorPattern& p) { return p.pattern_id == pattern_id; }),
-        error_patterns.end());
+    // Ids are positions, so the survivors are compiled again
+    std::vector<ErrorPattern> kept;
+    std::vector<RecoveryWindow> kept_windows;
+    pattern_matcher.clear();
+    for (size_t i = 0; i < error_patterns.size(); ++i) {
+        if (error_patterns[i].pattern_id == pattern_id) continue;
+        pattern_matcher.add(error_patterns[i].message_pattern);
+        kept.push_back(std::move(error_patterns[i]));
+        kept_windows.push_back(recovery_windows[i]);
+    }
+    error_patterns = std::move(kept);
+    recovery_windows = std::move(kept_windows);
 }
 
 void ErrorHandler::registerDefaultPatterns() {
@@ -478,9 +528,9 @@ std::vector<std::string> ErrorHandler::getSuggestedSolutions(ErrorCategory categ
 std::string ErrorHandler::getUserFriendlyMessage(const ErrorEvent& error) {
     std::lock_guard<std::mutex> lock(pattern_mutex);
     
-    for (const auto& pattern : error_patterns) {
-        if (matchesPattern(error, pattern) && !pattern.user_friendly_message.empty()) {
-            return pattern.user_friendly_message;
+    for (size_t index : matchingPatterns(error)) {
+        if (!error_patterns[index].user_friendly_message.empty()) {
+            return error_patterns[index].user_friendly_message;
         }
     }
     
@@ -550,10 +600,9 @@ bool ErrorHandler::isErrorRecoverable(const std::string& error_id) {
     }
     
     std::lock_guard<std::mutex> lock(pattern_mutex);
-    for (const auto& pattern : error_patterns) {
-        if (matchesPattern(error, pattern)) {
-            return pattern.auto_recoverable;
-        }
+    std::vector<size_t> matches = matchingPatterns(error);
+    if (!matches.empty()) {
+        return error_patterns[matches.front()].auto_recoverable;
     }
     
     // Most errors are potentially recoverable except fatal ones
@@ -613,12 +662,17 @@ ErrorEvent ErrorHandler::getErrorById(const std::string& error_id) {
 
 ErrorStats ErrorHandler::getErrorStats() {
     std::lock_guard<std::mutex> lock(stats_mutex);
-    return stats;
+    ErrorStats current = stats;
+    current.dropped_events = dropped_events.load(std::memory_order_relaxed);
+    current.delayed_events = delayed_events.load(std::memory_order_relaxed);
+    return current;
 }
 
 void ErrorHandler::resetStats() {
     std::lock_guard<std::mutex> lock(stats_mutex);
     stats = ErrorStats();
+    dropped_events.store(0, std::memory_order_relaxed);
+    delayed_events.store(0, std::memory_order_relaxed);
 }
 
 std::string ErrorHandler::generateErrorReport() {
@@ -634,6 +688,8 @@ std::string ErrorHandler::generateErrorReport() {
     report << "Resolved Errors: " << stats.resolved_errors << "\n";
     report << "Auto-Recovered: " << stats.auto_recovered << "\n";
     report << "Error Rate: " << std::fixed << std::setprecision(2) << stats.error_rate << " errors/hour\n";
+    report << "Dropped Events: " << stats.dropped_events << "\n";
+    report << "Delayed Critical Events: " << stats.delayed_events << "\n";
     
     report << "\nRecent Errors:\n";
     auto recent = getRecentErrors(5);
@@ -740,6 +796,7 @@ bool ErrorHandler::selfTest() {
 
 bool ErrorHandler::rotateLogFiles() {
     try {
+        std::lock_guard<std::mutex> lock(log_mutex);
         if (log_file.is_open()) {
             log_file.close();
         }
@@ -819,15 +876,28 @@ std::string ErrorHandler::getCurrentContext() {
 }
 
 void ErrorHandler::flushPendingErrors() {
+    if (std::this_thread::get_id() == processing_thread.get_id()) {
+        return; // already draining; the batch is written when it finishes
+    }
+    
     std::lock_guard<std::mutex> lock(queue_mutex);
-    // This forces the processing thread to wake up and process all pending errors
-    queue_cv.notify_all();
+    drainQueueLocked();
 }
 
 void ErrorHandler::processErrorBatch(const std::vector<ErrorEvent>& errors) {
-    for (const auto& error : errors) {
+    if (std::this_thread::get_id() == processing_thread.get_id()) {
+        // Already draining; queue them behind the current batch
+        for (const auto& error : errors) {
+            if (!error_queue.push(error)) dropped_events.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    for (auto error : errors) {
         processError(error);
     }
+    writeLogBuffer();
 }
 
 void ErrorHandler::reportErrorToRemote(const ErrorEvent& error) {
@@ -8,11 +8,12 @@
 #include <fstream>
 #include <memory>
 #include <functional>
-#include <queue>
 #include <atomic>
 #include <thread>
 #include <condition_variable>
 #include "nlohmann/json.hpp"
+#include "MpscQueue.h"
+#include "PatternMatcher.h"
 
 using json = nlohmann::json;
 
@@ -46,6 +47,7 @@ struct ErrorEvent {
     std::string message;
     std::string context;
     std::string stack_trace;
+    std::vector<void*> stack_frames; // captured raw; symbolized into stack_trace off the caller's thread
     std::chrono::system_clock::time_point timestamp;
     std::string session_id;
     json additional_data;
@@ -75,6 +77,8 @@ struct ErrorStats {
     int auto_recovered = 0;
     std::chrono::seconds average_resolution_time{0};
     double error_rate = 0.0; // errors per hour
+    int dropped_events = 0;   // lost because the queue was full
+    int delayed_events = 0;   // critical events that waited for room in the queue
 };
 
 class ErrorHandler {
@@ -84,28 +88,45 @@ private:
     std::atomic<bool> is_initialized{false};
     std::atomic<bool> is_running{false};
     
-    // Logging
+    // Logging. Reporting pushes onto a lock-free queue; the processing thread
+    // formats queued events and writes them to the log in one batch per wake-up,
+    // so a storm of errors costs callers a queue push each, not a disk flush.
+    // When the queue is full, events below CRITICAL are dropped and counted.
+    static constexpr size_t QUEUE_CAPACITY = 1024;
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL{250};
     std::ofstream log_file;
     std::mutex log_mutex;
+    std::string log_buffer; // guarded by queue_mutex
     
     // Error tracking
     std::vector<ErrorEvent> error_history;
     std::mutex error_mutex;
     int max_history_size = 1000;
     
-    // Error patterns and recovery
+    // Error patterns and recovery. Message patterns are compiled into one
+    // matcher when registered, so classifying an error is a single pass over
+    // its message; pattern ids are indices into error_patterns.
     std::vector<ErrorPattern> error_patterns;
+    PatternMatcher pattern_matcher;
+    // Recovery attempts in the current cooldown window, parallel to error_patterns
+    struct RecoveryWindow {
+        std::chrono::steady_clock::time_point start;
+        int attempts = 0;
+    };
+    std::vector<RecoveryWindow> recovery_windows;
     mutable std::mutex pattern_mutex;
     
     // Statistics
     ErrorStats stats;
     std::mutex stats_mutex;
     
-    // Background processing
-    std::queue<ErrorEvent> error_queue;
+    // Background processing; queue_mutex guards the queue's consumer side
+    MpscQueue<ErrorEvent> error_queue{QUEUE_CAPACITY};
     std::mutex queue_mutex;
     std::condition_variable queue_cv;
     std::thread processing_thread;
+    std::atomic<int> dropped_events{0};
+    std::atomic<int> delayed_events{0};
     
     // Configuration
     bool auto_reporting_enabled = false;
@@ -121,13 +142,18 @@ private:
     // Internal methods
     std::string generateErrorId();
     void processErrorQueue();
-    void processError(const ErrorEvent& error);
-    bool matchesPattern(const ErrorEvent& error, const ErrorPattern& pattern);
+    // Caller holds queue_mutex
+    void drainQueueLocked();
+    void processError(ErrorEvent& error);
+    void writeLogBuffer();
+    // Indices of the patterns error matches, in registration order; caller holds pattern_mutex
+    std::vector<size_t> matchingPatterns(const ErrorEvent& error) const;
     void attemptAutoRecovery(const ErrorEvent& error);
     void updateErrorStats(const ErrorEvent& error);
     void rotateLogFile();
     std::string formatLogEntry(const ErrorEvent& error);
-    std::string getStackTrace();
+    static std::vector<void*> captureStackFrames();
+    static std::string formatStackTrace(const std::vector<void*>& frames);
     void registerDefaultPatterns();
     void reportErrorToRemote(const ErrorEvent& error);
     
@@ -206,6 +232,7 @@ public:
     std::string getCurrentContext();
     
     // Batch operations
+    // Processes everything queued so far and writes it to the log before returning
     void flushPendingErrors();
     void processErrorBatch(const std::vector<ErrorEvent>& errors);
     
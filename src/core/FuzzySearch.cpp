@@ -1,4 +1,5 @@
 #include "FuzzySearch.h"
+#include "TextFolding.h"
 #include <algorithm>
 #include <cctype>
 #include <cmath>
@@ -9,106 +10,38 @@ FuzzySearch::FuzzySearch() = default;
 
 FuzzySearch::FuzzySearch(const FuzzySearchOptions& opts) : options(opts) {}
 
-int FuzzySearch::levenshteinDistance(const std::string& s1, const std::string& s2) const {
-    const size_t len1 = s1.length();
-    const size_t len2 = s2.length();
-    
-    // Early exit for empty strings
-    if (len1 == 0) return len2;
-    if (len2 == 0) return len1;
-    
-    // Early exit if difference in length is too large
-    if (std::abs(static_cast<int>(len1) - static_cast<int>(len2)) > options.maxEditDistance) {
-        return options.maxEditDistance + 1;
-    }
-    
-    // Use space-optimized version with only two rows instead of full matrix
-    std::vector<int> prev_row(len2 + 1);
-    std::vector<int> curr_row(len2 + 1);
-    
-    // Initialize first row
-    for (size_t j = 0; j <= len2; ++j) {
-        prev_row[j] = j;
-    }
+std::string FuzzySearch::soundex(const std::string& word) {
+    // Soundex mapping
+    static constexpr char mapping[] = "01230120022455012623010202";
     
-    // Fill the matrix row by row
-    for (size_t i = 1; i <= len1; ++i) {
-        curr_row[0] = i;
-        
-        // Early termination check - if minimum value in row exceeds threshold
-        int min_in_row = curr_row[0];
-        
-        for (size_t j = 1; j <= len2; ++j) {
-            if (s1[i - 1] == s2[j - 1]) {
-                curr_row[j] = prev_row[j - 1];
-            } else {
-                curr_row[j] = 1 + std::min({
-                    prev_row[j],      // deletion
-                    curr_row[j - 1],  // insertion
-                    prev_row[j - 1]   // substitution
-                });
-            }
-            min_in_row = std::min(min_in_row, curr_row[j]);
-        }
+    // Walks the raw word as if normalized, stopping once four symbols are known
+    std::string result;
+    char prev = '\0';
+    for (char raw : word) {
+        unsigned char uc = static_cast<unsigned char>(raw);
+        if (!std::isalnum(uc)) continue;
         
-        // Early termination if minimum distance exceeds threshold
-        if (min_in_row > options.maxEditDistance) {
-            return options.maxEditDistance + 1;
+        // First character is always kept
+        if (result.empty()) {
+            result += static_cast<char>(std::toupper(uc));
+            continue;
         }
         
-        // Swap rows
-        prev_row.swap(curr_row);
-    }
-    
-    return prev_row[len2];
-}
-
-std::string FuzzySearch::soundex(const std::string& word) const {
-    if (word.empty()) return "0000";
-    
-    // Check cache first
-    auto it = soundexCache.find(word);
-    if (it != soundexCache.end()) {
-        return it->second;
-    }
-    
-    std::string result;
-    std::string normalized = normalize(word);
-    
-    if (normalized.empty()) {
-        soundexCache[word] = "0000";
-        return "0000";
-    }
-    
-    // First character is always kept
-    result += std::toupper(normalized[0]);
-    
-    // Soundex mapping
-    std::string mapping = "01230120022455012623010202";
-    std::string prev = "";
-    
-    for (size_t i = 1; i < normalized.length() && result.length() < 4; ++i) {
-        char c = std::tolower(normalized[i]);
+        char c = static_cast<char>(std::tolower(uc));
         if (c >= 'a' && c <= 'z') {
-            size_t index = static_cast<size_t>(c - 'a');
-            // Ensure index is within bounds of mapping string
-            if (index < mapping.length()) {
-                std::string code = mapping.substr(index, 1);
-                if (code != "0" && code != prev) {
-                    result += code;
-                }
-                prev = code;
+            char code = mapping[c - 'a'];
+            if (code != '0' && code != prev) {
+                result += code;
+                if (result.length() == 4) break;
             }
+            prev = code;
         }
     }
     
-    // Pad with zeros
-    while (result.length() < 4) {
-        result += "0";
-    }
+    if (result.empty()) return "0000";
     
-    // Cache the result
-    soundexCache[word] = result;
+    // Pad with zeros
+    result.resize(4, '0');
     return result;
 }
 
@@ -153,34 +86,15 @@ double FuzzySearch::ngramSimilarity(const std::string& s1, const std::string& s2
     return unionSize > 0 ? static_cast<double>(intersection.size()) / unionSize : 0.0;
 }
 
-std::string FuzzySearch::normalize(const std::string& text) const {
-    // Check cache first for frequently used strings
-    auto it = normalizeCache.find(text);
-    if (it != normalizeCache.end()) {
-        return it->second;
-    }
-    
+std::string FuzzySearch::normalize(const std::string& text) {
+    // A single pass is cheaper than a memo lookup, and leaves nothing to grow or lock
     std::string result;
     result.reserve(text.length()); // Reserve space to avoid reallocations
-    
-    for (char c : text) {
-        if (std::isalnum(c)) {
-            result += std::tolower(c);
-        }
-    }
-    
-    // Cache the result if cache isn't too large
-    if (normalizeCache.size() < 1000) {
-        normalizeCache[text] = result;
-    }
-    
+    TextFolding::forEachWord(text, [&result](std::string_view word) { result += word; });
     return result;
 }
 
-double FuzzySearch::calculateConfidence(const std::string& query, const std::string& target, int editDistance) const {
-    const std::string normQuery = normalize(query);
-    const std::string normTarget = normalize(target);
-    
+double FuzzySearch::calculateConfidence(const std::string& normQuery, const std::string& normTarget, int editDistance) const {
     if (normQuery.empty() || normTarget.empty()) return 0.0;
     
     // Exact match gets perfect score
@@ -214,65 +128,160 @@ double FuzzySearch::calculateConfidence(const std::string& query, const std::str
     return std::max(0.0, std::min(1.0, confidence));
 }
 
-std::vector<FuzzyMatch> FuzzySearch::findMatches(const std::string& query, const std::vector<std::string>& candidates) const {
-    if (!options.enabled || query.empty()) return {};
+const char* FuzzySearch::kindName(MatchKind kind) {
+    switch (kind) {
+        case MatchKind::EXACT: return "exact";
+        case MatchKind::PARTIAL: return "partial";
+        case MatchKind::FUZZY: return "fuzzy";
+        case MatchKind::PHONETIC: return "phonetic";
+        case MatchKind::NONE: break;
+    }
+    return "none";
+}
+
+template <bool Phonetic, bool Partial>
+FuzzySearch::Score FuzzySearch::scoreCandidate(const std::string& query, const EditDistance::Pattern& queryPattern,
+                                               const std::string& candidate, const std::string& normCandidate) const {
+    const std::string& normQuery = queryPattern.str();
     
+    // Early returns for edge cases
+    if (normQuery.empty() || normCandidate.empty()) {
+        return {0.0, MatchKind::NONE};
+    }
+    
+    // Exact match
+    if (normQuery == normCandidate) {
+        return {1.0, MatchKind::EXACT};
+    }
+    
+    if constexpr (Partial) {
+        // Quick substring check first (fastest)
+        if (normCandidate.find(normQuery) != std::string::npos) {
+            double confidence = static_cast<double>(normQuery.length()) / normCandidate.length();
+            return {std::min(0.95, confidence + 0.1), MatchKind::PARTIAL};
+        }
+        
+        if (normQuery.find(normCandidate) != std::string::npos) {
+            double confidence = static_cast<double>(normCandidate.length()) / normQuery.length();
+            return {std::min(0.95, confidence + 0.1), MatchKind::PARTIAL};
+        }
+        
+        // Fast common prefix/suffix check
+        size_t commonPrefix = 0;
+        size_t minLen = std::min(normQuery.length(), normCandidate.length());
+        while (commonPrefix < minLen && normQuery[commonPrefix] == normCandidate[commonPrefix]) {
+            commonPrefix++;
+        }
+        
+        // If significant prefix match, give it a good score
+        if (commonPrefix >= 3 && commonPrefix >= minLen * 0.6) {
+            double confidence = static_cast<double>(commonPrefix) / std::max(normQuery.length(), normCandidate.length());
+            return {std::min(0.85, confidence + 0.1), MatchKind::PARTIAL};
+        }
+    }
+    
+    // Calculate edit distance with early termination
+    const int editDist = queryPattern.distance(normCandidate, options.maxEditDistance);
+    
+    // If edit distance is too high, skip expensive calculations
+    if (editDist > options.maxEditDistance) {
+        return {0.0, MatchKind::NONE};
+    }
+    
+    const double confidence = calculateConfidence(normQuery, normCandidate, editDist);
+    
+    // Only check phonetic similarity if confidence is reasonable
+    if constexpr (Phonetic) {
+        if (confidence > 0.3 && soundsAlike(query, candidate)) {
+            return {confidence, MatchKind::PHONETIC};
+        }
+    }
+    return {confidence, MatchKind::FUZZY};
+}
+
+template <bool Phonetic, bool Partial, bool EarlyStop>
+std::vector<FuzzyMatch> FuzzySearch::findMatchesWith(const std::string& query, const std::vector<std::string>& candidates,
+                                                     const SearchContext& context) const {
+    const size_t maxMatches = static_cast<size_t>(options.maxSuggestions * 2);
     std::vector<FuzzyMatch> matches;
-    matches.reserve(std::min(candidates.size(), static_cast<size_t>(options.maxSuggestions * 2))); // Reserve space
+    matches.reserve(std::min(candidates.size(), maxMatches)); // Reserve space
     
     const std::string normQuery = normalize(query);
+    const EditDistance::Pattern queryPattern(normQuery); // Compiled once for every candidate
+    const int maxLengthDiff = options.maxEditDistance * 2;
     
     // Early termination counters
     int exact_matches = 0;
     int good_matches = 0;
     
-    for (const auto& candidate : candidates) {
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        // Out of time: keep the matches scored so far
+        if (context.shouldStopAt(i)) break;
+        
+        const std::string& candidate = candidates[i];
         // Quick filter: skip candidates that are obviously too different
         const std::string normCandidate = normalize(candidate);
         
         // Skip if length difference is too large (quick filter)
-        if (std::abs(static_cast<int>(normQuery.length()) - static_cast<int>(normCandidate.length())) > options.maxEditDistance * 2) {
+        if (std::abs(static_cast<int>(normQuery.length()) - static_cast<int>(normCandidate.length())) > maxLengthDiff) {
             continue;
         }
         
-        FuzzyMatch match = calculateMatch(query, candidate);
-        if (match.confidence >= options.minConfidence) {
-            matches.push_back(match);
-            
-            // Track quality matches for early termination
-            if (match.matchType == "exact") {
+        // Only a match is copied; most candidates are rejected here
+        const Score score = scoreCandidate<Phonetic, Partial>(query, queryPattern, candidate, normCandidate);
+        if (score.confidence < options.minConfidence) continue;
+        matches.emplace_back(candidate, score.confidence, kindName(score.kind));
+        
+        // Track quality matches for early termination
+        if constexpr (EarlyStop) {
+            if (score.kind == MatchKind::EXACT) {
                 exact_matches++;
                 if (exact_matches >= 2) break; // Stop early if we have exact matches
-            } else if (match.confidence > 0.9) {
+            } else if (score.confidence > 0.9) {
                 good_matches++;
                 if (good_matches >= 3) break; // Stop if we have excellent matches
-            } else if (match.confidence > 0.8) {
+            } else if (score.confidence > 0.8) {
                 good_matches++;
                 if (good_matches >= options.maxSuggestions) break; // Stop if we have enough good matches
             }
         }
         
         // Hard limit to prevent excessive processing - be more aggressive
-        if (matches.size() >= static_cast<size_t>(options.maxSuggestions * 2)) break;
+        if (matches.size() >= maxMatches) break;
     }
     
     // Sort by confidence (descending) - use partial sort for better performance
+    auto byConfidence = [](const FuzzyMatch& a, const FuzzyMatch& b) { return a.confidence > b.confidence; };
     if (matches.size() > static_cast<size_t>(options.maxSuggestions)) {
-        std::partial_sort(matches.begin(), matches.begin() + options.maxSuggestions, matches.end(),
-                         [](const FuzzyMatch& a, const FuzzyMatch& b) {
-                             return a.confidence > b.confidence;
-                         });
+        std::partial_sort(matches.begin(), matches.begin() + options.maxSuggestions, matches.end(), byConfidence);
         matches.resize(options.maxSuggestions);
     } else {
-        std::sort(matches.begin(), matches.end(), [](const FuzzyMatch& a, const FuzzyMatch& b) {
-            return a.confidence > b.confidence;
-        });
+        std::sort(matches.begin(), matches.end(), byConfidence);
     }
     
     return matches;
 }
 
-std::vector<FuzzyMatch> FuzzySearch::findBookMatches(const std::string& query, const std::vector<std::string>& bookNames) const {
+std::vector<FuzzyMatch> FuzzySearch::findMatches(const std::string& query, const std::vector<std::string>& candidates,
+                                                 const SearchContext& context) const {
+    if (!options.enabled || query.empty()) return {};
+    
+    // Indexed by phonetic, partial, early termination, as bits from high to low
+    using Kernel = std::vector<FuzzyMatch> (FuzzySearch::*)(const std::string&, const std::vector<std::string>&,
+                                                             const SearchContext&) const;
+    static constexpr Kernel KERNELS[] = {
+        &FuzzySearch::findMatchesWith<false, false, false>, &FuzzySearch::findMatchesWith<false, false, true>,
+        &FuzzySearch::findMatchesWith<false, true, false>,  &FuzzySearch::findMatchesWith<false, true, true>,
+        &FuzzySearch::findMatchesWith<true, false, false>,  &FuzzySearch::findMatchesWith<true, false, true>,
+        &FuzzySearch::findMatchesWith<true, true, false>,   &FuzzySearch::findMatchesWith<true, true, true>,
+    };
+    const size_t kernel = (options.enablePhonetic ? 4 : 0) | (options.enablePartialMatch ? 2 : 0) |
+                          (options.enableEarlyTermination ? 1 : 0);
+    return (this->*KERNELS[kernel])(query, candidates, context);
+}
+
+std::vector<FuzzyMatch> FuzzySearch::findBookMatches(const std::string& query, const std::vector<std::string>& bookNames,
+                                                     const std::vector<std::string>& soundAlikes) const {
     if (!options.enabled || query.empty()) return {};
     
     std::vector<FuzzyMatch> matches;
@@ -325,6 +334,7 @@ std::vector<FuzzyMatch> FuzzySearch::findBookMatches(const std::string& query, c
     }
     
     // Now do fuzzy search only if needed
+    const EditDistance::Pattern queryPattern(normQuery);
     for (const auto& bookName : bookNames) {
         const std::string normBook = normalize(bookName);
         
@@ -339,17 +349,20 @@ std::vector<FuzzyMatch> FuzzySearch::findBookMatches(const std::string& query, c
         if (already_found) continue;
         
         // Calculate edit distance with early termination
-        const int editDist = levenshteinDistance(normQuery, normBook);
+        const int editDist = queryPattern.distance(normBook, options.maxEditDistance);
         if (editDist <= options.maxEditDistance) {
-            const double confidence = calculateConfidence(query, bookName, editDist);
+            const double confidence = calculateConfidence(normQuery, normBook, editDist);
             if (confidence >= options.minConfidence) {
                 matches.emplace_back(bookName, confidence, "fuzzy");
             }
         }
         
-        // Check phonetic similarity for book names
-        if (options.enablePhonetic && arePhoneticallySimilar(query, bookName)) {
-            const double phoneticConfidence = 0.8; // Base phonetic confidence
+    }
+    
+    // Sound-alikes come from the caller's phonetic index, not a comparison per name
+    if (options.enablePhonetic) {
+        const double phoneticConfidence = 0.8; // Base phonetic confidence
+        for (const auto& bookName : soundAlikes) {
             matches.emplace_back(bookName, phoneticConfidence, "phonetic");
         }
     }
@@ -373,71 +386,29 @@ std::vector<FuzzyMatch> FuzzySearch::findBookMatches(const std::string& query, c
 }
 
 FuzzyMatch FuzzySearch::calculateMatch(const std::string& query, const std::string& candidate) const {
-    const std::string normQuery = normalize(query);
-    const std::string normCandidate = normalize(candidate);
-    
-    // Early returns for edge cases
-    if (normQuery.empty() || normCandidate.empty()) {
-        return FuzzyMatch(candidate, 0.0, "none");
-    }
-    
-    // Exact match
-    if (normQuery == normCandidate) {
-        return FuzzyMatch(candidate, 1.0, "exact");
-    }
-    
-    // Quick substring check first (fastest)
-    if (normCandidate.find(normQuery) != std::string::npos) {
-        double confidence = static_cast<double>(normQuery.length()) / normCandidate.length();
-        return FuzzyMatch(candidate, std::min(0.95, confidence + 0.1), "partial");
-    }
-    
-    if (normQuery.find(normCandidate) != std::string::npos) {
-        double confidence = static_cast<double>(normCandidate.length()) / normQuery.length();
-        return FuzzyMatch(candidate, std::min(0.95, confidence + 0.1), "partial");
-    }
-    
-    // Fast common prefix/suffix check
-    size_t commonPrefix = 0;
-    size_t minLen = std::min(normQuery.length(), normCandidate.length());
-    while (commonPrefix < minLen && normQuery[commonPrefix] == normCandidate[commonPrefix]) {
-        commonPrefix++;
-    }
-    
-    // If significant prefix match, give it a good score
-    if (commonPrefix >= 3 && commonPrefix >= minLen * 0.6) {
-        double confidence = static_cast<double>(commonPrefix) / std::max(normQuery.length(), normCandidate.length());
-        return FuzzyMatch(candidate, std::min(0.85, confidence + 0.1), "partial");
-    }
-    
-    // Calculate edit distance with early termination
-    const int editDist = levenshteinDistance(normQuery, normCandidate);
-    
-    // If edit distance is too high, skip expensive calculations
-    if (editDist > options.maxEditDistance) {
-        return FuzzyMatch(candidate, 0.0, "none");
-    }
-    
-    const double confidence = calculateConfidence(query, candidate, editDist);
-    
-    // Only check phonetic similarity if confidence is reasonable
-    std::string matchType = "fuzzy";
-    if (confidence > 0.3 && options.enablePhonetic && arePhoneticallySimilar(query, candidate)) {
-        matchType = "phonetic";
-    }
-    
-    return FuzzyMatch(candidate, confidence, matchType);
+    using Kernel = Score (FuzzySearch::*)(const std::string&, const EditDistance::Pattern&, const std::string&,
+                                          const std::string&) const;
+    static constexpr Kernel KERNELS[] = {
+        &FuzzySearch::scoreCandidate<false, false>, &FuzzySearch::scoreCandidate<false, true>,
+        &FuzzySearch::scoreCandidate<true, false>,  &FuzzySearch::scoreCandidate<true, true>,
+    };
+    const size_t kernel = (options.enablePhonetic ? 2 : 0) | (options.enablePartialMatch ? 1 : 0);
+    const Score score = (this->*KERNELS[kernel])(query, EditDistance::Pattern(normalize(query)), candidate,
+                                                 normalize(candidate));
+    return FuzzyMatch(candidate, score.confidence, kindName(score.kind));
 }
 
-bool FuzzySearch::arePhoneticallySimilar(const std::string& s1, const std::string& s2) const {
-    if (!options.enablePhonetic) return false;
-    
+bool FuzzySearch::soundsAlike(const std::string& s1, const std::string& s2) {
     const std::string sound1 = soundex(s1);
     const std::string sound2 = soundex(s2);
     
     return sound1 == sound2 && sound1 != "0000";
 }
 
+bool FuzzySearch::arePhoneticallySimilar(const std::string& s1, const std::string& s2) const {
+    return options.enablePhonetic && soundsAlike(s1, s2);
+}
+
 std::vector<std::string> FuzzySearch::generateSuggestions(const std::string& query, const std::vector<std::string>& dictionary) const {
     if (!options.enabled || query.empty()) return {};
     
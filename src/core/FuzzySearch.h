@@ -5,6 +5,8 @@
 #include <vector>
 #include <unordered_map>
 #include <utility>
+#include "EditDistance.h"
+#include "SearchContext.h"
 
 struct FuzzyMatch {
     std::string text;
@@ -27,36 +29,56 @@ struct FuzzySearchOptions {
     bool enableEarlyTermination = true;  // Stop when good matches found
 };
 
+// Holds no mutable state: const methods are safe to call from any number of
+// threads (UI, incremental search worker, API requests) at once.
 class FuzzySearch {
 private:
     FuzzySearchOptions options;
-    mutable std::unordered_map<std::string, std::string> soundexCache;
-    mutable std::unordered_map<std::string, std::string> normalizeCache;
     
-    // Levenshtein distance calculation
-    int levenshteinDistance(const std::string& s1, const std::string& s2) const;
+    // What scoring a candidate found, before it is worth copying into a FuzzyMatch
+    enum class MatchKind : unsigned char { NONE, EXACT, PARTIAL, FUZZY, PHONETIC };
+    struct Score {
+        double confidence;
+        MatchKind kind;
+    };
+    static const char* kindName(MatchKind kind);
     
-    // Soundex algorithm for phonetic matching
-    std::string soundex(const std::string& word) const;
+    // Soundex algorithm for phonetic matching; reads only the first few letters
+    static std::string soundex(const std::string& word);
+    static bool soundsAlike(const std::string& s1, const std::string& s2);
     
     // N-gram similarity calculation
     double ngramSimilarity(const std::string& s1, const std::string& s2, int n = 2) const;
     
     // Normalize text for comparison
-    std::string normalize(const std::string& text) const;
+    static std::string normalize(const std::string& text);
     
-    // Calculate confidence score based on various factors
-    double calculateConfidence(const std::string& query, const std::string& target, int editDistance) const;
+    // Calculate confidence score from already normalized strings
+    double calculateConfidence(const std::string& normQuery, const std::string& normTarget, int editDistance) const;
+    
+    // The scoring and candidate loops, one instantiation per combination of
+    // the options they test (enablePhonetic, enablePartialMatch,
+    // enableEarlyTermination); the public calls pick one from a table once,
+    // so the loops themselves carry no option checks
+    template <bool Phonetic, bool Partial>
+    Score scoreCandidate(const std::string& query, const EditDistance::Pattern& queryPattern,
+                         const std::string& candidate, const std::string& normCandidate) const;
+    template <bool Phonetic, bool Partial, bool EarlyStop>
+    std::vector<FuzzyMatch> findMatchesWith(const std::string& query, const std::vector<std::string>& candidates,
+                                            const SearchContext& context) const;
 
 public:
     FuzzySearch();
     explicit FuzzySearch(const FuzzySearchOptions& opts);
     
     // Main fuzzy matching function
-    std::vector<FuzzyMatch> findMatches(const std::string& query, const std::vector<std::string>& candidates) const;
+    std::vector<FuzzyMatch> findMatches(const std::string& query, const std::vector<std::string>& candidates,
+                                        const SearchContext& context = SearchContext()) const;
     
-    // Fuzzy book name matching
-    std::vector<FuzzyMatch> findBookMatches(const std::string& query, const std::vector<std::string>& bookNames) const;
+    // Fuzzy book name matching. soundAlikes are the names a phonetic index
+    // found for query (see BookResolver::soundsLike); they match as "phonetic".
+    std::vector<FuzzyMatch> findBookMatches(const std::string& query, const std::vector<std::string>& bookNames,
+                                            const std::vector<std::string>& soundAlikes = {}) const;
     
     // Single string fuzzy match
     FuzzyMatch calculateMatch(const std::string& query, const std::string& candidate) const;
@@ -1,5 +1,6 @@
 #include "HealthMonitor.h"
 #include "ReliabilityManager.h"
+#include "TaskScheduler.h"
 #include <iostream>
 #include <filesystem>
 #include <fstream>
@@ -77,8 +78,17 @@ bool HealthMonitor::startMonitoring() {
     }
     
     try {
+        {
+            // Sample and run every test once straight away, then on their own timers
+            std::lock_guard<std::mutex> lock(schedule->mutex);
+            auto now = std::chrono::steady_clock::now();
+            schedule->next_sample = now;
+            for (auto& [component, check] : schedule->checks) {
+                check.next_run = now;
+            }
+        }
         is_monitoring.store(true);
-        monitoring_thread = std::thread(&HealthMonitor::monitoringLoop, this);
+        monitoring_done = spawn(monitoringLoop(), TaskPriority::BACKGROUND);
         
         std::cout << "Health monitoring started" << std::endl;
         return true;
@@ -95,54 +105,185 @@ void HealthMonitor::stopMonitoring() {
         return;
     }
     
-    is_monitoring.store(false);
+    {
+        std::lock_guard<std::mutex> lock(schedule->mutex);
+        is_monitoring.store(false);
+    }
+    schedule->wake.set();
     
-    if (monitoring_thread.joinable()) {
-        monitoring_thread.join();
+    if (monitoring_done.valid()) {
+        monitoring_done.wait();
     }
     
     std::cout << "Health monitoring stopped" << std::endl;
 }
 
-void HealthMonitor::monitoringLoop() {
+Task<void> HealthMonitor::monitoringLoop() {
+    using Clock = std::chrono::steady_clock;
+    int samples_since_cleanup = 0;
+    
     while (is_monitoring.load()) {
+        std::unique_lock<std::mutex> lock(schedule->mutex);
+        auto now = Clock::now();
+        std::vector<CheckResult> outcomes;
+        
+        // Results of checks that finished on the executor
+        std::vector<CheckResult> finished;
+        finished.swap(schedule->results);
+        for (auto& result : finished) {
+            auto it = schedule->checks.find(result.component);
+            if (it == schedule->checks.end() || !it->second.in_flight || it->second.run_id != result.run_id) {
+                continue; // Unregistered or replaced while it ran
+            }
+            ScheduledCheck& check = it->second;
+            check.in_flight = false;
+            check.next_run = now + check.interval;
+            bool counted = check.timed_out;
+            check.timed_out = false;
+            if (!(counted && !result.passed)) {
+                outcomes.push_back(std::move(result));
+            }
+        }
+        
+        // Start due checks; fail those overrunning their timeout, once per timeout
+        // period, and leave them to finish before they are started again
+        for (auto& [component, check] : schedule->checks) {
+            if (!check.in_flight) {
+                if (now >= check.next_run) launchCheck(component, check);
+            } else if (now >= check.deadline) {
+                check.timed_out = true;
+                check.deadline = now + check.timeout;
+                outcomes.push_back({component, check.run_id, false,
+                                    "Health check timed out after " + std::to_string(check.timeout.count()) + " ms",
+                                    static_cast<double>(check.timeout.count())});
+            }
+        }
+        
+        // Missed heartbeats count as failures, one per timeout period
+        for (auto& [component, watch] : schedule->heartbeats) {
+            if (now >= watch.deadline) {
+                watch.overdue = true;
+                watch.deadline = now + watch.timeout;
+                outcomes.push_back({component, 0, false,
+                                    "No heartbeat for " + std::to_string(watch.timeout.count()) + " ms", 0.0});
+            }
+        }
+        
+        bool sample_due = now >= schedule->next_sample;
+        if (sample_due) {
+            schedule->next_sample = now + monitoring_interval;
+        }
+        
+        lock.unlock();
         try {
-            // Update performance metrics
-            updatePerformanceMetrics();
-            
-            // Check all registered components
-            performHealthCheck();
-            
-            // Check thresholds and create alerts if necessary
-            checkThresholds();
-            
-            // Cleanup old data periodically
-            static int cleanup_counter = 0;
-            if (++cleanup_counter >= 60) { // Every 5 minutes at 5-second intervals
-                cleanupOldData();
-                cleanup_counter = 0;
+            for (const auto& outcome : outcomes) {
+                recordCheckResult(outcome.component, outcome.passed, outcome.error, outcome.response_time_ms);
             }
             
-            // Notify performance callback
-            if (performance_callback) {
-                performance_callback(current_metrics);
+            if (sample_due) {
+                updatePerformanceMetrics();
+                checkThresholds();
+                
+                // Cleanup old data periodically
+                if (++samples_since_cleanup >= 60) { // Every 5 minutes at 5-second intervals
+                    cleanupOldData();
+                    samples_since_cleanup = 0;
+                }
+                
+                if (performance_callback) {
+                    performance_callback(getCurrentMetrics());
+                }
             }
-            
         } catch (const std::exception& e) {
             std::cerr << "Error in health monitoring loop: " << e.what() << std::endl;
         }
+        lock.lock();
         
-        // Sleep for monitoring interval
-        std::this_thread::sleep_for(monitoring_interval);
+        // Sleep until the next timer, or until a check finishes or stop is called
+        if (!is_monitoring.load() || !schedule->results.empty()) {
+            continue;
+        }
+        Clock::time_point wake_at = schedule->next_sample;
+        for (const auto& [component, check] : schedule->checks) {
+            wake_at = std::min(wake_at, check.in_flight ? check.deadline : check.next_run);
+        }
+        for (const auto& [component, watch] : schedule->heartbeats) {
+            wake_at = std::min(wake_at, watch.deadline);
+        }
+        lock.unlock();
+        co_await schedule->wake.waitUntil(wake_at, TaskPriority::BACKGROUND);
     }
 }
 
-void HealthMonitor::registerComponentTest(SystemComponent component, std::function<bool()> test_function) {
-    component_tests[component] = test_function;
+void HealthMonitor::launchCheck(SystemComponent component, ScheduledCheck& check) {
+    // Called with schedule->mutex held
+    check.in_flight = true;
+    check.timed_out = false;
+    check.run_id = ++schedule->last_run_id;
+    check.deadline = std::chrono::steady_clock::now() + check.timeout;
+    
+    // The task keeps the schedule alive, so a check outliving the monitor is harmless
+    TaskScheduler::shared().post([schedule = schedule, test = check.test, component, run_id = check.run_id]() {
+        auto start_time = std::chrono::steady_clock::now();
+        bool passed = false;
+        std::string error;
+        try {
+            passed = test();
+        } catch (const std::exception& e) {
+            error = e.what();
+        } catch (...) {
+            error = "unknown exception";
+        }
+        double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+        
+        std::lock_guard<std::mutex> lock(schedule->mutex);
+        schedule->results.push_back({component, run_id, passed,
+                                     error.empty() ? "" : "Health check exception: " + error, elapsed_ms});
+        schedule->wake.set();
+    }, TaskPriority::BACKGROUND);
+}
+
+void HealthMonitor::registerComponentTest(SystemComponent component, std::function<bool()> test_function,
+                                          std::chrono::milliseconds interval, std::chrono::milliseconds timeout) {
+    {
+        std::lock_guard<std::mutex> lock(schedule->mutex);
+        ScheduledCheck& check = schedule->checks[component];
+        check = ScheduledCheck();
+        check.test = std::move(test_function);
+        check.interval = interval.count() > 0 ? interval : std::chrono::milliseconds(check_interval);
+        check.timeout = timeout.count() > 0 ? timeout : std::chrono::milliseconds(component_timeout);
+        check.next_run = std::chrono::steady_clock::now();
+    }
+    schedule->wake.set();
 }
 
 void HealthMonitor::unregisterComponentTest(SystemComponent component) {
-    component_tests.erase(component);
+    std::lock_guard<std::mutex> lock(schedule->mutex);
+    schedule->checks.erase(component);
+}
+
+void HealthMonitor::expectHeartbeat(SystemComponent component, std::chrono::milliseconds timeout) {
+    {
+        std::lock_guard<std::mutex> lock(schedule->mutex);
+        HeartbeatWatch& watch = schedule->heartbeats[component];
+        watch.timeout = timeout;
+        watch.deadline = std::chrono::steady_clock::now() + timeout;
+    }
+    schedule->wake.set();
+}
+
+void HealthMonitor::reportHeartbeat(SystemComponent component) {
+    bool resumed = false;
+    {
+        std::lock_guard<std::mutex> lock(schedule->mutex);
+        auto it = schedule->heartbeats.find(component);
+        if (it == schedule->heartbeats.end()) return;
+        it->second.deadline = std::chrono::steady_clock::now() + it->second.timeout;
+        resumed = std::exchange(it->second.overdue, false);
+    }
+    if (resumed) {
+        recordCheckResult(component, true, "", 0.0);
+    }
 }
 
 void HealthMonitor::registerDefaultTests() {
@@ -193,79 +334,89 @@ void HealthMonitor::registerDefaultTests() {
 }
 
 bool HealthMonitor::performHealthCheck() {
-    bool overall_healthy = true;
+    if (is_monitoring.load()) {
+        // Bring every idle check forward; results arrive in the background
+        {
+            std::lock_guard<std::mutex> lock(schedule->mutex);
+            auto now = std::chrono::steady_clock::now();
+            for (auto& [component, check] : schedule->checks) {
+                if (!check.in_flight) check.next_run = now;
+            }
+        }
+        schedule->wake.set();
+    } else {
+        // Not monitoring, so run the tests here
+        std::vector<std::pair<SystemComponent, std::function<bool()>>> tests;
+        {
+            std::lock_guard<std::mutex> lock(schedule->mutex);
+            for (const auto& [component, check] : schedule->checks) {
+                tests.emplace_back(component, check.test);
+            }
+        }
+        for (const auto& [component, test] : tests) {
+            auto start_time = std::chrono::steady_clock::now();
+            bool passed = false;
+            std::string error;
+            try {
+                passed = test();
+            } catch (const std::exception& e) {
+                error = "Health check exception: " + std::string(e.what());
+            }
+            recordCheckResult(component, passed, error,
+                              std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count());
+        }
+    }
     
     std::lock_guard<std::mutex> lock(health_mutex);
+    for (const auto& [component, health] : component_health) {
+        if (!health.is_healthy) return false;
+    }
+    return true;
+}
+
+void HealthMonitor::recordCheckResult(SystemComponent component, bool passed, const std::string& message,
+                                      double response_time_ms) {
+    std::lock_guard<std::mutex> lock(health_mutex);
     
-    for (auto& [component, health] : component_health) {
-        bool was_healthy = health.is_healthy;
-        
-        // Check if we have a test for this component
-        auto test_it = component_tests.find(component);
-        if (test_it != component_tests.end()) {
-            try {
-                auto start_time = std::chrono::high_resolution_clock::now();
-                bool test_result = test_it->second();
-                auto end_time = std::chrono::high_resolution_clock::now();
-                
-                health.response_time_ms = std::chrono::duration<double, std::milli>(end_time - start_time).count();
-                
-                if (test_result) {
-                    if (!was_healthy) {
-                        // Component recovered
-                        health.is_healthy = true;
-                        health.status_message = "Component recovered";
-                        health.consecutive_failures = 0;
-                        
-                        if (component_status_callback) {
-                            component_status_callback(component, true);
-                        }
-                    } else {
-                        health.status_message = "Component healthy";
-                    }
-                } else {
-                    // Component failed test
-                    health.consecutive_failures++;
-                    health.total_failures++;
-                    health.last_issue = std::chrono::system_clock::now();
-                    
-                    if (health.consecutive_failures >= max_consecutive_failures) {
-                        health.is_healthy = false;
-                        health.status_message = "Component failed health check";
-                        
-                        if (was_healthy && component_status_callback) {
-                            component_status_callback(component, false);
-                        }
-                        
-                        // Create alert for component failure
-                        createAlert(component, "Component health check failed", "error");
-                    }
-                }
-                
-            } catch (const std::exception& e) {
-                health.consecutive_failures++;
-                health.total_failures++;
-                health.last_issue = std::chrono::system_clock::now();
-                health.status_message = "Health check exception: " + std::string(e.what());
-                
-                if (health.consecutive_failures >= max_consecutive_failures) {
-                    health.is_healthy = false;
-                    
-                    if (was_healthy && component_status_callback) {
-                        component_status_callback(component, false);
-                    }
-                }
+    auto& health = component_health[component];
+    bool was_healthy = health.is_healthy;
+    health.response_time_ms = response_time_ms;
+    health.last_check = std::chrono::system_clock::now();
+    
+    if (passed) {
+        health.consecutive_failures = 0;
+        if (!was_healthy) {
+            // Component recovered
+            health.is_healthy = true;
+            health.status_message = "Component recovered";
+            
+            if (component_status_callback) {
+                component_status_callback(component, true);
             }
+        } else {
+            health.status_message = "Component healthy";
         }
+        return;
+    }
+    
+    // Component failed test
+    health.consecutive_failures++;
+    health.total_failures++;
+    health.last_issue = std::chrono::system_clock::now();
+    health.status_message = message.empty() ? "Component failed health check" : message;
+    
+    if (health.consecutive_failures >= max_consecutive_failures) {
+        health.is_healthy = false;
         
-        health.last_check = std::chrono::system_clock::now();
+        if (was_healthy && component_status_callback) {
+            component_status_callback(component, false);
+        }
         
-        if (!health.is_healthy) {
-            overall_healthy = false;
+        // Create alert for component failure
+        if (was_healthy) {
+            createAlert(component, health.status_message, "error");
         }
     }
-    
-    return overall_healthy;
 }
 
 bool HealthMonitor::isComponentHealthy(SystemComponent component) {
@@ -330,19 +481,43 @@ void HealthMonitor::updatePerformanceMetrics() {
     new_metrics.open_file_handles = getCurrentFileHandleCount();
     new_metrics.network_latency_ms = measureNetworkLatency();
     
+    // Share of frames since the last sample that overran the budget
+    uint64_t frames = frames_reported.exchange(0, std::memory_order_relaxed);
+    uint64_t slow_frames = frames_over_budget.exchange(0, std::memory_order_relaxed);
+    if (frames > 0) {
+        new_metrics.frame_time_violation_percent = 100.0 * static_cast<double>(slow_frames) / static_cast<double>(frames);
+    }
+    
     // Calculate uptime
     static auto start_time = std::chrono::system_clock::now();
     new_metrics.uptime = std::chrono::duration_cast<std::chrono::milliseconds>(
         std::chrono::system_clock::now() - start_time);
     
-    // Update current metrics
+    std::lock_guard<std::mutex> lock(metrics_mutex);
     current_metrics = new_metrics;
     
-    // Add to history
-    metrics_history.push_back(new_metrics);
-    if (metrics_history.size() > static_cast<size_t>(max_metrics_history)) {
-        metrics_history.erase(metrics_history.begin());
+    // Overwrite the oldest sample once the ring is full
+    size_t capacity = static_cast<size_t>(max_metrics_history);
+    if (metrics_history.size() < capacity) {
+        metrics_history.push_back(new_metrics);
+    } else {
+        metrics_history[metrics_next] = new_metrics;
+    }
+    metrics_next = (metrics_next + 1) % capacity;
+}
+
+void HealthMonitor::resizeMetricsHistory(size_t capacity) {
+    // Called with metrics_mutex held; keeps the newest samples, oldest first
+    std::vector<PerformanceMetrics> kept;
+    size_t size = metrics_history.size();
+    size_t keep = std::min(size, capacity);
+    kept.reserve(capacity);
+    for (size_t k = size - keep; k < size; ++k) {
+        kept.push_back(metrics_history[(metrics_next + k) % size]);
     }
+    metrics_history = std::move(kept);
+    metrics_next = metrics_history.size() % capacity;
+    max_metrics_history = static_cast<int>(capacity);
 }
 
 void HealthMonitor::checkThresholds() {
@@ -378,6 +553,17 @@ void HealthMonitor::checkThresholds() {
                    "Disk usage high: " + std::to_string(current_metrics.disk_usage_percent) + "%", 
                    "warning");
     }
+    
+    // Check frame times
+    if (current_metrics.frame_time_violation_percent > frame_violation_critical_threshold) {
+        createAlert(SystemComponent::UI_SYSTEM, 
+                   "Slow frames critical: " + std::to_string(current_metrics.frame_time_violation_percent) + "%", 
+                   "critical");
+    } else if (current_metrics.frame_time_violation_percent > frame_violation_warning_threshold) {
+        createAlert(SystemComponent::UI_SYSTEM, 
+                   "Slow frames high: " + std::to_string(current_metrics.frame_time_violation_percent) + "%", 
+                   "warning");
+    }
 }
 
 void HealthMonitor::createAlert(SystemComponent component, const std::string& message, 
@@ -672,22 +858,43 @@ double HealthMonitor::measureNetworkLatency() {
 // Public interface methods
 
 PerformanceMetrics HealthMonitor::getCurrentMetrics() {
+    std::lock_guard<std::mutex> lock(metrics_mutex);
     return current_metrics;
 }
 
 std::vector<PerformanceMetrics> HealthMonitor::getMetricsHistory(int count) {
+    std::lock_guard<std::mutex> lock(metrics_mutex);
     if (count <= 0 || metrics_history.empty()) {
         return {};
     }
     
-    int start = std::max(0, static_cast<int>(metrics_history.size()) - count);
-    return std::vector<PerformanceMetrics>(metrics_history.begin() + start, metrics_history.end());
+    // Oldest first; before the ring fills metrics_next is the end of the vector
+    size_t size = metrics_history.size();
+    size_t n = std::min(size, static_cast<size_t>(count));
+    std::vector<PerformanceMetrics> history;
+    history.reserve(n);
+    for (size_t k = size - n; k < size; ++k) {
+        history.push_back(metrics_history[(metrics_next + k) % size]);
+    }
+    return history;
 }
 
 bool HealthMonitor::isPerformanceWithinThresholds() {
     return current_metrics.cpu_usage < cpu_warning_threshold &&
            current_metrics.memory_usage_percent < memory_warning_threshold &&
-           current_metrics.disk_usage_percent < disk_warning_threshold;
+           current_metrics.disk_usage_percent < disk_warning_threshold &&
+           current_metrics.frame_time_violation_percent < frame_violation_warning_threshold;
+}
+
+void HealthMonitor::reportFrameTime(std::chrono::microseconds frame_time) {
+    frames_reported.fetch_add(1, std::memory_order_relaxed);
+    if (frame_time.count() > frame_budget_us.load(std::memory_order_relaxed)) {
+        frames_over_budget.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void HealthMonitor::setFrameTimeBudget(std::chrono::microseconds budget) {
+    frame_budget_us.store(budget.count(), std::memory_order_relaxed);
 }
 
 ComponentHealth HealthMonitor::getComponentHealth(SystemComponent component) {
@@ -780,6 +987,10 @@ void HealthMonitor::setMonitoringInterval(std::chrono::seconds interval) {
     monitoring_interval = interval;
 }
 
+void HealthMonitor::setCheckInterval(std::chrono::seconds interval) {
+    check_interval = interval;
+}
+
 void HealthMonitor::setComponentTimeout(std::chrono::seconds timeout) {
     component_timeout = timeout;
 }
@@ -839,6 +1050,7 @@ std::string HealthMonitor::generateReport() {
            << current_metrics.memory_usage_percent << "%)\n";
     report << "  Disk Usage: " << std::fixed << std::setprecision(1) << current_metrics.disk_usage_percent << "%\n";
     report << "  Active Threads: " << current_metrics.active_threads << "\n";
+    report << "  Slow Frames: " << std::fixed << std::setprecision(1) << current_metrics.frame_time_violation_percent << "%\n";
     report << "  Uptime: " << current_metrics.uptime.count() / 1000 << " seconds\n";
     
     // Component health
@@ -940,11 +1152,8 @@ void HealthMonitor::optimizePerformance() {
     
     // Reduce metrics history if memory usage is high
     if (current_metrics.memory_usage_percent > memory_warning_threshold) {
-        max_metrics_history = std::max(10, max_metrics_history / 2);
-        if (metrics_history.size() > static_cast<size_t>(max_metrics_history)) {
-            metrics_history.erase(metrics_history.begin(), 
-                                 metrics_history.end() - max_metrics_history);
-        }
+        std::lock_guard<std::mutex> lock(metrics_mutex);
+        resizeMetricsHistory(static_cast<size_t>(std::max(10, max_metrics_history / 2)));
     }
 }
 
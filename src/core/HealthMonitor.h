@@ -4,12 +4,14 @@
 #include <string>
 #include <chrono>
 #include <atomic>
-#include <thread>
+#include <future>
 #include <mutex>
+#include <memory>
 #include <map>
 #include <vector>
 #include <functional>
 #include "nlohmann/json.hpp"
+#include "Task.h"
 
 using json = nlohmann::json;
 
@@ -35,6 +37,7 @@ struct PerformanceMetrics {
     int active_threads = 0;
     int open_file_handles = 0;
     double network_latency_ms = 0.0;
+    double frame_time_violation_percent = 0.0; // of UI frames since the last sample that overran the budget
     std::chrono::milliseconds uptime{0};
 };
 
@@ -48,20 +51,67 @@ struct HealthAlert {
     json additional_data;
 };
 
+// Health of the application's components and of the machine. Nothing is
+// polled in lockstep: every component test runs on its own timer, on the
+// shared TaskScheduler, and fails if it overruns its timeout, so one slow
+// test holds up no other. Components can also push their state instead of
+// being polled, through heartbeats or issue/recovery reports. The monitor
+// itself is a coroutine on the scheduler, suspended until the next timer is
+// due, so it holds no thread between rounds.
 class HealthMonitor {
 private:
+    struct ScheduledCheck {
+        std::function<bool()> test;
+        std::chrono::milliseconds interval{0};
+        std::chrono::milliseconds timeout{0};
+        std::chrono::steady_clock::time_point next_run;
+        std::chrono::steady_clock::time_point deadline; // of the run in flight
+        uint64_t run_id = 0;
+        bool in_flight = false;
+        bool timed_out = false; // the run in flight has been counted as failed
+    };
+    
+    struct HeartbeatWatch {
+        std::chrono::milliseconds timeout{0};
+        std::chrono::steady_clock::time_point deadline; // next beat due by
+        bool overdue = false;
+    };
+    
+    struct CheckResult {
+        SystemComponent component;
+        uint64_t run_id;
+        bool passed;
+        std::string error;
+        double response_time_ms;
+    };
+    
+    // Timers and finished checks. Shared with checks still running on the
+    // executor, so a check that outlives the monitor has somewhere to report.
+    struct Schedule {
+        std::mutex mutex;
+        AsyncEvent wake;
+        std::map<SystemComponent, ScheduledCheck> checks;
+        std::map<SystemComponent, HeartbeatWatch> heartbeats;
+        std::vector<CheckResult> results;
+        std::chrono::steady_clock::time_point next_sample;
+        uint64_t last_run_id = 0;
+    };
+    
     std::atomic<bool> is_initialized{false};
     std::atomic<bool> is_monitoring{false};
-    std::thread monitoring_thread;
+    std::future<void> monitoring_done;
     std::mutex health_mutex;
     std::mutex alerts_mutex;
+    std::shared_ptr<Schedule> schedule = std::make_shared<Schedule>();
     
     // Component health tracking
     std::map<SystemComponent, ComponentHealth> component_health;
     
-    // Performance monitoring
+    // Performance monitoring; the history is a ring of the last max_metrics_history samples
+    std::mutex metrics_mutex;
     PerformanceMetrics current_metrics;
     std::vector<PerformanceMetrics> metrics_history;
+    size_t metrics_next = 0; // slot of the oldest sample once the ring is full
     int max_metrics_history = 100;
     
     // Alerts and notifications
@@ -70,8 +120,9 @@ private:
     int max_alert_history = 500;
     
     // Monitoring configuration
-    std::chrono::seconds monitoring_interval{5};
-    std::chrono::seconds component_timeout{30};
+    std::chrono::seconds monitoring_interval{5};  // between performance samples
+    std::chrono::seconds check_interval{30};      // default between runs of one component test
+    std::chrono::seconds component_timeout{5};    // default limit on one test run
     int max_consecutive_failures = 3;
     
     // Thresholds
@@ -83,19 +134,26 @@ private:
     double disk_critical_threshold = 95.0;
     double response_time_warning_threshold = 1000.0; // ms
     double response_time_critical_threshold = 5000.0; // ms
+    double frame_violation_warning_threshold = 10.0; // percent of frames
+    double frame_violation_critical_threshold = 30.0;
+    
+    // UI frame times, reported by the render loop and drained at each sample
+    std::atomic<int64_t> frame_budget_us{33333}; // 30 fps
+    std::atomic<uint64_t> frames_reported{0};
+    std::atomic<uint64_t> frames_over_budget{0};
     
     // Callbacks for notifications
     std::function<void(const HealthAlert&)> alert_callback;
     std::function<void(SystemComponent, bool)> component_status_callback;
     std::function<void(const PerformanceMetrics&)> performance_callback;
     
-    // Component test functions
-    std::map<SystemComponent, std::function<bool()>> component_tests;
-    
     // Internal methods
-    void monitoringLoop();
-    bool checkComponentHealth(SystemComponent component);
+    Task<void> monitoringLoop();
+    void launchCheck(SystemComponent component, ScheduledCheck& check);
+    void recordCheckResult(SystemComponent component, bool passed, const std::string& message,
+                           double response_time_ms);
     void updatePerformanceMetrics();
+    void resizeMetricsHistory(size_t capacity);
     void checkThresholds();
     void createAlert(SystemComponent component, const std::string& message, 
                     const std::string& severity, const json& data = json::object());
@@ -121,13 +179,22 @@ public:
     bool startMonitoring();
     void stopMonitoring();
     
-    // Component registration and testing
-    void registerComponentTest(SystemComponent component, std::function<bool()> test_function);
+    // Component registration and testing. A zero interval or timeout takes
+    // the monitor's defaults (check_interval, component_timeout).
+    void registerComponentTest(SystemComponent component, std::function<bool()> test_function,
+                               std::chrono::milliseconds interval = std::chrono::milliseconds::zero(),
+                               std::chrono::milliseconds timeout = std::chrono::milliseconds::zero());
     void unregisterComponentTest(SystemComponent component);
     void registerDefaultTests();
+    // Runs every test now (in the background while monitoring) and returns the health known so far
     bool performHealthCheck();
     bool isComponentHealthy(SystemComponent component);
     
+    // Push path: after expectHeartbeat(), a component that goes longer than
+    // timeout without reportHeartbeat() is failed, and recovers on its next beat
+    void expectHeartbeat(SystemComponent component, std::chrono::milliseconds timeout);
+    void reportHeartbeat(SystemComponent component);
+    
     // Component issue reporting
     void reportComponentIssue(SystemComponent component, const std::string& issue);
     void reportComponentRecovery(SystemComponent component);
@@ -138,6 +205,10 @@ public:
     std::vector<PerformanceMetrics> getMetricsHistory(int count = 10);
     bool isPerformanceWithinThresholds();
     
+    // Frame-time violations: call once per rendered frame, from any thread
+    void reportFrameTime(std::chrono::microseconds frame_time);
+    void setFrameTimeBudget(std::chrono::microseconds budget);
+    
     // Health status
     ComponentHealth getComponentHealth(SystemComponent component);
     std::map<SystemComponent, ComponentHealth> getAllComponentHealth();
@@ -154,6 +225,7 @@ public:
     // Configuration
     void setMonitoringInterval(std::chrono::seconds interval);
     void setComponentTimeout(std::chrono::seconds timeout);
+    void setCheckInterval(std::chrono::seconds interval);
     void setMaxConsecutiveFailures(int max_failures);
     void setCPUThresholds(double warning, double critical);
     void setMemoryThresholds(double warning, double critical);
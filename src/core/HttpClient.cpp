@@ -1,158 +1,500 @@
 #include "HttpClient.h"
+#include "MetricsRegistry.h"
+#include "TaskScheduler.h"
 #include <curl/curl.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cctype>
+#include <cstdio>
+#include <deque>
 #include <iostream>
-#include <fstream>
+#include <mutex>
+#include <string_view>
 #include <thread>
-#include <future>
+#include <unordered_map>
 
-struct HttpClient::Impl {
-    CURL* curl;
-    long timeout;
+namespace {
+
+constexpr long CONNECT_TIMEOUT_SECONDS = 10;
+constexpr long MAX_HOST_CONNECTIONS = 6;   // HTTP/1.1 fallback; HTTP/2 multiplexes onto one
+constexpr size_t MAX_IDLE_HANDLES = 16;
+constexpr long IDLE_POLL_MS = 1000;
+
+} // namespace
+
+// Guarded by the loop's mutex
+struct HttpClient::Lane {
+    std::string name;
+    size_t max_concurrent;
+    long timeout = 30;
+    std::string user_agent = "VerseFinder/2.0";
+    std::deque<std::shared_ptr<Transfer>> queued;
+    size_t active = 0; // popped from queued and not yet finished
+    bool closed = false;
+    Histogram* latency = nullptr;
+    Counter* failures = nullptr;
+};
+
+struct HttpClient::Transfer {
+    Request request;
+    std::shared_ptr<Lane> lane;
+    long timeout = 0;
     std::string user_agent;
-    
-    Impl() : curl(nullptr), timeout(30), user_agent("VerseFinder/2.0") {
-        curl = curl_easy_init();
-        if (!curl) {
-            throw std::runtime_error("Failed to initialize libcurl");
+    FILE* file = nullptr; // body goes here instead of into the response
+    ProgressCallback on_progress;
+    std::function<void(Response)> complete; // run on the loop thread
+    Response response;
+    curl_slist* header_list = nullptr;
+    char error_buffer[CURL_ERROR_SIZE] = {};
+    std::chrono::steady_clock::time_point started;
+};
+
+class HttpClient::Loop {
+public:
+    static Loop& shared() {
+        static Loop loop;
+        return loop;
+    }
+
+    void add(const std::shared_ptr<Lane>& lane) {
+        std::lock_guard<std::mutex> lock(mutex);
+        lanes.push_back(lane);
+    }
+
+    void submit(const std::shared_ptr<Transfer>& transfer) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Lane& lane = *transfer->lane;
+            if (!lane.closed) {
+                transfer->timeout = lane.timeout;
+                transfer->user_agent = lane.user_agent;
+                lane.queued.push_back(transfer);
+                curl_multi_wakeup(multi);
+                return;
+            }
+        }
+        fail(*transfer, "HTTP client closed");
+    }
+
+    template <typename Update>
+    void configure(const std::shared_ptr<Lane>& lane, Update update) {
+        std::lock_guard<std::mutex> lock(mutex);
+        update(*lane);
+        curl_multi_wakeup(multi); // a higher limit may admit queued transfers
+    }
+
+    // Fails what the lane has queued, aborts what it has running and waits
+    // until the loop has let go of all of it
+    void close(const std::shared_ptr<Lane>& lane) {
+        std::deque<std::shared_ptr<Transfer>> dropped;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            lane->closed = true;
+            dropped.swap(lane->queued);
+            std::erase(lanes, lane);
+            curl_multi_wakeup(multi);
+            lane_idle.wait(lock, [&]() { return lane->active == 0; });
+        }
+        for (const auto& transfer : dropped) {
+            fail(*transfer, "Request cancelled");
+        }
+    }
+
+private:
+    CURLM* multi = nullptr;
+    CURLSH* share = nullptr;
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable lane_idle;
+    std::vector<std::shared_ptr<Lane>> lanes;
+    bool stopping = false;
+
+    // Loop thread only
+    std::unordered_map<CURL*, std::shared_ptr<Transfer>> running;
+    std::vector<CURL*> idle_handles;
+
+    Loop() {
+        // Completions post to these, so they must outlive the loop
+        TaskScheduler::shared();
+        MetricsRegistry::shared();
+
+        curl_global_init(CURL_GLOBAL_DEFAULT);
+        multi = curl_multi_init();
+        curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, MAX_HOST_CONNECTIONS);
+
+        // Every handle is driven from the loop thread, so the share needs no lock callbacks
+        share = curl_share_init();
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+        thread = std::thread([this]() { run(); });
+    }
+
+    ~Loop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            curl_multi_wakeup(multi);
+        }
+        thread.join();
+
+        for (auto& [easy, transfer] : running) {
+            curl_multi_remove_handle(multi, easy);
+            curl_easy_cleanup(easy);
+            curl_slist_free_all(transfer->header_list);
+            fail(*transfer, "HTTP client shutting down");
+        }
+        for (CURL* easy : idle_handles) {
+            curl_easy_cleanup(easy);
+        }
+        for (const auto& lane : lanes) {
+            for (const auto& transfer : lane->queued) {
+                fail(*transfer, "HTTP client shutting down");
+            }
+        }
+        curl_multi_cleanup(multi);
+        curl_share_cleanup(share);
+        curl_global_cleanup();
+    }
+
+    static void fail(Transfer& transfer, const std::string& error) {
+        Response response;
+        response.error = error;
+        transfer.lane->failures->add();
+        transfer.complete(std::move(response));
+    }
+
+    void run() {
+        while (true) {
+            std::vector<std::shared_ptr<Transfer>> starting;
+            std::vector<CURL*> cancelled;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (stopping) return;
+                for (const auto& lane : lanes) {
+                    while (!lane->queued.empty() && lane->active < lane->max_concurrent) {
+                        starting.push_back(std::move(lane->queued.front()));
+                        lane->queued.pop_front();
+                        lane->active++;
+                    }
+                }
+                for (const auto& [easy, transfer] : running) {
+                    if (transfer->lane->closed) cancelled.push_back(easy);
+                }
+            }
+
+            for (CURL* easy : cancelled) {
+                finish(easy, CURLE_ABORTED_BY_CALLBACK);
+            }
+            for (auto& transfer : starting) {
+                start(std::move(transfer));
+            }
+
+            int still_running = 0;
+            curl_multi_perform(multi, &still_running);
+            int queued_messages = 0;
+            while (CURLMsg* message = curl_multi_info_read(multi, &queued_messages)) {
+                if (message->msg == CURLMSG_DONE) {
+                    finish(message->easy_handle, message->data.result);
+                }
+            }
+
+            curl_multi_poll(multi, nullptr, 0, IDLE_POLL_MS, nullptr);
+        }
+    }
+
+    static size_t writeBody(char* data, size_t size, size_t count, void* user) {
+        auto* transfer = static_cast<Transfer*>(user);
+        size_t bytes = size * count;
+        if (transfer->file) {
+            return fwrite(data, 1, bytes, transfer->file);
         }
+        transfer->response.body.append(data, bytes);
+        return bytes;
     }
-    
-    ~Impl() {
-        if (curl) {
-            curl_easy_cleanup(curl);
+
+    static size_t readHeader(char* data, size_t size, size_t count, void* user) {
+        auto* transfer = static_cast<Transfer*>(user);
+        size_t bytes = size * count;
+        std::string_view line(data, bytes);
+        while (!line.empty() && (line.back() == '\r' || line.back() == '\n')) line.remove_suffix(1);
+
+        auto& headers = transfer->response.headers;
+        if (line.starts_with("HTTP/")) {
+            headers.clear(); // a new response after a redirect or 100 Continue
+            return bytes;
+        }
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) return bytes;
+        std::string name(line.substr(0, colon));
+        std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+        std::string_view value = line.substr(colon + 1);
+        while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+        headers.emplace_back(std::move(name), std::string(value));
+        return bytes;
+    }
+
+    static int reportProgress(void* user, curl_off_t total, curl_off_t now, curl_off_t, curl_off_t) {
+        auto* transfer = static_cast<Transfer*>(user);
+        if (total > 0) {
+            transfer->on_progress(static_cast<double>(now) / static_cast<double>(total));
+        }
+        return 0;
+    }
+
+    void start(std::shared_ptr<Transfer> transfer) {
+        CURL* easy = nullptr;
+        if (!idle_handles.empty()) {
+            easy = idle_handles.back();
+            idle_handles.pop_back();
+            curl_easy_reset(easy);
+        } else {
+            easy = curl_easy_init();
+        }
+        if (!easy) {
+            release(*transfer);
+            fail(*transfer, "Failed to initialize libcurl");
+            return;
+        }
+
+        const Request& request = transfer->request;
+        curl_easy_setopt(easy, CURLOPT_URL, request.url.c_str());
+        curl_easy_setopt(easy, CURLOPT_SHARE, share);
+        curl_easy_setopt(easy, CURLOPT_PRIVATE, transfer.get());
+        curl_easy_setopt(easy, CURLOPT_ERRORBUFFER, transfer->error_buffer);
+        curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, writeBody);
+        curl_easy_setopt(easy, CURLOPT_WRITEDATA, transfer.get());
+        curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, readHeader);
+        curl_easy_setopt(easy, CURLOPT_HEADERDATA, transfer.get());
+        curl_easy_setopt(easy, CURLOPT_TIMEOUT, transfer->timeout);
+        curl_easy_setopt(easy, CURLOPT_CONNECTTIMEOUT, CONNECT_TIMEOUT_SECONDS);
+        curl_easy_setopt(easy, CURLOPT_USERAGENT, transfer->user_agent.c_str());
+        curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+        curl_easy_setopt(easy, CURLOPT_SSL_VERIFYPEER, 1L);
+        curl_easy_setopt(easy, CURLOPT_SSL_VERIFYHOST, 2L);
+        curl_easy_setopt(easy, CURLOPT_ACCEPT_ENCODING, "");
+        curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+        // Wait for an HTTP/2 connection being set up to this host rather than opening another
+        curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);
+
+        if (request.method == "POST") {
+            curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request.body.data());
+            curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(request.body.size()));
+        } else if (request.method != "GET") {
+            curl_easy_setopt(easy, CURLOPT_CUSTOMREQUEST, request.method.c_str());
+            if (!request.body.empty()) {
+                curl_easy_setopt(easy, CURLOPT_POSTFIELDS, request.body.data());
+                curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(request.body.size()));
+            }
+        }
+        for (const std::string& header : request.headers) {
+            transfer->header_list = curl_slist_append(transfer->header_list, header.c_str());
+        }
+        if (transfer->header_list) {
+            curl_easy_setopt(easy, CURLOPT_HTTPHEADER, transfer->header_list);
+        }
+        if (transfer->on_progress) {
+            curl_easy_setopt(easy, CURLOPT_NOPROGRESS, 0L);
+            curl_easy_setopt(easy, CURLOPT_XFERINFOFUNCTION, reportProgress);
+            curl_easy_setopt(easy, CURLOPT_XFERINFODATA, transfer.get());
+        }
+
+        transfer->started = std::chrono::steady_clock::now();
+        curl_multi_add_handle(multi, easy);
+        running.emplace(easy, std::move(transfer));
+    }
+
+    void finish(CURL* easy, CURLcode result) {
+        auto it = running.find(easy);
+        if (it == running.end()) return;
+        std::shared_ptr<Transfer> transfer = std::move(it->second);
+        running.erase(it);
+
+        curl_multi_remove_handle(multi, easy);
+        Response response = std::move(transfer->response);
+        if (result == CURLE_OK) {
+            curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &response.status);
+        } else if (result == CURLE_ABORTED_BY_CALLBACK) {
+            response.error = "Request cancelled";
+        } else {
+            response.error = transfer->error_buffer[0] ? transfer->error_buffer : curl_easy_strerror(result);
+        }
+        curl_slist_free_all(transfer->header_list);
+        transfer->header_list = nullptr;
+        if (idle_handles.size() < MAX_IDLE_HANDLES) {
+            idle_handles.push_back(easy);
+        } else {
+            curl_easy_cleanup(easy);
+        }
+
+        transfer->lane->latency->observe(std::chrono::steady_clock::now() - transfer->started);
+        if (!response.ok()) {
+            transfer->lane->failures->add();
         }
+        release(*transfer);
+        transfer->complete(std::move(response));
+    }
+
+    void release(Transfer& transfer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        transfer.lane->active--;
+        lane_idle.notify_all();
     }
 };
 
-HttpClient::HttpClient() : pImpl(std::make_unique<Impl>()) {
+std::string HttpClient::Response::header(const std::string& name) const {
+    for (const auto& [key, value] : headers) {
+        if (key == name) return value;
+    }
+    return "";
 }
 
-HttpClient::~HttpClient() = default;
+HttpClient::HttpClient(const std::string& name, size_t max_concurrent) : lane(std::make_shared<Lane>()) {
+    lane->name = name;
+    lane->max_concurrent = std::max<size_t>(max_concurrent, 1);
+    std::string labels = MetricsRegistry::label("client", name);
+    lane->latency = &MetricsRegistry::shared().histogram(
+        "versefinder_http_request_seconds", "Time from starting an HTTP transfer to its completion", labels);
+    lane->failures = &MetricsRegistry::shared().counter(
+        "versefinder_http_failures_total", "HTTP requests that failed or returned a non-2xx status", labels);
+    Loop::shared().add(lane);
+}
 
-size_t HttpClient::WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-    size_t total_size = size * nmemb;
-    userp->append(static_cast<char*>(contents), total_size);
-    return total_size;
+HttpClient::~HttpClient() {
+    Loop::shared().close(lane);
 }
 
-size_t HttpClient::WriteFileCallback(void* contents, size_t size, size_t nmemb, FILE* userp) {
-    return fwrite(contents, size, nmemb, userp);
+void HttpClient::enqueue(std::shared_ptr<Transfer> transfer) {
+    transfer->lane = lane;
+    Loop::shared().submit(transfer);
 }
 
-int HttpClient::CurlProgressCallback(void* clientp, double dltotal, double dlnow, [[maybe_unused]] double ultotal, [[maybe_unused]] double ulnow) {
-    if (clientp && dltotal > 0) {
-        auto* callback = static_cast<ProgressCallback*>(clientp);
-        if (*callback) {
-            double progress = dlnow / dltotal;
-            (*callback)(progress);
-        }
-    }
-    return 0;
+std::future<HttpClient::Response> HttpClient::send(Request request) {
+    auto promise = std::make_shared<std::promise<Response>>();
+    std::future<Response> result = promise->get_future();
+    auto transfer = std::make_shared<Transfer>();
+    transfer->request = std::move(request);
+    transfer->complete = [promise](Response response) { promise->set_value(std::move(response)); };
+    enqueue(std::move(transfer));
+    return result;
+}
+
+void HttpClient::send(Request request, ResponseCallback onDone) {
+    auto transfer = std::make_shared<Transfer>();
+    transfer->request = std::move(request);
+    transfer->complete = [onDone = std::move(onDone)](Response response) {
+        // Off the network thread, so a slow callback cannot stall other transfers
+        TaskScheduler::shared().post([onDone, response = std::move(response)]() {
+            try {
+                onDone(response);
+            } catch (const std::exception& e) {
+                std::cerr << "HTTP response callback threw: " << e.what() << std::endl;
+            } catch (...) {
+                std::cerr << "HTTP response callback threw" << std::endl;
+            }
+        });
+    };
+    enqueue(std::move(transfer));
+}
+
+Task<HttpClient::Response> HttpClient::fetch(Request request) {
+    TaskPriority priority = TaskScheduler::currentPriority();
+    co_return co_await awaitCallback<Response>([this, &request, priority](std::function<void(Response)> done) {
+        auto transfer = std::make_shared<Transfer>();
+        transfer->request = std::move(request);
+        transfer->complete = [done = std::move(done), priority](Response response) {
+            // Off the network thread, as for callbacks
+            TaskScheduler::shared().post([done, response = std::move(response)]() mutable {
+                done(std::move(response));
+            }, priority);
+        };
+        enqueue(std::move(transfer));
+    });
 }
 
 std::string HttpClient::get(const std::string& url) {
-    if (!pImpl->curl) {
-        return "";
-    }
-    
-    std::string response;
-    
-    curl_easy_setopt(pImpl->curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(pImpl->curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(pImpl->curl, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(pImpl->curl, CURLOPT_TIMEOUT, pImpl->timeout);
-    curl_easy_setopt(pImpl->curl, CURLOPT_USERAGENT, pImpl->user_agent.c_str());
-    curl_easy_setopt(pImpl->curl, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(pImpl->curl, CURLOPT_SSL_VERIFYPEER, 1L);
-    curl_easy_setopt(pImpl->curl, CURLOPT_SSL_VERIFYHOST, 2L);
-    
-    CURLcode res = curl_easy_perform(pImpl->curl);
-    
-    if (res != CURLE_OK) {
-        std::cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << std::endl;
+    Request request;
+    request.url = url;
+    Response response = send(std::move(request)).get();
+
+    if (!response.error.empty()) {
+        std::cerr << "HTTP request failed: " << response.error << std::endl;
         return "";
     }
-    
-    long response_code;
-    curl_easy_getinfo(pImpl->curl, CURLINFO_RESPONSE_CODE, &response_code);
-    
-    if (response_code != 200) {
-        std::cerr << "HTTP request failed with code: " << response_code << std::endl;
+    if (response.status != 200) {
+        std::cerr << "HTTP request failed with code: " << response.status << std::endl;
         return "";
     }
-    
-    return response;
+    return response.body;
 }
 
-void HttpClient::getAsync(const std::string& url, 
+void HttpClient::getAsync(const std::string& url,
                          std::function<void(const std::string&)> onSuccess,
                          std::function<void(const std::string&)> onError,
                          ProgressCallback onProgress) {
-    std::thread([this, url, onSuccess, onError, onProgress]() {
-        try {
-            std::string result = get(url);
-            if (!result.empty() && onSuccess) {
-                onSuccess(result);
-            } else if (onError) {
-                onError("Failed to fetch URL: " + url);
-            }
-        } catch (const std::exception& e) {
-            if (onError) {
-                onError(e.what());
+    Request request;
+    request.url = url;
+    auto transfer = std::make_shared<Transfer>();
+    transfer->request = std::move(request);
+    transfer->on_progress = std::move(onProgress);
+    transfer->complete = [url, onSuccess, onError](Response response) {
+        TaskScheduler::shared().post([url, onSuccess, onError, response = std::move(response)]() {
+            try {
+                if (response.status == 200 && response.error.empty() && !response.body.empty()) {
+                    if (onSuccess) onSuccess(response.body);
+                } else if (onError) {
+                    onError(response.error.empty() ? "Failed to fetch URL: " + url : response.error);
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "HTTP response callback threw: " << e.what() << std::endl;
+            } catch (...) {
+                std::cerr << "HTTP response callback threw" << std::endl;
             }
-        }
-    }).detach();
+        });
+    };
+    enqueue(std::move(transfer));
 }
 
 bool HttpClient::downloadFile(const std::string& url, const std::string& filepath,
                              ProgressCallback onProgress) {
-    if (!pImpl->curl) {
-        return false;
-    }
-    
     FILE* file = fopen(filepath.c_str(), "wb");
     if (!file) {
         return false;
     }
-    
-    curl_easy_setopt(pImpl->curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(pImpl->curl, CURLOPT_WRITEFUNCTION, WriteFileCallback);
-    curl_easy_setopt(pImpl->curl, CURLOPT_WRITEDATA, file);
-    curl_easy_setopt(pImpl->curl, CURLOPT_TIMEOUT, pImpl->timeout);
-    curl_easy_setopt(pImpl->curl, CURLOPT_USERAGENT, pImpl->user_agent.c_str());
-    curl_easy_setopt(pImpl->curl, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(pImpl->curl, CURLOPT_SSL_VERIFYPEER, 1L);
-    curl_easy_setopt(pImpl->curl, CURLOPT_SSL_VERIFYHOST, 2L);
-    
-    if (onProgress) {
-        curl_easy_setopt(pImpl->curl, CURLOPT_NOPROGRESS, 0L);
-        curl_easy_setopt(pImpl->curl, CURLOPT_PROGRESSFUNCTION, CurlProgressCallback);
-        curl_easy_setopt(pImpl->curl, CURLOPT_PROGRESSDATA, &onProgress);
-    }
-    
-    CURLcode res = curl_easy_perform(pImpl->curl);
+
+    auto promise = std::make_shared<std::promise<Response>>();
+    std::future<Response> result = promise->get_future();
+    auto transfer = std::make_shared<Transfer>();
+    transfer->request.url = url;
+    transfer->file = file;
+    transfer->on_progress = std::move(onProgress);
+    transfer->complete = [promise](Response response) { promise->set_value(std::move(response)); };
+    enqueue(std::move(transfer));
+
+    Response response = result.get();
     fclose(file);
-    
-    if (res != CURLE_OK) {
-        std::cerr << "curl_easy_perform() failed: " << curl_easy_strerror(res) << std::endl;
+
+    if (!response.error.empty()) {
+        std::cerr << "HTTP download failed: " << response.error << std::endl;
         return false;
     }
-    
-    long response_code;
-    curl_easy_getinfo(pImpl->curl, CURLINFO_RESPONSE_CODE, &response_code);
-    
-    if (response_code != 200) {
-        std::cerr << "HTTP download failed with code: " << response_code << std::endl;
+    if (response.status != 200) {
+        std::cerr << "HTTP download failed with code: " << response.status << std::endl;
         return false;
     }
-    
     return true;
 }
 
 void HttpClient::setTimeout(long timeout_seconds) {
-    pImpl->timeout = timeout_seconds;
+    Loop::shared().configure(lane, [&](Lane& settings) { settings.timeout = timeout_seconds; });
 }
 
 void HttpClient::setUserAgent(const std::string& user_agent) {
-    pImpl->user_agent = user_agent;
-}
\ No newline at end of file
+    Loop::shared().configure(lane, [&](Lane& settings) { settings.user_agent = user_agent; });
+}
+
+void HttpClient::setMaxConcurrent(size_t max_concurrent) {
+    Loop::shared().configure(lane, [&](Lane& settings) { settings.max_concurrent = std::max<size_t>(max_concurrent, 1); });
+}
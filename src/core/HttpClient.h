@@ -1,43 +1,92 @@
 #ifndef HTTP_CLIENT_H
 #define HTTP_CLIENT_H
 
+#include "Task.h"
 #include <string>
 #include <functional>
+#include <future>
 #include <memory>
+#include <utility>
+#include <vector>
 
+// Every HttpClient hands its transfers to one process-wide curl-multi loop
+// running on a background thread, so connections (and TLS sessions) to a
+// host are reused across requests and clients, and HTTP/2 streams share a
+// connection. A client is a lane in that loop: it has its own limit on
+// transfers in flight and its own timeout, so one integration syncing
+// hundreds of items cannot crowd out another.
 class HttpClient {
 public:
     using ProgressCallback = std::function<void(double progress)>;
-    
-    HttpClient();
+
+    static constexpr size_t DEFAULT_MAX_CONCURRENT = 6;
+
+    struct Request {
+        std::string method = "GET";
+        std::string url;
+        std::vector<std::string> headers; // "Name: value"
+        std::string body;
+    };
+
+    struct Response {
+        long status = 0;
+        std::string body;
+        std::vector<std::pair<std::string, std::string>> headers; // names lowercased
+        std::string error; // empty unless the transfer itself failed
+
+        bool ok() const { return error.empty() && status >= 200 && status < 300; }
+        // Value of the named header (lowercase), or "" if absent
+        std::string header(const std::string& name) const;
+    };
+
+    using ResponseCallback = std::function<void(Response)>;
+
+    // name labels the lane's metrics
+    explicit HttpClient(const std::string& name = "default", size_t max_concurrent = DEFAULT_MAX_CONCURRENT);
+    // Cancels this client's queued and running transfers; must not be called
+    // from one of its own callbacks
     ~HttpClient();
-    
+
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+    // Queue a request; the future is ready once it completes or fails
+    std::future<Response> send(Request request);
+    // As send(), with onDone run on the TaskScheduler
+    void send(Request request, ResponseCallback onDone);
+    // As send(), for coroutines: suspends until the response arrives, then
+    // continues on the TaskScheduler at the priority it was awaited with
+    Task<Response> fetch(Request request);
+
     // Synchronous GET request
     std::string get(const std::string& url);
-    
-    // Asynchronous GET request with progress callback
-    void getAsync(const std::string& url, 
+
+    // Asynchronous GET request; callbacks run on the TaskScheduler
+    void getAsync(const std::string& url,
                   std::function<void(const std::string&)> onSuccess,
                   std::function<void(const std::string&)> onError = nullptr,
                   ProgressCallback onProgress = nullptr);
-    
-    // Download file with progress
+
+    // Download file with progress; onProgress runs on the network thread
     bool downloadFile(const std::string& url, const std::string& filepath,
                       ProgressCallback onProgress = nullptr);
-    
-    // Set timeout in seconds
+
+    // Set timeout in seconds, for requests queued from now on
     void setTimeout(long timeout_seconds);
-    
+
     // Set user agent
     void setUserAgent(const std::string& user_agent);
-    
+
+    // Transfers allowed in flight at once; the rest wait in order
+    void setMaxConcurrent(size_t max_concurrent);
+
 private:
-    struct Impl;
-    std::unique_ptr<Impl> pImpl;
-    
-    static size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp);
-    static size_t WriteFileCallback(void* contents, size_t size, size_t nmemb, FILE* userp);
-    static int CurlProgressCallback(void* clientp, double dltotal, double dlnow, double ultotal, double ulnow);
+    struct Lane;
+    struct Transfer;
+    class Loop;
+    std::shared_ptr<Lane> lane;
+
+    void enqueue(std::shared_ptr<Transfer> transfer);
 };
 
-#endif // HTTP_CLIENT_H
\ No newline at end of file
+#endif // HTTP_CLIENT_H
@@ -1,4 +1,6 @@
 #include "IncrementalSearch.h"
+#include "TaskScheduler.h"
+#include "Tracer.h"
 #include "VerseFinder.h"
 #include <algorithm>
 #include <iostream>
@@ -11,12 +13,7 @@ IncrementalSearch::~IncrementalSearch() {
 }
 
 void IncrementalSearch::start() {
-    if (running.load()) {
-        return; // Already running
-    }
-    
     running.store(true);
-    search_thread = std::thread(&IncrementalSearch::searchWorkerLoop, this);
 }
 
 void IncrementalSearch::stop() {
@@ -25,73 +22,59 @@ void IncrementalSearch::stop() {
     }
     
     running.store(false);
-    queue_condition.notify_all();
-    
-    if (search_thread.joinable()) {
-        search_thread.join();
-    }
-    
     clearQueue();
+    
+    // A queued drain finds the queue empty and returns
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    if (active_cancel) active_cancel->store(true);
+    queue_condition.wait(lock, [this] { return !drain_scheduled; });
 }
 
-void IncrementalSearch::searchWorkerLoop() {
+void IncrementalSearch::drain() {
     std::unique_lock<std::mutex> lock(queue_mutex);
     
-    while (running.load()) {
-        // Wait for a search request or stop signal
-        queue_condition.wait(lock, [this] {
-            return !search_queue.empty() || !running.load();
-        });
-        
-        if (!running.load()) {
-            break;
-        }
-        
-        if (search_queue.empty()) {
-            continue;
+    while (running.load() && !search_queue.empty()) {
+        // Debounce: run once the latest keystroke is debounce_delay old
+        auto since_request = std::chrono::steady_clock::now() - search_queue.back().timestamp;
+        if (since_request < debounce_delay) {
+            TaskScheduler::shared().postAfter(debounce_delay - since_request, [this]() { drain(); },
+                                              TaskPriority::INTERACTIVE);
+            return;
         }
         
-        // Get the most recent search request and discard older ones
+        // Only the most recent request matters; older ones are discarded
         SearchRequest request = search_queue.back();
-        
-        // Clear the queue to process only the latest request
         while (!search_queue.empty()) {
             search_queue.pop();
         }
         
         lock.unlock();
-        
-        // Check if enough time has passed since the request (debouncing)
-        auto now = std::chrono::steady_clock::now();
-        auto time_since_request = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now - request.timestamp);
-        
-        if (time_since_request < debounce_delay) {
-            // Wait for the remaining debounce time
-            std::this_thread::sleep_for(debounce_delay - time_since_request);
-            
-            // Check if a newer request has arrived while waiting
-            lock.lock();
-            if (!search_queue.empty()) {
-                continue; // Process the newer request instead
-            }
-            lock.unlock();
-        }
-        
-        // Process the search request
         processSearchRequest(request);
-        
         lock.lock();
     }
+    
+    drain_scheduled = false;
+    queue_condition.notify_all();
 }
 
 void IncrementalSearch::processSearchRequest(const SearchRequest& request) {
     if (!verse_finder || !verse_finder->isReady()) {
         return;
     }
+    TRACE_SCOPE("incremental_search");
     
     auto start_time = std::chrono::steady_clock::now();
     
+    // Stale keystrokes are abandoned mid-scan rather than left to finish
+    SearchContext context;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        active_cancel = SearchContext::makeCancelToken();
+        if (!search_queue.empty()) active_cancel->store(true);
+        context.setCancelToken(active_cancel);
+    }
+    context.setTimeout(max_search_time).setMaxResults(max_results);
+    
     // Perform the search based on query type
     std::vector<std::string> results;
     
@@ -103,20 +86,15 @@ void IncrementalSearch::processSearchRequest(const SearchRequest& request) {
             // Determine search type and perform search
             std::string book;
             int chapter, verse;
-            if (verse_finder->parseReference(request.query, book, chapter, verse)) {
+            // parseReference accepts any text as a book name; only a chapter makes it a reference
+            if (verse_finder->parseReference(request.query, book, chapter, verse) && chapter != -1) {
                 // Reference search
                 std::string verse_result = verse_finder->searchByReference(request.query, request.translation);
                 if (!verse_result.empty()) {
                     results.push_back(verse_result);
                 }
             } else {
-                // Keyword search
-                results = verse_finder->searchByKeywords(request.query, request.translation);
-                
-                // Limit results for performance
-                if (results.size() > 50) {
-                    results.resize(50);
-                }
+                results = searchKeywords(request, context);
             }
         }
     } catch (const std::exception& e) {
@@ -152,6 +130,60 @@ void IncrementalSearch::processSearchRequest(const SearchRequest& request) {
     }
 }
 
+std::vector<std::string> IncrementalSearch::searchKeywords(const SearchRequest& request, const SearchContext& context) {
+    // Keeps the store the ids are rendered from resident until they are
+    VerseFinder::TranslationLease lease = verse_finder->acquireTranslation(request.translation);
+
+    // Read before searching, so ids from a translation reloaded mid-search are never reused
+    uint64_t generation = verse_finder->getTranslationGeneration(request.translation);
+    bool refine = isRefinement(request, generation);
+    
+    // The full match set is kept for refinement; only rendering applies the limit
+    SearchContext full_context = context;
+    full_context.setMaxResults(SearchContext::UNLIMITED);
+    CachedSearchResult match = verse_finder->searchKeywordPrefixIds(
+        request.query, request.translation, refine ? &last_keyword_search.ids : nullptr, full_context);
+    
+    last_keyword_search.query = request.query;
+    last_keyword_search.translation = request.translation;
+    last_keyword_search.generation = generation;
+    last_keyword_search.ids = match.ids;
+    last_keyword_search.valid = !match.ids.empty() && !full_context.interrupted();
+    
+    if (refine) {
+        std::lock_guard<std::mutex> stats_lock(stats_mutex);
+        refined_searches++;
+    }
+    
+    if (match.ids.empty()) {
+        return {match.message.empty() ? "No matching verses found." : match.message};
+    }
+    
+    const VerseStore* store = verse_finder->getVerseStore(request.translation);
+    if (!store) {
+        return {"Translation not found."};
+    }
+    
+    // Limit results for performance
+    std::vector<std::string> results;
+    size_t count = std::min(match.ids.size(), context.maxResults());
+    results.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        results.push_back(store->formatResult(match.ids[i]));
+    }
+    return results;
+}
+
+bool IncrementalSearch::isRefinement(const SearchRequest& request, uint64_t generation) const {
+    // Appending characters keeps every earlier word, extends or completes the partial one
+    // and can add more; none of that matches a verse the previous query did not.
+    // Deletions and edits inside the query fall back to a full search.
+    const RefinementState& last = last_keyword_search;
+    return last.valid && last.generation == generation && last.translation == request.translation &&
+           request.query.size() > last.query.size() &&
+           request.query.compare(0, last.query.size(), last.query) == 0;
+}
+
 bool IncrementalSearch::shouldCancelSearch(int current_id) const {
     // Cancel if there are newer requests in the queue
     std::lock_guard<std::mutex> lock(queue_mutex);
@@ -175,9 +207,14 @@ int IncrementalSearch::submitSearch(const std::string& query, const std::string&
         }
         
         search_queue.push(request);
+        if (active_cancel) active_cancel->store(true);
+        
+        if (!drain_scheduled) {
+            drain_scheduled = true;
+            TaskScheduler::shared().postAfter(debounce_delay, [this]() { drain(); }, TaskPriority::INTERACTIVE);
+        }
     }
     
-    queue_condition.notify_one();
     return request_id;
 }
 
@@ -190,6 +227,7 @@ IncrementalSearch::SearchStats IncrementalSearch::getStats() const {
     
     SearchStats stats;
     stats.total_searches = total_searches;
+    stats.refined_searches = refined_searches;
     stats.queue_size = getQueueSize();
     stats.is_running = running.load();
     
@@ -210,6 +248,7 @@ IncrementalSearch::SearchStats IncrementalSearch::getStats() const {
 void IncrementalSearch::resetStats() {
     std::lock_guard<std::mutex> stats_lock(stats_mutex);
     total_searches = 0;
+    refined_searches = 0;
     total_search_time = std::chrono::microseconds{0};
     fastest_search = std::chrono::microseconds::max();
     slowest_search = std::chrono::microseconds{0};
@@ -5,11 +5,12 @@
 #include <vector>
 #include <chrono>
 #include <atomic>
-#include <thread>
 #include <mutex>
 #include <condition_variable>
 #include <functional>
 #include <queue>
+#include "VerseStore.h"
+#include "SearchContext.h"
 
 class VerseFinder; // Forward declaration
 
@@ -44,21 +45,37 @@ public:
 private:
     VerseFinder* verse_finder;
     std::atomic<bool> running{false};
-    std::thread search_thread;
     
-    // Search queue and synchronization
+    // Search queue and synchronization. Searches run as INTERACTIVE tasks on
+    // the shared TaskScheduler; drain_scheduled keeps at most one queued or
+    // running, so they never overlap.
     std::queue<SearchRequest> search_queue;
     mutable std::mutex queue_mutex;
-    std::condition_variable queue_condition;
+    std::condition_variable queue_condition; // signalled when drain_scheduled clears
+    bool drain_scheduled = false;
+    SearchContext::CancelToken active_cancel; // in-flight search; a newer submission sets it
     
     // Configuration
-    std::chrono::milliseconds debounce_delay{150}; // Wait 150ms after last keystroke
-    std::chrono::milliseconds max_search_time{50}; // Target max search time
+    std::chrono::milliseconds debounce_delay{60}; // Wait 60ms after last keystroke
+    std::chrono::milliseconds max_search_time{50}; // Deadline after which partial results are returned
     size_t max_queue_size = 10;
+    size_t max_results = 50;
     
     // Callback for results
     ResultCallback result_callback;
     
+    // Last keyword search and its full match set. A query that only appends to
+    // it can only narrow the matches, so it is answered by filtering these ids.
+    // Touched by the drain task alone.
+    struct RefinementState {
+        std::string query;
+        std::string translation;
+        uint64_t generation = 0;
+        std::vector<VerseId> ids; // sorted
+        bool valid = false;
+    };
+    RefinementState last_keyword_search;
+    
     // Request tracking
     std::atomic<int> next_request_id{1};
     std::atomic<int> last_completed_id{0};
@@ -69,9 +86,12 @@ private:
     std::chrono::microseconds total_search_time{0};
     std::chrono::microseconds fastest_search{std::chrono::microseconds::max()};
     std::chrono::microseconds slowest_search{0};
+    size_t refined_searches = 0;
     
-    void searchWorkerLoop();
+    void drain();
     void processSearchRequest(const SearchRequest& request);
+    std::vector<std::string> searchKeywords(const SearchRequest& request, const SearchContext& context);
+    bool isRefinement(const SearchRequest& request, uint64_t generation) const;
     bool shouldCancelSearch(int current_id) const;
     
 public:
@@ -91,6 +111,7 @@ public:
     void setDebounceDelay(std::chrono::milliseconds delay) { debounce_delay = delay; }
     void setMaxSearchTime(std::chrono::milliseconds time) { max_search_time = time; }
     void setMaxQueueSize(size_t size) { max_queue_size = size; }
+    void setMaxResults(size_t count) { max_results = count; }
     void setResultCallback(ResultCallback callback) { result_callback = std::move(callback); }
     
     // Search operations
@@ -100,6 +121,7 @@ public:
     // Statistics
     struct SearchStats {
         size_t total_searches;
+        size_t refined_searches; // answered by filtering the previous query's matches
         double average_search_time_ms;
         double fastest_search_ms;
         double slowest_search_ms;
@@ -0,0 +1,554 @@
+#include "InvertedIndex.h"
+#include "Tracer.h"
+#include "TextAnalyzer.h"
+#include "TextFolding.h"
+#include "TextKernels.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cctype>
+#include <numeric>
+#include <limits>
+#include <iterator>
+
+void InvertedIndex::addPosting(std::string_view token, VerseId id, uint16_t position) {
+    // Only a word new to this index goes to the shared dictionary
+    auto it = postings.find(token);
+    if (it == postings.end()) {
+        it = postings.emplace(TermDictionary::shared().intern(token), TermPostings()).first;
+    }
+    TermPostings& term = it->second;
+    if (term.ids.empty() || term.ids.back() != id) {
+        if (!term.ids.empty() && term.ids.back() > id) needs_sort = true;
+        term.ids.push_back(id);
+        term.position_offsets.push_back(term.position_offsets.back());
+    }
+    // Token repeated within the same verse only adds a position
+    term.positions.push_back(position);
+    term.position_offsets.back()++;
+}
+
+void InvertedIndex::addVerse(VerseId id, std::string_view text) {
+    // Index terms are folded words, so any case or accent of a word finds them
+    uint16_t position = 0;
+
+    TextFolding::forEachWord(text, [&](std::string_view word) {
+        addPosting(word, id, position);
+        if (position < std::numeric_limits<uint16_t>::max()) ++position;
+    });
+}
+
+void InvertedIndex::addVerses(const VerseStore& store) {
+    TRACE_SCOPE("index_build");
+    const size_t verse_count = store.size();
+    if (verse_count == 0) return;
+
+    // Parts are runs of whole books, cut once a part has its share of verses
+    TaskScheduler& scheduler = TaskScheduler::shared();
+    // One part per thread: every extra part is another copy of its terms to merge
+    const size_t wanted = std::clamp<size_t>(verse_count / MIN_VERSES_PER_PART, 1, scheduler.threadCount() + 1);
+    const size_t target = (verse_count + wanted - 1) / wanted;
+    std::vector<VerseId> part_begin{0};
+    for (VerseId id = 1; id < verse_count; ++id) {
+        if (id - part_begin.back() >= target && store.bookId(id) != store.bookId(id - 1)) {
+            part_begin.push_back(id);
+        }
+    }
+    part_begin.push_back(static_cast<VerseId>(verse_count));
+    const size_t part_count = part_begin.size() - 1;
+
+    std::vector<InvertedIndex> parts(part_count);
+    scheduler.parallelFor(part_count, [&](size_t part) {
+        for (VerseId id = part_begin[part]; id < part_begin[part + 1]; ++id) {
+            parts[part].addVerse(id, store.text(id));
+        }
+    });
+
+    // Terms in token order, so the merged map is built in the same order every time
+    std::vector<std::string_view> tokens;
+    for (const InvertedIndex& part : parts) {
+        for (const auto& entry : part.postings) tokens.push_back(entry.first);
+    }
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+
+    // Each term's lists are the parts' lists in part order: the parts cover
+    // ascending id ranges, so concatenating them is the k-way merge
+    std::vector<TermPostings> merged(tokens.size());
+    std::vector<char> out_of_order(tokens.size(), 0);
+    const size_t shards = scheduler.shardCount(tokens.size(), 1024);
+    scheduler.parallelFor(shards, [&](size_t shard) {
+        size_t begin = tokens.size() * shard / shards;
+        size_t end = tokens.size() * (shard + 1) / shards;
+        for (size_t t = begin; t < end; ++t) {
+            for (InvertedIndex& part : parts) {
+                auto it = part.postings.find(tokens[t]);
+                if (it != part.postings.end() && !appendTerm(merged[t], std::move(it->second))) {
+                    out_of_order[t] = 1;
+                }
+            }
+        }
+    });
+
+    postings.reserve(postings.size() + tokens.size());
+    for (size_t t = 0; t < tokens.size(); ++t) {
+        if (out_of_order[t]) needs_sort = true;
+        auto it = postings.find(tokens[t]);
+        if (it == postings.end()) {
+            postings.emplace(tokens[t], std::move(merged[t]));
+        } else if (!appendTerm(it->second, std::move(merged[t]))) {
+            needs_sort = true;
+        }
+    }
+    for (const InvertedIndex& part : parts) {
+        if (part.needs_sort) needs_sort = true;
+    }
+}
+
+bool InvertedIndex::appendTerm(TermPostings& to, TermPostings&& from) {
+    if (to.ids.empty()) {
+        to = std::move(from);
+        return true;
+    }
+    bool in_order = from.ids.empty() || to.ids.back() < from.ids.front();
+    uint32_t base = to.position_offsets.back();
+    to.ids.insert(to.ids.end(), from.ids.begin(), from.ids.end());
+    for (size_t i = 1; i < from.position_offsets.size(); ++i) {
+        to.position_offsets.push_back(base + from.position_offsets[i]);
+    }
+    to.positions.insert(to.positions.end(), from.positions.begin(), from.positions.end());
+    return in_order;
+}
+
+void InvertedIndex::sortTerm(TermPostings& term) {
+    std::vector<size_t> order(term.ids.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&term](size_t a, size_t b) { return term.ids[a] < term.ids[b]; });
+
+    TermPostings sorted;
+    sorted.ids.reserve(term.ids.size());
+    sorted.position_offsets.reserve(term.position_offsets.size());
+    sorted.positions.reserve(term.positions.size());
+    for (size_t i : order) {
+        // Merge runs of the same id that were added out of order
+        bool same_id = !sorted.ids.empty() && sorted.ids.back() == term.ids[i];
+        if (!same_id) {
+            sorted.ids.push_back(term.ids[i]);
+            sorted.position_offsets.push_back(sorted.position_offsets.back());
+        }
+        for (uint32_t p = term.position_offsets[i]; p < term.position_offsets[i + 1]; ++p) {
+            sorted.positions.push_back(term.positions[p]);
+            sorted.position_offsets.back()++;
+        }
+        if (same_id) {
+            auto begin = sorted.positions.begin() + sorted.position_offsets[sorted.ids.size() - 1];
+            std::sort(begin, sorted.positions.end());
+        }
+    }
+    term = std::move(sorted);
+}
+
+void InvertedIndex::finalize() {
+    for (auto& entry : postings) {
+        TermPostings& term = entry.second;
+        if (needs_sort && !std::is_sorted(term.ids.begin(), term.ids.end())) {
+            sortTerm(term);
+        }
+        term.ids.shrink_to_fit();
+        term.position_offsets.shrink_to_fit();
+        term.positions.shrink_to_fit();
+    }
+    needs_sort = false;
+
+    // A verse's length is one past the last position any token holds in it
+    verse_lengths.clear();
+    uint64_t total_length = 0;
+    for (const auto& entry : postings) {
+        const TermPostings& term = entry.second;
+        for (size_t i = 0; i < term.ids.size(); ++i) {
+            VerseId id = term.ids[i];
+            if (id >= verse_lengths.size()) verse_lengths.resize(id + 1, 0);
+            uint32_t end = std::min<uint32_t>(term.positions[term.position_offsets[i + 1] - 1] + 1u,
+                                              std::numeric_limits<uint16_t>::max());
+            verse_lengths[id] = std::max<uint16_t>(verse_lengths[id], static_cast<uint16_t>(end));
+        }
+    }
+    for (uint16_t length : verse_lengths) total_length += length;
+    average_length = verse_lengths.empty() ? 0.0 : static_cast<double>(total_length) / verse_lengths.size();
+    verse_lengths.shrink_to_fit();
+    for (auto& entry : postings) {
+        buildBlocks(entry.second);
+    }
+
+    std::vector<std::string_view> tokens;
+    tokens.reserve(postings.size());
+    sorted_terms.clear();
+    sorted_terms.reserve(postings.size());
+    for (const auto& entry : postings) {
+        tokens.push_back(entry.first);
+        sorted_terms.push_back(&entry);
+    }
+    phonetic_index.build(tokens);
+    vocabulary_tree.build(std::move(tokens));
+    std::sort(sorted_terms.begin(), sorted_terms.end(),
+              [](const auto* a, const auto* b) { return a->first < b->first; });
+
+    term_suffixes.clear();
+    for (uint32_t term = 0; term < sorted_terms.size(); ++term) {
+        // Offsets must fit the low byte; no real word is that long
+        uint32_t length = static_cast<uint32_t>(std::min<size_t>(sorted_terms[term]->first.size(), 256));
+        for (uint32_t offset = 1; offset < length; ++offset) {
+            term_suffixes.push_back(term << 8 | offset);
+        }
+    }
+    std::sort(term_suffixes.begin(), term_suffixes.end(),
+              [this](uint32_t a, uint32_t b) { return suffixOf(a) < suffixOf(b); });
+    term_suffixes.shrink_to_fit();
+
+    stem_groups.clear();
+    for (uint32_t term = 0; term < sorted_terms.size(); ++term) {
+        std::string_view token = sorted_terms[term]->first;
+        if (!TextAnalyzer::isStopWord(token)) {
+            stem_groups[TextAnalyzer::stem(token)].push_back(term);
+        }
+    }
+    std::erase_if(stem_groups, [this](const auto& group) {
+        return group.second.size() == 1 && sorted_terms[group.second[0]]->first == group.first;
+    });
+    memory_charge.set(getMemoryUsage());
+}
+
+void InvertedIndex::clear() {
+    postings.clear();
+    vocabulary_tree.clear();
+    phonetic_index.clear();
+    sorted_terms.clear();
+    term_suffixes.clear();
+    stem_groups.clear();
+    verse_lengths.clear();
+    average_length = 0.0;
+    needs_sort = false;
+    memory_charge.set(0);
+}
+
+void InvertedIndex::buildBlocks(TermPostings& term) const {
+    term.blocks.clear();
+    term.blocks.reserve((term.ids.size() + TermPostings::BLOCK_SIZE - 1) / TermPostings::BLOCK_SIZE);
+    for (size_t begin = 0; begin < term.ids.size(); begin += TermPostings::BLOCK_SIZE) {
+        size_t end = std::min(term.ids.size(), begin + TermPostings::BLOCK_SIZE);
+        PostingBlock block{0, std::numeric_limits<uint16_t>::max()};
+        for (size_t i = begin; i < end; ++i) {
+            uint32_t frequency = std::min<uint32_t>(term.frequency(i), std::numeric_limits<uint16_t>::max());
+            block.max_frequency = std::max(block.max_frequency, static_cast<uint16_t>(frequency));
+            block.min_length = std::min(block.min_length, static_cast<uint16_t>(verseLength(term.ids[i])));
+        }
+        term.blocks.push_back(block);
+    }
+}
+
+const PostingList* InvertedIndex::find(const std::string& token) const {
+    auto it = postings.find(token);
+    return it != postings.end() ? &it->second.ids : nullptr;
+}
+
+const TermPostings* InvertedIndex::findTerm(const std::string& token) const {
+    auto it = postings.find(token);
+    return it != postings.end() ? &it->second : nullptr;
+}
+
+std::vector<const TermPostings*> InvertedIndex::findVariants(const std::string& token) const {
+    std::vector<const TermPostings*> terms;
+    if (!TextAnalyzer::isStopWord(token)) {
+        auto group = stem_groups.find(TextAnalyzer::stem(token));
+        if (group != stem_groups.end()) {
+            for (uint32_t index : group->second) {
+                terms.push_back(&sorted_terms[index]->second);
+            }
+            return terms;
+        }
+    }
+    if (const TermPostings* term = findTerm(token)) terms.push_back(term);
+    return terms;
+}
+
+TermPostings InvertedIndex::mergeTerms(const std::vector<const TermPostings*>& terms) const {
+    PostingList ids;
+    for (const TermPostings* term : terms) {
+        ids.insert(ids.end(), term->ids.begin(), term->ids.end());
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    // Forms of one stem never share a position, so each verse's positions just interleave
+    TermPostings merged;
+    merged.position_offsets.reserve(ids.size() + 1);
+    std::vector<size_t> cursors(terms.size(), 0);
+    for (VerseId id : ids) {
+        size_t begin = merged.positions.size();
+        for (size_t t = 0; t < terms.size(); ++t) {
+            const TermPostings& term = *terms[t];
+            if (cursors[t] < term.ids.size() && term.ids[cursors[t]] == id) {
+                merged.positions.insert(merged.positions.end(),
+                                        term.positions.begin() + term.position_offsets[cursors[t]],
+                                        term.positions.begin() + term.position_offsets[cursors[t] + 1]);
+                ++cursors[t];
+            }
+        }
+        std::sort(merged.positions.begin() + begin, merged.positions.end());
+        merged.position_offsets.push_back(static_cast<uint32_t>(merged.positions.size()));
+    }
+    merged.ids = std::move(ids);
+    buildBlocks(merged);
+    return merged;
+}
+
+PostingList InvertedIndex::findPrefix(std::string_view prefix, const PostingList* within) const {
+    auto first = std::lower_bound(sorted_terms.begin(), sorted_terms.end(), prefix,
+                                  [](const auto* term, std::string_view p) { return term->first < p; });
+    auto has_prefix = [prefix](const auto* term) { return term->first.compare(0, prefix.size(), prefix) == 0; };
+
+    PostingList ids;
+    if (within) {
+        // Mark the candidates each term hits; walking the smaller side keeps
+        // this cheap even when a short prefix spans thousands of terms
+        std::vector<char> hit(within->size(), 0);
+        for (auto it = first; it != sorted_terms.end() && has_prefix(*it); ++it) {
+            const PostingList& term_ids = (*it)->second.ids;
+            if (term_ids.size() < within->size()) {
+                auto cursor = within->begin();
+                for (VerseId id : term_ids) {
+                    cursor = std::lower_bound(cursor, within->end(), id);
+                    if (cursor == within->end()) break;
+                    if (*cursor == id) hit[cursor - within->begin()] = 1;
+                }
+            } else {
+                auto cursor = term_ids.begin();
+                for (size_t i = 0; i < within->size(); ++i) {
+                    cursor = std::lower_bound(cursor, term_ids.end(), (*within)[i]);
+                    if (cursor == term_ids.end()) break;
+                    if (*cursor == (*within)[i]) hit[i] = 1;
+                }
+            }
+        }
+        for (size_t i = 0; i < within->size(); ++i) {
+            if (hit[i]) ids.push_back((*within)[i]);
+        }
+        return ids;
+    }
+
+    // Terms sharing a prefix are adjacent in sorted order
+    size_t term_count = 0;
+    for (auto it = first; it != sorted_terms.end() && has_prefix(*it); ++it) {
+        const PostingList& term_ids = (*it)->second.ids;
+        ids.insert(ids.end(), term_ids.begin(), term_ids.end());
+        ++term_count;
+    }
+    if (term_count > 1) {
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+    return ids;
+}
+
+PostingList InvertedIndex::findContaining(std::string_view fragment) const {
+    std::vector<uint32_t> term_indices = termIndicesContaining(fragment);
+    return unionOfTerms(term_indices);
+}
+
+PostingList InvertedIndex::findSubstring(std::string_view fragment, const VerseStore& store) const {
+    std::vector<std::string> words;
+    TextFolding::forEachWord(fragment, [&words](std::string_view word) { words.emplace_back(word); });
+    const std::string folded = TextFolding::fold(fragment);
+
+    // A single word is exactly the verses holding a term that contains it
+    if (words.size() == 1 && words[0] == folded) return findContaining(words[0]);
+
+    PostingList candidates;
+    if (words.empty()) {
+        candidates.resize(store.size());
+        std::iota(candidates.begin(), candidates.end(), VerseId(0));
+    } else {
+        std::vector<PostingList> word_ids;
+        word_ids.reserve(words.size());
+        for (const std::string& w : words) {
+            word_ids.push_back(findContaining(w));
+            if (word_ids.back().empty()) return {};
+        }
+        std::sort(word_ids.begin(), word_ids.end(),
+                  [](const PostingList& a, const PostingList& b) { return a.size() < b.size(); });
+        candidates = std::move(word_ids[0]);
+        for (size_t i = 1; i < word_ids.size() && !candidates.empty(); ++i) {
+            PostingList common;
+            std::set_intersection(candidates.begin(), candidates.end(), word_ids[i].begin(), word_ids[i].end(),
+                                  std::back_inserter(common));
+            candidates = std::move(common);
+        }
+    }
+
+    // Plain ASCII is matched in place; anything else is folded per candidate
+    // rather than keeping a folded copy of every verse
+    const bool ascii_fragment = TextKernels::isAscii(fragment);
+    PostingList ids;
+    for (VerseId id : candidates) {
+        std::string_view text = store.text(id);
+        bool found = ascii_fragment && TextKernels::isAscii(text)
+                         ? TextKernels::findIgnoreCase(text, fragment) != std::string_view::npos
+                         : TextFolding::fold(text).find(folded) != std::string::npos;
+        if (found) ids.push_back(id);
+    }
+    return ids;
+}
+
+std::vector<const TermPostings*> InvertedIndex::termsContaining(std::string_view fragment) const {
+    std::vector<uint32_t> term_indices = termIndicesContaining(fragment);
+    std::sort(term_indices.begin(), term_indices.end());
+    term_indices.erase(std::unique(term_indices.begin(), term_indices.end()), term_indices.end());
+
+    std::vector<const TermPostings*> terms;
+    terms.reserve(term_indices.size());
+    for (uint32_t index : term_indices) {
+        terms.push_back(&sorted_terms[index]->second);
+    }
+    return terms;
+}
+
+std::vector<uint32_t> InvertedIndex::termIndicesContaining(std::string_view fragment) const {
+    if (fragment.empty()) return {};
+    auto has_prefix = [fragment](std::string_view text) { return text.compare(0, fragment.size(), fragment) == 0; };
+
+    // Terms starting with the fragment, then terms containing it further in
+    std::vector<uint32_t> term_indices;
+    auto term = std::lower_bound(sorted_terms.begin(), sorted_terms.end(), fragment,
+                                 [](const auto* entry, std::string_view f) { return entry->first < f; });
+    for (; term != sorted_terms.end() && has_prefix((*term)->first); ++term) {
+        term_indices.push_back(static_cast<uint32_t>(term - sorted_terms.begin()));
+    }
+    auto suffix = std::lower_bound(term_suffixes.begin(), term_suffixes.end(), fragment,
+                                   [this](uint32_t packed, std::string_view f) { return suffixOf(packed) < f; });
+    for (; suffix != term_suffixes.end() && has_prefix(suffixOf(*suffix)); ++suffix) {
+        term_indices.push_back(*suffix >> 8);
+    }
+    return term_indices;
+}
+
+PostingList InvertedIndex::unionOfTerms(std::vector<uint32_t>& term_indices) const {
+    // A term holding the fragment twice shows up once per occurrence
+    std::sort(term_indices.begin(), term_indices.end());
+    term_indices.erase(std::unique(term_indices.begin(), term_indices.end()), term_indices.end());
+
+    PostingList ids;
+    for (uint32_t index : term_indices) {
+        const PostingList& term_ids = sorted_terms[index]->second.ids;
+        ids.insert(ids.end(), term_ids.begin(), term_ids.end());
+    }
+    if (term_indices.size() > 1) {
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+    return ids;
+}
+
+PostingList InvertedIndex::filterPhrase(const PostingList& candidates, const std::vector<std::string>& tokens) const {
+    TRACE_SCOPE("phrase_verify");
+    if (tokens.size() <= 1) {
+        return candidates;
+    }
+
+    std::vector<const TermPostings*> terms;
+    if (!lookupTerms(tokens, terms)) return {};
+
+    PostingList result;
+    forEachPhrase(candidates, terms, false, [&result](VerseId id, uint16_t) { result.push_back(id); });
+    return result;
+}
+
+TermPostings InvertedIndex::findPhrase(const std::vector<std::string>& tokens) const {
+    TermPostings phrase;
+    std::vector<const TermPostings*> terms;
+    if (tokens.empty() || !lookupTerms(tokens, terms)) return phrase;
+
+    // Every occurrence is in the rarest token's verses
+    const TermPostings* rarest = *std::min_element(terms.begin(), terms.end(), [](const auto* a, const auto* b) {
+        return a->ids.size() < b->ids.size();
+    });
+    forEachPhrase(rarest->ids, terms, true, [&phrase](VerseId id, uint16_t start) {
+        if (phrase.ids.empty() || phrase.ids.back() != id) {
+            phrase.ids.push_back(id);
+            phrase.position_offsets.push_back(phrase.position_offsets.back());
+        }
+        phrase.positions.push_back(start);
+        phrase.position_offsets.back()++;
+    });
+    buildBlocks(phrase);
+    return phrase;
+}
+
+bool InvertedIndex::lookupTerms(const std::vector<std::string>& tokens, std::vector<const TermPostings*>& terms) const {
+    terms.clear();
+    terms.reserve(tokens.size());
+    for (const auto& token : tokens) {
+        auto it = postings.find(token);
+        if (it == postings.end()) return false;
+        terms.push_back(&it->second);
+    }
+    return true;
+}
+
+template <typename Emit>
+void InvertedIndex::forEachPhrase(const PostingList& candidates, const std::vector<const TermPostings*>& terms,
+                                  bool every_start, Emit emit) {
+    std::vector<size_t> cursors(terms.size(), 0);
+    std::vector<std::pair<const uint16_t*, const uint16_t*>> spans(terms.size());
+
+    for (VerseId id : candidates) {
+        // Locate this verse's position span in each term; cursors only move forward
+        bool present = true;
+        for (size_t t = 0; t < terms.size(); ++t) {
+            const PostingList& ids = terms[t]->ids;
+            cursors[t] = std::lower_bound(ids.begin() + cursors[t], ids.end(), id) - ids.begin();
+            if (cursors[t] == ids.size() || ids[cursors[t]] != id) {
+                present = false;
+                break;
+            }
+            const uint16_t* base = terms[t]->positions.data();
+            spans[t] = {base + terms[t]->position_offsets[cursors[t]],
+                        base + terms[t]->position_offsets[cursors[t] + 1]};
+        }
+        if (!present) continue;
+
+        // The phrase starts wherever the first token sits and every later token follows in step
+        for (const uint16_t* start = spans[0].first; start != spans[0].second; ++start) {
+            bool match = true;
+            for (size_t t = 1; t < terms.size() && match; ++t) {
+                match = std::binary_search(spans[t].first, spans[t].second,
+                                           static_cast<uint16_t>(*start + t));
+            }
+            if (match) {
+                emit(id, *start);
+                if (!every_start) break;
+            }
+        }
+    }
+}
+
+size_t InvertedIndex::getMemoryUsage() const {
+    size_t bytes = postings.bucket_count() * sizeof(void*);
+    for (const auto& entry : postings) {
+        const TermPostings& term = entry.second;
+        bytes += sizeof(entry) + sizeof(void*); // the term's text is TermDictionary's
+        bytes += term.ids.capacity() * sizeof(VerseId);
+        bytes += term.position_offsets.capacity() * sizeof(uint32_t);
+        bytes += term.positions.capacity() * sizeof(uint16_t);
+        bytes += term.blocks.capacity() * sizeof(PostingBlock);
+    }
+    bytes += vocabulary_tree.getMemoryUsage();
+    bytes += phonetic_index.getMemoryUsage();
+    bytes += sorted_terms.capacity() * sizeof(void*);
+    bytes += term_suffixes.capacity() * sizeof(uint32_t);
+    bytes += stem_groups.bucket_count() * sizeof(void*);
+    for (const auto& group : stem_groups) {
+        bytes += sizeof(group) + group.first.capacity() + group.second.capacity() * sizeof(uint32_t);
+    }
+    bytes += verse_lengths.capacity() * sizeof(uint16_t);
+    return bytes;
+}
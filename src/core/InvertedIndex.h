@@ -0,0 +1,154 @@
+#ifndef INVERTEDINDEX_H
+#define INVERTEDINDEX_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include "VerseStore.h"
+#include "BKTree.h"
+#include "MemoryAccounting.h"
+#include "PhoneticIndex.h"
+#include "TermDictionary.h"
+
+// Sorted, duplicate-free list of verse ids containing a token
+using PostingList = std::vector<VerseId>;
+
+// Score bounds for BLOCK_SIZE consecutive postings of one term
+struct PostingBlock {
+    uint16_t max_frequency; // most occurrences in any one of its verses
+    uint16_t min_length;    // shortest of its verses, in tokens
+};
+
+// Postings for one token plus the word offsets of every occurrence.
+// Offsets for ids[i] are positions[position_offsets[i] .. position_offsets[i + 1]).
+struct TermPostings {
+    static constexpr size_t BLOCK_SIZE = 64;
+
+    PostingList ids;
+    std::vector<uint32_t> position_offsets{0};
+    std::vector<uint16_t> positions;
+    std::vector<PostingBlock> blocks; // built by finalize(), block b covers ids[b * BLOCK_SIZE ...]
+
+    // Occurrences of the token in verse ids[i]
+    uint32_t frequency(size_t i) const { return position_offsets[i + 1] - position_offsets[i]; }
+};
+
+// Positional token index for one translation. Verses are expected to be
+// added in increasing id order, which keeps every posting list sorted without
+// a separate pass; finalize() repairs the order if that ever does not hold.
+// Terms are keyed by their entry in TermDictionary::shared(), so the text of
+// a word is held once however many translations index it.
+class InvertedIndex {
+public:
+    using TermMap = std::unordered_map<std::string_view, TermPostings>;
+    // Fewest verses addVerses() gives one thread
+    static constexpr size_t MIN_VERSES_PER_PART = 2048;
+
+private:
+    TermMap postings;
+    BKTree vocabulary_tree; // every indexed token, for fuzzy lookups
+    PhoneticIndex phonetic_index; // the same tokens by sound, for misspelled names
+    // Terms in token order, for prefix lookups; entries point into postings' nodes
+    std::vector<const TermMap::value_type*> sorted_terms;
+    // Every proper suffix of every term as (term index << 8 | offset), sorted by
+    // suffix text: terms containing a fragment past their first byte are one run
+    std::vector<uint32_t> term_suffixes;
+    // Stem -> the terms (indices into sorted_terms) that inflect it, e.g. "lov" ->
+    // "love", "loved", "loveth"; stems whose only form is themselves are left out
+    std::unordered_map<std::string, std::vector<uint32_t>> stem_groups;
+    std::vector<uint16_t> verse_lengths; // tokens per verse id
+    double average_length = 0.0;
+    bool needs_sort = false;
+    // The index only changes while it is built, so it is charged once finalized
+    MemoryCharge memory_charge{MemoryTag::INVERTED_INDEX};
+
+    std::string_view suffixOf(uint32_t packed) const {
+        return sorted_terms[packed >> 8]->first.substr(packed & 0xFF);
+    }
+    std::vector<uint32_t> termIndicesContaining(std::string_view fragment) const;
+    PostingList unionOfTerms(std::vector<uint32_t>& term_indices) const;
+    void buildBlocks(TermPostings& term) const;
+    // False if any token is not indexed
+    bool lookupTerms(const std::vector<std::string>& tokens, std::vector<const TermPostings*>& terms) const;
+    // emit(id, start) for the candidates holding the phrase: at its first start, or every one
+    template <typename Emit>
+    static void forEachPhrase(const PostingList& candidates, const std::vector<const TermPostings*>& terms,
+                              bool every_start, Emit emit);
+
+    void addPosting(std::string_view token, VerseId id, uint16_t position);
+    static void sortTerm(TermPostings& term);
+    // Append from's postings after to's; false if that breaks id order
+    static bool appendTerm(TermPostings& to, TermPostings&& from);
+
+public:
+    InvertedIndex() = default;
+    // Moving keeps the map's nodes, so sorted_terms stays valid; a copy would not
+    InvertedIndex(const InvertedIndex&) = delete;
+    InvertedIndex& operator=(const InvertedIndex&) = delete;
+    InvertedIndex(InvertedIndex&&) = default;
+    InvertedIndex& operator=(InvertedIndex&&) = default;
+
+    // Tokenize text (lowercase alphanumeric runs) and post each token for id
+    void addVerse(VerseId id, std::string_view text);
+    // Index every verse of store. Runs of whole books are indexed on the shared
+    // TaskScheduler into partial indexes that are merged term by term in id
+    // order, so the result is the same however many threads took part.
+    void addVerses(const VerseStore& store);
+    // Sort any out-of-order lists, release spare capacity and build the vocabulary lookups
+    void finalize();
+    void reserve(size_t term_count) { postings.reserve(term_count); }
+    void clear();
+    // Adopt a prebuilt term, e.g. when loading a snapshot; ids must be sorted
+    void addTerm(std::string_view token, TermPostings term) {
+        postings[TermDictionary::shared().intern(token)] = std::move(term);
+    }
+
+    // nullptr if the token is not indexed
+    const PostingList* find(const std::string& token) const;
+    const TermPostings* findTerm(const std::string& token) const;
+    // The terms sharing token's stem, such as "loved" and "loveth" for "love"
+    // (needs finalize()). Stop words are indexed for their positions only and
+    // only ever match themselves. Empty if no form of token is indexed.
+    std::vector<const TermPostings*> findVariants(const std::string& token) const;
+    // Several terms as one, with frequencies added and blocks built, so a stem ranks like a word
+    TermPostings mergeTerms(const std::vector<const TermPostings*>& terms) const;
+    // Sorted union of the lists of every token starting with prefix (needs finalize()),
+    // optionally restricted to the sorted ids in within
+    PostingList findPrefix(std::string_view prefix, const PostingList* within = nullptr) const;
+    // Sorted union of the lists of every token containing fragment anywhere; for an
+    // alphanumeric fragment these are exactly the verses whose text contains it
+    PostingList findContaining(std::string_view fragment) const;
+    // The terms behind findContaining(), for callers that score each one
+    std::vector<const TermPostings*> termsContaining(std::string_view fragment) const;
+    // Verses whose text contains fragment ignoring case, spaces and punctuation
+    // included: its words' findContaining() lists are intersected and only the
+    // surviving verses' text is checked (needs finalize())
+    PostingList findSubstring(std::string_view fragment, const VerseStore& store) const;
+
+    // Keep the candidates in which tokens occur as consecutive words.
+    // Candidates must be sorted and contain every token (e.g. their intersection).
+    PostingList filterPhrase(const PostingList& candidates, const std::vector<std::string>& tokens) const;
+    // The phrase as a term of its own: one position per occurrence, blocks built (needs finalize())
+    TermPostings findPhrase(const std::vector<std::string>& tokens) const;
+
+    // Collection statistics for relevance ranking, gathered by finalize()
+    size_t verseCount() const { return verse_lengths.size(); }
+    uint32_t verseLength(VerseId id) const { return id < verse_lengths.size() ? verse_lengths[id] : 0; }
+    double averageVerseLength() const { return average_length; }
+
+    size_t termCount() const { return postings.size(); }
+    bool empty() const { return postings.empty(); }
+    const TermMap& terms() const { return postings; }
+    // Every term in token order (needs finalize()), for output that must not depend on hashing
+    const std::vector<const TermMap::value_type*>& termsInOrder() const { return sorted_terms; }
+    const BKTree& vocabulary() const { return vocabulary_tree; }
+    const PhoneticIndex& phonetics() const { return phonetic_index; }
+
+    size_t getMemoryUsage() const;
+};
+
+// Indexes by translation name, shared like VerseStoreMap
+using InvertedIndexMap = std::unordered_map<std::string, std::shared_ptr<const InvertedIndex>>;
+
+#endif // INVERTEDINDEX_H
@@ -0,0 +1,81 @@
+#include "JournalFile.h"
+#include <filesystem>
+#include <iostream>
+
+bool JournalFile::replay(const std::string& file_path, const std::function<void(const json&)>& apply) {
+    std::ifstream in(file_path);
+    if (!in.is_open()) {
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        json record = json::parse(line, nullptr, false);
+        if (record.is_discarded() || !record.is_object()) {
+            // Torn by a crash mid-write; later records still apply
+            continue;
+        }
+        apply(record);
+    }
+    return true;
+}
+
+bool JournalFile::openForAppend() {
+    if (out.is_open()) return true;
+
+    // A crash can leave the last line unterminated; start a fresh one after it
+    bool needs_newline = false;
+    {
+        std::ifstream existing(path, std::ios::binary | std::ios::ate);
+        if (existing.is_open() && existing.tellg() > 0) {
+            existing.seekg(-1, std::ios::end);
+            needs_newline = existing.get() != '\n';
+        }
+    }
+    out.open(path, std::ios::binary | std::ios::app);
+    if (!out.is_open()) return false;
+    if (needs_newline) out << '\n';
+    return true;
+}
+
+bool JournalFile::append(const json& record) {
+    if (!openForAppend()) return false;
+
+    std::string line = record.dump();
+    line += '\n';
+    out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    out.flush();
+    appended_bytes += line.size();
+    return out.good();
+}
+
+bool JournalFile::compact(const json& snapshot) {
+    try {
+        close();
+
+        std::string line = snapshot.dump();
+        line += '\n';
+        std::string temp_path = path + ".tmp";
+        {
+            std::ofstream temp(temp_path, std::ios::binary | std::ios::trunc);
+            if (!temp.is_open()) return false;
+            temp.write(line.data(), static_cast<std::streamsize>(line.size()));
+            if (!temp.good()) return false;
+        }
+        std::filesystem::rename(temp_path, path);
+
+        snapshot_bytes = line.size();
+        appended_bytes = 0;
+        has_snapshot = true;
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to compact journal " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+}
+
+void JournalFile::close() {
+    if (out.is_open()) out.close();
+}
@@ -0,0 +1,47 @@
+#ifndef JOURNAL_FILE_H
+#define JOURNAL_FILE_H
+
+#include <string>
+#include <fstream>
+#include <functional>
+#include "nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+// Append-only log of JSON records, one compact object per line. The first
+// line is normally a full snapshot and later lines are changes to replay on
+// top of it, so a save writes only what changed. compact() replaces the file
+// with a single snapshot through a temporary file and a rename, and a line
+// torn by a crash is skipped on replay rather than failing the whole log.
+class JournalFile {
+public:
+    // Compact once the changes outgrow both this and twice the snapshot
+    static constexpr size_t COMPACT_MIN_BYTES = 64 * 1024;
+
+private:
+    std::string path;
+    std::ofstream out;
+    size_t snapshot_bytes = 0;
+    size_t appended_bytes = 0;
+    bool has_snapshot = false; // compact() has run since this object was created
+
+    bool openForAppend();
+
+public:
+    explicit JournalFile(std::string file_path) : path(std::move(file_path)) {}
+
+    // Feed every readable record to apply, oldest first; false if the file cannot be read
+    static bool replay(const std::string& file_path, const std::function<void(const json&)>& apply);
+
+    bool append(const json& record);
+    bool compact(const json& snapshot);
+    void close();
+
+    bool hasSnapshot() const { return has_snapshot; }
+    bool needsCompaction() const {
+        return !has_snapshot || (appended_bytes > COMPACT_MIN_BYTES && appended_bytes > 2 * snapshot_bytes);
+    }
+    const std::string& filePath() const { return path; }
+};
+
+#endif // JOURNAL_FILE_H
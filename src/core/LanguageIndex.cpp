@@ -0,0 +1,102 @@
+#include "LanguageIndex.h"
+#include <algorithm>
+
+void LanguageIndex::build(const std::vector<std::string>& translations, const InvertedIndexMap& indexes,
+                          const VerseAlignment& alignment) {
+    members.clear();
+    sources.clear();
+    postings.clear();
+    TermDictionary& dictionary = TermDictionary::shared();
+
+    std::vector<uint32_t> row_of;
+    for (const auto& name : translations) {
+        if (members.size() == MAX_TRANSLATIONS) break;
+        auto index_it = indexes.find(name);
+        std::span<const VerseId> column = alignment.column(name);
+        if (index_it == indexes.end() || column.empty()) continue;
+
+        // Invert the column: the row of each of this translation's verses
+        row_of.assign(index_it->second->verseCount(), VerseAlignment::NO_ROW);
+        for (uint32_t row = 0; row < column.size(); row++) {
+            VerseId id = column[row];
+            if (id != INVALID_VERSE_ID && id < row_of.size()) row_of[id] = row;
+        }
+
+        TranslationMask bit = TranslationMask{1} << members.size();
+        for (const auto& [term, term_postings] : index_it->second->terms()) {
+            std::vector<Posting>& list = postings[dictionary.find(term)];
+            for (VerseId id : term_postings.ids) {
+                if (id < row_of.size() && row_of[id] != VerseAlignment::NO_ROW) {
+                    list.push_back({row_of[id], bit});
+                }
+            }
+        }
+        members.push_back(name);
+        sources.push_back(index_it->second.get());
+    }
+
+    // Each member appended its rows in its own order; merge them into one sorted run per term
+    for (auto& [term, list] : postings) {
+        std::sort(list.begin(), list.end(), [](const Posting& a, const Posting& b) { return a.row < b.row; });
+        size_t out = 0;
+        for (size_t i = 0; i < list.size(); i++) {
+            if (out > 0 && list[out - 1].row == list[i].row) {
+                list[out - 1].translations |= list[i].translations;
+            } else {
+                list[out++] = list[i];
+            }
+        }
+        list.resize(out);
+        list.shrink_to_fit();
+    }
+    memory_charge.set(getMemoryUsage());
+}
+
+bool LanguageIndex::builtFrom(const std::vector<std::string>& translations, const InvertedIndexMap& indexes) const {
+    size_t expected = std::min(translations.size(), MAX_TRANSLATIONS);
+    if (members.size() != expected) return false;
+    for (size_t i = 0; i < members.size(); i++) {
+        auto it = indexes.find(members[i]);
+        if (members[i] != translations[i] || it == indexes.end() || it->second.get() != sources[i]) return false;
+    }
+    return true;
+}
+
+std::vector<LanguageIndex::Posting> LanguageIndex::match(const std::vector<std::string>& tokens) const {
+    const TermDictionary& dictionary = TermDictionary::shared();
+    std::vector<const std::vector<Posting>*> lists;
+    for (const auto& token : tokens) {
+        auto it = postings.find(dictionary.find(token));
+        if (it == postings.end()) return {};
+        lists.push_back(&it->second);
+    }
+    if (lists.empty()) return {};
+    std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) { return a->size() < b->size(); });
+
+    // Shortest list first; a row survives while some translation has every token there
+    std::vector<Posting> result = *lists[0];
+    for (size_t l = 1; l < lists.size() && !result.empty(); l++) {
+        const std::vector<Posting>& list = *lists[l];
+        size_t out = 0;
+        auto it = list.begin();
+        for (const Posting& posting : result) {
+            it = std::lower_bound(it, list.end(), posting.row,
+                                  [](const Posting& p, uint32_t row) { return p.row < row; });
+            if (it == list.end()) break;
+            if (it->row != posting.row) continue;
+            TranslationMask common = posting.translations & it->translations;
+            if (common) result[out++] = {posting.row, common};
+        }
+        result.resize(out);
+    }
+    return result;
+}
+
+size_t LanguageIndex::getMemoryUsage() const {
+    size_t bytes = 0;
+    for (const auto& [term, list] : postings) {
+        bytes += sizeof(TermId) + sizeof(list) + sizeof(void*) + list.capacity() * sizeof(Posting);
+    }
+    for (const auto& name : members) bytes += name.capacity();
+    return bytes;
+}
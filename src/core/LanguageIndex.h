@@ -0,0 +1,51 @@
+#ifndef LANGUAGEINDEX_H
+#define LANGUAGEINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "InvertedIndex.h"
+#include "TermDictionary.h"
+#include "VerseAlignment.h"
+
+// One keyword index for all resident translations of a language. Its
+// postings are VerseAlignment rows rather than per-translation verse ids, each
+// carrying a bit per member translation that has the term at that row, so a
+// query is intersected once for the whole language instead of once per
+// translation. Terms are TermDictionary ids, shared by every member.
+//
+// Built from the members' own indexes, so words match exactly (no stemming),
+// and verses without a row (apocrypha) are not covered.
+class LanguageIndex {
+public:
+    static constexpr size_t MAX_TRANSLATIONS = 32;
+    using TranslationMask = uint32_t; // bit i is translations()[i]
+
+    struct Posting {
+        uint32_t row;
+        TranslationMask translations;
+    };
+
+    // Index the first MAX_TRANSLATIONS of translations that have an index and a column
+    void build(const std::vector<std::string>& translations, const InvertedIndexMap& indexes,
+               const VerseAlignment& alignment);
+
+    const std::vector<std::string>& translations() const { return members; }
+    // Whether this was built from exactly these indexes, i.e. is still current
+    bool builtFrom(const std::vector<std::string>& translations, const InvertedIndexMap& indexes) const;
+
+    // Rows where every token occurs in the same translation, with the
+    // translations it does so in; sorted by row
+    std::vector<Posting> match(const std::vector<std::string>& tokens) const;
+
+    size_t getMemoryUsage() const;
+
+private:
+    std::vector<std::string> members;
+    std::vector<const InvertedIndex*> sources; // members' indexes, for builtFrom()
+    std::unordered_map<TermId, std::vector<Posting>> postings;
+    MemoryCharge memory_charge{MemoryTag::INVERTED_INDEX};
+};
+
+#endif // LANGUAGEINDEX_H
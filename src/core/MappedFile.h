@@ -0,0 +1,36 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <cstddef>
+
+// Read-only memory mapping of a whole file. Non-copyable; share it through a
+// shared_ptr when several views need to keep the mapping alive.
+class MappedFile {
+private:
+    const char* mapped_data = nullptr;
+    size_t mapped_size = 0;
+#ifdef _WIN32
+    void* file_handle = nullptr;
+    void* mapping_handle = nullptr;
+#else
+    int file_descriptor = -1;
+#endif
+
+    void close();
+
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    bool isOpen() const { return mapped_data != nullptr; }
+
+    const char* data() const { return mapped_data; }
+    size_t size() const { return mapped_size; }
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,78 @@
+#include "MemoryAccounting.h"
+#include "MetricsRegistry.h"
+#include <array>
+#include <atomic>
+#include <mutex>
+
+namespace {
+struct alignas(64) Cell {
+    std::atomic<int64_t> live_bytes{0};
+    std::atomic<uint64_t> allocated_bytes{0};
+    std::atomic<uint64_t> allocations{0};
+};
+
+// Constant-initialized, so allocations made during static initialization are safe
+std::array<std::array<Cell, metrics_detail::SHARDS>, MemoryAccounting::TAG_COUNT> cells;
+
+Cell& cellFor(MemoryTag tag) {
+    return cells[static_cast<size_t>(tag)][metrics_detail::shardIndex()];
+}
+}
+
+void MemoryAccounting::recordAllocation(MemoryTag tag, size_t bytes) {
+    Cell& cell = cellFor(tag);
+    cell.live_bytes.fetch_add(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+    cell.allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    cell.allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryAccounting::recordFree(MemoryTag tag, size_t bytes) {
+    cellFor(tag).live_bytes.fetch_sub(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+}
+
+MemoryAccounting::Usage MemoryAccounting::usage(MemoryTag tag) {
+    // Frees land in the freeing thread's shard, so only the sum is meaningful
+    Usage total;
+    for (const Cell& cell : cells[static_cast<size_t>(tag)]) {
+        total.live_bytes += cell.live_bytes.load(std::memory_order_relaxed);
+        total.allocated_bytes += cell.allocated_bytes.load(std::memory_order_relaxed);
+        total.allocations += cell.allocations.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+const char* MemoryAccounting::name(MemoryTag tag) {
+    switch (tag) {
+        case MemoryTag::VERSE_STORE: return "verse_store";
+        case MemoryTag::INVERTED_INDEX: return "inverted_index";
+        case MemoryTag::AUTOCOMPLETE: return "autocomplete";
+        case MemoryTag::TOPIC_INDEX: return "topic_index";
+        case MemoryTag::SEARCH_CACHE: return "search_cache";
+        case MemoryTag::PLUGINS: return "plugins";
+        case MemoryTag::MEDIA: return "media";
+        case MemoryTag::COUNT: break;
+    }
+    return "unknown";
+}
+
+void MemoryAccounting::publishMetrics() {
+    // Registry counters only go up, so each publish adds what accrued since the last
+    static std::mutex publish_mutex;
+    static std::array<Usage, TAG_COUNT> published{};
+    std::lock_guard<std::mutex> lock(publish_mutex);
+
+    MetricsRegistry& registry = MetricsRegistry::shared();
+    for (size_t t = 0; t < TAG_COUNT; ++t) {
+        auto tag = static_cast<MemoryTag>(t);
+        std::string labels = MetricsRegistry::label("subsystem", name(tag));
+        Usage current = usage(tag);
+
+        registry.gauge("versefinder_memory_live_bytes", "Heap bytes currently held, by subsystem", labels)
+            .set(static_cast<double>(current.live_bytes));
+        registry.counter("versefinder_memory_allocated_bytes_total", "Bytes allocated since start, by subsystem", labels)
+            .add(current.allocated_bytes - published[t].allocated_bytes);
+        registry.counter("versefinder_memory_allocations_total", "Allocations since start, by subsystem", labels)
+            .add(current.allocations - published[t].allocations);
+        published[t] = current;
+    }
+}
@@ -0,0 +1,124 @@
+#ifndef MEMORYACCOUNTING_H
+#define MEMORYACCOUNTING_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Subsystems whose memory is accounted separately
+enum class MemoryTag : uint8_t {
+    VERSE_STORE,
+    INVERTED_INDEX,
+    AUTOCOMPLETE,
+    TOPIC_INDEX,
+    SEARCH_CACHE,
+    PLUGINS,
+    MEDIA,
+    COUNT
+};
+
+// Live bytes and allocation totals per subsystem, so a growing process can be
+// traced to what grew. Containers a subsystem owns outright allocate through
+// TaggedAllocator, which counts every allocation exactly; memory a subsystem
+// sizes itself (indexes built once and then only read, cache entries, plugin
+// libraries, textures) is charged through a MemoryCharge. Counters are split
+// across per-thread shards, so recording never contends.
+class MemoryAccounting {
+public:
+    static constexpr size_t TAG_COUNT = static_cast<size_t>(MemoryTag::COUNT);
+
+    struct Usage {
+        int64_t live_bytes = 0;
+        uint64_t allocated_bytes = 0; // since start, for allocation rates
+        uint64_t allocations = 0;
+    };
+
+    static void recordAllocation(MemoryTag tag, size_t bytes);
+    static void recordFree(MemoryTag tag, size_t bytes);
+
+    static Usage usage(MemoryTag tag);
+    static const char* name(MemoryTag tag);
+
+    // Copy the totals into the metrics registry; call before rendering it
+    static void publishMetrics();
+};
+
+// std-compatible allocator that counts into one tag. Stateless, so tagged
+// containers are the same size as untagged ones.
+template <typename T, MemoryTag Tag>
+struct TaggedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = TaggedAllocator<U, Tag>;
+    };
+
+    TaggedAllocator() noexcept = default;
+    template <typename U>
+    TaggedAllocator(const TaggedAllocator<U, Tag>&) noexcept {}
+
+    T* allocate(size_t count) {
+        T* memory = std::allocator<T>().allocate(count);
+        MemoryAccounting::recordAllocation(Tag, count * sizeof(T));
+        return memory;
+    }
+    void deallocate(T* memory, size_t count) noexcept {
+        MemoryAccounting::recordFree(Tag, count * sizeof(T));
+        std::allocator<T>().deallocate(memory, count);
+    }
+
+    template <typename U>
+    bool operator==(const TaggedAllocator<U, Tag>&) const noexcept { return true; }
+};
+
+template <typename T, MemoryTag Tag>
+using TaggedVector = std::vector<T, TaggedAllocator<T, Tag>>;
+
+template <MemoryTag Tag>
+using TaggedString = std::basic_string<char, std::char_traits<char>, TaggedAllocator<char, Tag>>;
+
+template <typename Key, typename Value, MemoryTag Tag>
+using TaggedHashMap = std::unordered_map<Key, Value, std::hash<Key>, std::equal_to<Key>,
+                                         TaggedAllocator<std::pair<const Key, Value>, Tag>>;
+
+// Bytes its owner accounts for itself, charged to a tag until released or
+// destroyed. Moving transfers the charge.
+class MemoryCharge {
+private:
+    MemoryTag tag;
+    size_t bytes = 0;
+
+public:
+    explicit MemoryCharge(MemoryTag charged) : tag(charged) {}
+    ~MemoryCharge() { set(0); }
+
+    MemoryCharge(MemoryCharge&& other) noexcept : tag(other.tag), bytes(std::exchange(other.bytes, 0)) {}
+    MemoryCharge& operator=(MemoryCharge&& other) noexcept {
+        if (this != &other) {
+            set(0);
+            tag = other.tag;
+            bytes = std::exchange(other.bytes, 0);
+        }
+        return *this;
+    }
+    MemoryCharge(const MemoryCharge&) = delete;
+    MemoryCharge& operator=(const MemoryCharge&) = delete;
+
+    // Growth is recorded as an allocation, shrinking as a free
+    void set(size_t new_bytes) {
+        if (new_bytes > bytes) MemoryAccounting::recordAllocation(tag, new_bytes - bytes);
+        else if (new_bytes < bytes) MemoryAccounting::recordFree(tag, bytes - new_bytes);
+        bytes = new_bytes;
+    }
+    void add(size_t amount) { set(bytes + amount); }
+    void subtract(size_t amount) { set(bytes - std::min(bytes, amount)); }
+    size_t size() const { return bytes; }
+};
+
+#endif // MEMORYACCOUNTING_H
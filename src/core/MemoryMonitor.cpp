@@ -1,4 +1,5 @@
 #include "MemoryMonitor.h"
+#include "CacheManager.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -36,7 +37,7 @@ void MemoryMonitor::startMonitoring(std::chrono::milliseconds interval) {
     sample_interval = interval;
     monitoring.store(true);
     
-    monitor_thread = std::thread(&MemoryMonitor::monitoringLoop, this);
+    monitor_done = spawn(monitoringLoop(), TaskPriority::BACKGROUND);
 }
 
 void MemoryMonitor::stopMonitoring() {
@@ -45,17 +46,14 @@ void MemoryMonitor::stopMonitoring() {
     }
     
     monitoring.store(false);
-    stop_condition.notify_all();
+    stop_event.set();
     
-    if (monitor_thread.joinable()) {
-        monitor_thread.join();
+    if (monitor_done.valid()) {
+        monitor_done.wait();
     }
 }
 
-void MemoryMonitor::monitoringLoop() {
-    std::mutex mtx;
-    std::unique_lock<std::mutex> lock(mtx);
-    
+Task<void> MemoryMonitor::monitoringLoop() {
     while (monitoring.load()) {
         MemorySnapshot snapshot = getCurrentMemoryInfo();
         
@@ -71,10 +69,13 @@ void MemoryMonitor::monitoringLoop() {
             peak_memory_ever = snapshot.resident_memory_mb;
         }
         
-        // Wait for the next sample interval or stop signal
-        if (stop_condition.wait_for(lock, sample_interval, [this] { return !monitoring.load(); })) {
-            break; // Stop signal received
-        }
+        // Over the threshold, caches give back the excess; under it, they grow back
+        size_t threshold_mb = memory_threshold_mb;
+        size_t over_mb = snapshot.resident_memory_mb > threshold_mb ? snapshot.resident_memory_mb - threshold_mb : 0;
+        CacheManager::shared().reportMemoryPressure(over_mb * 1024 * 1024);
+        
+        // Wait for the next sample interval or stop signal, holding no thread
+        co_await stop_event.waitFor(sample_interval, TaskPriority::BACKGROUND);
     }
 }
 
@@ -92,16 +93,19 @@ MemorySnapshot MemoryMonitor::getCurrentSnapshot() const {
 
 MemorySnapshot MemoryMonitor::getCurrentMemoryInfo() const {
 #ifdef _WIN32
-    return getWindowsMemoryInfo();
+    MemorySnapshot snapshot = getWindowsMemoryInfo();
 #elif __APPLE__
-    return getMacOSMemoryInfo();
+    MemorySnapshot snapshot = getMacOSMemoryInfo();
 #elif __linux__
-    return getLinuxMemoryInfo();
+    MemorySnapshot snapshot = getLinuxMemoryInfo();
 #else
     // Fallback for unknown platforms
     MemorySnapshot snapshot;
-    return snapshot;
 #endif
+    for (size_t tag = 0; tag < MemoryAccounting::TAG_COUNT; ++tag) {
+        snapshot.subsystems[tag] = MemoryAccounting::usage(static_cast<MemoryTag>(tag));
+    }
+    return snapshot;
 }
 
 #ifdef _WIN32
@@ -323,7 +327,34 @@ std::string MemoryMonitor::getMemoryReport() const {
     report << "Maximum Recorded: " << max.resident_memory_mb << " MB\n";
     report << "Memory Threshold: " << memory_threshold_mb << " MB\n";
     report << "Threshold Exceeded: " << (isMemoryThresholdExceeded() ? "YES" : "NO") << "\n";
-    report << "Total Snapshots: " << snapshots.size() << "\n";
+    
+    // Allocation rates are over the time since the last recorded snapshot, and
+    // growth is since the oldest one still kept
+    MemorySnapshot first = current;
+    MemorySnapshot last = current;
+    size_t snapshot_count;
+    {
+        std::lock_guard<std::mutex> lock(snapshots_mutex);
+        snapshot_count = snapshots.size();
+        if (!snapshots.empty()) {
+            first = snapshots.front();
+            last = snapshots.back();
+        }
+    }
+    report << "Total Snapshots: " << snapshot_count << "\n";
+    
+    double seconds = std::chrono::duration<double>(current.timestamp - last.timestamp).count();
+    report << "\nSubsystem          Live MB   Alloc/s MB   Growth MB\n";
+    report << std::fixed << std::setprecision(2);
+    for (size_t tag = 0; tag < MemoryAccounting::TAG_COUNT; ++tag) {
+        const MemoryAccounting::Usage& now = current.subsystems[tag];
+        double allocated = static_cast<double>(now.allocated_bytes - last.subsystems[tag].allocated_bytes);
+        double growth = static_cast<double>(now.live_bytes - first.subsystems[tag].live_bytes);
+        report << std::left << std::setw(16) << MemoryAccounting::name(static_cast<MemoryTag>(tag)) << std::right
+               << std::setw(10) << now.live_bytes / (1024.0 * 1024.0)
+               << std::setw(13) << (seconds > 0 ? allocated / seconds / (1024.0 * 1024.0) : 0.0)
+               << std::setw(12) << growth / (1024.0 * 1024.0) << "\n";
+    }
     
     return report.str();
 }
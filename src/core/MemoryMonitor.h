@@ -1,13 +1,15 @@
 #ifndef MEMORYMONITOR_H
 #define MEMORYMONITOR_H
 
+#include <array>
 #include <chrono>
 #include <string>
 #include <vector>
 #include <atomic>
-#include <thread>
+#include <future>
 #include <mutex>
-#include <condition_variable>
+#include "MemoryAccounting.h"
+#include "Task.h"
 
 struct MemorySnapshot {
     std::chrono::steady_clock::time_point timestamp;
@@ -16,6 +18,7 @@ struct MemorySnapshot {
     size_t peak_memory_mb;          // Peak memory usage in MB
     size_t heap_memory_mb;          // Heap memory in MB (if available)
     double cpu_usage_percent;       // CPU usage percentage
+    std::array<MemoryAccounting::Usage, MemoryAccounting::TAG_COUNT> subsystems{}; // indexed by MemoryTag
     
     MemorySnapshot() : timestamp(std::chrono::steady_clock::now()),
                       resident_memory_mb(0), virtual_memory_mb(0), 
@@ -24,11 +27,12 @@ struct MemorySnapshot {
 
 class MemoryMonitor {
 private:
+    // Sampling is a coroutine on the TaskScheduler, suspended between samples
     std::atomic<bool> monitoring{false};
-    std::thread monitor_thread;
+    std::future<void> monitor_done;
+    AsyncEvent stop_event;
     std::vector<MemorySnapshot> snapshots;
     mutable std::mutex snapshots_mutex;
-    std::condition_variable stop_condition;
     
     // Configuration
     std::chrono::milliseconds sample_interval{1000}; // 1 second default
@@ -49,7 +53,7 @@ private:
     MemorySnapshot getLinuxMemoryInfo() const;
 #endif
     
-    void monitoringLoop();
+    Task<void> monitoringLoop();
     void trimSnapshots();
 
 public:
@@ -0,0 +1,203 @@
+#include "MetricsRegistry.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+
+size_t metrics_detail::shardIndex() {
+    static std::atomic<size_t> next_shard{0};
+    thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+    return shard;
+}
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards) total += shard.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+size_t Histogram::bucketFor(uint64_t micros) {
+    if (micros < SUB_BUCKETS) return static_cast<size_t>(micros);
+    int exponent = std::bit_width(micros) - 1;
+    if (exponent >= MAX_EXPONENT) return BUCKETS - 1;
+    size_t sub_bucket = (micros >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return static_cast<size_t>(exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub_bucket;
+}
+
+uint64_t Histogram::bucketUpperBound(size_t bucket) {
+    if (bucket < SUB_BUCKETS) return bucket + 1;
+    int shift = static_cast<int>(bucket / SUB_BUCKETS) - 1;
+    return (SUB_BUCKETS + bucket % SUB_BUCKETS + 1) << shift;
+}
+
+void Histogram::reset() {
+    for (size_t s = 0; s < SHARDS; ++s) {
+        for (auto& bucket : shards[s].counts) bucket.store(0, std::memory_order_relaxed);
+        shards[s].sum_us.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::array<uint64_t, Histogram::BUCKETS> Histogram::counts() const {
+    std::array<uint64_t, BUCKETS> merged{};
+    for (size_t s = 0; s < SHARDS; ++s) {
+        for (size_t b = 0; b < BUCKETS; ++b) {
+            merged[b] += shards[s].counts[b].load(std::memory_order_relaxed);
+        }
+    }
+    return merged;
+}
+
+uint64_t Histogram::count() const {
+    uint64_t total = 0;
+    for (uint64_t bucket_count : counts()) total += bucket_count;
+    return total;
+}
+
+uint64_t Histogram::sumMicros() const {
+    uint64_t total = 0;
+    for (size_t s = 0; s < SHARDS; ++s) total += shards[s].sum_us.load(std::memory_order_relaxed);
+    return total;
+}
+
+double Histogram::quantileMicros(double q) const {
+    auto merged = counts();
+    uint64_t total = 0;
+    for (uint64_t bucket_count : merged) total += bucket_count;
+    if (total == 0) return 0.0;
+
+    auto rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(total)));
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0;
+    for (size_t b = 0; b < BUCKETS; ++b) {
+        seen += merged[b];
+        if (seen >= rank) {
+            if (b < SUB_BUCKETS) return static_cast<double>(b);
+            uint64_t lower = bucketUpperBound(b - 1);
+            return (static_cast<double>(lower) + static_cast<double>(bucketUpperBound(b))) / 2.0;
+        }
+    }
+    return static_cast<double>(bucketUpperBound(BUCKETS - 1));
+}
+
+MetricsRegistry& MetricsRegistry::shared() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+template <typename Metric>
+Metric& MetricsRegistry::lookup(const std::string& name, const std::string& help, const std::string& labels,
+                                Kind kind, std::map<std::string, std::unique_ptr<Metric>> Family::*series) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto family = families.find(name);
+        if (family != families.end() && family->second.kind == kind) {
+            auto it = (family->second.*series).find(labels);
+            if (it != (family->second.*series).end()) return *it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto [family, inserted] = families.try_emplace(name);
+    if (inserted) {
+        family->second.kind = kind;
+        family->second.help = help;
+    } else if (family->second.kind != kind) {
+        throw std::logic_error("Metric " + name + " is already registered as a different type");
+    }
+    auto& slot = (family->second.*series)[labels];
+    if (!slot) slot = std::make_unique<Metric>();
+    return *slot;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const std::string& labels) {
+    return lookup(name, help, labels, Kind::COUNTER, &Family::counters);
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const std::string& labels) {
+    return lookup(name, help, labels, Kind::GAUGE, &Family::gauges);
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const std::string& labels) {
+    return lookup(name, help, labels, Kind::HISTOGRAM, &Family::histograms);
+}
+
+std::string MetricsRegistry::label(const std::string& key, const std::string& value) {
+    std::string result = key + "=\"";
+    for (char c : value) {
+        if (c == '\\' || c == '"') {
+            result += '\\';
+            result += c;
+        } else if (c == '\n') {
+            result += "\\n";
+        } else {
+            result += c;
+        }
+    }
+    result += '"';
+    return result;
+}
+
+namespace {
+std::string formatNumber(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    return buffer;
+}
+
+std::string seriesName(const std::string& name, const std::string& labels, const std::string& extra = "") {
+    if (labels.empty() && extra.empty()) return name;
+    std::string result = name + "{" + labels;
+    if (!labels.empty() && !extra.empty()) result += ",";
+    return result + extra + "}";
+}
+}
+
+std::string MetricsRegistry::renderPrometheus() const {
+    // Histogram buckets are exported at powers of two from 16 us to about 134 s,
+    // which line up with the internal bucket edges so the counts are exact
+    constexpr int FIRST_EXPORTED_EXPONENT = 4;
+    constexpr int LAST_EXPORTED_EXPONENT = 27;
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    std::string out;
+    for (const auto& [name, family] : families) {
+        out += "# HELP " + name + " " + family.help + "\n";
+        switch (family.kind) {
+            case Kind::COUNTER:
+                out += "# TYPE " + name + " counter\n";
+                for (const auto& [labels, metric] : family.counters) {
+                    out += seriesName(name, labels) + " " + std::to_string(metric->value()) + "\n";
+                }
+                break;
+            case Kind::GAUGE:
+                out += "# TYPE " + name + " gauge\n";
+                for (const auto& [labels, metric] : family.gauges) {
+                    out += seriesName(name, labels) + " " + formatNumber(metric->value()) + "\n";
+                }
+                break;
+            case Kind::HISTOGRAM:
+                out += "# TYPE " + name + " histogram\n";
+                for (const auto& [labels, metric] : family.histograms) {
+                    auto merged = metric->counts();
+                    uint64_t cumulative = 0;
+                    size_t bucket = 0;
+                    for (int exponent = FIRST_EXPORTED_EXPONENT; exponent <= LAST_EXPORTED_EXPONENT; ++exponent) {
+                        uint64_t bound = uint64_t{1} << exponent;
+                        for (; bucket < Histogram::BUCKETS && Histogram::bucketUpperBound(bucket) <= bound; ++bucket) {
+                            cumulative += merged[bucket];
+                        }
+                        out += seriesName(name + "_bucket", labels, "le=\"" + formatNumber(bound / 1e6) + "\"") +
+                               " " + std::to_string(cumulative) + "\n";
+                    }
+                    for (; bucket < Histogram::BUCKETS; ++bucket) cumulative += merged[bucket];
+                    out += seriesName(name + "_bucket", labels, "le=\"+Inf\"") + " " + std::to_string(cumulative) + "\n";
+                    out += seriesName(name + "_sum", labels) + " " + formatNumber(metric->sumMicros() / 1e6) + "\n";
+                    out += seriesName(name + "_count", labels) + " " + std::to_string(cumulative) + "\n";
+                }
+                break;
+        }
+    }
+    return out;
+}
@@ -0,0 +1,143 @@
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+
+namespace metrics_detail {
+constexpr size_t SHARDS = 16;
+
+// This thread's shard; threads are spread round-robin as they first report
+size_t shardIndex();
+
+struct alignas(64) PaddedCount {
+    std::atomic<uint64_t> value{0};
+};
+}
+
+// Monotonic count, split across per-thread shards so concurrent increments
+// do not contend on one cache line
+class Counter {
+private:
+    std::array<metrics_detail::PaddedCount, metrics_detail::SHARDS> shards;
+
+public:
+    void add(uint64_t amount = 1) {
+        shards[metrics_detail::shardIndex()].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+    uint64_t value() const;
+};
+
+class Gauge {
+private:
+    std::atomic<double> current{0.0};
+
+public:
+    void set(double value) { current.store(value, std::memory_order_relaxed); }
+    void add(double amount) { current.fetch_add(amount, std::memory_order_relaxed); }
+    double value() const { return current.load(std::memory_order_relaxed); }
+};
+
+// Latency distribution in microseconds. Buckets are log-linear, eight per
+// power of two, so any quantile read back is within 12.5% of the true value
+// while recording stays one relaxed increment. Values from 2^40 us up share
+// the last bucket.
+class Histogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 3;
+    static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+    static constexpr int MAX_EXPONENT = 40;
+    static constexpr size_t BUCKETS = SUB_BUCKETS * (MAX_EXPONENT - SUB_BUCKET_BITS + 1);
+    static constexpr size_t SHARDS = 4;
+
+private:
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, BUCKETS> counts{};
+        std::atomic<uint64_t> sum_us{0};
+    };
+    std::unique_ptr<Shard[]> shards = std::make_unique<Shard[]>(SHARDS);
+
+public:
+    static size_t bucketFor(uint64_t micros);
+    // Smallest value that falls past the bucket
+    static uint64_t bucketUpperBound(size_t bucket);
+
+    void observe(uint64_t micros) {
+        Shard& shard = shards[metrics_detail::shardIndex() % SHARDS];
+        shard.counts[bucketFor(micros)].fetch_add(1, std::memory_order_relaxed);
+        shard.sum_us.fetch_add(micros, std::memory_order_relaxed);
+    }
+    void observe(std::chrono::steady_clock::duration elapsed) {
+        auto micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+        observe(static_cast<uint64_t>(micros < 0 ? 0 : micros));
+    }
+
+    // Zeroes every bucket; safe while other threads record
+    void reset();
+
+    // Merged across shards
+    std::array<uint64_t, BUCKETS> counts() const;
+    uint64_t count() const;
+    uint64_t sumMicros() const;
+    // q in [0, 1]; 0 when nothing has been recorded
+    double quantileMicros(double q) const;
+};
+
+// Records how long the enclosing scope took
+class ScopedLatency {
+private:
+    Histogram& histogram;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+public:
+    explicit ScopedLatency(Histogram& target) : histogram(target) {}
+    ~ScopedLatency() { histogram.observe(std::chrono::steady_clock::now() - start); }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+};
+
+// Process-wide set of named metrics, rendered in the Prometheus text format.
+// Looking a metric up takes a lock, so hot paths should look it up once and
+// keep the reference; metrics are never removed, so references stay valid.
+// A series is a metric name plus a label set such as method="keyword"; build
+// label sets with label() so values are escaped.
+class MetricsRegistry {
+public:
+    static MetricsRegistry& shared();
+
+    Counter& counter(const std::string& name, const std::string& help, const std::string& labels = "");
+    Gauge& gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+    // Exported in seconds, as Prometheus expects
+    Histogram& histogram(const std::string& name, const std::string& help, const std::string& labels = "");
+
+    static std::string label(const std::string& key, const std::string& value);
+
+    std::string renderPrometheus() const;
+
+private:
+    enum class Kind { COUNTER, GAUGE, HISTOGRAM };
+
+    struct Family {
+        Kind kind;
+        std::string help;
+        std::map<std::string, std::unique_ptr<Counter>> counters;
+        std::map<std::string, std::unique_ptr<Gauge>> gauges;
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;
+    };
+
+    mutable std::shared_mutex mutex;
+    std::map<std::string, Family> families;
+
+    template <typename Metric>
+    Metric& lookup(const std::string& name, const std::string& help, const std::string& labels, Kind kind,
+                   std::map<std::string, std::unique_ptr<Metric>> Family::*series);
+};
+
+#endif // METRICSREGISTRY_H
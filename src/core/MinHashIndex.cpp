@@ -0,0 +1,215 @@
+#include "MinHashIndex.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <unordered_map>
+
+namespace {
+
+constexpr size_t BUILD_CHUNK = 1024;
+
+constexpr uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Hash i of a shingle is the top half of multipliers[i] * shingle + addends[i]
+// (multiply-shift), the shingle itself being well mixed already
+struct HashFamily {
+    std::array<uint64_t, MinHashIndex::HASHES> multipliers{};
+    std::array<uint64_t, MinHashIndex::HASHES> addends{};
+};
+
+constexpr HashFamily makeHashFamily() {
+    HashFamily family;
+    for (size_t i = 0; i < MinHashIndex::HASHES; ++i) {
+        family.multipliers[i] = mix(2 * i + 1) | 1;
+        family.addends[i] = mix(2 * i + 2);
+    }
+    return family;
+}
+
+constexpr HashFamily HASH_FAMILY = makeHashFamily();
+
+} // namespace
+
+MinHashIndex::Shingles MinHashIndex::shinglesOf(std::span<const TermId> terms) {
+    Shingles shingles;
+    shingles.reserve(terms.size());
+    for (size_t i = 1; i < terms.size(); ++i) {
+        shingles.push_back(mix((uint64_t(terms[i - 1]) << 32) | terms[i]));
+    }
+    // A one-word verse is its own shingle
+    if (terms.size() == 1) shingles.push_back(mix(terms[0]));
+
+    std::sort(shingles.begin(), shingles.end());
+    shingles.erase(std::unique(shingles.begin(), shingles.end()), shingles.end());
+    return shingles;
+}
+
+bool MinHashIndex::signatureOf(const Shingles& shingles, Signature& signature) {
+    if (shingles.empty()) return false;
+    signature.fill(std::numeric_limits<uint32_t>::max());
+    for (uint64_t shingle : shingles) {
+        for (size_t i = 0; i < HASHES; ++i) {
+            uint64_t hash = HASH_FAMILY.multipliers[i] * shingle + HASH_FAMILY.addends[i];
+            signature[i] = std::min(signature[i], static_cast<uint32_t>(hash >> 32));
+        }
+    }
+    return true;
+}
+
+uint32_t MinHashIndex::bandKey(const Signature& signature, size_t band) {
+    uint64_t key = band;
+    for (size_t row = 0; row < ROWS; ++row) key = mix(key ^ signature[band * ROWS + row]);
+    return static_cast<uint32_t>(key >> 32);
+}
+
+double MinHashIndex::jaccard(const Shingles& a, const Shingles& b) {
+    if (a.empty() || b.empty()) return 0.0;
+    size_t shared = 0;
+    auto ia = a.begin();
+    auto ib = b.begin();
+    while (ia != a.end() && ib != b.end()) {
+        if (*ia < *ib) {
+            ++ia;
+        } else if (*ib < *ia) {
+            ++ib;
+        } else {
+            ++shared;
+            ++ia;
+            ++ib;
+        }
+    }
+    return static_cast<double>(shared) / static_cast<double>(a.size() + b.size() - shared);
+}
+
+void MinHashIndex::build(const VerseStore& store) {
+    clear();
+    verse_count = store.size();
+    if (verse_count == 0) return;
+
+    // Band keys per verse; verses without words are left out
+    std::vector<uint32_t> keys(verse_count * BANDS);
+    std::vector<uint8_t> indexed(verse_count, 0);
+    TaskScheduler::shared().parallelFor((verse_count + BUILD_CHUNK - 1) / BUILD_CHUNK, [&](size_t chunk) {
+        Signature signature;
+        size_t end = std::min(verse_count, (chunk + 1) * BUILD_CHUNK);
+        for (size_t id = chunk * BUILD_CHUNK; id < end; ++id) {
+            if (!signatureOf(shinglesOf(store.terms(static_cast<VerseId>(id))), signature)) continue;
+            for (size_t band = 0; band < BANDS; ++band) keys[id * BANDS + band] = bandKey(signature, band);
+            indexed[id] = 1;
+        }
+    });
+
+    indexed_count = static_cast<size_t>(std::count(indexed.begin(), indexed.end(), 1));
+    bands.resize(indexed_count * BANDS);
+    TaskScheduler::shared().parallelFor(BANDS, [&](size_t band) {
+        uint64_t* out = bands.data() + band * indexed_count;
+        for (size_t id = 0; id < verse_count; ++id) {
+            if (indexed[id]) *out++ = (uint64_t(keys[id * BANDS + band]) << 32) | id;
+        }
+        std::sort(bands.data() + band * indexed_count, out);
+    });
+}
+
+void MinHashIndex::clear() {
+    bands.clear();
+    bands.shrink_to_fit();
+    indexed_count = 0;
+    verse_count = 0;
+}
+
+std::pair<const uint64_t*, const uint64_t*> MinHashIndex::bucket(size_t band, uint32_t key) const {
+    const uint64_t* first = bands.data() + band * indexed_count;
+    const uint64_t* last = first + indexed_count;
+    const uint64_t low = uint64_t(key) << 32;
+    first = std::lower_bound(first, last, low);
+    return {first, std::lower_bound(first, last, low | 0xFFFFFFFFULL)};
+}
+
+std::vector<MinHashIndex::Match> MinHashIndex::findSimilar(const VerseStore& store, VerseId id,
+                                                          double threshold, size_t max_results) const {
+    std::vector<Match> matches;
+    if (empty() || id >= store.size()) return matches;
+
+    Shingles shingles = shinglesOf(store.terms(id));
+    Signature signature;
+    if (!signatureOf(shingles, signature)) return matches;
+
+    std::vector<VerseId> candidates;
+    for (size_t band = 0; band < BANDS; ++band) {
+        auto [first, last] = bucket(band, bandKey(signature, band));
+        for (const uint64_t* entry = first; entry != last; ++entry) {
+            VerseId candidate = static_cast<VerseId>(*entry & 0xFFFFFFFFULL);
+            if (candidate != id) candidates.push_back(candidate);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    for (VerseId candidate : candidates) {
+        double similarity = jaccard(shingles, shinglesOf(store.terms(candidate)));
+        if (similarity >= threshold) matches.emplace_back(candidate, similarity);
+    }
+    std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+    if (matches.size() > max_results) matches.resize(max_results);
+    return matches;
+}
+
+std::vector<MinHashIndex::SimilarPair> MinHashIndex::findSimilarPairs(const VerseStore& store,
+                                                                     const std::vector<VerseId>& members,
+                                                                     double threshold) const {
+    std::vector<SimilarPair> pairs;
+    if (empty() || members.empty()) return pairs;
+
+    std::vector<uint8_t> is_member(verse_count, 0);
+    for (VerseId id : members) {
+        if (id < verse_count) is_member[id] = 1;
+    }
+
+    // Members sharing a bucket in any band
+    std::vector<VerseId> in_bucket;
+    for (size_t band = 0; band < BANDS; ++band) {
+        const uint64_t* entry = bands.data() + band * indexed_count;
+        const uint64_t* end = entry + indexed_count;
+        while (entry != end) {
+            const uint64_t* run_end = entry + 1;
+            while (run_end != end && (*run_end >> 32) == (*entry >> 32)) ++run_end;
+            if (run_end - entry > 1 && static_cast<size_t>(run_end - entry) <= MAX_GROUP_BUCKET) {
+                in_bucket.clear();
+                for (const uint64_t* e = entry; e != run_end; ++e) {
+                    VerseId id = static_cast<VerseId>(*e & 0xFFFFFFFFULL);
+                    if (is_member[id]) in_bucket.push_back(id);
+                }
+                for (size_t i = 0; i < in_bucket.size(); ++i) {
+                    for (size_t j = i + 1; j < in_bucket.size(); ++j) pairs.push_back({in_bucket[i], in_bucket[j], 0.0});
+                }
+            }
+            entry = run_end;
+        }
+    }
+    auto samePair = [](const SimilarPair& a, const SimilarPair& b) { return a.first == b.first && a.second == b.second; };
+    std::sort(pairs.begin(), pairs.end(), [](const SimilarPair& a, const SimilarPair& b) {
+        return a.first != b.first ? a.first < b.first : a.second < b.second;
+    });
+    pairs.erase(std::unique(pairs.begin(), pairs.end(), samePair), pairs.end());
+
+    // Verify, computing each verse's shingles once
+    std::unordered_map<VerseId, Shingles> shingles;
+    auto shinglesFor = [&](VerseId id) -> const Shingles& {
+        auto it = shingles.find(id);
+        if (it == shingles.end()) it = shingles.emplace(id, shinglesOf(store.terms(id))).first;
+        return it->second;
+    };
+    std::erase_if(pairs, [&](SimilarPair& pair) {
+        pair.similarity = jaccard(shinglesFor(pair.first), shinglesFor(pair.second));
+        return pair.similarity < threshold;
+    });
+    return pairs;
+}
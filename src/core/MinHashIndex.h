@@ -0,0 +1,69 @@
+#ifndef MINHASHINDEX_H
+#define MINHASHINDEX_H
+
+#include <array>
+#include <span>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include "VerseStore.h"
+
+// Near-duplicate lookup for one translation. Each verse is reduced to the
+// set of its folded word pairs (term ids), summarised by a MinHash signature of
+// HASHES values, and the signature is cut into BANDS bands of ROWS values.
+// Verses agreeing on every value of some band share a bucket; a lookup reads
+// the verse's buckets and checks only those candidates' actual word-pair
+// overlap. With the constants below a pair overlapping by 0.5 (Jaccard) is
+// found about 93% of the time and one overlapping by 0.1 almost never.
+//
+// Band b is one sorted array of (bucket << 32 | verse id), so a bucket is an
+// equal range and the index costs 8 bytes per verse per band.
+class MinHashIndex {
+public:
+    static constexpr size_t ROWS = 3;
+    static constexpr size_t BANDS = 20;
+    static constexpr size_t HASHES = ROWS * BANDS;
+    // Buckets larger than this (formulaic verses) are skipped when grouping
+    static constexpr size_t MAX_GROUP_BUCKET = 256;
+
+    using Signature = std::array<uint32_t, HASHES>;
+    using Shingles = std::vector<uint64_t>; // sorted, distinct word-pair hashes
+    using Match = std::pair<VerseId, double>; // verse, Jaccard similarity
+
+    struct SimilarPair {
+        VerseId first;
+        VerseId second; // greater than first
+        double similarity;
+    };
+
+private:
+    std::vector<uint64_t> bands; // BANDS runs of indexed_count entries
+    size_t indexed_count = 0;
+    size_t verse_count = 0;
+
+    std::pair<const uint64_t*, const uint64_t*> bucket(size_t band, uint32_t key) const;
+
+public:
+    // Adjacent pairs of a verse's words, from VerseStore::terms()
+    static Shingles shinglesOf(std::span<const TermId> terms);
+    // False for text without words
+    static bool signatureOf(const Shingles& shingles, Signature& signature);
+    static uint32_t bandKey(const Signature& signature, size_t band);
+    static double jaccard(const Shingles& a, const Shingles& b);
+
+    // Index every verse of store, in parallel
+    void build(const VerseStore& store);
+    void clear();
+
+    // Verses of store at least threshold similar to id, most similar first
+    std::vector<Match> findSimilar(const VerseStore& store, VerseId id, double threshold, size_t max_results) const;
+    // Pairs of members at least threshold similar, ordered by ids
+    std::vector<SimilarPair> findSimilarPairs(const VerseStore& store, const std::vector<VerseId>& members,
+                                              double threshold) const;
+
+    size_t verseCount() const { return verse_count; }
+    bool empty() const { return indexed_count == 0; }
+    size_t getMemoryUsage() const { return bands.capacity() * sizeof(uint64_t); }
+};
+
+#endif // MINHASHINDEX_H
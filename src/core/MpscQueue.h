@@ -0,0 +1,72 @@
+#ifndef MPSCQUEUE_H
+#define MPSCQUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+
+// Bounded lock-free queue for many producers and one consumer at a time.
+// Every cell carries a sequence number telling producers and the consumer
+// whose turn it is, so a push is one compare-and-swap on the tail plus one
+// release store, and it never blocks: when the queue is full it fails and the
+// caller decides what to drop. Capacity is rounded up to a power of two.
+template <typename T>
+class MpscQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> tail{0}; // next position to claim, shared by producers
+    alignas(64) size_t head = 0;             // next position to read, consumer only
+
+public:
+    explicit MpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        cells = std::make_unique<Cell[]>(size);
+        mask = size - 1;
+        for (size_t i = 0; i < size; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Any thread; false if the queue is full
+    bool push(T value) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[position & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto turn = static_cast<std::ptrdiff_t>(sequence - position);
+            if (turn == 0) {
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (turn < 0) {
+                return false; // the consumer has not freed this cell yet
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer only (callers must serialise); false if nothing is ready
+    bool pop(T& value) {
+        Cell& cell = cells[head & mask];
+        if (cell.sequence.load(std::memory_order_acquire) != head + 1) return false;
+        value = std::move(cell.value);
+        cell.sequence.store(head + mask + 1, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+    size_t capacity() const { return mask + 1; }
+};
+
+#endif // MPSCQUEUE_H
@@ -0,0 +1,543 @@
+#include "PatternMatcher.h"
+#include <algorithm>
+#include <cctype>
+#include <deque>
+
+struct PatternMatcher::Node {
+    enum class Kind { BYTES, CONCAT, ALTERNATE, STAR, PLUS, OPTIONAL };
+    Kind kind = Kind::CONCAT;
+    std::bitset<256> bytes; // BYTES: the bytes it matches
+    std::vector<Node> children;
+};
+
+namespace {
+using Node = PatternMatcher::Node;
+using Kind = Node::Kind;
+
+Node nodeOf(Kind kind) {
+    Node node;
+    node.kind = kind;
+    return node;
+}
+
+int firstByte(const std::bitset<256>& bytes) {
+    for (int byte = 0; byte < 256; ++byte) {
+        if (bytes[byte]) return byte;
+    }
+    return -1;
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Recursive descent over the supported subset; anything else, valid or not,
+// clears ok and is left to std::regex
+class PatternParser {
+private:
+    std::string_view text;
+    size_t pos = 0;
+    bool ok = true;
+
+    Node parseAlternation() {
+        Node alternation = nodeOf(Kind::ALTERNATE);
+        alternation.children.push_back(parseConcatenation());
+        while (ok && pos < text.size() && text[pos] == '|') {
+            ++pos;
+            alternation.children.push_back(parseConcatenation());
+        }
+        if (alternation.children.size() == 1) return std::move(alternation.children[0]);
+        return alternation;
+    }
+
+    Node parseConcatenation() {
+        Node concatenation = nodeOf(Kind::CONCAT);
+        while (ok && pos < text.size() && text[pos] != '|' && text[pos] != ')') {
+            concatenation.children.push_back(parseRepeat());
+        }
+        return concatenation;
+    }
+
+    Node parseRepeat() {
+        Node atom = parseAtom();
+        if (!ok || pos >= text.size()) return atom;
+        Kind kind;
+        switch (text[pos]) {
+            case '*': kind = Kind::STAR; break;
+            case '+': kind = Kind::PLUS; break;
+            case '?': kind = Kind::OPTIONAL; break;
+            case '{': ok = false; return atom;
+            default: return atom;
+        }
+        ++pos;
+        // Lazy or greedy, whether there is a match is the same
+        if (pos < text.size() && text[pos] == '?') ++pos;
+        if (pos < text.size() && (text[pos] == '*' || text[pos] == '+' || text[pos] == '?' || text[pos] == '{')) {
+            ok = false;
+            return atom;
+        }
+        Node repeat = nodeOf(kind);
+        repeat.children.push_back(std::move(atom));
+        return repeat;
+    }
+
+    Node parseAtom() {
+        Node atom = nodeOf(Kind::BYTES);
+        char c = text[pos++];
+        switch (c) {
+            case '(': {
+                if (text.substr(pos, 2) == "?:") {
+                    pos += 2;
+                } else if (pos < text.size() && text[pos] == '?') {
+                    ok = false; // lookaround
+                    return atom;
+                }
+                Node group = parseAlternation();
+                if (!ok || pos >= text.size() || text[pos] != ')') {
+                    ok = false;
+                    return atom;
+                }
+                ++pos;
+                return group;
+            }
+            case '[':
+                parseClass(atom.bytes);
+                return atom;
+            case '.':
+                atom.bytes.set();
+                atom.bytes.reset('\n');
+                atom.bytes.reset('\r');
+                return atom;
+            case '\\':
+                parseEscape(atom.bytes);
+                return atom;
+            case '^': case '$': case '*': case '+': case '?': case '{': case '}': case ']':
+                ok = false;
+                return atom;
+            default:
+                atom.bytes.set(static_cast<unsigned char>(c));
+                return atom;
+        }
+    }
+
+    // After a backslash, inside or outside a class
+    void parseEscape(std::bitset<256>& bytes) {
+        if (pos >= text.size()) {
+            ok = false;
+            return;
+        }
+        char c = text[pos++];
+        std::bitset<256> set;
+        switch (c) {
+            case 'd': case 'D':
+                for (int byte = '0'; byte <= '9'; ++byte) set.set(byte);
+                break;
+            case 'w': case 'W':
+                for (int byte = 0; byte < 128; ++byte) {
+                    if (std::isalnum(byte) || byte == '_') set.set(byte);
+                }
+                break;
+            case 's': case 'S':
+                for (char space : {' ', '\t', '\n', '\v', '\f', '\r'}) set.set(static_cast<unsigned char>(space));
+                break;
+            case 'n': set.set('\n'); break;
+            case 't': set.set('\t'); break;
+            case 'r': set.set('\r'); break;
+            case 'f': set.set('\f'); break;
+            case 'v': set.set('\v'); break;
+            case '0': set.set(0); break;
+            case 'x': {
+                int high = pos < text.size() ? hexValue(text[pos]) : -1;
+                int low = pos + 1 < text.size() ? hexValue(text[pos + 1]) : -1;
+                if (high < 0 || low < 0) {
+                    ok = false;
+                    return;
+                }
+                pos += 2;
+                set.set(high * 16 + low);
+                break;
+            }
+            default:
+                // \b, back-references, \u, \c, ...
+                if (std::isalnum(static_cast<unsigned char>(c))) {
+                    ok = false;
+                    return;
+                }
+                set.set(static_cast<unsigned char>(c));
+                break;
+        }
+        bytes |= (c == 'D' || c == 'W' || c == 'S') ? ~set : set;
+    }
+
+    // After '[', through the closing ']'
+    void parseClass(std::bitset<256>& bytes) {
+        bool negate = pos < text.size() && text[pos] == '^';
+        if (negate) ++pos;
+        std::bitset<256> set;
+        while (ok) {
+            if (pos >= text.size()) {
+                ok = false;
+                return;
+            }
+            char c = text[pos++];
+            if (c == ']') break;
+            std::bitset<256> item;
+            if (c == '\\') {
+                parseEscape(item);
+            } else if (c == '[' && pos < text.size() && (text[pos] == ':' || text[pos] == '=' || text[pos] == '.')) {
+                ok = false; // POSIX classes
+            } else {
+                item.set(static_cast<unsigned char>(c));
+            }
+            if (!ok) return;
+            if (pos + 1 < text.size() && text[pos] == '-' && text[pos + 1] != ']') {
+                ++pos;
+                std::bitset<256> upper;
+                char h = text[pos++];
+                if (h == '\\') {
+                    parseEscape(upper);
+                } else if (h == '[') {
+                    ok = false;
+                } else {
+                    upper.set(static_cast<unsigned char>(h));
+                }
+                if (!ok || item.count() != 1 || upper.count() != 1 || firstByte(upper) < firstByte(item)) {
+                    ok = false;
+                    return;
+                }
+                for (int byte = firstByte(item); byte <= firstByte(upper); ++byte) set.set(byte);
+            } else {
+                set |= item;
+            }
+        }
+        bytes = negate ? ~set : set;
+    }
+
+public:
+    explicit PatternParser(std::string_view pattern) : text(pattern) {}
+
+    // ^ is taken at the very start and $ at the very end only
+    bool parse(Node& root, bool& anchored_start, bool& anchored_end) {
+        anchored_start = !text.empty() && text.front() == '^';
+        if (anchored_start) text.remove_prefix(1);
+        anchored_end = false;
+        if (!text.empty() && text.back() == '$') {
+            size_t backslashes = 0;
+            for (size_t i = text.size() - 1; i > 0 && text[i - 1] == '\\'; --i) ++backslashes;
+            anchored_end = backslashes % 2 == 0;
+            if (anchored_end) text.remove_suffix(1);
+        }
+        root = parseAlternation();
+        if (!ok || pos != text.size()) return false;
+        // "^a|b" anchors its first branch only
+        return !((anchored_start || anchored_end) && root.kind == Kind::ALTERNATE);
+    }
+};
+
+// What a search has to find: a branch's leading and trailing parts that can
+// match nothing never decide whether it occurs, so ".*out of memory.*" is
+// found exactly where "out of memory" is
+void trimForSearch(Node& root, bool anchored_start, bool anchored_end) {
+    auto nullable = [](const Node& node) { return node.kind == Kind::STAR || node.kind == Kind::OPTIONAL; };
+    auto trim = [&](Node& branch) {
+        if (branch.kind != Kind::CONCAT) {
+            Node concatenation = nodeOf(Kind::CONCAT);
+            concatenation.children.push_back(std::move(branch));
+            branch = std::move(concatenation);
+        }
+        std::vector<Node>& parts = branch.children;
+        if (!anchored_end) {
+            while (!parts.empty() && nullable(parts.back())) parts.pop_back();
+        }
+        if (!anchored_start) {
+            size_t skip = 0;
+            while (skip < parts.size() && nullable(parts[skip])) ++skip;
+            parts.erase(parts.begin(), parts.begin() + static_cast<std::ptrdiff_t>(skip));
+        }
+    };
+    if (root.kind == Kind::ALTERNATE) {
+        for (Node& branch : root.children) trim(branch);
+    } else {
+        trim(root);
+    }
+}
+
+// Appends the string node matches, if it matches exactly one
+bool appendLiteral(const Node& node, std::string& out) {
+    if (node.kind == Kind::BYTES) {
+        if (node.bytes.count() != 1) return false;
+        out += static_cast<char>(firstByte(node.bytes));
+        return true;
+    }
+    if (node.kind != Kind::CONCAT) return false;
+    for (const Node& child : node.children) {
+        if (!appendLiteral(child, out)) return false;
+    }
+    return true;
+}
+}
+
+bool PatternMatcher::add(const std::string& pattern) {
+    const uint32_t id = static_cast<uint32_t>(pattern_count++);
+
+    Node root;
+    bool anchored_start = false;
+    bool anchored_end = false;
+    if (!PatternParser(pattern).parse(root, anchored_start, anchored_end)) {
+        try {
+            fallbacks.emplace_back(id, std::make_shared<const std::regex>(
+                pattern, std::regex::ECMAScript | std::regex::optimize));
+            return true;
+        } catch (const std::regex_error&) {
+            return false;
+        }
+    }
+    trimForSearch(root, anchored_start, anchored_end);
+
+    // Fixed strings go to the literal automaton
+    std::vector<std::string> words;
+    bool literal = !anchored_start && !anchored_end;
+    auto addWord = [&](const Node& branch) {
+        std::string word;
+        literal = literal && appendLiteral(branch, word);
+        words.push_back(std::move(word));
+    };
+    if (root.kind == Kind::ALTERNATE) {
+        for (const Node& branch : root.children) addWord(branch);
+    } else {
+        addWord(root);
+    }
+    if (literal) {
+        if (std::any_of(words.begin(), words.end(), [](const std::string& word) { return word.empty(); })) {
+            always.push_back(id);
+            return true;
+        }
+        for (const std::string& word : words) addLiteral(word, id);
+        buildLiteralLinks();
+        return true;
+    }
+
+    nfa.emplace_back();
+    nfa.back().accept = static_cast<int32_t>(id);
+    nfa.back().at_end = anchored_end;
+    int32_t start = compileNode(root, static_cast<int32_t>(nfa.size() - 1));
+    (anchored_start ? anchored_starts : search_starts).push_back(start);
+    dfa.clear();
+    dfa_index.clear();
+    return true;
+}
+
+void PatternMatcher::clear() {
+    pattern_count = 0;
+    always.clear();
+    literals.assign(1, LiteralNode());
+    nfa.clear();
+    search_starts.clear();
+    anchored_starts.clear();
+    dfa.clear();
+    dfa_index.clear();
+    closure_marks.clear();
+    fallbacks.clear();
+}
+
+int32_t PatternMatcher::compileNode(const Node& node, int32_t next) {
+    // Thompson construction, back to front: returns the state that matches node, then goes on to next
+    auto newState = [this]() {
+        nfa.emplace_back();
+        return static_cast<int32_t>(nfa.size() - 1);
+    };
+    switch (node.kind) {
+        case Kind::BYTES: {
+            int32_t state = newState();
+            nfa[state].bytes = node.bytes;
+            nfa[state].next = next;
+            return state;
+        }
+        case Kind::CONCAT:
+            for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) next = compileNode(*it, next);
+            return next;
+        case Kind::ALTERNATE: {
+            std::vector<int32_t> branches;
+            for (const Node& child : node.children) branches.push_back(compileNode(child, next));
+            int32_t state = newState();
+            nfa[state].epsilon = std::move(branches);
+            return state;
+        }
+        case Kind::STAR: {
+            int32_t loop = newState();
+            int32_t body = compileNode(node.children[0], loop);
+            nfa[loop].epsilon = {body, next};
+            return loop;
+        }
+        case Kind::PLUS: {
+            int32_t loop = newState();
+            int32_t body = compileNode(node.children[0], loop);
+            nfa[loop].epsilon = {body, next};
+            return body;
+        }
+        case Kind::OPTIONAL: {
+            int32_t body = compileNode(node.children[0], next);
+            int32_t state = newState();
+            nfa[state].epsilon = {body, next};
+            return state;
+        }
+    }
+    return next;
+}
+
+int32_t PatternMatcher::childOf(int32_t node, unsigned char byte) const {
+    for (const auto& child : literals[node].children) {
+        if (child.first == byte) return child.second;
+    }
+    return -1;
+}
+
+void PatternMatcher::addLiteral(std::string_view literal, uint32_t id) {
+    int32_t node = 0;
+    for (char c : literal) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        int32_t child = childOf(node, byte);
+        if (child < 0) {
+            child = static_cast<int32_t>(literals.size());
+            literals.emplace_back();
+            literals[node].children.emplace_back(byte, child);
+        }
+        node = child;
+    }
+    literals[node].ends.push_back(id);
+}
+
+void PatternMatcher::buildLiteralLinks() {
+    // Breadth first, so a node's fail target is done before it is
+    std::deque<int32_t> queue;
+    literals[0].outputs = literals[0].ends;
+    for (const auto& child : literals[0].children) {
+        literals[child.second].fail = 0;
+        queue.push_back(child.second);
+    }
+    while (!queue.empty()) {
+        int32_t node = queue.front();
+        queue.pop_front();
+        LiteralNode& current = literals[node];
+        current.outputs = current.ends;
+        const std::vector<uint32_t>& inherited = literals[current.fail].outputs;
+        current.outputs.insert(current.outputs.end(), inherited.begin(), inherited.end());
+        for (const auto& child : current.children) {
+            int32_t fail = current.fail;
+            int32_t target;
+            while ((target = childOf(fail, child.first)) < 0 && fail != 0) fail = literals[fail].fail;
+            literals[child.second].fail = std::max(target, 0);
+            queue.push_back(child.second);
+        }
+    }
+}
+
+void PatternMatcher::closeOver(std::vector<int32_t>& states) const {
+    if (closure_marks.size() < nfa.size()) closure_marks.resize(nfa.size(), 0);
+    if (++closure_generation == 0) {
+        std::fill(closure_marks.begin(), closure_marks.end(), 0);
+        closure_generation = 1;
+    }
+    // Only states that consume a byte or accept tell DFA states apart
+    std::vector<int32_t> pending;
+    pending.swap(states);
+    while (!pending.empty()) {
+        int32_t state = pending.back();
+        pending.pop_back();
+        if (closure_marks[state] == closure_generation) continue;
+        closure_marks[state] = closure_generation;
+        const NfaState& current = nfa[state];
+        if (current.next >= 0 || current.accept >= 0) states.push_back(state);
+        pending.insert(pending.end(), current.epsilon.begin(), current.epsilon.end());
+    }
+    std::sort(states.begin(), states.end());
+}
+
+int32_t PatternMatcher::dfaState(std::vector<int32_t> states) const {
+    auto it = dfa_index.find(states);
+    if (it != dfa_index.end()) return it->second;
+    DfaState state;
+    state.next.fill(-1);
+    for (int32_t nfa_state : states) {
+        const NfaState& current = nfa[nfa_state];
+        if (current.accept < 0) continue;
+        (current.at_end ? state.end_accepts : state.accepts).push_back(static_cast<uint32_t>(current.accept));
+    }
+    state.nfa_states = states;
+    int32_t id = static_cast<int32_t>(dfa.size());
+    dfa.push_back(std::move(state));
+    dfa_index.emplace(std::move(states), id);
+    return id;
+}
+
+int32_t PatternMatcher::step(int32_t state, unsigned char byte) const {
+    int32_t cached = dfa[state].next[byte];
+    if (cached >= 0) return cached;
+
+    // Unanchored patterns may start at any byte
+    std::vector<int32_t> reached(search_starts);
+    for (int32_t nfa_state : dfa[state].nfa_states) {
+        const NfaState& current = nfa[nfa_state];
+        if (current.next >= 0 && current.bytes[byte]) reached.push_back(current.next);
+    }
+    closeOver(reached);
+
+    int32_t next;
+    auto it = dfa_index.find(reached);
+    if (it != dfa_index.end()) {
+        next = it->second;
+    } else if (dfa.size() >= MAX_DFA_STATES) {
+        // Start the cache over from here; state is gone with it
+        dfa.clear();
+        dfa_index.clear();
+        return dfaState(std::move(reached));
+    } else {
+        next = dfaState(std::move(reached));
+    }
+    dfa[state].next[byte] = next;
+    return next;
+}
+
+std::vector<size_t> PatternMatcher::match(std::string_view text) const {
+    std::vector<char> found(pattern_count, 0);
+    for (uint32_t id : always) found[id] = 1;
+
+    if (literals.size() > 1) {
+        int32_t node = 0;
+        for (char c : text) {
+            unsigned char byte = static_cast<unsigned char>(c);
+            int32_t child;
+            while ((child = childOf(node, byte)) < 0 && node != 0) node = literals[node].fail;
+            node = std::max(child, 0);
+            for (uint32_t id : literals[node].outputs) found[id] = 1;
+        }
+    }
+
+    if (!nfa.empty()) {
+        std::vector<int32_t> starts(search_starts);
+        starts.insert(starts.end(), anchored_starts.begin(), anchored_starts.end());
+        closeOver(starts);
+        int32_t state = dfaState(std::move(starts));
+        for (char c : text) {
+            for (uint32_t id : dfa[state].accepts) found[id] = 1;
+            state = step(state, static_cast<unsigned char>(c));
+        }
+        for (uint32_t id : dfa[state].accepts) found[id] = 1;
+        for (uint32_t id : dfa[state].end_accepts) found[id] = 1;
+    }
+
+    for (const auto& fallback : fallbacks) {
+        if (!found[fallback.first] && std::regex_search(text.begin(), text.end(), *fallback.second)) {
+            found[fallback.first] = 1;
+        }
+    }
+
+    std::vector<size_t> ids;
+    for (size_t id = 0; id < found.size(); ++id) {
+        if (found[id]) ids.push_back(id);
+    }
+    return ids;
+}
@@ -0,0 +1,94 @@
+#ifndef PATTERNMATCHER_H
+#define PATTERNMATCHER_H
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Many regexes matched against a message in one pass, each compiled once when
+// added rather than on every message:
+// - literals, and alternations of literals ("out of memory|bad alloc"), go
+//   into one Aho-Corasick automaton;
+// - the rest of the supported subset is compiled into one combined NFA, which
+//   is determinized lazily: a DFA state per set of NFA states actually
+//   reached, so a message costs a table lookup per byte however many
+//   patterns there are;
+// - anything outside the subset (counted repeats, back-references,
+//   lookaround, \b, anchors other than a leading ^ or trailing $) is kept as
+//   a std::regex compiled once.
+// The subset is ECMAScript's literals, escapes, '.', [classes], groups, |, *,
+// + and ?. Patterns match as std::regex_search does: anywhere in the text.
+//
+// match() fills the DFA cache, so calls must not overlap; ErrorHandler makes
+// them under its pattern lock.
+class PatternMatcher {
+public:
+    static constexpr size_t MAX_DFA_STATES = 4096; // the cache starts over past this
+
+    PatternMatcher() = default;
+
+    // Compile pattern as id patternCount(); false if it is not a valid regex,
+    // in which case the id never matches
+    bool add(const std::string& pattern);
+    void clear();
+    size_t patternCount() const { return pattern_count; }
+
+    // Ids of the patterns found in text, ascending
+    std::vector<size_t> match(std::string_view text) const;
+
+    struct Node; // parsed pattern, see PatternMatcher.cpp
+
+private:
+    struct NfaState {
+        std::bitset<256> bytes;        // consumed on the way to next
+        int32_t next = -1;
+        std::vector<int32_t> epsilon;
+        int32_t accept = -1;           // id of the pattern this state completes
+        bool at_end = false;           // ... if the text ends here ($)
+    };
+    struct DfaState {
+        std::vector<int32_t> nfa_states; // sorted and closed under epsilon
+        std::vector<uint32_t> accepts;     // patterns found once this state is reached
+        std::vector<uint32_t> end_accepts; // patterns found if the text ends in it
+        std::array<int32_t, 256> next;     // -1 until first taken
+    };
+    struct LiteralNode {
+        std::vector<std::pair<unsigned char, int32_t>> children;
+        int32_t fail = 0;
+        std::vector<uint32_t> ends;    // patterns with a literal ending here
+        std::vector<uint32_t> outputs; // ends of this node and every fail-chain node
+    };
+
+    size_t pattern_count = 0;
+    std::vector<uint32_t> always; // patterns that match empty text, hence everything
+
+    std::vector<LiteralNode> literals{1};
+
+    std::vector<NfaState> nfa;
+    std::vector<int32_t> search_starts; // re-entered at every byte (unanchored)
+    std::vector<int32_t> anchored_starts; // entered at the first byte only (^)
+    mutable std::vector<DfaState> dfa;
+    mutable std::map<std::vector<int32_t>, int32_t> dfa_index;
+    mutable std::vector<uint32_t> closure_marks;
+    mutable uint32_t closure_generation = 0;
+
+    std::vector<std::pair<uint32_t, std::shared_ptr<const std::regex>>> fallbacks;
+
+    int32_t compileNode(const Node& node, int32_t next);
+    void addLiteral(std::string_view literal, uint32_t id);
+    void buildLiteralLinks();
+    int32_t childOf(int32_t node, unsigned char byte) const;
+
+    void closeOver(std::vector<int32_t>& states) const;
+    int32_t dfaState(std::vector<int32_t> states) const;
+    int32_t step(int32_t state, unsigned char byte) const;
+};
+
+#endif // PATTERNMATCHER_H
@@ -2,9 +2,10 @@
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
-#include <numeric>
 #include <cmath>
-#include <sstream>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -13,63 +14,163 @@
 #include <mach/mach.h>
 #elif __linux__
 #include <unistd.h>
-#include <fstream>
 #endif
 
 // Global benchmark instance
 PerformanceBenchmark g_benchmark;
 
-void PerformanceBenchmark::addResult(const std::string& operation_name, 
-                                    std::chrono::microseconds duration,
-                                    size_t input_size,
-                                    size_t output_size) {
-    results.emplace_back(operation_name, duration, input_size, output_size);
-    operation_times[operation_name].push_back(duration);
+namespace {
+// Interned operation names, shared by every benchmark. Entries are only
+// appended, and each id's exported histogram is set before the id is handed out.
+struct OperationTable {
+    std::mutex mutex;
+    std::vector<std::string> names;
+    std::unordered_map<std::string, PerformanceBenchmark::OperationId> ids;
+    std::array<Histogram*, PerformanceBenchmark::MAX_OPERATIONS> exported{};
+};
+
+OperationTable& operationTable() {
+    static OperationTable table;
+    return table;
+}
 }
 
-PerformanceBenchmark::Stats PerformanceBenchmark::getStats(const std::string& operation_name) const {
-    auto it = operation_times.find(operation_name);
-    if (it == operation_times.end() || it->second.empty()) {
-        return {0.0, 0.0, 0.0, 0.0, 0};
+PerformanceBenchmark::~PerformanceBenchmark() {
+    for (auto& slot : operations) {
+        delete slot.load(std::memory_order_relaxed);
     }
+}
+
+PerformanceBenchmark::OperationId PerformanceBenchmark::operationId(const std::string& name) {
+    OperationTable& table = operationTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    auto it = table.ids.find(name);
+    if (it != table.ids.end()) return it->second;
     
-    const auto& times = it->second;
+    // The last id is kept for everything past the limit
+    if (table.names.size() == MAX_OPERATIONS - 1) {
+        table.names.push_back("other");
+        table.exported[MAX_OPERATIONS - 1] = &MetricsRegistry::shared().histogram(
+            "versefinder_operation_duration_seconds", "Time taken by timed operations such as each search method",
+            MetricsRegistry::label("operation", "other"));
+    }
+    if (table.names.size() == MAX_OPERATIONS) {
+        return table.ids.emplace(name, MAX_OPERATIONS - 1).first->second;
+    }
     
-    // Calculate min, max, and average
-    auto min_it = std::min_element(times.begin(), times.end());
-    auto max_it = std::max_element(times.begin(), times.end());
+    auto id = static_cast<OperationId>(table.names.size());
+    table.names.push_back(name);
+    table.exported[id] = &MetricsRegistry::shared().histogram(
+        "versefinder_operation_duration_seconds", "Time taken by timed operations such as each search method",
+        MetricsRegistry::label("operation", name));
+    table.ids.emplace(name, id);
+    return id;
+}
+
+std::string PerformanceBenchmark::operationName(OperationId id) {
+    OperationTable& table = operationTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    return id < table.names.size() ? table.names[id] : std::string();
+}
+
+PerformanceBenchmark::Operation& PerformanceBenchmark::operation(OperationId id) {
+    auto& slot = operations[id];
+    Operation* existing = slot.load(std::memory_order_acquire);
+    if (existing) return *existing;
     
-    double sum_ms = 0.0;
-    for (const auto& time : times) {
-        sum_ms += time.count() / 1000.0; // Convert microseconds to milliseconds
+    auto created = std::make_unique<Operation>();
+    if (slot.compare_exchange_strong(existing, created.get(), std::memory_order_acq_rel)) {
+        return *created.release();
     }
+    return *existing; // another thread got there first
+}
+
+const PerformanceBenchmark::Operation* PerformanceBenchmark::findOperation(OperationId id) const {
+    return id < MAX_OPERATIONS ? operations[id].load(std::memory_order_acquire) : nullptr;
+}
+
+bool PerformanceBenchmark::shouldSample() const {
+    uint32_t interval = sample_interval.load(std::memory_order_relaxed);
+    if (interval <= 1) return true;
+    thread_local uint32_t calls = 0;
+    return ++calls % interval == 0;
+}
+
+void PerformanceBenchmark::addResult(OperationId id,
+                                    std::chrono::microseconds duration,
+                                    size_t input_size,
+                                    size_t output_size) {
+    if (id >= MAX_OPERATIONS) return;
     
-    double avg_ms = sum_ms / times.size();
-    double min_ms = min_it->count() / 1000.0;
-    double max_ms = max_it->count() / 1000.0;
+    auto micros = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+    Operation& op = operation(id);
+    op.latency.observe(micros);
+    op.sum_squares_us.fetch_add(static_cast<double>(micros) * static_cast<double>(micros), std::memory_order_relaxed);
+    op.input_total.fetch_add(input_size, std::memory_order_relaxed);
+    op.output_total.fetch_add(output_size, std::memory_order_relaxed);
     
-    // Calculate standard deviation
-    double std_dev_ms = calculateStandardDeviation(times, avg_ms * 1000.0) / 1000.0;
+    uint64_t seen = op.min_us.load(std::memory_order_relaxed);
+    while (micros < seen && !op.min_us.compare_exchange_weak(seen, micros, std::memory_order_relaxed)) {}
+    seen = op.max_us.load(std::memory_order_relaxed);
+    while (micros > seen && !op.max_us.compare_exchange_weak(seen, micros, std::memory_order_relaxed)) {}
     
-    return {avg_ms, min_ms, max_ms, std_dev_ms, times.size()};
+    if (Histogram* exported = operationTable().exported[id]) {
+        exported->observe(micros);
+    }
 }
 
-std::vector<PerformanceBenchmark::BenchmarkResult> 
-PerformanceBenchmark::getResults(const std::string& operation_name) const {
-    std::vector<BenchmarkResult> filtered_results;
-    
-    for (const auto& result : results) {
-        if (result.operation_name == operation_name) {
-            filtered_results.push_back(result);
+PerformanceBenchmark::Stats PerformanceBenchmark::getStats(const std::string& operation_name) const {
+    OperationTable& table = operationTable();
+    OperationId id;
+    {
+        std::lock_guard<std::mutex> lock(table.mutex);
+        auto it = table.ids.find(operation_name);
+        if (it == table.ids.end()) {
+            return {0.0, 0.0, 0.0, 0.0, 0, 0.0, 0.0, 0.0};
         }
+        id = it->second;
+    }
+    return getStats(id);
+}
+
+PerformanceBenchmark::Stats PerformanceBenchmark::getStats(OperationId id) const {
+    const Operation* op = findOperation(id);
+    uint64_t count = op ? op->latency.count() : 0;
+    if (count == 0) {
+        return {0.0, 0.0, 0.0, 0.0, 0, 0.0, 0.0, 0.0};
+    }
+    
+    double n = static_cast<double>(count);
+    double mean_us = static_cast<double>(op->latency.sumMicros()) / n;
+    double variance = 0.0;
+    if (count > 1) {
+        variance = (op->sum_squares_us.load(std::memory_order_relaxed) - n * mean_us * mean_us) / (n - 1.0);
     }
     
-    return filtered_results;
+    Stats stats;
+    stats.avg_ms = mean_us / 1000.0;
+    stats.min_ms = static_cast<double>(op->min_us.load(std::memory_order_relaxed)) / 1000.0;
+    stats.max_ms = static_cast<double>(op->max_us.load(std::memory_order_relaxed)) / 1000.0;
+    stats.std_dev_ms = std::sqrt(std::max(variance, 0.0)) / 1000.0;
+    stats.count = static_cast<size_t>(count);
+    stats.p50_ms = op->latency.quantileMicros(0.50) / 1000.0;
+    stats.p95_ms = op->latency.quantileMicros(0.95) / 1000.0;
+    stats.p99_ms = op->latency.quantileMicros(0.99) / 1000.0;
+    return stats;
 }
 
 void PerformanceBenchmark::clear() {
-    results.clear();
-    operation_times.clear();
+    // Recorders may still hold an Operation, so they are reset rather than freed
+    for (auto& slot : operations) {
+        if (Operation* op = slot.load(std::memory_order_acquire)) {
+            op->latency.reset();
+            op->min_us.store(UINT64_MAX, std::memory_order_relaxed);
+            op->max_us.store(0, std::memory_order_relaxed);
+            op->sum_squares_us.store(0.0, std::memory_order_relaxed);
+            op->input_total.store(0, std::memory_order_relaxed);
+            op->output_total.store(0, std::memory_order_relaxed);
+        }
+    }
 }
 
 bool PerformanceBenchmark::exportToCSV(const std::string& filename) const {
@@ -79,30 +180,34 @@ bool PerformanceBenchmark::exportToCSV(const std::string& filename) const {
     }
     
     // Write header
-    file << "Operation,Duration_ms,Input_Size,Output_Size,Timestamp\n";
-    
-    // Write results
-    for (const auto& result : results) {
-        // Use duration cast to convert timestamps properly
-        auto now_steady = std::chrono::steady_clock::now();
-        auto now_system = std::chrono::system_clock::now();
-        auto offset = std::chrono::duration_cast<std::chrono::system_clock::duration>(
-            result.timestamp - now_steady);
-        auto system_time = now_system + offset;
-        auto time_t = std::chrono::system_clock::to_time_t(system_time);
-        
-        file << result.operation_name << ","
-             << (result.duration.count() / 1000.0) << ","
-             << result.input_size << ","
-             << result.output_size << ","
-             << time_t << "\n";
+    file << "Operation,Count,Avg_ms,Min_ms,Max_ms,StdDev_ms,P50_ms,P95_ms,P99_ms,Avg_Input_Size,Avg_Output_Size\n";
+    
+    // Write one row per operation
+    for (const auto& name : getOperationNames()) {
+        OperationId id = operationId(name);
+        Stats stats = getStats(id);
+        if (stats.count == 0) continue;
+        const Operation* op = findOperation(id);
+        double n = static_cast<double>(stats.count);
+        file << name << ","
+             << stats.count << ","
+             << stats.avg_ms << ","
+             << stats.min_ms << ","
+             << stats.max_ms << ","
+             << stats.std_dev_ms << ","
+             << stats.p50_ms << ","
+             << stats.p95_ms << ","
+             << stats.p99_ms << ","
+             << static_cast<double>(op->input_total.load(std::memory_order_relaxed)) / n << ","
+             << static_cast<double>(op->output_total.load(std::memory_order_relaxed)) / n << "\n";
     }
     
     return true;
 }
 
 void PerformanceBenchmark::printSummary() const {
-    if (operation_times.empty()) {
+    auto names = getOperationNames();
+    if (names.empty()) {
         std::cout << "No benchmark results available.\n";
         return;
     }
@@ -111,25 +216,28 @@ void PerformanceBenchmark::printSummary() const {
     std::cout << std::setw(20) << "Operation" 
               << std::setw(10) << "Count"
               << std::setw(12) << "Avg (ms)"
-              << std::setw(12) << "Min (ms)"
-              << std::setw(12) << "Max (ms)"
-              << std::setw(12) << "StdDev (ms)" << "\n";
-    std::cout << std::string(78, '-') << "\n";
+              << std::setw(12) << "P50 (ms)"
+              << std::setw(12) << "P95 (ms)"
+              << std::setw(12) << "P99 (ms)"
+              << std::setw(12) << "Max (ms)" << "\n";
+    std::cout << std::string(90, '-') << "\n";
     
-    for (const auto& op_pair : operation_times) {
-        const std::string& op_name = op_pair.first;
+    size_t total = 0;
+    for (const auto& op_name : names) {
         Stats stats = getStats(op_name);
+        total += stats.count;
         
         std::cout << std::setw(20) << op_name
                   << std::setw(10) << stats.count
                   << std::setw(12) << std::fixed << std::setprecision(3) << stats.avg_ms
-                  << std::setw(12) << std::fixed << std::setprecision(3) << stats.min_ms
-                  << std::setw(12) << std::fixed << std::setprecision(3) << stats.max_ms
-                  << std::setw(12) << std::fixed << std::setprecision(3) << stats.std_dev_ms << "\n";
+                  << std::setw(12) << std::fixed << std::setprecision(3) << stats.p50_ms
+                  << std::setw(12) << std::fixed << std::setprecision(3) << stats.p95_ms
+                  << std::setw(12) << std::fixed << std::setprecision(3) << stats.p99_ms
+                  << std::setw(12) << std::fixed << std::setprecision(3) << stats.max_ms << "\n";
     }
     
-    std::cout << std::string(78, '-') << "\n";
-    std::cout << "Total operations measured: " << results.size() << "\n";
+    std::cout << std::string(90, '-') << "\n";
+    std::cout << "Total operations measured: " << total << "\n";
     
     // Memory usage if available
     size_t memory_kb = getCurrentMemoryUsage();
@@ -142,10 +250,14 @@ void PerformanceBenchmark::printSummary() const {
 
 std::vector<std::string> PerformanceBenchmark::getOperationNames() const {
     std::vector<std::string> names;
-    names.reserve(operation_times.size());
     
-    for (const auto& pair : operation_times) {
-        names.push_back(pair.first);
+    OperationTable& table = operationTable();
+    std::lock_guard<std::mutex> lock(table.mutex);
+    for (size_t id = 0; id < table.names.size(); ++id) {
+        const Operation* op = findOperation(static_cast<OperationId>(id));
+        if (op && op->latency.count() > 0) {
+            names.push_back(table.names[id]);
+        }
     }
     
     std::sort(names.begin(), names.end());
@@ -176,19 +288,3 @@ size_t PerformanceBenchmark::getCurrentMemoryUsage() {
 #endif
     return 0; // Unable to determine memory usage
 }
-
-double PerformanceBenchmark::calculateStandardDeviation(
-    const std::vector<std::chrono::microseconds>& times, double mean_microseconds) const {
-    
-    if (times.size() <= 1) {
-        return 0.0;
-    }
-    
-    double sum_squared_diff = 0.0;
-    for (const auto& time : times) {
-        double diff = time.count() - mean_microseconds;
-        sum_squared_diff += diff * diff;
-    }
-    
-    return std::sqrt(sum_squared_diff / (times.size() - 1));
-}
\ No newline at end of file
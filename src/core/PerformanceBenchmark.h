@@ -1,28 +1,27 @@
 #ifndef PERFORMANCEBENCHMARK_H
 #define PERFORMANCEBENCHMARK_H
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
 #include <string>
-#include <vector>
 #include <unordered_map>
-#include <fstream>
+#include <vector>
+#include "MetricsRegistry.h"
+#include "Tracer.h"
 
+// Timing statistics per named operation, in fixed memory. Each operation
+// keeps a log-linear latency histogram plus running totals rather than every
+// sample, so recording is O(1) and a long-running process never grows.
+// Operation names are interned once to small ids (BENCHMARK_SCOPE does it on
+// first use at each call site), and recording is lock-free.
 class PerformanceBenchmark {
 public:
-    struct BenchmarkResult {
-        std::string operation_name;
-        std::chrono::microseconds duration;
-        size_t input_size;
-        size_t output_size;
-        std::chrono::steady_clock::time_point timestamp;
-        
-        BenchmarkResult(const std::string& name, 
-                       std::chrono::microseconds dur,
-                       size_t in_size = 0, 
-                       size_t out_size = 0)
-            : operation_name(name), duration(dur), input_size(in_size), 
-              output_size(out_size), timestamp(std::chrono::steady_clock::now()) {}
-    };
+    using OperationId = uint32_t;
+    static constexpr size_t MAX_OPERATIONS = 256;
 
     struct Stats {
         double avg_ms;
@@ -30,74 +29,115 @@ public:
         double max_ms;
         double std_dev_ms;
         size_t count;
+        double p50_ms;
+        double p95_ms;
+        double p99_ms;
     };
 
 private:
-    std::vector<BenchmarkResult> results;
-    std::unordered_map<std::string, std::vector<std::chrono::microseconds>> operation_times;
-    
+    struct Operation {
+        Histogram latency;
+        std::atomic<uint64_t> min_us{UINT64_MAX};
+        std::atomic<uint64_t> max_us{0};
+        std::atomic<double> sum_squares_us{0.0};
+        std::atomic<uint64_t> input_total{0};
+        std::atomic<uint64_t> output_total{0};
+    };
+
+    // Allocated on first record; never freed before the benchmark is
+    std::array<std::atomic<Operation*>, MAX_OPERATIONS> operations{};
+    std::atomic<uint32_t> sample_interval{1};
+
+    Operation& operation(OperationId id);
+    const Operation* findOperation(OperationId id) const;
+
 public:
     PerformanceBenchmark() = default;
-    
+    ~PerformanceBenchmark();
+
+    PerformanceBenchmark(const PerformanceBenchmark&) = delete;
+    PerformanceBenchmark& operator=(const PerformanceBenchmark&) = delete;
+
+    // Shared by every benchmark; the same name always gets the same id.
+    // Past MAX_OPERATIONS distinct names, the rest share one "other" id.
+    static OperationId operationId(const std::string& name);
+    static std::string operationName(OperationId id);
+
     // Timer class for RAII timing
     class Timer {
     private:
         std::chrono::steady_clock::time_point start_time;
         PerformanceBenchmark* benchmark;
-        std::string operation_name;
+        OperationId operation;
         size_t input_size;
         size_t output_size;
-        
+
     public:
+        Timer(PerformanceBenchmark* bench, OperationId op, size_t in_size = 0)
+            : benchmark(bench && bench->shouldSample() ? bench : nullptr),
+              operation(op), input_size(in_size), output_size(0) {
+            if (benchmark) start_time = std::chrono::steady_clock::now();
+        }
         Timer(PerformanceBenchmark* bench, const std::string& name, size_t in_size = 0)
-            : start_time(std::chrono::steady_clock::now()), 
-              benchmark(bench), operation_name(name), input_size(in_size), output_size(0) {}
-        
+            : Timer(bench, operationId(name), in_size) {}
+
         ~Timer() {
-            auto end_time = std::chrono::steady_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
             if (benchmark) {
-                benchmark->addResult(operation_name, duration, input_size, output_size);
+                auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start_time);
+                benchmark->addResult(operation, duration, input_size, output_size);
             }
         }
-        
+
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
         void setOutputSize(size_t size) { output_size = size; }
     };
-    
+
     // Add a benchmark result
-    void addResult(const std::string& operation_name, 
+    void addResult(OperationId operation,
                    std::chrono::microseconds duration,
                    size_t input_size = 0,
                    size_t output_size = 0);
-    
+    void addResult(const std::string& operation_name,
+                   std::chrono::microseconds duration,
+                   size_t input_size = 0,
+                   size_t output_size = 0) {
+        addResult(operationId(operation_name), duration, input_size, output_size);
+    }
+
+    // Time only one call in every interval (1 = every call); counts then
+    // reflect the sampled calls only
+    void setSampleInterval(uint32_t interval) { sample_interval.store(interval ? interval : 1); }
+    bool shouldSample() const;
+
     // Get statistics for a specific operation
     Stats getStats(const std::string& operation_name) const;
-    
-    // Get all results for an operation
-    std::vector<BenchmarkResult> getResults(const std::string& operation_name) const;
-    
+    Stats getStats(OperationId operation) const;
+
     // Clear all results
     void clear();
-    
-    // Export results to CSV
+
+    // Export one summary row per operation to CSV
     bool exportToCSV(const std::string& filename) const;
-    
+
     // Print summary to console
     void printSummary() const;
-    
+
     // Get list of all operation names
     std::vector<std::string> getOperationNames() const;
-    
+
     // Measure memory usage (if available)
     static size_t getCurrentMemoryUsage();
-    
+
     // Benchmark a function
     template<typename Func>
     auto benchmark(const std::string& name, Func&& func) -> decltype(func()) {
         Timer timer(this, name);
         return func();
     }
-    
+
     // Benchmark with input/output size tracking
     template<typename Func>
     auto benchmarkWithSize(const std::string& name, size_t input_size, Func&& func) -> decltype(func()) {
@@ -109,16 +149,18 @@ public:
         }
         return result;
     }
-
-private:
-    double calculateStandardDeviation(const std::vector<std::chrono::microseconds>& times, double mean) const;
 };
 
 // Global benchmark instance for easy access
 extern PerformanceBenchmark g_benchmark;
 
-// Convenience macros for benchmarking
-#define BENCHMARK_SCOPE(name) PerformanceBenchmark::Timer _timer(&g_benchmark, name)
+// Convenience macros for benchmarking; the name is interned once per call site
+// and, when tracing is on, the scope is also recorded as a trace span (so name
+// must be a string literal)
+#define BENCHMARK_SCOPE(name) \
+    static const PerformanceBenchmark::OperationId _timer_operation = PerformanceBenchmark::operationId(name); \
+    PerformanceBenchmark::Timer _timer(&g_benchmark, _timer_operation); \
+    TraceSpan _trace_span(name)
 #define BENCHMARK_FUNCTION(name, func) g_benchmark.benchmark(name, func)
 
-#endif // PERFORMANCEBENCHMARK_H
\ No newline at end of file
+#endif // PERFORMANCEBENCHMARK_H
@@ -0,0 +1,246 @@
+#include "PhoneticIndex.h"
+#include <algorithm>
+
+namespace {
+
+bool isVowel(char c) {
+    return c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u' || c == 'y';
+}
+
+bool isSoftener(char c) {
+    return c == 'e' || c == 'i' || c == 'y';
+}
+
+struct KeyBuilder {
+    std::string primary;
+    std::string alternate;
+
+    void add(std::string_view code) { add(code, code); }
+    void add(std::string_view primary_code, std::string_view alternate_code) {
+        primary += primary_code;
+        alternate += alternate_code;
+    }
+    bool full() const {
+        return primary.size() >= PhoneticIndex::MAX_KEY_LENGTH && alternate.size() >= PhoneticIndex::MAX_KEY_LENGTH;
+    }
+};
+
+} // namespace
+
+PhoneticIndex::Keys PhoneticIndex::encode(std::string_view word) {
+    std::string w;
+    w.reserve(word.size());
+    for (char c : word) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+        if (c >= 'a' && c <= 'z') w.push_back(c);
+    }
+    if (w.empty()) return {};
+
+    const size_t n = w.size();
+    auto at = [&](size_t k) { return k < n ? w[k] : '\0'; };
+    KeyBuilder keys;
+    size_t i = 0;
+
+    // Silent first letters: "Gnash", "Knop", "Psalm", "Wrath"
+    std::string_view start = std::string_view(w).substr(0, 2);
+    if (start == "gn" || start == "kn" || start == "pn" || start == "ps" || start == "wr") {
+        i = 1;
+    } else if (w[0] == 'x') {
+        keys.add("S");
+        i = 1;
+    } else if (isVowel(w[0])) {
+        keys.add("A");
+        i = 1;
+    }
+
+    for (; i < n && !keys.full(); ++i) {
+        const char c = w[i];
+        // A doubled letter sounds once, except CC ("accept")
+        if (i > 0 && c == w[i - 1] && c != 'c') continue;
+        const char next = at(i + 1);
+
+        switch (c) {
+            case 'b':
+                // Silent after M at the end, as in "lamb"
+                if (!(i + 1 == n && i > 0 && w[i - 1] == 'm')) keys.add("P");
+                break;
+            case 'c':
+                if (next == 'h') {
+                    keys.add("X", "K"); // "church", or "Enoch" and "Melchizedek"
+                    ++i;
+                } else if (next == 'i' && at(i + 2) == 'a') {
+                    keys.add("X");
+                } else if (isSoftener(next)) {
+                    keys.add("S");
+                } else if (next == 'k' || next == 'q') {
+                    keys.add("K");
+                    ++i;
+                } else {
+                    keys.add("K");
+                }
+                break;
+            case 'd':
+                if (next == 'g' && isSoftener(at(i + 2))) {
+                    keys.add("J");
+                    i += 2;
+                } else {
+                    keys.add("T");
+                }
+                break;
+            case 'f':
+            case 'v':
+                keys.add("F");
+                break;
+            case 'g':
+                if (next == 'h') {
+                    // "ghost" sounds it, "night" does not
+                    if (i == 0 || isVowel(at(i + 2))) keys.add("K");
+                    ++i;
+                } else if (next == 'n' && i + 2 == n) {
+                    // "reign"
+                } else if (isSoftener(next)) {
+                    keys.add("J", "K");
+                } else {
+                    keys.add("K");
+                }
+                break;
+            case 'h':
+                // Only before a vowel, and not where it closes a consonant digraph
+                if (isVowel(next) && (i == 0 || isVowel(w[i - 1]))) keys.add("H");
+                break;
+            case 'j':
+                keys.add("J");
+                break;
+            case 'k':
+            case 'q':
+                keys.add("K");
+                break;
+            case 'l':
+                keys.add("L");
+                break;
+            case 'm':
+                keys.add("M");
+                break;
+            case 'n':
+                keys.add("N");
+                break;
+            case 'p':
+                if (next == 'h') {
+                    keys.add("F");
+                    ++i;
+                } else {
+                    keys.add("P");
+                }
+                break;
+            case 'r':
+                keys.add("R");
+                break;
+            case 's':
+                if (next == 'h') {
+                    keys.add("X");
+                    ++i;
+                } else if (next == 'c' && at(i + 2) == 'h') {
+                    keys.add("SK");
+                    i += 2;
+                } else if (next == 'i' && (at(i + 2) == 'o' || at(i + 2) == 'a')) {
+                    keys.add("X", "S");
+                } else {
+                    keys.add("S");
+                }
+                break;
+            case 't':
+                if (next == 'h') {
+                    keys.add("0", "T"); // "0" is TH
+                    ++i;
+                } else if (next == 'i' && (at(i + 2) == 'o' || at(i + 2) == 'a')) {
+                    keys.add("X");
+                } else if (next == 'c' && at(i + 2) == 'h') {
+                    // "watch": the CH is the sound
+                } else {
+                    keys.add("T");
+                }
+                break;
+            case 'w':
+                if (i == 0 && next == 'h') {
+                    keys.add("W");
+                    ++i;
+                } else if (isVowel(next)) {
+                    keys.add("W");
+                }
+                break;
+            case 'x':
+                keys.add("KS");
+                break;
+            case 'z':
+                keys.add("S");
+                break;
+            default:
+                break; // vowels past the first letter carry no key
+        }
+    }
+
+    Keys result{std::move(keys.primary), std::move(keys.alternate)};
+    if (result.primary.size() > MAX_KEY_LENGTH) result.primary.resize(MAX_KEY_LENGTH);
+    if (result.alternate.size() > MAX_KEY_LENGTH) result.alternate.resize(MAX_KEY_LENGTH);
+    if (result.alternate == result.primary) result.alternate.clear();
+    return result;
+}
+
+void PhoneticIndex::build(const std::vector<std::string_view>& vocabulary) {
+    clear();
+    words.reserve(vocabulary.size());
+    for (std::string_view word : vocabulary) {
+        add(word);
+    }
+}
+
+void PhoneticIndex::add(std::string_view word) {
+    Keys keys = encode(word);
+    if (keys.primary.empty()) return;
+
+    std::vector<uint32_t>& bucket = buckets[keys.primary];
+    for (uint32_t index : bucket) {
+        if (words[index] == word) return;
+    }
+    uint32_t index = static_cast<uint32_t>(words.size());
+    words.emplace_back(word);
+    bucket.push_back(index);
+    if (!keys.alternate.empty()) buckets[keys.alternate].push_back(index);
+}
+
+void PhoneticIndex::clear() {
+    words.clear();
+    buckets.clear();
+}
+
+std::vector<std::string_view> PhoneticIndex::find(std::string_view word) const {
+    std::vector<std::string_view> matches;
+    Keys keys = encode(word);
+    if (keys.primary.empty()) return matches;
+
+    std::vector<uint32_t> indices;
+    for (const std::string* key : {&keys.primary, &keys.alternate}) {
+        if (key->empty()) continue;
+        auto it = buckets.find(*key);
+        if (it != buckets.end()) indices.insert(indices.end(), it->second.begin(), it->second.end());
+    }
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+    matches.reserve(indices.size());
+    for (uint32_t index : indices) {
+        matches.push_back(words[index]);
+    }
+    return matches;
+}
+
+size_t PhoneticIndex::getMemoryUsage() const {
+    size_t bytes = words.capacity() * sizeof(std::string);
+    for (const auto& word : words) {
+        bytes += word.capacity() + 1;
+    }
+    for (const auto& bucket : buckets) {
+        bytes += sizeof(bucket) + bucket.second.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
@@ -0,0 +1,48 @@
+#ifndef PHONETICINDEX_H
+#define PHONETICINDEX_H
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Words grouped by how they sound, so "Nebucadnezar", "Melkizedek" or
+// "Habbakuk" find the spelling the text uses with one hash probe per key
+// rather than a pass over the vocabulary.
+//
+// Keys follow Double Metaphone in outline: consonant sounds only, vowels
+// kept as 'A' at the start, silent letters dropped, and a second key where
+// a spelling reads two ways (CH as in "church" or as in "Enoch", TH, soft
+// G), truncated to MAX_KEY_LENGTH. Two words sound alike when any of their
+// keys agree. Letters outside ASCII are ignored, so fold text first.
+class PhoneticIndex {
+public:
+    static constexpr size_t MAX_KEY_LENGTH = 6;
+
+    struct Keys {
+        std::string primary;
+        std::string alternate; // empty when it would equal primary
+    };
+
+    // Keys of word; empty primary for a word without letters
+    static Keys encode(std::string_view word);
+
+private:
+    std::vector<std::string> words;
+    std::unordered_map<std::string, std::vector<uint32_t>> buckets; // key -> indices into words
+
+public:
+    // Replace the contents
+    void build(const std::vector<std::string_view>& vocabulary);
+    void add(std::string_view word);
+    void clear();
+
+    // Words sharing a key with word (word itself included, if present), in the order added
+    std::vector<std::string_view> find(std::string_view word) const;
+
+    size_t size() const { return words.size(); }
+    bool empty() const { return words.empty(); }
+    size_t getMemoryUsage() const;
+};
+
+#endif // PHONETICINDEX_H
@@ -0,0 +1,64 @@
+#include "QueryArena.h"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <new>
+
+QueryArena::Scope::Scope() : arena(local()) {
+    ++arena.depth;
+}
+
+QueryArena::Scope::~Scope() {
+    // Nested searches share the outer query's arena
+    if (--arena.depth == 0) {
+        arena.reset();
+    }
+}
+
+QueryArena& QueryArena::local() {
+    thread_local QueryArena arena;
+    return arena;
+}
+
+size_t QueryArena::localCapacity() {
+    return local().capacity;
+}
+
+QueryArena::~QueryArena() {
+    reset();
+}
+
+void* QueryArena::do_allocate(size_t bytes, size_t alignment) {
+    if (!block) {
+        capacity = INITIAL_CAPACITY;
+        block.reset(new std::byte[capacity]);
+    }
+
+    auto base = reinterpret_cast<uintptr_t>(block.get());
+    size_t offset = ((base + used + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+    if (offset + bytes <= capacity) {
+        used = offset + bytes;
+        return block.get() + offset;
+    }
+
+    // Out of room: take this one from the heap and remember to grow
+    void* memory = ::operator new(bytes, std::align_val_t(alignment));
+    spills.emplace_back(memory, alignment);
+    spilled_bytes += bytes;
+    return memory;
+}
+
+void QueryArena::reset() {
+    for (const auto& [memory, alignment] : spills) {
+        ::operator delete(memory, std::align_val_t(alignment));
+    }
+    spills.clear();
+
+    // Size the block for the largest query seen, so the next one fits
+    if (spilled_bytes > 0 && capacity < MAX_CAPACITY) {
+        capacity = std::min(MAX_CAPACITY, std::bit_ceil(used + spilled_bytes));
+        block.reset(new std::byte[capacity]);
+    }
+    used = 0;
+    spilled_bytes = 0;
+}
@@ -0,0 +1,62 @@
+#ifndef QUERYARENA_H
+#define QUERYARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+// Per-thread bump allocator for the short-lived buffers one search builds.
+// Allocation is a pointer bump into a thread-local block and freeing is a
+// no-op; everything is reclaimed at once when the outermost Scope on the
+// thread ends. A query that outgrows the block spills to the global heap and
+// the block is regrown to fit before the next one, so steady-state searches
+// make no global allocations for their temporaries and threads searching at
+// the same time never contend in the allocator.
+//
+// Containers built on Scope::resource() must not outlive the Scope; results
+// handed back to callers are copied out into ordinary containers.
+class QueryArena final : public std::pmr::memory_resource {
+public:
+    static constexpr size_t INITIAL_CAPACITY = 16 * 1024;
+    static constexpr size_t MAX_CAPACITY = 1024 * 1024;
+
+    class Scope {
+    private:
+        QueryArena& arena;
+
+    public:
+        Scope();
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+        std::pmr::memory_resource* resource() const { return &arena; }
+    };
+
+    QueryArena() = default;
+    ~QueryArena() override;
+    QueryArena(const QueryArena&) = delete;
+    QueryArena& operator=(const QueryArena&) = delete;
+
+    // Current block size on the calling thread, for tests and tuning
+    static size_t localCapacity();
+
+private:
+    std::unique_ptr<std::byte[]> block;
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t spilled_bytes = 0;
+    std::vector<std::pair<void*, size_t>> spills; // pointer, alignment
+    int depth = 0;
+
+    static QueryArena& local();
+    void reset();
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+#endif // QUERYARENA_H
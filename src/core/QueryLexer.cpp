@@ -0,0 +1,228 @@
+#include "QueryLexer.h"
+#include <algorithm>
+#include <cctype>
+
+namespace {
+
+bool isSpace(char c) {
+    return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Matches regex \w
+bool isWordChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) != 0 || c == '_';
+}
+
+char lower(char c) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+// The word starting at pos and, if another follows after one space, that one too
+std::string oneOrTwoWords(std::string_view text, size_t pos) {
+    size_t end = pos;
+    while (end < text.size() && isWordChar(text[end])) ++end;
+    if (end + 1 < text.size() && text[end] == ' ' && isWordChar(text[end + 1])) {
+        end += 1;
+        while (end < text.size() && isWordChar(text[end])) ++end;
+    }
+    return std::string(text.substr(pos, end - pos));
+}
+
+} // namespace
+
+QueryLexer::Pattern::Pattern(std::string_view pattern) {
+    size_t start = 0;
+    while (start <= pattern.size()) {
+        size_t wildcard = pattern.find(".*", start);
+        size_t end = wildcard == std::string_view::npos ? pattern.size() : wildcard;
+        if (end > start) {
+            std::string fragment(pattern.substr(start, end - start));
+            std::transform(fragment.begin(), fragment.end(), fragment.begin(), lower);
+            fragments.push_back(std::move(fragment));
+        }
+        if (wildcard == std::string_view::npos) break;
+        start = wildcard + 2;
+    }
+}
+
+bool QueryLexer::Pattern::matches(std::string_view text) const {
+    // Taking each fragment at its earliest occurrence leaves the most room for the rest
+    size_t pos = 0;
+    for (const std::string& fragment : fragments) {
+        size_t found = text.find(fragment, pos);
+        if (found == std::string_view::npos) return false;
+        pos = found + fragment.size();
+    }
+    return true;
+}
+
+std::string QueryLexer::normalize(std::string_view query) {
+    std::string normalized;
+    normalized.reserve(query.size());
+    bool pending_space = false;
+    for (char c : query) {
+        if (isSpace(c)) {
+            pending_space = !normalized.empty();
+            continue;
+        }
+        if (pending_space) normalized += ' ';
+        pending_space = false;
+        normalized += lower(c);
+    }
+    return normalized;
+}
+
+std::vector<std::string_view> QueryLexer::words(std::string_view text) {
+    std::vector<std::string_view> result;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        while (pos < text.size() && isSpace(text[pos])) ++pos;
+        size_t start = pos;
+        while (pos < text.size() && !isSpace(text[pos])) ++pos;
+        if (pos > start) result.push_back(text.substr(start, pos - start));
+    }
+    return result;
+}
+
+QueryLexer::Operator QueryLexer::classifyOperator(std::string_view word) {
+    switch (word.size()) {
+        case 1:
+            if (word[0] == '&' || word[0] == '+') return Operator::AND;
+            if (word[0] == '|') return Operator::OR;
+            if (word[0] == '!' || word[0] == '-') return Operator::NOT;
+            break;
+        case 2:
+            if (word == "&&") return Operator::AND;
+            if (word == "||" || word == "or") return Operator::OR;
+            break;
+        case 3:
+            if (word == "and") return Operator::AND;
+            if (word == "not") return Operator::NOT;
+            break;
+    }
+    return Operator::NONE;
+}
+
+bool QueryLexer::containsOperator(std::string_view normalized) {
+    for (std::string_view word : words(normalized)) {
+        if (classifyOperator(word) != Operator::NONE) return true;
+    }
+    return false;
+}
+
+bool QueryLexer::containsReference(std::string_view normalized) {
+    // Anchor on each colon: digits on both sides, whitespace and then a word before
+    for (size_t colon = normalized.find(':'); colon != std::string_view::npos;
+         colon = normalized.find(':', colon + 1)) {
+        size_t chapter = colon;
+        while (chapter > 0 && isDigit(normalized[chapter - 1])) --chapter;
+        size_t verse_end = colon + 1;
+        while (verse_end < normalized.size() && isDigit(normalized[verse_end])) ++verse_end;
+        if (chapter == colon || verse_end == colon + 1) continue;
+        if (verse_end < normalized.size() && isWordChar(normalized[verse_end])) continue;
+
+        size_t book_end = chapter;
+        while (book_end > 0 && isSpace(normalized[book_end - 1])) --book_end;
+        if (book_end < chapter && book_end > 0 && isWordChar(normalized[book_end - 1])) return true;
+    }
+    return false;
+}
+
+QueryLexer::Scope QueryLexer::splitScope(std::string_view query, std::string_view& terms, std::string& name) {
+    auto equalsIgnoringCase = [](std::string_view text, std::string_view word) {
+        return text.size() == word.size() &&
+               std::equal(text.begin(), text.end(), word.begin(), [](char a, char b) { return lower(a) == b; });
+    };
+    auto trimmed = [](std::string_view text) {
+        while (!text.empty() && isSpace(text.front())) text.remove_prefix(1);
+        while (!text.empty() && isSpace(text.back())) text.remove_suffix(1);
+        return text;
+    };
+
+    // The last standalone "within" that a scope follows
+    for (size_t at = query.size(); at-- > 0;) {
+        if (at + 6 >= query.size() || !isSpace(query[at + 6]) || (at > 0 && !isSpace(query[at - 1]))) continue;
+        if (!equalsIgnoringCase(query.substr(at, 6), "within")) continue;
+
+        std::string_view rest = trimmed(query.substr(at + 6));
+        size_t kind_end = 0;
+        while (kind_end < rest.size() && !isSpace(rest[kind_end]) && rest[kind_end] != ':') ++kind_end;
+        std::string_view kind = rest.substr(0, kind_end);
+        std::string_view scope_name = rest.substr(kind_end);
+        while (!scope_name.empty() && (isSpace(scope_name.front()) || scope_name.front() == ':')) {
+            scope_name.remove_prefix(1);
+        }
+
+        Scope scope = Scope::NONE;
+        if (equalsIgnoringCase(kind, "favorites") || equalsIgnoringCase(kind, "favourites")) {
+            if (scope_name.empty()) scope = Scope::FAVORITES;
+        } else if (!scope_name.empty() && equalsIgnoringCase(kind, "collection")) {
+            scope = Scope::COLLECTION;
+        } else if (!scope_name.empty() && equalsIgnoringCase(kind, "topic")) {
+            scope = Scope::TOPIC;
+        }
+        if (scope == Scope::NONE) continue;
+        terms = trimmed(query.substr(0, at));
+        name = std::string(scope_name);
+        return scope;
+    }
+    return Scope::NONE;
+}
+
+std::string QueryLexer::questionSubject(std::string_view normalized) {
+    for (size_t about = normalized.find("about"); about != std::string_view::npos;
+         about = normalized.find("about", about + 1)) {
+        size_t pos = about + 5;
+        if (pos < normalized.size() && isSpace(normalized[pos])) {
+            while (pos < normalized.size() && isSpace(normalized[pos])) ++pos;
+            if (pos < normalized.size() && isWordChar(normalized[pos])) return oneOrTwoWords(normalized, pos);
+        }
+    }
+
+    // Earliest question word, then the first word after it
+    static constexpr std::string_view question_words[] = {"what", "how", "where", "when", "why"};
+    size_t earliest = std::string_view::npos;
+    size_t earliest_end = 0;
+    for (std::string_view question : question_words) {
+        size_t found = normalized.find(question);
+        if (found < earliest) {
+            earliest = found;
+            earliest_end = found + question.size();
+        }
+    }
+    if (earliest == std::string_view::npos) return "";
+    size_t pos = earliest_end;
+    while (pos < normalized.size() && !isWordChar(normalized[pos])) ++pos;
+    return pos < normalized.size() ? oneOrTwoWords(normalized, pos) : "";
+}
+
+bool QueryLexer::matchesWildcard(std::string_view text, std::string_view pattern) {
+    // Iterative glob with one backtrack point per '*'; a search, so try every start
+    auto matchesAt = [&](size_t start) {
+        size_t t = start, p = 0;
+        size_t star = std::string_view::npos, star_text = 0;
+        while (p < pattern.size()) {
+            if (pattern[p] == '*') {
+                star = p++;
+                star_text = t;
+            } else if (t < text.size() && (pattern[p] == '?' || lower(pattern[p]) == lower(text[t]))) {
+                ++p;
+                ++t;
+            } else if (star != std::string_view::npos && star_text < text.size()) {
+                p = star + 1;
+                t = ++star_text;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    };
+    for (size_t start = 0; start <= text.size(); ++start) {
+        if (matchesAt(start)) return true;
+    }
+    return false;
+}
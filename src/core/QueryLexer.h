@@ -0,0 +1,54 @@
+#ifndef QUERYLEXER_H
+#define QUERYLEXER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Hand-written scanner for the small grammar of search queries: references
+// ("john 3:16"), boolean operators and question phrasing. Everything is a
+// single left-to-right pass over the text with no allocation beyond the
+// result, so intent detection on every keystroke costs well under a
+// microsecond per check.
+class QueryLexer {
+public:
+    enum class Operator { NONE, AND, OR, NOT };
+    enum class Scope { NONE, FAVORITES, COLLECTION, TOPIC };
+
+    // Literal fragments that must occur in order, compiled from a pattern
+    // whose only metacharacter is ".*" (e.g. "what does.*say about")
+    class Pattern {
+    private:
+        std::vector<std::string> fragments;
+
+    public:
+        explicit Pattern(std::string_view pattern);
+        // True if the pattern occurs anywhere in text, which must be lowercase
+        bool matches(std::string_view text) const;
+    };
+
+    // Lowercase, collapse whitespace runs to one space and trim
+    static std::string normalize(std::string_view query);
+    // Whitespace-separated words, viewing into text
+    static std::vector<std::string_view> words(std::string_view text);
+
+    // "and" / "&&" / "&" / "+", "or" / "||" / "|", "not" / "!" / "-"; lowercase input
+    static Operator classifyOperator(std::string_view word);
+    // True if some standalone word of the normalized query is a boolean operator
+    static bool containsOperator(std::string_view normalized);
+    // True for "<word> <chapter>:<verse>" anywhere in the normalized query
+    static bool containsReference(std::string_view normalized);
+
+    // A trailing "within favorites", "within collection: <name>" or "within topic: <name>"
+    // (the colon optional, any case). Sets terms to the query before it and name to the
+    // name as typed; with no such clause returns NONE and leaves both alone.
+    static Scope splitScope(std::string_view query, std::string_view& terms, std::string& name);
+
+    // One or two words after "about", else after the first question word; empty if neither
+    static std::string questionSubject(std::string_view normalized);
+
+    // Case-insensitive search for a pattern where '*' matches any run and '?' any one character
+    static bool matchesWildcard(std::string_view text, std::string_view pattern);
+};
+
+#endif // QUERYLEXER_H
@@ -0,0 +1,49 @@
+#include "QueryProfile.h"
+
+namespace {
+
+double millisecondsBetween(QueryProfile::Clock::time_point from, QueryProfile::Clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+} // namespace
+
+void QueryProfile::step(const char* plan_step) {
+    if (active) active->plan_steps.push_back(plan_step);
+}
+
+void QueryProfile::count(const char* name, size_t value) {
+    if (active) active->counters.emplace_back(name, value);
+}
+
+void QueryProfile::cacheLookup(bool hit) {
+    if (!active) return;
+    if (hit) {
+        ++active->cache_hits;
+    } else {
+        ++active->cache_misses;
+    }
+}
+
+size_t QueryProfile::beginStage(const char* name) {
+    uint32_t stage_depth = depth++;
+    if (stages.size() >= MAX_STAGES) {
+        ++dropped_stages;
+        return SIZE_MAX;
+    }
+    Clock::time_point now = Clock::now();
+    stages.push_back({name, stage_depth, millisecondsBetween(start, now), 0.0});
+    stage_starts.push_back(now);
+    return stages.size() - 1;
+}
+
+void QueryProfile::endStage(size_t stage) {
+    --depth;
+    if (stage < stages.size()) {
+        stages[stage].duration_ms = millisecondsBetween(stage_starts[stage], Clock::now());
+    }
+}
+
+double QueryProfile::elapsedMs() const {
+    return millisecondsBetween(start, Clock::now());
+}
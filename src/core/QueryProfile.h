@@ -0,0 +1,76 @@
+#ifndef QUERYPROFILE_H
+#define QUERYPROFILE_H
+
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Explain mode for one search: what it did and where its time went. While a
+// Scope is open on a thread, every TraceSpan there (and so every
+// BENCHMARK_SCOPE) becomes a stage with its nesting and timing, whether or
+// not the tracer is on, and the search records the plan it chose ("index",
+// "fuzzy", "regex_scan"), candidate counts and cache lookups. Work handed to
+// other threads is timed within the stage that waits for it.
+//
+// Everything is a no-op without an open Scope, which costs a thread-local
+// load; names must be string literals, as only the pointer is kept.
+class QueryProfile {
+public:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t MAX_STAGES = 256; // later stages are counted, not kept
+
+    struct Stage {
+        const char* name;
+        uint32_t depth;
+        double start_ms;    // since the profile began
+        double duration_ms;
+    };
+
+    // Makes profile the calling thread's for its lifetime
+    class Scope {
+        QueryProfile* previous;
+
+    public:
+        explicit Scope(QueryProfile& profile) : previous(active) { active = &profile; }
+        ~Scope() { active = previous; }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+private:
+    static inline thread_local QueryProfile* active = nullptr;
+
+    Clock::time_point start = Clock::now();
+    std::vector<const char*> plan_steps;
+    std::vector<std::pair<const char*, size_t>> counters;
+    std::vector<Stage> stages;
+    std::vector<Clock::time_point> stage_starts; // parallel to stages
+    size_t dropped_stages = 0;
+    uint32_t depth = 0;
+    size_t cache_hits = 0;
+    size_t cache_misses = 0;
+
+public:
+    static QueryProfile* current() { return active; }
+
+    // Recorded into the calling thread's profile, if it has one
+    static void step(const char* plan_step);
+    static void count(const char* name, size_t value);
+    static void cacheLookup(bool hit);
+
+    // TraceSpan's hooks: beginStage() returns what endStage() takes
+    size_t beginStage(const char* name);
+    void endStage(size_t stage);
+
+    const std::vector<const char*>& plan() const { return plan_steps; }
+    const std::vector<std::pair<const char*, size_t>>& counts() const { return counters; }
+    const std::vector<Stage>& timings() const { return stages; }
+    size_t cacheHits() const { return cache_hits; }
+    size_t cacheMisses() const { return cache_misses; }
+    size_t droppedStages() const { return dropped_stages; }
+    double elapsedMs() const;
+};
+
+#endif // QUERYPROFILE_H
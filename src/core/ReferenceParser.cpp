@@ -0,0 +1,221 @@
+#include "ReferenceParser.h"
+#include "BookResolver.h"
+#include <charconv>
+
+namespace {
+constexpr std::string_view EN_DASH = "\xE2\x80\x93";
+constexpr int MAX_NUMBER = 0xFFFF; // VerseStore keeps chapters and verses in 16 bits
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+bool isLetter(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+    while (!text.empty() && text.back() == ' ') text.remove_suffix(1);
+    return text;
+}
+
+// Reads through the chapter and verse numbers after the book
+class NumberCursor {
+public:
+    explicit NumberCursor(std::string_view text) : text(text) {}
+
+    bool atEnd() {
+        skipSpaces();
+        return pos == text.size();
+    }
+
+    bool number(int& value) {
+        skipSpaces();
+        size_t start = pos;
+        while (pos < text.size() && isDigit(text[pos])) pos++;
+        if (pos == start) return false;
+        auto result = std::from_chars(text.data() + start, text.data() + pos, value);
+        return result.ec == std::errc() && value <= MAX_NUMBER;
+    }
+
+    // ':' or a '.' between numbers, as in "3.16"
+    bool verseSeparator() {
+        skipSpaces();
+        if (pos < text.size() && (text[pos] == ':' || text[pos] == '.')) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool dash() {
+        skipSpaces();
+        if (pos < text.size() && text[pos] == '-') {
+            pos++;
+            return true;
+        }
+        if (text.substr(pos, EN_DASH.size()) == EN_DASH) {
+            pos += EN_DASH.size();
+            return true;
+        }
+        return false;
+    }
+
+    // ',' or ';', else 0
+    char listSeparator() {
+        skipSpaces();
+        if (pos < text.size() && (text[pos] == ',' || text[pos] == ';')) {
+            return text[pos++];
+        }
+        return 0;
+    }
+
+private:
+    std::string_view text;
+    size_t pos = 0;
+
+    void skipSpaces() {
+        while (pos < text.size() && text[pos] == ' ') pos++;
+    }
+};
+
+// Where the numbers after the book begin: the run of digits, separators,
+// dashes and spaces at the end of text
+size_t numbersStart(std::string_view text) {
+    size_t start = text.size();
+    while (start > 0) {
+        char c = text[start - 1];
+        if (isDigit(c) || c == ':' || c == ',' || c == ';' || c == '-' || c == ' ') {
+            start--;
+        } else if (c == '.' && start >= 2 && start < text.size() && isDigit(text[start - 2]) && isDigit(text[start])) {
+            start--;
+        } else if (start >= EN_DASH.size() && text.substr(start - EN_DASH.size(), EN_DASH.size()) == EN_DASH) {
+            start -= EN_DASH.size();
+        } else {
+            break;
+        }
+    }
+    return start;
+}
+
+// "John 10", "1 John 2", "1st Kings": a part of a list that names its own book
+bool startsWithBook(std::string_view part) {
+    part = trim(part);
+    size_t i = 0;
+    while (i < part.size() && isDigit(part[i])) i++;
+    if (i == 0) return !part.empty();
+    while (i < part.size() && part[i] == ' ') i++;
+    return i < part.size() && (isLetter(part[i]) || static_cast<unsigned char>(part[i]) >= 0x80);
+}
+
+bool parseSpans(std::string_view text, ParsedReference& reference) {
+    NumberCursor cursor(text);
+    bool next_is_verse = false; // after a comma that followed a verse
+    int current_chapter = -1;
+
+    do {
+        if (reference.span_count == ParsedReference::MAX_SPANS) return false;
+        ReferenceSpan span;
+
+        int first;
+        if (!cursor.number(first)) return false;
+        if (cursor.verseSeparator()) {
+            span.chapter = first;
+            if (!cursor.number(span.verse)) return false;
+        } else if (next_is_verse) {
+            span.chapter = current_chapter;
+            span.verse = first;
+        } else {
+            span.chapter = first;
+        }
+        span.end_chapter = span.chapter;
+        span.end_verse = span.verse;
+
+        if (cursor.dash()) {
+            int end;
+            if (!cursor.number(end)) return false;
+            if (cursor.verseSeparator()) {
+                // "3:16-4:2"; a chapter range cannot end mid-chapter
+                if (span.wholeChapters()) return false;
+                span.end_chapter = end;
+                if (!cursor.number(span.end_verse)) return false;
+            } else if (span.wholeChapters()) {
+                span.end_chapter = end;
+            } else {
+                span.end_verse = end;
+            }
+        }
+
+        bool backwards = span.end_chapter < span.chapter ||
+                         (span.end_chapter == span.chapter && span.end_verse < span.verse);
+        if (backwards) return false;
+        reference.spans[reference.span_count++] = span;
+
+        if (cursor.atEnd()) return true;
+        char separator = cursor.listSeparator();
+        if (separator == 0) return false;
+        next_is_verse = separator == ',' && !span.wholeChapters();
+        current_chapter = span.end_chapter;
+    } while (true);
+}
+}
+
+bool ParsedReference::isSingleVerse() const {
+    return span_count == 1 && spans[0].verse >= 0 && spans[0].end_chapter == spans[0].chapter &&
+           spans[0].end_verse == spans[0].verse;
+}
+
+bool ReferenceParser::parse(std::string_view text, ParsedReference& reference) {
+    reference = ParsedReference();
+    text = trim(text);
+
+    // A translation hint: "(KJV)", or a trailing word right after the numbers
+    if (!text.empty() && text.back() == ')') {
+        size_t open = text.rfind('(');
+        if (open == std::string_view::npos) return false;
+        reference.translation = trim(text.substr(open + 1, text.size() - open - 2));
+        text = trim(text.substr(0, open));
+    } else {
+        // Unless the numbers before it are all there is, as in "1 John"
+        size_t space = text.rfind(' ');
+        std::string_view rest = space != std::string_view::npos ? trim(text.substr(0, space)) : std::string_view();
+        if (!rest.empty() && isDigit(rest.back()) && !trim(rest.substr(0, numbersStart(rest))).empty()) {
+            std::string_view word = text.substr(space + 1);
+            bool letters = true;
+            for (char c : word) letters = letters && isLetter(c);
+            if (letters) {
+                reference.translation = word;
+                text = rest;
+            }
+        }
+    }
+
+    size_t start = numbersStart(text);
+    reference.book = trim(text.substr(0, start));
+    std::string_view numbers = trim(text.substr(start));
+
+    // Separators left in the book mean numbers that did not parse, or a list
+    if (reference.book.empty() || reference.book.find_first_of(":;,") != std::string_view::npos) {
+        return false;
+    }
+    reference.canonical_book = BookResolver::canonicalBook(reference.book);
+
+    return numbers.empty() || parseSpans(numbers, reference);
+}
+
+bool ReferenceParser::parseList(std::string_view text, std::vector<ParsedReference>& references) {
+    references.clear();
+    size_t begin = 0;
+    for (size_t semicolon = text.find(';'); semicolon != std::string_view::npos;
+         semicolon = text.find(';', semicolon + 1)) {
+        if (!startsWithBook(text.substr(semicolon + 1, text.find(';', semicolon + 1) - semicolon - 1))) {
+            continue;
+        }
+        references.emplace_back();
+        if (!parse(text.substr(begin, semicolon - begin), references.back())) return false;
+        begin = semicolon + 1;
+    }
+    references.emplace_back();
+    return parse(text.substr(begin), references.back());
+}
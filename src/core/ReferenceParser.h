@@ -0,0 +1,53 @@
+#ifndef REFERENCE_PARSER_H
+#define REFERENCE_PARSER_H
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+// One contiguous stretch of a reference. verse is -1 for whole chapters,
+// so "John 3" is {3, -1, 3, -1}, "John 3-4" is {3, -1, 4, -1} and
+// "John 3:16-4:2" is {3, 16, 4, 2}.
+struct ReferenceSpan {
+    int chapter = -1;
+    int verse = -1;
+    int end_chapter = -1;
+    int end_verse = -1;
+
+    bool wholeChapters() const { return verse == -1; }
+};
+
+struct ParsedReference {
+    static constexpr size_t MAX_SPANS = 8;
+
+    std::string_view book;        // as written, e.g. "1 Cor."
+    int canonical_book = 0;       // BookResolver::canonicalBook(book), 0 if not one of the 66
+    std::string_view translation; // "KJV" from "John 3:16 (KJV)" or "John 3:16 KJV", else empty
+    std::array<ReferenceSpan, MAX_SPANS> spans{};
+    size_t span_count = 0;        // 0 for a bare book name
+
+    bool hasChapter() const { return span_count > 0; }
+    const ReferenceSpan& first() const { return spans[0]; }
+    // Exactly one verse, as in "John 3:16"
+    bool isSingleVerse() const;
+};
+
+// The one parser for scripture references, allocation-free: everything in
+// the result views the input, which must outlive it.
+//
+//   "John 3:16"  "John 3"  "1 Cor. 13:4-7"  "John 3:16-4:2"  "Jn 3.16 (KJV)"
+//   "John 3:16, 18, 20-21"  "Ps 23; 24:1-3"  "1 John"
+//
+// After a comma a bare number is another verse of the same chapter; after
+// a semicolon it is a chapter. Ranges take "-" or an en dash. Anything
+// else, a range running backwards, or more than MAX_SPANS spans, fails.
+class ReferenceParser {
+public:
+    static bool parse(std::string_view text, ParsedReference& reference);
+    // "Ps 23; John 10:11-18": one reference per book, in order. A part with
+    // no book of its own continues the one before, as in "Ps 23; 24:1-3".
+    static bool parseList(std::string_view text, std::vector<ParsedReference>& references);
+};
+
+#endif // REFERENCE_PARSER_H
@@ -0,0 +1,52 @@
+#include "RegexCache.h"
+
+RegexCache::RegexCache(size_t capacity) : capacity(capacity == 0 ? 1 : capacity) {}
+
+RegexCache& RegexCache::shared() {
+    static RegexCache cache;
+    return cache;
+}
+
+RegexCache::Compiled RegexCache::get(const std::string& pattern, bool case_sensitive) {
+    std::string key = (case_sensitive ? "c:" : "i:") + pattern;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end()) {
+            lru.splice(lru.begin(), lru, it->second.lru_pos);
+            return it->second.compiled;
+        }
+    }
+
+    // Compile outside the lock; two threads racing on one pattern both compile and one wins
+    Compiled compiled;
+    try {
+        std::regex::flag_type flags = std::regex::ECMAScript | std::regex::optimize;
+        if (!case_sensitive) flags |= std::regex::icase;
+        compiled.regex = std::make_shared<const std::regex>(pattern, flags);
+    } catch (const std::regex_error& e) {
+        compiled.error = e.what();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = entries.find(key);
+    if (it != entries.end()) return it->second.compiled;
+    lru.push_front(key);
+    entries.emplace(std::move(key), Entry{compiled, lru.begin()});
+    while (entries.size() > capacity) {
+        entries.erase(lru.back());
+        lru.pop_back();
+    }
+    return compiled;
+}
+
+void RegexCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    lru.clear();
+}
+
+size_t RegexCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
@@ -0,0 +1,51 @@
+#ifndef REGEXCACHE_H
+#define REGEXCACHE_H
+
+#include <string>
+#include <memory>
+#include <regex>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+
+// Compiled user regexes, keyed by pattern and flags. Compiling a std::regex
+// costs far more than running it against a verse, so a search compiles its
+// pattern once (with std::regex::optimize) and every later search with the
+// same pattern reuses it. Invalid patterns are remembered too, so a typo being
+// edited keystroke by keystroke is not recompiled to fail again. Bounded LRU;
+// safe to share between threads, and a compiled regex is immutable once built.
+class RegexCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 64;
+
+    struct Compiled {
+        std::shared_ptr<const std::regex> regex; // null when the pattern is invalid
+        std::string error;
+    };
+
+private:
+    struct Entry {
+        Compiled compiled;
+        std::list<std::string>::iterator lru_pos;
+    };
+
+    mutable std::mutex mutex;
+    size_t capacity;
+    std::unordered_map<std::string, Entry> entries;
+    std::list<std::string> lru; // most recently used first
+
+public:
+    explicit RegexCache(size_t capacity = DEFAULT_CAPACITY);
+
+    RegexCache(const RegexCache&) = delete;
+    RegexCache& operator=(const RegexCache&) = delete;
+
+    // Process-wide cache for searches that have nowhere better to keep one
+    static RegexCache& shared();
+
+    Compiled get(const std::string& pattern, bool case_sensitive = false);
+    void clear();
+    size_t size() const;
+};
+
+#endif // REGEXCACHE_H
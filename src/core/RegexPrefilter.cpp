@@ -0,0 +1,222 @@
+#include "RegexPrefilter.h"
+#include "TextKernels.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+using Clause = RegexPrefilter::Clause;
+
+// Shortest literal of a clause: the weakest alternative decides how much it narrows
+size_t weakestLength(const Clause& clause) {
+    size_t length = SIZE_MAX;
+    for (const std::string& literal : clause) length = std::min(length, literal.size());
+    return length;
+}
+
+bool moreSelective(const Clause& a, const Clause& b) {
+    if (a.size() != b.size()) return a.size() < b.size();
+    return weakestLength(a) > weakestLength(b);
+}
+
+// Recursive descent over ECMAScript syntax, keeping only what every match must contain
+class LiteralReader {
+    std::string_view pattern;
+    size_t pos = 0;
+
+    struct Repeat {
+        size_t min = 1;
+        bool once = true; // exactly one occurrence
+    };
+
+    bool more() const { return pos < pattern.size(); }
+
+    Repeat quantifier() {
+        Repeat repeat;
+        if (!more()) return repeat;
+        char c = pattern[pos];
+        if (c == '*' || c == '?') {
+            repeat = {0, false};
+            ++pos;
+        } else if (c == '+') {
+            repeat = {1, false};
+            ++pos;
+        } else if (c == '{') {
+            // {n}, {n,} or {n,m}; anything else is a literal brace
+            size_t end = pos + 1;
+            size_t min = 0;
+            size_t digits = 0;
+            while (end < pattern.size() && pattern[end] >= '0' && pattern[end] <= '9') {
+                min = std::min<size_t>(min * 10 + (pattern[end] - '0'), 1000);
+                ++end;
+                ++digits;
+            }
+            bool ranged = end < pattern.size() && pattern[end] == ',';
+            if (ranged) {
+                ++end;
+                while (end < pattern.size() && pattern[end] >= '0' && pattern[end] <= '9') ++end;
+            }
+            if (digits == 0 || end >= pattern.size() || pattern[end] != '}') return repeat;
+            repeat = {min, min == 1 && !ranged};
+            pos = end + 1;
+        } else {
+            return repeat;
+        }
+        if (more() && pattern[pos] == '?') ++pos; // lazy
+        return repeat;
+    }
+
+    void skipClass() {
+        ++pos; // '['
+        while (more() && pattern[pos] != ']') {
+            pos += pattern[pos] == '\\' ? 2 : 1;
+        }
+        pos = std::min(pos + 1, pattern.size());
+    }
+
+    void skipEscape() {
+        ++pos; // '\'
+        if (!more()) return;
+        char c = pattern[pos++];
+        if (c == 'x') {
+            pos += 2;
+        } else if (c == 'u') {
+            pos += 4;
+        } else if (c == 'c') {
+            pos += 1;
+        } else if (c >= '0' && c <= '9') {
+            while (more() && pattern[pos] >= '0' && pattern[pos] <= '9') ++pos;
+        }
+        pos = std::min(pos, pattern.size());
+    }
+
+    std::vector<Clause> sequence() {
+        std::vector<Clause> clauses;
+        std::string run;
+        auto endRun = [&]() {
+            if (run.size() >= RegexPrefilter::MIN_LITERAL_LENGTH) clauses.push_back({run});
+            run.clear();
+        };
+
+        while (more() && pattern[pos] != '|' && pattern[pos] != ')') {
+            char c = pattern[pos];
+            if (c == '(') {
+                endRun();
+                ++pos;
+                // Lookahead asserts without consuming; its literals need not be in the match
+                bool opaque = false;
+                if (pattern.substr(pos, 2) == "?:") {
+                    pos += 2;
+                } else if (more() && pattern[pos] == '?') {
+                    opaque = true;
+                    pos = std::min(pos + 2, pattern.size());
+                }
+                std::vector<Clause> inner = alternation();
+                if (more() && pattern[pos] == ')') ++pos;
+                Repeat repeat = quantifier();
+                if (!opaque && repeat.min > 0) {
+                    clauses.insert(clauses.end(), std::make_move_iterator(inner.begin()),
+                                   std::make_move_iterator(inner.end()));
+                }
+                continue;
+            }
+            if (c == '[') {
+                endRun();
+                skipClass();
+                quantifier();
+                continue;
+            }
+            if (c == '\\') {
+                endRun();
+                skipEscape();
+                quantifier();
+                continue;
+            }
+
+            ++pos;
+            Repeat repeat = quantifier();
+            if (!TextKernels::isWordChar(static_cast<unsigned char>(c)) || repeat.min == 0) {
+                endRun();
+                continue;
+            }
+            run.push_back(TextKernels::toLower(c));
+            // "lo+rd" holds "lo", then who knows how many more o's
+            if (!repeat.once) endRun();
+        }
+        endRun();
+        return clauses;
+    }
+
+public:
+    explicit LiteralReader(std::string_view pattern) : pattern(pattern) {}
+
+    std::vector<Clause> alternation() {
+        std::vector<std::vector<Clause>> branches;
+        branches.push_back(sequence());
+        while (more() && pattern[pos] == '|') {
+            ++pos;
+            branches.push_back(sequence());
+        }
+        if (branches.size() == 1) return std::move(branches[0]);
+
+        // Each branch's most selective clause, any one of which will do; a
+        // branch requiring nothing lets every verse through
+        Clause any;
+        for (const auto& branch : branches) {
+            if (branch.empty()) return {};
+            const Clause& best = *std::min_element(branch.begin(), branch.end(), moreSelective);
+            any.insert(any.end(), best.begin(), best.end());
+        }
+        std::sort(any.begin(), any.end());
+        any.erase(std::unique(any.begin(), any.end()), any.end());
+        return {std::move(any)};
+    }
+
+    bool finished() const { return !more(); }
+};
+
+} // namespace
+
+std::vector<RegexPrefilter::Clause> RegexPrefilter::requiredLiterals(std::string_view pattern) {
+    LiteralReader reader(pattern);
+    std::vector<Clause> clauses = reader.alternation();
+    // An unbalanced ')' is not a valid pattern; make no promises about one
+    if (!reader.finished()) return {};
+
+    std::sort(clauses.begin(), clauses.end());
+    clauses.erase(std::unique(clauses.begin(), clauses.end()), clauses.end());
+    std::stable_sort(clauses.begin(), clauses.end(), moreSelective);
+    if (clauses.size() > MAX_CLAUSES) clauses.resize(MAX_CLAUSES);
+    return clauses;
+}
+
+bool RegexPrefilter::candidates(const std::vector<Clause>& clauses, const Lookup& lookup, std::vector<VerseId>& ids) {
+    ids.clear();
+    if (clauses.empty()) return false;
+
+    for (size_t i = 0; i < clauses.size(); ++i) {
+        std::vector<VerseId> satisfying;
+        for (const std::string& literal : clauses[i]) {
+            std::vector<VerseId> found = lookup(literal);
+            if (satisfying.empty()) {
+                satisfying = std::move(found);
+                continue;
+            }
+            std::vector<VerseId> merged;
+            merged.reserve(satisfying.size() + found.size());
+            std::set_union(satisfying.begin(), satisfying.end(), found.begin(), found.end(),
+                           std::back_inserter(merged));
+            satisfying = std::move(merged);
+        }
+        if (i == 0) {
+            ids = std::move(satisfying);
+        } else {
+            std::vector<VerseId> common;
+            std::set_intersection(ids.begin(), ids.end(), satisfying.begin(), satisfying.end(),
+                                  std::back_inserter(common));
+            ids = std::move(common);
+        }
+        if (ids.empty()) break;
+    }
+    return true;
+}
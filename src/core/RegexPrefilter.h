@@ -0,0 +1,41 @@
+#ifndef REGEXPREFILTER_H
+#define REGEXPREFILTER_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "VerseStore.h"
+
+// Narrows a regex search to the verses that can match before the regex runs.
+// The pattern is read for the literal text every match must contain: in
+// "\bsh[ae]pherd\w*" any match holds "pherd", in "(lamb|sheep)s? of god"
+// one of "lamb" and "sheep", and "god". The index then answers which verses
+// contain those fragments, and only they are matched against the regex.
+//
+// Only runs of ASCII letters and digits are kept, lowercased, since those
+// lie within one indexed word whatever the case or accents around them. The
+// reading is conservative: anything not understood (classes, escapes,
+// back-references, lookaround, optional parts) contributes nothing, so the
+// filter can let through verses that do not match but never drops one that
+// does. A pattern without a usable literal ("\d+", "^.{300,}$") has no
+// clauses and is scanned verse by verse.
+class RegexPrefilter {
+public:
+    static constexpr size_t MIN_LITERAL_LENGTH = 3; // shorter ones narrow too little to be worth a lookup
+    static constexpr size_t MAX_CLAUSES = 4;        // longest literals first
+
+    // Satisfied by a verse containing any one of its literals
+    using Clause = std::vector<std::string>;
+    // Verses whose folded words contain fragment, sorted
+    using Lookup = std::function<std::vector<VerseId>(std::string_view fragment)>;
+
+    // Clauses every match satisfies; empty if the pattern requires no literal
+    static std::vector<Clause> requiredLiterals(std::string_view pattern);
+
+    // Sorted verses satisfying every clause; false, leaving ids empty, when
+    // there are no clauses and every verse is a candidate
+    static bool candidates(const std::vector<Clause>& clauses, const Lookup& lookup, std::vector<VerseId>& ids);
+};
+
+#endif // REGEXPREFILTER_H
@@ -4,6 +4,7 @@
 #include "HealthMonitor.h"
 #include "BackupManager.h"
 #include "EmergencyModeHandler.h"
+#include "DegradationPolicy.h"
 #include <iostream>
 #include <filesystem>
 #include <fstream>
@@ -60,6 +61,7 @@ bool ReliabilityManager::initialize([[maybe_unused]] const std::string& app_dire
         health_monitor = std::make_unique<HealthMonitor>();
         backup_manager = std::make_unique<BackupManager>();
         emergency_mode = std::make_unique<EmergencyModeHandler>();
+        degradation_policy = std::make_unique<DegradationPolicy>();
         
         // Initialize each component
         if (!crash_recovery->initialize(crash_recovery_directory)) {
@@ -77,10 +79,24 @@ bool ReliabilityManager::initialize([[maybe_unused]] const std::string& app_dire
             return false;
         }
         
+        // Every health sample drives load shedding
+        health_monitor->setPerformanceCallback([this](const PerformanceMetrics& metrics) {
+            DegradationLevel before = degradation_policy->level();
+            DegradationLevel after = degradation_policy->evaluate(metrics);
+            if (after != before) {
+                std::cout << "Degradation level changed to " << DegradationPolicy::name(after);
+                std::string reason = degradation_policy->reason();
+                if (!reason.empty()) std::cout << " (" << reason << ")";
+                std::cout << std::endl;
+            }
+        });
+        
         if (!backup_manager->initialize(backup_directory)) {
             reportError("Failed to initialize backup manager");
             return false;
         }
+        backup_manager->addSource(config_directory);
+        backup_manager->addSource(crash_recovery_directory);
         
         if (!emergency_mode->initialize()) {
             reportError("Failed to initialize emergency mode handler");
@@ -117,9 +133,11 @@ bool ReliabilityManager::start() {
     }
     
     try {
-        // Start the auto-save thread
+        is_running.store(true);
+        
+        // Start auto-saving; the loop runs only while is_running is set
         if (auto_save_enabled.load()) {
-            auto_save_thread = std::thread(&ReliabilityManager::autoSaveLoop, this);
+            auto_save_done = spawn(autoSaveLoop(), TaskPriority::BACKGROUND);
         }
         
         // Start health monitoring
@@ -127,8 +145,6 @@ bool ReliabilityManager::start() {
             health_monitor->startMonitoring();
         }
         
-        is_running.store(true);
-        
         // Update reliability level to normal
         updateReliabilityLevel(ReliabilityLevel::NORMAL);
         
@@ -137,6 +153,7 @@ bool ReliabilityManager::start() {
         
     } catch (const std::exception& e) {
         reportCriticalError("Failed to start ReliabilityManager: " + std::string(e.what()));
+        is_running.store(false);
         return false;
     }
 }
@@ -148,10 +165,10 @@ void ReliabilityManager::stop() {
     
     is_running.store(false);
     
-    // Stop auto-save thread
-    if (auto_save_thread.joinable()) {
-        auto_save_cv.notify_all();
-        auto_save_thread.join();
+    // Stop auto-saving, waiting out a save in progress
+    if (auto_save_done.valid()) {
+        auto_save_wake.set();
+        auto_save_done.wait();
     }
     
     // Stop health monitoring
@@ -409,6 +426,14 @@ std::string ReliabilityManager::generateDiagnosticReport() {
     }
     report += "\n";
     
+    if (degradation_policy) {
+        report += "Degradation Level: ";
+        report += DegradationPolicy::name(degradation_policy->level());
+        std::string reason = degradation_policy->reason();
+        if (!reason.empty()) report += " (" + reason + ")";
+        report += "\n";
+    }
+    
     // Component status
     if (health_monitor) {
         report += health_monitor->generateReport();
@@ -535,10 +560,10 @@ void ReliabilityManager::resetStats() {
 
 // Private methods
 
-void ReliabilityManager::autoSaveLoop() {
+Task<void> ReliabilityManager::autoSaveLoop() {
     while (is_running.load()) {
-        std::unique_lock<std::mutex> lock(auto_save_mutex);
-        if (auto_save_cv.wait_for(lock, auto_save_interval, [this] { return !is_running.load(); })) {
+        co_await auto_save_wake.waitFor(auto_save_interval, TaskPriority::BACKGROUND);
+        if (!is_running.load()) {
             break; // Shutdown requested
         }
         
@@ -551,6 +576,23 @@ void ReliabilityManager::autoSaveLoop() {
 void ReliabilityManager::updateReliabilityLevel(ReliabilityLevel new_level) {
     ReliabilityLevel old_level = current_level.exchange(new_level);
     
+    // A degraded system sheds at least the optional search work; emergency and
+    // critical shed everything but lookup and display, whatever the load
+    if (degradation_policy) {
+        switch (new_level) {
+            case ReliabilityLevel::NORMAL:
+                degradation_policy->setFloor(DegradationLevel::NORMAL);
+                break;
+            case ReliabilityLevel::DEGRADED:
+                degradation_policy->setFloor(DegradationLevel::REDUCED, "component degraded");
+                break;
+            case ReliabilityLevel::EMERGENCY:
+            case ReliabilityLevel::CRITICAL:
+                degradation_policy->setFloor(DegradationLevel::MINIMAL, "emergency mode");
+                break;
+        }
+    }
+    
     if (old_level != new_level) {
         std::cout << "Reliability level changed from " << static_cast<int>(old_level) 
                   << " to " << static_cast<int>(new_level) << std::endl;
@@ -6,9 +6,9 @@
 #include <chrono>
 #include <functional>
 #include <atomic>
-#include <thread>
+#include <future>
 #include <mutex>
-#include <condition_variable>
+#include "Task.h"
 
 // Forward declarations
 class CrashRecoverySystem;
@@ -16,6 +16,7 @@ class ErrorHandler;
 class HealthMonitor;
 class BackupManager;
 class EmergencyModeHandler;
+class DegradationPolicy;
 
 enum class ReliabilityLevel {
     NORMAL = 0,
@@ -59,6 +60,7 @@ private:
     std::unique_ptr<HealthMonitor> health_monitor;
     std::unique_ptr<BackupManager> backup_manager;
     std::unique_ptr<EmergencyModeHandler> emergency_mode;
+    std::unique_ptr<DegradationPolicy> degradation_policy; // sheds optional work under load
     
     // State management
     std::atomic<ReliabilityLevel> current_level{ReliabilityLevel::NORMAL};
@@ -66,10 +68,9 @@ private:
     std::atomic<bool> is_running{false};
     std::atomic<bool> auto_save_enabled{true};
     
-    // Auto-save system
-    std::thread auto_save_thread;
-    std::mutex auto_save_mutex;
-    std::condition_variable auto_save_cv;
+    // Auto-save system: a coroutine on the TaskScheduler, suspended between saves
+    std::future<void> auto_save_done;
+    AsyncEvent auto_save_wake;
     std::chrono::seconds auto_save_interval{30};
     
     // System health tracking
@@ -90,7 +91,7 @@ private:
     ReliabilityManager();
     
     // Internal methods
-    void autoSaveLoop();
+    Task<void> autoSaveLoop();
     void updateReliabilityLevel(ReliabilityLevel new_level);
     bool performHealthCheck();
     void handleCriticalError(const std::string& error_message);
@@ -162,6 +163,7 @@ public:
     HealthMonitor* getHealthMonitor() { return health_monitor.get(); }
     BackupManager* getBackupManager() { return backup_manager.get(); }
     EmergencyModeHandler* getEmergencyMode() { return emergency_mode.get(); }
+    DegradationPolicy* getDegradationPolicy() { return degradation_policy.get(); }
     
     // Statistics and metrics
     struct ReliabilityStats {
@@ -1,9 +1,11 @@
 #include "SearchAnalytics.h"
+#include "ThreadRandom.h"
 #include <algorithm>
-#include <random>
 #include <iostream>
 #include <sstream>
 #include <unordered_set>
+#include <numeric>
+#include <cmath>
 
 SearchAnalytics::SearchAnalytics() {
     initializeSeasonalVerses();
@@ -29,36 +31,127 @@ void SearchAnalytics::initializeTopicalVerses() {
     };
 }
 
+uint32_t SearchAnalytics::StringPool::intern(const std::string& text) {
+    auto it = ids.find(text);
+    if (it != ids.end()) return it->second;
+    uint32_t id = static_cast<uint32_t>(strings.size());
+    strings.push_back(text);
+    ids.emplace(text, id);
+    return id;
+}
+
+const uint32_t* SearchAnalytics::StringPool::find(const std::string& text) const {
+    auto it = ids.find(text);
+    return it != ids.end() ? &it->second : nullptr;
+}
+
 void SearchAnalytics::recordSearch(const std::string& query, const std::string& queryType, 
                                  const std::string& translation, int resultCount, 
                                  double executionTime, bool wasSuccessful) {
+    if (maxHistorySize == 0) return;
+    const auto now = std::chrono::system_clock::now();
+    updateLocalTime(now);
     
-    SearchEntry entry;
-    entry.query = query;
-    entry.queryType = queryType;
-    entry.translation = translation;
-    entry.timestamp = std::chrono::system_clock::now();
+    // Reuse the oldest slot once the ring is full
+    const size_t slot = searchesRecorded % maxHistorySize;
+    if (slot == searchHistory.size()) searchHistory.emplace_back();
+    HistoryRecord& entry = searchHistory[slot];
+    if (historyCount == maxHistorySize) {
+        evictRecord(entry);
+    } else {
+        ++historyCount;
+    }
+    
+    entry.query = queries.intern(query);
+    entry.queryType = labels.intern(queryType);
+    entry.translation = labels.intern(translation);
+    entry.timestamp = now;
     entry.resultCount = resultCount;
-    entry.executionTime = executionTime;
+    entry.executionTime = static_cast<float>(executionTime);
     entry.wasSuccessful = wasSuccessful;
+    entry.hour = currentHour;
+    entry.weekday = currentWeekday;
+    entry.selectedResults.clear();
     
-    searchHistory.push_back(entry);
-    queryFrequency[query]++;
+    ++searchesByHour[entry.hour];
+    ++searchesByWeekday[entry.weekday];
+    if (entry.queryType >= searchesByType.size()) searchesByType.resize(entry.queryType + 1, 0);
+    ++searchesByType[entry.queryType];
     
-    // Prune old entries if necessary
-    if (searchHistory.size() > maxHistorySize) {
-        pruneOldEntries();
-    }
+    if (entry.query >= queryStats.size()) queryStats.resize(entry.query + 1);
+    QueryStats& stats = queryStats[entry.query];
+    ++stats.count;
+    stats.trendScore += trendWeight(now);
+    stats.lastSearched = now;
+    stats.lastSearch = searchesRecorded++;
+    
+    promote(topQueries, entry.query, [this](uint32_t id) { return queryStats[id].count; });
+    promote(trendingQueries, entry.query, [this](uint32_t id) { return queryStats[id].trendScore; });
 }
 
 void SearchAnalytics::recordVerseSelection(const std::string& query, const std::string& selectedVerse) {
-    // Find the most recent search entry for this query and add the selection
-    for (auto it = searchHistory.rbegin(); it != searchHistory.rend(); ++it) {
-        if (it->query == query) {
-            it->selectedResults.push_back(selectedVerse);
-            break;
+    // The query's latest search, if it is still in the history
+    const uint32_t* id = queries.find(query);
+    if (!id || historyCount == 0) return;
+    uint64_t search = queryStats[*id].lastSearch;
+    if (search >= searchesRecorded || search < searchesRecorded - historyCount) return;
+    
+    HistoryRecord& entry = searchHistory[search % maxHistorySize];
+    if (entry.query == *id) entry.selectedResults.push_back(labels.intern(selectedVerse));
+}
+
+void SearchAnalytics::evictRecord(HistoryRecord& record) {
+    --searchesByHour[record.hour];
+    --searchesByWeekday[record.weekday];
+    --searchesByType[record.queryType];
+}
+
+void SearchAnalytics::updateLocalTime(std::chrono::system_clock::time_point now) {
+    std::time_t time = std::chrono::system_clock::to_time_t(now);
+    if (time < currentHourEnd) return;
+    
+    std::tm local = *std::localtime(&time);
+    currentHour = static_cast<uint8_t>(local.tm_hour);
+    currentWeekday = static_cast<uint8_t>(local.tm_wday);
+    currentHourEnd = time + (60 - local.tm_min) * 60 - local.tm_sec;
+}
+
+double SearchAnalytics::trendWeight(std::chrono::system_clock::time_point now) {
+    // Forward decay: rather than shrinking every score as time passes, later
+    // searches weigh exponentially more, which ranks queries identically
+    const double halfLives = std::chrono::duration<double, std::ratio<3600>>(now - trendEpoch).count()
+                             / TREND_HALF_LIFE_HOURS;
+    double weight = std::exp2(halfLives);
+    if (weight > 1e100) {
+        // Move the epoch up before the scores overflow
+        for (QueryStats& stats : queryStats) stats.trendScore /= weight;
+        trendEpoch = now;
+        weight = 1.0;
+    }
+    return weight;
+}
+
+template <typename Score>
+void SearchAnalytics::promote(std::vector<uint32_t>& ranking, uint32_t queryId, Score score) {
+    // Scores only grow, so the query can only move up
+    auto it = std::find(ranking.begin(), ranking.end(), queryId);
+    if (it == ranking.end()) {
+        if (ranking.size() < RANKED_QUERIES) {
+            ranking.push_back(queryId);
+        } else if (score(ranking.back()) < score(queryId)) {
+            ranking.back() = queryId;
+        } else {
+            return;
         }
+        it = ranking.end() - 1;
     }
+    for (; it != ranking.begin() && score(*(it - 1)) < score(*it); --it) std::iter_swap(it - 1, it);
+}
+
+std::vector<std::string> SearchAnalytics::rankedQueries(const std::vector<uint32_t>& ranking, size_t count) const {
+    std::vector<std::string> result;
+    for (size_t i = 0; i < std::min(count, ranking.size()); ++i) result.push_back(queries.get(ranking[i]));
+    return result;
 }
 
 void SearchAnalytics::recordVerseAccess(const std::string& verseKey, double relevanceScore) {
@@ -70,16 +163,24 @@ void SearchAnalytics::recordVerseAccess(const std::string& verseKey, double rele
 }
 
 std::vector<std::string> SearchAnalytics::getMostSearchedQueries(int count) const {
-    std::vector<std::pair<std::string, int>> queryPairs(queryFrequency.begin(), queryFrequency.end());
-    
-    std::sort(queryPairs.begin(), queryPairs.end(), 
-              [](const auto& a, const auto& b) { return a.second > b.second; });
+    if (count <= 0) return {};
+    if (static_cast<size_t>(count) <= RANKED_QUERIES) return rankedQueries(topQueries, count);
     
+    std::vector<uint32_t> ids(queryStats.size());
+    std::iota(ids.begin(), ids.end(), 0);
+    std::sort(ids.begin(), ids.end(), [this](uint32_t a, uint32_t b) {
+        return queryStats[a].count > queryStats[b].count;
+    });
+    return rankedQueries(ids, count);
+}
+
+std::vector<std::string> SearchAnalytics::getTrendingQueries(int days) const {
+    // Ranked by trend score, limited to queries searched in the last days
+    const auto cutoff = std::chrono::system_clock::now() - std::chrono::hours(24 * std::max(days, 0));
     std::vector<std::string> result;
-    for (int i = 0; i < std::min(count, (int)queryPairs.size()); ++i) {
-        result.push_back(queryPairs[i].first);
+    for (uint32_t id : trendingQueries) {
+        if (queryStats[id].lastSearched >= cutoff) result.push_back(queries.get(id));
     }
-    
     return result;
 }
 
@@ -104,49 +205,60 @@ std::vector<std::string> SearchAnalytics::getMostPopularVerses(int count) const
 std::vector<std::string> SearchAnalytics::getRecentSearches(int count) const {
     std::vector<std::string> result;
     
-    int start = std::max(0, (int)searchHistory.size() - count);
-    for (int i = start; i < (int)searchHistory.size(); ++i) {
-        result.push_back(searchHistory[i].query);
+    // Newest first
+    const size_t n = std::min(static_cast<size_t>(std::max(count, 0)), historyCount);
+    for (size_t i = 1; i <= n; ++i) {
+        result.push_back(queries.get(searchHistory[(searchesRecorded - i) % maxHistorySize].query));
+    }
+    return result;
+}
+
+std::vector<std::pair<std::string, uint32_t>> SearchAnalytics::getSuccessfulQueryCounts() const {
+    std::vector<uint32_t> counts(queries.size(), 0);
+    for (size_t i = 0; i < historyCount; ++i) {
+        const HistoryRecord& record = searchHistory[(searchesRecorded - historyCount + i) % maxHistorySize];
+        if (record.wasSuccessful && record.resultCount > 0) ++counts[record.query];
+    }
+    std::vector<std::pair<std::string, uint32_t>> result;
+    for (uint32_t id = 0; id < counts.size(); ++id) {
+        if (counts[id] != 0) result.push_back({queries.get(id), counts[id]});
     }
-    
-    std::reverse(result.begin(), result.end());
     return result;
 }
 
 std::string SearchAnalytics::getVerseOfTheDay() const {
-    // Simple implementation - would be enhanced with actual verse of the day logic
-    std::vector<std::string> popularVerses = {"John 3:16", "Psalm 23:1", "Romans 8:28", "Philippians 4:13"};
-    
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, popularVerses.size() - 1);
+    static const std::vector<std::string> popularVerses = {"John 3:16", "Psalm 23:1", "Romans 8:28", "Philippians 4:13"};
     
-    return popularVerses[dis(gen)];
+    // Scrambled so consecutive days do not simply walk the list
+    uint32_t day = static_cast<uint32_t>(currentDay());
+    return popularVerses[(day * 2654435761u >> 16) % popularVerses.size()];
+}
+
+int SearchAnalytics::currentDay() {
+    std::time_t now = std::time(nullptr);
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    return (local.tm_year + 1900) * 10000 + (local.tm_mon + 1) * 100 + local.tm_mday;
 }
 
 std::string SearchAnalytics::getTopicalVerseOfTheDay(const std::string& topic) const {
     auto it = topicalVerses.find(topic);
     if (it != topicalVerses.end() && !it->second.empty()) {
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> dis(0, it->second.size() - 1);
-        return it->second[dis(gen)];
+        return it->second[randomIndex(it->second.size())];
     }
     
     return getVerseOfTheDay();
 }
 
-std::string SearchAnalytics::getRandomVerse(const std::unordered_map<std::string, std::string>& allVerses) const {
-    if (allVerses.empty()) return "";
-    
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, allVerses.size() - 1);
-    
-    auto it = allVerses.begin();
-    std::advance(it, dis(gen));
+std::string SearchAnalytics::getRandomVerse(const VerseTextView& allVerses) const {
+    size_t count = allVerses.size();
+    if (count == 0) return "";
     
-    return it->first + ": " + it->second;
+    return allVerses.formatResult(randomIndex(count));
 }
 
 void SearchAnalytics::addToFavorites(const std::string& verseKey) {
@@ -185,11 +297,43 @@ std::vector<std::string> SearchAnalytics::getAllCollections() const {
     return result;
 }
 
-void SearchAnalytics::pruneOldEntries() {
-    if (searchHistory.size() > maxHistorySize) {
-        searchHistory.erase(searchHistory.begin(), 
-                           searchHistory.begin() + (searchHistory.size() - maxHistorySize));
+void SearchAnalytics::setMaxHistorySize(size_t size) {
+    if (size == maxHistorySize) return;
+    
+    // Keep the newest searches, renumbered from zero in the new ring
+    const size_t kept = std::min(size, historyCount);
+    std::vector<HistoryRecord> ring;
+    ring.reserve(kept);
+    for (size_t i = 0; i < historyCount; ++i) {
+        HistoryRecord& record = searchHistory[(searchesRecorded - historyCount + i) % maxHistorySize];
+        if (i < historyCount - kept) {
+            evictRecord(record);
+        } else {
+            ring.push_back(std::move(record));
+        }
     }
+    for (QueryStats& stats : queryStats) stats.lastSearch = UINT64_MAX;
+    for (size_t i = 0; i < ring.size(); ++i) queryStats[ring[i].query].lastSearch = i;
+    
+    searchHistory = std::move(ring);
+    searchesRecorded = kept;
+    historyCount = kept;
+    maxHistorySize = size;
+}
+
+void SearchAnalytics::clearHistory() {
+    searchHistory.clear();
+    searchesRecorded = 0;
+    historyCount = 0;
+    queries.clear();
+    labels.clear();
+    queryStats.clear();
+    searchesByHour.fill(0);
+    searchesByWeekday.fill(0);
+    searchesByType.clear();
+    topQueries.clear();
+    trendingQueries.clear();
+    trendEpoch = std::chrono::system_clock::now();
 }
 
 std::string SearchAnalytics::categorizeQuery(const std::string& query) const {
@@ -205,11 +349,43 @@ std::string SearchAnalytics::categorizeQuery(const std::string& query) const {
 }
 
 int SearchAnalytics::getTotalSearches() const {
-    return searchHistory.size();
+    return static_cast<int>(historyCount);
 }
 
 int SearchAnalytics::getUniqueQueriesCount() const {
-    return queryFrequency.size();
+    return static_cast<int>(queries.size());
+}
+
+std::unordered_map<std::string, int> SearchAnalytics::getQueryTypeDistribution() const {
+    std::unordered_map<std::string, int> distribution;
+    for (uint32_t type = 0; type < searchesByType.size(); ++type) {
+        if (searchesByType[type] > 0) distribution[labels.get(type)] = searchesByType[type];
+    }
+    return distribution;
+}
+
+std::vector<std::pair<int, int>> SearchAnalytics::getUsagePatternsByHour() const {
+    std::vector<std::pair<int, int>> pattern;
+    for (int hour = 0; hour < 24; ++hour) pattern.emplace_back(hour, searchesByHour[hour]);
+    return pattern;
+}
+
+std::vector<std::pair<std::string, int>> SearchAnalytics::getUsagePatternsByDay() const {
+    static const char* const DAY_NAMES[7] = {"Sunday", "Monday", "Tuesday", "Wednesday",
+                                             "Thursday", "Friday", "Saturday"};
+    std::vector<std::pair<std::string, int>> pattern;
+    for (int day = 0; day < 7; ++day) pattern.emplace_back(DAY_NAMES[day], searchesByWeekday[day]);
+    return pattern;
+}
+
+std::chrono::system_clock::time_point SearchAnalytics::getFirstSearchDate() const {
+    if (historyCount == 0) return {};
+    return searchHistory[(searchesRecorded - historyCount) % maxHistorySize].timestamp;
+}
+
+std::chrono::system_clock::time_point SearchAnalytics::getLastSearchDate() const {
+    if (historyCount == 0) return {};
+    return searchHistory[(searchesRecorded - 1) % maxHistorySize].timestamp;
 }
 
 std::vector<std::string> SearchAnalytics::getRelatedQueries(const std::string& query) const {
@@ -220,8 +396,9 @@ std::vector<std::string> SearchAnalytics::getRelatedQueries(const std::string& q
     // Find queries with similar words - "People also searched for" functionality
     std::unordered_map<std::string, int> relatedQueries;
     
-    for (const auto& entry : searchHistory) {
-        std::string lowerHistoryQuery = entry.query;
+    for (size_t i = 0; i < historyCount; ++i) {
+        const std::string& historyQuery = queries.get(searchHistory[(searchesRecorded - historyCount + i) % maxHistorySize].query);
+        std::string lowerHistoryQuery = historyQuery;
         std::transform(lowerHistoryQuery.begin(), lowerHistoryQuery.end(), 
                       lowerHistoryQuery.begin(), ::tolower);
         
@@ -242,7 +419,7 @@ std::vector<std::string> SearchAnalytics::getRelatedQueries(const std::string& q
             }
             
             if (commonWords > 0) {
-                relatedQueries[entry.query] += commonWords;
+                relatedQueries[historyQuery] += commonWords;
             }
         }
     }
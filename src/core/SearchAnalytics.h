@@ -7,7 +7,11 @@
 #include <unordered_set>
 #include <chrono>
 #include <queue>
+#include <array>
+#include <ctime>
+#include <cstdint>
 #include "nlohmann/json.hpp"
+#include "VerseTextView.h"
 
 using json = nlohmann::json;
 
@@ -44,12 +48,70 @@ struct VerseOfTheDayEntry {
 };
 
 class SearchAnalytics {
+public:
+    // Queries kept ranked by count and by trend; longer rankings are sorted on demand
+    static constexpr size_t RANKED_QUERIES = 32;
+    // A search's weight in the trend halves every this many hours
+    static constexpr double TREND_HALF_LIFE_HOURS = 24.0;
+
 private:
-    // Search history and patterns
-    std::vector<SearchEntry> searchHistory;
-    std::unordered_map<std::string, int> queryFrequency;
+    // Strings stored once and referred to by dense id
+    struct StringPool {
+        std::vector<std::string> strings;
+        std::unordered_map<std::string, uint32_t> ids;
+        
+        uint32_t intern(const std::string& text);
+        const std::string& get(uint32_t id) const { return strings[id]; }
+        const uint32_t* find(const std::string& text) const;
+        size_t size() const { return strings.size(); }
+        void clear() { strings.clear(); ids.clear(); }
+    };
+    
+    // One search, its strings interned
+    struct HistoryRecord {
+        uint32_t query = 0;       // in queries
+        uint32_t queryType = 0;   // in labels
+        uint32_t translation = 0; // in labels
+        std::chrono::system_clock::time_point timestamp;
+        int resultCount = 0;
+        float executionTime = 0.0f;
+        bool wasSuccessful = false;
+        uint8_t hour = 0;    // local time, for the usage histograms
+        uint8_t weekday = 0; // 0 = Sunday
+        std::vector<uint32_t> selectedResults; // verse keys, in labels
+    };
+    
+    // Per query, indexed by its id in queries
+    struct QueryStats {
+        int count = 0;
+        double trendScore = 0.0; // sum of the searches' weights relative to trendEpoch
+        std::chrono::system_clock::time_point lastSearched;
+        uint64_t lastSearch = 0; // search number of the latest one
+    };
+    
+    // Search history: a ring holding the last maxHistorySize searches, search n in
+    // slot n % maxHistorySize, so recording never moves older entries
+    std::vector<HistoryRecord> searchHistory;
+    uint64_t searchesRecorded = 0;
+    size_t historyCount = 0;
+    StringPool queries;
+    StringPool labels;
+    std::vector<QueryStats> queryStats;
     std::unordered_map<std::string, SearchPattern> searchPatterns;
     
+    // Aggregates kept up to date as searches enter and leave the history
+    std::array<int, 24> searchesByHour{};
+    std::array<int, 7> searchesByWeekday{};
+    std::vector<int> searchesByType; // by label id
+    std::vector<uint32_t> topQueries;      // query ids, most searched first
+    std::vector<uint32_t> trendingQueries; // query ids, highest trend score first
+    std::chrono::system_clock::time_point trendEpoch = std::chrono::system_clock::now();
+    
+    // Local hour and weekday of the current hour, recomputed once it ends
+    std::time_t currentHourEnd = 0;
+    uint8_t currentHour = 0;
+    uint8_t currentWeekday = 0;
+    
     // Verse popularity and access patterns
     std::unordered_map<std::string, PopularVerse> versePopularity;
     std::unordered_map<std::string, int> topicSearchCount;
@@ -72,7 +134,12 @@ private:
     int trendsAnalysisDays = 30;
     
     // Helper methods
-    void pruneOldEntries();
+    void evictRecord(HistoryRecord& record);
+    void updateLocalTime(std::chrono::system_clock::time_point now);
+    double trendWeight(std::chrono::system_clock::time_point now);
+    template <typename Score>
+    static void promote(std::vector<uint32_t>& ranking, uint32_t queryId, Score score);
+    std::vector<std::string> rankedQueries(const std::vector<uint32_t>& ranking, size_t count) const;
     std::string categorizeQuery(const std::string& query) const;
     void updateSearchPatterns(const SearchEntry& entry);
     void initializeSeasonalVerses();
@@ -93,6 +160,8 @@ public:
     std::vector<std::string> getMostPopularVerses(int count = 10) const;
     std::vector<std::string> getTrendingQueries(int days = 7) const;
     std::vector<std::string> getRecentSearches(int count = 20) const;
+    // Searches in the history that found something, counted per query
+    std::vector<std::pair<std::string, uint32_t>> getSuccessfulQueryCounts() const;
     
     // Performance analysis
     std::unordered_map<std::string, double> getAverageSearchTimes() const;
@@ -118,10 +187,13 @@ public:
     void deleteCollection(const std::string& name);
     
     // Verse of the Day system
+    // Chosen from the calendar day, so every caller and every node agrees on it
     std::string getVerseOfTheDay() const;
+    // Today's local date as yyyymmdd
+    static int currentDay();
     std::string getTopicalVerseOfTheDay(const std::string& topic) const;
     std::string getSeasonalVerseOfTheDay() const;
-    std::string getRandomVerse(const std::unordered_map<std::string, std::string>& allVerses) const;
+    std::string getRandomVerse(const VerseTextView& allVerses) const;
     void recordVerseOfTheDay(const std::string& verseKey, const std::string& source, const std::string& theme = "");
     
     // Reading plans
@@ -1,33 +1,85 @@
 #include "SearchCache.h"
+#include "MemoryAccounting.h"
+#include "MetricsRegistry.h"
+#include "Tracer.h"
 #include <algorithm>
+#include <mutex>
 
-size_t SearchCache::generateKey(const std::string& query, const std::string& translation) const {
-    // Combine query and translation into a single hash
-    std::hash<std::string> hasher;
-    size_t query_hash = hasher(query);
-    size_t translation_hash = hasher(translation);
-    
-    // Combine hashes using boost-style hash combining
-    return query_hash ^ (translation_hash + 0x9e3779b9 + (query_hash << 6) + (query_hash >> 2));
-}
-
-void SearchCache::evictOldest() const {
-    if (lru_order.empty()) return;
-    
-    size_t oldest_key = lru_order.back();
-    lru_order.pop_back();
-    cache.erase(oldest_key);
-}
-
-void SearchCache::updateLRU(size_t key) const {
-    // Remove key if it exists in LRU list
-    auto it = std::find(lru_order.begin(), lru_order.end(), key);
-    if (it != lru_order.end()) {
-        lru_order.erase(it);
+namespace {
+Counter& cacheRequests(const char* result) {
+    return MetricsRegistry::shared().counter("versefinder_search_cache_requests_total",
+                                             "Search cache lookups by outcome",
+                                             MetricsRegistry::label("result", result));
+}
+Counter& cacheHits() {
+    static Counter& metric = cacheRequests("hit");
+    return metric;
+}
+Counter& cacheMisses() {
+    static Counter& metric = cacheRequests("miss");
+    return metric;
+}
+}
+
+SearchCache::SearchCache(size_t memory_budget_bytes)
+    : shard_budget(std::max<size_t>(memory_budget_bytes / SHARD_COUNT, 1)) {
+}
+
+SearchCache::~SearchCache() {
+    MemoryAccounting::recordFree(MemoryTag::SEARCH_CACHE, memoryUsage());
+}
+
+std::string SearchCache::makeKey(const std::string& query, const std::string& translation) {
+    // Full key rather than a bare hash so colliding queries never share results
+    std::string key;
+    key.reserve(translation.size() + 1 + query.size());
+    key += translation;
+    key += '\x1f';
+    key += query;
+    return key;
+}
+
+SearchCache::Shard& SearchCache::shardFor(const std::string& key) const {
+    return shards[std::hash<std::string>{}(key) % SHARD_COUNT];
+}
+
+size_t SearchCache::estimateBytes(const std::string& key, const CachedSearchResult& result) {
+    size_t bytes = sizeof(CacheEntry) + key.capacity() + sizeof(void*) * 3; // node + ring slot
+    bytes += result.ids.size() * sizeof(VerseId);
+    bytes += result.scores.size() * sizeof(float);
+    bytes += result.span_offsets.size() * sizeof(uint32_t) + result.spans.size() * sizeof(MatchSpan);
+    bytes += result.message.capacity();
+    return bytes;
+}
+
+void SearchCache::eraseEntry(Shard& shard, std::unordered_map<std::string, CacheEntry>::iterator it) {
+    // O(1) removal from the clock ring: move the last slot into the hole
+    size_t pos = it->second.ring_pos;
+    const std::string* moved = shard.ring.back();
+    shard.ring[pos] = moved;
+    shard.ring.pop_back();
+    if (pos < shard.ring.size()) {
+        shard.entries.find(*moved)->second.ring_pos = pos;
+    }
+
+    shard.bytes -= it->second.bytes;
+    MemoryAccounting::recordFree(MemoryTag::SEARCH_CACHE, it->second.bytes);
+    shard.entries.erase(it);
+}
+
+void SearchCache::evictUntilFits(Shard& shard, size_t incoming_bytes, size_t budget) {
+    while (!shard.ring.empty() && shard.bytes + incoming_bytes > budget) {
+        if (shard.clock_hand >= shard.ring.size()) {
+            shard.clock_hand = 0;
+        }
+
+        auto it = shard.entries.find(*shard.ring[shard.clock_hand]);
+        if (it->second.referenced.exchange(false, std::memory_order_relaxed)) {
+            ++shard.clock_hand; // Second chance
+        } else {
+            eraseEntry(shard, it); // Hand now points at the slot moved into this position
+        }
     }
-    
-    // Add to front (most recently used)
-    lru_order.push_front(key);
 }
 
 bool SearchCache::isExpired(const CacheEntry& entry) const {
@@ -36,77 +88,145 @@ bool SearchCache::isExpired(const CacheEntry& entry) const {
     return age > CACHE_TTL;
 }
 
-bool SearchCache::get(const std::string& query, const std::string& translation, 
-                      std::vector<std::string>& results) const {
-    size_t key = generateKey(query, translation);
-    
-    auto it = cache.find(key);
-    if (it != cache.end()) {
-        // Check if entry is expired
-        if (isExpired(it->second)) {
-            // Remove expired entry
-            auto lru_it = std::find(lru_order.begin(), lru_order.end(), key);
-            if (lru_it != lru_order.end()) {
-                lru_order.erase(lru_it);
-            }
-            cache.erase(it);
-            ++misses;
-            return false;
+uint64_t SearchCache::generation(const std::string& translation) const {
+    std::shared_lock<std::shared_mutex> lock(generation_mutex);
+    auto it = generations.find(translation);
+    return it != generations.end() ? it->second : 0;
+}
+
+void SearchCache::invalidateTranslation(const std::string& translation) {
+    // Stale entries are not walked here; they fail the generation check and age out
+    std::unique_lock<std::shared_mutex> lock(generation_mutex);
+    ++generations[translation];
+}
+
+bool SearchCache::get(const std::string& query, const std::string& translation,
+                      CachedSearchResult& result) const {
+    TRACE_SCOPE("cache_get");
+    std::string key = makeKey(query, translation);
+    Shard& shard = shardFor(key);
+    uint64_t current_generation = generation(translation);
+
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        // Expired and stale entries are left for put() or cleanupExpired() to reclaim
+        if (it != shard.entries.end() && it->second.generation == current_generation &&
+            !isExpired(it->second)) {
+            result = it->second.result;
+            it->second.referenced.store(true, std::memory_order_relaxed);
+            hits.fetch_add(1, std::memory_order_relaxed);
+            cacheHits().add();
+            return true;
         }
-        
-        // Cache hit - update LRU and return results
-        results = it->second.results;
-        updateLRU(key);
-        ++hits;
-        return true;
     }
-    
+
     // Cache miss
-    ++misses;
+    misses.fetch_add(1, std::memory_order_relaxed);
+    cacheMisses().add();
     return false;
 }
 
-void SearchCache::put(const std::string& query, const std::string& translation,
-                      const std::vector<std::string>& results) const {
-    size_t key = generateKey(query, translation);
-    
-    // Check if we need to evict entries to make room
-    while (cache.size() >= MAX_CACHE_SIZE) {
-        evictOldest();
+void SearchCache::put(const std::string& query, const std::string& translation, uint64_t result_generation,
+                      const CachedSearchResult& result) const {
+    TRACE_SCOPE("cache_put");
+    // The translation changed while this result was being computed
+    if (result_generation != generation(translation)) return;
+
+    std::string key = makeKey(query, translation);
+    size_t bytes = estimateBytes(key, result);
+    size_t budget = shard_budget.load(std::memory_order_relaxed);
+    if (bytes > budget) return; // Would evict the whole shard for one entry
+
+    Shard& shard = shardFor(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+    auto existing = shard.entries.find(key);
+    if (existing != shard.entries.end()) {
+        eraseEntry(shard, existing);
     }
-    
+
+    // Evict entries to make room
+    evictUntilFits(shard, bytes, budget);
+
     // Add new entry
-    cache[key] = CacheEntry(results);
-    updateLRU(key);
+    auto inserted = shard.entries.try_emplace(std::move(key)).first;
+    CacheEntry& entry = inserted->second;
+    entry.result = result;
+    entry.generation = result_generation;
+    entry.timestamp = std::chrono::steady_clock::now();
+    entry.bytes = bytes;
+    entry.ring_pos = shard.ring.size();
+    shard.ring.push_back(&inserted->first);
+    shard.bytes += bytes;
+    MemoryAccounting::recordAllocation(MemoryTag::SEARCH_CACHE, bytes);
 }
 
 void SearchCache::clear() {
-    cache.clear();
-    lru_order.clear();
-    hits = 0;
-    misses = 0;
+    for (auto& shard : shards) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.entries.clear();
+        shard.ring.clear();
+        shard.clock_hand = 0;
+        MemoryAccounting::recordFree(MemoryTag::SEARCH_CACHE, shard.bytes);
+        shard.bytes = 0;
+    }
+    hits.store(0, std::memory_order_relaxed);
+    misses.store(0, std::memory_order_relaxed);
+}
+
+void SearchCache::setMemoryBudget(size_t memory_budget_bytes) {
+    size_t budget = std::max<size_t>(memory_budget_bytes / SHARD_COUNT, 1);
+    shard_budget.store(budget, std::memory_order_relaxed);
+    for (auto& shard : shards) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        evictUntilFits(shard, 0, budget);
+    }
+}
+
+size_t SearchCache::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        total += shard.entries.size();
+    }
+    return total;
+}
+
+size_t SearchCache::memoryUsage() const {
+    size_t total = 0;
+    for (const auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        total += shard.bytes;
+    }
+    return total;
 }
 
 double SearchCache::hitRate() const {
-    size_t total = hits + misses;
-    return total > 0 ? static_cast<double>(hits) / total : 0.0;
+    uint64_t hit_count = hits.load(std::memory_order_relaxed);
+    uint64_t total = hit_count + misses.load(std::memory_order_relaxed);
+    return total > 0 ? static_cast<double>(hit_count) / total : 0.0;
 }
 
 void SearchCache::cleanupExpired() {
-    // Collect expired keys
-    std::vector<size_t> expired_keys;
-    for (const auto& pair : cache) {
-        if (isExpired(pair.second)) {
-            expired_keys.push_back(pair.first);
-        }
+    std::unordered_map<std::string, uint64_t> current;
+    {
+        std::shared_lock<std::shared_mutex> lock(generation_mutex);
+        current = generations;
     }
-    
-    // Remove expired entries
-    for (size_t key : expired_keys) {
-        cache.erase(key);
-        auto lru_it = std::find(lru_order.begin(), lru_order.end(), key);
-        if (lru_it != lru_order.end()) {
-            lru_order.erase(lru_it);
+
+    for (auto& shard : shards) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+            auto next = std::next(it);
+            // Translation name is the key prefix up to the separator
+            auto gen_it = current.find(it->first.substr(0, it->first.find('\x1f')));
+            uint64_t live_generation = gen_it != current.end() ? gen_it->second : 0;
+            if (isExpired(it->second) || it->second.generation != live_generation) {
+                // eraseEntry only touches the ring and this node, so next stays valid
+                eraseEntry(shard, it);
+            }
+            it = next;
         }
     }
-}
\ No newline at end of file
+}
@@ -4,58 +4,113 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
-#include <list>
+#include <array>
+#include <atomic>
+#include <shared_mutex>
 #include <chrono>
 #include <functional>
+#include <span>
+#include "VerseStore.h"
 
+// Bytes [begin, end) of a verse's text that a query word matched
+struct MatchSpan {
+    uint32_t begin;
+    uint32_t end;
+};
+
+// Compact cached search result: verse ids are rendered to text on the way out
+struct CachedSearchResult {
+    std::vector<VerseId> ids;
+    std::vector<float> scores; // parallel to ids; empty for unranked searches
+    // Matched words of ids[i] are spans[span_offsets[i] .. span_offsets[i + 1]),
+    // in text order; both empty for searches that do not record them
+    std::vector<uint32_t> span_offsets;
+    std::vector<MatchSpan> spans;
+    std::string message;       // status text (e.g. "No matching verses found.") when ids is empty
+
+    std::span<const MatchSpan> spansOf(size_t i) const {
+        if (i + 1 >= span_offsets.size()) return {};
+        return std::span<const MatchSpan>(spans.data() + span_offsets[i], span_offsets[i + 1] - span_offsets[i]);
+    }
+};
+
+// Concurrent search result cache shared by the UI thread, the incremental
+// search worker and API request threads. Keys are spread over independent
+// shards; lookups take a shard's lock in shared mode, so readers never block
+// each other, and only mark the entry as recently used. Eviction is CLOCK
+// (second chance) against a byte budget rather than an entry count.
+// Entries are tagged with their translation's generation; bumping it with
+// invalidateTranslation() retires that translation's entries only.
 class SearchCache {
 public:
     struct CacheEntry {
-        std::vector<std::string> results;
+        CachedSearchResult result;
+        uint64_t generation = 0;
         std::chrono::steady_clock::time_point timestamp;
-        
-        CacheEntry() = default;
-        CacheEntry(const std::vector<std::string>& res) 
-            : results(res), timestamp(std::chrono::steady_clock::now()) {}
+        size_t bytes = 0;
+        size_t ring_pos = 0;
+        mutable std::atomic<bool> referenced{false};
     };
 
+    static constexpr size_t SHARD_COUNT = 16;
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 32 * 1024 * 1024; // 32 MB
+
 private:
-    mutable std::unordered_map<size_t, CacheEntry> cache;
-    mutable std::list<size_t> lru_order;
-    static constexpr size_t MAX_CACHE_SIZE = 200;
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, CacheEntry> entries;
+        std::vector<const std::string*> ring; // CLOCK order, points at map keys
+        size_t clock_hand = 0;
+        size_t bytes = 0;
+    };
+
+    mutable std::array<Shard, SHARD_COUNT> shards;
+    std::atomic<size_t> shard_budget;
+
+    mutable std::shared_mutex generation_mutex;
+    std::unordered_map<std::string, uint64_t> generations;
     static constexpr std::chrono::minutes CACHE_TTL{30}; // 30 minutes TTL
 
-    size_t generateKey(const std::string& query, const std::string& translation) const;
-    void evictOldest() const;
-    void updateLRU(size_t key) const;
+    static std::string makeKey(const std::string& query, const std::string& translation);
+    Shard& shardFor(const std::string& key) const;
+    static size_t estimateBytes(const std::string& key, const CachedSearchResult& result);
+    static void eraseEntry(Shard& shard, std::unordered_map<std::string, CacheEntry>::iterator it);
+    static void evictUntilFits(Shard& shard, size_t incoming_bytes, size_t budget);
     bool isExpired(const CacheEntry& entry) const;
 
+    // Statistics tracking
+    mutable std::atomic<uint64_t> hits{0};
+    mutable std::atomic<uint64_t> misses{0};
+
 public:
-    SearchCache() = default;
-    ~SearchCache() = default;
+    explicit SearchCache(size_t memory_budget_bytes = DEFAULT_MEMORY_BUDGET);
+    ~SearchCache();
 
     // Non-copyable
     SearchCache(const SearchCache&) = delete;
     SearchCache& operator=(const SearchCache&) = delete;
 
-    bool get(const std::string& query, const std::string& translation, 
-             std::vector<std::string>& results) const;
-    
-    void put(const std::string& query, const std::string& translation,
-             const std::vector<std::string>& results) const;
-    
+    // Current generation of a translation; read it before searching and pass it to put()
+    uint64_t generation(const std::string& translation) const;
+    // Retire every cached entry of one translation, e.g. after it is loaded or replaced
+    void invalidateTranslation(const std::string& translation);
+
+    bool get(const std::string& query, const std::string& translation,
+             CachedSearchResult& result) const;
+
+    void put(const std::string& query, const std::string& translation, uint64_t result_generation,
+             const CachedSearchResult& result) const;
+
     void clear();
-    
+
     // Statistics and management
-    size_t size() const { return cache.size(); }
-    size_t maxSize() const { return MAX_CACHE_SIZE; }
+    size_t size() const;
+    size_t memoryUsage() const;
+    size_t memoryBudget() const { return shard_budget.load(std::memory_order_relaxed) * SHARD_COUNT; }
+    // Shrinking evicts down to the new budget at once, e.g. to shed memory under pressure
+    void setMemoryBudget(size_t memory_budget_bytes);
     double hitRate() const;
     void cleanupExpired();
-
-private:
-    // Statistics tracking
-    mutable size_t hits = 0;
-    mutable size_t misses = 0;
 };
 
-#endif // SEARCHCACHE_H
\ No newline at end of file
+#endif // SEARCHCACHE_H
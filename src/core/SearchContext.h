@@ -0,0 +1,80 @@
+#ifndef SEARCHCONTEXT_H
+#define SEARCHCONTEXT_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <memory>
+
+// Limits for one search call. Scan loops poll shouldStop() every
+// CHECK_INTERVAL items and return whatever they have ranked so far once the
+// caller cancels or the deadline passes; interrupted() then reports that the
+// results are partial. Offset and max results select one page of the ranked
+// matches, so work can stop once resultEnd() of them are known. A default
+// context never stops a search.
+class SearchContext {
+public:
+    using Clock = std::chrono::steady_clock;
+    using CancelToken = std::shared_ptr<std::atomic<bool>>;
+
+    static constexpr size_t UNLIMITED = std::numeric_limits<size_t>::max();
+    static constexpr size_t CHECK_INTERVAL = 256; // items scanned between polls
+
+private:
+    CancelToken cancel_token;
+    Clock::time_point deadline = Clock::time_point::max();
+    size_t max_results = UNLIMITED;
+    size_t result_offset = 0;
+    mutable std::atomic<bool> stopped{false}; // shards of one search poll it from several threads
+
+public:
+    SearchContext() = default;
+    SearchContext(const SearchContext& other)
+        : cancel_token(other.cancel_token), deadline(other.deadline), max_results(other.max_results),
+          result_offset(other.result_offset), stopped(other.stopped.load(std::memory_order_relaxed)) {}
+    SearchContext& operator=(const SearchContext& other) {
+        cancel_token = other.cancel_token;
+        deadline = other.deadline;
+        max_results = other.max_results;
+        result_offset = other.result_offset;
+        stopped.store(other.stopped.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+
+    static CancelToken makeCancelToken() { return std::make_shared<std::atomic<bool>>(false); }
+
+    // Setters return *this so a context can be built in one expression
+    SearchContext& setCancelToken(CancelToken token) { cancel_token = std::move(token); return *this; }
+    SearchContext& setDeadline(Clock::time_point when) { deadline = when; return *this; }
+    SearchContext& setTimeout(std::chrono::milliseconds timeout) { deadline = Clock::now() + timeout; return *this; }
+    SearchContext& setMaxResults(size_t limit) { max_results = limit; return *this; }
+    SearchContext& setOffset(size_t offset) { result_offset = offset; return *this; }
+
+    size_t maxResults() const { return max_results; }
+    size_t offset() const { return result_offset; }
+    // Matches to rank before the page is complete: offset plus limit, saturating
+    size_t resultEnd() const {
+        return max_results > UNLIMITED - result_offset ? UNLIMITED : result_offset + max_results;
+    }
+    // count is every match found so far, skipped ones included
+    bool limitReached(size_t count) const { return count >= resultEnd(); }
+
+    // True once cancelled or past the deadline; stays true for the rest of the search
+    bool shouldStop() const {
+        if (stopped.load(std::memory_order_relaxed)) return true;
+        if ((cancel_token && cancel_token->load(std::memory_order_relaxed)) ||
+            (deadline != Clock::time_point::max() && Clock::now() >= deadline)) {
+            stopped.store(true, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+    // Poll only on every CHECK_INTERVAL-th item, keeping the clock out of tight loops
+    bool shouldStopAt(size_t index) const {
+        return index % CHECK_INTERVAL == 0 && shouldStop();
+    }
+    bool interrupted() const { return stopped.load(std::memory_order_relaxed); }
+};
+
+#endif // SEARCHCONTEXT_H
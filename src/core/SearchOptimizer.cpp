@@ -1,4 +1,7 @@
 #include "SearchOptimizer.h"
+#include "Tracer.h"
+#include "TextFolding.h"
+#include "TextKernels.h"
 #include <algorithm>
 #include <cctype>
 
@@ -88,64 +91,57 @@ std::vector<std::vector<std::string>> SearchOptimizer::sortTokenListsBySize(
     return sorted_lists;
 }
 
-std::string SearchOptimizer::preprocessToken(const std::string& token) {
+std::string SearchOptimizer::preprocessToken(std::string_view token) {
     std::string result;
     result.reserve(token.size());
-    
-    for (char c : token) {
-        if (std::isalnum(c)) {
-            result += std::tolower(c);
-        }
-    }
-    
+    TextFolding::forEachWord(token, [&result](std::string_view word) { result += word; });
     return result;
 }
 
-std::vector<std::string> SearchOptimizer::optimizedTokenize(const std::string& text) {
+std::vector<std::string> SearchOptimizer::optimizedTokenize(std::string_view text) {
+    TRACE_SCOPE("tokenize");
     std::vector<std::string> tokens;
     tokens.reserve(text.size() / 5); // Estimate average token length
     
-    std::string token;
-    token.reserve(20); // Reserve space for typical word length
-    
-    for (char c : text) {
-        if (std::isalnum(c)) {
-            token += std::tolower(c);
-        } else if (!token.empty()) {
-            tokens.push_back(std::move(token));
-            token.clear();
-            token.reserve(20);
-        }
-    }
-    
-    if (!token.empty()) {
-        tokens.push_back(std::move(token));
-    }
-    
+    TextFolding::forEachWord(text, [&tokens](std::string_view word) { tokens.emplace_back(word); });
     return tokens;
 }
 
-bool SearchOptimizer::verifyPhraseMatch(const std::string& text, const std::string& query) {
-    // Convert both to lowercase for comparison
-    std::string lower_text = text;
-    std::string lower_query = query;
-    
-    std::transform(lower_text.begin(), lower_text.end(), lower_text.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
-    std::transform(lower_query.begin(), lower_query.end(), lower_query.begin(),
-                   [](unsigned char c) { return std::tolower(c); });
-    
-    size_t pos = lower_text.find(lower_query);
-    if (pos == std::string::npos) {
+bool SearchOptimizer::verifyPhraseMatch(std::string_view text, std::string_view query) {
+    if (query.empty() || query.size() > text.size()) {
         return false;
     }
     
-    // Verify word boundaries for exact phrase matching
-    bool word_start = (pos == 0 || !std::isalnum(lower_text[pos - 1]));
-    bool word_end = (pos + lower_query.length() >= lower_text.length() || 
-                     !std::isalnum(lower_text[pos + lower_query.length()]));
-    
-    return word_start && word_end;
+    // Outside ASCII, compare folded words so accents and case don't matter
+    if (!TextKernels::isAscii(text) || !TextKernels::isAscii(query)) {
+        std::string words = " " + TextFolding::foldWords(text) + " ";
+        std::string phrase = TextFolding::foldWords(query);
+        return !phrase.empty() && words.find(" " + phrase + " ") != std::string::npos;
+    }
+
+    // Case-insensitive search in place, trying each occurrence until one sits on word boundaries
+    for (size_t pos = TextKernels::findIgnoreCase(text, query); pos != std::string_view::npos;
+         pos = TextKernels::findIgnoreCase(text, query, pos + 1)) {
+        size_t end = pos + query.size();
+        bool word_start = pos == 0 || !TextKernels::isWordChar(text[pos - 1]);
+        bool word_end = end >= text.size() || !TextKernels::isWordChar(text[end]);
+        if (word_start && word_end) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SearchOptimizer::verifyPhraseMatch(const VerseStore& store, VerseId id, std::string_view query) {
+    // A word no translation has ever held cannot be in the verse
+    std::vector<TermId> phrase;
+    bool known = true;
+    TextFolding::forEachWord(query, [&](std::string_view word) {
+        TermId term = TermDictionary::shared().find(word);
+        known = known && term != TermDictionary::NO_TERM;
+        phrase.push_back(term);
+    });
+    return known && store.containsPhrase(id, phrase);
 }
 
 size_t SearchOptimizer::estimateIntersectionSize(
@@ -195,4 +191,110 @@ std::vector<std::string> SearchOptimizer::multiWayIntersection(
 bool SearchOptimizer::binarySearchInVector(const std::vector<std::string>& vec, 
                                           const std::string& target) {
     return std::binary_search(vec.begin(), vec.end(), target);
-}
\ No newline at end of file
+}
+PostingList SearchOptimizer::intersectPostings(std::vector<const PostingList*> lists, const VerseSet* within) {
+    TRACE_SCOPE("intersect");
+    if (lists.empty() || (within && within->empty())) {
+        return {};
+    }
+    
+    for (const PostingList* list : lists) {
+        if (!list || list->empty()) {
+            return {}; // Early termination if any list is empty
+        }
+    }
+    
+    // Rarest token first keeps every intermediate result as small as possible
+    std::sort(lists.begin(), lists.end(),
+              [](const PostingList* a, const PostingList* b) { return a->size() < b->size(); });
+    
+    if (lists.size() == 1 && !within) {
+        return *lists[0];
+    }
+    
+    // The result only ever shrinks, so one buffer sized for the rarest list
+    // holds every step: each later list is intersected into it in place
+    PostingList result(lists[0]->size());
+    size_t count = 0;
+    size_t next = 1;
+    if (within) {
+        count = within->filter(lists[0]->data(), lists[0]->size(), result.data());
+    } else {
+        count = intersectSorted(lists[0]->data(), lists[0]->size(), *lists[1], result.data());
+        next = 2;
+    }
+    for (size_t i = next; i < lists.size() && count > 0; ++i) {
+        count = intersectSorted(result.data(), count, *lists[i], result.data());
+    }
+    result.resize(count);
+    
+    return result;
+}
+
+PostingList SearchOptimizer::intersectTwoPostings(const PostingList& list1, const PostingList& list2) {
+    const PostingList& small_list = list1.size() <= list2.size() ? list1 : list2;
+    const PostingList& large_list = list1.size() <= list2.size() ? list2 : list1;
+    
+    PostingList result(small_list.size());
+    result.resize(intersectSorted(small_list.data(), small_list.size(), large_list, result.data()));
+    return result;
+}
+
+size_t SearchOptimizer::intersectSorted(const VerseId* ids, size_t count, const PostingList& other, VerseId* out) {
+    return count * GALLOP_RATIO < other.size() ? gallopSorted(ids, count, other, out)
+                                               : mergeSorted(ids, count, other, out);
+}
+
+size_t SearchOptimizer::mergeSorted(const VerseId* ids, size_t count, const PostingList& other, VerseId* out) {
+    // Writes never pass reads, so out may be ids itself. Every step writes the
+    // candidate and keeps it only on a match, and advances whichever side is
+    // behind, so the loop compiles to conditional moves: which way two ids
+    // compare is as good as random and would mispredict half the time.
+    const VerseId* others = other.data();
+    const size_t other_count = other.size();
+    size_t written = 0;
+    size_t i = 0, j = 0;
+    while (i < count && j < other_count) {
+        const VerseId a = ids[i];
+        const VerseId b = others[j];
+        out[written] = a;
+        written += a == b;
+        i += a <= b;
+        j += b <= a;
+    }
+    return written;
+}
+
+size_t SearchOptimizer::gallopSorted(const VerseId* ids, size_t count, const PostingList& other, VerseId* out) {
+    size_t written = 0;
+    size_t pos = 0;
+    for (size_t i = 0; i < count; ++i) {
+        VerseId id = ids[i];
+        pos = gallopTo(other, pos, id);
+        if (pos == other.size()) break;
+        if (other[pos] == id) {
+            out[written++] = id;
+            ++pos;
+        }
+    }
+    return written;
+}
+
+size_t SearchOptimizer::gallopTo(const PostingList& list, size_t from, VerseId target) {
+    if (from >= list.size() || list[from] >= target) {
+        return from;
+    }
+    
+    // Double the step until we overshoot, then binary search the last gap
+    size_t step = 1;
+    size_t low = from;
+    size_t high = from + step;
+    while (high < list.size() && list[high] < target) {
+        low = high;
+        step <<= 1;
+        high = from + step;
+    }
+    high = std::min(high + 1, list.size());
+    
+    return std::lower_bound(list.begin() + low + 1, list.begin() + high, target) - list.begin();
+}
@@ -2,9 +2,12 @@
 #define SEARCHOPTIMIZER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <algorithm>
+#include "InvertedIndex.h"
+#include "VerseSet.h"
 
 class SearchOptimizer {
 public:
@@ -22,16 +25,25 @@ public:
         const std::vector<std::vector<std::string>>& token_lists);
     
     // Pre-process tokens to lowercase during indexing
-    static std::string preprocessToken(const std::string& token);
+    static std::string preprocessToken(std::string_view token);
     
     // Optimized tokenization with reserved capacity
-    static std::vector<std::string> optimizedTokenize(const std::string& text);
+    static std::vector<std::string> optimizedTokenize(std::string_view text);
     
-    // Check if query contains phrase and verify word boundaries
-    static bool verifyPhraseMatch(const std::string& text, const std::string& query);
+    // Check if text contains query, ignoring case, on word boundaries; copies neither
+    static bool verifyPhraseMatch(std::string_view text, std::string_view query);
+    // The same for a stored verse, comparing the query's term ids with the verse's
+    static bool verifyPhraseMatch(const VerseStore& store, VerseId id, std::string_view query);
     
     // Calculate estimated result size for early termination
     static size_t estimateIntersectionSize(const std::vector<std::vector<std::string>>& token_lists);
+    
+    // Intersect sorted verse id posting lists, smallest list first. With within,
+    // only its members are kept: the rarest list is filtered before any merge.
+    static PostingList intersectPostings(std::vector<const PostingList*> lists, const VerseSet* within = nullptr);
+    
+    // Intersect two sorted posting lists, galloping through the longer one when sizes are skewed
+    static PostingList intersectTwoPostings(const PostingList& list1, const PostingList& list2);
 
 private:
     // Helper for multi-way intersection using iterative approach
@@ -41,8 +53,22 @@ private:
     // Binary search optimization for large lists
     static bool binarySearchInVector(const std::vector<std::string>& vec, const std::string& target);
     
+    // Write the ids also in other to out and return how many; out may be ids.
+    // Picks one of the walks below once for the pair of lists.
+    static size_t intersectSorted(const VerseId* ids, size_t count, const PostingList& other, VerseId* out);
+    // Similar sizes: both lists in step, without a data-dependent branch
+    static size_t mergeSorted(const VerseId* ids, size_t count, const PostingList& other, VerseId* out);
+    // Skewed sizes: galloping through other, never revisiting skipped ranges
+    static size_t gallopSorted(const VerseId* ids, size_t count, const PostingList& other, VerseId* out);
+    
+    // Exponential then binary search for the first element >= target at or after from
+    static size_t gallopTo(const PostingList& list, size_t from, VerseId target);
+    
     // Threshold for switching to binary search
     static constexpr size_t BINARY_SEARCH_THRESHOLD = 100;
+    
+    // Size ratio above which galloping beats a linear merge
+    static constexpr size_t GALLOP_RATIO = 8;
 };
 
 #endif // SEARCHOPTIMIZER_H
\ No newline at end of file
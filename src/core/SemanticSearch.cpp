@@ -1,4 +1,5 @@
 #include "SemanticSearch.h"
+#include "RegexCache.h"
 #include <algorithm>
 #include <sstream>
 #include <iostream>
@@ -8,7 +9,6 @@ SemanticSearch::SemanticSearch() {
     initializeTopicKeywords();
     initializeQuestionPatterns();
     initializeContextualSituations();
-    initializeBooleanPatterns();
     initializeStopWords();
     initializeSynonyms();
 }
@@ -64,6 +64,11 @@ void SemanticSearch::initializeQuestionPatterns() {
         {"bible.*strength", "strength"},
         {"scripture.*", "topical"}
     };
+    
+    compiledQuestionPatterns.clear();
+    for (const auto& pattern : questionPatterns) {
+        compiledQuestionPatterns.emplace_back(pattern.first);
+    }
 }
 
 void SemanticSearch::initializeContextualSituations() {
@@ -89,21 +94,18 @@ void SemanticSearch::initializeContextualSituations() {
     };
 }
 
-void SemanticSearch::initializeBooleanPatterns() {
-    booleanPatterns = {
-        std::regex(R"(\b(AND|and|\&\&|\+)\b)"),
-        std::regex(R"(\b(OR|or|\|\|)\b)"),
-        std::regex(R"(\b(NOT|not|\!|-)\b)")
-    };
-}
-
-void SemanticSearch::initializeStopWords() {
-    stopWords = {
+const std::unordered_set<std::string>& SemanticSearch::defaultStopWords() {
+    static const std::unordered_set<std::string> words = {
         "a", "an", "and", "are", "as", "at", "be", "by", "for", "from", "has", "he", "in", "is", "it",
         "its", "of", "on", "that", "the", "to", "was", "will", "with", "the", "this", "these", "those",
         "what", "where", "when", "why", "how", "who", "which", "does", "do", "did", "can", "could",
         "should", "would", "may", "might", "must", "shall", "about", "up", "out", "if", "no", "all"
     };
+    return words;
+}
+
+void SemanticSearch::initializeStopWords() {
+    stopWords = defaultStopWords();
 }
 
 void SemanticSearch::initializeSynonyms() {
@@ -151,40 +153,25 @@ std::vector<std::string> SemanticSearch::tokenizeAndFilter(const std::string& qu
 }
 
 std::string SemanticSearch::normalizeQuery(const std::string& query) const {
-    std::string normalized = query;
-    std::transform(normalized.begin(), normalized.end(), normalized.begin(), ::tolower);
-    
-    // Remove extra whitespace
-    std::regex ws_re("\\s+");
-    normalized = std::regex_replace(normalized, ws_re, " ");
-    
-    // Trim leading/trailing whitespace
-    normalized.erase(0, normalized.find_first_not_of(" \t\n\r"));
-    normalized.erase(normalized.find_last_not_of(" \t\n\r") + 1);
-    
-    return normalized;
+    return QueryLexer::normalize(query);
 }
 
 QueryIntent::Type SemanticSearch::detectQueryType(const std::string& query) const {
     std::string normalized = normalizeQuery(query);
     
     // Check for biblical reference pattern
-    std::regex ref_pattern(R"(\b\w+\s+\d+:\d+\b)");
-    if (std::regex_search(normalized, ref_pattern)) {
+    if (QueryLexer::containsReference(normalized)) {
         return QueryIntent::REFERENCE_LOOKUP;
     }
     
     // Check for boolean operators
-    for (const auto& pattern : booleanPatterns) {
-        if (std::regex_search(normalized, pattern)) {
-            return QueryIntent::BOOLEAN_SEARCH;
-        }
+    if (QueryLexer::containsOperator(normalized)) {
+        return QueryIntent::BOOLEAN_SEARCH;
     }
     
     // Check for question patterns
-    for (const auto& pattern : questionPatterns) {
-        std::regex question_regex(pattern.first, std::regex_constants::icase);
-        if (std::regex_search(normalized, question_regex)) {
+    for (const auto& pattern : compiledQuestionPatterns) {
+        if (pattern.matches(normalized)) {
             return QueryIntent::QUESTION_BASED;
         }
     }
@@ -243,22 +230,8 @@ std::vector<std::string> SemanticSearch::extractTopicsFromQuery(const std::strin
 }
 
 std::string SemanticSearch::extractSubjectFromQuestion(const std::string& query) const {
-    std::string normalized = normalizeQuery(query);
-    
-    // Look for "about X" patterns
-    std::regex about_pattern(R"(about\s+(\w+(?:\s+\w+)?))");
-    std::smatch match;
-    if (std::regex_search(normalized, match, about_pattern)) {
-        return match[1].str();
-    }
-    
-    // Look for other question patterns
-    std::regex question_pattern(R"((?:what|how|where|when|why).*?(\w+(?:\s+\w+)?))");
-    if (std::regex_search(normalized, match, question_pattern)) {
-        return match[1].str();
-    }
-    
-    return "";
+    // "about X", else the words following a question word
+    return QueryLexer::questionSubject(normalizeQuery(query));
 }
 
 std::vector<std::string> SemanticSearch::expandWithSynonyms(const std::vector<std::string>& keywords) const {
@@ -278,6 +251,19 @@ std::vector<std::string> SemanticSearch::expandWithSynonyms(const std::vector<st
     return expanded;
 }
 
+const char* QueryIntent::typeName(Type type) {
+    switch (type) {
+        case REFERENCE_LOOKUP: return "reference";
+        case KEYWORD_SEARCH: return "keyword";
+        case TOPICAL_SEARCH: return "topical";
+        case QUESTION_BASED: return "question";
+        case CONTEXTUAL_REQUEST: return "contextual";
+        case BOOLEAN_SEARCH: return "boolean";
+        case SEMANTIC_SEARCH: return "semantic";
+    }
+    return "unknown";
+}
+
 QueryIntent SemanticSearch::parseQuery(const std::string& query) const {
     QueryIntent intent;
     intent.originalQuery = query;
@@ -370,62 +356,53 @@ SemanticSearch::BooleanQuery SemanticSearch::parseBooleanQuery(const std::string
     std::string workingQuery = query;
     std::transform(workingQuery.begin(), workingQuery.end(), workingQuery.begin(), ::tolower);
     
-    // Split by NOT operators first
-    std::regex not_pattern(R"(\s+(not|!|-)\s+)");
-    std::vector<std::string> not_split;
-    std::sregex_token_iterator iter(workingQuery.begin(), workingQuery.end(), not_pattern, -1);
-    std::sregex_token_iterator end;
+    // Operators count only between words; the first NOT ends the included terms
+    std::vector<std::string_view> words = QueryLexer::words(workingQuery);
+    auto operatorAt = [&](size_t i) {
+        if (i == 0 || i + 1 == words.size()) return QueryLexer::Operator::NONE;
+        return QueryLexer::classifyOperator(words[i]);
+    };
     
-    for (; iter != end; ++iter) {
-        std::string part = *iter;
-        if (!part.empty()) {
-            not_split.push_back(part);
+    size_t notStart = words.size();
+    bool hasOr = false;
+    for (size_t i = 0; i < words.size(); ++i) {
+        QueryLexer::Operator op = operatorAt(i);
+        if (op == QueryLexer::Operator::NOT) {
+            notStart = i;
+            break;
         }
+        if (op == QueryLexer::Operator::OR) hasOr = true;
     }
     
-    // Process each part for AND/OR
-    for (size_t i = 0; i < not_split.size(); ++i) {
-        std::string part = not_split[i];
-        
-        if (i == 0) {
-            // First part contains AND/OR terms
-            std::regex and_pattern(R"(\s+(and|&|&&|\+)\s+)");
-            std::regex or_pattern(R"(\s+(or|\||\|\|)\s+)");
-            
-            // Split by OR first
-            std::sregex_token_iterator or_iter(part.begin(), part.end(), or_pattern, -1);
-            for (; or_iter != end; ++or_iter) {
-                std::string or_part = *or_iter;
-                if (!or_part.empty()) {
-                    // Check if this part contains AND
-                    std::sregex_token_iterator and_iter(or_part.begin(), or_part.end(), and_pattern, -1);
-                    bool hasAnd = false;
-                    for (; and_iter != end; ++and_iter) {
-                        std::string and_part = *and_iter;
-                        if (!and_part.empty()) {
-                            std::vector<std::string> tokens = tokenizeAndFilter(and_part);
-                            for (const auto& token : tokens) {
-                                boolQuery.andTerms.push_back(token);
-                            }
-                            hasAnd = true;
-                        }
-                    }
-                    
-                    if (!hasAnd) {
-                        std::vector<std::string> tokens = tokenizeAndFilter(or_part);
-                        for (const auto& token : tokens) {
-                            boolQuery.orTerms.push_back(token);
-                        }
-                    }
-                }
-            }
-        } else {
-            // Subsequent parts are NOT terms
-            std::vector<std::string> tokens = tokenizeAndFilter(part);
-            for (const auto& token : tokens) {
-                boolQuery.notTerms.push_back(token);
+    auto addTerms = [&](size_t begin, size_t end, std::vector<std::string>& terms) {
+        for (size_t i = begin; i < end; ++i) {
+            if (operatorAt(i) != QueryLexer::Operator::NONE) continue;
+            for (auto& token : tokenizeAndFilter(std::string(words[i]))) {
+                terms.push_back(std::move(token));
             }
         }
+    };
+    
+    // Without OR everything before NOT is required; with it, OR-separated groups
+    // of a single term are alternatives and groups joined by AND stay required
+    if (!hasOr) {
+        addTerms(0, notStart, boolQuery.andTerms);
+    } else {
+        size_t groupStart = 0;
+        bool groupHasAnd = false;
+        for (size_t i = 0; i <= notStart; ++i) {
+            QueryLexer::Operator op = i < notStart ? operatorAt(i) : QueryLexer::Operator::OR;
+            if (op == QueryLexer::Operator::AND) groupHasAnd = true;
+            if (op != QueryLexer::Operator::OR) continue;
+            addTerms(groupStart, i, groupHasAnd ? boolQuery.andTerms : boolQuery.orTerms);
+            groupStart = i + 1;
+            groupHasAnd = false;
+        }
+    }
+    
+    // Later NOTs just separate further excluded terms
+    if (notStart < words.size()) {
+        addTerms(notStart + 1, words.size(), boolQuery.notTerms);
     }
     
     return boolQuery;
@@ -522,47 +499,17 @@ std::vector<std::string> SemanticSearch::searchWithWildcards([[maybe_unused]] co
 std::vector<std::string> SemanticSearch::searchWithRegex(const std::string& regexPattern) const {
     std::vector<std::string> results;
     
-    try {
-        std::regex regex(regexPattern, std::regex_constants::icase);
-        
-        // This would search through all verses with the regex
-        // For now, return empty as this would need access to verse data
-        
-    } catch (const std::regex_error& e) {
-        // Invalid regex pattern
-    }
+    // Compiled once and kept for the searches that follow
+    RegexCache::Compiled compiled = RegexCache::shared().get(regexPattern);
+    if (!compiled.regex) return results;
+    
+    // This would search through all verses with the regex
+    // For now, return empty as this would need access to verse data
     
     return results;
 }
 
 bool SemanticSearch::matchesWildcardPattern(const std::string& text, const std::string& pattern) const {
     // Simple wildcard matching: * matches any sequence, ? matches any single character
-    std::string regexPattern = pattern;
-    
-    // Escape special regex characters except * and ?
-    std::string escaped = "";
-    for (char c : regexPattern) {
-        switch (c) {
-            case '.': case '^': case '$': case '+': case '{': case '}':
-            case '[': case ']': case '(': case ')': case '|': case '\\':
-                escaped += "\\";
-                escaped += c;
-                break;
-            case '*':
-                escaped += ".*";
-                break;
-            case '?':
-                escaped += ".";
-                break;
-            default:
-                escaped += c;
-        }
-    }
-    
-    try {
-        std::regex wildcardRegex(escaped, std::regex_constants::icase);
-        return std::regex_search(text, wildcardRegex);
-    } catch (const std::regex_error& e) {
-        return false;
-    }
+    return QueryLexer::matchesWildcard(text, pattern);
 }
\ No newline at end of file
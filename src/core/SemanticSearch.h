@@ -5,8 +5,8 @@
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
-#include <regex>
 #include "nlohmann/json.hpp"
+#include "QueryLexer.h"
 
 using json = nlohmann::json;
 
@@ -27,6 +27,9 @@ struct QueryIntent {
     std::vector<std::string> topics;
     std::string subject;
     double confidence;
+    
+    // "reference", "keyword", "topical", ... for logs and explain output
+    static const char* typeName(Type type);
 };
 
 struct TopicScore {
@@ -50,13 +53,11 @@ private:
     
     // Common question patterns and their mapping to topics
     std::unordered_map<std::string, std::string> questionPatterns;
+    std::vector<QueryLexer::Pattern> compiledQuestionPatterns;
     
     // Contextual situation mapping
     std::unordered_map<std::string, std::vector<std::string>> contextualSituations;
     
-    // Boolean operator patterns
-    std::vector<std::regex> booleanPatterns;
-    
     // Natural language processing helpers
     std::unordered_set<std::string> stopWords;
     std::unordered_map<std::string, std::vector<std::string>> synonyms;
@@ -68,7 +69,6 @@ private:
     void initializeTopicKeywords();
     void initializeQuestionPatterns();
     void initializeContextualSituations();
-    void initializeBooleanPatterns();
     void initializeStopWords();
     void initializeSynonyms();
     
@@ -89,6 +89,9 @@ private:
 
 public:
     SemanticSearch();
+
+    // Words too common to carry meaning in a query; the keyword index shares this list
+    static const std::unordered_set<std::string>& defaultStopWords();
     
     // Main semantic search interface
     QueryIntent parseQuery(const std::string& query) const;
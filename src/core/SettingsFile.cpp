@@ -0,0 +1,110 @@
+#include "SettingsFile.h"
+#include "TaskScheduler.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+SettingsFile::SettingsFile(std::string path, Snapshot snapshot, Clock::duration debounce)
+    : path(std::move(path)), snapshot(std::move(snapshot)), debounce(debounce) {
+}
+
+SettingsFile::~SettingsFile() {
+    flush();
+}
+
+void SettingsFile::markDirty() {
+    dirty = true;
+    last_change = Clock::now();
+}
+
+void SettingsFile::poll() {
+    if (dirty && Clock::now() - last_change >= debounce) {
+        dirty = false;
+        enqueue(snapshot());
+    }
+}
+
+void SettingsFile::save() {
+    dirty = false;
+    enqueue(snapshot());
+}
+
+bool SettingsFile::flush() {
+    if (dirty) {
+        dirty = false;
+        enqueue(snapshot());
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return !writing && !queued; });
+    return last_error.empty();
+}
+
+std::string SettingsFile::getLastError() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return last_error;
+}
+
+void SettingsFile::enqueue(nlohmann::json document) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queued = std::move(document);
+        if (writing) {
+            return; // the running writer picks it up next
+        }
+        writing = true;
+    }
+    TaskScheduler::shared().post([this]() { writeQueued(); }, TaskPriority::BACKGROUND);
+}
+
+void SettingsFile::writeQueued() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (queued) {
+        nlohmann::json document = std::move(*queued);
+        queued.reset();
+        lock.unlock();
+
+        std::string error;
+        try {
+            writeFile(document.dump(4), error);
+        } catch (const std::exception& e) {
+            error = e.what(); // invalid UTF-8 in a string, say
+        }
+        if (!error.empty()) {
+            std::cerr << "Failed to save settings to " << path << ": " << error << std::endl;
+        }
+
+        lock.lock();
+        last_error = std::move(error);
+    }
+    writing = false;
+    idle.notify_all();
+}
+
+// Written beside the file and renamed over it, so a crash never leaves half a file
+bool SettingsFile::writeFile(const std::string& contents, std::string& error) const {
+    std::filesystem::path target(path);
+    std::error_code ec;
+    if (target.has_parent_path()) {
+        std::filesystem::create_directories(target.parent_path(), ec);
+    }
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            error = "cannot open " + temp_path;
+            return false;
+        }
+        file << contents;
+        if (!file.flush()) {
+            error = "cannot write " + temp_path;
+            return false;
+        }
+    }
+    std::filesystem::rename(temp_path, target, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        error = ec.message();
+        return false;
+    }
+    return true;
+}
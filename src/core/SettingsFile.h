@@ -0,0 +1,74 @@
+#ifndef SETTINGS_FILE_H
+#define SETTINGS_FILE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include "nlohmann/json.hpp"
+
+// A settings document whose in-memory copy is the authority and whose file
+// trails it. Changes only mark it dirty; once it has gone DEBOUNCE without
+// another, poll() takes one snapshot and hands it to the TaskScheduler,
+// which writes it beside the file and renames it over, so a crash never
+// leaves half a file. Dragging a slider through a hundred values costs one
+// write, and no change costs disk I/O on the thread that made it.
+//
+// The snapshot is taken on the owner's thread, the one calling markDirty()
+// and poll(), so it may read the settings without a lock. Writes to the file
+// happen one at a time, newest last; a snapshot taken while one is running
+// replaces any still waiting behind it.
+class SettingsFile {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Snapshot = std::function<nlohmann::json()>;
+
+    static constexpr auto DEBOUNCE = std::chrono::milliseconds(500);
+
+    SettingsFile(std::string path, Snapshot snapshot, Clock::duration debounce = DEBOUNCE);
+    // Flushes
+    ~SettingsFile();
+
+    SettingsFile(const SettingsFile&) = delete;
+    SettingsFile& operator=(const SettingsFile&) = delete;
+
+    // Owner's thread only
+    void markDirty();
+    // Call each frame (or tick); snapshots once the changes have settled
+    void poll();
+    // Snapshots now, without waiting for the changes to settle; the write
+    // still happens in the background
+    void save();
+    // Snapshots now if dirty and waits for the file to hold it. For shutdown
+    // and for an explicit save.
+    bool flush();
+    bool isDirty() const { return dirty; }
+
+    const std::string& getPath() const { return path; }
+    // From the last write; empty if it succeeded
+    std::string getLastError() const;
+
+private:
+    std::string path;
+    Snapshot snapshot;
+    Clock::duration debounce;
+
+    // Owner's thread
+    bool dirty = false;
+    Clock::time_point last_change;
+
+    // Shared with the writer
+    mutable std::mutex mutex;
+    std::condition_variable idle;
+    std::optional<nlohmann::json> queued; // the next document to write
+    bool writing = false;
+    std::string last_error;
+
+    void enqueue(nlohmann::json document);
+    void writeQueued();
+    bool writeFile(const std::string& contents, std::string& error) const;
+};
+
+#endif // SETTINGS_FILE_H
@@ -0,0 +1,231 @@
+#include "StartupGraph.h"
+#include <exception>
+#include <iostream>
+
+StartupGraph::StartupGraph(TaskScheduler& scheduler) : scheduler(scheduler) {}
+
+StartupGraph::~StartupGraph() {
+    cancel();
+}
+
+void StartupGraph::add(const std::string& name, std::vector<std::string> after, Task task,
+                       TaskPriority priority, Affinity affinity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (started || by_name.count(name)) {
+        std::cerr << "Startup task " << name << " ignored: " << (started ? "graph already started" : "name taken")
+                  << std::endl;
+        return;
+    }
+    Node node;
+    node.name = name;
+    node.after = std::move(after);
+    node.task = std::move(task);
+    node.priority = priority;
+    node.affinity = affinity;
+    node.timing.name = name;
+    by_name[name] = nodes.size();
+    nodes.push_back(std::move(node));
+}
+
+void StartupGraph::setMainThreadWake(std::function<void()> wake) {
+    std::lock_guard<std::mutex> lock(mutex);
+    main_wake = std::move(wake);
+}
+
+bool StartupGraph::start() {
+    Released released;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (started) return true;
+
+        // Dependencies by index, checked before anything runs
+        std::vector<size_t> unfinished(nodes.size(), 0);
+        std::vector<std::vector<size_t>> dependents(nodes.size());
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            for (const std::string& before : nodes[i].after) {
+                auto it = by_name.find(before);
+                if (it == by_name.end()) {
+                    std::cerr << "Startup task " << nodes[i].name << " comes after unknown task " << before << std::endl;
+                    return false;
+                }
+                dependents[it->second].push_back(i);
+                ++unfinished[i];
+            }
+        }
+
+        // Kahn's walk reaches every task unless some wait on each other
+        std::vector<size_t> remaining = unfinished;
+        std::vector<size_t> order;
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (remaining[i] == 0) order.push_back(i);
+        }
+        for (size_t next = 0; next < order.size(); ++next) {
+            for (size_t dependent : dependents[order[next]]) {
+                if (--remaining[dependent] == 0) order.push_back(dependent);
+            }
+        }
+        if (order.size() != nodes.size()) {
+            std::cerr << "Startup tasks depend on each other in a cycle:";
+            for (size_t i = 0; i < nodes.size(); ++i) {
+                if (remaining[i] != 0) std::cerr << " " << nodes[i].name;
+            }
+            std::cerr << std::endl;
+            return false;
+        }
+
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            nodes[i].dependents = std::move(dependents[i]);
+            nodes[i].unfinished = unfinished[i];
+        }
+        started = true;
+        start_time = Clock::now();
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            if (nodes[i].unfinished == 0) dispatch(i, released);
+        }
+    }
+    release(released);
+    return true;
+}
+
+void StartupGraph::dispatch(size_t node, Released& released) {
+    Node& ready = nodes[node];
+    ready.timing.ready_ms = sinceStart(Clock::now());
+    if (cancelled) {
+        finish(node, true, released);
+        return;
+    }
+    ready.state = State::QUEUED;
+    if (ready.affinity == Affinity::MAIN) {
+        main_ready.push_back(node);
+        released.main = true;
+    } else {
+        ++in_flight;
+        released.posts.push_back(node);
+    }
+}
+
+void StartupGraph::finish(size_t node, bool skipped, Released& released) {
+    Node& done = nodes[node];
+    done.state = State::DONE;
+    done.timing.skipped = skipped;
+    done.task = nullptr; // Whatever it captured goes now
+    if (!skipped) {
+        std::cout << "Startup: " << done.name << " took " << done.timing.duration_ms << "ms (ready at "
+                  << done.timing.ready_ms << "ms)" << std::endl;
+    }
+    if (++finished_count == nodes.size()) {
+        std::cout << "Startup finished in " << sinceStart(Clock::now()) << "ms" << std::endl;
+    }
+    for (size_t dependent : done.dependents) {
+        if (--nodes[dependent].unfinished == 0) dispatch(dependent, released);
+    }
+}
+
+void StartupGraph::release(const Released& released) {
+    for (size_t node : released.posts) {
+        scheduler.post([this, node]() { run(node); }, nodes[node].priority);
+    }
+    if (released.main) {
+        std::function<void()> wake;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            wake = main_wake;
+        }
+        if (wake) wake();
+    }
+}
+
+void StartupGraph::run(size_t node) {
+    Released released;
+    Task task;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cancelled) {
+            finish(node, true, released);
+        } else {
+            nodes[node].state = State::RUNNING;
+            task = std::move(nodes[node].task);
+        }
+    }
+
+    if (task) {
+        Clock::time_point began = Clock::now();
+        try {
+            task();
+        } catch (const std::exception& e) {
+            std::cerr << "Startup task " << nodes[node].name << " failed: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "Startup task " << nodes[node].name << " failed" << std::endl;
+        }
+        Clock::time_point ended = Clock::now();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        nodes[node].timing.start_ms = sinceStart(began);
+        nodes[node].timing.duration_ms = std::chrono::duration<double, std::milli>(ended - began).count();
+        finish(node, false, released);
+    }
+
+    if (nodes[node].affinity == Affinity::ANY) {
+        // The graph may be destroyed as soon as in_flight drops, so release first
+        release(released);
+        std::lock_guard<std::mutex> lock(mutex);
+        --in_flight;
+        idle.notify_all();
+        return;
+    }
+    release(released);
+}
+
+size_t StartupGraph::runMainThreadTasks() {
+    size_t ran = 0;
+    for (;;) {
+        size_t node;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (main_ready.empty()) return ran;
+            node = main_ready.front();
+            main_ready.pop_front();
+        }
+        run(node);
+        ++ran;
+    }
+}
+
+bool StartupGraph::isDone(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = by_name.find(name);
+    return it != by_name.end() && nodes[it->second].state == State::DONE && !nodes[it->second].timing.skipped;
+}
+
+bool StartupGraph::finished() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return started && finished_count == nodes.size();
+}
+
+void StartupGraph::cancel() {
+    Released released;
+    std::unique_lock<std::mutex> lock(mutex);
+    cancelled = true;
+    // MAIN tasks waiting for a frame are skipped here, ANY tasks when the scheduler gets to them
+    while (!main_ready.empty()) {
+        size_t node = main_ready.front();
+        main_ready.pop_front();
+        finish(node, true, released);
+    }
+    // Skipping frees no task to run, so released holds nothing to act on
+    idle.wait(lock, [this]() { return in_flight == 0; });
+}
+
+std::vector<StartupGraph::Timing> StartupGraph::timings() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<Timing> result;
+    result.reserve(nodes.size());
+    for (const Node& node : nodes) {
+        if (node.state == State::DONE) result.push_back(node.timing);
+    }
+    return result;
+}
+
+double StartupGraph::sinceStart(Clock::time_point time) const {
+    return std::chrono::duration<double, std::milli>(time - start_time).count();
+}
@@ -0,0 +1,115 @@
+#ifndef STARTUPGRAPH_H
+#define STARTUPGRAPH_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TaskScheduler.h"
+
+// Application startup as tasks with declared dependencies. Each task runs as
+// soon as everything it comes after has finished: on the shared scheduler at
+// its own priority, or, for work tied to the UI thread (the GL context, the
+// ImGui context), from that thread's runMainThreadTasks() between frames.
+// Independent subsystems so start together instead of one after another, and
+// the first frame need wait only for what it draws with.
+//
+// A task that throws is logged and counts as finished, so what comes after
+// it still runs; each task checks for the state it needs.
+class StartupGraph {
+public:
+    using Task = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+
+    enum class Affinity {
+        ANY,  // any scheduler thread
+        MAIN  // the thread calling runMainThreadTasks()
+    };
+
+    struct Timing {
+        std::string name;
+        double ready_ms;    // since start(), when its dependencies were done
+        double start_ms;
+        double duration_ms;
+        bool skipped;       // cancelled before it ran
+    };
+
+private:
+    enum class State { WAITING, QUEUED, RUNNING, DONE };
+
+    struct Node {
+        std::string name;
+        std::vector<size_t> dependents;
+        std::vector<std::string> after;
+        size_t unfinished = 0;
+        Task task;
+        TaskPriority priority;
+        Affinity affinity;
+        State state = State::WAITING;
+        Timing timing{};
+    };
+
+    TaskScheduler& scheduler;
+    mutable std::mutex mutex;
+    std::condition_variable idle;
+    std::vector<Node> nodes;
+    std::unordered_map<std::string, size_t> by_name;
+    std::deque<size_t> main_ready;
+    std::function<void()> main_wake;
+    Clock::time_point start_time;
+    size_t finished_count = 0;
+    size_t in_flight = 0;  // posted to the scheduler and not yet back
+    bool started = false;
+    bool cancelled = false;
+
+    // What finishing a task set free, acted on once the mutex is released
+    struct Released {
+        std::vector<size_t> posts;
+        bool main = false;
+    };
+
+    // Under mutex: node's dependencies are done
+    void dispatch(size_t node, Released& released);
+    // Under mutex: node ran, or was skipped
+    void finish(size_t node, bool skipped, Released& released);
+    void release(const Released& released);
+    void run(size_t node);
+    double sinceStart(Clock::time_point time) const;
+
+public:
+    explicit StartupGraph(TaskScheduler& scheduler = TaskScheduler::shared());
+    ~StartupGraph();
+
+    StartupGraph(const StartupGraph&) = delete;
+    StartupGraph& operator=(const StartupGraph&) = delete;
+
+    // Before start(); after names tasks added before or after this one
+    void add(const std::string& name, std::vector<std::string> after, Task task,
+             TaskPriority priority = TaskPriority::BACKGROUND, Affinity affinity = Affinity::ANY);
+
+    // Called from a scheduler thread whenever a MAIN task becomes ready, to
+    // wake the main thread; must not call back into the graph
+    void setMainThreadWake(std::function<void()> wake);
+
+    // Releases the tasks without dependencies; false, running nothing, if a
+    // dependency is unknown or the tasks depend on each other in a cycle
+    bool start();
+
+    // Runs the MAIN tasks that are ready, including any they make ready;
+    // returns how many ran
+    size_t runMainThreadTasks();
+
+    bool isDone(const std::string& name) const;
+    bool finished() const;
+
+    // Tasks not yet started are skipped; returns once the running ones are back
+    void cancel();
+
+    std::vector<Timing> timings() const;
+};
+
+#endif // STARTUPGRAPH_H
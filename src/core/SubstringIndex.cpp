@@ -0,0 +1,131 @@
+#include "SubstringIndex.h"
+#include "TextFolding.h"
+#include <algorithm>
+
+void SubstringIndex::build(const VerseStore& store) {
+    clear();
+    owned_starts.reserve(store.size() + 1);
+    owned_text.reserve(store.textBlob().size() + store.size());
+    for (VerseId id = 0; id < store.size(); ++id) {
+        owned_starts.push_back(static_cast<uint32_t>(owned_text.size()));
+        owned_text += TextFolding::fold(store.text(id));
+        owned_text += '\0';
+    }
+    owned_starts.push_back(static_cast<uint32_t>(owned_text.size()));
+    owned_suffixes = sortSuffixes(owned_text);
+    memory_charge.set(getMemoryUsage());
+}
+
+bool SubstringIndex::attach(std::shared_ptr<const MappedFile> file, size_t verse_count, std::string_view text,
+                            std::span<const uint32_t> starts, std::span<const uint32_t> suffixes) {
+    if (!file || starts.size() != verse_count + 1 || starts.front() != 0 || starts.back() != text.size() ||
+        (!text.empty() && text.back() != '\0') || suffixes.size() > text.size()) {
+        return false;
+    }
+    clear();
+    mapping = std::move(file);
+    text_view = text;
+    starts_view = starts;
+    suffixes_view = suffixes;
+    return true;
+}
+
+void SubstringIndex::clear() {
+    owned_text = std::string();
+    owned_starts = std::vector<uint32_t>();
+    owned_suffixes = std::vector<uint32_t>();
+    text_view = {};
+    starts_view = {};
+    suffixes_view = {};
+    mapping.reset();
+    memory_charge.set(0);
+}
+
+std::vector<uint32_t> SubstringIndex::sortSuffixes(std::string_view text) {
+    // Sorts the rotations of text. It ends in a NUL and fragments hold none,
+    // so the rotations a fragment begins are exactly the suffixes it begins.
+    const size_t n = text.size();
+    if (n == 0) return {};
+    std::vector<uint32_t> order(n), rank(n), next_order(n), next_rank(n);
+    std::vector<uint32_t> counts(std::max<size_t>(256, n));
+
+    // Rotations ranked by their first byte
+    for (char c : text) ++counts[static_cast<unsigned char>(c)];
+    for (size_t i = 1; i < 256; ++i) counts[i] += counts[i - 1];
+    for (size_t i = n; i-- > 0;) order[--counts[static_cast<unsigned char>(text[i])]] = static_cast<uint32_t>(i);
+    size_t classes = 1;
+    rank[order[0]] = 0;
+    for (size_t i = 1; i < n; ++i) {
+        if (text[order[i]] != text[order[i - 1]]) ++classes;
+        rank[order[i]] = static_cast<uint32_t>(classes - 1);
+    }
+
+    // Ranked by 2 * length bytes: already in order of the second half, so a
+    // stable sort by the first half's rank completes it
+    for (size_t length = 1; length < n && classes < n; length *= 2) {
+        for (size_t i = 0; i < n; ++i) next_order[i] = static_cast<uint32_t>((order[i] + n - length) % n);
+        std::fill(counts.begin(), counts.begin() + classes, 0);
+        for (uint32_t pos : next_order) ++counts[rank[pos]];
+        for (size_t i = 1; i < classes; ++i) counts[i] += counts[i - 1];
+        for (size_t i = n; i-- > 0;) order[--counts[rank[next_order[i]]]] = next_order[i];
+
+        classes = 1;
+        next_rank[order[0]] = 0;
+        for (size_t i = 1; i < n; ++i) {
+            uint32_t pos = order[i];
+            uint32_t previous = order[i - 1];
+            if (rank[pos] != rank[previous] || rank[(pos + length) % n] != rank[(previous + length) % n]) ++classes;
+            next_rank[pos] = static_cast<uint32_t>(classes - 1);
+        }
+        rank.swap(next_rank);
+    }
+
+    // A suffix starting at a verse's NUL never begins a fragment
+    order.erase(std::remove_if(order.begin(), order.end(), [text](uint32_t pos) { return text[pos] == '\0'; }),
+                order.end());
+    order.shrink_to_fit();
+    return order;
+}
+
+PostingList SubstringIndex::find(std::string_view fragment) const {
+    const std::string folded = TextFolding::fold(fragment);
+    if (folded.empty() || folded.find('\0') != std::string::npos || empty()) return {};
+
+    // Suffixes compare on the fragment's length only, so those it begins are all equal to it
+    std::string_view text = foldedText();
+    std::span<const uint32_t> sorted = suffixes();
+    std::string_view key = folded;
+    auto head = [text, length = key.size()](uint32_t pos) { return text.substr(pos, length); };
+    auto first = std::lower_bound(sorted.begin(), sorted.end(), key,
+                                  [&head](uint32_t pos, std::string_view k) { return head(pos) < k; });
+    auto last = std::upper_bound(first, sorted.end(), key,
+                                 [&head](std::string_view k, uint32_t pos) { return k < head(pos); });
+
+    std::span<const uint32_t> verse_starts = starts();
+    auto verseAt = [verse_starts](uint32_t pos) {
+        return static_cast<VerseId>(std::upper_bound(verse_starts.begin(), verse_starts.end(), pos) -
+                                    verse_starts.begin() - 1);
+    };
+
+    PostingList ids;
+    size_t matches = static_cast<size_t>(last - first);
+    if (matches > verseCount()) {
+        // A common fragment: mark its verses rather than sort every occurrence
+        std::vector<char> hit(verseCount(), 0);
+        for (auto it = first; it != last; ++it) hit[verseAt(*it)] = 1;
+        for (VerseId id = 0; id < hit.size(); ++id) {
+            if (hit[id]) ids.push_back(id);
+        }
+        return ids;
+    }
+    ids.reserve(matches);
+    for (auto it = first; it != last; ++it) ids.push_back(verseAt(*it));
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+size_t SubstringIndex::getMemoryUsage() const {
+    // Borrowed sections are backed by the page cache rather than the heap
+    return owned_text.capacity() + (owned_starts.capacity() + owned_suffixes.capacity()) * sizeof(uint32_t);
+}
@@ -0,0 +1,72 @@
+#ifndef SUBSTRINGINDEX_H
+#define SUBSTRINGINDEX_H
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "InvertedIndex.h"
+#include "MemoryAccounting.h"
+#include "VerseStore.h"
+
+class MappedFile;
+
+// Any substring of a translation's text, not just its words: "gotten" inside
+// "begotten", "-eth", a fragment spanning words and punctuation. Each verse is
+// folded as TextFolding::fold() does and the verses are joined, each ending in
+// a NUL; the suffix array lists every position of that text in order of the
+// text that follows it. The positions where a fragment starts are then one
+// run, found with two binary searches of at most |fragment| bytes compared
+// per step, and mapped to verses through their start offsets.
+//
+// It costs four bytes per folded byte on top of the folded text, so it is
+// optional. It is built when a translation is imported and kept in its
+// snapshot, from which later loads borrow it zero-copy (see attach()).
+class SubstringIndex {
+private:
+    std::string owned_text;
+    std::vector<uint32_t> owned_starts;
+    std::vector<uint32_t> owned_suffixes;
+    // Borrowed from a mapped snapshot instead, when mapping is set
+    std::string_view text_view;
+    std::span<const uint32_t> starts_view;
+    std::span<const uint32_t> suffixes_view;
+    std::shared_ptr<const MappedFile> mapping;
+    MemoryCharge memory_charge{MemoryTag::INVERTED_INDEX};
+
+    // Every position of text but its NULs, ordered by the text from there on
+    // (prefix doubling with counting sorts, so O(n log n) for any text)
+    static std::vector<uint32_t> sortSuffixes(std::string_view text);
+
+public:
+    SubstringIndex() = default;
+    SubstringIndex(const SubstringIndex&) = delete;
+    SubstringIndex& operator=(const SubstringIndex&) = delete;
+    SubstringIndex(SubstringIndex&&) = default;
+    SubstringIndex& operator=(SubstringIndex&&) = default;
+
+    void build(const VerseStore& store);
+    // Borrow the sections of a snapshot; file keeps them alive. False, leaving
+    // the index unchanged, if they do not fit together or verse_count
+    bool attach(std::shared_ptr<const MappedFile> file, size_t verse_count, std::string_view text,
+                std::span<const uint32_t> starts, std::span<const uint32_t> suffixes);
+    void clear();
+
+    // Sorted ids of the verses whose folded text contains fragment folded;
+    // nothing for a fragment that folds to nothing
+    PostingList find(std::string_view fragment) const;
+
+    bool empty() const { return starts().empty(); }
+    size_t verseCount() const { return starts().empty() ? 0 : starts().size() - 1; }
+    // The sections a snapshot stores
+    std::string_view foldedText() const { return mapping ? text_view : std::string_view(owned_text); }
+    std::span<const uint32_t> starts() const { return mapping ? starts_view : std::span<const uint32_t>(owned_starts); }
+    std::span<const uint32_t> suffixes() const {
+        return mapping ? suffixes_view : std::span<const uint32_t>(owned_suffixes);
+    }
+    size_t getMemoryUsage() const;
+};
+
+#endif // SUBSTRINGINDEX_H
@@ -0,0 +1,45 @@
+#include "Task.h"
+
+bool AsyncEvent::consumeSignal() {
+    std::lock_guard<std::mutex> lock(mutex);
+    bool was_signaled = signaled;
+    signaled = false;
+    return was_signaled;
+}
+
+bool AsyncEvent::suspend(std::shared_ptr<Waiter> next, Clock::time_point deadline, TaskPriority priority) {
+    next->priority = priority;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (signaled) {
+            signaled = false;
+            return false;
+        }
+        waiter = next;
+    }
+    // From here set() may resume the coroutine on another thread, so only
+    // the waiter is touched. A timer that loses to set() finds it claimed.
+    TaskScheduler::shared().postAfter(deadline - Clock::now(), [next]() {
+        if (!next->claimed.exchange(true, std::memory_order_acq_rel)) {
+            next->handle.resume();
+        }
+    }, priority);
+    return true;
+}
+
+void AsyncEvent::set() {
+    std::shared_ptr<Waiter> woken;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (waiter && !waiter->claimed.exchange(true, std::memory_order_acq_rel)) {
+            woken = std::move(waiter);
+        } else {
+            signaled = true; // for the next wait, or the one whose deadline just passed
+        }
+        waiter.reset();
+    }
+    if (woken) {
+        woken->woken = true;
+        TaskScheduler::shared().post([woken]() { woken->handle.resume(); }, woken->priority);
+    }
+}
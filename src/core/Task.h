@@ -0,0 +1,285 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include "TaskScheduler.h"
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// Coroutines on the shared TaskScheduler, so code that waits (on the
+// network, a timer, another task) holds no thread while it does. A Task<T>
+// is lazy: it runs when it is co_awaited, or when spawn() hands it to the
+// pool, and resumes whoever awaited it on the thread that finished it.
+//
+//   co_await schedule(priority)   continue on a pool worker
+//   co_await sleepFor(delay)      continue on a worker once delay has passed
+//   co_await event.waitUntil(t)   an AsyncEvent, or the deadline, whichever first
+//   co_await awaitCallback<T>(f)  a callback API: f(done) arranges done(T)
+//
+// Resumption is from scheduler tasks, which inherit the priority given to
+// schedule() or the timer. Timers the scheduler drops when it stops leave
+// their coroutines suspended for good, like postAfter() tasks.
+template <typename T = void>
+class Task;
+
+namespace task_detail {
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> finished) noexcept {
+            // Straight into the awaiter, without growing the stack
+            std::coroutine_handle<> next = finished.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object();
+    template <typename U>
+    void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+    T take() {
+        if (error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object();
+    void return_void() {}
+    void take() {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+} // namespace task_detail
+
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = task_detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+    explicit Task(Handle handle) : handle(handle) {}
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    bool valid() const { return static_cast<bool>(handle); }
+
+    // Runs the task and returns its result, or rethrows what it threw
+    auto operator co_await() noexcept {
+        struct Awaiter {
+            Handle task;
+            bool await_ready() const noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                task.promise().continuation = awaiting;
+                return task;
+            }
+            T await_resume() { return task.promise().take(); }
+        };
+        return Awaiter{handle};
+    }
+
+private:
+    Handle handle;
+};
+
+namespace task_detail {
+
+template <typename T>
+Task<T> Promise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+// Owns itself: runs from spawn() to the end and frees its own frame
+struct Detached {
+    struct promise_type {
+        Detached get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+struct ScheduleAwaiter {
+    TaskScheduler& scheduler;
+    TaskPriority priority;
+    TaskScheduler::Clock::duration delay{};
+    bool delayed = false;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+        if (delayed) {
+            scheduler.postAfter(delay, [handle]() { handle.resume(); }, priority);
+        } else {
+            scheduler.post([handle]() { handle.resume(); }, priority);
+        }
+    }
+    void await_resume() const noexcept {}
+};
+
+} // namespace task_detail
+
+// Continue on a worker of the shared scheduler
+inline task_detail::ScheduleAwaiter schedule(TaskPriority priority = TaskScheduler::currentPriority()) {
+    return {TaskScheduler::shared(), priority};
+}
+
+// Continue on a worker once delay has passed
+inline task_detail::ScheduleAwaiter sleepFor(TaskScheduler::Clock::duration delay,
+                                             TaskPriority priority = TaskScheduler::currentPriority()) {
+    return {TaskScheduler::shared(), priority, delay, true};
+}
+
+// Adapts a callback API: start(done) must arrange for done(T) to be called
+// exactly once, from any thread, even before start returns. The coroutine
+// continues on that thread.
+template <typename T, typename Start>
+auto awaitCallback(Start start) {
+    struct Awaiter {
+        Start start;
+        std::optional<T> value;
+        std::atomic<bool> arrived{false}; // whichever of the callback and await_suspend comes second resumes
+
+        explicit Awaiter(Start start) : start(std::move(start)) {}
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle) {
+            start([this, handle](T result) {
+                value.emplace(std::move(result));
+                if (arrived.exchange(true, std::memory_order_acq_rel)) handle.resume();
+            });
+            return !arrived.exchange(true, std::memory_order_acq_rel);
+        }
+        T await_resume() { return std::move(*value); }
+    };
+    return Awaiter(std::move(start));
+}
+
+// Starts task on a pool worker at priority; the future holds its result or
+// exception. Nothing need keep the future: the task runs to the end either way.
+template <typename T>
+std::future<T> spawn(Task<T> task, TaskPriority priority = TaskScheduler::currentPriority()) {
+    struct Runner {
+        static task_detail::Detached run(Task<T> task, TaskPriority priority, std::promise<T> done) {
+            co_await schedule(priority);
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    co_await task;
+                    done.set_value();
+                } else {
+                    done.set_value(co_await task);
+                }
+            } catch (...) {
+                done.set_exception(std::current_exception());
+            }
+        }
+    };
+    std::promise<T> done;
+    std::future<T> result = done.get_future();
+    Runner::run(std::move(task), priority, std::move(done));
+    return result;
+}
+
+// Wakes one waiting coroutine, or the next to wait if none is: a set() is
+// never lost, and several before a wait count as one. For loops that sleep
+// until a deadline or until something changes; one coroutine waits at a time.
+class AsyncEvent {
+public:
+    using Clock = TaskScheduler::Clock;
+
+private:
+    struct Waiter {
+        std::coroutine_handle<> handle;
+        std::atomic<bool> claimed{false}; // by set() or the deadline, whichever came first
+        bool woken = false;               // by set()
+        TaskPriority priority = TaskPriority::BACKGROUND;
+    };
+
+    std::mutex mutex;
+    bool signaled = false;
+    std::shared_ptr<Waiter> waiter;
+
+    bool consumeSignal();
+    // False if a set() arrived first and the coroutine should not suspend
+    bool suspend(std::shared_ptr<Waiter> next, Clock::time_point deadline, TaskPriority priority);
+
+public:
+    struct WaitAwaiter {
+        AsyncEvent& event;
+        Clock::time_point deadline;
+        TaskPriority priority;
+        std::shared_ptr<Waiter> waiter;
+        bool woken = false;
+
+        bool await_ready() {
+            woken = event.consumeSignal();
+            return woken;
+        }
+        bool await_suspend(std::coroutine_handle<> handle) {
+            waiter = std::make_shared<Waiter>();
+            waiter->handle = handle;
+            if (!event.suspend(waiter, deadline, priority)) {
+                woken = true;
+                return false;
+            }
+            return true;
+        }
+        // True if set() woke it, false if the deadline passed
+        bool await_resume() const { return woken || (waiter && waiter->woken); }
+    };
+
+    AsyncEvent() = default;
+    AsyncEvent(const AsyncEvent&) = delete;
+    AsyncEvent& operator=(const AsyncEvent&) = delete;
+
+    // Safe from any thread, with any lock held: the waiter resumes on the pool
+    void set();
+
+    WaitAwaiter waitUntil(Clock::time_point deadline, TaskPriority priority = TaskScheduler::currentPriority()) {
+        return {*this, deadline, priority, nullptr, false};
+    }
+    WaitAwaiter waitFor(Clock::duration timeout, TaskPriority priority = TaskScheduler::currentPriority()) {
+        return waitUntil(Clock::now() + timeout, priority);
+    }
+};
+
+#endif // TASK_H
@@ -0,0 +1,253 @@
+#include "TaskScheduler.h"
+#include <algorithm>
+
+namespace {
+
+// Which scheduler, if any, the current thread works for, and its queue
+thread_local const TaskScheduler* current_scheduler = nullptr;
+thread_local size_t current_queue = 0;
+// Priority of the task this thread is running, else what the thread set
+thread_local TaskPriority current_priority = TaskPriority::API;
+thread_local bool in_task = false;
+
+constexpr size_t UNLIMITED = SIZE_MAX;
+
+int64_t ticks(TaskScheduler::Clock::time_point time) {
+    return time.time_since_epoch().count();
+}
+
+} // namespace
+
+TaskScheduler::TaskScheduler(size_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (auto& limit : concurrency_limits) limit.store(UNLIMITED);
+    concurrency_limits[static_cast<size_t>(TaskPriority::BACKGROUND)].store(std::max<size_t>(1, thread_count / 2));
+    for (auto& served : last_served) served.store(ticks(Clock::now()));
+
+    queues.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    threads.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads.emplace_back(&TaskScheduler::workerLoop, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+        timers.clear();
+    }
+    wake.notify_all();
+    // Workers drain what is still queued before exiting
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+TaskScheduler& TaskScheduler::shared() {
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+TaskPriority TaskScheduler::currentPriority() {
+    return current_priority;
+}
+
+void TaskScheduler::setThreadPriority(TaskPriority priority) {
+    current_priority = priority;
+}
+
+void TaskScheduler::setConcurrencyLimit(TaskPriority priority, size_t limit) {
+    concurrency_limits[static_cast<size_t>(priority)].store(limit == 0 ? UNLIMITED : limit);
+    std::lock_guard<std::mutex> lock(sleep_mutex);
+    wake.notify_all();  // A higher cap may admit queued tasks
+}
+
+size_t TaskScheduler::shardCount(size_t items, size_t min_items) const {
+    size_t by_size = items / std::max<size_t>(1, min_items);
+    // A few shards per thread let fast threads steal from slow ones
+    size_t by_threads = (threads.size() + 1) * 4;
+    return std::clamp<size_t>(by_size, 1, by_threads);
+}
+
+size_t TaskScheduler::homeQueue() const {
+    if (current_scheduler == this) return current_queue;
+    return next_queue.load(std::memory_order_relaxed) % queues.size();
+}
+
+void TaskScheduler::post(Task task, TaskPriority priority) {
+    const size_t level = static_cast<size_t>(priority);
+    size_t index = current_scheduler == this ? current_queue
+                                             : next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        // Counted first, and under the sleep lock, so no worker can either take
+        // the task before it is counted or go to sleep without seeing it
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        pending.fetch_add(1, std::memory_order_release);
+        if (pending_by_priority[level].fetch_add(1, std::memory_order_acq_rel) == 0) {
+            // Waiting starts now, not when the class last ran
+            last_served[level].store(ticks(Clock::now()), std::memory_order_relaxed);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks[level].push_back(std::move(task));
+    }
+    wake.notify_one();
+}
+
+void TaskScheduler::postAfter(Clock::duration delay, Task task, TaskPriority priority) {
+    Clock::time_point due = Clock::now() + delay;
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        if (stopping) return;
+        timers.push_back({due, priority, std::move(task)});
+        std::push_heap(timers.begin(), timers.end(), [](const Timer& a, const Timer& b) { return a.due > b.due; });
+        next_timer_due.store(ticks(timers.front().due), std::memory_order_release);
+    }
+    wake.notify_one();  // A sleeping worker recomputes how long to wait
+}
+
+void TaskScheduler::releaseDueTimers() {
+    if (next_timer_due.load(std::memory_order_acquire) > ticks(Clock::now())) return;
+
+    std::vector<Timer> due;
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        Clock::time_point now = Clock::now();
+        while (!timers.empty() && timers.front().due <= now) {
+            std::pop_heap(timers.begin(), timers.end(), [](const Timer& a, const Timer& b) { return a.due > b.due; });
+            due.push_back(std::move(timers.back()));
+            timers.pop_back();
+        }
+        next_timer_due.store(timers.empty() ? INT64_MAX : ticks(timers.front().due), std::memory_order_release);
+    }
+    for (Timer& timer : due) {
+        post(std::move(timer.task), timer.priority);
+    }
+}
+
+bool TaskScheduler::runnable() const {
+    for (size_t level = 0; level < PRIORITY_COUNT; ++level) {
+        if (pending_by_priority[level].load(std::memory_order_acquire) > 0 &&
+            running_by_priority[level].load(std::memory_order_acquire) < concurrency_limits[level].load()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskScheduler::takeTask(size_t home, size_t level, Task& task) {
+    {
+        // Own queue from the back: the newest task is the one most likely still in cache
+        WorkQueue& own = *queues[home];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        auto& tasks = own.tasks[level];
+        if (!tasks.empty()) {
+            task = std::move(tasks.back());
+            tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        // Steal the oldest task, which tends to be the largest piece left
+        WorkQueue& victim = *queues[(home + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        auto& tasks = victim.tasks[level];
+        if (!tasks.empty()) {
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TaskScheduler::acquireSlot(size_t level) {
+    size_t running = running_by_priority[level].load(std::memory_order_acquire);
+    while (running < concurrency_limits[level].load()) {
+        if (running_by_priority[level].compare_exchange_weak(running, running + 1)) return true;
+    }
+    return false;
+}
+
+bool TaskScheduler::runOne(size_t home, TaskPriority lowest) {
+    const size_t lowest_level = static_cast<size_t>(lowest);
+    const int64_t now = ticks(Clock::now());
+    const int64_t starving_before = now - std::chrono::duration_cast<Clock::duration>(STARVATION_LIMIT).count();
+
+    // Most urgent first, except that a class kept waiting too long goes ahead of all
+    std::array<size_t, PRIORITY_COUNT> order;
+    size_t count = 0;
+    for (size_t level = 0; level <= lowest_level; ++level) {
+        if (pending_by_priority[level].load(std::memory_order_acquire) > 0 &&
+            last_served[level].load(std::memory_order_relaxed) < starving_before) {
+            order[count++] = level;
+        }
+    }
+    for (size_t level = 0; level <= lowest_level; ++level) {
+        if (std::find(order.begin(), order.begin() + count, level) == order.begin() + count) order[count++] = level;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const size_t level = order[i];
+        if (pending_by_priority[level].load(std::memory_order_acquire) == 0) continue;
+
+        // Nested work of the class the thread is already running is not capped,
+        // or a capped task waiting in parallelFor() could never finish
+        const bool capped = !(in_task && current_priority == static_cast<TaskPriority>(level));
+        if (capped && !acquireSlot(level)) continue;
+
+        Task task;
+        if (!takeTask(home, level, task)) {
+            if (capped) running_by_priority[level].fetch_sub(1, std::memory_order_acq_rel);
+            continue;
+        }
+        pending.fetch_sub(1, std::memory_order_acq_rel);
+        pending_by_priority[level].fetch_sub(1, std::memory_order_acq_rel);
+        last_served[level].store(now, std::memory_order_relaxed);
+
+        const TaskPriority saved_priority = current_priority;
+        const bool saved_in_task = in_task;
+        current_priority = static_cast<TaskPriority>(level);
+        in_task = true;
+        task();
+        current_priority = saved_priority;
+        in_task = saved_in_task;
+
+        if (capped) {
+            running_by_priority[level].fetch_sub(1, std::memory_order_acq_rel);
+            if (pending_by_priority[level].load(std::memory_order_acquire) > 0) {
+                // A worker may have gone to sleep on the cap
+                std::lock_guard<std::mutex> lock(sleep_mutex);
+                wake.notify_one();
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+void TaskScheduler::workerLoop(size_t index) {
+    current_scheduler = this;
+    current_queue = index;
+
+    while (true) {
+        releaseDueTimers();
+        if (runOne(index)) continue;
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        if (stopping && pending.load(std::memory_order_acquire) == 0) return;
+        if (runnable() || (!timers.empty() && timers.front().due <= Clock::now())) continue;
+        if (timers.empty()) {
+            wake.wait(lock);
+        } else {
+            wake.wait_until(lock, timers.front().due);
+        }
+    }
+}
@@ -0,0 +1,168 @@
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Classes of work, most urgent first
+enum class TaskPriority {
+    INTERACTIVE,  // the operator's own searches and keystrokes
+    PREFETCH,     // what the presentation is likely to show next
+    API,          // remote clients; the default for threads that set nothing
+    BACKGROUND    // warm-up, analytics and other work nobody waits on
+};
+
+// Work-stealing thread pool shared by the search code. Every worker owns a
+// deque per priority: it takes its newest task from the back, while idle
+// workers steal the oldest from the front of someone else's. Threads waiting
+// in parallelFor() run queued tasks instead of blocking, so nested parallel
+// sections cannot starve the pool.
+//
+// A free worker takes the most urgent class with work, so an operator's
+// keystroke runs next whatever else is queued; tasks are not preempted, so
+// background work comes in short tasks. A class can be capped at a number
+// of tasks running at once (BACKGROUND at half the workers by default,
+// leaving the rest free for what arrives), and a class passed over for
+// STARVATION_LIMIT is served next regardless. Tasks inherit the priority
+// of the task or thread that posted them.
+class TaskScheduler {
+public:
+    using Task = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t PRIORITY_COUNT = 4;
+    static constexpr auto STARVATION_LIMIT = std::chrono::milliseconds(200);
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::array<std::deque<Task>, PRIORITY_COUNT> tasks;
+    };
+    struct Timer {
+        Clock::time_point due;
+        TaskPriority priority;
+        Task task;
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> threads;
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> next_queue{0};
+    bool stopping = false;
+
+    std::array<std::atomic<size_t>, PRIORITY_COUNT> pending_by_priority{};
+    std::array<std::atomic<size_t>, PRIORITY_COUNT> running_by_priority{};
+    std::array<std::atomic<size_t>, PRIORITY_COUNT> concurrency_limits{};
+    std::array<std::atomic<int64_t>, PRIORITY_COUNT> last_served{};  // Clock ticks
+
+    std::vector<Timer> timers;  // Heap by due time, under sleep_mutex
+    std::atomic<int64_t> next_timer_due{INT64_MAX};  // Clock ticks
+
+    void workerLoop(size_t index);
+    // Run one queued task of priority at most lowest, most urgent first and
+    // preferring the home queue; false if there was none it could start
+    bool runOne(size_t home, TaskPriority lowest = TaskPriority::BACKGROUND);
+    bool takeTask(size_t home, size_t priority, Task& task);
+    bool acquireSlot(size_t priority);  // Under the class's concurrency limit
+    bool runnable() const;
+    void releaseDueTimers();
+    size_t homeQueue() const;
+
+public:
+    // thread_count 0 picks one worker per hardware thread
+    explicit TaskScheduler(size_t thread_count = 0);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    // Process-wide pool, started on first use
+    static TaskScheduler& shared();
+
+    size_t threadCount() const { return threads.size(); }
+    // Shards worth splitting items into: enough to keep every thread busy
+    // (the caller included), none smaller than min_items
+    size_t shardCount(size_t items, size_t min_items) const;
+
+    // Priority of the calling thread's work: the running task's, or what
+    // the thread set for itself (API if nothing)
+    static TaskPriority currentPriority();
+    static void setThreadPriority(TaskPriority priority);
+
+    // Most tasks of the class running at once; 0 lifts the cap. Tasks posted
+    // from a running task of the same class do not count against it.
+    void setConcurrencyLimit(TaskPriority priority, size_t limit);
+
+    // Tasks must not throw; submit() and parallelFor() carry exceptions back to the caller
+    void post(Task task) { post(std::move(task), currentPriority()); }
+    void post(Task task, TaskPriority priority);
+    // Queued once delay has passed; dropped if the scheduler stops first
+    void postAfter(Clock::duration delay, Task task, TaskPriority priority);
+
+    template <typename F>
+    auto submit(F&& function, TaskPriority priority = currentPriority()) -> std::future<std::invoke_result_t<F>> {
+        using Result = std::invoke_result_t<F>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(function));
+        std::future<Result> result = task->get_future();
+        post([task]() { (*task)(); }, priority);
+        return result;
+    }
+
+    // Run body(0) .. body(count - 1), the calling thread included, and return
+    // once all have finished. The first exception thrown is rethrown here.
+    template <typename Body>
+    void parallelFor(size_t count, Body&& body) {
+        if (count == 0) return;
+        if (count == 1) {
+            body(size_t(0));
+            return;
+        }
+
+        struct Shared {
+            std::atomic<size_t> remaining;
+            std::mutex error_mutex;
+            std::exception_ptr error;
+        };
+        auto state = std::make_shared<Shared>();
+        state->remaining.store(count);
+        auto run = [state, &body](size_t index) {
+            try {
+                body(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state->error_mutex);
+                if (!state->error) state->error = std::current_exception();
+            }
+            state->remaining.fetch_sub(1, std::memory_order_acq_rel);
+        };
+
+        for (size_t index = 1; index < count; ++index) {
+            post([run, index]() { run(index); });
+        }
+        run(0);
+
+        // Help with queued work until the stragglers are done, but nothing less
+        // urgent than this section, which could keep its caller waiting
+        const size_t home = homeQueue();
+        const TaskPriority priority = currentPriority();
+        while (state->remaining.load(std::memory_order_acquire) != 0) {
+            if (!runOne(home, priority)) std::this_thread::yield();
+        }
+        if (state->error) std::rethrow_exception(state->error);
+    }
+};
+
+#endif // TASKSCHEDULER_H
@@ -0,0 +1,75 @@
+#include "TermDictionary.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+
+TermDictionary& TermDictionary::shared() {
+    static TermDictionary dictionary;
+    return dictionary;
+}
+
+std::string_view TermDictionary::intern(std::string_view term) {
+    return add(term).second;
+}
+
+TermId TermDictionary::internId(std::string_view term) {
+    return add(term).first;
+}
+
+std::pair<TermId, std::string_view> TermDictionary::add(std::string_view term) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(term);
+        if (it != ids.end()) return {it->second, terms[it->second]};
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    // Another indexer may have added it in between
+    auto it = ids.find(term);
+    if (it != ids.end()) return {it->second, terms[it->second]};
+
+    std::string_view stored = store(term);
+    TermId id = static_cast<TermId>(terms.size());
+    ids.emplace(stored, id);
+    terms.push_back(stored);
+    memory_charge.set(memoryUsageLocked());
+    return {id, stored};
+}
+
+std::string_view TermDictionary::store(std::string_view term) {
+    if (block_used + term.size() > BLOCK_SIZE) {
+        // A word longer than a block gets one of its own
+        blocks.push_back(std::make_unique<char[]>(std::max(BLOCK_SIZE, term.size())));
+        block_used = 0;
+    }
+    char* destination = blocks.back().get() + block_used;
+    std::memcpy(destination, term.data(), term.size());
+    block_used += term.size();
+    return std::string_view(destination, term.size());
+}
+
+TermId TermDictionary::find(std::string_view term) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(term);
+    return it != ids.end() ? it->second : NO_TERM;
+}
+
+std::string_view TermDictionary::term(TermId id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return id < terms.size() ? terms[id] : std::string_view();
+}
+
+size_t TermDictionary::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return terms.size();
+}
+
+size_t TermDictionary::getMemoryUsage() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return memoryUsageLocked();
+}
+
+size_t TermDictionary::memoryUsageLocked() const {
+    // Hash nodes are estimated as the entry plus a next pointer
+    return blocks.size() * BLOCK_SIZE + terms.capacity() * sizeof(std::string_view) +
+           ids.bucket_count() * sizeof(void*) + ids.size() * (sizeof(std::pair<std::string_view, TermId>) + sizeof(void*));
+}
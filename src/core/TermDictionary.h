@@ -0,0 +1,57 @@
+#ifndef TERMDICTIONARY_H
+#define TERMDICTIONARY_H
+
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "MemoryAccounting.h"
+
+using TermId = uint32_t;
+
+// Every index term of every translation, stored once for the whole process.
+// Translations of one language share most of their vocabulary, so indexes
+// key their postings by views into this dictionary instead of each keeping
+// its own copy of every word, and a term has the same id in all of them.
+//
+// Append-only: a term stays (and its view stays valid) after the translations
+// that used it are evicted, which bounds the dictionary by the union of the
+// vocabularies ever loaded. Lookups take a shared lock; interning a new term
+// takes the exclusive one, which indexing only does once per distinct word.
+class TermDictionary {
+public:
+    static constexpr TermId NO_TERM = UINT32_MAX;
+
+    static TermDictionary& shared();
+
+    // The stored copy of term, added if new
+    std::string_view intern(std::string_view term);
+    // The id of term, added if new
+    TermId internId(std::string_view term);
+    // NO_TERM if term was never interned
+    TermId find(std::string_view term) const;
+    std::string_view term(TermId id) const;
+
+    size_t size() const;
+    size_t getMemoryUsage() const;
+
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    mutable std::shared_mutex mutex;
+    // Text lives in fixed blocks that never move, so views stay valid as it grows
+    std::vector<std::unique_ptr<char[]>> blocks;
+    size_t block_used = BLOCK_SIZE;
+    std::vector<std::string_view> terms; // by id
+    std::unordered_map<std::string_view, TermId> ids;
+    MemoryCharge memory_charge{MemoryTag::INVERTED_INDEX};
+
+    std::string_view store(std::string_view term);
+    std::pair<TermId, std::string_view> add(std::string_view term);
+    size_t memoryUsageLocked() const;
+};
+
+#endif // TERMDICTIONARY_H
@@ -0,0 +1,80 @@
+#include "TextAnalyzer.h"
+#include "SemanticSearch.h"
+#include "TextKernels.h"
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Archaic forms no suffix rule reaches, mapped to the word they inflect
+constexpr std::pair<std::string_view, std::string_view> IRREGULAR[] = {
+    {"canst", "can"},   {"didst", "do"},    {"dost", "do"},     {"doth", "do"},     {"hadst", "have"},
+    {"hast", "have"},   {"hath", "have"},   {"saith", "say"},   {"shalt", "shall"}, {"spake", "speak"},
+    {"sware", "swear"}, {"wast", "was"},    {"wert", "were"},   {"wilt", "will"},
+};
+
+// Inflectional endings, longest first so "ieth" is tried before "eth"
+constexpr std::string_view ENDINGS[] = {"edst", "ieth", "iest", "eth", "est", "ies", "ied", "ing", "ed", "es", "s"};
+
+bool isVowel(char c) {
+    return c == 'a' || c == 'e' || c == 'i' || c == 'o' || c == 'u' || c == 'y';
+}
+
+bool endsWith(std::string_view word, std::string_view ending) {
+    return word.size() >= ending.size() && word.substr(word.size() - ending.size()) == ending;
+}
+
+// word without its inflectional ending, or word itself if none applies
+std::string_view stripEnding(std::string_view word) {
+    for (std::string_view ending : ENDINGS) {
+        if (!endsWith(word, ending)) continue;
+        std::string_view base = word.substr(0, word.size() - ending.size());
+
+        if (ending.substr(0, 2) == "ie") {
+            // "cries", "cried", "crieth" keep the i that "cry" folds to below
+            if (!base.empty()) return word.substr(0, base.size() + 1);
+            continue;
+        }
+        if (ending == "s") {
+            // "bless", "Jesus" and "this" are not plurals
+            if (endsWith(base, "s") || endsWith(base, "u") || endsWith(base, "i")) return word;
+        } else if (ending == "es") {
+            // Only "washes", "boxes" and the like lose the e with the s
+            bool sibilant = endsWith(base, "s") || endsWith(base, "x") || endsWith(base, "z") ||
+                            endsWith(base, "ch") || endsWith(base, "sh");
+            if (!sibilant) continue;
+        }
+        if (base.size() < 3 || std::none_of(base.begin(), base.end(), isVowel)) continue;
+
+        // "sinned" and "sinneth" go back to "sin"; "dwelleth" keeps its ll
+        size_t n = base.size();
+        bool doubled = n > 3 && base[n - 1] == base[n - 2] && !isVowel(base[n - 1]) &&
+                       base[n - 1] != 'l' && base[n - 1] != 's' && base[n - 1] != 'z';
+        return doubled ? base.substr(0, n - 1) : base;
+    }
+    return word;
+}
+
+}
+
+std::string TextAnalyzer::stem(std::string_view word) {
+    if (word.size() < 3 || !TextKernels::isAscii(word)) return std::string(word);
+
+    auto irregular = std::find_if(std::begin(IRREGULAR), std::end(IRREGULAR),
+                                  [word](const auto& entry) { return entry.first == word; });
+    if (irregular != std::end(IRREGULAR)) word = irregular->second;
+
+    std::string stem(word.size() > 3 ? stripEnding(word) : word);
+    // "love" meets "loved" at "lov", and "cry" meets "cried" at "cri"
+    if (stem.size() > 3 && stem.back() == 'e') {
+        stem.pop_back();
+    } else if (stem.size() >= 3 && stem.back() == 'y' && !isVowel(stem[stem.size() - 2])) {
+        stem.back() = 'i';
+    }
+    return stem;
+}
+
+bool TextAnalyzer::isStopWord(std::string_view word) {
+    const auto& words = SemanticSearch::defaultStopWords();
+    return words.find(std::string(word)) != words.end();
+}
@@ -0,0 +1,18 @@
+#ifndef TEXTANALYZER_H
+#define TEXTANALYZER_H
+
+#include <string>
+#include <string_view>
+
+// Index-time analysis of folded words (see TextFolding). stem() reduces an
+// English word to a key shared by its inflections, the KJV's archaic ones
+// included: "love", "loved", "loveth", "lovest" and "loving" all become "lov".
+// Keys are for matching only and need not be words. Words in other scripts
+// are their own stems. Stop words are SemanticSearch's list.
+class TextAnalyzer {
+public:
+    static std::string stem(std::string_view word);
+    static bool isStopWord(std::string_view word);
+};
+
+#endif // TEXTANALYZER_H
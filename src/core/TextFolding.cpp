@@ -0,0 +1,165 @@
+#include "TextFolding.h"
+#include "TextFoldingTables.h"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+
+namespace {
+
+using namespace text_folding_tables;
+
+constexpr uint32_t INVALID = 0xFFFFFFFF;
+
+// Combining marks that only carry accents, vowel points or breathing:
+// dropped from words rather than splitting them
+constexpr CodeRange DROPPED_MARKS[] = {
+    {0x0300, 0x036F}, // combining diacritics, incl. Greek accents and iota subscript
+    {0x0483, 0x0489}, // Cyrillic titlo
+    {0x0591, 0x05BD}, {0x05BF, 0x05BF}, {0x05C1, 0x05C2}, {0x05C4, 0x05C5}, {0x05C7, 0x05C7}, // Hebrew points
+    {0x0610, 0x061A}, {0x064B, 0x065F}, {0x0670, 0x0670}, // Arabic harakat
+    {0x1AB0, 0x1AFF}, {0x1DC0, 0x1DFF}, {0x20D0, 0x20FF}, {0xFE20, 0xFE2F},
+};
+
+bool inRanges(const CodeRange* begin, const CodeRange* end, uint32_t code) {
+    const CodeRange* it = std::upper_bound(begin, end, code,
+                                           [](uint32_t c, const CodeRange& range) { return c < range.first; });
+    return it != begin && code <= std::prev(it)->last;
+}
+
+// Next code point, advancing text; INVALID for a malformed sequence, which
+// skips one byte
+uint32_t decode(std::string_view& text) {
+    auto byte = [&text](size_t i) { return static_cast<unsigned char>(text[i]); };
+    unsigned char lead = byte(0);
+    size_t length = lead < 0x80 ? 1 : lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC2 ? 2 : 0;
+    if (length == 0 || length > text.size()) {
+        text.remove_prefix(1);
+        return INVALID;
+    }
+
+    uint32_t code = length == 1 ? lead : lead & (0x7F >> length);
+    for (size_t i = 1; i < length; ++i) {
+        if ((byte(i) & 0xC0) != 0x80) {
+            text.remove_prefix(1);
+            return INVALID;
+        }
+        code = (code << 6) | (byte(i) & 0x3F);
+    }
+    text.remove_prefix(length);
+    return code;
+}
+
+void encode(uint32_t code, std::string& out) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+bool isSeparator(uint32_t code) {
+    if (code < 0x80) return !TextKernels::isWordChar(static_cast<unsigned char>(code));
+    return code == INVALID || inRanges(std::begin(SEPARATORS), std::end(SEPARATORS), code);
+}
+
+void appendFolded(uint32_t code, std::string& out) {
+    if (code < 0x80) {
+        out += TextKernels::toLower(static_cast<char>(code));
+        return;
+    }
+    if (inRanges(std::begin(DROPPED_MARKS), std::end(DROPPED_MARKS), code)) {
+        return;
+    }
+
+    const FoldRun* run = std::upper_bound(std::begin(FOLD_RUNS), std::end(FOLD_RUNS), code,
+                                          [](uint32_t c, const FoldRun& r) { return c < r.first; });
+    if (run != std::begin(FOLD_RUNS) && code <= std::prev(run)->last) {
+        run = std::prev(run);
+        encode(run->target + (code - run->first) * run->step, out);
+        return;
+    }
+
+    const FoldExpansion* expansion = std::lower_bound(std::begin(FOLD_EXPANSIONS), std::end(FOLD_EXPANSIONS), code,
+                                                      [](const FoldExpansion& e, uint32_t c) { return e.code < c; });
+    if (expansion != std::end(FOLD_EXPANSIONS) && expansion->code == code) {
+        out += expansion->folded;
+        return;
+    }
+    encode(code, out);
+}
+
+// foldWords(), also noting where each word came from when spans is given
+std::string foldWordsWithSpans(std::string_view text, std::vector<uint32_t>* spans) {
+    const char* const start = text.data();
+    std::string words;
+    words.reserve(text.size());
+    bool pending_space = false;
+    bool in_word = false;
+    while (!text.empty()) {
+        uint32_t begin = static_cast<uint32_t>(text.data() - start);
+        uint32_t code = decode(text);
+        if (isSeparator(code)) {
+            pending_space = !words.empty();
+            in_word = false;
+            continue;
+        }
+
+        size_t word_end = words.size();
+        if (pending_space) words += ' ';
+        size_t before = words.size();
+        appendFolded(code, words);
+        if (words.size() > before) {
+            pending_space = false;
+            if (spans && !in_word) {
+                spans->push_back(begin);
+                spans->push_back(begin);
+            }
+            in_word = true;
+        } else {
+            // Only a dropped mark so far: the next word has not started
+            words.resize(word_end);
+        }
+        // A mark inside a word still belongs to it
+        if (spans && in_word) spans->back() = static_cast<uint32_t>(text.data() - start);
+    }
+    return words;
+}
+
+}
+
+std::string TextFolding::foldWords(std::string_view text) {
+    return foldWordsWithSpans(text, nullptr);
+}
+
+std::string TextFolding::foldWords(std::string_view text, std::vector<uint32_t>& spans) {
+    return foldWordsWithSpans(text, &spans);
+}
+
+std::string TextFolding::fold(std::string_view text) {
+    if (TextKernels::isAscii(text)) return TextKernels::toLower(text);
+
+    std::string folded;
+    folded.reserve(text.size());
+    while (!text.empty()) {
+        std::string_view rest = text;
+        uint32_t code = decode(text);
+        if (code == INVALID) {
+            folded += rest.front();
+        } else if (isSeparator(code)) {
+            encode(code, folded);
+        } else {
+            appendFolded(code, folded);
+        }
+    }
+    return folded;
+}
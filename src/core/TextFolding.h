@@ -0,0 +1,76 @@
+#ifndef TEXTFOLDING_H
+#define TEXTFOLDING_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "TextKernels.h"
+
+// Search keys for UTF-8 text in any script. Words break at Unicode
+// punctuation, symbols and spaces rather than at every non-ASCII byte, and
+// each word is folded: compatibility forms and case are unified and accents
+// dropped, so "Éternel", "ÉTERNEL" and "eternel" share a key, as do "Θεός"
+// and "θεος". Folding is table-driven (see TextFoldingTables.h), so indexing
+// and queries pay one lookup per non-ASCII character and no library calls;
+// pure ASCII text goes straight through TextKernels with the same result it
+// always had.
+class TextFolding {
+public:
+    // Calls on_word(std::string_view) with each folded word of text, in order
+    template <typename OnWord>
+    static void forEachWord(std::string_view text, OnWord&& on_word);
+    // The same words, each with the [begin, end) byte range of text it was
+    // folded from: on_word(std::string_view, size_t begin, size_t end)
+    template <typename OnWord>
+    static void forEachWordSpan(std::string_view text, OnWord&& on_word);
+
+    // Folded words of text joined by single spaces
+    static std::string foldWords(std::string_view text);
+    // The same, appending each word's begin and end byte in text to spans
+    static std::string foldWords(std::string_view text, std::vector<uint32_t>& spans);
+    // text folded as a whole with its separators kept, for substring matching
+    static std::string fold(std::string_view text);
+};
+
+template <typename OnWord>
+void TextFolding::forEachWord(std::string_view text, OnWord&& on_word) {
+    if (TextKernels::isAscii(text)) {
+        std::string lowered = TextKernels::toLower(text);
+        TextKernels::forEachWord(lowered, on_word);
+        return;
+    }
+
+    std::string words = foldWords(text);
+    std::string_view rest = words;
+    while (!rest.empty()) {
+        size_t end = rest.find(' ');
+        on_word(rest.substr(0, end));
+        if (end == std::string_view::npos) break;
+        rest.remove_prefix(end + 1);
+    }
+}
+
+template <typename OnWord>
+void TextFolding::forEachWordSpan(std::string_view text, OnWord&& on_word) {
+    if (TextKernels::isAscii(text)) {
+        // Lowering ASCII leaves every byte where it was
+        std::string lowered = TextKernels::toLower(text);
+        TextKernels::forEachWord(lowered, [&](std::string_view word) {
+            size_t begin = static_cast<size_t>(word.data() - lowered.data());
+            on_word(word, begin, begin + word.size());
+        });
+        return;
+    }
+
+    std::vector<uint32_t> spans;
+    std::string words = foldWords(text, spans);
+    std::string_view rest = words;
+    for (size_t i = 0; i + 1 < spans.size(); i += 2) {
+        size_t end = rest.find(' ');
+        on_word(rest.substr(0, end), spans[i], spans[i + 1]);
+        if (end == std::string_view::npos) break;
+        rest.remove_prefix(end + 1);
+    }
+}
+
+#endif // TEXTFOLDING_H
@@ -0,0 +1,204 @@
+#ifndef TEXTFOLDINGTABLES_H
+#define TEXTFOLDINGTABLES_H
+
+// Generated from the Unicode 14.0.0 character database; included only by
+// TextFolding.cpp. For every letter or number in the Latin, Greek, Cyrillic,
+// Armenian, letterlike, ligature and fullwidth blocks, the folded form is
+// NFKD, then dropping combining marks, then full case folding, then NFC.
+// Code points not listed fold to themselves.
+
+#include <cstdint>
+
+namespace text_folding_tables {
+
+// [first, last] fold to target + (code - first) * step
+struct FoldRun {
+    uint32_t first;
+    uint32_t last;
+    uint32_t target;
+    uint32_t step;
+};
+
+// Code points that fold to more than one character, as UTF-8
+struct FoldExpansion {
+    uint32_t code;
+    const char* folded;
+};
+
+struct CodeRange {
+    uint32_t first;
+    uint32_t last;
+};
+
+constexpr FoldRun FOLD_RUNS[] = {
+    {0x00AA, 0x00AA, 0x0061, 0}, {0x00B2, 0x00B3, 0x0032, 1}, {0x00B5, 0x00B5, 0x03BC, 0}, {0x00B9, 0x00B9, 0x0031, 0},
+    {0x00BA, 0x00BA, 0x006F, 0}, {0x00C0, 0x00C5, 0x0061, 0}, {0x00C6, 0x00C6, 0x00E6, 0}, {0x00C7, 0x00C7, 0x0063, 0},
+    {0x00C8, 0x00CB, 0x0065, 0}, {0x00CC, 0x00CF, 0x0069, 0}, {0x00D0, 0x00D0, 0x00F0, 0}, {0x00D1, 0x00D2, 0x006E, 1},
+    {0x00D3, 0x00D6, 0x006F, 0}, {0x00D8, 0x00D8, 0x00F8, 0}, {0x00D9, 0x00DC, 0x0075, 0}, {0x00DD, 0x00DD, 0x0079, 0},
+    {0x00DE, 0x00DE, 0x00FE, 0}, {0x00E0, 0x00E5, 0x0061, 0}, {0x00E7, 0x00E7, 0x0063, 0}, {0x00E8, 0x00EB, 0x0065, 0},
+    {0x00EC, 0x00EF, 0x0069, 0}, {0x00F1, 0x00F2, 0x006E, 1}, {0x00F3, 0x00F6, 0x006F, 0}, {0x00F9, 0x00FC, 0x0075, 0},
+    {0x00FD, 0x00FD, 0x0079, 0}, {0x00FF, 0x00FF, 0x0079, 0}, {0x0100, 0x0105, 0x0061, 0}, {0x0106, 0x010D, 0x0063, 0},
+    {0x010E, 0x010F, 0x0064, 0}, {0x0110, 0x0110, 0x0111, 0}, {0x0112, 0x011B, 0x0065, 0}, {0x011C, 0x0123, 0x0067, 0},
+    {0x0124, 0x0125, 0x0068, 0}, {0x0126, 0x0126, 0x0127, 0}, {0x0128, 0x0130, 0x0069, 0}, {0x0134, 0x0135, 0x006A, 0},
+    {0x0136, 0x0137, 0x006B, 0}, {0x0139, 0x013E, 0x006C, 0}, {0x0141, 0x0141, 0x0142, 0}, {0x0143, 0x0148, 0x006E, 0},
+    {0x014A, 0x014A, 0x014B, 0}, {0x014C, 0x0151, 0x006F, 0}, {0x0152, 0x0152, 0x0153, 0}, {0x0154, 0x0159, 0x0072, 0},
+    {0x015A, 0x0161, 0x0073, 0}, {0x0162, 0x0165, 0x0074, 0}, {0x0166, 0x0166, 0x0167, 0}, {0x0168, 0x0173, 0x0075, 0},
+    {0x0174, 0x0175, 0x0077, 0}, {0x0176, 0x0178, 0x0079, 0}, {0x0179, 0x017E, 0x007A, 0}, {0x017F, 0x017F, 0x0073, 0},
+    {0x0181, 0x0181, 0x0253, 0}, {0x0182, 0x0182, 0x0183, 0}, {0x0184, 0x0184, 0x0185, 0}, {0x0186, 0x0186, 0x0254, 0},
+    {0x0187, 0x0187, 0x0188, 0}, {0x0189, 0x018A, 0x0256, 1}, {0x018B, 0x018B, 0x018C, 0}, {0x018E, 0x018E, 0x01DD, 0},
+    {0x018F, 0x018F, 0x0259, 0}, {0x0190, 0x0190, 0x025B, 0}, {0x0191, 0x0191, 0x0192, 0}, {0x0193, 0x0193, 0x0260, 0},
+    {0x0194, 0x0194, 0x0263, 0}, {0x0196, 0x0196, 0x0269, 0}, {0x0197, 0x0197, 0x0268, 0}, {0x0198, 0x0198, 0x0199, 0},
+    {0x019C, 0x019C, 0x026F, 0}, {0x019D, 0x019D, 0x0272, 0}, {0x019F, 0x019F, 0x0275, 0}, {0x01A0, 0x01A1, 0x006F, 0},
+    {0x01A2, 0x01A2, 0x01A3, 0}, {0x01A4, 0x01A4, 0x01A5, 0}, {0x01A6, 0x01A6, 0x0280, 0}, {0x01A7, 0x01A7, 0x01A8, 0},
+    {0x01A9, 0x01A9, 0x0283, 0}, {0x01AC, 0x01AC, 0x01AD, 0}, {0x01AE, 0x01AE, 0x0288, 0}, {0x01AF, 0x01B0, 0x0075, 0},
+    {0x01B1, 0x01B2, 0x028A, 1}, {0x01B3, 0x01B3, 0x01B4, 0}, {0x01B5, 0x01B5, 0x01B6, 0}, {0x01B7, 0x01B7, 0x0292, 0},
+    {0x01B8, 0x01B8, 0x01B9, 0}, {0x01BC, 0x01BC, 0x01BD, 0}, {0x01CD, 0x01CE, 0x0061, 0}, {0x01CF, 0x01D0, 0x0069, 0},
+    {0x01D1, 0x01D2, 0x006F, 0}, {0x01D3, 0x01DC, 0x0075, 0}, {0x01DE, 0x01E1, 0x0061, 0}, {0x01E2, 0x01E3, 0x00E6, 0},
+    {0x01E4, 0x01E4, 0x01E5, 0}, {0x01E6, 0x01E7, 0x0067, 0}, {0x01E8, 0x01E9, 0x006B, 0}, {0x01EA, 0x01ED, 0x006F, 0},
+    {0x01EE, 0x01EF, 0x0292, 0}, {0x01F0, 0x01F0, 0x006A, 0}, {0x01F4, 0x01F5, 0x0067, 0}, {0x01F6, 0x01F6, 0x0195, 0},
+    {0x01F7, 0x01F7, 0x01BF, 0}, {0x01F8, 0x01F9, 0x006E, 0}, {0x01FA, 0x01FB, 0x0061, 0}, {0x01FC, 0x01FD, 0x00E6, 0},
+    {0x01FE, 0x01FF, 0x00F8, 0}, {0x0200, 0x0203, 0x0061, 0}, {0x0204, 0x0207, 0x0065, 0}, {0x0208, 0x020B, 0x0069, 0},
+    {0x020C, 0x020F, 0x006F, 0}, {0x0210, 0x0213, 0x0072, 0}, {0x0214, 0x0217, 0x0075, 0}, {0x0218, 0x0219, 0x0073, 0},
+    {0x021A, 0x021B, 0x0074, 0}, {0x021C, 0x021C, 0x021D, 0}, {0x021E, 0x021F, 0x0068, 0}, {0x0220, 0x0220, 0x019E, 0},
+    {0x0222, 0x0222, 0x0223, 0}, {0x0224, 0x0224, 0x0225, 0}, {0x0226, 0x0227, 0x0061, 0}, {0x0228, 0x0229, 0x0065, 0},
+    {0x022A, 0x0231, 0x006F, 0}, {0x0232, 0x0233, 0x0079, 0}, {0x023A, 0x023A, 0x2C65, 0}, {0x023B, 0x023B, 0x023C, 0},
+    {0x023D, 0x023D, 0x019A, 0}, {0x023E, 0x023E, 0x2C66, 0}, {0x0241, 0x0241, 0x0242, 0}, {0x0243, 0x0243, 0x0180, 0},
+    {0x0244, 0x0244, 0x0289, 0}, {0x0245, 0x0245, 0x028C, 0}, {0x0246, 0x0246, 0x0247, 0}, {0x0248, 0x0248, 0x0249, 0},
+    {0x024A, 0x024A, 0x024B, 0}, {0x024C, 0x024C, 0x024D, 0}, {0x024E, 0x024E, 0x024F, 0}, {0x0370, 0x0370, 0x0371, 0},
+    {0x0372, 0x0372, 0x0373, 0}, {0x0374, 0x0374, 0x02B9, 0}, {0x0376, 0x0376, 0x0377, 0}, {0x037F, 0x037F, 0x03F3, 0},
+    {0x0386, 0x0386, 0x03B1, 0}, {0x0388, 0x0388, 0x03B5, 0}, {0x0389, 0x0389, 0x03B7, 0}, {0x038A, 0x038A, 0x03B9, 0},
+    {0x038C, 0x038C, 0x03BF, 0}, {0x038E, 0x038E, 0x03C5, 0}, {0x038F, 0x038F, 0x03C9, 0}, {0x0390, 0x0390, 0x03B9, 0},
+    {0x0391, 0x03A1, 0x03B1, 1}, {0x03A3, 0x03A9, 0x03C3, 1}, {0x03AA, 0x03AA, 0x03B9, 0}, {0x03AB, 0x03AB, 0x03C5, 0},
+    {0x03AC, 0x03AC, 0x03B1, 0}, {0x03AD, 0x03AD, 0x03B5, 0}, {0x03AE, 0x03AE, 0x03B7, 0}, {0x03AF, 0x03AF, 0x03B9, 0},
+    {0x03B0, 0x03B0, 0x03C5, 0}, {0x03C2, 0x03C2, 0x03C3, 0}, {0x03CA, 0x03CA, 0x03B9, 0}, {0x03CB, 0x03CB, 0x03C5, 0},
+    {0x03CC, 0x03CC, 0x03BF, 0}, {0x03CD, 0x03CD, 0x03C5, 0}, {0x03CE, 0x03CE, 0x03C9, 0}, {0x03CF, 0x03CF, 0x03D7, 0},
+    {0x03D0, 0x03D0, 0x03B2, 0}, {0x03D1, 0x03D1, 0x03B8, 0}, {0x03D2, 0x03D4, 0x03C5, 0}, {0x03D5, 0x03D5, 0x03C6, 0},
+    {0x03D6, 0x03D6, 0x03C0, 0}, {0x03D8, 0x03D8, 0x03D9, 0}, {0x03DA, 0x03DA, 0x03DB, 0}, {0x03DC, 0x03DC, 0x03DD, 0},
+    {0x03DE, 0x03DE, 0x03DF, 0}, {0x03E0, 0x03E0, 0x03E1, 0}, {0x03E2, 0x03E2, 0x03E3, 0}, {0x03E4, 0x03E4, 0x03E5, 0},
+    {0x03E6, 0x03E6, 0x03E7, 0}, {0x03E8, 0x03E8, 0x03E9, 0}, {0x03EA, 0x03EA, 0x03EB, 0}, {0x03EC, 0x03EC, 0x03ED, 0},
+    {0x03EE, 0x03EE, 0x03EF, 0}, {0x03F0, 0x03F0, 0x03BA, 0}, {0x03F1, 0x03F1, 0x03C1, 0}, {0x03F2, 0x03F2, 0x03C3, 0},
+    {0x03F4, 0x03F4, 0x03B8, 0}, {0x03F5, 0x03F5, 0x03B5, 0}, {0x03F7, 0x03F7, 0x03F8, 0}, {0x03F9, 0x03F9, 0x03C3, 0},
+    {0x03FA, 0x03FA, 0x03FB, 0}, {0x03FD, 0x03FF, 0x037B, 1}, {0x0400, 0x0401, 0x0435, 0}, {0x0402, 0x0402, 0x0452, 0},
+    {0x0403, 0x0403, 0x0433, 0}, {0x0404, 0x0406, 0x0454, 1}, {0x0407, 0x0407, 0x0456, 0}, {0x0408, 0x040B, 0x0458, 1},
+    {0x040C, 0x040C, 0x043A, 0}, {0x040D, 0x040D, 0x0438, 0}, {0x040E, 0x040E, 0x0443, 0}, {0x040F, 0x040F, 0x045F, 0},
+    {0x0410, 0x0418, 0x0430, 1}, {0x0419, 0x0419, 0x0438, 0}, {0x041A, 0x042F, 0x043A, 1}, {0x0439, 0x0439, 0x0438, 0},
+    {0x0450, 0x0451, 0x0435, 0}, {0x0453, 0x0453, 0x0433, 0}, {0x0457, 0x0457, 0x0456, 0}, {0x045C, 0x045C, 0x043A, 0},
+    {0x045D, 0x045D, 0x0438, 0}, {0x045E, 0x045E, 0x0443, 0}, {0x0460, 0x0460, 0x0461, 0}, {0x0462, 0x0462, 0x0463, 0},
+    {0x0464, 0x0464, 0x0465, 0}, {0x0466, 0x0466, 0x0467, 0}, {0x0468, 0x0468, 0x0469, 0}, {0x046A, 0x046A, 0x046B, 0},
+    {0x046C, 0x046C, 0x046D, 0}, {0x046E, 0x046E, 0x046F, 0}, {0x0470, 0x0470, 0x0471, 0}, {0x0472, 0x0472, 0x0473, 0},
+    {0x0474, 0x0474, 0x0475, 0}, {0x0476, 0x0477, 0x0475, 0}, {0x0478, 0x0478, 0x0479, 0}, {0x047A, 0x047A, 0x047B, 0},
+    {0x047C, 0x047C, 0x047D, 0}, {0x047E, 0x047E, 0x047F, 0}, {0x0480, 0x0480, 0x0481, 0}, {0x048A, 0x048A, 0x048B, 0},
+    {0x048C, 0x048C, 0x048D, 0}, {0x048E, 0x048E, 0x048F, 0}, {0x0490, 0x0490, 0x0491, 0}, {0x0492, 0x0492, 0x0493, 0},
+    {0x0494, 0x0494, 0x0495, 0}, {0x0496, 0x0496, 0x0497, 0}, {0x0498, 0x0498, 0x0499, 0}, {0x049A, 0x049A, 0x049B, 0},
+    {0x049C, 0x049C, 0x049D, 0}, {0x049E, 0x049E, 0x049F, 0}, {0x04A0, 0x04A0, 0x04A1, 0}, {0x04A2, 0x04A2, 0x04A3, 0},
+    {0x04A4, 0x04A4, 0x04A5, 0}, {0x04A6, 0x04A6, 0x04A7, 0}, {0x04A8, 0x04A8, 0x04A9, 0}, {0x04AA, 0x04AA, 0x04AB, 0},
+    {0x04AC, 0x04AC, 0x04AD, 0}, {0x04AE, 0x04AE, 0x04AF, 0}, {0x04B0, 0x04B0, 0x04B1, 0}, {0x04B2, 0x04B2, 0x04B3, 0},
+    {0x04B4, 0x04B4, 0x04B5, 0}, {0x04B6, 0x04B6, 0x04B7, 0}, {0x04B8, 0x04B8, 0x04B9, 0}, {0x04BA, 0x04BA, 0x04BB, 0},
+    {0x04BC, 0x04BC, 0x04BD, 0}, {0x04BE, 0x04BE, 0x04BF, 0}, {0x04C0, 0x04C0, 0x04CF, 0}, {0x04C1, 0x04C2, 0x0436, 0},
+    {0x04C3, 0x04C3, 0x04C4, 0}, {0x04C5, 0x04C5, 0x04C6, 0}, {0x04C7, 0x04C7, 0x04C8, 0}, {0x04C9, 0x04C9, 0x04CA, 0},
+    {0x04CB, 0x04CB, 0x04CC, 0}, {0x04CD, 0x04CD, 0x04CE, 0}, {0x04D0, 0x04D3, 0x0430, 0}, {0x04D4, 0x04D4, 0x04D5, 0},
+    {0x04D6, 0x04D7, 0x0435, 0}, {0x04D8, 0x04D8, 0x04D9, 0}, {0x04DA, 0x04DB, 0x04D9, 0}, {0x04DC, 0x04DD, 0x0436, 0},
+    {0x04DE, 0x04DF, 0x0437, 0}, {0x04E0, 0x04E0, 0x04E1, 0}, {0x04E2, 0x04E5, 0x0438, 0}, {0x04E6, 0x04E7, 0x043E, 0},
+    {0x04E8, 0x04E8, 0x04E9, 0}, {0x04EA, 0x04EB, 0x04E9, 0}, {0x04EC, 0x04ED, 0x044D, 0}, {0x04EE, 0x04F3, 0x0443, 0},
+    {0x04F4, 0x04F5, 0x0447, 0}, {0x04F6, 0x04F6, 0x04F7, 0}, {0x04F8, 0x04F9, 0x044B, 0}, {0x04FA, 0x04FA, 0x04FB, 0},
+    {0x04FC, 0x04FC, 0x04FD, 0}, {0x04FE, 0x04FE, 0x04FF, 0}, {0x0500, 0x0500, 0x0501, 0}, {0x0502, 0x0502, 0x0503, 0},
+    {0x0504, 0x0504, 0x0505, 0}, {0x0506, 0x0506, 0x0507, 0}, {0x0508, 0x0508, 0x0509, 0}, {0x050A, 0x050A, 0x050B, 0},
+    {0x050C, 0x050C, 0x050D, 0}, {0x050E, 0x050E, 0x050F, 0}, {0x0510, 0x0510, 0x0511, 0}, {0x0512, 0x0512, 0x0513, 0},
+    {0x0514, 0x0514, 0x0515, 0}, {0x0516, 0x0516, 0x0517, 0}, {0x0518, 0x0518, 0x0519, 0}, {0x051A, 0x051A, 0x051B, 0},
+    {0x051C, 0x051C, 0x051D, 0}, {0x051E, 0x051E, 0x051F, 0}, {0x0520, 0x0520, 0x0521, 0}, {0x0522, 0x0522, 0x0523, 0},
+    {0x0524, 0x0524, 0x0525, 0}, {0x0526, 0x0526, 0x0527, 0}, {0x0528, 0x0528, 0x0529, 0}, {0x052A, 0x052A, 0x052B, 0},
+    {0x052C, 0x052C, 0x052D, 0}, {0x052E, 0x052E, 0x052F, 0}, {0x0531, 0x0556, 0x0561, 1}, {0x1E00, 0x1E01, 0x0061, 0},
+    {0x1E02, 0x1E07, 0x0062, 0}, {0x1E08, 0x1E09, 0x0063, 0}, {0x1E0A, 0x1E13, 0x0064, 0}, {0x1E14, 0x1E1D, 0x0065, 0},
+    {0x1E1E, 0x1E1F, 0x0066, 0}, {0x1E20, 0x1E21, 0x0067, 0}, {0x1E22, 0x1E2B, 0x0068, 0}, {0x1E2C, 0x1E2F, 0x0069, 0},
+    {0x1E30, 0x1E35, 0x006B, 0}, {0x1E36, 0x1E3D, 0x006C, 0}, {0x1E3E, 0x1E43, 0x006D, 0}, {0x1E44, 0x1E4B, 0x006E, 0},
+    {0x1E4C, 0x1E53, 0x006F, 0}, {0x1E54, 0x1E57, 0x0070, 0}, {0x1E58, 0x1E5F, 0x0072, 0}, {0x1E60, 0x1E69, 0x0073, 0},
+    {0x1E6A, 0x1E71, 0x0074, 0}, {0x1E72, 0x1E7B, 0x0075, 0}, {0x1E7C, 0x1E7F, 0x0076, 0}, {0x1E80, 0x1E89, 0x0077, 0},
+    {0x1E8A, 0x1E8D, 0x0078, 0}, {0x1E8E, 0x1E8F, 0x0079, 0}, {0x1E90, 0x1E95, 0x007A, 0}, {0x1E96, 0x1E96, 0x0068, 0},
+    {0x1E97, 0x1E97, 0x0074, 0}, {0x1E98, 0x1E98, 0x0077, 0}, {0x1E99, 0x1E99, 0x0079, 0}, {0x1E9B, 0x1E9B, 0x0073, 0},
+    {0x1EA0, 0x1EB7, 0x0061, 0}, {0x1EB8, 0x1EC7, 0x0065, 0}, {0x1EC8, 0x1ECB, 0x0069, 0}, {0x1ECC, 0x1EE3, 0x006F, 0},
+    {0x1EE4, 0x1EF1, 0x0075, 0}, {0x1EF2, 0x1EF9, 0x0079, 0}, {0x1EFA, 0x1EFA, 0x1EFB, 0}, {0x1EFC, 0x1EFC, 0x1EFD, 0},
+    {0x1EFE, 0x1EFE, 0x1EFF, 0}, {0x1F00, 0x1F0F, 0x03B1, 0}, {0x1F10, 0x1F15, 0x03B5, 0}, {0x1F18, 0x1F1D, 0x03B5, 0},
+    {0x1F20, 0x1F2F, 0x03B7, 0}, {0x1F30, 0x1F3F, 0x03B9, 0}, {0x1F40, 0x1F45, 0x03BF, 0}, {0x1F48, 0x1F4D, 0x03BF, 0},
+    {0x1F50, 0x1F57, 0x03C5, 0}, {0x1F59, 0x1F59, 0x03C5, 0}, {0x1F5B, 0x1F5B, 0x03C5, 0}, {0x1F5D, 0x1F5D, 0x03C5, 0},
+    {0x1F5F, 0x1F5F, 0x03C5, 0}, {0x1F60, 0x1F6F, 0x03C9, 0}, {0x1F70, 0x1F71, 0x03B1, 0}, {0x1F72, 0x1F73, 0x03B5, 0},
+    {0x1F74, 0x1F75, 0x03B7, 0}, {0x1F76, 0x1F77, 0x03B9, 0}, {0x1F78, 0x1F79, 0x03BF, 0}, {0x1F7A, 0x1F7B, 0x03C5, 0},
+    {0x1F7C, 0x1F7D, 0x03C9, 0}, {0x1F80, 0x1F8F, 0x03B1, 0}, {0x1F90, 0x1F9F, 0x03B7, 0}, {0x1FA0, 0x1FAF, 0x03C9, 0},
+    {0x1FB0, 0x1FB4, 0x03B1, 0}, {0x1FB6, 0x1FBC, 0x03B1, 0}, {0x1FBE, 0x1FBE, 0x03B9, 0}, {0x1FC2, 0x1FC4, 0x03B7, 0},
+    {0x1FC6, 0x1FC7, 0x03B7, 0}, {0x1FC8, 0x1FC9, 0x03B5, 0}, {0x1FCA, 0x1FCC, 0x03B7, 0}, {0x1FD0, 0x1FD3, 0x03B9, 0},
+    {0x1FD6, 0x1FDB, 0x03B9, 0}, {0x1FE0, 0x1FE3, 0x03C5, 0}, {0x1FE4, 0x1FE5, 0x03C1, 0}, {0x1FE6, 0x1FEB, 0x03C5, 0},
+    {0x1FEC, 0x1FEC, 0x03C1, 0}, {0x1FF2, 0x1FF4, 0x03C9, 0}, {0x1FF6, 0x1FF7, 0x03C9, 0}, {0x1FF8, 0x1FF9, 0x03BF, 0},
+    {0x1FFA, 0x1FFC, 0x03C9, 0}, {0x2160, 0x2160, 0x0069, 0}, {0x2164, 0x2164, 0x0076, 0}, {0x2169, 0x2169, 0x0078, 0},
+    {0x216C, 0x216C, 0x006C, 0}, {0x216D, 0x216E, 0x0063, 1}, {0x216F, 0x216F, 0x006D, 0}, {0x2170, 0x2170, 0x0069, 0},
+    {0x2174, 0x2174, 0x0076, 0}, {0x2179, 0x2179, 0x0078, 0}, {0x217C, 0x217C, 0x006C, 0}, {0x217D, 0x217E, 0x0063, 1},
+    {0x217F, 0x217F, 0x006D, 0}, {0xFF10, 0xFF19, 0x0030, 1}, {0xFF21, 0xFF3A, 0x0061, 1}, {0xFF41, 0xFF5A, 0x0061, 1},
+    {0xFF66, 0xFF66, 0x30F2, 0}, {0xFF67, 0xFF67, 0x30A1, 0}, {0xFF68, 0xFF68, 0x30A3, 0}, {0xFF69, 0xFF69, 0x30A5, 0},
+    {0xFF6A, 0xFF6A, 0x30A7, 0}, {0xFF6B, 0xFF6B, 0x30A9, 0}, {0xFF6C, 0xFF6C, 0x30E3, 0}, {0xFF6D, 0xFF6D, 0x30E5, 0},
+    {0xFF6E, 0xFF6E, 0x30E7, 0}, {0xFF6F, 0xFF6F, 0x30C3, 0}, {0xFF70, 0xFF70, 0x30FC, 0}, {0xFF71, 0xFF71, 0x30A2, 0},
+    {0xFF72, 0xFF72, 0x30A4, 0}, {0xFF73, 0xFF73, 0x30A6, 0}, {0xFF74, 0xFF74, 0x30A8, 0}, {0xFF75, 0xFF76, 0x30AA, 1},
+    {0xFF77, 0xFF77, 0x30AD, 0}, {0xFF78, 0xFF78, 0x30AF, 0}, {0xFF79, 0xFF79, 0x30B1, 0}, {0xFF7A, 0xFF7A, 0x30B3, 0},
+    {0xFF7B, 0xFF7B, 0x30B5, 0}, {0xFF7C, 0xFF7C, 0x30B7, 0}, {0xFF7D, 0xFF7D, 0x30B9, 0}, {0xFF7E, 0xFF7E, 0x30BB, 0},
+    {0xFF7F, 0xFF7F, 0x30BD, 0}, {0xFF80, 0xFF80, 0x30BF, 0}, {0xFF81, 0xFF81, 0x30C1, 0}, {0xFF82, 0xFF82, 0x30C4, 0},
+    {0xFF83, 0xFF83, 0x30C6, 0}, {0xFF84, 0xFF84, 0x30C8, 0}, {0xFF85, 0xFF8A, 0x30CA, 1}, {0xFF8B, 0xFF8B, 0x30D2, 0},
+    {0xFF8C, 0xFF8C, 0x30D5, 0}, {0xFF8D, 0xFF8D, 0x30D8, 0}, {0xFF8E, 0xFF8E, 0x30DB, 0}, {0xFF8F, 0xFF93, 0x30DE, 1},
+    {0xFF94, 0xFF94, 0x30E4, 0}, {0xFF95, 0xFF95, 0x30E6, 0}, {0xFF96, 0xFF9B, 0x30E8, 1}, {0xFF9C, 0xFF9C, 0x30EF, 0},
+    {0xFF9D, 0xFF9D, 0x30F3, 0}, {0xFFA0, 0xFFA0, 0x1160, 0}, {0xFFA1, 0xFFA2, 0x1100, 1}, {0xFFA3, 0xFFA3, 0x11AA, 0},
+    {0xFFA4, 0xFFA4, 0x1102, 0}, {0xFFA5, 0xFFA6, 0x11AC, 1}, {0xFFA7, 0xFFA9, 0x1103, 1}, {0xFFAA, 0xFFAF, 0x11B0, 1},
+    {0xFFB0, 0xFFB0, 0x111A, 0}, {0xFFB1, 0xFFB3, 0x1106, 1}, {0xFFB4, 0xFFB4, 0x1121, 0}, {0xFFB5, 0xFFBE, 0x1109, 1},
+    {0xFFC2, 0xFFC7, 0x1161, 1}, {0xFFCA, 0xFFCF, 0x1167, 1}, {0xFFD2, 0xFFD7, 0x116D, 1}, {0xFFDA, 0xFFDC, 0x1173, 1},
+};
+
+constexpr FoldExpansion FOLD_EXPANSIONS[] = {
+    {0x00DF, "\x73\x73"}, {0x0132, "\x69\x6a"}, {0x0133, "\x69\x6a"}, {0x0149, "\xca\xbc\x6e"},
+    {0x01C4, "\x64\x7a"}, {0x01C5, "\x64\x7a"}, {0x01C6, "\x64\x7a"}, {0x01C7, "\x6c\x6a"},
+    {0x01C8, "\x6c\x6a"}, {0x01C9, "\x6c\x6a"}, {0x01CA, "\x6e\x6a"}, {0x01CB, "\x6e\x6a"},
+    {0x01CC, "\x6e\x6a"}, {0x01F1, "\x64\x7a"}, {0x01F2, "\x64\x7a"}, {0x01F3, "\x64\x7a"},
+    {0x0587, "\xd5\xa5\xd6\x82"}, {0x1E9A, "\x61\xca\xbe"}, {0x1E9E, "\x73\x73"}, {0x2161, "\x69\x69"},
+    {0x2162, "\x69\x69\x69"}, {0x2163, "\x69\x76"}, {0x2165, "\x76\x69"}, {0x2166, "\x76\x69\x69"},
+    {0x2167, "\x76\x69\x69\x69"}, {0x2168, "\x69\x78"}, {0x216A, "\x78\x69"}, {0x216B, "\x78\x69\x69"},
+    {0x2171, "\x69\x69"}, {0x2172, "\x69\x69\x69"}, {0x2173, "\x69\x76"}, {0x2175, "\x76\x69"},
+    {0x2176, "\x76\x69\x69"}, {0x2177, "\x76\x69\x69\x69"}, {0x2178, "\x69\x78"}, {0x217A, "\x78\x69"},
+    {0x217B, "\x78\x69\x69"}, {0xFB00, "\x66\x66"}, {0xFB01, "\x66\x69"}, {0xFB02, "\x66\x6c"},
+    {0xFB03, "\x66\x66\x69"}, {0xFB04, "\x66\x66\x6c"}, {0xFB05, "\x73\x74"}, {0xFB06, "\x73\x74"},
+};
+
+// Punctuation, symbols, spaces and controls above ASCII: word separators
+constexpr CodeRange SEPARATORS[] = {
+    {0x0080, 0x00A9}, {0x00AB, 0x00B1}, {0x00B4, 0x00B4}, {0x00B6, 0x00B8}, {0x00BB, 0x00BB}, {0x00BF, 0x00BF},
+    {0x00D7, 0x00D7}, {0x00F7, 0x00F7}, {0x02C2, 0x02C5}, {0x02D2, 0x02DF}, {0x02E5, 0x02EB}, {0x02ED, 0x02ED},
+    {0x02EF, 0x02FF}, {0x0375, 0x0375}, {0x037E, 0x037E}, {0x0384, 0x0385}, {0x0387, 0x0387}, {0x03F6, 0x03F6},
+    {0x0482, 0x0482}, {0x055A, 0x055F}, {0x0589, 0x058A}, {0x058D, 0x058F}, {0x05BE, 0x05BE}, {0x05C0, 0x05C0},
+    {0x05C3, 0x05C3}, {0x05C6, 0x05C6}, {0x05F3, 0x05F4}, {0x0600, 0x060F}, {0x061B, 0x061F}, {0x066A, 0x066D},
+    {0x06D4, 0x06D4}, {0x06DD, 0x06DE}, {0x06E9, 0x06E9}, {0x06FD, 0x06FE}, {0x0700, 0x070D}, {0x070F, 0x070F},
+    {0x07F6, 0x07F9}, {0x07FE, 0x07FF}, {0x0830, 0x083E}, {0x085E, 0x085E}, {0x0888, 0x0888}, {0x0890, 0x0891},
+    {0x08E2, 0x08E2}, {0x0964, 0x0965}, {0x0970, 0x0970}, {0x09F2, 0x09F3}, {0x09FA, 0x09FB}, {0x09FD, 0x09FD},
+    {0x0A76, 0x0A76}, {0x0AF0, 0x0AF1}, {0x0B70, 0x0B70}, {0x0BF3, 0x0BFA}, {0x0C77, 0x0C77}, {0x0C7F, 0x0C7F},
+    {0x0C84, 0x0C84}, {0x0D4F, 0x0D4F}, {0x0D79, 0x0D79}, {0x0DF4, 0x0DF4}, {0x0E3F, 0x0E3F}, {0x0E4F, 0x0E4F},
+    {0x0E5A, 0x0E5B}, {0x0F01, 0x0F17}, {0x0F1A, 0x0F1F}, {0x0F34, 0x0F34}, {0x0F36, 0x0F36}, {0x0F38, 0x0F38},
+    {0x0F3A, 0x0F3D}, {0x0F85, 0x0F85}, {0x0FBE, 0x0FC5}, {0x0FC7, 0x0FCC}, {0x0FCE, 0x0FDA}, {0x104A, 0x104F},
+    {0x109E, 0x109F}, {0x10FB, 0x10FB}, {0x1360, 0x1368}, {0x1390, 0x1399}, {0x1400, 0x1400}, {0x166D, 0x166E},
+    {0x1680, 0x1680}, {0x169B, 0x169C}, {0x16EB, 0x16ED}, {0x1735, 0x1736}, {0x17D4, 0x17D6}, {0x17D8, 0x17DB},
+    {0x1800, 0x180A}, {0x180E, 0x180E}, {0x1940, 0x1940}, {0x1944, 0x1945}, {0x19DE, 0x19FF}, {0x1A1E, 0x1A1F},
+    {0x1AA0, 0x1AA6}, {0x1AA8, 0x1AAD}, {0x1B5A, 0x1B6A}, {0x1B74, 0x1B7E}, {0x1BFC, 0x1BFF}, {0x1C3B, 0x1C3F},
+    {0x1C7E, 0x1C7F}, {0x1CC0, 0x1CC7}, {0x1CD3, 0x1CD3}, {0x1FBD, 0x1FBD}, {0x1FBF, 0x1FC1}, {0x1FCD, 0x1FCF},
+    {0x1FDD, 0x1FDF}, {0x1FED, 0x1FEF}, {0x1FFD, 0x1FFE}, {0x2000, 0x2064}, {0x2066, 0x206F}, {0x207A, 0x207E},
+    {0x208A, 0x208E}, {0x20A0, 0x20C0}, {0x2100, 0x2101}, {0x2103, 0x2106}, {0x2108, 0x2109}, {0x2114, 0x2114},
+    {0x2116, 0x2118}, {0x211E, 0x2123}, {0x2125, 0x2125}, {0x2127, 0x2127}, {0x2129, 0x2129}, {0x212E, 0x212E},
+    {0x213A, 0x213B}, {0x2140, 0x2144}, {0x214A, 0x214D}, {0x214F, 0x214F}, {0x218A, 0x218B}, {0x2190, 0x2426},
+    {0x2440, 0x244A}, {0x249C, 0x24E9}, {0x2500, 0x2775}, {0x2794, 0x2B73}, {0x2B76, 0x2B95}, {0x2B97, 0x2BFF},
+    {0x2CE5, 0x2CEA}, {0x2CF9, 0x2CFC}, {0x2CFE, 0x2CFF}, {0x2D70, 0x2D70}, {0x2E00, 0x2E2E}, {0x2E30, 0x2E5D},
+    {0x2E80, 0x2E99}, {0x2E9B, 0x2EF3}, {0x2F00, 0x2FD5}, {0x2FF0, 0x2FFB}, {0x3000, 0x3004}, {0x3008, 0x3020},
+    {0x3030, 0x3030}, {0x3036, 0x3037}, {0x303D, 0x303F}, {0x309B, 0x309C}, {0x30A0, 0x30A0}, {0x30FB, 0x30FB},
+    {0x3190, 0x3191}, {0x3196, 0x319F}, {0x31C0, 0x31E3}, {0x3200, 0x321E}, {0x322A, 0x3247}, {0x3250, 0x3250},
+    {0x3260, 0x327F}, {0x328A, 0x32B0}, {0x32C0, 0x33FF}, {0x4DC0, 0x4DFF}, {0xA490, 0xA4C6}, {0xA4FE, 0xA4FF},
+    {0xA60D, 0xA60F}, {0xA673, 0xA673}, {0xA67E, 0xA67E}, {0xA6F2, 0xA6F7}, {0xA700, 0xA716}, {0xA720, 0xA721},
+    {0xA789, 0xA78A}, {0xA828, 0xA82B}, {0xA836, 0xA839}, {0xA874, 0xA877}, {0xA8CE, 0xA8CF}, {0xA8F8, 0xA8FA},
+    {0xA8FC, 0xA8FC}, {0xA92E, 0xA92F}, {0xA95F, 0xA95F}, {0xA9C1, 0xA9CD}, {0xA9DE, 0xA9DF}, {0xAA5C, 0xAA5F},
+    {0xAA77, 0xAA79}, {0xAADE, 0xAADF}, {0xAAF0, 0xAAF1}, {0xAB5B, 0xAB5B}, {0xAB6A, 0xAB6B}, {0xABEB, 0xABEB},
+    {0xD800, 0xF8FF}, {0xFB29, 0xFB29}, {0xFBB2, 0xFBC2}, {0xFD3E, 0xFD4F}, {0xFDCF, 0xFDCF}, {0xFDFC, 0xFDFF},
+    {0xFE10, 0xFE19}, {0xFE30, 0xFE52}, {0xFE54, 0xFE66}, {0xFE68, 0xFE6B}, {0xFEFF, 0xFEFF}, {0xFF01, 0xFF0F},
+    {0xFF1A, 0xFF20}, {0xFF3B, 0xFF40}, {0xFF5B, 0xFF65}, {0xFFE0, 0xFFE6}, {0xFFE8, 0xFFEE}, {0xFFF9, 0xFFFD},
+};
+
+} // namespace text_folding_tables
+
+#endif // TEXTFOLDINGTABLES_H
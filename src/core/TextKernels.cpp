@@ -0,0 +1,163 @@
+#include "TextKernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TEXT_KERNELS_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define TEXT_KERNELS_NEON 1
+#endif
+
+namespace {
+
+#if TEXT_KERNELS_SSE2
+using Lanes = __m128i;
+
+Lanes load(const char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+void store(char* p, Lanes v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+
+// Bytes in [low, low + width): shifting by low + 128 turns the unsigned range
+// test into one signed compare
+Lanes inRange(Lanes v, char low, int width) {
+    Lanes shifted = _mm_sub_epi8(v, _mm_set1_epi8(static_cast<char>(low + 128)));
+    return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(-128 + width)));
+}
+
+Lanes lower(Lanes v) {
+    return _mm_or_si128(v, _mm_and_si128(inRange(v, 'A', 26), _mm_set1_epi8(0x20)));
+}
+
+Lanes isWord(Lanes v) {
+    Lanes letter = inRange(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 26);
+    return _mm_or_si128(letter, inRange(v, '0', 10));
+}
+
+Lanes equal(Lanes a, Lanes b) { return _mm_cmpeq_epi8(a, b); }
+Lanes both(Lanes a, Lanes b) { return _mm_and_si128(a, b); }
+Lanes splat(char c) { return _mm_set1_epi8(c); }
+uint32_t bits(Lanes mask) { return static_cast<uint32_t>(_mm_movemask_epi8(mask)); }
+
+#elif TEXT_KERNELS_NEON
+using Lanes = uint8x16_t;
+
+Lanes load(const char* p) { return vld1q_u8(reinterpret_cast<const uint8_t*>(p)); }
+void store(char* p, Lanes v) { vst1q_u8(reinterpret_cast<uint8_t*>(p), v); }
+
+Lanes inRange(Lanes v, char low, int width) {
+    return vcltq_u8(vsubq_u8(v, vdupq_n_u8(static_cast<uint8_t>(low))), vdupq_n_u8(static_cast<uint8_t>(width)));
+}
+
+Lanes lower(Lanes v) {
+    return vorrq_u8(v, vandq_u8(inRange(v, 'A', 26), vdupq_n_u8(0x20)));
+}
+
+Lanes isWord(Lanes v) {
+    Lanes letter = inRange(vorrq_u8(v, vdupq_n_u8(0x20)), 'a', 26);
+    return vorrq_u8(letter, inRange(v, '0', 10));
+}
+
+Lanes equal(Lanes a, Lanes b) { return vceqq_u8(a, b); }
+Lanes both(Lanes a, Lanes b) { return vandq_u8(a, b); }
+Lanes splat(char c) { return vdupq_n_u8(static_cast<uint8_t>(c)); }
+
+// NEON has no movemask: weight each lane by its bit and add up each half
+uint32_t bits(Lanes mask) {
+    static const uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    Lanes weighted = vandq_u8(mask, vld1q_u8(weights));
+    return vaddv_u8(vget_low_u8(weighted)) | (static_cast<uint32_t>(vaddv_u8(vget_high_u8(weighted))) << 8);
+}
+#endif
+
+#if TEXT_KERNELS_SSE2 || TEXT_KERNELS_NEON
+constexpr size_t LANES = 16;
+#endif
+
+}
+
+void TextKernels::toLower(const char* in, size_t count, char* out) {
+    size_t i = 0;
+#if TEXT_KERNELS_SSE2 || TEXT_KERNELS_NEON
+    for (; i + LANES <= count; i += LANES) {
+        store(out + i, lower(load(in + i)));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = toLower(in[i]);
+    }
+}
+
+std::string TextKernels::toLower(std::string_view text) {
+    std::string result(text.size(), '\0');
+    toLower(text.data(), text.size(), result.data());
+    return result;
+}
+
+void TextKernels::toLowerInPlace(std::string& text) {
+    toLower(text.data(), text.size(), text.data());
+}
+
+bool TextKernels::isAscii(std::string_view text) {
+    size_t i = 0;
+#if TEXT_KERNELS_SSE2
+    for (; i + LANES <= text.size(); i += LANES) {
+        if (_mm_movemask_epi8(load(text.data() + i)) != 0) return false;
+    }
+#elif TEXT_KERNELS_NEON
+    for (; i + LANES <= text.size(); i += LANES) {
+        if (vmaxvq_u8(load(text.data() + i)) >= 0x80) return false;
+    }
+#endif
+    for (; i < text.size(); ++i) {
+        if (static_cast<unsigned char>(text[i]) >= 0x80) return false;
+    }
+    return true;
+}
+
+uint64_t TextKernels::wordMask(const char* block, size_t count) {
+    uint64_t mask = 0;
+    size_t i = 0;
+#if TEXT_KERNELS_SSE2 || TEXT_KERNELS_NEON
+    for (; i + LANES <= count; i += LANES) {
+        mask |= static_cast<uint64_t>(bits(isWord(load(block + i)))) << i;
+    }
+#endif
+    for (; i < count; ++i) {
+        mask |= static_cast<uint64_t>(isWordChar(static_cast<unsigned char>(block[i]))) << i;
+    }
+    return mask;
+}
+
+bool TextKernels::equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (toLower(a[i]) != toLower(b[i])) return false;
+    }
+    return true;
+}
+
+size_t TextKernels::findIgnoreCase(std::string_view text, std::string_view needle, size_t from) {
+    if (needle.empty()) return from <= text.size() ? from : std::string_view::npos;
+    if (from >= text.size() || needle.size() > text.size() - from) return std::string_view::npos;
+
+    const size_t last = text.size() - needle.size(); // final start position
+    size_t pos = from;
+#if TEXT_KERNELS_SSE2 || TEXT_KERNELS_NEON
+    // Test 16 start positions at once on the needle's first and last byte,
+    // then confirm each candidate in full
+    const Lanes first = splat(toLower(needle.front()));
+    const Lanes ending = splat(toLower(needle.back()));
+    const size_t tail = needle.size() - 1;
+    for (; pos + LANES - 1 <= last; pos += LANES) {
+        Lanes starts = equal(lower(load(text.data() + pos)), first);
+        Lanes ends = equal(lower(load(text.data() + pos + tail)), ending);
+        for (uint32_t candidates = bits(both(starts, ends)); candidates; candidates &= candidates - 1) {
+            size_t at = pos + static_cast<size_t>(std::countr_zero(candidates));
+            if (equalsIgnoreCase(text.substr(at + 1, needle.size() - 1), needle.substr(1))) return at;
+        }
+    }
+#endif
+    for (; pos <= last; ++pos) {
+        if (equalsIgnoreCase(text.substr(pos, needle.size()), needle)) return pos;
+    }
+    return std::string_view::npos;
+}
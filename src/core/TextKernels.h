@@ -0,0 +1,71 @@
+#ifndef TEXTKERNELS_H
+#define TEXTKERNELS_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// ASCII kernels for tokenizing and case-insensitive matching. A word is a run
+// of ASCII letters and digits, which is what std::isalnum accepts in the "C"
+// locale the application runs in, but nothing here consults the locale.
+// The kernels work on 16 bytes at a time with SSE2 on x86-64 or NEON on
+// AArch64, both baseline for those targets so no build flags or runtime
+// dispatch are involved, and fall back to scalar code elsewhere and for tails.
+class TextKernels {
+public:
+    static constexpr bool isWordChar(unsigned char c) {
+        return (c >= '0' && c <= '9') || static_cast<unsigned char>((c | 0x20) - 'a') < 26;
+    }
+    static constexpr char toLower(char c) {
+        return static_cast<unsigned char>(c - 'A') < 26 ? static_cast<char>(c | 0x20) : c;
+    }
+
+    // Lowercase count bytes from in to out, which may be in itself
+    static void toLower(const char* in, size_t count, char* out);
+    static std::string toLower(std::string_view text);
+    static void toLowerInPlace(std::string& text);
+
+    // True when no byte has its high bit set, i.e. the UTF-8 text is plain ASCII
+    static bool isAscii(std::string_view text);
+
+    // Bit i is set when block[i] is a word character; count is at most 64
+    static uint64_t wordMask(const char* block, size_t count);
+
+    // Calls on_word(std::string_view) for each word of text, in order
+    template <typename OnWord>
+    static void forEachWord(std::string_view text, OnWord&& on_word);
+
+    // First case-insensitive occurrence of needle in text at or after from, or npos
+    static size_t findIgnoreCase(std::string_view text, std::string_view needle, size_t from = 0);
+    static bool equalsIgnoreCase(std::string_view a, std::string_view b);
+};
+
+template <typename OnWord>
+void TextKernels::forEachWord(std::string_view text, OnWord&& on_word) {
+    size_t word_start = 0;
+    bool in_word = false;
+    for (size_t base = 0; base < text.size(); base += 64) {
+        size_t count = std::min<size_t>(64, text.size() - base);
+        uint64_t mask = wordMask(text.data() + base, count);
+
+        // A word starts or ends wherever a byte's class differs from the previous byte's
+        uint64_t edges = mask ^ ((mask << 1) | (in_word ? 1u : 0u));
+        if (count < 64) edges &= (uint64_t(1) << count) - 1;
+        while (edges) {
+            size_t pos = base + static_cast<size_t>(std::countr_zero(edges));
+            if (in_word) {
+                on_word(text.substr(word_start, pos - word_start));
+            } else {
+                word_start = pos;
+            }
+            in_word = !in_word;
+            edges &= edges - 1;
+        }
+    }
+    if (in_word) on_word(text.substr(word_start));
+}
+
+#endif // TEXTKERNELS_H
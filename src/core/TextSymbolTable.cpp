@@ -0,0 +1,138 @@
+#include "TextSymbolTable.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+// Units while training: symbol codes, then 256 + byte for an escaped byte
+constexpr size_t UNIT_COUNT = 512;
+constexpr size_t LITERAL = 256;
+}
+
+TextSymbolTable TextSymbolTable::train(const std::vector<std::string_view>& texts) {
+    size_t total = 0;
+    for (std::string_view text : texts) total += text.size();
+    size_t stride = std::max<size_t>(1, (total + TRAINING_BYTES - 1) / TRAINING_BYTES);
+    std::vector<std::string_view> sample;
+    for (size_t i = 0; i < texts.size(); i += stride) sample.push_back(texts[i]);
+
+    TextSymbolTable table;
+    std::vector<uint32_t> single(UNIT_COUNT);
+    std::vector<uint32_t> pairs(UNIT_COUNT * UNIT_COUNT);
+    for (size_t round = 0; round < TRAINING_ROUNDS; ++round) {
+        // Encode the sample with the current table, counting units and the units that follow them
+        std::fill(single.begin(), single.end(), 0);
+        std::fill(pairs.begin(), pairs.end(), 0);
+        for (std::string_view text : sample) {
+            size_t previous = UNIT_COUNT;
+            for (size_t pos = 0; pos < text.size();) {
+                int code = table.match(text, pos);
+                size_t unit = code >= 0 ? static_cast<size_t>(code) : LITERAL + static_cast<unsigned char>(text[pos]);
+                ++single[unit];
+                if (previous != UNIT_COUNT) ++pairs[previous * UNIT_COUNT + unit];
+                previous = unit;
+                pos += code >= 0 ? table.lengths[code] : 1;
+            }
+        }
+
+        auto unit_text = [&table](size_t unit) {
+            if (unit >= LITERAL) return std::string(1, static_cast<char>(unit - LITERAL));
+            return std::string(reinterpret_cast<const char*>(&table.symbols[unit]), table.lengths[unit]);
+        };
+
+        // A candidate saves one byte per occurrence per byte it covers; pairs
+        // grow symbols a round at a time, up to MAX_SYMBOL_LENGTH
+        std::unordered_map<std::string, uint64_t> gains;
+        for (size_t unit = 0; unit < UNIT_COUNT; ++unit) {
+            if (single[unit] == 0) continue;
+            std::string text = unit_text(unit);
+            gains[text] += static_cast<uint64_t>(single[unit]) * text.size();
+        }
+        for (size_t first = 0; first < UNIT_COUNT; ++first) {
+            if (single[first] == 0) continue;
+            std::string prefix = unit_text(first);
+            if (prefix.size() == MAX_SYMBOL_LENGTH) continue;
+            for (size_t second = 0; second < UNIT_COUNT; ++second) {
+                uint32_t count = pairs[first * UNIT_COUNT + second];
+                if (count == 0) continue;
+                std::string text = (prefix + unit_text(second)).substr(0, MAX_SYMBOL_LENGTH);
+                gains[text] += static_cast<uint64_t>(count) * text.size();
+            }
+        }
+
+        std::vector<std::pair<uint64_t, std::string>> ranked;
+        ranked.reserve(gains.size());
+        for (auto& gain : gains) ranked.emplace_back(gain.second, gain.first);
+        size_t kept = std::min(MAX_SYMBOLS, ranked.size());
+        std::partial_sort(ranked.begin(), ranked.begin() + kept, ranked.end(), [](const auto& a, const auto& b) {
+            if (a.first != b.first) return a.first > b.first;
+            return a.second < b.second;
+        });
+
+        table = TextSymbolTable();
+        for (size_t i = 0; i < kept; ++i) {
+            std::memcpy(&table.symbols[i], ranked[i].second.data(), ranked[i].second.size());
+            table.lengths[i] = static_cast<uint8_t>(ranked[i].second.size());
+        }
+        table.count = kept;
+        table.index();
+    }
+    return table;
+}
+
+void TextSymbolTable::index() {
+    for (auto& codes : by_first_byte) codes.clear();
+    for (size_t code = 0; code < count; ++code) {
+        unsigned char first = *reinterpret_cast<const unsigned char*>(&symbols[code]);
+        by_first_byte[first].push_back(static_cast<uint8_t>(code));
+    }
+    for (auto& codes : by_first_byte) {
+        std::stable_sort(codes.begin(), codes.end(), [this](uint8_t a, uint8_t b) { return lengths[a] > lengths[b]; });
+    }
+}
+
+int TextSymbolTable::match(std::string_view text, size_t pos) const {
+    const size_t remaining = text.size() - pos;
+    for (uint8_t code : by_first_byte[static_cast<unsigned char>(text[pos])]) {
+        size_t length = lengths[code];
+        if (length <= remaining && std::memcmp(text.data() + pos, &symbols[code], length) == 0) return code;
+    }
+    return -1;
+}
+
+void TextSymbolTable::encode(std::string_view text, std::string& out) const {
+    for (size_t pos = 0; pos < text.size();) {
+        int code = match(text, pos);
+        if (code >= 0) {
+            out.push_back(static_cast<char>(code));
+            pos += lengths[code];
+        } else {
+            out.push_back(static_cast<char>(ESCAPE));
+            out.push_back(text[pos++]);
+        }
+    }
+}
+
+void TextSymbolTable::decode(std::string_view encoded, std::string& out) const {
+    // Whole 8-byte words are written and the end trimmed afterwards
+    const size_t start = out.size();
+    out.resize(start + encoded.size() * MAX_SYMBOL_LENGTH + MAX_SYMBOL_LENGTH);
+    char* write = out.data() + start;
+    for (size_t i = 0; i < encoded.size(); ++i) {
+        uint8_t code = static_cast<uint8_t>(encoded[i]);
+        if (code == ESCAPE) {
+            if (++i == encoded.size()) break;
+            *write++ = encoded[i];
+            continue;
+        }
+        std::memcpy(write, &symbols[code], MAX_SYMBOL_LENGTH);
+        write += lengths[code];
+    }
+    out.resize(static_cast<size_t>(write - out.data()));
+}
+
+size_t TextSymbolTable::getMemoryUsage() const {
+    size_t bytes = sizeof(*this);
+    for (const auto& codes : by_first_byte) bytes += codes.capacity();
+    return bytes;
+}
@@ -0,0 +1,48 @@
+#ifndef TEXTSYMBOLTABLE_H
+#define TEXTSYMBOLTABLE_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Static symbol table compression in the style of FSST: up to 255 strings of
+// 1 to 8 bytes, learned from a sample of one translation, each replaced by a
+// one-byte code; a byte no symbol covers is written as ESCAPE and itself.
+// Every text is encoded on its own, so any one verse decodes without its
+// neighbours, by copying one 8-byte word per code.
+class TextSymbolTable {
+public:
+    static constexpr size_t MAX_SYMBOLS = 255;
+    static constexpr size_t MAX_SYMBOL_LENGTH = 8;
+    static constexpr uint8_t ESCAPE = 255;
+    static constexpr size_t TRAINING_ROUNDS = 5;
+    static constexpr size_t TRAINING_BYTES = 256 * 1024; // sampled from larger inputs
+
+    TextSymbolTable() = default;
+
+    // Learns the symbols that save the most bytes over texts
+    static TextSymbolTable train(const std::vector<std::string_view>& texts);
+
+    // Append text's encoding to out
+    void encode(std::string_view text, std::string& out) const;
+    // Append the decoded text to out
+    void decode(std::string_view encoded, std::string& out) const;
+
+    size_t symbolCount() const { return count; }
+    size_t getMemoryUsage() const;
+
+private:
+    std::array<uint64_t, MAX_SYMBOLS> symbols{}; // the bytes in memory order, zero-padded
+    std::array<uint8_t, MAX_SYMBOLS> lengths{};
+    size_t count = 0;
+    // Encoding only: codes by first byte, longest symbol first
+    std::array<std::vector<uint8_t>, 256> by_first_byte;
+
+    void index();
+    // Code of the longest symbol at text[pos], or -1 for an escaped byte
+    int match(std::string_view text, size_t pos) const;
+};
+
+#endif // TEXTSYMBOLTABLE_H
@@ -0,0 +1,20 @@
+#ifndef THREADRANDOM_H
+#define THREADRANDOM_H
+
+#include <cstddef>
+#include <random>
+
+// One generator per thread, seeded from std::random_device the first time a
+// thread asks. Constructing random_device opens the system entropy source,
+// so picks that happen every few seconds use this instead of a fresh one.
+inline std::mt19937& threadRandom() {
+    thread_local std::mt19937 generator{std::random_device{}()};
+    return generator;
+}
+
+// Uniform index in [0, count); count must be non-zero
+inline size_t randomIndex(size_t count) {
+    return std::uniform_int_distribution<size_t>(0, count - 1)(threadRandom());
+}
+
+#endif // THREADRANDOM_H
@@ -0,0 +1,48 @@
+#ifndef TOPK_H
+#define TOPK_H
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+// Keeps the k best items seen so far. The heap's root is the worst item kept,
+// so a candidate costs one comparison unless it displaces that item, and
+// ranking n matches takes O(n log k) time and O(k) memory.
+template <typename T, typename Better = std::greater<T>>
+class TopK {
+private:
+    size_t capacity;
+    Better better;
+    std::vector<T> heap;
+
+public:
+    explicit TopK(size_t k, Better compare = Better()) : capacity(k), better(std::move(compare)) {
+        heap.reserve(std::min<size_t>(k, 1024));
+    }
+
+    void push(T item) {
+        if (capacity == 0) return;
+        if (heap.size() < capacity) {
+            heap.push_back(std::move(item));
+            std::push_heap(heap.begin(), heap.end(), better);
+        } else if (better(item, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), better);
+            heap.back() = std::move(item);
+            std::push_heap(heap.begin(), heap.end(), better);
+        }
+    }
+
+    size_t size() const { return heap.size(); }
+    bool empty() const { return heap.empty(); }
+    bool full() const { return heap.size() >= capacity; }
+    // The item a candidate must beat once full(); undefined while empty
+    const T& worst() const { return heap.front(); }
+
+    // Best first; leaves the collector empty
+    std::vector<T> take() {
+        std::sort_heap(heap.begin(), heap.end(), better);
+        return std::move(heap);
+    }
+};
+
+#endif // TOPK_H
@@ -1,17 +1,14 @@
 #include "TopicManager.h"
+#include "VerseStore.h"
+#include "TaskScheduler.h"
+#include "BooleanPlanner.h"
+#include "TextKernels.h"
+#include "ThreadRandom.h"
 #include <algorithm>
 #include <sstream>
-#include <random>
 #include <chrono>
 #include <cmath>
-
-// Include Verse struct definition
-struct Verse {
-    std::string book;
-    int chapter;
-    int verse;
-    std::string text;
-};
+#include <cctype>
 
 TopicManager::TopicManager() {
     initializeCoreTopics();
@@ -140,25 +137,153 @@ void TopicManager::buildTopicHierarchy() {
     topicHierarchy["Emotions"] = {"Joy", "Peace", "Fear", "Anger", "Sadness"};
 }
 
-void TopicManager::buildTopicIndex(const std::unordered_map<std::string, std::unordered_map<std::string, Verse>>& verses) {
-    // Build topic index by analyzing verse content
+void TopicManager::buildTopicIndex(const VerseStoreMap& verses, const InvertedIndexMap& indexes) {
+    // Forget translations that are gone
+    bool changed = !staleTopics.empty();
+    for (auto it = translationTopics.begin(); it != translationTopics.end();) {
+        if (verses.count(it->first)) {
+            ++it;
+        } else {
+            it = translationTopics.erase(it);
+            changed = true;
+        }
+    }
+    
+    // New or stale translations need every topic, the others only changed topics
+    struct Job {
+        const std::string* translation;
+        const std::pair<const std::string, TopicCluster>* topic;
+        PostingList ids;
+    };
+    std::vector<Job> jobs;
     for (const auto& translation : verses) {
-        for (const auto& verse : translation.second) {
-            auto topicScores = analyzeVerseTopics(verse.second.text, verse.first);
-            for (const auto& score : topicScores) {
-                topics[score.topic].verseKeys.insert(score.verseKey);
-                verseTopicMapping[score.verseKey].push_back(score.topic);
+        if (!indexes.count(translation.first)) continue;
+        bool stale = staleTranslations.count(translation.first) || !translationTopics.count(translation.first);
+        changed |= stale;
+        if (stale) translationTopics[translation.first].clear();
+        for (const auto& topic : topics) {
+            if (stale || staleTopics.count(topic.first)) {
+                jobs.push_back({&translation.first, &topic, {}});
             }
         }
     }
+    if (!changed) return;
+    
+    // Every (translation, topic) pair is independent
+    TaskScheduler::shared().parallelFor(jobs.size(), [&](size_t i) {
+        Job& job = jobs[i];
+        job.ids = matchTopicVerses(job.topic->second, *verses.at(*job.translation), *indexes.at(*job.translation));
+    });
+    for (Job& job : jobs) {
+        translationTopics[*job.translation][job.topic->first] = std::move(job.ids);
+    }
+    
+    staleTranslations.clear();
+    staleTopics.clear();
+    deriveTopicVerses(verses);
+    indexCharge.set(indexMemoryUsage());
+}
+
+size_t TopicManager::indexMemoryUsage() const {
+    // Hash nodes are estimated as the entry plus a next pointer
+    size_t bytes = verseKeyNames.capacity() * sizeof(std::string);
+    for (const auto& key : verseKeyNames) {
+        bytes += key.capacity() + sizeof(std::pair<const std::string, VerseKeyId>) + sizeof(void*);
+    }
+    for (const auto& translation : translationTopics) {
+        for (const auto& topic : translation.second) {
+            bytes += topic.first.capacity() + sizeof(topic) + sizeof(void*);
+            bytes += topic.second.capacity() * sizeof(VerseId);
+        }
+    }
+    for (const auto& topic : topics) {
+        bytes += topic.second.verses.capacity() * sizeof(VerseKeyId);
+    }
+    return bytes;
+}
+
+void TopicManager::invalidateTranslation(const std::string& translation) {
+    staleTranslations.insert(translation);
+}
+
+PostingList TopicManager::matchTopicVerses(const TopicCluster& topic, const VerseStore& store, const InvertedIndex& index) {
+    if (topic.keywords.empty()) return {};
+    
+    // Same rule as analyzeVerseTopics(): more than a tenth of the keywords must occur
+    const size_t needed = topic.keywords.size() / 10 + 1;
+    std::vector<uint16_t> counts(store.size(), 0);
+    for (const auto& keyword : topic.keywords) {
+        std::string lowerKeyword = keyword;
+        std::transform(lowerKeyword.begin(), lowerKeyword.end(), lowerKeyword.begin(), ::tolower);
+        for (VerseId id : index.findSubstring(lowerKeyword, store)) {
+            ++counts[id];
+        }
+    }
+    
+    PostingList ids;
+    for (VerseId id = 0; id < counts.size(); ++id) {
+        if (counts[id] >= needed) ids.push_back(id);
+    }
+    return ids;
+}
+
+void TopicManager::deriveTopicVerses(const VerseStoreMap& verses) {
+    // Topics never analysed (e.g. imported with their own verses) keep their verses
+    std::unordered_set<std::string> analysed;
+    for (const auto& translation : translationTopics) {
+        for (const auto& topic : translation.second) analysed.insert(topic.first);
+    }
+    for (const auto& name : analysed) {
+        auto topic = topics.find(name);
+        if (topic != topics.end()) topic->second.verses.clear();
+    }
+    
+    for (const auto& translation : translationTopics) {
+        // Each verse's reference is interned once per translation, not once per topic
+        const VerseStore& store = *verses.at(translation.first);
+        std::vector<VerseKeyId> keyOf(store.size());
+        for (VerseId id = 0; id < store.size(); ++id) {
+            keyOf[id] = internVerseKey(store.reference(id));
+        }
+        for (const auto& topic : translation.second) {
+            auto cluster = topics.find(topic.first);
+            if (cluster == topics.end()) continue;
+            for (VerseId id : topic.second) {
+                cluster->second.verses.push_back(keyOf[id]);
+            }
+        }
+    }
+    
+    for (const auto& name : analysed) {
+        auto topic = topics.find(name);
+        if (topic == topics.end()) continue;
+        std::vector<VerseKeyId>& ids = topic->second.verses;
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        ids.shrink_to_fit();
+    }
+}
+
+VerseKeyId TopicManager::internVerseKey(const std::string& verseKey) {
+    auto [it, inserted] = verseKeyIds.emplace(verseKey, static_cast<VerseKeyId>(verseKeyNames.size()));
+    if (inserted) verseKeyNames.push_back(verseKey);
+    return it->second;
+}
+
+std::vector<std::string> TopicManager::verseKeysOf(const std::vector<VerseKeyId>& ids, size_t maxResults) const {
+    std::vector<std::string> keys;
+    keys.reserve(std::min(ids.size(), maxResults));
+    for (size_t i = 0; i < ids.size() && i < maxResults; ++i) {
+        keys.push_back(verseKeyNames[ids[i]]);
+    }
+    return keys;
 }
 
 std::vector<VerseTopicScore> TopicManager::analyzeVerseTopics(const std::string& verseText, const std::string& verseKey) const {
     std::vector<VerseTopicScore> results;
     
     // Convert text to lowercase for matching
-    std::string lowerText = verseText;
-    std::transform(lowerText.begin(), lowerText.end(), lowerText.begin(), ::tolower);
+    std::string lowerText = TextKernels::toLower(verseText);
     
     for (const auto& topic : topics) {
         double score = 0.0;
@@ -193,18 +318,62 @@ std::vector<VerseTopicScore> TopicManager::analyzeVerseTopics(const std::string&
 }
 
 std::vector<std::string> TopicManager::getVersesByTopic(const std::string& topic, int maxResults) const {
-    std::vector<std::string> results;
-    
     auto it = topics.find(topic);
-    if (it != topics.end()) {
-        for (const auto& verseKey : it->second.verseKeys) {
-            results.push_back(verseKey);
-            if (results.size() >= static_cast<size_t>(maxResults)) {
-                break;
-            }
+    if (it == topics.end() || maxResults <= 0) return {};
+    return verseKeysOf(it->second.verses, static_cast<size_t>(maxResults));
+}
+
+const PostingList* TopicManager::getTopicVerseIds(const std::string& topic, const std::string& translation) const {
+    auto translation_it = translationTopics.find(translation);
+    if (translation_it == translationTopics.end()) return nullptr;
+    auto it = translation_it->second.find(topic);
+    if (it != translation_it->second.end()) return &it->second;
+    for (const auto& [name, ids] : translation_it->second) {
+        if (name.size() == topic.size() &&
+            std::equal(name.begin(), name.end(), topic.begin(), [](char a, char b) {
+                return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+            })) {
+            return &ids;
         }
     }
+    return nullptr;
+}
+
+std::vector<std::string> TopicManager::getTopicIntersection(const std::vector<std::string>& topicNames) const {
+    BooleanPlanner::Query query;
+    for (const auto& name : topicNames) {
+        auto it = topics.find(name);
+        if (it == topics.end()) return {};
+        query.required.push_back(it->second.verses);
+    }
+    if (query.required.empty()) return {};
+    return verseKeysOf(BooleanPlanner::execute(std::move(query), verseKeyNames.size()));
+}
+
+std::vector<std::string> TopicManager::searchByTopicHierarchy(const std::string& parentTopic) const {
+    auto parent = topicHierarchy.find(parentTopic);
+    if (parent == topicHierarchy.end()) return {};
+    
+    // Verses of any child topic
+    BooleanPlanner::Query query;
+    for (const auto& child : parent->second) {
+        auto it = topics.find(child);
+        if (it != topics.end()) query.alternatives.push_back(it->second.verses);
+    }
+    if (query.alternatives.empty()) return {};
+    return verseKeysOf(BooleanPlanner::execute(std::move(query), verseKeyNames.size()));
+}
+
+std::vector<std::string> TopicManager::getTopicsForVerse(const std::string& verseKey) const {
+    auto key = verseKeyIds.find(verseKey);
+    if (key == verseKeyIds.end()) return {};
     
+    std::vector<std::string> results;
+    for (const auto& topic : topics) {
+        if (std::binary_search(topic.second.verses.begin(), topic.second.verses.end(), key->second)) {
+            results.push_back(topic.first);
+        }
+    }
     return results;
 }
 
@@ -250,12 +419,7 @@ std::vector<TopicSuggestion> TopicManager::generateTopicSuggestions(const std::s
         
         if (relevance > 0.0) {
             // Get sample verses
-            std::vector<std::string> sampleVerses;
-            int count = 0;
-            for (const auto& verseKey : topic.second.verseKeys) {
-                sampleVerses.push_back(verseKey);
-                if (++count >= 3) break;
-            }
+            std::vector<std::string> sampleVerses = verseKeysOf(topic.second.verses, 3);
             
             suggestions.push_back({
                 topic.first,
@@ -337,6 +501,7 @@ void TopicManager::addCustomTopic(const std::string& topicName, const std::vecto
     };
     
     topics[topicName] = cluster;
+    staleTopics.insert(topicName);
 }
 
 std::string TopicManager::getVerseOfTheDay(const std::string& source) const {
@@ -345,10 +510,7 @@ std::string TopicManager::getVerseOfTheDay(const std::string& source) const {
         if (!seasonalTopics.empty()) {
             auto topicVerses = getVersesByTopic(seasonalTopics[0], 10);
             if (!topicVerses.empty()) {
-                std::random_device rd;
-                std::mt19937 gen(rd());
-                std::uniform_int_distribution<> dis(0, topicVerses.size() - 1);
-                return topicVerses[dis(gen)];
+                return topicVerses[randomIndex(topicVerses.size())];
             }
         }
     }
@@ -358,10 +520,7 @@ std::string TopicManager::getVerseOfTheDay(const std::string& source) const {
     if (!popularTopics.empty()) {
         auto topicVerses = getVersesByTopic(popularTopics[0], 10);
         if (!topicVerses.empty()) {
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<> dis(0, topicVerses.size() - 1);
-            return topicVerses[dis(gen)];
+            return topicVerses[randomIndex(topicVerses.size())];
         }
     }
     
@@ -372,10 +531,7 @@ std::string TopicManager::getTopicalVerseOfTheDay(const std::string& topic) cons
     if (!topic.empty()) {
         auto topicVerses = getVersesByTopic(topic, 10);
         if (!topicVerses.empty()) {
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<> dis(0, topicVerses.size() - 1);
-            return topicVerses[dis(gen)];
+            return topicVerses[randomIndex(topicVerses.size())];
         }
     }
     
@@ -400,7 +556,7 @@ int TopicManager::getTopicCount() const {
 int TopicManager::getVerseCountForTopic(const std::string& topic) const {
     auto it = topics.find(topic);
     if (it != topics.end()) {
-        return it->second.verseKeys.size();
+        return it->second.verses.size();
     }
     return 0;
 }
@@ -424,9 +580,7 @@ std::string TopicManager::exportTopicsAsJson() const {
         topicJson["coherenceScore"] = topic.second.coherenceScore;
         topicJson["searchFrequency"] = topic.second.searchFrequency;
         
-        // Convert unordered_set to vector for JSON serialization
-        std::vector<std::string> verseKeysVector(topic.second.verseKeys.begin(), topic.second.verseKeys.end());
-        topicJson["verseKeys"] = verseKeysVector;
+        topicJson["verseKeys"] = verseKeysOf(topic.second.verses);
         
         topicsJson[topic.first] = topicJson;
     }
@@ -448,8 +602,10 @@ void TopicManager::importTopicsFromJson(const std::string& jsonData) {
             
             if (topicData.contains("verseKeys")) {
                 for (const auto& verseKey : topicData["verseKeys"]) {
-                    cluster.verseKeys.insert(verseKey);
+                    cluster.verses.push_back(internVerseKey(verseKey.get<std::string>()));
                 }
+                std::sort(cluster.verses.begin(), cluster.verses.end());
+                cluster.verses.erase(std::unique(cluster.verses.begin(), cluster.verses.end()), cluster.verses.end());
             }
             
             topics[topicName] = cluster;
@@ -6,18 +6,21 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <memory>
+#include <cstdint>
 #include "nlohmann/json.hpp"
+#include "InvertedIndex.h"
+#include "MemoryAccounting.h"
 
 using json = nlohmann::json;
 
-// Forward declaration to avoid circular dependency
-struct Verse;
+// Index into TopicManager's table of verse references ("John 3:16"), shared by every topic
+using VerseKeyId = uint32_t;
 
 struct TopicCluster {
     std::string name;
     std::vector<std::string> keywords;
     std::vector<std::string> relatedTopics;
-    std::unordered_set<std::string> verseKeys;
+    std::vector<VerseKeyId> verses; // sorted, duplicate-free
     double coherenceScore;
     int searchFrequency;
 };
@@ -40,8 +43,20 @@ class TopicManager {
 private:
     // Core topic data
     std::unordered_map<std::string, TopicCluster> topics;
-    std::unordered_map<std::string, std::vector<std::string>> verseTopicMapping;
+    
+    // Every verse reference any topic has held, interned once; topics store
+    // sorted ids into this table instead of copies of the strings
+    std::vector<std::string> verseKeyNames;
+    std::unordered_map<std::string, VerseKeyId> verseKeyIds;
+    
+    // Verses of each topic per translation (translation -> topic -> ids), found
+    // from the keywords' postings. Topic memberships are derived from these,
+    // so only stale translations and changed topics are recomputed.
+    std::unordered_map<std::string, std::unordered_map<std::string, PostingList>> translationTopics;
+    std::unordered_set<std::string> staleTranslations;
+    std::unordered_set<std::string> staleTopics;
     std::unordered_map<std::string, int> topicPopularity;
+    MemoryCharge indexCharge{MemoryTag::TOPIC_INDEX}; // the three indexes above, refreshed on rebuild
     
     // Seasonal and liturgical topics
     std::unordered_map<std::string, std::vector<std::string>> seasonalTopics;
@@ -62,8 +77,13 @@ private:
     void buildTopicHierarchy();
     
     // Topic analysis helpers
+    static PostingList matchTopicVerses(const TopicCluster& topic, const VerseStore& store, const InvertedIndex& index);
+    void deriveTopicVerses(const VerseStoreMap& verses);
+    size_t indexMemoryUsage() const;
+    VerseKeyId internVerseKey(const std::string& verseKey);
+    std::vector<std::string> verseKeysOf(const std::vector<VerseKeyId>& ids, size_t maxResults = SIZE_MAX) const;
     double calculateTopicCoherence(const TopicCluster& cluster, 
-                                 const std::unordered_map<std::string, std::unordered_map<std::string, Verse>>& verses) const;
+                                 const VerseStoreMap& verses) const;
     std::vector<std::string> extractTopicKeywords(const std::vector<std::string>& verseTexts) const;
     double calculateSemanticSimilarity(const std::string& topic1, const std::string& topic2) const;
     
@@ -75,7 +95,11 @@ public:
     TopicManager();
     
     // Topic organization and management
-    void buildTopicIndex(const std::unordered_map<std::string, std::unordered_map<std::string, Verse>>& verses);
+    // Bring the topic index up to date with the loaded translations, analysing
+    // only new or invalidated translations and topics added since the last call
+    void buildTopicIndex(const VerseStoreMap& verses, const InvertedIndexMap& indexes);
+    // The translation's verses changed; the next buildTopicIndex() re-analyses it
+    void invalidateTranslation(const std::string& translation);
     void addCustomTopic(const std::string& topicName, const std::vector<std::string>& keywords);
     void updateTopicKeywords(const std::string& topicName, const std::vector<std::string>& newKeywords);
     void removeTopicFromVerse(const std::string& verseKey, const std::string& topic);
@@ -83,6 +107,9 @@ public:
     // Topic discovery and analysis
     std::vector<VerseTopicScore> analyzeVerseTopics(const std::string& verseText, const std::string& verseKey) const;
     std::vector<std::string> getVersesByTopic(const std::string& topic, int maxResults = 50) const;
+    // The topic's verses in one translation as sorted ids, its name in any case;
+    // null until buildTopicIndex() has analysed that translation
+    const PostingList* getTopicVerseIds(const std::string& topic, const std::string& translation) const;
     std::vector<std::string> getRelatedTopics(const std::string& topic, int maxResults = 10) const;
     std::vector<TopicCluster> getTopicClusters() const;
     
@@ -90,6 +117,7 @@ public:
     std::vector<std::string> searchByTopicHierarchy(const std::string& parentTopic) const;
     std::vector<std::string> findSimilarTopics(const std::string& topic, double threshold = 0.7) const;
     std::vector<std::string> getTopicIntersection(const std::vector<std::string>& topics) const;
+    std::vector<std::string> getTopicsForVerse(const std::string& verseKey) const;
     
     // Suggestions and recommendations
     std::vector<TopicSuggestion> generateTopicSuggestions(const std::string& query) const;
@@ -0,0 +1,160 @@
+#include "Tracer.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+Tracer& Tracer::shared() {
+    static Tracer tracer;
+    return tracer;
+}
+
+void Tracer::setEnabled(bool enable) {
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+uint64_t Tracer::nowNanos() const {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+Tracer::ThreadBuffer& Tracer::threadBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(threads_mutex);
+        buffer->thread_id = static_cast<uint32_t>(threads.size() + 1);
+        threads.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void Tracer::setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(threads_mutex);
+    buffer.name = name;
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(threads_mutex);
+    for (const auto& buffer : threads) {
+        buffer->cleared.store(buffer->written.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+void Tracer::record(ThreadBuffer& buffer, const char* name, uint64_t start_ns, uint64_t end_ns) {
+    uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    Slot& slot = buffer.slots[index % RING_CAPACITY];
+
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start_ns.store(start_ns, std::memory_order_relaxed);
+    slot.duration_ns.store(end_ns - start_ns, std::memory_order_relaxed);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+void TraceSpan::begin() {
+    Tracer& tracer = Tracer::shared();
+    Tracer::ThreadBuffer& thread = tracer.threadBuffer();
+    if (thread.depth == 0) {
+        uint32_t interval = tracer.sample_interval.load(std::memory_order_relaxed);
+        thread.recording = ++thread.outermost_spans % interval == 0;
+    }
+    ++thread.depth;
+    buffer = &thread;
+    if (thread.recording) start_ns = tracer.nowNanos();
+}
+
+void TraceSpan::end() {
+    --buffer->depth;
+    if (buffer->recording) {
+        Tracer::record(*buffer, name, start_ns, Tracer::shared().nowNanos());
+    }
+}
+
+namespace {
+void appendJsonString(std::string& out, const char* text) {
+    out += '"';
+    for (const char* c = text; *c; ++c) {
+        switch (*c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            default:
+                if (static_cast<unsigned char>(*c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", *c);
+                    out += escaped;
+                } else {
+                    out += *c;
+                }
+        }
+    }
+    out += '"';
+}
+}
+
+std::string Tracer::chromeTraceJson() const {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(threads_mutex);
+        buffers = threads;
+        for (const auto& buffer : threads) names.push_back(buffer->name);
+    }
+
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    char number[64];
+    for (size_t t = 0; t < buffers.size(); ++t) {
+        const ThreadBuffer& buffer = *buffers[t];
+        std::string tid = std::to_string(buffer.thread_id);
+
+        if (!names[t].empty()) {
+            if (!first) out += ',';
+            first = false;
+            out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + tid + ",\"args\":{\"name\":";
+            appendJsonString(out, names[t].c_str());
+            out += "}}";
+        }
+
+        // Only the newest RING_CAPACITY events are still in the ring
+        uint64_t end = buffer.written.load(std::memory_order_acquire);
+        uint64_t begin = std::max(buffer.cleared.load(std::memory_order_relaxed),
+                                  end > RING_CAPACITY ? end - RING_CAPACITY : 0);
+        for (uint64_t index = begin; index < end; ++index) {
+            const Slot& slot = buffer.slots[index % RING_CAPACITY];
+            uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const char* name = slot.name.load(std::memory_order_relaxed);
+            uint64_t start_ns = slot.start_ns.load(std::memory_order_relaxed);
+            uint64_t duration_ns = slot.duration_ns.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence != 2 * index + 2 || slot.sequence.load(std::memory_order_relaxed) != sequence || !name) {
+                continue; // overwritten while we read it
+            }
+
+            if (!first) out += ',';
+            first = false;
+            out += "{\"name\":";
+            appendJsonString(out, name);
+            std::snprintf(number, sizeof(number), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f",
+                          start_ns / 1000.0, duration_ns / 1000.0);
+            out += number;
+            out += ",\"pid\":1,\"tid\":" + tid + "}";
+        }
+    }
+    out += "]}";
+    return out;
+}
+
+bool Tracer::writeChromeTrace(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::string trace = chromeTraceJson();
+    file.write(trace.data(), static_cast<std::streamsize>(trace.size()));
+    return file.good();
+}
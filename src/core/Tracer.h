@@ -0,0 +1,108 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "QueryProfile.h"
+
+// Opt-in span tracing for finding where a slow request spent its time.
+// Each thread records finished spans into its own fixed-size ring, so
+// recording never locks and a long session keeps only the most recent
+// RING_CAPACITY spans per thread. Spans nest by scope and are exported as
+// Chrome trace JSON, which chrome://tracing and ui.perfetto.dev both open.
+// While tracing is off, a span costs one relaxed load and a check for a
+// QueryProfile.
+class Tracer {
+public:
+    static constexpr size_t RING_CAPACITY = 16384;
+
+    static Tracer& shared();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+    // Trace one outermost span in every interval on each thread, with
+    // everything nested inside it (1 = all)
+    void setSampleInterval(uint32_t interval) { sample_interval.store(interval ? interval : 1); }
+    // Label the calling thread in exported traces
+    void setThreadName(const std::string& name);
+    // Forget everything recorded so far
+    void clear();
+
+    std::string chromeTraceJson() const;
+    bool writeChromeTrace(const std::string& path) const;
+
+private:
+    friend class TraceSpan;
+
+    // Written by one thread, read by exporters: a slot's sequence is odd while
+    // it is being written, so a reader can detect and skip a torn event
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> start_ns{0};
+        std::atomic<uint64_t> duration_ns{0};
+    };
+
+    struct ThreadBuffer {
+        uint32_t thread_id = 0;
+        std::string name; // guarded by threads_mutex
+        std::unique_ptr<Slot[]> slots = std::make_unique<Slot[]>(RING_CAPACITY);
+        std::atomic<uint64_t> written{0};
+        std::atomic<uint64_t> cleared{0}; // events before this index were cleared
+        // Owner thread only
+        uint32_t depth = 0;
+        bool recording = false;
+        uint32_t outermost_spans = 0;
+    };
+
+    std::atomic<bool> enabled{false};
+    std::atomic<uint32_t> sample_interval{1};
+    std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+    // Buffers outlive their threads so their spans can still be exported
+    mutable std::mutex threads_mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> threads;
+
+    ThreadBuffer& threadBuffer();
+    uint64_t nowNanos() const;
+    static void record(ThreadBuffer& buffer, const char* name, uint64_t start_ns, uint64_t end_ns);
+};
+
+// Times the enclosing scope as a span, and as a stage of the thread's
+// QueryProfile if it has one. name must outlive the trace (a string
+// literal), since only the pointer is stored.
+class TraceSpan {
+private:
+    Tracer::ThreadBuffer* buffer = nullptr;
+    QueryProfile* profile;
+    const char* name;
+    uint64_t start_ns = 0;
+    size_t profile_stage = 0;
+
+    void begin();
+    void end();
+
+public:
+    explicit TraceSpan(const char* span_name) : profile(QueryProfile::current()), name(span_name) {
+        if (Tracer::shared().isEnabled()) begin();
+        if (profile) profile_stage = profile->beginStage(name);
+    }
+    ~TraceSpan() {
+        if (profile) profile->endStage(profile_stage);
+        if (buffer) end();
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+#define TRACE_SCOPE_CONCAT_INNER(a, b) a##b
+#define TRACE_SCOPE_CONCAT(a, b) TRACE_SCOPE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceSpan TRACE_SCOPE_CONCAT(_trace_span_, __LINE__)(name)
+
+#endif // TRACER_H
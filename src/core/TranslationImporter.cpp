@@ -0,0 +1,287 @@
+#include "TranslationImporter.h"
+#include "VerseFinder.h"
+#include <fstream>
+#include <iostream>
+
+TranslationImporter::TranslationImporter(TranslationInfo& info, VerseStore& store, InvertedIndex& index,
+                                         BookNormalizer normalize_book)
+    : info(info), store(store), index(index), normalize_book(std::move(normalize_book)) {
+}
+
+void TranslationImporter::reset() {
+    info = TranslationInfo("Unknown", "UNK");
+    contexts.clear();
+    current_key.clear();
+    last_error.clear();
+    verse_count = 0;
+    book_name.clear();
+    has_book_name = false;
+    book_pending.clear();
+    chapter_number = 1;
+    has_chapter_number = false;
+    chapter_pending.clear();
+    verse_number = 1;
+    verse_text.clear();
+}
+
+bool TranslationImporter::importData(std::string_view data) {
+    reset();
+    // Text can never be larger than the document that carries it
+    store.reserve(data.size() / 160, data.size() * 3 / 4);
+
+    bool ok = false;
+    try {
+        ok = nlohmann::json::sax_parse(data, this);
+    } catch (const std::exception& e) {
+        last_error = e.what();
+    }
+    if (!ok) return false;
+
+    store.finalize();
+    index.addVerses(store);
+    index.finalize();
+    info.is_loaded = true;
+    return true;
+}
+
+bool TranslationImporter::importFile(const std::string& filename) {
+    reset();
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        last_error = "Could not open " + filename;
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    size_t file_size = static_cast<size_t>(file.tellg());
+    file.seekg(0, std::ios::beg);
+    store.reserve(file_size / 160, file_size * 3 / 4); // ~160 bytes of JSON per verse
+
+    bool ok = false;
+    try {
+        ok = nlohmann::json::sax_parse(file, this);
+    } catch (const std::exception& e) {
+        last_error = e.what();
+    }
+    if (!ok) return false;
+
+    store.finalize();
+    index.addVerses(store);
+    index.finalize();
+    info.filename = filename;
+    info.is_loaded = true;
+    return true;
+}
+
+bool TranslationImporter::readHeader(const std::string& filename) {
+    reset();
+    const std::string unnamed = info.name;
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        last_error = "Could not open " + filename;
+        return false;
+    }
+
+    // start_array() cuts the parse short at "books", which sax_parse reports as a failure
+    header_only = true;
+    try {
+        nlohmann::json::sax_parse(file, this);
+    } catch (const std::exception& e) {
+        last_error = e.what();
+    }
+    header_only = false;
+    if (info.name == unnamed) return false;
+
+    info.filename = filename;
+    info.is_loaded = false;
+    return true;
+}
+
+void TranslationImporter::emitVerse(int chapter, int verse, std::string_view text) {
+    VerseId id = store.addVerse(book_name, chapter, verse, text);
+    if (id == INVALID_VERSE_ID) return; // Duplicate reference, keep the first occurrence
+
+    ++verse_count;
+}
+
+void TranslationImporter::finishVerse() {
+    if (!has_chapter_number) {
+        chapter_pending.push_back({0, verse_number, std::move(verse_text)});
+    } else if (!has_book_name) {
+        book_pending.push_back({chapter_number, verse_number, std::move(verse_text)});
+    } else {
+        emitVerse(chapter_number, verse_number, verse_text);
+    }
+}
+
+void TranslationImporter::finishChapter() {
+    for (auto& pending : chapter_pending) {
+        pending.chapter = chapter_number;
+        if (has_book_name) {
+            emitVerse(pending.chapter, pending.verse, pending.text);
+        } else {
+            book_pending.push_back(std::move(pending));
+        }
+    }
+    chapter_pending.clear();
+}
+
+void TranslationImporter::finishBook() {
+    if (!has_book_name) {
+        book_name = normalize_book ? normalize_book("Unknown Book") : "Unknown Book";
+        has_book_name = true;
+    }
+    for (const auto& pending : book_pending) {
+        emitVerse(pending.chapter, pending.verse, pending.text);
+    }
+    book_pending.clear();
+}
+
+bool TranslationImporter::number(int64_t value) {
+    switch (top()) {
+        case Context::Root:
+            if (current_key == "year") info.year = static_cast<int>(value);
+            break;
+        case Context::Chapter:
+            if (current_key == "chapter") {
+                chapter_number = static_cast<int>(value);
+                has_chapter_number = true;
+            }
+            break;
+        case Context::Verse:
+            if (current_key == "verse") verse_number = static_cast<int>(value);
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+bool TranslationImporter::null() {
+    return true;
+}
+
+bool TranslationImporter::boolean(bool) {
+    return true;
+}
+
+bool TranslationImporter::number_integer(number_integer_t val) {
+    return number(val);
+}
+
+bool TranslationImporter::number_unsigned(number_unsigned_t val) {
+    return number(static_cast<int64_t>(val));
+}
+
+bool TranslationImporter::number_float(number_float_t val, const string_t&) {
+    return number(static_cast<int64_t>(val));
+}
+
+bool TranslationImporter::string(string_t& val) {
+    switch (top()) {
+        case Context::Root:
+            if (current_key == "translation") info.name = std::move(val);
+            else if (current_key == "abbreviation") info.abbreviation = std::move(val);
+            else if (current_key == "description") info.description = std::move(val);
+            else if (current_key == "language") info.language = std::move(val);
+            break;
+        case Context::Book:
+            if (current_key == "name") {
+                book_name = normalize_book ? normalize_book(val) : val;
+                has_book_name = true;
+                // Chapters that arrived before the name can go out now
+                for (const auto& pending : book_pending) {
+                    emitVerse(pending.chapter, pending.verse, pending.text);
+                }
+                book_pending.clear();
+            }
+            break;
+        case Context::Verse:
+            if (current_key == "text") verse_text = std::move(val);
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+bool TranslationImporter::binary(binary_t&) {
+    return true;
+}
+
+bool TranslationImporter::start_object(std::size_t) {
+    Context next = Context::Skip;
+    if (contexts.empty()) {
+        next = Context::Root;
+    } else {
+        switch (top()) {
+            case Context::Books:
+                next = Context::Book;
+                book_name.clear();
+                has_book_name = false;
+                break;
+            case Context::Chapters:
+                next = Context::Chapter;
+                chapter_number = 1;
+                has_chapter_number = false;
+                break;
+            case Context::Verses:
+                next = Context::Verse;
+                verse_number = 1;
+                verse_text.clear();
+                break;
+            default:
+                break;
+        }
+    }
+    contexts.push_back(next);
+    current_key.clear();
+    return true;
+}
+
+bool TranslationImporter::key(string_t& val) {
+    current_key = std::move(val);
+    return true;
+}
+
+bool TranslationImporter::end_object() {
+    Context ended = top();
+    contexts.pop_back();
+    current_key.clear();
+
+    switch (ended) {
+        case Context::Verse: finishVerse(); break;
+        case Context::Chapter: finishChapter(); break;
+        case Context::Book: finishBook(); break;
+        default: break;
+    }
+    return true;
+}
+
+bool TranslationImporter::start_array(std::size_t) {
+    Context next = Context::Skip;
+    Context parent = top();
+    if (parent == Context::Root && current_key == "books") {
+        if (header_only) return false;
+        next = Context::Books;
+    } else if (parent == Context::Book && current_key == "chapters") {
+        next = Context::Chapters;
+    } else if (parent == Context::Chapter && current_key == "verses") {
+        next = Context::Verses;
+    }
+    contexts.push_back(next);
+    return true;
+}
+
+bool TranslationImporter::end_array() {
+    contexts.pop_back();
+    return true;
+}
+
+bool TranslationImporter::parse_error(std::size_t position, const std::string& last_token,
+                                      const nlohmann::detail::exception& ex) {
+    last_error = "Parse error at byte " + std::to_string(position) + " near '" + last_token + "': " + ex.what();
+    return false;
+}
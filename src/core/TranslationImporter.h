@@ -0,0 +1,97 @@
+#ifndef TRANSLATIONIMPORTER_H
+#define TRANSLATIONIMPORTER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include "nlohmann/json.hpp"
+#include "VerseStore.h"
+
+struct TranslationInfo;
+class InvertedIndex;
+
+// Streaming importer for the translation JSON format. Built on nlohmann's SAX
+// interface: verses go straight into the verse store as they are read, so no
+// DOM of the whole file is ever held in memory; the index is built from the
+// store once the document ends.
+// Key order inside book/chapter/verse objects does not matter; verses seen
+// before their book name or chapter number are held until it is known.
+class TranslationImporter : public nlohmann::json_sax<nlohmann::json> {
+public:
+    using BookNormalizer = std::function<std::string(const std::string&)>;
+
+private:
+    enum class Context { Root, Books, Book, Chapters, Chapter, Verses, Verse, Skip };
+
+    struct PendingVerse {
+        int chapter;
+        int verse;
+        std::string text;
+    };
+
+    TranslationInfo& info;
+    VerseStore& store;
+    InvertedIndex& index;
+    BookNormalizer normalize_book;
+
+    std::vector<Context> contexts;
+    bool header_only = false; // stop at "books"
+    std::string current_key;
+    std::string last_error;
+    size_t verse_count = 0;
+
+    // Current book
+    std::string book_name;
+    bool has_book_name = false;
+    std::vector<PendingVerse> book_pending;
+
+    // Current chapter
+    int chapter_number = 1;
+    bool has_chapter_number = false;
+    std::vector<PendingVerse> chapter_pending;
+
+    // Current verse
+    int verse_number = 1;
+    std::string verse_text;
+
+    void emitVerse(int chapter, int verse, std::string_view text);
+    void finishVerse();
+    void finishChapter();
+    void finishBook();
+    Context top() const { return contexts.empty() ? Context::Skip : contexts.back(); }
+    bool number(int64_t value);
+    void reset();
+
+public:
+    TranslationImporter(TranslationInfo& info, VerseStore& store, InvertedIndex& index,
+                        BookNormalizer normalize_book = {});
+
+    // Stream a translation document; returns false on malformed JSON
+    bool importData(std::string_view data);
+    bool importFile(const std::string& filename);
+    // Metadata only: parsing stops where "books" begins, so the cost is a few
+    // hundred bytes whatever the file's size. False if no name precedes the verses.
+    bool readHeader(const std::string& filename);
+
+    const std::string& getLastError() const { return last_error; }
+    size_t getVerseCount() const { return verse_count; }
+
+    // SAX callbacks
+    bool null() override;
+    bool boolean(bool val) override;
+    bool number_integer(number_integer_t val) override;
+    bool number_unsigned(number_unsigned_t val) override;
+    bool number_float(number_float_t val, const string_t& s) override;
+    bool string(string_t& val) override;
+    bool binary(binary_t& val) override;
+    bool start_object(std::size_t elements) override;
+    bool key(string_t& val) override;
+    bool end_object() override;
+    bool start_array(std::size_t elements) override;
+    bool end_array() override;
+    bool parse_error(std::size_t position, const std::string& last_token,
+                     const nlohmann::detail::exception& ex) override;
+};
+
+#endif // TRANSLATIONIMPORTER_H
@@ -0,0 +1,397 @@
+#include "TranslationSnapshot.h"
+#include "VerseFinder.h"
+#include "MappedFile.h"
+#include "SubstringIndex.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <span>
+
+namespace {
+
+constexpr char SNAPSHOT_MAGIC[8] = {'V', 'F', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t source_size;
+    int64_t source_mtime;
+    uint64_t payload_size;
+    uint64_t payload_checksum;
+    uint32_t verse_count;
+    uint32_t book_count;
+    uint32_t term_count;
+    uint32_t reserved;
+};
+static_assert(sizeof(SnapshotHeader) % 8 == 0, "payload must start 8-byte aligned");
+
+// Appends fixed-layout values to the payload buffer
+class SnapshotWriter {
+private:
+    std::string buffer;
+
+public:
+    template <typename T>
+    void pod(const T& value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void array(std::span<const T> values) {
+        buffer.append(reinterpret_cast<const char*>(values.data()), values.size_bytes());
+    }
+
+    void str(std::string_view value) {
+        pod(static_cast<uint32_t>(value.size()));
+        buffer.append(value.data(), value.size());
+    }
+
+    void align() {
+        buffer.append((8 - buffer.size() % 8) % 8, '\0');
+    }
+
+    void reserve(size_t bytes) { buffer.reserve(bytes); }
+    const std::string& data() const { return buffer; }
+};
+
+// Bounds-checked cursor over the mapped payload; any overrun poisons the reader
+class SnapshotReader {
+private:
+    const char* base;
+    size_t size;
+    size_t pos = 0;
+    bool valid = true;
+
+public:
+    SnapshotReader(const char* data, size_t length) : base(data), size(length) {}
+
+    bool ok() const { return valid; }
+
+    template <typename T>
+    bool pod(T& value) {
+        if (!valid || size - pos < sizeof(T)) return valid = false;
+        std::memcpy(&value, base + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    // Zero-copy view; the mapping base is page aligned and sections are aligned on write
+    template <typename T>
+    std::span<const T> array(size_t count) {
+        if (!valid || count > (size - pos) / sizeof(T) ||
+            reinterpret_cast<uintptr_t>(base + pos) % alignof(T) != 0) {
+            valid = false;
+            return {};
+        }
+        std::span<const T> view(reinterpret_cast<const T*>(base + pos), count);
+        pos += count * sizeof(T);
+        return view;
+    }
+
+    std::string_view bytes(size_t count) {
+        if (!valid || count > size - pos) {
+            valid = false;
+            return {};
+        }
+        std::string_view view(base + pos, count);
+        pos += count;
+        return view;
+    }
+
+    bool str(std::string& value) {
+        uint32_t length = 0;
+        if (!pod(length)) return false;
+        std::string_view view = bytes(length);
+        if (!valid) return false;
+        value.assign(view.data(), view.size());
+        return true;
+    }
+
+    void align() {
+        size_t padded = pos + (8 - pos % 8) % 8;
+        if (padded > size) valid = false;
+        else pos = padded;
+    }
+};
+
+// The fixed header, if the file is a complete snapshot of this format
+bool readHeader(const MappedFile& file, SnapshotHeader& header) {
+    if (file.size() < sizeof(SnapshotHeader)) return false;
+    std::memcpy(&header, file.data(), sizeof(header));
+    return std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 &&
+           header.version == TranslationSnapshot::FORMAT_VERSION && header.byte_order == BYTE_ORDER_MARK &&
+           header.payload_size == file.size() - sizeof(SnapshotHeader);
+}
+
+bool readMetadata(SnapshotReader& reader, const std::string& source_path, TranslationInfo& info) {
+    int32_t year = 0;
+    reader.str(info.name);
+    reader.str(info.abbreviation);
+    reader.str(info.description);
+    reader.str(info.language);
+    reader.pod(year);
+    reader.align();
+    info.year = year;
+    info.filename = source_path;
+    return reader.ok();
+}
+
+} // namespace
+
+std::string TranslationSnapshot::snapshotPathFor(const std::string& source_path) {
+    return std::filesystem::path(source_path).replace_extension(".vfsnap").string();
+}
+
+uint64_t TranslationSnapshot::checksum(const char* data, size_t size) {
+    // FNV-1a over 64-bit words; only has to catch truncation and corruption
+    uint64_t hash = 1469598103934665603ULL;
+    constexpr uint64_t prime = 1099511628211ULL;
+
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+    }
+    return hash;
+}
+
+bool TranslationSnapshot::sourceStamp(const std::string& source_path, uint64_t& size, int64_t& mtime) {
+    std::error_code ec;
+    size = std::filesystem::file_size(source_path, ec);
+    if (ec) return false;
+    auto write_time = std::filesystem::last_write_time(source_path, ec);
+    if (ec) return false;
+    mtime = static_cast<int64_t>(write_time.time_since_epoch().count());
+    return true;
+}
+
+bool TranslationSnapshot::isStale(const std::string& source_path, uint64_t size, int64_t mtime) {
+    uint64_t source_size = 0;
+    int64_t source_mtime = 0;
+    return sourceStamp(source_path, source_size, source_mtime) && (source_size != size || source_mtime != mtime);
+}
+
+bool TranslationSnapshot::readInfo(const std::string& snapshot_path, const std::string& source_path,
+                                   TranslationInfo& info) {
+    MappedFile file;
+    SnapshotHeader header;
+    if (!file.open(snapshot_path) || !readHeader(file, header) ||
+        isStale(source_path, header.source_size, header.source_mtime)) {
+        return false;
+    }
+
+    // Only the pages holding the metadata are ever read in
+    SnapshotReader reader(file.data() + sizeof(SnapshotHeader), header.payload_size);
+    TranslationInfo listed;
+    if (!readMetadata(reader, source_path, listed)) return false;
+    info = std::move(listed);
+    return true;
+}
+
+bool TranslationSnapshot::write(const std::string& snapshot_path, const std::string& source_path,
+                                const TranslationInfo& info, const VerseStore& store, const InvertedIndex& index,
+                                const SubstringIndex* substrings) {
+    // Snapshots hold plain text, which readers map and use in place
+    if (store.isCompressed()) return false;
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = FORMAT_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    if (!sourceStamp(source_path, header.source_size, header.source_mtime)) return false;
+    header.verse_count = static_cast<uint32_t>(store.size());
+    header.book_count = static_cast<uint32_t>(store.books().size());
+    header.term_count = static_cast<uint32_t>(index.termCount());
+
+    SnapshotWriter writer;
+    size_t substring_bytes = substrings ? substrings->foldedText().size() + substrings->suffixes().size_bytes() : 0;
+    writer.reserve(store.textBlob().size() * 2 + substring_bytes);
+
+    // Metadata
+    writer.str(info.name);
+    writer.str(info.abbreviation);
+    writer.str(info.description);
+    writer.str(info.language);
+    writer.pod(static_cast<int32_t>(info.year));
+    writer.align();
+
+    // Book names
+    for (const auto& book : store.books()) {
+        writer.str(book);
+    }
+    writer.align();
+
+    // Verse columns and packed text
+    writer.array(store.bookColumn());
+    writer.align();
+    writer.array(store.chapterColumn());
+    writer.align();
+    writer.array(store.verseColumn());
+    writer.align();
+    writer.array(store.textOffsets());
+    writer.align();
+    std::string_view text = store.textBlob();
+    writer.array(std::span<const char>(text.data(), text.size()));
+    writer.align();
+
+    // Positional index, in token order so equal indexes write equal files
+    for (const auto* entry : index.termsInOrder()) {
+        const TermPostings& term = entry->second;
+        writer.str(entry->first);
+        writer.align();
+        writer.pod(static_cast<uint32_t>(term.ids.size()));
+        writer.pod(static_cast<uint32_t>(term.positions.size()));
+        writer.array(std::span<const VerseId>(term.ids));
+        writer.array(std::span<const uint32_t>(term.position_offsets));
+        writer.array(std::span<const uint16_t>(term.positions));
+        writer.align();
+    }
+
+    // Substring index, if one was built for this store
+    bool has_substrings = substrings && !substrings->empty() && substrings->verseCount() == store.size();
+    std::string_view folded = has_substrings ? substrings->foldedText() : std::string_view();
+    writer.pod(static_cast<uint64_t>(folded.size()));
+    writer.pod(static_cast<uint64_t>(has_substrings ? substrings->suffixes().size() : 0));
+    if (has_substrings) {
+        writer.array(std::span<const char>(folded.data(), folded.size()));
+        writer.align();
+        writer.array(substrings->starts());
+        writer.align();
+        writer.array(substrings->suffixes());
+        writer.align();
+    }
+
+    const std::string& payload = writer.data();
+    header.payload_size = payload.size();
+    header.payload_checksum = checksum(payload.data(), payload.size());
+
+    // Write to a temporary name and rename so readers never see a torn file
+    std::string temp_path = snapshot_path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Warning: Could not write snapshot " << snapshot_path << std::endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+        if (!out.good()) {
+            out.close();
+            std::error_code ec;
+            std::filesystem::remove(temp_path, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp_path, snapshot_path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+    return true;
+}
+
+bool TranslationSnapshot::load(const std::string& snapshot_path, const std::string& source_path,
+                               TranslationInfo& info, VerseStore& store, InvertedIndex& index,
+                               SubstringIndex* substrings) {
+    auto file = std::make_shared<MappedFile>();
+    SnapshotHeader header;
+    if (!file->open(snapshot_path) || !readHeader(*file, header)) {
+        return false;
+    }
+
+    // Stale if the source JSON changed since the snapshot was written
+    if (isStale(source_path, header.source_size, header.source_mtime)) {
+        return false;
+    }
+
+    const char* payload = file->data() + sizeof(SnapshotHeader);
+    if (checksum(payload, header.payload_size) != header.payload_checksum) {
+        std::cerr << "Warning: Snapshot checksum mismatch, re-importing " << source_path << std::endl;
+        return false;
+    }
+
+    SnapshotReader reader(payload, header.payload_size);
+
+    TranslationInfo loaded_info;
+    readMetadata(reader, source_path, loaded_info);
+    loaded_info.is_loaded = true;
+
+    std::vector<std::string> books(header.book_count);
+    for (auto& book : books) {
+        reader.str(book);
+    }
+    reader.align();
+
+    size_t count = header.verse_count;
+    auto book_col = reader.array<uint16_t>(count);
+    reader.align();
+    auto chapter_col = reader.array<uint16_t>(count);
+    reader.align();
+    auto verse_col = reader.array<uint16_t>(count);
+    reader.align();
+    auto offsets = reader.array<uint32_t>(count + 1);
+    reader.align();
+    if (!reader.ok() || offsets.empty()) return false;
+    std::string_view text = reader.bytes(offsets[count]);
+    reader.align();
+
+    InvertedIndex loaded_index;
+    loaded_index.reserve(header.term_count);
+    for (uint32_t t = 0; t < header.term_count && reader.ok(); ++t) {
+        std::string token;
+        uint32_t id_count = 0;
+        uint32_t position_count = 0;
+        reader.str(token);
+        reader.align();
+        reader.pod(id_count);
+        reader.pod(position_count);
+        auto ids = reader.array<VerseId>(id_count);
+        auto position_offsets = reader.array<uint32_t>(size_t(id_count) + 1);
+        auto positions = reader.array<uint16_t>(position_count);
+        reader.align();
+        if (!reader.ok() || position_offsets.back() != position_count) return false;
+
+        TermPostings term;
+        term.ids.assign(ids.begin(), ids.end());
+        term.position_offsets.assign(position_offsets.begin(), position_offsets.end());
+        term.positions.assign(positions.begin(), positions.end());
+        loaded_index.addTerm(std::move(token), std::move(term));
+    }
+    if (!reader.ok()) return false;
+
+    uint64_t folded_size = 0;
+    uint64_t suffix_count = 0;
+    reader.pod(folded_size);
+    reader.pod(suffix_count);
+    SubstringIndex loaded_substrings;
+    if (folded_size > 0 && substrings) {
+        std::string_view folded = reader.bytes(folded_size);
+        reader.align();
+        auto starts = reader.array<uint32_t>(size_t(count) + 1);
+        reader.align();
+        auto suffixes = reader.array<uint32_t>(suffix_count);
+        reader.align();
+        if (!reader.ok() || !loaded_substrings.attach(file, count, folded, starts, suffixes)) return false;
+    }
+    if (!reader.ok()) return false;
+    loaded_index.finalize(); // Rebuilds the vocabulary tree
+
+    VerseStore loaded_store;
+    if (!loaded_store.attach(file, std::move(books), book_col, chapter_col, verse_col, offsets, text)) {
+        return false;
+    }
+
+    info = std::move(loaded_info);
+    store = std::move(loaded_store);
+    index = std::move(loaded_index);
+    if (substrings) *substrings = std::move(loaded_substrings);
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef TRANSLATIONSNAPSHOT_H
+#define TRANSLATIONSNAPSHOT_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+struct TranslationInfo;
+class VerseStore;
+class InvertedIndex;
+class SubstringIndex;
+
+// Binary cache of a loaded translation: metadata, verse columns, the packed
+// text buffer and the prebuilt positional index. Written next to the source
+// JSON the first time it is parsed; later loads map the file and borrow the
+// verse columns zero-copy instead of parsing and re-indexing.
+//
+// Layout (native byte order, every section 8-byte aligned):
+//   header | metadata | book names | book/chapter/verse columns (u16)
+//   | text offsets (u32) | text bytes | terms | substring index
+// The substring index is optional: its folded text's size, 0 when there is
+// none, then the folded text, verse starts (u32) and suffix array (u32).
+// The header records the source file's size and mtime so an edited JSON
+// file is re-imported, plus a checksum over everything after the header.
+class TranslationSnapshot {
+public:
+    // 2: index terms are Unicode-folded words
+    // 3: book names are canonical ("Song of Solomon" is stored as "Song of Songs")
+    // 4: an optional substring index follows the terms
+    static constexpr uint32_t FORMAT_VERSION = 4;
+
+    // Snapshot location for a JSON translation, e.g. "kjv.json" -> "kjv.vfsnap"
+    static std::string snapshotPathFor(const std::string& source_path);
+
+    // substrings, if given and built, is stored with the rest
+    static bool write(const std::string& snapshot_path, const std::string& source_path,
+                      const TranslationInfo& info, const VerseStore& store, const InvertedIndex& index,
+                      const SubstringIndex* substrings = nullptr);
+
+    // Returns false for missing, stale, corrupt or version-mismatched snapshots;
+    // the outputs are only modified on success. substrings, if given, borrows
+    // the stored substring index, and is left empty when there is none.
+    static bool load(const std::string& snapshot_path, const std::string& source_path,
+                     TranslationInfo& info, VerseStore& store, InvertedIndex& index,
+                     SubstringIndex* substrings = nullptr);
+    // Just the metadata of a current snapshot, for listing a translation without loading it
+    static bool readInfo(const std::string& snapshot_path, const std::string& source_path, TranslationInfo& info);
+
+private:
+    static uint64_t checksum(const char* data, size_t size);
+    static bool sourceStamp(const std::string& source_path, uint64_t& size, int64_t& mtime);
+    // True when the source JSON changed since a snapshot stamped with size and mtime
+    static bool isStale(const std::string& source_path, uint64_t size, int64_t mtime);
+};
+
+#endif // TRANSLATIONSNAPSHOT_H
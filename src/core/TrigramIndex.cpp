@@ -0,0 +1,123 @@
+#include "TrigramIndex.h"
+#include "TaskScheduler.h"
+#include "TextFolding.h"
+#include "TopK.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+constexpr size_t BUILD_CHUNK = 1024;
+constexpr size_t EXPECTED_TRIGRAMS = 16384; // distinct ones in an English Bible, about
+
+} // namespace
+
+std::vector<uint32_t> TrigramIndex::trigramsOf(std::string_view text) {
+    std::vector<uint32_t> trigrams;
+    std::string words = TextFolding::foldWords(text);
+    if (words.empty()) return trigrams;
+
+    // Padded, so a word's first and last letters make trigrams of their own
+    std::string padded;
+    padded.reserve(words.size() + 2);
+    padded.push_back(' ');
+    padded.append(words);
+    padded.push_back(' ');
+
+    trigrams.reserve(padded.size() - 2);
+    for (size_t i = 0; i + 3 <= padded.size(); ++i) {
+        trigrams.push_back((uint32_t(uint8_t(padded[i])) << 16) | (uint32_t(uint8_t(padded[i + 1])) << 8) |
+                           uint32_t(uint8_t(padded[i + 2])));
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+void TrigramIndex::build(const VerseStore& store) {
+    clear();
+    verse_count = store.size();
+    if (verse_count == 0) return;
+
+    // Each chunk's trigrams, verse after verse, and where each verse's run ends
+    size_t chunk_count = (verse_count + BUILD_CHUNK - 1) / BUILD_CHUNK;
+    std::vector<std::vector<uint32_t>> chunk_trigrams(chunk_count);
+    std::vector<std::vector<uint32_t>> chunk_ends(chunk_count);
+    TaskScheduler::shared().parallelFor(chunk_count, [&](size_t chunk) {
+        size_t end = std::min(verse_count, (chunk + 1) * BUILD_CHUNK);
+        for (size_t id = chunk * BUILD_CHUNK; id < end; ++id) {
+            std::vector<uint32_t> trigrams = trigramsOf(store.text(static_cast<VerseId>(id)));
+            chunk_trigrams[chunk].insert(chunk_trigrams[chunk].end(), trigrams.begin(), trigrams.end());
+            chunk_ends[chunk].push_back(static_cast<uint32_t>(chunk_trigrams[chunk].size()));
+        }
+    });
+
+    // Verses per trigram, then each trigram's slot once the keys are sorted
+    std::unordered_map<uint32_t, uint32_t> slots;
+    slots.reserve(EXPECTED_TRIGRAMS);
+    size_t total = 0;
+    for (const auto& trigrams : chunk_trigrams) {
+        for (uint32_t trigram : trigrams) ++slots[trigram];
+        total += trigrams.size();
+    }
+    keys.reserve(slots.size());
+    for (const auto& entry : slots) keys.push_back(entry.first);
+    std::sort(keys.begin(), keys.end());
+    offsets.resize(keys.size() + 1);
+    offsets[0] = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        uint32_t& slot = slots[keys[i]];
+        offsets[i + 1] = offsets[i] + slot;
+        slot = static_cast<uint32_t>(i);
+    }
+
+    // Verses in id order, so every posting list comes out sorted
+    ids.resize(total);
+    std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+        uint32_t begin = 0;
+        for (size_t verse = 0; verse < chunk_ends[chunk].size(); ++verse) {
+            VerseId id = static_cast<VerseId>(chunk * BUILD_CHUNK + verse);
+            for (uint32_t i = begin; i < chunk_ends[chunk][verse]; ++i) {
+                ids[cursors[slots[chunk_trigrams[chunk][i]]]++] = id;
+            }
+            begin = chunk_ends[chunk][verse];
+        }
+    }
+}
+
+void TrigramIndex::clear() {
+    keys.clear();
+    keys.shrink_to_fit();
+    offsets.clear();
+    offsets.shrink_to_fit();
+    ids.clear();
+    ids.shrink_to_fit();
+    verse_count = 0;
+}
+
+std::vector<TrigramIndex::Candidate> TrigramIndex::candidates(std::string_view query, size_t k,
+                                                              size_t min_shared) const {
+    std::vector<uint32_t> query_trigrams = trigramsOf(query);
+    if (empty() || query_trigrams.empty() || k == 0) return {};
+
+    std::vector<uint32_t> shared(verse_count, 0);
+    std::vector<VerseId> touched;
+    for (uint32_t trigram : query_trigrams) {
+        auto key = std::lower_bound(keys.begin(), keys.end(), trigram);
+        if (key == keys.end() || *key != trigram) continue;
+        size_t slot = static_cast<size_t>(key - keys.begin());
+        for (uint32_t i = offsets[slot]; i < offsets[slot + 1]; ++i) {
+            if (shared[ids[i]]++ == 0) touched.push_back(ids[i]);
+        }
+    }
+
+    auto better = [](const Candidate& a, const Candidate& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    };
+    TopK<Candidate, decltype(better)> top(k, better);
+    for (VerseId id : touched) {
+        if (shared[id] >= min_shared) top.push({id, shared[id]});
+    }
+    return top.take();
+}
@@ -0,0 +1,49 @@
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "VerseStore.h"
+
+// Candidate generator for fuzzy search. Each verse's folded words, joined
+// by single spaces and padded with one at either end, are cut into byte
+// trigrams; a misspelled or partly remembered phrase still shares most of
+// its trigrams with the verse it came from, whatever words it got wrong.
+// candidates() counts, per verse, the query trigrams it contains and keeps
+// the best k, so precise scoring only sees verses worth scoring.
+//
+// Postings are one array of verse ids grouped by trigram (sorted keys and
+// offsets into it), each group in id order: 4 bytes per distinct trigram
+// of each verse.
+class TrigramIndex {
+public:
+    using Candidate = std::pair<VerseId, uint32_t>; // verse, trigrams shared with the query
+
+private:
+    std::vector<uint32_t> keys;    // sorted trigrams, three bytes packed
+    std::vector<uint32_t> offsets; // keys.size() + 1 bounds into ids
+    std::vector<VerseId> ids;
+    size_t verse_count = 0;
+
+public:
+    // Distinct trigrams of text's folded words, sorted
+    static std::vector<uint32_t> trigramsOf(std::string_view text);
+
+    // Index every verse of store, in parallel
+    void build(const VerseStore& store);
+    void clear();
+
+    // Up to k verses sharing at least min_shared of query's trigrams, most
+    // shared first (ties by id)
+    std::vector<Candidate> candidates(std::string_view query, size_t k, size_t min_shared = 1) const;
+
+    size_t verseCount() const { return verse_count; }
+    bool empty() const { return ids.empty(); }
+    size_t getMemoryUsage() const {
+        return (keys.capacity() + offsets.capacity()) * sizeof(uint32_t) + ids.capacity() * sizeof(VerseId);
+    }
+};
+
+#endif // TRIGRAMINDEX_H
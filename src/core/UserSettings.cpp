@@ -138,6 +138,7 @@ void to_json(json& j, const AccessibilitySettings& settings) {
         {"large_text_enabled", settings.large_text_enabled},
         {"screen_reader_enabled", settings.screen_reader_enabled},
         {"voice_commands_enabled", settings.voice_commands_enabled},
+        {"voice_confirm_live_commands", settings.voice_confirm_live_commands},
         {"audio_feedback_enabled", settings.audio_feedback_enabled},
         {"enhanced_keyboard_nav", settings.enhanced_keyboard_nav},
         {"focus_indicators_enabled", settings.focus_indicators_enabled},
@@ -158,6 +159,7 @@ void from_json(const json& j, AccessibilitySettings& settings) {
     if (j.contains("large_text_enabled")) j.at("large_text_enabled").get_to(settings.large_text_enabled);
     if (j.contains("screen_reader_enabled")) j.at("screen_reader_enabled").get_to(settings.screen_reader_enabled);
     if (j.contains("voice_commands_enabled")) j.at("voice_commands_enabled").get_to(settings.voice_commands_enabled);
+    if (j.contains("voice_confirm_live_commands")) j.at("voice_confirm_live_commands").get_to(settings.voice_confirm_live_commands);
     if (j.contains("audio_feedback_enabled")) j.at("audio_feedback_enabled").get_to(settings.audio_feedback_enabled);
     if (j.contains("enhanced_keyboard_nav")) j.at("enhanced_keyboard_nav").get_to(settings.enhanced_keyboard_nav);
     if (j.contains("focus_indicators_enabled")) j.at("focus_indicators_enabled").get_to(settings.focus_indicators_enabled);
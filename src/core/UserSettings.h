@@ -70,6 +70,7 @@ struct AccessibilitySettings {
     bool large_text_enabled = false;
     bool screen_reader_enabled = false;
     bool voice_commands_enabled = false;
+    bool voice_confirm_live_commands = true; // operator confirms spoken commands that change the live display
     bool audio_feedback_enabled = false;
     bool enhanced_keyboard_nav = true;
     bool focus_indicators_enabled = true;
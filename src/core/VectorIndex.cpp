@@ -0,0 +1,573 @@
+#include "VectorIndex.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <queue>
+#include <random>
+
+namespace {
+
+constexpr char EMBEDDINGS_MAGIC[8] = {'V', 'F', 'E', 'M', 'B', '\0', '\0', '\0'};
+constexpr char GRAPH_MAGIC[8] = {'V', 'F', 'H', 'N', 'S', 'W', '\0', '\0'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr uint32_t MAX_LEVEL = 16;
+
+struct EmbeddingsHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t count;
+    uint32_t dimensions;
+    uint32_t encoding;
+    uint32_t reserved;
+};
+static_assert(sizeof(EmbeddingsHeader) % 8 == 0, "sections must start 8-byte aligned");
+
+struct GraphHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t embeddings_stamp;
+    uint32_t count;
+    uint32_t links;
+    uint32_t entry_point;
+    uint32_t max_level;
+    uint64_t upper_size;
+};
+static_assert(sizeof(GraphHeader) % 8 == 0, "sections must start 8-byte aligned");
+
+size_t padTo8(size_t bytes) {
+    return bytes + (8 - bytes % 8) % 8;
+}
+
+float halfToFloat(uint16_t half) {
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    uint32_t exponent = (half >> 10) & 0x1Fu;
+    uint32_t mantissa = half & 0x3FFu;
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // Subnormal: shift the leading one into the implicit bit
+            exponent = 127 - 15 + 1;
+            while ((mantissa & 0x400u) == 0) {
+                mantissa <<= 1;
+                --exponent;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FFu) << 13);
+        }
+    } else if (exponent == 31) {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    uint32_t raw_exponent = (bits >> 23) & 0xFFu;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+    if (raw_exponent == 0xFF) return sign | 0x7C00u | (mantissa ? 0x200u : 0u);
+
+    int32_t exponent = static_cast<int32_t>(raw_exponent) - 127 + 15;
+    if (exponent >= 31) return sign | 0x7C00u;
+    if (exponent <= 0) {
+        if (exponent < -10) return sign;
+        mantissa |= 0x800000u;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1u) ++half;
+        return static_cast<uint16_t>(sign | half);
+    }
+    // Rounding may carry into the exponent, which is still the right result
+    uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    if (mantissa & 0x1000u) ++half;
+    return static_cast<uint16_t>(sign | half);
+}
+
+// Every float16 value decoded once: a lookup is cheaper than the bit twiddling
+const float* halfTable() {
+    static const std::vector<float> table = [] {
+        std::vector<float> values(65536);
+        for (uint32_t half = 0; half < values.size(); ++half) {
+            values[half] = halfToFloat(static_cast<uint16_t>(half));
+        }
+        return values;
+    }();
+    return table.data();
+}
+
+float dotProduct(const float* a, const float* b, size_t length) {
+    // Independent partial sums let the compiler vectorize without -ffast-math
+    float sums[8] = {};
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        for (size_t lane = 0; lane < 8; ++lane) sums[lane] += a[i + lane] * b[i + lane];
+    }
+    float sum = ((sums[0] + sums[1]) + (sums[2] + sums[3])) + ((sums[4] + sums[5]) + (sums[6] + sums[7]));
+    for (; i < length; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+// Nodes seen by the current search, marked with a per-search epoch so the
+// array is cleared only when the epoch wraps
+struct VisitedSet {
+    std::vector<uint32_t> marks;
+    uint32_t epoch = 0;
+
+    void reset(size_t size) {
+        if (marks.size() < size) marks.resize(size, 0);
+        if (++epoch == 0) {
+            std::fill(marks.begin(), marks.end(), 0);
+            epoch = 1;
+        }
+    }
+    // True the first time node is seen in this search
+    bool visit(uint32_t node) {
+        if (marks[node] == epoch) return false;
+        marks[node] = epoch;
+        return true;
+    }
+};
+
+thread_local VisitedSet visited_nodes;
+
+uint64_t fileStamp(const std::string& path) {
+    std::error_code error;
+    uint64_t size = std::filesystem::file_size(path, error);
+    if (error) return 0;
+    auto mtime = std::filesystem::last_write_time(path, error);
+    if (error) return 0;
+    uint64_t ticks = static_cast<uint64_t>(mtime.time_since_epoch().count());
+    return size ^ (ticks * 0x9E3779B97F4A7C15ULL);
+}
+
+struct CloserFirst {
+    bool operator()(const VectorIndex::Neighbor& a, const VectorIndex::Neighbor& b) const { return a.second < b.second; }
+};
+struct FartherFirst {
+    bool operator()(const VectorIndex::Neighbor& a, const VectorIndex::Neighbor& b) const { return a.second > b.second; }
+};
+
+bool moreSimilar(const VectorIndex::Neighbor& a, const VectorIndex::Neighbor& b) {
+    if (a.second != b.second) return a.second > b.second;
+    return a.first < b.first;
+}
+
+} // namespace
+
+VectorIndex::VectorIndex() = default;
+VectorIndex::~VectorIndex() = default;
+
+std::string VectorIndex::embeddingsPathFor(const std::string& source_path) {
+    return std::filesystem::path(source_path).replace_extension(".vfemb").string();
+}
+
+std::string VectorIndex::graphPathFor(const std::string& embeddings_path) {
+    return std::filesystem::path(embeddings_path).replace_extension(".vfhnsw").string();
+}
+
+bool VectorIndex::writeEmbeddings(const std::string& path, const std::vector<std::vector<float>>& embeddings,
+                                  Encoding encoding) {
+    if (embeddings.empty() || embeddings.front().empty()) return false;
+    const size_t dimensions = embeddings.front().size();
+
+    EmbeddingsHeader header{};
+    std::memcpy(header.magic, EMBEDDINGS_MAGIC, sizeof(header.magic));
+    header.version = FORMAT_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.count = static_cast<uint32_t>(embeddings.size());
+    header.dimensions = static_cast<uint32_t>(dimensions);
+    header.encoding = static_cast<uint32_t>(encoding);
+
+    std::string buffer(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (encoding == Encoding::INT8) {
+        // Symmetric quantization: each vector's largest magnitude maps to 127
+        std::vector<float> vector_scales;
+        std::string quantized;
+        quantized.reserve(embeddings.size() * dimensions);
+        for (const auto& embedding : embeddings) {
+            if (embedding.size() != dimensions) return false;
+            float peak = 0.0f;
+            for (float value : embedding) peak = std::max(peak, std::fabs(value));
+            float scale = peak > 0.0f ? peak / 127.0f : 1.0f;
+            vector_scales.push_back(scale);
+            for (float value : embedding) {
+                quantized.push_back(static_cast<char>(static_cast<int8_t>(std::lround(value / scale))));
+            }
+        }
+        buffer.append(reinterpret_cast<const char*>(vector_scales.data()), vector_scales.size() * sizeof(float));
+        buffer.append(padTo8(buffer.size()) - buffer.size(), '\0');
+        buffer += quantized;
+    } else {
+        for (const auto& embedding : embeddings) {
+            if (embedding.size() != dimensions) return false;
+            for (float value : embedding) {
+                uint16_t half = floatToHalf(value);
+                buffer.append(reinterpret_cast<const char*>(&half), sizeof(half));
+            }
+        }
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    return static_cast<bool>(out);
+}
+
+bool VectorIndex::open(const std::string& embeddings_path, size_t expected_count) {
+    auto mapped = std::make_shared<MappedFile>();
+    if (!mapped->open(embeddings_path) || mapped->size() < sizeof(EmbeddingsHeader)) return false;
+
+    EmbeddingsHeader header;
+    std::memcpy(&header, mapped->data(), sizeof(header));
+    if (std::memcmp(header.magic, EMBEDDINGS_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != FORMAT_VERSION || header.byte_order != BYTE_ORDER_MARK ||
+        header.count != expected_count || header.count == 0 || header.dimensions == 0) {
+        return false;
+    }
+
+    size_t vector_offset = sizeof(header);
+    size_t element_size = 0;
+    if (header.encoding == static_cast<uint32_t>(Encoding::INT8)) {
+        vector_offset = padTo8(sizeof(header) + size_t(header.count) * sizeof(float));
+        element_size = 1;
+    } else if (header.encoding == static_cast<uint32_t>(Encoding::FLOAT16)) {
+        element_size = 2;
+    } else {
+        return false;
+    }
+    if (mapped->size() < vector_offset + size_t(header.count) * header.dimensions * element_size) return false;
+
+    file = std::move(mapped);
+    encoding = static_cast<Encoding>(header.encoding);
+    count = header.count;
+    dims = header.dimensions;
+    vectors = file->data() + vector_offset;
+    scales = encoding == Encoding::INT8 ? reinterpret_cast<const float*>(file->data() + sizeof(header)) : nullptr;
+
+    // Fold scale and norm into one factor so comparisons need no normalization
+    factors.assign(count, 0.0f);
+    std::vector<float> unit(dims);
+    for (uint32_t node = 0; node < count; ++node) {
+        factors[node] = 1.0f;
+        if (scales) factors[node] = scales[node];
+        decode(node, unit.data());
+        float norm = std::sqrt(dotProduct(unit.data(), unit.data(), dims));
+        factors[node] = norm > 0.0f ? factors[node] / norm : 0.0f;
+    }
+
+    std::string graph_path = graphPathFor(embeddings_path);
+    uint64_t stamp = fileStamp(embeddings_path);
+    if (!loadGraph(graph_path, stamp)) {
+        build();
+        // A failed write only costs the next start another build
+        writeGraph(graph_path, stamp);
+    }
+    return true;
+}
+
+uint32_t* VectorIndex::links(uint32_t node, uint32_t level) {
+    if (level == 0) return base_links.data() + size_t(node) * (BASE_LINKS + 1);
+    return upper_links.data() + upper_offsets[node] + size_t(level - 1) * (LINKS + 1);
+}
+
+const uint32_t* VectorIndex::links(uint32_t node, uint32_t level) const {
+    return const_cast<VectorIndex*>(this)->links(node, level);
+}
+
+float VectorIndex::similarity(const float* query, uint32_t node) const {
+    if (build_vectors) return dotProduct(query, build_vectors + size_t(node) * dims, dims);
+    float sum = 0.0f;
+    if (encoding == Encoding::INT8) {
+        const int8_t* values = reinterpret_cast<const int8_t*>(vectors) + size_t(node) * dims;
+        for (uint32_t i = 0; i < dims; ++i) sum += query[i] * values[i];
+    } else {
+        const float* table = halfTable();
+        const uint16_t* values = reinterpret_cast<const uint16_t*>(vectors) + size_t(node) * dims;
+        for (uint32_t i = 0; i < dims; ++i) sum += query[i] * table[values[i]];
+    }
+    return sum * factors[node];
+}
+
+void VectorIndex::decode(uint32_t node, float* unit_vector) const {
+    if (encoding == Encoding::INT8) {
+        const int8_t* values = reinterpret_cast<const int8_t*>(vectors) + size_t(node) * dims;
+        for (uint32_t i = 0; i < dims; ++i) unit_vector[i] = values[i] * factors[node];
+    } else {
+        const float* table = halfTable();
+        const uint16_t* values = reinterpret_cast<const uint16_t*>(vectors) + size_t(node) * dims;
+        for (uint32_t i = 0; i < dims; ++i) unit_vector[i] = table[values[i]] * factors[node];
+    }
+}
+
+std::vector<VectorIndex::Neighbor> VectorIndex::searchLayer(const float* query, const std::vector<Neighbor>& entries,
+                                                            size_t beam, uint32_t level) const {
+    VisitedSet& visited = visited_nodes;
+    visited.reset(count);
+
+    // Expand the closest unexpanded candidate until none can improve the beam
+    std::priority_queue<Neighbor, std::vector<Neighbor>, CloserFirst> candidates;
+    std::priority_queue<Neighbor, std::vector<Neighbor>, FartherFirst> beam_set;
+    for (const Neighbor& entry : entries) {
+        if (!visited.visit(entry.first)) continue;
+        candidates.push(entry);
+        beam_set.push(entry);
+        if (beam_set.size() > beam) beam_set.pop();
+    }
+
+    while (!candidates.empty()) {
+        Neighbor current = candidates.top();
+        if (beam_set.size() >= beam && current.second < beam_set.top().second) break;
+        candidates.pop();
+
+        const uint32_t* list = links(current.first, level);
+        for (uint32_t i = 1; i <= list[0]; ++i) {
+            uint32_t neighbor = list[i];
+            if (!visited.visit(neighbor)) continue;
+            float score = similarity(query, neighbor);
+            if (beam_set.size() < beam || score > beam_set.top().second) {
+                candidates.push({neighbor, score});
+                beam_set.push({neighbor, score});
+                if (beam_set.size() > beam) beam_set.pop();
+            }
+        }
+    }
+
+    std::vector<Neighbor> found;
+    found.reserve(beam_set.size());
+    while (!beam_set.empty()) {
+        found.push_back(beam_set.top());
+        beam_set.pop();
+    }
+    return found;
+}
+
+VectorIndex::Neighbor VectorIndex::greedyDescend(const float* query, Neighbor entry, uint32_t from_level,
+                                                 uint32_t to_level) const {
+    // Upper layers only route: hop to the closest neighbour until none is closer
+    for (uint32_t level = from_level; level > to_level; --level) {
+        bool moved = true;
+        while (moved) {
+            moved = false;
+            const uint32_t* list = links(entry.first, level);
+            for (uint32_t i = 1; i <= list[0]; ++i) {
+                float score = similarity(query, list[i]);
+                if (score > entry.second) {
+                    entry = {list[i], score};
+                    moved = true;
+                }
+            }
+        }
+    }
+    return entry;
+}
+
+std::vector<VectorIndex::Neighbor> VectorIndex::search(std::span<const float> query, size_t k, size_t beam) const {
+    if (count == 0 || k == 0 || query.size() != dims) return {};
+
+    std::vector<float> unit(query.begin(), query.end());
+    float norm = std::sqrt(dotProduct(unit.data(), unit.data(), dims));
+    if (norm == 0.0f) return {};
+    for (float& value : unit) value /= norm;
+
+    Neighbor entry = greedyDescend(unit.data(), {entry_point, similarity(unit.data(), entry_point)}, max_level, 0);
+    std::vector<Neighbor> found = searchLayer(unit.data(), {entry}, std::max(beam, k), 0);
+    std::sort(found.begin(), found.end(), moreSimilar);
+    if (found.size() > k) found.resize(k);
+    return found;
+}
+
+void VectorIndex::layoutLevels() {
+    upper_offsets.assign(count, 0);
+    size_t upper_size = 0;
+    for (uint32_t node = 0; node < count; ++node) {
+        upper_offsets[node] = static_cast<uint32_t>(upper_size);
+        upper_size += size_t(levels[node]) * (LINKS + 1);
+    }
+    upper_links.assign(upper_size, 0);
+    base_links.assign(size_t(count) * (BASE_LINKS + 1), 0);
+}
+
+void VectorIndex::build() {
+    // Levels are drawn up front, from a fixed seed so a rebuild gives the same graph
+    std::mt19937 random(0x5eed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    const double level_scale = 1.0 / std::log(static_cast<double>(LINKS));
+    levels.assign(count, 0);
+    for (uint32_t node = 0; node < count; ++node) {
+        double level = -std::log(1.0 - uniform(random)) * level_scale;
+        levels[node] = static_cast<uint8_t>(std::min<double>(level, MAX_LEVEL));
+    }
+    layoutLevels();
+
+    // Unit vectors decoded once for the node-to-node comparisons of neighbour selection
+    std::vector<float> unit_vectors(size_t(count) * dims);
+    for (uint32_t node = 0; node < count; ++node) {
+        decode(node, unit_vectors.data() + size_t(node) * dims);
+    }
+
+    build_vectors = unit_vectors.data();
+    entry_point = 0;
+    max_level = levels[0];
+    for (uint32_t node = 1; node < count; ++node) {
+        const float* query = unit_vectors.data() + size_t(node) * dims;
+        uint32_t level = levels[node];
+
+        Neighbor entry = {entry_point, similarity(query, entry_point)};
+        entry = greedyDescend(query, entry, max_level, std::min(level, max_level));
+        std::vector<Neighbor> entries = {entry};
+        for (uint32_t layer = std::min(level, max_level) + 1; layer-- > 0;) {
+            std::vector<Neighbor> found = searchLayer(query, entries, BUILD_BEAM, layer);
+            std::vector<Neighbor> chosen = selectNeighbors(found, capacity(layer), unit_vectors);
+            uint32_t* list = links(node, layer);
+            list[0] = static_cast<uint32_t>(chosen.size());
+            for (size_t i = 0; i < chosen.size(); ++i) {
+                list[i + 1] = chosen[i].first;
+                connect(chosen[i].first, node, chosen[i].second, layer, unit_vectors);
+            }
+            entries = std::move(found);
+        }
+
+        if (level > max_level) {
+            max_level = level;
+            entry_point = node;
+        }
+    }
+    build_vectors = nullptr;
+}
+
+std::vector<VectorIndex::Neighbor> VectorIndex::selectNeighbors(std::vector<Neighbor> candidates, uint32_t limit,
+                                                                const std::vector<float>& unit_vectors) const {
+    // Keep a candidate only if it is closer to the node than to every neighbour
+    // already kept, which spreads links over directions; top up with the
+    // closest leftovers so sparse regions stay connected
+    std::sort(candidates.begin(), candidates.end(), moreSimilar);
+    std::vector<Neighbor> chosen;
+    std::vector<Neighbor> skipped;
+    for (const Neighbor& candidate : candidates) {
+        if (chosen.size() >= limit) break;
+        const float* candidate_vector = unit_vectors.data() + size_t(candidate.first) * dims;
+        bool diverse = true;
+        for (const Neighbor& kept : chosen) {
+            const float* kept_vector = unit_vectors.data() + size_t(kept.first) * dims;
+            if (dotProduct(candidate_vector, kept_vector, dims) > candidate.second) {
+                diverse = false;
+                break;
+            }
+        }
+        (diverse ? chosen : skipped).push_back(candidate);
+    }
+    for (size_t i = 0; i < skipped.size() && chosen.size() < limit; ++i) {
+        chosen.push_back(skipped[i]);
+    }
+    return chosen;
+}
+
+void VectorIndex::connect(uint32_t node, uint32_t neighbor, float neighbor_similarity, uint32_t level,
+                          const std::vector<float>& unit_vectors) {
+    uint32_t* list = links(node, level);
+    uint32_t limit = capacity(level);
+    if (list[0] < limit) {
+        list[++list[0]] = neighbor;
+        return;
+    }
+
+    // Full: re-select among the current links and the newcomer
+    const float* node_vector = unit_vectors.data() + size_t(node) * dims;
+    std::vector<Neighbor> candidates;
+    candidates.reserve(limit + 1);
+    for (uint32_t i = 1; i <= list[0]; ++i) {
+        const float* linked = unit_vectors.data() + size_t(list[i]) * dims;
+        candidates.push_back({list[i], dotProduct(node_vector, linked, dims)});
+    }
+    candidates.push_back({neighbor, neighbor_similarity});
+    std::vector<Neighbor> chosen = selectNeighbors(std::move(candidates), limit, unit_vectors);
+    list[0] = static_cast<uint32_t>(chosen.size());
+    for (size_t i = 0; i < chosen.size(); ++i) {
+        list[i + 1] = chosen[i].first;
+    }
+}
+
+bool VectorIndex::loadGraph(const std::string& graph_path, uint64_t stamp) {
+    std::ifstream in(graph_path, std::ios::binary);
+    if (!in) return false;
+
+    GraphHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, GRAPH_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != FORMAT_VERSION || header.byte_order != BYTE_ORDER_MARK ||
+        header.embeddings_stamp != stamp || header.count != count || header.links != LINKS ||
+        header.entry_point >= count || header.max_level > MAX_LEVEL) {
+        return false;
+    }
+
+    levels.resize(count);
+    if (!in.read(reinterpret_cast<char*>(levels.data()), count)) return false;
+    in.ignore(static_cast<std::streamsize>(padTo8(count) - count));
+    layoutLevels();
+    if (upper_links.size() != header.upper_size) return false;
+    if (!in.read(reinterpret_cast<char*>(base_links.data()), base_links.size() * sizeof(uint32_t)) ||
+        !in.read(reinterpret_cast<char*>(upper_links.data()), upper_links.size() * sizeof(uint32_t))) {
+        return false;
+    }
+
+    // Reject link lists that would index out of range
+    for (uint32_t node = 0; node < count; ++node) {
+        for (uint32_t level = 0; level <= levels[node]; ++level) {
+            const uint32_t* list = links(node, level);
+            if (list[0] > capacity(level)) return false;
+            for (uint32_t i = 1; i <= list[0]; ++i) {
+                if (list[i] >= count || levels[list[i]] < level) return false;
+            }
+        }
+    }
+    entry_point = header.entry_point;
+    max_level = header.max_level;
+    return levels[entry_point] == max_level;
+}
+
+bool VectorIndex::writeGraph(const std::string& graph_path, uint64_t stamp) const {
+    GraphHeader header{};
+    std::memcpy(header.magic, GRAPH_MAGIC, sizeof(header.magic));
+    header.version = FORMAT_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.embeddings_stamp = stamp;
+    header.count = count;
+    header.links = LINKS;
+    header.entry_point = entry_point;
+    header.max_level = max_level;
+    header.upper_size = upper_links.size();
+
+    // Written to a temporary name first so a crash never leaves a torn graph behind
+    std::string temp_path = graph_path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        std::string padding(padTo8(count) - count, '\0');
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(levels.data()), count);
+        out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+        out.write(reinterpret_cast<const char*>(base_links.data()), base_links.size() * sizeof(uint32_t));
+        out.write(reinterpret_cast<const char*>(upper_links.data()), upper_links.size() * sizeof(uint32_t));
+        if (!out) return false;
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, graph_path, error);
+    return !error;
+}
+
+size_t VectorIndex::getMemoryUsage() const {
+    // The mapped vectors are paged in by the OS and not counted here
+    return factors.capacity() * sizeof(float) + levels.capacity() +
+           (base_links.capacity() + upper_offsets.capacity() + upper_links.capacity()) * sizeof(uint32_t);
+}
@@ -0,0 +1,98 @@
+#ifndef VECTORINDEX_H
+#define VECTORINDEX_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <span>
+#include <utility>
+#include <cstdint>
+
+class MappedFile;
+
+// Approximate nearest-neighbour search over precomputed verse embeddings.
+// The embeddings file ("kjv.vfemb" next to "kjv.json") holds one vector per
+// verse in canonical verse order, as float16 or as int8 with a per-vector
+// scale; it is mapped and vectors are decoded as they are compared. An HNSW
+// graph over them is read from "kjv.vfhnsw", or built and written there when
+// that file is missing or was made for a different embeddings file.
+//
+// Embeddings layout (native byte order, sections 8-byte aligned):
+//   header | scales (f32 per vector, int8 only) | vectors
+class VectorIndex {
+public:
+    enum class Encoding : uint32_t { FLOAT16 = 1, INT8 = 2 };
+    using Neighbor = std::pair<uint32_t, float>; // vector number (canonical verse position), cosine similarity
+
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr uint32_t LINKS = 12;             // per node on the upper layers
+    static constexpr uint32_t BASE_LINKS = 2 * LINKS; // per node on layer 0
+    static constexpr size_t BUILD_BEAM = 80;          // candidates kept while inserting
+    static constexpr size_t DEFAULT_BEAM = 64;        // candidates kept while searching, at least k
+
+private:
+    std::shared_ptr<MappedFile> file;
+    Encoding encoding = Encoding::FLOAT16;
+    uint32_t count = 0;
+    uint32_t dims = 0;
+    const char* vectors = nullptr;
+    const float* scales = nullptr;
+    std::vector<float> factors; // per vector: scale over norm, turning a raw dot product into a cosine
+    const float* build_vectors = nullptr; // decoded unit vectors, compared directly while building
+
+    // Link lists hold their length in slot 0. Layer 0 has BASE_LINKS + 1 slots
+    // per node; a node's upper layers follow each other at upper_offsets[node]
+    std::vector<uint8_t> levels;
+    std::vector<uint32_t> base_links;
+    std::vector<uint32_t> upper_offsets;
+    std::vector<uint32_t> upper_links;
+    uint32_t entry_point = 0;
+    uint32_t max_level = 0;
+
+    uint32_t* links(uint32_t node, uint32_t level);
+    const uint32_t* links(uint32_t node, uint32_t level) const;
+    static uint32_t capacity(uint32_t level) { return level == 0 ? BASE_LINKS : LINKS; }
+
+    // Cosine similarity of a unit-length query and a stored vector
+    float similarity(const float* query, uint32_t node) const;
+    void decode(uint32_t node, float* unit_vector) const;
+    std::vector<Neighbor> searchLayer(const float* query, const std::vector<Neighbor>& entries,
+                                      size_t beam, uint32_t level) const;
+    Neighbor greedyDescend(const float* query, Neighbor entry, uint32_t from_level, uint32_t to_level) const;
+
+    void build();
+    std::vector<Neighbor> selectNeighbors(std::vector<Neighbor> candidates, uint32_t limit,
+                                          const std::vector<float>& unit_vectors) const;
+    void connect(uint32_t node, uint32_t neighbor, float neighbor_similarity, uint32_t level,
+                 const std::vector<float>& unit_vectors);
+    void layoutLevels();
+    bool loadGraph(const std::string& graph_path, uint64_t stamp);
+    bool writeGraph(const std::string& graph_path, uint64_t stamp) const;
+
+public:
+    VectorIndex();
+    ~VectorIndex();
+
+    VectorIndex(const VectorIndex&) = delete;
+    VectorIndex& operator=(const VectorIndex&) = delete;
+
+    // Side file locations, e.g. "kjv.json" -> "kjv.vfemb" -> "kjv.vfhnsw"
+    static std::string embeddingsPathFor(const std::string& source_path);
+    static std::string graphPathFor(const std::string& embeddings_path);
+
+    // Write embeddings (one per verse, canonical order, equal lengths) in the side file format
+    static bool writeEmbeddings(const std::string& path, const std::vector<std::vector<float>>& embeddings,
+                                Encoding encoding);
+
+    // Map the embeddings, which must hold expected_count vectors, and load or build the graph
+    bool open(const std::string& embeddings_path, size_t expected_count);
+
+    // The k stored vectors most similar to query, most similar first
+    std::vector<Neighbor> search(std::span<const float> query, size_t k, size_t beam = DEFAULT_BEAM) const;
+
+    size_t size() const { return count; }
+    size_t dimensions() const { return dims; }
+    size_t getMemoryUsage() const;
+};
+
+#endif // VECTORINDEX_H
@@ -0,0 +1,154 @@
+#include "VerseAlignment.h"
+#include "BookResolver.h"
+#include "VersificationTables.h"
+
+namespace {
+using versification_tables::CHAPTER_COUNTS;
+using versification_tables::VERSE_COUNTS;
+
+// Index of each book's first chapter in VERSE_COUNTS, and of each chapter's first row
+constexpr std::array<uint16_t, CHAPTER_COUNTS.size() + 1> CHAPTER_BEGIN = [] {
+    std::array<uint16_t, CHAPTER_COUNTS.size() + 1> begin{};
+    for (size_t book = 0; book < CHAPTER_COUNTS.size(); book++) {
+        begin[book + 1] = static_cast<uint16_t>(begin[book] + CHAPTER_COUNTS[book]);
+    }
+    return begin;
+}();
+static_assert(CHAPTER_BEGIN.back() == VERSE_COUNTS.size());
+
+constexpr std::array<uint32_t, VERSE_COUNTS.size() + 1> ROW_BEGIN = [] {
+    std::array<uint32_t, VERSE_COUNTS.size() + 1> begin{};
+    for (size_t chapter = 0; chapter < VERSE_COUNTS.size(); chapter++) {
+        begin[chapter + 1] = begin[chapter] + VERSE_COUNTS[chapter];
+    }
+    return begin;
+}();
+
+constexpr int PSALMS = 19;
+constexpr int JOEL = 29;
+constexpr int MALACHI = 39;
+// Psalms a translation numbers one or two verses longer before it counts as
+// numbering titles; a single odd psalm is more likely a split verse
+constexpr int MIN_TITLED_PSALMS = 10;
+
+int lastVerse(const VerseStore& store, int book_id, int chapter) {
+    VerseRange range = store.chapterRange(book_id, chapter);
+    return range.empty() ? 0 : store.verseNumber(store.atPosition(range.last - 1));
+}
+}
+
+uint32_t VerseAlignment::row(int book, int chapter, int verse) {
+    int count = verseCount(book, chapter);
+    if (verse < 1 || verse > count) return NO_ROW;
+    return ROW_BEGIN[CHAPTER_BEGIN[book - 1] + chapter - 1] + static_cast<uint32_t>(verse - 1);
+}
+
+uint32_t VerseAlignment::rowCount() {
+    return ROW_BEGIN.back();
+}
+
+int VerseAlignment::verseCount(int book, int chapter) {
+    if (book < 1 || book > BookResolver::BOOK_COUNT || chapter < 1 || chapter > CHAPTER_COUNTS[book - 1]) {
+        return 0;
+    }
+    return VERSE_COUNTS[CHAPTER_BEGIN[book - 1] + chapter - 1];
+}
+
+void VerseAlignment::addTranslation(const std::string& name, const VerseStore& store) {
+    std::vector<VerseId> column(rowCount(), INVALID_VERSE_ID);
+    std::vector<uint32_t> verse_rows(store.size(), NO_ROW);
+
+    for (size_t book_id = 0; book_id < store.books().size(); book_id++) {
+        int book = BookResolver::canonicalBook(store.books()[book_id]);
+        if (book == 0) continue; // apocrypha and unknown books have no rows
+        int id = static_cast<int>(book_id);
+        int last_chapter = store.lastChapter(id);
+
+        bool hebrew_malachi = book == MALACHI && last_chapter == 3;
+        bool hebrew_joel = book == JOEL && last_chapter == 4;
+        bool titled_psalms = false;
+        if (book == PSALMS) {
+            int titled = 0;
+            for (int chapter = 1; chapter <= last_chapter; chapter++) {
+                int extra = lastVerse(store, id, chapter) - verseCount(book, chapter);
+                titled += extra == 1 || extra == 2;
+            }
+            titled_psalms = titled >= MIN_TITLED_PSALMS;
+        }
+
+        VerseRange range = store.bookRange(id);
+        for (uint32_t pos = range.first; pos < range.last; pos++) {
+            VerseId verse_id = store.atPosition(pos);
+            int chapter = store.chapter(verse_id);
+            int verse = store.verseNumber(verse_id);
+
+            if (hebrew_malachi && chapter == 3 && verse > 18) {
+                chapter = 4;
+                verse -= 18;
+            } else if (hebrew_joel && chapter == 3) {
+                chapter = 2;
+                verse += 27;
+            } else if (hebrew_joel && chapter == 4) {
+                chapter = 3;
+            } else if (titled_psalms) {
+                // The title is verse 1 (or 1-2) and has no English verse of its own
+                int extra = lastVerse(store, id, chapter) - verseCount(book, chapter);
+                if (extra == 1 || extra == 2) verse -= extra;
+            }
+
+            uint32_t target = row(book, chapter, verse);
+            if (target != NO_ROW && column[target] == INVALID_VERSE_ID) {
+                column[target] = verse_id;
+                if (verse_id < verse_rows.size()) verse_rows[verse_id] = target;
+            }
+        }
+    }
+
+    columns[name] = std::move(column);
+    rows[name] = std::move(verse_rows);
+}
+
+void VerseAlignment::removeTranslation(const std::string& name) {
+    columns.erase(name);
+    rows.erase(name);
+}
+
+void VerseAlignment::clear() {
+    columns.clear();
+    rows.clear();
+}
+
+void VerseAlignment::gather(uint32_t target, std::span<const std::string> translations, std::span<VerseId> ids) const {
+    for (size_t i = 0; i < translations.size() && i < ids.size(); i++) {
+        ids[i] = find(translations[i], target);
+    }
+}
+
+VerseId VerseAlignment::find(const std::string& translation, uint32_t target) const {
+    auto it = columns.find(translation);
+    if (it == columns.end() || target >= it->second.size()) return INVALID_VERSE_ID;
+    return it->second[target];
+}
+
+std::span<const VerseId> VerseAlignment::column(const std::string& translation) const {
+    auto it = columns.find(translation);
+    if (it == columns.end()) return {};
+    return it->second;
+}
+
+uint32_t VerseAlignment::rowOf(const std::string& translation, VerseId id) const {
+    auto it = rows.find(translation);
+    if (it == rows.end() || id >= it->second.size()) return NO_ROW;
+    return it->second[id];
+}
+
+size_t VerseAlignment::getMemoryUsage() const {
+    size_t bytes = 0;
+    for (const auto& [name, column] : columns) {
+        bytes += name.capacity() + column.capacity() * sizeof(VerseId);
+    }
+    for (const auto& [name, verse_rows] : rows) {
+        bytes += name.capacity() + verse_rows.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
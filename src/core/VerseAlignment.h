@@ -0,0 +1,52 @@
+#ifndef VERSE_ALIGNMENT_H
+#define VERSE_ALIGNMENT_H
+
+#include "VerseStore.h"
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Lines the verses of every loaded translation up against one English
+// versification (VersificationTables.h): a row per verse of it, and a column
+// per translation holding that translation's verse for each row. Showing a
+// reference in several translations is then one row number and a gather.
+//
+// Columns are built once, as a translation is installed, and absorb the
+// common numbering differences:
+//   - psalm titles counted as verses (Hebrew numbering) shift the psalm down
+//   - Malachi 3:19-24 is 4:1-6 in Bibles with three chapters of Malachi
+//   - Joel 3:1-5 is 2:28-32, and Joel 4 is 3, in Bibles with four
+// Belongs to one Corpus version and, like the stores, never changes once published.
+class VerseAlignment {
+public:
+    static constexpr uint32_t NO_ROW = UINT32_MAX;
+
+    // Row of a canonical book (1-66) chapter and verse, NO_ROW if the
+    // English versification has no such verse
+    static uint32_t row(int book, int chapter, int verse);
+    static uint32_t rowCount();
+    // Verses in a chapter of the English versification, 0 if there is no such chapter
+    static int verseCount(int book, int chapter);
+
+    void addTranslation(const std::string& name, const VerseStore& store);
+    void removeTranslation(const std::string& name);
+    void clear();
+
+    // ids[i] is translations[i]'s verse at row, INVALID_VERSE_ID if it has none
+    void gather(uint32_t row, std::span<const std::string> translations, std::span<VerseId> ids) const;
+    VerseId find(const std::string& translation, uint32_t row) const;
+    // A translation's verse for every row, empty if it has no column
+    std::span<const VerseId> column(const std::string& translation) const;
+    // The row a translation's verse is aligned to, NO_ROW if none (apocrypha, extra verses)
+    uint32_t rowOf(const std::string& translation, VerseId id) const;
+
+    size_t getMemoryUsage() const;
+
+private:
+    std::unordered_map<std::string, std::vector<VerseId>> columns;
+    std::unordered_map<std::string, std::vector<uint32_t>> rows; // by verse id, the inverse of columns
+};
+
+#endif // VERSE_ALIGNMENT_H
@@ -1,371 +1,960 @@
 
 #include "VerseFinder.h"
+#include "TranslationSnapshot.h"
+#include "TranslationImporter.h"
+#include "TaskScheduler.h"
+#include "Bm25Ranker.h"
+#include "BooleanPlanner.h"
+#include "QueryArena.h"
+#include "QueryProfile.h"
+#include "RegexCache.h"
+#include "RegexPrefilter.h"
+#include "TextAnalyzer.h"
+#include "TextKernels.h"
 #include <fstream>
+#include <sstream>
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
+#include <cctype>
+#include <numeric>
 #include <thread>
 #include <filesystem>
 #include <set>
+#include <memory_resource>
+#include <utility>
+#include <tuple>
+#include <deque>
 #include <unordered_set>
 #include <future>
 #include <mutex>
 
-VerseFinder::VerseFinder() : benchmark(&g_benchmark) {
-    book_aliases = {
-        {"St. John", "John"},
-        {"Saint John", "John"},
-        {"1st John", "1 John"},
-    };
+namespace {
+
+// Relative to the other caches: a result is a few kilobytes that took a search to find
+constexpr double SEARCH_CACHE_WEIGHT = 4.0;
+
+// Most a verse gains, over its best score relative to the top hit of its
+// translation, for every other translation also matching it
+constexpr float AGREEMENT_BONUS = 0.25f;
+
+// How results name a translation: its abbreviation, else its name, in capitals
+std::string translationTag(const Corpus& corpus, const std::string& name) {
+    std::string tag = name;
+    for (const auto& info : corpus.translations) {
+        if (info.name == name && !info.abbreviation.empty()) tag = info.abbreviation;
+    }
+    std::transform(tag.begin(), tag.end(), tag.begin(), [](unsigned char c) { return std::toupper(c); });
+    return tag;
+}
+
+} // namespace
+
+VerseFinder::VerseFinder() : corpus(std::make_shared<Corpus>()), benchmark(&g_benchmark) {
+    search_cache_registration = CacheManager::shared().add(
+        {"search_results", SEARCH_CACHE_WEIGHT, [this]() { return search_cache.memoryUsage(); },
+         [this](size_t bytes) { search_cache.setMemoryBudget(bytes); }});
+}
+
+VerseFinder::~VerseFinder() {
+    waitForLoading(); // a loader on the pool still uses this
+    {
+        std::lock_guard<std::mutex> lock(watcher_mutex);
+        translations_watcher.stop(); // so does a reload under way
+    }
+    cancelWarmUp();
+    cancelSpeculation();
 }
 
 void VerseFinder::startLoading(const std::string& filename) {
-    loading_future = std::async(std::launch::async, &VerseFinder::loadBibleInternal, this, filename);
+    loading_future = TaskScheduler::shared().submit([this, filename]() { loadBibleInternal(filename); },
+                                                    TaskPriority::INTERACTIVE);
 }
 
 bool VerseFinder::isReady() const {
     return data_loaded;
 }
 
+void VerseFinder::waitForLoading() const {
+    if (loading_future.valid()) loading_future.wait();
+}
+
+VerseFinder::LoadProgress VerseFinder::getLoadProgress() const {
+    LoadProgress progress;
+    progress.total = load_files_total.load();
+    progress.done = std::min(load_files_done.load(), progress.total);
+    return progress;
+}
+
 void VerseFinder::loadBibleInternal(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open " << filename << std::endl;
+    LoadedTranslation loaded;
+    
+    // Stream verses straight into the store and index, no JSON DOM
+    TranslationImporter importer(loaded.info, loaded.store, loaded.index,
+                                 [this](const std::string& book) { return normalizeBookName(book); });
+    if (!importer.importFile(filename)) {
+        std::cerr << "Error: Could not load " << filename << ": " << importer.getLastError() << std::endl;
         return;
     }
+    loaded.similarity.build(loaded.store);
+    loaded.trigrams.build(loaded.store);
+    if (substring_search) loaded.substrings.build(loaded.store);
 
-    json j;
-    file >> j;
-
-    // Extract translation metadata
-    std::string trans_name = j["translation"];
-    std::string trans_abbr = j["abbreviation"];
-    std::string trans_desc = j.value("description", "");
-    int trans_year = j.value("year", 0);
-    std::string trans_lang = j.value("language", "");
-    
-    TranslationInfo trans_info(trans_name, trans_abbr, trans_desc, trans_year, trans_lang, filename);
-    trans_info.is_loaded = true;
-    available_translations.push_back(trans_info);
-
-    for (const auto& book_json : j["books"]) {
-        std::string book_name = book_json["name"];
-        for (const auto& chapter_json : book_json["chapters"]) {
-            int chapter_num = chapter_json["chapter"];
-            for (const auto& verse_json : chapter_json["verses"]) {
-                Verse v{
-                    book_name,
-                    chapter_num,
-                    verse_json["verse"],
-                    verse_json["text"]
-                };
-                std::string key = makeKey(v.book, v.chapter, v.verse);
-                verses[trans_name][key] = v;
-                // Use optimized tokenization
-                for (const auto& token : SearchOptimizer::optimizedTokenize(v.text)) {
-                    keyword_index[trans_name][token].push_back(key);
-                }
-            }
-        }
+    std::shared_ptr<const Corpus> loaded_corpus;
+    {
+        std::lock_guard<std::mutex> lock(residency_mutex);
+        std::shared_ptr<Corpus> next = editCorpus();
+        installTranslation(*next, std::move(loaded), false);
+        publish(next);
+        loaded_corpus = std::move(next);
     }
     
     // Build auto-complete index after loading data
-    auto_complete.buildIndex(verses);
+    auto_complete.buildIndex(loaded_corpus->verses, autoCompleteQueryLog());
     
     // Build topic index after loading data
     if (topic_analysis_enabled) {
-        topic_manager.buildTopicIndex(verses);
+        indexTopics(*loaded_corpus);
     }
     
     data_loaded = true;
-    std::cout << "Loaded " << available_translations.size() << " translations." << std::endl;
+    std::cout << "Loaded " << loaded_corpus->translations.size() << " translations." << std::endl;
+}
+
+namespace {
+// Fuzzy search takes trigram candidates for phrases, and for words whose
+// nearby vocabulary found fewer verses than the minimum
+constexpr size_t TRIGRAM_CANDIDATES = 200;
+constexpr size_t MIN_FUZZY_CANDIDATES = 50;
+// Verses per shard of a regex search; matching one costs microseconds
+constexpr size_t REGEX_SHARD_VERSES = 512;
+
+// The texts of a passage's verses, separated by spaces
+std::string joinPassage(const VerseStore& store, const std::vector<VerseRange>& ranges) {
+    std::string passage;
+    for (VerseRange range : ranges) {
+        for (uint32_t pos = range.first; pos < range.last; ++pos) {
+            if (!passage.empty()) passage += ' ';
+            passage += store.text(store.atPosition(pos));
+        }
+    }
+    return passage.empty() ? "Verse not found." : passage;
+}
+
+// token's postings with its inflections folded in ("loved", "loveth" for "love");
+// a merged term is kept in storage, which must outlive the result
+const TermPostings* stemPostings(const InvertedIndex& index, const std::string& token,
+                                 std::deque<TermPostings>& storage) {
+    std::vector<const TermPostings*> variants = index.findVariants(token);
+    if (variants.size() <= 1) return variants.empty() ? nullptr : variants[0];
+    storage.push_back(index.mergeTerms(variants));
+    return &storage.back();
+}
+
+// Append where terms' occurrences in verse id lie in its text, in text order.
+// The index's word positions are the store's words, so no text is read.
+void appendMatchSpans(const VerseStore& store, VerseId id, const std::vector<Bm25Ranker::QueryTerm>& terms,
+                      std::vector<MatchSpan>& spans) {
+    const size_t first = spans.size();
+    const size_t words = store.terms(id).size();
+    for (const auto& term : terms) {
+        const PostingList& ids = term.postings->ids;
+        auto it = std::lower_bound(ids.begin(), ids.end(), id);
+        if (it == ids.end() || *it != id) continue;
+        size_t i = static_cast<size_t>(it - ids.begin());
+        for (uint32_t p = term.postings->position_offsets[i]; p < term.postings->position_offsets[i + 1]; ++p) {
+            uint16_t word = term.postings->positions[p];
+            if (word >= words) continue;
+            auto [begin, end] = store.wordSpan(id, word);
+            spans.push_back({static_cast<uint32_t>(begin), static_cast<uint32_t>(end)});
+        }
+    }
+    std::sort(spans.begin() + first, spans.end(), [](const MatchSpan& a, const MatchSpan& b) {
+        return a.begin < b.begin;
+    });
+    spans.erase(std::unique(spans.begin() + first, spans.end(), [](const MatchSpan& a, const MatchSpan& b) {
+        return a.begin == b.begin;
+    }), spans.end());
 }
 
-std::string VerseFinder::normalizeBookName(const std::string& book) const {
-    // First try exact match
-    auto it = book_aliases.find(book);
-    if (it != book_aliases.end()) {
-        return it->second;
-    }
-    
-    // Try case-insensitive match for book aliases
-    std::string lower_book = book;
-    std::transform(lower_book.begin(), lower_book.end(), lower_book.begin(),
-                   [](unsigned char c){ return std::tolower(c); });
+// The tokens that narrow a keyword query: stop words only count when there is nothing else
+std::vector<std::string> contentTokens(const std::vector<std::string>& tokens) {
+    std::vector<std::string> content;
+    std::copy_if(tokens.begin(), tokens.end(), std::back_inserter(content),
+                 [](const std::string& token) { return !TextAnalyzer::isStopWord(token); });
+    return content.empty() ? tokens : content;
+}
+}
+
+std::string VerseFinder::normalizeBookName(std::string_view book) const {
+    return book_resolver.resolve(book);
+}
+
+void VerseFinder::setBookAliases(const std::unordered_map<std::string, std::string>& aliases) {
+    book_resolver.setAliases(aliases);
+}
+
+std::vector<std::string> VerseFinder::tokenize(const std::string& text) {
+    return SearchOptimizer::optimizedTokenize(text);
+}
+
+std::string VerseFinder::searchByReference(const std::string& reference, const std::string& translation) const {
+    if (!isReady()) return "Bible is loading...";
     
-    for (const auto& alias_pair : book_aliases) {
-        std::string lower_alias = alias_pair.first;
-        std::transform(lower_alias.begin(), lower_alias.end(), lower_alias.begin(),
-                       [](unsigned char c){ return std::tolower(c); });
-        if (lower_alias == lower_book) {
-            return alias_pair.second;
+    BENCHMARK_SCOPE("reference_search");
+    QueryProfile::step("reference");
+    
+    ParsedReference parsed;
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto it = current->verses.find(translation);
+    if (it == current->verses.end() || !ReferenceParser::parse(reference, parsed) || !parsed.hasChapter() ||
+        parsed.first().wholeChapters()) {
+        // Several books ("Ps 23:1; John 10:11") are read as a list
+        std::vector<ParsedReference> list;
+        if (it == current->verses.end() || !ReferenceParser::parseList(reference, list) || list.size() < 2 ||
+            !list[0].hasChapter() || list[0].first().wholeChapters()) {
+            return "Verse not found.";
         }
+        return joinPassage(*it->second, findRanges(*it->second, list));
     }
     
-    // If no alias match, try case-insensitive match against actual book names in loaded data
-    if (!verses.empty()) {
-        const auto& first_translation = verses.begin()->second;
-        
-        // Collect unique book names from the loaded data
-        std::set<std::string> book_names;
-        for (const auto& verse_pair : first_translation) {
-            const Verse& v = verse_pair.second;
-            book_names.insert(v.book);
-        }
-        
-        // Try case-insensitive match against actual book names
-        for (const std::string& actual_book : book_names) {
-            std::string lower_actual = actual_book;
-            std::transform(lower_actual.begin(), lower_actual.end(), lower_actual.begin(),
-                           [](unsigned char c){ return std::tolower(c); });
-            if (lower_actual == lower_book) {
-                return actual_book; // Return the correctly cased book name
-            }
-        }
+    const VerseStore& store = *it->second;
+    if (parsed.isSingleVerse()) {
+        VerseId id = store.find(findBook(store, parsed), parsed.first().chapter, parsed.first().verse);
+        return id != INVALID_VERSE_ID ? std::string(store.text(id)) : "Verse not found.";
     }
     
-    // If no match found, return the original book name
-    return book;
+    std::vector<VerseRange> ranges;
+    appendSpanRanges(store, parsed, ranges);
+    return joinPassage(store, ranges);
 }
 
-std::string VerseFinder::normalizeReference(const std::string& reference) const {
-    // Parse the reference to extract book, chapter, and verse
-    size_t space_pos = reference.find_last_of(' ');
-    if (space_pos == std::string::npos) return reference;
-    
-    std::string book_part = reference.substr(0, space_pos);
-    std::string chapter_verse = reference.substr(space_pos + 1);
-    
-    size_t colon_pos = chapter_verse.find(':');
-    if (colon_pos == std::string::npos) return reference;
+VerseView VerseFinder::findVerse(std::string_view reference, const std::string& translation) const {
+    if (!isReady()) return {};
     
-    try {
-        int chapter = std::stoi(chapter_verse.substr(0, colon_pos));
-        int verse = std::stoi(chapter_verse.substr(colon_pos + 1));
-        
-        // Normalize the book name and reconstruct the reference
-        std::string normalized_book = normalizeBookName(book_part);
-        return normalized_book + " " + std::to_string(chapter) + ":" + std::to_string(verse);
-    } catch (const std::exception&) {
-        // If parsing fails, return the original reference
-        return reference;
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto it = current->verses.find(translation);
+    ParsedReference parsed;
+    if (it == current->verses.end() || !ReferenceParser::parse(reference, parsed) || !parsed.hasChapter() ||
+        parsed.first().wholeChapters()) {
+        return {};
     }
+    
+    // The first verse of a range or list
+    const VerseStore& store = *it->second;
+    return store.view(store.find(findBook(store, parsed), parsed.first().chapter, parsed.first().verse));
 }
 
-std::string VerseFinder::makeKey(const std::string& book, int chapter, int verse) const {
-    return normalizeBookName(book) + " " + std::to_string(chapter) + ":" + std::to_string(verse);
+int VerseFinder::findBook(const VerseStore& store, const ParsedReference& reference) const {
+    // Canonical names fit std::string's inline buffer, so the common case allocates nothing
+    if (reference.canonical_book != 0) {
+        return store.findBook(std::string(BookResolver::canonicalName(reference.canonical_book)));
+    }
+    return store.findBook(normalizeBookName(reference.book));
 }
 
-std::vector<std::string> VerseFinder::tokenize(const std::string& text) {
-    std::vector<std::string> tokens;
-    std::string token;
-    for (char c : text) {
-        if (std::isalnum(c)) {
-            token += std::tolower(c);
-        } else if (!token.empty()) {
-            tokens.push_back(token);
-            token.clear();
+void VerseFinder::appendSpanRanges(const VerseStore& store, const ParsedReference& reference,
+                                   std::vector<VerseRange>& ranges) const {
+    int book_id = findBook(store, reference);
+    if (book_id < 0) return;
+    for (size_t i = 0; i < reference.span_count; ++i) {
+        const ReferenceSpan& span = reference.spans[i];
+        VerseRange range = store.spanRange(book_id, span.chapter, span.verse, span.end_chapter, span.end_verse);
+        if (!range.empty()) {
+            ranges.push_back(range);
         }
     }
-    if (!token.empty()) tokens.push_back(token);
-    return tokens;
 }
 
-std::string VerseFinder::searchByReference(const std::string& reference, const std::string& translation) const {
-    if (!isReady()) return "Bible is loading...";
+std::vector<VerseRange> VerseFinder::findRanges(const VerseStore& store,
+                                                const std::vector<ParsedReference>& references) const {
+    std::vector<VerseRange> ranges;
+    for (const auto& reference : references) {
+        appendSpanRanges(store, reference, ranges);
+    }
+    return ranges;
+}
+
+std::vector<VerseView> VerseFinder::findAlignedVerses(std::string_view reference,
+                                                     const std::vector<std::string>& translations) const {
+    std::vector<VerseView> views(translations.size());
+    ParsedReference parsed;
+    if (!isReady() || !ReferenceParser::parse(reference, parsed) || !parsed.hasChapter() ||
+        parsed.first().wholeChapters()) {
+        return views;
+    }
     
-    BENCHMARK_SCOPE("reference_search");
+    std::shared_ptr<const Corpus> current = snapshot();
+    int chapter = parsed.first().chapter;
+    int verse = parsed.first().verse;
+    uint32_t row = VerseAlignment::row(parsed.canonical_book, chapter, verse);
+    std::vector<VerseId> ids(translations.size(), INVALID_VERSE_ID);
+    if (row != VerseAlignment::NO_ROW) {
+        current->alignment.gather(row, translations, ids);
+    }
     
-    // Normalize the reference for case-insensitive lookup
-    std::string normalized_ref = normalizeReference(reference);
+    for (size_t i = 0; i < translations.size(); ++i) {
+        auto it = current->verses.find(translations[i]);
+        if (it == current->verses.end()) continue;
+        const VerseStore& store = *it->second;
+        if (ids[i] == INVALID_VERSE_ID) {
+            // Outside the English versification (3 John 1:15, apocrypha): the
+            // translation's own numbering, else the verse a split ends in
+            ids[i] = store.find(findBook(store, parsed), chapter, verse);
+            if (ids[i] == INVALID_VERSE_ID && row == VerseAlignment::NO_ROW &&
+                verse == VerseAlignment::verseCount(parsed.canonical_book, chapter) + 1) {
+                ids[i] = current->alignment.find(translations[i], VerseAlignment::row(parsed.canonical_book, chapter, verse - 1));
+            }
+        }
+        views[i] = store.view(ids[i]);
+    }
+    return views;
+}
+
+std::vector<VerseView> VerseFinder::viewVerses(std::span<const VerseId> ids, const std::string& translation) const {
+    std::vector<VerseView> views;
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto it = current->verses.find(translation);
+    if (!isReady() || it == current->verses.end()) return views;
     
-    auto it = verses.find(translation);
-    if (it != verses.end()) {
-        const auto& inner = it->second;
-        if (const auto verse_it = inner.find(normalized_ref); verse_it != inner.end()) {
-            return verse_it->second.text;
+    views.reserve(ids.size());
+    for (VerseId id : ids) {
+        if (VerseView view = it->second->view(id)) {
+            views.push_back(view);
         }
     }
-    return "Verse not found.";
+    return views;
 }
 
-std::vector<std::string> VerseFinder::searchByKeywords(const std::string& query, const std::string& translation) const {
-    if (!isReady()) return {"Bible is loading..."};
+std::vector<std::string> VerseFinder::searchByKeywords(const std::string& query, const std::string& translation,
+                                                       const SearchContext& context) const {
+    return renderResults(searchKeywordIds(query, translation, context), translation);
+}
+
+CachedSearchResult VerseFinder::searchKeywordIds(const std::string& query, const std::string& translation,
+                                                 const SearchContext& context) const {
+    CachedSearchResult result;
+    if (!isReady()) {
+        result.message = "Bible is loading...";
+        return result;
+    }
+    
+    // A scoped query is searched within its scope's verses and not cached,
+    // since the scope can change while its translation does not
+    std::string_view terms;
+    std::string scope_name;
+    QueryLexer::Scope scope = QueryLexer::splitScope(query, terms, scope_name);
+    if (scope != QueryLexer::Scope::NONE) {
+        std::shared_ptr<const VerseSet> members = scopeVerses(scope, scope_name, translation);
+        if (!members) {
+            result.message = "No collection or topic named \"" + scope_name + "\".";
+            return result;
+        }
+        result = terms.empty() ? CachedSearchResult{members->ids()}
+                               : findKeywordMatches(std::string(terms), translation, members.get());
+        if (result.ids.empty() && result.message.empty()) result.message = "No matching verses found.";
+        applyResultLimit(result, context);
+        return result;
+    }
     
     // Check cache first
-    std::vector<std::string> cached_results;
-    if (search_cache.get(query, translation, cached_results)) {
-        return cached_results;
+    bool cached = search_cache.get(query, translation, result);
+    QueryProfile::cacheLookup(cached);
+    if (cached) {
+        applyResultLimit(result, context);
+        return result;
     }
     
-    // Use full text search instead of keyword intersection for better results
-    std::vector<std::string> results = searchByFullText(query, translation);
+    if (query.empty()) {
+        result.message = "No search query provided.";
+        return result;
+    }
     
-    // Cache the results
-    search_cache.put(query, translation, results);
+    // Read the generation before searching so a concurrent reload can't be cached as fresh
+    uint64_t generation = search_cache.generation(translation);
+    result = findKeywordMatches(query, translation);
     
-    return results;
+    // Cache the ids, not the rendered text, and the full list so any later limit can be served
+    search_cache.put(query, translation, generation, result);
+    
+    applyResultLimit(result, context);
+    return result;
 }
 
-std::vector<std::string> VerseFinder::searchByKeywordsOptimized(const std::string& query, const std::string& translation) const {
+size_t VerseFinder::streamKeywordMatches(const std::string& query, const std::string& translation,
+                                         const MatchCallback& on_match, const SearchContext& context) const {
+    if (!isReady()) return 0;
+    
+    BENCHMARK_SCOPE("keyword_stream");
+    
+    // A single word needs no intersection or phrase pass: rank just the page's
+    // worth of its postings, skipping blocks that cannot get into it
+    CachedSearchResult result;
+    auto tokens = SearchOptimizer::optimizedTokenize(query);
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->keyword_index.find(translation);
+    auto store_it = current->verses.find(translation);
+    if (tokens.size() == 1 && trans_it != current->keyword_index.end() && store_it != current->verses.end() &&
+        context.resultEnd() != SearchContext::UNLIMITED) {
+        std::deque<TermPostings> merged;
+        const TermPostings* postings = stemPostings(*trans_it->second, tokens[0], merged);
+        QueryProfile::step("index_top_k");
+        QueryProfile::count("postings", postings ? postings->ids.size() : 0);
+        if (!postings) return 0;
+        result.span_offsets.push_back(0);
+        for (const auto& match : Bm25Ranker(*trans_it->second).topK({{postings}}, context.resultEnd(), context)) {
+            result.ids.push_back(match.first);
+            result.scores.push_back(match.second);
+            appendMatchSpans(*store_it->second, match.first, {{postings}}, result.spans);
+            result.span_offsets.push_back(static_cast<uint32_t>(result.spans.size()));
+        }
+    } else {
+        result = searchKeywordIds(query, translation);
+    }
+    
+    size_t visited = 0;
+    for (size_t i = context.offset(); i < result.ids.size() && !context.limitReached(i); ++i) {
+        if (context.shouldStopAt(visited)) break;
+        ++visited;
+        float score = i < result.scores.size() ? result.scores[i] : 1.0f;
+        if (!on_match(result.ids[i], score, result.spansOf(i))) break;
+    }
+    return visited;
+}
+
+std::vector<std::string> VerseFinder::searchByKeywordsOptimized(const std::string& query, const std::string& translation,
+                                                                const SearchContext& context) const {
+    CachedSearchResult result = findKeywordMatches(query, translation);
+    applyResultLimit(result, context);
+    return renderResults(result, translation);
+}
+
+void VerseFinder::applyResultLimit(CachedSearchResult& result, const SearchContext& context) {
+    // Keep one page: cap at offset + limit, then drop the first offset matches
+    size_t end = std::min(context.resultEnd(), result.ids.size());
+    size_t begin = std::min(context.offset(), end);
+    result.ids.resize(end);
+    result.ids.erase(result.ids.begin(), result.ids.begin() + begin);
+    if (!result.scores.empty()) {
+        result.scores.resize(end);
+        result.scores.erase(result.scores.begin(), result.scores.begin() + begin);
+    }
+    if (!result.span_offsets.empty()) {
+        uint32_t first_span = result.span_offsets[begin];
+        result.spans.resize(result.span_offsets[end]);
+        result.spans.erase(result.spans.begin(), result.spans.begin() + first_span);
+        result.span_offsets.resize(end + 1);
+        result.span_offsets.erase(result.span_offsets.begin(), result.span_offsets.begin() + begin);
+        for (uint32_t& offset : result.span_offsets) offset -= first_span;
+    }
+}
+
+CachedSearchResult VerseFinder::findKeywordMatches(const std::string& query, const std::string& translation,
+                                                   const VerseSet* within) const {
     BENCHMARK_SCOPE("keyword_search");
+    QueryArena::Scope arena;
     
+    CachedSearchResult result;
     auto tokens = SearchOptimizer::optimizedTokenize(query);
-    if (tokens.empty()) return {"No keywords provided."};
+    if (tokens.empty()) {
+        result.message = "No keywords provided.";
+        return result;
+    }
 
-    auto trans_it = keyword_index.find(translation);
-    if (trans_it == keyword_index.end()) {
-        return {"Translation not found."};
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->keyword_index.find(translation);
+    auto store_it = current->verses.find(translation);
+    if (trans_it == current->keyword_index.end() || store_it == current->verses.end()) {
+        result.message = "Translation not found.";
+        return result;
     }
-    const auto& index = trans_it->second;
+    const InvertedIndex& index = *trans_it->second;
 
-    // Collect token lists for intersection
-    std::vector<std::vector<std::string>> token_lists;
-    token_lists.reserve(tokens.size());
+    // Collect posting lists for intersection; each word matches any of its
+    // inflections, and stop words are left to the phrase pass
+    std::vector<std::string> content = contentTokens(tokens);
+    std::vector<const PostingList*> token_lists;
+    std::vector<Bm25Ranker::QueryTerm> terms;
+    std::deque<TermPostings> merged;
+    token_lists.reserve(content.size());
+    terms.reserve(content.size());
     
-    for (const auto& token : tokens) {
-        auto token_it = index.find(token);
-        if (token_it == index.end()) {
-            return {"No matching verses found."};
+    {
+        TRACE_SCOPE("index_lookup");
+        for (const auto& token : content) {
+            const TermPostings* postings = stemPostings(index, token, merged);
+            if (!postings) {
+                result.message = "No matching verses found.";
+                return result;
+            }
+            token_lists.push_back(&postings->ids);
+            terms.push_back({postings});
         }
-        token_lists.push_back(token_it->second);
     }
 
-    // Use optimized intersection algorithm
-    std::vector<std::string> common_refs = SearchOptimizer::optimizedIntersection(token_lists);
+    // Intersect sorted verse ids; only matching verses are ever touched
+    QueryProfile::step("index");
+    PostingList common_ids = SearchOptimizer::intersectPostings(std::move(token_lists), within);
+    QueryProfile::count("index_candidates", common_ids.size());
 
-    if (common_refs.empty()) {
-        return {"No matching verses found."};
+    if (common_ids.empty()) {
+        result.message = "No matching verses found.";
+        return result;
     }
 
-    // Verify phrase matches using optimized verification
-    std::vector<std::string> results;
-    results.reserve(common_refs.size());
+    // Exact phrase matches first, then verses containing all words, each by BM25
+    std::pmr::vector<char> is_phrase(common_ids.size(), 0, arena.resource());
+    if (tokens.size() > 1) {
+        PostingList phrase_ids = index.filterPhrase(common_ids, tokens);
+        QueryProfile::count("phrase_matches", phrase_ids.size());
+        auto phrase_it = phrase_ids.begin();
+        for (size_t i = 0; i < common_ids.size() && phrase_it != phrase_ids.end(); ++i) {
+            if (common_ids[i] == *phrase_it) {
+                is_phrase[i] = 1;
+                ++phrase_it;
+            }
+        }
+    }
+    std::vector<float> scores = Bm25Ranker(index).score(terms, common_ids);
+    
+    std::pmr::vector<uint32_t> order(common_ids.size(), arena.resource());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        if (is_phrase[a] != is_phrase[b]) return is_phrase[a] > is_phrase[b];
+        if (scores[a] != scores[b]) return scores[a] > scores[b];
+        return a < b;
+    });
+    result.ids.reserve(order.size());
+    result.scores.reserve(order.size());
+    result.span_offsets.reserve(order.size() + 1);
+    result.span_offsets.push_back(0);
+    for (uint32_t i : order) {
+        result.ids.push_back(common_ids[i]);
+        result.scores.push_back(scores[i]);
+        // Highlights come from the same postings, so the UI never searches the text again
+        appendMatchSpans(*store_it->second, common_ids[i], terms, result.spans);
+        result.span_offsets.push_back(static_cast<uint32_t>(result.spans.size()));
+    }
+    return result;
+}
 
-    for (const auto& ref : common_refs) {
-        const auto& verse_text = verses.at(translation).at(ref).text;
-        
-        if (SearchOptimizer::verifyPhraseMatch(verse_text, query)) {
-            results.push_back(ref + ": " + verse_text);
+CachedSearchResult VerseFinder::searchKeywordPrefixIds(const std::string& query, const std::string& translation,
+                                                       const std::vector<VerseId>* within,
+                                                       const SearchContext& context) const {
+    BENCHMARK_SCOPE("prefix_keyword_search");
+    
+    CachedSearchResult result;
+    if (!isReady()) {
+        result.message = "Bible is loading...";
+        return result;
+    }
+    
+    auto tokens = SearchOptimizer::optimizedTokenize(query);
+    if (tokens.empty()) {
+        result.message = "No keywords provided.";
+        return result;
+    }
+    
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->keyword_index.find(translation);
+    if (trans_it == current->keyword_index.end()) {
+        result.message = "Translation not found.";
+        return result;
+    }
+    const InvertedIndex& index = *trans_it->second;
+    
+    // A query still being typed ends in a partial word; a trailing non-ASCII
+    // byte is taken to be the end of a letter
+    unsigned char last_byte = static_cast<unsigned char>(query.back());
+    bool partial_last = TextKernels::isWordChar(last_byte) || last_byte >= 0x80;
+    PostingList partial_ids;
+    
+    // Finished words match their inflections; stop words narrow nothing unless
+    // they are all there is
+    bool has_content = partial_last || std::any_of(tokens.begin(), tokens.end(), [](const std::string& token) {
+        return !TextAnalyzer::isStopWord(token);
+    });
+    std::deque<TermPostings> merged;
+    std::vector<const PostingList*> token_lists;
+    token_lists.reserve(tokens.size() + 1);
+    if (within) {
+        token_lists.push_back(within);
+    }
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        const PostingList* postings = nullptr;
+        if (partial_last && i + 1 == tokens.size()) {
+            partial_ids = index.findPrefix(tokens[i], within);
+            postings = partial_ids.empty() ? nullptr : &partial_ids;
+        } else if (has_content && TextAnalyzer::isStopWord(tokens[i])) {
+            continue;
+        } else {
+            const TermPostings* term = stemPostings(index, tokens[i], merged);
+            postings = term ? &term->ids : nullptr;
+        }
+        if (!postings) {
+            result.message = "No matching verses found.";
+            return result;
         }
+        token_lists.push_back(postings);
     }
     
-    return results.empty() ? std::vector<std::string>{"No matching verses found."} : results;
+    result.ids = SearchOptimizer::intersectPostings(std::move(token_lists));
+    if (result.ids.empty()) {
+        result.message = "No matching verses found.";
+    }
+    applyResultLimit(result, context);
+    return result;
+}
+
+uint64_t VerseFinder::getTranslationGeneration(const std::string& translation) const {
+    return search_cache.generation(translation);
 }
 
-std::vector<std::string> VerseFinder::searchByFullText(const std::string& query, const std::string& translation) const {
+std::vector<std::string> VerseFinder::renderResults(const CachedSearchResult& result, const std::string& translation) const {
+    TRACE_SCOPE("format_results");
+    if (result.ids.empty()) {
+        return {result.message.empty() ? "No matching verses found." : result.message};
+    }
+    
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->verses.find(translation);
+    if (trans_it == current->verses.end()) {
+        return {"Translation not found."};
+    }
+    const VerseStore& store = *trans_it->second;
+    
+    std::vector<std::string> results;
+    results.reserve(result.ids.size());
+    for (VerseId id : result.ids) {
+        if (id < store.size()) {
+            results.push_back(store.formatResult(id));
+        }
+    }
+    return results;
+}
+
+std::vector<std::string> VerseFinder::searchByFullText(const std::string& query, const std::string& translation,
+                                                       const SearchContext& context) const {
     if (!isReady()) return {"Bible is loading..."};
     
     BENCHMARK_SCOPE("full_text_search");
     
     if (query.empty()) return {"No search query provided."};
     
-    // Convert query to lowercase for case-insensitive search
-    std::string lower_query = query;
-    std::transform(lower_query.begin(), lower_query.end(), lower_query.begin(),
-                   [](unsigned char c){ return std::tolower(c); });
-    
-    auto trans_it = verses.find(translation);
-    if (trans_it == verses.end()) {
+    if (!snapshot()->verses.count(translation)) {
         return {"Translation not found."};
     }
     
-    std::vector<std::string> results;
-    const auto& translation_verses = trans_it->second;
+    // Quotes ask for the text between them literally
+    std::string_view fragment = query;
+    bool quoted = fragment.size() >= 2 && fragment.front() == '"' && fragment.back() == '"';
+    if (quoted) fragment = fragment.substr(1, fragment.size() - 2);
+    if (fragment.find_first_not_of(' ') == std::string_view::npos) return {"No search query provided."};
+    bool punctuated = std::any_of(fragment.begin(), fragment.end(), [](char c) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        return byte < 0x80 && byte != ' ' && !TextKernels::isWordChar(byte);
+    });
     
-    // Search through all verses in the translation
-    for (const auto& verse_pair : translation_verses) {
-        const std::string& verse_key = verse_pair.first;
-        const Verse& verse = verse_pair.second;
-        
-        // Convert verse text to lowercase for comparison
-        std::string lower_verse_text = verse.text;
-        std::transform(lower_verse_text.begin(), lower_verse_text.end(), lower_verse_text.begin(),
-                       [](unsigned char c){ return std::tolower(c); });
-        
-        // Check if the query appears as a substring in the verse
-        if (lower_verse_text.find(lower_query) != std::string::npos) {
-            results.push_back(verse_key + ": " + verse.text);
+    // Words are answered from the positional index; verse text was tokenized
+    // and lowercased once at load time
+    CachedSearchResult result;
+    if (!quoted && !punctuated) {
+        result = findKeywordMatches(query, translation);
+    }
+    // Fragments, and words that may be parts of longer ones
+    if (result.ids.empty()) {
+        result = findSubstringMatches(fragment, translation);
+    }
+    applyResultLimit(result, context);
+    return renderResults(result, translation);
+}
+
+CachedSearchResult VerseFinder::findSubstringMatches(std::string_view fragment, const std::string& translation) const {
+    BENCHMARK_SCOPE("substring_search");
+    
+    CachedSearchResult result;
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto substrings_it = current->substring_indexes.find(translation);
+    if (substrings_it != current->substring_indexes.end()) {
+        QueryProfile::step("substring_index");
+        result.ids = substrings_it->second->find(fragment);
+    } else {
+        // Without one, only the verses holding the fragment's words are read
+        auto trans_it = current->verses.find(translation);
+        auto index_it = current->keyword_index.find(translation);
+        if (trans_it == current->verses.end() || index_it == current->keyword_index.end()) {
+            result.message = "Translation not found.";
+            return result;
         }
-        // If not exact substring match, check if all query words appear in the verse
-        else {
-            auto query_words = tokenize(lower_query);
-            bool all_words_found = true;
-            
-            for (const auto& word : query_words) {
-                if (lower_verse_text.find(word) == std::string::npos) {
-                    all_words_found = false;
-                    break;
-                }
+        QueryProfile::step("substring_scan");
+        result.ids = index_it->second->findSubstring(fragment, *trans_it->second);
+    }
+    QueryProfile::count("substring_matches", result.ids.size());
+    if (result.ids.empty()) {
+        result.message = "No matching verses found.";
+    }
+    return result;
+}
+
+std::vector<std::string> VerseFinder::searchRegex(const std::string& pattern, const std::string& translation,
+                                                  const SearchContext& context) const {
+    if (!isReady()) return {"Bible is loading..."};
+    if (pattern.empty()) return {"No search query provided."};
+    return renderResults(searchRegexIds(pattern, translation, context), translation);
+}
+
+CachedSearchResult VerseFinder::searchRegexIds(const std::string& pattern, const std::string& translation,
+                                               const SearchContext& context, bool case_sensitive) const {
+    BENCHMARK_SCOPE("regex_search");
+    
+    CachedSearchResult result;
+    RegexCache::Compiled compiled = RegexCache::shared().get(pattern, case_sensitive);
+    if (!compiled.regex) {
+        result.message = "Invalid regular expression: " + compiled.error;
+        return result;
+    }
+    const std::regex& regex = *compiled.regex;
+    
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->verses.find(translation);
+    auto index_it = current->keyword_index.find(translation);
+    if (trans_it == current->verses.end() || index_it == current->keyword_index.end()) {
+        result.message = "Translation not found.";
+        return result;
+    }
+    const VerseStore& store = *trans_it->second;
+    const InvertedIndex& index = *index_it->second;
+    auto substrings_it = current->substring_indexes.find(translation);
+    const SubstringIndex* substrings =
+        substrings_it != current->substring_indexes.end() ? substrings_it->second.get() : nullptr;
+    
+    // Only verses holding the literals every match needs are read
+    std::vector<VerseId> candidates;
+    bool filtered = RegexPrefilter::candidates(
+        RegexPrefilter::requiredLiterals(pattern),
+        [&](std::string_view fragment) { return substrings ? substrings->find(fragment) : index.findContaining(fragment); },
+        candidates);
+    const size_t count = filtered ? candidates.size() : store.size();
+    QueryProfile::step(filtered ? "regex_prefilter" : "regex_scan");
+    QueryProfile::count("regex_candidates", count);
+    
+    // Shards are matched in parallel, each in id order and stopping once it alone fills the page
+    struct Shard {
+        std::vector<VerseId> ids;
+        std::vector<uint32_t> span_ends;
+        std::vector<MatchSpan> spans;
+    };
+    const size_t wanted = context.resultEnd();
+    std::vector<Shard> shards(TaskScheduler::shared().shardCount(count, REGEX_SHARD_VERSES));
+    TaskScheduler::shared().parallelFor(shards.size(), [&](size_t s) {
+        Shard& shard = shards[s];
+        size_t begin = count * s / shards.size();
+        size_t end = count * (s + 1) / shards.size();
+        for (size_t i = begin; i < end && shard.ids.size() < wanted; ++i) {
+            if (context.shouldStopAt(i - begin)) break;
+            VerseId id = filtered ? candidates[i] : static_cast<VerseId>(i);
+            std::string_view text = store.text(id);
+            std::cregex_iterator match(text.data(), text.data() + text.size(), regex);
+            if (match == std::cregex_iterator()) continue;
+            shard.ids.push_back(id);
+            for (; match != std::cregex_iterator(); ++match) {
+                if (match->length(0) == 0) continue;
+                uint32_t position = static_cast<uint32_t>(match->position(0));
+                shard.spans.push_back({position, position + static_cast<uint32_t>(match->length(0))});
             }
-            
-            if (all_words_found && !query_words.empty()) {
-                results.push_back(verse_key + ": " + verse.text);
+            shard.span_ends.push_back(static_cast<uint32_t>(shard.spans.size()));
+        }
+    });
+    
+    result.span_offsets.push_back(0);
+    for (const Shard& shard : shards) {
+        uint32_t base = static_cast<uint32_t>(result.spans.size());
+        result.ids.insert(result.ids.end(), shard.ids.begin(), shard.ids.end());
+        for (uint32_t span_end : shard.span_ends) result.span_offsets.push_back(base + span_end);
+        result.spans.insert(result.spans.end(), shard.spans.begin(), shard.spans.end());
+    }
+    QueryProfile::count("regex_matches", result.ids.size());
+    if (result.ids.empty()) {
+        result.span_offsets.clear();
+        result.message = "No matching verses found.";
+    }
+    applyResultLimit(result, context);
+    return result;
+}
+
+std::vector<std::string> VerseFinder::searchLanguage(const std::string& query, const std::string& language,
+                                                    const SearchContext& context) const {
+    if (!isReady()) return {"Bible is loading..."};
+    BENCHMARK_SCOPE("language_search");
+    
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto index_it = current->language_indexes.find(language);
+    if (index_it == current->language_indexes.end()) {
+        for (const auto& info : current->translations) {
+            if (info.language == language && current->verses.count(info.name)) {
+                return searchByKeywords(query, info.name, context);
             }
         }
+        return {"No translations loaded for language '" + language + "'."};
     }
+    const LanguageIndex& index = *index_it->second;
     
-    // Sort results by relevance (exact phrase matches first, then word matches)
-    std::sort(results.begin(), results.end(), [&](const std::string& a, const std::string& b) {
-        std::string text_a = a.substr(a.find(": ") + 2);
-        std::string text_b = b.substr(b.find(": ") + 2);
-        
-        std::transform(text_a.begin(), text_a.end(), text_a.begin(),
-                       [](unsigned char c){ return std::tolower(c); });
-        std::transform(text_b.begin(), text_b.end(), text_b.begin(),
-                       [](unsigned char c){ return std::tolower(c); });
-        
-        bool a_exact = text_a.find(lower_query) != std::string::npos;
-        bool b_exact = text_b.find(lower_query) != std::string::npos;
-        
-        if (a_exact && !b_exact) return true;
-        if (!a_exact && b_exact) return false;
-        
-        return false; // Keep original order for same relevance
+    std::vector<std::string> tokens = contentTokens(SearchOptimizer::optimizedTokenize(query));
+    if (tokens.empty()) return {"No keywords provided."};
+    QueryProfile::step("language_index");
+    std::vector<LanguageIndex::Posting> matches = index.match(tokens);
+    QueryProfile::count("language_matches", matches.size());
+    
+    // Members in index order, with their abbreviations for tagging results
+    const std::vector<std::string>& members = index.translations();
+    std::vector<const VerseStore*> stores;
+    std::vector<std::string> tags;
+    for (const auto& name : members) {
+        auto store_it = current->verses.find(name);
+        stores.push_back(store_it != current->verses.end() ? store_it->second.get() : nullptr);
+        tags.push_back(translationTag(*current, name));
+    }
+    
+    std::vector<std::string> results;
+    for (size_t i = context.offset(); i < matches.size() && !context.limitReached(i); ++i) {
+        const LanguageIndex::Posting& match = matches[i];
+        const VerseStore* first = nullptr;
+        VerseId first_id = INVALID_VERSE_ID;
+        std::string tagged;
+        for (size_t m = 0; m < members.size(); ++m) {
+            if (!(match.translations >> m & 1) || !stores[m]) continue;
+            if (!first) {
+                first = stores[m];
+                first_id = current->alignment.find(members[m], match.row);
+            }
+            tagged += tagged.empty() ? tags[m] : ", " + tags[m];
+        }
+        if (!first || first_id == INVALID_VERSE_ID) continue;
+        std::string text(first->text(first_id));
+        results.push_back(first->reference(first_id) + " [" + tagged + "]: " + text);
+    }
+    return results.empty() ? std::vector<std::string>{"No matching verses found."} : results;
+}
+
+std::vector<VerseFinder::AlignedMatch> VerseFinder::searchAllTranslationIds(const std::string& query,
+                                                                            const SearchContext& context) const {
+    std::vector<AlignedMatch> merged;
+    if (!isReady() || query.empty()) return merged;
+    BENCHMARK_SCOPE("all_translations_search");
+    
+    std::shared_ptr<const Corpus> current = snapshot();
+    std::vector<std::string> translations;
+    for (const auto& info : current->translations) {
+        if (current->verses.count(info.name)) translations.push_back(info.name);
+    }
+    
+    // Whole lists, so a verse one translation ranks low still meets the others' hits
+    std::vector<CachedSearchResult> hits(translations.size());
+    TaskScheduler::shared().parallelFor(translations.size(), [&](size_t t) {
+        if (!context.shouldStop()) hits[t] = searchKeywordIds(query, translations[t]);
     });
+    if (context.shouldStop()) return merged;
+    
+    // An entry per row matched, in the order first met; a verse without a row is its own entry
+    QueryProfile::step("align_matches");
+    std::vector<uint32_t> slots(VerseAlignment::rowCount(), UINT32_MAX);
+    for (size_t t = 0; t < translations.size(); ++t) {
+        const CachedSearchResult& result = hits[t];
+        float top = result.scores.empty() ? 0.0f : *std::max_element(result.scores.begin(), result.scores.end());
+        for (size_t i = 0; i < result.ids.size(); ++i) {
+            float score = top > 0.0f && i < result.scores.size() ? result.scores[i] / top : 1.0f;
+            uint32_t row = current->alignment.rowOf(translations[t], result.ids[i]);
+            size_t slot = row != VerseAlignment::NO_ROW ? slots[row] : UINT32_MAX;
+            if (slot == UINT32_MAX) {
+                slot = merged.size();
+                if (row != VerseAlignment::NO_ROW) slots[row] = static_cast<uint32_t>(slot);
+                merged.push_back(AlignedMatch{row});
+            }
+            AlignedMatch& match = merged[slot];
+            match.translations.push_back(translations[t]);
+            if (match.id == INVALID_VERSE_ID || score > match.score) {
+                std::span<const MatchSpan> spans = result.spansOf(i);
+                match.translation = translations[t];
+                match.id = result.ids[i];
+                match.score = score;
+                match.spans.assign(spans.begin(), spans.end());
+            }
+        }
+    }
+    QueryProfile::count("aligned_matches", merged.size());
     
+    if (translations.size() > 1) {
+        const float others = static_cast<float>(translations.size() - 1);
+        for (AlignedMatch& match : merged) {
+            match.score += AGREEMENT_BONUS * static_cast<float>(match.translations.size() - 1) / others;
+        }
+    }
+    
+    // Only the page is ordered; ties go to the most translations, then canonical order
+    size_t end = std::min(context.resultEnd(), merged.size());
+    std::partial_sort(merged.begin(), merged.begin() + end, merged.end(),
+                      [](const AlignedMatch& a, const AlignedMatch& b) {
+                          if (a.score != b.score) return a.score > b.score;
+                          if (a.translations.size() != b.translations.size()) {
+                              return a.translations.size() > b.translations.size();
+                          }
+                          if (a.row != b.row) return a.row < b.row;
+                          return std::tie(a.translation, a.id) < std::tie(b.translation, b.id);
+                      });
+    merged.resize(end);
+    merged.erase(merged.begin(), merged.begin() + std::min(context.offset(), end));
+    return merged;
+}
+
+std::vector<std::string> VerseFinder::searchAllTranslations(const std::string& query,
+                                                            const SearchContext& context) const {
+    if (!isReady()) return {"Bible is loading..."};
+    if (query.empty()) return {"No search query provided."};
+    
+    std::vector<std::string> results;
+    for (const AlignedMatch& match : searchAllTranslationIds(query, context)) {
+        std::string result = formatAlignedMatch(match);
+        if (!result.empty()) results.push_back(std::move(result));
+    }
     return results.empty() ? std::vector<std::string>{"No matching verses found."} : results;
 }
 
+std::string VerseFinder::formatAlignedMatch(const AlignedMatch& match) const {
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto store_it = current->verses.find(match.translation);
+    if (store_it == current->verses.end() || match.id >= store_it->second->size()) return {};
+    const VerseStore& store = *store_it->second;
+    
+    std::string tagged;
+    for (const auto& name : match.translations) {
+        tagged += (tagged.empty() ? "" : ", ") + translationTag(*current, name);
+    }
+    std::string text(store.text(match.id));
+    return store.reference(match.id) + " [" + tagged + "]: " + text;
+}
+
 bool VerseFinder::parseReference(const std::string& reference, std::string& book, int& chapter, int& verse) const {
-    // Initialize defaults
-    book.clear();
+    std::string_view book_view;
+    bool parsed = parseReference(std::string_view(reference), book_view, chapter, verse);
+    book.assign(book_view);
+    return parsed;
+}
+
+bool VerseFinder::parseReference(std::string_view reference, std::string_view& book, int& chapter, int& verse) const {
+    book = {};
     chapter = -1;
     verse = -1;
     
-    // Find the last space to separate book from chapter:verse
-    size_t space_pos = reference.find_last_of(' ');
-    if (space_pos == std::string::npos) {
-        // No space found - might be just a book name
-        book = reference;
-        return true;
+    ParsedReference parsed;
+    if (!ReferenceParser::parse(reference, parsed)) {
+        return false;
     }
-    
-    book = reference.substr(0, space_pos);
-    std::string chapter_verse = reference.substr(space_pos + 1);
-    
-    // Check if there's a colon for verse specification
-    size_t colon_pos = chapter_verse.find(':');
-    if (colon_pos != std::string::npos) {
-        // Format: "Book Chapter:Verse"
-        try {
-            chapter = std::stoi(chapter_verse.substr(0, colon_pos));
-            verse = std::stoi(chapter_verse.substr(colon_pos + 1));
-            return true;
-        } catch (const std::exception&) {
-            return false;
-        }
-    } else {
-        // Format: "Book Chapter" (chapter only)
-        try {
-            chapter = std::stoi(chapter_verse);
-            return true;
-        } catch (const std::exception&) {
-            // Maybe it's part of the book name (e.g., "1 John")
-            book = reference;
-            return true;
-        }
+    book = parsed.book;
+    if (parsed.hasChapter()) {
+        chapter = parsed.first().chapter;
+        verse = parsed.first().verse;
     }
+    return true;
 }
 
 std::vector<std::string> VerseFinder::searchByChapter(const std::string& reference, const std::string& translation) const {
@@ -373,113 +962,193 @@ std::vector<std::string> VerseFinder::searchByChapter(const std::string& referen
     
     BENCHMARK_SCOPE("chapter_search");
     
-    std::string book;
-    int chapter, verse;
-    
-    if (!parseReference(reference, book, chapter, verse)) {
+    ParsedReference parsed;
+    if (!ReferenceParser::parse(reference, parsed)) {
         return {"Invalid reference format."};
     }
     
-    // Normalize the book name
-    std::string normalized_book = normalizeBookName(book);
-    
-    auto trans_it = verses.find(translation);
-    if (trans_it == verses.end()) {
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->verses.find(translation);
+    if (trans_it == current->verses.end()) {
         return {"Translation not found."};
     }
     
-    std::vector<std::string> results;
-    const auto& translation_verses = trans_it->second;
+    const VerseStore& store = *trans_it->second;
+    int book_id = findBook(store, parsed);
     
     // If only book is specified, return error message suggesting format
-    if (chapter == -1) {
+    if (!parsed.hasChapter()) {
+        std::string book(parsed.book);
         return {"Please specify a chapter (e.g., \"" + book + " 1\") or verse (e.g., \"" + book + " 1:1\")."};
     }
+    int chapter = parsed.first().chapter;
     
-    // Collect all verses from the specified chapter
-    for (const auto& verse_pair : translation_verses) {
-        const Verse& v = verse_pair.second;
-        if (v.book == normalized_book && v.chapter == chapter) {
-            std::string verse_ref = normalized_book + " " + std::to_string(v.chapter) + ":" + std::to_string(v.verse);
-            results.push_back(verse_ref + ": " + v.text);
-        }
+    std::vector<std::string> results;
+    for (VerseId id : findChapterVerses(store, book_id, chapter)) {
+        results.push_back(store.formatResult(id));
     }
     
-    // Sort by verse number
-    std::sort(results.begin(), results.end(), [](const std::string& a, const std::string& b) {
-        // Find the pattern "chapter:verse: " to extract verse numbers
-        size_t colon_a = a.find(':');
-        size_t colon_b = b.find(':');
-        
-        if (colon_a != std::string::npos && colon_b != std::string::npos) {
-            size_t second_colon_a = a.find(':', colon_a + 1);
-            size_t second_colon_b = b.find(':', colon_b + 1);
-            
-            if (second_colon_a != std::string::npos && second_colon_b != std::string::npos) {
-                try {
-                    // Extract verse number between first and second colon
-                    std::string verse_str_a = a.substr(colon_a + 1, second_colon_a - colon_a - 1);
-                    std::string verse_str_b = b.substr(colon_b + 1, second_colon_b - colon_b - 1);
-                    
-                    int verse_a = std::stoi(verse_str_a);
-                    int verse_b = std::stoi(verse_str_b);
-                    return verse_a < verse_b;
-                } catch (const std::exception&) {
-                    return false;
-                }
-            }
-        }
-        return false;
-    });
-    
     if (results.empty()) {
-        return {"Chapter not found: " + normalized_book + " " + std::to_string(chapter)};
+        return {"Chapter not found: " + normalizeBookName(parsed.book) + " " + std::to_string(chapter)};
     }
     
     return results;
 }
 
-const std::vector<TranslationInfo>& VerseFinder::getTranslations() const {
-    return available_translations;
+std::vector<VerseId> VerseFinder::findChapterVerses(const VerseStore& store, int book_id, int chapter) {
+    // The chapter is one contiguous slice of the store's canonical order
+    VerseRange range = store.chapterRange(book_id, chapter);
+    std::vector<VerseId> ids;
+    ids.reserve(range.size());
+    for (uint32_t pos = range.first; pos < range.last; ++pos) {
+        ids.push_back(store.atPosition(pos));
+    }
+    return ids;
+}
+
+std::vector<std::vector<std::string>> VerseFinder::searchTranslations(SearchMethod method, const std::string& query,
+                                                                     const std::vector<std::string>& translations,
+                                                                     const SearchContext& context) const {
+    std::vector<std::vector<std::string>> results(translations.size());
+    TaskScheduler::shared().parallelFor(translations.size(), [&](size_t i) {
+        results[i] = (this->*method)(query, translations[i], context);
+    });
+    return results;
+}
+
+std::vector<VerseId> VerseFinder::findPassage(const std::string& reference, const std::string& translation) const {
+    if (!isReady()) return {};
+    
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->verses.find(translation);
+    if (trans_it == current->verses.end()) return {};
+    const VerseStore& store = *trans_it->second;
+    
+    std::vector<VerseId> ids;
+    for (VerseRange range : findPassageRanges(reference, translation)) {
+        for (uint32_t pos = range.first; pos < range.last; ++pos) {
+            ids.push_back(store.atPosition(pos));
+        }
+    }
+    return ids;
+}
+
+std::vector<VerseRange> VerseFinder::findPassageRanges(const std::string& reference, const std::string& translation) const {
+    if (!isReady()) return {};
+    
+    std::vector<ParsedReference> references;
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->verses.find(translation);
+    if (trans_it == current->verses.end() || !ReferenceParser::parseList(reference, references)) {
+        return {};
+    }
+    // A bare book name is not a passage
+    for (const auto& parsed : references) {
+        if (!parsed.hasChapter()) return {};
+    }
+    QueryProfile::step("reference");
+    return findRanges(*trans_it->second, references);
+}
+
+const VerseStore* VerseFinder::getVerseStore(const std::string& translation) const {
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto it = current->verses.find(translation);
+    return it != current->verses.end() ? it->second.get() : nullptr;
+}
+
+std::vector<TranslationInfo> VerseFinder::getTranslations() const {
+    return snapshot()->translations;
 }
 
 void VerseFinder::addTranslation(const std::string& json_data) {
-    json j = json::parse(json_data);
+    TranslationInfo trans_info;
+    VerseStore store;
+    InvertedIndex index;
+    
+    TranslationImporter importer(trans_info, store, index,
+                                 [this](const std::string& book) { return normalizeBookName(book); });
+    if (!importer.importData(json_data)) {
+        std::cerr << "Error parsing translation data: " << importer.getLastError() << std::endl;
+        return;
+    }
 
-    std::string trans_name = j["translation"];
-    std::string trans_abbr = j["abbreviation"];
+    const std::string trans_name = trans_info.name;
 
     // Check if translation already exists
-    for (const auto& trans_info : available_translations) {
-        if (trans_info.name == trans_name) {
+    for (const auto& existing : snapshot()->translations) {
+        if (existing.name == trans_name) {
             std::cerr << "Translation " << trans_name << " already loaded." << std::endl;
             return;
         }
     }
 
-    available_translations.push_back({trans_name, trans_abbr});
-
-    for (const auto& book_json : j["books"]) {
-        std::string book_name = book_json["name"];
-        for (const auto& chapter_json : book_json["chapters"]) {
-            int chapter_num = chapter_json["chapter"];
-            for (const auto& verse_json : chapter_json["verses"]) {
-                Verse v{
-                    book_name,
-                    chapter_num,
-                    verse_json["verse"],
-                    verse_json["text"]
-                };
-                std::string key = makeKey(v.book, v.chapter, v.verse);
-                verses[trans_name][key] = v;
-                // Use optimized tokenization
-                for (const auto& token : SearchOptimizer::optimizedTokenize(v.text)) {
-                    keyword_index[trans_name][token].push_back(key);
-                }
-            }
-        }
+    LoadedTranslation loaded{std::move(trans_info), std::move(store), std::move(index), {}, {}, {}, {}};
+    // Nothing to read it back from, so it is never evicted
+    if (addLoadedTranslation(std::move(loaded), false)) {
+        std::cout << "Added translation: " << trans_name << std::endl;
     }
-    std::cout << "Added translation: " << trans_name << std::endl;
+}
+
+bool VerseFinder::addLoadedTranslation(LoadedTranslation&& loaded, bool evictable) {
+    loaded.similarity.build(loaded.store);
+    loaded.trigrams.build(loaded.store);
+    if (substring_search && loaded.substrings.empty()) loaded.substrings.build(loaded.store);
+    std::lock_guard<std::mutex> lock(residency_mutex);
+    std::shared_ptr<Corpus> next = editCorpus();
+    bool exists = std::any_of(next->translations.begin(), next->translations.end(),
+                              [&loaded](const TranslationInfo& info) { return info.name == loaded.info.name; });
+    if (exists) {
+        std::cerr << "Translation " << loaded.info.name << " already loaded." << std::endl;
+        return false;
+    }
+    installTranslation(*next, std::move(loaded), evictable);
+    publish(next);
+    
+    // Only the new translation is analysed
+    if (topic_analysis_enabled && isReady()) {
+        indexTopics(*next);
+    }
+    return true;
+}
+
+VerseFinder::TranslationBuilder::TranslationBuilder(VerseFinder* owner, TranslationInfo info) : owner(owner) {
+    loaded.info = std::move(info);
+}
+
+bool VerseFinder::TranslationBuilder::addVerse(const std::string& book, int chapter, int verse, std::string_view text) {
+    if (committed) return false;
+    if (book != last_book) {
+        last_book = book;
+        last_book_normalized = owner->normalizeBookName(book);
+    }
+    VerseId id = loaded.store.addVerse(last_book_normalized, chapter, verse, text);
+    if (id == INVALID_VERSE_ID) return false;
+    ++verse_count;
+    return true;
+}
+
+bool VerseFinder::TranslationBuilder::commit() {
+    if (committed || verse_count == 0 || loaded.info.name.empty()) return false;
+    committed = true;
+    loaded.store.finalize();
+    loaded.index.addVerses(loaded.store);
+    loaded.index.finalize();
+    if (owner->substring_search) loaded.substrings.build(loaded.store);
+    
+    // A snapshot lets the directory scan list and map the source file itself
+    // later, so only then can it be evicted and read back
+    const std::string& source = loaded.info.filename;
+    bool evictable = !source.empty() &&
+                     TranslationSnapshot::write(TranslationSnapshot::snapshotPathFor(source), source,
+                                                loaded.info, loaded.store, loaded.index, &loaded.substrings);
+    std::string name = loaded.info.name;
+    if (!owner->addLoadedTranslation(std::move(loaded), evictable)) return false;
+    std::cout << "Imported translation: " << name << " (" << verse_count << " verses)" << std::endl;
+    return true;
+}
+
+std::unique_ptr<VerseFinder::TranslationBuilder> VerseFinder::beginTranslation(const TranslationInfo& info) {
+    return std::make_unique<TranslationBuilder>(this, info);
 }
 
 void VerseFinder::setTranslationsDirectory(const std::string& dir_path) {
@@ -494,7 +1163,125 @@ void VerseFinder::setTranslationsDirectory(const std::string& dir_path) {
 void VerseFinder::loadAllTranslations() {
     if (translations_dir.empty()) return;
     
-    loading_future = std::async(std::launch::async, &VerseFinder::loadTranslationsFromDirectory, this, translations_dir);
+    loading_future = TaskScheduler::shared().submit([this, dir = translations_dir]() {
+        loadTranslationsFromDirectory(dir);
+        if (watch_translations) watchTranslations(dir);
+    }, TaskPriority::INTERACTIVE);
+}
+
+void VerseFinder::setWatchTranslations(bool enabled) {
+    watch_translations = enabled;
+    if (enabled && isReady() && !translations_dir.empty()) {
+        watchTranslations(translations_dir);
+    } else if (!enabled) {
+        std::lock_guard<std::mutex> lock(watcher_mutex);
+        translations_watcher.stop();
+    }
+}
+
+bool VerseFinder::isWatchingTranslations() {
+    std::lock_guard<std::mutex> lock(watcher_mutex);
+    return translations_watcher.isRunning();
+}
+
+void VerseFinder::watchTranslations(const std::string& dir_path) {
+    std::lock_guard<std::mutex> lock(watcher_mutex);
+    translations_watcher.start(dir_path, [this, dir_path](const std::vector<std::string>& names) {
+        std::vector<std::string> paths;
+        for (const auto& name : names) {
+            paths.push_back((std::filesystem::path(dir_path) / name).string());
+        }
+        TaskScheduler::setThreadPriority(TaskPriority::BACKGROUND);
+        reloadTranslationFiles(paths);
+    });
+}
+
+void VerseFinder::reloadTranslationFiles(const std::vector<std::string>& paths) {
+    // Only sources: the snapshots and embeddings written beside them are read with them
+    std::vector<std::string> files;
+    for (const auto& path : paths) {
+        const auto extension = std::filesystem::path(path).extension();
+        if (extension == ".vfsnap" || extension == ".vfemb" || extension == ".vfhnsw" || extension == ".tmp") continue;
+        if (extension == ".json" || std::filesystem::exists(TranslationSnapshot::snapshotPathFor(path))) {
+            files.push_back(path);
+        }
+    }
+    if (files.empty()) return;
+    
+    // One batch of files read at a time, so a lease cannot read a file this is replacing
+    std::lock_guard<std::mutex> loading(materialize_mutex);
+    auto namesFrom = [](const Corpus& current, const std::string& file) {
+        std::vector<std::string> names;
+        for (const auto& info : current.translations) {
+            if (info.filename == file) names.push_back(info.name);
+        }
+        return names;
+    };
+    std::shared_ptr<const Corpus> current = snapshot();
+    std::vector<TranslationInfo> listed(files.size());
+    std::vector<LoadedTranslation> read_in_full(files.size());
+    std::vector<char> outcome(files.size(), 0); // as listTranslation, or 3 removed
+    TaskScheduler::shared().parallelFor(files.size(), [&](size_t i) {
+        if (!std::filesystem::exists(files[i])) {
+            outcome[i] = 3;
+            return;
+        }
+        // A resident translation is read again now; one only listed waits for its next use
+        std::vector<std::string> names = namesFrom(*current, files[i]);
+        bool resident = std::any_of(names.begin(), names.end(),
+                                    [&current](const std::string& name) { return current->verses.count(name) > 0; });
+        if (resident) {
+            outcome[i] = readTranslation(files[i], read_in_full[i]) ? 2 : 0;
+        } else {
+            outcome[i] = listTranslation(files[i], listed[i], read_in_full[i]);
+        }
+    });
+    
+    std::lock_guard<std::mutex> lock(residency_mutex);
+    std::shared_ptr<Corpus> next = editCorpus();
+    bool changed = false;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (outcome[i] == 0) {
+            std::cerr << "Could not read changed translation file " << files[i] << "; keeping the previous version"
+                      << std::endl;
+            continue;
+        }
+        const std::string name = outcome[i] == 2 ? read_in_full[i].info.name : listed[i].name;
+        for (const auto& previous : namesFrom(*next, files[i])) {
+            if (outcome[i] == 3 || previous != name) removeTranslation(*next, previous);
+        }
+        changed = true;
+        if (outcome[i] == 3) continue;
+        bool duplicate = std::any_of(next->translations.begin(), next->translations.end(),
+                                     [&](const TranslationInfo& other) {
+                                         return other.name == name && other.filename != files[i];
+                                     });
+        if (duplicate) {
+            std::cout << "Translation " << name << " already listed, skipping." << std::endl;
+            continue;
+        }
+        // The previous version goes whole, so nothing of it outlives the file
+        if (next->verses.count(name)) unloadTranslation(*next, name);
+        recently_used.remove_if([&name](const ResidentTranslation& entry) { return entry.name == name; });
+        if (outcome[i] == 2) {
+            installTranslation(*next, std::move(read_in_full[i]), true);
+        } else {
+            auto entry = std::find_if(next->translations.begin(), next->translations.end(),
+                                      [&name](const TranslationInfo& info) { return info.name == name; });
+            if (entry != next->translations.end()) {
+                *entry = std::move(listed[i]);
+            } else {
+                next->translations.push_back(std::move(listed[i]));
+            }
+            std::cout << "Listed changed translation: " << name << std::endl;
+        }
+    }
+    if (!changed) return;
+    evictColdTranslations(*next, {});
+    publish(next);
+    if (topic_analysis_enabled) {
+        indexTopics(*next);
+    }
 }
 
 void VerseFinder::loadTranslationsFromDirectory(const std::string& dir_path) {
@@ -505,224 +1292,476 @@ void VerseFinder::loadTranslationsFromDirectory(const std::string& dir_path) {
     
     auto start_time = std::chrono::steady_clock::now();
     
-    // Clear existing translations
-    available_translations.clear();
-    verses.clear();
-    keyword_index.clear();
-    
-    // Collect all JSON files first
-    std::vector<std::string> json_files;
+    // Collect all JSON files first, and sources in other formats that an
+    // import plugin left a snapshot beside
+    std::vector<std::string> source_files;
     for (const auto& entry : std::filesystem::directory_iterator(dir_path)) {
-        if (entry.is_regular_file() && entry.path().extension() == ".json") {
-            json_files.push_back(entry.path().string());
+        if (!entry.is_regular_file()) continue;
+        const auto extension = entry.path().extension();
+        if (extension == ".json") {
+            source_files.push_back(entry.path().string());
+        } else if (extension != ".vfsnap" && extension != ".vfemb" &&
+                   std::filesystem::exists(TranslationSnapshot::snapshotPathFor(entry.path().string()))) {
+            source_files.push_back(entry.path().string());
         }
     }
+    std::sort(source_files.begin(), source_files.end());
     
     // If no translations found in directory, try to load bible.json from parent directory
-    if (json_files.empty()) {
+    if (source_files.empty()) {
         std::string bible_file = dir_path + "/../bible.json";
         if (std::filesystem::exists(bible_file)) {
-            json_files.push_back(bible_file);
+            source_files.push_back(bible_file);
         }
     }
     
-    if (json_files.empty()) {
+    if (source_files.empty()) {
         std::cout << "No translation files found." << std::endl;
         return;
     }
     
-    std::cout << "Loading " << json_files.size() << " translation files..." << std::endl;
-    
-    // Load files in parallel using async tasks
-    std::vector<std::future<void>> loading_tasks;
-    std::mutex data_mutex; // Protect shared data structures
+    // List each file from its snapshot's metadata or the head of its JSON; only a
+    // file that names itself after its verses has to be read in full to be listed.
+    // Files go through the shared scheduler, so however many there are, only as
+    // many are open (and at most that many read in full) as it has threads.
+    std::vector<TranslationInfo> listed(source_files.size());
+    std::vector<LoadedTranslation> read_in_full(source_files.size());
+    std::vector<char> outcome(source_files.size(), 0); // 1 listed, 2 read in full
+    load_files_done = 0;
+    load_files_total = source_files.size();
+    TaskScheduler::shared().parallelFor(source_files.size(), [&](size_t i) {
+        outcome[i] = listTranslation(source_files[i], listed[i], read_in_full[i]);
+        ++load_files_done;
+    });
     
-    for (const auto& file_path : json_files) {
-        loading_tasks.emplace_back(std::async(std::launch::async, [this, file_path, &data_mutex]() {
-            loadSingleTranslationOptimized(file_path, data_mutex);
-        }));
+    {
+        // A fresh corpus replaces the old one whole; searches still reading the
+        // old one finish on it
+        auto next = std::make_shared<Corpus>();
+        std::lock_guard<std::mutex> lock(residency_mutex);
+        recently_used.clear();
+        {
+            std::lock_guard<std::mutex> vector_lock(vector_mutex);
+            vector_indexes.clear();
+        }
+        for (size_t i = 0; i < listed.size(); ++i) {
+            if (outcome[i] != 1) continue;
+            TranslationInfo& info = listed[i];
+            bool duplicate = std::any_of(next->translations.begin(), next->translations.end(),
+                                         [&info](const TranslationInfo& other) { return other.name == info.name; });
+            if (duplicate) {
+                std::cout << "Translation " << info.name << " already listed, skipping." << std::endl;
+            } else {
+                next->translations.push_back(std::move(info));
+            }
+        }
+        for (size_t i = 0; i < read_in_full.size(); ++i) {
+            if (outcome[i] == 2) installTranslation(*next, std::move(read_in_full[i]), true);
+        }
+        publish(next);
     }
     
-    // Wait for all loading tasks to complete
-    for (auto& task : loading_tasks) {
-        task.wait();
+    // The first translation is the default everywhere, so it is read in now
+    std::shared_ptr<const Corpus> listed_corpus = snapshot();
+    if (!listed_corpus->translations.empty()) {
+        acquireTranslation(listed_corpus->translations.front().name);
+        listed_corpus = snapshot();
     }
     
     auto end_time = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
     
-    // Build topic index after loading all translations
+    // Searches start as soon as the default translation is in; completions
+    // and topics follow, and each serves what it has until then
+    data_loaded = true;
+    std::cout << "Listed " << listed_corpus->translations.size() << " translations in " 
+              << duration.count() << "ms (" << listed_corpus->verses.size() << " resident)." << std::endl;
+    
+    // Completions come from the translations resident at startup
+    TaskScheduler::setThreadPriority(TaskPriority::BACKGROUND);
+    auto_complete.buildIndex(listed_corpus->verses, autoCompleteQueryLog());
+    if (topic_analysis_enabled) {
+        indexTopics(*listed_corpus);
+    }
+    auto indexed_time = std::chrono::steady_clock::now();
+    std::cout << "Completion and topic indexes built in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(indexed_time - end_time).count() << "ms."
+              << std::endl;
+}
+
+void VerseFinder::loadSingleTranslation(const std::string& filename) {
+    LoadedTranslation loaded;
+    if (!importTranslationJson(filename, loaded.info, loaded.store, loaded.index)) {
+        return;
+    }
+    loaded.similarity.build(loaded.store);
+    loaded.trigrams.build(loaded.store);
+    if (substring_search) loaded.substrings.build(loaded.store);
+
+    const std::string trans_name = loaded.info.name;
+    const std::string trans_abbr = loaded.info.abbreviation;
+    {
+        std::lock_guard<std::mutex> lock(residency_mutex);
+        std::shared_ptr<Corpus> next = editCorpus();
+        // Check if translation already exists
+        for (const auto& existing : next->translations) {
+            if (existing.name == trans_name) {
+                std::cout << "Translation " << trans_name << " already loaded, skipping." << std::endl;
+                return;
+            }
+        }
+        installTranslation(*next, std::move(loaded), false);
+        publish(next);
+        if (topic_analysis_enabled && isReady()) {
+            indexTopics(*next);
+        }
+    }
+    
+    std::cout << "Successfully loaded translation: " << trans_name << " (" << trans_abbr << ")" << std::endl;
+}
+
+bool VerseFinder::readTranslation(const std::string& filename, LoadedTranslation& loaded) const {
+    // A current binary snapshot maps the verse columns and prebuilt index without parsing JSON
+    std::string snapshot_path = TranslationSnapshot::snapshotPathFor(filename);
+    SubstringIndex* substrings = substring_search ? &loaded.substrings : nullptr;
+    if (!TranslationSnapshot::load(snapshot_path, filename, loaded.info, loaded.store, loaded.index, substrings)) {
+        if (!importTranslationJson(filename, loaded.info, loaded.store, loaded.index)) {
+            return false;
+        }
+        if (substrings) substrings->build(loaded.store);
+        // Cache the import for the next startup; a failed write only costs that start its fast path
+        TranslationSnapshot::write(snapshot_path, filename, loaded.info, loaded.store, loaded.index, substrings);
+    } else if (substrings && substrings->empty()) {
+        // Snapshots written before substring search was turned on gain the index once
+        substrings->build(loaded.store);
+        TranslationSnapshot::write(snapshot_path, filename, loaded.info, loaded.store, loaded.index, substrings);
+    }
+    
+    loaded.similarity.build(loaded.store);
+    loaded.trigrams.build(loaded.store);
+    
+    // Optional verse embeddings beside the translation enable vector semantic search
+    std::string embeddings_path = VectorIndex::embeddingsPathFor(filename);
+    if (std::filesystem::exists(embeddings_path)) {
+        loaded.vectors = std::make_shared<VectorIndex>();
+        if (!loaded.vectors->open(embeddings_path, loaded.store.size())) {
+            std::cerr << "Ignoring embeddings that do not match " << filename << ": " << embeddings_path << std::endl;
+            loaded.vectors.reset();
+        }
+    }
+    return true;
+}
+
+char VerseFinder::listTranslation(const std::string& file_path, TranslationInfo& info,
+                                  LoadedTranslation& loaded) const {
+    VerseStore unused_store;
+    InvertedIndex unused_index;
+    TranslationImporter header(info, unused_store, unused_index);
+    bool is_json = std::filesystem::path(file_path).extension() == ".json";
+    if (TranslationSnapshot::readInfo(TranslationSnapshot::snapshotPathFor(file_path), file_path, info) ||
+        (is_json && header.readHeader(file_path))) {
+        info.is_loaded = false;
+        return 1;
+    }
+    if (is_json && readTranslation(file_path, loaded)) {
+        return 2;
+    }
+    return 0;
+}
+
+bool VerseFinder::readTranslations(const std::vector<std::string>& files, std::vector<LoadedTranslation>& loaded) {
+    loaded.clear();
+    loaded.resize(files.size());
+    std::vector<char> read(files.size(), 0);
+    load_files_total += files.size();
+    TaskScheduler::shared().parallelFor(files.size(), [&](size_t i) {
+        read[i] = readTranslation(files[i], loaded[i]);
+        ++load_files_done;
+    });
+    return std::all_of(read.begin(), read.end(), [](char ok) { return ok != 0; });
+}
+
+std::shared_ptr<const Corpus> VerseFinder::snapshot() const {
+    return std::atomic_load_explicit(&corpus, std::memory_order_acquire);
+}
+
+std::shared_ptr<Corpus> VerseFinder::editCorpus() const {
+    return std::make_shared<Corpus>(*snapshot());
+}
+
+void VerseFinder::publish(std::shared_ptr<Corpus> next) {
+    std::shared_ptr<const Corpus> previous = snapshot();
+    indexLanguages(*next, *previous);
+    std::atomic_store_explicit(&corpus, std::shared_ptr<const Corpus>(next), std::memory_order_release);
+    
+    // Only now, so a search that read the previous version cannot cache its
+    // result as current; ids handed out for a replaced store are void, and its
+    // topics are re-derived
+    auto dropChanged = [this](const VerseStoreMap& from, const VerseStoreMap& to) {
+        for (const auto& [name, store] : from) {
+            auto it = to.find(name);
+            if (it != to.end() && it->second == store) continue;
+            search_cache.invalidateTranslation(name);
+            std::lock_guard<std::mutex> topic_lock(topic_mutex);
+            topic_manager.invalidateTranslation(name);
+        }
+    };
+    dropChanged(previous->verses, next->verses);
+    dropChanged(next->verses, previous->verses);
+}
+
+void VerseFinder::indexLanguages(Corpus& next, const Corpus& previous) {
+    std::unordered_map<std::string, std::vector<std::string>> by_language;
+    for (const auto& info : next.translations) {
+        if (!info.language.empty() && next.keyword_index.count(info.name)) {
+            by_language[info.language].push_back(info.name);
+        }
+    }
+    
+    next.language_indexes.clear();
+    for (const auto& [language, members] : by_language) {
+        if (members.size() < 2) continue;
+        auto kept = previous.language_indexes.find(language);
+        if (kept != previous.language_indexes.end() && kept->second->builtFrom(members, next.keyword_index)) {
+            next.language_indexes[language] = kept->second;
+            continue;
+        }
+        auto index = std::make_shared<LanguageIndex>();
+        index->build(members, next.keyword_index, next.alignment);
+        next.language_indexes[language] = std::move(index);
+    }
+}
+
+void VerseFinder::installTranslation(Corpus& next, LoadedTranslation&& loaded, bool evictable) {
+    const std::string trans_name = loaded.info.name;
+    loaded.info.is_loaded = true;
+    auto listed = std::find_if(next.translations.begin(), next.translations.end(),
+                               [&trans_name](const TranslationInfo& info) { return info.name == trans_name; });
+    if (listed != next.translations.end()) {
+        *listed = loaded.info;
+    } else {
+        next.translations.push_back(loaded.info);
+    }
+    
+    // After the snapshot is written and the indexes built, which read plain text faster
+    if (compress_text) {
+        size_t plain_bytes = loaded.store.textBlob().size();
+        if (loaded.store.compressText()) {
+            std::cout << "Compressed text of " << trans_name << ": " << plain_bytes / 1024 << " KB -> "
+                      << loaded.store.textBlob().size() / 1024 << " KB" << std::endl;
+        }
+    }
+    size_t bytes = loaded.store.getMemoryUsage() + loaded.index.getMemoryUsage() +
+                   loaded.similarity.getMemoryUsage() + loaded.trigrams.getMemoryUsage() +
+                   loaded.substrings.getMemoryUsage();
+    book_resolver.addBookNames(loaded.store.books());
+    auto store = std::make_shared<const VerseStore>(std::move(loaded.store));
+    next.alignment.addTranslation(trans_name, *store);
+    next.verses[trans_name] = store;
+    next.keyword_index[trans_name] = std::make_shared<const InvertedIndex>(std::move(loaded.index));
+    next.similarity_indexes[trans_name] = std::make_shared<const MinHashIndex>(std::move(loaded.similarity));
+    next.trigram_indexes[trans_name] = std::make_shared<const TrigramIndex>(std::move(loaded.trigrams));
+    if (!loaded.substrings.empty()) {
+        next.substring_indexes[trans_name] = std::make_shared<const SubstringIndex>(std::move(loaded.substrings));
+    } else {
+        next.substring_indexes.erase(trans_name);
+    }
+    if (loaded.vectors) {
+        std::lock_guard<std::mutex> vector_lock(vector_mutex);
+        vector_indexes[trans_name] = std::move(loaded.vectors);
+    }
+    if (evictable) {
+        recently_used.push_front({trans_name, bytes});
+    }
+    
+    std::cout << "Loaded translation: " << trans_name << " (" << store->size() << " verses)" << std::endl;
+}
+
+void VerseFinder::unloadTranslation(Corpus& next, const std::string& name) {
+    next.verses.erase(name);
+    next.keyword_index.erase(name);
+    next.similarity_indexes.erase(name);
+    next.trigram_indexes.erase(name);
+    next.substring_indexes.erase(name);
+    next.alignment.removeTranslation(name);
+    {
+        std::lock_guard<std::mutex> vector_lock(vector_mutex);
+        vector_indexes.erase(name);
+    }
+    for (auto& info : next.translations) {
+        if (info.name == name) info.is_loaded = false;
+    }
+    std::cout << "Evicted translation: " << name << std::endl;
+}
+
+void VerseFinder::removeTranslation(Corpus& next, const std::string& name) {
+    if (next.verses.count(name)) unloadTranslation(next, name);
+    recently_used.remove_if([&name](const ResidentTranslation& entry) { return entry.name == name; });
+    next.translations.erase(std::remove_if(next.translations.begin(), next.translations.end(),
+                                           [&name](const TranslationInfo& info) { return info.name == name; }),
+                            next.translations.end());
+    std::cout << "Removed translation: " << name << std::endl;
+}
+
+void VerseFinder::evictColdTranslations(Corpus& next, const std::vector<std::string>& keep) {
+    size_t resident = 0;
+    for (const auto& entry : recently_used) resident += entry.bytes;
+    
+    // Least recently used first; the translations just asked for, and any a
+    // lease holds, stay even over budget
+    for (auto it = recently_used.end(); it != recently_used.begin() && resident > residency_budget;) {
+        --it;
+        if (std::find(keep.begin(), keep.end(), it->name) != keep.end() || lease_counts.count(it->name)) continue;
+        resident -= it->bytes;
+        unloadTranslation(next, it->name);
+        it = recently_used.erase(it);
+    }
+}
+
+void VerseFinder::touchTranslations(const std::vector<std::string>& names) {
+    for (const auto& name : names) {
+        auto it = std::find_if(recently_used.begin(), recently_used.end(),
+                               [&name](const ResidentTranslation& entry) { return entry.name == name; });
+        if (it != recently_used.end()) recently_used.splice(recently_used.begin(), recently_used, it);
+    }
+}
+
+VerseFinder::TranslationLease VerseFinder::acquireTranslation(const std::string& translation) {
+    return acquireTranslations({translation});
+}
+
+VerseFinder::TranslationLease VerseFinder::acquireTranslations(const std::vector<std::string>& translations) {
+    // Listed translations that still have to be read in
+    auto findMissing = [&translations](const Corpus& current, std::vector<std::string>& files, bool& known) {
+        files.clear();
+        known = true;
+        for (const auto& name : translations) {
+            if (current.verses.count(name)) continue;
+            auto listed = std::find_if(current.translations.begin(), current.translations.end(),
+                                       [&name](const TranslationInfo& info) { return info.name == name; });
+            if (listed == current.translations.end() || listed->filename.empty()) {
+                known = false;
+                return;
+            }
+            files.push_back(listed->filename);
+        }
+    };
+    // Under residency_mutex
+    auto lease = [this, &translations](std::shared_ptr<const Corpus> current) {
+        for (const auto& name : translations) ++lease_counts[name];
+        return TranslationLease(this, translations, std::move(current));
+    };
+    
+    std::vector<std::string> files;
+    bool known = true;
+    {
+        std::lock_guard<std::mutex> lock(residency_mutex);
+        std::shared_ptr<const Corpus> current = snapshot();
+        findMissing(*current, files, known);
+        if (!known) return {};
+        if (files.empty()) {
+            touchTranslations(translations);
+            return lease(std::move(current));
+        }
+    }
+    
+    // Read outside the residency lock so searches and leases on resident translations carry on
+    std::lock_guard<std::mutex> loading(materialize_mutex);
+    {
+        // Another thread may have read them in while this one waited
+        std::lock_guard<std::mutex> lock(residency_mutex);
+        findMissing(*snapshot(), files, known);
+        if (!known) return {};
+    }
+    std::vector<LoadedTranslation> loaded;
+    if (!readTranslations(files, loaded)) return {};
+    
+    std::lock_guard<std::mutex> lock(residency_mutex);
+    std::shared_ptr<Corpus> next = editCorpus();
+    for (auto& translation : loaded) {
+        if (!next->verses.count(translation.info.name)) installTranslation(*next, std::move(translation), true);
+    }
+    for (const auto& name : translations) {
+        if (!next->verses.count(name)) return {}; // The file no longer holds the translation listed
+    }
+    touchTranslations(translations);
+    evictColdTranslations(*next, translations);
+    publish(next);
     if (topic_analysis_enabled) {
-        topic_manager.buildTopicIndex(verses);
+        indexTopics(*next);
     }
-    
-    data_loaded = true;
-    std::cout << "Loaded " << available_translations.size() << " translations in " 
-              << duration.count() << "ms." << std::endl;
+    return lease(std::move(next));
 }
 
-void VerseFinder::loadSingleTranslation(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open " << filename << std::endl;
-        return;
+void VerseFinder::releaseLease(const std::vector<std::string>& translations) {
+    std::lock_guard<std::mutex> lock(residency_mutex);
+    for (const auto& name : translations) {
+        auto it = lease_counts.find(name);
+        if (it != lease_counts.end() && --it->second == 0) lease_counts.erase(it);
     }
+}
 
-    json j;
-    try {
-        file >> j;
-    } catch (const std::exception& e) {
-        std::cerr << "Error parsing JSON file " << filename << ": " << e.what() << std::endl;
-        return;
+VerseFinder::TranslationLease& VerseFinder::TranslationLease::operator=(TranslationLease&& other) noexcept {
+    if (this != &other) {
+        if (owner) owner->releaseLease(translations);
+        owner = std::exchange(other.owner, nullptr);
+        translations = std::move(other.translations);
+        pinned = std::move(other.pinned);
     }
+    return *this;
+}
 
-    std::string trans_name = j.value("translation", "Unknown");
-    std::string trans_abbr = j.value("abbreviation", "UNK");
-    std::string trans_desc = j.value("description", "");
-    int trans_year = j.value("year", 0);
-    std::string trans_lang = j.value("language", "");
+VerseFinder::TranslationLease::~TranslationLease() {
+    if (owner) owner->releaseLease(translations);
+}
 
-    // Check if translation already exists
-    for (const auto& trans_info : available_translations) {
-        if (trans_info.name == trans_name) {
-            std::cout << "Translation " << trans_name << " already loaded, skipping." << std::endl;
-            return;
-        }
-    }
+bool VerseFinder::isTranslationResident(const std::string& translation) const {
+    return snapshot()->verses.count(translation) > 0;
+}
 
-    TranslationInfo trans_info(trans_name, trans_abbr, trans_desc, trans_year, trans_lang, filename);
-    trans_info.is_loaded = true;
-    available_translations.push_back(trans_info);
-
-    // Load verses
-    if (j.contains("books") && j["books"].is_array()) {
-        for (const auto& book_json : j["books"]) {
-            std::string book_name = book_json.value("name", "Unknown Book");
-            if (book_json.contains("chapters") && book_json["chapters"].is_array()) {
-                for (const auto& chapter_json : book_json["chapters"]) {
-                    int chapter_num = chapter_json.value("chapter", 1);
-                    if (chapter_json.contains("verses") && chapter_json["verses"].is_array()) {
-                        for (const auto& verse_json : chapter_json["verses"]) {
-                            Verse v{
-                                book_name,
-                                chapter_num,
-                                verse_json.value("verse", 1),
-                                verse_json.value("text", "")
-                            };
-                            std::string key = makeKey(v.book, v.chapter, v.verse);
-                            verses[trans_name][key] = v;
-                            
-                            // Build keyword index
-                            for (const auto& token : tokenize(v.text)) {
-                                keyword_index[trans_name][token].push_back(key);
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-    
-    std::cout << "Successfully loaded translation: " << trans_name << " (" << trans_abbr << ")" << std::endl;
+void VerseFinder::setResidencyBudget(size_t bytes) {
+    std::lock_guard<std::mutex> lock(residency_mutex);
+    residency_budget = bytes;
 }
 
-void VerseFinder::loadSingleTranslationOptimized(const std::string& filename, std::mutex& data_mutex) {
-    // Load and parse JSON outside of the lock
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open " << filename << std::endl;
-        return;
-    }
+size_t VerseFinder::getResidencyBudget() const {
+    std::lock_guard<std::mutex> lock(residency_mutex);
+    return residency_budget;
+}
 
-    json j;
-    try {
-        // Use more efficient JSON parsing
-        file.seekg(0, std::ios::end);
-        size_t file_size = file.tellg();
-        file.seekg(0, std::ios::beg);
-        
-        std::string json_content;
-        json_content.reserve(file_size); // Pre-allocate memory
-        
-        json_content.assign((std::istreambuf_iterator<char>(file)),
-                           std::istreambuf_iterator<char>());
-        
-        j = json::parse(json_content);
-    } catch (const std::exception& e) {
-        std::cerr << "Error parsing JSON file " << filename << ": " << e.what() << std::endl;
-        return;
-    }
+void VerseFinder::setCompressedText(bool enabled) {
+    compress_text = enabled;
+}
 
-    std::string trans_name = j.value("translation", "Unknown");
-    std::string trans_abbr = j.value("abbreviation", "UNK");
-    std::string trans_desc = j.value("description", "");
-    int trans_year = j.value("year", 0);
-    std::string trans_lang = j.value("language", "");
-
-    // Pre-process all data structures without locks
-    std::unordered_map<std::string, Verse> local_verses;
-    std::unordered_map<std::string, std::vector<std::string>> local_keyword_index;
-    
-    // Estimate capacity for better performance
-    if (j.contains("books") && j["books"].is_array()) {
-        size_t estimated_verses = j["books"].size() * 25 * 30; // rough estimate
-        local_verses.reserve(estimated_verses);
-        local_keyword_index.reserve(estimated_verses / 10); // estimate unique words
-    }
-
-    // Load verses into local data structures
-    if (j.contains("books") && j["books"].is_array()) {
-        for (const auto& book_json : j["books"]) {
-            std::string book_name = book_json.value("name", "Unknown Book");
-            if (book_json.contains("chapters") && book_json["chapters"].is_array()) {
-                for (const auto& chapter_json : book_json["chapters"]) {
-                    int chapter_num = chapter_json.value("chapter", 1);
-                    if (chapter_json.contains("verses") && chapter_json["verses"].is_array()) {
-                        for (const auto& verse_json : chapter_json["verses"]) {
-                            Verse v{
-                                book_name,
-                                chapter_num,
-                                verse_json.value("verse", 1),
-                                verse_json.value("text", "")
-                            };
-                            std::string key = makeKey(v.book, v.chapter, v.verse);
-                            
-                            // Build keyword index before moving the verse
-                            std::vector<std::string> tokens = tokenize(v.text);
-                            for (const auto& token : tokens) {
-                                local_keyword_index[token].push_back(key);
-                            }
-                            
-                            local_verses[key] = std::move(v);
-                        }
-                    }
-                }
-            }
-        }
-    }
-    
-    // Now lock and move all data to shared structures
-    {
-        std::lock_guard<std::mutex> lock(data_mutex);
-        
-        // Check if translation already exists
-        for (const auto& trans_info : available_translations) {
-            if (trans_info.name == trans_name) {
-                std::cout << "Translation " << trans_name << " already loaded, skipping." << std::endl;
-                return;
-            }
-        }
-        
-        available_translations.push_back(TranslationInfo(trans_name, trans_abbr, trans_desc, trans_year, trans_lang, filename));
-        available_translations.back().is_loaded = true;
-        
-        // Move local data to shared structures
-        verses[trans_name] = std::move(local_verses);
-        keyword_index[trans_name] = std::move(local_keyword_index);
-        
-        std::cout << "Loaded translation: " << trans_name << " (" 
-                  << verses[trans_name].size() << " verses)" << std::endl;
+bool VerseFinder::isCompressedText() const {
+    return compress_text;
+}
+
+void VerseFinder::setSubstringSearch(bool enabled) {
+    substring_search = enabled;
+}
+
+bool VerseFinder::isSubstringSearch() const {
+    return substring_search;
+}
+
+size_t VerseFinder::getResidentBytes() const {
+    std::lock_guard<std::mutex> lock(residency_mutex);
+    size_t bytes = 0;
+    for (const auto& entry : recently_used) bytes += entry.bytes;
+    return bytes;
+}
+
+bool VerseFinder::importTranslationJson(const std::string& filename, TranslationInfo& info,
+                                        VerseStore& local_verses, InvertedIndex& local_keyword_index) const {
+    // Stream verses straight into the local store and index; the file is never held as a DOM
+    TranslationImporter importer(info, local_verses, local_keyword_index,
+                                 [this](const std::string& book) { return normalizeBookName(book); });
+    if (!importer.importFile(filename)) {
+        std::cerr << "Error loading JSON file " << filename << ": " << importer.getLastError() << std::endl;
+        return false;
     }
+    return true;
 }
 
 bool VerseFinder::saveTranslation(const std::string& json_data, const std::string& filename) {
@@ -764,90 +1803,36 @@ bool VerseFinder::loadTranslationFromFile(const std::string& filename) {
 std::string VerseFinder::getAdjacentVerse(const std::string& reference, const std::string& translation, int direction) const {
     if (!isReady()) return "";
     
-    // Parse the reference to extract book, chapter, and verse
-    size_t space_pos = reference.find_last_of(' ');
-    if (space_pos == std::string::npos) return "";
-    
-    std::string book = reference.substr(0, space_pos);
-    std::string chapter_verse = reference.substr(space_pos + 1);
-    
-    size_t colon_pos = chapter_verse.find(':');
-    if (colon_pos == std::string::npos) return "";
-    
-    int chapter = std::stoi(chapter_verse.substr(0, colon_pos));
-    int verse = std::stoi(chapter_verse.substr(colon_pos + 1));
-    
-    // Normalize book name
-    std::string normalized_book = normalizeBookName(book);
-    
-    // Navigate step by step to handle multiple movements and chapter boundaries
-    int current_chapter = chapter;
-    int current_verse = verse;
-    int steps_remaining = std::abs(direction);
-    int step_direction = (direction > 0) ? 1 : -1;
-    
-    for (int i = 0; i < steps_remaining; i++) {
-        int next_verse = current_verse + step_direction;
-        
-        if (step_direction > 0) {
-            // Moving forward
-            if (!verseExists(normalized_book, current_chapter, next_verse, translation)) {
-                // Try next chapter, verse 1
-                current_chapter++;
-                next_verse = 1;
-                if (!verseExists(normalized_book, current_chapter, next_verse, translation)) {
-                    // Reached end of book or invalid book
-                    if (i == 0) return ""; // Couldn't move at all
-                    break; // Stop here with current position
-                }
-            }
-        } else {
-            // Moving backward
-            if (next_verse < 1) {
-                // Go to previous chapter's last verse
-                current_chapter--;
-                if (current_chapter < 1) {
-                    // Reached beginning of book
-                    if (i == 0) return ""; // Couldn't move at all
-                    break; // Stop here with current position
-                }
-                next_verse = getLastVerseInChapter(normalized_book, current_chapter, translation);
-                if (next_verse == 0) {
-                    // Chapter doesn't exist
-                    if (i == 0) return ""; // Couldn't move at all
-                    break; // Stop here with current position
-                }
-            } else {
-                // Check if the previous verse exists in the current chapter
-                if (!verseExists(normalized_book, current_chapter, next_verse, translation)) {
-                    // Previous verse doesn't exist in current chapter
-                    if (i == 0) return ""; // Couldn't move at all
-                    break; // Stop here with current position
-                }
-            }
-        }
-        
-        current_verse = next_verse;
+    ParsedReference parsed;
+    if (!ReferenceParser::parse(reference, parsed) || !parsed.hasChapter() || parsed.first().wholeChapters()) {
+        return "";
     }
     
-    // Construct new reference and search for it
-    std::string new_reference = normalized_book + " " + std::to_string(current_chapter) + ":" + std::to_string(current_verse);
-    std::string result = searchByReference(new_reference, translation);
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->verses.find(translation);
+    if (trans_it == current->verses.end()) return "";
+    const VerseStore& store = *trans_it->second;
     
-    if (result != "Verse not found.") {
-        return new_reference + ": " + result;
-    }
+    // From a range, step away from its first verse
+    VerseId id = store.find(findBook(store, parsed), parsed.first().chapter, parsed.first().verse);
+    if (id == INVALID_VERSE_ID) return "";
+    
+    // Step through canonical positions, crossing chapter boundaries but stopping at the book's ends
+    VerseRange book_range = store.bookRange(store.bookId(id));
+    int64_t position = store.positionOf(id);
+    int64_t target = std::clamp<int64_t>(position + direction, book_range.first, int64_t(book_range.last) - 1);
+    if (target == position) return ""; // Couldn't move at all
     
-    return "";
+    return store.formatResult(store.atPosition(static_cast<uint32_t>(target)));
 }
 
 bool VerseFinder::verseExists(const std::string& book, int chapter, int verse, const std::string& translation) const {
     if (!isReady()) return false;
     
-    std::string key = makeKey(book, chapter, verse);
-    auto trans_it = verses.find(translation);
-    if (trans_it != verses.end()) {
-        return trans_it->second.find(key) != trans_it->second.end();
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->verses.find(translation);
+    if (trans_it != current->verses.end()) {
+        return trans_it->second->find(normalizeBookName(book), chapter, verse) != INVALID_VERSE_ID;
     }
     return false;
 }
@@ -855,41 +1840,52 @@ bool VerseFinder::verseExists(const std::string& book, int chapter, int verse, c
 int VerseFinder::getLastVerseInChapter(const std::string& book, int chapter, const std::string& translation) const {
     if (!isReady()) return 0;
     
-    auto trans_it = verses.find(translation);
-    if (trans_it == verses.end()) return 0;
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->verses.find(translation);
+    if (trans_it == current->verses.end()) return 0;
     
-    int last_verse = 0;
-    for (const auto& verse_pair : trans_it->second) {
-        const Verse& v = verse_pair.second;
-        if (v.book == book && v.chapter == chapter) {
-            last_verse = std::max(last_verse, v.verse);
-        }
-    }
+    const VerseStore& store = *trans_it->second;
+    VerseRange range = store.chapterRange(store.findBook(book), chapter);
+    if (range.empty()) return 0;
     
-    return last_verse;
+    // Chapters are sorted by verse number
+    return store.verseNumber(store.atPosition(range.last - 1));
 }
 
 int VerseFinder::getLastChapterInBook(const std::string& book, const std::string& translation) const {
     if (!isReady()) return 0;
     
-    auto trans_it = verses.find(translation);
-    if (trans_it == verses.end()) return 0;
-    
-    int last_chapter = 0;
-    for (const auto& verse_pair : trans_it->second) {
-        const Verse& v = verse_pair.second;
-        if (v.book == book) {
-            last_chapter = std::max(last_chapter, v.chapter);
-        }
-    }
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->verses.find(translation);
+    if (trans_it == current->verses.end()) return 0;
     
-    return last_chapter;
+    return trans_it->second->lastChapter(trans_it->second->findBook(book));
 }
 
 void VerseFinder::clearSearchCache() {
     search_cache.clear();
 }
 
+void VerseFinder::applyDegradationProfile(const DegradationProfile& profile) {
+    bool topics_were_enabled = topic_analysis_enabled;
+    degradation_profile = profile;
+    fuzzy_search_enabled = fuzzy_search_requested && profile.fuzzy_search;
+    semantic_search_enabled = semantic_search_requested && profile.semantic_search;
+    topic_analysis_enabled = topic_analysis_requested && profile.topic_analysis;
+    
+    // Translations loaded while topics were shed have no topic index yet
+    if (topic_analysis_enabled && !topics_were_enabled && isReady()) {
+        std::shared_ptr<const Corpus> current = snapshot();
+        indexTopics(*current);
+    }
+    
+    CacheManager::shared().setBudgetFraction(profile.cache_budget_fraction);
+}
+
+const DegradationProfile& VerseFinder::getDegradationProfile() const {
+    return degradation_profile;
+}
+
 void VerseFinder::setBenchmark(PerformanceBenchmark* bench) {
     benchmark = bench;
 }
@@ -904,14 +1900,16 @@ void VerseFinder::printPerformanceStats() const {
         
         // Print cache statistics
         std::cout << "\n=== Search Cache Statistics ===\n";
-        std::cout << "Cache size: " << search_cache.size() << "/" << search_cache.maxSize() << "\n";
+        std::cout << "Cache size: " << search_cache.size() << " entries, "
+                  << search_cache.memoryUsage() / 1024 << "/" << search_cache.memoryBudget() / 1024 << " KB\n";
         std::cout << "Hit rate: " << std::fixed << std::setprecision(2) << (search_cache.hitRate() * 100) << "%\n";
         std::cout << std::endl;
     }
 }
 
 void VerseFinder::enableFuzzySearch(bool enable) {
-    fuzzy_search_enabled = enable;
+    fuzzy_search_requested = enable;
+    fuzzy_search_enabled = enable && degradation_profile.fuzzy_search;
     std::cout << "Fuzzy search " << (enable ? "enabled" : "disabled") << std::endl;
 }
 
@@ -927,81 +1925,106 @@ const FuzzySearchOptions& VerseFinder::getFuzzySearchOptions() const {
     return fuzzy_search.getOptions();
 }
 
-std::vector<std::string> VerseFinder::searchByKeywordsFuzzy(const std::string& query, const std::string& translation) const {
+std::vector<std::string> VerseFinder::searchByKeywordsFuzzy(const std::string& query, const std::string& translation,
+                                                            const SearchContext& context) const {
     if (!isReady()) return {"Bible is loading..."};
-    if (!fuzzy_search_enabled) return searchByKeywords(query, translation);
+    if (!fuzzy_search_enabled) return searchByKeywords(query, translation, context);
     
     BENCHMARK_SCOPE("fuzzy_keyword_search");
     
     // First try exact search
-    std::vector<std::string> exact_results = searchByKeywords(query, translation);
+    std::vector<std::string> exact_results = searchByKeywords(query, translation, context);
     
     // If we have good exact results, return them immediately
     if (!exact_results.empty() && exact_results[0] != "No matching verses found.") {
         return exact_results;
     }
+    QueryProfile::step("fuzzy");
     
     // Get translation data
-    auto trans_it = verses.find(translation);
-    if (trans_it == verses.end()) {
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->verses.find(translation);
+    if (trans_it == current->verses.end()) {
         return {"Translation not found."};
     }
     
-    auto keyword_it = keyword_index.find(translation);
-    if (keyword_it == keyword_index.end()) {
+    auto keyword_it = current->keyword_index.find(translation);
+    if (keyword_it == current->keyword_index.end()) {
         return {"Translation index not found."};
     }
     
-    const auto& translation_verses = trans_it->second;
-    const auto& index = keyword_it->second;
+    const VerseStore& store = *trans_it->second;
+    const InvertedIndex& index = *keyword_it->second;
+    
+    // Candidate bookkeeping lives only as long as this search
+    QueryArena::Scope arena;
     
     // Tokenize query for smart candidate selection
     auto query_tokens = SearchOptimizer::optimizedTokenize(query);
-    std::unordered_set<std::string> candidate_verses;
+    std::pmr::set<VerseId> candidate_verses(arena.resource());
     
-    // Strategy 1: Find candidates through fuzzy word matching in the index
+    // Strategy 1: Find candidates through every vocabulary word near each query token
+    const int max_distance = fuzzy_search.getOptions().maxEditDistance;
+    const size_t max_word_matches = 10;
+    // Candidate scoring runs on the bit-parallel kernel, so the option's budget is affordable
+    const size_t max_candidates = static_cast<size_t>(std::max(1, fuzzy_search.getOptions().maxCandidates));
     for (const auto& token : query_tokens) {
-        // Collect a sample of index words for fuzzy matching (performance limited)
-        std::vector<std::string> sample_words;
-        sample_words.reserve(200); // Limit vocabulary sample for performance
-        
-        for (const auto& entry : index) {
-            sample_words.push_back(entry.first);
-            if (sample_words.size() >= 200) break; // Hard limit for performance
+        // Short words tolerate fewer edits before they match everything
+        int allowed = std::min(max_distance, token.size() <= 4 ? 1 : 2);
+        std::vector<BKTree::Match> word_matches = index.vocabulary().search(token, allowed);
+        // Names misspelled past the edit budget ("nebucadnezar") still sound alike; they rank after
+        if (fuzzy_search.getOptions().enablePhonetic) {
+            for (std::string_view word : index.phonetics().find(token)) {
+                auto same = [word](const BKTree::Match& match) { return match.word == word; };
+                if (std::none_of(word_matches.begin(), word_matches.end(), same)) {
+                    word_matches.push_back({word, allowed + 1});
+                }
+            }
         }
         
-        // Set lower confidence for word matching to cast a wider net
-        FuzzySearchOptions word_options = fuzzy_search.getOptions();
-        word_options.minConfidence = 0.4; // Lower threshold for word matching
-        word_options.maxSuggestions = 10; // More word suggestions
-        FuzzySearch word_matcher(word_options);
-        
-        std::vector<FuzzyMatch> word_matches = word_matcher.findMatches(token, sample_words);
+        // Closest words first; among equals, the most frequent one is the likeliest intent
+        std::pmr::vector<std::pair<const BKTree::Match*, size_t>> ranked(arena.resource());
+        ranked.reserve(word_matches.size());
+        for (const auto& match : word_matches) {
+            const PostingList* postings = index.find(std::string(match.word));
+            ranked.push_back({&match, postings ? postings->size() : 0});
+        }
+        std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+            if (a.first->distance != b.first->distance) return a.first->distance < b.first->distance;
+            if (a.second != b.second) return a.second > b.second;
+            return a.first->word < b.first->word;
+        });
+        if (ranked.size() > max_word_matches) ranked.resize(max_word_matches);
         
         // For each matched word, add its verses to candidates
-        for (const auto& match : word_matches) {
-            auto word_it = index.find(match.text);
-            if (word_it != index.end()) {
-                for (const auto& verse_key : word_it->second) {
-                    candidate_verses.insert(verse_key);
+        for (const auto& entry : ranked) {
+            if (const PostingList* postings = index.find(std::string(entry.first->word))) {
+                for (VerseId id : *postings) {
+                    candidate_verses.insert(id);
                     // Limit total candidates for performance
-                    if (candidate_verses.size() >= 300) break;
+                    if (candidate_verses.size() >= max_candidates) break;
                 }
             }
-            if (candidate_verses.size() >= 300) break;
+            if (candidate_verses.size() >= max_candidates) break;
         }
         
         // Early termination if we have enough candidates
-        if (candidate_verses.size() >= 300) break;
+        if (candidate_verses.size() >= max_candidates) break;
     }
     
-    // Strategy 2: If still too few candidates, add a sample from full verses
-    if (candidate_verses.size() < 50) {
-        size_t verse_count = 0;
-        for (const auto& verse_pair : translation_verses) {
-            candidate_verses.insert(verse_pair.first);
-            if (++verse_count >= 200) break; // Limit sample for performance
+    QueryProfile::count("fuzzy_vocabulary_candidates", candidate_verses.size());
+    
+    // Strategy 2: Verses sharing the most trigrams with the query, which finds
+    // phrases whose words are misspelled or run together past any one word's
+    // edit distance. Each must share a third of the query's trigrams.
+    auto trigram_it = current->trigram_indexes.find(translation);
+    if (trigram_it != current->trigram_indexes.end() &&
+        (query_tokens.size() > 1 || candidate_verses.size() < MIN_FUZZY_CANDIDATES)) {
+        size_t query_trigrams = TrigramIndex::trigramsOf(query).size();
+        for (const auto& candidate : trigram_it->second->candidates(query, TRIGRAM_CANDIDATES, (query_trigrams + 2) / 3)) {
+            candidate_verses.insert(candidate.first);
         }
+        QueryProfile::count("fuzzy_candidates", candidate_verses.size());
     }
     
     // Now perform fuzzy text matching only on the candidate set
@@ -1010,22 +2033,21 @@ std::vector<std::string> VerseFinder::searchByKeywordsFuzzy(const std::string& q
     candidate_texts.reserve(candidate_verses.size());
     candidate_keys.reserve(candidate_verses.size());
     
-    for (const auto& verse_key : candidate_verses) {
-        auto verse_it = translation_verses.find(verse_key);
-        if (verse_it != translation_verses.end()) {
-            candidate_texts.push_back(verse_it->second.text);
-            candidate_keys.push_back(verse_key);
-        }
+    for (VerseId id : candidate_verses) {
+        candidate_texts.emplace_back(store.text(id));
+        candidate_keys.push_back(store.reference(id));
     }
     
     // Perform fuzzy search on the much smaller candidate set
-    std::vector<FuzzyMatch> fuzzy_matches = fuzzy_search.findMatches(query, candidate_texts);
+    std::vector<FuzzyMatch> fuzzy_matches = fuzzy_search.findMatches(query, candidate_texts, context);
+    QueryProfile::count("fuzzy_matches", fuzzy_matches.size());
     
     // Build results with confidence indicators - use direct indexing for performance
     std::vector<std::string> results;
     results.reserve(fuzzy_matches.size());
     
-    for (size_t i = 0; i < fuzzy_matches.size(); ++i) {
+    size_t matched = 0;
+    for (size_t i = 0; i < fuzzy_matches.size() && !context.limitReached(matched); ++i) {
         const auto& match = fuzzy_matches[i];
         
         // Find the corresponding verse key using direct indexing where possible
@@ -1039,7 +2061,9 @@ std::vector<std::string> VerseFinder::searchByKeywordsFuzzy(const std::string& q
                 } else if (match.matchType == "partial") {
                     confidence_indicator = " [...]";
                 }
-                results.push_back(candidate_keys[j] + confidence_indicator + ": " + match.text);
+                if (matched++ >= context.offset()) {
+                    results.push_back(candidate_keys[j] + confidence_indicator + ": " + match.text);
+                }
                 break; // Found the match, no need to continue searching
             }
         }
@@ -1053,35 +2077,52 @@ std::vector<FuzzyMatch> VerseFinder::findBookNameSuggestions(const std::string&
     
     // Collect all unique book names from loaded translations
     std::set<std::string> book_names_set;
-    for (const auto& translation_pair : verses) {
-        for (const auto& verse_pair : translation_pair.second) {
-            book_names_set.insert(verse_pair.second.book);
-        }
+    std::shared_ptr<const Corpus> current = snapshot();
+    for (const auto& translation_pair : current->verses) {
+        const auto& books = translation_pair.second->books();
+        book_names_set.insert(books.begin(), books.end());
     }
     
-    // Also include book aliases
-    for (const auto& alias_pair : book_aliases) {
-        book_names_set.insert(alias_pair.first);
-        book_names_set.insert(alias_pair.second);
+    // Also include the canonical names and the user's aliases
+    for (int book = 1; book <= BookResolver::BOOK_COUNT; book++) {
+        book_names_set.emplace(BookResolver::canonicalName(book));
+    }
+    for (const auto& alias : book_resolver.aliasNames()) {
+        book_names_set.insert(alias);
     }
     
     std::vector<std::string> book_names(book_names_set.begin(), book_names_set.end());
-    return fuzzy_search.findBookMatches(query, book_names);
+    return fuzzy_search.findBookMatches(query, book_names, book_resolver.soundsLike(query));
 }
 
 std::vector<std::string> VerseFinder::generateQuerySuggestions(const std::string& query, const std::string& translation) const {
     if (!isReady() || !fuzzy_search_enabled) return {};
     
     // Generate suggestions based on keywords from the translation
-    auto trans_it = keyword_index.find(translation);
-    if (trans_it == keyword_index.end()) {
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->keyword_index.find(translation);
+    if (trans_it == current->keyword_index.end()) {
         return {};
     }
     
+    // Only vocabulary words within edit range of a query token are worth scoring
+    const BKTree& vocabulary = trans_it->second->vocabulary();
+    const int max_distance = fuzzy_search.getOptions().maxEditDistance;
+    const bool phonetic = fuzzy_search.getOptions().enablePhonetic;
     std::vector<std::string> keywords;
-    for (const auto& keyword_pair : trans_it->second) {
-        keywords.push_back(keyword_pair.first);
+    for (const auto& token : SearchOptimizer::optimizedTokenize(query)) {
+        for (const auto& match : vocabulary.search(token, std::min(max_distance, 2))) {
+            keywords.emplace_back(match.word);
+        }
+        // And those that sound like it, however far apart the spellings
+        if (phonetic) {
+            for (std::string_view word : trans_it->second->phonetics().find(token)) {
+                keywords.emplace_back(word);
+            }
+        }
     }
+    std::sort(keywords.begin(), keywords.end());
+    keywords.erase(std::unique(keywords.begin(), keywords.end()), keywords.end());
     
     return fuzzy_search.generateSuggestions(query, keywords);
 }
@@ -1101,6 +2142,41 @@ std::vector<std::string> VerseFinder::getSmartSuggestions(const std::string& inp
     return auto_complete.getSmartSuggestions(input, max_results);
 }
 
+void VerseFinder::speculate(const std::string& input, const std::string& translation) {
+    uint64_t generation = ++speculation_generation;
+    if (!isReady() || input.size() < 2) return;
+    
+    // Keyword search ignores case, so suggestions differing only in case are one search
+    std::vector<std::string> predictions;
+    for (std::string& suggestion : getSmartSuggestions(input, static_cast<int>(SPECULATIVE_QUERIES * 2 + 1))) {
+        if (predictions.size() == SPECULATIVE_QUERIES) break;
+        auto same = [&](const std::string& other) { return TextKernels::equalsIgnoreCase(suggestion, other); };
+        // The input itself is already being searched
+        if (same(input) || std::any_of(predictions.begin(), predictions.end(), same)) continue;
+        predictions.push_back(std::move(suggestion));
+    }
+    
+    for (std::string& prediction : predictions) {
+        speculations_pending.fetch_add(1, std::memory_order_acq_rel);
+        TaskScheduler::shared().post([this, generation, prediction = std::move(prediction), translation]() {
+            // A keystroke since: this prediction is stale, and a fresher one is queued
+            if (speculation_generation.load(std::memory_order_acquire) == generation &&
+                snapshot()->verses.count(translation) != 0) {
+                warmSearch(prediction, translation);
+            }
+            speculations_pending.fetch_sub(1, std::memory_order_acq_rel);
+            speculations_pending.notify_all();
+        }, TaskPriority::PREFETCH);
+    }
+}
+
+void VerseFinder::cancelSpeculation() {
+    ++speculation_generation;
+    for (size_t pending = speculations_pending.load(); pending != 0; pending = speculations_pending.load()) {
+        speculations_pending.wait(pending);
+    }
+}
+
 void VerseFinder::updateAutoCompleteFrequency(const std::string& query) {
     auto_complete.updateWordFrequency(query);
 }
@@ -1110,17 +2186,22 @@ void VerseFinder::clearAutoCompleteCache() {
 }
 
 // Semantic search method implementations
-std::vector<std::string> VerseFinder::searchSemantic(const std::string& query, const std::string& translation) const {
+std::vector<std::string> VerseFinder::searchSemantic(const std::string& query, const std::string& translation,
+                                                     const SearchContext& context) const {
     if (!isReady()) return {"Bible is loading..."};
-    if (!semantic_search_enabled) return searchByKeywords(query, translation);
+    if (!semantic_search_enabled) return searchByKeywords(query, translation, context);
     
     BENCHMARK_SCOPE("semantic_search");
     
     // Parse the natural language query
     QueryIntent intent = semantic_search.parseQuery(query);
+    QueryProfile::step("semantic");
     
-    // Generate semantic keywords based on the intent
-    std::vector<std::string> semanticKeywords = semantic_search.generateSemanticKeywords(intent);
+    // Embeddings answer everything but references and boolean expressions
+    if (intent.type != QueryIntent::REFERENCE_LOOKUP && intent.type != QueryIntent::BOOLEAN_SEARCH) {
+        std::vector<std::string> results;
+        if (searchByEmbedding(query, translation, context, results)) return results;
+    }
     
     // Based on query type, route to appropriate search method
     switch (intent.type) {
@@ -1128,14 +2209,14 @@ std::vector<std::string> VerseFinder::searchSemantic(const std::string& query, c
             return {searchByReference(query, translation)};
             
         case QueryIntent::BOOLEAN_SEARCH:
-            return searchBoolean(query, translation);
+            return searchBoolean(query, translation, context);
             
         case QueryIntent::QUESTION_BASED:
-            return answerQuestion(query, translation);
+            return answerQuestion(query, translation, context);
             
         case QueryIntent::TOPICAL_SEARCH:
             if (!intent.topics.empty()) {
-                return searchByTopic(intent.topics[0], translation);
+                return searchByTopic(intent.topics[0], translation, context);
             }
             break;
             
@@ -1146,60 +2227,110 @@ std::vector<std::string> VerseFinder::searchSemantic(const std::string& query, c
             break;
     }
     
+    return rankSemanticKeywords(intent, translation, context);
+}
+
+bool VerseFinder::searchByEmbedding(const std::string& query, const std::string& translation,
+                                    const SearchContext& context, std::vector<std::string>& results) const {
+    QueryEmbedder embedder;
+    std::shared_ptr<const VectorIndex> index;
+    {
+        std::lock_guard<std::mutex> lock(vector_mutex);
+        auto index_it = vector_indexes.find(translation);
+        if (!query_embedder || index_it == vector_indexes.end()) return false;
+        embedder = query_embedder;
+        index = index_it->second;
+    }
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->verses.find(translation);
+    if (trans_it == current->verses.end()) return false;
+    
+    std::vector<float> embedding;
+    if (!embedder(query, embedding) || embedding.size() != index->dimensions()) return false;
+    
+    BENCHMARK_SCOPE("vector_search");
+    
+    // Vectors are stored in canonical verse order
+    const VerseStore& store = *trans_it->second;
+    SearchContext page = context;
+    page.setMaxResults(std::min<size_t>(50, context.maxResults()));
+    QueryProfile::step("vector");
+    std::vector<VectorIndex::Neighbor> neighbors = index->search(embedding, page.resultEnd());
+    QueryProfile::count("vector_neighbors", neighbors.size());
+    results.clear();
+    for (size_t i = page.offset(); i < neighbors.size(); ++i) {
+        results.push_back(store.formatResult(store.atPosition(neighbors[i].first)));
+    }
+    if (results.empty()) results.push_back("No semantic matches found.");
+    return true;
+}
+
+std::vector<std::string> VerseFinder::rankSemanticKeywords(const QueryIntent& intent, const std::string& translation,
+                                                           const SearchContext& context) const {
+    std::vector<std::string> semanticKeywords = semantic_search.generateSemanticKeywords(intent);
+    
     // Perform enhanced keyword search with semantic expansion
     std::vector<std::string> results;
-    auto trans_it = verses.find(translation);
-    if (trans_it == verses.end()) {
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->verses.find(translation);
+    if (trans_it == current->verses.end()) {
         return {"Translation not found."};
     }
     
-    const auto& translation_verses = trans_it->second;
+    const VerseStore& store = *trans_it->second;
     
-    // Score verses based on semantic relevance
-    std::vector<std::pair<std::string, double>> scoredResults;
-    
-    for (const auto& verse_pair : translation_verses) {
-        const std::string& verse_key = verse_pair.first;
-        const Verse& verse = verse_pair.second;
-        
-        double score = 0.0;
-        int matchCount = 0;
-        
-        // Convert verse text to lowercase for comparison
-        std::string lower_verse_text = verse.text;
-        std::transform(lower_verse_text.begin(), lower_verse_text.end(), lower_verse_text.begin(),
-                       [](unsigned char c){ return std::tolower(c); });
-        
-        // Score based on semantic keyword matches
-        for (const auto& keyword : semanticKeywords) {
-            if (lower_verse_text.find(keyword) != std::string::npos) {
-                matchCount++;
-                // Higher weight for original query keywords
-                bool isOriginalKeyword = std::find(intent.keywords.begin(), intent.keywords.end(), keyword) != intent.keywords.end();
-                score += isOriginalKeyword ? 2.0 : 1.0;
-            }
+    auto index_it = current->keyword_index.find(translation);
+    if (index_it == current->keyword_index.end()) {
+        return {"Translation index not found."};
+    }
+    const InvertedIndex& index = *index_it->second;
+    
+    // Every keyword resolves to the indexed terms containing it, or a
+    // phrase ("eternal life") to its consecutive occurrences. A term reached
+    // by several keywords counts once, at the highest weight.
+    std::vector<TermPostings> phrases;
+    phrases.reserve(semanticKeywords.size());
+    std::vector<Bm25Ranker::QueryTerm> terms;
+    QueryArena::Scope arena;
+    std::pmr::unordered_map<const TermPostings*, size_t> term_slots(arena.resource());
+    auto addTerm = [&terms, &term_slots](const TermPostings* postings, float weight) {
+        auto [slot, inserted] = term_slots.emplace(postings, terms.size());
+        if (inserted) {
+            terms.push_back({postings, weight});
+        } else {
+            terms[slot->second].weight = std::max(terms[slot->second].weight, weight);
         }
-        
-        // Only include verses with sufficient matches
-        if (matchCount >= 1 && score > 0) {
-            scoredResults.push_back({verse_key + ": " + verse.text, score});
+    };
+    for (const auto& keyword : semanticKeywords) {
+        // Higher weight for original query keywords
+        bool isOriginalKeyword = std::find(intent.keywords.begin(), intent.keywords.end(), keyword) != intent.keywords.end();
+        float weight = isOriginalKeyword ? 2.0f : 1.0f;
+        auto words = SearchOptimizer::optimizedTokenize(keyword);
+        if (words.size() == 1) {
+            for (const TermPostings* postings : index.termsContaining(words[0])) {
+                addTerm(postings, weight);
+            }
+        } else if (words.size() > 1) {
+            phrases.push_back(index.findPhrase(words));
+            if (!phrases.back().ids.empty()) addTerm(&phrases.back(), weight);
         }
     }
     
-    // Sort by relevance score
-    std::sort(scoredResults.begin(), scoredResults.end(), 
-              [](const auto& a, const auto& b) { return a.second > b.second; });
-    
-    // Extract top results
-    int maxResults = std::min(50, static_cast<int>(scoredResults.size()));
-    for (int i = 0; i < maxResults; ++i) {
-        results.push_back(scoredResults[i].first);
+    // Only the requested page's worth of verses is ever ranked
+    SearchContext page = context;
+    page.setMaxResults(std::min<size_t>(50, context.maxResults()));
+    QueryProfile::step("semantic_keywords");
+    QueryProfile::count("semantic_terms", terms.size());
+    std::vector<Bm25Ranker::ScoredVerse> ranked = Bm25Ranker(index).topK(terms, page.resultEnd(), context);
+    for (size_t i = page.offset(); i < ranked.size(); ++i) {
+        results.push_back(store.formatResult(ranked[i].first));
     }
     
     return results.empty() ? std::vector<std::string>{"No semantic matches found."} : results;
 }
 
-std::vector<std::string> VerseFinder::searchByTopic(const std::string& topic, const std::string& translation) const {
+std::vector<std::string> VerseFinder::searchByTopic(const std::string& topic, const std::string& translation,
+                                                    const SearchContext& context) const {
     if (!isReady()) return {"Bible is loading..."};
     
     BENCHMARK_SCOPE("topic_search");
@@ -1216,90 +2347,82 @@ std::vector<std::string> VerseFinder::searchByTopic(const std::string& topic, co
         keywordQuery += topicKeywords[i];
     }
     
-    return searchByKeywords(keywordQuery, translation);
+    return searchByKeywords(keywordQuery, translation, context);
 }
 
-std::vector<std::string> VerseFinder::answerQuestion(const std::string& question, const std::string& translation) const {
+std::vector<std::string> VerseFinder::answerQuestion(const std::string& question, const std::string& translation,
+                                                     const SearchContext& context) const {
     if (!isReady()) return {"Bible is loading..."};
     
     BENCHMARK_SCOPE("question_answering");
     
+    std::vector<std::string> nearest;
+    if (searchByEmbedding(question, translation, context, nearest)) return nearest;
+    
     // Parse question to extract key topics and subject
     QueryIntent intent = semantic_search.parseQuery(question);
     
     if (!intent.subject.empty()) {
         // Search by the extracted subject
-        return searchByTopic(intent.subject, translation);
+        return searchByTopic(intent.subject, translation, context);
     } else if (!intent.topics.empty()) {
         // Search by identified topics
-        return searchByTopic(intent.topics[0], translation);
+        return searchByTopic(intent.topics[0], translation, context);
     } else {
-        // Fall back to semantic search
-        return searchSemantic(question, translation);
+        // Fall back to the semantic keyword expansion; searchSemantic would route the question back here
+        return rankSemanticKeywords(intent, translation, context);
     }
 }
 
-std::vector<std::string> VerseFinder::searchBoolean(const std::string& query, const std::string& translation) const {
+std::vector<std::string> VerseFinder::searchBoolean(const std::string& query, const std::string& translation,
+                                                    const SearchContext& context) const {
     if (!isReady()) return {"Bible is loading..."};
     
     BENCHMARK_SCOPE("boolean_search");
     
+    // A scope joins the plan as one more required set, already a bitset
+    std::string_view terms = query;
+    std::string scope_name;
+    QueryLexer::Scope scope = QueryLexer::splitScope(query, terms, scope_name);
+    std::shared_ptr<const VerseSet> members;
+    if (scope != QueryLexer::Scope::NONE) {
+        members = scopeVerses(scope, scope_name, translation);
+        if (!members) return {"No collection or topic named \"" + scope_name + "\"."};
+    }
+    
     // Parse boolean query
-    SemanticSearch::BooleanQuery boolQuery = semantic_search.parseBooleanQuery(query);
+    SemanticSearch::BooleanQuery boolQuery = semantic_search.parseBooleanQuery(std::string(terms));
     
-    auto trans_it = verses.find(translation);
-    if (trans_it == verses.end()) {
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->verses.find(translation);
+    auto index_it = current->keyword_index.find(translation);
+    if (trans_it == current->verses.end() || index_it == current->keyword_index.end()) {
         return {"Translation not found."};
     }
     
-    const auto& translation_verses = trans_it->second;
+    const VerseStore& store = *trans_it->second;
+    const InvertedIndex& index = *index_it->second;
+    auto substrings_it = current->substring_indexes.find(translation);
+    const SubstringIndex* substrings =
+        substrings_it != current->substring_indexes.end() ? substrings_it->second.get() : nullptr;
     std::vector<std::string> results;
     
-    for (const auto& verse_pair : translation_verses) {
-        const std::string& verse_key = verse_pair.first;
-        const Verse& verse = verse_pair.second;
-        
-        std::string lower_verse_text = verse.text;
-        std::transform(lower_verse_text.begin(), lower_verse_text.end(), lower_verse_text.begin(),
-                       [](unsigned char c){ return std::tolower(c); });
-        
-        bool matches = true;
-        
-        // Check AND terms (all must be present)
-        if (!boolQuery.andTerms.empty()) {
-            for (const auto& term : boolQuery.andTerms) {
-                if (lower_verse_text.find(term) == std::string::npos) {
-                    matches = false;
-                    break;
-                }
-            }
-        }
-        
-        // Check OR terms (at least one must be present)
-        if (matches && !boolQuery.orTerms.empty()) {
-            bool orMatch = false;
-            for (const auto& term : boolQuery.orTerms) {
-                if (lower_verse_text.find(term) != std::string::npos) {
-                    orMatch = true;
-                    break;
-                }
-            }
-            matches = orMatch;
-        }
-        
-        // Check NOT terms (none should be present)
-        if (matches && !boolQuery.notTerms.empty()) {
-            for (const auto& term : boolQuery.notTerms) {
-                if (lower_verse_text.find(term) != std::string::npos) {
-                    matches = false;
-                    break;
-                }
-            }
-        }
-        
-        if (matches) {
-            results.push_back(verse_key + ": " + verse.text);
-        }
+    // A term matches verses whose text contains it, even inside a longer word
+    auto versesContaining = [&](const std::string& term) {
+        return substrings ? substrings->find(term) : index.findSubstring(term, store);
+    };
+    
+    BooleanPlanner::Query plan;
+    for (const auto& term : boolQuery.andTerms) plan.required.push_back(versesContaining(term));
+    for (const auto& term : boolQuery.orTerms) plan.alternatives.push_back(versesContaining(term));
+    for (const auto& term : boolQuery.notTerms) plan.excluded.push_back(versesContaining(term));
+    if (members) plan.within.push_back(std::move(members));
+    QueryProfile::step("boolean");
+    PostingList matches = BooleanPlanner::execute(std::move(plan), store.size());
+    QueryProfile::count("boolean_matches", matches.size());
+    
+    for (size_t i = context.offset(); i < matches.size() && !context.limitReached(i); ++i) {
+        results.push_back(store.formatResult(matches[i]));
     }
     
     return results.empty() ? std::vector<std::string>{"No boolean matches found."} : results;
@@ -1325,7 +2448,8 @@ QueryIntent VerseFinder::parseNaturalLanguage(const std::string& query) const {
 }
 
 void VerseFinder::enableSemanticSearch(bool enable) {
-    semantic_search_enabled = enable;
+    semantic_search_requested = enable;
+    semantic_search_enabled = enable && degradation_profile.semantic_search;
     std::cout << "Semantic search " << (enable ? "enabled" : "disabled") << std::endl;
 }
 
@@ -1333,19 +2457,37 @@ bool VerseFinder::isSemanticSearchEnabled() const {
     return semantic_search_enabled;
 }
 
+bool VerseFinder::loadEmbeddings(const std::string& translation, const std::string& embeddings_path) {
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto trans_it = current->verses.find(translation);
+    if (trans_it == current->verses.end()) return false;
+    
+    auto index = std::make_shared<VectorIndex>();
+    if (!index->open(embeddings_path, trans_it->second->size())) {
+        std::cerr << "Could not load embeddings for " << translation << " from " << embeddings_path << std::endl;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(vector_mutex);
+    vector_indexes[translation] = std::move(index);
+    return true;
+}
+
+void VerseFinder::setQueryEmbedder(QueryEmbedder embedder) {
+    std::lock_guard<std::mutex> lock(vector_mutex);
+    query_embedder = std::move(embedder);
+}
+
+bool VerseFinder::hasVectorSearch(const std::string& translation) const {
+    std::lock_guard<std::mutex> lock(vector_mutex);
+    return query_embedder && vector_indexes.count(translation) != 0;
+}
+
 // Cross-reference method implementations
 std::vector<std::string> VerseFinder::findCrossReferences(const std::string& verseKey) const {
     if (!isReady() || !cross_references_enabled) return {};
     
-    // Convert verse map to the format expected by CrossReferenceSystem
-    std::unordered_map<std::string, std::string> allVerses;
-    for (const auto& translation_pair : verses) {
-        for (const auto& verse_pair : translation_pair.second) {
-            allVerses[verse_pair.first] = verse_pair.second.text;
-        }
-    }
-    
-    auto crossRefs = cross_reference_system.findCrossReferences(verseKey, allVerses);
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto crossRefs = cross_reference_system.findCrossReferences(verseKey, VerseTextView(current->verses));
     std::vector<std::string> results;
     for (const auto& ref : crossRefs) {
         results.push_back(ref.targetVerse + " [" + ref.relationship + "]");
@@ -1357,14 +2499,71 @@ std::vector<std::string> VerseFinder::findCrossReferences(const std::string& ver
 std::vector<std::string> VerseFinder::findParallelPassages(const std::string& verseKey) const {
     if (!isReady() || !cross_references_enabled) return {};
     
-    std::unordered_map<std::string, std::string> allVerses;
-    for (const auto& translation_pair : verses) {
-        for (const auto& verse_pair : translation_pair.second) {
-            allVerses[verse_pair.first] = verse_pair.second.text;
+    std::shared_ptr<const Corpus> current = snapshot();
+    std::vector<std::string> results = cross_reference_system.findParallelPassages(verseKey, VerseTextView(current->verses));
+    
+    // Near-duplicates in the first loaded translation that has the verse
+    for (const auto& info : current->translations) {
+        auto store_it = current->verses.find(info.name);
+        auto similarity_it = current->similarity_indexes.find(info.name);
+        if (store_it == current->verses.end() || similarity_it == current->similarity_indexes.end()) continue;
+        if (store_it->second->findByReference(verseKey) == INVALID_VERSE_ID) continue;
+        
+        for (auto& match : cross_reference_system.findThematicMatches(verseKey, *store_it->second, *similarity_it->second)) {
+            if (std::find(results.begin(), results.end(), match) == results.end()) results.push_back(std::move(match));
+        }
+        break;
+    }
+    return results;
+}
+
+std::vector<ParallelPassage> VerseFinder::findParallelPassageGroups(const std::vector<std::string>& books,
+                                                                    const std::string& translation) const {
+    if (!isReady() || !cross_references_enabled) return {};
+    
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto store_it = current->verses.find(translation);
+    auto similarity_it = current->similarity_indexes.find(translation);
+    if (store_it == current->verses.end() || similarity_it == current->similarity_indexes.end()) return {};
+    const VerseStore& store = *store_it->second;
+    
+    std::vector<std::string> verseKeys;
+    for (const auto& book : books) {
+        int book_id = store.findBook(normalizeBookName(book));
+        if (book_id < 0) continue;
+        VerseRange range = store.bookRange(book_id);
+        for (uint32_t position = range.first; position < range.last; ++position) {
+            verseKeys.push_back(store.reference(store.atPosition(position)));
         }
     }
+    return cross_reference_system.findParallelPassageGroups(verseKeys, store, *similarity_it->second);
+}
+
+std::vector<std::string> VerseFinder::findIndirectCrossReferences(const std::string& verseKey, size_t maxResults) const {
+    if (!isReady() || !cross_references_enabled) return {};
+    
+    const CrossReferenceGraph& graph = cross_reference_system.referenceGraph();
+    std::vector<std::string> results;
+    for (const auto& hop : cross_reference_system.findIndirectReferences(verseKey, maxResults)) {
+        results.push_back(graph.reference(hop.target) + " [via " + graph.reference(hop.via) + "]");
+    }
+    return results;
+}
+
+bool VerseFinder::loadCrossReferences(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Could not open cross-references " << path << std::endl;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
     
-    return cross_reference_system.findParallelPassages(verseKey, allVerses);
+    int before = cross_reference_system.getCrossReferenceCount();
+    cross_reference_system.loadCrossReferenceData(buffer.str());
+    std::cout << "Loaded " << (cross_reference_system.getCrossReferenceCount() - before)
+              << " cross-references from " << path << std::endl;
+    return true;
 }
 
 std::vector<std::string> VerseFinder::expandVerseContext(const std::string& verseKey, int contextSize) const {
@@ -1386,42 +2585,158 @@ bool VerseFinder::areCrossReferencesEnabled() const {
 std::string VerseFinder::getVerseOfTheDay() const {
     if (!analytics_enabled) return "John 3:16: For God so loved the world...";
     
-    return search_analytics.getVerseOfTheDay();
+    int today = SearchAnalytics::currentDay();
+    std::lock_guard<std::mutex> lock(verse_of_the_day_mutex);
+    if (verse_of_the_day_date != today) {
+        verse_of_the_day = search_analytics.read([&](const SearchAnalytics& analytics) { return analytics.getVerseOfTheDay(); });
+        verse_of_the_day_date = today;
+    }
+    return verse_of_the_day;
 }
 
 std::string VerseFinder::getRandomVerse() const {
     if (!isReady()) return "";
     
-    // Convert verses to format expected by SearchAnalytics
-    std::unordered_map<std::string, std::string> allVerses;
-    if (!verses.empty()) {
-        const auto& firstTranslation = verses.begin()->second;
-        for (const auto& verse_pair : firstTranslation) {
-            allVerses[verse_pair.first] = verse_pair.second.text;
+    std::shared_ptr<const Corpus> current = snapshot();
+    if (current->verses.empty()) return "";
+    VerseTextView view(*current->verses.begin()->second);
+    return search_analytics.read([&](const SearchAnalytics& analytics) { return analytics.getRandomVerse(view); });
+}
+
+std::vector<std::string> VerseFinder::warmupQueries() const {
+    std::vector<std::string> queries;
+    if (analytics_enabled) {
+        queries = search_analytics.read([](const SearchAnalytics& analytics) {
+            return analytics.getMostSearchedQueries(static_cast<int>(WARMUP_QUERY_COUNT));
+        });
+    }
+    std::lock_guard<std::mutex> lock(warmup_mutex);
+    for (const std::string& query : restored_queries) {
+        if (queries.size() >= WARMUP_QUERY_COUNT) break;
+        if (std::find(queries.begin(), queries.end(), query) == queries.end()) queries.push_back(query);
+    }
+    return queries;
+}
+
+void VerseFinder::warmUp(std::vector<std::string> extra_queries, std::vector<std::string> translations) {
+    cancelWarmUp();
+    // The service's own references first: they are the likeliest next searches
+    std::vector<std::string> queries = std::move(extra_queries);
+    for (std::string& query : warmupQueries()) {
+        if (std::find(queries.begin(), queries.end(), query) == queries.end()) queries.push_back(std::move(query));
+    }
+    if (queries.empty()) return;
+    auto run = std::make_shared<WarmUpRun>();
+    run->queries = std::move(queries);
+    run->translations = std::move(translations);
+    if (run->translations.empty()) {
+        for (const auto& entry : snapshot()->verses) run->translations.push_back(entry.first);
+    }
+    run->start_time = std::chrono::steady_clock::now();
+    warmup_cancelled = false;
+    warmup_future = run->done.get_future();
+    TaskScheduler::shared().post([this, run]() { runWarmUp(run); }, TaskPriority::BACKGROUND);
+}
+
+void VerseFinder::cancelWarmUp() {
+    warmup_cancelled = true;
+    if (warmup_future.valid()) warmup_future.wait();
+}
+
+void VerseFinder::warmSearch(const std::string& query, const std::string& translation) const {
+    ParsedReference parsed;
+    if (ReferenceParser::parse(query, parsed) && parsed.hasChapter()) {
+        if (parsed.first().wholeChapters()) {
+            searchByChapter(query, translation);
+        } else {
+            searchByReference(query, translation);
+        }
+    } else {
+        searchKeywordIds(query, translation, SearchContext());
+    }
+}
+
+void VerseFinder::runWarmUp(std::shared_ptr<WarmUpRun> run) {
+    // One query per task, so a keystroke never queues behind more than one
+    size_t count = run->queries.size() * run->translations.size();
+    while (run->next < count && !warmup_cancelled) {
+        const std::string& translation = run->translations[run->next / run->queries.size()];
+        const std::string& query = run->queries[run->next % run->queries.size()];
+        ++run->next;
+        // Only what is resident: warming must not load or evict translations
+        if (snapshot()->verses.count(translation) == 0) continue;
+        warmSearch(query, translation);
+        ++run->warmed;
+        if (run->next < count) {
+            TaskScheduler::shared().post([this, run]() { runWarmUp(run); }, TaskPriority::BACKGROUND);
+            return;
         }
     }
-    
-    return search_analytics.getRandomVerse(allVerses);
+    if (!warmup_cancelled) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - run->start_time);
+        std::cout << "Warmed " << run->warmed << " searches in " << elapsed.count() << "ms" << std::endl;
+    }
+    run->done.set_value();
+}
+
+std::vector<std::pair<std::string, uint32_t>> VerseFinder::autoCompleteQueryLog() const {
+    std::vector<std::pair<std::string, uint32_t>> query_log;
+    if (analytics_enabled) {
+        query_log = search_analytics.read([](const SearchAnalytics& analytics) {
+            return analytics.getSuccessfulQueryCounts();
+        });
+    }
+    // The restored history lists the previous session's most searched queries, without counts
+    std::lock_guard<std::mutex> lock(warmup_mutex);
+    for (const std::string& query : restored_queries) {
+        query_log.push_back({query, 1});
+    }
+    return query_log;
+}
+
+bool VerseFinder::saveSearchHistory(const std::string& path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Warning: Could not write search history " << path << std::endl;
+        return false;
+    }
+    for (const std::string& query : warmupQueries()) {
+        if (query.find('\n') == std::string::npos) file << query << '\n';
+    }
+    return file.good();
+}
+
+bool VerseFinder::loadSearchHistory(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+    std::vector<std::string> queries;
+    std::string line;
+    while (queries.size() < WARMUP_QUERY_COUNT && std::getline(file, line)) {
+        if (!line.empty()) queries.push_back(line);
+    }
+    std::lock_guard<std::mutex> lock(warmup_mutex);
+    restored_queries = std::move(queries);
+    return true;
 }
 
 std::vector<std::string> VerseFinder::getPopularVerses(int count) const {
     if (!analytics_enabled) return {};
     
-    return search_analytics.getMostPopularVerses(count);
+    return search_analytics.read([&](const SearchAnalytics& analytics) { return analytics.getMostPopularVerses(count); });
 }
 
-std::vector<std::string> VerseFinder::getTrendingSearches([[maybe_unused]] int days) const {
+std::vector<std::string> VerseFinder::getTrendingSearches(int days) const {
     if (!analytics_enabled) return {};
     
-    return search_analytics.getMostSearchedQueries(10); // Simplified implementation
+    return search_analytics.read([&](const SearchAnalytics& analytics) { return analytics.getTrendingQueries(days); });
 }
 
 std::vector<std::string> VerseFinder::getPersonalizedSuggestions() const {
     if (!analytics_enabled) return {};
     
     // Basic implementation combining recent searches and popular verses
-    auto recent = search_analytics.getRecentSearches(5);
-    auto popular = search_analytics.getMostSearchedQueries(5);
+    auto recent = search_analytics.read([&](const SearchAnalytics& analytics) { return analytics.getRecentSearches(5); });
+    auto popular = search_analytics.read([&](const SearchAnalytics& analytics) { return analytics.getMostSearchedQueries(5); });
     
     std::vector<std::string> suggestions;
     suggestions.insert(suggestions.end(), recent.begin(), recent.end());
@@ -1433,50 +2748,110 @@ std::vector<std::string> VerseFinder::getPersonalizedSuggestions() const {
 std::vector<std::string> VerseFinder::getRecentSearches(int count) const {
     if (!analytics_enabled) return {};
     
-    return search_analytics.getRecentSearches(count);
+    return search_analytics.read([&](const SearchAnalytics& analytics) { return analytics.getRecentSearches(count); });
 }
 
 // Bookmark and collection management
 void VerseFinder::addToFavorites(const std::string& verseKey) {
     if (analytics_enabled) {
-        search_analytics.addToFavorites(verseKey);
+        search_analytics.update([&](SearchAnalytics& analytics) { analytics.addToFavorites(verseKey); });
+        ++scope_version;
     }
 }
 
 void VerseFinder::removeFromFavorites(const std::string& verseKey) {
     if (analytics_enabled) {
-        search_analytics.removeFromFavorites(verseKey);
+        search_analytics.update([&](SearchAnalytics& analytics) { analytics.removeFromFavorites(verseKey); });
+        ++scope_version;
     }
 }
 
 std::vector<std::string> VerseFinder::getFavoriteVerses() const {
     if (!analytics_enabled) return {};
     
-    return search_analytics.getFavoriteVerses();
+    return search_analytics.read([&](const SearchAnalytics& analytics) { return analytics.getFavoriteVerses(); });
 }
 
 bool VerseFinder::isFavorite(const std::string& verseKey) const {
     if (!analytics_enabled) return false;
     
-    return search_analytics.isFavorite(verseKey);
+    return search_analytics.read([&](const SearchAnalytics& analytics) { return analytics.isFavorite(verseKey); });
 }
 
 void VerseFinder::createCollection(const std::string& name, const std::vector<std::string>& verses) {
     if (analytics_enabled) {
-        search_analytics.createCollection(name, verses);
+        search_analytics.update([&](SearchAnalytics& analytics) { analytics.createCollection(name, verses); });
+        ++scope_version;
     }
 }
 
 std::vector<std::string> VerseFinder::getCollection(const std::string& name) const {
     if (!analytics_enabled) return {};
     
-    return search_analytics.getCollection(name);
+    return search_analytics.read([&](const SearchAnalytics& analytics) { return analytics.getCollection(name); });
 }
 
 std::vector<std::string> VerseFinder::getAllCollections() const {
     if (!analytics_enabled) return {};
     
-    return search_analytics.getAllCollections();
+    return search_analytics.read([&](const SearchAnalytics& analytics) { return analytics.getAllCollections(); });
+}
+
+std::shared_ptr<const VerseSet> VerseFinder::scopeVerses(QueryLexer::Scope scope, const std::string& name,
+                                                         const std::string& translation) const {
+    if (scope == QueryLexer::Scope::NONE) return nullptr;
+    
+    // Read both before building so a change meanwhile leaves the entry stale
+    std::string key = std::to_string(static_cast<int>(scope)) + '\n' + QueryLexer::normalize(name) + '\n' + translation;
+    uint64_t generation = search_cache.generation(translation);
+    uint64_t version = scope_version.load();
+    {
+        std::lock_guard<std::mutex> lock(scope_mutex);
+        auto it = scope_cache.find(key);
+        if (it != scope_cache.end() && it->second.generation == generation && it->second.version == version) {
+            return it->second.members;
+        }
+    }
+    
+    std::shared_ptr<const Corpus> current = snapshot();
+    auto store_it = current->verses.find(translation);
+    if (store_it == current->verses.end()) return nullptr;
+    auto members = std::make_shared<VerseSet>(store_it->second->size());
+    
+    if (scope == QueryLexer::Scope::TOPIC) {
+        std::lock_guard<std::mutex> lock(topic_mutex);
+        const PostingList* ids = topic_manager.getTopicVerseIds(name, translation);
+        if (!ids) return nullptr;
+        for (VerseId id : *ids) members->insert(id);
+    } else {
+        // Favorites and collections hold references; each is looked up once here
+        std::vector<std::string> keys;
+        if (scope == QueryLexer::Scope::FAVORITES) {
+            keys = getFavoriteVerses();
+        } else {
+            if (!analytics_enabled) return nullptr;
+            bool found = search_analytics.read([&](const SearchAnalytics& analytics) {
+                for (const std::string& collection : analytics.getAllCollections()) {
+                    if (QueryLexer::normalize(collection) == QueryLexer::normalize(name)) {
+                        keys = analytics.getCollection(collection);
+                        return true;
+                    }
+                }
+                return false;
+            });
+            if (!found) return nullptr;
+        }
+        for (const std::string& reference : keys) {
+            for (VerseId id : findPassage(reference, translation)) members->insert(id);
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(scope_mutex);
+    if (scope_cache.size() >= MAX_SCOPE_ENTRIES) {
+        scope_cache.clear();
+    }
+    scope_cache[key] = {generation, version, members};
+    return members;
 }
 
 // Reading plans and guided discovery
@@ -1509,6 +2884,7 @@ std::vector<std::string> VerseFinder::getGuidedReadingPlan(const std::string& pl
 // Analytics control
 void VerseFinder::enableAnalytics(bool enable) {
     analytics_enabled = enable;
+    ++scope_version;
     std::cout << "Analytics " << (enable ? "enabled" : "disabled") << std::endl;
 }
 
@@ -1525,13 +2901,13 @@ void VerseFinder::recordSearch(const std::string& query, const std::string& quer
 void VerseFinder::recordVerseSelection(const std::string& query, const std::string& verseKey) {
     if (analytics_enabled) {
         search_analytics.recordVerseSelection(query, verseKey);
-        search_analytics.recordVerseAccess(verseKey);
     }
 }
 
 // Topic management methods
 void VerseFinder::enableTopicAnalysis(bool enable) {
-    topic_analysis_enabled = enable;
+    topic_analysis_requested = enable;
+    topic_analysis_enabled = enable && degradation_profile.topic_analysis;
 }
 
 bool VerseFinder::isTopicAnalysisEnabled() const {
@@ -1541,36 +2917,42 @@ bool VerseFinder::isTopicAnalysisEnabled() const {
 std::vector<std::string> VerseFinder::getVersesByTopic(const std::string& topic, int maxResults) const {
     if (!topic_analysis_enabled) return {};
     
+    std::lock_guard<std::mutex> lock(topic_mutex);
     return topic_manager.getVersesByTopic(topic, maxResults);
 }
 
 std::vector<std::string> VerseFinder::getRelatedTopics(const std::string& topic, int maxResults) const {
     if (!topic_analysis_enabled) return {};
     
+    std::lock_guard<std::mutex> lock(topic_mutex);
     return topic_manager.getRelatedTopics(topic, maxResults);
 }
 
 std::vector<TopicSuggestion> VerseFinder::generateTopicSuggestions(const std::string& query) const {
     if (!topic_analysis_enabled) return {};
     
+    std::lock_guard<std::mutex> lock(topic_mutex);
     return topic_manager.generateTopicSuggestions(query);
 }
 
 std::vector<std::string> VerseFinder::getPopularTopics(int count) const {
     if (!topic_analysis_enabled) return {};
     
+    std::lock_guard<std::mutex> lock(topic_mutex);
     return topic_manager.getPopularTopics(count);
 }
 
 std::vector<std::string> VerseFinder::getSeasonalTopicSuggestions() const {
     if (!topic_analysis_enabled) return {};
     
+    std::lock_guard<std::mutex> lock(topic_mutex);
     return topic_manager.getSeasonalSuggestions();
 }
 
 std::string VerseFinder::getTopicalVerseOfTheDay(const std::string& topic) const {
     if (!topic_analysis_enabled) return "John 3:16";
     
+    std::lock_guard<std::mutex> lock(topic_mutex);
     if (topic.empty()) {
         return topic_manager.getVerseOfTheDay("seasonal");
     } else {
@@ -1580,10 +2962,24 @@ std::string VerseFinder::getTopicalVerseOfTheDay(const std::string& topic) const
 
 void VerseFinder::addCustomTopic(const std::string& topicName, const std::vector<std::string>& keywords) {
     if (topic_analysis_enabled) {
-        topic_manager.addCustomTopic(topicName, keywords);
+        {
+            std::lock_guard<std::mutex> lock(topic_mutex);
+            topic_manager.addCustomTopic(topicName, keywords);
+        }
+        // Analyses just the new topic
+        if (isReady()) {
+            std::shared_ptr<const Corpus> current = snapshot();
+            indexTopics(*current);
+        }
     }
 }
 
+void VerseFinder::indexTopics(const Corpus& corpus) {
+    std::lock_guard<std::mutex> lock(topic_mutex);
+    topic_manager.buildTopicIndex(corpus.verses, corpus.keyword_index);
+    ++scope_version;
+}
+
 TopicManager* VerseFinder::getTopicManager() {
     return &topic_manager;
 }
@@ -3,56 +3,55 @@
 #define VERSEFINDER_H
 
 #include <string>
+#include <string_view>
+#include <span>
 #include <vector>
 #include <unordered_map>
 #include <future>
 #include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <list>
+#include <utility>
 #include "nlohmann/json.hpp"
+#include "VerseStore.h"
+#include "InvertedIndex.h"
 #include "SearchCache.h"
+#include "CacheManager.h"
 #include "SearchOptimizer.h"
+#include "SearchContext.h"
 #include "PerformanceBenchmark.h"
 #include "FuzzySearch.h"
 #include "AutoComplete.h"
 #include "SemanticSearch.h"
 #include "CrossReferenceSystem.h"
-#include "SearchAnalytics.h"
+#include "AnalyticsPipeline.h"
 #include "TopicManager.h"
+#include "VectorIndex.h"
+#include "DegradationPolicy.h"
+#include "BookResolver.h"
+#include "ReferenceParser.h"
+#include "VerseAlignment.h"
+#include "Corpus.h"
+#include "DirectoryWatcher.h"
+#include "QueryLexer.h"
+#include "VerseSet.h"
 
 using json = nlohmann::json;
 
-struct Verse {
-    std::string book;
-    int chapter;
-    int verse;
-    std::string text;
-};
-
-struct TranslationInfo {
-    std::string name;
-    std::string abbreviation;
-    std::string description;
-    int year = 0;
-    std::string language;
-    std::string filename;
-    bool is_loaded = false;
-    
-    TranslationInfo() = default;
-    TranslationInfo(const std::string& n, const std::string& abbr, 
-                   const std::string& desc = "", int y = 0, 
-                   const std::string& lang = "", const std::string& file = "")
-        : name(n), abbreviation(abbr), description(desc), year(y), 
-          language(lang), filename(file), is_loaded(false) {}
-};
-
 class VerseFinder {
 private:
-    std::unordered_map<std::string, std::unordered_map<std::string, Verse>> verses;
-    std::unordered_map<std::string, std::unordered_map<std::string, std::vector<std::string>>> keyword_index;
-    std::vector<TranslationInfo> available_translations;
-    std::unordered_map<std::string, std::string> book_aliases;
+    // Only accessed through std::atomic_load / std::atomic_store; see snapshot()
+    std::shared_ptr<const Corpus> corpus;
+    BookResolver book_resolver;
     std::future<void> loading_future;
     std::atomic<bool> data_loaded{false};
     std::string translations_dir;
+    // Reloads translation files as they change; its callback runs on its thread
+    std::mutex watcher_mutex;
+    DirectoryWatcher translations_watcher;
+    std::atomic<bool> watch_translations{true};
     
     // Performance optimization components
     SearchCache search_cache;
@@ -60,57 +59,364 @@ private:
     
     // Fuzzy search component
     FuzzySearch fuzzy_search;
-    bool fuzzy_search_enabled = false;
+    std::atomic<bool> fuzzy_search_enabled{false};
+    bool fuzzy_search_requested = false;
     
     // Auto-complete component
     AutoComplete auto_complete;
     
     // Semantic search component
     SemanticSearch semantic_search;
-    bool semantic_search_enabled = true;
+    std::atomic<bool> semantic_search_enabled{true};
+    bool semantic_search_requested = true;
     
     // Cross-reference system
     CrossReferenceSystem cross_reference_system;
     bool cross_references_enabled = true;
     
     // Search analytics
-    SearchAnalytics search_analytics;
+    AnalyticsPipeline search_analytics;
     bool analytics_enabled = true;
+    // Today's verse, chosen once per day for the UI, API and plugins alike
+    mutable std::mutex verse_of_the_day_mutex;
+    mutable int verse_of_the_day_date = 0; // yyyymmdd it was chosen on
+    mutable std::string verse_of_the_day;
     
-    // Topic management
+    // Topic management; topics are built after startup while searches run
+    mutable std::mutex topic_mutex;
     TopicManager topic_manager;
-    bool topic_analysis_enabled = true;
+    std::atomic<bool> topic_analysis_enabled{true};
+    bool topic_analysis_requested = true;
+    
+    // Favorites, collections and topics as VerseSets per translation, built by
+    // the first search scoped to them. An entry is current while neither its
+    // translation's generation nor scope_version has moved since.
+    struct ScopeEntry {
+        uint64_t generation = 0;
+        uint64_t version = 0;
+        std::shared_ptr<const VerseSet> members;
+    };
+    static constexpr size_t MAX_SCOPE_ENTRIES = 64;
+    mutable std::mutex scope_mutex;
+    mutable std::unordered_map<std::string, ScopeEntry> scope_cache; // by kind, name and translation
+    std::atomic<uint64_t> scope_version{0}; // bumped when favorites, collections or topics change
+    
+    // Load shedding: each *_enabled flag is what was requested and what the
+    // profile still allows; the cache fraction goes to the CacheManager
+    DegradationProfile degradation_profile;
+    // The search cache's share of the CacheManager budget; declared after it so released first
+    CacheManager::Registration search_cache_registration;
+    
+public:
+    // Turns text into a vector in the space of the loaded verse embeddings; false if it cannot.
+    // Called from search threads, possibly several at once.
+    using QueryEmbedder = std::function<bool(const std::string& text, std::vector<float>& embedding)>;
+    
+private:
+    // Vector semantic search, used when embeddings and an embedder are both present
+    mutable std::mutex vector_mutex;
+    QueryEmbedder query_embedder;
+    std::unordered_map<std::string, std::shared_ptr<const VectorIndex>> vector_indexes;
+
+public:
+    static constexpr size_t DEFAULT_RESIDENCY_BUDGET = 256 * 1024 * 1024;
+
+    // Keeps translations resident while searches use them; see acquireTranslation()
+    class TranslationLease {
+    private:
+        VerseFinder* owner = nullptr;
+        std::vector<std::string> translations;
+        std::shared_ptr<const Corpus> pinned; // keeps their data alive across a reload
+
+    public:
+        TranslationLease() = default;
+        TranslationLease(VerseFinder* owner, std::vector<std::string> translations, std::shared_ptr<const Corpus> pinned)
+            : owner(owner), translations(std::move(translations)), pinned(std::move(pinned)) {}
+        TranslationLease(TranslationLease&& other) noexcept
+            : owner(std::exchange(other.owner, nullptr)), translations(std::move(other.translations)),
+              pinned(std::move(other.pinned)) {}
+        TranslationLease& operator=(TranslationLease&& other) noexcept;
+        ~TranslationLease();
+
+        explicit operator bool() const { return owner != nullptr; }
+    };
+
+private:
+    // Everything one translation file yields, read outside any lock
+    struct LoadedTranslation {
+        TranslationInfo info;
+        VerseStore store;
+        InvertedIndex index;
+        MinHashIndex similarity;
+        TrigramIndex trigrams;
+        SubstringIndex substrings; // empty unless substring search is on
+        std::shared_ptr<VectorIndex> vectors;
+    };
+    struct ResidentTranslation {
+        std::string name;
+        size_t bytes;
+    };
+
+    // Translations in a directory are listed from their metadata and read on
+    // first use. Loads build the next Corpus under residency_mutex and publish
+    // it; searches never wait for one, and it never waits for them. Eviction
+    // passes over translations a lease holds.
+    mutable std::mutex residency_mutex;
+    std::unordered_map<std::string, size_t> lease_counts; // by translation
+    std::mutex materialize_mutex; // one batch of translations read at a time
+    std::list<ResidentTranslation> recently_used; // evictable translations, most recent first
+    size_t residency_budget = DEFAULT_RESIDENCY_BUDGET;
+    std::atomic<bool> compress_text{false};
+    std::atomic<bool> substring_search{false};
+    std::atomic<size_t> load_files_done{0};
+    std::atomic<size_t> load_files_total{0};
+
+    // The current corpus; what it holds stays valid for as long as the pointer is kept
+    std::shared_ptr<const Corpus> snapshot() const;
+    // A copy of the current corpus to change; under residency_mutex
+    std::shared_ptr<Corpus> editCorpus() const;
+    // Makes next current and drops cached results for translations it changed; under residency_mutex
+    void publish(std::shared_ptr<Corpus> next);
+    // Analyses the topics of corpus's translations not yet analysed
+    void indexTopics(const Corpus& corpus);
+    // Rebuilds the language indexes whose members or their indexes changed, keeps the rest
+    static void indexLanguages(Corpus& next, const Corpus& previous);
+    void releaseLease(const std::vector<std::string>& translations);
+    bool readTranslation(const std::string& filename, LoadedTranslation& loaded) const;
+    // 1 if listed into info from its snapshot's metadata or the head of its
+    // JSON, 2 if it had to be read in full into loaded, 0 if it cannot be read
+    char listTranslation(const std::string& file_path, TranslationInfo& info, LoadedTranslation& loaded) const;
+    // Reads files on the shared scheduler, so no more run at once than it has
+    // threads; false if any could not be read
+    bool readTranslations(const std::vector<std::string>& files, std::vector<LoadedTranslation>& loaded);
+    // Moves loaded into next; evictable ones can be dropped and read again later
+    void installTranslation(Corpus& next, LoadedTranslation&& loaded, bool evictable);
+    // Installs a translation built in memory unless one of its name is listed already
+    bool addLoadedTranslation(LoadedTranslation&& loaded, bool evictable);
+    void unloadTranslation(Corpus& next, const std::string& name);
+    // Unlists name as well, for a file that no longer holds it
+    void removeTranslation(Corpus& next, const std::string& name);
+    void evictColdTranslations(Corpus& next, const std::vector<std::string>& keep);
+    void touchTranslations(const std::vector<std::string>& names);
 
     void loadBibleInternal(const std::string& filename);
     void loadTranslationsFromDirectory(const std::string& dir_path);
+    void watchTranslations(const std::string& dir_path);
     void loadSingleTranslation(const std::string& filename);
-    void loadSingleTranslationOptimized(const std::string& filename, std::mutex& data_mutex);
-    std::string normalizeReference(const std::string& reference) const;
-    std::string makeKey(const std::string& book, int chapter, int verse) const;
+    bool importTranslationJson(const std::string& filename, TranslationInfo& info,
+                               VerseStore& store, InvertedIndex& index) const;
     static std::vector<std::string> tokenize(const std::string& text);
     
     // Optimized search methods
     std::vector<std::string> searchByKeywordsOptimized(const std::string& query, 
-                                                      const std::string& translation) const;
+                                                      const std::string& translation,
+                                                      const SearchContext& context) const;
+    CachedSearchResult findKeywordMatches(const std::string& query, const std::string& translation,
+                                          const VerseSet* within = nullptr) const;
+    // Verses containing fragment anywhere, from the substring index when the translation has one
+    CachedSearchResult findSubstringMatches(std::string_view fragment, const std::string& translation) const;
+    std::vector<std::string> renderResults(const CachedSearchResult& result, const std::string& translation) const;
+    static void applyResultLimit(CachedSearchResult& result, const SearchContext& context);
+    // Nearest verses to the query's embedding; false when vector search is unavailable for translation
+    bool searchByEmbedding(const std::string& query, const std::string& translation,
+                           const SearchContext& context, std::vector<std::string>& results) const;
+    // Score a parsed query's expanded keywords against the index, term at a time
+    std::vector<std::string> rankSemanticKeywords(const QueryIntent& intent, const std::string& translation,
+                                                  const SearchContext& context) const;
+    static std::vector<VerseId> findChapterVerses(const VerseStore& store, int book_id, int chapter);
+    // reference's book in store, -1 if absent
+    int findBook(const VerseStore& store, const ParsedReference& reference) const;
+    // Appends the positions each of reference's spans covers in store
+    void appendSpanRanges(const VerseStore& store, const ParsedReference& reference,
+                          std::vector<VerseRange>& ranges) const;
+    // Positions references cover, in the order written
+    std::vector<VerseRange> findRanges(const VerseStore& store, const std::vector<ParsedReference>& references) const;
 
 public:
     VerseFinder();
+    ~VerseFinder();
     void startLoading(const std::string& filename);
     void setTranslationsDirectory(const std::string& dir_path);
     void loadAllTranslations();
+    // Follow the translations directory after loading it: files written,
+    // added or removed there are passed to reloadTranslationFiles once they
+    // settle. On by default.
+    void setWatchTranslations(bool enabled);
+    bool isWatchingTranslations();
+    // Brings just these files' translations up to date, in the background of
+    // searches: a changed file is read again if its translation is resident
+    // and listed again if not, a new one is listed, and a removed one's
+    // translation is dropped. They are published together as the next corpus.
+    // A file that cannot be read leaves its translation as it was.
+    void reloadTranslationFiles(const std::vector<std::string>& paths);
     bool isReady() const;
+    // Blocks until the load last started has finished, whether or not it found anything
+    void waitForLoading() const;
+    // Translation files listed or read so far since loading began, out of those found
+    struct LoadProgress {
+        size_t done = 0;
+        size_t total = 0;
+    };
+    LoadProgress getLoadProgress() const;
+    // A verse, or the verses of a range or list joined by spaces ("John 3:16-18",
+    // "Ps 23:1; John 10:11-18")
     std::string searchByReference(const std::string& reference, const std::string& translation) const;
+    // Zero-copy counterparts for callers that format verses themselves: views point
+    // into the verse store and stay valid until the translation is reloaded (see
+    // getTranslationGeneration). findVerse() is a miss (false) when not found.
+    VerseView findVerse(std::string_view reference, const std::string& translation) const;
+    std::vector<VerseView> viewVerses(std::span<const VerseId> ids, const std::string& translation) const;
+    // reference's verse in each translation, lined up across versifications (see
+    // VerseAlignment): one row lookup, then a gather. views[i] is a miss (false)
+    // where translations[i] has no such verse.
+    std::vector<VerseView> findAlignedVerses(std::string_view reference,
+                                             const std::vector<std::string>& translations) const;
     std::vector<std::string> searchByChapter(const std::string& reference, const std::string& translation) const;
-    std::vector<std::string> searchByKeywords(const std::string& query, const std::string& translation) const;
-    std::vector<std::string> searchByFullText(const std::string& query, const std::string& translation) const;
-    const std::vector<TranslationInfo>& getTranslations() const;
+    // Searches take an optional SearchContext to cancel them, bound their time or cap their results
+    std::vector<std::string> searchByKeywords(const std::string& query, const std::string& translation,
+                                              const SearchContext& context = SearchContext()) const;
+    // Words as searchByKeywords matches them; a quoted query, one with punctuation,
+    // or words matching nothing are found as a fragment of the text instead,
+    // even inside words ("\"gotten\"", "-eth")
+    std::vector<std::string> searchByFullText(const std::string& query, const std::string& translation,
+                                              const SearchContext& context = SearchContext()) const;
+    // Verses matching an ECMAScript regex anywhere in their text, ignoring case,
+    // in id order. The literals every match needs are looked up in the index
+    // first (see RegexPrefilter), so only the verses holding them are matched,
+    // in parallel shards; a pattern without any reads every verse.
+    std::vector<std::string> searchRegex(const std::string& pattern, const std::string& translation,
+                                         const SearchContext& context = SearchContext()) const;
+    // The same as ids, with each verse's matches as spans; message says why a pattern is invalid
+    CachedSearchResult searchRegexIds(const std::string& pattern, const std::string& translation,
+                                      const SearchContext& context = SearchContext(),
+                                      bool case_sensitive = false) const;
+    // Keyword search over every resident translation of a language at once, one
+    // result per verse in canonical order, tagged with the translations that match
+    // ("Ref [KJV, ASV]: text"). Exact words only; a language with a single
+    // resident translation is searched as that translation.
+    std::vector<std::string> searchLanguage(const std::string& query, const std::string& language,
+                                            const SearchContext& context = SearchContext()) const;
+    // One verse of a search over several translations: its row in the English
+    // versification (NO_ROW for verses without one, which are never merged), the
+    // translation whose wording ranked it highest with that translation's verse
+    // and matched words, and every translation that matched it, in search order
+    struct AlignedMatch {
+        uint32_t row = VerseAlignment::NO_ROW;
+        std::string translation;
+        VerseId id = INVALID_VERSE_ID;
+        float score = 0.0f;
+        std::vector<MatchSpan> spans;
+        std::vector<std::string> translations;
+    };
+    // Keyword search over every resident translation at once, whatever its
+    // language: each is searched in parallel (cached as a search of it alone),
+    // hits are merged by row, and one ranked list comes back. A verse's score is
+    // the best of its per-translation scores, each taken relative to that
+    // translation's top hit, plus up to AGREEMENT_BONUS for the share of the
+    // other translations that also matched it.
+    std::vector<AlignedMatch> searchAllTranslationIds(const std::string& query,
+                                                      const SearchContext& context = SearchContext()) const;
+    // Rendered as searchLanguage does: "Ref [KJV, ASV]: text"
+    std::vector<std::string> searchAllTranslations(const std::string& query,
+                                                   const SearchContext& context = SearchContext()) const;
+    std::string formatAlignedMatch(const AlignedMatch& match) const;
+    // Every translation found, resident or only listed (is_loaded false)
+    std::vector<TranslationInfo> getTranslations() const;
+    // Read the translations in if they are only listed, evicting the least recently
+    // used ones beyond the residency budget, and keep them resident until the lease
+    // is released. Each search reads one version of the corpus throughout, so
+    // loads never stop it; VerseStore pointers and views handed out stay valid
+    // only under a lease. The lease is false if a translation is unknown or cannot
+    // be read.
+    TranslationLease acquireTranslation(const std::string& translation);
+    TranslationLease acquireTranslations(const std::vector<std::string>& translations);
+    bool isTranslationResident(const std::string& translation) const;
+    // Bytes of evictable translations to keep resident; applies from the next load
+    void setResidencyBudget(size_t bytes);
+    size_t getResidencyBudget() const;
+    // Keep the text of translations read from now on compressed (see
+    // VerseStore::compressText): a few microseconds per verse shown for
+    // less memory, on kiosks and small boards
+    void setCompressedText(bool enabled);
+    bool isCompressedText() const;
+    // Give translations read from now on a substring index (see SubstringIndex),
+    // built on first import and kept in the snapshot: full-text and boolean
+    // searches then find any fragment without reading verse text, for about
+    // five bytes per byte of text
+    void setSubstringSearch(bool enabled);
+    bool isSubstringSearch() const;
+    size_t getResidentBytes() const;
+    
+    // One search method over several translations at once; results come back in the order given
+    using SearchMethod = std::vector<std::string> (VerseFinder::*)(const std::string&, const std::string&,
+                                                                   const SearchContext&) const;
+    std::vector<std::vector<std::string>> searchTranslations(SearchMethod method, const std::string& query,
+                                                              const std::vector<std::string>& translations,
+                                                              const SearchContext& context = SearchContext()) const;
+    
+    // Id-level lookups for callers that render verses themselves (e.g. the batch API)
+    // Anything ReferenceParser::parseList accepts ("Book C:V-V", "Book C; Book C:V, V"), in the order written
+    std::vector<VerseId> findPassage(const std::string& reference, const std::string& translation) const;
+    // The same passage as runs of canonical positions, one per span: "Romans 8:28-39"
+    // is one, "Ps 23; John 10:11-18" two. Read them with VerseStore::atPosition;
+    // each costs a bounds computation, not a lookup per verse.
+    std::vector<VerseRange> findPassageRanges(const std::string& reference, const std::string& translation) const;
+    CachedSearchResult searchKeywordIds(const std::string& query, const std::string& translation,
+                                        const SearchContext& context = SearchContext()) const;
+    // Called for each match in result order with its score (1 for unranked searches) and
+    // the bytes of its text the query's words matched; return false to stop
+    using MatchCallback = std::function<bool(VerseId id, float score, std::span<const MatchSpan> spans)>;
+    // Streams the context's page of keyword matches without rendering them; returns how many were visited
+    size_t streamKeywordMatches(const std::string& query, const std::string& translation,
+                                const MatchCallback& on_match, const SearchContext& context = SearchContext()) const;
+    // As-you-type matching: a trailing partial word matches as a prefix; ids are sorted.
+    // within, if given, restricts matches to a previous result this query refines.
+    CachedSearchResult searchKeywordPrefixIds(const std::string& query, const std::string& translation,
+                                              const std::vector<VerseId>* within = nullptr,
+                                              const SearchContext& context = SearchContext()) const;
+    // Changes whenever the translation is reloaded, invalidating ids kept by callers
+    uint64_t getTranslationGeneration(const std::string& translation) const;
+    const VerseStore* getVerseStore(const std::string& translation) const;
     void addTranslation(const std::string& json_data);
+    
+    // Import path for translation formats other than JSON: verses go
+    // straight into the verse store and index as the caller parses them, and
+    // commit() installs the translation. When info.filename names the source
+    // file, a snapshot is written beside it, so later starts map it without
+    // the importer.
+    class TranslationBuilder {
+    private:
+        VerseFinder* owner;
+        LoadedTranslation loaded;
+        std::string last_book; // as given, and normalized, since books arrive in runs
+        std::string last_book_normalized;
+        size_t verse_count = 0;
+        bool committed = false;
+        
+    public:
+        TranslationBuilder(VerseFinder* owner, TranslationInfo info);
+        
+        void reserve(size_t verses, size_t text_bytes) { loaded.store.reserve(verses, text_bytes); }
+        // Verses may come in any order; false for a reference already added
+        bool addVerse(const std::string& book, int chapter, int verse, std::string_view text);
+        size_t getVerseCount() const { return verse_count; }
+        // False if nothing was added or a translation of this name exists
+        bool commit();
+    };
+    std::unique_ptr<TranslationBuilder> beginTranslation(const TranslationInfo& info);
     bool saveTranslation(const std::string& json_data, const std::string& filename);
     bool loadTranslationFromFile(const std::string& filename); // Public wrapper for file loading
     
     // Public utility methods for UI
+    // The first chapter and verse of reference (-1 if absent), through ReferenceParser
     bool parseReference(const std::string& reference, std::string& book, int& chapter, int& verse) const;
-    std::string normalizeBookName(const std::string& book) const;
+    // book views into reference
+    bool parseReference(std::string_view reference, std::string_view& book, int& chapter, int& verse) const;
+    // The name translations key book by: canonical for the 66 books and their
+    // abbreviations, else a user alias or a translation's own name
+    std::string normalizeBookName(std::string_view book) const;
+    // ContentSettings::customBookAliases, alias -> book
+    void setBookAliases(const std::unordered_map<std::string, std::string>& aliases);
     
     // Navigation helper methods
     std::string getAdjacentVerse(const std::string& reference, const std::string& translation, int direction) const;
@@ -120,6 +426,10 @@ public:
     
     // Performance and caching methods
     void clearSearchCache();
+    // Shed or restore optional work (fuzzy, semantic, topic analysis, cache size)
+    // without losing what was enabled; reference lookup is never affected
+    void applyDegradationProfile(const DegradationProfile& profile);
+    const DegradationProfile& getDegradationProfile() const;
     void setBenchmark(PerformanceBenchmark* bench);
     PerformanceBenchmark* getBenchmark() const;
     void printPerformanceStats() const;
@@ -130,7 +440,8 @@ public:
     void setFuzzySearchOptions(const FuzzySearchOptions& options);
     const FuzzySearchOptions& getFuzzySearchOptions() const;
     
-    std::vector<std::string> searchByKeywordsFuzzy(const std::string& query, const std::string& translation) const;
+    std::vector<std::string> searchByKeywordsFuzzy(const std::string& query, const std::string& translation,
+                                                   const SearchContext& context = SearchContext()) const;
     std::vector<FuzzyMatch> findBookNameSuggestions(const std::string& query) const;
     std::vector<std::string> generateQuerySuggestions(const std::string& query, const std::string& translation) const;
     
@@ -140,21 +451,44 @@ public:
     void updateAutoCompleteFrequency(const std::string& query);
     void clearAutoCompleteCache();
     
+    // Speculative search: runs the top SPECULATIVE_QUERIES suggestions for
+    // what the operator is typing as PREFETCH tasks, so the search cache holds
+    // their results by the time one is accepted. Each call supersedes the
+    // last; predictions not yet started when the input moves on are dropped.
+    static constexpr size_t SPECULATIVE_QUERIES = 2;
+    void speculate(const std::string& input, const std::string& translation);
+    void cancelSpeculation();  // Returns once no speculative search is running
+    
     // Semantic search methods
-    std::vector<std::string> searchSemantic(const std::string& query, const std::string& translation) const;
-    std::vector<std::string> searchByTopic(const std::string& topic, const std::string& translation) const;
-    std::vector<std::string> answerQuestion(const std::string& question, const std::string& translation) const;
-    std::vector<std::string> searchBoolean(const std::string& query, const std::string& translation) const;
+    std::vector<std::string> searchSemantic(const std::string& query, const std::string& translation,
+                                            const SearchContext& context = SearchContext()) const;
+    std::vector<std::string> searchByTopic(const std::string& topic, const std::string& translation,
+                                           const SearchContext& context = SearchContext()) const;
+    std::vector<std::string> answerQuestion(const std::string& question, const std::string& translation,
+                                            const SearchContext& context = SearchContext()) const;
+    std::vector<std::string> searchBoolean(const std::string& query, const std::string& translation,
+                                           const SearchContext& context = SearchContext()) const;
     std::vector<std::string> getTopicalSuggestions(const std::string& input) const;
     std::vector<std::string> getContextualSuggestions(const std::string& situation) const;
     std::vector<std::string> getRelatedTopics(const std::string& topic) const;
     QueryIntent parseNaturalLanguage(const std::string& query) const;
     void enableSemanticSearch(bool enable);
     bool isSemanticSearchEnabled() const;
+    // Embeddings are picked up from "<translation>.vfemb" side files on load, or attached here
+    bool loadEmbeddings(const std::string& translation, const std::string& embeddings_path);
+    void setQueryEmbedder(QueryEmbedder embedder);
+    bool hasVectorSearch(const std::string& translation) const;
     
     // Cross-reference methods
     std::vector<std::string> findCrossReferences(const std::string& verseKey) const;
     std::vector<std::string> findParallelPassages(const std::string& verseKey) const;
+    // Clusters of near-identical verses across books, e.g. the Gospels' shared passages
+    std::vector<ParallelPassage> findParallelPassageGroups(const std::vector<std::string>& books,
+                                                           const std::string& translation) const;
+    // Two links away, as "Book C:V [via Book C:V]", strongest chain first
+    std::vector<std::string> findIndirectCrossReferences(const std::string& verseKey, size_t maxResults = 20) const;
+    // Add links from a JSON export such as a Treasury of Scripture Knowledge conversion
+    bool loadCrossReferences(const std::string& path);
     std::vector<std::string> expandVerseContext(const std::string& verseKey, int contextSize = 2) const;
     void enableCrossReferences(bool enable);
     bool areCrossReferencesEnabled() const;
@@ -167,7 +501,24 @@ public:
     std::vector<std::string> getPersonalizedSuggestions() const;
     std::vector<std::string> getRecentSearches(int count = 10) const;
     
-    // Bookmark and collection management
+    // Cache warm-up, so the first searches of a service hit warm caches and
+    // resident pages. warmUp() replays the most searched queries (this
+    // session's, then those restored by loadSearchHistory()) and extra_queries,
+    // such as a service plan's references, against translations (empty: every
+    // resident one) as BACKGROUND tasks on the shared TaskScheduler, one query
+    // per task. References are looked up; anything else runs a keyword search,
+    // which the search cache keeps. Nothing is recorded in the analytics.
+    // Call once translations are loaded; a new call replaces a running warm-up.
+    static constexpr size_t WARMUP_QUERY_COUNT = 32;
+    void warmUp(std::vector<std::string> extra_queries = {}, std::vector<std::string> translations = {});
+    void cancelWarmUp();
+    // The most searched queries, one per line, for the next session's warm-up
+    bool saveSearchHistory(const std::string& path) const;
+    bool loadSearchHistory(const std::string& path);
+    
+    // Bookmark and collection management. Keyword and boolean searches can be
+    // limited to these (or to a topic) by ending the query with "within favorites",
+    // "within collection: <name>" or "within topic: <name>".
     void addToFavorites(const std::string& verseKey);
     void removeFromFavorites(const std::string& verseKey);
     std::vector<std::string> getFavoriteVerses() const;
@@ -175,6 +526,10 @@ public:
     void createCollection(const std::string& name, const std::vector<std::string>& verses);
     std::vector<std::string> getCollection(const std::string& name) const;
     std::vector<std::string> getAllCollections() const;
+    // The verses of a scope in translation, names matched in any case; null if
+    // there is no such collection or topic there
+    std::shared_ptr<const VerseSet> scopeVerses(QueryLexer::Scope scope, const std::string& name,
+                                                const std::string& translation) const;
     
     // Reading plans and guided discovery
     std::vector<std::string> generateReadingPlan(const std::string& theme) const;
@@ -197,6 +552,31 @@ public:
     std::string getTopicalVerseOfTheDay(const std::string& topic = "") const;
     void addCustomTopic(const std::string& topicName, const std::vector<std::string>& keywords);
     TopicManager* getTopicManager();
+
+private:
+    mutable std::mutex warmup_mutex;
+    std::vector<std::string> restored_queries; // from loadSearchHistory()
+    std::future<void> warmup_future;
+    std::atomic<bool> warmup_cancelled{false};
+    std::atomic<uint64_t> speculation_generation{0};
+    std::atomic<size_t> speculations_pending{0};  // posted and not yet finished
+
+    // A warm-up in progress, carried from one task to the next
+    struct WarmUpRun {
+        std::vector<std::string> queries;
+        std::vector<std::string> translations;
+        size_t next = 0;  // translation-major index of the next query
+        size_t warmed = 0;
+        std::chrono::steady_clock::time_point start_time;
+        std::promise<void> done;
+    };
+
+    std::vector<std::string> warmupQueries() const;
+    // Runs query the way the search bar would, for its caching side effects
+    void warmSearch(const std::string& query, const std::string& translation) const;
+    void runWarmUp(std::shared_ptr<WarmUpRun> run);
+    // Successful searches so far plus the restored history, for ranking completions
+    std::vector<std::pair<std::string, uint32_t>> autoCompleteQueryLog() const;
 };
 
 #endif //VERSEFINDER_H
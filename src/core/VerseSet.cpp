@@ -0,0 +1,57 @@
+#include "VerseSet.h"
+#include <bit>
+
+VerseSet::VerseSet(size_t verse_count) : words((verse_count + 63) / 64, 0), verse_count(verse_count) {}
+
+VerseSet VerseSet::fromIds(std::span<const VerseId> ids, size_t verse_count) {
+    VerseSet set(verse_count);
+    for (VerseId id : ids) set.insert(id);
+    return set;
+}
+
+void VerseSet::insert(VerseId id) {
+    if (id >= verse_count) return;
+    uint64_t& word = words[id >> 6];
+    const uint64_t bit = uint64_t(1) << (id & 63);
+    member_count += (word & bit) == 0;
+    word |= bit;
+}
+
+void VerseSet::intersectWith(const VerseSet& other) {
+    member_count = 0;
+    for (size_t i = 0; i < words.size(); ++i) {
+        words[i] &= i < other.words.size() ? other.words[i] : 0;
+        member_count += static_cast<size_t>(std::popcount(words[i]));
+    }
+}
+
+PostingList VerseSet::ids() const {
+    PostingList members;
+    members.reserve(member_count);
+    for (size_t word = 0; word < words.size(); ++word) {
+        for (uint64_t bits = words[word]; bits; bits &= bits - 1) {
+            members.push_back(static_cast<VerseId>(word * 64 + std::countr_zero(bits)));
+        }
+    }
+    return members;
+}
+
+size_t VerseSet::filter(const VerseId* ids, size_t count, VerseId* out) const {
+    // Writes never pass reads; every id is written and kept only if a member,
+    // so the loop has no branch on membership
+    size_t written = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const VerseId id = ids[i];
+        out[written] = id;
+        written += contains(id);
+    }
+    return written;
+}
+
+PostingList VerseSet::filter(const PostingList& ids) const {
+    if (member_count == 0) return {};
+    // filter() writes every candidate before deciding, so the buffer takes them all
+    PostingList members(ids.size());
+    members.resize(filter(ids.data(), ids.size(), members.data()));
+    return members;
+}
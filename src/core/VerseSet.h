@@ -0,0 +1,48 @@
+#ifndef VERSESET_H
+#define VERSESET_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "InvertedIndex.h"
+
+// A set of one translation's verses as a bitmap over their ids: a bit each,
+// under 4 KB for a whole Bible whatever the set holds. Membership is one bit
+// test, so a search restricted to favorites, a collection or a topic checks
+// its candidates against the set as they are gathered instead of filtering
+// the formatted results afterwards.
+class VerseSet {
+private:
+    std::vector<uint64_t> words;
+    size_t verse_count = 0;
+    size_t member_count = 0;
+
+public:
+    VerseSet() = default;
+    // Empty, over the ids [0, verse_count)
+    explicit VerseSet(size_t verse_count);
+    // ids outside [0, verse_count) are left out
+    static VerseSet fromIds(std::span<const VerseId> ids, size_t verse_count);
+
+    void insert(VerseId id);
+    bool contains(VerseId id) const {
+        return id < verse_count && ((words[id >> 6] >> (id & 63)) & 1);
+    }
+    // Keeps only the verses also in other, which covers the same translation
+    void intersectWith(const VerseSet& other);
+
+    size_t size() const { return member_count; }
+    bool empty() const { return member_count == 0; }
+    // How many ids the set is over
+    size_t universe() const { return verse_count; }
+
+    // The members, sorted
+    PostingList ids() const;
+    // The members of sorted ids, in order; out may be ids.data(). Returns how many.
+    size_t filter(const VerseId* ids, size_t count, VerseId* out) const;
+    PostingList filter(const PostingList& ids) const;
+
+    size_t getMemoryUsage() const { return words.capacity() * sizeof(uint64_t); }
+};
+
+#endif // VERSESET_H
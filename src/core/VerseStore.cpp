@@ -0,0 +1,503 @@
+#include "VerseStore.h"
+#include "MappedFile.h"
+#include "TextSymbolTable.h"
+#include "TextFolding.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <numeric>
+
+VerseStore::VerseStore() {
+    refreshViews();
+}
+
+VerseStore::VerseStore(const VerseStore& other)
+    : book_names(other.book_names), book_lookup(other.book_lookup),
+      book_column(other.book_column), chapter_column(other.chapter_column),
+      verse_column(other.verse_column), text_blob(other.text_blob),
+      text_offsets(other.text_offsets), book_view(other.book_view),
+      chapter_view(other.chapter_view), verse_view(other.verse_view),
+      offsets_view(other.offsets_view), text_view(other.text_view),
+      mapping(other.mapping), symbols(other.symbols), ref_index(other.ref_index), navigation(other.navigation),
+      words(other.words) {
+    refreshOwnedViews();
+}
+
+VerseStore::VerseStore(VerseStore&& other) noexcept
+    : book_names(std::move(other.book_names)), book_lookup(std::move(other.book_lookup)),
+      book_column(std::move(other.book_column)), chapter_column(std::move(other.chapter_column)),
+      verse_column(std::move(other.verse_column)), text_blob(std::move(other.text_blob)),
+      text_offsets(std::move(other.text_offsets)), book_view(other.book_view),
+      chapter_view(other.chapter_view), verse_view(other.verse_view),
+      offsets_view(other.offsets_view), text_view(other.text_view),
+      mapping(std::move(other.mapping)), symbols(std::move(other.symbols)), ref_index(std::move(other.ref_index)),
+      navigation(std::move(other.navigation)), words(std::move(other.words)) {
+    // Owned string storage may move (small-buffer), so always re-point owned views
+    refreshOwnedViews();
+    other.clear();
+}
+
+VerseStore& VerseStore::operator=(const VerseStore& other) {
+    if (this != &other) {
+        VerseStore copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+VerseStore& VerseStore::operator=(VerseStore&& other) noexcept {
+    if (this != &other) {
+        book_names = std::move(other.book_names);
+        book_lookup = std::move(other.book_lookup);
+        book_column = std::move(other.book_column);
+        chapter_column = std::move(other.chapter_column);
+        verse_column = std::move(other.verse_column);
+        text_blob = std::move(other.text_blob);
+        text_offsets = std::move(other.text_offsets);
+        book_view = other.book_view;
+        chapter_view = other.chapter_view;
+        verse_view = other.verse_view;
+        offsets_view = other.offsets_view;
+        text_view = other.text_view;
+        mapping = std::move(other.mapping);
+        symbols = std::move(other.symbols);
+        ref_index = std::move(other.ref_index);
+        navigation = std::move(other.navigation);
+        words = std::move(other.words);
+        refreshOwnedViews();
+        other.clear();
+    }
+    return *this;
+}
+
+void VerseStore::refreshViews() {
+    book_view = book_column;
+    chapter_view = chapter_column;
+    verse_view = verse_column;
+    offsets_view = text_offsets;
+    text_view = text_blob;
+}
+
+void VerseStore::refreshOwnedViews() {
+    if (!mapping) {
+        refreshViews();
+    } else if (symbols) {
+        // Mapped columns with the compressed text held here
+        offsets_view = text_offsets;
+        text_view = text_blob;
+    }
+}
+
+void VerseStore::materialize() {
+    if (symbols) {
+        TaggedString<MemoryTag::VERSE_STORE> expanded;
+        Column<uint32_t> expanded_offsets{0};
+        expanded_offsets.reserve(size() + 1);
+        for (VerseId id = 0; id < size(); ++id) {
+            expanded += text(id);
+            expanded_offsets.push_back(static_cast<uint32_t>(expanded.size()));
+        }
+        text_blob = std::move(expanded);
+        text_offsets = std::move(expanded_offsets);
+        symbols.reset();
+        offsets_view = text_offsets;
+        text_view = text_blob;
+    }
+    if (!mapping) return;
+
+    book_column.assign(book_view.begin(), book_view.end());
+    chapter_column.assign(chapter_view.begin(), chapter_view.end());
+    verse_column.assign(verse_view.begin(), verse_view.end());
+    if (offsets_view.data() != text_offsets.data()) {
+        text_offsets.assign(offsets_view.begin(), offsets_view.end());
+        text_blob.assign(text_view.data(), text_view.size());
+    }
+    mapping.reset();
+    refreshViews();
+}
+
+uint16_t VerseStore::internBook(const std::string& book) {
+    auto it = book_lookup.find(book);
+    if (it != book_lookup.end()) {
+        return it->second;
+    }
+
+    uint16_t id = static_cast<uint16_t>(book_names.size());
+    book_names.push_back(book);
+    book_lookup.emplace(book, id);
+    return id;
+}
+
+VerseId VerseStore::addVerse(const std::string& book, int chapter, int verse, std::string_view text) {
+    materialize();
+    uint16_t book_id = internBook(book);
+    uint32_t ref = VerseRef::pack(book_id, chapter, verse);
+
+    VerseId id = static_cast<VerseId>(book_column.size());
+    if (!ref_index.emplace(ref, id).second) {
+        return INVALID_VERSE_ID; // Duplicate reference, keep the first occurrence
+    }
+
+    book_column.push_back(book_id);
+    chapter_column.push_back(static_cast<uint16_t>(chapter));
+    verse_column.push_back(static_cast<uint16_t>(verse));
+
+    text_blob.append(text.data(), text.size());
+    text_offsets.push_back(static_cast<uint32_t>(text_blob.size()));
+    refreshViews();
+
+    // Navigation tables are stale until the next finalize()
+    if (!navigation.book_ranges.empty()) navigation = Navigation();
+
+    return id;
+}
+
+void VerseStore::reserve(size_t verse_count, size_t text_bytes) {
+    materialize();
+    book_column.reserve(verse_count);
+    chapter_column.reserve(verse_count);
+    verse_column.reserve(verse_count);
+    text_offsets.reserve(verse_count + 1);
+    ref_index.reserve(verse_count);
+    text_blob.reserve(text_bytes);
+    refreshViews();
+}
+
+void VerseStore::clear() {
+    book_names.clear();
+    book_lookup.clear();
+    book_column.clear();
+    chapter_column.clear();
+    verse_column.clear();
+    text_blob.clear();
+    text_offsets.assign(1, 0);
+    ref_index.clear();
+    navigation = Navigation();
+    words = Words();
+    mapping.reset();
+    symbols.reset();
+    refreshViews();
+}
+
+void VerseStore::finalize() {
+    size_t count = size();
+    navigation = Navigation();
+
+    auto key = [this](VerseId id) {
+        return VerseRef::pack(book_view[id], chapter_view[id], verse_view[id]);
+    };
+
+    // Only out-of-order files pay for a permutation
+    bool ordered = true;
+    for (VerseId id = 1; id < count && ordered; ++id) {
+        ordered = key(id - 1) < key(id);
+    }
+    if (!ordered) {
+        navigation.order.resize(count);
+        std::iota(navigation.order.begin(), navigation.order.end(), VerseId{0});
+        std::stable_sort(navigation.order.begin(), navigation.order.end(),
+                         [&key](VerseId a, VerseId b) { return key(a) < key(b); });
+        navigation.position.resize(count);
+        for (uint32_t pos = 0; pos < count; ++pos) {
+            navigation.position[navigation.order[pos]] = pos;
+        }
+    }
+
+    // One slot per chapter number up to each book's highest chapter
+    size_t book_count = book_names.size();
+    std::vector<uint32_t> max_chapter(book_count, 0);
+    for (VerseId id = 0; id < count; ++id) {
+        max_chapter[book_view[id]] = std::max<uint32_t>(max_chapter[book_view[id]], chapter_view[id]);
+    }
+    navigation.chapter_begin.assign(book_count + 1, 0);
+    for (size_t book = 0; book < book_count; ++book) {
+        navigation.chapter_begin[book + 1] = navigation.chapter_begin[book] + max_chapter[book] + 1;
+    }
+    navigation.chapters.assign(navigation.chapter_begin[book_count], VerseRange{});
+    navigation.book_ranges.assign(book_count, VerseRange{});
+
+    // Sorted order makes every chapter and book a contiguous run of positions
+    for (uint32_t pos = 0; pos < count; ++pos) {
+        VerseId id = atPosition(pos);
+        VerseRange& chapter_range = navigation.chapters[navigation.chapter_begin[book_view[id]] + chapter_view[id]];
+        VerseRange& book_range = navigation.book_ranges[book_view[id]];
+        if (chapter_range.empty()) chapter_range.first = pos;
+        chapter_range.last = pos + 1;
+        if (book_range.empty()) book_range.first = pos;
+        book_range.last = pos + 1;
+    }
+    tokenize();
+}
+
+void VerseStore::tokenize() {
+    TermDictionary& dictionary = TermDictionary::shared();
+    words = Words();
+    words.begin.reserve(size() + 1);
+    words.begin.push_back(0);
+    for (VerseId id = 0; id < size(); ++id) {
+        TextFolding::forEachWordSpan(text(id), [&](std::string_view word, size_t begin, size_t end) {
+            words.terms.push_back(dictionary.internId(word));
+            words.starts.push_back(static_cast<uint16_t>(std::min<size_t>(begin, UINT16_MAX)));
+            words.lengths.push_back(static_cast<uint8_t>(std::min<size_t>(end - begin, UINT8_MAX)));
+        });
+        words.begin.push_back(static_cast<uint32_t>(words.terms.size()));
+    }
+    words.terms.shrink_to_fit();
+    words.starts.shrink_to_fit();
+    words.lengths.shrink_to_fit();
+}
+
+std::span<const TermId> VerseStore::terms(VerseId id) const {
+    if (static_cast<size_t>(id) + 1 >= words.begin.size()) return {};
+    return std::span<const TermId>(words.terms.data() + words.begin[id], words.begin[id + 1] - words.begin[id]);
+}
+
+std::pair<size_t, size_t> VerseStore::wordSpan(VerseId id, size_t index) const {
+    size_t word = words.begin[id] + index;
+    return {words.starts[word], size_t(words.starts[word]) + words.lengths[word]};
+}
+
+bool VerseStore::containsPhrase(VerseId id, std::span<const TermId> phrase) const {
+    std::span<const TermId> verse = terms(id);
+    return !phrase.empty() && std::search(verse.begin(), verse.end(), phrase.begin(), phrase.end()) != verse.end();
+}
+
+bool VerseStore::attach(std::shared_ptr<const MappedFile> file, std::vector<std::string> books,
+                        std::span<const uint16_t> books_col, std::span<const uint16_t> chapters_col,
+                        std::span<const uint16_t> verses_col, std::span<const uint32_t> offsets,
+                        std::string_view text) {
+    size_t count = books_col.size();
+    if (chapters_col.size() != count || verses_col.size() != count || offsets.size() != count + 1 ||
+        offsets[0] != 0 || offsets[count] != text.size() || books.size() > 0xFFFF) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (books_col[i] >= books.size() || offsets[i] > offsets[i + 1]) return false;
+    }
+
+    clear();
+    book_names = std::move(books);
+    for (size_t i = 0; i < book_names.size(); ++i) {
+        book_lookup.emplace(book_names[i], static_cast<uint16_t>(i));
+    }
+
+    mapping = std::move(file);
+    book_view = books_col;
+    chapter_view = chapters_col;
+    verse_view = verses_col;
+    offsets_view = offsets;
+    text_view = text;
+
+    // Reference lookup is rebuilt from the columns; it is small next to the text
+    ref_index.reserve(count);
+    for (VerseId id = 0; id < count; ++id) {
+        ref_index.emplace(VerseRef::pack(book_view[id], chapter_view[id], verse_view[id]), id);
+    }
+    finalize();
+    return true;
+}
+
+int VerseStore::findBook(const std::string& book) const {
+    auto it = book_lookup.find(book);
+    return it != book_lookup.end() ? it->second : -1;
+}
+
+VerseId VerseStore::find(int book_id, int chapter, int verse) const {
+    if (book_id < 0 || chapter < 0 || verse < 0) return INVALID_VERSE_ID;
+
+    auto it = ref_index.find(VerseRef::pack(book_id, chapter, verse));
+    return it != ref_index.end() ? it->second : INVALID_VERSE_ID;
+}
+
+VerseId VerseStore::find(const std::string& book, int chapter, int verse) const {
+    return find(findBook(book), chapter, verse);
+}
+
+VerseRange VerseStore::chapterRange(int book_id, int chapter) const {
+    if (book_id < 0 || static_cast<size_t>(book_id) >= navigation.book_ranges.size() || chapter < 0) {
+        return {};
+    }
+    uint32_t slot = navigation.chapter_begin[book_id] + static_cast<uint32_t>(chapter);
+    return slot < navigation.chapter_begin[book_id + 1] ? navigation.chapters[slot] : VerseRange{};
+}
+
+VerseRange VerseStore::bookRange(int book_id) const {
+    if (book_id < 0 || static_cast<size_t>(book_id) >= navigation.book_ranges.size()) {
+        return {};
+    }
+    return navigation.book_ranges[book_id];
+}
+
+int VerseStore::lastChapter(int book_id) const {
+    VerseRange range = bookRange(book_id);
+    return range.empty() ? 0 : chapter(atPosition(range.last - 1));
+}
+
+VerseRange VerseStore::spanRange(int book_id, int chapter, int verse, int end_chapter, int end_verse) const {
+    VerseRange book = bookRange(book_id);
+    if (book.empty()) return {};
+    int last_chapter = lastChapter(book_id);
+
+    // First position at chapter:target_verse, or past it
+    auto boundary = [&](int target_chapter, int target_verse, bool past) -> uint32_t {
+        VerseRange range = chapterRange(book_id, target_chapter);
+        if (range.empty()) {
+            // A chapter the book skips, or one before or past its ends
+            for (int next = std::max(target_chapter + 1, 0); next <= last_chapter; ++next) {
+                VerseRange next_range = chapterRange(book_id, next);
+                if (!next_range.empty()) return next_range.first;
+            }
+            return book.last;
+        }
+        uint32_t low = range.first;
+        uint32_t high = range.last;
+        while (low < high) {
+            uint32_t mid = low + (high - low) / 2;
+            int number = verseNumber(atPosition(mid));
+            if (past ? number <= target_verse : number < target_verse) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    };
+
+    uint32_t first = boundary(chapter, std::max(verse, 0), false);
+    uint32_t last = end_verse < 0 ? boundary(end_chapter + 1, 0, false) : boundary(end_chapter, end_verse, true);
+    return {first, std::max(first, last)};
+}
+
+VerseId VerseStore::findByReference(const std::string& reference) const {
+    size_t space_pos = reference.find_last_of(' ');
+    if (space_pos == std::string::npos) return INVALID_VERSE_ID;
+
+    size_t colon_pos = reference.find(':', space_pos);
+    if (colon_pos == std::string::npos || colon_pos == space_pos + 1 ||
+        colon_pos + 1 == reference.size()) {
+        return INVALID_VERSE_ID;
+    }
+
+    int book_id = findBook(reference.substr(0, space_pos));
+    if (book_id < 0) return INVALID_VERSE_ID;
+
+    int chapter = 0;
+    int verse = 0;
+    for (size_t i = space_pos + 1; i < colon_pos; ++i) {
+        if (reference[i] < '0' || reference[i] > '9') return INVALID_VERSE_ID;
+        chapter = chapter * 10 + (reference[i] - '0');
+    }
+    for (size_t i = colon_pos + 1; i < reference.size(); ++i) {
+        if (reference[i] < '0' || reference[i] > '9') return INVALID_VERSE_ID;
+        verse = verse * 10 + (reference[i] - '0');
+    }
+
+    return find(book_id, chapter, verse);
+}
+
+std::string_view VerseStore::text(VerseId id) const {
+    uint32_t begin = offsets_view[id];
+    uint32_t end = offsets_view[id + 1];
+    if (!symbols) return text_view.substr(begin, end - begin);
+    
+    thread_local std::array<std::string, DECODED_SLOTS> decoded;
+    thread_local size_t next_slot = 0;
+    std::string& slot = decoded[next_slot];
+    next_slot = (next_slot + 1) % DECODED_SLOTS;
+    slot.clear();
+    symbols->decode(text_view.substr(begin, end - begin), slot);
+    return slot;
+}
+
+VerseView VerseStore::view(VerseId id) const {
+    if (id >= size()) return {};
+    if (!symbols) return VerseView{id, bookName(id), chapter(id), verseNumber(id), text(id), nullptr};
+    
+    auto decoded = std::make_shared<const std::string>(text(id));
+    std::string_view decoded_text = *decoded;
+    return VerseView{id, bookName(id), chapter(id), verseNumber(id), decoded_text, std::move(decoded)};
+}
+
+bool VerseStore::compressText() {
+    if (symbols || empty()) return symbols != nullptr;
+    
+    std::vector<std::string_view> texts;
+    texts.reserve(size());
+    for (VerseId id = 0; id < size(); ++id) texts.push_back(text(id));
+    auto table = std::make_shared<TextSymbolTable>(TextSymbolTable::train(texts));
+    
+    TaggedString<MemoryTag::VERSE_STORE> compressed;
+    compressed.reserve(text_view.size() / 2);
+    Column<uint32_t> compressed_offsets{0};
+    compressed_offsets.reserve(size() + 1);
+    std::string encoded;
+    for (std::string_view verse_text : texts) {
+        encoded.clear();
+        table->encode(verse_text, encoded);
+        compressed += encoded;
+        compressed_offsets.push_back(static_cast<uint32_t>(compressed.size()));
+    }
+    if (compressed.size() + table->getMemoryUsage() >= text_view.size()) return false;
+    
+    compressed.shrink_to_fit();
+    text_blob = std::move(compressed);
+    text_offsets = std::move(compressed_offsets);
+    symbols = std::move(table);
+    offsets_view = text_offsets;
+    text_view = text_blob;
+    return true;
+}
+
+std::string VerseStore::reference(VerseId id) const {
+    std::string result;
+    appendReference(id, result);
+    return result;
+}
+
+std::string VerseStore::formatResult(VerseId id) const {
+    std::string result;
+    result.reserve(bookName(id).size() + 12 + text(id).size());
+    appendResult(id, result);
+    return result;
+}
+
+void VerseStore::appendReference(VerseId id, std::string& out) const {
+    // Chapter and verse numbers are at most 4095, so 4 digits each
+    char digits[16];
+    auto written = std::to_chars(digits, digits + sizeof(digits), chapter(id)).ptr;
+    *written++ = ':';
+    written = std::to_chars(written, digits + sizeof(digits), verseNumber(id)).ptr;
+    out += bookName(id);
+    out += ' ';
+    out.append(digits, written);
+}
+
+void VerseStore::appendResult(VerseId id, std::string& out) const {
+    appendReference(id, out);
+    out += ": ";
+    out += text(id);
+}
+
+Verse VerseStore::getVerse(VerseId id) const {
+    return Verse{bookName(id), chapter(id), verseNumber(id), std::string(text(id))};
+}
+
+size_t VerseStore::getMemoryUsage() const {
+    // Mapped columns are backed by the page cache rather than the heap
+    size_t bytes = text_blob.capacity();
+    bytes += text_offsets.capacity() * sizeof(uint32_t);
+    if (symbols) bytes += symbols->getMemoryUsage();
+    bytes += (book_column.capacity() + chapter_column.capacity() + verse_column.capacity()) * sizeof(uint16_t);
+    // Hash node estimate: key, value, and next pointer per entry plus the bucket array
+    bytes += ref_index.size() * (sizeof(uint32_t) + sizeof(VerseId) + sizeof(void*));
+    bytes += ref_index.bucket_count() * sizeof(void*);
+    bytes += (navigation.order.capacity() + navigation.position.capacity() +
+              navigation.chapter_begin.capacity()) * sizeof(uint32_t);
+    bytes += (navigation.chapters.capacity() + navigation.book_ranges.capacity()) * sizeof(VerseRange);
+    bytes += (words.begin.capacity() + words.terms.capacity()) * sizeof(uint32_t);
+    bytes += words.starts.capacity() * sizeof(uint16_t) + words.lengths.capacity();
+    for (const auto& name : book_names) {
+        bytes += name.capacity() * 2 + sizeof(uint16_t);
+    }
+    return bytes;
+}
@@ -0,0 +1,222 @@
+#ifndef VERSESTORE_H
+#define VERSESTORE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include "MemoryAccounting.h"
+#include "TermDictionary.h"
+
+class MappedFile;
+class TextSymbolTable;
+
+// Materialized verse value, kept for callers that want an owning copy
+struct Verse {
+    std::string book;
+    int chapter;
+    int verse;
+    std::string text;
+};
+
+// Dense row index of a verse inside one translation's store.
+// Rows are kept in load order, which is canonical (book, chapter, verse) order
+// for well-formed translation files.
+using VerseId = uint32_t;
+constexpr VerseId INVALID_VERSE_ID = std::numeric_limits<VerseId>::max();
+
+// Half-open [first, last) slice of canonical positions
+struct VerseRange {
+    uint32_t first = 0;
+    uint32_t last = 0;
+    bool empty() const { return first == last; }
+    uint32_t size() const { return last - first; }
+};
+
+// Book/chapter/verse packed into a single 32-bit key for hash lookups
+struct VerseRef {
+    static constexpr uint32_t pack(uint32_t book_id, uint32_t chapter, uint32_t verse) {
+        return (book_id << 24) | ((chapter & 0xFFF) << 12) | (verse & 0xFFF);
+    }
+    static constexpr uint32_t bookOf(uint32_t ref) { return ref >> 24; }
+    static constexpr uint32_t chapterOf(uint32_t ref) { return (ref >> 12) & 0xFFF; }
+    static constexpr uint32_t verseOf(uint32_t ref) { return ref & 0xFFF; }
+};
+
+// One verse as views into its store: no copies, valid while the store is
+// unchanged. id is INVALID_VERSE_ID (and the views empty) for a miss.
+// A compressed store decodes the text into decoded, which the view owns.
+struct VerseView {
+    VerseId id = INVALID_VERSE_ID;
+    std::string_view book;
+    int chapter = 0;
+    int verse = 0;
+    std::string_view text;
+    std::shared_ptr<const std::string> decoded;
+
+    explicit operator bool() const { return id != INVALID_VERSE_ID; }
+};
+
+// Columnar verse storage for one translation. Book names are enumerated once,
+// per-verse metadata lives in parallel columns, and all verse texts are packed
+// into a single contiguous buffer addressed through an offsets table.
+// Columns are either owned (built with addVerse) or borrowed zero-copy from a
+// mapped snapshot; all reads go through the views below.
+//
+// compressText() re-encodes the text with a symbol table learned from it,
+// for machines short of memory. Verses still decode one at a time, into a
+// per-thread ring of DECODED_SLOTS buffers: a text() view of a compressed
+// store stays valid until the same thread decodes that many more verses.
+// Hold a VerseView, or copy, to keep text longer.
+//
+// finalize() also tokenizes every verse once, as the index does: the term id
+// of each word and where it lies in the text. Phrase checks, word diffs and
+// similarity then compare ids instead of scanning and re-tokenizing text.
+class VerseStore {
+public:
+    static constexpr size_t DECODED_SLOTS = 16;
+
+private:
+    // Owned storage is counted under MemoryTag::VERSE_STORE
+    template <typename T>
+    using Column = TaggedVector<T, MemoryTag::VERSE_STORE>;
+
+    std::vector<std::string> book_names;
+    TaggedHashMap<std::string, uint16_t, MemoryTag::VERSE_STORE> book_lookup;
+
+    Column<uint16_t> book_column;
+    Column<uint16_t> chapter_column;
+    Column<uint16_t> verse_column;
+
+    TaggedString<MemoryTag::VERSE_STORE> text_blob;
+    Column<uint32_t> text_offsets{0}; // size() + 1 entries
+
+    // Read-only views over the owned columns or the mapped snapshot
+    std::span<const uint16_t> book_view;
+    std::span<const uint16_t> chapter_view;
+    std::span<const uint16_t> verse_view;
+    std::span<const uint32_t> offsets_view;
+    std::string_view text_view;
+    std::shared_ptr<const MappedFile> mapping; // keeps borrowed views alive
+    std::shared_ptr<const TextSymbolTable> symbols; // set when the text is compressed; offsets then address it
+
+    TaggedHashMap<uint32_t, VerseId, MemoryTag::VERSE_STORE> ref_index;
+
+    // Canonical (book, chapter, verse) ordering and chapter bounds, built by finalize().
+    // order/position stay empty when load order is already canonical.
+    struct Navigation {
+        Column<VerseId> order;          // canonical position -> id
+        Column<uint32_t> position;      // id -> canonical position
+        Column<uint32_t> chapter_begin; // book id -> first slot in chapters (books + 1 entries)
+        Column<VerseRange> chapters;    // indexed by chapter_begin[book] + chapter number
+        Column<VerseRange> book_ranges;
+    } navigation;
+
+    // Verse id -> its words [begin[id], begin[id + 1]): term ids and byte ranges in its text
+    struct Words {
+        Column<uint32_t> begin;  // size() + 1 entries once tokenized
+        Column<TermId> terms;
+        Column<uint16_t> starts;
+        Column<uint8_t> lengths; // longer words are cut short
+    } words;
+
+    uint16_t internBook(const std::string& book);
+    void tokenize();
+    void refreshViews();
+    void refreshOwnedViews(); // after copying or moving: re-point whatever is owned
+    void materialize(); // copy borrowed columns into owned storage and expand the text before mutating
+
+public:
+    VerseStore();
+    VerseStore(const VerseStore& other);
+    VerseStore(VerseStore&& other) noexcept;
+    VerseStore& operator=(const VerseStore& other);
+    VerseStore& operator=(VerseStore&& other) noexcept;
+
+    // Append a verse; returns INVALID_VERSE_ID if the reference already exists
+    VerseId addVerse(const std::string& book, int chapter, int verse, std::string_view text);
+    void reserve(size_t verse_count, size_t text_bytes);
+    void clear();
+    // Build the navigation tables and tokenize the verses; call after the last
+    // addVerse (attach does it itself)
+    void finalize();
+
+    // Borrow columns from a mapped snapshot; returns false if they are inconsistent
+    bool attach(std::shared_ptr<const MappedFile> file, std::vector<std::string> books,
+                std::span<const uint16_t> books_col, std::span<const uint16_t> chapters_col,
+                std::span<const uint16_t> verses_col, std::span<const uint32_t> offsets,
+                std::string_view text);
+    bool isMapped() const { return mapping != nullptr; }
+    
+    // Compress the text in place; false if it would not come out smaller
+    bool compressText();
+    bool isCompressed() const { return symbols != nullptr; }
+
+    size_t size() const { return book_view.size(); }
+    bool empty() const { return book_view.empty(); }
+
+    // Lookup
+    int findBook(const std::string& book) const; // -1 if unknown
+    VerseId find(int book_id, int chapter, int verse) const;
+    VerseId find(const std::string& book, int chapter, int verse) const;
+    VerseId findByReference(const std::string& reference) const; // exact "Book C:V"
+
+    // Canonical-order navigation (constant time once finalized)
+    VerseRange chapterRange(int book_id, int chapter) const;
+    VerseRange bookRange(int book_id) const;
+    int lastChapter(int book_id) const; // 0 if unknown
+    // Positions from chapter:verse through end_chapter:end_verse (verse -1 for
+    // whole chapters), clamped to the verses that exist: a binary search in
+    // each end chapter, however long the span
+    VerseRange spanRange(int book_id, int chapter, int verse, int end_chapter, int end_verse) const;
+    VerseId atPosition(uint32_t position) const {
+        return navigation.order.empty() ? position : navigation.order[position];
+    }
+    uint32_t positionOf(VerseId id) const {
+        return navigation.position.empty() ? id : navigation.position[id];
+    }
+
+    // Column accessors
+    std::string_view text(VerseId id) const;
+    const std::string& bookName(VerseId id) const { return book_names[book_view[id]]; }
+    uint16_t bookId(VerseId id) const { return book_view[id]; }
+    int chapter(VerseId id) const { return chapter_view[id]; }
+    int verseNumber(VerseId id) const { return verse_view[id]; }
+    const std::vector<std::string>& books() const { return book_names; }
+
+    // The verse's words as TermDictionary ids, in order; the same words as the
+    // index's positions, so equal across translations. Empty before finalize().
+    std::span<const TermId> terms(VerseId id) const;
+    // Bytes [first, second) of text(id) that the verse's index-th word was folded from
+    std::pair<size_t, size_t> wordSpan(VerseId id, size_t index) const;
+    // Whether phrase occurs as consecutive words of the verse
+    bool containsPhrase(VerseId id, std::span<const TermId> phrase) const;
+
+    // Raw columns for serialization; textOffsets and textBlob are compressed if the store is
+    std::span<const uint16_t> bookColumn() const { return book_view; }
+    std::span<const uint16_t> chapterColumn() const { return chapter_view; }
+    std::span<const uint16_t> verseColumn() const { return verse_view; }
+    std::span<const uint32_t> textOffsets() const { return offsets_view; }
+    std::string_view textBlob() const { return text_view; }
+
+    VerseView view(VerseId id) const;
+
+    // String adapters for the legacy "Book C:V" key format
+    std::string reference(VerseId id) const;
+    std::string formatResult(VerseId id) const; // "Book C:V: text"
+    // The same, appended to a buffer the caller reuses
+    void appendReference(VerseId id, std::string& out) const;
+    void appendResult(VerseId id, std::string& out) const;
+    Verse getVerse(VerseId id) const;
+
+    size_t getMemoryUsage() const;
+};
+
+// Stores by translation name; corpus versions share them (see Corpus.h)
+using VerseStoreMap = std::unordered_map<std::string, std::shared_ptr<const VerseStore>>;
+
+#endif // VERSESTORE_H
@@ -0,0 +1,59 @@
+#ifndef VERSETEXTVIEW_H
+#define VERSETEXTVIEW_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include "VerseStore.h"
+
+// Read-only view over one or more loaded translations. Building one copies a
+// pointer per store, never verse text, so analysis code can look verses up
+// without a per-call map of every reference. Valid only while the stores are.
+class VerseTextView {
+private:
+    std::vector<const VerseStore*> stores;
+
+public:
+    VerseTextView() = default;
+    explicit VerseTextView(const VerseStore& store) : stores{&store} {}
+    explicit VerseTextView(const VerseStoreMap& translations) {
+        stores.reserve(translations.size());
+        for (const auto& translation : translations) stores.push_back(translation.second.get());
+    }
+
+    // Verses across all stores; a reference present in several counts once per store
+    size_t size() const {
+        size_t total = 0;
+        for (const VerseStore* store : stores) total += store->size();
+        return total;
+    }
+    bool empty() const { return size() == 0; }
+
+    bool contains(const std::string& reference) const {
+        for (const VerseStore* store : stores) {
+            if (store->findByReference(reference) != INVALID_VERSE_ID) return true;
+        }
+        return false;
+    }
+
+    // Text from the first store holding reference, empty if none does
+    std::string_view text(const std::string& reference) const {
+        for (const VerseStore* store : stores) {
+            VerseId id = store->findByReference(reference);
+            if (id != INVALID_VERSE_ID) return store->text(id);
+        }
+        return {};
+    }
+
+    // "Book C:V: text" for position index in [0, size()), stores taken in turn
+    std::string formatResult(size_t index) const {
+        for (const VerseStore* store : stores) {
+            if (index < store->size()) return store->formatResult(static_cast<VerseId>(index));
+            index -= store->size();
+        }
+        return "";
+    }
+};
+
+#endif // VERSETEXTVIEW_H
@@ -0,0 +1,91 @@
+#include "WordDiff.h"
+
+void WordDiff::align(std::span<const uint32_t> a, std::span<const uint32_t> b,
+                     std::vector<bool>& a_matched, std::vector<bool>& b_matched) {
+    const int n = static_cast<int>(a.size());
+    const int m = static_cast<int>(b.size());
+    a_matched.assign(a.size(), false);
+    b_matched.assign(b.size(), false);
+    if (n == 0 || m == 0) return;
+
+    // Furthest x reached on each diagonal k = x - y, offset so k can be negative,
+    // with a copy kept per edit count for walking the path back
+    const int offset = n + m;
+    std::vector<int> v(2 * offset + 2, 0);
+    std::vector<std::vector<int>> trace;
+    int edits = 0;
+    for (int d = 0; d <= n + m; d++) {
+        trace.push_back(v);
+        bool reached_end = false;
+        for (int k = -d; k <= d; k += 2) {
+            int x = (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1]))
+                        ? v[offset + k + 1]       // down: an insertion from b
+                        : v[offset + k - 1] + 1;  // right: a deletion from a
+            int y = x - k;
+            while (x < n && y < m && a[x] == b[y]) {
+                x++;
+                y++;
+            }
+            v[offset + k] = x;
+            if (x >= n && y >= m) {
+                reached_end = true;
+                break;
+            }
+        }
+        if (reached_end) {
+            edits = d;
+            break;
+        }
+    }
+
+    // Back from the end, the diagonal runs of each step are the matches
+    int x = n;
+    int y = m;
+    for (int d = edits; d >= 0; d--) {
+        const std::vector<int>& before = trace[d];
+        int k = x - y;
+        int prev_k = (k == -d || (k != d && before[offset + k - 1] < before[offset + k + 1])) ? k + 1 : k - 1;
+        int prev_x = before[offset + prev_k];
+        int prev_y = prev_x - prev_k;
+        while (x > prev_x && y > prev_y) {
+            x--;
+            y--;
+            a_matched[x] = true;
+            b_matched[y] = true;
+        }
+        if (d > 0) {
+            x = prev_x;
+            y = prev_y;
+        }
+    }
+}
+
+std::vector<std::vector<bool>> WordDiff::markDifferences(const std::vector<std::vector<uint32_t>>& sequences) {
+    const size_t count = sequences.size();
+    std::vector<std::vector<int>> matches(count);
+    for (size_t i = 0; i < count; i++) {
+        matches[i].assign(sequences[i].size(), 0);
+    }
+
+    // Each pair is aligned once and credits both sides
+    std::vector<bool> i_matched;
+    std::vector<bool> j_matched;
+    for (size_t i = 0; i < count; i++) {
+        for (size_t j = i + 1; j < count; j++) {
+            align(sequences[i], sequences[j], i_matched, j_matched);
+            for (size_t t = 0; t < i_matched.size(); t++) matches[i][t] += i_matched[t];
+            for (size_t t = 0; t < j_matched.size(); t++) matches[j][t] += j_matched[t];
+        }
+    }
+
+    std::vector<std::vector<bool>> differences(count);
+    const int others = static_cast<int>(count) - 1;
+    for (size_t i = 0; i < count; i++) {
+        differences[i].resize(sequences[i].size(), false);
+        if (others == 0) continue;
+        for (size_t t = 0; t < sequences[i].size(); t++) {
+            differences[i][t] = matches[i][t] * 2 < others;
+        }
+    }
+    return differences;
+}
@@ -0,0 +1,24 @@
+#ifndef WORDDIFF_H
+#define WORDDIFF_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Alignment of token sequences, such as the words of one verse in several
+// translations. Tokens are compared as integer ids, so callers intern the
+// words once and each pair is a Myers O((N+M)D) diff: verses that mostly
+// agree cost little more than a linear scan.
+class WordDiff {
+public:
+    // Marks the tokens of a and b that belong to one longest common
+    // subsequence of the two; a_matched and b_matched are resized to fit
+    static void align(std::span<const uint32_t> a, std::span<const uint32_t> b,
+                      std::vector<bool>& a_matched, std::vector<bool>& b_matched);
+
+    // Per sequence, true at tokens aligned with fewer than half of the other
+    // sequences. A single sequence has no differences.
+    static std::vector<std::vector<bool>> markDifferences(const std::vector<std::vector<uint32_t>>& sequences);
+};
+
+#endif // WORDDIFF_H
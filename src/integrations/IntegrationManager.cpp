@@ -31,6 +31,8 @@ bool IntegrationManager::removeIntegration(IntegrationType type) {
     configs_.erase(it);
     statuses_.erase(type);
     errors_.erase(type);
+    changed_plans_.erase(type);
+    last_sync_.erase(type);
     return true;
 }
 
@@ -133,11 +135,74 @@ bool IntegrationManager::importServicePlan(IntegrationType source, ServicePlan&
 }
 
 bool IntegrationManager::syncServicePlans(IntegrationType type) {
-    // Suppress unused parameter warning for placeholder implementation
-    (void)type;
+    auto config_it = configs_.find(type);
+    auto provider_it = providers_.find(type);
     
-    // Placeholder for two-way sync implementation
-    return false;
+    if (config_it == configs_.end() || provider_it == providers_.end()) {
+        errors_[type] = "Integration not configured or provider not available";
+        return false;
+    }
+    
+    updateStatus(type, IntegrationStatus::SYNCING);
+    last_sync_[type] = std::chrono::steady_clock::now();
+    
+    std::vector<std::string> changed;
+    bool success = provider_it->second->syncServicePlans(config_it->second, changed);
+    
+    // Plans that changed stay queued until taken, even across failed syncs
+    auto& pending = changed_plans_[type];
+    for (auto& id : changed) {
+        if (std::find(pending.begin(), pending.end(), id) == pending.end()) {
+            pending.push_back(std::move(id));
+        }
+    }
+    
+    updateStatus(type, success ? IntegrationStatus::CONNECTED : IntegrationStatus::ERROR);
+    if (!success) {
+        errors_[type] = provider_it->second->getLastError();
+    }
+    
+    return success;
+}
+
+std::vector<std::string> IntegrationManager::takeChangedPlans(IntegrationType type) {
+    std::vector<std::string> changed;
+    auto it = changed_plans_.find(type);
+    if (it != changed_plans_.end()) {
+        changed.swap(it->second);
+    }
+    return changed;
+}
+
+bool IntegrationManager::mergeRemotePlan(IntegrationType type, const std::string& remote_id, ServicePlan& plan) {
+    auto provider_it = providers_.find(type);
+    if (provider_it == providers_.end()) {
+        errors_[type] = "Provider not available";
+        return false;
+    }
+    
+    bool success = provider_it->second->mergeRemotePlan(remote_id, plan);
+    if (!success) {
+        errors_[type] = provider_it->second->getLastError();
+    }
+    return success;
+}
+
+void IntegrationManager::syncDueIntegrations() {
+    auto now = std::chrono::steady_clock::now();
+    std::vector<IntegrationType> due;
+    for (const auto& [type, config] : configs_) {
+        if (!config.auto_sync) continue;
+        auto interval = std::chrono::minutes(std::max(config.sync_interval_minutes, 1));
+        auto last = last_sync_.find(type);
+        if (last == last_sync_.end() || now - last->second >= interval) {
+            due.push_back(type);
+        }
+    }
+    
+    for (IntegrationType type : due) {
+        syncServicePlans(type);
+    }
 }
 
 void IntegrationManager::enableRealTimeSync(IntegrationType type, bool enable) {
@@ -7,6 +7,7 @@
 #include <unordered_map>
 #include <functional>
 #include <mutex>
+#include <chrono>
 
 // Forward declarations
 class ServicePlan;
@@ -70,7 +71,14 @@ public:
     // Service plan synchronization
     bool exportServicePlan(const ServicePlan& plan, IntegrationType target);
     bool importServicePlan(IntegrationType source, ServicePlan& plan);
+    // Delta sync into the provider's local cache; cheap when little changed,
+    // so auto_sync can run every minute. Changed plans are then collected with
+    // takeChangedPlans() and applied with mergeRemotePlan().
     bool syncServicePlans(IntegrationType type);
+    std::vector<std::string> takeChangedPlans(IntegrationType type);
+    bool mergeRemotePlan(IntegrationType type, const std::string& remote_id, ServicePlan& plan);
+    // Syncs every auto_sync integration whose sync_interval_minutes has passed
+    void syncDueIntegrations();
     
     // Real-time features
     void enableRealTimeSync(IntegrationType type, bool enable);
@@ -95,6 +103,8 @@ private:
     std::unordered_map<IntegrationType, IntegrationConfig> configs_;
     std::unordered_map<IntegrationType, IntegrationStatus> statuses_;
     std::unordered_map<IntegrationType, std::string> errors_;
+    std::unordered_map<IntegrationType, std::vector<std::string>> changed_plans_;
+    std::unordered_map<IntegrationType, std::chrono::steady_clock::time_point> last_sync_;
     std::function<void(IntegrationType, IntegrationStatus)> status_callback_;
     
     // Thread safety
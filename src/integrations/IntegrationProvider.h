@@ -2,6 +2,7 @@
 #define INTEGRATION_PROVIDER_H
 
 #include <string>
+#include <vector>
 #include "IntegrationManager.h"
 
 class ServicePlan;
@@ -16,6 +17,22 @@ public:
     virtual std::string generateOAuthUrl() const = 0;
     virtual bool handleOAuthCallback(const std::string& code, IntegrationConfig& config) = 0;
     virtual std::string getLastError() const = 0;
+
+    // Delta sync: bring the provider's local copy of remote plans up to date,
+    // fetching only what changed, and report the remote ids of plans that did
+    virtual bool syncServicePlans(const IntegrationConfig& config, std::vector<std::string>& changed_plan_ids) {
+        (void)config;
+        (void)changed_plan_ids;
+        last_error_ = "Sync is not supported by this integration";
+        return false;
+    }
+    // Apply the local copy of a remote plan to plan, changing only fields that differ
+    virtual bool mergeRemotePlan(const std::string& remote_id, ServicePlan& plan) {
+        (void)remote_id;
+        (void)plan;
+        last_error_ = "Sync is not supported by this integration";
+        return false;
+    }
     
 protected:
     mutable std::string last_error_;
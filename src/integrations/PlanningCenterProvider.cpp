@@ -1,5 +1,9 @@
 #include "PlanningCenterProvider.h"
 #include "../service/ServicePlan.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
 #include <sstream>
 #include <regex>
 
@@ -9,8 +13,52 @@ const std::string PlanningCenterProvider::REDIRECT_URI = "http://localhost:8080/
 const std::string PlanningCenterProvider::API_BASE_URL = "https://api.planningcenteronline.com/services/v2";
 const std::string PlanningCenterProvider::OAUTH_BASE_URL = "https://api.planningcenteronline.com/oauth";
 
-PlanningCenterProvider::PlanningCenterProvider() {
-    // Initialize provider
+namespace {
+
+// Prefix for the ids of items that came from Planning Center, so merging
+// never touches items added locally
+const std::string REMOTE_ITEM_PREFIX = "pco-";
+
+// Map PCO categories to service item types
+ServiceItemType categoryToItemType(const std::string& category) {
+    if (category == "song") return ServiceItemType::SONG;
+    if (category == "scripture" || category == "reading") return ServiceItemType::SCRIPTURE;
+    if (category == "sermon" || category == "message") return ServiceItemType::SERMON;
+    if (category == "prayer") return ServiceItemType::PRAYER;
+    if (category == "announcement") return ServiceItemType::ANNOUNCEMENT;
+    if (category == "offering") return ServiceItemType::OFFERING;
+    if (category == "communion") return ServiceItemType::COMMUNION;
+    if (category == "baptism") return ServiceItemType::BAPTISM;
+    if (category == "media" || category == "video") return ServiceItemType::MEDIA;
+    return ServiceItemType::CUSTOM;
+}
+
+// Parses "2024-05-12T09:00:00Z"; false for anything else
+bool parseIsoTime(const std::string& text, std::chrono::system_clock::time_point& time) {
+    std::tm parts{};
+    std::istringstream stream(text);
+    stream >> std::get_time(&parts, "%Y-%m-%dT%H:%M:%S");
+    if (stream.fail()) return false;
+    time = std::chrono::system_clock::from_time_t(timegm(&parts));
+    return true;
+}
+
+// Attribute as a string; unset attributes come back as null
+std::string textAttribute(const nlohmann::json& attributes, const char* key) {
+    auto it = attributes.find(key);
+    return it != attributes.end() && it->is_string() ? it->get<std::string>() : std::string();
+}
+
+std::string idOf(const nlohmann::json& entry) {
+    return entry["id"].is_string() ? entry["id"].get<std::string>() : entry["id"].dump();
+}
+
+} // namespace
+
+PlanningCenterProvider::PlanningCenterProvider()
+    : http("planning_center", MAX_CONCURRENT_REQUESTS), cache("config/integrations/planning_center.json") {
+    http.setTimeout(REQUEST_TIMEOUT_SECONDS);
+    cache.load();
 }
 
 bool PlanningCenterProvider::testConnection(const IntegrationConfig& config) {
@@ -156,9 +204,149 @@ std::string PlanningCenterProvider::getLastError() const {
 }
 
 bool PlanningCenterProvider::syncServiceOrders(const IntegrationConfig& config) {
-    // Implementation for syncing service orders with Planning Center Live
-    std::string response;
-    return makeApiRequest("/service_types/1/plans?filter=future", "GET", "", response, config);
+    std::vector<std::string> changed_plan_ids;
+    return syncServicePlans(config, changed_plan_ids);
+}
+
+bool PlanningCenterProvider::syncServicePlans(const IntegrationConfig& config,
+                                              std::vector<std::string>& changed_plan_ids) {
+    if (config.api_key.empty()) {
+        last_error_ = "No API key configured";
+        return false;
+    }
+
+    // Oldest changes first, so a sync that hits the page size resumes from
+    // its cursor next time rather than skipping what did not fit
+    std::string endpoint = "/service_types/1/plans?filter=future&order=updated_at&per_page=" +
+                           std::to_string(SYNC_PAGE_SIZE);
+    if (!cache.getCursor().empty()) {
+        endpoint += "&where[updated_at][gte]=" + cache.getCursor();
+    }
+    HttpClient::Response listing = sendApiRequest(endpoint, "GET", "", config, cache.getListEtag()).get();
+    if (listing.status == 304) {
+        return true;
+    }
+    if (!listing.ok()) {
+        last_error_ = listing.error.empty() ? "Planning Center returned HTTP " + std::to_string(listing.status)
+                                            : "Planning Center request failed: " + listing.error;
+        return false;
+    }
+
+    // Only plans whose version moved are fetched again, and their items are
+    // requested with the last ETag so unchanged ones come back empty
+    struct Fetch {
+        PCOService service;
+        std::future<HttpClient::Response> items;
+    };
+    std::vector<Fetch> fetches;
+    std::string newest;
+    for (auto& service : parseServicesResponse(listing.body)) {
+        newest = std::max(newest, service.updated_at);
+        const RemotePlanCache::RemotePlan* cached = cache.find(service.id);
+        if (cached && !service.updated_at.empty() && cached->version == service.updated_at) continue;
+        std::string etag = cached ? cached->items_etag : "";
+        auto items = sendApiRequest("/service_types/1/plans/" + service.id + "/items?per_page=100", "GET", "",
+                                    config, etag);
+        fetches.push_back(Fetch{std::move(service), std::move(items)});
+    }
+
+    size_t failed = 0;
+    for (auto& fetch : fetches) {
+        HttpClient::Response items = fetch.items.get();
+        if (items.status != 304 && !items.ok()) {
+            failed++;
+            continue;
+        }
+
+        const RemotePlanCache::RemotePlan* cached = cache.find(fetch.service.id);
+        RemotePlanCache::RemotePlan plan = cached ? *cached : RemotePlanCache::RemotePlan{};
+        plan.id = fetch.service.id;
+        plan.version = fetch.service.updated_at;
+        plan.title = fetch.service.name;
+        plan.series_title = fetch.service.series_title;
+        plan.service_time = fetch.service.sort_date;
+        if (items.status != 304) {
+            plan.items_etag = items.header("etag");
+            plan.items.clear();
+            for (const auto& pco_item : parseItemsResponse(items.body)) {
+                plan.items.push_back(RemotePlanCache::RemoteItem{pco_item.id, pco_item.title, pco_item.category,
+                                                                 pco_item.description,
+                                                                 static_cast<long>(pco_item.length.count())});
+            }
+        }
+        cache.store(std::move(plan));
+        changed_plan_ids.push_back(fetch.service.id);
+    }
+
+    // A plan that failed is fetched again next time only if the cursor has not passed it
+    if (failed == 0) {
+        cache.advanceCursor(newest);
+        cache.setListEtag(listing.header("etag"));
+    }
+    cache.save();
+
+    if (failed > 0) {
+        last_error_ = "Failed to sync " + std::to_string(failed) + " of " + std::to_string(fetches.size()) +
+                      " changed service plans";
+        return false;
+    }
+    return true;
+}
+
+bool PlanningCenterProvider::mergeRemotePlan(const std::string& remote_id, ServicePlan& plan) {
+    const RemotePlanCache::RemotePlan* remote = cache.find(remote_id);
+    if (!remote) {
+        last_error_ = "Service plan " + remote_id + " has not been synced";
+        return false;
+    }
+
+    // Setters are only called for fields that differ, so an unchanged plan
+    // keeps its modification time and does not look dirty to needsSync()
+    if (!remote->title.empty() && plan.getTitle() != remote->title) {
+        plan.setTitle(remote->title);
+    }
+    if (!remote->series_title.empty() && plan.getDescription() != remote->series_title) {
+        plan.setDescription(remote->series_title);
+    }
+    std::chrono::system_clock::time_point service_time;
+    if (parseIsoTime(remote->service_time, service_time) && plan.getServiceTime() != service_time) {
+        plan.setServiceTime(service_time);
+    }
+
+    std::vector<std::string> remote_ids;
+    for (const auto& remote_item : remote->items) {
+        std::string id = REMOTE_ITEM_PREFIX + remote_item.id;
+        remote_ids.push_back(id);
+
+        ServiceItem* existing = plan.getItem(id);
+        ServiceItem item = existing ? *existing : ServiceItem{};
+        item.id = id;
+        item.title = remote_item.title;
+        item.description = remote_item.description;
+        item.type = categoryToItemType(remote_item.category);
+        item.duration = std::chrono::seconds(remote_item.length_seconds);
+        if (!existing) {
+            plan.addItem(item);
+        } else if (existing->title != item.title || existing->description != item.description ||
+                   existing->type != item.type || existing->duration != item.duration) {
+            plan.updateItem(item);
+        }
+    }
+
+    // Items deleted remotely go; items added locally stay
+    std::vector<std::string> removed;
+    for (const auto& item : plan.getItems()) {
+        if (item.id.rfind(REMOTE_ITEM_PREFIX, 0) == 0 &&
+            std::find(remote_ids.begin(), remote_ids.end(), item.id) == remote_ids.end()) {
+            removed.push_back(item.id);
+        }
+    }
+    for (const auto& id : removed) {
+        plan.removeItem(id);
+    }
+
+    plan.markAsSynced("planning_center");
+    return true;
 }
 
 bool PlanningCenterProvider::importScriptureReadings(const IntegrationConfig& config, ServicePlan& plan) {
@@ -258,38 +446,45 @@ std::vector<std::string> PlanningCenterProvider::getAvailableServices(const Inte
 bool PlanningCenterProvider::makeApiRequest(const std::string& endpoint, const std::string& method,
                                            const std::string& body, std::string& response,
                                            const IntegrationConfig& config) {
-    // Suppress unused parameter warnings for mock implementation
-    (void)method;
-    (void)body;
-    
-    // In a real implementation, this would make actual HTTP requests
-    // For now, we'll simulate API responses
-    
     if (config.api_key.empty()) {
         last_error_ = "No API key configured";
         return false;
     }
-    
-    // Simulate successful response
-    if (endpoint.find("/service_types") != std::string::npos) {
-        response = R"({
-            "data": [
-                {
-                    "type": "ServiceType",
-                    "id": "1",
-                    "attributes": {
-                        "name": "Sunday Morning Service"
-                    }
-                }
-            ]
-        })";
-        return true;
+
+    HttpClient::Response result = sendApiRequest(endpoint, method, body, config).get();
+    if (!result.error.empty()) {
+        last_error_ = "Planning Center request failed: " + result.error;
+        return false;
     }
-    
-    response = "{}";
+    if (!result.ok()) {
+        last_error_ = "Planning Center returned HTTP " + std::to_string(result.status);
+        return false;
+    }
+
+    response = std::move(result.body);
     return true;
 }
 
+std::future<HttpClient::Response> PlanningCenterProvider::sendApiRequest(const std::string& endpoint,
+                                                                         const std::string& method,
+                                                                         const std::string& body,
+                                                                         const IntegrationConfig& config,
+                                                                         const std::string& etag) {
+    HttpClient::Request request;
+    request.method = method;
+    request.url = (config.endpoint.empty() ? API_BASE_URL : config.endpoint) + endpoint;
+    request.headers.push_back("Authorization: " + buildAuthHeader(config));
+    request.headers.push_back("Accept: application/json");
+    if (!etag.empty()) {
+        request.headers.push_back("If-None-Match: " + etag);
+    }
+    if (!body.empty()) {
+        request.headers.push_back("Content-Type: application/json");
+        request.body = body;
+    }
+    return http.send(std::move(request));
+}
+
 std::string PlanningCenterProvider::buildAuthHeader(const IntegrationConfig& config) const {
     return "Bearer " + config.api_key;
 }
@@ -303,20 +498,54 @@ bool PlanningCenterProvider::refreshAccessToken(IntegrationConfig& config) {
 }
 
 std::vector<PlanningCenterProvider::PCOService> PlanningCenterProvider::parseServicesResponse(const std::string& response) {
-    // Suppress unused parameter warning for mock implementation
-    (void)response;
-    
     std::vector<PCOService> services;
-    // Parse JSON response and extract service information
+    auto json = nlohmann::json::parse(response, nullptr, false);
+    if (json.is_discarded() || !json.contains("data") || !json["data"].is_array()) {
+        return services;
+    }
+
+    for (const auto& entry : json["data"]) {
+        if (!entry.is_object() || !entry.contains("id")) continue;
+        PCOService service;
+        service.id = idOf(entry);
+        if (entry.contains("attributes") && entry["attributes"].is_object()) {
+            const auto& attributes = entry["attributes"];
+            service.name = textAttribute(attributes, "title");
+            service.series_title = textAttribute(attributes, "series_title");
+            service.plan_title = service.name;
+            service.updated_at = textAttribute(attributes, "updated_at");
+            service.sort_date = textAttribute(attributes, "sort_date");
+            parseIsoTime(service.sort_date, service.service_time);
+        }
+        services.push_back(std::move(service));
+    }
     return services;
 }
 
 std::vector<PlanningCenterProvider::PCOItem> PlanningCenterProvider::parseItemsResponse(const std::string& response) {
-    // Suppress unused parameter warning for mock implementation
-    (void)response;
-    
     std::vector<PCOItem> items;
-    // Parse JSON response and extract item information
+    auto json = nlohmann::json::parse(response, nullptr, false);
+    if (json.is_discarded() || !json.contains("data") || !json["data"].is_array()) {
+        return items;
+    }
+
+    for (const auto& entry : json["data"]) {
+        if (!entry.is_object() || !entry.contains("id")) continue;
+        PCOItem item;
+        item.id = idOf(entry);
+        item.length = std::chrono::seconds(0);
+        if (entry.contains("attributes") && entry["attributes"].is_object()) {
+            const auto& attributes = entry["attributes"];
+            item.title = textAttribute(attributes, "title");
+            item.category = textAttribute(attributes, "item_type");
+            item.description = textAttribute(attributes, "description");
+            auto length = attributes.find("length");
+            if (length != attributes.end() && length->is_number_integer()) {
+                item.length = std::chrono::seconds(length->get<long>());
+            }
+        }
+        items.push_back(std::move(item));
+    }
     return items;
 }
 
@@ -332,30 +561,7 @@ void PlanningCenterProvider::convertPCOToServicePlan(const PCOService& service,
         item.duration = pco_item.length;
         item.assigned_to = pco_item.assigned_to;
         
-        // Map PCO categories to service item types
-        if (pco_item.category == "song") {
-            item.type = ServiceItemType::SONG;
-        } else if (pco_item.category == "header") {
-            item.type = ServiceItemType::CUSTOM;
-        } else if (pco_item.category == "scripture" || pco_item.category == "reading") {
-            item.type = ServiceItemType::SCRIPTURE;
-        } else if (pco_item.category == "sermon" || pco_item.category == "message") {
-            item.type = ServiceItemType::SERMON;
-        } else if (pco_item.category == "prayer") {
-            item.type = ServiceItemType::PRAYER;
-        } else if (pco_item.category == "announcement") {
-            item.type = ServiceItemType::ANNOUNCEMENT;
-        } else if (pco_item.category == "offering") {
-            item.type = ServiceItemType::OFFERING;
-        } else if (pco_item.category == "communion") {
-            item.type = ServiceItemType::COMMUNION;
-        } else if (pco_item.category == "baptism") {
-            item.type = ServiceItemType::BAPTISM;
-        } else if (pco_item.category == "media" || pco_item.category == "video") {
-            item.type = ServiceItemType::MEDIA;
-        } else {
-            item.type = ServiceItemType::CUSTOM;
-        }
+        item.type = categoryToItemType(pco_item.category);
         
         plan.addItem(item);
     }
@@ -2,8 +2,11 @@
 #define PLANNING_CENTER_PROVIDER_H
 
 #include "IntegrationProvider.h"
+#include "RemotePlanCache.h"
+#include "../core/HttpClient.h"
 #include <string>
 #include <chrono>
+#include <future>
 
 class PlanningCenterProvider : public IntegrationProvider {
 public:
@@ -16,6 +19,8 @@ public:
     std::string generateOAuthUrl() const override;
     bool handleOAuthCallback(const std::string& code, IntegrationConfig& config) override;
     std::string getLastError() const override;
+    bool syncServicePlans(const IntegrationConfig& config, std::vector<std::string>& changed_plan_ids) override;
+    bool mergeRemotePlan(const std::string& remote_id, ServicePlan& plan) override;
     
     // Planning Center specific methods
     bool syncServiceOrders(const IntegrationConfig& config);
@@ -30,6 +35,8 @@ private:
         std::chrono::system_clock::time_point service_time;
         std::string series_title;
         std::string plan_title;
+        std::string updated_at;
+        std::string sort_date;
     };
     
     struct PCOItem {
@@ -46,6 +53,10 @@ private:
     bool makeApiRequest(const std::string& endpoint, const std::string& method,
                        const std::string& body, std::string& response,
                        const IntegrationConfig& config);
+    // Queues a request without waiting, for fanning out over many plans
+    std::future<HttpClient::Response> sendApiRequest(const std::string& endpoint, const std::string& method,
+                                                     const std::string& body, const IntegrationConfig& config,
+                                                     const std::string& etag = "");
     
     std::string buildAuthHeader(const IntegrationConfig& config) const;
     bool refreshAccessToken(IntegrationConfig& config);
@@ -55,6 +66,15 @@ private:
     void convertPCOToServicePlan(const PCOService& service, const std::vector<PCOItem>& items, ServicePlan& plan);
     std::string convertServicePlanToPCO(const ServicePlan& plan);
     
+    // All requests share one lane of the HTTP loop, capped so a large sync
+    // stays within Planning Center's rate limits
+    static constexpr size_t MAX_CONCURRENT_REQUESTS = 4;
+    static constexpr long REQUEST_TIMEOUT_SECONDS = 20;
+    HttpClient http;
+    // Plans fetched so far, with the versions and ETags delta sync compares against
+    RemotePlanCache cache;
+    static constexpr size_t SYNC_PAGE_SIZE = 100;
+
     // OAuth configuration
     static const std::string CLIENT_ID;
     static const std::string REDIRECT_URI;
@@ -0,0 +1,120 @@
+#include "RemotePlanCache.h"
+#include <nlohmann/json.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+RemotePlanCache::RemotePlanCache(const std::string& path) : path(path) {
+}
+
+bool RemotePlanCache::load() {
+    std::ifstream file(path);
+    if (!file) return false;
+
+    try {
+        auto json = nlohmann::json::parse(file);
+        cursor = json.value("cursor", "");
+        list_etag = json.value("list_etag", "");
+        plans.clear();
+        for (const auto& entry : json.value("plans", nlohmann::json::array())) {
+            RemotePlan plan;
+            plan.id = entry.value("id", "");
+            plan.version = entry.value("version", "");
+            plan.items_etag = entry.value("items_etag", "");
+            plan.title = entry.value("title", "");
+            plan.series_title = entry.value("series_title", "");
+            plan.service_time = entry.value("service_time", "");
+            for (const auto& item_json : entry.value("items", nlohmann::json::array())) {
+                RemoteItem item;
+                item.id = item_json.value("id", "");
+                item.title = item_json.value("title", "");
+                item.category = item_json.value("category", "");
+                item.description = item_json.value("description", "");
+                item.length_seconds = item_json.value("length", 0L);
+                plan.items.push_back(std::move(item));
+            }
+            if (!plan.id.empty()) {
+                plans[plan.id] = std::move(plan);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Ignoring unreadable integration cache " << path << ": " << e.what() << std::endl;
+        plans.clear();
+        cursor.clear();
+        list_etag.clear();
+        return false;
+    }
+    dirty = false;
+    return true;
+}
+
+bool RemotePlanCache::save() {
+    if (!dirty) return true;
+
+    nlohmann::json json;
+    json["cursor"] = cursor;
+    json["list_etag"] = list_etag;
+    json["plans"] = nlohmann::json::array();
+    for (const auto& [id, plan] : plans) {
+        nlohmann::json entry;
+        entry["id"] = plan.id;
+        entry["version"] = plan.version;
+        entry["items_etag"] = plan.items_etag;
+        entry["title"] = plan.title;
+        entry["series_title"] = plan.series_title;
+        entry["service_time"] = plan.service_time;
+        entry["items"] = nlohmann::json::array();
+        for (const auto& item : plan.items) {
+            entry["items"].push_back({{"id", item.id}, {"title", item.title}, {"category", item.category},
+                                      {"description", item.description}, {"length", item.length_seconds}});
+        }
+        json["plans"].push_back(std::move(entry));
+    }
+
+    // Written beside the cache and renamed over it, so a crash never leaves half a file
+    std::error_code ec;
+    std::filesystem::path target(path);
+    if (target.has_parent_path()) {
+        std::filesystem::create_directories(target.parent_path(), ec);
+    }
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if (!file) return false;
+        file << json.dump();
+        if (!file) return false;
+    }
+    std::filesystem::rename(temp_path, target, ec);
+    if (ec) {
+        std::cerr << "Failed to write integration cache " << path << ": " << ec.message() << std::endl;
+        return false;
+    }
+    dirty = false;
+    return true;
+}
+
+const RemotePlanCache::RemotePlan* RemotePlanCache::find(const std::string& id) const {
+    auto it = plans.find(id);
+    return it != plans.end() ? &it->second : nullptr;
+}
+
+void RemotePlanCache::store(RemotePlan plan) {
+    std::string id = plan.id;
+    plans[id] = std::move(plan);
+    dirty = true;
+}
+
+void RemotePlanCache::advanceCursor(const std::string& version) {
+    // ISO 8601 timestamps in one zone order as strings
+    if (version > cursor) {
+        cursor = version;
+        dirty = true;
+    }
+}
+
+void RemotePlanCache::setListEtag(const std::string& etag) {
+    if (etag != list_etag) {
+        list_etag = etag;
+        dirty = true;
+    }
+}
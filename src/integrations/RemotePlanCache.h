@@ -0,0 +1,57 @@
+#ifndef REMOTE_PLAN_CACHE_H
+#define REMOTE_PLAN_CACHE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Local copy of the service plans an integration has fetched, keyed by
+// remote id, with the version and ETags needed to ask the remote for only
+// what changed. Persisted as one JSON file per integration, so a restart
+// does not mean a full re-download.
+class RemotePlanCache {
+public:
+    struct RemoteItem {
+        std::string id;
+        std::string title;
+        std::string category;
+        std::string description;
+        long length_seconds = 0;
+    };
+
+    struct RemotePlan {
+        std::string id;
+        std::string version;      // the remote's updated_at
+        std::string items_etag;   // of the last items response
+        std::string title;
+        std::string series_title;
+        std::string service_time; // ISO 8601, as the remote sent it
+        std::vector<RemoteItem> items;
+    };
+
+    explicit RemotePlanCache(const std::string& path);
+
+    // Missing or unreadable files leave the cache empty
+    bool load();
+    // Writes only if something changed since the last load or save
+    bool save();
+
+    const RemotePlan* find(const std::string& id) const;
+    void store(RemotePlan plan);
+
+    // updated_since cursor: the newest version seen so far
+    const std::string& getCursor() const { return cursor; }
+    void advanceCursor(const std::string& version);
+
+    const std::string& getListEtag() const { return list_etag; }
+    void setListEtag(const std::string& etag);
+
+private:
+    std::string path;
+    std::unordered_map<std::string, RemotePlan> plans;
+    std::string cursor;
+    std::string list_etag;
+    bool dirty = false;
+};
+
+#endif // REMOTE_PLAN_CACHE_H
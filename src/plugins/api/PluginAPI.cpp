@@ -0,0 +1,200 @@
+#include "PluginAPI.h"
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+// Host side of an open translation: the lease keeps the store the views
+// point into resident until the plugin closes it. Text decoded from a
+// compressed store is kept here for as long, by verse, since views of it
+// must last as long.
+struct VfTranslation {
+    VerseFinder::TranslationLease lease;
+    std::string name;
+    const VerseStore* store = nullptr;
+    mutable std::mutex decoded_mutex;
+    mutable std::unordered_map<VerseId, std::shared_ptr<const std::string>> decoded;
+};
+
+struct VfTranslationBuilder {
+    std::unique_ptr<VerseFinder::TranslationBuilder> builder;
+};
+
+namespace PluginSystem {
+
+namespace {
+
+// Nothing may unwind into a plugin, which may not even be C++
+VfTranslation* hostOpenTranslation(void* host, const char* name) {
+    if (!host || !name) return nullptr;
+    try {
+        auto* finder = static_cast<VerseFinder*>(host);
+        VerseFinder::TranslationLease lease = finder->acquireTranslation(name);
+        const VerseStore* store = lease ? finder->getVerseStore(name) : nullptr;
+        if (!store) return nullptr;
+        auto* translation = new VfTranslation;
+        translation->lease = std::move(lease);
+        translation->name = name;
+        translation->store = store;
+        return translation;
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void hostCloseTranslation(void*, VfTranslation* translation) {
+    delete translation;
+}
+
+uint32_t hostVerseCount(void*, const VfTranslation* translation) {
+    return translation ? static_cast<uint32_t>(translation->store->size()) : 0;
+}
+
+VfVerseId hostVerseAt(void*, const VfTranslation* translation, uint32_t position) {
+    if (!translation || position >= translation->store->size()) return VF_INVALID_VERSE_ID;
+    return translation->store->atPosition(position);
+}
+
+int hostBookRange(void* host, const VfTranslation* translation, const char* book,
+                  uint32_t* first, uint32_t* last) {
+    if (!translation || !book) return 0;
+    try {
+        int book_id = translation->store->findBook(static_cast<VerseFinder*>(host)->normalizeBookName(book));
+        if (book_id < 0) return 0;
+        VerseRange range = translation->store->bookRange(book_id);
+        if (range.empty()) return 0;
+        if (first) *first = range.first;
+        if (last) *last = range.last;
+        return 1;
+    } catch (...) {
+        return 0;
+    }
+}
+
+size_t copyIds(const std::vector<VerseId>& found, VfVerseId* ids, size_t capacity) {
+    if (ids) {
+        std::copy_n(found.begin(), std::min(found.size(), capacity), ids);
+    }
+    return found.size();
+}
+
+size_t hostFindPassage(void* host, const VfTranslation* translation, const char* reference,
+                       VfVerseId* ids, size_t capacity) {
+    if (!translation || !reference) return 0;
+    try {
+        return copyIds(static_cast<VerseFinder*>(host)->findPassage(reference, translation->name), ids, capacity);
+    } catch (...) {
+        return 0;
+    }
+}
+
+size_t hostFindPassageRanges(void* host, const VfTranslation* translation, const char* reference,
+                             VfRange* ranges, size_t capacity) {
+    if (!translation || !reference) return 0;
+    try {
+        std::vector<VerseRange> found = static_cast<VerseFinder*>(host)->findPassageRanges(reference, translation->name);
+        if (ranges) {
+            for (size_t i = 0; i < std::min(found.size(), capacity); i++) {
+                ranges[i] = VfRange{found[i].first, found[i].last};
+            }
+        }
+        return found.size();
+    } catch (...) {
+        return 0;
+    }
+}
+
+size_t hostSearchKeywords(void* host, const VfTranslation* translation, const char* query,
+                          VfVerseId* ids, size_t capacity) {
+    if (!translation || !query) return 0;
+    try {
+        return copyIds(static_cast<VerseFinder*>(host)->searchKeywordIds(query, translation->name).ids, ids, capacity);
+    } catch (...) {
+        return 0;
+    }
+}
+
+size_t hostGetVerses(void*, const VfTranslation* translation, const VfVerseId* ids, size_t count, VfVerse* out) {
+    if (!translation || !ids || !out) return 0;
+    const VerseStore& store = *translation->store;
+    size_t found = 0;
+    for (size_t i = 0; i < count; i++) {
+        VfVerse& verse = out[i];
+        verse = VfVerse{VF_INVALID_VERSE_ID, 0, 0, 0, {nullptr, 0}, {nullptr, 0}};
+        if (ids[i] >= store.size()) continue;
+
+        VerseView view = store.view(ids[i]);
+        if (view.decoded) {
+            std::lock_guard<std::mutex> lock(translation->decoded_mutex);
+            auto kept = translation->decoded.emplace(view.id, view.decoded).first;
+            view.text = *kept->second;
+        }
+        verse.id = view.id;
+        verse.chapter = static_cast<uint32_t>(view.chapter);
+        verse.verse = static_cast<uint32_t>(view.verse);
+        verse.book = {view.book.data(), view.book.size()};
+        verse.text = {view.text.data(), view.text.size()};
+        found++;
+    }
+    return found;
+}
+
+VfTranslationBuilder* hostBeginTranslation(void* host, const char* name, const char* abbreviation,
+                                           const char* language, const char* source_file) {
+    if (!host || !name) return nullptr;
+    try {
+        TranslationInfo info(name, abbreviation ? abbreviation : "", "", 0,
+                             language ? language : "", source_file ? source_file : "");
+        return new VfTranslationBuilder{static_cast<VerseFinder*>(host)->beginTranslation(info)};
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+int hostAddVerse(void*, VfTranslationBuilder* builder, const char* book, uint32_t chapter,
+                 uint32_t verse, VfStringView text) {
+    if (!builder || !book || (!text.data && text.size)) return 0;
+    try {
+        return builder->builder->addVerse(book, static_cast<int>(chapter), static_cast<int>(verse),
+                                          std::string_view(text.data, text.size)) ? 1 : 0;
+    } catch (...) {
+        return 0;
+    }
+}
+
+int hostCommitTranslation(void*, VfTranslationBuilder* builder) {
+    if (!builder) return 0;
+    int committed = 0;
+    try {
+        committed = builder->builder->commit() ? 1 : 0;
+    } catch (...) {
+    }
+    delete builder;
+    return committed;
+}
+
+void hostDiscardTranslation(void*, VfTranslationBuilder* builder) {
+    delete builder;
+}
+
+} // namespace
+
+PluginAPI::PluginAPI(VerseFinder* bible) : bible_instance(bible) {
+    host_api.abi_version = VF_PLUGIN_ABI_VERSION;
+    host_api.struct_size = sizeof(VfHostApi);
+    host_api.host = bible;
+    host_api.open_translation = hostOpenTranslation;
+    host_api.close_translation = hostCloseTranslation;
+    host_api.verse_count = hostVerseCount;
+    host_api.verse_at = hostVerseAt;
+    host_api.book_range = hostBookRange;
+    host_api.find_passage = hostFindPassage;
+    host_api.search_keywords = hostSearchKeywords;
+    host_api.get_verses = hostGetVerses;
+    host_api.begin_translation = hostBeginTranslation;
+    host_api.add_verse = hostAddVerse;
+    host_api.commit_translation = hostCommitTranslation;
+    host_api.discard_translation = hostDiscardTranslation;
+    host_api.find_passage_ranges = hostFindPassageRanges;
+}
+
+} // namespace PluginSystem
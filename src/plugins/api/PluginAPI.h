@@ -2,50 +2,58 @@
 #define PLUGIN_API_H
 
 #include "PluginInterfaces.h"
+#include "PluginAbi.h"
+#include "PluginEventBus.h"
 #include "../../core/VerseFinder.h"
 #include <functional>
 #include <memory>
+#include <span>
 
 namespace PluginSystem {
 
-// Event system for plugin communication
-class PluginEvent {
-public:
-    std::string type;
-    std::unordered_map<std::string, std::string> data;
-    std::string source;
-    std::chrono::steady_clock::time_point timestamp;
-    
-    PluginEvent(const std::string& eventType, const std::string& sourcePlugin = "")
-        : type(eventType), source(sourcePlugin), timestamp(std::chrono::steady_clock::now()) {}
-    
-    void setData(const std::string& key, const std::string& value) {
-        data[key] = value;
-    }
-    
-    std::string getData(const std::string& key, const std::string& defaultValue = "") const {
-        auto it = data.find(key);
-        return it != data.end() ? it->second : defaultValue;
-    }
-};
-
-// Event listener interface
-using EventCallback = std::function<void(const PluginEvent&)>;
-
 // Plugin API - provides access to VerseFinder functionality
 class PluginAPI {
 private:
     VerseFinder* bible_instance;
-    std::unordered_map<std::string, std::vector<EventCallback>> event_listeners;
+    PluginEventBus events;
+    VfHostApi host_api; // the same surface for plugins across the library boundary
     
 public:
-    explicit PluginAPI(VerseFinder* bible) : bible_instance(bible) {}
+    explicit PluginAPI(VerseFinder* bible);
+    PluginAPI(const PluginAPI&) = delete;
+    PluginAPI& operator=(const PluginAPI&) = delete;
+    
+    // Function table handed to v2 plugins; see PluginAbi.h
+    const VfHostApi* getHostApi() const { return &host_api; }
     
     // Bible search methods
     std::string searchByReference(const std::string& reference, const std::string& translation) const {
         return bible_instance ? bible_instance->searchByReference(reference, translation) : "";
     }
     
+    // Views into the loaded translation, no copy; valid until it is reloaded
+    VerseView findVerse(const std::string& reference, const std::string& translation) const {
+        return bible_instance ? bible_instance->findVerse(reference, translation) : VerseView();
+    }
+    
+    // Id-level lookups that render nothing; view the ids with viewVerses()
+    std::vector<VerseId> findPassage(const std::string& reference, const std::string& translation) const {
+        return bible_instance ? bible_instance->findPassage(reference, translation) : std::vector<VerseId>();
+    }
+    
+    // Canonical positions of a passage, one run per span; read with VerseStore::atPosition
+    std::vector<VerseRange> findPassageRanges(const std::string& reference, const std::string& translation) const {
+        return bible_instance ? bible_instance->findPassageRanges(reference, translation) : std::vector<VerseRange>();
+    }
+    
+    CachedSearchResult searchKeywordIds(const std::string& query, const std::string& translation) const {
+        return bible_instance ? bible_instance->searchKeywordIds(query, translation) : CachedSearchResult();
+    }
+    
+    std::vector<VerseView> viewVerses(std::span<const VerseId> ids, const std::string& translation) const {
+        return bible_instance ? bible_instance->viewVerses(ids, translation) : std::vector<VerseView>();
+    }
+    
     std::vector<std::string> searchByKeywords(const std::string& query, const std::string& translation) const {
         return bible_instance ? bible_instance->searchByKeywords(query, translation) : std::vector<std::string>();
     }
@@ -58,16 +66,25 @@ public:
         return bible_instance ? bible_instance->searchSemantic(query, translation) : std::vector<std::string>();
     }
     
+    // Search plugins with an embedding model route semantic search through verse embeddings
+    void setQueryEmbedder(VerseFinder::QueryEmbedder embedder) {
+        if (bible_instance) bible_instance->setQueryEmbedder(std::move(embedder));
+    }
+    
     // Translation management
-    const std::vector<TranslationInfo>& getTranslations() const {
-        static std::vector<TranslationInfo> empty;
-        return bible_instance ? bible_instance->getTranslations() : empty;
+    std::vector<TranslationInfo> getTranslations() const {
+        return bible_instance ? bible_instance->getTranslations() : std::vector<TranslationInfo>{};
     }
     
     bool loadTranslationFromFile(const std::string& filename) {
         return bible_instance ? bible_instance->loadTranslationFromFile(filename) : false;
     }
     
+    // Streaming import for other formats; see VerseFinder::TranslationBuilder
+    std::unique_ptr<VerseFinder::TranslationBuilder> beginTranslation(const TranslationInfo& info) {
+        return bible_instance ? bible_instance->beginTranslation(info) : nullptr;
+    }
+    
     // Cross-references and context
     std::vector<std::string> findCrossReferences(const std::string& verseKey) const {
         return bible_instance ? bible_instance->findCrossReferences(verseKey) : std::vector<std::string>();
@@ -138,26 +155,30 @@ public:
         return bible_instance ? bible_instance->getPopularVerses(count) : std::vector<std::string>();
     }
     
-    // Event system
-    void addEventListener(const std::string& eventType, EventCallback callback) {
-        event_listeners[eventType].push_back(callback);
+    // Event system; listeners run on the TaskScheduler, never on the
+    // triggering thread, in order per owner (see PluginEventBus)
+    ListenerId addEventListener(const std::string& eventType, EventCallback callback, const std::string& owner = "") {
+        return events.addListener(eventType, std::move(callback), owner);
     }
     
     void removeEventListener(const std::string& eventType) {
-        event_listeners.erase(eventType);
+        events.removeListeners(eventType);
+    }
+    
+    void removeEventListener(ListenerId id) {
+        events.removeListener(id);
+    }
+    
+    void removeEventListenersOf(const std::string& owner) {
+        events.removeOwner(owner);
     }
     
     void triggerEvent(const PluginEvent& event) {
-        auto it = event_listeners.find(event.type);
-        if (it != event_listeners.end()) {
-            for (const auto& callback : it->second) {
-                try {
-                    callback(event);
-                } catch (...) {
-                    // Log error but don't crash
-                }
-            }
-        }
+        events.publish(event);
+    }
+    
+    void flushEvents() {
+        events.flush();
     }
     
     // Utility methods
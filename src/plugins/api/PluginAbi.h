@@ -0,0 +1,125 @@
+#ifndef PLUGIN_ABI_H
+#define PLUGIN_ABI_H
+
+/*
+ * Plugin ABI v2: a C function table the host hands to plugins, so that
+ * plugins built with another compiler or standard library can read verses
+ * straight out of the verse store. Verses are addressed by id, text comes
+ * back as pointer and length into the host's memory, and lookups take
+ * arrays rather than one call per verse. Nothing crosses the boundary as a
+ * C++ type, and nothing is copied or formatted on the way.
+ *
+ * A plugin opts in by returning "2.0" from getPluginApiVersion() and
+ * exporting bindHostApi(), which the host calls once before initialize().
+ * Later versions only append members to VfHostApi; check struct_size before
+ * using a member newer than the version the plugin was built against.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VF_PLUGIN_ABI_VERSION 2
+
+typedef uint32_t VfVerseId;
+#define VF_INVALID_VERSE_ID 0xFFFFFFFFu
+
+/* UTF-8 bytes owned by the host, not NUL-terminated */
+typedef struct VfStringView {
+    const char* data;
+    size_t size;
+} VfStringView;
+
+typedef struct VfVerse {
+    VfVerseId id;
+    uint32_t chapter;
+    uint32_t verse;
+    uint32_t reserved;
+    VfStringView book;
+    VfStringView text;
+} VfVerse;
+
+/* Canonical positions [first, last); see verse_at */
+typedef struct VfRange {
+    uint32_t first;
+    uint32_t last;
+} VfRange;
+
+/* An open translation. Its ids and views stay valid until it is closed. */
+typedef struct VfTranslation VfTranslation;
+
+/* A translation being imported; see begin_translation */
+typedef struct VfTranslationBuilder VfTranslationBuilder;
+
+typedef struct VfHostApi {
+    uint32_t abi_version; /* VF_PLUGIN_ABI_VERSION of the host */
+    uint32_t struct_size; /* sizeof(VfHostApi) as the host was built */
+    void* host;           /* passed back as the first argument of every call */
+
+    /* Reads the translation in if needed and keeps it resident until closed;
+     * NULL if it is unknown. A thread holding one open translation must not
+     * open another that is not yet resident: open what a task needs first. */
+    VfTranslation* (*open_translation)(void* host, const char* name);
+    void (*close_translation)(void* host, VfTranslation* translation);
+
+    /* Verses in canonical (book, chapter, verse) order: positions run from 0
+     * to verse_count - 1 and verse_at maps one to its id */
+    uint32_t (*verse_count)(void* host, const VfTranslation* translation);
+    VfVerseId (*verse_at)(void* host, const VfTranslation* translation, uint32_t position);
+    /* Positions [first, last) of a book; 0 if the book is unknown */
+    int (*book_range)(void* host, const VfTranslation* translation, const char* book,
+                      uint32_t* first, uint32_t* last);
+
+    /* Fill ids with up to capacity matches and return how many there are in
+     * all, so a caller whose buffer was short can call again with a larger one */
+    size_t (*find_passage)(void* host, const VfTranslation* translation, const char* reference,
+                           VfVerseId* ids, size_t capacity);
+    size_t (*search_keywords)(void* host, const VfTranslation* translation, const char* query,
+                              VfVerseId* ids, size_t capacity);
+
+    /* Batch lookup: out[i] describes ids[i], with id VF_INVALID_VERSE_ID for
+     * an unknown one. Returns how many were found. */
+    size_t (*get_verses)(void* host, const VfTranslation* translation, const VfVerseId* ids,
+                         size_t count, VfVerse* out);
+
+    /* Import for translation-format plugins: verses go straight into the
+     * verse store, in any order, with no JSON in between. source_file, if not
+     * NULL, is the file imported; a snapshot kept beside it lets later starts
+     * load it without the plugin. commit installs the translation and, like
+     * discard, frees the builder; it returns 0 if nothing was added or the
+     * name is taken. commit waits until no translation is open anywhere, so
+     * close yours first. */
+    VfTranslationBuilder* (*begin_translation)(void* host, const char* name, const char* abbreviation,
+                                               const char* language, const char* source_file);
+    int (*add_verse)(void* host, VfTranslationBuilder* builder, const char* book, uint32_t chapter,
+                     uint32_t verse, VfStringView text);
+    int (*commit_translation)(void* host, VfTranslationBuilder* builder);
+    void (*discard_translation)(void* host, VfTranslationBuilder* builder);
+
+    /* A passage ("Romans 8:28-39", "Ps 23; John 10:11-18") as runs of
+     * positions, one per span, filled and counted like find_passage: a long
+     * passage is a few ranges to walk with verse_at, not an id per verse */
+    size_t (*find_passage_ranges)(void* host, const VfTranslation* translation, const char* reference,
+                                  VfRange* ranges, size_t capacity);
+} VfHostApi;
+
+/* Exported by v2 plugins as bindHostApi */
+typedef void (*VfBindHostApiFunc)(const VfHostApi* api);
+
+/* Progress of an export: done of total verses written so far. Return 0 to
+ * cancel; the plugin then stops writing and its export returns false. */
+typedef int (*VfExportProgressFunc)(void* user, uint64_t done, uint64_t total);
+
+/* Optionally exported by v2 export plugins as setExportProgress. The host
+ * sets a callback before an export it runs in the background and clears it
+ * (NULL) afterwards; it never runs two exports of one plugin at once. */
+typedef void (*VfSetExportProgressFunc)(VfExportProgressFunc progress, void* user);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PLUGIN_ABI_H */
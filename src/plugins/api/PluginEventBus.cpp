@@ -0,0 +1,172 @@
+#include "PluginEventBus.h"
+#include "../../core/MetricsRegistry.h"
+#include "../../core/TaskScheduler.h"
+#include <algorithm>
+#include <iostream>
+
+namespace PluginSystem {
+
+PluginEventBus::PluginEventBus() {
+    registry.store(std::make_shared<const Registry>());
+}
+
+PluginEventBus::~PluginEventBus() {
+    std::lock_guard<std::mutex> lock(write_mutex);
+    registry.store(std::make_shared<const Registry>());
+    for (auto& [owner, queue] : queues) {
+        std::unique_lock<std::mutex> queue_lock(queue->mutex);
+        queue->closed = true;
+        queue->pending.clear();
+        queue->idle.wait(queue_lock, [&]() { return !queue->draining; });
+    }
+    queues.clear();
+}
+
+ListenerId PluginEventBus::addListener(const std::string& eventType, EventCallback callback, const std::string& owner) {
+    std::lock_guard<std::mutex> lock(write_mutex);
+
+    std::shared_ptr<Queue>& queue = queues[owner];
+    if (!queue) {
+        queue = std::make_shared<Queue>();
+        std::string labels = MetricsRegistry::label("plugin", owner.empty() ? "host" : owner);
+        queue->latency = &MetricsRegistry::shared().histogram(
+            "versefinder_plugin_event_dispatch_seconds", "Time from publishing an event to delivering it", labels);
+        queue->dropped = &MetricsRegistry::shared().counter(
+            "versefinder_plugin_events_dropped_total", "Events dropped from a full listener queue", labels);
+    }
+
+    auto listener = std::make_shared<Listener>();
+    listener->id = next_id++;
+    listener->callback = std::move(callback);
+    listener->queue = queue;
+
+    auto next = std::make_shared<Registry>(*registry.load());
+    (*next)[eventType].push_back(listener);
+    registry.store(std::move(next));
+    return listener->id;
+}
+
+template <typename Predicate>
+void PluginEventBus::removeWhere(Predicate remove) {
+    auto next = std::make_shared<Registry>(*registry.load());
+    for (auto it = next->begin(); it != next->end();) {
+        auto& listeners = it->second;
+        std::erase_if(listeners, [&](const std::shared_ptr<Listener>& listener) {
+            if (!remove(*listener)) return false;
+            // Deliveries already queued check this and skip the listener
+            listener->removed.store(true);
+            return true;
+        });
+        it = listeners.empty() ? next->erase(it) : std::next(it);
+    }
+    registry.store(std::move(next));
+}
+
+void PluginEventBus::removeListener(ListenerId id) {
+    std::lock_guard<std::mutex> lock(write_mutex);
+    removeWhere([id](const Listener& listener) { return listener.id == id; });
+}
+
+void PluginEventBus::removeListeners(const std::string& eventType) {
+    std::lock_guard<std::mutex> lock(write_mutex);
+    auto current = registry.load();
+    auto it = current->find(eventType);
+    if (it == current->end()) return;
+    std::vector<Listener*> targets;
+    for (const auto& listener : it->second) {
+        targets.push_back(listener.get());
+    }
+    removeWhere([&](const Listener& listener) {
+        return std::find(targets.begin(), targets.end(), &listener) != targets.end();
+    });
+}
+
+void PluginEventBus::removeOwner(const std::string& owner) {
+    std::shared_ptr<Queue> queue;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        auto it = queues.find(owner);
+        if (it == queues.end()) return;
+        queue = it->second;
+        queues.erase(it);
+        removeWhere([&](const Listener& listener) { return listener.queue == queue; });
+    }
+
+    std::unique_lock<std::mutex> lock(queue->mutex);
+    queue->closed = true;
+    queue->pending.clear();
+    queue->idle.wait(lock, [&]() { return !queue->draining; });
+}
+
+void PluginEventBus::publish(const PluginEvent& event) {
+    std::shared_ptr<const Registry> snapshot = registry.load();
+    auto it = snapshot->find(event.type);
+    if (it == snapshot->end()) return;
+
+    auto shared_event = std::make_shared<const PluginEvent>(event);
+    auto now = std::chrono::steady_clock::now();
+    for (const auto& listener : it->second) {
+        enqueue(listener->queue, Delivery{shared_event, listener, now});
+    }
+}
+
+void PluginEventBus::flush() {
+    std::vector<std::shared_ptr<Queue>> current;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        for (const auto& entry : queues) {
+            current.push_back(entry.second);
+        }
+    }
+    for (const auto& queue : current) {
+        std::unique_lock<std::mutex> lock(queue->mutex);
+        queue->idle.wait(lock, [&]() { return !queue->draining; });
+    }
+}
+
+void PluginEventBus::enqueue(const std::shared_ptr<Queue>& queue, Delivery delivery) {
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    if (queue->closed) return;
+    if (queue->pending.size() >= MAX_QUEUED_EVENTS) {
+        queue->pending.pop_front();
+        queue->dropped->add();
+    }
+    queue->pending.push_back(std::move(delivery));
+    if (!queue->draining) {
+        queue->draining = true;
+        TaskScheduler::shared().post([queue]() { drain(queue); });
+    }
+}
+
+void PluginEventBus::drain(const std::shared_ptr<Queue>& queue) {
+    for (size_t handled = 0;; handled++) {
+        Delivery delivery;
+        {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            if (queue->pending.empty()) {
+                queue->draining = false;
+                queue->idle.notify_all();
+                return;
+            }
+            if (handled == DRAIN_BATCH) {
+                // Still draining; continue in a fresh task so others get the worker
+                TaskScheduler::shared().post([queue]() { drain(queue); });
+                return;
+            }
+            delivery = std::move(queue->pending.front());
+            queue->pending.pop_front();
+        }
+
+        if (delivery.listener->removed.load()) continue;
+        queue->latency->observe(std::chrono::steady_clock::now() - delivery.published);
+        try {
+            delivery.listener->callback(*delivery.event);
+        } catch (const std::exception& e) {
+            std::cerr << "Plugin event listener for " << delivery.event->type << " threw: " << e.what() << std::endl;
+        } catch (...) {
+            std::cerr << "Plugin event listener for " << delivery.event->type << " threw" << std::endl;
+        }
+    }
+}
+
+} // namespace PluginSystem
@@ -0,0 +1,111 @@
+#ifndef PLUGIN_EVENT_BUS_H
+#define PLUGIN_EVENT_BUS_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Counter;
+class Histogram;
+
+namespace PluginSystem {
+
+// Event system for plugin communication
+class PluginEvent {
+public:
+    std::string type;
+    std::unordered_map<std::string, std::string> data;
+    std::string source;
+    std::chrono::steady_clock::time_point timestamp;
+
+    PluginEvent(const std::string& eventType, const std::string& sourcePlugin = "")
+        : type(eventType), source(sourcePlugin), timestamp(std::chrono::steady_clock::now()) {}
+
+    void setData(const std::string& key, const std::string& value) {
+        data[key] = value;
+    }
+
+    std::string getData(const std::string& key, const std::string& defaultValue = "") const {
+        auto it = data.find(key);
+        return it != data.end() ? it->second : defaultValue;
+    }
+};
+
+// Event listener interface
+using EventCallback = std::function<void(const PluginEvent&)>;
+using ListenerId = uint64_t;
+
+// Delivers events off the publishing thread. The listener table is an
+// immutable snapshot replaced whenever a listener is added or removed, so
+// publishing reads it without a lock. Each owner (a plugin, or "" for the
+// host) has its own queue, drained in order by one TaskScheduler task at a
+// time: a slow plugin only holds up its own events, never the publisher or
+// other plugins.
+class PluginEventBus {
+public:
+    static constexpr size_t MAX_QUEUED_EVENTS = 256; // per owner; the oldest are dropped past it
+    static constexpr size_t DRAIN_BATCH = 32;        // events per task before yielding the worker
+
+    PluginEventBus();
+    ~PluginEventBus(); // drops queued events and waits for deliveries in progress
+    PluginEventBus(const PluginEventBus&) = delete;
+    PluginEventBus& operator=(const PluginEventBus&) = delete;
+
+    ListenerId addListener(const std::string& eventType, EventCallback callback, const std::string& owner = "");
+    void removeListener(ListenerId id);
+    void removeListeners(const std::string& eventType);
+    // Removes everything owner registered, drops its queued events and waits
+    // for a delivery in progress; call before unloading the owner's code, and
+    // not from one of its listeners
+    void removeOwner(const std::string& owner);
+
+    void publish(const PluginEvent& event);
+    // Waits until every event published so far has been delivered
+    void flush();
+
+private:
+    struct Queue;
+    struct Listener {
+        ListenerId id;
+        EventCallback callback;
+        std::shared_ptr<Queue> queue;
+        std::atomic<bool> removed{false};
+    };
+    struct Delivery {
+        std::shared_ptr<const PluginEvent> event;
+        std::shared_ptr<Listener> listener;
+        std::chrono::steady_clock::time_point published;
+    };
+    struct Queue {
+        std::mutex mutex;
+        std::condition_variable idle;
+        std::deque<Delivery> pending;
+        bool draining = false;
+        bool closed = false;
+        Histogram* latency = nullptr; // publish to delivery
+        Counter* dropped = nullptr;
+    };
+    using Registry = std::unordered_map<std::string, std::vector<std::shared_ptr<Listener>>>;
+
+    std::atomic<std::shared_ptr<const Registry>> registry;
+    std::mutex write_mutex; // serializes writers; guards queues
+    std::unordered_map<std::string, std::shared_ptr<Queue>> queues;
+    ListenerId next_id = 1;
+
+    template <typename Predicate>
+    void removeWhere(Predicate remove);
+    static void enqueue(const std::shared_ptr<Queue>& queue, Delivery delivery);
+    static void drain(const std::shared_ptr<Queue>& queue);
+};
+
+} // namespace PluginSystem
+
+#endif // PLUGIN_EVENT_BUS_H
@@ -1,10 +1,13 @@
 #include "interfaces/PluginInterfaces.h"
 #include "api/PluginAPI.h"
 #include <algorithm>
-#include <regex>
+#include "RegexCache.h"
 
 using namespace PluginSystem;
 
+// Host function table, bound before initialize(); see PluginAbi.h
+static const VfHostApi* host_api = nullptr;
+
 class EnhancedSearchPlugin : public ISearchPlugin {
 private:
     PluginInfo info;
@@ -150,30 +153,51 @@ public:
     
 private:
     std::vector<std::string> regexSearch(const std::string& pattern, const std::string& translation, bool caseSensitive = false) {
-        try {
-            std::regex::flag_type flags = std::regex::optimize;
-            if (!caseSensitive) {
-                flags |= std::regex::icase;
+        // Patterns are compiled once and reused while the user keeps searching with them
+        RegexCache::Compiled compiled = RegexCache::shared().get(pattern, caseSensitive);
+        if (!compiled.regex) {
+            last_error = "Invalid regex pattern: " + compiled.error;
+            return {};
+        }
+        
+        std::vector<std::string> results;
+        if (!host_api) {
+            last_error = "Host API not bound";
+            return results;
+        }
+        VfTranslation* source = host_api->open_translation(host_api->host, translation.c_str());
+        if (!source) {
+            last_error = "Unknown translation: " + translation;
+            return results;
+        }
+        
+        // Every verse in order, matched in place in the host's store; only
+        // matches are formatted
+        constexpr uint32_t BATCH = 512;
+        std::vector<VfVerseId> ids(BATCH);
+        std::vector<VfVerse> verses(BATCH);
+        uint32_t total = host_api->verse_count(host_api->host, source);
+        for (uint32_t position = 0; position < total; position += BATCH) {
+            uint32_t count = std::min(BATCH, total - position);
+            for (uint32_t i = 0; i < count; ++i) {
+                ids[i] = host_api->verse_at(host_api->host, source, position + i);
             }
-            
-            std::regex regex(pattern, flags);
-            std::vector<std::string> results;
-            
-            // Get all verses and search through them
-            // This is a simplified implementation - in reality, we'd need to iterate through all verses
-            auto allVerses = api->searchByKeywords("", translation); // Get all verses (simplified)
-            
-            for (const auto& verse : allVerses) {
-                if (std::regex_search(verse, regex)) {
-                    results.push_back(verse);
+            host_api->get_verses(host_api->host, source, ids.data(), count, verses.data());
+            for (uint32_t i = 0; i < count; ++i) {
+                const VfVerse& verse = verses[i];
+                if (verse.id == VF_INVALID_VERSE_ID ||
+                    !std::regex_search(verse.text.data, verse.text.data + verse.text.size, *compiled.regex)) {
+                    continue;
                 }
+                std::string result(verse.book.data, verse.book.size);
+                result += " " + std::to_string(verse.chapter) + ":" + std::to_string(verse.verse) + ": ";
+                result.append(verse.text.data, verse.text.size);
+                results.push_back(std::move(result));
             }
-            
-            return results;
-        } catch (const std::regex_error& e) {
-            last_error = "Invalid regex pattern: " + std::string(e.what());
-            return {};
         }
+        host_api->close_translation(host_api->host, source);
+        
+        return results;
     }
     
     std::vector<std::string> wildcardSearch(const std::string& pattern, const std::string& translation, bool caseSensitive = false) {
@@ -323,7 +347,11 @@ extern "C" {
     }
     
     const char* getPluginApiVersion() {
-        return "1.0";
+        return "2.0";
+    }
+    
+    void bindHostApi(const VfHostApi* api) {
+        host_api = api;
     }
     
     const char* getPluginType() {
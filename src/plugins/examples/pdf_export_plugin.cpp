@@ -6,9 +6,63 @@
 #include <algorithm>
 #include <iomanip>
 #include <chrono>
+#include <cstddef>
+#include <cstdio>
 
 using namespace PluginSystem;
 
+// Host function table, bound before initialize(); see PluginAbi.h
+static const VfHostApi* host_api = nullptr;
+// Set by the host around background exports; see setExportProgress
+static VfExportProgressFunc export_progress = nullptr;
+static void* export_progress_user = nullptr;
+
+// Writes a document to its file as it is produced, a buffer at a time, so an
+// export takes the same memory whatever its length
+class StreamingWriter {
+private:
+    static constexpr size_t FLUSH_BYTES = 64 * 1024;
+    std::ofstream file;
+    std::string buffer;
+
+public:
+    bool open(const std::string& path) {
+        file.open(path, std::ios::binary | std::ios::trunc);
+        buffer.reserve(FLUSH_BYTES + 4096);
+        return file.is_open();
+    }
+
+    StreamingWriter& operator<<(std::string_view text) {
+        buffer.append(text);
+        if (buffer.size() >= FLUSH_BYTES) flush();
+        return *this;
+    }
+
+    void escaped(std::string_view text) {
+        for (char c : text) {
+            switch (c) {
+                case '&': buffer += "&amp;"; break;
+                case '<': buffer += "&lt;"; break;
+                case '>': buffer += "&gt;"; break;
+                case '"': buffer += "&quot;"; break;
+                default: buffer += c; break;
+            }
+        }
+        if (buffer.size() >= FLUSH_BYTES) flush();
+    }
+
+    void flush() {
+        file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+    bool close() {
+        flush();
+        file.close();
+        return !file.fail();
+    }
+};
+
 class PDFExportPlugin : public IExportPlugin {
 private:
     PluginInfo info;
@@ -119,24 +173,25 @@ public:
                 return false;
             }
             
-            // Generate HTML content that can be converted to PDF
-            std::string htmlContent = generateHTMLContent(verses, references, defaultOptions);
-            
             // For this example, we'll save as HTML with PDF-like formatting
             // In a real implementation, you might use a PDF library like libharu or wkhtmltopdf
-            std::string outputFile = filename;
-            if (outputFile.find(".pdf") != std::string::npos) {
-                outputFile = outputFile.substr(0, outputFile.find(".pdf")) + ".html";
-            }
-            
-            std::ofstream file(outputFile);
-            if (!file.is_open()) {
+            std::string outputFile = htmlPathFor(filename);
+            StreamingWriter out;
+            if (!out.open(outputFile)) {
                 last_error = "Cannot open file for writing: " + outputFile;
                 return false;
             }
             
-            file << htmlContent;
-            file.close();
+            out << htmlPrologue(defaultOptions);
+            for (size_t i = 0; i < verses.size(); ++i) {
+                writeVerse(out, references[i], verses[i], defaultOptions.separateVerses && i > 0);
+            }
+            out << htmlEpilogue(defaultOptions);
+            if (!out.close()) {
+                last_error = "Cannot write " + outputFile;
+                std::remove(outputFile.c_str());
+                return false;
+            }
             
             // Log success
             if (api) {
@@ -157,22 +212,19 @@ public:
     
     bool exportServicePlan(const std::string& planData, const std::string& filename) override {
         try {
-            // Parse service plan data and create formatted output
-            std::string htmlContent = generateServicePlanHTML(planData, defaultOptions);
-            
-            std::string outputFile = filename;
-            if (outputFile.find(".pdf") != std::string::npos) {
-                outputFile = outputFile.substr(0, outputFile.find(".pdf")) + ".html";
-            }
-            
-            std::ofstream file(outputFile);
-            if (!file.is_open()) {
+            std::string outputFile = htmlPathFor(filename);
+            StreamingWriter out;
+            if (!out.open(outputFile)) {
                 last_error = "Cannot open file for writing: " + outputFile;
                 return false;
             }
             
-            file << htmlContent;
-            file.close();
+            writeServicePlan(out, planData, defaultOptions);
+            if (!out.close()) {
+                last_error = "Cannot write " + outputFile;
+                std::remove(outputFile.c_str());
+                return false;
+            }
             
             last_error.clear();
             return true;
@@ -183,6 +235,107 @@ public:
         }
     }
     
+    bool exportPassage(const std::string& passage, const std::string& translation,
+                       const std::string& filename) override {
+        if (!host_api) {
+            last_error = "Host API not bound";
+            return false;
+        }
+        VfTranslation* source = host_api->open_translation(host_api->host, translation.c_str());
+        if (!source) {
+            last_error = "Unknown translation: " + translation;
+            return false;
+        }
+        
+        // The passage as runs of canonical positions, walked a batch at a
+        // time: a book is one range, and nothing is held per verse
+        std::vector<VfRange> ranges(1);
+        std::vector<VfVerseId> ids; // hosts older than find_passage_ranges
+        bool host_has_ranges = host_api->struct_size >= offsetof(VfHostApi, find_passage_ranges) +
+                                                        sizeof(host_api->find_passage_ranges) &&
+                               host_api->find_passage_ranges;
+        if (!host_api->book_range(host_api->host, source, passage.c_str(), &ranges[0].first, &ranges[0].last)) {
+            if (host_has_ranges) {
+                ranges.resize(host_api->find_passage_ranges(host_api->host, source, passage.c_str(), nullptr, 0));
+                host_api->find_passage_ranges(host_api->host, source, passage.c_str(), ranges.data(), ranges.size());
+            } else {
+                ranges.clear();
+                ids.resize(host_api->find_passage(host_api->host, source, passage.c_str(), nullptr, 0));
+                host_api->find_passage(host_api->host, source, passage.c_str(), ids.data(), ids.size());
+            }
+        }
+        uint64_t total = ids.size();
+        for (const VfRange& range : ranges) {
+            total += range.last - range.first;
+        }
+        if (total == 0) {
+            host_api->close_translation(host_api->host, source);
+            last_error = "No verses found for " + passage;
+            return false;
+        }
+        
+        ExportOptions options = defaultOptions;
+        options.titleText = passage + " (" + translation + ")";
+        
+        std::string outputFile = htmlPathFor(filename);
+        StreamingWriter out;
+        if (!out.open(outputFile)) {
+            host_api->close_translation(host_api->host, source);
+            last_error = "Cannot open file for writing: " + outputFile;
+            return false;
+        }
+        out << htmlPrologue(options);
+        
+        // Verses are written straight from the host's store as they are read
+        constexpr size_t BATCH = 512;
+        std::vector<VfVerseId> batch_ids(BATCH);
+        std::vector<VfVerse> batch(BATCH);
+        uint64_t done = 0;
+        bool cancelled = false;
+        auto writeBatch = [&](const VfVerseId* batch_start, size_t count) {
+            host_api->get_verses(host_api->host, source, batch_start, count, batch.data());
+            for (size_t i = 0; i < count; ++i) {
+                const VfVerse& verse = batch[i];
+                if (verse.id == VF_INVALID_VERSE_ID) continue;
+                std::string reference(verse.book.data, verse.book.size);
+                reference += ' ';
+                reference += std::to_string(verse.chapter);
+                reference += ':';
+                reference += std::to_string(verse.verse);
+                writeVerse(out, reference, std::string_view(verse.text.data, verse.text.size),
+                           options.separateVerses && (done + i) > 0);
+            }
+            done += count;
+            if (export_progress && !export_progress(export_progress_user, done, total)) {
+                cancelled = true;
+            }
+        };
+        for (const VfRange& range : ranges) {
+            for (uint32_t position = range.first; position < range.last && !cancelled;) {
+                size_t count = std::min<size_t>(BATCH, range.last - position);
+                for (size_t i = 0; i < count; ++i) {
+                    batch_ids[i] = host_api->verse_at(host_api->host, source, position + static_cast<uint32_t>(i));
+                }
+                writeBatch(batch_ids.data(), count);
+                position += static_cast<uint32_t>(count);
+            }
+        }
+        for (size_t offset = 0; offset < ids.size() && !cancelled; offset += BATCH) {
+            writeBatch(ids.data() + offset, std::min(BATCH, ids.size() - offset));
+        }
+        host_api->close_translation(host_api->host, source);
+        
+        out << htmlEpilogue(options);
+        if (!out.close() || cancelled) {
+            last_error = cancelled ? "Export cancelled" : "Cannot write " + outputFile;
+            std::remove(outputFile.c_str());
+            return false;
+        }
+        
+        last_error.clear();
+        return true;
+    }
+    
     std::string getFormatName() const override {
         return "PDF Document";
     }
@@ -208,9 +361,27 @@ public:
     }
 
 private:
-    std::string generateHTMLContent(const std::vector<std::string>& verses,
-                                   const std::vector<std::string>& references,
-                                   const ExportOptions& options) {
+    // Exports are HTML laid out for printing; a .pdf name gets .html instead
+    static std::string htmlPathFor(const std::string& filename) {
+        if (filename.find(".pdf") != std::string::npos) {
+            return filename.substr(0, filename.find(".pdf")) + ".html";
+        }
+        return filename;
+    }
+    
+    static void writeVerse(StreamingWriter& out, std::string_view reference, std::string_view text, bool separated) {
+        if (separated) {
+            out << "<div class=\"verse-separator\"></div>\n";
+        }
+        out << "<div class=\"verse-container\">\n<div class=\"verse-reference\">";
+        out.escaped(reference);
+        out << "</div>\n<div class=\"verse-text\">";
+        out.escaped(text);
+        out << "</div>\n</div>\n";
+    }
+    
+    // Document start, header and the opening of the content block
+    std::string htmlPrologue(const ExportOptions& options) {
         std::ostringstream html;
         
         // HTML document start with CSS styling
@@ -234,18 +405,12 @@ private:
         
         // Content
         html << "<div class=\"content\">\n";
-        
-        for (size_t i = 0; i < verses.size(); ++i) {
-            if (options.separateVerses && i > 0) {
-                html << "<div class=\"verse-separator\"></div>\n";
-            }
-            
-            html << "<div class=\"verse-container\">\n";
-            html << "<div class=\"verse-reference\">" << escapeHTML(references[i]) << "</div>\n";
-            html << "<div class=\"verse-text\">" << escapeHTML(verses[i]) << "</div>\n";
-            html << "</div>\n";
-        }
-        
+        return html.str();
+    }
+    
+    // Closes the content block, then footer and document end
+    std::string htmlEpilogue(const ExportOptions& options) {
+        std::ostringstream html;
         html << "</div>\n";
         
         // Footer
@@ -259,11 +424,10 @@ private:
         }
         
         html << "</body>\n</html>";
-        
         return html.str();
     }
     
-    std::string generateServicePlanHTML(const std::string& planData, const ExportOptions& options) {
+    void writeServicePlan(StreamingWriter& out, const std::string& planData, const ExportOptions& options) {
         std::ostringstream html;
         
         html << "<!DOCTYPE html>\n";
@@ -288,7 +452,11 @@ private:
         html << "<div class=\"content\">\n";
         html << "<div class=\"service-item\">\n";
         html << "<div class=\"service-title\">Service Order</div>\n";
-        html << "<div class=\"verse-text\">" << escapeHTML(planData) << "</div>\n";
+        html << "<div class=\"verse-text\">";
+        out << html.str();
+        out.escaped(planData);
+        html.str("");
+        html << "</div>\n";
         html << "</div>\n";
         html << "</div>\n";
         
@@ -299,8 +467,7 @@ private:
         }
         
         html << "</body>\n</html>";
-        
-        return html.str();
+        out << html.str();
     }
     
     std::string generateCSS(const ExportOptions& options) {
@@ -393,37 +560,6 @@ private:
         return css.str();
     }
     
-    std::string escapeHTML(const std::string& text) {
-        std::string escaped = text;
-        
-        // Replace HTML special characters
-        std::string::size_type pos = 0;
-        while ((pos = escaped.find("&", pos)) != std::string::npos) {
-            escaped.replace(pos, 1, "&amp;");
-            pos += 5;
-        }
-        
-        pos = 0;
-        while ((pos = escaped.find("<", pos)) != std::string::npos) {
-            escaped.replace(pos, 1, "&lt;");
-            pos += 4;
-        }
-        
-        pos = 0;
-        while ((pos = escaped.find(">", pos)) != std::string::npos) {
-            escaped.replace(pos, 1, "&gt;");
-            pos += 4;
-        }
-        
-        pos = 0;
-        while ((pos = escaped.find("\"", pos)) != std::string::npos) {
-            escaped.replace(pos, 1, "&quot;");
-            pos += 6;
-        }
-        
-        return escaped;
-    }
-    
     std::string getCurrentDateTime() {
         auto now = std::chrono::system_clock::now();
         auto time_t = std::chrono::system_clock::to_time_t(now);
@@ -445,7 +581,16 @@ extern "C" {
     }
     
     const char* getPluginApiVersion() {
-        return "1.0";
+        return "2.0";
+    }
+    
+    void bindHostApi(const VfHostApi* api) {
+        host_api = api;
+    }
+    
+    void setExportProgress(VfExportProgressFunc progress, void* user) {
+        export_progress = progress;
+        export_progress_user = user;
     }
     
     const char* getPluginType() {
@@ -144,7 +144,9 @@ class ITranslationPlugin : public IPlugin {
 public:
     virtual ~ITranslationPlugin() = default;
     
-    // Translation parsing
+    // Translation parsing. Feed verses to bible->beginTranslation() (or the
+    // host API's begin_translation) as they are parsed rather than building
+    // JSON for addTranslation() to parse again.
     virtual bool canParse(const std::string& filename) const = 0;
     virtual bool parseFile(const std::string& filename, VerseFinder* bible) = 0;
     virtual bool parseData(const std::string& data, VerseFinder* bible) = 0;
@@ -209,6 +211,11 @@ public:
                             const std::vector<std::string>& references,
                             const std::string& filename) = 0;
     virtual bool exportServicePlan(const std::string& planData, const std::string& filename) = 0;
+    // Exports a whole book, chapter or verse ("Genesis", "John 3") read
+    // through the host API. Only call on plugins loaded as API version 2.0;
+    // earlier plugins were built without this slot.
+    virtual bool exportPassage(const std::string& passage, const std::string& translation,
+                               const std::string& filename) { return false; }
     
     // Format info
     virtual std::string getFormatName() const = 0;
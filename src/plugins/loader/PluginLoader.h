@@ -2,6 +2,7 @@
 #define PLUGIN_LOADER_H
 
 #include "../interfaces/PluginInterfaces.h"
+#include "../api/PluginAbi.h"
 #include <string>
 #include <memory>
 
@@ -126,6 +127,8 @@ private:
     std::unique_ptr<IPlugin> plugin_instance;
     CreatePluginFunc create_func;
     DestroyPluginFunc destroy_func;
+    VfBindHostApiFunc bind_host_api = nullptr; // v2 plugins only
+    VfSetExportProgressFunc set_export_progress = nullptr; // v2 export plugins that report progress
     std::string plugin_type;
     std::string api_version;
     std::string last_error;
@@ -157,7 +160,14 @@ private:
         }
         
         api_version = getApiVersion();
-        if (api_version != "1.0") {
+        if (api_version == "2.0") {
+            bind_host_api = library->getFunction<VfBindHostApiFunc>("bindHostApi");
+            if (!bind_host_api) {
+                last_error = "Missing bindHostApi function";
+                return false;
+            }
+            set_export_progress = library->getFunction<VfSetExportProgressFunc>("setExportProgress");
+        } else if (api_version != "1.0") {
             last_error = "Unsupported API version: " + api_version;
             return false;
         }
@@ -221,6 +231,24 @@ public:
         
         create_func = nullptr;
         destroy_func = nullptr;
+        bind_host_api = nullptr;
+        set_export_progress = nullptr;
+    }
+    
+    // Hands a v2 plugin the host's function table; v1 plugins are left alone
+    void bindHostApi(const VfHostApi* api) {
+        if (bind_host_api) bind_host_api(api);
+    }
+    
+    bool hasHostApi() const {
+        return bind_host_api != nullptr;
+    }
+    
+    // False if the plugin does not report export progress
+    bool setExportProgress(VfExportProgressFunc progress, void* user) {
+        if (!set_export_progress) return false;
+        set_export_progress(progress, user);
+        return true;
     }
     
     IPlugin* getPlugin() const {
@@ -1,10 +1,35 @@
 #include "PluginManager.h"
+#include "../../core/MetricsRegistry.h"
+#include "../../core/PerformanceBenchmark.h"
+#include "../../core/TaskScheduler.h"
 #include <iostream>
 #include <fstream>
+#include <cstdio>
 #include <algorithm>
+#include <thread>
 
 namespace PluginSystem {
 
+namespace {
+
+std::string trimmed(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return "";
+    return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+// VfExportProgressFunc over a PluginExportProgress
+int reportExportProgress(void* user, uint64_t done, uint64_t total) {
+    try {
+        return (*static_cast<PluginExportProgress*>(user))(done, total) ? 1 : 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Export progress callback failed: " << e.what() << std::endl;
+        return 0;
+    }
+}
+
+} // namespace
+
 PluginManager::PluginManager(VerseFinder* bible) 
     : api(std::make_unique<PluginAPI>(bible)),
       security(std::make_unique<PluginSecurity>()) {
@@ -42,12 +67,18 @@ bool PluginManager::initialize(const std::string& pluginsDir, const std::string&
 }
 
 void PluginManager::shutdown() {
-    std::lock_guard<std::mutex> lock(plugins_mutex);
+    // Deferred activations still queued would load into a manager going away
+    while (pending_activations.load() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
     
-    // Unload all plugins in reverse order
+    // Unload all plugins in reverse order; unloadPlugin takes the lock itself
     std::vector<std::string> plugin_names;
-    for (const auto& entry : plugins) {
-        plugin_names.push_back(entry.first);
+    {
+        std::lock_guard<std::mutex> lock(plugins_mutex);
+        for (const auto& entry : plugins) {
+            plugin_names.push_back(entry.first);
+        }
     }
     
     for (auto it = plugin_names.rbegin(); it != plugin_names.rend(); ++it) {
@@ -85,10 +116,25 @@ bool PluginManager::loadPlugin(const std::string& pluginName) {
     }
     
     // Create plugin loader
+    size_t resident_kb_before = PerformanceBenchmark::getCurrentMemoryUsage();
     entry.loader = std::make_unique<PluginLoader>();
     
     // Get plugin library path
-    std::string libraryPath = plugins_directory + "/" + getPluginLibraryName(pluginName);
+    std::string libraryPath = entry.library_path.empty()
+        ? plugins_directory + "/" + getPluginLibraryName(pluginName) : entry.library_path;
+    
+    // Discovery has checked the file already, unless it changed since
+    std::error_code time_error;
+    auto write_time = std::filesystem::last_write_time(libraryPath, time_error);
+    if (time_error || write_time != entry.verified_write_time) {
+        std::string error = verifyPluginFile(libraryPath);
+        if (!error.empty()) {
+            updatePluginState(pluginName, PluginState::ERROR, error);
+            triggerLoadCallbacks(pluginName, false, error);
+            return false;
+        }
+        entry.verified_write_time = write_time;
+    }
     
     // Load the plugin library
     if (!entry.loader->loadPlugin(libraryPath)) {
@@ -107,6 +153,12 @@ bool PluginManager::loadPlugin(const std::string& pluginName) {
         return false;
     }
     
+    if (entry.manifest.present && entry.manifest.type != entry.loader->getPluginType()) {
+        std::cerr << "Plugin " << pluginName << " is a " << entry.loader->getPluginType()
+                  << " plugin but its manifest says " << entry.manifest.type << std::endl;
+        entry.manifest.type = entry.loader->getPluginType();
+    }
+    
     // Validate dependencies
     if (!validateDependencies(plugin->getInfo())) {
         std::string error = "Plugin dependencies not satisfied";
@@ -125,6 +177,9 @@ bool PluginManager::loadPlugin(const std::string& pluginName) {
     
     updatePluginState(pluginName, PluginState::LOADED);
     
+    // v2 plugins read verses through the C function table rather than PluginAPI
+    entry.loader->bindHostApi(api->getHostApi());
+    
     // Initialize the plugin
     if (!plugin->initialize()) {
         std::string error = "Plugin initialization failed: " + plugin->getLastError();
@@ -146,6 +201,11 @@ bool PluginManager::loadPlugin(const std::string& pluginName) {
         plugin->onActivate();
         updatePluginState(pluginName, PluginState::ACTIVE);
         entry.load_time = std::chrono::steady_clock::now();
+        entry.search_suspended = false;
+        entry.deferred = false;
+        plugin_metrics[pluginName].consecutive_overruns = 0;
+        size_t resident_kb_after = PerformanceBenchmark::getCurrentMemoryUsage();
+        entry.memory.set(resident_kb_after > resident_kb_before ? (resident_kb_after - resident_kb_before) * 1024 : 0);
         
         // Trigger plugin loaded event
         PluginEvent event(Events::PLUGIN_LOADED, "PluginManager");
@@ -165,6 +225,10 @@ bool PluginManager::loadPlugin(const std::string& pluginName) {
 }
 
 bool PluginManager::unloadPlugin(const std::string& pluginName) {
+    // Before taking the lock: this waits for the plugin's listener to return,
+    // and the listener may be calling into the manager
+    api->removeEventListenersOf(pluginName);
+    
     std::lock_guard<std::mutex> lock(plugins_mutex);
     
     auto it = plugins.find(pluginName);
@@ -191,8 +255,14 @@ bool PluginManager::unloadPlugin(const std::string& pluginName) {
         }
     }
     
+    // A federated search or an export may still be running plugin code on the scheduler
+    while (entry.calls_in_flight->load() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    
     // Unload the plugin library
     entry.loader.reset();
+    entry.memory.set(0);
     
     updatePluginState(pluginName, PluginState::UNLOADED);
     
@@ -242,6 +312,186 @@ PluginState PluginManager::getPluginState(const std::string& pluginName) const {
     return it != plugins.end() ? it->second->state : PluginState::UNLOADED;
 }
 
+PluginSearchBatch PluginManager::startPluginSearches(const std::string& query, const std::string& translation,
+                                                     std::chrono::milliseconds budget) {
+    PluginSearchBatch batch;
+    auto now = std::chrono::steady_clock::now();
+    batch.deadline = now + budget;
+    
+    // A deferred search plugin starts loading now and joins later searches;
+    // this one does not wait for it
+    activateDeferredPluginsAsync(pluginTypeName<ISearchPlugin>());
+    
+    std::lock_guard<std::mutex> lock(plugins_mutex);
+    for (const auto& [name, entry] : plugins) {
+        if (entry->state != PluginState::ACTIVE || entry->search_suspended || !entry->loader) continue;
+        auto* plugin = dynamic_cast<ISearchPlugin*>(entry->loader->getPlugin());
+        if (!plugin) continue;
+        
+        double quality = 0.0;
+        try {
+            if (!plugin->supportsTranslation(translation)) continue;
+            quality = plugin->getSearchQuality(query);
+        } catch (const std::exception& e) {
+            recordPluginError(name);
+            std::cerr << "Plugin search error in " << name << ": " << e.what() << std::endl;
+            continue;
+        }
+        if (quality <= 0.0) continue;
+        
+        // The task keeps the library loaded through the in-flight count and
+        // never touches the manager, so it may outlive the batch
+        auto in_flight = entry->calls_in_flight;
+        in_flight->fetch_add(1);
+        auto results = TaskScheduler::shared().submit([plugin, in_flight, query, translation]() {
+            try {
+                auto found = plugin->search(query, translation);
+                in_flight->fetch_sub(1);
+                return found;
+            } catch (...) {
+                in_flight->fetch_sub(1);
+                throw;
+            }
+        });
+        batch.calls.push_back(PluginSearchBatch::Call{name, std::clamp(quality, 0.0, 1.0), now, std::move(results)});
+    }
+    return batch;
+}
+
+bool PluginManager::exportPassageAsync(const std::string& pluginName, const std::string& passage,
+                                       const std::string& translation, const std::string& filename,
+                                       PluginExportProgress progress, PluginExportDone done) {
+    activateDeferredPlugins(pluginTypeName<IExportPlugin>());
+    
+    std::lock_guard<std::mutex> lock(plugins_mutex);
+    auto it = plugins.find(pluginName);
+    if (it == plugins.end() || it->second->state != PluginState::ACTIVE || !it->second->loader ||
+        !it->second->loader->hasHostApi()) {
+        last_error = "Not an active v2 plugin: " + pluginName;
+        return false;
+    }
+    PluginEntry& entry = *it->second;
+    auto* plugin = dynamic_cast<IExportPlugin*>(entry.loader->getPlugin());
+    if (!plugin) {
+        last_error = "Not an export plugin: " + pluginName;
+        return false;
+    }
+    if (entry.exporting->exchange(true)) {
+        last_error = pluginName + " is already exporting";
+        return false;
+    }
+    
+    // As with searches, the in-flight count keeps the library loaded while
+    // the task runs, and the task never touches the manager
+    auto in_flight = entry.calls_in_flight;
+    auto exporting = entry.exporting;
+    PluginLoader* loader = entry.loader.get();
+    in_flight->fetch_add(1);
+    TaskScheduler::shared().post([plugin, loader, in_flight, exporting, passage, translation, filename,
+                                  progress = std::move(progress), done = std::move(done)]() mutable {
+        if (progress) {
+            loader->setExportProgress(reportExportProgress, &progress);
+        }
+        bool success = false;
+        std::string error;
+        try {
+            success = plugin->exportPassage(passage, translation, filename);
+            if (!success) error = plugin->getLastError();
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        loader->setExportProgress(nullptr, nullptr);
+        exporting->store(false);
+        in_flight->fetch_sub(1);
+        if (done) done(success, error);
+    });
+    return true;
+}
+
+std::vector<std::string> PluginManager::mergePluginSearches(PluginSearchBatch& batch,
+                                                            std::vector<std::string> core_results) {
+    if (batch.calls.empty()) return core_results;
+    
+    struct Merged {
+        std::string text;
+        double score;
+        size_t order;
+    };
+    std::vector<Merged> merged;
+    std::unordered_map<std::string, size_t> by_reference;
+    
+    // Reciprocal rank, weighted by how much the source is trusted for this
+    // query; a verse several sources agree on collects all their weights
+    auto add = [&](std::vector<std::string>& results, double weight) {
+        for (size_t rank = 0; rank < results.size(); rank++) {
+            std::string& text = results[rank];
+            std::string reference = text.substr(0, text.find(": "));
+            double score = weight / (1.0 + rank);
+            auto [it, inserted] = by_reference.try_emplace(std::move(reference), merged.size());
+            if (inserted) {
+                merged.push_back(Merged{std::move(text), score, merged.size()});
+            } else {
+                merged[it->second].score += score;
+            }
+        }
+    };
+    add(core_results, 1.0);
+    
+    for (auto& call : batch.calls) {
+        bool in_time = call.results.wait_until(batch.deadline) == std::future_status::ready;
+        std::vector<std::string> results;
+        bool failed = false;
+        if (in_time) {
+            try {
+                results = call.results.get();
+            } catch (const std::exception& e) {
+                failed = true;
+                std::cerr << "Plugin search error in " << call.plugin << ": " << e.what() << std::endl;
+            }
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(plugins_mutex);
+            auto& metrics = plugin_metrics[call.plugin];
+            if (failed) {
+                recordPluginError(call.plugin);
+            } else if (in_time) {
+                recordPluginCall(call.plugin, std::chrono::duration_cast<std::chrono::microseconds>(
+                                                  std::chrono::steady_clock::now() - call.started));
+                metrics.consecutive_overruns = 0;
+            } else {
+                metrics.recordOverrun();
+                MetricsRegistry::shared()
+                    .counter("versefinder_plugin_search_overruns_total", "Plugin searches that missed their deadline",
+                             MetricsRegistry::label("plugin", call.plugin))
+                    .add();
+                auto it = plugins.find(call.plugin);
+                if (metrics.consecutive_overruns >= MAX_SEARCH_OVERRUNS && it != plugins.end() &&
+                    !it->second->search_suspended) {
+                    it->second->search_suspended = true;
+                    std::cerr << "Plugin " << call.plugin << " missed its search deadline "
+                              << metrics.consecutive_overruns << " times in a row; leaving it out of searches"
+                              << std::endl;
+                }
+            }
+        }
+        
+        // A late result is dropped; its future is left to finish on the worker
+        if (in_time && !failed) add(results, call.quality);
+    }
+    batch.calls.clear();
+    
+    std::sort(merged.begin(), merged.end(), [](const Merged& a, const Merged& b) {
+        return a.score != b.score ? a.score > b.score : a.order < b.order;
+    });
+    std::vector<std::string> results;
+    results.reserve(merged.size());
+    for (auto& entry : merged) {
+        results.push_back(std::move(entry.text));
+    }
+    return results;
+}
+
 void PluginManager::triggerEvent(const PluginEvent& event) {
     api->triggerEvent(event);
 }
@@ -288,9 +538,31 @@ PluginInfo PluginManager::getPluginInfo(const std::string& pluginName) const {
     if (it != plugins.end() && it->second->loader && it->second->loader->getPlugin()) {
         return it->second->loader->getPlugin()->getInfo();
     }
+    if (it != plugins.end() && it->second->manifest.present) {
+        return it->second->manifest.info;
+    }
     return PluginInfo(); // Return empty info if not found
 }
 
+std::string PluginManager::getPluginType(const std::string& pluginName) const {
+    std::lock_guard<std::mutex> lock(plugins_mutex);
+    auto it = plugins.find(pluginName);
+    if (it == plugins.end()) return "";
+    return it->second->loader ? it->second->loader->getPluginType() : it->second->manifest.type;
+}
+
+std::vector<std::string> PluginManager::getPluginsByType(const std::string& type) const {
+    std::lock_guard<std::mutex> lock(plugins_mutex);
+    std::vector<std::string> result;
+    for (const auto& [name, entry] : plugins) {
+        const std::string& entry_type = entry->loader ? entry->loader->getPluginType() : entry->manifest.type;
+        if (entry_type == type) {
+            result.push_back(name);
+        }
+    }
+    return result;
+}
+
 std::string PluginManager::getPluginError(const std::string& pluginName) const {
     std::lock_guard<std::mutex> lock(plugins_mutex);
     auto it = plugins.find(pluginName);
@@ -448,6 +720,12 @@ std::vector<std::string> PluginManager::getPluginFiles(const std::string& direct
 #endif
                     // Remove extension to get plugin name
                     std::string pluginName = filename.substr(0, filename.find_last_of('.'));
+#ifndef _WIN32
+                    // and the prefix getPluginLibraryName() puts back
+                    if (pluginName.rfind("lib", 0) == 0) {
+                        pluginName.erase(0, 3);
+                    }
+#endif
                     result.push_back(pluginName);
                 }
             }
@@ -503,27 +781,169 @@ void PluginManager::triggerUnloadCallbacks(const std::string& pluginName) {
 }
 
 bool PluginManager::scanForPlugins() {
+    auto start = std::chrono::steady_clock::now();
     std::vector<std::string> available = getAvailablePlugins();
     
-    for (const std::string& pluginName : available) {
+    // Reading manifests and checking files touch nothing shared, so every
+    // plugin is looked at at once; no library is loaded here
+    struct Discovery {
+        std::string library_path;
+        std::filesystem::file_time_type write_time{};
+        PluginManifest manifest;
+        std::string error;
+    };
+    std::vector<Discovery> found(available.size());
+    TaskScheduler::shared().parallelFor(available.size(), [&](size_t i) {
+        Discovery& discovery = found[i];
+        discovery.library_path = plugins_directory + "/" + getPluginLibraryName(available[i]);
+        std::error_code time_error;
+        discovery.write_time = std::filesystem::last_write_time(discovery.library_path, time_error);
+        discovery.manifest = readManifest(available[i]);
+        discovery.error = verifyPluginFile(discovery.library_path);
+    });
+    
+    std::vector<std::string> to_load;
+    size_t deferred = 0;
+    {
         std::lock_guard<std::mutex> lock(plugins_mutex);
-        
-        // Create entry if it doesn't exist
-        if (plugins.find(pluginName) == plugins.end()) {
-            plugins[pluginName] = std::make_unique<PluginEntry>();
+        for (size_t i = 0; i < available.size(); i++) {
+            const std::string& pluginName = available[i];
+            Discovery& discovery = found[i];
+            
+            // Create entry if it doesn't exist
+            auto& entry = plugins[pluginName];
+            if (!entry) {
+                entry = std::make_unique<PluginEntry>();
+            }
+            if (entry->state != PluginState::UNLOADED) continue;
+            
+            entry->library_path = discovery.library_path;
+            entry->manifest = std::move(discovery.manifest);
+            if (!discovery.error.empty()) {
+                updatePluginState(pluginName, PluginState::ERROR, discovery.error);
+                std::cerr << "Plugin " << pluginName << ": " << discovery.error << std::endl;
+                continue;
+            }
+            entry->verified_write_time = discovery.write_time;
+            
+            // Auto-start plugins wait for their type to be used when the
+            // manifest says what that type is; others load now
+            if (!entry->auto_start) continue;
+            if (entry->manifest.present) {
+                entry->deferred = true;
+                deferred++;
+            } else {
+                to_load.push_back(pluginName);
+            }
         }
+    }
+    
+    // loadPlugin takes the lock itself
+    for (const std::string& pluginName : to_load) {
+        loadPlugin(pluginName);
+    }
+    
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "Plugins: found " << available.size() << ", loaded " << to_load.size() << ", "
+              << deferred << " deferred until first use (" << elapsed.count() << " ms)" << std::endl;
+    return true;
+}
+
+PluginManifest PluginManager::readManifest(const std::string& pluginName) const {
+    PluginManifest manifest;
+    std::ifstream file(plugins_directory + "/" + pluginName + ".manifest");
+    if (!file.is_open()) {
+        return manifest;
+    }
+    
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t pos = line.find('=');
+        if (line.empty() || line[0] == '#' || pos == std::string::npos) continue;
+        std::string key = trimmed(line.substr(0, pos));
+        std::string value = trimmed(line.substr(pos + 1));
         
-        // Auto-load plugins marked for auto-start
-        auto& entry = *plugins[pluginName];
-        if (entry.auto_start && entry.state == PluginState::UNLOADED) {
-            // Unlock for loading (loadPlugin will acquire its own lock)
-            plugins_mutex.unlock();
-            loadPlugin(pluginName);
-            plugins_mutex.lock();
+        if (key == "name") {
+            manifest.info.name = value;
+        } else if (key == "description") {
+            manifest.info.description = value;
+        } else if (key == "author") {
+            manifest.info.author = value;
+        } else if (key == "website") {
+            manifest.info.website = value;
+        } else if (key == "version") {
+            PluginVersion& version = manifest.info.version;
+            std::sscanf(value.c_str(), "%d.%d.%d", &version.major, &version.minor, &version.patch);
+        } else if (key == "type") {
+            manifest.type = value;
+        } else if (key == "api_version") {
+            manifest.api_version = value;
+        } else if (key == "dependencies") {
+            size_t begin = 0;
+            while (begin <= value.size()) {
+                size_t end = std::min(value.find(',', begin), value.size());
+                std::string dependency = trimmed(value.substr(begin, end - begin));
+                if (!dependency.empty()) manifest.info.dependencies.push_back(dependency);
+                begin = end + 1;
+            }
         }
     }
     
-    return true;
+    // Without a type there is nothing to defer the load on
+    manifest.present = !manifest.type.empty();
+    if (manifest.info.name.empty()) {
+        manifest.info.name = pluginName;
+    }
+    return manifest;
+}
+
+std::string PluginManager::verifyPluginFile(const std::string& libraryPath) const {
+    return security->verifyPluginFile(libraryPath);
+}
+
+void PluginManager::refreshPluginVerifications() {
+    security->refreshChangedVerificationsAsync();
+}
+
+size_t PluginManager::activateDeferredPlugins(const std::string& type) {
+    std::vector<std::string> names;
+    {
+        std::lock_guard<std::mutex> lock(plugins_mutex);
+        for (const auto& [name, entry] : plugins) {
+            if (entry->deferred && (type.empty() || entry->manifest.type == type)) {
+                entry->deferred = false;
+                names.push_back(name);
+            }
+        }
+    }
+    
+    size_t activated = 0;
+    for (const std::string& name : names) {
+        if (loadPlugin(name)) {
+            activated++;
+        }
+    }
+    return activated;
+}
+
+void PluginManager::activateDeferredPluginsAsync(const std::string& type) {
+    {
+        std::lock_guard<std::mutex> lock(plugins_mutex);
+        bool any = std::any_of(plugins.begin(), plugins.end(), [&](const auto& entry) {
+            return entry.second->deferred && (type.empty() || entry.second->manifest.type == type);
+        });
+        if (!any) return;
+    }
+    
+    pending_activations++;
+    TaskScheduler::shared().post([this, type]() {
+        try {
+            activateDeferredPlugins(type);
+        } catch (const std::exception& e) {
+            std::cerr << "Deferred plugin activation failed: " << e.what() << std::endl;
+        }
+        pending_activations--;
+    });
 }
 
 void PluginManager::addLoadCallback(PluginLoadCallback callback) {
@@ -561,10 +981,18 @@ void PluginManager::update(float deltaTime) {
 
 void PluginManager::recordPluginCall(const std::string& pluginName, std::chrono::microseconds execution_time) {
     plugin_metrics[pluginName].recordCall(execution_time);
+    MetricsRegistry::shared()
+        .histogram("versefinder_plugin_call_duration_seconds", "Time spent in plugin callbacks",
+                   MetricsRegistry::label("plugin", pluginName))
+        .observe(static_cast<uint64_t>(execution_time.count()));
 }
 
 void PluginManager::recordPluginError(const std::string& pluginName) {
     plugin_metrics[pluginName].recordError();
+    MetricsRegistry::shared()
+        .counter("versefinder_plugin_errors_total", "Plugin callbacks that threw",
+                 MetricsRegistry::label("plugin", pluginName))
+        .add();
 }
 
 } // namespace PluginSystem
\ No newline at end of file
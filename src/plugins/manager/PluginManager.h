@@ -5,15 +5,30 @@
 #include "../api/PluginAPI.h"
 #include "../loader/PluginLoader.h"
 #include "../security/PluginSecurity.h"
+#include "../../core/MemoryAccounting.h"
 #include <unordered_map>
 #include <vector>
 #include <memory>
 #include <mutex>
 #include <functional>
 #include <filesystem>
+#include <atomic>
+#include <future>
+#include <type_traits>
 
 namespace PluginSystem {
 
+// What a plugin says about itself without its library being loaded: a
+// <name>.manifest of key=value lines beside the library, with name,
+// description, author, version, type (as getPluginType() returns it) and
+// api_version
+struct PluginManifest {
+    bool present = false;
+    PluginInfo info;
+    std::string type;
+    std::string api_version;
+};
+
 // Plugin registry entry
 struct PluginEntry {
     std::unique_ptr<PluginLoader> loader;
@@ -23,6 +38,22 @@ struct PluginEntry {
     std::chrono::steady_clock::time_point load_time;
     std::chrono::steady_clock::time_point last_activity;
     bool auto_start = true;
+    // Resident memory the process gained while the plugin loaded and started.
+    // A plugin allocates through its own runtime, so this is an estimate.
+    MemoryCharge memory{MemoryTag::PLUGINS};
+    // Plugin searches and exports still running on the scheduler; unloading waits for them
+    std::shared_ptr<std::atomic<int>> calls_in_flight = std::make_shared<std::atomic<int>>(0);
+    // An exportPassageAsync() of this plugin is running
+    std::shared_ptr<std::atomic<bool>> exporting = std::make_shared<std::atomic<bool>>(false);
+    // Left out of federated search after missing its deadline too often
+    bool search_suspended = false;
+    // Discovery: the library, what its manifest says, and when its file last
+    // passed the security checks
+    std::string library_path;
+    PluginManifest manifest;
+    std::filesystem::file_time_type verified_write_time{};
+    // Auto-start plugin with a manifest, loaded on first use of its type
+    bool deferred = false;
     
     PluginEntry() : state(PluginState::UNLOADED) {}
 };
@@ -40,6 +71,8 @@ struct PluginMetrics {
     std::chrono::microseconds total_execution_time{0};
     size_t call_count = 0;
     size_t error_count = 0;
+    size_t budget_overruns = 0;      // federated searches that missed their deadline
+    size_t consecutive_overruns = 0; // since the last one that made it
     double average_execution_time_ms = 0.0;
     std::chrono::steady_clock::time_point last_call;
     
@@ -53,13 +86,40 @@ struct PluginMetrics {
     void recordError() {
         error_count++;
     }
+    
+    void recordOverrun() {
+        budget_overruns++;
+        consecutive_overruns++;
+    }
 };
 
+// Plugin searches started alongside a core search; see PluginManager::startPluginSearches
+struct PluginSearchBatch {
+    struct Call {
+        std::string plugin;
+        double quality = 0.0; // the plugin's own estimate for the query, 0.0-1.0
+        std::chrono::steady_clock::time_point started;
+        std::future<std::vector<std::string>> results;
+    };
+    std::vector<Call> calls;
+    std::chrono::steady_clock::time_point deadline;
+};
+
+// Progress of PluginManager::exportPassageAsync: verses written of the
+// total. Returning false cancels the export.
+using PluginExportProgress = std::function<bool(uint64_t done, uint64_t total)>;
+// Runs on the scheduler when the export ends; error is empty on success
+using PluginExportDone = std::function<void(bool success, const std::string& error)>;
+
 // Plugin manager callbacks
 using PluginLoadCallback = std::function<void(const std::string& pluginName, bool success, const std::string& error)>;
 using PluginUnloadCallback = std::function<void(const std::string& pluginName)>;
 
 class PluginManager {
+public:
+    static constexpr std::chrono::milliseconds DEFAULT_SEARCH_BUDGET{150};
+    static constexpr size_t MAX_SEARCH_OVERRUNS = 3; // in a row, before a plugin is suspended
+
 private:
     std::unordered_map<std::string, std::unique_ptr<PluginEntry>> plugins;
     std::unordered_map<std::string, PluginMetrics> plugin_metrics;
@@ -84,6 +144,10 @@ private:
     void updatePluginState(const std::string& pluginName, PluginState state, const std::string& error = "");
     void triggerLoadCallbacks(const std::string& pluginName, bool success, const std::string& error);
     void triggerUnloadCallbacks(const std::string& pluginName);
+    PluginManifest readManifest(const std::string& pluginName) const;
+    // Empty if the file passes the security checks, otherwise why not;
+    // touches no manager state, so discovery runs it on several threads
+    std::string verifyPluginFile(const std::string& libraryPath) const;
     
 public:
     explicit PluginManager(VerseFinder* bible);
@@ -118,16 +182,40 @@ public:
     bool setPluginSetting(const std::string& pluginName, const std::string& key, const std::string& value);
     std::string getPluginSetting(const std::string& pluginName, const std::string& key, const std::string& defaultValue = "") const;
     
-    // Plugin discovery and installation
+    // Plugin discovery and installation. Scanning reads manifests and runs
+    // the security checks on the TaskScheduler, without loading anything;
+    // auto-start plugins with a manifest are then loaded on first use of
+    // their type (see activateDeferredPlugins), the others straight away.
     bool scanForPlugins();
     bool installPlugin(const std::string& pluginFile, const std::string& pluginName = "");
     bool uninstallPlugin(const std::string& pluginName);
     
+    // Re-verifies, in the background, plugin files rebuilt since they were
+    // checked; cheap enough to call every few seconds
+    void refreshPluginVerifications();
+    
     // Plugin lifecycle management
     bool enablePlugin(const std::string& pluginName);
     bool disablePlugin(const std::string& pluginName);
     bool isPluginEnabled(const std::string& pluginName) const;
     void enableAutoStart(const std::string& pluginName, bool enable);
+    // Loads the deferred plugins of a type ("" for every type); returns how
+    // many became active. The async form loads them on the TaskScheduler.
+    size_t activateDeferredPlugins(const std::string& type);
+    void activateDeferredPluginsAsync(const std::string& type);
+    
+    // Type name a plugin interface's libraries report from getPluginType()
+    template<typename T>
+    static std::string pluginTypeName() {
+        if constexpr (std::is_same_v<T, ISearchPlugin>) return "search";
+        else if constexpr (std::is_same_v<T, IUIPlugin>) return "ui";
+        else if constexpr (std::is_same_v<T, ITranslationPlugin>) return "translation";
+        else if constexpr (std::is_same_v<T, IThemePlugin>) return "theme";
+        else if constexpr (std::is_same_v<T, IIntegrationPlugin>) return "integration";
+        else if constexpr (std::is_same_v<T, IExportPlugin>) return "export";
+        else if constexpr (std::is_same_v<T, IScriptPlugin>) return "script";
+        else return "";
+    }
     
     // Plugin execution and access
     template<typename T>
@@ -140,6 +228,13 @@ public:
         return nullptr;
     }
     
+    // Asking for a type through a non-const manager loads its deferred plugins first
+    template<typename T>
+    std::vector<T*> getPluginsByType() {
+        activateDeferredPlugins(pluginTypeName<T>());
+        return static_cast<const PluginManager&>(*this).getPluginsByType<T>();
+    }
+    
     template<typename T>
     std::vector<T*> getPluginsByType() const {
         std::vector<T*> result;
@@ -155,6 +250,27 @@ public:
         return result;
     }
     
+    // Federated search: every active ISearchPlugin that supports the
+    // translation searches on the shared TaskScheduler while the caller runs
+    // the core search, then merge waits for them until the deadline. Results
+    // are scored by rank, plugin results weighted by their quality estimate,
+    // and summed across sources that agree on a verse. Plugins that miss the
+    // deadline MAX_SEARCH_OVERRUNS times in a row are suspended from it until
+    // they are reloaded.
+    PluginSearchBatch startPluginSearches(const std::string& query, const std::string& translation,
+                                          std::chrono::milliseconds budget = DEFAULT_SEARCH_BUDGET);
+    std::vector<std::string> mergePluginSearches(PluginSearchBatch& batch, std::vector<std::string> core_results);
+    
+    // Exports a passage ("Genesis", "John 3") through an active v2 export
+    // plugin on the TaskScheduler. The plugin reads the verses through the
+    // host API and writes them as it goes, so neither the calling thread nor
+    // memory pays for the size of the passage. progress is only called by
+    // plugins that report it. False, with nothing started, if the plugin is
+    // not such a plugin or is already exporting.
+    bool exportPassageAsync(const std::string& pluginName, const std::string& passage,
+                            const std::string& translation, const std::string& filename,
+                            PluginExportProgress progress, PluginExportDone done);
+    
     // Event system
     void triggerEvent(const PluginEvent& event);
     
@@ -198,6 +314,7 @@ public:
 private:
     std::string last_error;
     bool performance_monitoring_enabled = true;
+    std::atomic<int> pending_activations{0}; // activateDeferredPluginsAsync tasks not yet run
     
     void recordPluginCall(const std::string& pluginName, std::chrono::microseconds execution_time);
     void recordPluginError(const std::string& pluginName);
@@ -7,27 +7,104 @@
 #include <memory>
 #include <unordered_map>
 #include <functional>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 
 // Forward declaration for Lua state
 struct lua_State;
 
 namespace PluginSystem {
 
-// Lua script wrapper
+// Lua script wrapper. The bytecode is what lua_dump produced for the
+// content; it is what gets loaded once present, so a script is parsed once
+// per change rather than once per load.
 class LuaScript {
 private:
     std::string script_content;
     std::string script_name;
     bool is_compiled;
+    uint64_t content_hash = 0;
+    std::string bytecode;
     
 public:
     LuaScript(const std::string& name, const std::string& content)
-        : script_name(name), script_content(content), is_compiled(false) {}
+        : script_content(content), script_name(name), is_compiled(false) {}
     
     const std::string& getName() const { return script_name; }
     const std::string& getContent() const { return script_content; }
     bool isCompiled() const { return is_compiled; }
     void setCompiled(bool compiled) { is_compiled = compiled; }
+    
+    uint64_t getContentHash() const { return content_hash; }
+    void setContentHash(uint64_t hash) { content_hash = hash; }
+    const std::string& getBytecode() const { return bytecode; }
+    void setBytecode(std::string compiled) { bytecode = std::move(compiled); }
+};
+
+// Compiled chunks on disk, one file per source content hash. Bytecode only
+// loads into the runtime that dumped it, so the runtime is part of the name:
+// builds with VERSEFINDER_USE_LUAJIT and plain Lua builds keep apart.
+class LuaBytecodeCache {
+private:
+    std::string directory;
+    
+public:
+#ifdef VERSEFINDER_USE_LUAJIT
+    static constexpr const char* RUNTIME = "luajit";
+#else
+    static constexpr const char* RUNTIME = "lua54";
+#endif
+    
+    explicit LuaBytecodeCache(std::string cacheDirectory) : directory(std::move(cacheDirectory)) {}
+    
+    std::string pathFor(uint64_t contentHash) const {
+        char name[48];
+        std::snprintf(name, sizeof(name), "%016llx.%s.luac", static_cast<unsigned long long>(contentHash), RUNTIME);
+        return directory + "/" + name;
+    }
+    
+    bool load(uint64_t contentHash, std::string& bytecode) const {
+        std::ifstream file(pathFor(contentHash), std::ios::binary);
+        if (!file.is_open()) return false;
+        bytecode.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return !bytecode.empty();
+    }
+    
+    // Written beside and renamed into place, so a reader never sees half a chunk
+    bool store(uint64_t contentHash, const std::string& bytecode) const {
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        std::string path = pathFor(contentHash);
+        {
+            std::ofstream file(path + ".tmp", std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) return false;
+            file.write(bytecode.data(), static_cast<std::streamsize>(bytecode.size()));
+            if (!file) return false;
+        }
+        std::filesystem::rename(path + ".tmp", path, ec);
+        return !ec;
+    }
+};
+
+// Script time per onUpdate. Scripts run as coroutines under an
+// instruction-count hook; once the update's share is spent the running one
+// yields and resumes next update, so automation left running every frame
+// cannot stretch a frame.
+struct ScriptBudget {
+    std::chrono::microseconds per_update{500};
+    std::chrono::microseconds spent_last_update{0};
+    std::chrono::microseconds max_spent{0};
+    size_t suspensions = 0; // scripts cut off by the budget
+    
+    void record(std::chrono::microseconds spent, bool suspended) {
+        spent_last_update = spent;
+        if (spent > max_spent) max_spent = spent;
+        if (suspended) suspensions++;
+    }
 };
 
 // Lua function callback type
@@ -44,6 +121,8 @@ private:
     
     std::unordered_map<std::string, LuaFunction> registered_functions;
     std::unordered_map<std::string, std::unique_ptr<LuaScript>> loaded_scripts;
+    std::unique_ptr<LuaBytecodeCache> bytecode_cache; // under the plugin data path once configured
+    ScriptBudget update_budget;
     
     // Lua C functions for API binding
     static int lua_searchByReference(lua_State* L);
@@ -54,12 +133,21 @@ private:
     static int lua_triggerEvent(lua_State* L);
     static int lua_log(lua_State* L);
     
+    // Batched bindings: verses cross as id arrays, and text is pushed
+    // straight from the verse store's views, once, when a script asks
+    static int lua_findPassage(lua_State* L);      // (reference, translation) -> {id, ...}
+    static int lua_searchKeywordIds(lua_State* L); // (query, translation) -> {id, ...}
+    static int lua_viewVerses(lua_State* L);       // ({id, ...}, translation) -> {{book, chapter, verse, text}, ...}
+    
     // Helper methods
     void registerCoreFunctions();
     void registerUtilityFunctions();
     bool loadLuaLibraries();
     void setupErrorHandling();
     std::string getLuaError();
+    // Loads script's bytecode from memory, the cache or, failing both, its
+    // source, dumping what the source compiled to into the cache
+    bool compileScript(LuaScript& script);
     
 public:
     LuaScriptEngine();
@@ -98,6 +186,10 @@ public:
     bool loadScriptFromFile(const std::string& filename);
     void clearAllScripts();
     
+    // Per-update script time; see ScriptBudget
+    void setUpdateBudget(std::chrono::microseconds budget) { update_budget.per_update = budget; }
+    const ScriptBudget& getUpdateBudget() const { return update_budget; }
+    
     // Error handling
     void setErrorHandler(std::function<void(const std::string&)> handler);
     
@@ -1,11 +1,115 @@
 #include "PluginSecurity.h"
+#include "../../core/MappedFile.h"
+#include "../../core/MetricsRegistry.h"
+#include "../../core/TaskScheduler.h"
 #include <fstream>
 #include <algorithm>
+#include <cstring>
 #include <filesystem>
 #include <iostream>
+#include <sstream>
+#include <thread>
 
 namespace PluginSystem {
 
+namespace {
+
+// XXH64, as published by its authors: four independent lanes over 32-byte
+// stripes, so the multiplies pipeline instead of waiting on each other
+constexpr uint64_t XXH_PRIME1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t XXH_PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t XXH_PRIME3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t XXH_PRIME4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t XXH_PRIME5 = 0x27D4EB2F165667C5ULL;
+
+uint64_t rotl64(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+uint64_t read64(const unsigned char* p) {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t read32(const unsigned char* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint64_t xxhRound(uint64_t acc, uint64_t input) {
+    acc += input * XXH_PRIME2;
+    return rotl64(acc, 31) * XXH_PRIME1;
+}
+
+uint64_t xxhMerge(uint64_t acc, uint64_t lane) {
+    acc ^= xxhRound(0, lane);
+    return acc * XXH_PRIME1 + XXH_PRIME4;
+}
+
+// Little-endian hosts only, which is every platform the app is built for
+uint64_t xxh64(const unsigned char* p, size_t size, uint64_t seed = 0) {
+    const unsigned char* end = p + size;
+    uint64_t hash;
+
+    if (size >= 32) {
+        uint64_t v1 = seed + XXH_PRIME1 + XXH_PRIME2;
+        uint64_t v2 = seed + XXH_PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - XXH_PRIME1;
+        const unsigned char* limit = end - 32;
+        do {
+            v1 = xxhRound(v1, read64(p));
+            v2 = xxhRound(v2, read64(p + 8));
+            v3 = xxhRound(v3, read64(p + 16));
+            v4 = xxhRound(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        hash = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        hash = xxhMerge(hash, v1);
+        hash = xxhMerge(hash, v2);
+        hash = xxhMerge(hash, v3);
+        hash = xxhMerge(hash, v4);
+    } else {
+        hash = seed + XXH_PRIME5;
+    }
+    hash += size;
+
+    for (; p + 8 <= end; p += 8) {
+        hash ^= xxhRound(0, read64(p));
+        hash = rotl64(hash, 27) * XXH_PRIME1 + XXH_PRIME4;
+    }
+    if (p + 4 <= end) {
+        hash ^= static_cast<uint64_t>(read32(p)) * XXH_PRIME1;
+        hash = rotl64(hash, 23) * XXH_PRIME2 + XXH_PRIME3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        hash ^= *p * XXH_PRIME5;
+        hash = rotl64(hash, 11) * XXH_PRIME1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= XXH_PRIME2;
+    hash ^= hash >> 29;
+    hash *= XXH_PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+bool fileStamp(const std::string& path, uint64_t& size, int64_t& mtime) {
+    std::error_code ec;
+    size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    auto write_time = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    mtime = static_cast<int64_t>(write_time.time_since_epoch().count());
+    return true;
+}
+
+} // namespace
+
 // SecurityContext implementation
 
 void SecurityContext::grantPermission(const std::string& permission) {
@@ -224,10 +328,16 @@ PluginSecurity::~PluginSecurity() {
 
 bool PluginSecurity::initialize(const std::string& configPath) {
     security_config_path = configPath + "/security.conf";
+    verification_cache_path = configPath + "/plugin_verification.cache";
+    loadVerificationCache();
     return loadSecurityConfig();
 }
 
 void PluginSecurity::shutdown() {
+    while (refresh_running.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    saveVerificationCache();
     saveSecurityConfig();
     contexts.clear();
 }
@@ -410,7 +520,7 @@ bool PluginSecurity::checkPluginPermissions(const std::string& pluginName, const
     return true; // Allow for now
 }
 
-bool PluginSecurity::validatePluginSafety(const std::string& filePath) {
+bool PluginSecurity::checkFileLimits(const std::string& filePath) {
     // Basic file validation
     if (!std::filesystem::exists(filePath)) {
         return false;
@@ -426,6 +536,14 @@ bool PluginSecurity::validatePluginSafety(const std::string& filePath) {
         return false;
     }
     
+    return true;
+}
+
+bool PluginSecurity::validatePluginSafety(const std::string& filePath) {
+    if (!checkFileLimits(filePath)) {
+        return false;
+    }
+    
     // If code signing is required, verify signature
     if (code_signing_required) {
         return verifyPluginSignature(filePath);
@@ -455,6 +573,160 @@ bool PluginSecurity::scanForMalware(const std::string& filePath) {
     return true;
 }
 
+std::string PluginSecurity::runFileChecks(const std::string& filePath) {
+    if (!checkFileLimits(filePath)) {
+        return "Plugin file failed validation";
+    }
+    if (!scanForMalware(filePath)) {
+        return "Plugin file failed the malware scan";
+    }
+    return "";
+}
+
+bool PluginSecurity::hashFile(const std::string& filePath, uint64_t& hash) {
+    std::error_code ec;
+    if (std::filesystem::file_size(filePath, ec) == 0 && !ec) {
+        hash = xxh64(nullptr, 0);
+        return true;
+    }
+    MappedFile file;
+    if (!file.open(filePath)) {
+        return false;
+    }
+    hash = xxh64(reinterpret_cast<const unsigned char*>(file.data()), file.size());
+    return true;
+}
+
+std::string PluginSecurity::verifyPluginFile(const std::string& filePath) {
+    if (code_signing_required && !verifyPluginSignature(filePath)) {
+        return "Plugin signature could not be verified";
+    }
+    
+    uint64_t size = 0;
+    int64_t mtime = 0;
+    if (!fileStamp(filePath, size, mtime)) {
+        return "Plugin file not found";
+    }
+    std::error_code ec;
+    std::string key = std::filesystem::absolute(filePath, ec).lexically_normal().string();
+    Counter& reused = MetricsRegistry::shared().counter(
+        "versefinder_plugin_verifications_reused_total", "Plugin verifications answered from the cache");
+    
+    {
+        std::lock_guard<std::mutex> lock(verification_mutex);
+        auto it = verified_files.find(key);
+        if (it != verified_files.end() && it->second.size == size && it->second.mtime == mtime) {
+            reused.add();
+            return it->second.error;
+        }
+    }
+    
+    uint64_t hash = 0;
+    if (!hashFile(filePath, hash)) {
+        return "Plugin file could not be read";
+    }
+    {
+        // Copied or touched but the same bytes: the old verdict stands
+        std::lock_guard<std::mutex> lock(verification_mutex);
+        auto it = verified_files.find(key);
+        if (it != verified_files.end() && it->second.size == size && it->second.content_hash == hash) {
+            it->second.mtime = mtime;
+            verification_cache_dirty = true;
+            reused.add();
+            return it->second.error;
+        }
+    }
+    
+    std::string error = runFileChecks(filePath);
+    MetricsRegistry::shared()
+        .counter("versefinder_plugin_verifications_total", "Plugin files checked in full")
+        .add();
+    
+    std::lock_guard<std::mutex> lock(verification_mutex);
+    verified_files[key] = VerifiedFile{size, mtime, hash, error};
+    verification_cache_dirty = true;
+    return error;
+}
+
+void PluginSecurity::refreshChangedVerificationsAsync() {
+    if (refresh_running.exchange(true)) return;
+    
+    TaskScheduler::shared().post([this]() {
+        std::vector<std::string> changed;
+        {
+            std::lock_guard<std::mutex> lock(verification_mutex);
+            for (const auto& [path, verified] : verified_files) {
+                uint64_t size = 0;
+                int64_t mtime = 0;
+                if (fileStamp(path, size, mtime) && (size != verified.size || mtime != verified.mtime)) {
+                    changed.push_back(path);
+                }
+            }
+        }
+        try {
+            for (const std::string& path : changed) {
+                verifyPluginFile(path);
+            }
+            if (!changed.empty()) {
+                saveVerificationCache();
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Plugin re-verification failed: " << e.what() << std::endl;
+        }
+        refresh_running.store(false);
+    });
+}
+
+bool PluginSecurity::loadVerificationCache() {
+    std::ifstream file(verification_cache_path);
+    if (!file.is_open()) {
+        return false;
+    }
+    
+    // path, size, mtime, hash and error, tab-separated, one file per line
+    std::lock_guard<std::mutex> lock(verification_mutex);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string path, size, mtime, hash;
+        VerifiedFile verified;
+        if (!std::getline(fields, path, '\t') || !std::getline(fields, size, '\t') ||
+            !std::getline(fields, mtime, '\t') || !std::getline(fields, hash, '\t')) {
+            continue;
+        }
+        std::getline(fields, verified.error);
+        try {
+            verified.size = std::stoull(size);
+            verified.mtime = std::stoll(mtime);
+            verified.content_hash = std::stoull(hash, nullptr, 16);
+        } catch (...) {
+            continue;
+        }
+        verified_files[path] = std::move(verified);
+    }
+    return true;
+}
+
+bool PluginSecurity::saveVerificationCache() {
+    std::lock_guard<std::mutex> lock(verification_mutex);
+    if (!verification_cache_dirty || verification_cache_path.empty()) {
+        return true;
+    }
+    
+    std::ofstream file(verification_cache_path);
+    if (!file.is_open()) {
+        return false;
+    }
+    for (const auto& [path, verified] : verified_files) {
+        // Files since deleted are forgotten
+        if (!std::filesystem::exists(path)) continue;
+        file << path << '\t' << verified.size << '\t' << verified.mtime << '\t'
+             << std::hex << verified.content_hash << std::dec << '\t' << verified.error << '\n';
+    }
+    verification_cache_dirty = false;
+    return true;
+}
+
 PluginSandbox PluginSecurity::createSandbox(const std::string& pluginName) {
     SecurityContext* context = getContext(pluginName);
     if (!context) {
@@ -7,6 +7,9 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <chrono>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 
 namespace PluginSystem {
 
@@ -209,6 +212,19 @@ public:
     bool validatePluginSafety(const std::string& filePath);
     bool scanForMalware(const std::string& filePath);
     
+    // validatePluginSafety() and scanForMalware() with the outcome remembered
+    // per file: unchanged size and mtime skip reading it, and a file that was
+    // only touched is hashed but not scanned again. Results persist beside
+    // security.conf across restarts. The signature, kept in a file of its
+    // own, is checked on every call when required. Empty if the file passes,
+    // otherwise why not; safe to call from several threads.
+    std::string verifyPluginFile(const std::string& filePath);
+    // Re-verifies remembered files that changed on disk on the TaskScheduler,
+    // so that loading a rebuilt plugin finds its verdict ready
+    void refreshChangedVerificationsAsync();
+    // XXH64 of the file's contents; false if it cannot be read
+    static bool hashFile(const std::string& filePath, uint64_t& hash);
+    
     // Sandbox management
     void enableGlobalSandbox(bool enable) { global_sandbox_enabled = enable; }
     bool isGlobalSandboxEnabled() const { return global_sandbox_enabled; }
@@ -232,6 +248,23 @@ private:
     bool code_signing_required = false;
     std::unordered_map<std::string, std::vector<std::string>> security_violations;
     
+    struct VerifiedFile {
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        uint64_t content_hash = 0;
+        std::string error; // empty when the file passed
+    };
+    std::unordered_map<std::string, VerifiedFile> verified_files; // by absolute path
+    std::mutex verification_mutex;
+    std::string verification_cache_path;
+    bool verification_cache_dirty = false;
+    std::atomic<bool> refresh_running{false};
+    
+    bool checkFileLimits(const std::string& filePath);
+    std::string runFileChecks(const std::string& filePath);
+    bool loadVerificationCache();
+    bool saveVerificationCache();
+    
     bool isSystemPath(const std::string& path);
     bool isSafePath(const std::string& path);
     std::string sanitizePath(const std::string& path);
@@ -0,0 +1,307 @@
+// versefinder-server: the search engine and its HTTP API without the desktop UI,
+// for a machine that serves stage displays and relay software on its own.
+//
+// Settings come from, in increasing precedence: built-in defaults, the config
+// file (--config, or VERSEFINDER_SERVER_CONFIG), environment variables, and
+// command-line flags. Logs go to stdout/stderr, where journald picks them up.
+// Under systemd with Type=notify it reports READY=1 once translations are
+// listed; SIGHUP rescans the translations directory, SIGTERM stops.
+//
+// Several servers share favorites, collections, the verse of the day and the
+// presentation state through ReplicaChannel: one leads, the rest are started
+// with replica_of naming it (and the nodes to try if it goes away).
+#include "../api/ApiServer.h"
+#include "../api/ReplicaChannel.h"
+#include "../api/SearchApi.h"
+#include "../core/VerseFinder.h"
+#include <algorithm>
+#include <csignal>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+struct ServerConfig {
+    int port = 8080;
+    std::string translations_dir = "translations";
+    size_t worker_threads = 0;   // 0 = ApiServer picks from the hardware
+    size_t residency_mb = 0;     // 0 = VerseFinder's default budget
+    std::string cors_origin = "*";
+    std::vector<std::string> replica_of; // peers to follow, in order; empty to lead
+    std::string search_history;          // queries replayed to warm the caches; empty for none
+    bool compress_text = false;          // keep verse text compressed in memory
+    std::vector<std::pair<std::string, std::string>> webhooks; // (event, url) to POST each event to
+};
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+bool parseCount(const std::string& text, size_t& value) {
+    if (text.empty() || text.size() > 9 || text.find_first_not_of("0123456789") != std::string::npos) return false;
+    value = std::stoul(text);
+    return true;
+}
+
+// False (with a message) for an unknown key or a value that does not parse
+bool applySetting(ServerConfig& config, const std::string& key, const std::string& value) {
+    size_t count = 0;
+    if (key == "port") {
+        if (!parseCount(value, count) || count == 0 || count > 65535) {
+            std::cerr << "Invalid port: " << value << std::endl;
+            return false;
+        }
+        config.port = static_cast<int>(count);
+    } else if (key == "translations") {
+        config.translations_dir = value;
+    } else if (key == "workers") {
+        if (!parseCount(value, count)) {
+            std::cerr << "Invalid workers: " << value << std::endl;
+            return false;
+        }
+        config.worker_threads = count;
+    } else if (key == "residency_mb") {
+        if (!parseCount(value, count)) {
+            std::cerr << "Invalid residency_mb: " << value << std::endl;
+            return false;
+        }
+        config.residency_mb = count;
+    } else if (key == "cors_origin") {
+        config.cors_origin = value;
+    } else if (key == "compress_text") {
+        if (value != "true" && value != "false" && value != "1" && value != "0") {
+            std::cerr << "Invalid compress_text: " << value << std::endl;
+            return false;
+        }
+        config.compress_text = value == "true" || value == "1";
+    } else if (key == "search_history") {
+        config.search_history = value;
+    } else if (key == "webhooks") {
+        config.webhooks.clear();
+        std::stringstream entries(value);
+        std::string entry;
+        while (std::getline(entries, entry, ',')) {
+            entry = trim(entry);
+            if (entry.empty()) continue;
+            size_t equals = entry.find('=');
+            if (equals == std::string::npos || equals == 0 || equals + 1 == entry.size()) {
+                std::cerr << "Invalid webhook (expected event=url): " << entry << std::endl;
+                return false;
+            }
+            config.webhooks.emplace_back(trim(entry.substr(0, equals)), trim(entry.substr(equals + 1)));
+        }
+    } else if (key == "replica_of") {
+        config.replica_of.clear();
+        std::stringstream peers(value);
+        std::string peer;
+        while (std::getline(peers, peer, ',')) {
+            peer = trim(peer);
+            if (!peer.empty()) config.replica_of.push_back(peer);
+        }
+    } else {
+        std::cerr << "Unknown setting: " << key << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// "key = value" lines; blank lines and lines starting with # are skipped
+bool loadConfigFile(ServerConfig& config, const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Cannot read config file: " << path << std::endl;
+        return false;
+    }
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        ++line_number;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            std::cerr << path << ":" << line_number << ": expected key = value" << std::endl;
+            return false;
+        }
+        if (!applySetting(config, trim(line.substr(0, equals)), trim(line.substr(equals + 1)))) {
+            std::cerr << "  in " << path << ":" << line_number << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool loadEnvironment(ServerConfig& config) {
+    static const std::pair<const char*, const char*> VARIABLES[] = {
+        {"VERSEFINDER_PORT", "port"},
+        {"VERSEFINDER_TRANSLATIONS", "translations"},
+        {"VERSEFINDER_WORKERS", "workers"},
+        {"VERSEFINDER_RESIDENCY_MB", "residency_mb"},
+        {"VERSEFINDER_CORS_ORIGIN", "cors_origin"},
+        {"VERSEFINDER_REPLICA_OF", "replica_of"},
+        {"VERSEFINDER_SEARCH_HISTORY", "search_history"},
+        {"VERSEFINDER_COMPRESS_TEXT", "compress_text"},
+        {"VERSEFINDER_WEBHOOKS", "webhooks"},
+    };
+    for (const auto& [variable, key] : VARIABLES) {
+        const char* value = std::getenv(variable);
+        if (value && !applySetting(config, key, value)) return false;
+    }
+    return true;
+}
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [--config FILE] [--port N] [--translations DIR]\n"
+              << "       [--workers N] [--residency-mb N] [--cors-origin ORIGIN]\n"
+              << "       [--replica-of http://HOST:PORT[,http://HOST:PORT...]] [--search-history FILE]\n"
+              << "       [--compress-text true|false] [--webhooks EVENT=URL[,EVENT=URL...]]\n"
+              << "Config file keys: port, translations, workers, residency_mb, cors_origin, replica_of,\n"
+              << "                  search_history, compress_text, webhooks\n"
+              << "Environment: VERSEFINDER_SERVER_CONFIG, VERSEFINDER_PORT, VERSEFINDER_TRANSLATIONS,\n"
+              << "             VERSEFINDER_WORKERS, VERSEFINDER_RESIDENCY_MB, VERSEFINDER_CORS_ORIGIN,\n"
+              << "             VERSEFINDER_REPLICA_OF, VERSEFINDER_SEARCH_HISTORY, VERSEFINDER_COMPRESS_TEXT,\n"
+              << "             VERSEFINDER_WEBHOOKS" << std::endl;
+}
+
+// -1 to run, otherwise the exit code
+int parseArguments(int argc, char** argv, ServerConfig& config) {
+    std::string config_path;
+    if (const char* path = std::getenv("VERSEFINDER_SERVER_CONFIG")) config_path = path;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--config") == 0) config_path = argv[i + 1];
+    }
+    if (!config_path.empty() && !loadConfigFile(config, config_path)) return 2;
+    if (!loadEnvironment(config)) return 2;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string flag = argv[i];
+        if (flag == "--help" || flag == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        if (flag.rfind("--", 0) != 0 || i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 2;
+        }
+        std::string value = argv[++i];
+        if (flag == "--config") continue;
+        std::string key = flag.substr(2);
+        std::replace(key.begin(), key.end(), '-', '_');
+        if (!applySetting(config, key, value)) return 2;
+    }
+    return -1;
+}
+
+// sd_notify(3) without libsystemd: one datagram to $NOTIFY_SOCKET, if set
+void notifySystemd(const char* state) {
+    const char* socket_path = std::getenv("NOTIFY_SOCKET");
+    if (!socket_path || (socket_path[0] != '/' && socket_path[0] != '@')) return;
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    size_t length = std::strlen(socket_path);
+    if (length >= sizeof(address.sun_path)) return;
+    std::memcpy(address.sun_path, socket_path, length);
+    if (address.sun_path[0] == '@') address.sun_path[0] = '\0'; // abstract namespace
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd < 0) return;
+    socklen_t address_length = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + length);
+    sendto(fd, state, std::strlen(state), 0, reinterpret_cast<sockaddr*>(&address), address_length);
+    close(fd);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    ServerConfig config;
+    int exit_code = parseArguments(argc, argv, config);
+    if (exit_code >= 0) return exit_code;
+
+    // Blocked before any thread starts, so every thread inherits the mask and
+    // the signals are only ever taken by sigwait() below
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigaddset(&signals, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    VerseFinder bible;
+    bible.setTranslationsDirectory(config.translations_dir);
+    if (config.residency_mb > 0) {
+        bible.setResidencyBudget(config.residency_mb * 1024 * 1024);
+    }
+    bible.setCompressedText(config.compress_text);
+    // Translations with snapshots are only listed here and mapped on first use
+    // Before loading: the completion index is ranked with it
+    if (!config.search_history.empty()) bible.loadSearchHistory(config.search_history);
+    bible.loadAllTranslations();
+
+    ApiServer server;
+    server.setWorkerThreads(config.worker_threads);
+    server.enableCors(config.cors_origin);
+    for (const auto& [event, url] : config.webhooks) server.addWebhook(event, url);
+    SearchApi search_api(server, bible);
+    // Displays subscribe here on any node; the state is whatever the leader was last given
+    server.addEventStream("/api/presentation/events");
+    ReplicaChannel replica(server);
+    replica.setDocumentListener([&server](const std::string& key, const nlohmann::json& value) {
+        if (key != "presentation") return;
+        std::string state = value.dump();
+        server.broadcastEvent("/api/presentation/events", "presentation", state);
+        server.triggerWebhook("presentation", state);
+    });
+    if (!config.replica_of.empty()) replica.follow(config.replica_of);
+    if (!server.start(config.port)) {
+        std::cerr << "Failed to start API server on port " << config.port << std::endl;
+        return 1;
+    }
+    std::cout << "versefinder-server listening on port " << config.port
+              << ", translations in " << config.translations_dir << std::endl;
+
+    // /api/health answers meanwhile and reports bible_ready false
+    bible.waitForLoading();
+    if (!bible.isReady()) {
+        std::cerr << "No translations in " << config.translations_dir << "; serving health checks only" << std::endl;
+    } else {
+        bible.warmUp();
+    }
+    notifySystemd("READY=1");
+
+    for (;;) {
+        int signal_number = 0;
+        if (sigwait(&signals, &signal_number) != 0) continue;
+        if (signal_number == SIGHUP) {
+            notifySystemd("RELOADING=1");
+            std::cout << "Rescanning " << config.translations_dir << std::endl;
+            bible.cancelWarmUp();
+            bible.loadAllTranslations();
+            bible.waitForLoading();
+            if (bible.isReady()) bible.warmUp();
+            notifySystemd("READY=1");
+            continue;
+        }
+        std::cout << "Stopping on signal " << signal_number << std::endl;
+        break;
+    }
+
+    notifySystemd("STOPPING=1");
+    server.stop();
+    bible.cancelWarmUp();
+    if (!config.search_history.empty()) bible.saveSearchHistory(config.search_history);
+    return 0;
+}
@@ -0,0 +1,441 @@
+#include "ServiceBundle.h"
+#include "../core/VerseFinder.h"
+#include "../core/MappedFile.h"
+#include <stb_image.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <span>
+
+namespace {
+
+constexpr char BUNDLE_MAGIC[8] = {'V', 'F', 'B', 'U', 'N', 'D', 'L', 'E'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr uint32_t NO_MEDIA = 0xFFFFFFFFu;
+
+struct BundleHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    int64_t built_at;
+    uint64_t index_size;
+    uint64_t index_checksum;
+    uint64_t media_size;
+};
+static_assert(sizeof(BundleHeader) % 8 == 0, "index must start 8-byte aligned");
+
+uint64_t checksum(const char* data, size_t size) {
+    // FNV-1a over 64-bit words, as translation snapshots use
+    uint64_t hash = 1469598103934665603ULL;
+    constexpr uint64_t prime = 1099511628211ULL;
+
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+    }
+    for (; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+    }
+    return hash;
+}
+
+class IndexWriter {
+private:
+    std::string buffer;
+
+public:
+    template <typename T>
+    void pod(const T& value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void str(std::string_view value) {
+        pod(static_cast<uint32_t>(value.size()));
+        buffer.append(value.data(), value.size());
+    }
+
+    void align() {
+        buffer.append((8 - buffer.size() % 8) % 8, '\0');
+    }
+
+    const std::string& data() const { return buffer; }
+};
+
+// Bounds-checked cursor over the mapped index; strings are views into the mapping
+class IndexReader {
+private:
+    const char* base;
+    size_t size;
+    size_t pos = 0;
+    bool valid = true;
+
+public:
+    IndexReader(const char* data, size_t length) : base(data), size(length) {}
+
+    bool ok() const { return valid; }
+    void fail() { valid = false; }
+
+    template <typename T>
+    bool pod(T& value) {
+        if (!valid || size - pos < sizeof(T)) return valid = false;
+        std::memcpy(&value, base + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    std::string_view str() {
+        uint32_t length = 0;
+        if (!pod(length) || length > size - pos) {
+            valid = false;
+            return {};
+        }
+        std::string_view view(base + pos, length);
+        pos += length;
+        return view;
+    }
+
+    // A count of entries each at least min_bytes long, so a corrupt count
+    // cannot make the loader reserve more than the file could hold
+    bool count(uint32_t& value, size_t min_bytes) {
+        if (!pod(value)) return false;
+        if (value > (size - pos) / min_bytes) return valid = false;
+        return true;
+    }
+};
+
+// A media blob as it will be stored: decoded pixels when it is an image
+struct PreparedMedia {
+    std::string source_path;
+    std::string media_type;
+    ServiceBundle::MediaEncoding encoding = ServiceBundle::MediaEncoding::ORIGINAL;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::string bytes;
+};
+
+bool readWholeFile(const std::string& path, std::string& bytes) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    in.seekg(0, std::ios::end);
+    std::streamoff size = in.tellg();
+    if (size < 0) return false;
+    in.seekg(0, std::ios::beg);
+    bytes.resize(static_cast<size_t>(size));
+    return static_cast<bool>(in.read(bytes.data(), size));
+}
+
+bool prepareMedia(const ServiceItem& item, PreparedMedia& media) {
+    media.source_path = item.media_path;
+    media.media_type = item.media_type;
+    if (!readWholeFile(item.media_path, media.bytes)) {
+        return false;
+    }
+
+    // Images are decoded now so showing one is a texture upload; anything
+    // stb cannot read is kept as it is for the player to decode
+    int width = 0, height = 0, channels = 0;
+    unsigned char* pixels = stbi_load_from_memory(reinterpret_cast<const unsigned char*>(media.bytes.data()),
+                                                  static_cast<int>(media.bytes.size()),
+                                                  &width, &height, &channels, 4);
+    if (pixels) {
+        media.encoding = ServiceBundle::MediaEncoding::RGBA8;
+        media.width = static_cast<uint32_t>(width);
+        media.height = static_cast<uint32_t>(height);
+        media.bytes.assign(reinterpret_cast<const char*>(pixels), static_cast<size_t>(width) * height * 4);
+        stbi_image_free(pixels);
+    }
+    return true;
+}
+
+} // namespace
+
+ServiceBundle::ServiceBundle() = default;
+ServiceBundle::~ServiceBundle() = default;
+
+std::string ServiceBundle::pathFor(const std::string& directory, const std::string& plan_id) {
+    return (std::filesystem::path(directory) / (plan_id + EXTENSION)).string();
+}
+
+bool ServiceBundle::write(const std::string& path, const std::string& plan_id, const std::string& plan_title,
+                          const std::vector<ServiceItem>& items, VerseFinder& bible,
+                          const std::vector<std::string>& translations, BuildReport* report) {
+    BuildReport built;
+    VerseFinder::TranslationLease lease = bible.acquireTranslations(translations);
+
+    std::vector<PreparedMedia> media;
+    IndexWriter index;
+    index.str(plan_id);
+    index.str(plan_title);
+    index.pod(static_cast<uint32_t>(translations.size()));
+    for (const auto& translation : translations) {
+        index.str(translation);
+    }
+
+    index.pod(static_cast<uint32_t>(items.size()));
+    for (const auto& item : items) {
+        index.str(item.id);
+        index.pod(static_cast<uint32_t>(item.type));
+        index.str(item.title);
+        index.str(item.content);
+
+        // Each translation's verses, one slide apiece
+        std::vector<std::pair<const std::string*, std::vector<VerseView>>> readings;
+        if (item.type == ServiceItemType::SCRIPTURE && !item.content.empty()) {
+            for (const auto& translation : translations) {
+                std::vector<VerseId> ids = bible.findPassage(item.content, translation);
+                std::vector<VerseView> verses = bible.viewVerses(ids, translation);
+                std::erase_if(verses, [](const VerseView& verse) { return !verse; });
+                if (verses.empty()) {
+                    ++built.unresolved;
+                    continue;
+                }
+                built.slides += verses.size();
+                readings.emplace_back(&translation, std::move(verses));
+            }
+        }
+        built.readings += readings.size();
+        index.pod(static_cast<uint32_t>(readings.size()));
+        for (const auto& [translation, verses] : readings) {
+            index.str(*translation);
+            index.pod(static_cast<uint32_t>(verses.size()));
+            for (const auto& verse : verses) {
+                index.str(verse.text);
+                index.str(std::string(verse.book) + " " + std::to_string(verse.chapter) + ":" +
+                          std::to_string(verse.verse));
+            }
+        }
+
+        uint32_t media_index = NO_MEDIA;
+        if (!item.media_path.empty()) {
+            PreparedMedia prepared;
+            if (prepareMedia(item, prepared)) {
+                media_index = static_cast<uint32_t>(media.size());
+                media.push_back(std::move(prepared));
+            } else {
+                std::cerr << "Warning: Could not bundle media " << item.media_path << std::endl;
+                ++built.media_missing;
+            }
+        }
+        index.pod(media_index);
+    }
+
+    // The media table; offsets are into the media area after the index
+    uint64_t media_size = 0;
+    index.pod(static_cast<uint32_t>(media.size()));
+    for (const auto& entry : media) {
+        index.str(entry.source_path);
+        index.str(entry.media_type);
+        index.pod(static_cast<uint32_t>(entry.encoding));
+        index.pod(entry.width);
+        index.pod(entry.height);
+        index.pod(media_size);
+        index.pod(static_cast<uint64_t>(entry.bytes.size()));
+        media_size += (entry.bytes.size() + 7) / 8 * 8;
+    }
+    index.align();
+    built.media = media.size();
+
+    BundleHeader header{};
+    std::memcpy(header.magic, BUNDLE_MAGIC, sizeof(header.magic));
+    header.version = FORMAT_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.built_at = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    header.index_size = index.data().size();
+    header.index_checksum = checksum(index.data().data(), index.data().size());
+    header.media_size = media_size;
+
+    std::error_code ec;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    // Write to a temporary name and rename, so a bundle in use is never torn
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "Warning: Could not write service bundle " << path << std::endl;
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(index.data().data(), static_cast<std::streamsize>(index.data().size()));
+        static const char padding[8] = {};
+        for (const auto& entry : media) {
+            out.write(entry.bytes.data(), static_cast<std::streamsize>(entry.bytes.size()));
+            out.write(padding, static_cast<std::streamsize>((8 - entry.bytes.size() % 8) % 8));
+        }
+        if (!out.good()) {
+            out.close();
+            std::filesystem::remove(temp_path, ec);
+            return false;
+        }
+    }
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp_path, ec);
+        return false;
+    }
+
+    built.bytes = sizeof(header) + header.index_size + media_size;
+    if (report) {
+        *report = built;
+    }
+    return true;
+}
+
+bool ServiceBundle::load(const std::string& bundle_path) {
+    auto mapped = std::make_shared<MappedFile>();
+    if (!mapped->open(bundle_path) || mapped->size() < sizeof(BundleHeader)) {
+        return false;
+    }
+    BundleHeader header;
+    std::memcpy(&header, mapped->data(), sizeof(header));
+    if (std::memcmp(header.magic, BUNDLE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != FORMAT_VERSION || header.byte_order != BYTE_ORDER_MARK ||
+        header.index_size > mapped->size() - sizeof(header) ||
+        header.media_size != mapped->size() - sizeof(header) - header.index_size) {
+        std::cerr << "Warning: " << bundle_path << " is not a usable service bundle" << std::endl;
+        return false;
+    }
+    const char* index_data = mapped->data() + sizeof(header);
+    if (checksum(index_data, header.index_size) != header.index_checksum) {
+        std::cerr << "Warning: Service bundle " << bundle_path << " is corrupt" << std::endl;
+        return false;
+    }
+    std::string_view media_area(index_data + header.index_size, header.media_size);
+
+    IndexReader reader(index_data, header.index_size);
+    std::string_view loaded_id = reader.str();
+    std::string_view loaded_title = reader.str();
+
+    uint32_t count = 0;
+    std::vector<std::string_view> loaded_translations;
+    reader.count(count, sizeof(uint32_t));
+    for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+        loaded_translations.push_back(reader.str());
+    }
+
+    std::vector<Item> loaded_items;
+    std::vector<uint32_t> item_media;
+    reader.count(count, 4 * sizeof(uint32_t));
+    loaded_items.reserve(count);
+    for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+        Item item;
+        uint32_t type = 0, reading_count = 0, media_index = NO_MEDIA;
+        item.id = reader.str();
+        reader.pod(type);
+        item.type = static_cast<ServiceItemType>(type);
+        item.title = reader.str();
+        item.content = reader.str();
+        reader.count(reading_count, 2 * sizeof(uint32_t));
+        for (uint32_t r = 0; r < reading_count && reader.ok(); ++r) {
+            Reading reading;
+            uint32_t slide_count = 0;
+            reading.translation = reader.str();
+            reader.count(slide_count, 2 * sizeof(uint32_t));
+            reading.slides.reserve(slide_count);
+            for (uint32_t s = 0; s < slide_count && reader.ok(); ++s) {
+                Slide slide;
+                slide.text = reader.str();
+                slide.reference = reader.str();
+                reading.slides.push_back(slide);
+            }
+            item.readings.push_back(std::move(reading));
+        }
+        reader.pod(media_index);
+        item_media.push_back(media_index);
+        loaded_items.push_back(std::move(item));
+    }
+
+    std::vector<Media> loaded_media;
+    reader.count(count, 2 * sizeof(uint32_t) + 3 * sizeof(uint32_t) + 2 * sizeof(uint64_t));
+    for (uint32_t i = 0; i < count && reader.ok(); ++i) {
+        Media entry;
+        uint32_t encoding = 0;
+        uint64_t offset = 0, size = 0;
+        entry.source_path = reader.str();
+        entry.media_type = reader.str();
+        reader.pod(encoding);
+        reader.pod(entry.width);
+        reader.pod(entry.height);
+        reader.pod(offset);
+        reader.pod(size);
+        entry.encoding = static_cast<MediaEncoding>(encoding);
+        if (offset > media_area.size() || size > media_area.size() - offset ||
+            (entry.encoding == MediaEncoding::RGBA8 &&
+             size != static_cast<uint64_t>(entry.width) * entry.height * 4)) {
+            reader.fail();
+            break;
+        }
+        entry.bytes = media_area.substr(offset, size);
+        loaded_media.push_back(entry);
+    }
+
+    if (!reader.ok()) {
+        std::cerr << "Warning: Service bundle " << bundle_path << " is truncated" << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < loaded_items.size(); ++i) {
+        if (item_media[i] < loaded_media.size()) {
+            loaded_items[i].media = static_cast<int>(item_media[i]);
+        }
+    }
+
+    file = std::move(mapped);
+    path = bundle_path;
+    plan_id = loaded_id;
+    plan_title = loaded_title;
+    built_at = header.built_at;
+    translations = std::move(loaded_translations);
+    items = std::move(loaded_items);
+    media_table = std::move(loaded_media);
+    return true;
+}
+
+void ServiceBundle::clear() {
+    // The views go before the mapping they point into
+    items.clear();
+    media_table.clear();
+    translations.clear();
+    plan_id = plan_title = {};
+    built_at = 0;
+    path.clear();
+    file.reset();
+}
+
+const ServiceBundle::Reading* ServiceBundle::readingOf(const Item& item, std::string_view translation) const {
+    if (item.readings.empty()) {
+        return nullptr;
+    }
+    auto match = std::find_if(item.readings.begin(), item.readings.end(), [&](const Reading& reading) {
+        return reading.translation == translation;
+    });
+    return match != item.readings.end() ? &*match : &item.readings.front();
+}
+
+const ServiceBundle::Reading* ServiceBundle::findReading(std::string_view reference,
+                                                         std::string_view translation) const {
+    auto match = std::find_if(items.begin(), items.end(), [&](const Item& item) {
+        return item.type == ServiceItemType::SCRIPTURE && item.content == reference && !item.readings.empty();
+    });
+    return match != items.end() ? readingOf(*match, translation) : nullptr;
+}
+
+const ServiceBundle::Item* ServiceBundle::nextReading(std::string_view reference) const {
+    auto is_scripture = [](const Item& item) { return item.type == ServiceItemType::SCRIPTURE; };
+    auto current = std::find_if(items.begin(), items.end(), [&](const Item& item) {
+        return is_scripture(item) && item.content == reference;
+    });
+    if (current == items.end()) {
+        return nullptr;
+    }
+    auto next = std::find_if(std::next(current), items.end(), is_scripture);
+    return next != items.end() ? &*next : nullptr;
+}
@@ -0,0 +1,121 @@
+#ifndef SERVICE_BUNDLE_H
+#define SERVICE_BUNDLE_H
+
+#include "ServicePlan.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class MappedFile;
+class VerseFinder;
+
+// A service plan resolved ahead of the service into one file that needs
+// nothing else to present it: every scripture reading's verses in each
+// chosen translation, already cut into slides, and every media item's file,
+// images decoded to pixels. Loading maps the file and indexes it in place,
+// a few milliseconds however large it is, so it still works when the
+// translations are not loaded, the planning integration is unreachable, or
+// the application is in emergency mode.
+//
+// Layout: a BundleHeader, the index (plan, items, readings, slides and the
+// media table, all strings length-prefixed) checksummed as a whole, then the
+// media area, each blob 8-byte aligned. Media bytes are not checksummed;
+// they are only read if an item is shown.
+class ServiceBundle {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr const char* EXTENSION = ".vfbundle";
+
+    enum class MediaEncoding : uint32_t {
+        ORIGINAL = 0, // the file's own bytes: video, audio, an image stb cannot read
+        RGBA8 = 1     // decoded pixels, width * height * 4 bytes, top row first
+    };
+
+    struct Slide {
+        std::string_view text;
+        std::string_view reference; // "John 3:16"
+    };
+
+    // One scripture item in one translation
+    struct Reading {
+        std::string_view translation;
+        std::vector<Slide> slides;
+    };
+
+    struct Media {
+        std::string_view source_path;
+        std::string_view media_type;
+        MediaEncoding encoding = MediaEncoding::ORIGINAL;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::string_view bytes;
+    };
+
+    struct Item {
+        std::string_view id;
+        ServiceItemType type = ServiceItemType::CUSTOM;
+        std::string_view title;
+        std::string_view content;
+        std::vector<Reading> readings; // scripture only; translations that could not resolve it are left out
+        int media = -1;                // into media(), or -1
+    };
+
+    struct BuildReport {
+        size_t readings = 0;   // scripture items times translations resolved
+        size_t slides = 0;
+        size_t unresolved = 0; // readings with no verses in their translation
+        size_t media = 0;
+        size_t media_missing = 0;
+        uint64_t bytes = 0;    // of the written file
+    };
+
+    ServiceBundle();
+    ~ServiceBundle();
+
+    ServiceBundle(const ServiceBundle&) = delete;
+    ServiceBundle& operator=(const ServiceBundle&) = delete;
+
+    // Resolves items in each translation through bible and writes the bundle
+    // to path, replacing any there only once it is complete. Run it off the
+    // UI thread: it acquires the translations and reads every media file.
+    static bool write(const std::string& path, const std::string& plan_id, const std::string& plan_title,
+                      const std::vector<ServiceItem>& items, VerseFinder& bible,
+                      const std::vector<std::string>& translations, BuildReport* report = nullptr);
+    // <directory>/<plan id>.vfbundle
+    static std::string pathFor(const std::string& directory, const std::string& plan_id);
+
+    // False for a missing, truncated, corrupt or other-version file, leaving
+    // whatever was loaded before in place
+    bool load(const std::string& path);
+    void clear();
+    bool isLoaded() const { return file != nullptr; }
+    const std::string& getPath() const { return path; }
+
+    std::string_view planId() const { return plan_id; }
+    std::string_view planTitle() const { return plan_title; }
+    int64_t builtAt() const { return built_at; } // seconds since the epoch
+    const std::vector<std::string_view>& getTranslations() const { return translations; }
+    const std::vector<Item>& getItems() const { return items; }
+    const std::vector<Media>& media() const { return media_table; }
+
+    // item's reading in translation, or else in the first translation that has it
+    const Reading* readingOf(const Item& item, std::string_view translation) const;
+    // That of the first scripture item reading reference (its content)
+    const Reading* findReading(std::string_view reference, std::string_view translation) const;
+    // The scripture item after the one reading reference, if any
+    const Item* nextReading(std::string_view reference) const;
+
+private:
+    std::shared_ptr<MappedFile> file;
+    std::string path;
+    std::string_view plan_id;
+    std::string_view plan_title;
+    int64_t built_at = 0;
+    std::vector<std::string_view> translations;
+    std::vector<Item> items;
+    std::vector<Media> media_table;
+};
+
+#endif // SERVICE_BUNDLE_H
@@ -8,6 +8,83 @@
 #include <fstream>
 #include <filesystem>
 
+namespace {
+
+nlohmann::json itemToJson(const ServiceItem& item) {
+    nlohmann::json item_json;
+    item_json["id"] = item.id;
+    item_json["title"] = item.title;
+    item_json["type"] = static_cast<int>(item.type);
+    item_json["content"] = item.content;
+    item_json["description"] = item.description;
+    item_json["duration_seconds"] = item.duration.count();
+    item_json["assigned_to"] = item.assigned_to;
+    item_json["assigned_role"] = static_cast<int>(item.assigned_role);
+    item_json["notes"] = item.notes;
+    item_json["tags"] = item.tags;
+    item_json["is_transition"] = item.is_transition;
+    
+    // Scripture-specific fields
+    if (item.type == ServiceItemType::SCRIPTURE) {
+        item_json["translation"] = item.translation;
+        item_json["book"] = item.book;
+        item_json["chapter"] = item.chapter;
+        item_json["verse_start"] = item.verse_start;
+        item_json["verse_end"] = item.verse_end;
+    }
+    
+    // Media-specific fields
+    if (item.type == ServiceItemType::MEDIA) {
+        item_json["media_path"] = item.media_path;
+        item_json["media_type"] = item.media_type;
+    }
+    return item_json;
+}
+
+// Sets the fields item_json has and leaves the rest; throws on a wrong type
+void readItemFields(const nlohmann::json& item_json, ServiceItem& item) {
+    if (item_json.contains("id")) item.id = item_json["id"].get<std::string>();
+    if (item_json.contains("title")) item.title = item_json["title"].get<std::string>();
+    if (item_json.contains("type")) item.type = static_cast<ServiceItemType>(item_json["type"].get<int>());
+    if (item_json.contains("content")) item.content = item_json["content"].get<std::string>();
+    if (item_json.contains("description")) item.description = item_json["description"].get<std::string>();
+    if (item_json.contains("duration_seconds")) {
+        item.duration = std::chrono::seconds(item_json["duration_seconds"].get<long long>());
+    }
+    if (item_json.contains("assigned_to")) item.assigned_to = item_json["assigned_to"].get<std::string>();
+    if (item_json.contains("assigned_role")) {
+        item.assigned_role = static_cast<ServiceRole>(item_json["assigned_role"].get<int>());
+    }
+    if (item_json.contains("notes")) item.notes = item_json["notes"].get<std::string>();
+    if (item_json.contains("tags")) item.tags = item_json["tags"].get<std::vector<std::string>>();
+    if (item_json.contains("is_transition")) item.is_transition = item_json["is_transition"].get<bool>();
+    if (item_json.contains("translation")) item.translation = item_json["translation"].get<std::string>();
+    if (item_json.contains("book")) item.book = item_json["book"].get<std::string>();
+    if (item_json.contains("chapter")) item.chapter = item_json["chapter"].get<int>();
+    if (item_json.contains("verse_start")) item.verse_start = item_json["verse_start"].get<int>();
+    if (item_json.contains("verse_end")) item.verse_end = item_json["verse_end"].get<int>();
+    if (item_json.contains("media_path")) item.media_path = item_json["media_path"].get<std::string>();
+    if (item_json.contains("media_type")) item.media_type = item_json["media_type"].get<std::string>();
+}
+
+nlohmann::json itemsToJson(const std::vector<ServiceItem>& items) {
+    nlohmann::json array = nlohmann::json::array();
+    for (const auto& item : items) {
+        array.push_back(itemToJson(item));
+    }
+    return array;
+}
+
+std::vector<ServiceItem>::iterator findItem(std::vector<ServiceItem>& items, const std::string& item_id) {
+    return std::find_if(items.begin(), items.end(),
+        [&item_id](const ServiceItem& item) { return item.id == item_id; });
+}
+
+// Short names keep operation batches small on the wire
+const char* const OPERATION_NAMES[] = {"ins", "rm", "mv", "upd", "ord", "title", "desc", "replace"};
+
+} // namespace
+
 ServicePlan::ServicePlan() 
     : id_(generateItemId()),
       service_time_(std::chrono::system_clock::now()),
@@ -22,12 +99,18 @@ ServicePlan::ServicePlan(const std::string& title, const std::chrono::system_clo
       service_time_(service_time),
       created_at_(std::chrono::system_clock::now()),
       last_modified_(std::chrono::system_clock::now()),
-      approval_status_(ApprovalStatus::DRAFT) {
+      approval_status_(ApprovalStatus::DRAFT),
+      base_title_(title) {
 }
 
 void ServicePlan::setTitle(const std::string& title) {
     title_ = title;
     updateLastModified();
+    
+    PlanOperation operation;
+    operation.type = PlanOperation::Type::SET_TITLE;
+    operation.payload = title;
+    record(std::move(operation));
 }
 
 std::string ServicePlan::getTitle() const {
@@ -46,6 +129,11 @@ std::chrono::system_clock::time_point ServicePlan::getServiceTime() const {
 void ServicePlan::setDescription(const std::string& description) {
     description_ = description;
     updateLastModified();
+    
+    PlanOperation operation;
+    operation.type = PlanOperation::Type::SET_DESCRIPTION;
+    operation.payload = description;
+    record(std::move(operation));
 }
 
 std::string ServicePlan::getDescription() const {
@@ -75,6 +163,13 @@ void ServicePlan::addItem(const ServiceItem& item) {
     
     items_.push_back(new_item);
     updateLastModified();
+    
+    PlanOperation operation;
+    operation.type = PlanOperation::Type::INSERT;
+    operation.item_id = new_item.id;
+    operation.index = items_.size() - 1;
+    operation.payload = itemToJson(new_item).dump();
+    record(std::move(operation));
 }
 
 void ServicePlan::insertItem(size_t index, const ServiceItem& item) {
@@ -83,20 +178,34 @@ void ServicePlan::insertItem(size_t index, const ServiceItem& item) {
         new_item.id = generateItemId();
     }
     if (index >= items_.size()) {
+        index = items_.size();
         items_.push_back(new_item);
     } else {
         items_.insert(items_.begin() + index, new_item);
     }
     updateLastModified();
+    
+    PlanOperation operation;
+    operation.type = PlanOperation::Type::INSERT;
+    operation.item_id = new_item.id;
+    operation.index = index;
+    operation.payload = itemToJson(new_item).dump();
+    record(std::move(operation));
 }
 
 void ServicePlan::removeItem(const std::string& item_id) {
-    items_.erase(
-        std::remove_if(items_.begin(), items_.end(),
-            [&item_id](const ServiceItem& item) { return item.id == item_id; }),
-        items_.end()
-    );
+    auto it = findItem(items_, item_id);
+    if (it == items_.end()) {
+        return;
+    }
+    // Before erasing: item_id may be the erased item's own id
+    PlanOperation operation;
+    operation.type = PlanOperation::Type::REMOVE;
+    operation.item_id = item_id;
+    
+    items_.erase(it);
     updateLastModified();
+    record(std::move(operation));
 }
 
 void ServicePlan::moveItem(const std::string& item_id, size_t new_index) {
@@ -112,25 +221,63 @@ void ServicePlan::moveItem(const std::string& item_id, size_t new_index) {
             return;
         }
         
+        // Before erasing: item_id may be the erased item's own id
+        PlanOperation operation;
+        operation.type = PlanOperation::Type::MOVE;
+        operation.item_id = item_id;
+        
         items_.erase(it);
         
         // Adjust new_index if it's beyond the new size after removal
         if (new_index >= items_.size()) {
+            new_index = items_.size();
             items_.push_back(item);
         } else {
             items_.insert(items_.begin() + new_index, item);
         }
         updateLastModified();
+        
+        operation.index = new_index;
+        record(std::move(operation));
     }
 }
 
 void ServicePlan::updateItem(const ServiceItem& item) {
-    auto it = std::find_if(items_.begin(), items_.end(),
-        [&item](const ServiceItem& existing) { return existing.id == item.id; });
+    auto it = findItem(items_, item.id);
+    if (it == items_.end()) {
+        return;
+    }
     
-    if (it != items_.end()) {
-        *it = item;
+    // Only the fields that changed are recorded
+    nlohmann::json before = itemToJson(*it);
+    nlohmann::json after = itemToJson(item);
+    nlohmann::json changes = nlohmann::json::object();
+    for (const auto& [key, value] : after.items()) {
+        if (!before.contains(key) || before[key] != value) {
+            changes[key] = value;
+        }
+    }
+    if (changes.empty()) {
+        return;
+    }
+    
+    *it = item;
+    updateLastModified();
+    
+    PlanOperation operation;
+    operation.type = PlanOperation::Type::UPDATE;
+    operation.item_id = item.id;
+    operation.payload = changes.dump();
+    record(std::move(operation));
+}
+
+void ServicePlan::reorderItems(const std::vector<std::string>& order) {
+    PlanOperation operation;
+    operation.type = PlanOperation::Type::REORDER;
+    operation.order = order;
+    if (applyTo(operation, items_, title_, description_)) {
         updateLastModified();
+        record(std::move(operation));
     }
 }
 
@@ -216,6 +363,8 @@ void ServicePlan::loadFromTemplate(const std::string& template_name) {
         file.close();
         
         auto template_json = nlohmann::json::parse(json_content);
+        std::string old_title = title_;
+        std::string old_description = description_;
         
         // Load template data
         if (template_json.contains("title")) {
@@ -294,6 +443,7 @@ void ServicePlan::loadFromTemplate(const std::string& template_name) {
         }
         
         updateLastModified();
+        recordReplace(old_title, old_description);
         
     } catch (const std::exception&) {
         // Template load failed, but don't throw - this is not critical
@@ -363,7 +513,9 @@ std::string ServicePlan::createVersion(const std::string& comment, const std::st
     version.created_by = created_by;
     version.created_at = std::chrono::system_clock::now();
     version.comment = comment;
-    version.items = items_;
+    version.revision = revision_;
+    version.operations = std::move(unversioned_operations_);
+    unversioned_operations_.clear();
     
     versions_.push_back(version);
     return version.version_id;
@@ -373,10 +525,254 @@ void ServicePlan::revertToVersion(const std::string& version_id) {
     auto it = std::find_if(versions_.begin(), versions_.end(),
         [&version_id](const ServiceVersion& version) { return version.version_id == version_id; });
     
-    if (it != versions_.end()) {
-        items_ = it->items;
-        updateLastModified();
+    if (it == versions_.end()) {
+        return;
+    }
+    
+    std::vector<ServiceItem> items = base_items_;
+    std::string title = base_title_;
+    std::string description = base_description_;
+    for (auto version = versions_.begin(); version != std::next(it); ++version) {
+        for (const auto& operation : version->operations) {
+            applyTo(operation, items, title, description);
+        }
     }
+    
+    std::string old_title = title_;
+    std::string old_description = description_;
+    items_ = std::move(items);
+    title_ = std::move(title);
+    description_ = std::move(description);
+    updateLastModified();
+    recordReplace(old_title, old_description);
+}
+
+uint64_t ServicePlan::getRevision() const {
+    return revision_;
+}
+
+bool ServicePlan::applyOperation(PlanOperation operation) {
+    if (!applyTo(operation, items_, title_, description_)) {
+        return false;
+    }
+    updateLastModified();
+    record(std::move(operation));
+    return true;
+}
+
+bool ServicePlan::getOperationsSince(uint64_t revision, std::vector<PlanOperation>& operations) const {
+    operations.clear();
+    if (revision >= revision_) {
+        return revision == revision_;
+    }
+    if (recent_operations_.empty() || recent_operations_.front().revision > revision + 1) {
+        return false;
+    }
+    for (const auto& operation : recent_operations_) {
+        if (operation.revision > revision) {
+            operations.push_back(operation);
+        }
+    }
+    return true;
+}
+
+void ServicePlan::setOperationListener(std::function<void(const PlanOperation&)> listener) {
+    operation_listener_ = std::move(listener);
+}
+
+std::string ServicePlan::operationsToJson(const std::vector<PlanOperation>& operations) {
+    nlohmann::json array = nlohmann::json::array();
+    for (const auto& operation : operations) {
+        nlohmann::json entry;
+        entry["r"] = operation.revision;
+        entry["t"] = OPERATION_NAMES[static_cast<int>(operation.type)];
+        switch (operation.type) {
+            case PlanOperation::Type::INSERT:
+                entry["id"] = operation.item_id;
+                entry["i"] = operation.index;
+                entry["p"] = nlohmann::json::parse(operation.payload);
+                break;
+            case PlanOperation::Type::REMOVE:
+                entry["id"] = operation.item_id;
+                break;
+            case PlanOperation::Type::MOVE:
+                entry["id"] = operation.item_id;
+                entry["i"] = operation.index;
+                break;
+            case PlanOperation::Type::UPDATE:
+                entry["id"] = operation.item_id;
+                entry["p"] = nlohmann::json::parse(operation.payload);
+                break;
+            case PlanOperation::Type::REORDER:
+                entry["o"] = operation.order;
+                break;
+            case PlanOperation::Type::SET_TITLE:
+            case PlanOperation::Type::SET_DESCRIPTION:
+                entry["p"] = operation.payload;
+                break;
+            case PlanOperation::Type::REPLACE:
+                entry["p"] = nlohmann::json::parse(operation.payload);
+                break;
+        }
+        if (!operation.author.empty()) {
+            entry["a"] = operation.author;
+        }
+        array.push_back(std::move(entry));
+    }
+    return array.dump();
+}
+
+bool ServicePlan::operationsFromJson(const std::string& json_data, std::vector<PlanOperation>& operations) {
+    operations.clear();
+    try {
+        auto array = nlohmann::json::parse(json_data);
+        if (!array.is_array()) {
+            return false;
+        }
+        for (const auto& entry : array) {
+            PlanOperation operation;
+            std::string name = entry.at("t").get<std::string>();
+            auto type = std::find(std::begin(OPERATION_NAMES), std::end(OPERATION_NAMES), name);
+            if (type == std::end(OPERATION_NAMES)) {
+                return false;
+            }
+            operation.type = static_cast<PlanOperation::Type>(type - std::begin(OPERATION_NAMES));
+            operation.revision = entry.value("r", uint64_t(0));
+            operation.item_id = entry.value("id", "");
+            operation.index = entry.value("i", size_t(0));
+            operation.author = entry.value("a", "");
+            if (entry.contains("o")) {
+                operation.order = entry["o"].get<std::vector<std::string>>();
+            }
+            if (entry.contains("p")) {
+                operation.payload = entry["p"].is_string() ? entry["p"].get<std::string>() : entry["p"].dump();
+            }
+            operations.push_back(std::move(operation));
+        }
+        return true;
+    } catch (const std::exception&) {
+        operations.clear();
+        return false;
+    }
+}
+
+void ServicePlan::record(PlanOperation operation) {
+    operation.revision = ++revision_;
+    unversioned_operations_.push_back(operation);
+    recent_operations_.push_back(operation);
+    if (recent_operations_.size() > MAX_RECENT_OPERATIONS) {
+        recent_operations_.pop_front();
+    }
+    if (operation_listener_) {
+        operation_listener_(recent_operations_.back());
+    }
+}
+
+void ServicePlan::recordReplace(const std::string& old_title, const std::string& old_description) {
+    if (title_ != old_title) {
+        PlanOperation operation;
+        operation.type = PlanOperation::Type::SET_TITLE;
+        operation.payload = title_;
+        record(std::move(operation));
+    }
+    if (description_ != old_description) {
+        PlanOperation operation;
+        operation.type = PlanOperation::Type::SET_DESCRIPTION;
+        operation.payload = description_;
+        record(std::move(operation));
+    }
+    PlanOperation operation;
+    operation.type = PlanOperation::Type::REPLACE;
+    operation.payload = itemsToJson(items_).dump();
+    record(std::move(operation));
+}
+
+bool ServicePlan::applyTo(const PlanOperation& operation, std::vector<ServiceItem>& items,
+                          std::string& title, std::string& description) {
+    try {
+        switch (operation.type) {
+            case PlanOperation::Type::INSERT: {
+                ServiceItem item;
+                readItemFields(nlohmann::json::parse(operation.payload), item);
+                if (item.id.empty() || findItem(items, item.id) != items.end()) {
+                    return false;
+                }
+                items.insert(items.begin() + std::min(operation.index, items.size()), std::move(item));
+                return true;
+            }
+            case PlanOperation::Type::REMOVE: {
+                auto it = findItem(items, operation.item_id);
+                if (it == items.end()) {
+                    return false;
+                }
+                items.erase(it);
+                return true;
+            }
+            case PlanOperation::Type::MOVE: {
+                auto it = findItem(items, operation.item_id);
+                if (it == items.end()) {
+                    return false;
+                }
+                ServiceItem item = std::move(*it);
+                items.erase(it);
+                items.insert(items.begin() + std::min(operation.index, items.size()), std::move(item));
+                return true;
+            }
+            case PlanOperation::Type::UPDATE: {
+                auto it = findItem(items, operation.item_id);
+                if (it == items.end()) {
+                    return false;
+                }
+                // Applied to a copy so a bad field leaves the item as it was
+                ServiceItem item = *it;
+                readItemFields(nlohmann::json::parse(operation.payload), item);
+                item.id = operation.item_id;
+                *it = std::move(item);
+                return true;
+            }
+            case PlanOperation::Type::REORDER: {
+                if (operation.order.size() != items.size()) {
+                    return false;
+                }
+                std::vector<ServiceItem> reordered;
+                reordered.reserve(items.size());
+                for (const auto& id : operation.order) {
+                    auto it = findItem(items, id);
+                    if (it == items.end()) {
+                        return false;
+                    }
+                    reordered.push_back(*it);
+                }
+                // Duplicates in order would have dropped an item
+                for (const auto& item : items) {
+                    if (findItem(reordered, item.id) == reordered.end()) {
+                        return false;
+                    }
+                }
+                items = std::move(reordered);
+                return true;
+            }
+            case PlanOperation::Type::SET_TITLE:
+                title = operation.payload;
+                return true;
+            case PlanOperation::Type::SET_DESCRIPTION:
+                description = operation.payload;
+                return true;
+            case PlanOperation::Type::REPLACE: {
+                std::vector<ServiceItem> replaced;
+                for (const auto& item_json : nlohmann::json::parse(operation.payload)) {
+                    ServiceItem item;
+                    readItemFields(item_json, item);
+                    replaced.push_back(std::move(item));
+                }
+                items = std::move(replaced);
+                return true;
+            }
+        }
+    } catch (const std::exception&) {
+        // Malformed payload
+    }
+    return false;
 }
 
 std::vector<ServiceVersion> ServicePlan::getVersionHistory() const {
@@ -452,39 +848,10 @@ std::string ServicePlan::exportToJson() const {
         time_stream << std::put_time(std::gmtime(&time_t), "%Y-%m-%dT%H:%M:%SZ");
         json["service_time"] = time_stream.str();
         
+        json["revision"] = revision_;
+        
         // Export items
-        json["items"] = nlohmann::json::array();
-        for (const auto& item : items_) {
-            nlohmann::json item_json;
-            item_json["id"] = item.id;
-            item_json["title"] = item.title;
-            item_json["type"] = static_cast<int>(item.type);
-            item_json["content"] = item.content;
-            item_json["description"] = item.description;
-            item_json["duration_seconds"] = item.duration.count();
-            item_json["assigned_to"] = item.assigned_to;
-            item_json["assigned_role"] = static_cast<int>(item.assigned_role);
-            item_json["notes"] = item.notes;
-            item_json["tags"] = item.tags;
-            item_json["is_transition"] = item.is_transition;
-            
-            // Scripture-specific fields
-            if (item.type == ServiceItemType::SCRIPTURE) {
-                item_json["translation"] = item.translation;
-                item_json["book"] = item.book;
-                item_json["chapter"] = item.chapter;
-                item_json["verse_start"] = item.verse_start;
-                item_json["verse_end"] = item.verse_end;
-            }
-            
-            // Media-specific fields
-            if (item.type == ServiceItemType::MEDIA) {
-                item_json["media_path"] = item.media_path;
-                item_json["media_type"] = item.media_type;
-            }
-            
-            json["items"].push_back(item_json);
-        }
+        json["items"] = itemsToJson(items_);
         
         return json.dump(2); // Pretty print with 2-space indentation
         
@@ -502,36 +869,29 @@ bool ServicePlan::importFromJson(const std::string& json_data) {
             return false;
         }
         
-        // Import basic properties
-        id_ = json["id"].get<std::string>();
-        title_ = json["title"].get<std::string>();
-        
-        if (json.contains("description")) {
-            description_ = json["description"].get<std::string>();
-        }
-        
-        // Import items if present
+        // Parse everything before changing anything
+        std::string old_title = title_;
+        std::string old_description = description_;
+        std::string title = json["title"].get<std::string>();
+        std::string description = json.contains("description") ? json["description"].get<std::string>() : description_;
+        std::vector<ServiceItem> items = items_;
         if (json.contains("items") && json["items"].is_array()) {
-            items_.clear();
+            items.clear();
             for (const auto& item_json : json["items"]) {
                 ServiceItem item;
-                if (item_json.contains("id")) {
-                    item.id = item_json["id"].get<std::string>();
-                }
-                if (item_json.contains("title")) {
-                    item.title = item_json["title"].get<std::string>();
-                }
-                if (item_json.contains("type")) {
-                    item.type = static_cast<ServiceItemType>(item_json["type"].get<int>());
-                }
-                if (item_json.contains("content")) {
-                    item.content = item_json["content"].get<std::string>();
-                }
-                items_.push_back(item);
+                readItemFields(item_json, item);
+                items.push_back(item);
             }
         }
         
+        // Import basic properties
+        id_ = json["id"].get<std::string>();
+        title_ = std::move(title);
+        description_ = std::move(description);
+        items_ = std::move(items);
+        
         updateLastModified();
+        recordReplace(old_title, old_description);
         return true;
         
     } catch (const std::exception&) {
@@ -4,6 +4,9 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <mutex>
@@ -69,12 +72,37 @@ struct ServiceCollaborator {
     std::chrono::system_clock::time_point last_active;
 };
 
+// One edit to a plan. Every change made through ServicePlan is recorded as
+// one of these and numbered, so other editors can apply edits as they
+// happen instead of reloading the whole plan.
+struct PlanOperation {
+    enum class Type {
+        INSERT,          // payload: the item, at index
+        REMOVE,
+        MOVE,            // to index
+        UPDATE,          // payload: only the item fields that changed
+        REORDER,         // order: every item id
+        SET_TITLE,       // payload: the text
+        SET_DESCRIPTION, // payload: the text
+        REPLACE          // payload: all items, for imports and reverts
+    };
+
+    Type type = Type::UPDATE;
+    uint64_t revision = 0;  // assigned when the plan records it
+    std::string item_id;
+    size_t index = 0;
+    std::string payload;    // JSON, except for the SET_ types
+    std::vector<std::string> order;
+    std::string author;
+};
+
 struct ServiceVersion {
     std::string version_id;
     std::string created_by;
     std::chrono::system_clock::time_point created_at;
     std::string comment;
-    std::vector<ServiceItem> items;
+    uint64_t revision = 0;                  // plan revision it captures
+    std::vector<PlanOperation> operations;  // edits since the previous version
 };
 
 class ServicePlan {
@@ -96,6 +124,9 @@ public:
     void removeItem(const std::string& item_id);
     void moveItem(const std::string& item_id, size_t new_index);
     void updateItem(const ServiceItem& item);
+    // order lists every item id; ignored otherwise
+    void reorderItems(const std::vector<std::string>& order);
+    // Edit through the methods above: changes made through these references are not recorded
     std::vector<ServiceItem>& getItems();
     const std::vector<ServiceItem>& getItems() const;
     ServiceItem* getItem(const std::string& item_id);
@@ -112,7 +143,20 @@ public:
     std::vector<ServiceCollaborator>& getCollaborators();
     const std::vector<ServiceCollaborator>& getCollaborators() const;
     
-    // Version control
+    // Operation log. Operations another editor made are applied with
+    // applyOperation(), which returns false if one no longer fits (its item
+    // is gone, or the order is stale). The listener sees every operation
+    // recorded, local or applied, with its revision set.
+    uint64_t getRevision() const;
+    bool applyOperation(PlanOperation operation);
+    // Operations after revision, oldest first; false if the log no longer reaches back that far
+    bool getOperationsSince(uint64_t revision, std::vector<PlanOperation>& operations) const;
+    void setOperationListener(std::function<void(const PlanOperation&)> listener);
+    static std::string operationsToJson(const std::vector<PlanOperation>& operations);
+    static bool operationsFromJson(const std::string& json_data, std::vector<PlanOperation>& operations);
+    
+    // Version control: a version keeps only the operations since the one
+    // before it, and reverting replays them from the plan's starting point
     std::string createVersion(const std::string& comment, const std::string& created_by);
     void revertToVersion(const std::string& version_id);
     std::vector<ServiceVersion> getVersionHistory() const;
@@ -161,9 +205,23 @@ private:
     std::vector<std::string> approval_comments_;
     std::unordered_map<std::string, std::chrono::system_clock::time_point> sync_timestamps_;
     
+    // The plan before its first recorded operation, which versions replay from
+    std::vector<ServiceItem> base_items_;
+    std::string base_title_;
+    std::string base_description_;
+    uint64_t revision_ = 0;
+    std::vector<PlanOperation> unversioned_operations_;  // since the last version
+    std::deque<PlanOperation> recent_operations_;        // for editors catching up
+    std::function<void(const PlanOperation&)> operation_listener_;
+    static constexpr size_t MAX_RECENT_OPERATIONS = 1024;
+    
     // Thread safety
     mutable std::mutex mutex_;
     
+    void record(PlanOperation operation);
+    void recordReplace(const std::string& old_title, const std::string& old_description);
+    static bool applyTo(const PlanOperation& operation, std::vector<ServiceItem>& items,
+                        std::string& title, std::string& description);
     void updateLastModified();
     std::string generateItemId() const;
     std::string generateVersionId() const;
@@ -0,0 +1,12 @@
+#ifndef IMGUI_THREAD_CONFIG_H
+#define IMGUI_THREAD_CONFIG_H
+
+// Dear ImGui user config (IMGUI_USER_CONFIG) for the application target.
+// The presentation output draws on its own thread with its own ImGui context
+// (see PresentationRenderer), so each thread keeps its own current context
+// instead of sharing ImGui's global one.
+struct ImGuiContext;
+extern thread_local ImGuiContext* ImGuiThreadContext;
+#define GImGui ImGuiThreadContext
+
+#endif // IMGUI_THREAD_CONFIG_H
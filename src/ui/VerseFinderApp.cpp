@@ -1,16 +1,28 @@
 #include "VerseFinderApp.h"
 #include "components/PluginManagerWindow.h"
+#include "../core/TaskScheduler.h"
+#include "../core/CacheManager.h"
+#include "../core/HealthMonitor.h"
+#include "../core/BackupManager.h"
+#include "../core/EmergencyModeHandler.h"
+#include "../core/MetricsRegistry.h"
+#include "../core/Tracer.h"
 #include <iostream>
 #include <filesystem>
 #include <fstream>
 #include <algorithm>
+#include <cctype>
 #include <regex>
 #include <ctime>
 #include <cstdlib>
+#include <cstring>
 #include <thread>
 #include <future>
+#include <optional>
 #include <chrono>
 #include <atomic>
+#include <cstdio>
+#include <sstream>
 
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
@@ -29,6 +41,70 @@
 #include <shlobj.h>
 #endif
 
+namespace {
+// Beside settings.json; read at startup and written at exit for the cache warm-up
+std::string searchHistoryPath() {
+    return (std::filesystem::path(PlatformUtils::getSettingsFilePath()).parent_path() / "search_history.txt").string();
+}
+
+// Wrapped text drawn word by word, the words a span touches in color; the
+// spans come with the result, so nothing is searched while drawing
+void renderHighlightedText(std::string_view text, const std::vector<MatchSpan>& spans, const ImVec4& color) {
+    ImGui::BeginGroup();
+    const float space = ImGui::CalcTextSize(" ").x;
+    const float right_edge = ImGui::GetWindowPos().x + ImGui::GetWindowContentRegionMax().x;
+    size_t span = 0;
+    bool first = true;
+    for (size_t pos = 0; pos < text.size();) {
+        size_t end = std::min(text.find(' ', pos), text.size());
+        if (end > pos) {
+            const char* begin = text.data() + pos;
+            float width = ImGui::CalcTextSize(begin, text.data() + end).x;
+            if (!first && ImGui::GetItemRectMax().x + space + width <= right_edge) {
+                ImGui::SameLine(0.0f, space);
+            }
+            while (span < spans.size() && spans[span].end <= pos) ++span;
+            bool matched = span < spans.size() && spans[span].begin < end;
+            if (matched) ImGui::PushStyleColor(ImGuiCol_Text, color);
+            ImGui::TextUnformatted(begin, text.data() + end);
+            if (matched) ImGui::PopStyleColor();
+            first = false;
+        }
+        pos = end + 1;
+    }
+    ImGui::EndGroup();
+}
+
+std::vector<PresentationRenderer::OutputTarget> parsePresentationOutputs(const std::string& setting) {
+    std::vector<PresentationRenderer::OutputTarget> targets;
+    std::stringstream outputs(setting);
+    std::string output;
+    while (std::getline(outputs, output, ',')) {
+        std::stringstream fields(output);
+        std::string field;
+        PresentationRenderer::OutputTarget target;
+        std::getline(fields, target.name, ':');
+        if (target.name.empty()) continue;
+        while (std::getline(fields, field, ':')) {
+            int width = 0;
+            int height = 0;
+            if (field == "keyed") {
+                target.keyed = true;
+            } else if (field == "lower-third") {
+                target.layout = PresentationRenderer::Layout::LOWER_THIRD;
+            } else if (std::sscanf(field.c_str(), "%dx%d", &width, &height) == 2 && width > 0 && height > 0) {
+                target.width = width;
+                target.height = height;
+            } else {
+                std::cerr << "Ignoring presentation output option " << field << " of " << target.name << std::endl;
+            }
+        }
+        targets.push_back(target);
+    }
+    return targets;
+}
+}
+
 VerseFinderApp::VerseFinderApp() : window(nullptr), presentation_window(nullptr) {
     // Initialize integration manager and service planning
     integration_manager = std::make_unique<IntegrationManager>();
@@ -37,6 +113,8 @@ VerseFinderApp::VerseFinderApp() : window(nullptr), presentation_window(nullptr)
     // Initialize API server
     api_server = std::make_unique<ApiServer>();
     setupApiRoutes();
+    plan_sync = std::make_unique<PlanSyncChannel>(*api_server, []() { FrameScheduler::shared().requestRedraw(); });
+    plan_sync->attach(current_service_plan.get());
     
     // Initialize UI components
     theme_manager = std::make_unique<ThemeManager>();
@@ -44,13 +122,27 @@ VerseFinderApp::VerseFinderApp() : window(nullptr), presentation_window(nullptr)
     window_manager = std::make_unique<WindowManager>();
     accessibility_manager = std::make_unique<AccessibilityManager>();
     presentation_window_component = std::make_unique<PresentationWindow>(userSettings);
+    presentation_window_component->setStateListener([this](const std::string& change, const PresentationWindow& view) {
+        json state = {
+            {"change", change},
+            {"active", view.isPresentationModeActive()},
+            {"blank", view.isBlankScreenActive()},
+            {"reference", view.getCurrentDisplayedReference()},
+            {"text", view.getCurrentDisplayedVerse()}
+        };
+        if (change == "transition") {
+            state["transition"] = {
+                {"type", PresentationWindow::transitionTypeName(view.getLastTransition())},
+                {"duration_ms", view.getLastTransitionDuration()}
+            };
+        }
+        std::string payload = state.dump();
+        api_server->broadcastEvent("/api/presentation/events", "presentation", payload);
+        api_server->triggerWebhook("presentation", payload);
+    });
     translation_comparison = std::make_unique<TranslationComparison>();
     
-    // Initialize plugin system
-    if (plugins_enabled) {
-        plugin_manager = std::make_unique<PluginSystem::PluginManager>(&bible);
-        initializePluginSystem();
-    }
+    // Plugins, the Bible and the services start in init(); see declareStartupTasks()
 }
 
 VerseFinderApp::~VerseFinderApp() {
@@ -63,7 +155,11 @@ void VerseFinderApp::glfwErrorCallback(int error, const char* description) {
 }
 
 bool VerseFinderApp::init() {
+    app_start_time = std::chrono::steady_clock::now();
+    
     // Load settings first
+    settings_file = std::make_unique<SettingsFile>(PlatformUtils::getSettingsFilePath(),
+                                                   [this]() { return settingsSnapshot(); });
     loadSettings();
     
     // Setup error callback
@@ -102,6 +198,9 @@ bool VerseFinderApp::init() {
     
     glfwMakeContextCurrent(window);
     glfwSwapInterval(1); // Enable vsync
+    if (const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor())) {
+        if (mode->refreshRate > 0) frame_profiler.setFrameBudget(1000.0 / mode->refreshRate);
+    }
     
     // Explicitly show the window (required on some platforms like macOS)
     glfwShowWindow(window);
@@ -128,74 +227,6 @@ bool VerseFinderApp::init() {
     ImGuiIO& io = ImGui::GetIO();
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
     
-    // Initialize accessibility manager
-    accessibility_manager->initialize();
-    accessibility_manager->setupImGuiAccessibility(ImGui::GetCurrentContext());
-    
-    // Register voice commands
-    accessibility_manager->registerVoiceCommand(VoiceCommand::SEARCH_VERSE, [this](const std::string& input) {
-        // Extract verse reference from voice input and perform search
-        std::string query = input;
-        // Simple pattern extraction - remove "search for", "find", "go to" etc.
-        std::regex pattern(R"((search for|find|go to|show)\s*(.+))");
-        std::smatch match;
-        if (std::regex_search(query, match, pattern) && match.size() > 2) {
-            query = match[2].str();
-        }
-        
-        strncpy(search_input, query.c_str(), sizeof(search_input) - 1);
-        search_input[sizeof(search_input) - 1] = '\0';
-        performSearch();
-        
-        if (accessibility_manager->isFeatureEnabled(AccessibilityFeature::SCREEN_READER)) {
-            accessibility_manager->announceAction("Searching for " + query);
-        }
-    });
-    
-    accessibility_manager->registerVoiceCommand(VoiceCommand::PRESENTATION_MODE, [this](const std::string&) {
-        togglePresentationMode();
-        if (accessibility_manager->isFeatureEnabled(AccessibilityFeature::SCREEN_READER)) {
-            accessibility_manager->announceAction(isPresentationWindowActive() ? 
-                "Presentation mode activated" : "Presentation mode deactivated");
-        }
-    });
-    
-    accessibility_manager->registerVoiceCommand(VoiceCommand::BLANK_SCREEN, [this](const std::string&) {
-        if (isPresentationWindowActive()) {
-            toggleBlankScreen();
-            if (accessibility_manager->isFeatureEnabled(AccessibilityFeature::SCREEN_READER)) {
-                accessibility_manager->announceAction(presentation_blank_screen ? 
-                    "Screen blanked" : "Screen unblanked");
-            }
-        }
-    });
-    
-    accessibility_manager->registerVoiceCommand(VoiceCommand::SHOW_VERSE, [this](const std::string&) {
-        if (isPresentationWindowActive() && !selected_verse_text.empty()) {
-            std::string verse_text = formatVerseText(selected_verse_text);
-            std::string reference = formatVerseReference(selected_verse_text);
-            displayVerseOnPresentation(verse_text, reference);
-            
-            if (accessibility_manager->isFeatureEnabled(AccessibilityFeature::SCREEN_READER)) {
-                accessibility_manager->announceVerseText(verse_text, reference);
-            }
-        }
-    });
-    
-    accessibility_manager->registerVoiceCommand(VoiceCommand::HELP, [this](const std::string&) {
-        show_help_window = true;
-        if (accessibility_manager->isFeatureEnabled(AccessibilityFeature::SCREEN_READER)) {
-            accessibility_manager->announceAction("Help window opened");
-        }
-    });
-    
-    accessibility_manager->registerVoiceCommand(VoiceCommand::SETTINGS, [this](const std::string&) {
-        show_settings_window = true;
-        if (accessibility_manager->isFeatureEnabled(AccessibilityFeature::SCREEN_READER)) {
-            accessibility_manager->announceAction("Settings window opened");
-        }
-    });
-    
     // Apply accessibility settings to UI
     if (userSettings.accessibility.high_contrast_enabled) {
         accessibility_manager->applyHighContrastTheme();
@@ -213,12 +244,15 @@ bool VerseFinderApp::init() {
     style.WindowRounding = 0.0f;
     style.Colors[ImGuiCol_WindowBg].w = 1.0f;
     
-    // Setup Platform/Renderer backends
+    // Setup Platform/Renderer backends; ImGui chains to the frame scheduler's input callbacks
+    FrameScheduler::shared().attach(window);
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init(glsl_version);
     
     // Load fonts with symbol support using system font size
     float systemFontSize = font_manager->getSystemFontSize();
+    // The presentation component draws its effects from this atlas
+    PresentationEffects::reserveEffectPadding(io.Fonts);
     
     // Try to load a custom font with fallback to default
     std::vector<std::string> font_paths;
@@ -233,56 +267,39 @@ bool VerseFinderApp::init() {
     font_paths.push_back(exe_dir + "/fonts/Gentium_Plus/GentiumPlus-Regular.ttf");
     font_paths.push_back(exe_dir + "/fonts/arial/ARIAL.TTF");
     
-    // Try to load fonts in order of preference
-    ImFont* loaded_font = nullptr;
+    // The first font found is the UI font
     for (const auto& path : font_paths) {
         if (std::filesystem::exists(path)) {
-            loaded_font = io.Fonts->AddFontFromFileTTF(path.c_str(), systemFontSize);
-            if (loaded_font) {
-                std::cout << "Loaded font: " << path << std::endl;
-                break;
-            }
+            ui_font_path = path;
+            glyph_cache.addSource(path, systemFontSize);
+            break;
         }
     }
     
-    // If no custom font loaded, use default
-    if (!loaded_font) {
-        std::cout << "Using default ImGui font" << std::endl;
-        io.Fonts->AddFontDefault();
-    }
-    
-    // Add Unicode ranges for symbol/emoji support (limited to 16-bit ranges)
-    static const ImWchar ranges[] = {
-        0x0020, 0x00FF, // Basic Latin + Latin Supplement
-        0x2000, 0x206F, // General Punctuation
-        0x2190, 0x21FF, // Arrows
-        0x2600, 0x26FF, // Miscellaneous Symbols (includes some emoji-like symbols)
-        0x2700, 0x27BF, // Dingbats
-        0x3000, 0x30FF, // CJK Symbols and Punctuation, Hiragana, Katakana
-        0x31F0, 0x31FF, // Katakana Phonetic Extensions
-        0xFF00, 0xFFEF, // Half-width characters
-        0,
-    };
-    
-    ImFontConfig config;
-    config.MergeMode = true;
-    config.GlyphMinAdvanceX = systemFontSize; // Ensure symbols are properly spaced
-    
-    // Try to add a system font with better symbol support
+    // A system font with better symbol coverage fills in what the UI font lacks
+    ImFontConfig symbol_config;
+    symbol_config.GlyphMinAdvanceX = systemFontSize; // Ensure symbols are properly spaced
     #ifdef __APPLE__
-        // Try system UI font which has good symbol support
-        io.Fonts->AddFontFromFileTTF("/System/Library/Fonts/Helvetica.ttc", systemFontSize, &config, ranges);
+        glyph_cache.addSource("/System/Library/Fonts/Helvetica.ttc", systemFontSize, symbol_config);
     #elif _WIN32
-        io.Fonts->AddFontFromFileTTF("C:/Windows/Fonts/segoeui.ttf", systemFontSize, &config, ranges);
+        glyph_cache.addSource("C:/Windows/Fonts/segoeui.ttf", systemFontSize, symbol_config);
     #else
         // On Linux, try DejaVu Sans which has good symbol coverage
-        io.Fonts->AddFontFromFileTTF("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", systemFontSize, &config, ranges);
+        glyph_cache.addSource("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", systemFontSize, symbol_config);
     #endif
     
-    // Setup translations directory and start async loading
-    std::string translations_path = PlatformUtils::PlatformUtils::getExecutablePath() + "/translations";
-    bible.setTranslationsDirectory(translations_path);
-    bible.loadAllTranslations();
+    // Always baked: Latin and the symbols the UI draws. Other scripts (and
+    // the CJK and half-width forms once baked up front) are added as
+    // verses using them are shown.
+    glyph_cache.pinRange(0x0020, 0x00FF); // Basic Latin + Latin Supplement
+    glyph_cache.pinRange(0x2000, 0x207F); // General Punctuation
+    glyph_cache.pinRange(0x2180, 0x21FF); // Arrows
+    glyph_cache.pinRange(0x2600, 0x27BF); // Miscellaneous Symbols, Dingbats
+    if (!glyph_cache.build(io.Fonts)) {
+        std::cout << "Using default ImGui font" << std::endl;
+    } else if (!ui_font_path.empty()) {
+        std::cout << "Loaded font: " << ui_font_path << std::endl;
+    }
     
     // Initialize UI components that need dependencies
     search_component = std::make_unique<SearchComponent>(&bible);
@@ -294,163 +311,245 @@ bool VerseFinderApp::init() {
     translation_comparison->setVerseFinderRef(&bible);
     translation_manager_modal->setVerseFinderRef(&bible);
     
-    // Note: Scanning for existing translations will be done asynchronously 
-    // in the background to avoid blocking the GUI initialization
-    
     // Apply loaded settings to application state
     fuzzy_search_enabled = userSettings.search.fuzzySearchEnabled;
     bible.enableFuzzySearch(fuzzy_search_enabled);
+    bible.setBookAliases(userSettings.content.customBookAliases);
     auto_search = userSettings.search.autoSearch;
     show_performance_stats = userSettings.search.showPerformanceStats;
     
-    // Start API server if enabled
-    if (api_server_enabled) {
-        if (!api_server->start(8080)) {
-            std::cerr << "Failed to start API server" << std::endl;
+    // VERSEFINDER_TRACE=<n> turns on span tracing of one request in n (1 = all);
+    // fetch the trace from /api/debug/trace and open it in ui.perfetto.dev
+    if (const char* trace_setting = std::getenv("VERSEFINDER_TRACE")) {
+        long interval = std::strtol(trace_setting, nullptr, 10);
+        if (interval > 0) {
+            Tracer::shared().setSampleInterval(static_cast<uint32_t>(interval));
+            Tracer::shared().setEnabled(true);
         }
     }
     
+    // Everything else starts alongside the first frames
+    declareStartupTasks();
+    if (!startup.start()) {
+        std::cerr << "Startup tasks could not be scheduled" << std::endl;
+        return false;
+    }
+    
     return true;
 }
 
-void VerseFinderApp::setupApiRoutes() {
-    // Enable CORS for web browser access
-    api_server->enableCors("*");
-    
-    // Search endpoint
-    // Examples: 
-    // /api/search?q=John%203:16 (John 3:16)
-    // /api/search?q=love&translation=ESV 
-    // /api/search?q=psalm+23 (psalm 23)
-    api_server->addRoute(HttpMethod::GET, "/api/search", [this](const ApiRequest& req) -> ApiResponse {
-        auto query_it = req.query_params.find("q");
-        if (query_it == req.query_params.end()) {
-            return errorResponse(400, "Missing query parameter 'q'");
-        }
-        
-        std::string query = query_it->second;
-        
-        // Get the first available translation as default
-        std::string translation;
-        if (!bible.getTranslations().empty()) {
-            translation = bible.getTranslations()[0].name;
-        } else {
-            return errorResponse(503, "No translations loaded");
-        }
-        
-        // Check if user specified a translation parameter
-        auto trans_it = req.query_params.find("translation");
-        if (trans_it != req.query_params.end()) {
-            std::string requested_translation = trans_it->second;
-            
-            // Look for exact match by name or abbreviation
+void VerseFinderApp::declareStartupTasks() {
+    using Affinity = StartupGraph::Affinity;
+    
+    // Main-thread tasks run between frames, which must then come promptly
+    startup.setMainThreadWake([]() { FrameScheduler::shared().requestRedraw(); });
+    
+    // First: the default translation, and with it reference lookup and search
+    startup.add("translations", {}, [this]() {
+        std::string translations_path = PlatformUtils::PlatformUtils::getExecutablePath() + "/translations";
+        bible.setTranslationsDirectory(translations_path);
+        // VERSEFINDER_RESIDENCY_MB=<n> caps the memory of translations kept loaded;
+        // the least recently used beyond it are dropped and read again on demand
+        if (const char* residency_setting = std::getenv("VERSEFINDER_RESIDENCY_MB")) {
+            long megabytes = std::strtol(residency_setting, nullptr, 10);
+            if (megabytes > 0) {
+                bible.setResidencyBudget(static_cast<size_t>(megabytes) * 1024 * 1024);
+            }
+        }
+        // VERSEFINDER_COMPRESS_TEXT=1 keeps verse text compressed, for displays short of memory
+        if (const char* compress_setting = std::getenv("VERSEFINDER_COMPRESS_TEXT")) {
+            bible.setCompressedText(std::strcmp(compress_setting, "1") == 0);
+        }
+        // VERSEFINDER_SUBSTRING_INDEX=1 lets boolean searches find any fragment from an index
+        if (const char* substring_setting = std::getenv("VERSEFINDER_SUBSTRING_INDEX")) {
+            bible.setSubstringSearch(std::strcmp(substring_setting, "1") == 0);
+        }
+        // Before loading: the completion index is ranked with it
+        bible.loadSearchHistory(searchHistoryPath());
+        bible.loadAllTranslations();
+    }, TaskPriority::INTERACTIVE);
+    
+    // Which downloadable translations are already on disk, for the manager
+    auto downloaded = std::make_shared<std::vector<bool>>();
+    startup.add("translation_files", {}, [this, downloaded]() {
+        std::vector<std::string> search_directories = {
+            PlatformUtils::getExecutablePath() + "/translations/",
+            PlatformUtils::getExecutablePath() + "/",
+            PlatformUtils::getExecutablePath() + "/data/",
+            "./translations/",
+            "./"
+        };
+        for (const auto& available : available_translations) {
             bool found = false;
-            for (const auto& trans : bible.getTranslations()) {
-                if (trans.name == requested_translation || trans.abbreviation == requested_translation) {
-                    translation = trans.name; // Always use the full name internally
+            std::string expected_filename = getTranslationFilename(available.name);
+            for (const auto& dir : search_directories) {
+                std::string full_path = dir + expected_filename;
+                if (std::filesystem::exists(full_path)) {
+                    std::cout << "Found existing translation file: " << available.name 
+                              << " at " << full_path << std::endl;
                     found = true;
                     break;
                 }
             }
-            
-            if (!found) {
-                // Build list of available translations for error message
-                std::string available_list = "";
-                const auto& translations = bible.getTranslations();
-                for (size_t i = 0; i < translations.size(); ++i) {
-                    if (i > 0) available_list += ", ";
-                    available_list += translations[i].name + " (" + translations[i].abbreviation + ")";
-                }
-                return errorResponse(400, "Translation '" + requested_translation + "' not found. Available: " + available_list);
-            }
+            downloaded->push_back(found);
         }
-        
-        // Log the query to show URL decoding worked
-        std::cout << "[API] Search query: '" << query << "' with translation: '" << translation << "'" << std::endl;
-        
-        if (!bible.isReady()) {
-            return errorResponse(503, "Bible data not ready");
+    });
+    startup.add("translation_files_shown", {"translation_files"}, [this, downloaded]() {
+        for (size_t i = 0; i < available_translations.size() && i < downloaded->size(); ++i) {
+            if (!available_translations[i].is_downloading) {
+                available_translations[i].is_downloaded = (*downloaded)[i];
+            }
         }
-        
-        // Try reference search first
-        std::string result = bible.searchByReference(query, translation);
-        if (result != "Verse not found." && result != "Bible is loading...") {
-            std::string json = std::string("{\"type\": \"reference\", \"query\": \"") + query + 
-                              std::string("\", \"translation\": \"") + translation + 
-                              std::string("\", \"result\": \"") + result + std::string("\"}");
-            return jsonResponse(json);
+    }, TaskPriority::BACKGROUND, Affinity::MAIN);
+    
+    // Plugins load off the UI thread; searches use them once attached
+    auto plugins = std::make_shared<std::unique_ptr<PluginSystem::PluginManager>>();
+    if (plugins_enabled) {
+        startup.add("plugins", {}, [this, plugins]() {
+            *plugins = initializePluginSystem();
+        });
+        startup.add("plugins_attached", {"plugins"}, [this, plugins]() {
+            plugin_manager = std::move(*plugins);
+            plugins_enabled = plugin_manager != nullptr;
+        }, TaskPriority::BACKGROUND, Affinity::MAIN);
+    }
+    
+    // Needs the ImGui context
+    startup.add("accessibility", {}, [this]() {
+        accessibility_manager->initialize();
+        accessibility_manager->setupImGuiAccessibility(ImGui::GetCurrentContext());
+        registerVoiceCommands();
+    }, TaskPriority::INTERACTIVE, Affinity::MAIN);
+    
+    // Health monitoring sheds optional work when the machine is overloaded,
+    // so reference lookup and display stay fast; see applyDegradationLevel()
+    startup.add("reliability", {}, []() {
+        ReliabilityManager& reliability = ReliabilityManager::getInstance();
+        reliability.enableAutoSave(false); // No session state is registered to save
+        if (!reliability.initialize(".") || !reliability.start()) {
+            std::cerr << "Health monitoring unavailable; load shedding is off" << std::endl;
+        }
+        // Settings, history and plans change little between services, so an
+        // hourly backup writes only what did
+        if (BackupManager* backups = reliability.getBackupManager()) {
+            backups->addSource(std::filesystem::path(PlatformUtils::getSettingsFilePath()).parent_path().string());
+            backups->setAutomaticInterval(std::chrono::hours(1));
         }
-        
-        // Try keyword search
-        auto keyword_results = bible.searchByKeywords(query, translation);
-        if (!keyword_results.empty()) {
-            std::string json = std::string("{\"type\": \"keyword\", \"query\": \"") + query + 
-                              std::string("\", \"translation\": \"") + translation + 
-                              std::string("\", \"results\": [");
-            for (size_t i = 0; i < keyword_results.size(); ++i) {
-                if (i > 0) json += ", ";
-                json += "\"" + keyword_results[i] + "\"";
+    });
+    
+    // Remote clients get "loading" answers until the translations are in
+    if (api_server_enabled) {
+        startup.add("api_server", {}, [this]() {
+            if (!api_server->start(8080)) {
+                std::cerr << "Failed to start API server" << std::endl;
             }
-            json += "]}";
-            return jsonResponse(json);
+        }, TaskPriority::API);
+    }
+}
+
+void VerseFinderApp::registerVoiceCommands() {
+    accessibility_manager->registerVoiceCommand(VoiceCommand::SEARCH_VERSE, [this](const std::string& input) {
+        // Extract verse reference from voice input and perform search
+        std::string query = input;
+        // Simple pattern extraction - remove "search for", "find", "go to" etc.
+        std::regex pattern(R"((search for|find|go to|show)\s*(.+))");
+        std::smatch match;
+        if (std::regex_search(query, match, pattern) && match.size() > 2) {
+            query = match[2].str();
         }
         
-        // If no results found, provide available translations info
-        std::string available_translations = "";
-        const auto& translations = bible.getTranslations();
-        for (size_t i = 0; i < translations.size(); ++i) {
-            if (i > 0) available_translations += ", ";
-            available_translations += translations[i].name;
-        }
+        strncpy(search_input, query.c_str(), sizeof(search_input) - 1);
+        search_input[sizeof(search_input) - 1] = '\0';
+        performSearch();
         
-        std::string error_msg = "No results found";
-        if (!available_translations.empty()) {
-            error_msg += ". Available translations: " + available_translations;
+        if (accessibility_manager->isFeatureEnabled(AccessibilityFeature::SCREEN_READER)) {
+            accessibility_manager->announceAction("Searching for " + query);
         }
-        
-        return errorResponse(404, error_msg);
     });
     
-    // Translations endpoint
-    api_server->addRoute(HttpMethod::GET, "/api/translations", [this](const ApiRequest&) -> ApiResponse {
-        if (!bible.isReady()) {
-            return errorResponse(503, "Bible data not ready");
+    accessibility_manager->registerVoiceCommand(VoiceCommand::PRESENTATION_MODE, [this](const std::string&) {
+        togglePresentationMode();
+        if (accessibility_manager->isFeatureEnabled(AccessibilityFeature::SCREEN_READER)) {
+            accessibility_manager->announceAction(isPresentationWindowActive() ? 
+                "Presentation mode activated" : "Presentation mode deactivated");
         }
-        
-        const auto& translations = bible.getTranslations();
-        std::string json = "{\"translations\": [";
-        bool first = true;
-        for (const auto& trans : translations) {
-            if (!first) json += ", ";
-            json += "{\"name\": \"" + trans.name + "\", \"abbreviation\": \"" + trans.abbreviation + "\"}";
-            first = false;
+    });
+    
+    accessibility_manager->registerVoiceCommand(VoiceCommand::BLANK_SCREEN, [this](const std::string&) {
+        if (isPresentationWindowActive()) {
+            toggleBlankScreen();
+            if (accessibility_manager->isFeatureEnabled(AccessibilityFeature::SCREEN_READER)) {
+                accessibility_manager->announceAction(presentation_blank_screen ? 
+                    "Screen blanked" : "Screen unblanked");
+            }
         }
-        json += "]}";
-        return jsonResponse(json);
     });
     
-    // Health check endpoint
-    api_server->addRoute(HttpMethod::GET, "/api/health", [this](const ApiRequest& req) -> ApiResponse {
-        std::string json = std::string("{\"status\": \"ok\", \"bible_ready\": ") + 
-                          (bible.isReady() ? "true" : "false") + 
-                          std::string(", \"api_server_running\": true");
-        
-        // Add test parameter to verify URL decoding works
-        auto test_it = req.query_params.find("test");
-        if (test_it != req.query_params.end()) {
-            json = std::string("{\"status\": \"ok\", \"bible_ready\": ") + 
-                   (bible.isReady() ? "true" : "false") + 
-                   std::string(", \"api_server_running\": true, \"test_decoded\": \"") + 
-                   test_it->second + std::string("\"}");
+    accessibility_manager->registerVoiceCommand(VoiceCommand::SHOW_VERSE, [this](const std::string&) {
+        if (isPresentationWindowActive() && !selected_verse_text.empty()) {
+            std::string verse_text = formatVerseText(selected_verse_text);
+            std::string reference = formatVerseReference(selected_verse_text);
+            displayVerseOnPresentation(verse_text, reference);
+            
+            if (accessibility_manager->isFeatureEnabled(AccessibilityFeature::SCREEN_READER)) {
+                accessibility_manager->announceVerseText(verse_text, reference);
+            }
+        }
+    });
+    
+    accessibility_manager->registerVoiceCommand(VoiceCommand::HELP, [this](const std::string&) {
+        show_help_window = true;
+        if (accessibility_manager->isFeatureEnabled(AccessibilityFeature::SCREEN_READER)) {
+            accessibility_manager->announceAction("Help window opened");
+        }
+    });
+    
+    accessibility_manager->registerVoiceCommand(VoiceCommand::SETTINGS, [this](const std::string&) {
+        show_settings_window = true;
+        if (accessibility_manager->isFeatureEnabled(AccessibilityFeature::SCREEN_READER)) {
+            accessibility_manager->announceAction("Settings window opened");
         }
-        
-        return jsonResponse(json);
     });
 }
 
+void VerseFinderApp::setupApiRoutes() {
+    // Enable CORS for web browser access
+    api_server->enableCors("*");
+    
+    search_api = std::make_unique<SearchApi>(*api_server, bible);
+    
+    // Live presentation state for remote displays and overlays (Server-Sent Events)
+    // Example: new EventSource("http://host:8080/api/presentation/events")
+    api_server->addEventStream("/api/presentation/events");
+    publishPresentationState("init");
+}
+
 void VerseFinderApp::run() {
+    Histogram& frame_time = MetricsRegistry::shared().histogram(
+        "versefinder_frame_duration_seconds", "Time to build and render one UI frame, excluding vsync");
+    Tracer::shared().setThreadName("ui");
+    
     while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+        // Sleeps while nothing changes; see FrameScheduler
+        bool active_frame = FrameScheduler::shared().waitForNextFrame(isAnimating());
+        TRACE_SCOPE("frame");
+        auto frame_start = std::chrono::steady_clock::now();
+        // Sections below are timed per frame; see FrameProfiler
+        frame_profiler.beginFrame();
+        drainSearchMailbox();
+        drainBundleMailbox();
+        {
+            TRACE_SCOPE("ui.startup_tasks");
+            startup.runMainThreadTasks();
+        }
+        // Remote plan edits in, last frame's local edits out
+        plan_sync->pump();
+        
+        // Bake glyphs that text shown since the last frame needs
+        {
+            TRACE_SCOPE("ui.glyph_cache");
+            glyph_cache.refresh();
+        }
         
         // Start the Dear ImGui frame
         ImGui_ImplOpenGL3_NewFrame();
@@ -459,6 +558,8 @@ void VerseFinderApp::run() {
         
         // Update accessibility manager
         accessibility_manager->update();
+        settings_file->poll();
+        CacheManager::shared().poll(); // shifts cache budgets toward the caches in use
         
         // Handle accessibility keyboard shortcuts first
         if (!accessibility_manager->handleAccessibilityKeyInput()) {
@@ -511,6 +612,8 @@ void VerseFinderApp::run() {
             if (ImGui::BeginMenu("View")) {
                 ImGui::MenuItem("Auto Search", nullptr, &auto_search);
                 ImGui::MenuItem("Performance Stats", nullptr, &show_performance_stats);
+                ImGui::MenuItem("Query Explain", nullptr, &show_explain_window);
+                ImGui::MenuItem("Frame Profiler", nullptr, &show_frame_profiler);
                 if (ImGui::MenuItem("Translation Comparison", "Ctrl+T")) {
                     show_comparison_window = true;
                 }
@@ -582,12 +685,22 @@ void VerseFinderApp::run() {
             renderPerformanceWindow();
         }
         
+        if (show_explain_window) {
+            renderExplainWindow();
+        }
+        
         if (show_comparison_window) {
             renderComparisonWindow();
         }
         
+        if (show_frame_profiler) {
+            TRACE_SCOPE("ui.frame_profiler");
+            frame_profiler.renderWindow(&show_frame_profiler);
+        }
+        
         // Render translation manager modal
         if (translation_manager_modal) {
+            TRACE_SCOPE("ui.translation_manager");
             translation_manager_modal->render();
         }
         
@@ -595,19 +708,35 @@ void VerseFinderApp::run() {
         accessibility_manager->renderAccessibilityOverlay();
         
         // Rendering
-        ImGui::Render();
-        int display_w, display_h;
-        glfwGetFramebufferSize(window, &display_w, &display_h);
-        glViewport(0, 0, display_w, display_h);
-        glClearColor(0.11f, 0.11f, 0.12f, 1.00f);
-        glClear(GL_COLOR_BUFFER_BIT);
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-        
-        // Render presentation window if active
-        if (isPresentationWindowActive()) {
-            renderPresentationWindow();
+        {
+            TRACE_SCOPE("ui.render");
+            ImGui::Render();
+            int display_w, display_h;
+            glfwGetFramebufferSize(window, &display_w, &display_h);
+            frame_profiler.beginGpu();
+            glViewport(0, 0, display_w, display_h);
+            glClearColor(0.11f, 0.11f, 0.12f, 1.00f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            frame_profiler.endGpu();
+        }
+        
+        // The presentation window draws on its own thread; settings only
+        // change with input, so idle refreshes need not look for edits
+        if (isPresentationWindowActive() && active_frame) {
+            syncPresentationStyle();
+        }
+        
+        auto frame_duration = std::chrono::steady_clock::now() - frame_start;
+        frame_time.observe(frame_duration);
+        frame_profiler.endFrame(frame_duration);
+        // Health monitoring starts with the other startup tasks, off this thread
+        if (startup.isDone("reliability")) {
+            if (HealthMonitor* health = ReliabilityManager::getInstance().getHealthMonitor()) {
+                health->reportFrameTime(std::chrono::duration_cast<std::chrono::microseconds>(frame_duration));
+            }
+            applyDegradationLevel();
         }
-        
         glfwSwapBuffers(window);
     }
 }
@@ -644,6 +773,7 @@ void VerseFinderApp::renderMainWindow() {
 }
 
 void VerseFinderApp::renderSearchArea() {
+    TRACE_SCOPE("ui.search_bar");
     ImGui::Text("Bible Search");
     ImGui::Spacing();
     
@@ -701,6 +831,14 @@ void VerseFinderApp::renderSearchArea() {
         }
     }
     
+    // One merged list from every resident translation instead of one search each
+    ImGui::SameLine();
+    ImGui::Text("All translations: ");
+    ImGui::SameLine();
+    if (ImGui::Checkbox("##all_translations", &search_all_translations) && strlen(search_input) > 0) {
+        performSearch();
+    }
+    
     // Show fuzzy search suggestions
     if (fuzzy_search_enabled && strlen(search_input) > 0) {
         // Book name suggestions
@@ -767,12 +905,23 @@ void VerseFinderApp::renderSearchArea() {
 }
 
 void VerseFinderApp::renderSearchResults() {
+    TRACE_SCOPE("ui.results");
     if (!bible.isReady()) {
         ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "Loading Bible data...");
         return;
     }
     
+    // The previous results stay up while a search runs in the background
+    if (search_in_progress) {
+        static const char* const spinner = "|/-\\";
+        int frame = static_cast<int>(ImGui::GetTime() / 0.1) % 4;
+        ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "%c Searching...", spinner[frame]);
+    }
+    
     if (search_results.empty()) {
+        if (search_in_progress) {
+            return;
+        }
         if (strlen(search_input) > 0) {
             ImGui::TextColored(ImVec4(0.8f, 0.4f, 0.4f, 1.0f), "No verses found");
             ImGui::Text("Try different keywords or check the reference");
@@ -795,134 +944,135 @@ void VerseFinderApp::renderSearchResults() {
     // Results list with scrolling
     ImGui::BeginChild("ResultsList", ImVec2(0, 0), false);
     
-    for (size_t i = 0; i < search_results.size(); ++i) {
-        const std::string& result = search_results[i];
-        
-        // Parse reference and text
-        size_t colon_pos = result.find(": ");
-        if (colon_pos == std::string::npos) continue;
-        
-        std::string reference = result.substr(0, colon_pos);
-        std::string verse_text = result.substr(colon_pos + 2);
-        
-        // Highlight current selection
-        bool is_selected = (static_cast<int>(i) == selected_result_index);
-        if (is_selected) {
-            ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0.3f, 0.5f, 0.8f, 0.3f));
-        }
-        
-        // Different layout for chapter viewing vs search results
-        float child_height = is_viewing_chapter ? 60.0f : 80.0f;
-        ImGui::BeginChild(("result_" + std::to_string(i)).c_str(), ImVec2(0, child_height), true);
-        
-        if (is_viewing_chapter) {
-            // Extract verse number for chapter viewing
-            size_t last_colon = reference.find_last_of(':');
-            std::string verse_num = (last_colon != std::string::npos) ? 
-                                   reference.substr(last_colon + 1) : std::to_string(i + 1);
-            
-            // Show verse number prominently and make it clickable
-            ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.4f, 0.8f, 1.0f));
-            ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.3f, 0.5f, 0.9f, 1.0f));
-            ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.1f, 0.3f, 0.7f, 1.0f));
-            
-            if (ImGui::Button(("v" + verse_num).c_str(), ImVec2(40, 0))) {
-                // Jump to this specific verse
-                std::string book;
-                int chapter, verse;
-                if (bible.parseReference(reference, book, chapter, verse)) {
-                    jumpToVerse(book, chapter, verse);
-                }
-            }
-            ImGui::PopStyleColor(3);
+    // Every row is a fixed-height child, so the clipper can place them without
+    // measuring and only the rows in view are laid out
+    float child_height = is_viewing_chapter ? 60.0f : 80.0f;
+    ImGuiListClipper clipper;
+    clipper.Begin(static_cast<int>(search_results.size()), child_height + ImGui::GetStyle().ItemSpacing.y);
+    while (clipper.Step()) {
+        for (size_t i = static_cast<size_t>(clipper.DisplayStart); i < static_cast<size_t>(clipper.DisplayEnd); ++i) {
+            const std::string& result = search_results[i];
             
-            ImGui::SameLine();
-            ImGui::Text("%s", verse_text.c_str());
-        } else {
-            // Regular search result display
-            // Show favorite star if this verse is favorited
-            bool isFavorite = userSettings.isFavoriteVerse(result);
-            if (isFavorite) {
-                ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.0f, 1.0f), "*");
-                ImGui::SameLine();
+            // Parse reference and text; a malformed row still keeps its slot
+            size_t colon_pos = result.find(": ");
+            if (colon_pos == std::string::npos) {
+                ImGui::Dummy(ImVec2(0.0f, child_height));
+                continue;
             }
-            ImGui::TextColored(ImVec4(0.4f, 0.7f, 1.0f, 1.0f), "%s", reference.c_str());
             
-            // Verse text with word wrapping
-            ImGui::PushTextWrapPos(0.0f);
+            std::string reference = result.substr(0, colon_pos);
+            std::string verse_text = result.substr(colon_pos + 2);
             
-            // Highlight search terms in verse text
-            std::string display_text = verse_text;
-            if (display_text.length() > 150) {
-                display_text = display_text.substr(0, 147) + "...";
-            }
-            
-            // Simple highlighting with case-insensitive search
-            bool should_highlight = false;
-            if (strlen(search_input) > 0) {
-                std::string lower_search = search_input;
-                std::string lower_display = display_text;
-                std::transform(lower_search.begin(), lower_search.end(), lower_search.begin(),
-                              [](unsigned char c){ return std::tolower(c); });
-                std::transform(lower_display.begin(), lower_display.end(), lower_display.begin(),
-                              [](unsigned char c){ return std::tolower(c); });
-                should_highlight = lower_display.find(lower_search) != std::string::npos;
+            // Highlight current selection
+            bool is_selected = (static_cast<int>(i) == selected_result_index);
+            if (is_selected) {
+                ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(0.3f, 0.5f, 0.8f, 0.3f));
             }
             
-            if (should_highlight) {
-                ImGui::TextColored(ImVec4(1.0f, 1.0f, 0.6f, 1.0f), "%s", display_text.c_str());
-            } else {
-                ImGui::Text("%s", display_text.c_str());
-            }
+            // Different layout for chapter viewing vs search results
+            ImGui::BeginChild(("result_" + std::to_string(i)).c_str(), ImVec2(0, child_height), true);
             
-            ImGui::PopTextWrapPos();
-        }
-        
-        // Click to select/view
-        if (ImGui::IsItemClicked()) {
-            selectResult(static_cast<int>(i));
-        }
-        
-        // Double-click to open modal
-        if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(0)) {
-            selectResult(static_cast<int>(i));
-            show_verse_modal = true;
-        }
-        
-        // Right-click context menu
-        if (ImGui::BeginPopupContextItem(("context_" + std::to_string(i)).c_str())) {
-            bool isFavorite = userSettings.isFavoriteVerse(result);
-            if (isFavorite) {
-                if (ImGui::MenuItem("Remove from Favorites")) {
-                    userSettings.removeFavoriteVerse(result);
+            if (is_viewing_chapter) {
+                // Extract verse number for chapter viewing
+                size_t last_colon = reference.find_last_of(':');
+                std::string verse_num = (last_colon != std::string::npos) ? 
+                                       reference.substr(last_colon + 1) : std::to_string(i + 1);
+                
+                // Show verse number prominently and make it clickable
+                ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0.2f, 0.4f, 0.8f, 1.0f));
+                ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(0.3f, 0.5f, 0.9f, 1.0f));
+                ImGui::PushStyleColor(ImGuiCol_ButtonActive, ImVec4(0.1f, 0.3f, 0.7f, 1.0f));
+                
+                if (ImGui::Button(("v" + verse_num).c_str(), ImVec2(40, 0))) {
+                    // Jump to this specific verse
+                    std::string book;
+                    int chapter, verse;
+                    if (bible.parseReference(reference, book, chapter, verse)) {
+                        jumpToVerse(book, chapter, verse);
+                    }
                 }
+                ImGui::PopStyleColor(3);
+                
+                ImGui::SameLine();
+                ImGui::Text("%s", verse_text.c_str());
             } else {
-                if (ImGui::MenuItem("Add to Favorites")) {
-                    userSettings.addFavoriteVerse(result);
+                // Regular search result display
+                // Show favorite star if this verse is favorited
+                bool isFavorite = userSettings.isFavoriteVerse(result);
+                if (isFavorite) {
+                    ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.0f, 1.0f), "*");
+                    ImGui::SameLine();
                 }
+                ImGui::TextColored(ImVec4(0.4f, 0.7f, 1.0f, 1.0f), "%s", reference.c_str());
+                
+                // Verse text with word wrapping
+                ImGui::PushTextWrapPos(0.0f);
+                
+                // Highlight search terms in verse text
+                std::string display_text = verse_text;
+                if (display_text.length() > 150) {
+                    display_text = display_text.substr(0, 147) + "...";
+                }
+                
+                // Matched words as the search found them; the spans are offsets into verse_text
+                if (i < search_highlights.size() && !search_highlights[i].empty()) {
+                    renderHighlightedText(display_text, search_highlights[i], ImVec4(1.0f, 1.0f, 0.6f, 1.0f));
+                } else {
+                    ImGui::Text("%s", display_text.c_str());
+                }
+                
+                ImGui::PopTextWrapPos();
             }
-            if (ImGui::MenuItem("Copy to Clipboard")) {
-                copyToClipboard(result);
+            
+            // Click to select/view
+            if (ImGui::IsItemClicked()) {
+                selectResult(static_cast<int>(i));
             }
-            if (ImGui::MenuItem("View Full Verse")) {
+            
+            // Double-click to open modal
+            if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(0)) {
                 selectResult(static_cast<int>(i));
                 show_verse_modal = true;
             }
-            if (userSettings.presentation.enabled && ImGui::MenuItem("Display on Presentation")) {
-                selectResult(static_cast<int>(i));
-                std::string verse_text = formatVerseText(selected_verse_text);
-                std::string reference = formatVerseReference(selected_verse_text);
-                displayVerseOnPresentation(verse_text, reference);
+            
+            // Right-click context menu
+            if (ImGui::BeginPopupContextItem(("context_" + std::to_string(i)).c_str())) {
+                bool isFavorite = userSettings.isFavoriteVerse(result);
+                if (isFavorite) {
+                    if (ImGui::MenuItem("Remove from Favorites")) {
+                        userSettings.removeFavoriteVerse(result);
+                        settingsChanged();
+                    }
+                } else {
+                    if (ImGui::MenuItem("Add to Favorites")) {
+                        userSettings.addFavoriteVerse(result);
+                        settingsChanged();
+                    }
+                }
+                if (ImGui::MenuItem("Copy to Clipboard")) {
+                    copyToClipboard(result);
+                }
+                if (ImGui::MenuItem("View Full Verse")) {
+                    selectResult(static_cast<int>(i));
+                    show_verse_modal = true;
+                }
+                if (userSettings.presentation.enabled && ImGui::MenuItem("Display on Presentation")) {
+                    selectResult(static_cast<int>(i));
+                    std::string verse_text = formatVerseText(selected_verse_text);
+                    std::string reference = formatVerseReference(selected_verse_text);
+                    displayVerseOnPresentation(verse_text, reference);
+                }
+                ImGui::EndPopup();
+            }
+            
+            ImGui::EndChild();
+            
+            if (is_selected) {
+                ImGui::PopStyleColor();
             }
-            ImGui::EndPopup();
-        }
-        
-        ImGui::EndChild();
-        
-        if (is_selected) {
-            ImGui::PopStyleColor();
         }
     }
+    clipper.End();
     
     ImGui::EndChild();
 }
@@ -994,6 +1144,16 @@ void VerseFinderApp::renderStatusBar() {
         ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.3f, 1.0f), "Loading Bible data...");
     }
     
+    // Dropped frames show here whether or not the profiler is open
+    if (size_t slow_frames = frame_profiler.slowFrames()) {
+        ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.3f, 1.0f), "%zu slow frame(s) lately", slow_frames);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Frames over %.1f ms in the last few seconds; see View > Frame Profiler",
+                              frame_profiler.frameBudget());
+        }
+        if (ImGui::IsItemClicked()) show_frame_profiler = true;
+    }
+    
     // Selected verse preview
     if (!selected_verse_text.empty()) {
         ImGui::Spacing();
@@ -1079,6 +1239,7 @@ void VerseFinderApp::renderVerseModal() {
 }
 
 void VerseFinderApp::renderSettingsWindow() {
+    TRACE_SCOPE("ui.settings");
     ImGui::SetNextWindowSize(ImVec2(800, 600), ImGuiCond_FirstUseEver);
     
     if (ImGui::Begin("Settings", &show_settings_window)) {
@@ -1161,6 +1322,7 @@ void VerseFinderApp::renderSettingsWindow() {
                 float fontSize = userSettings.display.fontSize;
                 if (ImGui::SliderFloat("Font Size", &fontSize, 8.0f, 36.0f, "%.1f")) {
                     userSettings.display.fontSize = fontSize;
+                    settingsChanged();
                     // Apply font size change immediately
                     ImGui::GetIO().FontGlobalScale = fontSize / 16.0f; // Relative to default 16px
                 }
@@ -1187,6 +1349,7 @@ void VerseFinderApp::renderSettingsWindow() {
                         case 2: userSettings.display.colorTheme = "blue"; break;
                         case 3: userSettings.display.colorTheme = "green"; break;
                     }
+                    settingsChanged();
                     theme_manager->setupImGuiStyle(userSettings.display.colorTheme, userSettings.display.fontSize / 16.0f); // Apply theme immediately
                 }
                 
@@ -1201,6 +1364,7 @@ void VerseFinderApp::renderSettingsWindow() {
                            (int)(highlightColor.y * 255), 
                            (int)(highlightColor.z * 255));
                     userSettings.display.highlightColor = colorHex;
+                    settingsChanged();
                 }
                 ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "Color used for highlighting search results");
                 
@@ -1214,6 +1378,7 @@ void VerseFinderApp::renderSettingsWindow() {
                 bool rememberWindow = userSettings.display.rememberWindowState;
                 if (ImGui::Checkbox("Remember Window Size & Position", &rememberWindow)) {
                     userSettings.display.rememberWindowState = rememberWindow;
+                    settingsChanged();
                 }
                 ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "Save window layout between sessions");
                 
@@ -1243,6 +1408,7 @@ void VerseFinderApp::renderSettingsWindow() {
                         bool isSelected = (userSettings.search.defaultTranslation == trans.abbreviation);
                         if (ImGui::Selectable(trans.abbreviation.c_str(), isSelected)) {
                             userSettings.search.defaultTranslation = trans.abbreviation;
+                            settingsChanged();
                         }
                         if (isSelected) {
                             ImGui::SetItemDefaultFocus();
@@ -1258,6 +1424,7 @@ void VerseFinderApp::renderSettingsWindow() {
                 int maxResults = userSettings.search.maxSearchResults;
                 if (ImGui::SliderInt("Max Search Results", &maxResults, 10, 200)) {
                     userSettings.search.maxSearchResults = maxResults;
+                    settingsChanged();
                 }
                 ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "Maximum number of verses to show in search results");
                 
@@ -1267,6 +1434,7 @@ void VerseFinderApp::renderSettingsWindow() {
                 bool autoSearchSetting = userSettings.search.autoSearch;
                 if (ImGui::Checkbox("Auto Search", &autoSearchSetting)) {
                     userSettings.search.autoSearch = autoSearchSetting;
+                    settingsChanged();
                     auto_search = autoSearchSetting;
                 }
                 ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "Search automatically as you type");
@@ -1285,6 +1453,7 @@ void VerseFinderApp::renderSettingsWindow() {
                         case 1: userSettings.search.searchResultFormat = "text_only"; break;
                         case 2: userSettings.search.searchResultFormat = "reference_only"; break;
                     }
+                    settingsChanged();
                 }
                 ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "How to display search results");
                 
@@ -1294,6 +1463,7 @@ void VerseFinderApp::renderSettingsWindow() {
                 bool showPerfStats = userSettings.search.showPerformanceStats;
                 if (ImGui::Checkbox("Show Performance Statistics", &showPerfStats)) {
                     userSettings.search.showPerformanceStats = showPerfStats;
+                    settingsChanged();
                     show_performance_stats = showPerfStats;
                 }
                 ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "Display search timing information");
@@ -1328,6 +1498,7 @@ void VerseFinderApp::renderSettingsWindow() {
                 bool fuzzyEnabled = userSettings.search.fuzzySearchEnabled;
                 if (ImGui::Checkbox("Enable Fuzzy Search", &fuzzyEnabled)) {
                     userSettings.search.fuzzySearchEnabled = fuzzyEnabled;
+                    settingsChanged();
                     fuzzy_search_enabled = fuzzyEnabled;
                     bible.enableFuzzySearch(fuzzy_search_enabled);
                 }
@@ -1413,6 +1584,7 @@ void VerseFinderApp::renderSettingsWindow() {
                         if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(0)) {
                             // Remove from favorites on double-click
                             userSettings.removeFavoriteVerse(verse);
+                            settingsChanged();
                         }
                     }
                     ImGui::EndListBox();
@@ -1429,6 +1601,7 @@ void VerseFinderApp::renderSettingsWindow() {
                 bool saveHistory = userSettings.content.saveSearchHistory;
                 if (ImGui::Checkbox("Save Search History", &saveHistory)) {
                     userSettings.content.saveSearchHistory = saveHistory;
+                    settingsChanged();
                 }
                 
                 if (userSettings.content.saveSearchHistory) {
@@ -1437,6 +1610,7 @@ void VerseFinderApp::renderSettingsWindow() {
                     int maxHistory = userSettings.content.maxHistoryEntries;
                     if (ImGui::SliderInt("Max History Entries", &maxHistory, 10, 500)) {
                         userSettings.content.maxHistoryEntries = maxHistory;
+                        settingsChanged();
                     }
                     
                     ImGui::Spacing();
@@ -1451,6 +1625,7 @@ void VerseFinderApp::renderSettingsWindow() {
                     
                     if (ImGui::Button("Clear History")) {
                         userSettings.content.searchHistory.clear();
+                        settingsChanged();
                     }
                 }
                 
@@ -1472,6 +1647,7 @@ void VerseFinderApp::renderSettingsWindow() {
                         case 1: userSettings.content.verseDisplayFormat = "compact"; break;
                         case 2: userSettings.content.verseDisplayFormat = "detailed"; break;
                     }
+                    settingsChanged();
                 }
                 ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "How verses are formatted when displayed");
                 
@@ -1502,10 +1678,12 @@ void VerseFinderApp::renderSettingsWindow() {
                 
                 if (ImGui::Button("Clear All History")) {
                     userSettings.content.searchHistory.clear();
+                    settingsChanged();
                 }
                 ImGui::SameLine();
                 if (ImGui::Button("Clear Favorites")) {
                     userSettings.content.favoriteVerses.clear();
+                    settingsChanged();
                 }
                 
                 ImGui::EndTabItem();
@@ -1519,6 +1697,7 @@ void VerseFinderApp::renderSettingsWindow() {
                 bool presentation_enabled = userSettings.presentation.enabled;
                 if (ImGui::Checkbox("Enable Presentation Mode", &presentation_enabled)) {
                     userSettings.presentation.enabled = presentation_enabled;
+                    settingsChanged();
                 }
                 
                 if (userSettings.presentation.enabled) {
@@ -1535,6 +1714,7 @@ void VerseFinderApp::renderSettingsWindow() {
                         
                         if (ImGui::Combo("Target Monitor", &userSettings.presentation.monitorIndex, 
                                        monitor_names.data(), static_cast<int>(monitor_names.size()))) {
+                            settingsChanged();
                             if (presentation_mode_active) {
                                 updatePresentationMonitorPosition();
                             }
@@ -1545,6 +1725,7 @@ void VerseFinderApp::renderSettingsWindow() {
                     bool fullscreen = userSettings.presentation.fullscreen;
                     if (ImGui::Checkbox("Fullscreen Mode", &fullscreen)) {
                         userSettings.presentation.fullscreen = fullscreen;
+                        settingsChanged();
                         if (presentation_mode_active) {
                             updatePresentationMonitorPosition();
                         }
@@ -1557,9 +1738,11 @@ void VerseFinderApp::renderSettingsWindow() {
                         
                         if (ImGui::InputInt("Window Width", &width)) {
                             userSettings.presentation.windowWidth = std::max(640, width);
+                            settingsChanged();
                         }
                         if (ImGui::InputInt("Window Height", &height)) {
                             userSettings.presentation.windowHeight = std::max(480, height);
+                            settingsChanged();
                         }
                     }
                     
@@ -1571,6 +1754,7 @@ void VerseFinderApp::renderSettingsWindow() {
                     float fontSize = userSettings.presentation.fontSize;
                     if (ImGui::SliderFloat("Font Size", &fontSize, 24.0f, 120.0f, "%.0f")) {
                         userSettings.presentation.fontSize = fontSize;
+                        settingsChanged();
                     }
                     
                     // Text alignment
@@ -1581,18 +1765,21 @@ void VerseFinderApp::renderSettingsWindow() {
                     
                     if (ImGui::Combo("Text Alignment", &current_alignment, alignments, 3)) {
                         userSettings.presentation.textAlignment = alignments[current_alignment];
+                        settingsChanged();
                     }
                     
                     // Text padding
                     float padding = userSettings.presentation.textPadding;
                     if (ImGui::SliderFloat("Text Padding", &padding, 10.0f, 100.0f, "%.0f")) {
                         userSettings.presentation.textPadding = padding;
+                        settingsChanged();
                     }
                     
                     // Show reference option
                     bool showReference = userSettings.presentation.showReference;
                     if (ImGui::Checkbox("Show Bible Reference", &showReference)) {
                         userSettings.presentation.showReference = showReference;
+                        settingsChanged();
                     }
                     
                     ImGui::Separator();
@@ -1615,6 +1802,7 @@ void VerseFinderApp::renderSettingsWindow() {
                                (int)(bg_color.y * 255), 
                                (int)(bg_color.z * 255));
                         userSettings.presentation.backgroundColor = std::string(hex);
+                        settingsChanged();
                     }
                     
                     // Text color
@@ -1633,6 +1821,7 @@ void VerseFinderApp::renderSettingsWindow() {
                                (int)(text_color.y * 255), 
                                (int)(text_color.z * 255));
                         userSettings.presentation.textColor = std::string(hex);
+                        settingsChanged();
                     }
                     
                     // Reference color
@@ -1651,6 +1840,7 @@ void VerseFinderApp::renderSettingsWindow() {
                                (int)(ref_color.y * 255), 
                                (int)(ref_color.z * 255));
                         userSettings.presentation.referenceColor = std::string(hex);
+                        settingsChanged();
                     }
                     
                     ImGui::Separator();
@@ -1661,6 +1851,7 @@ void VerseFinderApp::renderSettingsWindow() {
                     bool obsOptimized = userSettings.presentation.obsOptimized;
                     if (ImGui::Checkbox("OBS Studio Optimization", &obsOptimized)) {
                         userSettings.presentation.obsOptimized = obsOptimized;
+                        settingsChanged();
                     }
                     ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "Optimizes window for OBS capture");
                     
@@ -1668,12 +1859,14 @@ void VerseFinderApp::renderSettingsWindow() {
                     bool autoHideCursor = userSettings.presentation.autoHideCursor;
                     if (ImGui::Checkbox("Auto-hide Cursor", &autoHideCursor)) {
                         userSettings.presentation.autoHideCursor = autoHideCursor;
+                        settingsChanged();
                     }
                     
                     // Fade transition time
                     float fadeTime = userSettings.presentation.fadeTransitionTime;
                     if (ImGui::SliderFloat("Fade Transition Time", &fadeTime, 0.0f, 2.0f, "%.1fs")) {
                         userSettings.presentation.fadeTransitionTime = fadeTime;
+                        settingsChanged();
                     }
                     
                     // Window title for OBS
@@ -1683,6 +1876,7 @@ void VerseFinderApp::renderSettingsWindow() {
                     
                     if (ImGui::InputText("Window Title", title, sizeof(title))) {
                         userSettings.presentation.windowTitle = std::string(title);
+                        settingsChanged();
                     }
                     ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "Title shown in OBS window capture list");
                 }
@@ -1738,6 +1932,7 @@ void VerseFinderApp::renderSettingsWindow() {
                 // Apply imported settings immediately
                 fuzzy_search_enabled = userSettings.search.fuzzySearchEnabled;
                 bible.enableFuzzySearch(fuzzy_search_enabled);
+                bible.setBookAliases(userSettings.content.customBookAliases);
                 auto_search = userSettings.search.autoSearch;
                 show_performance_stats = userSettings.search.showPerformanceStats;
                 theme_manager->setupImGuiStyle(userSettings.display.colorTheme, userSettings.display.fontSize / 16.0f); // Apply theme changes
@@ -1753,6 +1948,7 @@ void VerseFinderApp::renderSettingsWindow() {
             // Apply reset settings immediately
             fuzzy_search_enabled = userSettings.search.fuzzySearchEnabled;
             bible.enableFuzzySearch(fuzzy_search_enabled);
+            bible.setBookAliases(userSettings.content.customBookAliases);
             auto_search = userSettings.search.autoSearch;
             show_performance_stats = userSettings.search.showPerformanceStats;
             theme_manager->setupImGuiStyle(userSettings.display.colorTheme, userSettings.display.fontSize / 16.0f); // Apply theme changes
@@ -1797,6 +1993,7 @@ void VerseFinderApp::renderAboutWindow() {
 }
 
 void VerseFinderApp::renderPluginManagerWindow() {
+    TRACE_SCOPE("ui.plugin_manager");
     if (!plugin_manager) {
         show_plugin_manager_window = false;
         return;
@@ -1947,6 +2144,56 @@ void VerseFinderApp::renderPerformanceWindow() {
     ImGui::End();
 }
 
+void VerseFinderApp::renderExplainWindow() {
+    ImGui::SetNextWindowSize(ImVec2(520, 480), ImGuiCond_FirstUseEver);
+    
+    if (ImGui::Begin("🔍 Query Explain", &show_explain_window)) {
+        if (!last_explanation) {
+            ImGui::TextWrapped("Search with this panel open to see how the search ran.");
+            ImGui::End();
+            return;
+        }
+        const QueryIntent& intent = last_explanation->intent;
+        const QueryProfile& profile = last_explanation->profile;
+        
+        ImGui::Text("Query: %s", intent.originalQuery.c_str());
+        ImGui::Text("Intent: %s (%.0f%% confidence)", QueryIntent::typeName(intent.type), intent.confidence * 100.0);
+        if (!intent.keywords.empty()) {
+            std::string keywords;
+            for (const auto& keyword : intent.keywords) keywords += (keywords.empty() ? "" : ", ") + keyword;
+            ImGui::TextWrapped("Keywords: %s", keywords.c_str());
+        }
+        if (!intent.topics.empty()) {
+            std::string topics;
+            for (const auto& topic : intent.topics) topics += (topics.empty() ? "" : ", ") + topic;
+            ImGui::TextWrapped("Topics: %s", topics.c_str());
+        }
+        
+        ImGui::Spacing();
+        ImGui::Text("Plan");
+        ImGui::Separator();
+        std::string plan;
+        for (const char* step : profile.plan()) plan += (plan.empty() ? "" : " -> ") + std::string(step);
+        ImGui::TextWrapped("%s", plan.empty() ? "(no index work: cached or rejected)" : plan.c_str());
+        ImGui::Text("Cache: %zu hit(s), %zu miss(es)", profile.cacheHits(), profile.cacheMisses());
+        for (const auto& [name, value] : profile.counts()) {
+            ImGui::BulletText("%s: %zu", name, value);
+        }
+        
+        ImGui::Spacing();
+        ImGui::Text("Stages");
+        ImGui::Separator();
+        for (const QueryProfile::Stage& stage : profile.timings()) {
+            ImGui::Text("%*s%s  %.3f ms", static_cast<int>(stage.depth * 2), "", stage.name, stage.duration_ms);
+        }
+        if (profile.droppedStages() > 0) {
+            ImGui::TextDisabled("... and %zu more", profile.droppedStages());
+        }
+        ImGui::Text("Total: %.2f ms", last_explanation->elapsed_ms);
+    }
+    ImGui::End();
+}
+
 void VerseFinderApp::handleKeyboardShortcuts() {
     ImGuiIO& io = ImGui::GetIO();
     
@@ -2015,134 +2262,262 @@ void VerseFinderApp::handleKeyboardShortcuts() {
 }
 
 void VerseFinderApp::performSearch() {
+    cancelSearches();
     if (!bible.isReady() || strlen(search_input) == 0) {
         search_results.clear();
+        search_highlights.clear();
         selected_result_index = -1;
         selected_verse_text.clear();
         last_search_time_ms = 0.0;
         return;
     }
     
-    std::string query = search_input;
+    // Only the results that will be shown are ranked; fewer when shedding load
+    size_t result_limit = std::min(static_cast<size_t>(userSettings.search.maxSearchResults),
+                                   bible.getDegradationProfile().max_results);
+    SearchContext context;
+    context.setMaxResults(result_limit);
+    context.setCancelToken(search_cancel);
+    
+    auto outcome = std::make_unique<SearchOutcome>();
+    outcome->generation = search_generation;
+    outcome->query = search_input;
+    outcome->translation = current_translation.name;
+    outcome->all_translations = search_all_translations;
+    outcome->plugins = plugin_manager.get();
+    bool semantic = bible.isSemanticSearchEnabled();
+    bool fuzzy = fuzzy_search_enabled;
+    if (show_explain_window) {
+        outcome->explanation = std::make_shared<SearchExplanation>();
+    }
+    
+    // The frame keeps drawing the previous results, with a spinner, until this one lands
+    search_in_progress = true;
+    ++searches_running;
+    TaskScheduler::shared().post([this, outcome = outcome.release(), result_limit, semantic, fuzzy, context]() {
+        std::unique_ptr<SearchOutcome> finished(outcome);
+        try {
+            executeSearch(*finished, result_limit, semantic, fuzzy, context);
+        } catch (const std::exception& e) {
+            std::cerr << "Search for \"" << finished->query << "\" failed: " << e.what() << std::endl;
+            finished->results.clear();
+        }
+        if (!context.interrupted()) {
+            delete search_mailbox.exchange(finished.release(), std::memory_order_acq_rel);
+            FrameScheduler::shared().requestRedraw();
+        }
+        --searches_running;
+    }, TaskPriority::INTERACTIVE);
+    
+    // Likely completions of a partial query are searched ahead, so accepting one is a cache hit
+    bible.speculate(search_input, current_translation.name);
+}
+
+void VerseFinderApp::executeSearch(SearchOutcome& outcome, size_t result_limit, bool semantic, bool fuzzy,
+                                   const SearchContext& context) {
+    const std::string& query = outcome.query;
+    const std::string& translation = outcome.translation;
+    
+    // The API may load or evict translations meanwhile; this one stays for the search
+    VerseFinder::TranslationLease lease = bible.acquireTranslation(translation);
     
     // Benchmark the search operation
     auto start_time = std::chrono::steady_clock::now();
     
-    // Determine search type based on query format
-    bool is_reference_format = false;
+    // With the explain panel open, every stage of the search below is recorded
+    std::optional<QueryProfile::Scope> profiling;
+    if (outcome.explanation) {
+        outcome.explanation->intent = bible.parseNaturalLanguage(query);
+        profiling.emplace(outcome.explanation->profile);
+    }
     
-    // Check if query looks like a reference (contains numbers and potentially colons)
-    std::regex reference_pattern(R"(^[a-zA-Z0-9\s]+\s+\d+(:?\d+)?$)");
-    if (std::regex_match(query, reference_pattern)) {
-        is_reference_format = true;
+    // A book followed by chapter and verse numbers is a reference
+    ParsedReference parsed_reference;
+    bool is_reference_format = ReferenceParser::parse(query, parsed_reference) && parsed_reference.hasChapter();
+    outcome.query_type = is_reference_format ? "reference" : (semantic ? "semantic" : "keyword");
+    
+    // Search plugins run alongside the core search and are merged in after it
+    PluginSystem::PluginSearchBatch plugin_searches;
+    if (outcome.plugins && !is_reference_format) {
+        plugin_searches = outcome.plugins->startPluginSearches(query, translation);
     }
     
+    std::vector<std::string>& results = outcome.results;
     if (is_reference_format) {
         // Try exact verse reference first
-        std::string ref_result = bible.searchByReference(query, current_translation.name);
+        std::string ref_result = bible.searchByReference(query, translation);
         if (ref_result != "Verse not found." && ref_result != "Bible is loading...") {
-            search_results = {query + ": " + ref_result};
-            is_viewing_chapter = false;
+            results = {query + ": " + ref_result};
         } else {
             // Try chapter search (e.g., "Hebrews 12")
-            search_results = bible.searchByChapter(query, current_translation.name);
+            results = bible.searchByChapter(query, translation);
             
             // Check if this is a chapter search
-            std::string book;
-            int chapter, verse;
-            if (bible.parseReference(query, book, chapter, verse) && chapter != -1 && verse == -1) {
-                is_viewing_chapter = true;
-                current_chapter_book = bible.normalizeBookName(book);
-                current_chapter_number = chapter;
-            } else {
-                is_viewing_chapter = false;
+            if (parsed_reference.first().wholeChapters()) {
+                outcome.is_viewing_chapter = true;
+                outcome.chapter_book = bible.normalizeBookName(parsed_reference.book);
+                outcome.chapter_number = parsed_reference.first().chapter;
             }
         }
-    } else {
-        // Use intelligent search strategy based on query type
-        if (bible.isSemanticSearchEnabled()) {
-            // Parse the query to determine search strategy
-            QueryIntent intent = bible.parseNaturalLanguage(query);
-            
-            switch (intent.type) {
-                case QueryIntent::BOOLEAN_SEARCH:
-                    search_results = bible.searchBoolean(query, current_translation.name);
-                    break;
-                    
-                case QueryIntent::QUESTION_BASED:
-                    search_results = bible.answerQuestion(query, current_translation.name);
-                    break;
-                    
-                case QueryIntent::TOPICAL_SEARCH:
-                    if (!intent.topics.empty()) {
-                        search_results = bible.searchByTopic(intent.topics[0], current_translation.name);
-                    } else {
-                        search_results = bible.searchSemantic(query, current_translation.name);
-                    }
-                    break;
-                    
-                case QueryIntent::CONTEXTUAL_REQUEST:
-                case QueryIntent::SEMANTIC_SEARCH:
-                    search_results = bible.searchSemantic(query, current_translation.name);
-                    break;
-                    
-                default:
-                    // Fall back to keyword search with fuzzy matching if enabled
-                    if (fuzzy_search_enabled) {
-                        search_results = bible.searchByKeywordsFuzzy(query, current_translation.name);
-                    } else {
-                        search_results = bible.searchByKeywords(query, current_translation.name);
-                    }
-                    break;
-            }
-            
-            // Generate intelligent suggestions
-            auto topical_suggestions = bible.getTopicalSuggestions(query);
-            auto contextual_suggestions = bible.getContextualSuggestions(query);
-            
-            query_suggestions.clear();
-            query_suggestions.insert(query_suggestions.end(), topical_suggestions.begin(), topical_suggestions.end());
-            query_suggestions.insert(query_suggestions.end(), contextual_suggestions.begin(), contextual_suggestions.end());
-            
-            if (fuzzy_search_enabled) {
-                auto fuzzy_suggestions = bible.generateQuerySuggestions(query, current_translation.name);
-                query_suggestions.insert(query_suggestions.end(), fuzzy_suggestions.begin(), fuzzy_suggestions.end());
-                book_suggestions = bible.findBookNameSuggestions(query);
-            }
-        } else {
-            // Use traditional keyword search (with fuzzy search if enabled)
-            if (fuzzy_search_enabled) {
-                search_results = bible.searchByKeywordsFuzzy(query, current_translation.name);
+    } else if (semantic) {
+        // Parse the query to determine search strategy
+        QueryIntent intent = bible.parseNaturalLanguage(query);
+        
+        switch (intent.type) {
+            case QueryIntent::BOOLEAN_SEARCH:
+                results = bible.searchBoolean(query, translation, context);
+                break;
                 
-                // Generate suggestions for the current query
-                query_suggestions = bible.generateQuerySuggestions(query, current_translation.name);
-                book_suggestions = bible.findBookNameSuggestions(query);
-            } else {
-                search_results = bible.searchByKeywords(query, current_translation.name);
+            case QueryIntent::QUESTION_BASED:
+                results = bible.answerQuestion(query, translation, context);
+                break;
+                
+            case QueryIntent::TOPICAL_SEARCH:
+                if (!intent.topics.empty()) {
+                    results = bible.searchByTopic(intent.topics[0], translation, context);
+                } else {
+                    results = bible.searchSemantic(query, translation, context);
+                }
+                break;
+                
+            case QueryIntent::CONTEXTUAL_REQUEST:
+            case QueryIntent::SEMANTIC_SEARCH:
+                results = bible.searchSemantic(query, translation, context);
+                break;
+                
+            default:
+                // Fall back to keyword search with fuzzy matching if enabled
+                if (fuzzy) {
+                    results = bible.searchByKeywordsFuzzy(query, translation, context);
+                } else {
+                    searchKeywords(outcome, context);
+                }
+                break;
+        }
+        
+        // Generate intelligent suggestions
+        auto topical_suggestions = bible.getTopicalSuggestions(query);
+        auto contextual_suggestions = bible.getContextualSuggestions(query);
+        
+        outcome.has_suggestions = true;
+        outcome.query_suggestions.insert(outcome.query_suggestions.end(), topical_suggestions.begin(), topical_suggestions.end());
+        outcome.query_suggestions.insert(outcome.query_suggestions.end(), contextual_suggestions.begin(), contextual_suggestions.end());
+        
+        if (fuzzy) {
+            auto fuzzy_suggestions = bible.generateQuerySuggestions(query, translation);
+            outcome.query_suggestions.insert(outcome.query_suggestions.end(), fuzzy_suggestions.begin(), fuzzy_suggestions.end());
+            outcome.has_book_suggestions = true;
+            outcome.book_suggestions = bible.findBookNameSuggestions(query);
+        }
+    } else if (fuzzy) {
+        // Traditional keyword search with fuzzy matching
+        results = bible.searchByKeywordsFuzzy(query, translation, context);
+        
+        // Generate suggestions for the current query
+        outcome.has_suggestions = true;
+        outcome.query_suggestions = bible.generateQuerySuggestions(query, translation);
+        outcome.has_book_suggestions = true;
+        outcome.book_suggestions = bible.findBookNameSuggestions(query);
+    } else {
+        searchKeywords(outcome, context);
+    }
+    
+    if (outcome.plugins && !plugin_searches.calls.empty()) {
+        // Plugin results interleave with the core ones; carry the highlights along by result
+        std::unordered_map<std::string, std::vector<MatchSpan>> highlights;
+        for (size_t i = 0; i < outcome.highlights.size(); ++i) {
+            highlights.emplace(results[i], std::move(outcome.highlights[i]));
+        }
+        results = outcome.plugins->mergePluginSearches(plugin_searches, std::move(results));
+        outcome.highlights.clear();
+        if (!highlights.empty()) {
+            for (const auto& result : results) {
+                auto it = highlights.find(result);
+                outcome.highlights.push_back(it != highlights.end() ? std::move(it->second) : std::vector<MatchSpan>());
             }
         }
-        is_viewing_chapter = false;
     }
     
     auto end_time = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
-    last_search_time_ms = duration.count() / 1000.0;
+    outcome.elapsed_ms = duration.count() / 1000.0;
+    if (outcome.explanation) {
+        outcome.explanation->elapsed_ms = outcome.elapsed_ms;
+    }
     
     // Apply search result limit
-    if (search_results.size() > static_cast<size_t>(userSettings.search.maxSearchResults)) {
-        search_results.resize(userSettings.search.maxSearchResults);
+    if (results.size() > result_limit) {
+        results.resize(result_limit);
+    }
+    if (outcome.highlights.size() > result_limit) {
+        outcome.highlights.resize(result_limit);
+    }
+}
+
+void VerseFinderApp::searchKeywords(SearchOutcome& outcome, const SearchContext& context) {
+    if (outcome.all_translations) {
+        // "Ref [KJV, ASV]: text" from the translation that ranked it highest, whose matched words are the spans
+        for (const VerseFinder::AlignedMatch& match : bible.searchAllTranslationIds(outcome.query, context)) {
+            std::string result = bible.formatAlignedMatch(match);
+            if (result.empty()) continue;
+            outcome.results.push_back(std::move(result));
+            outcome.highlights.push_back(match.spans);
+        }
+        if (outcome.results.empty()) outcome.results = {"No matching verses found."};
+        return;
+    }
+    CachedSearchResult matches = bible.searchKeywordIds(outcome.query, outcome.translation, context);
+    const VerseStore* store = bible.getVerseStore(outcome.translation);
+    if (matches.ids.empty() || !store) {
+        outcome.results = {matches.message.empty() ? "No matching verses found." : matches.message};
+        return;
+    }
+    outcome.results.reserve(matches.ids.size());
+    outcome.highlights.reserve(matches.ids.size());
+    for (size_t i = 0; i < matches.ids.size(); ++i) {
+        std::span<const MatchSpan> spans = matches.spansOf(i);
+        outcome.results.push_back(store->formatResult(matches.ids[i]));
+        outcome.highlights.emplace_back(spans.begin(), spans.end());
+    }
+}
+
+void VerseFinderApp::drainSearchMailbox() {
+    std::unique_ptr<SearchOutcome> outcome(search_mailbox.exchange(nullptr, std::memory_order_acq_rel));
+    if (!outcome || outcome->generation != search_generation) {
+        return;
+    }
+    search_in_progress = false;
+    
+    search_results = std::move(outcome->results);
+    search_highlights = std::move(outcome->highlights);
+    for (const auto& result : search_results) {
+        glyph_cache.noteText(result);
+    }
+    is_viewing_chapter = outcome->is_viewing_chapter;
+    if (is_viewing_chapter) {
+        current_chapter_book = outcome->chapter_book;
+        current_chapter_number = outcome->chapter_number;
+    }
+    if (outcome->has_suggestions) {
+        query_suggestions = std::move(outcome->query_suggestions);
+        if (outcome->has_book_suggestions) {
+            book_suggestions = std::move(outcome->book_suggestions);
+        }
+    }
+    last_search_time_ms = outcome->elapsed_ms;
+    if (outcome->explanation) {
+        last_explanation = std::move(outcome->explanation);
     }
     
     // Add to search history if enabled and results found
     if (!search_results.empty() && userSettings.content.saveSearchHistory) {
-        userSettings.addToSearchHistory(query);
+        userSettings.addToSearchHistory(outcome->query);
+        settingsChanged();
     }
     
     // Record search analytics if enabled
     if (bible.areAnalyticsEnabled()) {
-        std::string queryType = is_reference_format ? "reference" : 
-                               (bible.isSemanticSearchEnabled() ? "semantic" : "keyword");
-        bible.recordSearch(query, queryType, search_results.size(), last_search_time_ms);
+        bible.recordSearch(outcome->query, outcome->query_type, search_results.size(), last_search_time_ms);
     }
     
     selected_result_index = search_results.empty() ? -1 : 0;
@@ -2153,9 +2528,21 @@ void VerseFinderApp::performSearch() {
     }
 }
 
+void VerseFinderApp::cancelSearches() {
+    // Superseded searches stop at their next poll and publish nothing
+    if (search_cancel) {
+        search_cancel->store(true, std::memory_order_relaxed);
+    }
+    search_cancel = SearchContext::makeCancelToken();
+    ++search_generation;
+    search_in_progress = false;
+}
+
 void VerseFinderApp::clearSearch() {
+    cancelSearches();
     memset(search_input, 0, sizeof(search_input));
     search_results.clear();
+    search_highlights.clear();
     selected_result_index = -1;
     selected_verse_text.clear();
     last_search_query.clear();
@@ -2214,6 +2601,7 @@ void VerseFinderApp::navigateToVerse(int direction) {
     }
     
     // Use the improved navigation method from VerseFinder
+    VerseFinder::TranslationLease lease = bible.acquireTranslation(current_translation.name);
     std::string result = bible.getAdjacentVerse(reference, current_translation.name, direction);
     
     if (!result.empty()) {
@@ -2222,6 +2610,7 @@ void VerseFinderApp::navigateToVerse(int direction) {
         
         // Update search results to maintain UI consistency
         search_results = {result};
+        search_highlights.clear();
         selected_result_index = 0;
         
         // Extract just the reference for the search input display
@@ -2248,11 +2637,13 @@ void VerseFinderApp::jumpToVerse(const std::string& book, int chapter, int verse
     std::string reference = book + " " + std::to_string(chapter) + ":" + std::to_string(verse);
     
     // Search for this specific verse
+    VerseFinder::TranslationLease lease = bible.acquireTranslation(current_translation.name);
     std::string result = bible.searchByReference(reference, current_translation.name);
     
     if (result != "Verse not found." && result != "Bible is loading...") {
         // Clear current search and show just this verse
         search_results = {reference + ": " + result};
+        search_highlights.clear();
         selected_result_index = 0;
         selected_verse_text = search_results[0];
         is_viewing_chapter = false;
@@ -2264,111 +2655,101 @@ void VerseFinderApp::jumpToVerse(const std::string& book, int chapter, int verse
 }
 
 void VerseFinderApp::downloadTranslation(const std::string& url, const std::string& name) {
-    // Mark as downloading
+    setDownloadProgress(name, 0.0f, true);
+    
+    if (!translation_client) {
+        translation_client = std::make_unique<HttpClient>("translations", 2);
+        translation_client->setTimeout(60);
+    }
+    // Forget downloads that have finished, then start this one; it holds no thread while it waits
+    std::erase_if(translation_downloads, [](const std::future<void>& download) {
+        return download.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    });
+    translation_downloads.push_back(spawn(fetchTranslation(url, name), TaskPriority::INTERACTIVE));
+}
+
+void VerseFinderApp::setDownloadProgress(const std::string& name, float progress, bool downloading, bool downloaded) {
     for (auto& trans : available_translations) {
         if (trans.name == name) {
-            trans.is_downloading = true;
-            trans.download_progress = 0.0f;
+            trans.is_downloading = downloading;
+            trans.download_progress = progress;
+            if (downloaded) trans.is_downloaded = true;
             break;
         }
     }
-    
-    // Simulate download in a separate thread
-    std::thread([this, url, name]() {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        
-        // Update progress
-        for (float progress = 0.0f; progress <= 1.0f; progress += 0.1f) {
-            for (auto& trans : available_translations) {
-                if (trans.name == name) {
-                    trans.download_progress = progress;
-                    break;
-                }
+}
+
+Task<void> VerseFinderApp::fetchTranslation(std::string url, std::string name) {
+    try {
+        // Get the correct filename based on URL and translation name
+        std::string filename = extractFilenameFromUrl(url, name);
+        
+        // Try to find existing translation file in common locations first
+        std::vector<std::string> search_paths = {
+            PlatformUtils::getExecutablePath() + "/translations/" + filename,
+            PlatformUtils::getExecutablePath() + "/" + filename,
+            PlatformUtils::getExecutablePath() + "/data/" + filename,
+            "./translations/" + filename,
+            "./" + filename
+        };
+        
+        std::string translation_content;
+        bool found_existing = false;
+        
+        for (const auto& path : search_paths) {
+            std::ifstream file(path);
+            if (file.is_open()) {
+                std::stringstream buffer;
+                buffer << file.rdbuf();
+                translation_content = buffer.str();
+                found_existing = true;
+                std::cout << "Found existing translation at: " << path << std::endl;
+                break;
             }
-            std::this_thread::sleep_for(std::chrono::milliseconds(200));
         }
         
-        try {
-            // Get the correct filename based on URL and translation name
-            std::string filename = extractFilenameFromUrl(url, name);
-            
-            // Try to find existing translation file in common locations first
-            std::vector<std::string> search_paths = {
-                PlatformUtils::getExecutablePath() + "/translations/" + filename,
-                PlatformUtils::getExecutablePath() + "/" + filename,
-                PlatformUtils::getExecutablePath() + "/data/" + filename,
-                "./translations/" + filename,
-                "./" + filename
-            };
-            
-            std::string translation_content;
-            bool found_existing = false;
-            
-            for (const auto& path : search_paths) {
-                std::ifstream file(path);
-                if (file.is_open()) {
-                    std::stringstream buffer;
-                    buffer << file.rdbuf();
-                    translation_content = buffer.str();
-                    found_existing = true;
-                    std::cout << "Found existing translation at: " << path << std::endl;
-                    break;
-                }
-            }
-            
-            if (!found_existing) {
-                // Download from the provided URL
-                std::cout << "Downloading translation from: " << url << std::endl;
-                translation_content = downloadFromUrl(url);
-                
-                if (translation_content.empty()) {
-                    throw std::runtime_error("Failed to download translation from URL: " + url);
-                }
-                
-                std::cout << "Successfully downloaded " << name << " (" << translation_content.length() << " bytes)" << std::endl;
-            }
-            
-            // Validate JSON format
-            try {
-                json test_parse = json::parse(translation_content);
-                if (!test_parse.contains("translation") || !test_parse.contains("books")) {
-                    throw std::runtime_error("Invalid Bible JSON format");
-                }
-            } catch (const json::exception& e) {
-                throw std::runtime_error("Failed to parse translation JSON: " + std::string(e.what()));
+        if (!found_existing) {
+            // Download from the provided URL
+            std::cout << "Downloading translation from: " << url << std::endl;
+            setDownloadProgress(name, 0.1f, true);
+            HttpClient::Request request;
+            request.url = url;
+            HttpClient::Response response = co_await translation_client->fetch(std::move(request));
+            if (!response.ok()) {
+                throw std::runtime_error("Failed to download translation from URL: " + url + " (" +
+                                         (response.error.empty() ? "HTTP " + std::to_string(response.status) : response.error) + ")");
             }
+            translation_content = std::move(response.body);
             
-            // Save to translations directory and add to Bible
-            if (bible.saveTranslation(translation_content, filename)) {
-                bible.addTranslation(translation_content);
-                
-                // Mark as completed
-                for (auto& trans : available_translations) {
-                    if (trans.name == name) {
-                        trans.is_downloading = false;
-                        trans.is_downloaded = true;
-                        trans.download_progress = 1.0f;
-                        break;
-                    }
-                }
-                
-                updateAvailableTranslationStatus();
-                std::cout << "Successfully downloaded and saved: " << name << std::endl;
-            } else {
-                throw std::runtime_error("Failed to save translation file");
-            }
-        } catch (const std::exception& e) {
-            // Mark as failed
-            for (auto& trans : available_translations) {
-                if (trans.name == name) {
-                    trans.is_downloading = false;
-                    trans.download_progress = 0.0f;
-                    break;
-                }
+            std::cout << "Successfully downloaded " << name << " (" << translation_content.length() << " bytes)" << std::endl;
+        }
+        setDownloadProgress(name, 0.6f, true);
+        FrameScheduler::shared().requestRedraw();
+        
+        // Validate JSON format
+        try {
+            json test_parse = json::parse(translation_content);
+            if (!test_parse.contains("translation") || !test_parse.contains("books")) {
+                throw std::runtime_error("Invalid Bible JSON format");
             }
-            std::cerr << "Failed to download " << name << ": " << e.what() << std::endl;
+        } catch (const json::exception& e) {
+            throw std::runtime_error("Failed to parse translation JSON: " + std::string(e.what()));
+        }
+        
+        // Save to translations directory and add to Bible
+        if (bible.saveTranslation(translation_content, filename)) {
+            bible.addTranslation(translation_content);
+            setDownloadProgress(name, 1.0f, false, true);
+            updateAvailableTranslationStatus();
+            std::cout << "Successfully downloaded and saved: " << name << std::endl;
+        } else {
+            throw std::runtime_error("Failed to save translation file");
         }
-    }).detach();
+    } catch (const std::exception& e) {
+        setDownloadProgress(name, 0.0f, false);
+        std::cerr << "Failed to download " << name << ": " << e.what() << std::endl;
+    }
+    FrameScheduler::shared().requestRedraw();
 }
 
 void VerseFinderApp::updateAvailableTranslationStatus() {
@@ -2391,10 +2772,16 @@ void VerseFinderApp::switchToTranslation(const std::string& translation_name) {
     const auto& translations = bible.getTranslations();
     for (const auto& trans : translations) {
         if (trans.abbreviation == translation_name || trans.name == translation_name) {
+            // Listed translations are read in when first chosen
+            if (!bible.acquireTranslation(trans.name)) {
+                std::cerr << "Could not load translation " << trans.name << std::endl;
+                return;
+            }
             current_translation = trans;
             
             // Add to recent translations
             userSettings.addToRecentTranslations(trans.abbreviation);
+            settingsChanged();
             
             // Re-perform search with new translation
             if (strlen(search_input) > 0) {
@@ -2413,45 +2800,27 @@ bool VerseFinderApp::isTranslationAvailable(const std::string& name) const {
                       });
 }
 
+json VerseFinderApp::settingsSnapshot() const {
+    // Update window state in settings if remembering position
+    if (userSettings.display.rememberWindowState && window) {
+        int width, height, xpos, ypos;
+        glfwGetWindowSize(window, &width, &height);
+        glfwGetWindowPos(window, &xpos, &ypos);
+        
+        // Create a mutable copy to update window state
+        UserSettings mutableSettings = userSettings;
+        mutableSettings.display.windowWidth = width;
+        mutableSettings.display.windowHeight = height;
+        mutableSettings.display.windowPosX = xpos;
+        mutableSettings.display.windowPosY = ypos;
+        return mutableSettings.toJson();
+    }
+    return userSettings.toJson();
+}
+
 bool VerseFinderApp::saveSettings() const {
     try {
-        std::string settingsPath = PlatformUtils::getSettingsFilePath();
-        
-        // Update window state in settings if remembering position
-        if (userSettings.display.rememberWindowState && window) {
-            int width, height, xpos, ypos;
-            glfwGetWindowSize(window, &width, &height);
-            glfwGetWindowPos(window, &xpos, &ypos);
-            
-            // Create a mutable copy to update window state
-            UserSettings mutableSettings = userSettings;
-            mutableSettings.display.windowWidth = width;
-            mutableSettings.display.windowHeight = height;
-            mutableSettings.display.windowPosX = xpos;
-            mutableSettings.display.windowPosY = ypos;
-            
-            json settingsJson = mutableSettings.toJson();
-            std::ofstream file(settingsPath);
-            if (!file.is_open()) {
-                std::cerr << "Failed to open settings file for writing: " << settingsPath << std::endl;
-                return false;
-            }
-            
-            file << settingsJson.dump(4);
-            file.close();
-        } else {
-            json settingsJson = userSettings.toJson();
-            std::ofstream file(settingsPath);
-            if (!file.is_open()) {
-                std::cerr << "Failed to open settings file for writing: " << settingsPath << std::endl;
-                return false;
-            }
-            
-            file << settingsJson.dump(4);
-            file.close();
-        }
-        
-        std::cout << "Settings saved to: " << settingsPath << std::endl;
+        settings_file->save();
         return true;
     } catch (const std::exception& e) {
         std::cerr << "Failed to save settings: " << e.what() << std::endl;
@@ -2619,41 +2988,6 @@ void VerseFinderApp::scanForExistingTranslations() {
     }
 }
 
-std::string VerseFinderApp::downloadFromUrl(const std::string& url) const {
-    // Create a temporary file for the download
-    std::string temp_file = "/tmp/bible_download_" + std::to_string(std::time(nullptr)) + ".json";
-    
-    // Use curl to download the file with timeout and better error handling
-    std::string curl_command = "curl -s -L -f --connect-timeout 10 --max-time 30 \"" + url + "\" -o \"" + temp_file + "\"";
-    
-    std::cout << "Downloading from: " << url << std::endl;
-    
-    int result = system(curl_command.c_str());
-    if (result != 0) {
-        std::cerr << "Failed to download from URL: " << url << " (curl exit code: " << result << ")" << std::endl;
-        // Clean up temp file if it exists
-        std::remove(temp_file.c_str());
-        return "";
-    }
-    
-    // Read the downloaded file
-    std::ifstream file(temp_file);
-    if (!file.is_open()) {
-        std::cerr << "Failed to open downloaded file: " << temp_file << std::endl;
-        return "";
-    }
-    
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string content = buffer.str();
-    file.close();
-    
-    // Clean up temporary file
-    std::remove(temp_file.c_str());
-    
-    return content;
-}
-
 std::string VerseFinderApp::extractFilenameFromUrl(const std::string& url, const std::string& translation_name) const {
     // Map URL patterns to proper filenames
     std::unordered_map<std::string, std::string> url_to_filename = {
@@ -2750,161 +3084,254 @@ void VerseFinderApp::initPresentationWindow() {
         glfwSetInputMode(presentation_window, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
     }
     
+    // From here on the render thread owns the window's GL context
+    presentation_style_sent = presentationStyle();
+    presentation_renderer = std::make_unique<PresentationRenderer>();
+    presentation_renderer->start(presentation_window, ui_font_path, presentation_style_sent);
+    if (!current_displayed_verse.empty()) {
+        presentation_renderer->displayVerse(current_displayed_verse, current_displayed_reference);
+        prefetchPresentationSlides(current_displayed_reference);
+    }
+    presentation_renderer->setBlank(presentation_blank_screen);
+    // VERSEFINDER_PRESENTATION_OUTPUT shares the display's frames with other
+    // programs: comma-separated outputs, each name[:WIDTHxHEIGHT][:keyed][:lower-third],
+    // e.g. "stream:3840x2160,captions:1920x1080:keyed:lower-third"
+    if (const char* output_setting = std::getenv("VERSEFINDER_PRESENTATION_OUTPUT")) {
+        presentation_renderer->setOutputs(parsePresentationOutputs(output_setting));
+    }
+    
     std::cout << "Presentation window created successfully" << std::endl;
 }
 
 void VerseFinderApp::destroyPresentationWindow() {
     if (presentation_window) {
+        presentation_renderer.reset(); // Joins the render thread, releasing the context
         glfwDestroyWindow(presentation_window);
         presentation_window = nullptr;
         presentation_mode_active = false;
     }
 }
 
-void VerseFinderApp::renderPresentationWindow() {
-    if (!presentation_window) {
+void VerseFinderApp::syncPresentationStyle() {
+    if (!presentation_renderer) {
+        return;
+    }
+    PresentationRenderer::Style style = presentationStyle();
+    if (style != presentation_style_sent) {
+        presentation_style_sent = style;
+        presentation_renderer->setStyle(style);
+    }
+}
+
+void VerseFinderApp::prefetchPresentationSlides(const std::string& reference) {
+    if (!presentation_renderer || reference.empty()) {
+        return;
+    }
+    if (presentingFromBundle()) {
+        prefetchBundledSlides(reference);
+        return;
+    }
+    if (!bible.isReady()) {
         return;
     }
     
-    // Make presentation window context current
-    glfwMakeContextCurrent(presentation_window);
+    std::vector<PresentationRenderer::Slide> upcoming;
+    auto addSlide = [&](const std::string& result) {
+        if (!result.empty() && upcoming.size() < PresentationRenderer::MAX_PREFETCHED) {
+            upcoming.push_back({formatVerseText(result), formatVerseReference(result)});
+        }
+    };
+    
+    VerseFinder::TranslationLease lease = bible.acquireTranslation(current_translation.name);
     
-    int display_w, display_h;
-    glfwGetFramebufferSize(presentation_window, &display_w, &display_h);
-    glViewport(0, 0, display_w, display_h);
+    // The next scripture reading in the service plan, when this verse opens one
+    if (current_service_plan) {
+        const auto& items = current_service_plan->getItems();
+        auto is_scripture = [](const ServiceItem& item) { return item.type == ServiceItemType::SCRIPTURE; };
+        auto current = std::find_if(items.begin(), items.end(), [&](const ServiceItem& item) {
+            return is_scripture(item) && item.content == reference;
+        });
+        if (current != items.end()) {
+            auto next = std::find_if(std::next(current), items.end(), is_scripture);
+            VerseView verse = next != items.end() ? bible.findVerse(next->content, current_translation.name) : VerseView();
+            if (verse) {
+                upcoming.push_back({std::string(verse.text), next->content});
+            }
+        }
+    }
     
-    // Parse background color
-    float bg_r = 0.0f, bg_g = 0.0f, bg_b = 0.0f;
-    if (userSettings.presentation.backgroundColor.length() == 7 && userSettings.presentation.backgroundColor[0] == '#') {
-        std::string hex = userSettings.presentation.backgroundColor.substr(1);
-        bg_r = std::stoi(hex.substr(0, 2), 0, 16) / 255.0f;
-        bg_g = std::stoi(hex.substr(2, 2), 0, 16) / 255.0f;
-        bg_b = std::stoi(hex.substr(4, 2), 0, 16) / 255.0f;
+    // Then the following verses, which next/previous navigation steps through
+    std::string cursor = reference;
+    while (upcoming.size() + 1 < PresentationRenderer::MAX_PREFETCHED) {
+        std::string next = bible.getAdjacentVerse(cursor, current_translation.name, 1);
+        if (next.empty()) {
+            break;
+        }
+        addSlide(next);
+        cursor = formatVerseReference(next);
     }
+    addSlide(bible.getAdjacentVerse(reference, current_translation.name, -1));
     
-    glClearColor(bg_r, bg_g, bg_b, 1.0f);
-    glClear(GL_COLOR_BUFFER_BIT);
+    presentation_renderer->prefetch(std::move(upcoming));
+}
+
+void VerseFinderApp::prefetchBundledSlides(const std::string& reference) {
+    // reference is one of a bundled reading's slides: the rest of that
+    // reading, then the first slide of the next
+    std::vector<PresentationRenderer::Slide> upcoming;
+    for (const auto& item : service_bundle.getItems()) {
+        const ServiceBundle::Reading* reading = service_bundle.readingOf(item, current_translation.name);
+        if (!reading) {
+            continue;
+        }
+        auto slide = std::find_if(reading->slides.begin(), reading->slides.end(), [&](const ServiceBundle::Slide& s) {
+            return s.reference == reference;
+        });
+        if (slide == reading->slides.end()) {
+            continue;
+        }
+        for (++slide; slide != reading->slides.end() && upcoming.size() + 1 < PresentationRenderer::MAX_PREFETCHED; ++slide) {
+            upcoming.push_back({std::string(slide->text), std::string(slide->reference)});
+        }
+        const ServiceBundle::Item* next = service_bundle.nextReading(item.content);
+        if (const ServiceBundle::Reading* next_reading = next ? service_bundle.readingOf(*next, current_translation.name) : nullptr) {
+            const ServiceBundle::Slide& first = next_reading->slides.front();
+            upcoming.push_back({std::string(first.text), std::string(first.reference)});
+        }
+        break;
+    }
     
-    // Start ImGui frame for presentation window
-    ImGui_ImplOpenGL3_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
-    ImGui::NewFrame();
+    if (!upcoming.empty()) {
+        presentation_renderer->prefetch(std::move(upcoming));
+    }
+}
+
+bool VerseFinderApp::presentingFromBundle() const {
+    if (!service_bundle.isLoaded()) {
+        return false;
+    }
+    if (!bible.isReady()) {
+        return true;
+    }
+    if (startup.isDone("reliability")) {
+        if (EmergencyModeHandler* emergency = ReliabilityManager::getInstance().getEmergencyMode()) {
+            return emergency->isActive();
+        }
+    }
+    return false;
+}
+
+void VerseFinderApp::presentServiceItem(const ServiceItem& item) {
+    if (item.type != ServiceItemType::SCRIPTURE || item.content.empty()) {
+        return;
+    }
+    const std::string& translation = item.translation.empty() ? current_translation.name : item.translation;
     
-    // Create fullscreen invisible window for rendering
-    ImGuiWindowFlags flags = ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | 
-                           ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoScrollbar |
-                           ImGuiWindowFlags_NoScrollWithMouse | ImGuiWindowFlags_NoCollapse |
-                           ImGuiWindowFlags_NoBackground | ImGuiWindowFlags_NoBringToFrontOnFocus |
-                           ImGuiWindowFlags_NoNavFocus | ImGuiWindowFlags_NoDecoration;
+    if (!presentingFromBundle() && bible.isReady()) {
+        VerseFinder::TranslationLease lease = bible.acquireTranslation(translation);
+        VerseView verse = bible.findVerse(item.content, translation);
+        if (verse) {
+            displayVerseOnPresentation(std::string(verse.text), std::string(verse.book) + " " +
+                                       std::to_string(verse.chapter) + ":" + std::to_string(verse.verse));
+            return;
+        }
+    }
     
-    ImGui::SetNextWindowPos(ImVec2(0, 0));
-    ImGui::SetNextWindowSize(ImVec2(display_w, display_h));
+    // The translation is missing or not to be relied on; the bundle may have the reading
+    if (const ServiceBundle::Reading* reading = service_bundle.findReading(item.content, translation)) {
+        const ServiceBundle::Slide& first = reading->slides.front();
+        displayVerseOnPresentation(std::string(first.text), std::string(first.reference));
+    }
+}
+
+void VerseFinderApp::buildServiceBundle() {
+    if (!current_service_plan || !bible.isReady() || bundle_building.exchange(true)) {
+        return;
+    }
     
-    if (ImGui::Begin("PresentationDisplay", nullptr, flags)) {
-        if (!presentation_blank_screen && !current_displayed_verse.empty()) {
-            // Parse text color
-            float text_r = 1.0f, text_g = 1.0f, text_b = 1.0f;
-            if (userSettings.presentation.textColor.length() == 7 && userSettings.presentation.textColor[0] == '#') {
-                std::string hex = userSettings.presentation.textColor.substr(1);
-                text_r = std::stoi(hex.substr(0, 2), 0, 16) / 255.0f;
-                text_g = std::stoi(hex.substr(2, 2), 0, 16) / 255.0f;
-                text_b = std::stoi(hex.substr(4, 2), 0, 16) / 255.0f;
-            }
-            
-            // Parse reference color
-            float ref_r = 0.8f, ref_g = 0.8f, ref_b = 0.8f;
-            if (userSettings.presentation.referenceColor.length() == 7 && userSettings.presentation.referenceColor[0] == '#') {
-                std::string hex = userSettings.presentation.referenceColor.substr(1);
-                ref_r = std::stoi(hex.substr(0, 2), 0, 16) / 255.0f;
-                ref_g = std::stoi(hex.substr(2, 2), 0, 16) / 255.0f;
-                ref_b = std::stoi(hex.substr(4, 2), 0, 16) / 255.0f;
-            }
-            
-            ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(userSettings.presentation.textPadding, userSettings.presentation.textPadding));
-            
-            // Calculate text area
-            float available_width = display_w - (2 * userSettings.presentation.textPadding);
-            float available_height = display_h - (2 * userSettings.presentation.textPadding);
-            
-            ImGui::PushFont(ImGui::GetIO().Fonts->Fonts[0]); // Use default font, we'll scale it
-            
-            // Set large font size for presentation
-            float font_scale = userSettings.presentation.fontSize / ImGui::GetFontSize();
-            ImGui::SetWindowFontScale(font_scale);
-            
-            // Calculate text size and position for centering
-            ImVec2 verse_size = ImGui::CalcTextSize(current_displayed_verse.c_str(), nullptr, false, available_width);
-            ImVec2 ref_size = ImVec2(0, 0);
-            if (userSettings.presentation.showReference && !current_displayed_reference.empty()) {
-                ref_size = ImGui::CalcTextSize(current_displayed_reference.c_str());
-            }
-            
-            float total_height = verse_size.y;
-            if (userSettings.presentation.showReference) {
-                total_height += ref_size.y + 20; // Add spacing
-            }
-            
-            float start_y = (available_height - total_height) / 2;
-            if (start_y < 0) start_y = 0;
-            
-            ImGui::SetCursorPos(ImVec2(userSettings.presentation.textPadding, userSettings.presentation.textPadding + start_y));
-            
-            // Display verse text
-            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(text_r, text_g, text_b, presentation_fade_alpha));
-            
-            if (userSettings.presentation.textAlignment == "center") {
-                float text_width = ImGui::CalcTextSize(current_displayed_verse.c_str(), nullptr, false, available_width).x;
-                if (text_width < available_width) {
-                    ImGui::SetCursorPosX(userSettings.presentation.textPadding + (available_width - text_width) / 2);
-                }
-            } else if (userSettings.presentation.textAlignment == "right") {
-                float text_width = ImGui::CalcTextSize(current_displayed_verse.c_str(), nullptr, false, available_width).x;
-                if (text_width < available_width) {
-                    ImGui::SetCursorPosX(userSettings.presentation.textPadding + available_width - text_width);
-                }
-            }
-            
-            ImGui::TextWrapped("%s", current_displayed_verse.c_str());
-            ImGui::PopStyleColor();
-            
-            // Display reference if enabled
-            if (userSettings.presentation.showReference && !current_displayed_reference.empty()) {
-                ImGui::Spacing();
-                ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(ref_r, ref_g, ref_b, presentation_fade_alpha));
-                
-                if (userSettings.presentation.textAlignment == "center") {
-                    float ref_width = ImGui::CalcTextSize(current_displayed_reference.c_str()).x;
-                    if (ref_width < available_width) {
-                        ImGui::SetCursorPosX(userSettings.presentation.textPadding + (available_width - ref_width) / 2);
-                    }
-                } else if (userSettings.presentation.textAlignment == "right") {
-                    float ref_width = ImGui::CalcTextSize(current_displayed_reference.c_str()).x;
-                    if (ref_width < available_width) {
-                        ImGui::SetCursorPosX(userSettings.presentation.textPadding + available_width - ref_width);
-                    }
-                }
-                
-                ImGui::Text("%s", current_displayed_reference.c_str());
-                ImGui::PopStyleColor();
-            }
-            
-            ImGui::PopFont();
-            ImGui::PopStyleVar();
+    // The translation on screen, and any an item asks for
+    std::vector<ServiceItem> items = current_service_plan->getItems();
+    std::vector<std::string> translations{current_translation.name};
+    for (const auto& item : items) {
+        if (!item.translation.empty() &&
+            std::find(translations.begin(), translations.end(), item.translation) == translations.end()) {
+            translations.push_back(item.translation);
         }
     }
-    ImGui::End();
     
-    // Render
-    ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    auto outcome = std::make_unique<BundleOutcome>();
+    outcome->path = ServiceBundle::pathFor(
+        (std::filesystem::path(PlatformUtils::getSettingsFilePath()).parent_path() / "bundles").string(),
+        current_service_plan->getId());
+    outcome->revision = current_service_plan->getRevision();
+    service_bundle_status = "Bundling...";
+    
+    TaskScheduler::shared().post([this, outcome = outcome.release(), id = current_service_plan->getId(),
+                                  title = current_service_plan->getTitle(), items = std::move(items),
+                                  translations = std::move(translations)]() {
+        std::unique_ptr<BundleOutcome> finished(outcome);
+        finished->written = ServiceBundle::write(finished->path, id, title, items, bible, translations, &finished->report);
+        delete bundle_mailbox.exchange(finished.release(), std::memory_order_acq_rel);
+        bundle_building = false;
+        FrameScheduler::shared().requestRedraw();
+    });
+}
+
+void VerseFinderApp::drainBundleMailbox() {
+    std::unique_ptr<BundleOutcome> outcome(bundle_mailbox.exchange(nullptr, std::memory_order_acq_rel));
+    if (!outcome) {
+        return;
+    }
+    if (!outcome->written || !service_bundle.load(outcome->path)) {
+        service_bundle_status = "Could not write the service bundle";
+        return;
+    }
+    service_bundle_revision = outcome->revision;
+    
+    const ServiceBundle::BuildReport& report = outcome->report;
+    char status[256];
+    std::snprintf(status, sizeof(status), "Bundled %zu readings (%zu slides) and %zu media, %.1f MB",
+                  report.readings, report.slides, report.media, report.bytes / (1024.0 * 1024.0));
+    service_bundle_status = status;
+    if (report.unresolved > 0 || report.media_missing > 0) {
+        std::snprintf(status, sizeof(status), "; %zu readings unresolved, %zu media files missing",
+                      report.unresolved, report.media_missing);
+        service_bundle_status += status;
+    }
     
-    glfwSwapBuffers(presentation_window);
+    if (startup.isDone("reliability")) {
+        if (EmergencyModeHandler* emergency = ReliabilityManager::getInstance().getEmergencyMode()) {
+            emergency->setFallbackBundle(outcome->path);
+        }
+    }
+}
+
+PresentationRenderer::Style VerseFinderApp::presentationStyle() const {
+    // "#RRGGBB" settings; anything else keeps the fallback
+    auto parseColor = [](const std::string& hex, ImVec4 fallback) {
+        if (hex.length() != 7 || hex[0] != '#') {
+            return fallback;
+        }
+        return ImVec4(std::stoi(hex.substr(1, 2), 0, 16) / 255.0f,
+                      std::stoi(hex.substr(3, 2), 0, 16) / 255.0f,
+                      std::stoi(hex.substr(5, 2), 0, 16) / 255.0f, 1.0f);
+    };
     
-    // Switch back to main window context
-    glfwMakeContextCurrent(window);
+    const PresentationSettings& settings = userSettings.presentation;
+    PresentationRenderer::Style style;
+    style.font_size = settings.fontSize;
+    style.background = parseColor(settings.backgroundColor, ImVec4(0.0f, 0.0f, 0.0f, 1.0f));
+    style.text = parseColor(settings.textColor, ImVec4(1.0f, 1.0f, 1.0f, 1.0f));
+    style.reference = parseColor(settings.referenceColor, ImVec4(0.8f, 0.8f, 0.8f, 1.0f));
+    style.show_reference = settings.showReference;
+    style.alignment = settings.textAlignment;
+    style.padding = settings.textPadding;
+    style.fade_seconds = settings.fadeTransitionTime;
+    return style;
 }
 
 void VerseFinderApp::renderPresentationPreview() {
+    TRACE_SCOPE("ui.presentation_preview");
     if (!userSettings.presentation.enabled) {
         return;
     }
@@ -2985,33 +3412,76 @@ void VerseFinderApp::togglePresentationMode() {
         if (presentation_window) {
             presentation_mode_active = true;
             userSettings.presentation.enabled = true;
+            settingsChanged();
         }
     } else {
         destroyPresentationWindow();
         presentation_mode_active = false;
     }
+    publishPresentationState("mode");
 }
 
 void VerseFinderApp::displayVerseOnPresentation(const std::string& verse_text, const std::string& reference) {
     current_displayed_verse = verse_text;
     current_displayed_reference = reference;
+    glyph_cache.noteText(verse_text);
+    glyph_cache.noteText(reference);
     presentation_blank_screen = false;
-    presentation_fade_alpha = 1.0f;
+    if (presentation_renderer) {
+        presentation_renderer->displayVerse(verse_text, reference);
+        prefetchPresentationSlides(reference);
+    }
+    publishPresentationState("verse");
 }
 
 void VerseFinderApp::clearPresentationDisplay() {
     current_displayed_verse.clear();
     current_displayed_reference.clear();
+    if (presentation_renderer) {
+        presentation_renderer->clear();
+    }
+    publishPresentationState("clear");
 }
 
 void VerseFinderApp::toggleBlankScreen() {
     presentation_blank_screen = !presentation_blank_screen;
+    if (presentation_renderer) {
+        presentation_renderer->setBlank(presentation_blank_screen);
+    }
+    publishPresentationState("blank");
+}
+
+void VerseFinderApp::publishPresentationState(const std::string& change) {
+    // One serialization per change, fanned out to every subscriber and webhook by the API server
+    json state = {
+        {"change", change},
+        {"active", isPresentationWindowActive()},
+        {"blank", presentation_blank_screen},
+        {"reference", current_displayed_reference},
+        {"text", current_displayed_verse}
+    };
+    std::string payload = state.dump();
+    api_server->broadcastEvent("/api/presentation/events", "presentation", payload);
+    api_server->triggerWebhook("presentation", payload);  // An enqueue; delivery is off this thread
+    FrameScheduler::shared().requestRedraw();
 }
 
 bool VerseFinderApp::isPresentationWindowActive() const {
     return presentation_window != nullptr && presentation_mode_active;
 }
 
+bool VerseFinderApp::isAnimating() const {
+    if (current_screen == UIScreen::SPLASH || !bible.isReady() || search_in_progress) {
+        return true;
+    }
+    if (presentation_window_component && presentation_window_component->isAnimationActive()) {
+        return true;
+    }
+    // Download progress bars are updated from worker threads
+    return std::any_of(available_translations.begin(), available_translations.end(),
+                       [](const auto& trans) { return trans.is_downloading; });
+}
+
 void VerseFinderApp::updatePresentationMonitorPosition() {
     if (!presentation_window) {
         return;
@@ -3035,18 +3505,50 @@ std::vector<GLFWmonitor*> VerseFinderApp::getAvailableMonitors() const {
 }
 
 void VerseFinderApp::cleanup() {
+    // Startup tasks still running use everything below
+    startup.cancel();
+    
     // Stop API server
     if (api_server && api_server->isRunning()) {
         api_server->stop();
     }
     
+    bible.cancelWarmUp();
+    bible.saveSearchHistory(searchHistoryPath());
+    
+    // Searches still running use the Bible and the mailbox
+    cancelSearches();
+    while (searches_running.load() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    delete search_mailbox.exchange(nullptr);
+    // A bundle being written reads the Bible too
+    while (bundle_building.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    delete bundle_mailbox.exchange(nullptr);
+    // So do translation downloads; ending the client fails any still waiting on the network
+    translation_client.reset();
+    for (auto& download : translation_downloads) {
+        download.wait();
+    }
+    translation_downloads.clear();
+    
     // Shutdown plugin system
     shutdownPluginSystem();
     
+    ReliabilityManager::destroyInstance();
+    
     // Cleanup presentation window first
     destroyPresentationWindow();
     
+    // Changes still settling, with the main window's geometry while it exists
+    if (settings_file) {
+        settings_file->flush();
+    }
+    
     if (window) {
+        frame_profiler.releaseGpuQueries();
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
         ImGui::DestroyContext();
@@ -3112,6 +3614,9 @@ void VerseFinderApp::renderServicePlanningScreen() {
             
             // Context menu for items
             if (ImGui::BeginPopupContextItem(("service_item_context_" + std::to_string(i)).c_str())) {
+                if (item.type == ServiceItemType::SCRIPTURE && ImGui::MenuItem("Present")) {
+                    presentServiceItem(item);
+                }
                 if (ImGui::MenuItem("Edit")) {
                     // TODO: Implement item editing
                 }
@@ -3119,10 +3624,10 @@ void VerseFinderApp::renderServicePlanningScreen() {
                     current_service_plan->removeItem(item.id);
                 }
                 if (ImGui::MenuItem("Move Up") && i > 0) {
-                    // TODO: Implement move up
+                    current_service_plan->moveItem(item.id, i - 1);
                 }
                 if (ImGui::MenuItem("Move Down") && i < current_service_plan->getItems().size() - 1) {
-                    // TODO: Implement move down
+                    current_service_plan->moveItem(item.id, i + 1);
                 }
                 ImGui::EndPopup();
             }
@@ -3155,6 +3660,23 @@ void VerseFinderApp::renderServicePlanningScreen() {
             item.content = "Prayer notes...";
             current_service_plan->addItem(item);
         }
+        
+        // Everything needed to present the plan, in one file that loads even
+        // without the translations or the planning integration
+        ImGui::Separator();
+        bool building = bundle_building.load();
+        if (ImGui::Button(building ? "Bundling..." : "Bundle for Offline", ImVec2(150, 0)) && !building) {
+            buildServiceBundle();
+        }
+        if (!service_bundle_status.empty()) {
+            ImGui::SameLine();
+            ImGui::TextColored(ImVec4(0.7f, 0.7f, 0.7f, 1.0f), "%s", service_bundle_status.c_str());
+        }
+        if (service_bundle.isLoaded() && !building &&
+            (service_bundle.planId() != current_service_plan->getId() ||
+             service_bundle_revision != current_service_plan->getRevision())) {
+            ImGui::TextColored(ImVec4(1.0f, 0.7f, 0.3f, 1.0f), "The plan changed since it was bundled");
+        }
     }
     
     ImGui::EndChild();
@@ -3162,7 +3684,9 @@ void VerseFinderApp::renderServicePlanningScreen() {
     // Bottom buttons
     ImGui::Separator();
     if (ImGui::Button("New Plan", ImVec2(100, 0))) {
+        plan_sync->attach(nullptr);
         current_service_plan = std::make_unique<ServicePlan>("New Service Plan", std::chrono::system_clock::now());
+        plan_sync->attach(current_service_plan.get());
     }
     ImGui::SameLine();
     if (ImGui::Button("Load Template", ImVec2(120, 0))) {
@@ -3286,6 +3810,7 @@ void VerseFinderApp::renderIntegrationsWindow() {
 }
 
 void VerseFinderApp::renderComparisonWindow() {
+    TRACE_SCOPE("ui.translation_comparison");
     ImGui::SetNextWindowSize(ImVec2(1000, 600), ImGuiCond_FirstUseEver);
     
     if (ImGui::Begin("Translation Comparison", &show_comparison_window)) {
@@ -3314,8 +3839,7 @@ void VerseFinderApp::renderSplashScreen() {
     
     // Update loading progress based on Bible readiness
     static bool initialization_started = false;
-    static bool scanning_started = false;
-    static std::atomic<bool> scanning_complete{false};
+    static bool warm_up_started = false;
     static auto initialization_start_time = std::chrono::steady_clock::now();
     
     if (!initialization_started) {
@@ -3325,56 +3849,30 @@ void VerseFinderApp::renderSplashScreen() {
         splash_progress = 0.1f;
     }
     
-    // Check if Bible is ready
+    // Searching starts with the default translation; the rest of startup
+    // carries on behind the main screen
     if (bible.isReady()) {
-        if (!scanning_started) {
-            // Start async scanning when Bible is ready
-            scanning_started = true;
-            splash_status = "Scanning for translations...";
-            splash_progress = 0.7f;
-            
-            // Start async scanning of existing translations
-            std::thread([this]() {
-                // Just scan for files and update status without loading
-                std::vector<std::string> search_directories = {
-                    PlatformUtils::getExecutablePath() + "/translations/",
-                    PlatformUtils::getExecutablePath() + "/",
-                    PlatformUtils::getExecutablePath() + "/data/",
-                    "./translations/",
-                    "./"
-                };
-                
-                for (auto& available : available_translations) {
-                    if (!available.is_downloading) {
-                        available.is_downloaded = false;
-                        
-                        std::string expected_filename = getTranslationFilename(available.name);
-                        
-                        // Check if file exists in any of the search directories
-                        for (const auto& dir : search_directories) {
-                            std::string full_path = dir + expected_filename;
-                            std::ifstream file(full_path);
-                            if (file.is_open()) {
-                                file.close();
-                                available.is_downloaded = true;
-                                std::cout << "Found existing translation file: " << available.name 
-                                          << " at " << full_path << std::endl;
-                                break;
-                            }
-                        }
+        if (!warm_up_started) {
+            warm_up_started = true;
+            auto ready_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - app_start_time).count();
+            std::cout << "Ready to search " << ready_ms << "ms after launch" << std::endl;
+            
+            // Warm the caches with the service's readings and past searches
+            std::vector<std::string> plan_references;
+            if (current_service_plan) {
+                for (const auto& item : current_service_plan->getItems()) {
+                    if (item.type == ServiceItemType::SCRIPTURE && !item.content.empty()) {
+                        plan_references.push_back(item.content);
                     }
                 }
-                
-                scanning_complete = true;
-            }).detach();
-        } else if (scanning_complete) {
-            splash_status = "Ready!";
-            splash_progress = 1.0f;
-        } else {
-            // Still scanning, show progress
-            splash_status = "Scanning for translations...";
-            splash_progress = 0.9f;
+            }
+            std::vector<std::string> warm_translations;
+            if (!current_translation.name.empty()) warm_translations.push_back(current_translation.name);
+            bible.warmUp(std::move(plan_references), std::move(warm_translations));
         }
+        splash_status = "Ready!";
+        splash_progress = 1.0f;
     } else {
         // Show progressive loading based on time elapsed
         auto now = std::chrono::steady_clock::now();
@@ -3384,6 +3882,14 @@ void VerseFinderApp::renderSplashScreen() {
         float time_progress = std::min(elapsed / 5000.0f, 0.7f);
         splash_progress = std::max(splash_progress, time_progress);
         
+        // Once the files are counted, report them instead
+        VerseFinder::LoadProgress files = bible.getLoadProgress();
+        if (files.total > 0) {
+            splash_status = "Loading translations (" + std::to_string(files.done) + "/" +
+                            std::to_string(files.total) + ")...";
+            splash_progress = std::max(splash_progress, 0.1f + 0.6f * files.done / files.total);
+        }
+        
         if (elapsed > 10000) {
             // After 10 seconds, transition anyway to avoid infinite hang
             splash_status = "Starting application...";
@@ -3397,26 +3903,15 @@ void VerseFinderApp::renderSplashScreen() {
     
     ImGui::EndChild();
     
-    // Auto-transition to main screen when loading complete or timeout
+    // To the main screen as soon as a search can run, or on timeout
     if (splash_progress >= 1.0f) {
-        // Small delay to show "Ready!" message
-        static auto ready_time = std::chrono::steady_clock::time_point{};
-        if (ready_time == std::chrono::steady_clock::time_point{}) {
-            ready_time = std::chrono::steady_clock::now();
-        }
-        
-        auto elapsed_since_ready = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::steady_clock::now() - ready_time).count();
-        
-        if (elapsed_since_ready > 500) { // 500ms delay
-            current_screen = UIScreen::MAIN;
-        }
+        current_screen = UIScreen::MAIN;
     }
 }
 
 // Plugin system methods
-void VerseFinderApp::initializePluginSystem() {
-    if (!plugin_manager) return;
+std::unique_ptr<PluginSystem::PluginManager> VerseFinderApp::initializePluginSystem() {
+    auto manager = std::make_unique<PluginSystem::PluginManager>(&bible);
     
     // Create plugins directory if it doesn't exist
     std::string plugins_dir = "plugins";
@@ -3427,19 +3922,17 @@ void VerseFinderApp::initializePluginSystem() {
         std::filesystem::create_directories(config_dir);
     } catch (const std::exception& e) {
         std::cerr << "Failed to create plugin directories: " << e.what() << std::endl;
-        return;
+        return nullptr;
     }
     
     // Initialize plugin manager
-    if (!plugin_manager->initialize(plugins_dir, config_dir)) {
+    if (!manager->initialize(plugins_dir, config_dir)) {
         std::cerr << "Failed to initialize plugin manager" << std::endl;
-        plugins_enabled = false;
-        plugin_manager.reset();
-        return;
+        return nullptr;
     }
     
     // Set up plugin callbacks
-    plugin_manager->addLoadCallback([this](const std::string& name, bool success, const std::string& error) {
+    manager->addLoadCallback([](const std::string& name, bool success, const std::string& error) {
         if (success) {
             std::cout << "Plugin loaded: " << name << std::endl;
         } else {
@@ -3447,14 +3940,15 @@ void VerseFinderApp::initializePluginSystem() {
         }
     });
     
-    plugin_manager->addUnloadCallback([this](const std::string& name) {
+    manager->addUnloadCallback([](const std::string& name) {
         std::cout << "Plugin unloaded: " << name << std::endl;
     });
     
     // Auto-scan for plugins
-    plugin_manager->scanForPlugins();
+    manager->scanForPlugins();
     
     std::cout << "Plugin system initialized successfully" << std::endl;
+    return manager;
 }
 
 void VerseFinderApp::shutdownPluginSystem() {
@@ -3462,4 +3956,19 @@ void VerseFinderApp::shutdownPluginSystem() {
         plugin_manager->shutdown();
         plugin_manager.reset();
     }
+}
+
+void VerseFinderApp::applyDegradationLevel() {
+    // The policy changes level on the monitor thread; apply each change here, once
+    DegradationPolicy* policy = ReliabilityManager::getInstance().getDegradationPolicy();
+    if (!policy || policy->generation() == applied_degradation_generation) {
+        return;
+    }
+    applied_degradation_generation = policy->generation();
+    
+    DegradationProfile profile = DegradationPolicy::profile(policy->level());
+    bible.applyDegradationProfile(profile);
+    if (presentation_window_component) {
+        presentation_window_component->setAnimationsEnabled(profile.animated_effects);
+    }
 }
\ No newline at end of file
@@ -21,18 +21,29 @@
 #include "../core/FuzzySearch.h"
 #include "../core/UserSettings.h"
 #include "../core/IncrementalSearch.h"
+#include "../core/QueryProfile.h"
 #include "../core/ReliabilityManager.h"
+#include "../core/StartupGraph.h"
+#include "../core/HttpClient.h"
+#include "../core/SettingsFile.h"
 #include "../integrations/IntegrationManager.h"
 #include "../service/ServicePlan.h"
+#include "../service/ServiceBundle.h"
 #include "../api/ApiServer.h"
+#include "../api/PlanSyncChannel.h"
+#include "../api/SearchApi.h"
 #include "../plugins/manager/PluginManager.h"
 #include "components/SearchComponent.h"
 #include "components/TranslationSelector.h"
 #include "components/TranslationComparison.h"
 #include "components/PresentationWindow.h"
+#include "components/PresentationRenderer.h"
 #include "settings/ThemeManager.h"
 #include "system/FontManager.h"
 #include "system/WindowManager.h"
+#include "system/FrameScheduler.h"
+#include "system/FrameProfiler.h"
+#include "system/GlyphCache.h"
 #include "accessibility/AccessibilityManager.h"
 #include "modals/SettingsModal.h"
 #include "modals/TranslationManagerModal.h"
@@ -41,6 +52,7 @@
 #include <string>
 #include <memory>
 #include <chrono>
+#include <atomic>
 
 enum class UIScreen {
     SPLASH,
@@ -69,8 +81,12 @@ private:
     bool presentation_mode_active = false;
     std::string current_displayed_verse;
     std::string current_displayed_reference;
-    float presentation_fade_alpha = 1.0f;
     bool presentation_blank_screen = false;
+    // Draws the presentation window on its own thread while it is open
+    std::unique_ptr<PresentationRenderer> presentation_renderer;
+    PresentationRenderer::Style presentation_style_sent;
+    std::string ui_font_path; // font file the UI loaded, reused on the presentation output
+    GlyphCache glyph_cache; // glyphs of the UI's font atlas beyond the pinned ranges
     
     // User settings
     UserSettings userSettings;
@@ -82,10 +98,14 @@ private:
     // Search state
     char search_input[512] = "";
     std::vector<std::string> search_results;
+    // Matched words of each keyword result, as spans of its verse text; empty otherwise
+    std::vector<std::vector<MatchSpan>> search_highlights;
     int selected_result_index = -1;
     std::string selected_verse_text;
     std::string last_search_query;
     bool auto_search = true;
+    // Keyword searches cover every resident translation, merged by verse
+    bool search_all_translations = false;
     
     // Fuzzy search state
     bool fuzzy_search_enabled = false;
@@ -97,26 +117,81 @@ private:
     std::string current_chapter_book;
     int current_chapter_number = -1;
     
+    // UI searches run on the shared TaskScheduler. Each leaves its outcome in a
+    // one-slot mailbox that the frame loop drains; a newer search cancels the one
+    // in flight, and outcomes of superseded searches are dropped.
+    // How a search ran, recorded while the Query Explain panel is open
+    struct SearchExplanation {
+        QueryIntent intent{};
+        QueryProfile profile;
+        double elapsed_ms = 0.0;
+    };
+    struct SearchOutcome {
+        uint64_t generation = 0;
+        std::string query;
+        std::string translation;
+        bool all_translations = false; // keyword searches span every resident translation
+        std::string query_type; // for analytics
+        std::vector<std::string> results;
+        std::vector<std::vector<MatchSpan>> highlights; // parallel to results, keyword searches only
+        bool is_viewing_chapter = false;
+        std::string chapter_book;
+        int chapter_number = -1;
+        bool has_suggestions = false;
+        std::vector<std::string> query_suggestions;
+        bool has_book_suggestions = false;
+        std::vector<FuzzyMatch> book_suggestions;
+        double elapsed_ms = 0.0;
+        std::shared_ptr<SearchExplanation> explanation;
+        PluginSystem::PluginManager* plugins = nullptr; // as attached when the search began
+    };
+    std::atomic<SearchOutcome*> search_mailbox{nullptr};
+    std::atomic<int> searches_running{0};
+    SearchContext::CancelToken search_cancel;
+    uint64_t search_generation = 0;
+    bool search_in_progress = false;
+    
     // Performance monitoring
     double last_search_time_ms = 0.0;
     bool show_performance_stats = false;
     bool show_memory_monitor = false;
+    bool show_explain_window = false;
+    std::shared_ptr<const SearchExplanation> last_explanation; // of the last search run with the panel open
     std::unique_ptr<IncrementalSearch> incremental_search;
     std::vector<std::string> auto_complete_suggestions;
+    uint64_t applied_degradation_generation = 0; // DegradationPolicy change last applied
     bool show_auto_complete = false;
     
     // Splash screen state
     UIScreen current_screen = UIScreen::SPLASH;
     std::chrono::steady_clock::time_point app_start_time;
     
+    // What init() leaves until after the first frame; see declareStartupTasks()
+    StartupGraph startup;
+    
     // Service planning integration
     std::unique_ptr<IntegrationManager> integration_manager;
     std::unique_ptr<ServicePlan> current_service_plan;
     int selected_integration_type = 0;
+    // current_service_plan resolved to present without translations; see buildServiceBundle()
+    struct BundleOutcome {
+        bool written = false;
+        std::string path;
+        uint64_t revision = 0; // of the plan it was built from
+        ServiceBundle::BuildReport report;
+    };
+    ServiceBundle service_bundle;
+    uint64_t service_bundle_revision = 0;
+    std::string service_bundle_status;
+    std::atomic<BundleOutcome*> bundle_mailbox{nullptr};
+    std::atomic<bool> bundle_building{false};
     
     // API server
     std::unique_ptr<ApiServer> api_server;
     bool api_server_enabled = false;
+    std::unique_ptr<SearchApi> search_api;
+    // Live edits of current_service_plan for remote editors
+    std::unique_ptr<PlanSyncChannel> plan_sync;
     
     // Plugin system
     std::unique_ptr<PluginSystem::PluginManager> plugin_manager;
@@ -147,14 +222,26 @@ private:
     bool show_integrations_window = false;
     bool show_comparison_window = false;
     bool show_plugin_manager_window = false;
+    bool show_frame_profiler = false;
+    
+    // Per-section CPU and GPU time of the UI thread's frames
+    FrameProfiler frame_profiler;
     
     // API server setup
     void setupApiRoutes();
     
-    // Plugin system setup
-    void initializePluginSystem();
+    // Startup beyond the window, GL and fonts, run alongside the first frames
+    void declareStartupTasks();
+    void registerVoiceCommands();
+    
+    // Plugin system setup; initializePluginSystem() runs off the UI thread and
+    // returns a manager with its plugins scanned, or null
+    std::unique_ptr<PluginSystem::PluginManager> initializePluginSystem();
     void shutdownPluginSystem();
     
+    // Load shedding driven by the health monitor
+    void applyDegradationLevel();
+    
     // Available translations for download
     std::vector<AvailableTranslation> available_translations = {
         {"King James Version", "KJV", "https://api.getbible.net/v2/kjv.json", 
@@ -168,6 +255,9 @@ private:
         {"Basic English Bible", "BBE", "https://api.getbible.net/v2/basicenglish.json",
          "Simple English translation using basic vocabulary", false, false, 0.0f}
     };
+    // Downloads in progress are coroutines on the TaskScheduler; see fetchTranslation()
+    std::unique_ptr<HttpClient> translation_client;
+    std::vector<std::future<void>> translation_downloads;
     
     // UI rendering methods
     void renderMainWindow();
@@ -186,6 +276,7 @@ private:
     void renderAboutWindow();
     void renderHelpWindow();
     void renderPerformanceWindow();
+    void renderExplainWindow();
     void renderMemoryWindow();
     void renderComparisonWindow();
     void renderPluginManagerWindow();
@@ -193,19 +284,41 @@ private:
     // Presentation mode methods
     void initPresentationWindow();
     void destroyPresentationWindow();
-    void renderPresentationWindow();
+    // Sends presentation settings edited since the last call to the render thread
+    void syncPresentationStyle();
+    PresentationRenderer::Style presentationStyle() const;
+    // Has the render thread draw ahead the slides likely to follow reference
+    void prefetchPresentationSlides(const std::string& reference);
+    // The same from the service bundle, for when the translations cannot serve it
+    void prefetchBundledSlides(const std::string& reference);
+    // Translations unloaded or emergency mode: present from the bundle instead
+    bool presentingFromBundle() const;
+    void presentServiceItem(const ServiceItem& item);
+    // Writes the bundle off the UI thread; drainBundleMailbox() loads it
+    void buildServiceBundle();
+    void drainBundleMailbox();
     void renderPresentationPreview();
     void togglePresentationMode();
     void displayVerseOnPresentation(const std::string& verse_text, const std::string& reference);
     void clearPresentationDisplay();
     void toggleBlankScreen();
+    void publishPresentationState(const std::string& change);
     bool isPresentationWindowActive() const;
+    // Something on screen moves without input, so frames must keep coming
+    bool isAnimating() const;
     void updatePresentationMonitorPosition();
     std::vector<GLFWmonitor*> getAvailableMonitors() const;
     
     // Utility methods
     void performSearch();
     void performIncrementalSearch();
+    // Worker side of performSearch(): fills outcome's results for its query
+    void executeSearch(SearchOutcome& outcome, size_t result_limit, bool semantic, bool fuzzy,
+                       const SearchContext& context);
+    // Keyword matches rendered as "Reference: text" with the spans the engine matched
+    void searchKeywords(SearchOutcome& outcome, const SearchContext& context);
+    void drainSearchMailbox();
+    void cancelSearches();
     void updateAutoComplete();
     void clearSearch();
     void selectResult(int index);
@@ -217,6 +330,8 @@ private:
     
     // Translation management
     void downloadTranslation(const std::string& url, const std::string& name);
+    Task<void> fetchTranslation(std::string url, std::string name);
+    void setDownloadProgress(const std::string& name, float progress, bool downloading, bool downloaded = false);
     void updateAvailableTranslationStatus();
     void switchToTranslation(const std::string& translation_name);
     bool isTranslationAvailable(const std::string& name) const;
@@ -224,15 +339,18 @@ private:
     void scanForExistingTranslations();
     
     // HTTP download utilities
-    std::string downloadFromUrl(const std::string& url) const;
     std::string extractFilenameFromUrl(const std::string& url, const std::string& translation_name) const;
     
     // Event handling
     static void glfwErrorCallback(int error, const char* description);
     void handleKeyboardShortcuts();
     
-    // File operations
-    bool saveSettings() const;
+    // File operations. userSettings is the authority; settings_file writes it
+    // out in the background once changes settle.
+    std::unique_ptr<SettingsFile> settings_file;
+    json settingsSnapshot() const;
+    void settingsChanged() { settings_file->markDirty(); }
+    bool saveSettings() const; // queues a write now
     bool loadSettings();
     void resetSettingsToDefault();
     bool exportSettings(const std::string& filepath) const;
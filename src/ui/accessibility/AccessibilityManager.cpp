@@ -1,7 +1,7 @@
 #include "AccessibilityManager.h"
+#include "../system/FrameScheduler.h"
 #include "imgui.h"
 #include <iostream>
-#include <fstream>
 #include <algorithm>
 #include <cctype>
 #include <regex>
@@ -9,8 +9,6 @@
 // Platform-specific includes
 #ifdef _WIN32
 #include <windows.h>
-#include <sapi.h>
-#include <sphelper.h>
 #elif __APPLE__
 #include <CoreFoundation/CoreFoundation.h>
 #include <ApplicationServices/ApplicationServices.h>
@@ -22,6 +20,8 @@
 AccessibilityManager::AccessibilityManager() {
     // Initialize default settings
     settings = AccessibilitySettings{};
+    settings_file = std::make_unique<SettingsFile>("accessibility_settings.json",
+                                                   [this]() { return json(settings); });
 }
 
 AccessibilityManager::~AccessibilityManager() {
@@ -69,7 +69,9 @@ void AccessibilityManager::shutdown() {
     
     stopVoiceRecognition();
     stopSpeaking();
-    saveSettings();
+    speech.reset();
+    tts_available = false;
+    settings_file->flush();
     
     is_initialized = false;
 }
@@ -79,13 +81,38 @@ void AccessibilityManager::update() {
         return;
     }
     
-    // Handle any ongoing voice recognition or TTS updates
-    // This would be platform-specific and handle async operations
+    settings_file->poll();
+    
+    if (voice_recognition_active && voice && !voice->isRunning()) {
+        voice_recognition_active = false;
+        pending_voice_command.reset();
+        announceAction("Voice recognition stopped");
+    }
+    
+    // Only finished recognitions reach the frame loop; capture and decoding stay on the worker
+    VoiceWorker::Recognition recognition;
+    while (voice && voice->poll(recognition)) {
+        if (!settings.voice_commands_enabled) {
+            continue;
+        }
+        if (settings.voice_confirm_live_commands && changesLiveDisplay(recognition.command)) {
+            pending_voice_command = std::move(recognition); // a newer command replaces one not yet confirmed
+            playSelectionSound();
+        } else {
+            runVoiceCommand(recognition.command, recognition.transcript);
+        }
+    }
+    
+    if (pending_voice_command &&
+        std::chrono::steady_clock::now() - pending_voice_command->heard_at > std::chrono::seconds(VOICE_CONFIRM_SECONDS)) {
+        pending_voice_command.reset();
+    }
 }
 
 void AccessibilityManager::updateSettings(const AccessibilitySettings& new_settings) {
     AccessibilitySettings old_settings = settings;
     settings = new_settings;
+    settings_file->markDirty();
     
     // Handle setting changes that require reinitialization
     if (old_settings.voice_commands_enabled != settings.voice_commands_enabled) {
@@ -116,24 +143,7 @@ void AccessibilityManager::updateSettings(const AccessibilitySettings& new_setti
 
 void AccessibilityManager::saveSettings() {
     try {
-        std::ofstream file("accessibility_settings.json");
-        if (file.is_open()) {
-            file << "{\n";
-            file << "  \"high_contrast_enabled\": " << (settings.high_contrast_enabled ? "true" : "false") << ",\n";
-            file << "  \"large_text_enabled\": " << (settings.large_text_enabled ? "true" : "false") << ",\n";
-            file << "  \"screen_reader_enabled\": " << (settings.screen_reader_enabled ? "true" : "false") << ",\n";
-            file << "  \"voice_commands_enabled\": " << (settings.voice_commands_enabled ? "true" : "false") << ",\n";
-            file << "  \"audio_feedback_enabled\": " << (settings.audio_feedback_enabled ? "true" : "false") << ",\n";
-            file << "  \"enhanced_keyboard_nav\": " << (settings.enhanced_keyboard_nav ? "true" : "false") << ",\n";
-            file << "  \"focus_indicators_enabled\": " << (settings.focus_indicators_enabled ? "true" : "false") << ",\n";
-            file << "  \"font_scale_factor\": " << settings.font_scale_factor << ",\n";
-            file << "  \"speech_rate\": " << settings.speech_rate << ",\n";
-            file << "  \"audio_volume\": " << settings.audio_volume << ",\n";
-            file << "  \"preferred_voice\": \"" << settings.preferred_voice << "\",\n";
-            file << "  \"contrast_theme\": \"" << settings.contrast_theme << "\"\n";
-            file << "}\n";
-            file.close();
-        }
+        settings_file->save();
     } catch (const std::exception& e) {
         std::cerr << "Error saving accessibility settings: " << e.what() << std::endl;
     }
@@ -161,7 +171,7 @@ bool AccessibilityManager::isFeatureAvailable(AccessibilityFeature feature) cons
             #elif __APPLE__
             return true; // macOS Speech Framework
             #elif __linux__
-            return (system("which espeak > /dev/null 2>&1") == 0); // Check for espeak
+            return SpeechWorker::isAvailable(); // Check for espeak
             #else
             return false;
             #endif
@@ -217,6 +227,7 @@ void AccessibilityManager::setFeatureEnabled(AccessibilityFeature feature, bool
             settings.focus_indicators_enabled = enabled;
             break;
     }
+    settings_file->markDirty();
 }
 
 void AccessibilityManager::registerVoiceCommand(VoiceCommand command, std::function<void(const std::string&)> handler) {
@@ -224,54 +235,8 @@ void AccessibilityManager::registerVoiceCommand(VoiceCommand command, std::funct
 }
 
 VoiceCommand AccessibilityManager::parseVoiceCommand(const std::string& input) {
-    std::string lower_input = input;
-    std::transform(lower_input.begin(), lower_input.end(), lower_input.begin(), ::tolower);
-    
-    // Simple pattern matching for voice commands
-    if (lower_input.find("search") != std::string::npos || 
-        lower_input.find("find") != std::string::npos ||
-        lower_input.find("go to") != std::string::npos) {
-        return VoiceCommand::SEARCH_VERSE;
-    }
-    
-    if (lower_input.find("next verse") != std::string::npos) {
-        return VoiceCommand::NEXT_VERSE;
-    }
-    
-    if (lower_input.find("previous verse") != std::string::npos) {
-        return VoiceCommand::PREVIOUS_VERSE;
-    }
-    
-    if (lower_input.find("next chapter") != std::string::npos) {
-        return VoiceCommand::NEXT_CHAPTER;
-    }
-    
-    if (lower_input.find("previous chapter") != std::string::npos) {
-        return VoiceCommand::PREVIOUS_CHAPTER;
-    }
-    
-    if (lower_input.find("presentation") != std::string::npos || 
-        lower_input.find("present") != std::string::npos) {
-        return VoiceCommand::PRESENTATION_MODE;
-    }
-    
-    if (lower_input.find("blank") != std::string::npos) {
-        return VoiceCommand::BLANK_SCREEN;
-    }
-    
-    if (lower_input.find("show verse") != std::string::npos) {
-        return VoiceCommand::SHOW_VERSE;
-    }
-    
-    if (lower_input.find("help") != std::string::npos) {
-        return VoiceCommand::HELP;
-    }
-    
-    if (lower_input.find("settings") != std::string::npos) {
-        return VoiceCommand::SETTINGS;
-    }
-    
-    return VoiceCommand::UNKNOWN;
+    // The same phrases the recognizer's hypotheses are spotted with
+    return VoiceWorker::spot(input, true);
 }
 
 void AccessibilityManager::processVoiceInput(const std::string& input) {
@@ -279,8 +244,25 @@ void AccessibilityManager::processVoiceInput(const std::string& input) {
         return;
     }
     
-    VoiceCommand command = parseVoiceCommand(input);
-    
+    runVoiceCommand(parseVoiceCommand(input), input);
+}
+
+bool AccessibilityManager::changesLiveDisplay(VoiceCommand command) {
+    switch (command) {
+        case VoiceCommand::NEXT_VERSE:
+        case VoiceCommand::PREVIOUS_VERSE:
+        case VoiceCommand::NEXT_CHAPTER:
+        case VoiceCommand::PREVIOUS_CHAPTER:
+        case VoiceCommand::PRESENTATION_MODE:
+        case VoiceCommand::BLANK_SCREEN:
+        case VoiceCommand::SHOW_VERSE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void AccessibilityManager::runVoiceCommand(VoiceCommand command, const std::string& input) {
     auto handler_it = command_handlers.find(command);
     if (handler_it != command_handlers.end()) {
         handler_it->second(input);
@@ -295,73 +277,20 @@ void AccessibilityManager::processVoiceInput(const std::string& input) {
     }
 }
 
-// Platform-specific TTS implementations
+// Text-to-Speech runs on SpeechWorker's thread; these only queue
 bool AccessibilityManager::initializeTTS() {
-    #ifdef _WIN32
-    return initializeWindowsSpeech();
-    #elif __APPLE__
-    return initializeMacOSSpeech();
-    #else
-    return initializeLinuxSpeech();
-    #endif
-}
-
-#ifdef _WIN32
-bool AccessibilityManager::initializeWindowsSpeech() {
-    // Windows SAPI implementation would go here
-    // For minimal implementation, return true
-    return true;
-}
-
-void AccessibilityManager::speakTextWindows(const std::string& text) {
-    // Simple fallback using Windows narrator command
-    std::string command = "echo " + text + " | msg %username%";
-    system(command.c_str());
-}
-#endif
-
-#ifdef __APPLE__
-bool AccessibilityManager::initializeMacOSSpeech() {
-    // macOS Speech Synthesis implementation would go here
-    return true;
-}
-
-void AccessibilityManager::speakTextMacOS(const std::string& text) {
-    std::string command = "say \"" + text + "\"";
-    system(command.c_str());
-}
-#endif
-
-#ifndef _WIN32
-#ifndef __APPLE__
-bool AccessibilityManager::initializeLinuxSpeech() {
-    // Check if espeak is available
-    return (system("which espeak > /dev/null 2>&1") == 0);
-}
-
-void AccessibilityManager::speakTextLinux(const std::string& text) {
-    std::string command = "espeak \"" + text + "\" 2>/dev/null &";
-    system(command.c_str());
+    if (!speech) {
+        speech = std::make_unique<SpeechWorker>();
+    }
+    return speech->start();
 }
-#endif
-#endif
 
 void AccessibilityManager::speakText(const std::string& text, bool interrupt) {
     if (!tts_available || !settings.screen_reader_enabled) {
         return;
     }
     
-    if (interrupt) {
-        stopSpeaking();
-    }
-    
-    #ifdef _WIN32
-    speakTextWindows(text);
-    #elif __APPLE__
-    speakTextMacOS(text);
-    #else
-    speakTextLinux(text);
-    #endif
+    speech->speak(text, interrupt);
 }
 
 void AccessibilityManager::announceText(const std::string& text) {
@@ -382,18 +311,13 @@ void AccessibilityManager::announceAction(const std::string& action) {
 }
 
 void AccessibilityManager::stopSpeaking() {
-    #ifdef _WIN32
-    // Stop Windows speech
-    #elif __APPLE__
-    system("killall say 2>/dev/null");
-    #else
-    system("killall espeak 2>/dev/null");
-    #endif
+    if (speech) {
+        speech->cancel();
+    }
 }
 
 bool AccessibilityManager::isSpeaking() const {
-    // Simple implementation - in reality this would check platform-specific speech status
-    return false;
+    return speech && speech->isSpeaking();
 }
 
 // Audio feedback implementations
@@ -535,17 +459,30 @@ void AccessibilityManager::renderFocusIndicator(const std::string& element_id) {
 }
 
 bool AccessibilityManager::initializeVoiceRecognition() {
-    // Placeholder implementation
-    // In a full implementation, this would initialize platform-specific voice recognition
-    return false; // For now, return false to indicate not implemented
+    // The recognizer itself only starts with startVoiceRecognition(), so the
+    // microphone is not held until the operator asks for it
+    return VoiceWorker::isAvailable();
 }
 
 void AccessibilityManager::startVoiceRecognition() {
-    voice_recognition_active = true;
+    if (voice_recognition_active) {
+        return;
+    }
+    if (!voice) {
+        voice = std::make_unique<VoiceWorker>();
+    }
+    voice_recognition_active = voice->start([] { FrameScheduler::shared().requestRedraw(); });
+    if (!voice_recognition_active) {
+        std::cerr << "Voice recognition unavailable: set VERSEFINDER_VOICE_RECOGNIZER to a streaming recognizer" << std::endl;
+    }
 }
 
 void AccessibilityManager::stopVoiceRecognition() {
+    if (voice) {
+        voice->stop();
+    }
     voice_recognition_active = false;
+    pending_voice_command.reset();
 }
 
 bool AccessibilityManager::handleAccessibilityKeyInput() {
@@ -625,4 +562,27 @@ void AccessibilityManager::renderAccessibilityOverlay() {
         }
         ImGui::End();
     }
+    
+    // A heard command that would change the live display waits for the operator
+    if (pending_voice_command) {
+        ImVec2 display_size = ImGui::GetIO().DisplaySize;
+        ImGui::SetNextWindowPos(ImVec2(display_size.x - 310, 70));
+        ImGui::SetNextWindowSize(ImVec2(300, 0));
+        
+        if (ImGui::Begin("Voice Command", nullptr,
+                        ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize |
+                        ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoCollapse)) {
+            ImGui::TextWrapped("Heard: \"%s\"", pending_voice_command->transcript.c_str());
+            if (ImGui::Button("Run")) {
+                VoiceWorker::Recognition confirmed = std::move(*pending_voice_command);
+                pending_voice_command.reset();
+                runVoiceCommand(confirmed.command, confirmed.transcript);
+            }
+            ImGui::SameLine();
+            if (ImGui::Button("Dismiss")) {
+                pending_voice_command.reset();
+            }
+        }
+        ImGui::End();
+    }
 }
\ No newline at end of file
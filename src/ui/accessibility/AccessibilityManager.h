@@ -6,7 +6,11 @@
 #include <map>
 #include <functional>
 #include <memory>
+#include <optional>
 #include "../core/UserSettings.h"
+#include "../core/SettingsFile.h"
+#include "SpeechWorker.h"
+#include "VoiceWorker.h"
 
 // Forward declarations
 struct ImGuiContext;
@@ -21,23 +25,10 @@ enum class AccessibilityFeature {
     FOCUS_INDICATORS
 };
 
-enum class VoiceCommand {
-    SEARCH_VERSE,
-    NEXT_VERSE,
-    PREVIOUS_VERSE,
-    NEXT_CHAPTER,
-    PREVIOUS_CHAPTER,
-    PRESENTATION_MODE,
-    BLANK_SCREEN,
-    SHOW_VERSE,
-    HELP,
-    SETTINGS,
-    UNKNOWN
-};
-
 class AccessibilityManager {
 private:
     AccessibilitySettings settings;
+    std::unique_ptr<SettingsFile> settings_file; // written once changes settle
     bool is_initialized = false;
     bool voice_recognition_active = false;
     bool tts_available = false;
@@ -53,26 +44,21 @@ private:
     // Audio feedback
     void playFeedbackSound(const std::string& action);
     
-    // Voice recognition
+    // Voice recognition runs on VoiceWorker's thread; update() takes its results
+    std::unique_ptr<VoiceWorker> voice;
+    std::optional<VoiceWorker::Recognition> pending_voice_command; // awaiting the operator
+    static constexpr int VOICE_CONFIRM_SECONDS = 5;
     bool initializeVoiceRecognition();
     void processVoiceInput(const std::string& input);
     VoiceCommand parseVoiceCommand(const std::string& input);
+    void runVoiceCommand(VoiceCommand command, const std::string& input);
+    // Commands that change what the congregation sees
+    static bool changesLiveDisplay(VoiceCommand command);
     
     // Text-to-Speech
+    std::unique_ptr<SpeechWorker> speech;
     bool initializeTTS();
     void speakText(const std::string& text, bool interrupt = false);
-    
-    // Platform-specific implementations
-    #ifdef _WIN32
-    bool initializeWindowsSpeech();
-    void speakTextWindows(const std::string& text);
-    #elif __APPLE__
-    bool initializeMacOSSpeech();
-    void speakTextMacOS(const std::string& text);
-    #else
-    bool initializeLinuxSpeech();
-    void speakTextLinux(const std::string& text);
-    #endif
 
 public:
     AccessibilityManager();
@@ -86,7 +72,7 @@ public:
     // Settings management
     const AccessibilitySettings& getSettings() const { return settings; }
     void updateSettings(const AccessibilitySettings& new_settings);
-    void saveSettings();
+    void saveSettings(); // queues a write now
     void loadSettings();
     
     // Feature availability
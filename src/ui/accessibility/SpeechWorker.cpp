@@ -0,0 +1,357 @@
+#include "SpeechWorker.h"
+#include <chrono>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <sapi.h>
+#elif __APPLE__
+#include <ApplicationServices/ApplicationServices.h>
+#elif defined(VERSEFINDER_USE_SPEECHD)
+#include <libspeechd.h>
+#else
+#include <cerrno>
+#include <cstdlib>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+
+namespace {
+// How often the worker checks whether a synthesizer that speaks
+// asynchronously has finished, while it holds queued text
+constexpr auto BUSY_POLL_INTERVAL = std::chrono::milliseconds(20);
+}
+
+#ifdef _WIN32
+
+struct SpeechWorker::Backend {
+    ISpVoice* voice = nullptr;
+
+    // COM objects belong to the thread that created them: all of these run on the worker
+    bool openVoice() {
+        if (FAILED(CoInitializeEx(nullptr, COINIT_MULTITHREADED))) return false;
+        if (FAILED(CoCreateInstance(CLSID_SpVoice, nullptr, CLSCTX_ALL, IID_ISpVoice,
+                                    reinterpret_cast<void**>(&voice)))) {
+            voice = nullptr;
+            CoUninitialize();
+            return false;
+        }
+        return true;
+    }
+
+    void closeVoice() {
+        voice->Release();
+        voice = nullptr;
+        CoUninitialize();
+    }
+
+    bool say(const std::string& text) {
+        int length = MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), nullptr, 0);
+        std::wstring wide(static_cast<size_t>(length), L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, text.data(), static_cast<int>(text.size()), wide.data(), length);
+        // Verse text is never SAPI markup
+        return SUCCEEDED(voice->Speak(wide.c_str(), SPF_ASYNC | SPF_IS_NOT_XML, nullptr));
+    }
+
+    void silence() {
+        voice->Speak(nullptr, SPF_ASYNC | SPF_PURGEBEFORESPEAK, nullptr);
+    }
+
+    bool busy() {
+        SPVOICESTATUS status;
+        return SUCCEEDED(voice->GetStatus(&status, nullptr)) && status.dwRunningState == SPRS_IS_SPEAKING;
+    }
+};
+
+bool SpeechWorker::isAvailable() {
+    return true;
+}
+
+#elif __APPLE__
+
+struct SpeechWorker::Backend {
+    SpeechChannel channel = nullptr;
+
+    bool openVoice() {
+        return NewSpeechChannel(nullptr, &channel) == noErr;
+    }
+
+    void closeVoice() {
+        DisposeSpeechChannel(channel);
+        channel = nullptr;
+    }
+
+    bool say(const std::string& text) {
+        CFStringRef string = CFStringCreateWithBytes(kCFAllocatorDefault, reinterpret_cast<const UInt8*>(text.data()),
+                                                     static_cast<CFIndex>(text.size()), kCFStringEncodingUTF8, false);
+        if (!string) return false;
+        OSErr result = SpeakCFString(channel, string, nullptr);
+        CFRelease(string);
+        return result == noErr;
+    }
+
+    void silence() {
+        StopSpeech(channel);
+    }
+
+    // A channel speaks one string at a time; a new one would cut this one off
+    bool busy() {
+        SpeechStatusInfo status;
+        return GetSpeechInfo(channel, soStatus, &status) == noErr && status.outputBusy;
+    }
+};
+
+bool SpeechWorker::isAvailable() {
+    return true;
+}
+
+#elif defined(VERSEFINDER_USE_SPEECHD)
+
+struct SpeechWorker::Backend {
+    SPDConnection* connection = nullptr;
+
+    bool openVoice() {
+        connection = spd_open("VerseFinder", "screen-reader", nullptr, SPD_MODE_THREADED);
+        return connection != nullptr;
+    }
+
+    void closeVoice() {
+        spd_close(connection);
+        connection = nullptr;
+    }
+
+    // speech-dispatcher queues messages of the same priority itself
+    bool say(const std::string& text) {
+        return spd_say(connection, SPD_TEXT, text.c_str()) >= 0;
+    }
+
+    void silence() {
+        spd_cancel(connection);
+    }
+
+    bool busy() {
+        return false;
+    }
+};
+
+bool SpeechWorker::isAvailable() {
+    return true;
+}
+
+#else
+
+namespace {
+// First of espeak-ng, espeak on PATH, found without running a shell
+std::string findSynthesizer() {
+    const char* path = std::getenv("PATH");
+    if (!path) return "";
+    for (const char* program : {"espeak-ng", "espeak"}) {
+        std::string directories = path;
+        size_t start = 0;
+        while (start <= directories.size()) {
+            size_t end = directories.find(':', start);
+            if (end == std::string::npos) end = directories.size();
+            std::string candidate = directories.substr(start, end - start) + "/" + program;
+            if (end > start && access(candidate.c_str(), X_OK) == 0) return candidate;
+            start = end + 1;
+        }
+    }
+    return "";
+}
+}
+
+// espeak reads stdin a line at a time when given no text, speaking each line
+// as it arrives, so one process serves every utterance. Interrupting kills
+// it; the next utterance starts another.
+struct SpeechWorker::Backend {
+    std::string program;
+    pid_t pid = -1;
+    int input = -1;  // a socket rather than a pipe, so a dead synthesizer is EPIPE and not SIGPIPE
+
+    bool openVoice() {
+        program = findSynthesizer();
+        return !program.empty();
+    }
+
+    void closeVoice() {
+        silence();
+    }
+
+    bool spawn() {
+        int fds[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) return false;
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, fds[1], STDIN_FILENO);
+        posix_spawn_file_actions_addclose(&actions, fds[1]);
+        posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+        posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+        char* argv[] = {program.data(), nullptr};
+        int result = posix_spawn(&pid, program.c_str(), &actions, nullptr, argv, environ);
+        posix_spawn_file_actions_destroy(&actions);
+        ::close(fds[1]);
+        if (result != 0) {
+            std::cerr << "Cannot start " << program << ": " << std::strerror(result) << std::endl;
+            ::close(fds[0]);
+            pid = -1;
+            return false;
+        }
+        input = fds[0];
+        return true;
+    }
+
+    bool say(const std::string& text) {
+        if (input < 0 && !spawn()) return false;
+        std::string line = text;
+        for (char& c : line) {
+            if (c == '\n' || c == '\r') c = ' ';
+        }
+        line += '\n';
+        size_t sent = 0;
+        while (sent < line.size()) {
+#ifdef MSG_NOSIGNAL
+            ssize_t count = send(input, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+#else
+            ssize_t count = send(input, line.data() + sent, line.size() - sent, 0);
+#endif
+            if (count < 0 && errno == EINTR) continue;
+            if (count <= 0) {
+                silence();  // it exited; reap it and start afresh next time
+                return false;
+            }
+            sent += static_cast<size_t>(count);
+        }
+        return true;
+    }
+
+    void silence() {
+        if (input >= 0) {
+            ::close(input);
+            input = -1;
+        }
+        if (pid > 0) {
+            kill(pid, SIGKILL);
+            waitpid(pid, nullptr, 0);
+            pid = -1;
+        }
+    }
+
+    // Lines already sent are the synthesizer's queue; it does not say when it is done
+    bool busy() {
+        return false;
+    }
+};
+
+bool SpeechWorker::isAvailable() {
+    return !findSynthesizer().empty();
+}
+
+#endif
+
+SpeechWorker::SpeechWorker() = default;
+
+SpeechWorker::~SpeechWorker() {
+    stop();
+}
+
+bool SpeechWorker::start() {
+    if (worker.joinable()) {
+        return true;
+    }
+    backend = std::make_unique<Backend>();
+    running = true;
+    std::promise<bool> opened;
+    std::future<bool> result = opened.get_future();
+    worker = std::thread([this, &opened] { run(opened); });
+    if (!result.get()) {
+        worker.join();
+        running = false;
+        backend.reset();
+        return false;
+    }
+    return true;
+}
+
+void SpeechWorker::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        running = false;
+        queue.clear();
+    }
+    wake.notify_one();
+    worker.join();
+    backend.reset();
+    speaking = false;
+}
+
+void SpeechWorker::speak(const std::string& text, bool interrupt) {
+    if (text.empty()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        if (interrupt) {
+            queue.clear();
+            cancel_requested = true;
+        }
+        queue.push_back(text);
+        while (queue.size() > MAX_QUEUED) {
+            queue.pop_front();
+        }
+        speaking = true;
+    }
+    wake.notify_one();
+}
+
+void SpeechWorker::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) return;
+        queue.clear();
+        cancel_requested = true;
+    }
+    wake.notify_one();
+}
+
+void SpeechWorker::run(std::promise<bool>& opened) {
+    bool ok = backend->openVoice();
+    opened.set_value(ok);
+    if (!ok) return;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+        if (cancel_requested) {
+            cancel_requested = false;
+            lock.unlock();
+            backend->silence();
+            lock.lock();
+            continue;
+        }
+        bool busy = backend->busy();
+        if (!queue.empty() && !busy) {
+            std::string text = std::move(queue.front());
+            queue.pop_front();
+            lock.unlock();
+            backend->say(text);
+            lock.lock();
+            continue;
+        }
+        speaking = busy || !queue.empty();
+        if (busy) {
+            wake.wait_for(lock, BUSY_POLL_INTERVAL);
+        } else {
+            wake.wait(lock);
+        }
+    }
+    lock.unlock();
+    backend->silence();
+    backend->closeVoice();
+}
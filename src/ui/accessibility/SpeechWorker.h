@@ -0,0 +1,62 @@
+#ifndef SPEECHWORKER_H
+#define SPEECHWORKER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// One long-lived speech synthesizer driven from a worker thread, so the UI
+// thread only queues text. Backends:
+//   Windows  SAPI voice (ISpVoice), created on the worker thread
+//   macOS    a Speech Synthesis Manager channel
+//   Linux    speech-dispatcher when built with it (VERSEFINDER_USE_SPEECHD),
+//            otherwise one espeak-ng / espeak process fed a line per utterance
+//            and restarted only after an interruption
+// Text is handed over as data, never through a shell. The queue keeps the
+// newest MAX_QUEUED utterances, so fast keyboard navigation speaks where the
+// user is rather than where they were.
+class SpeechWorker {
+public:
+    static constexpr size_t MAX_QUEUED = 8;
+
+    SpeechWorker();
+    ~SpeechWorker();
+
+    SpeechWorker(const SpeechWorker&) = delete;
+    SpeechWorker& operator=(const SpeechWorker&) = delete;
+
+    // Whether this platform has a synthesizer to drive, without starting it
+    static bool isAvailable();
+
+    // Opens the backend on the worker thread; false if there is none
+    bool start();
+    void stop();
+
+    // interrupt drops everything queued and cuts off the current utterance
+    void speak(const std::string& text, bool interrupt);
+    void cancel();
+    // Queued or still being spoken (on Linux without speech-dispatcher, only
+    // until it is handed to the synthesizer)
+    bool isSpeaking() const { return speaking.load(); }
+
+private:
+    struct Backend;
+
+    std::unique_ptr<Backend> backend;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::string> queue;
+    bool cancel_requested = false;
+    bool running = false;
+    std::atomic<bool> speaking{false};
+
+    void run(std::promise<bool>& opened);
+};
+
+#endif // SPEECHWORKER_H
@@ -0,0 +1,242 @@
+#include "VoiceWorker.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+
+namespace {
+
+constexpr const char* RECOGNIZER_VARIABLE = "VERSEFINDER_VOICE_RECOGNIZER";
+
+struct Phrase {
+    const char* words; // lowercase, space separated, matched as whole words
+    VoiceCommand command;
+    bool takes_argument;
+};
+
+// In priority order: the first phrase found in a hypothesis decides it
+constexpr Phrase PHRASES[] = {
+    {"search", VoiceCommand::SEARCH_VERSE, true},
+    {"find", VoiceCommand::SEARCH_VERSE, true},
+    {"go to", VoiceCommand::SEARCH_VERSE, true},
+    {"next verse", VoiceCommand::NEXT_VERSE, false},
+    {"previous verse", VoiceCommand::PREVIOUS_VERSE, false},
+    {"next chapter", VoiceCommand::NEXT_CHAPTER, false},
+    {"previous chapter", VoiceCommand::PREVIOUS_CHAPTER, false},
+    {"presentation", VoiceCommand::PRESENTATION_MODE, false},
+    {"present", VoiceCommand::PRESENTATION_MODE, false},
+    {"blank", VoiceCommand::BLANK_SCREEN, false},
+    {"show verse", VoiceCommand::SHOW_VERSE, false},
+    {"help", VoiceCommand::HELP, false},
+    {"settings", VoiceCommand::SETTINGS, false},
+};
+
+// " words like these " from whatever the recognizer printed, so phrases
+// match whole words whatever the case and punctuation
+std::string normalized(std::string_view text) {
+    std::string words = " ";
+    for (char c : text) {
+        auto byte = static_cast<unsigned char>(c);
+        if (std::isalnum(byte)) {
+            words += static_cast<char>(std::tolower(byte));
+        } else if (words.back() != ' ') {
+            words += ' ';
+        }
+    }
+    if (words.back() != ' ') words += ' ';
+    return words;
+}
+
+} // namespace
+
+VoiceWorker::VoiceWorker() = default;
+
+VoiceWorker::~VoiceWorker() {
+    stop();
+}
+
+bool VoiceWorker::isAvailable() {
+    const char* command = std::getenv(RECOGNIZER_VARIABLE);
+    return command && *command;
+}
+
+VoiceCommand VoiceWorker::spot(std::string_view hypothesis, bool final) {
+    std::string words = normalized(hypothesis);
+    for (const Phrase& phrase : PHRASES) {
+        std::string needle = std::string(" ") + phrase.words + " ";
+        if (words.find(needle) != std::string::npos) {
+            return phrase.takes_argument && !final ? VoiceCommand::UNKNOWN : phrase.command;
+        }
+    }
+    return VoiceCommand::UNKNOWN;
+}
+
+bool VoiceWorker::start(std::function<void()> wake_callback) {
+    if (worker.joinable()) {
+        return true;
+    }
+    const char* command = std::getenv(RECOGNIZER_VARIABLE);
+    if (!command || !*command || !launch(command)) {
+        return false;
+    }
+    wake = std::move(wake_callback);
+    stopping = false;
+    running = true;
+    worker = std::thread([this] { run(); });
+    return true;
+}
+
+void VoiceWorker::stop() {
+    if (!worker.joinable()) {
+        return;
+    }
+    // Ending the recognizer closes its output, which ends the worker's read
+    stopping = true;
+#ifdef _WIN32
+    TerminateProcess(static_cast<HANDLE>(process), 0);
+    worker.join();
+    CloseHandle(static_cast<HANDLE>(process));
+    CloseHandle(static_cast<HANDLE>(output));
+    process = output = nullptr;
+#else
+    kill(pid, SIGKILL);
+    worker.join();
+    waitpid(pid, nullptr, 0);
+    ::close(output);
+    pid = -1;
+    output = -1;
+#endif
+    running = false;
+}
+
+bool VoiceWorker::poll(Recognition& result) {
+    return results.pop(result);
+}
+
+#ifdef _WIN32
+
+bool VoiceWorker::launch(const std::string& command_line) {
+    SECURITY_ATTRIBUTES inherit{sizeof(SECURITY_ATTRIBUTES), nullptr, TRUE};
+    HANDLE read_end = nullptr, write_end = nullptr;
+    if (!CreatePipe(&read_end, &write_end, &inherit, 0)) return false;
+    SetHandleInformation(read_end, HANDLE_FLAG_INHERIT, 0);
+
+    STARTUPINFOA startup{};
+    startup.cb = sizeof(startup);
+    startup.dwFlags = STARTF_USESTDHANDLES;
+    startup.hStdOutput = write_end;
+    PROCESS_INFORMATION info{};
+    std::string mutable_line = command_line; // CreateProcessA may write to it
+    BOOL created = CreateProcessA(nullptr, mutable_line.data(), nullptr, nullptr, TRUE, CREATE_NO_WINDOW,
+                                  nullptr, nullptr, &startup, &info);
+    CloseHandle(write_end);
+    if (!created) {
+        std::cerr << "Cannot start voice recognizer " << command_line << std::endl;
+        CloseHandle(read_end);
+        return false;
+    }
+    CloseHandle(info.hThread);
+    process = info.hProcess;
+    output = read_end;
+    return true;
+}
+
+#else
+
+bool VoiceWorker::launch(const std::string& command_line) {
+    // Program and arguments split on spaces; there is no shell to quote for
+    std::vector<std::string> words;
+    size_t start = 0;
+    while ((start = command_line.find_first_not_of(" \t", start)) != std::string::npos) {
+        size_t end = command_line.find_first_of(" \t", start);
+        words.push_back(command_line.substr(start, end - start));
+        start = end;
+    }
+    std::vector<char*> argv;
+    for (auto& word : words) argv.push_back(word.data());
+    argv.push_back(nullptr);
+
+    int fds[2];
+    if (pipe(fds) != 0) return false;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, fds[1]);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+    int result = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    ::close(fds[1]);
+    if (result != 0) {
+        std::cerr << "Cannot start voice recognizer " << argv[0] << ": " << std::strerror(result) << std::endl;
+        ::close(fds[0]);
+        pid = -1;
+        return false;
+    }
+    output = fds[0];
+    return true;
+}
+
+#endif
+
+void VoiceWorker::run() {
+    std::string pending; // output up to the end of a line
+    uint32_t fired = 0;  // commands sent for the utterance under way, by bit
+    char buffer[4096];
+    for (;;) {
+#ifdef _WIN32
+        DWORD count = 0;
+        if (!ReadFile(static_cast<HANDLE>(output), buffer, sizeof(buffer), &count, nullptr) || count == 0) break;
+#else
+        ssize_t count = read(output, buffer, sizeof(buffer));
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) break;
+#endif
+        pending.append(buffer, static_cast<size_t>(count));
+        size_t line_end;
+        while ((line_end = pending.find('\n')) != std::string::npos) {
+            std::string line = pending.substr(0, line_end);
+            pending.erase(0, line_end + 1);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (!line.empty()) hear(line, fired);
+        }
+    }
+    if (!stopping) {
+        std::cerr << "Voice recognizer exited" << std::endl;
+    }
+    running = false;
+}
+
+void VoiceWorker::hear(const std::string& line, uint32_t& fired) {
+    bool partial = line[0] == '~';
+    std::string_view text = std::string_view(line).substr(partial ? 1 : 0);
+    VoiceCommand command = spot(text, !partial);
+    uint32_t bit = 1u << static_cast<uint32_t>(command);
+    if (command != VoiceCommand::UNKNOWN && !(fired & bit)) {
+        fired |= bit;
+        Recognition recognition{command, std::string(text), std::chrono::steady_clock::now()};
+        if (!results.push(std::move(recognition))) {
+            std::cerr << "Voice command dropped: the frame loop is not draining them" << std::endl;
+        } else if (wake) {
+            wake();
+        }
+    }
+    if (!partial) {
+        fired = 0; // the utterance is over
+    }
+}
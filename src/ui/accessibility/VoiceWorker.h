@@ -0,0 +1,91 @@
+#ifndef VOICEWORKER_H
+#define VOICEWORKER_H
+
+#include "../../core/MpscQueue.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+#ifndef _WIN32
+#include <sys/types.h>
+#endif
+
+enum class VoiceCommand {
+    SEARCH_VERSE,
+    NEXT_VERSE,
+    PREVIOUS_VERSE,
+    NEXT_CHAPTER,
+    PREVIOUS_CHAPTER,
+    PRESENTATION_MODE,
+    BLANK_SCREEN,
+    SHOW_VERSE,
+    HELP,
+    SETTINGS,
+    UNKNOWN
+};
+
+// Voice commands recognized on a thread of their own, so the frame loop only
+// takes finished results off a lock-free queue. Capture and recognition are
+// a streaming recognizer process named by VERSEFINDER_VOICE_RECOGNIZER (a
+// program and its arguments, run without a shell) that owns the microphone
+// and prints a line per hypothesis: "~text" while an utterance is still
+// being heard, each replacing the last, then the final "text".
+//
+// Commands are spotted in every hypothesis as it arrives. One without an
+// argument ("next verse", "blank screen") fires from the first partial that
+// holds its words, without waiting for the silence that ends the utterance;
+// one with an argument ("go to John 3 16") waits for the final transcript.
+// Each command fires at most once per utterance.
+class VoiceWorker {
+public:
+    static constexpr size_t QUEUE_CAPACITY = 16;
+
+    struct Recognition {
+        VoiceCommand command = VoiceCommand::UNKNOWN;
+        std::string transcript;
+        std::chrono::steady_clock::time_point heard_at; // when the hypothesis arrived
+    };
+
+    VoiceWorker();
+    ~VoiceWorker();
+
+    VoiceWorker(const VoiceWorker&) = delete;
+    VoiceWorker& operator=(const VoiceWorker&) = delete;
+
+    // Whether a recognizer is configured, without starting it
+    static bool isAvailable();
+    // The command hypothesis asks for; one taking an argument only once final
+    static VoiceCommand spot(std::string_view hypothesis, bool final);
+
+    // Starts the recognizer; wake runs on the worker after each result is
+    // queued, to bring the frame loop round. False if it cannot run.
+    bool start(std::function<void()> wake);
+    void stop();
+    bool isRunning() const { return running.load(); }
+
+    // Frame loop only; false if nothing has been recognized since
+    bool poll(Recognition& result);
+
+private:
+    MpscQueue<Recognition> results{QUEUE_CAPACITY};
+    std::function<void()> wake;
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<bool> stopping{false};
+#ifdef _WIN32
+    void* process = nullptr; // HANDLE
+    void* output = nullptr;  // HANDLE, the read end of its stdout
+#else
+    pid_t pid = -1;
+    int output = -1;
+#endif
+
+    bool launch(const std::string& command_line);
+    void run();
+    // Spots commands in one line of recognizer output
+    void hear(const std::string& line, uint32_t& fired);
+};
+
+#endif // VOICEWORKER_H
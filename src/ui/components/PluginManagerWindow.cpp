@@ -16,6 +16,13 @@ void PluginManagerWindow::render(bool* open) {
     ImGui::SetNextWindowSize(ImVec2(800, 600), ImGuiCond_FirstUseEver);
     
     if (ImGui::Begin("Plugin Manager", open)) {
+        // With the window open plugins are likely being rebuilt and reloaded;
+        // have their new builds checked before Reload asks for them
+        if (ImGui::GetTime() - last_verification_refresh > 2.0) {
+            last_verification_refresh = ImGui::GetTime();
+            plugin_manager->refreshPluginVerifications();
+        }
+        
         // Top toolbar
         if (ImGui::Button("Refresh")) {
             refresh();
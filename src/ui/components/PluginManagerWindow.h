@@ -19,6 +19,7 @@ private:
     bool show_plugin_details = false;
     bool show_install_dialog = false;
     bool show_uninstall_dialog = false;
+    double last_verification_refresh = 0.0; // ImGui time
     
     // Plugin installation
     char install_file_path[512] = "";
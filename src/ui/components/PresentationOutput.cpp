@@ -0,0 +1,303 @@
+// OpenGL loader - must be included before GLFW
+#ifdef IMGUI_IMPL_OPENGL_LOADER_GLEW
+#include <GL/glew.h>
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+#include <GL/gl3w.h>
+#else
+#include "../../opengl_loader.h"
+#endif
+
+#include "PresentationOutput.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+uint64_t microsecondsSinceEpoch(std::chrono::steady_clock::time_point time) {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count());
+}
+
+#ifdef _WIN32
+std::string sharedName(const std::string& name) { return "Local\\" + name; }
+#else
+std::string sharedName(const std::string& name) { return "/" + name; }
+#endif
+
+} // namespace
+
+PresentationOutput::~PresentationOutput() {
+    close();
+}
+
+bool PresentationOutput::open(const std::string& output_name, bool keyed_output) {
+    close();
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+    std::cerr << "Presentation output needs OpenGL 3.2 fences; not available in this build" << std::endl;
+    return false;
+#else
+    if (output_name.empty() || output_name.find_first_of("/\\") != std::string::npos) {
+        std::cerr << "Presentation output name must be a plain name: " << output_name << std::endl;
+        return false;
+    }
+    name = output_name;
+    keyed = keyed_output;
+    for (Readback& readback : readbacks) {
+        readback = Readback();
+        glGenBuffers(1, &readback.buffer);
+    }
+    std::cout << "Publishing presentation frames" << (keyed ? " (keyed)" : "") << " to shared memory "
+              << sharedName(name) << std::endl;
+    return true;
+#endif
+}
+
+void PresentationOutput::close() {
+    if (!isOpen()) return;
+#ifdef GL_SYNC_GPU_COMMANDS_COMPLETE
+    for (Readback& readback : readbacks) {
+        if (readback.fence) glDeleteSync(static_cast<GLsync>(readback.fence));
+        if (readback.buffer) glDeleteBuffers(1, &readback.buffer);
+        readback = Readback();
+    }
+#endif
+    releaseTarget();
+    unmapRing();
+    next_readback = 0;
+    oldest_pending = 0;
+    pending_count = 0;
+    std::cout << "Presentation output " << name << " closed after " << published << " frame(s), "
+              << dropped << " dropped" << std::endl;
+    name.clear();
+}
+
+void PresentationOutput::captureWindow(int width, int height) {
+    if (!isOpen() || keyed || width <= 0 || height <= 0) return;
+    glReadBuffer(GL_BACK);
+    startReadback(width, height, FLAG_BOTTOM_UP);
+}
+
+bool PresentationOutput::beginFrame(int width, int height) {
+    if (!isOpen() || width <= 0 || height <= 0) return false;
+    if (pending_count == READBACKS) {
+        // The GPU is behind; skip drawing a frame there is nowhere to copy
+        ++dropped;
+        return false;
+    }
+
+    if (width != target_width || height != target_height) {
+        releaseTarget();
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "Presentation output " << name << " framebuffer incomplete; frames dropped" << std::endl;
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            releaseTarget();
+            return false;
+        }
+        target_width = width;
+        target_height = height;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, width, height);
+    return true;
+}
+
+void PresentationOutput::endFrame() {
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    uint32_t flags = keyed ? FLAG_BOTTOM_UP | FLAG_PREMULTIPLIED | FLAG_KEYED : FLAG_BOTTOM_UP;
+    startReadback(target_width, target_height, flags);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void PresentationOutput::startReadback(int width, int height, uint32_t flags) {
+#ifdef GL_SYNC_GPU_COMMANDS_COMPLETE
+    if (pending_count == READBACKS) {
+        ++dropped;
+        return;
+    }
+    Readback& readback = readbacks[next_readback];
+    size_t bytes = static_cast<size_t>(width) * height * 4;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+    if (readback.capacity != bytes) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_READ);
+        readback.capacity = bytes;
+    }
+    // Into the buffer, not client memory: the call returns without waiting for the GPU
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    readback.width = width;
+    readback.height = height;
+    readback.flags = flags;
+    readback.drawn_at = std::chrono::steady_clock::now();
+    next_readback = (next_readback + 1) % READBACKS;
+    ++pending_count;
+#else
+    (void)width;
+    (void)height;
+    (void)flags;
+#endif
+}
+
+void PresentationOutput::publishReady() {
+#ifdef GL_SYNC_GPU_COMMANDS_COMPLETE
+    while (pending_count > 0) {
+        Readback& readback = readbacks[oldest_pending];
+        GLint status = GL_UNSIGNALED;
+        glGetSynciv(static_cast<GLsync>(readback.fence), GL_SYNC_STATUS, 1, nullptr, &status);
+        if (status != GL_SIGNALED) break;
+        glDeleteSync(static_cast<GLsync>(readback.fence));
+        readback.fence = nullptr;
+        oldest_pending = (oldest_pending + 1) % READBACKS;
+        --pending_count;
+
+        uint64_t bytes = static_cast<uint64_t>(readback.width) * readback.height * 4;
+        if (!mapRing(bytes)) {
+            ++dropped;
+            continue;
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+        const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes), GL_MAP_READ_BIT);
+        if (pixels) {
+            uint64_t frame = ++sequence;
+            unsigned char* destination = slot(static_cast<uint32_t>(frame % SLOTS));
+            auto* slot_header = reinterpret_cast<SlotHeader*>(destination);
+
+            // Odd while written, so a reader copying meanwhile throws its copy away
+            slot_header->sequence.store(frame * 2 - 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            slot_header->timestamp_us = microsecondsSinceEpoch(readback.drawn_at);
+            slot_header->width = static_cast<uint32_t>(readback.width);
+            slot_header->height = static_cast<uint32_t>(readback.height);
+            slot_header->stride = static_cast<uint32_t>(readback.width) * 4;
+            slot_header->flags = readback.flags;
+            std::memcpy(destination + SLOT_HEADER_BYTES, pixels, bytes);
+            slot_header->sequence.store(frame * 2, std::memory_order_release);
+            header()->latest.store(frame, std::memory_order_release);
+            ++published;
+        } else {
+            ++dropped;
+        }
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+#endif
+}
+
+bool PresentationOutput::mapRing(uint64_t capacity) {
+    if (mapping && capacity <= slot_capacity) return true;
+    // Frames only outgrow the ring when the display does; readers follow retired to the new one
+    unmapRing();
+
+    size_t size = RING_HEADER_BYTES + SLOTS * (SLOT_HEADER_BYTES + capacity);
+    std::string shared_name = sharedName(name);
+#ifdef _WIN32
+    HANDLE handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                       static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+                                       static_cast<DWORD>(size & 0xFFFFFFFFu), shared_name.c_str());
+    if (!handle) {
+        std::cerr << "Cannot create presentation output " << shared_name << std::endl;
+        return false;
+    }
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        // A reader still holds the old ring, at its old size; try again next frame
+        CloseHandle(handle);
+        return false;
+    }
+    void* view = MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!view) {
+        CloseHandle(handle);
+        std::cerr << "Cannot map presentation output " << shared_name << std::endl;
+        return false;
+    }
+    mapping_handle = handle;
+#else
+    // A ring left by an earlier run is replaced, not reused
+    shm_unlink(shared_name.c_str());
+    int fd = shm_open(shared_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "Cannot create presentation output " << shared_name << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        std::cerr << "Cannot size presentation output " << shared_name << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        shm_unlink(shared_name.c_str());
+        return false;
+    }
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        std::cerr << "Cannot map presentation output " << shared_name << ": " << std::strerror(errno) << std::endl;
+        shm_unlink(shared_name.c_str());
+        return false;
+    }
+#endif
+
+    mapping = view;
+    mapping_size = size;
+    slot_capacity = capacity;
+
+    auto* ring = new (mapping) RingHeader{};
+    std::memcpy(ring->magic, MAGIC, sizeof(ring->magic));
+    ring->version = VERSION;
+    ring->slot_count = SLOTS;
+    ring->slot_capacity = capacity;
+    for (uint32_t i = 0; i < SLOTS; ++i) {
+        new (slot(i)) SlotHeader{};
+    }
+    // Readers may start at latest, so it is published last
+    ring->latest.store(sequence, std::memory_order_release);
+    return true;
+}
+
+void PresentationOutput::unmapRing() {
+    if (!mapping) return;
+    header()->retired.store(1, std::memory_order_release);
+#ifdef _WIN32
+    UnmapViewOfFile(mapping);
+    CloseHandle(static_cast<HANDLE>(mapping_handle));
+    mapping_handle = nullptr;
+#else
+    munmap(mapping, mapping_size);
+    shm_unlink(sharedName(name).c_str());
+#endif
+    mapping = nullptr;
+    mapping_size = 0;
+    slot_capacity = 0;
+}
+
+void PresentationOutput::releaseTarget() {
+    if (framebuffer) glDeleteFramebuffers(1, &framebuffer);
+    if (texture) glDeleteTextures(1, &texture);
+    framebuffer = 0;
+    texture = 0;
+    target_width = 0;
+    target_height = 0;
+}
+
+unsigned char* PresentationOutput::slot(uint32_t index) const {
+    return static_cast<unsigned char*>(mapping) + RING_HEADER_BYTES + index * (SLOT_HEADER_BYTES + slot_capacity);
+}
@@ -0,0 +1,139 @@
+#ifndef PRESENTATION_OUTPUT_H
+#define PRESENTATION_OUTPUT_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Publishes the presentation display's frames to other programs (an OBS or
+// vMix source, a stream encoder) through a named shared-memory ring, so they
+// need not capture the screen. Frames are read back from the GPU
+// asynchronously: each is copied into a pixel buffer when drawn and into the
+// ring a frame or two later, once the copy has finished, so the render
+// thread never waits on it.
+//
+// An output the size and layout of the window reads the window's frame
+// back as it is; any other is drawn into a target of its own. A keyed
+// output has the text alone over transparency, for lower thirds; its pixels
+// carry premultiplied alpha.
+//
+// Lives on the presentation render thread, with its GL context current.
+//
+// Ring layout, for readers: a RingHeader padded to RING_HEADER_BYTES, then
+// slot_count slots, each a SlotHeader padded to SLOT_HEADER_BYTES followed
+// by slot_capacity bytes of RGBA8 pixels, rows stride bytes apart. To read
+// the newest frame, take latest, read slot latest % slot_count, and keep it
+// only if its sequence was latest * 2 both before and after copying the
+// pixels. Once retired is set the writer has moved to a new ring under the
+// same name (after the display grew, say), which must be opened again.
+class PresentationOutput {
+public:
+    static constexpr uint32_t SLOTS = 3;
+    static constexpr size_t READBACKS = 3;  // frames the GPU copy may lag
+    static constexpr size_t RING_HEADER_BYTES = 64;
+    static constexpr size_t SLOT_HEADER_BYTES = 64;
+    static constexpr uint32_t VERSION = 1;
+    static constexpr char MAGIC[8] = {'V', 'F', 'F', 'R', 'A', 'M', 'E', '1'};
+
+    enum Flags : uint32_t {
+        FLAG_BOTTOM_UP = 1,     // first row is the bottom of the picture, as GL reads it
+        FLAG_PREMULTIPLIED = 2, // color already multiplied by alpha
+        FLAG_KEYED = 4          // text only, over transparency
+    };
+
+    struct RingHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t slot_count;
+        uint64_t slot_capacity;         // pixel bytes per slot
+        std::atomic<uint64_t> latest;   // newest complete frame; 0 before the first
+        std::atomic<uint32_t> retired;
+    };
+
+    struct SlotHeader {
+        std::atomic<uint64_t> sequence; // frame * 2 when complete, odd while written
+        uint64_t timestamp_us;          // steady clock when the frame was drawn
+        uint32_t width;
+        uint32_t height;
+        uint32_t stride;
+        uint32_t flags;
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "ring counters are shared between processes");
+    static_assert(sizeof(RingHeader) <= RING_HEADER_BYTES, "ring header outgrew its padding");
+    static_assert(sizeof(SlotHeader) <= SLOT_HEADER_BYTES, "slot header outgrew its padding");
+
+    PresentationOutput() = default;
+    ~PresentationOutput();
+
+    PresentationOutput(const PresentationOutput&) = delete;
+    PresentationOutput& operator=(const PresentationOutput&) = delete;
+
+    // name is the shared memory's: "versefinder-presentation" is opened as
+    // /versefinder-presentation (POSIX) or Local\versefinder-presentation
+    bool open(const std::string& name, bool keyed);
+    void close();
+    bool isOpen() const { return !name.empty(); }
+    bool isKeyed() const { return keyed; }
+
+    // The window's back buffer, just drawn, is the frame
+    void captureWindow(int width, int height);
+    // The frame is drawn between these into the output's own target, bound
+    // by beginFrame; false if there is none, and nothing should be drawn
+    bool beginFrame(int width, int height);
+    void endFrame();
+
+    // Copies readbacks that have finished into the ring
+    void publishReady();
+    bool hasPendingFrames() const { return pending_count > 0; }
+
+    uint64_t framesPublished() const { return published; }
+    uint64_t framesDropped() const { return dropped; }
+
+private:
+    struct Readback {
+        unsigned int buffer = 0;
+        size_t capacity = 0;    // bytes allocated to buffer
+        void* fence = nullptr;  // GLsync
+        int width = 0;
+        int height = 0;
+        uint32_t flags = 0;
+        std::chrono::steady_clock::time_point drawn_at;
+    };
+
+    std::string name;
+    bool keyed = false;
+
+    // Shared memory
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+    uint64_t slot_capacity = 0;
+#ifdef _WIN32
+    void* mapping_handle = nullptr;
+#endif
+    uint64_t sequence = 0;
+
+    // GL objects
+    std::array<Readback, READBACKS> readbacks{};
+    size_t next_readback = 0;   // where the next capture goes
+    size_t oldest_pending = 0;  // the next to publish
+    size_t pending_count = 0;
+    unsigned int framebuffer = 0;
+    unsigned int texture = 0;
+    int target_width = 0;
+    int target_height = 0;
+
+    uint64_t published = 0;
+    uint64_t dropped = 0;
+
+    bool mapRing(uint64_t capacity);
+    void unmapRing();
+    void startReadback(int width, int height, uint32_t flags);
+    void releaseTarget();
+    RingHeader* header() const { return static_cast<RingHeader*>(mapping); }
+    unsigned char* slot(uint32_t index) const;
+};
+
+#endif // PRESENTATION_OUTPUT_H
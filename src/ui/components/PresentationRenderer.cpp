@@ -0,0 +1,586 @@
+// OpenGL loader - must be included before GLFW
+#ifdef IMGUI_IMPL_OPENGL_LOADER_GLEW
+#include <GL/glew.h>
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+#include <GL/gl3w.h>
+#else
+#include "../../opengl_loader.h"
+#endif
+
+#include "PresentationRenderer.h"
+#include <imgui_impl_opengl3.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+// Current ImGui context of each thread; see ImGuiThreadConfig.h
+thread_local ImGuiContext* ImGuiThreadContext = nullptr;
+
+namespace {
+
+bool sameColor(const ImVec4& a, const ImVec4& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+}
+
+ImVec4 withAlpha(ImVec4 color, float alpha) {
+    color.w *= alpha;
+    return color;
+}
+
+// Left edge that aligns a line of width text_width within the padded area
+float alignedX(const PresentationRenderer::Style& style, float padding, float available_width, float text_width) {
+    if (text_width >= available_width) return padding;
+    if (style.alignment == "center") return padding + (available_width - text_width) / 2;
+    if (style.alignment == "right") return padding + available_width - text_width;
+    return padding;
+}
+
+// Keyed slides hold premultiplied color, which ImGui's blending would multiply again
+void premultipliedBlend([[maybe_unused]] const ImDrawList* draw_list, [[maybe_unused]] const ImDrawCmd* cmd) {
+    glBlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+} // namespace
+
+bool PresentationRenderer::Style::operator==(const Style& other) const {
+    return font_size == other.font_size && sameColor(background, other.background) &&
+           sameColor(text, other.text) && sameColor(reference, other.reference) &&
+           show_reference == other.show_reference && alignment == other.alignment &&
+           padding == other.padding && fade_seconds == other.fade_seconds;
+}
+
+PresentationRenderer::~PresentationRenderer() {
+    stop();
+}
+
+bool PresentationRenderer::start(GLFWwindow* target, const std::string& font, const Style& style) {
+    if (isRunning() || !target) return false;
+
+    window = target;
+    font_path = font;
+    scene = Scene();
+    scene.style = style;
+    glfwGetFramebufferSize(window, &scene.width, &scene.height);
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = false;
+    }
+
+    glfwSetWindowUserPointer(window, this);
+    glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
+    glfwSetWindowRefreshCallback(window, refreshCallback);
+
+    // A context can only be current on one thread at a time
+    if (glfwGetCurrentContext() == window) {
+        glfwMakeContextCurrent(nullptr);
+    }
+    render_thread = std::thread(&PresentationRenderer::renderLoop, this);
+    return true;
+}
+
+void PresentationRenderer::stop() {
+    if (!isRunning()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        stopping = true;
+        commands.clear();
+    }
+    queue_ready.notify_one();
+    render_thread.join();
+
+    glfwSetFramebufferSizeCallback(window, nullptr);
+    glfwSetWindowRefreshCallback(window, nullptr);
+    glfwSetWindowUserPointer(window, nullptr);
+    window = nullptr;
+}
+
+void PresentationRenderer::post(Command command) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        commands.push_back(std::move(command));
+    }
+    queue_ready.notify_one();
+}
+
+void PresentationRenderer::displayVerse(const std::string& text, const std::string& reference) {
+    post([text, reference](Scene& scene) {
+        // The outgoing slide fades out under the new one
+        bool showing = !scene.blank && !scene.shown.verse.empty();
+        scene.previous = showing ? scene.shown : Slide();
+        scene.shown = Slide{text, reference};
+        scene.blank = false;
+        scene.shown_at = std::chrono::steady_clock::now();
+        scene.dirty = true;
+    });
+}
+
+void PresentationRenderer::clear() {
+    post([](Scene& scene) {
+        scene.shown = Slide();
+        scene.previous = Slide();
+        scene.dirty = true;
+    });
+}
+
+void PresentationRenderer::setBlank(bool blank) {
+    post([blank](Scene& scene) {
+        scene.blank = blank;
+        scene.previous = Slide();
+        scene.dirty = true;
+    });
+}
+
+void PresentationRenderer::setStyle(const Style& style) {
+    post([style](Scene& scene) {
+        scene.style = style;
+        scene.dirty = true;
+    });
+}
+
+void PresentationRenderer::prefetch(std::vector<Slide> slides) {
+    if (slides.size() > MAX_PREFETCHED) {
+        slides.resize(MAX_PREFETCHED);
+    }
+    post([slides = std::move(slides)](Scene& scene) { scene.upcoming = slides; });
+}
+
+void PresentationRenderer::setOutputs(std::vector<OutputTarget> targets) {
+    if (targets.size() > MAX_OUTPUTS) {
+        targets.resize(MAX_OUTPUTS);
+    }
+    post([this, targets = std::move(targets)](Scene& scene) {
+        // Unchanged outputs carry on; the rest close before any reopens their name
+        std::vector<Output> previous = std::move(outputs);
+        outputs.clear();
+        for (const OutputTarget& target : targets) {
+            auto same = std::find_if(previous.begin(), previous.end(), [&](const Output& output) {
+                return output.publisher && output.target == target;
+            });
+            if (same != previous.end()) outputs.push_back(std::move(*same));
+        }
+        previous.clear();
+
+        for (const OutputTarget& target : targets) {
+            bool taken = std::any_of(outputs.begin(), outputs.end(),
+                                     [&](const Output& output) { return output.target.name == target.name; });
+            if (taken) continue; // Kept above, or a second target under one name
+            Output output{target, std::make_unique<PresentationOutput>()};
+            if (output.publisher->open(target.name, target.keyed)) {
+                outputs.push_back(std::move(output));
+            }
+        }
+        scene.dirty = true; // Readers get a frame straight away
+    });
+}
+
+void PresentationRenderer::framebufferSizeCallback(GLFWwindow* window, int width, int height) {
+    auto* renderer = static_cast<PresentationRenderer*>(glfwGetWindowUserPointer(window));
+    if (!renderer) return;
+    renderer->post([width, height](Scene& scene) {
+        scene.width = width;
+        scene.height = height;
+        scene.dirty = true;
+    });
+}
+
+void PresentationRenderer::refreshCallback(GLFWwindow* window) {
+    auto* renderer = static_cast<PresentationRenderer*>(glfwGetWindowUserPointer(window));
+    if (!renderer) return;
+    renderer->post([](Scene& scene) { scene.dirty = true; });
+}
+
+float PresentationRenderer::fadeAlpha(const Scene& scene) {
+    if (scene.style.fade_seconds <= 0.0f) return 1.0f;
+    std::chrono::duration<float> shown = std::chrono::steady_clock::now() - scene.shown_at;
+    return std::clamp(shown.count() / scene.style.fade_seconds, 0.0f, 1.0f);
+}
+
+void PresentationRenderer::renderLoop() {
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(1); // One frame per display refresh while anything moves
+
+    ImGuiContext* context = ImGui::CreateContext();
+    ImGui::SetCurrentContext(context);
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.LogFilename = nullptr;
+
+    glyph_cache = GlyphCache();
+    if (!font_path.empty()) {
+        glyph_cache.addSource(font_path, FONT_PIXELS);
+    }
+    glyph_cache.pinRange(0x0020, 0x00FF); // Basic Latin + Latin Supplement
+    glyph_cache.pinRange(0x2000, 0x207F); // General Punctuation
+    if (!glyph_cache.build(io.Fonts)) {
+        io.Fonts->Clear();
+        ImFontConfig config;
+        config.SizePixels = FONT_PIXELS;
+        io.Fonts->AddFontDefault(&config);
+    }
+    ImGui_ImplOpenGL3_Init(nullptr);
+
+    auto last_frame = std::chrono::steady_clock::now();
+    while (true) {
+        std::deque<Command> pending;
+        {
+            // Sleep until something changes, unless a fade is still running
+            // or slides are waiting to be drawn ahead. Frames still being
+            // read back are checked for every millisecond meanwhile.
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            auto woken = [this] {
+                return stopping || !commands.empty() || scene.dirty || fadeAlpha(scene) < 1.0f ||
+                       nextToPrefetch(scene).slide != nullptr;
+            };
+            bool reading_back = std::any_of(outputs.begin(), outputs.end(),
+                                            [](const Output& output) { return output.publisher->hasPendingFrames(); });
+            if (reading_back) {
+                queue_ready.wait_for(lock, std::chrono::milliseconds(1), woken);
+            } else {
+                queue_ready.wait(lock, woken);
+            }
+            if (stopping) break;
+            pending.swap(commands);
+        }
+        for (auto& command : pending) {
+            command(scene);
+        }
+        pruneSlides(scene);
+        for (Output& output : outputs) {
+            output.publisher->publishReady();
+        }
+
+        if (scene.dirty || fadeAlpha(scene) < 1.0f) {
+            auto now = std::chrono::steady_clock::now();
+            std::chrono::duration<float> delta = now - last_frame;
+            last_frame = now;
+            drawScene(scene, delta.count());
+            scene.dirty = false;
+        } else if (Prefetch next = nextToPrefetch(scene); next.slide) {
+            // One slide per pass, so a command arriving meanwhile waits for one at most
+            slideTexture(scene, *next.slide, next.canvas);
+        }
+    }
+
+    outputs.clear(); // Closed while the context is current
+    releaseSlides();
+    ImGui_ImplOpenGL3_Shutdown();
+    ImGui::DestroyContext(context);
+    glfwMakeContextCurrent(nullptr);
+}
+
+void PresentationRenderer::beginFrame(int width, int height, float delta_seconds) {
+    ImGuiIO& io = ImGui::GetIO();
+    io.DisplaySize = ImVec2(static_cast<float>(width), static_cast<float>(height));
+    io.DeltaTime = delta_seconds > 0.0f ? delta_seconds : 1.0f / 60.0f;
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui::NewFrame();
+}
+
+void PresentationRenderer::drawScene(Scene& scene, float delta_seconds) {
+    const Style& style = scene.style;
+    float display_w = static_cast<float>(scene.width);
+    float display_h = static_cast<float>(scene.height);
+    float alpha = fadeAlpha(scene);
+
+    // Drawn ahead in the usual case; otherwise drawn now, before the frame
+    // starts, for the window and every output alike
+    bool showing = !scene.blank && !scene.shown.verse.empty();
+    Canvas window_canvas = sharedCanvas(scene, windowCanvas(scene));
+    unsigned int current = showing ? slideTexture(scene, scene.shown, window_canvas) : 0;
+    if (showing) {
+        for (const Output& output : outputs) {
+            slideTexture(scene, scene.shown, sharedCanvas(scene, outputCanvas(scene, output.target)));
+        }
+    }
+    const CachedSlide* previous = nullptr;
+    if (showing && alpha < 1.0f && !scene.previous.verse.empty()) {
+        previous = findSlide(scene, scene.previous, window_canvas);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, scene.width, scene.height);
+    glClearColor(style.background.x, style.background.y, style.background.z, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    beginFrame(scene.width, scene.height, delta_seconds);
+
+    // Slides are opaque, so drawing the new one over the old at the fade's
+    // alpha cross-fades them. Framebuffer textures are stored bottom-up.
+    ImDrawList* draw_list = ImGui::GetBackgroundDrawList();
+    ImVec2 top_left(0.0f, 0.0f);
+    ImVec2 bottom_right(display_w, display_h);
+    if (previous && previous->texture) {
+        draw_list->AddImage(reinterpret_cast<ImTextureID>(static_cast<intptr_t>(previous->texture)),
+                            top_left, bottom_right, ImVec2(0, 1), ImVec2(1, 0));
+    }
+    if (current) {
+        draw_list->AddImage(reinterpret_cast<ImTextureID>(static_cast<intptr_t>(current)), top_left, bottom_right,
+                            ImVec2(0, 1), ImVec2(1, 0), IM_COL32(255, 255, 255, static_cast<int>(alpha * 255.0f)));
+    } else if (showing) {
+        layoutSlide(style, scene.shown, windowCanvas(scene), 1.0f, alpha);
+    }
+
+    ImGui::Render();
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    // Queued before the swap, which may wait for vsync
+    for (Output& output : outputs) {
+        drawOutput(scene, output, alpha);
+    }
+    glViewport(0, 0, scene.width, scene.height);
+    glfwSwapBuffers(window);
+}
+
+void PresentationRenderer::drawOutput(const Scene& scene, Output& output, float alpha) {
+    const OutputTarget& target = output.target;
+    Canvas canvas = outputCanvas(scene, target);
+    if (canvas.width <= 0 || canvas.height <= 0) return;
+    if (canvas == windowCanvas(scene)) {
+        // Just what the window shows; its frame is read back as it is
+        output.publisher->captureWindow(canvas.width, canvas.height);
+        return;
+    }
+    if (!output.publisher->beginFrame(canvas.width, canvas.height)) return;
+
+    if (target.keyed) {
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    } else {
+        glClearColor(scene.style.background.x, scene.style.background.y, scene.style.background.z, 1.0f);
+    }
+    glClear(GL_COLOR_BUFFER_BIT);
+    beginFrame(canvas.width, canvas.height, 0.0f);
+
+    // Composited from the shared canvas's slides, scaled to this target
+    Canvas shared = sharedCanvas(scene, canvas);
+    bool showing = !scene.blank && !scene.shown.verse.empty();
+    const CachedSlide* current = showing ? findSlide(scene, scene.shown, shared) : nullptr;
+    const CachedSlide* previous = nullptr;
+    if (showing && alpha < 1.0f && !scene.previous.verse.empty()) {
+        previous = findSlide(scene, scene.previous, shared);
+    }
+
+    ImDrawList* draw_list = ImGui::GetBackgroundDrawList();
+    ImVec2 top_left(0.0f, 0.0f);
+    ImVec2 bottom_right(static_cast<float>(canvas.width), static_cast<float>(canvas.height));
+    auto composite = [&](const CachedSlide* slide, float opacity) {
+        if (!slide || !slide->texture) return;
+        int a = static_cast<int>(opacity * 255.0f);
+        // Premultiplied color fades with its alpha
+        ImU32 tint = target.keyed ? IM_COL32(a, a, a, a) : IM_COL32(255, 255, 255, a);
+        draw_list->AddImage(reinterpret_cast<ImTextureID>(static_cast<intptr_t>(slide->texture)), top_left,
+                            bottom_right, ImVec2(0, 1), ImVec2(1, 0), tint);
+    };
+    if (target.keyed) {
+        // No background hides the outgoing slide, so both fade
+        draw_list->AddCallback(premultipliedBlend, nullptr);
+        composite(previous, 1.0f - alpha);
+        composite(current, alpha);
+        draw_list->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+    } else {
+        composite(previous, 1.0f);
+        composite(current, alpha);
+    }
+
+    ImGui::Render();
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    output.publisher->endFrame();
+}
+
+void PresentationRenderer::layoutSlide(const Style& style, const Slide& slide, const Canvas& canvas, float scale,
+                                       float alpha) {
+    float width = static_cast<float>(canvas.width);
+    float height = static_cast<float>(canvas.height);
+    float padding = style.padding * scale;
+    // The band the text is centred in
+    float band_top = 0.0f;
+    float band_height = height;
+    if (canvas.layout == Layout::LOWER_THIRD) {
+        band_top = height * 2.0f / 3.0f;
+        band_height = height - band_top;
+    }
+
+    ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoMove |
+                             ImGuiWindowFlags_NoScrollWithMouse | ImGuiWindowFlags_NoBackground |
+                             ImGuiWindowFlags_NoBringToFrontOnFocus | ImGuiWindowFlags_NoNavFocus |
+                             ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoInputs;
+    ImGui::SetNextWindowPos(ImVec2(0, 0));
+    ImGui::SetNextWindowSize(ImVec2(width, height));
+
+    if (ImGui::Begin("PresentationDisplay", nullptr, flags)) {
+        float available_width = width - 2 * padding;
+        float available_height = band_height - 2 * padding;
+
+        ImGui::SetWindowFontScale(style.font_size * scale / ImGui::GetFontSize());
+
+        // Centre the verse and its reference vertically as one block
+        ImVec2 verse_size = ImGui::CalcTextSize(slide.verse.c_str(), nullptr, false, available_width);
+        bool show_reference = style.show_reference && !slide.reference.empty();
+        ImVec2 reference_size = show_reference ? ImGui::CalcTextSize(slide.reference.c_str()) : ImVec2(0, 0);
+        float total_height = verse_size.y + (show_reference ? reference_size.y + 20 : 0.0f);
+        float start_y = std::max(0.0f, (available_height - total_height) / 2);
+
+        ImGui::SetCursorPos(ImVec2(alignedX(style, padding, available_width, verse_size.x), band_top + padding + start_y));
+        ImGui::PushTextWrapPos(padding + available_width);
+        ImGui::PushStyleColor(ImGuiCol_Text, withAlpha(style.text, alpha));
+        ImGui::TextUnformatted(slide.verse.c_str());
+        ImGui::PopStyleColor();
+        ImGui::PopTextWrapPos();
+
+        if (show_reference) {
+            ImGui::Spacing();
+            ImGui::SetCursorPosX(alignedX(style, padding, available_width, reference_size.x));
+            ImGui::PushStyleColor(ImGuiCol_Text, withAlpha(style.reference, alpha));
+            ImGui::TextUnformatted(slide.reference.c_str());
+            ImGui::PopStyleColor();
+        }
+    }
+    ImGui::End();
+}
+
+float PresentationRenderer::canvasScale(const Scene& scene, const Canvas& canvas) {
+    return scene.height > 0 ? static_cast<float>(canvas.height) / static_cast<float>(scene.height) : 1.0f;
+}
+
+PresentationRenderer::Canvas PresentationRenderer::windowCanvas(const Scene& scene) const {
+    return Canvas{Layout::FULL, false, scene.width, scene.height};
+}
+
+PresentationRenderer::Canvas PresentationRenderer::outputCanvas(const Scene& scene, const OutputTarget& target) const {
+    bool own_size = target.width > 0 && target.height > 0;
+    return Canvas{target.layout, target.keyed, own_size ? target.width : scene.width,
+                  own_size ? target.height : scene.height};
+}
+
+PresentationRenderer::Canvas PresentationRenderer::sharedCanvas(const Scene& scene, const Canvas& canvas) const {
+    Canvas best = canvas;
+    auto consider = [&](const Canvas& other) {
+        if (other.layout != canvas.layout || other.keyed != canvas.keyed || other.width <= best.width) return;
+        // The same shape to within half a percent, so text wraps alike
+        int64_t cross = static_cast<int64_t>(other.width) * canvas.height - static_cast<int64_t>(canvas.width) * other.height;
+        if (std::abs(cross) * 200 > static_cast<int64_t>(canvas.width) * other.height) return;
+        best = other;
+    };
+    consider(windowCanvas(scene));
+    for (const Output& output : outputs) {
+        consider(outputCanvas(scene, output.target));
+    }
+    return best;
+}
+
+std::vector<PresentationRenderer::Canvas> PresentationRenderer::canvasesInUse(const Scene& scene) const {
+    std::vector<Canvas> canvases;
+    auto use = [&](const Canvas& canvas) {
+        if (canvas.width <= 0 || canvas.height <= 0) return;
+        Canvas shared = sharedCanvas(scene, canvas);
+        if (std::find(canvases.begin(), canvases.end(), shared) == canvases.end()) {
+            canvases.push_back(shared);
+        }
+    };
+    use(windowCanvas(scene));
+    for (const Output& output : outputs) {
+        use(outputCanvas(scene, output.target));
+    }
+    return canvases;
+}
+
+const PresentationRenderer::CachedSlide* PresentationRenderer::findSlide(const Scene& scene, const Slide& slide,
+                                                                         const Canvas& canvas) const {
+    float scale = canvasScale(scene, canvas);
+    for (const CachedSlide& cached : slide_cache) {
+        if (cached.slide == slide && cached.style == scene.style && cached.canvas == canvas && cached.scale == scale) {
+            return &cached;
+        }
+    }
+    return nullptr;
+}
+
+unsigned int PresentationRenderer::slideTexture(const Scene& scene, const Slide& slide, const Canvas& canvas) {
+    if (const CachedSlide* cached = findSlide(scene, slide, canvas)) {
+        return cached->texture;
+    }
+
+    // Glyphs must be baked before the frame that draws them starts
+    glyph_cache.noteText(slide.verse);
+    glyph_cache.noteText(slide.reference);
+    glyph_cache.refresh();
+
+    CachedSlide cached{slide, scene.style, canvas, canvasScale(scene, canvas)};
+    if (canvas.width > 0 && canvas.height > 0) {
+        // Mipmapped, as outputs smaller than the canvas sample it scaled down
+        glGenTextures(1, &cached.texture);
+        glBindTexture(GL_TEXTURE_2D, cached.texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, canvas.width, canvas.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+        glGenFramebuffers(1, &cached.framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, cached.framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, cached.texture, 0);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE) {
+            const Style& style = scene.style;
+            glViewport(0, 0, canvas.width, canvas.height);
+            // Keyed text is drawn over transparency, leaving premultiplied color
+            if (canvas.keyed) {
+                glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+            } else {
+                glClearColor(style.background.x, style.background.y, style.background.z, 1.0f);
+            }
+            glClear(GL_COLOR_BUFFER_BIT);
+            beginFrame(canvas.width, canvas.height, 0.0f);
+            layoutSlide(style, slide, canvas, cached.scale, 1.0f);
+            ImGui::Render();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            glBindTexture(GL_TEXTURE_2D, cached.texture);
+            glGenerateMipmap(GL_TEXTURE_2D);
+        } else {
+            std::cerr << "Presentation slide framebuffer incomplete; drawing slides directly" << std::endl;
+            glDeleteFramebuffers(1, &cached.framebuffer);
+            glDeleteTextures(1, &cached.texture);
+            cached.framebuffer = 0;
+            cached.texture = 0;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    slide_cache.push_back(cached);
+    return cached.texture;
+}
+
+PresentationRenderer::Prefetch PresentationRenderer::nextToPrefetch(const Scene& scene) const {
+    for (const Canvas& canvas : canvasesInUse(scene)) {
+        for (const Slide& slide : scene.upcoming) {
+            if (!findSlide(scene, slide, canvas)) return Prefetch{&slide, canvas};
+        }
+    }
+    return Prefetch();
+}
+
+void PresentationRenderer::pruneSlides(const Scene& scene) {
+    std::vector<Canvas> canvases = canvasesInUse(scene);
+    auto wanted = [&](const CachedSlide& cached) {
+        if (cached.style != scene.style || cached.scale != canvasScale(scene, cached.canvas) ||
+            std::find(canvases.begin(), canvases.end(), cached.canvas) == canvases.end()) {
+            return false;
+        }
+        if (cached.slide == scene.shown || cached.slide == scene.previous) return true;
+        return std::find(scene.upcoming.begin(), scene.upcoming.end(), cached.slide) != scene.upcoming.end();
+    };
+
+    auto kept = std::partition(slide_cache.begin(), slide_cache.end(), wanted);
+    for (auto it = kept; it != slide_cache.end(); ++it) {
+        if (it->framebuffer) glDeleteFramebuffers(1, &it->framebuffer);
+        if (it->texture) glDeleteTextures(1, &it->texture);
+    }
+    slide_cache.erase(kept, slide_cache.end());
+}
+
+void PresentationRenderer::releaseSlides() {
+    for (CachedSlide& cached : slide_cache) {
+        if (cached.framebuffer) glDeleteFramebuffers(1, &cached.framebuffer);
+        if (cached.texture) glDeleteTextures(1, &cached.texture);
+    }
+    slide_cache.clear();
+}
@@ -0,0 +1,204 @@
+#ifndef PRESENTATION_RENDERER_H
+#define PRESENTATION_RENDERER_H
+
+#include <GLFW/glfw3.h>
+#include <imgui.h>
+#include "../system/GlyphCache.h"
+#include "PresentationOutput.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Draws the audience display on a thread of its own, in the presentation
+// window's GL context (shared with the main window's) and an ImGui context
+// of its own, so nothing the operator does in the main window can delay a
+// projector frame. The UI thread only queues display commands. While a
+// transition runs, frames are locked to the display's vsync; otherwise the
+// thread sleeps until a command or a resize arrives.
+//
+// Each slide is laid out once into a texture of its own; a transition then
+// only blends two textures. Slides the operator is likely to show next
+// (see prefetch) are drawn ahead while the thread would otherwise sleep,
+// so showing one needs no layout or glyph baking at all.
+//
+// ImGui keeps its current context in a global, made thread-local for this
+// target by ImGuiThreadConfig.h; without that the two contexts would race.
+//
+// Frames can also be published to other programs through offscreen outputs
+// (setOutputs), each at its own resolution and layout: a stream at 4K, a
+// keyed lower third, a confidence monitor. A slide is laid out once per
+// canvas, a layout at one shape, drawn at the largest size any output of
+// that shape wants; each output then only scales that texture into its own
+// target. Another output of a shape already drawn costs a textured quad,
+// not a layout.
+class PresentationRenderer {
+public:
+    // How the display looks; sent whole whenever a setting changes
+    struct Style {
+        float font_size = 48.0f;
+        ImVec4 background = ImVec4(0.0f, 0.0f, 0.0f, 1.0f);
+        ImVec4 text = ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
+        ImVec4 reference = ImVec4(0.8f, 0.8f, 0.8f, 1.0f);
+        bool show_reference = true;
+        std::string alignment = "center"; // "left", "center" or "right"
+        float padding = 40.0f;
+        float fade_seconds = 0.3f; // fade-in of each new verse
+
+        bool operator==(const Style& other) const;
+        bool operator!=(const Style& other) const { return !(*this == other); }
+    };
+
+    struct Slide {
+        std::string verse;
+        std::string reference;
+
+        bool operator==(const Slide& other) const { return verse == other.verse && reference == other.reference; }
+    };
+
+    // Where the text sits on a display
+    enum class Layout {
+        FULL,        // the whole display, as on the presentation window
+        LOWER_THIRD  // a band along the bottom, to caption video under it
+    };
+
+    // An offscreen output, published through a PresentationOutput
+    struct OutputTarget {
+        std::string name;   // its shared memory
+        int width = 0;      // 0 to follow the presentation window
+        int height = 0;
+        Layout layout = Layout::FULL;
+        bool keyed = false; // text alone over transparency
+
+        bool operator==(const OutputTarget& other) const {
+            return name == other.name && width == other.width && height == other.height &&
+                   layout == other.layout && keyed == other.keyed;
+        }
+    };
+
+    // Slides drawn ahead, beyond the one shown and the one fading out
+    static constexpr size_t MAX_PREFETCHED = 4;
+    static constexpr size_t MAX_OUTPUTS = 4;
+
+    PresentationRenderer() = default;
+    ~PresentationRenderer();
+
+    PresentationRenderer(const PresentationRenderer&) = delete;
+    PresentationRenderer& operator=(const PresentationRenderer&) = delete;
+
+    // Takes over window's GL context and starts drawing; call on the main
+    // thread, as GLFW requires. font_path may be empty for ImGui's own font.
+    bool start(GLFWwindow* window, const std::string& font_path, const Style& style);
+    // Joins the render thread and hands the context back; call before destroying the window
+    void stop();
+    bool isRunning() const { return render_thread.joinable(); }
+
+    // Display commands, safe from any thread
+    void displayVerse(const std::string& text, const std::string& reference);
+    void clear();
+    void setBlank(bool blank);
+    void setStyle(const Style& style);
+    // Replaces the slides to draw ahead, most likely first; extras past MAX_PREFETCHED are dropped
+    void prefetch(std::vector<Slide> slides);
+    // Replaces the offscreen outputs; outputs kept by name and unchanged
+    // keep publishing without a gap. Extras past MAX_OUTPUTS are dropped.
+    void setOutputs(std::vector<OutputTarget> targets);
+
+private:
+    // Owned by the render thread once it runs; only commands touch it
+    struct Scene {
+        Slide shown;
+        Slide previous; // fading out under shown; empty when there is none
+        bool blank = false;
+        Style style;
+        std::chrono::steady_clock::time_point shown_at;
+        int width = 0;
+        int height = 0;
+        bool dirty = true;
+        std::vector<Slide> upcoming;
+    };
+    using Command = std::function<void(Scene&)>;
+
+    // A layout at one size; text scales with height against the window's,
+    // so outputs of one shape share a layout whatever their size
+    struct Canvas {
+        Layout layout = Layout::FULL;
+        bool keyed = false;
+        int width = 0;
+        int height = 0;
+
+        bool operator==(const Canvas& other) const {
+            return layout == other.layout && keyed == other.keyed && width == other.width && height == other.height;
+        }
+    };
+
+    // A slide drawn into a texture at one style and canvas; texture is 0 if
+    // drawing it failed, and the slide is then drawn straight to the window
+    struct CachedSlide {
+        Slide slide;
+        Style style;
+        Canvas canvas;
+        float scale = 1.0f;
+        unsigned int framebuffer = 0;
+        unsigned int texture = 0;
+    };
+
+    struct Output {
+        OutputTarget target;
+        std::unique_ptr<PresentationOutput> publisher;
+    };
+
+    // A slide still to draw ahead, and the canvas it is wanted at
+    struct Prefetch {
+        const Slide* slide = nullptr;
+        Canvas canvas;
+    };
+
+    static constexpr float FONT_PIXELS = 64.0f; // atlas size, scaled to the style's font size
+
+    GLFWwindow* window = nullptr;
+    std::string font_path;
+    GlyphCache glyph_cache; // the render thread's atlas, grown as verses need
+    std::thread render_thread;
+    Scene scene;
+    std::vector<CachedSlide> slide_cache; // render thread only
+    std::vector<Output> outputs;          // render thread only
+
+    std::mutex queue_mutex;
+    std::condition_variable queue_ready;
+    std::deque<Command> commands;
+    bool stopping = false;
+
+    void post(Command command);
+    void renderLoop();
+    void drawScene(Scene& scene, float delta_seconds);
+    void beginFrame(int width, int height, float delta_seconds);
+    void drawOutput(const Scene& scene, Output& output, float alpha);
+    static void layoutSlide(const Style& style, const Slide& slide, const Canvas& canvas, float scale, float alpha);
+    static float fadeAlpha(const Scene& scene);
+
+    static float canvasScale(const Scene& scene, const Canvas& canvas);
+    Canvas windowCanvas(const Scene& scene) const;
+    Canvas outputCanvas(const Scene& scene, const OutputTarget& target) const;
+    // The canvas canvas is drawn from: the largest wanted of its layout and shape
+    Canvas sharedCanvas(const Scene& scene, const Canvas& canvas) const;
+    // Every canvas some display draws from, each once
+    std::vector<Canvas> canvasesInUse(const Scene& scene) const;
+
+    const CachedSlide* findSlide(const Scene& scene, const Slide& slide, const Canvas& canvas) const;
+    unsigned int slideTexture(const Scene& scene, const Slide& slide, const Canvas& canvas);
+    Prefetch nextToPrefetch(const Scene& scene) const;
+    void pruneSlides(const Scene& scene);
+    void releaseSlides();
+
+    // GLFW calls these on the main thread
+    static void framebufferSizeCallback(GLFWwindow* window, int width, int height);
+    static void refreshCallback(GLFWwindow* window);
+};
+
+#endif // PRESENTATION_RENDERER_H
@@ -77,6 +77,10 @@ bool PresentationWindow::initPresentationWindow([[maybe_unused]] GLFWwindow* mai
 
 void PresentationWindow::destroyPresentationWindow() {
     if (presentation_window) {
+        if (glfwGetCurrentContext()) {
+            presentation_effects.releaseGpuResources();
+            media_manager.releaseTextures();
+        }
         glfwDestroyWindow(presentation_window);
         presentation_window = nullptr;
         presentation_mode_active = false;
@@ -271,17 +275,42 @@ void PresentationWindow::displayVerse(const std::string& verse_text, const std::
     }
     
     // Start default text animation
-    animation_system.startTextAnimation(verse_text, TextAnimationType::FADE_IN, 1500.0f);
+    if (animations_enabled) {
+        animation_system.startTextAnimation(verse_text, TextAnimationType::FADE_IN, 1500.0f);
+    }
+    notifyStateChange("verse");
 }
 
 void PresentationWindow::clearDisplay() {
     current_displayed_verse.clear();
     current_displayed_reference.clear();
     presentation_blank_screen = false;
+    notifyStateChange("clear");
 }
 
 void PresentationWindow::toggleBlankScreen() {
     presentation_blank_screen = !presentation_blank_screen;
+    notifyStateChange("blank");
+}
+
+void PresentationWindow::notifyStateChange(const std::string& change) {
+    if (state_listener) {
+        state_listener(change, *this);
+    }
+}
+
+const char* PresentationWindow::transitionTypeName(TransitionType type) {
+    switch (type) {
+        case TransitionType::FADE: return "fade";
+        case TransitionType::SLIDE_LEFT: return "slide_left";
+        case TransitionType::SLIDE_RIGHT: return "slide_right";
+        case TransitionType::SLIDE_UP: return "slide_up";
+        case TransitionType::SLIDE_DOWN: return "slide_down";
+        case TransitionType::ZOOM_IN: return "zoom_in";
+        case TransitionType::ZOOM_OUT: return "zoom_out";
+        case TransitionType::CROSS_FADE: return "cross_fade";
+    }
+    return "fade";
 }
 
 void PresentationWindow::updateMonitorPosition() {
@@ -335,11 +364,16 @@ ImVec4 PresentationWindow::hexToImVec4(const std::string& hex_color) {
 
 // Enhanced presentation methods
 void PresentationWindow::startTransition(TransitionType type, float duration) {
-    animation_system.startTransition(type, duration);
+    if (animations_enabled) {
+        animation_system.startTransition(type, duration);
+    }
+    last_transition = type;
+    last_transition_duration = duration;
+    notifyStateChange("transition");
 }
 
 void PresentationWindow::startTextAnimation(TextAnimationType type, float duration) {
-    if (!current_displayed_verse.empty()) {
+    if (animations_enabled && !current_displayed_verse.empty()) {
         animation_system.startTextAnimation(current_displayed_verse, type, duration);
     }
 }
@@ -353,7 +387,19 @@ void PresentationWindow::setBackground(const BackgroundConfig& config) {
 }
 
 void PresentationWindow::startKenBurnsEffect(float duration) {
-    animation_system.startKenBurnsEffect(1.0f, 1.1f, 0.0f, 0.0f, duration);
+    if (animations_enabled) {
+        animation_system.startKenBurnsEffect(1.0f, 1.1f, 0.0f, 0.0f, duration);
+    }
+}
+
+void PresentationWindow::setAnimationsEnabled(bool enabled) {
+    animations_enabled = enabled;
+    if (!enabled) {
+        animation_system.stopTransition();
+        animation_system.stopTextAnimation();
+        animation_system.stopKenBurnsEffect();
+        animation_system.stopParticleEffect();
+    }
 }
 
 bool PresentationWindow::isAnimationActive() const {
@@ -3,6 +3,7 @@
 
 #include <GLFW/glfw3.h>
 #include <string>
+#include <functional>
 #include <imgui.h>
 #include "../../core/UserSettings.h"
 #include "../effects/AnimationSystem.h"
@@ -11,6 +12,9 @@
 
 class PresentationWindow {
 public:
+    // Notified after every visible change: "verse", "clear", "blank" or "transition"
+    using StateListener = std::function<void(const std::string& change, const PresentationWindow& window)>;
+
     PresentationWindow(UserSettings& settings);
     ~PresentationWindow();
 
@@ -35,9 +39,13 @@ public:
     void applyTextEffects(const std::string& preset = "default");
     void setBackground(const BackgroundConfig& config);
     void startKenBurnsEffect(float duration = 10000.0f);
+    // When off, verses appear at once and running animations stop (load shedding)
+    void setAnimationsEnabled(bool enabled);
+    bool areAnimationsEnabled() const { return animations_enabled; }
     
     // Settings
     void updateMonitorPosition();
+    void setStateListener(StateListener listener) { state_listener = std::move(listener); }
     
     // State queries
     bool isPresentationModeActive() const { return presentation_mode_active; }
@@ -48,6 +56,9 @@ public:
     // Current content
     const std::string& getCurrentDisplayedVerse() const { return current_displayed_verse; }
     const std::string& getCurrentDisplayedReference() const { return current_displayed_reference; }
+    TransitionType getLastTransition() const { return last_transition; }
+    float getLastTransitionDuration() const { return last_transition_duration; }
+    static const char* transitionTypeName(TransitionType type);
     
     // Effects access for configuration
     AnimationSystem& getAnimationSystem() { return animation_system; }
@@ -69,12 +80,17 @@ private:
     std::string current_displayed_reference;
     float presentation_fade_alpha;
     bool presentation_blank_screen;
+    TransitionType last_transition = TransitionType::FADE;
+    float last_transition_duration = 0.0f;
+    bool animations_enabled = true;
+    StateListener state_listener;
     
     // Enhanced display state
     std::string animated_verse_text;
     std::string animated_reference_text;
     
     // Helper methods
+    void notifyStateChange(const std::string& change);
     void setupPresentationStyle();
     void renderPresentationContent();
     void renderEnhancedPresentationContent();
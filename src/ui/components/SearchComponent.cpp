@@ -256,6 +256,7 @@ void SearchComponent::performSearch() {
     
     // Add to search history
     addToSearchHistory(query);
+    verse_finder->updateAutoCompleteFrequency(query);
     
     // Update suggestions based on results
     updateAutoComplete();
@@ -292,12 +293,10 @@ void SearchComponent::updateAutoComplete() {
         book_suggestions = verse_finder->findBookNameSuggestions(query);
     }
     
-    // Get query suggestions (simplified - would normally use more sophisticated logic)
+    // Prefix completions come from an immutable snapshot, cheap enough for every keystroke
     query_suggestions.clear();
     if (query.length() >= 2) {
-        // This would typically call a method to get keyword suggestions
-        // For now, we'll leave it empty as the full implementation would require
-        // access to the verse finder's internal methods
+        query_suggestions = verse_finder->getSmartSuggestions(query, 5);
     }
 }
 
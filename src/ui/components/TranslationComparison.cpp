@@ -1,8 +1,8 @@
 #include "TranslationComparison.h"
+#include "../../core/TaskScheduler.h"
+#include "../../core/WordDiff.h"
 #include <imgui.h>
 #include <algorithm>
-#include <sstream>
-#include <cctype>
 
 TranslationComparison::TranslationComparison() 
     : verse_finder(nullptr), current_reference("John 3:16") {
@@ -13,6 +13,7 @@ TranslationComparison::~TranslationComparison() {
 
 void TranslationComparison::render() {
     if (!verse_finder) return;
+    drainPendingResults();
     
     if (ImGui::BeginChild("TranslationComparison", ImVec2(0, comparison_height), true)) {
         ImGui::Text("Translation Comparison");
@@ -89,7 +90,7 @@ void TranslationComparison::render() {
             
             if (ImGui::Checkbox((trans_info.abbreviation + " - " + trans_info.name).c_str(), &is_selected)) {
                 if (is_selected) {
-                    if (selected_translations.size() < 4) { // Limit to 4 translations
+                    if (selected_translations.size() < MAX_COMPARED_TRANSLATIONS) {
                         selected_translations.push_back(trans_info.name);
                         translation_changed = true;
                     }
@@ -119,15 +120,15 @@ void TranslationComparison::render() {
                 const std::string& translation = trans_text.first;
                 const std::string& text = trans_text.second;
                 
-                std::vector<bool> word_diffs;
-                if (show_word_differences && i < current_comparison.word_differences.size()) {
-                    word_diffs = current_comparison.word_differences[i];
-                }
+                static const std::vector<bool> no_differences;
+                const std::vector<bool>& word_diffs =
+                    (show_word_differences && i < current_comparison.word_differences.size())
+                        ? current_comparison.word_differences[i] : no_differences;
                 
                 if (i > 0) ImGui::SameLine();
                 
                 ImGui::BeginGroup();
-                renderTranslationPanel(translation, text, word_diffs, i);
+                renderTranslationPanel(translation, text, current_comparison.words[i], word_diffs, i);
                 ImGui::EndGroup();
                 
                 if (i < current_comparison.translation_texts.size() - 1) {
@@ -136,6 +137,8 @@ void TranslationComparison::render() {
                     ImGui::Text("|");
                 }
             }
+        } else if (in_flight.count(current_key)) {
+            ImGui::Text("Comparing %s...", current_reference.c_str());
         } else {
             ImGui::Text("No verse found for reference: %s", current_reference.c_str());
         }
@@ -156,128 +159,155 @@ void TranslationComparison::setCurrentReference(const std::string& reference) {
 void TranslationComparison::updateComparison() {
     if (!verse_finder || selected_translations.empty()) {
         current_comparison = ComparisonResult();
+        current_key.clear();
         return;
     }
     
-    current_comparison = compareVerseTexts(current_reference);
+    // The previous comparison stays up until a new one lands
+    current_key = cacheKey(current_reference);
+    auto cached = cache.find(current_key);
+    if (cached != cache.end()) {
+        current_comparison = cached->second;
+    } else {
+        requestComparison(current_reference);
+    }
+    prefetchAdjacent();
 }
 
-ComparisonResult TranslationComparison::compareVerseTexts(const std::string& reference) {
-    ComparisonResult result;
-    result.reference = reference;
-    
-    std::vector<std::string> texts;
+void TranslationComparison::drainPendingResults() {
+    std::vector<std::pair<std::string, ComparisonResult>> ready;
+    {
+        std::lock_guard<std::mutex> lock(pending->mutex);
+        if (pending->ready.empty()) return;
+        ready.swap(pending->ready);
+    }
     
-    // Collect verse texts from all selected translations
-    for (const std::string& translation : selected_translations) {
-        std::string verse_text = verse_finder->searchByReference(reference, translation);
-        if (verse_text.find("Verse not found") == std::string::npos && 
-            verse_text.find("Translation not found") == std::string::npos) {
-            // Extract just the text part (remove reference prefix)
-            size_t colon_pos = verse_text.find(": ");
-            if (colon_pos != std::string::npos) {
-                verse_text = verse_text.substr(colon_pos + 2);
+    for (auto& [key, result] : ready) {
+        in_flight.erase(key);
+        if (key == current_key) {
+            current_comparison = result;
+        }
+        if (cache.emplace(key, std::move(result)).second) {
+            cache_order.push_back(key);
+            if (cache_order.size() > CACHE_CAPACITY) {
+                cache.erase(cache_order.front());
+                cache_order.pop_front();
             }
-            result.translation_texts.push_back({translation, verse_text});
-            texts.push_back(verse_text);
         }
     }
+}
+
+void TranslationComparison::prefetchAdjacent() {
+    for (int direction : {1, -1}) {
+        // "Book C:V: text", of which only the reference is wanted
+        std::string adjacent = verse_finder->getAdjacentVerse(current_reference, selected_translations.front(), direction);
+        size_t colon_pos = adjacent.find(": ");
+        if (colon_pos != std::string::npos) {
+            requestComparison(adjacent.substr(0, colon_pos));
+        }
+    }
+}
+
+std::string TranslationComparison::cacheKey(const std::string& reference) const {
+    // Generations retire comparisons of a translation once it is reloaded
+    std::string key = reference;
+    for (const std::string& translation : selected_translations) {
+        key += '\x1f';
+        key += translation;
+        key += '@';
+        key += std::to_string(verse_finder->getTranslationGeneration(translation));
+    }
+    return key;
+}
+
+void TranslationComparison::requestComparison(const std::string& reference) {
+    std::string key = cacheKey(reference);
+    if (cache.count(key) || !in_flight.insert(key).second) return;
     
-    // Analyze word differences
-    if (show_word_differences && texts.size() > 1) {
-        result.word_differences = analyzeWordDifferences(texts);
+    // Taken here rather than on a worker, which may be helping a search that
+    // already holds a lease; it is released once the comparison is done
+    auto lease = std::make_shared<VerseFinder::TranslationLease>(verse_finder->acquireTranslations(selected_translations));
+    if (!*lease) {
+        std::lock_guard<std::mutex> lock(pending->mutex);
+        ComparisonResult missing;
+        missing.reference = reference;
+        pending->ready.emplace_back(key, std::move(missing));
+        return;
     }
     
-    return result;
+    TaskScheduler::shared().post([finder = verse_finder, lease, results = pending, key, reference,
+                                  translations = selected_translations]() {
+        ComparisonResult result = compareVerseTexts(*finder, reference, translations);
+        std::lock_guard<std::mutex> lock(results->mutex);
+        results->ready.emplace_back(key, std::move(result));
+    }, TaskPriority::PREFETCH);
 }
 
-std::vector<std::vector<bool>> TranslationComparison::analyzeWordDifferences(const std::vector<std::string>& texts) {
-    std::vector<std::vector<bool>> differences;
-    std::vector<std::vector<std::string>> tokenized_texts;
+ComparisonResult TranslationComparison::compareVerseTexts(const VerseFinder& finder, const std::string& reference,
+                                                          const std::vector<std::string>& translations) {
+    ComparisonResult result;
+    result.reference = reference;
     
-    // Tokenize all texts
-    for (const std::string& text : texts) {
-        tokenized_texts.push_back(tokenizeForComparison(text));
-        differences.push_back(std::vector<bool>());
+    // Collect verse texts from all selected translations, which the caller holds a lease on;
+    // one aligned lookup finds the verse however each translation numbers it
+    std::vector<VerseView> aligned = finder.findAlignedVerses(reference, translations);
+    for (size_t i = 0; i < translations.size(); ++i) {
+        // The verse text straight from the store; a miss is an empty view, not a message
+        const VerseView& verse = aligned[i];
+        const VerseStore* store = finder.getVerseStore(translations[i]);
+        if (!verse || !store) continue;
+        result.translation_texts.push_back({translations[i], std::string(verse.text)});
+        const std::string& text = result.translation_texts.back().second;
+        
+        // The store tokenized the verse when it was loaded: each display token runs
+        // from the start of one word to the next, punctuation and spacing included
+        std::span<const TermId> terms = store->terms(verse.id);
+        std::vector<std::string> display_words;
+        display_words.reserve(terms.size());
+        for (size_t w = 0; w < terms.size(); ++w) {
+            size_t begin = w == 0 ? 0 : store->wordSpan(verse.id, w).first;
+            size_t end = w + 1 < terms.size() ? store->wordSpan(verse.id, w + 1).first : text.size();
+            display_words.push_back(text.substr(begin, end - begin));
+        }
+        result.words.push_back(std::move(display_words));
+        result.terms.emplace_back(terms.begin(), terms.end());
     }
     
-    // Helper method to extract clean word from display word
-    auto getCleanWord = [](const std::string& display_word) -> std::string {
-        std::string clean;
-        for (char c : display_word) {
-            if (std::isalnum(c) || c == '\'') {
-                clean += std::tolower(c);
-            }
-        }
-        return clean;
-    };
+    // Analyze word differences
+    if (result.terms.size() > 1) {
+        result.word_differences = analyzeWordDifferences(result.terms);
+    }
     
-    // Improved word-by-word comparison with better alignment
-    for (size_t i = 0; i < tokenized_texts.size(); ++i) {
-        const auto& tokens_i = tokenized_texts[i];
-        auto& diffs_i = differences[i];
-        diffs_i.resize(tokens_i.size(), false);
-        
-        for (size_t word_idx = 0; word_idx < tokens_i.size(); ++word_idx) {
-            const std::string& display_word = tokens_i[word_idx];
-            const std::string clean_word = getCleanWord(display_word);
-            
-            if (clean_word.empty()) {
-                continue; // Skip punctuation-only tokens
-            }
-            
-            // Check if this word appears in all other translations
-            bool is_unique = true;
-            int match_count = 0;
-            
-            for (size_t j = 0; j < tokenized_texts.size(); ++j) {
-                if (i == j) continue;
-                
-                const auto& tokens_j = tokenized_texts[j];
-                
-                // Search for exact match first
-                bool found_exact = false;
-                for (const auto& other_display_word : tokens_j) {
-                    const std::string other_clean = getCleanWord(other_display_word);
-                    if (other_clean == clean_word) {
-                        found_exact = true;
-                        match_count++;
-                        break;
-                    }
-                }
-                
-                // If no exact match, check for similar words (different forms)
-                if (!found_exact) {
-                    for (const auto& other_display_word : tokens_j) {
-                        const std::string other_clean = getCleanWord(other_display_word);
-                        // Simple similarity check for variations (e.g., "believes" vs "believeth")
-                        if (clean_word.length() > 3 && other_clean.length() > 3) {
-                            std::string word_root = clean_word.substr(0, std::min(clean_word.length() - 2, size_t(6)));
-                            std::string other_root = other_clean.substr(0, std::min(other_clean.length() - 2, size_t(6)));
-                            if (word_root == other_root) {
-                                match_count++;
-                                found_exact = true;
-                                break;
-                            }
-                        }
-                    }
-                }
-                
-                if (!found_exact) {
-                    is_unique = false;
-                }
+    return result;
+}
+
+std::vector<std::vector<bool>> TranslationComparison::analyzeWordDifferences(
+    const std::vector<std::vector<TermId>>& terms) {
+    // Term ids are shared across translations already; each distinct term is
+    // mapped to its root once, so inflections align too
+    std::unordered_map<std::string, uint32_t> roots;
+    std::unordered_map<TermId, uint32_t> root_of;
+    std::vector<std::vector<uint32_t>> sequences(terms.size());
+    for (size_t i = 0; i < terms.size(); ++i) {
+        sequences[i].reserve(terms[i].size());
+        for (TermId term : terms[i]) {
+            auto known = root_of.find(term);
+            if (known == root_of.end()) {
+                std::string key = comparisonKey(TermDictionary::shared().term(term));
+                auto root = roots.emplace(std::move(key), static_cast<uint32_t>(roots.size())).first;
+                known = root_of.emplace(term, root->second).first;
             }
-            
-            // Mark as different if it's unique to this translation or appears in less than half
-            diffs_i[word_idx] = is_unique || (match_count < static_cast<int>((tokenized_texts.size() - 1) / 2));
+            sequences[i].push_back(known->second);
         }
     }
     
-    return differences;
+    // A word differs when it lines up with fewer than half of the other translations
+    return WordDiff::markDifferences(sequences);
 }
 
 void TranslationComparison::renderTranslationPanel(const std::string& translation, 
                                                   const std::string& text, 
+                                                  const std::vector<std::string>& words,
                                                   const std::vector<bool>& word_diffs, 
                                                   int /* panel_index */) {
     // Translation header
@@ -291,8 +321,6 @@ void TranslationComparison::renderTranslationPanel(const std::string& translatio
     
     // Render text with highlighting
     if (show_word_differences && !word_diffs.empty()) {
-        std::vector<std::string> words = tokenizeForComparison(text);
-        
         ImGui::BeginGroup();
         for (size_t i = 0; i < words.size() && i < word_diffs.size(); ++i) {
             if (i > 0) ImGui::SameLine(0, 0);
@@ -333,34 +361,10 @@ void TranslationComparison::renderMetadataInfo(const std::string& translation) {
     }
 }
 
-std::vector<std::string> TranslationComparison::tokenizeForComparison(const std::string& text) {
-    std::vector<std::string> tokens;
-    std::istringstream stream(text);
-    std::string word;
-    
-    // Keep track of position for proper spacing
-    bool first_word = true;
-    
-    while (stream >> word) {
-        // Remove punctuation for comparison, but keep original for display
-        std::string clean_word;
-        std::string display_word = word;
-        
-        for (char c : word) {
-            if (std::isalnum(c) || c == '\'') {
-                clean_word += std::tolower(c);
-            }
-        }
-        
-        if (!clean_word.empty()) {
-            // Store the display word with proper spacing
-            if (!first_word) {
-                display_word = " " + display_word;
-            }
-            tokens.push_back(display_word);
-            first_word = false;
-        }
+std::string TranslationComparison::comparisonKey(std::string_view term) {
+    std::string key(term);
+    if (key.length() > 3) {
+        key.resize(std::min(key.length() - 2, size_t(6)));
     }
-    
-    return tokens;
+    return key;
 }
\ No newline at end of file
@@ -3,18 +3,32 @@
 
 #include <string>
 #include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
 #include "../../core/VerseFinder.h"
 
 struct ComparisonResult {
     std::string reference;
     std::vector<std::pair<std::string, std::string>> translation_texts; // {translation_name, text}
+    std::vector<std::vector<std::string>> words; // per translation, display tokens
+    std::vector<std::vector<TermId>> terms;      // per translation, each display token's word
     std::vector<std::vector<bool>> word_differences; // per translation, per word
 };
 
+// Comparisons are computed on the shared TaskScheduler and cached by
+// reference and translation set, so the UI handlers that ask for one never
+// wait on it. The verses either side of the shown one are prefetched, which
+// keeps stepping through a chapter instant.
 class TranslationComparison {
 public:
+    static constexpr size_t MAX_COMPARED_TRANSLATIONS = 6;
+    static constexpr size_t CACHE_CAPACITY = 64; // comparisons kept
+
+
     TranslationComparison();
     ~TranslationComparison();
 
@@ -35,6 +49,18 @@ private:
     std::vector<std::string> selected_translations;
     std::string current_reference;
     ComparisonResult current_comparison;
+    std::string current_key; // cache key current_comparison is, or will be, for
+
+    // Finished comparisons, handed from the workers to the UI thread; shared
+    // so a worker finishing after the component is gone is harmless
+    struct PendingResults {
+        std::mutex mutex;
+        std::vector<std::pair<std::string, ComparisonResult>> ready; // {key, result}
+    };
+    std::shared_ptr<PendingResults> pending = std::make_shared<PendingResults>();
+    std::unordered_set<std::string> in_flight;
+    std::unordered_map<std::string, ComparisonResult> cache;
+    std::deque<std::string> cache_order; // oldest first
     
     // UI state
     bool show_word_differences = true;
@@ -46,12 +72,20 @@ private:
     
     // Helper methods
     void updateComparison();
-    ComparisonResult compareVerseTexts(const std::string& reference);
-    std::vector<std::vector<bool>> analyzeWordDifferences(const std::vector<std::string>& texts);
+    void drainPendingResults();
+    void prefetchAdjacent();
+    std::string cacheKey(const std::string& reference) const;
+    // Starts comparing reference in the background unless it is cached or on its way
+    void requestComparison(const std::string& reference);
+    static ComparisonResult compareVerseTexts(const VerseFinder& finder, const std::string& reference,
+                                              const std::vector<std::string>& translations);
+    static std::vector<std::vector<bool>> analyzeWordDifferences(const std::vector<std::vector<TermId>>& terms);
     void renderTranslationPanel(const std::string& translation, const std::string& text, 
+                               const std::vector<std::string>& words,
                                const std::vector<bool>& word_diffs, int panel_index);
     void renderMetadataInfo(const std::string& translation);
-    std::vector<std::string> tokenizeForComparison(const std::string& text);
+    // A folded word, longer words cut to a root so "believes" and "believeth" align
+    static std::string comparisonKey(std::string_view term);
 };
 
 #endif // TRANSLATION_COMPARISON_H
\ No newline at end of file
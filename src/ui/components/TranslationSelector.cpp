@@ -15,24 +15,23 @@ void TranslationSelector::render() {
     
     // Translation dropdown
     if (ImGui::BeginCombo("##translation", current_translation.c_str())) {
+        // Listed translations are offered too; the owner reads one in when it is chosen
         for (const auto& translation : available_translations) {
-            if (translation.is_loaded) {
-                bool is_selected = (current_translation == translation.abbreviation);
-                std::string display_text = translation.abbreviation + " - " + translation.name;
-                if (!translation.description.empty()) {
-                    display_text += " (" + translation.description + ")";
-                }
-                
-                if (ImGui::Selectable(display_text.c_str(), is_selected)) {
-                    current_translation = translation.abbreviation;
-                    if (on_translation_changed) {
-                        on_translation_changed(current_translation);
-                    }
-                }
-                if (is_selected) {
-                    ImGui::SetItemDefaultFocus();
+            bool is_selected = (current_translation == translation.abbreviation);
+            std::string display_text = translation.abbreviation + " - " + translation.name;
+            if (!translation.description.empty()) {
+                display_text += " (" + translation.description + ")";
+            }
+            
+            if (ImGui::Selectable(display_text.c_str(), is_selected)) {
+                current_translation = translation.abbreviation;
+                if (on_translation_changed) {
+                    on_translation_changed(current_translation);
                 }
             }
+            if (is_selected) {
+                ImGui::SetItemDefaultFocus();
+            }
         }
         ImGui::EndCombo();
     }
@@ -3,8 +3,29 @@
 #include <cmath>
 #include <sstream>
 
+namespace {
+
+using EasingFunction = float (*)(float);
+
+// Indexed by EasingType
+constexpr EasingFunction EASING_FUNCTIONS[] = {
+    AnimationSystem::easeLinear,
+    AnimationSystem::easeInQuad,
+    AnimationSystem::easeOutQuad,
+    AnimationSystem::easeInOutQuad,
+    AnimationSystem::easeBounce,
+    AnimationSystem::easeElastic,
+};
+static_assert(sizeof(EASING_FUNCTIONS) / sizeof(EASING_FUNCTIONS[0]) ==
+              static_cast<size_t>(EasingType::ELASTIC) + 1, "one easing function per EasingType");
+
+constexpr size_t NO_TWEEN = static_cast<size_t>(-1);
+
+} // namespace
+
 AnimationSystem::AnimationSystem()
-    : ken_burns_active(false), ken_burns_zoom(1.0f), ken_burns_pan_x(0.0f), ken_burns_pan_y(0.0f),
+    : epoch(std::chrono::steady_clock::now()),
+      ken_burns_active(false), ken_burns_zoom(1.0f), ken_burns_pan_x(0.0f), ken_burns_pan_y(0.0f),
       particle_effect_active(false) {}
 
 AnimationSystem::~AnimationSystem() {
@@ -12,10 +33,12 @@ AnimationSystem::~AnimationSystem() {
 }
 
 void AnimationSystem::update() {
+    now_ms = elapsedMs();
+    updateTweens();
     updateTransition();
     updateTextAnimation();
-    updateValueAnimations();
     updateKenBurnsEffect();
+    retireFinishedTweens();
     updateParticleEffects();
 }
 
@@ -24,7 +47,7 @@ void AnimationSystem::reset() {
     stopTextAnimation();
     stopKenBurnsEffect();
     stopParticleEffect();
-    animations.clear();
+    tweens.clear();
 }
 
 // Transition animations
@@ -32,12 +55,13 @@ void AnimationSystem::startTransition(TransitionType type, float duration, Easin
     stopTransition();
     transition = std::make_unique<TransitionAnimation>(type, duration, easing);
     transition->active = true;
-    transition->start_time = std::chrono::steady_clock::now();
+    transition->tween = animateValue(0.0f, 1.0f, duration, easing);
     transition->progress = 0.0f;
 }
 
 void AnimationSystem::stopTransition() {
     if (transition) {
+        stopAnimation(transition->tween);
         transition->active = false;
         transition.reset();
     }
@@ -59,14 +83,27 @@ void AnimationSystem::startTextAnimation(const std::string& text, TextAnimationT
     text_animation = std::make_unique<TextAnimation>(type, duration);
     text_animation->text = text;
     text_animation->active = true;
-    text_animation->start_time = std::chrono::steady_clock::now();
+    text_animation->tween = animateValue(0.0f, 1.0f, duration, EasingType::LINEAR);
     text_animation->current_char = 0;
     text_animation->current_word = 0;
     text_animation->current_line = 0;
+
+    std::istringstream iss(text);
+    std::string word;
+    while (iss >> word) {
+        if (!text_animation->words.empty()) text_animation->words += ' ';
+        text_animation->words += word;
+        text_animation->word_ends.push_back(text_animation->words.size());
+    }
+    for (size_t pos = text.find('\n'); pos != std::string::npos; pos = text.find('\n', pos + 1)) {
+        text_animation->line_ends.push_back(pos);
+    }
+    text_animation->line_ends.push_back(text.size());
 }
 
 void AnimationSystem::stopTextAnimation() {
     if (text_animation) {
+        stopAnimation(text_animation->tween);
         text_animation->active = false;
         text_animation.reset();
     }
@@ -83,31 +120,13 @@ std::string AnimationSystem::getAnimatedText() const {
         }
         case TextAnimationType::WORD_BY_WORD: {
             int visible_words = calculateVisibleWords();
-            std::istringstream iss(text_animation->text);
-            std::string word;
-            std::string result;
-            int word_count = 0;
-            
-            while (iss >> word && word_count < visible_words) {
-                if (!result.empty()) result += " ";
-                result += word;
-                word_count++;
-            }
-            return result;
+            if (visible_words <= 0) return "";
+            return text_animation->words.substr(0, text_animation->word_ends[visible_words - 1]);
         }
         case TextAnimationType::LINE_BY_LINE: {
             int visible_lines = calculateVisibleLines();
-            std::istringstream iss(text_animation->text);
-            std::string line;
-            std::string result;
-            int line_count = 0;
-            
-            while (std::getline(iss, line) && line_count < visible_lines) {
-                if (!result.empty()) result += "\n";
-                result += line;
-                line_count++;
-            }
-            return result;
+            if (visible_lines <= 0) return "";
+            return text_animation->text.substr(0, text_animation->line_ends[visible_lines - 1]);
         }
         default:
             return text_animation->text;
@@ -116,28 +135,35 @@ std::string AnimationSystem::getAnimatedText() const {
 
 float AnimationSystem::getTextAnimationProgress() const {
     if (!text_animation || !text_animation->active) return 1.0f;
-    
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - text_animation->start_time).count();
-    return std::min(1.0f, static_cast<float>(elapsed) / text_animation->duration);
+    return text_animation->progress;
 }
 
 // Value animations
-std::shared_ptr<Animation> AnimationSystem::animateValue(float start, float end, float duration, EasingType easing) {
-    auto animation = std::make_shared<Animation>(start, end, duration, easing);
-    animation->start_time = std::chrono::steady_clock::now();
-    animation->active = true;
-    animations.push_back(animation);
-    return animation;
-}
-
-void AnimationSystem::stopAnimation(std::shared_ptr<Animation> animation) {
-    if (animation) {
-        animation->active = false;
-        animation->completed = true;
+AnimationHandle AnimationSystem::animateValue(float start, float end, float duration, EasingType easing) {
+    AnimationHandle handle = next_handle++;
+    if (next_handle == 0) next_handle = 1;
+    // Timed from now rather than the last update() so a tween started
+    // between frames does not begin part way through
+    tweens.push(handle, elapsedMs(), duration, start, end, easing);
+    return handle;
+}
+
+void AnimationSystem::stopAnimation(AnimationHandle animation) {
+    size_t index = findTween(animation);
+    if (index != NO_TWEEN) {
+        tweens.swapRemove(index);
     }
 }
 
+bool AnimationSystem::isAnimationActive(AnimationHandle animation) const {
+    return findTween(animation) != NO_TWEEN;
+}
+
+float AnimationSystem::getAnimationValue(AnimationHandle animation, float fallback) const {
+    size_t index = findTween(animation);
+    return index != NO_TWEEN ? tweens.value[index] : fallback;
+}
+
 // Ken Burns effect
 void AnimationSystem::startKenBurnsEffect(float zoom_start, float zoom_end, float pan_x, float pan_y, float duration) {
     stopKenBurnsEffect();
@@ -146,19 +172,15 @@ void AnimationSystem::startKenBurnsEffect(float zoom_start, float zoom_end, floa
     ken_burns_zoom_anim = animateValue(zoom_start, zoom_end, duration, EasingType::LINEAR);
     ken_burns_pan_x_anim = animateValue(0.0f, pan_x, duration, EasingType::LINEAR);
     ken_burns_pan_y_anim = animateValue(0.0f, pan_y, duration, EasingType::LINEAR);
-    
-    ken_burns_zoom_anim->update_callback = [this](float value) { ken_burns_zoom = value; };
-    ken_burns_pan_x_anim->update_callback = [this](float value) { ken_burns_pan_x = value; };
-    ken_burns_pan_y_anim->update_callback = [this](float value) { ken_burns_pan_y = value; };
-    
-    ken_burns_zoom_anim->complete_callback = [this]() { ken_burns_active = false; };
+    ken_burns_zoom = zoom_start;
 }
 
 void AnimationSystem::stopKenBurnsEffect() {
     ken_burns_active = false;
-    if (ken_burns_zoom_anim) stopAnimation(ken_burns_zoom_anim);
-    if (ken_burns_pan_x_anim) stopAnimation(ken_burns_pan_x_anim);
-    if (ken_burns_pan_y_anim) stopAnimation(ken_burns_pan_y_anim);
+    stopAnimation(ken_burns_zoom_anim);
+    stopAnimation(ken_burns_pan_x_anim);
+    stopAnimation(ken_burns_pan_y_anim);
+    ken_burns_zoom_anim = ken_burns_pan_x_anim = ken_burns_pan_y_anim = 0;
     ken_burns_zoom = 1.0f;
     ken_burns_pan_x = 0.0f;
     ken_burns_pan_y = 0.0f;
@@ -218,87 +240,120 @@ float AnimationSystem::easeElastic(float t) {
            -std::pow(2.0f, 10.0f * t - 10.0f) * std::sin((t * 10.0f - 10.75f) * c4);
 }
 
-// Private helper methods
 float AnimationSystem::applyEasing(float t, EasingType easing) {
-    switch (easing) {
-        case EasingType::LINEAR: return easeLinear(t);
-        case EasingType::EASE_IN: return easeInQuad(t);
-        case EasingType::EASE_OUT: return easeOutQuad(t);
-        case EasingType::EASE_IN_OUT: return easeInOutQuad(t);
-        case EasingType::BOUNCE: return easeBounce(t);
-        case EasingType::ELASTIC: return easeElastic(t);
-        default: return easeLinear(t);
+    return EASING_FUNCTIONS[static_cast<size_t>(easing)](t);
+}
+
+// Tween table
+void AnimationSystem::Tweens::push(AnimationHandle id, float start, float duration, float from_value,
+                                   float to_value, EasingType easing_type) {
+    handle.push_back(id);
+    start_ms.push_back(start);
+    duration_ms.push_back(duration);
+    from.push_back(from_value);
+    to.push_back(to_value);
+    value.push_back(from_value);
+    easing.push_back(easing_type);
+}
+
+void AnimationSystem::Tweens::swapRemove(size_t index) {
+    size_t last = size() - 1;
+    handle[index] = handle[last];
+    start_ms[index] = start_ms[last];
+    duration_ms[index] = duration_ms[last];
+    from[index] = from[last];
+    to[index] = to[last];
+    value[index] = value[last];
+    easing[index] = easing[last];
+    handle.pop_back();
+    start_ms.pop_back();
+    duration_ms.pop_back();
+    from.pop_back();
+    to.pop_back();
+    value.pop_back();
+    easing.pop_back();
+}
+
+void AnimationSystem::Tweens::clear() {
+    handle.clear();
+    start_ms.clear();
+    duration_ms.clear();
+    from.clear();
+    to.clear();
+    value.clear();
+    easing.clear();
+}
+
+// Private helper methods
+size_t AnimationSystem::findTween(AnimationHandle animation) const {
+    if (animation == 0) return NO_TWEEN;
+    auto it = std::find(tweens.handle.begin(), tweens.handle.end(), animation);
+    return it != tweens.handle.end() ? static_cast<size_t>(it - tweens.handle.begin()) : NO_TWEEN;
+}
+
+float AnimationSystem::elapsedMs() const {
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+void AnimationSystem::updateTweens() {
+    const size_t count = tweens.size();
+    for (size_t i = 0; i < count; i++) {
+        float duration = tweens.duration_ms[i];
+        float t = duration > 0.0f ? (now_ms - tweens.start_ms[i]) / duration : 1.0f;
+        t = std::clamp(t, 0.0f, 1.0f);
+        // The end value exactly, whatever the easing does at 1
+        float eased = t < 1.0f ? EASING_FUNCTIONS[static_cast<size_t>(tweens.easing[i])](t) : 1.0f;
+        tweens.value[i] = tweens.from[i] + (tweens.to[i] - tweens.from[i]) * eased;
+    }
+}
+
+void AnimationSystem::retireFinishedTweens() {
+    for (size_t i = 0; i < tweens.size();) {
+        if (now_ms - tweens.start_ms[i] >= tweens.duration_ms[i]) {
+            tweens.swapRemove(i);
+        } else {
+            i++;
+        }
     }
 }
 
 void AnimationSystem::updateTransition() {
     if (!transition || !transition->active) return;
-    
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - transition->start_time).count();
-    float t = static_cast<float>(elapsed) / transition->duration;
-    
-    if (t >= 1.0f) {
+
+    size_t index = findTween(transition->tween);
+    if (index == NO_TWEEN || now_ms - tweens.start_ms[index] >= tweens.duration_ms[index]) {
         transition->progress = 1.0f;
         transition->active = false;
     } else {
-        transition->progress = applyEasing(t, transition->easing);
+        transition->progress = tweens.value[index];
     }
 }
 
 void AnimationSystem::updateTextAnimation() {
     if (!text_animation || !text_animation->active) return;
-    
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - text_animation->start_time).count();
-    
-    if (elapsed >= text_animation->duration) {
-        text_animation->active = false;
-    }
-}
 
-void AnimationSystem::updateValueAnimations() {
-    auto now = std::chrono::steady_clock::now();
-    
-    for (auto it = animations.begin(); it != animations.end();) {
-        auto& animation = *it;
-        
-        if (!animation->active || animation->completed) {
-            it = animations.erase(it);
-            continue;
-        }
-        
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - animation->start_time).count();
-        float t = static_cast<float>(elapsed) / animation->duration;
-        
-        if (t >= 1.0f) {
-            animation->current_value = animation->end_value;
-            animation->active = false;
-            animation->completed = true;
-            
-            if (animation->update_callback) {
-                animation->update_callback(animation->current_value);
-            }
-            if (animation->complete_callback) {
-                animation->complete_callback();
-            }
-        } else {
-            float eased_t = applyEasing(t, animation->easing);
-            animation->current_value = animation->start_value + 
-                                     (animation->end_value - animation->start_value) * eased_t;
-            
-            if (animation->update_callback) {
-                animation->update_callback(animation->current_value);
-            }
-        }
-        
-        ++it;
+    size_t index = findTween(text_animation->tween);
+    if (index == NO_TWEEN || now_ms - tweens.start_ms[index] >= tweens.duration_ms[index]) {
+        text_animation->progress = 1.0f;
+        text_animation->active = false;
+    } else {
+        text_animation->progress = tweens.value[index];
     }
 }
 
 void AnimationSystem::updateKenBurnsEffect() {
-    // Ken Burns effect is handled by the individual value animations
-    // This method is kept for future enhancement
+    if (!ken_burns_active) return;
+
+    // Finished tweens still hold their end values until retired after this
+    size_t zoom = findTween(ken_burns_zoom_anim);
+    size_t pan_x = findTween(ken_burns_pan_x_anim);
+    size_t pan_y = findTween(ken_burns_pan_y_anim);
+    if (zoom != NO_TWEEN) ken_burns_zoom = tweens.value[zoom];
+    if (pan_x != NO_TWEEN) ken_burns_pan_x = tweens.value[pan_x];
+    if (pan_y != NO_TWEEN) ken_burns_pan_y = tweens.value[pan_y];
+    if (zoom == NO_TWEEN || now_ms - tweens.start_ms[zoom] >= tweens.duration_ms[zoom]) {
+        ken_burns_active = false;
+    }
 }
 
 void AnimationSystem::updateParticleEffects() {
@@ -325,19 +380,13 @@ int AnimationSystem::calculateVisibleChars() const {
 int AnimationSystem::calculateVisibleWords() const {
     if (!text_animation) return 0;
     
-    std::istringstream iss(text_animation->text);
-    std::string word;
-    int total_words = 0;
-    while (iss >> word) total_words++;
-    
     float progress = getTextAnimationProgress();
-    return static_cast<int>(progress * total_words);
+    return static_cast<int>(progress * text_animation->word_ends.size());
 }
 
 int AnimationSystem::calculateVisibleLines() const {
     if (!text_animation) return 0;
     
-    int total_lines = std::count(text_animation->text.begin(), text_animation->text.end(), '\n') + 1;
     float progress = getTextAnimationProgress();
-    return static_cast<int>(progress * total_lines);
+    return static_cast<int>(progress * text_animation->line_ends.size());
 }
\ No newline at end of file
@@ -2,7 +2,8 @@
 #define ANIMATION_SYSTEM_H
 
 #include <chrono>
-#include <functional>
+#include <cstdint>
+#include <string>
 #include <vector>
 #include <memory>
 
@@ -35,29 +36,15 @@ enum class TextAnimationType {
     SLIDE_IN_RIGHT
 };
 
-struct Animation {
-    std::chrono::steady_clock::time_point start_time;
-    float duration;
-    float current_value;
-    float start_value;
-    float end_value;
-    EasingType easing;
-    std::function<void(float)> update_callback;
-    std::function<void()> complete_callback;
-    bool active;
-    bool completed;
-
-    Animation(float start, float end, float duration_ms, EasingType easing_type)
-        : duration(duration_ms), current_value(start), start_value(start), 
-          end_value(end), easing(easing_type), active(false), completed(false) {}
-};
+// Names a value tween; 0 is never issued
+using AnimationHandle = uint32_t;
 
 struct TransitionAnimation {
     TransitionType type;
     float duration;
     EasingType easing;
     bool active;
-    std::chrono::steady_clock::time_point start_time;
+    AnimationHandle tween = 0;
     float progress;
 
     TransitionAnimation(TransitionType t, float d, EasingType e) 
@@ -71,11 +58,16 @@ struct TextAnimation {
     float word_delay;
     float line_delay;
     bool active;
-    std::chrono::steady_clock::time_point start_time;
+    AnimationHandle tween = 0; // progress, 0 to 1
+    float progress = 0.0f;
     int current_char;
     int current_word;
     int current_line;
     std::string text;
+    // Laid out once at start so each frame only takes a prefix
+    std::string words; // text's words joined by single spaces
+    std::vector<size_t> word_ends; // end of each word in words
+    std::vector<size_t> line_ends; // end of each line in text
 
     TextAnimation(TextAnimationType t, float d) 
         : type(t), duration(d), char_delay(0.05f), word_delay(0.1f), 
@@ -83,6 +75,10 @@ struct TextAnimation {
           current_word(0), current_line(0) {}
 };
 
+// Every animation — transitions, text reveals, Ken Burns and plain values —
+// runs as a tween in one struct-of-arrays table that update() sweeps in a
+// single loop, easing through a function table. Nothing is allocated or
+// called through type erasure per frame; state is read back by handle.
 class AnimationSystem {
 public:
     AnimationSystem();
@@ -106,10 +102,13 @@ public:
     std::string getAnimatedText() const;
     float getTextAnimationProgress() const;
     
-    // Value animations
-    std::shared_ptr<Animation> animateValue(float start, float end, float duration, 
-                                          EasingType easing = EasingType::EASE_IN_OUT);
-    void stopAnimation(std::shared_ptr<Animation> animation);
+    // Value animations; duration in milliseconds
+    AnimationHandle animateValue(float start, float end, float duration,
+                                 EasingType easing = EasingType::EASE_IN_OUT);
+    void stopAnimation(AnimationHandle animation);
+    bool isAnimationActive(AnimationHandle animation) const;
+    // Value as of the last update(); fallback once the tween has finished or stopped
+    float getAnimationValue(AnimationHandle animation, float fallback = 0.0f) const;
     
     // Ken Burns effect (slow zoom/pan for images)
     void startKenBurnsEffect(float zoom_start = 1.0f, float zoom_end = 1.1f, 
@@ -132,9 +131,33 @@ public:
     static float easeInOutQuad(float t);
     static float easeBounce(float t);
     static float easeElastic(float t);
+    static float applyEasing(float t, EasingType easing);
     
 private:
-    std::vector<std::shared_ptr<Animation>> animations;
+    // Active tweens, one index across all arrays; times in milliseconds
+    // since the system was made. Finished tweens are swapped out with the
+    // last, so the arrays only grow to the most ever active at once.
+    struct Tweens {
+        std::vector<AnimationHandle> handle;
+        std::vector<float> start_ms;
+        std::vector<float> duration_ms;
+        std::vector<float> from;
+        std::vector<float> to;
+        std::vector<float> value;
+        std::vector<EasingType> easing;
+
+        size_t size() const { return handle.size(); }
+        void push(AnimationHandle id, float start, float duration, float from_value, float to_value,
+                  EasingType easing_type);
+        void swapRemove(size_t index);
+        void clear();
+    };
+
+    Tweens tweens;
+    AnimationHandle next_handle = 1;
+    std::chrono::steady_clock::time_point epoch;
+    float now_ms = 0.0f; // as of the last update()
+
     std::unique_ptr<TransitionAnimation> transition;
     std::unique_ptr<TextAnimation> text_animation;
     
@@ -143,9 +166,9 @@ private:
     float ken_burns_zoom;
     float ken_burns_pan_x;
     float ken_burns_pan_y;
-    std::shared_ptr<Animation> ken_burns_zoom_anim;
-    std::shared_ptr<Animation> ken_burns_pan_x_anim;
-    std::shared_ptr<Animation> ken_burns_pan_y_anim;
+    AnimationHandle ken_burns_zoom_anim = 0;
+    AnimationHandle ken_burns_pan_x_anim = 0;
+    AnimationHandle ken_burns_pan_y_anim = 0;
     
     // Particle effects
     bool particle_effect_active;
@@ -153,10 +176,12 @@ private:
     std::chrono::steady_clock::time_point particle_start_time;
     
     // Helper methods
-    float applyEasing(float t, EasingType easing);
+    size_t findTween(AnimationHandle animation) const;
+    float elapsedMs() const;
+    void updateTweens();
+    void retireFinishedTweens();
     void updateTransition();
     void updateTextAnimation();
-    void updateValueAnimations();
     void updateKenBurnsEffect();
     void updateParticleEffects();
     
@@ -1,9 +1,30 @@
 #include "MediaManager.h"
+#include "../../core/TaskScheduler.h"
+
+// OpenGL loader, as picked by the build for the ImGui backend
+#ifdef IMGUI_IMPL_OPENGL_LOADER_GLEW
+#include <GL/glew.h>
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+#include <GL/gl3w.h>
+#else
+#include "../../opengl_loader.h"
+#endif
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_JPEG
+#define STBI_ONLY_PNG
+#define STBI_ONLY_BMP
+#define STBI_ONLY_TGA
+#define STBI_ONLY_GIF
+#include <stb_image.h>
+
 #include <imgui.h>
 #include <filesystem>
 #include <algorithm>
+#include <cstring>
 #include <fstream>
 #include <ctime>
+#include <iostream>
 #include <random>
 
 MediaManager::MediaManager() 
@@ -15,9 +36,21 @@ MediaManager::MediaManager()
     current_background.type = BackgroundType::SOLID_COLOR;
     current_background.colors.clear();
     current_background.colors.push_back(0xFF000000); // Black
+    
+    // Resident textures are all that is charged to MEDIA
+    auto texture_bytes = []() {
+        return static_cast<size_t>(std::max<int64_t>(MemoryAccounting::usage(MemoryTag::MEDIA).live_bytes, 0));
+    };
+    texture_cache_registration = CacheManager::shared().add(
+        {"media_textures", TEXTURE_CACHE_WEIGHT, texture_bytes, [this](size_t bytes) { texture_budget = bytes; }});
 }
 
 MediaManager::~MediaManager() {
+    {
+        std::lock_guard<std::mutex> lock(decode_queue->mutex);
+        decode_queue->closed = true;
+        decode_queue->ready.clear();
+    }
     clearAllAssets();
     shutdownCamera();
 }
@@ -65,6 +98,7 @@ bool MediaManager::loadMediaAsset(const std::string& file_path, const std::strin
     }
     
     if (load_success) {
+        texture_memory.add(textureBytes(asset));
         media_assets[asset_id] = asset;
         return true;
     }
@@ -75,7 +109,8 @@ bool MediaManager::loadMediaAsset(const std::string& file_path, const std::strin
 bool MediaManager::unloadMediaAsset(const std::string& media_id) {
     auto it = media_assets.find(media_id);
     if (it != media_assets.end()) {
-        // TODO: Release GPU resources if any
+        releaseTexture(media_id);
+        texture_memory.subtract(textureBytes(it->second)); // a video's frame
         media_assets.erase(it);
         return true;
     }
@@ -83,7 +118,10 @@ bool MediaManager::unloadMediaAsset(const std::string& media_id) {
 }
 
 void MediaManager::clearAllAssets() {
+    // Textures are only forgotten here; releaseTextures() frees them
+    textures.clear();
     media_assets.clear();
+    texture_memory.set(0);
     current_background_texture = 0;
 }
 
@@ -208,10 +246,14 @@ void MediaManager::setBackground(const BackgroundConfig& config) {
     current_background = config;
     
     // Update background texture if needed
-    if (config.type == BackgroundType::IMAGE || config.type == BackgroundType::VIDEO) {
-        const MediaAsset* asset = getAsset(config.media_id);
-        if (asset && asset->loaded) {
-            // TODO: Set current_background_texture from asset
+    current_background_texture = 0;
+    if (config.type == BackgroundType::IMAGE || config.type == BackgroundType::SEASONAL_THEME ||
+        config.type == BackgroundType::DYNAMIC_WEATHER) {
+        auto it = textures.find(config.media_id);
+        if (it != textures.end()) {
+            current_background_texture = it->second.texture;
+        } else {
+            requestDecode(config.media_id);
         }
     }
     
@@ -356,6 +398,8 @@ void MediaManager::setCameraSettings(int width, int height, float fps) {
 
 // Rendering interface
 void MediaManager::renderCurrentBackground(const ImVec2& position, const ImVec2& size) {
+    uploadDecodedTextures();
+
     switch (current_background.type) {
         case BackgroundType::SOLID_COLOR:
             renderSolidBackground(position, size);
@@ -428,14 +472,164 @@ MediaType MediaManager::detectMediaType(const std::string& file_path) const {
 }
 
 bool MediaManager::loadImageAsset(MediaAsset& asset) {
-    // TODO: Implement actual image loading using stb_image or similar
-    // For now, just mark as loaded
-    asset.loaded = true;
-    asset.width = 1920; // Placeholder
-    asset.height = 1080; // Placeholder
+    // Only the header is read here; the pixels are decoded when first needed
+    int channels = 0;
+    if (!stbi_info(asset.file_path.c_str(), &asset.width, &asset.height, &channels)) {
+        std::cerr << "Unsupported image " << asset.file_path << ": " << stbi_failure_reason() << std::endl;
+        return false;
+    }
+    asset.loaded = false;
     return true;
 }
 
+// Background decoding and texture cache
+void MediaManager::preloadAssets(const std::vector<std::string>& asset_ids) {
+    for (const auto& id : asset_ids) {
+        requestDecode(id);
+    }
+}
+
+void MediaManager::requestDecode(const std::string& media_id) {
+    const MediaAsset* asset = getAsset(media_id);
+    if (!asset || asset->type != MediaType::IMAGE || textures.count(media_id) ||
+        !decodes_in_flight.insert(media_id).second) {
+        return;
+    }
+
+    TaskScheduler::shared().post([queue = decode_queue, id = media_id, path = asset->file_path]() {
+        DecodedImage image;
+        image.asset_id = id;
+        int channels = 0;
+        unsigned char* pixels = stbi_load(path.c_str(), &image.width, &image.height, &channels, 4);
+        if (pixels) {
+            image.pixels.reset(pixels, stbi_image_free);
+        } else {
+            std::cerr << "Failed to decode " << path << ": " << stbi_failure_reason() << std::endl;
+        }
+
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (!queue->closed) {
+            queue->ready.push_back(std::move(image));
+        }
+    }, TaskPriority::PREFETCH);
+}
+
+void MediaManager::uploadDecodedTextures() {
+    DecodedImage image;
+    bool decoded = false;
+    {
+        std::lock_guard<std::mutex> lock(decode_queue->mutex);
+        if (!decode_queue->ready.empty()) {
+            image = std::move(decode_queue->ready.front());
+            decode_queue->ready.erase(decode_queue->ready.begin());
+            decoded = true;
+        }
+    }
+    if (!decoded) {
+        evictTextures(); // the budget may have shrunk since the last upload
+        return;
+    }
+    decodes_in_flight.erase(image.asset_id);
+
+    // A failed decode, or an asset unloaded while it decoded, leaves nothing to upload
+    auto asset_it = media_assets.find(image.asset_id);
+    if (!image.pixels || asset_it == media_assets.end()) return;
+    MediaAsset& asset = asset_it->second;
+
+    // Streamed through a pixel buffer so the driver can copy it to the
+    // texture asynchronously rather than stalling on client memory
+    size_t bytes = static_cast<size_t>(image.width) * static_cast<size_t>(image.height) * 4;
+    if (!upload_buffer) {
+        glGenBuffers(1, &upload_buffer);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, upload_buffer);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    const void* source = nullptr;
+    if (mapped) {
+        std::memcpy(mapped, image.pixels.get(), bytes);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    } else {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        source = image.pixels.get();
+    }
+
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.width, image.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, source);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    textures[asset.id] = TextureEntry{texture, image.width, image.height};
+    asset.width = image.width;
+    asset.height = image.height;
+    asset.loaded = true;
+    texture_memory.add(textureBytes(asset));
+    if (current_background.media_id == asset.id) {
+        current_background_texture = texture;
+    }
+
+    evictTextures();
+}
+
+void MediaManager::evictTextures() {
+    if (texture_memory.size() <= texture_budget) return;
+
+    std::vector<std::pair<std::chrono::system_clock::time_point, std::string>> by_age;
+    by_age.reserve(textures.size());
+    for (const auto& entry : textures) {
+        const MediaAsset* asset = getAsset(entry.first);
+        if (asset && entry.first != current_background.media_id) {
+            by_age.emplace_back(asset->last_used, entry.first);
+        }
+    }
+    std::sort(by_age.begin(), by_age.end());
+    for (const auto& [last_used, id] : by_age) {
+        if (texture_memory.size() <= texture_budget) break;
+        releaseTexture(id);
+    }
+}
+
+void MediaManager::releaseTexture(const std::string& media_id) {
+    auto it = textures.find(media_id);
+    if (it == textures.end()) return;
+
+    GLuint texture = it->second.texture;
+    glDeleteTextures(1, &texture);
+    textures.erase(it);
+    if (MediaAsset* asset = getAsset(media_id)) {
+        texture_memory.subtract(textureBytes(*asset));
+        asset->loaded = false;
+    }
+}
+
+void MediaManager::releaseTextures() {
+    while (!textures.empty()) {
+        releaseTexture(textures.begin()->first);
+    }
+    if (upload_buffer) {
+        glDeleteBuffers(1, &upload_buffer);
+        upload_buffer = 0;
+    }
+    current_background_texture = 0;
+}
+
+size_t MediaManager::getTotalMemoryUsage() const {
+    return texture_memory.size();
+}
+
+size_t MediaManager::textureBytes(const MediaAsset& asset) {
+    // One RGBA frame; a video keeps one decoded frame resident at a time
+    if (!asset.loaded || asset.width <= 0 || asset.height <= 0) return 0;
+    return static_cast<size_t>(asset.width) * static_cast<size_t>(asset.height) * 4;
+}
+
 bool MediaManager::loadVideoAsset(MediaAsset& asset) {
     // TODO: Implement actual video loading
     // For now, just mark as loaded
@@ -503,9 +697,38 @@ void MediaManager::renderGradientBackground(const ImVec2& position, const ImVec2
 }
 
 void MediaManager::renderImageBackground(const ImVec2& position, const ImVec2& size) {
-    // TODO: Implement actual image rendering
-    // For now, render a placeholder
-    renderSolidBackground(position, size);
+    auto it = textures.find(current_background.media_id);
+    if (it == textures.end()) {
+        // Solid colour until the decode lands
+        requestDecode(current_background.media_id);
+        renderSolidBackground(position, size);
+        return;
+    }
+    if (MediaAsset* asset = getAsset(current_background.media_id)) {
+        asset->last_used = std::chrono::system_clock::now();
+    }
+
+    // Cover the area, cropping whichever axis of the image overflows it
+    const TextureEntry& entry = it->second;
+    ImVec2 uv_min(0.0f, 0.0f);
+    ImVec2 uv_max(1.0f, 1.0f);
+    if (entry.width > 0 && entry.height > 0 && size.x > 0.0f && size.y > 0.0f) {
+        float image_aspect = static_cast<float>(entry.width) / static_cast<float>(entry.height);
+        float area_aspect = size.x / size.y;
+        if (image_aspect > area_aspect) {
+            float visible = area_aspect / image_aspect;
+            uv_min.x = (1.0f - visible) * 0.5f;
+            uv_max.x = uv_min.x + visible;
+        } else {
+            float visible = image_aspect / area_aspect;
+            uv_min.y = (1.0f - visible) * 0.5f;
+            uv_max.y = uv_min.y + visible;
+        }
+    }
+
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    draw_list->AddImage(reinterpret_cast<ImTextureID>(static_cast<intptr_t>(entry.texture)), position,
+                        ImVec2(position.x + size.x, position.y + size.y), uv_min, uv_max);
 }
 
 void MediaManager::renderVideoBackground(const ImVec2& position, const ImVec2& size) {
@@ -8,6 +8,11 @@
 #include <memory>
 #include <chrono>
 #include <functional>
+#include <mutex>
+#include <unordered_set>
+#include <atomic>
+#include "../../core/MemoryAccounting.h"
+#include "../../core/CacheManager.h"
 
 enum class MediaType {
     IMAGE,
@@ -34,7 +39,7 @@ struct MediaAsset {
     std::string description;
     std::vector<std::string> tags;
     std::chrono::system_clock::time_point last_used;
-    bool loaded;
+    bool loaded; // decoded and resident as a texture
     size_t file_size;
     int width;
     int height;
@@ -91,8 +96,18 @@ struct SeasonalTheme {
     SeasonalTheme() : active(false) {}
 };
 
+// Images are decoded on the shared TaskScheduler pool and uploaded to
+// textures on the GL thread through a pixel buffer, one per frame, so
+// neither a slow disk nor a large JPEG holds up a frame. Textures are
+// cached by MediaAsset::id within a memory budget, least recently used
+// (MediaAsset::last_used) evicted first. The CacheManager sets the budget,
+// from any thread; the GL thread evicts down to it on its next frame.
 class MediaManager {
 public:
+    static constexpr size_t DEFAULT_TEXTURE_BUDGET = 256 * 1024 * 1024;
+    // Against the CacheManager's other caches: megabytes per texture, each one decode to redo
+    static constexpr double TEXTURE_CACHE_WEIGHT = 1.0;
+
     MediaManager();
     ~MediaManager();
     
@@ -152,6 +167,13 @@ public:
     
     // Asset optimization
     void preloadAssets(const std::vector<std::string>& asset_ids);
+    // Starts decoding an image asset in the background unless it is resident or on its way
+    void requestDecode(const std::string& media_id);
+    // Uploads a decoded image, if one is waiting, and evicts past the budget; GL thread only
+    void uploadDecodedTextures();
+    void setTextureBudget(size_t bytes) { texture_budget = bytes; }
+    // Frees the textures; call on the GL thread with the context they were made in current
+    void releaseTextures();
     void unloadUnusedAssets(std::chrono::minutes unused_threshold = std::chrono::minutes(30));
     size_t getTotalMemoryUsage() const;
     void optimizeMemoryUsage();
@@ -171,7 +193,31 @@ public:
     static bool isFormatSupported(const std::string& file_path);
     
 private:
+    // Decoded pixels on their way from the decode pool to the GL thread
+    struct DecodedImage {
+        std::string asset_id;
+        int width = 0;
+        int height = 0;
+        std::shared_ptr<unsigned char> pixels; // RGBA
+    };
+    // Shared with decode tasks, so one finishing after the manager is gone is harmless
+    struct DecodeQueue {
+        std::mutex mutex;
+        std::vector<DecodedImage> ready;
+        bool closed = false;
+    };
+    struct TextureEntry {
+        unsigned int texture = 0;
+        int width = 0;
+        int height = 0;
+    };
+
     std::unordered_map<std::string, MediaAsset> media_assets;
+    std::shared_ptr<DecodeQueue> decode_queue = std::make_shared<DecodeQueue>();
+    std::unordered_set<std::string> decodes_in_flight;
+    std::unordered_map<std::string, TextureEntry> textures; // by MediaAsset::id
+    std::atomic<size_t> texture_budget{DEFAULT_TEXTURE_BUDGET};
+    unsigned int upload_buffer = 0; // pixel unpack buffer the uploads stream through
     std::vector<SeasonalTheme> seasonal_themes;
     BackgroundConfig current_background;
     
@@ -188,6 +234,7 @@ private:
     
     // Rendering
     uint32_t current_background_texture;
+    MemoryCharge texture_memory{MemoryTag::MEDIA}; // resident textures
     
     // Dynamic background state
     bool weather_enabled;
@@ -197,7 +244,13 @@ private:
     // Callbacks
     std::function<void(const BackgroundConfig&)> background_change_callback;
     
+    // Last, so released before anything its callbacks read
+    CacheManager::Registration texture_cache_registration;
+    
     // Helper methods
+    static size_t textureBytes(const MediaAsset& asset);
+    void evictTextures();
+    void releaseTexture(const std::string& media_id);
     std::string generateAssetId(const std::string& file_path) const;
     MediaType detectMediaType(const std::string& file_path) const;
     bool loadImageAsset(MediaAsset& asset);
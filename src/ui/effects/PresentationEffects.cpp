@@ -67,6 +67,11 @@ void PresentationEffects::beginTextEffects(const ImVec2& position, const ImVec2&
         renderTextBackground(position, size);
     }
     
+    // One shader pass per layer group instead of one draw per offset
+    if (renderWithShader(position, size, text)) {
+        return;
+    }
+    
     // Render effects in order (back to front)
     if (drop_shadow.enabled) {
         renderDropShadow(position, size, text, current_font, current_font_size);
@@ -316,6 +321,107 @@ void PresentationEffects::drawBlurredRect(ImDrawList* draw_list, const ImVec2& m
 }
 
 // Private helper methods
+bool PresentationEffects::renderWithShader(const ImVec2& position, const ImVec2& size, const std::string& text) {
+    bool any_effect = drop_shadow.enabled || glow.enabled || outline.enabled || stroke.enabled || gradient.enabled;
+    if (!gpu_effects_enabled || !any_effect || !effect_shader.available() || !current_draw_list) {
+        return false;
+    }
+    
+    // Effects must fit in the padding the atlas leaves around each glyph
+    ImFontAtlas* atlas = current_font->ContainerAtlas;
+    float texels_per_pixel = current_font->FontSize / current_font_size;
+    float reach = effectReach();
+    if (reach * texels_per_pixel > TextEffectShader::reachTexels(atlas)) {
+        return false;
+    }
+    
+    TextEffectShader::Params params;
+    params.texels_per_pixel = texels_per_pixel;
+    
+    bool any_layer = drop_shadow.enabled || glow.enabled || outline.enabled || stroke.enabled;
+    if (any_layer) {
+        params.effects_pass = true;
+        if (drop_shadow.enabled) {
+            params.shadow_color = drop_shadow.color;
+            params.shadow_offset = ImVec2(drop_shadow.offset_x, drop_shadow.offset_y);
+            params.shadow_blur = drop_shadow.blur_radius * 0.5f;
+        }
+        if (glow.enabled) {
+            params.glow_color = glow.color;
+            params.glow_color.w *= glow.strength;
+            params.glow_radius = glow.radius;
+        }
+        // A stroke is drawn over any outline, so it wins where both are set
+        if (stroke.enabled) {
+            params.outline_color = stroke.stroke_color;
+            params.outline_width = stroke.width;
+        } else if (outline.enabled) {
+            params.outline_color = outline.color;
+            params.outline_width = outline.thickness;
+        }
+        
+        int vtx_start = current_draw_list->VtxBuffer.Size;
+        effect_shader.begin(current_draw_list, params);
+        current_draw_list->AddText(current_font, current_font_size, position, IM_COL32_WHITE, text.c_str());
+        float margin = std::ceil(reach);
+        expandGlyphQuads(current_draw_list, vtx_start, margin,
+                         ImVec2(margin * texels_per_pixel * atlas->TexUvScale.x,
+                                margin * texels_per_pixel * atlas->TexUvScale.y));
+    }
+    
+    // The fill goes in a pass of its own so no glyph's effects cover its neighbour
+    params.effects_pass = false;
+    if (stroke.enabled) {
+        params.fill = stroke.color;
+    } else if (gradient.enabled) {
+        float radians = gradient.angle * static_cast<float>(M_PI) / 180.0f;
+        ImVec2 direction(std::cos(radians), std::sin(radians));
+        float half_span = 0.5f * (std::abs(direction.x) * size.x + std::abs(direction.y) * size.y);
+        ImVec2 center(position.x + size.x * 0.5f, position.y + size.y * 0.5f);
+        params.gradient = true;
+        params.gradient_start = gradient.start_color;
+        params.gradient_end = gradient.end_color;
+        params.gradient_from = ImVec2(center.x - direction.x * half_span, center.y - direction.y * half_span);
+        params.gradient_to = ImVec2(center.x + direction.x * half_span, center.y + direction.y * half_span);
+    }
+    effect_shader.begin(current_draw_list, params);
+    current_draw_list->AddText(current_font, current_font_size, position, IM_COL32_WHITE, text.c_str());
+    effect_shader.end(current_draw_list);
+    return true;
+}
+
+float PresentationEffects::effectReach() const {
+    float reach = 0.0f;
+    if (drop_shadow.enabled) {
+        reach = std::max(reach, std::max(std::abs(drop_shadow.offset_x), std::abs(drop_shadow.offset_y)) +
+                                drop_shadow.blur_radius * 0.5f);
+    }
+    if (glow.enabled) reach = std::max(reach, glow.radius);
+    if (outline.enabled) reach = std::max(reach, outline.thickness);
+    if (stroke.enabled) reach = std::max(reach, stroke.width);
+    return reach + 1.0f; // Room for the antialiased edge
+}
+
+void PresentationEffects::expandGlyphQuads(ImDrawList* draw_list, int vtx_start, float margin, ImVec2 uv_margin) {
+    // AddText emits one four-vertex quad per glyph; grow each so the shader
+    // has pixels to draw effects on beyond the glyph's own box
+    for (int i = vtx_start; i + 3 < draw_list->VtxBuffer.Size; i += 4) {
+        ImDrawVert* quad = &draw_list->VtxBuffer[i];
+        ImVec2 pos_min = quad[0].pos;
+        for (int v = 1; v < 4; v++) {
+            pos_min = ImVec2(std::min(pos_min.x, quad[v].pos.x), std::min(pos_min.y, quad[v].pos.y));
+        }
+        for (int v = 0; v < 4; v++) {
+            float sx = quad[v].pos.x == pos_min.x ? -1.0f : 1.0f;
+            float sy = quad[v].pos.y == pos_min.y ? -1.0f : 1.0f;
+            quad[v].pos.x += sx * margin;
+            quad[v].pos.y += sy * margin;
+            quad[v].uv.x += sx * uv_margin.x;
+            quad[v].uv.y += sy * uv_margin.y;
+        }
+    }
+}
+
 void PresentationEffects::renderTextWithColor(const ImVec2& position, const std::string& text, 
                                             ImFont* font, float font_size, ImU32 color) {
     if (!current_draw_list) return;
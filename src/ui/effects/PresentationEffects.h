@@ -2,6 +2,7 @@
 #define PRESENTATION_EFFECTS_H
 
 #include <imgui.h>
+#include "TextEffectShader.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -124,6 +125,15 @@ public:
     static void drawBlurredRect(ImDrawList* draw_list, const ImVec2& min, const ImVec2& max, 
                                ImU32 color, float blur_radius, float corner_radius = 0.0f);
     
+    // Shader-drawn effects; on by default, with the draw-list path kept for
+    // effects reaching past the atlas padding and for a failed shader
+    void setGpuEffectsEnabled(bool enabled) { gpu_effects_enabled = enabled; }
+    bool isGpuEffectsEnabled() const { return gpu_effects_enabled; }
+    // Lets effects reach their full size; call before the font atlas is built
+    static void reserveEffectPadding(ImFontAtlas* atlas) { TextEffectShader::reserveAtlasPadding(atlas); }
+    // Frees GL objects; call with the context they were made in current
+    void releaseGpuResources() { effect_shader.release(); }
+    
 private:
     DropShadowEffect drop_shadow;
     OutlineEffect outline;
@@ -140,12 +150,18 @@ private:
     ImFont* current_font;
     float current_font_size;
     
+    TextEffectShader effect_shader;
+    bool gpu_effects_enabled = true;
+    
     // Helper methods
     void renderTextWithColor(const ImVec2& position, const std::string& text, 
                            ImFont* font, float font_size, ImU32 color);
     void renderTextMultiple(const ImVec2& position, const std::string& text, 
                            ImFont* font, float font_size, ImU32 color, 
                            int offset_x, int offset_y, int samples = 8);
+    bool renderWithShader(const ImVec2& position, const ImVec2& size, const std::string& text);
+    float effectReach() const;
+    static void expandGlyphQuads(ImDrawList* draw_list, int vtx_start, float margin, ImVec2 uv_margin);
     ImU32 imVec4ToImU32(const ImVec4& color);
     float calculateFontSize(ImFont* font, float desired_size);
 };
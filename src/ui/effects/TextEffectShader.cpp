@@ -0,0 +1,360 @@
+#include "TextEffectShader.h"
+
+// OpenGL loader, as picked by the build for the ImGui backend
+#ifdef IMGUI_IMPL_OPENGL_LOADER_GLEW
+#include <GL/glew.h>
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+#include <GL/gl3w.h>
+#else
+#include "../../opengl_loader.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+#ifdef __APPLE__
+const char* GLSL_VERSION = "#version 150\n";
+#else
+const char* GLSL_VERSION = "#version 130\n";
+#endif
+
+const char* VERTEX_SHADER = R"(
+uniform mat4 ProjMtx;
+in vec2 Position;
+in vec2 UV;
+in vec4 Color;
+out vec2 Frag_UV;
+out vec4 Frag_Color;
+out vec2 Frag_Pos;
+void main() {
+    Frag_UV = UV;
+    Frag_Color = Color;
+    Frag_Pos = Position;
+    gl_Position = ProjMtx * vec4(Position.xy, 0, 1);
+}
+)";
+
+// Layers are composited premultiplied, back to front, and un-premultiplied
+// at the end for the backend's SRC_ALPHA blending
+const char* FRAGMENT_SHADER = R"(
+uniform sampler2D Field;
+uniform float Spread;
+uniform float TexelsPerPixel;
+uniform vec2 TexelUv;
+uniform int EffectsPass;
+uniform vec4 Fill;
+uniform int Gradient;
+uniform vec4 GradientStart;
+uniform vec4 GradientEnd;
+uniform vec2 GradientFrom;
+uniform vec2 GradientTo;
+uniform vec4 OutlineColor;
+uniform float OutlineWidth;
+uniform vec4 GlowColor;
+uniform float GlowRadius;
+uniform vec4 ShadowColor;
+uniform vec2 ShadowOffset;
+uniform float ShadowBlur;
+in vec2 Frag_UV;
+in vec4 Frag_Color;
+in vec2 Frag_Pos;
+out vec4 Out_Color;
+
+// Screen pixels from the glyph edge; negative inside
+float distanceAt(vec2 uv) {
+    return (texture(Field, uv).r - 0.5) * 2.0 * Spread / TexelsPerPixel;
+}
+
+vec4 layer(vec4 color, float coverage) {
+    float alpha = color.a * coverage;
+    return vec4(color.rgb * alpha, alpha);
+}
+
+vec4 over(vec4 top, vec4 base) {
+    return top + base * (1.0 - top.a);
+}
+
+void main() {
+    float d = distanceAt(Frag_UV);
+    float aa = max(fwidth(d), 0.0001);
+    vec4 color = vec4(0.0);
+
+    if (EffectsPass != 0) {
+        if (ShadowColor.a > 0.0) {
+            float ds = distanceAt(Frag_UV - ShadowOffset * TexelsPerPixel * TexelUv);
+            float blur = max(ShadowBlur, aa);
+            color = layer(ShadowColor, 1.0 - smoothstep(-blur, blur, ds));
+        }
+        if (GlowColor.a > 0.0 && GlowRadius > 0.0) {
+            color = over(layer(GlowColor, 1.0 - smoothstep(0.0, GlowRadius, d)), color);
+        }
+        if (OutlineColor.a > 0.0 && OutlineWidth > 0.0) {
+            color = over(layer(OutlineColor, clamp(0.5 - (d - OutlineWidth) / aa, 0.0, 1.0)), color);
+        }
+    } else {
+        vec4 fill = Fill;
+        if (Gradient != 0) {
+            vec2 span = GradientTo - GradientFrom;
+            float t = clamp(dot(Frag_Pos - GradientFrom, span) / max(dot(span, span), 0.0001), 0.0, 1.0);
+            fill = mix(GradientStart, GradientEnd, t);
+        }
+        color = layer(fill, clamp(0.5 - d / aa, 0.0, 1.0));
+    }
+
+    color *= Frag_Color.a;
+    Out_Color = color.a > 0.0 ? vec4(color.rgb / color.a, color.a) : vec4(0.0);
+}
+)";
+
+GLuint compileShader(GLenum type, const char* source) {
+    const char* sources[2] = {GLSL_VERSION, source};
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 2, sources, nullptr);
+    glCompileShader(shader);
+
+    GLint status = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (status != GL_TRUE) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        std::cerr << "Text effect shader failed to compile: " << log << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+// Euclidean distance, in texels, from each texel to the nearest texel where
+// solid is true, by the two-pass 8SSEDT sweep
+std::vector<float> distanceTo(const std::vector<bool>& solid, int width, int height) {
+    const int FAR = 1 << 14;
+    struct Offset { int dx, dy; int lengthSquared() const { return dx * dx + dy * dy; } };
+    std::vector<Offset> grid(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < grid.size(); i++) {
+        grid[i] = solid[i] ? Offset{0, 0} : Offset{FAR, FAR};
+    }
+
+    auto at = [&](int x, int y) -> Offset {
+        if (x < 0 || y < 0 || x >= width || y >= height) return Offset{FAR, FAR};
+        return grid[static_cast<size_t>(y) * width + x];
+    };
+    auto compare = [&](Offset& current, int x, int y, int ox, int oy) {
+        Offset other = at(x + ox, y + oy);
+        other.dx += ox;
+        other.dy += oy;
+        if (other.lengthSquared() < current.lengthSquared()) current = other;
+    };
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            Offset& o = grid[static_cast<size_t>(y) * width + x];
+            compare(o, x, y, -1, 0);
+            compare(o, x, y, 0, -1);
+            compare(o, x, y, -1, -1);
+            compare(o, x, y, 1, -1);
+        }
+        for (int x = width - 1; x >= 0; x--) {
+            compare(grid[static_cast<size_t>(y) * width + x], x, y, 1, 0);
+        }
+    }
+    for (int y = height - 1; y >= 0; y--) {
+        for (int x = width - 1; x >= 0; x--) {
+            Offset& o = grid[static_cast<size_t>(y) * width + x];
+            compare(o, x, y, 1, 0);
+            compare(o, x, y, 0, 1);
+            compare(o, x, y, -1, 1);
+            compare(o, x, y, 1, 1);
+        }
+        for (int x = 0; x < width; x++) {
+            compare(grid[static_cast<size_t>(y) * width + x], x, y, -1, 0);
+        }
+    }
+
+    std::vector<float> distances(grid.size());
+    for (size_t i = 0; i < grid.size(); i++) {
+        distances[i] = std::sqrt(static_cast<float>(grid[i].lengthSquared()));
+    }
+    return distances;
+}
+
+} // namespace
+
+void TextEffectShader::reserveAtlasPadding(ImFontAtlas* atlas) {
+    // Twice the spread keeps a glyph's effects clear of its atlas neighbours
+    atlas->TexGlyphPadding = std::max(atlas->TexGlyphPadding, 2 * FIELD_SPREAD);
+}
+
+float TextEffectShader::reachTexels(const ImFontAtlas* atlas) {
+    return static_cast<float>(std::min(FIELD_SPREAD, atlas->TexGlyphPadding / 2));
+}
+
+void TextEffectShader::begin(ImDrawList* draw_list, const Params& params) {
+    int frame = ImGui::GetFrameCount();
+    if (frame != bindings_frame) {
+        bindings.clear();
+        bindings_frame = frame;
+    }
+    bindings.push_back(Binding{this, params});
+    draw_list->AddCallback(bindCallback, &bindings.back());
+}
+
+void TextEffectShader::end(ImDrawList* draw_list) {
+    draw_list->AddCallback(ImDrawCallback_ResetRenderState, nullptr);
+}
+
+void TextEffectShader::bindCallback([[maybe_unused]] const ImDrawList* draw_list, const ImDrawCmd* cmd) {
+    const Binding* binding = static_cast<const Binding*>(cmd->UserCallbackData);
+    binding->shader->bind(binding->params);
+}
+
+void TextEffectShader::bind(const Params& params) {
+    if (failed) return;
+    if (!program && !buildProgram()) return;
+
+    ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+    if (field_source != atlas->TexID && !buildField(atlas)) return;
+
+    // Same projection the backend sets up for the draw data
+    ImDrawData* draw_data = ImGui::GetDrawData();
+    float L = draw_data->DisplayPos.x;
+    float R = draw_data->DisplayPos.x + draw_data->DisplaySize.x;
+    float T = draw_data->DisplayPos.y;
+    float B = draw_data->DisplayPos.y + draw_data->DisplaySize.y;
+    const float ortho[4][4] = {
+        {2.0f / (R - L), 0.0f, 0.0f, 0.0f},
+        {0.0f, 2.0f / (T - B), 0.0f, 0.0f},
+        {0.0f, 0.0f, -1.0f, 0.0f},
+        {(R + L) / (L - R), (T + B) / (B - T), 0.0f, 1.0f},
+    };
+
+    glUseProgram(program);
+    glUniformMatrix4fv(glGetUniformLocation(program, "ProjMtx"), 1, GL_FALSE, &ortho[0][0]);
+    glUniform1i(glGetUniformLocation(program, "Field"), 1);
+    glUniform1f(glGetUniformLocation(program, "Spread"), static_cast<float>(FIELD_SPREAD));
+    glUniform1f(glGetUniformLocation(program, "TexelsPerPixel"), params.texels_per_pixel);
+    glUniform2f(glGetUniformLocation(program, "TexelUv"), atlas->TexUvScale.x, atlas->TexUvScale.y);
+    glUniform1i(glGetUniformLocation(program, "EffectsPass"), params.effects_pass ? 1 : 0);
+    glUniform4f(glGetUniformLocation(program, "Fill"), params.fill.x, params.fill.y, params.fill.z, params.fill.w);
+    glUniform1i(glGetUniformLocation(program, "Gradient"), params.gradient ? 1 : 0);
+    glUniform4f(glGetUniformLocation(program, "GradientStart"), params.gradient_start.x, params.gradient_start.y,
+                params.gradient_start.z, params.gradient_start.w);
+    glUniform4f(glGetUniformLocation(program, "GradientEnd"), params.gradient_end.x, params.gradient_end.y,
+                params.gradient_end.z, params.gradient_end.w);
+    glUniform2f(glGetUniformLocation(program, "GradientFrom"), params.gradient_from.x, params.gradient_from.y);
+    glUniform2f(glGetUniformLocation(program, "GradientTo"), params.gradient_to.x, params.gradient_to.y);
+    glUniform4f(glGetUniformLocation(program, "OutlineColor"), params.outline_color.x, params.outline_color.y,
+                params.outline_color.z, params.outline_color.w);
+    glUniform1f(glGetUniformLocation(program, "OutlineWidth"), params.outline_width);
+    glUniform4f(glGetUniformLocation(program, "GlowColor"), params.glow_color.x, params.glow_color.y,
+                params.glow_color.z, params.glow_color.w);
+    glUniform1f(glGetUniformLocation(program, "GlowRadius"), params.glow_radius);
+    glUniform4f(glGetUniformLocation(program, "ShadowColor"), params.shadow_color.x, params.shadow_color.y,
+                params.shadow_color.z, params.shadow_color.w);
+    glUniform2f(glGetUniformLocation(program, "ShadowOffset"), params.shadow_offset.x, params.shadow_offset.y);
+    glUniform1f(glGetUniformLocation(program, "ShadowBlur"), params.shadow_blur);
+
+    // The backend binds the atlas to unit 0 for each draw; the field sits beside it
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, field_texture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+bool TextEffectShader::buildProgram() {
+    // The backend's vertex layout is bound to its own program's attribute
+    // locations, so ours are pinned to the same ones before linking
+    GLint backend_program = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &backend_program);
+
+    GLuint vertex = compileShader(GL_VERTEX_SHADER, VERTEX_SHADER);
+    GLuint fragment = compileShader(GL_FRAGMENT_SHADER, FRAGMENT_SHADER);
+    if (!vertex || !fragment) {
+        if (vertex) glDeleteShader(vertex);
+        if (fragment) glDeleteShader(fragment);
+        failed = true;
+        return false;
+    }
+
+    program = glCreateProgram();
+    glAttachShader(program, vertex);
+    glAttachShader(program, fragment);
+    for (const char* attribute : {"Position", "UV", "Color"}) {
+        GLint location = backend_program ? glGetAttribLocation(backend_program, attribute) : -1;
+        if (location >= 0) {
+            glBindAttribLocation(program, static_cast<GLuint>(location), attribute);
+        }
+    }
+    glLinkProgram(program);
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+
+    GLint status = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        char log[1024];
+        glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+        std::cerr << "Text effect shader failed to link: " << log << std::endl;
+        glDeleteProgram(program);
+        program = 0;
+        failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool TextEffectShader::buildField(ImFontAtlas* atlas) {
+    unsigned char* coverage = nullptr;
+    int width = 0;
+    int height = 0;
+    atlas->GetTexDataAsAlpha8(&coverage, &width, &height);
+    if (!coverage || width <= 0 || height <= 0) return false;
+
+    size_t count = static_cast<size_t>(width) * height;
+    std::vector<bool> inside(count);
+    std::vector<bool> outside(count);
+    for (size_t i = 0; i < count; i++) {
+        inside[i] = coverage[i] >= 128;
+        outside[i] = !inside[i];
+    }
+    std::vector<float> to_inside = distanceTo(inside, width, height);
+    std::vector<float> to_outside = distanceTo(outside, width, height);
+
+    // Edges sit half a texel from the texel centres either side of them
+    std::vector<unsigned char> field(count);
+    for (size_t i = 0; i < count; i++) {
+        float distance = inside[i] ? 0.5f - to_outside[i] : to_inside[i] - 0.5f;
+        float encoded = std::clamp(0.5f + distance / (2.0f * FIELD_SPREAD), 0.0f, 1.0f);
+        field[i] = static_cast<unsigned char>(encoded * 255.0f + 0.5f);
+    }
+
+    GLint last_texture = 0;
+    GLint last_alignment = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &last_texture);
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &last_alignment);
+
+    if (!field_texture) glGenTextures(1, &field_texture);
+    glBindTexture(GL_TEXTURE_2D, field_texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, field.data());
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, last_alignment);
+    glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(last_texture));
+    field_source = atlas->TexID;
+    return true;
+}
+
+void TextEffectShader::release() {
+    if (program) glDeleteProgram(program);
+    if (field_texture) glDeleteTextures(1, &field_texture);
+    program = 0;
+    field_texture = 0;
+    field_source = nullptr;
+    bindings.clear();
+}
@@ -0,0 +1,83 @@
+#ifndef TEXT_EFFECT_SHADER_H
+#define TEXT_EFFECT_SHADER_H
+
+#include <imgui.h>
+#include <deque>
+
+// Draws text effects in a fragment shader over a signed distance field of
+// the ImGui font atlas. Shadow, glow and outline come from one sample pass
+// whatever their size, where drawing the text once per offset grew with
+// radius and thickness. The field is built once per atlas on the CPU.
+//
+// Use on the thread that owns the GL context the draw data is rendered in.
+// Effects reach at most reachTexels() atlas texels past a glyph, which
+// depends on the padding the atlas was built with; see reserveAtlasPadding.
+class TextEffectShader {
+public:
+    // Texels encoded either side of a glyph edge
+    static constexpr int FIELD_SPREAD = 4;
+
+    // Uniforms for one run of text; shadow_offset, widths and radii in screen pixels
+    struct Params {
+        bool effects_pass = false; // true draws shadow, glow and outline; false the fill
+        float texels_per_pixel = 1.0f; // atlas texels per screen pixel at the drawn size
+
+        ImVec4 fill = ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
+        bool gradient = false;
+        ImVec4 gradient_start;
+        ImVec4 gradient_end;
+        ImVec2 gradient_from; // screen positions of the start and end colours
+        ImVec2 gradient_to;
+
+        ImVec4 outline_color = ImVec4(0.0f, 0.0f, 0.0f, 0.0f);
+        float outline_width = 0.0f;
+        ImVec4 glow_color = ImVec4(0.0f, 0.0f, 0.0f, 0.0f);
+        float glow_radius = 0.0f;
+        ImVec4 shadow_color = ImVec4(0.0f, 0.0f, 0.0f, 0.0f);
+        ImVec2 shadow_offset;
+        float shadow_blur = 0.0f;
+    };
+
+    TextEffectShader() = default;
+    // GL objects are not freed here, as no context may be current; call release()
+    ~TextEffectShader() = default;
+
+    TextEffectShader(const TextEffectShader&) = delete;
+    TextEffectShader& operator=(const TextEffectShader&) = delete;
+
+    // Pads glyphs so effects can reach FIELD_SPREAD texels; call before the atlas is built
+    static void reserveAtlasPadding(ImFontAtlas* atlas);
+    // How far past a glyph, in atlas texels, effects can be drawn from atlas
+    static float reachTexels(const ImFontAtlas* atlas);
+
+    // Draws the draw list's following text with params until end(). params
+    // is copied; the draw list must be rendered before the next ImGui frame.
+    void begin(ImDrawList* draw_list, const Params& params);
+    void end(ImDrawList* draw_list);
+
+    // False once the shader failed to build; callers then draw without it
+    bool available() const { return !failed; }
+    void release();
+
+private:
+    struct Binding {
+        TextEffectShader* shader;
+        Params params;
+    };
+
+    unsigned int program = 0;
+    unsigned int field_texture = 0;
+    ImTextureID field_source = nullptr; // atlas texture the field was built from
+    bool failed = false;
+
+    // Keeps callback data alive until the frame that queued it is rendered
+    std::deque<Binding> bindings;
+    int bindings_frame = -1;
+
+    static void bindCallback(const ImDrawList* draw_list, const ImDrawCmd* cmd);
+    void bind(const Params& params);
+    bool buildProgram();
+    bool buildField(ImFontAtlas* atlas);
+};
+
+#endif // TEXT_EFFECT_SHADER_H
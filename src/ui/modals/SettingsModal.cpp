@@ -406,6 +406,15 @@ void SettingsModal::renderAccessibilityTab() {
         ImGui::SetTooltip("Enable voice control for hands-free operation\nCommands: 'Search for John 3:16', 'Presentation mode', 'Blank screen'");
     }
     
+    if (voice_commands) {
+        ImGui::Indent();
+        ImGui::Checkbox("Confirm commands that change the live display", &userSettings.accessibility.voice_confirm_live_commands);
+        if (ImGui::IsItemHovered()) {
+            ImGui::SetTooltip("Spoken navigation, blanking and presentation commands wait for Run before they reach the screen");
+        }
+        ImGui::Unindent();
+    }
+    
     bool audio_feedback = userSettings.accessibility.audio_feedback_enabled;
     if (ImGui::Checkbox("Audio Feedback", &audio_feedback)) {
         userSettings.accessibility.audio_feedback_enabled = audio_feedback;
@@ -0,0 +1,308 @@
+// OpenGL loader - must be included before GLFW
+#ifdef IMGUI_IMPL_OPENGL_LOADER_GLEW
+#include <GL/glew.h>
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+#include <GL/gl3w.h>
+#else
+#include "../../opengl_loader.h"
+#endif
+
+#include "FrameProfiler.h"
+#include <imgui.h>
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+double percentile(std::vector<float> values, double q) {
+    if (values.empty()) return 0.0;
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(q * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+ImU32 sectionColor(const char* name) {
+    // Stable per name, so a section keeps its color from frame to frame
+    uint32_t hash = 2166136261u;
+    for (const char* c = name; *c; ++c) hash = (hash ^ static_cast<unsigned char>(*c)) * 16777619u;
+    float hue = (hash % 360) / 360.0f;
+    float r, g, b;
+    ImGui::ColorConvertHSVtoRGB(hue, 0.5f, 0.75f, r, g, b);
+    return ImGui::GetColorU32(ImVec4(r, g, b, 1.0f));
+}
+
+} // namespace
+
+FrameProfiler::FrameProfiler()
+    : cpu_histogram(MetricsRegistry::shared().histogram(
+          "versefinder_ui_frame_cpu_seconds", "CPU time of one UI frame, excluding vsync")),
+      gpu_histogram(MetricsRegistry::shared().histogram(
+          "versefinder_ui_frame_gpu_seconds", "GPU time drawing one UI frame")) {
+    gpu_query_frames.fill(UINT64_MAX);
+}
+
+FrameProfiler::~FrameProfiler() {
+    scope.reset();
+}
+
+void FrameProfiler::beginFrame() {
+    collectGpuResults();
+    profile = std::make_unique<QueryProfile>();
+    scope.emplace(*profile);
+}
+
+void FrameProfiler::endFrame(std::chrono::steady_clock::duration cpu_time) {
+    scope.reset();
+    if (!profile) return;
+
+    size_t slot = frame % HISTORY;
+    double frame_ms = std::chrono::duration<double, std::milli>(cpu_time).count();
+    cpu_ms[slot] = static_cast<float>(frame_ms);
+    gpu_ms[slot] = 0.0f; // filled in when the query comes back
+    cpu_histogram.observe(cpu_time);
+
+    // A section that ran more than once this frame counts its total
+    std::unordered_map<const char*, double> totals;
+    for (const QueryProfile::Stage& stage : profile->timings()) {
+        totals[stage.name] += stage.duration_ms;
+    }
+    for (auto& [name, section] : sections) section.ms[slot] = 0.0f;
+    for (const auto& [name, total] : totals) {
+        auto it = sections.find(name);
+        if (it == sections.end()) {
+            if (sections.size() >= MAX_SECTIONS) continue;
+            it = sections.emplace(name, Section()).first;
+            it->second.histogram = &MetricsRegistry::shared().histogram(
+                "versefinder_ui_section_duration_seconds", "Time in one section of a UI frame",
+                MetricsRegistry::label("section", name));
+        }
+        it->second.ms[slot] = static_cast<float>(total);
+        it->second.histogram->observe(static_cast<uint64_t>(total * 1000.0));
+    }
+
+    // The flame graph shows the slowest recent frame, which is the one worth explaining
+    if (frame_ms >= slowest_ms || frame - slowest_frame >= HISTORY) {
+        slowest = profile->timings();
+        slowest_ms = frame_ms;
+        slowest_frame = frame;
+    }
+    profile.reset();
+    ++frame;
+}
+
+void FrameProfiler::beginGpu() {
+#ifdef GL_TIME_ELAPSED
+    if (gpu_support == GpuSupport::UNKNOWN) {
+        GLint major = 0;
+        GLint minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        bool available = major > 3 || (major == 3 && minor >= 3);
+        GLint extensions = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensions);
+        for (GLint i = 0; !available && i < extensions; ++i) {
+            const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            available = extension && std::strcmp(extension, "GL_ARB_timer_query") == 0;
+        }
+        gpu_support = available ? GpuSupport::AVAILABLE : GpuSupport::UNAVAILABLE;
+        if (available) glGenQueries(static_cast<GLsizei>(GPU_QUERIES), gpu_queries.data());
+    }
+    // A query still in flight is not waited for; the frame goes untimed
+    if (gpu_support != GpuSupport::AVAILABLE || gpu_query_frames[gpu_next] != UINT64_MAX) return;
+    glBeginQuery(GL_TIME_ELAPSED, gpu_queries[gpu_next]);
+    gpu_timing = true;
+#endif
+}
+
+void FrameProfiler::endGpu() {
+#ifdef GL_TIME_ELAPSED
+    if (!gpu_timing) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    gpu_query_frames[gpu_next] = frame;
+    gpu_next = (gpu_next + 1) % GPU_QUERIES;
+    gpu_timing = false;
+#endif
+}
+
+void FrameProfiler::collectGpuResults() {
+#ifdef GL_TIME_ELAPSED
+    if (gpu_support != GpuSupport::AVAILABLE) return;
+    for (size_t i = 0; i < GPU_QUERIES; ++i) {
+        if (gpu_query_frames[i] == UINT64_MAX) continue;
+        GLint available = 0;
+        glGetQueryObjectiv(gpu_queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) continue;
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(gpu_queries[i], GL_QUERY_RESULT, &nanoseconds);
+        uint64_t timed_frame = gpu_query_frames[i];
+        gpu_query_frames[i] = UINT64_MAX;
+        if (frame - timed_frame < HISTORY) {
+            gpu_ms[timed_frame % HISTORY] = static_cast<float>(nanoseconds / 1e6);
+        }
+        gpu_histogram.observe(static_cast<uint64_t>(nanoseconds / 1000));
+    }
+#endif
+}
+
+void FrameProfiler::releaseGpuQueries() {
+#ifdef GL_TIME_ELAPSED
+    if (gpu_support == GpuSupport::AVAILABLE) {
+        glDeleteQueries(static_cast<GLsizei>(GPU_QUERIES), gpu_queries.data());
+    }
+    gpu_support = GpuSupport::UNAVAILABLE;
+#endif
+}
+
+size_t FrameProfiler::slowFrames() const {
+    size_t kept = framesKept();
+    size_t slow = 0;
+    for (size_t i = 0; i < kept; ++i) {
+        if (cpu_ms[i] > budget_ms) ++slow;
+    }
+    return slow;
+}
+
+std::vector<float> FrameProfiler::ordered(const std::array<float, HISTORY>& values) const {
+    size_t kept = framesKept();
+    std::vector<float> result;
+    result.reserve(kept);
+    for (uint64_t f = frame - kept; f < frame; ++f) result.push_back(values[f % HISTORY]);
+    return result;
+}
+
+void FrameProfiler::renderWindow(bool* open) {
+    ImGui::SetNextWindowSize(ImVec2(620, 560), ImGuiCond_FirstUseEver);
+
+    if (ImGui::Begin("⏱ Frame Profiler", open)) {
+        size_t kept = framesKept();
+        if (kept == 0) {
+            ImGui::Text("No frames recorded yet");
+            ImGui::End();
+            return;
+        }
+
+        size_t slow = slowFrames();
+        ImGui::Text("Budget: %.1f ms per frame", budget_ms);
+        ImGui::SameLine();
+        ImVec4 color = slow == 0 ? ImVec4(0.3f, 0.8f, 0.3f, 1.0f) : ImVec4(1.0f, 0.6f, 0.3f, 1.0f);
+        ImGui::TextColored(color, "%zu of the last %zu frames over budget", slow, kept);
+
+        // Frame times over the window, with the budget at mid-height
+        char overlay[64];
+        std::vector<float> cpu = ordered(cpu_ms);
+        std::snprintf(overlay, sizeof(overlay), "CPU %.2f ms", cpu.back());
+        ImGui::PlotLines("##cpu", cpu.data(), static_cast<int>(cpu.size()), 0, overlay,
+                         0.0f, static_cast<float>(budget_ms * 2), ImVec2(-1, 60));
+        if (gpu_support == GpuSupport::AVAILABLE) {
+            std::vector<float> gpu = ordered(gpu_ms);
+            float latest = 0.0f;
+            for (auto it = gpu.rbegin(); it != gpu.rend() && latest == 0.0f; ++it) latest = *it;
+            std::snprintf(overlay, sizeof(overlay), "GPU %.2f ms", latest);
+            ImGui::PlotLines("##gpu", gpu.data(), static_cast<int>(gpu.size()), 0, overlay,
+                             0.0f, static_cast<float>(budget_ms * 2), ImVec2(-1, 60));
+        } else {
+            ImGui::TextDisabled("GPU time needs OpenGL 3.3 timer queries");
+        }
+
+        // Distribution of CPU frame times, up to twice the budget
+        constexpr int BUCKETS = 24;
+        std::array<float, BUCKETS> distribution{};
+        for (float ms : cpu) {
+            int bucket = static_cast<int>(ms / (budget_ms * 2) * BUCKETS);
+            distribution[std::clamp(bucket, 0, BUCKETS - 1)] += 1.0f;
+        }
+        ImGui::PlotHistogram("##distribution", distribution.data(), BUCKETS, 0,
+                             "CPU frame time, 0 to twice the budget", 0.0f, FLT_MAX, ImVec2(-1, 60));
+
+        ImGui::Spacing();
+        ImGui::Text("Sections");
+        ImGui::Separator();
+        if (ImGui::BeginTable("FrameSections", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg |
+                                                  ImGuiTableFlags_ScrollY, ImVec2(0, 180))) {
+            ImGui::TableSetupScrollFreeze(0, 1);
+            ImGui::TableSetupColumn("Section");
+            ImGui::TableSetupColumn("Last ms");
+            ImGui::TableSetupColumn("Mean ms");
+            ImGui::TableSetupColumn("p95 ms");
+            ImGui::TableSetupColumn("Max ms");
+            ImGui::TableHeadersRow();
+            size_t last = (frame - 1) % HISTORY;
+            for (const auto& [name, section] : sections) {
+                std::vector<float> values = ordered(section.ms);
+                double sum = 0.0;
+                float worst = 0.0f;
+                for (float ms : values) {
+                    sum += ms;
+                    worst = std::max(worst, ms);
+                }
+                if (worst == 0.0f) continue; // has not run lately
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(name.c_str());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", section.ms[last]);
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", sum / values.size());
+                ImGui::TableNextColumn();
+                ImGui::Text("%.2f", percentile(values, 0.95));
+                ImGui::TableNextColumn();
+                ImGui::TextColored(worst > budget_ms ? ImVec4(1.0f, 0.6f, 0.3f, 1.0f) : ImGui::GetStyleColorVec4(ImGuiCol_Text),
+                                   "%.2f", worst);
+            }
+            ImGui::EndTable();
+        }
+
+        ImGui::Spacing();
+        ImGui::Text("Slowest recent frame: %.2f ms", slowest_ms);
+        ImGui::Separator();
+        renderFlameGraph();
+    }
+    ImGui::End();
+}
+
+void FrameProfiler::renderFlameGraph() {
+    if (slowest.empty()) {
+        ImGui::TextDisabled("No sections in the slowest frame");
+        return;
+    }
+
+    // Stages start from when the frame's profile opened; the span is the furthest one ends
+    double span_ms = 0.0;
+    uint32_t deepest = 0;
+    for (const QueryProfile::Stage& stage : slowest) {
+        span_ms = std::max(span_ms, stage.start_ms + stage.duration_ms);
+        deepest = std::max(deepest, stage.depth);
+    }
+    if (span_ms <= 0.0) return;
+
+    const float row_height = ImGui::GetTextLineHeight() + 4.0f;
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    float width = ImGui::GetContentRegionAvail().x;
+    ImGui::InvisibleButton("##flame", ImVec2(width, row_height * (deepest + 1)));
+    bool hovered = ImGui::IsItemHovered();
+    ImVec2 mouse = ImGui::GetIO().MousePos;
+
+    ImDrawList* draw_list = ImGui::GetWindowDrawList();
+    for (const QueryProfile::Stage& stage : slowest) {
+        float x0 = origin.x + static_cast<float>(stage.start_ms / span_ms) * width;
+        float x1 = origin.x + static_cast<float>((stage.start_ms + stage.duration_ms) / span_ms) * width;
+        x1 = std::max(x1, x0 + 1.0f);
+        float y0 = origin.y + stage.depth * row_height;
+        float y1 = y0 + row_height - 1.0f;
+        draw_list->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y1), sectionColor(stage.name));
+
+        // Label the stage if its name fits
+        ImVec2 text_size = ImGui::CalcTextSize(stage.name);
+        if (text_size.x + 4.0f < x1 - x0) {
+            draw_list->PushClipRect(ImVec2(x0, y0), ImVec2(x1, y1), true);
+            draw_list->AddText(ImVec2(x0 + 2.0f, y0 + 2.0f), IM_COL32(0, 0, 0, 255), stage.name);
+            draw_list->PopClipRect();
+        }
+        if (hovered && mouse.x >= x0 && mouse.x < x1 && mouse.y >= y0 && mouse.y < y1) {
+            ImGui::SetTooltip("%s\n%.3f ms, from %.3f ms", stage.name, stage.duration_ms, stage.start_ms);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include "../../core/QueryProfile.h"
+#include "../../core/MetricsRegistry.h"
+#include <array>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Where the UI thread's frame time goes. Between beginFrame() and endFrame()
+// a QueryProfile is open on the thread, so every TRACE_SCOPE there (the
+// "ui.*" sections around panels, and any core work called from them) is
+// timed with its nesting. Each section keeps its time in the last HISTORY
+// frames, for the overlay's graphs and percentiles, and in a
+// versefinder_ui_section_duration_seconds histogram on /metrics.
+//
+// GPU time comes from GL_TIME_ELAPSED queries around the main window's draw,
+// read back a few frames later so the CPU never waits on them; without
+// OpenGL 3.3 or ARB_timer_query it is left out. The presentation window
+// draws on its own context and is not included.
+class FrameProfiler {
+public:
+    static constexpr size_t HISTORY = 240;      // frames; four seconds at 60 Hz
+    static constexpr size_t MAX_SECTIONS = 64;  // distinct names tracked, first come
+    static constexpr size_t GPU_QUERIES = 4;    // frames a GPU reading may lag
+
+    FrameProfiler();
+    ~FrameProfiler();
+
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+    // The display's frame interval
+    void setFrameBudget(double milliseconds) { budget_ms = milliseconds; }
+    double frameBudget() const { return budget_ms; }
+
+    void beginFrame();
+    // cpu_time is the frame's work, without waiting for vsync
+    void endFrame(std::chrono::steady_clock::duration cpu_time);
+
+    // Around the GL calls drawing the frame; needs the window's context current
+    void beginGpu();
+    void endGpu();
+
+    // Frames over budget among the last HISTORY
+    size_t slowFrames() const;
+
+    void renderWindow(bool* open);
+
+    // Release the GL queries while the context is still current
+    void releaseGpuQueries();
+
+private:
+    struct Section {
+        std::array<float, HISTORY> ms{};  // by frame, 0 where it did not run
+        Histogram* histogram = nullptr;
+    };
+
+    std::unique_ptr<QueryProfile> profile;
+    std::optional<QueryProfile::Scope> scope;
+    uint64_t frame = 0;  // frames finished
+    double budget_ms = 1000.0 / 60.0;
+
+    std::array<float, HISTORY> cpu_ms{};
+    std::array<float, HISTORY> gpu_ms{};
+    std::map<std::string, Section> sections;
+    std::vector<QueryProfile::Stage> slowest;  // stages of the slowest frame in the window
+    double slowest_ms = 0.0;
+    uint64_t slowest_frame = 0;
+
+    Histogram& cpu_histogram;
+    Histogram& gpu_histogram;
+
+    // GL query objects and the frame each is timing; UINT64_MAX when free
+    enum class GpuSupport { UNKNOWN, AVAILABLE, UNAVAILABLE };
+    GpuSupport gpu_support = GpuSupport::UNKNOWN;
+    std::array<unsigned int, GPU_QUERIES> gpu_queries{};
+    std::array<uint64_t, GPU_QUERIES> gpu_query_frames{};
+    size_t gpu_next = 0;
+    bool gpu_timing = false;  // a query is open this frame
+
+    void collectGpuResults();
+    size_t framesKept() const { return frame < HISTORY ? static_cast<size_t>(frame) : HISTORY; }
+    // Values oldest first, for ImGui's plots
+    std::vector<float> ordered(const std::array<float, HISTORY>& values) const;
+    void renderFlameGraph();
+};
+
+#endif // FRAME_PROFILER_H
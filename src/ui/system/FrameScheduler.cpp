@@ -0,0 +1,38 @@
+#include "FrameScheduler.h"
+
+FrameScheduler& FrameScheduler::shared() {
+    static FrameScheduler scheduler;
+    return scheduler;
+}
+
+void FrameScheduler::attach(GLFWwindow* window) {
+    // Captureless lambdas convert to the plain function pointers GLFW expects
+    glfwSetWindowFocusCallback(window, [](GLFWwindow*, int) { shared().markActive(); });
+    glfwSetCursorEnterCallback(window, [](GLFWwindow*, int) { shared().markActive(); });
+    glfwSetCursorPosCallback(window, [](GLFWwindow*, double, double) { shared().markActive(); });
+    glfwSetMouseButtonCallback(window, [](GLFWwindow*, int, int, int) { shared().markActive(); });
+    glfwSetScrollCallback(window, [](GLFWwindow*, double, double) { shared().markActive(); });
+    glfwSetKeyCallback(window, [](GLFWwindow*, int, int, int, int) { shared().markActive(); });
+    glfwSetCharCallback(window, [](GLFWwindow*, unsigned int) { shared().markActive(); });
+    glfwSetWindowSizeCallback(window, [](GLFWwindow*, int, int) { shared().markActive(); });
+    glfwSetWindowRefreshCallback(window, [](GLFWwindow*) { shared().markActive(); });
+}
+
+void FrameScheduler::requestRedraw() {
+    markActive();
+    glfwPostEmptyEvent();
+}
+
+bool FrameScheduler::waitForNextFrame(bool animating) {
+    if (animating || frames_pending.load(std::memory_order_relaxed) > 0) {
+        glfwPollEvents();
+    } else {
+        glfwWaitEventsTimeout(IDLE_FRAME_INTERVAL);
+    }
+
+    // Events handled above may have refilled the count
+    int pending = frames_pending.load(std::memory_order_relaxed);
+    while (pending > 0 && !frames_pending.compare_exchange_weak(pending, pending - 1, std::memory_order_relaxed)) {
+    }
+    return animating || pending > 0;
+}
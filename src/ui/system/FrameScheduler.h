@@ -0,0 +1,38 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <GLFW/glfw3.h>
+#include <atomic>
+
+// Paces the UI loop. Frames run at the display's refresh rate while
+// something is happening (input, animation, loading) and for a few frames
+// after; otherwise the loop sleeps in glfwWaitEventsTimeout until input
+// arrives or another thread calls requestRedraw(), redrawing no more often
+// than IDLE_FRAME_INTERVAL so state polled from other threads stays fresh.
+class FrameScheduler {
+public:
+    static constexpr double IDLE_FRAME_INTERVAL = 0.5; // seconds
+    // ImGui settles hover and layout changes a frame or two after the input behind them
+    static constexpr int FRAMES_PER_WAKE = 3;
+
+    // Process-wide scheduler for the UI thread
+    static FrameScheduler& shared();
+
+    // Wakes on window's input and refresh events. For a window ImGui drives,
+    // call before ImGui installs its callbacks so that it chains to these.
+    void attach(GLFWwindow* window);
+
+    // Something on screen changed; safe to call from any thread
+    void requestRedraw();
+
+    // Blocks until the next frame is due. animating keeps frames continuous.
+    // False when the frame is only the idle refresh and nothing asked for it.
+    bool waitForNextFrame(bool animating);
+
+private:
+    std::atomic<int> frames_pending{FRAMES_PER_WAKE};
+
+    void markActive() { frames_pending.store(FRAMES_PER_WAKE, std::memory_order_relaxed); }
+};
+
+#endif // FRAME_SCHEDULER_H
@@ -0,0 +1,154 @@
+#include "GlyphCache.h"
+#include "../../core/TextKernels.h"
+
+// OpenGL loader, as picked by the build for the ImGui backend
+#ifdef IMGUI_IMPL_OPENGL_LOADER_GLEW
+#include <GL/glew.h>
+#elif defined(IMGUI_IMPL_OPENGL_LOADER_GL3W)
+#include <GL/gl3w.h>
+#else
+#include "../../opengl_loader.h"
+#endif
+
+#include <imgui_impl_opengl3.h>
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+namespace {
+
+// Largest code point an atlas can hold while ImWchar is 16 bits
+constexpr uint32_t MAX_CODEPOINT = sizeof(ImWchar) == 2 ? 0xFFFF : 0x10FFFF;
+
+// Decodes the next UTF-8 sequence of text at pos, advancing pos; malformed
+// bytes decode to U+FFFD one at a time
+uint32_t nextCodepoint(std::string_view text, size_t& pos) {
+    unsigned char lead = static_cast<unsigned char>(text[pos++]);
+    int extra = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+    if (lead >= 0x80 && extra == 0) return 0xFFFD;
+    uint32_t codepoint = extra == 0 ? lead : lead & (0x3F >> extra);
+    for (int i = 0; i < extra; i++) {
+        if (pos >= text.size() || (static_cast<unsigned char>(text[pos]) & 0xC0) != 0x80) return 0xFFFD;
+        codepoint = (codepoint << 6) | (static_cast<unsigned char>(text[pos++]) & 0x3F);
+    }
+    return codepoint;
+}
+
+} // namespace
+
+void GlyphCache::addSource(const std::string& path, float size_pixels, ImFontConfig config) {
+    sources.push_back(Source{path, size_pixels, config});
+}
+
+void GlyphCache::pinRange(ImWchar first, ImWchar last) {
+    pinned_ranges.push_back(first);
+    pinned_ranges.push_back(last);
+}
+
+bool GlyphCache::isPinned(uint32_t page) const {
+    uint32_t first = page << PAGE_BITS;
+    uint32_t last = first + (1u << PAGE_BITS) - 1;
+    for (size_t i = 0; i + 1 < pinned_ranges.size(); i += 2) {
+        if (pinned_ranges[i] <= first && last <= pinned_ranges[i + 1]) return true;
+    }
+    return false;
+}
+
+void GlyphCache::noteText(std::string_view text) {
+    // Basic Latin is always pinned, and without sources there is nothing to bake
+    if (sources.empty() || TextKernels::isAscii(text)) return;
+
+    use_clock++;
+    uint32_t last_page = UINT32_MAX;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        uint32_t codepoint = nextCodepoint(text, pos);
+        uint32_t page = codepoint >> PAGE_BITS;
+        if (codepoint < 0x80 || codepoint > MAX_CODEPOINT || page == last_page) continue;
+        last_page = page;
+
+        auto it = page_last_use.find(page);
+        if (it != page_last_use.end()) {
+            it->second = use_clock;
+        } else if (!isPinned(page) &&
+                   std::find(pending_pages.begin(), pending_pages.end(), page) == pending_pages.end()) {
+            pending_pages.push_back(page);
+        }
+    }
+}
+
+void GlyphCache::evictColdPages() {
+    if (page_last_use.size() <= page_budget) return;
+
+    std::vector<std::pair<uint64_t, uint32_t>> by_age;
+    by_age.reserve(page_last_use.size());
+    for (const auto& [page, last_use] : page_last_use) {
+        by_age.emplace_back(last_use, page);
+    }
+    std::sort(by_age.begin(), by_age.end());
+    for (size_t i = 0; i < by_age.size() - page_budget; i++) {
+        page_last_use.erase(by_age[i].second);
+    }
+}
+
+bool GlyphCache::build(ImFontAtlas* atlas) {
+    for (uint32_t page : pending_pages) {
+        page_last_use[page] = use_clock;
+    }
+    pending_pages.clear();
+    evictColdPages();
+
+    // Pinned ranges, then resident pages in order with neighbours merged
+    baked_ranges.assign(pinned_ranges.begin(), pinned_ranges.end());
+    std::vector<uint32_t> pages;
+    pages.reserve(page_last_use.size());
+    for (const auto& entry : page_last_use) {
+        pages.push_back(entry.first);
+    }
+    std::sort(pages.begin(), pages.end());
+    for (size_t i = 0; i < pages.size();) {
+        size_t run_end = i;
+        while (run_end + 1 < pages.size() && pages[run_end + 1] == pages[run_end] + 1) run_end++;
+        uint32_t first = std::max<uint32_t>(pages[i] << PAGE_BITS, 1);
+        uint32_t last = std::min(((pages[run_end] + 1) << PAGE_BITS) - 1, MAX_CODEPOINT);
+        baked_ranges.push_back(static_cast<ImWchar>(first));
+        baked_ranges.push_back(static_cast<ImWchar>(last));
+        i = run_end + 1;
+    }
+    baked_ranges.push_back(0);
+
+    atlas->Clear();
+    bool loaded = false;
+    for (const Source& source : sources) {
+        if (!std::filesystem::exists(source.path)) continue;
+        ImFontConfig config = source.config;
+        config.MergeMode = loaded;
+        if (atlas->AddFontFromFileTTF(source.path.c_str(), source.size_pixels, &config, baked_ranges.data())) {
+            loaded = true;
+        }
+    }
+    if (!loaded) {
+        atlas->AddFontDefault();
+    }
+    atlas->Build();
+    return loaded;
+}
+
+bool GlyphCache::refresh() {
+    if (pending_pages.empty()) return false;
+
+    ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+    GLuint old_texture = static_cast<GLuint>(reinterpret_cast<intptr_t>(atlas->TexID));
+    size_t before = page_last_use.size();
+    build(atlas);
+
+    // Until the backend has made a texture it will upload this atlas itself.
+    // The new texture is made before the old is freed so that its name
+    // differs, which is how caches keyed on TexID notice the change.
+    if (old_texture) {
+        ImGui_ImplOpenGL3_CreateFontsTexture();
+        glDeleteTextures(1, &old_texture);
+    }
+    std::cout << "Glyph cache: " << before << " -> " << page_last_use.size() << " pages resident" << std::endl;
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <imgui.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Keeps an ImGui font atlas holding only the glyphs text actually needs.
+// Pinned ranges (Latin, punctuation, the UI's symbols) are always baked;
+// other characters are added a page at a time the first time noted text
+// uses them, and once more pages are resident than the budget allows the
+// least recently used are dropped at the next rebuild. Startup rasterizes
+// a few hundred glyphs instead of every script a translation might use.
+//
+// ImGui 1.90 atlases are static, so a new page means rebuilding the atlas
+// and re-uploading its texture, between frames. Each context (and thread)
+// needs a cache of its own.
+class GlyphCache {
+public:
+    static constexpr int PAGE_BITS = 6; // 64 code points per page
+    static constexpr size_t DEFAULT_PAGE_BUDGET = 96;
+
+    explicit GlyphCache(size_t page_budget = DEFAULT_PAGE_BUDGET) : page_budget(page_budget) {}
+
+    // Fonts baked into the atlas, in order; each later one only supplies
+    // glyphs the ones before it lack. config's MergeMode is set as needed.
+    void addSource(const std::string& path, float size_pixels, ImFontConfig config = ImFontConfig());
+    // Code points baked whatever the budget
+    void pinRange(ImWchar first, ImWchar last);
+
+    // Marks the characters of UTF-8 text as in use
+    void noteText(std::string_view text);
+    bool hasPendingGlyphs() const { return !pending_pages.empty(); }
+
+    // Clears atlas and bakes the sources over the resident pages; call
+    // before the current context's first frame, or through refresh().
+    // False when no source could be loaded, leaving ImGui's default font.
+    bool build(ImFontAtlas* atlas);
+    // Rebuilds the current context's atlas and GL font texture if noted text
+    // needs glyphs it lacks; call before the backend's NewFrame. True if rebuilt.
+    bool refresh();
+
+    size_t residentPages() const { return page_last_use.size(); }
+
+private:
+    struct Source {
+        std::string path;
+        float size_pixels;
+        ImFontConfig config;
+    };
+
+    size_t page_budget;
+    std::vector<Source> sources;
+    std::vector<ImWchar> pinned_ranges; // pairs, as ImGui expects
+    std::unordered_map<uint32_t, uint64_t> page_last_use; // resident page -> use stamp
+    std::vector<uint32_t> pending_pages;
+    std::vector<ImWchar> baked_ranges; // must outlive the atlas build
+    uint64_t use_clock = 0;
+
+    bool isPinned(uint32_t page) const;
+    void evictColdPages();
+};
+
+#endif // GLYPH_CACHE_H
@@ -180,6 +180,10 @@ void WindowManager::pollEvents() {
     glfwPollEvents();
 }
 
+void WindowManager::waitEvents(double timeout_seconds) {
+    glfwWaitEventsTimeout(timeout_seconds);
+}
+
 void WindowManager::swapBuffers() {
     if (main_window) {
         glfwSwapBuffers(main_window);
@@ -43,6 +43,8 @@ public:
     // Event handling
     bool shouldClose() const;
     void pollEvents();
+    // Sleeps until an event arrives or timeout_seconds pass
+    void waitEvents(double timeout_seconds);
     void swapBuffers();
 
 private:
@@ -0,0 +1,652 @@
+// Load generator for the VerseFinder HTTP API. Drives /api/search,
+// /api/translations and /api/batch from many concurrent connections with a
+// configurable request mix, optionally holding open Server-Sent Events
+// subscribers on /api/presentation/events the way remote displays do, and
+// reports per-endpoint latency histograms and error rates.
+//
+// Point it at a running VerseFinder with the API server enabled:
+//
+//   api_load_generator --port 8080 --connections 32 --duration 30
+//                      --mix search=70,translations=10,batch=20 --subscribers 30
+//
+// Each connection is one closed-loop client: it sends a request, waits for
+// the whole response and sends the next, reusing the connection unless
+// --no-keep-alive is given or the server closes it.
+
+#include "MetricsRegistry.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+using json = nlohmann::json;
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int SEND_FLAGS = 0;
+#endif
+
+struct Options {
+    std::string host = "127.0.0.1";
+    int port = 8080;
+    unsigned connections = 8;
+    double duration_s = 10.0;
+    double timeout_s = 5.0;
+    bool keep_alive = true;
+    std::map<std::string, unsigned> mix = {{"search", 70}, {"translations", 10}, {"batch", 20}};
+    unsigned subscribers = 0;
+    size_t batch_size = 5;
+    std::string translation;
+    std::string queries_file;
+    std::string output;
+    unsigned seed = 1;
+};
+
+const std::vector<std::string> DEFAULT_QUERIES = {
+    "John 3:16", "Psalm 23:1", "Romans 8:28", "Genesis 1:1", "Philippians 4:13", "Isaiah 40:31",
+    "love", "faith", "grace", "peace", "shepherd", "light of the world", "fear not", "mercy",
+    "the lord is my shepherd", "in the beginning", "forgive", "strength", "hope", "salvation",
+};
+
+enum class Endpoint { SEARCH, TRANSLATIONS, BATCH };
+const char* const ENDPOINT_NAMES[] = {"search", "translations", "batch"};
+constexpr size_t ENDPOINT_COUNT = 3;
+
+// Outcome counts and latencies for one endpoint, shared by every client
+struct EndpointStats {
+    Histogram latency;
+    std::atomic<uint64_t> max_us{0};
+    std::atomic<uint64_t> responses{0};
+    std::atomic<uint64_t> client_errors{0};  // 4xx (a search with no matches is a 404)
+    std::atomic<uint64_t> rate_limited{0};   // 429s, also counted in client_errors
+    std::atomic<uint64_t> server_errors{0};  // 5xx
+    std::atomic<uint64_t> transport_errors{0};  // connect, send, timeout or malformed response
+    std::atomic<uint64_t> bytes{0};
+};
+
+struct PushStats {
+    Histogram first_event;  // subscribe to first event received
+    std::atomic<uint64_t> connected{0};
+    std::atomic<uint64_t> failed{0};
+    std::atomic<uint64_t> events{0};
+    std::atomic<uint64_t> disconnects{0};  // closed by the server before the run ended
+};
+
+uint64_t microsSince(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+std::string urlEncode(const std::string& text) {
+    static const char* HEX = "0123456789ABCDEF";
+    std::string out;
+    for (unsigned char c : text) {
+        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            out += static_cast<char>(c);
+        } else {
+            out += '%';
+            out += HEX[c >> 4];
+            out += HEX[c & 15];
+        }
+    }
+    return out;
+}
+
+// One blocking client socket plus whatever it has read past the last response
+class Connection {
+private:
+    int fd = -1;
+    std::string buffer;
+
+    bool fill() {
+        char chunk[16 * 1024];
+        ssize_t received = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (received <= 0) return false;
+        buffer.append(chunk, static_cast<size_t>(received));
+        return true;
+    }
+
+public:
+    ~Connection() { close(); }
+
+    bool isOpen() const { return fd >= 0; }
+
+    bool open(const sockaddr_storage& address, socklen_t length, double timeout_s) {
+        close();
+        fd = ::socket(address.ss_family, SOCK_STREAM, 0);
+        if (fd < 0) return false;
+        timeval timeout{};
+        timeout.tv_sec = static_cast<time_t>(timeout_s);
+        timeout.tv_usec = static_cast<suseconds_t>((timeout_s - static_cast<double>(timeout.tv_sec)) * 1e6);
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+#ifdef SO_NOSIGPIPE
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+        if (::connect(fd, reinterpret_cast<const sockaddr*>(&address), length) != 0) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+        buffer.clear();
+    }
+
+    bool sendAll(const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t written = ::send(fd, data.data() + sent, data.size() - sent, SEND_FLAGS);
+            if (written <= 0) return false;
+            sent += static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    // Reads the status line and headers; returns false on EOF, timeout or garbage
+    bool readHead(int& status, std::map<std::string, std::string>& headers) {
+        size_t end;
+        while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (!fill()) return false;
+        }
+        std::istringstream head(buffer.substr(0, end));
+        buffer.erase(0, end + 4);
+
+        std::string line;
+        std::getline(head, line);
+        if (line.compare(0, 5, "HTTP/") != 0 || line.size() < 12) return false;
+        status = std::atoi(line.c_str() + 9);
+        while (std::getline(head, line)) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            size_t colon = line.find(':');
+            if (colon == std::string::npos) continue;
+            std::string name = line.substr(0, colon);
+            std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::tolower(c); });
+            size_t value_start = line.find_first_not_of(' ', colon + 1);
+            headers[name] = value_start == std::string::npos ? "" : line.substr(value_start);
+        }
+        return true;
+    }
+
+    // Reads a Content-Length or chunked body; returns its size, or -1 on failure
+    long long readBody(const std::map<std::string, std::string>& headers) {
+        auto encoding = headers.find("transfer-encoding");
+        if (encoding != headers.end() && encoding->second.find("chunked") != std::string::npos) {
+            long long total = 0;
+            while (true) {
+                size_t line_end;
+                while ((line_end = buffer.find("\r\n")) == std::string::npos) {
+                    if (!fill()) return -1;
+                }
+                size_t chunk_size = std::strtoul(buffer.c_str(), nullptr, 16);
+                buffer.erase(0, line_end + 2);
+                while (buffer.size() < chunk_size + 2) {
+                    if (!fill()) return -1;
+                }
+                buffer.erase(0, chunk_size + 2);
+                total += static_cast<long long>(chunk_size);
+                if (chunk_size == 0) return total;
+            }
+        }
+
+        auto length_header = headers.find("content-length");
+        if (length_header == headers.end()) {
+            while (fill()) {}  // Body runs to connection close
+            long long total = static_cast<long long>(buffer.size());
+            close();
+            return total;
+        }
+        size_t length = std::strtoull(length_header->second.c_str(), nullptr, 10);
+        while (buffer.size() < length) {
+            if (!fill()) return -1;
+        }
+        buffer.erase(0, length);
+        return static_cast<long long>(length);
+    }
+
+    // Reads whatever arrives next, for event streams; empty on close or timeout
+    std::string readSome() {
+        if (buffer.empty() && !fill()) return {};
+        std::string data;
+        data.swap(buffer);
+        return data;
+    }
+};
+
+class LoadGenerator {
+private:
+    Options options;
+    sockaddr_storage address{};
+    socklen_t address_length = 0;
+    std::vector<std::string> queries;
+    std::vector<unsigned> weights;  // Indexed by Endpoint
+    std::array<EndpointStats, ENDPOINT_COUNT> stats;
+    PushStats push;
+    std::atomic<bool> stopping{false};
+    std::chrono::steady_clock::time_point deadline;
+    double elapsed_s = 0.0;
+
+    std::string buildRequest(Endpoint endpoint, std::mt19937& random) const {
+        std::uniform_int_distribution<size_t> pick(0, queries.size() - 1);
+        std::string target;
+        std::string body;
+        switch (endpoint) {
+            case Endpoint::SEARCH:
+                target = "/api/search?q=" + urlEncode(queries[pick(random)]);
+                if (!options.translation.empty()) target += "&translation=" + urlEncode(options.translation);
+                break;
+            case Endpoint::TRANSLATIONS:
+                target = "/api/translations";
+                break;
+            case Endpoint::BATCH: {
+                target = "/api/batch";
+                json request = {{"queries", json::array()}};
+                for (size_t i = 0; i < options.batch_size; ++i) request["queries"].push_back(queries[pick(random)]);
+                if (!options.translation.empty()) request["translations"] = {options.translation};
+                body = request.dump();
+                break;
+            }
+        }
+
+        std::string request = std::string(body.empty() ? "GET " : "POST ") + target + " HTTP/1.1\r\n" +
+                              "Host: " + options.host + "\r\n" +
+                              "Connection: " + (options.keep_alive ? "keep-alive" : "close") + "\r\n";
+        if (!body.empty()) {
+            request += "Content-Type: application/json\r\nContent-Length: " + std::to_string(body.size()) + "\r\n";
+        }
+        return request + "\r\n" + body;
+    }
+
+    void runClient(unsigned client) {
+        std::mt19937 random(options.seed * 7919 + client);
+        std::discrete_distribution<size_t> choose(weights.begin(), weights.end());
+        Connection connection;
+
+        while (!stopping.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() < deadline) {
+            auto endpoint = static_cast<Endpoint>(choose(random));
+            EndpointStats& endpoint_stats = stats[static_cast<size_t>(endpoint)];
+            std::string request = buildRequest(endpoint, random);
+
+            auto start = std::chrono::steady_clock::now();
+            bool reused = connection.isOpen();
+            if (!reused && !connection.open(address, address_length, options.timeout_s)) {
+                endpoint_stats.transport_errors.fetch_add(1, std::memory_order_relaxed);
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));  // Don't spin on a dead server
+                continue;
+            }
+
+            int status = 0;
+            std::map<std::string, std::string> headers;
+            bool sent = connection.sendAll(request);
+            bool headed = sent && connection.readHead(status, headers);
+            if (!headed && reused && !stopping.load(std::memory_order_relaxed)) {
+                // The server may have retired the idle connection just as we reused it
+                start = std::chrono::steady_clock::now();
+                headed = connection.open(address, address_length, options.timeout_s) &&
+                         connection.sendAll(request) && connection.readHead(status, headers);
+            }
+            long long body_bytes = headed ? connection.readBody(headers) : -1;
+            uint64_t elapsed_us = microsSince(start);
+
+            if (body_bytes < 0) {
+                endpoint_stats.transport_errors.fetch_add(1, std::memory_order_relaxed);
+                connection.close();
+                continue;
+            }
+
+            endpoint_stats.latency.observe(elapsed_us);
+            uint64_t previous_max = endpoint_stats.max_us.load(std::memory_order_relaxed);
+            while (elapsed_us > previous_max &&
+                   !endpoint_stats.max_us.compare_exchange_weak(previous_max, elapsed_us, std::memory_order_relaxed)) {}
+            endpoint_stats.responses.fetch_add(1, std::memory_order_relaxed);
+            endpoint_stats.bytes.fetch_add(static_cast<uint64_t>(body_bytes), std::memory_order_relaxed);
+            if (status >= 500) endpoint_stats.server_errors.fetch_add(1, std::memory_order_relaxed);
+            else if (status >= 400) endpoint_stats.client_errors.fetch_add(1, std::memory_order_relaxed);
+            if (status == 429) endpoint_stats.rate_limited.fetch_add(1, std::memory_order_relaxed);
+
+            auto connection_header = headers.find("connection");
+            if (!options.keep_alive || (connection_header != headers.end() && connection_header->second == "close")) {
+                connection.close();
+            }
+        }
+    }
+
+    // A remote display: subscribes once and reads events until the run ends
+    void runSubscriber() {
+        Connection connection;
+        auto start = std::chrono::steady_clock::now();
+        int status = 0;
+        std::map<std::string, std::string> headers;
+        std::string request = "GET /api/presentation/events HTTP/1.1\r\nHost: " + options.host +
+                              "\r\nAccept: text/event-stream\r\n\r\n";
+        if (!connection.open(address, address_length, 1.0) || !connection.sendAll(request) ||
+            !connection.readHead(status, headers) || status != 200) {
+            push.failed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        push.connected.fetch_add(1, std::memory_order_relaxed);
+
+        // Reads time out every second so the subscriber notices the end of the run
+        bool first = true;
+        std::string pending;
+        while (!stopping.load(std::memory_order_relaxed)) {
+            errno = 0;
+            std::string data = connection.readSome();
+            if (data.empty()) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) continue;
+                if (!stopping.load(std::memory_order_relaxed)) push.disconnects.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            pending += data;
+            size_t boundary;
+            while ((boundary = pending.find("\n\n")) != std::string::npos) {
+                bool is_event = pending.compare(0, 1, ":") != 0;  // ": keep-alive" comments are not events
+                pending.erase(0, boundary + 2);
+                if (!is_event) continue;
+                if (first) {
+                    push.first_event.observe(microsSince(start));
+                    first = false;
+                }
+                push.events.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+public:
+    explicit LoadGenerator(Options opts) : options(std::move(opts)) {
+        for (const char* name : ENDPOINT_NAMES) {
+            auto it = options.mix.find(name);
+            weights.push_back(it == options.mix.end() ? 0 : it->second);
+        }
+    }
+
+    bool resolve() {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* result = nullptr;
+        if (getaddrinfo(options.host.c_str(), std::to_string(options.port).c_str(), &hints, &result) != 0 || !result) {
+            return false;
+        }
+        std::memcpy(&address, result->ai_addr, result->ai_addrlen);
+        address_length = static_cast<socklen_t>(result->ai_addrlen);
+        freeaddrinfo(result);
+        return true;
+    }
+
+    bool loadQueries() {
+        if (options.queries_file.empty()) {
+            queries = DEFAULT_QUERIES;
+            return true;
+        }
+        std::ifstream file(options.queries_file);
+        json document = json::parse(file, nullptr, false);
+        // A plain array of strings, or a search_benchmark corpus of category -> array
+        auto collect = [this](const json& list) {
+            for (const auto& item : list) {
+                if (item.is_string()) queries.push_back(item.get<std::string>());
+            }
+        };
+        if (document.is_array()) {
+            collect(document);
+        } else if (document.is_object()) {
+            for (const auto& [category, list] : document.items()) {
+                if (list.is_array()) collect(list);
+            }
+        }
+        return !queries.empty();
+    }
+
+    void run() {
+        deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                                          std::chrono::duration<double>(options.duration_s));
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> subscribers;
+        for (unsigned i = 0; i < options.subscribers; ++i) subscribers.emplace_back([this]() { runSubscriber(); });
+
+        std::vector<std::thread> clients;
+        for (unsigned i = 0; i < options.connections; ++i) clients.emplace_back([this, i]() { runClient(i); });
+        for (auto& client : clients) client.join();
+
+        elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stopping.store(true);
+        for (auto& subscriber : subscribers) subscriber.join();
+    }
+
+    json results() const {
+        auto histogramJson = [](const Histogram& histogram, uint64_t max_us) {
+            // Power-of-two buckets are coarse enough to read and line up with the internal ones
+            json buckets = json::array();
+            auto counts = histogram.counts();
+            uint64_t cumulative = 0;
+            size_t bucket = 0;
+            for (int exponent = 4; exponent <= 27 && bucket < Histogram::BUCKETS; ++exponent) {
+                uint64_t bound = uint64_t{1} << exponent;
+                uint64_t in_range = 0;
+                for (; bucket < Histogram::BUCKETS && Histogram::bucketUpperBound(bucket) <= bound; ++bucket) {
+                    in_range += counts[bucket];
+                }
+                cumulative += in_range;
+                if (in_range > 0) buckets.push_back({{"le_us", bound}, {"count", in_range}});
+                if (cumulative == histogram.count()) break;
+            }
+            return json{
+                {"p50_us", histogram.quantileMicros(0.50)},
+                {"p90_us", histogram.quantileMicros(0.90)},
+                {"p99_us", histogram.quantileMicros(0.99)},
+                {"p999_us", histogram.quantileMicros(0.999)},
+                {"max_us", max_us},
+                {"mean_us", histogram.count() ? static_cast<double>(histogram.sumMicros()) / histogram.count() : 0.0},
+                {"buckets", buckets},
+            };
+        };
+
+        json endpoints = json::object();
+        uint64_t total = 0, failures = 0;
+        for (size_t e = 0; e < ENDPOINT_COUNT; ++e) {
+            const EndpointStats& s = stats[e];
+            uint64_t responses = s.responses.load(), transport = s.transport_errors.load();
+            if (weights[e] == 0) continue;
+            uint64_t attempts = responses + transport;
+            total += attempts;
+            failures += transport + s.server_errors.load();
+            endpoints[ENDPOINT_NAMES[e]] = {
+                {"requests", attempts},
+                {"responses", responses},
+                {"rps", elapsed_s > 0 ? static_cast<double>(responses) / elapsed_s : 0.0},
+                {"client_errors", s.client_errors.load()},
+                {"rate_limited", s.rate_limited.load()},
+                {"server_errors", s.server_errors.load()},
+                {"transport_errors", transport},
+                {"error_rate", attempts ? static_cast<double>(transport + s.server_errors.load()) / attempts : 0.0},
+                {"bytes", s.bytes.load()},
+                {"latency", histogramJson(s.latency, s.max_us.load())},
+            };
+        }
+
+        json result = {
+            {"target", options.host + ":" + std::to_string(options.port)},
+            {"connections", options.connections},
+            {"keep_alive", options.keep_alive},
+            {"seconds", elapsed_s},
+            {"requests", total},
+            {"rps", elapsed_s > 0 ? static_cast<double>(total) / elapsed_s : 0.0},
+            {"error_rate", total ? static_cast<double>(failures) / total : 0.0},
+            {"endpoints", endpoints},
+        };
+        if (options.subscribers > 0) {
+            result["push"] = {
+                {"subscribers", options.subscribers},
+                {"connected", push.connected.load()},
+                {"failed", push.failed.load()},
+                {"events", push.events.load()},
+                {"disconnects", push.disconnects.load()},
+                {"first_event_p50_us", push.first_event.quantileMicros(0.50)},
+                {"first_event_p99_us", push.first_event.quantileMicros(0.99)},
+            };
+        }
+        return result;
+    }
+};
+
+void printReport(const json& results) {
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << results["requests"].get<uint64_t>() << " requests in " << results["seconds"].get<double>()
+              << " s over " << results["connections"].get<unsigned>() << " connections ("
+              << (results["keep_alive"].get<bool>() ? "keep-alive" : "no keep-alive") << "): "
+              << results["rps"].get<double>() << " req/s, "
+              << results["error_rate"].get<double>() * 100.0 << "% errors\n\n";
+
+    std::cout << std::left << std::setw(14) << "endpoint" << std::right << std::setw(9) << "req/s"
+              << std::setw(10) << "p50 ms" << std::setw(10) << "p90 ms" << std::setw(10) << "p99 ms"
+              << std::setw(10) << "max ms" << std::setw(8) << "4xx" << std::setw(8) << "5xx"
+              << std::setw(8) << "429" << std::setw(8) << "failed" << "\n";
+    for (const auto& [name, endpoint] : results["endpoints"].items()) {
+        const json& latency = endpoint["latency"];
+        std::cout << std::left << std::setw(14) << name << std::right
+                  << std::setw(9) << endpoint["rps"].get<double>()
+                  << std::setw(10) << latency["p50_us"].get<double>() / 1000.0
+                  << std::setw(10) << latency["p90_us"].get<double>() / 1000.0
+                  << std::setw(10) << latency["p99_us"].get<double>() / 1000.0
+                  << std::setw(10) << latency["max_us"].get<double>() / 1000.0
+                  << std::setw(8) << endpoint["client_errors"].get<uint64_t>()
+                  << std::setw(8) << endpoint["server_errors"].get<uint64_t>()
+                  << std::setw(8) << endpoint["rate_limited"].get<uint64_t>()
+                  << std::setw(8) << endpoint["transport_errors"].get<uint64_t>() << "\n";
+    }
+
+    for (const auto& [name, endpoint] : results["endpoints"].items()) {
+        const json& buckets = endpoint["latency"]["buckets"];
+        uint64_t peak = 1;
+        for (const auto& bucket : buckets) peak = std::max(peak, bucket["count"].get<uint64_t>());
+        std::cout << "\n" << name << " latency\n";
+        for (const auto& bucket : buckets) {
+            uint64_t count = bucket["count"].get<uint64_t>();
+            std::cout << "  <= " << std::setprecision(3) << std::setw(9) << bucket["le_us"].get<uint64_t>() / 1000.0
+                      << std::setprecision(1) << " ms "
+                      << std::setw(8) << count << " " << std::string(static_cast<size_t>(40 * count / peak), '#')
+                      << "\n";
+        }
+    }
+
+    if (results.contains("push")) {
+        const json& push = results["push"];
+        std::cout << "\nPush: " << push["connected"].get<uint64_t>() << "/" << push["subscribers"].get<unsigned>()
+                  << " subscribers connected, " << push["events"].get<uint64_t>() << " events, "
+                  << push["disconnects"].get<uint64_t>() << " dropped; first event p50 "
+                  << push["first_event_p50_us"].get<double>() / 1000.0 << " ms, p99 "
+                  << push["first_event_p99_us"].get<double>() / 1000.0 << " ms\n";
+    }
+}
+
+bool parseMix(const std::string& text, std::map<std::string, unsigned>& mix) {
+    mix.clear();
+    std::istringstream entries(text);
+    std::string entry;
+    while (std::getline(entries, entry, ',')) {
+        size_t equals = entry.find('=');
+        std::string name = entry.substr(0, equals);
+        if (std::find(std::begin(ENDPOINT_NAMES), std::end(ENDPOINT_NAMES), name) == std::end(ENDPOINT_NAMES)) {
+            return false;
+        }
+        mix[name] = equals == std::string::npos ? 1 : static_cast<unsigned>(std::stoul(entry.substr(equals + 1)));
+    }
+    return std::any_of(mix.begin(), mix.end(), [](const auto& weight) { return weight.second > 0; });
+}
+
+bool parseArguments(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+            return argv[++i];
+        };
+        if (arg == "--host") options.host = value();
+        else if (arg == "--port") options.port = std::stoi(value());
+        else if (arg == "--connections") options.connections = std::max(1u, static_cast<unsigned>(std::stoul(value())));
+        else if (arg == "--duration") options.duration_s = std::stod(value());
+        else if (arg == "--timeout") options.timeout_s = std::stod(value());
+        else if (arg == "--no-keep-alive") options.keep_alive = false;
+        else if (arg == "--subscribers") options.subscribers = static_cast<unsigned>(std::stoul(value()));
+        else if (arg == "--batch-size") options.batch_size = std::max<size_t>(1, std::stoul(value()));
+        else if (arg == "--translation") options.translation = value();
+        else if (arg == "--queries") options.queries_file = value();
+        else if (arg == "--output") options.output = value();
+        else if (arg == "--seed") options.seed = static_cast<unsigned>(std::stoul(value()));
+        else if (arg == "--mix") {
+            if (!parseMix(value(), options.mix)) throw std::invalid_argument("--mix takes e.g. search=70,batch=30");
+        } else {
+            std::cerr << "Usage: api_load_generator [--host 127.0.0.1] [--port 8080] [--connections 8]\n"
+                         "       [--duration 10] [--timeout 5] [--no-keep-alive]\n"
+                         "       [--mix search=70,translations=10,batch=20] [--batch-size 5]\n"
+                         "       [--subscribers N] [--translation KJV] [--queries queries.json]\n"
+                         "       [--seed 1] [--output results.json]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        if (!parseArguments(argc, argv, options)) return 2;
+    } catch (const std::exception& e) {
+        std::cerr << "api_load_generator: " << e.what() << std::endl;
+        return 2;
+    }
+
+    LoadGenerator generator(options);
+    if (!generator.resolve()) {
+        std::cerr << "api_load_generator: cannot resolve " << options.host << std::endl;
+        return 2;
+    }
+    if (!generator.loadQueries()) {
+        std::cerr << "api_load_generator: no queries in " << options.queries_file << std::endl;
+        return 2;
+    }
+
+    generator.run();
+    json results = generator.results();
+    printReport(results);
+
+    if (!options.output.empty()) {
+        std::ofstream file(options.output, std::ios::trunc);
+        file << results.dump(2) << "\n";
+        if (!file.good()) {
+            std::cerr << "api_load_generator: could not write " << options.output << std::endl;
+            return 2;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,406 @@
+// Reproducible search benchmark: runs a fixed query corpus against real
+// translation data and reports latency percentiles, throughput, allocations
+// and peak memory per query category as JSON. Given a baseline from an
+// earlier run it fails (exit code 1) when any category regressed, so it can
+// gate changes in CI. Exit code 2 means the benchmark itself could not run.
+//
+//   search_benchmark --data bible.json --corpus test/bench/queries.json \
+//                    --baseline test/bench/baseline.json --output results.json
+
+#include "VerseFinder.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using json = nlohmann::json;
+
+// Allocation counting for the calling thread only, so work done by other
+// threads (loaders, caches warming in the background) is not charged to the
+// query being measured
+namespace {
+thread_local uint64_t thread_allocations = 0;
+thread_local uint64_t thread_allocated_bytes = 0;
+}
+
+void* operator new(std::size_t size) {
+    ++thread_allocations;
+    thread_allocated_bytes += size;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+struct Options {
+    std::vector<std::string> data;
+    std::string corpus = "test/bench/queries.json";
+    std::string output;
+    std::string baseline;
+    bool update_baseline = false;
+    int iterations = 5;
+    double tolerance = 0.20;   // relative slowdown allowed before failing
+    double min_delta_us = 50;  // ...as long as it is also at least this much
+    bool warm_cache = false;
+    unsigned threads = 0;
+};
+
+size_t peakResidentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    struct rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss);
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    size_t rank = static_cast<size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+// Runs one query the way its category is served to users; returns the result count
+using QueryRunner = size_t (*)(const VerseFinder&, const std::string&, const std::string&);
+
+template <VerseFinder::SearchMethod method>
+size_t runSearch(const VerseFinder& finder, const std::string& query, const std::string& translation) {
+    return (finder.*method)(query, translation, SearchContext()).size();
+}
+
+size_t runReference(const VerseFinder& finder, const std::string& query, const std::string& translation) {
+    return finder.searchByReference(query, translation).empty() ? 0 : 1;
+}
+
+const std::map<std::string, QueryRunner>& queryRunners() {
+    static const std::map<std::string, QueryRunner> runners = {
+        {"reference", &runReference},
+        {"word", &runSearch<&VerseFinder::searchByKeywords>},
+        {"phrase", &runSearch<&VerseFinder::searchByKeywords>},
+        {"typo", &runSearch<&VerseFinder::searchByKeywordsFuzzy>},
+        {"boolean", &runSearch<&VerseFinder::searchBoolean>},
+        {"semantic", &runSearch<&VerseFinder::searchSemantic>},
+        {"question", &runSearch<&VerseFinder::answerQuestion>},
+    };
+    return runners;
+}
+
+struct Query {
+    std::string category;
+    std::string text;
+    QueryRunner run;
+};
+
+bool parseArguments(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument(arg + " needs a value");
+            return argv[++i];
+        };
+        if (arg == "--data") options.data.push_back(value());
+        else if (arg == "--corpus") options.corpus = value();
+        else if (arg == "--output") options.output = value();
+        else if (arg == "--baseline") options.baseline = value();
+        else if (arg == "--update-baseline") options.update_baseline = true;
+        else if (arg == "--iterations") options.iterations = std::max(1, std::stoi(value()));
+        else if (arg == "--tolerance") options.tolerance = std::stod(value());
+        else if (arg == "--min-delta-us") options.min_delta_us = std::stod(value());
+        else if (arg == "--threads") options.threads = static_cast<unsigned>(std::stoul(value()));
+        else if (arg == "--warm-cache") options.warm_cache = true;
+        else {
+            std::cerr << "Usage: search_benchmark --data <file|dir> [--data ...] [--corpus queries.json]\n"
+                         "       [--iterations N] [--threads N] [--warm-cache] [--output results.json]\n"
+                         "       [--baseline baseline.json [--update-baseline]] [--tolerance 0.20]\n"
+                         "       [--min-delta-us 50]\n";
+            return false;
+        }
+    }
+    if (options.data.empty()) options.data.push_back("bible.json");
+    return true;
+}
+
+bool loadData(VerseFinder& finder, const std::vector<std::string>& paths) {
+    bool first = true;
+    for (const auto& path : paths) {
+        if (std::filesystem::is_directory(path)) {
+            finder.setTranslationsDirectory(path);
+            finder.loadAllTranslations();
+        } else if (first) {
+            finder.startLoading(path);
+        } else if (!finder.loadTranslationFromFile(path)) {
+            return false;
+        }
+        if (first) {
+            for (int waited = 0; !finder.isReady() && waited < 600; ++waited) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            if (!finder.isReady()) return false;
+            first = false;
+        }
+    }
+    return !finder.getTranslations().empty();
+}
+
+std::vector<Query> loadCorpus(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) throw std::runtime_error("cannot open corpus " + path);
+    json corpus = json::parse(file);
+
+    std::vector<Query> queries;
+    for (const auto& [category, texts] : corpus.items()) {
+        auto runner = queryRunners().find(category);
+        if (runner == queryRunners().end()) throw std::runtime_error("unknown query category " + category);
+        for (const auto& text : texts) queries.push_back({category, text.get<std::string>(), runner->second});
+    }
+    return queries;
+}
+
+// Single-threaded latency and allocation profile per category
+json measureLatency(VerseFinder& finder, const std::vector<Query>& queries,
+                    const std::vector<std::string>& translations, const Options& options) {
+    struct Samples {
+        std::vector<double> micros;
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+        uint64_t results = 0;
+    };
+    std::map<std::string, Samples> by_category;
+
+    // One untimed pass so lazily built structures are not charged to the first query
+    for (const auto& translation : translations) {
+        for (const auto& query : queries) query.run(finder, query.text, translation);
+    }
+
+    for (int iteration = 0; iteration < options.iterations; ++iteration) {
+        for (const auto& translation : translations) {
+            for (const auto& query : queries) {
+                if (!options.warm_cache) finder.clearSearchCache();
+                Samples& samples = by_category[query.category];
+
+                uint64_t allocations_before = thread_allocations;
+                uint64_t bytes_before = thread_allocated_bytes;
+                auto start = std::chrono::steady_clock::now();
+                size_t results = query.run(finder, query.text, translation);
+                auto elapsed = std::chrono::steady_clock::now() - start;
+
+                samples.micros.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+                samples.allocations += thread_allocations - allocations_before;
+                samples.bytes += thread_allocated_bytes - bytes_before;
+                samples.results += results;
+            }
+        }
+    }
+
+    json categories = json::object();
+    for (auto& [category, samples] : by_category) {
+        std::sort(samples.micros.begin(), samples.micros.end());
+        double total_us = 0;
+        for (double us : samples.micros) total_us += us;
+        double count = static_cast<double>(samples.micros.size());
+        categories[category] = {
+            {"samples", samples.micros.size()},
+            {"mean_us", total_us / count},
+            {"p50_us", percentile(samples.micros, 0.50)},
+            {"p95_us", percentile(samples.micros, 0.95)},
+            {"p99_us", percentile(samples.micros, 0.99)},
+            {"max_us", samples.micros.back()},
+            {"qps", total_us > 0 ? count * 1e6 / total_us : 0.0},
+            {"allocations_per_query", static_cast<double>(samples.allocations) / count},
+            {"bytes_per_query", static_cast<double>(samples.bytes) / count},
+            {"results_per_query", static_cast<double>(samples.results) / count},
+        };
+    }
+    return categories;
+}
+
+// Whole corpus run from several threads at once against one VerseFinder
+json measureThroughput(const VerseFinder& finder, const std::vector<Query>& queries,
+                       const std::vector<std::string>& translations, const Options& options) {
+    unsigned thread_count = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    std::atomic<size_t> next{0};
+    size_t total = queries.size() * translations.size() * static_cast<size_t>(options.iterations);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < thread_count; ++t) {
+        workers.emplace_back([&]() {
+            for (size_t i = next.fetch_add(1); i < total; i = next.fetch_add(1)) {
+                const Query& query = queries[i % queries.size()];
+                query.run(finder, query.text, translations[(i / queries.size()) % translations.size()]);
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return {{"threads", thread_count}, {"queries", total}, {"seconds", seconds},
+            {"qps", seconds > 0 ? static_cast<double>(total) / seconds : 0.0}};
+}
+
+// Returns a description of every metric that got worse than the baseline allows
+std::vector<std::string> findRegressions(const json& results, const json& baseline, const Options& options) {
+    std::vector<std::string> regressions;
+    auto slower = [&](double current, double base) {
+        return current > base * (1.0 + options.tolerance) && current - base > options.min_delta_us;
+    };
+
+    json base_categories = baseline.value("categories", json::object());
+    for (const auto& [category, base] : base_categories.items()) {
+        if (!results["categories"].contains(category)) continue;
+        const json& current = results["categories"][category];
+        // p99 is reported but not gated: with a corpus this size it is close to the max and too noisy
+        for (const char* metric : {"p50_us", "p95_us"}) {
+            double now = current.value(metric, 0.0), then = base.value(metric, 0.0);
+            if (slower(now, then)) {
+                regressions.push_back(category + " " + metric + ": " + std::to_string(then) + " -> " +
+                                      std::to_string(now));
+            }
+        }
+        double allocations = current.value("allocations_per_query", 0.0);
+        double base_allocations = base.value("allocations_per_query", 0.0);
+        if (allocations > base_allocations * (1.0 + options.tolerance) && allocations - base_allocations >= 1.0) {
+            regressions.push_back(category + " allocations_per_query: " + std::to_string(base_allocations) +
+                                  " -> " + std::to_string(allocations));
+        }
+    }
+
+    double rss = results.value("peak_rss_bytes", 0.0), base_rss = baseline.value("peak_rss_bytes", 0.0);
+    if (base_rss > 0 && rss > base_rss * (1.0 + options.tolerance)) {
+        regressions.push_back("peak_rss_bytes: " + std::to_string(base_rss) + " -> " + std::to_string(rss));
+    }
+    return regressions;
+}
+
+void printSummary(const json& results) {
+    std::cout << "\n" << std::left << std::setw(11) << "category" << std::right << std::setw(9) << "p50 us"
+              << std::setw(10) << "p95 us" << std::setw(10) << "p99 us" << std::setw(10) << "qps"
+              << std::setw(11) << "allocs/q" << "\n";
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& [category, stats] : results["categories"].items()) {
+        std::cout << std::left << std::setw(11) << category << std::right
+                  << std::setw(9) << stats["p50_us"].get<double>()
+                  << std::setw(10) << stats["p95_us"].get<double>()
+                  << std::setw(10) << stats["p99_us"].get<double>()
+                  << std::setw(10) << stats["qps"].get<double>()
+                  << std::setw(11) << stats["allocations_per_query"].get<double>() << "\n";
+    }
+    const json& throughput = results["throughput"];
+    std::cout << "Throughput: " << throughput["qps"].get<double>() << " queries/s on "
+              << throughput["threads"].get<unsigned>() << " threads\n";
+    std::cout << "Peak RSS: " << results["peak_rss_bytes"].get<size_t>() / (1024 * 1024) << " MB\n";
+}
+
+bool writeJson(const std::string& path, const json& value) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) return false;
+    file << value.dump(2) << "\n";
+    return file.good();
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    std::vector<Query> queries;
+    try {
+        if (!parseArguments(argc, argv, options)) return 2;
+        queries = loadCorpus(options.corpus);
+    } catch (const std::exception& e) {
+        std::cerr << "search_benchmark: " << e.what() << std::endl;
+        return 2;
+    }
+
+    VerseFinder finder;
+    finder.enableFuzzySearch(true); // off by default, but the typo queries exist to exercise it
+    auto load_start = std::chrono::steady_clock::now();
+    if (!loadData(finder, options.data)) {
+        std::cerr << "search_benchmark: could not load translation data" << std::endl;
+        return 2;
+    }
+    double load_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - load_start).count();
+
+    std::vector<std::string> translations;
+    for (const auto& info : finder.getTranslations()) translations.push_back(info.name);
+    std::cout << "Loaded " << translations.size() << " translation(s) in " << load_seconds << " s; running "
+              << queries.size() << " queries x " << options.iterations << " iterations"
+              << (options.warm_cache ? " (warm cache)" : "") << std::endl;
+
+    json results = {
+        {"version", 1},
+        {"translations", translations},
+        {"corpus", options.corpus},
+        {"iterations", options.iterations},
+        {"warm_cache", options.warm_cache},
+        {"load_seconds", load_seconds},
+    };
+    results["categories"] = measureLatency(finder, queries, translations, options);
+    results["throughput"] = measureThroughput(finder, queries, translations, options);
+    results["peak_rss_bytes"] = peakResidentBytes();
+    printSummary(results);
+
+    if (!options.output.empty() && !writeJson(options.output, results)) {
+        std::cerr << "search_benchmark: could not write " << options.output << std::endl;
+        return 2;
+    }
+
+    if (options.baseline.empty()) return 0;
+    if (options.update_baseline) {
+        if (!writeJson(options.baseline, results)) return 2;
+        std::cout << "Baseline written to " << options.baseline << std::endl;
+        return 0;
+    }
+
+    std::ifstream baseline_file(options.baseline);
+    if (!baseline_file.is_open()) {
+        std::cout << "No baseline at " << options.baseline << "; nothing to compare" << std::endl;
+        return 0;
+    }
+    json baseline;
+    try {
+        baseline = json::parse(baseline_file);
+    } catch (const std::exception& e) {
+        std::cerr << "search_benchmark: bad baseline: " << e.what() << std::endl;
+        return 2;
+    }
+
+    auto regressions = findRegressions(results, baseline, options);
+    if (regressions.empty()) {
+        std::cout << "No regressions against " << options.baseline << std::endl;
+        return 0;
+    }
+    std::cout << "Regressions against " << options.baseline << ":\n";
+    for (const auto& regression : regressions) std::cout << "  " << regression << "\n";
+    return 1;
+}